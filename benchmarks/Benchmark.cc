@@ -0,0 +1,356 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The benchmark runner
+ *
+ * Usage: afwBenchmarks [--filter REGEX] [--min-time SECONDS] [--repetitions N] [--json FILE]
+ *                      [--scratch-dir DIR] [--list]
+ *
+ *  --filter       run only the benchmarks whose names match REGEX (ECMAScript syntax, partial match)
+ *  --min-time     run each benchmark's loop for at least this long per repetition (default 0.5)
+ *  --repetitions  number of timed repetitions of each benchmark (default 5)
+ *  --json         write the results to FILE as JSON ("-" for standard output)
+ *  --scratch-dir  directory for the files written by the I/O benchmarks (default $TMPDIR or /tmp)
+ *  --list         list the benchmarks' names and exit
+ *
+ * Times are reported per iteration of a benchmark's loop; the median over repetitions is the headline
+ * figure, as it is the least sensitive to other activity on the machine.  Benchmarks that report the
+ * bytes or items (e.g. records) they process also have their throughput reported.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Benchmark.h"
+
+namespace lsst {
+namespace afw {
+namespace benchmarks {
+
+namespace {
+
+std::map<std::string, BenchmarkFunction>& getRegistry() {
+    static std::map<std::string, BenchmarkFunction> registry;
+    return registry;
+}
+
+std::string getDefaultScratchDirectory() {
+    char const* tmpdir = std::getenv("TMPDIR");
+    return (tmpdir && *tmpdir) ? tmpdir : "/tmp";
+}
+
+std::string& getScratchDirectoryImpl() {
+    static std::string directory = getDefaultScratchDirectory();
+    return directory;
+}
+
+struct Options {
+    std::string filter = ".*";
+    double minTime = 0.5;
+    int repetitions = 5;
+    std::string jsonFile;
+    std::string scratchDir = getDefaultScratchDirectory();
+    bool list = false;
+};
+
+struct Result {
+    std::string name;
+    std::string error;
+    std::int64_t iterations = 0;
+    std::vector<double> realTimes;  // per iteration, one per repetition
+    std::vector<double> cpuTimes;   // per iteration, one per repetition
+    std::int64_t items = 0;         // per iteration
+    std::int64_t bytes = 0;         // per iteration
+};
+
+double median(std::vector<double> values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    std::size_t const n = values.size();
+    return n % 2 ? values[n / 2] : 0.5 * (values[n / 2 - 1] + values[n / 2]);
+}
+
+double mean(std::vector<double> const& values) {
+    double sum = 0.0;
+    for (double v : values) {
+        sum += v;
+    }
+    return values.empty() ? 0.0 : sum / values.size();
+}
+
+double stddev(std::vector<double> const& values) {
+    if (values.size() < 2) {
+        return 0.0;
+    }
+    double const m = mean(values);
+    double sum = 0.0;
+    for (double v : values) {
+        sum += (v - m) * (v - m);
+    }
+    return std::sqrt(sum / (values.size() - 1));
+}
+
+Result run(std::string const& name, BenchmarkFunction const& function, Options const& options) {
+    Result result;
+    result.name = name;
+    try {
+        // One untimed iteration warms the caches and estimates how many iterations fill minTime
+        State warmup(1);
+        function(warmup);
+        double const perIteration = std::max(warmup.getRealTime(), 1e-9);
+        result.iterations =
+                std::clamp<std::int64_t>(std::ceil(options.minTime / perIteration), 1, 1000000000);
+        for (int i = 0; i < options.repetitions; ++i) {
+            State state(result.iterations);
+            function(state);
+            result.realTimes.push_back(state.getRealTime() / result.iterations);
+            result.cpuTimes.push_back(state.getCpuTime() / result.iterations);
+            result.items = state.getItemsProcessed();
+            result.bytes = state.getBytesProcessed();
+        }
+    } catch (std::exception const& err) {
+        result.error = err.what();
+    }
+    return result;
+}
+
+std::string formatTime(double seconds) {
+    std::ostringstream out;
+    out << std::setprecision(3) << std::fixed;
+    if (seconds >= 1.0) {
+        out << seconds << " s";
+    } else if (seconds >= 1e-3) {
+        out << seconds * 1e3 << " ms";
+    } else {
+        out << seconds * 1e6 << " us";
+    }
+    return out.str();
+}
+
+// e.g. formatRate(1.5e8, "B") is "150.000MB/s" and formatRate(2e4, " items") is "20.000k items/s"
+std::string formatRate(double perSecond, std::string const& unit) {
+    std::ostringstream out;
+    out << std::setprecision(3) << std::fixed;
+    if (perSecond >= 1e9) {
+        out << perSecond * 1e-9 << "G";
+    } else if (perSecond >= 1e6) {
+        out << perSecond * 1e-6 << "M";
+    } else if (perSecond >= 1e3) {
+        out << perSecond * 1e-3 << "k";
+    } else {
+        out << perSecond;
+    }
+    out << unit << "/s";
+    return out.str();
+}
+
+std::string jsonString(std::string const& value) {
+    std::ostringstream out;
+    out << '"';
+    for (char c : value) {
+        switch (c) {
+            case '"':
+                out << "\\\"";
+                break;
+            case '\\':
+                out << "\\\\";
+                break;
+            case '\n':
+                out << "\\n";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec;
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+void writeJson(std::ostream& out, std::vector<Result> const& results, Options const& options) {
+    char date[32];
+    std::time_t const now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    char host[256] = "";
+    gethostname(host, sizeof(host) - 1);
+
+    out << std::setprecision(9);
+    out << "{\n  \"context\": {\n";
+    out << "    \"date\": " << jsonString(date) << ",\n";
+    out << "    \"host_name\": " << jsonString(host) << ",\n";
+    out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "    \"min_time\": " << options.minTime << ",\n";
+    out << "    \"repetitions\": " << options.repetitions << ",\n";
+    out << "    \"scratch_dir\": " << jsonString(options.scratchDir) << ",\n";
+    out << "    \"time_unit\": \"s\"\n  },\n  \"benchmarks\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        Result const& r = results[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\n      \"name\": " << jsonString(r.name);
+        if (!r.error.empty()) {
+            out << ",\n      \"error_message\": " << jsonString(r.error) << "\n    }";
+            continue;
+        }
+        double const realMedian = median(r.realTimes);
+        out << ",\n      \"iterations\": " << r.iterations;
+        out << ",\n      \"real_time\": " << realMedian;
+        out << ",\n      \"real_time_min\": " << *std::min_element(r.realTimes.begin(), r.realTimes.end());
+        out << ",\n      \"real_time_mean\": " << mean(r.realTimes);
+        out << ",\n      \"real_time_stddev\": " << stddev(r.realTimes);
+        out << ",\n      \"cpu_time\": " << median(r.cpuTimes);
+        if (r.items > 0) {
+            out << ",\n      \"items_per_second\": " << r.items / realMedian;
+        }
+        if (r.bytes > 0) {
+            out << ",\n      \"bytes_per_second\": " << r.bytes / realMedian;
+        }
+        out << "\n    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    auto value = [&](int& i) -> std::string {
+        if (i + 1 >= argc) {
+            throw std::invalid_argument(std::string("Missing value for ") + argv[i]);
+        }
+        return argv[++i];
+    };
+    for (int i = 1; i < argc; ++i) {
+        std::string const arg = argv[i];
+        if (arg == "--filter") {
+            options.filter = value(i);
+        } else if (arg == "--min-time") {
+            options.minTime = std::stod(value(i));
+        } else if (arg == "--repetitions") {
+            options.repetitions = std::stoi(value(i));
+        } else if (arg == "--json") {
+            options.jsonFile = value(i);
+        } else if (arg == "--scratch-dir") {
+            options.scratchDir = value(i);
+        } else if (arg == "--list") {
+            options.list = true;
+        } else {
+            throw std::invalid_argument("Unknown argument " + arg);
+        }
+    }
+    if (options.repetitions < 1) {
+        throw std::invalid_argument("--repetitions must be at least 1");
+    }
+    return options;
+}
+
+}  // namespace
+
+int registerBenchmark(std::string const& name, BenchmarkFunction function) {
+    if (!getRegistry().emplace(name, std::move(function)).second) {
+        std::cerr << "Duplicate benchmark name " << name << std::endl;
+        std::abort();
+    }
+    return 0;
+}
+
+std::string const& getScratchDirectory() { return getScratchDirectoryImpl(); }
+
+}  // namespace benchmarks
+}  // namespace afw
+}  // namespace lsst
+
+int main(int argc, char** argv) {
+    using namespace lsst::afw::benchmarks;
+    Options options;
+    std::regex filter;
+    try {
+        options = parseOptions(argc, argv);
+        filter = std::regex(options.filter);
+        getScratchDirectoryImpl() = options.scratchDir;
+    } catch (std::exception const& err) {
+        std::cerr << argv[0] << ": " << err.what() << std::endl;
+        return 2;
+    }
+
+    std::vector<Result> results;
+    bool failed = false;
+    for (auto const& entry : getRegistry()) {
+        if (!std::regex_search(entry.first, filter)) {
+            continue;
+        }
+        if (options.list) {
+            std::cout << entry.first << std::endl;
+            continue;
+        }
+        Result result = run(entry.first, entry.second, options);
+        std::cout << std::left << std::setw(48) << result.name << std::right;
+        if (result.error.empty()) {
+            double const realMedian = median(result.realTimes);
+            std::cout << std::setw(14) << formatTime(realMedian) << "  +/- " << std::setw(12)
+                      << formatTime(stddev(result.realTimes)) << std::setw(12) << result.iterations
+                      << " iterations";
+            if (result.bytes > 0) {
+                std::cout << std::setw(16) << formatRate(result.bytes / realMedian, "B");
+            }
+            if (result.items > 0) {
+                std::cout << std::setw(18) << formatRate(result.items / realMedian, " items");
+            }
+            std::cout << std::endl;
+        } else {
+            std::cout << "  ERROR: " << result.error << std::endl;
+            failed = true;
+        }
+        results.push_back(std::move(result));
+    }
+
+    if (!options.jsonFile.empty() && !options.list) {
+        if (options.jsonFile == "-") {
+            writeJson(std::cout, results, options);
+        } else {
+            std::ofstream out(options.jsonFile);
+            writeJson(out, results, options);
+            if (!out) {
+                std::cerr << argv[0] << ": could not write " << options.jsonFile << std::endl;
+                return 2;
+            }
+        }
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,179 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * A minimal harness for timing afw's hot paths
+ *
+ * Each benchmark is a function that times a loop:
+ *
+ *     AFW_REGISTER_BENCHMARK("statistics/meanClip", [](State& state) {
+ *         auto image = makeImage();             // not timed
+ *         while (state.keepRunning()) {
+ *             makeStatistics(image, MEANCLIP);  // timed
+ *         }
+ *         state.setItemsProcessed(image.getArea());
+ *     });
+ *
+ * The runner (see Benchmark.cc) calls the function repeatedly, reports the time per iteration of the
+ * loop and writes the results as JSON for comparison against a baseline (see compareBenchmarks.py).
+ * Benchmarks that need files write them to getScratchDirectory().
+ */
+#ifndef LSST_AFW_BENCHMARKS_BENCHMARK_H
+#define LSST_AFW_BENCHMARKS_BENCHMARK_H
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <string>
+
+namespace lsst {
+namespace afw {
+namespace benchmarks {
+
+/**
+ * The timing state of one run of a benchmark.
+ *
+ * Only the body of the `while (state.keepRunning())` loop is timed, less any time between
+ * pauseTiming() and resumeTiming().
+ */
+class State final {
+public:
+    /// Prepare to run a benchmark's loop `iterations` times.
+    explicit State(std::int64_t iterations) : _iterations(iterations) {}
+
+    State(State const&) = delete;
+    State& operator=(State const&) = delete;
+
+    /// Return true if the loop should run again; the first call starts the clock, the last stops it.
+    bool keepRunning() {
+        if (!_started) {
+            _started = true;
+            _start();
+            return _iterations > 0;
+        }
+        if (++_done < _iterations) {
+            return true;
+        }
+        _stop();
+        return false;
+    }
+
+    //@{
+    /// Exclude work done inside the loop (e.g. resetting an output) from the timing.
+    void pauseTiming() { _stop(); }
+    void resumeTiming() { _start(); }
+    //@}
+
+    /// Set the number of items (e.g. pixels or records) processed by one iteration of the loop.
+    void setItemsProcessed(std::int64_t items) { _items = items; }
+
+    /// Set the number of bytes processed by one iteration of the loop.
+    void setBytesProcessed(std::int64_t bytes) { _bytes = bytes; }
+
+    std::int64_t getIterations() const { return _iterations; }
+    std::int64_t getItemsProcessed() const { return _items; }
+    std::int64_t getBytesProcessed() const { return _bytes; }
+
+    /// Wall-clock time, in seconds, spent in the timed part of the loop.
+    double getRealTime() const { return _realTime; }
+
+    /// CPU time of the process (summed over all threads), in seconds, spent in the timed part of the loop.
+    double getCpuTime() const { return _cpuTime; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void _start() {
+        _running = true;
+        _cpuStart = std::clock();
+        _realStart = Clock::now();
+    }
+
+    void _stop() {
+        if (_running) {
+            _realTime += std::chrono::duration<double>(Clock::now() - _realStart).count();
+            _cpuTime += double(std::clock() - _cpuStart) / CLOCKS_PER_SEC;
+            _running = false;
+        }
+    }
+
+    std::int64_t const _iterations;
+    std::int64_t _done = 0;
+    std::int64_t _items = 0;
+    std::int64_t _bytes = 0;
+    bool _started = false;
+    bool _running = false;
+    double _realTime = 0.0;
+    double _cpuTime = 0.0;
+    Clock::time_point _realStart;
+    std::clock_t _cpuStart = 0;
+};
+
+using BenchmarkFunction = std::function<void(State&)>;
+
+/**
+ * Add a benchmark to the list that the runner knows about.
+ *
+ * @param name  unique name of the benchmark; by convention "<operation>/<variant>"
+ * @param function  the benchmark
+ *
+ * @returns an arbitrary value, so that this can be used to initialize a static variable
+ */
+int registerBenchmark(std::string const& name, BenchmarkFunction function);
+
+/**
+ * Return the directory in which benchmarks should write any files.
+ *
+ * This is set by the runner's --scratch-dir option, so that I/O can be timed on a local disk or a
+ * network filesystem; the default is $TMPDIR, or /tmp if that is not set.
+ */
+std::string const& getScratchDirectory();
+
+/**
+ * Prevent the compiler from optimizing away a value computed by a benchmark.
+ */
+template <typename T>
+void doNotOptimize(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile char const* sink;
+    sink = reinterpret_cast<char const*>(&value);
+#endif
+}
+
+}  // namespace benchmarks
+}  // namespace afw
+}  // namespace lsst
+
+#define AFW_BENCHMARK_CONCAT2(a, b) a##b
+#define AFW_BENCHMARK_CONCAT(a, b) AFW_BENCHMARK_CONCAT2(a, b)
+
+/// Register a lambda taking a `State&` as a benchmark with the given name.
+#define AFW_REGISTER_BENCHMARK(name, ...)                                                      \
+    static int const AFW_BENCHMARK_CONCAT(afwBenchmarkRegistered_, __LINE__) [[maybe_unused]] = \
+            ::lsst::afw::benchmarks::registerBenchmark(name, __VA_ARGS__)
+
+#endif  // !LSST_AFW_BENCHMARKS_BENCHMARK_H
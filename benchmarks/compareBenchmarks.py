@@ -0,0 +1,92 @@
+#!/usr/bin/env python
+# This file is part of afw.
+#
+# Developed for the LSST Data Management System.
+# This product includes software developed by the LSST Project
+# (https://www.lsst.org).
+# See the COPYRIGHT file at the top-level directory of this distribution
+# for details of code ownership.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+"""Compare the JSON output of two runs of afwBenchmarks.
+
+A baseline is simply the output of an earlier run on the same machine:
+
+    benchmarks/afwBenchmarks --json baseline.json
+    # ... change and rebuild afw ...
+    benchmarks/afwBenchmarks --json current.json
+    python benchmarks/compareBenchmarks.py baseline.json current.json
+
+The script prints the ratio of the median times of each benchmark, and exits with
+status 1 if any benchmark is slower than the baseline by more than the threshold
+(or failed), so that it can be used in automated checks.
+"""
+
+import argparse
+import json
+import sys
+
+
+def loadResults(fileName):
+    """Return the benchmarks in an afwBenchmarks JSON file, keyed by name.
+    """
+    with open(fileName) as f:
+        data = json.load(f)
+    return {b["name"]: b for b in data["benchmarks"]}, data["context"]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline", help="JSON output of the baseline run")
+    parser.add_argument("current", help="JSON output of the run to check")
+    parser.add_argument("--threshold", type=float, default=0.1,
+                        help="largest tolerated fractional slowdown (default: %(default)s)")
+    args = parser.parse_args()
+
+    baseline, baselineContext = loadResults(args.baseline)
+    current, currentContext = loadResults(args.current)
+    if baselineContext.get("host_name") != currentContext.get("host_name"):
+        print("Warning: the runs were on different hosts (%s and %s)"
+              % (baselineContext.get("host_name"), currentContext.get("host_name")), file=sys.stderr)
+
+    failed = False
+    print("%-56s %12s %12s %8s" % ("benchmark", "baseline", "current", "ratio"))
+    for name in sorted(set(baseline) | set(current)):
+        old = baseline.get(name)
+        new = current.get(name)
+        if new is None:
+            print("%-56s %12s" % (name, "(missing)"))
+            continue
+        if "error_message" in new:
+            print("%-56s ERROR: %s" % (name, new["error_message"]))
+            failed = True
+            continue
+        if old is None or "error_message" in old:
+            print("%-56s %12s %12.6g" % (name, "(new)", new["real_time"]))
+            continue
+        ratio = new["real_time"]/old["real_time"]
+        flag = ""
+        if ratio > 1.0 + args.threshold:
+            flag = "  SLOWER"
+            failed = True
+        elif ratio < 1.0/(1.0 + args.threshold):
+            flag = "  faster"
+        print("%-56s %12.6g %12.6g %8.3f%s" % (name, old["real_time"], new["real_time"], ratio, flag))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
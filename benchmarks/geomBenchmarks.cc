@@ -0,0 +1,122 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Benchmarks of coordinate transforms
+ */
+
+#include <memory>
+#include <vector>
+
+#include "Eigen/Core"
+
+#include "lsst/geom.h"
+#include "lsst/afw/geom/SkyWcs.h"
+#include "lsst/afw/math/Random.h"
+
+#include "Benchmark.h"
+
+namespace lsst {
+namespace afw {
+namespace benchmarks {
+
+namespace {
+
+int const N_POINTS = 1000000;
+int const CCD_SIZE = 4096;
+
+// A TAN-SIP WCS with third-order distortion, like those fit to LSST CCDs
+std::shared_ptr<geom::SkyWcs> makeDistortedWcs() {
+    Eigen::MatrixXd sipA = Eigen::MatrixXd::Zero(4, 4);
+    Eigen::MatrixXd sipB = Eigen::MatrixXd::Zero(4, 4);
+    sipA(2, 0) = 2e-7;
+    sipA(1, 1) = -1e-7;
+    sipA(3, 0) = 3e-11;
+    sipA(0, 2) = 1e-7;
+    sipB(0, 2) = -2e-7;
+    sipB(1, 1) = 1.5e-7;
+    sipB(0, 3) = -2e-11;
+    sipB(2, 0) = 1e-7;
+    return geom::makeTanSipWcs(lsst::geom::Point2D(CCD_SIZE / 2, CCD_SIZE / 2),
+                               lsst::geom::SpherePoint(150.0, 2.0, lsst::geom::degrees),
+                               geom::makeCdMatrix(0.2 * lsst::geom::arcseconds, 30 * lsst::geom::degrees),
+                               sipA, sipB);
+}
+
+std::vector<lsst::geom::Point2D> makePixels(int n) {
+    math::Random rand(math::Random::PHILOX4X32, 1);
+    std::vector<lsst::geom::Point2D> result;
+    result.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        result.emplace_back(rand.flat(0.0, CCD_SIZE), rand.flat(0.0, CCD_SIZE));
+    }
+    return result;
+}
+
+AFW_REGISTER_BENCHMARK("SkyWcs/pixelToSky/tan", [](State& state) {
+    auto const wcs = geom::makeSkyWcs(lsst::geom::Point2D(CCD_SIZE / 2, CCD_SIZE / 2),
+                                      lsst::geom::SpherePoint(150.0, 2.0, lsst::geom::degrees),
+                                      geom::makeCdMatrix(0.2 * lsst::geom::arcseconds));
+    auto const pixels = makePixels(N_POINTS);
+    while (state.keepRunning()) {
+        doNotOptimize(wcs->pixelToSky(pixels));
+    }
+    state.setItemsProcessed(N_POINTS);
+});
+
+AFW_REGISTER_BENCHMARK("SkyWcs/pixelToSky/tanSip", [](State& state) {
+    auto const wcs = makeDistortedWcs();
+    auto const pixels = makePixels(N_POINTS);
+    while (state.keepRunning()) {
+        doNotOptimize(wcs->pixelToSky(pixels));
+    }
+    state.setItemsProcessed(N_POINTS);
+});
+
+AFW_REGISTER_BENCHMARK("SkyWcs/skyToPixel/tanSip", [](State& state) {
+    auto const wcs = makeDistortedWcs();
+    auto const sky = wcs->pixelToSky(makePixels(N_POINTS));
+    while (state.keepRunning()) {
+        doNotOptimize(wcs->skyToPixel(sky));
+    }
+    state.setItemsProcessed(N_POINTS);
+});
+
+// Many single-point calls, as made by code that transforms one source at a time
+AFW_REGISTER_BENCHMARK("SkyWcs/pixelToSky/tanSip/onePointPerCall", [](State& state) {
+    auto const wcs = makeDistortedWcs();
+    auto const pixels = makePixels(N_POINTS / 100);
+    while (state.keepRunning()) {
+        for (auto const& pixel : pixels) {
+            doNotOptimize(wcs->pixelToSky(pixel));
+        }
+    }
+    state.setItemsProcessed(pixels.size());
+});
+
+}  // namespace
+
+}  // namespace benchmarks
+}  // namespace afw
+}  // namespace lsst
@@ -0,0 +1,267 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Benchmarks of image processing: convolution, warping, statistics, stacking and detection
+ *
+ * The images are the size of an LSST CCD (4k x 4k), or a quarter of that for the slower operations,
+ * filled with Gaussian noise and stars.
+ */
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "lsst/geom.h"
+#include "lsst/afw/image/MaskedImage.h"
+#include "lsst/afw/image/Exposure.h"
+#include "lsst/afw/geom/SkyWcs.h"
+#include "lsst/afw/math/ConvolveImage.h"
+#include "lsst/afw/math/FunctionLibrary.h"
+#include "lsst/afw/math/Kernel.h"
+#include "lsst/afw/math/Random.h"
+#include "lsst/afw/math/Stack.h"
+#include "lsst/afw/math/Statistics.h"
+#include "lsst/afw/math/warpExposure.h"
+#include "lsst/afw/detection/FootprintSet.h"
+#include "lsst/afw/detection/Threshold.h"
+
+#include "Benchmark.h"
+
+namespace lsst {
+namespace afw {
+namespace benchmarks {
+
+namespace {
+
+using MaskedImageF = image::MaskedImage<float>;
+
+int const KERNEL_SIZE = 19;
+
+/*
+ * A masked image of unit-variance noise on a sky of 1000 counts, with stars of Gaussian profile and a
+ * few masked pixels
+ */
+MaskedImageF makeSkyImage(int width, int height, int nStars, unsigned long seed = 1) {
+    MaskedImageF result(lsst::geom::Extent2I(width, height));
+    math::Random rand(math::Random::PHILOX4X32, seed);
+    math::randomGaussianImage(result.getImage().get(), rand, 0);
+    *result.getImage() += 1000.0f;
+    *result.getVariance() = 1.0f;
+    double const sigma = 2.0;
+    int const radius = 4 * sigma;
+    for (int i = 0; i < nStars; ++i) {
+        int const x0 = rand.flat(radius, width - radius);
+        int const y0 = rand.flat(radius, height - radius);
+        double const flux = 100.0 * std::pow(10.0, rand.flat(0.0, 3.0));
+        for (int y = y0 - radius; y <= y0 + radius; ++y) {
+            for (int x = x0 - radius; x <= x0 + radius; ++x) {
+                double const r2 = (x - x0) * (x - x0) + (y - y0) * (y - y0);
+                (*result.getImage())(x, y) += flux * std::exp(-0.5 * r2 / (sigma * sigma));
+            }
+        }
+    }
+    image::MaskPixel const bad = image::Mask<image::MaskPixel>::getPlaneBitMask("BAD");
+    for (int i = 0; i < width * height / 1000; ++i) {
+        (*result.getMask())(rand.uniformInt(width), rand.uniformInt(height)) |= bad;
+    }
+    return result;
+}
+
+math::GaussianFunction2<math::Kernel::Pixel> makeGaussian(double sigma) {
+    return math::GaussianFunction2<math::Kernel::Pixel>(sigma, sigma, 0.0);
+}
+
+// A first-order polynomial spatial model, with coefficients that make the kernel vary from edge to edge
+std::vector<math::Kernel::SpatialFunctionPtr> makeSpatialFunctions(int nParams, double scale) {
+    std::vector<math::Kernel::SpatialFunctionPtr> result;
+    for (int i = 0; i < nParams; ++i) {
+        auto function = std::make_shared<math::PolynomialFunction2<double>>(1);
+        function->setParameters({1.0 + 0.1 * i, 0.5 / scale, -0.5 / scale});
+        result.push_back(function);
+    }
+    return result;
+}
+
+void benchmarkConvolve(State& state, math::Kernel const& kernel, int numThreads) {
+    int const size = 2048;
+    MaskedImageF const input = makeSkyImage(size, size, 1000);
+    MaskedImageF output(input.getDimensions());
+    math::ConvolutionControl control(true, false, 10, numThreads);
+    while (state.keepRunning()) {
+        math::convolve(output, input, kernel, control);
+    }
+    state.setItemsProcessed(std::int64_t(size) * size);
+}
+
+AFW_REGISTER_BENCHMARK("convolve/FixedKernel", [](State& state) {
+    math::AnalyticKernel const analytic(KERNEL_SIZE, KERNEL_SIZE, makeGaussian(2.5));
+    math::FixedKernel const kernel(analytic, lsst::geom::Point2D(0.0, 0.0));
+    benchmarkConvolve(state, kernel, 1);
+});
+
+AFW_REGISTER_BENCHMARK("convolve/FixedKernel/allThreads", [](State& state) {
+    math::AnalyticKernel const analytic(KERNEL_SIZE, KERNEL_SIZE, makeGaussian(2.5));
+    math::FixedKernel const kernel(analytic, lsst::geom::Point2D(0.0, 0.0));
+    benchmarkConvolve(state, kernel, 0);
+});
+
+AFW_REGISTER_BENCHMARK("convolve/AnalyticKernel", [](State& state) {
+    math::AnalyticKernel const kernel(KERNEL_SIZE, KERNEL_SIZE, makeGaussian(2.5));
+    benchmarkConvolve(state, kernel, 1);
+});
+
+AFW_REGISTER_BENCHMARK("convolve/AnalyticKernel/spatiallyVarying", [](State& state) {
+    math::AnalyticKernel const kernel(KERNEL_SIZE, KERNEL_SIZE, makeGaussian(2.5),
+                                      makeSpatialFunctions(3, 2048.0));
+    benchmarkConvolve(state, kernel, 1);
+});
+
+AFW_REGISTER_BENCHMARK("convolve/SeparableKernel", [](State& state) {
+    math::GaussianFunction1<math::Kernel::Pixel> const gaussian(2.5);
+    math::SeparableKernel const kernel(KERNEL_SIZE, KERNEL_SIZE, gaussian, gaussian);
+    benchmarkConvolve(state, kernel, 1);
+});
+
+AFW_REGISTER_BENCHMARK("convolve/DeltaFunctionKernel", [](State& state) {
+    math::DeltaFunctionKernel const kernel(KERNEL_SIZE, KERNEL_SIZE, lsst::geom::Point2I(3, 7));
+    benchmarkConvolve(state, kernel, 1);
+});
+
+// A basis of Gaussians of several widths, as used for PSF matching
+math::KernelList makeGaussianBasis() {
+    math::KernelList result;
+    for (double sigma : {1.0, 2.0, 3.0, 4.5, 6.0}) {
+        result.push_back(
+                std::make_shared<math::AnalyticKernel>(KERNEL_SIZE, KERNEL_SIZE, makeGaussian(sigma)));
+    }
+    return result;
+}
+
+AFW_REGISTER_BENCHMARK("convolve/LinearCombinationKernel", [](State& state) {
+    math::LinearCombinationKernel const kernel(makeGaussianBasis(), {0.4, 0.3, 0.15, 0.1, 0.05});
+    benchmarkConvolve(state, kernel, 1);
+});
+
+AFW_REGISTER_BENCHMARK("convolve/LinearCombinationKernel/spatiallyVarying", [](State& state) {
+    math::LinearCombinationKernel const kernel(makeGaussianBasis(), makeSpatialFunctions(5, 2048.0));
+    benchmarkConvolve(state, kernel, 1);
+});
+
+void benchmarkWarpExposure(State& state, std::string const& kernelName) {
+    int const size = 2048;
+    lsst::geom::SpherePoint const center(150.0 * lsst::geom::degrees, 2.0 * lsst::geom::degrees);
+    auto const srcWcs = geom::makeSkyWcs(lsst::geom::Point2D(size / 2, size / 2), center,
+                                         geom::makeCdMatrix(0.2 * lsst::geom::arcseconds));
+    // The destination is rotated and slightly rescaled, as when warping to a coadd's tract
+    auto const destWcs =
+            geom::makeSkyWcs(lsst::geom::Point2D(size / 2 + 13.5, size / 2 - 7.25), center,
+                             geom::makeCdMatrix(0.21 * lsst::geom::arcseconds, 23.0 * lsst::geom::degrees));
+    MaskedImageF srcImage = makeSkyImage(size, size, 1000);
+    image::Exposure<float> const src(srcImage, srcWcs);
+    image::Exposure<float> dest(src.getDimensions(), destWcs);
+    math::WarpingControl const control(kernelName);
+    while (state.keepRunning()) {
+        math::warpExposure(dest, src, control);
+    }
+    state.setItemsProcessed(std::int64_t(size) * size);
+}
+
+AFW_REGISTER_BENCHMARK("warpExposure/lanczos3",
+                       [](State& state) { benchmarkWarpExposure(state, "lanczos3"); });
+
+AFW_REGISTER_BENCHMARK("warpExposure/bilinear",
+                       [](State& state) { benchmarkWarpExposure(state, "bilinear"); });
+
+void benchmarkStatistics(State& state, int flags) {
+    int const size = 4096;
+    MaskedImageF const image = makeSkyImage(size, size, 4000);
+    math::StatisticsControl control;
+    control.setAndMask(image::Mask<image::MaskPixel>::getPlaneBitMask("BAD"));
+    while (state.keepRunning()) {
+        doNotOptimize(math::makeStatistics(image, flags, control));
+    }
+    state.setItemsProcessed(std::int64_t(size) * size);
+}
+
+AFW_REGISTER_BENCHMARK("makeStatistics/meanStdev",
+                       [](State& state) { benchmarkStatistics(state, math::MEAN | math::STDEV); });
+
+AFW_REGISTER_BENCHMARK("makeStatistics/median",
+                       [](State& state) { benchmarkStatistics(state, math::MEDIAN | math::IQRANGE); });
+
+AFW_REGISTER_BENCHMARK("makeStatistics/meanClip",
+                       [](State& state) { benchmarkStatistics(state, math::MEANCLIP | math::STDEVCLIP); });
+
+void benchmarkStatisticsStack(State& state, math::Property flags) {
+    int const size = 1024;
+    int const nImages = 20;
+    std::vector<std::shared_ptr<MaskedImageF>> images;
+    for (int i = 0; i < nImages; ++i) {
+        images.push_back(std::make_shared<MaskedImageF>(makeSkyImage(size, size, 250, i + 1)));
+    }
+    math::StatisticsControl control;
+    control.setAndMask(image::Mask<image::MaskPixel>::getPlaneBitMask("BAD"));
+    while (state.keepRunning()) {
+        doNotOptimize(math::statisticsStack(images, flags, control));
+    }
+    state.setItemsProcessed(std::int64_t(nImages) * size * size);
+}
+
+AFW_REGISTER_BENCHMARK("statisticsStack/mean",
+                       [](State& state) { benchmarkStatisticsStack(state, math::MEAN); });
+
+AFW_REGISTER_BENCHMARK("statisticsStack/meanClip",
+                       [](State& state) { benchmarkStatisticsStack(state, math::MEANCLIP); });
+
+AFW_REGISTER_BENCHMARK("statisticsStack/median",
+                       [](State& state) { benchmarkStatisticsStack(state, math::MEDIAN); });
+
+AFW_REGISTER_BENCHMARK("FootprintSet/image", [](State& state) {
+    int const size = 4096;
+    MaskedImageF const image = makeSkyImage(size, size, 4000);
+    detection::Threshold const threshold(1005.0);
+    while (state.keepRunning()) {
+        detection::FootprintSet const footprints(*image.getImage(), threshold, 5);
+        doNotOptimize(footprints.getFootprints()->size());
+    }
+    state.setItemsProcessed(std::int64_t(size) * size);
+});
+
+AFW_REGISTER_BENCHMARK("FootprintSet/maskedImageWithPeaks", [](State& state) {
+    int const size = 4096;
+    MaskedImageF image = makeSkyImage(size, size, 4000);
+    detection::Threshold const threshold(1005.0);
+    while (state.keepRunning()) {
+        detection::FootprintSet const footprints(image, threshold, "DETECTED", 5, true);
+        doNotOptimize(footprints.getFootprints()->size());
+    }
+    state.setItemsProcessed(std::int64_t(size) * size);
+});
+
+}  // namespace
+
+}  // namespace benchmarks
+}  // namespace afw
+}  // namespace lsst
@@ -0,0 +1,406 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * End-to-end benchmarks of FITS persistence through files: exposures and source catalogs
+ *
+ * The exposure is a coadd-like 4k x 4k ExposureF with a Psf, a TAN-SIP SkyWcs, a spatially varying
+ * PhotoCalib, an ApCorrMap and CoaddInputs with a Psf, SkyWcs, PhotoCalib and ApCorrMap for each
+ * input, so that its archive is as complex as a real one.  The source catalog is wide, with a
+ * HeavyFootprint for each source.  Each is written both uncompressed and compressed (losslessly), and
+ * read back whole, as a cutout, and (for the exposure) one component at a time.
+ *
+ * The files are written in the runner's --scratch-dir, so the same benchmarks time a local disk or a
+ * network filesystem.  Reads are usually served by the operating system's page cache, as the files
+ * were just written; the byteRange benchmarks instead read through a fits::ByteRangeCache, as from
+ * an object store, and report the number of bytes fetched.
+ */
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Eigen/Core"
+#include "lsst/geom.h"
+#include "lsst/afw/detection/Footprint.h"
+#include "lsst/afw/detection/GaussianPsf.h"
+#include "lsst/afw/detection/HeavyFootprint.h"
+#include "lsst/afw/fits.h"
+#include "lsst/afw/fitsByteRange.h"
+#include "lsst/afw/geom/SkyWcs.h"
+#include "lsst/afw/geom/SpanSet.h"
+#include "lsst/afw/image/ApCorrMap.h"
+#include "lsst/afw/image/CoaddInputs.h"
+#include "lsst/afw/image/Exposure.h"
+#include "lsst/afw/image/ExposureFitsReader.h"
+#include "lsst/afw/image/PhotoCalib.h"
+#include "lsst/afw/math/ChebyshevBoundedField.h"
+#include "lsst/afw/math/Random.h"
+#include "lsst/afw/table/Exposure.h"
+#include "lsst/afw/table/Source.h"
+
+#include "Benchmark.h"
+
+namespace lsst {
+namespace afw {
+namespace benchmarks {
+
+namespace {
+
+int const CCD_SIZE = 4096;
+int const CUTOUT_SIZE = 512;
+int const N_VISITS = 20;
+int const N_CCDS_PER_VISIT = 5;
+int const N_AP_CORR_FIELDS = 10;
+int const N_SOURCES = 20000;
+int const N_MEASUREMENTS = 100;
+
+// Bytes of a pixel of an ExposureF: image, mask and variance
+std::size_t const PIXEL_SIZE = sizeof(float) + sizeof(image::MaskPixel) + sizeof(image::VariancePixel);
+
+/*
+ * A file in the scratch directory with a unique name, removed when the object is destroyed
+ */
+class ScratchFile final {
+public:
+    ScratchFile() {
+        static std::atomic<int> count(0);
+        _path = getScratchDirectory() + "/afwBenchmark-" + std::to_string(::getpid()) + "-" +
+                std::to_string(count++) + ".fits";
+    }
+
+    ScratchFile(ScratchFile const&) = delete;
+    ScratchFile& operator=(ScratchFile const&) = delete;
+
+    ~ScratchFile() { std::remove(_path.c_str()); }
+
+    std::string const& getPath() const { return _path; }
+
+    std::size_t getSize() const { return std::filesystem::file_size(_path); }
+
+private:
+    std::string _path;
+};
+
+lsst::geom::Box2I const CCD_BBOX(lsst::geom::Point2I(0, 0), lsst::geom::Extent2I(CCD_SIZE, CCD_SIZE));
+
+lsst::geom::Box2I const CUTOUT_BBOX(lsst::geom::Point2I(CCD_SIZE / 2, CCD_SIZE / 2),
+                                    lsst::geom::Extent2I(CUTOUT_SIZE, CUTOUT_SIZE));
+
+// A TAN-SIP WCS of 0.2 arcsecond pixels with third-order distortion, both forward and inverse
+std::shared_ptr<geom::SkyWcs> makeWcs(lsst::geom::SpherePoint const& crval, double rotation) {
+    Eigen::MatrixXd sipA = Eigen::MatrixXd::Zero(4, 4);
+    Eigen::MatrixXd sipB = Eigen::MatrixXd::Zero(4, 4);
+    sipA(2, 0) = 1e-7;
+    sipA(0, 2) = -2e-7;
+    sipA(3, 0) = 3e-11;
+    sipB(1, 1) = 1.5e-7;
+    sipB(0, 3) = -2e-11;
+    Eigen::MatrixXd const sipAp = -sipA;
+    Eigen::MatrixXd const sipBp = -sipB;
+    Eigen::Matrix2d const cdMatrix =
+            geom::makeCdMatrix(0.2 * lsst::geom::arcseconds, rotation * lsst::geom::degrees);
+    return geom::makeTanSipWcs(lsst::geom::Point2D(CCD_SIZE / 2, CCD_SIZE / 2), crval, cdMatrix, sipA, sipB,
+                               sipAp, sipBp);
+}
+
+// A smooth field of second order over the CCD, near `mean`
+std::shared_ptr<math::ChebyshevBoundedField> makeField(double mean, math::Random& rand) {
+    ndarray::Array<double, 2, 2> coefficients = ndarray::allocate(3, 3);
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            coefficients[i][j] = (i == 0 && j == 0) ? mean : mean * rand.flat(-0.01, 0.01);
+        }
+    }
+    return std::make_shared<math::ChebyshevBoundedField>(CCD_BBOX, coefficients);
+}
+
+std::shared_ptr<image::PhotoCalib> makePhotoCalib(math::Random& rand) {
+    return std::make_shared<image::PhotoCalib>(makeField(rand.flat(0.5, 2.0), rand), 0.01);
+}
+
+std::shared_ptr<image::ApCorrMap> makeApCorrMap(math::Random& rand) {
+    auto result = std::make_shared<image::ApCorrMap>();
+    for (int i = 0; i < N_AP_CORR_FIELDS; ++i) {
+        std::string const name = "measurement" + std::to_string(i);
+        result->set(name + "_instFlux", makeField(rand.flat(0.95, 1.05), rand));
+        result->set(name + "_instFluxErr", makeField(rand.flat(0.001, 0.01), rand));
+    }
+    return result;
+}
+
+// Inputs of N_VISITS visits of several CCDs each, with distinct components so that none are shared
+std::shared_ptr<image::CoaddInputs> makeCoaddInputs(math::Random& rand) {
+    table::Schema const schema = table::ExposureTable::makeMinimalSchema();
+    auto result = std::make_shared<image::CoaddInputs>(schema, schema);
+    lsst::geom::SpherePoint const center(45.0 * lsst::geom::degrees, -30.0 * lsst::geom::degrees);
+    for (int visit = 0; visit < N_VISITS; ++visit) {
+        auto visitRecord = result->visits.addNew();
+        visitRecord->setId(visit);
+        visitRecord->setBBox(CCD_BBOX);
+        for (int ccd = 0; ccd < N_CCDS_PER_VISIT; ++ccd) {
+            auto ccdRecord = result->ccds.addNew();
+            ccdRecord->setId(visit * N_CCDS_PER_VISIT + ccd);
+            ccdRecord->setBBox(CCD_BBOX);
+            ccdRecord->setPsf(std::make_shared<detection::GaussianPsf>(25, 25, rand.flat(1.5, 3.0)));
+            ccdRecord->setWcs(makeWcs(center.offset(rand.flat(0.0, 360.0) * lsst::geom::degrees,
+                                                    rand.flat(0.0, 0.1) * lsst::geom::degrees),
+                                      rand.flat(0.0, 360.0)));
+            ccdRecord->setPhotoCalib(makePhotoCalib(rand));
+            ccdRecord->setApCorrMap(makeApCorrMap(rand));
+        }
+    }
+    return result;
+}
+
+// A coadd-like exposure: unit-variance noise on a sky of 1000 counts, and all the common components
+image::ExposureF makeExposure() {
+    image::ExposureF result(CCD_BBOX);
+    math::Random rand(math::Random::PHILOX4X32, 1);
+    auto maskedImage = result.getMaskedImage();  // shares the pixels of result
+    math::randomGaussianImage(maskedImage.getImage().get(), rand, 0);
+    *maskedImage.getImage() += 1000.0f;
+    *maskedImage.getVariance() = 1.0f;
+    *maskedImage.getMask() = 0;
+    result.setPsf(std::make_shared<detection::GaussianPsf>(25, 25, 2.0));
+    result.setWcs(makeWcs(lsst::geom::SpherePoint(45.0 * lsst::geom::degrees, -30.0 * lsst::geom::degrees),
+                          0.0));
+    result.setPhotoCalib(makePhotoCalib(rand));
+    result.getInfo()->setApCorrMap(makeApCorrMap(rand));
+    result.getInfo()->setCoaddInputs(makeCoaddInputs(rand));
+    return result;
+}
+
+image::ExposureF const& getExposure() {
+    static image::ExposureF const exposure = makeExposure();
+    return exposure;
+}
+
+/*
+ * A source catalog with a schema like that of a coadd measurement catalog (N_MEASUREMENTS
+ * measurements with errors and flags) and a HeavyFootprint of a few dozen to a few hundred pixels
+ * for each source
+ */
+table::SourceCatalog makeSourceCatalog() {
+    table::Schema schema = table::SourceTable::makeMinimalSchema();
+    std::vector<table::Key<double>> fluxKeys;
+    std::vector<table::Key<float>> errKeys;
+    std::vector<table::Key<table::Flag>> flagKeys;
+    for (int i = 0; i < N_MEASUREMENTS; ++i) {
+        std::string const name = "measurement" + std::to_string(i);
+        fluxKeys.push_back(schema.addField<double>(name + "_instFlux", "a measurement", "count"));
+        errKeys.push_back(schema.addField<float>(name + "_instFluxErr", "its uncertainty", "count"));
+        flagKeys.push_back(schema.addField<table::Flag>(name + "_flag", "whether the measurement failed"));
+    }
+    table::SourceCatalog result(table::SourceTable::make(schema));
+    result.reserve(N_SOURCES);
+    auto const maskedImage = getExposure().getMaskedImage();
+    math::Random rand(math::Random::PHILOX4X32, 2);
+    for (int i = 0; i < N_SOURCES; ++i) {
+        auto record = result.addNew();
+        int const radius = rand.flat(2.0, 8.0);
+        int const x = rand.flat(radius, CCD_SIZE - radius - 1);
+        int const y = rand.flat(radius, CCD_SIZE - radius - 1);
+        auto spans = geom::SpanSet::fromShape(radius)->shiftedBy(x, y);
+        auto footprint = std::make_shared<detection::Footprint>(spans, CCD_BBOX);
+        footprint->addPeak(x, y, maskedImage.getImage()->get(lsst::geom::Point2I(x, y), image::PARENT));
+        record->setFootprint(std::make_shared<detection::HeavyFootprint<float>>(*footprint, maskedImage));
+        for (std::size_t j = 0; j < fluxKeys.size(); ++j) {
+            record->set(fluxKeys[j], rand.flat(0.0, 1e5));
+            record->set(errKeys[j], rand.flat(1.0, 100.0));
+            record->set(flagKeys[j], rand.uniform() < 0.05);
+        }
+    }
+    return result;
+}
+
+table::SourceCatalog const& getSourceCatalog() {
+    static table::SourceCatalog const catalog = makeSourceCatalog();
+    return catalog;
+}
+
+void writeExposure(std::string const& path, bool compressed) {
+    if (!compressed) {
+        getExposure().writeFits(path);
+        return;
+    }
+    fits::ImageWriteOptions const options(
+            fits::ImageCompressionOptions(fits::ImageCompressionOptions::GZIP_SHUFFLE));
+    getExposure().writeFits(path, options, options, options);
+}
+
+void writeSourceCatalog(std::string const& path, bool compressed) {
+    fits::Fits fitsfile(path, "w", fits::Fits::AUTO_CLOSE | fits::Fits::AUTO_CHECK);
+    if (compressed) {
+        fitsfile.setTableCompression(
+                fits::TableCompressionOptions(fits::ImageCompressionOptions::GZIP_SHUFFLE));
+    }
+    getSourceCatalog().writeFits(fitsfile);
+}
+
+void benchmarkWriteExposure(State& state, bool compressed) {
+    getExposure();
+    ScratchFile file;
+    while (state.keepRunning()) {
+        writeExposure(file.getPath(), compressed);
+    }
+    state.setItemsProcessed(CCD_BBOX.getArea());
+    state.setBytesProcessed(file.getSize());
+}
+
+void benchmarkReadExposure(State& state, bool compressed) {
+    ScratchFile file;
+    writeExposure(file.getPath(), compressed);
+    while (state.keepRunning()) {
+        doNotOptimize(image::ExposureF(file.getPath()));
+    }
+    state.setItemsProcessed(CCD_BBOX.getArea());
+    state.setBytesProcessed(file.getSize());
+}
+
+// Bytes reported are those of the pixels of the cutout, as only they are read
+void benchmarkReadCutout(State& state, bool compressed) {
+    ScratchFile file;
+    writeExposure(file.getPath(), compressed);
+    while (state.keepRunning()) {
+        doNotOptimize(image::ExposureF(file.getPath(), CUTOUT_BBOX));
+    }
+    state.setItemsProcessed(CUTOUT_BBOX.getArea());
+    state.setBytesProcessed(CUTOUT_BBOX.getArea() * PIXEL_SIZE);
+}
+
+// Each iteration reads through a new, empty cache, and bytes reported are those fetched
+void benchmarkReadCutoutByteRange(State& state, bool compressed) {
+    ScratchFile file;
+    writeExposure(file.getPath(), compressed);
+    auto const source = std::make_shared<fits::FileByteRangeSource>(file.getPath());
+    std::size_t bytesFetched = 0;
+    while (state.keepRunning()) {
+        auto cache = std::make_shared<fits::ByteRangeCache>(source);
+        image::ExposureFitsReader reader(cache);
+        doNotOptimize(reader.read<float>(CUTOUT_BBOX));
+        bytesFetched = cache->getBytesFetched();
+    }
+    state.setItemsProcessed(CUTOUT_BBOX.getArea());
+    state.setBytesProcessed(bytesFetched);
+}
+
+template <typename Function>
+void benchmarkReadComponent(State& state, Function function) {
+    ScratchFile file;
+    writeExposure(file.getPath(), false);
+    while (state.keepRunning()) {
+        image::ExposureFitsReader reader(file.getPath());
+        doNotOptimize(function(reader));
+    }
+}
+
+void benchmarkWriteSources(State& state, bool compressed) {
+    getSourceCatalog();
+    ScratchFile file;
+    while (state.keepRunning()) {
+        writeSourceCatalog(file.getPath(), compressed);
+    }
+    state.setItemsProcessed(N_SOURCES);
+    state.setBytesProcessed(file.getSize());
+}
+
+void benchmarkReadSources(State& state, bool compressed, int flags) {
+    ScratchFile file;
+    writeSourceCatalog(file.getPath(), compressed);
+    while (state.keepRunning()) {
+        doNotOptimize(table::SourceCatalog::readFits(file.getPath(), fits::DEFAULT_HDU, flags));
+    }
+    state.setItemsProcessed(N_SOURCES);
+    state.setBytesProcessed(file.getSize());
+}
+
+AFW_REGISTER_BENCHMARK("exposureFits/write", [](State& state) { benchmarkWriteExposure(state, false); });
+
+AFW_REGISTER_BENCHMARK("exposureFits/write/compressed",
+                       [](State& state) { benchmarkWriteExposure(state, true); });
+
+AFW_REGISTER_BENCHMARK("exposureFits/read", [](State& state) { benchmarkReadExposure(state, false); });
+
+AFW_REGISTER_BENCHMARK("exposureFits/read/compressed",
+                       [](State& state) { benchmarkReadExposure(state, true); });
+
+AFW_REGISTER_BENCHMARK("exposureFits/readCutout", [](State& state) { benchmarkReadCutout(state, false); });
+
+AFW_REGISTER_BENCHMARK("exposureFits/readCutout/compressed",
+                       [](State& state) { benchmarkReadCutout(state, true); });
+
+AFW_REGISTER_BENCHMARK("exposureFits/readCutout/byteRange",
+                       [](State& state) { benchmarkReadCutoutByteRange(state, false); });
+
+AFW_REGISTER_BENCHMARK("exposureFits/readCutout/byteRange/compressed",
+                       [](State& state) { benchmarkReadCutoutByteRange(state, true); });
+
+AFW_REGISTER_BENCHMARK("exposureFits/readComponent/psf", [](State& state) {
+    benchmarkReadComponent(state, [](image::ExposureFitsReader& reader) { return reader.readPsf(); });
+});
+
+AFW_REGISTER_BENCHMARK("exposureFits/readComponent/wcs", [](State& state) {
+    benchmarkReadComponent(state, [](image::ExposureFitsReader& reader) { return reader.readWcs(); });
+});
+
+AFW_REGISTER_BENCHMARK("exposureFits/readComponent/photoCalib", [](State& state) {
+    benchmarkReadComponent(state, [](image::ExposureFitsReader& reader) { return reader.readPhotoCalib(); });
+});
+
+AFW_REGISTER_BENCHMARK("exposureFits/readComponent/coaddInputs", [](State& state) {
+    benchmarkReadComponent(state,
+                           [](image::ExposureFitsReader& reader) { return reader.readCoaddInputs(); });
+});
+
+AFW_REGISTER_BENCHMARK("exposureFits/readComponent/exposureInfo", [](State& state) {
+    benchmarkReadComponent(state,
+                           [](image::ExposureFitsReader& reader) { return reader.readExposureInfo(); });
+});
+
+AFW_REGISTER_BENCHMARK("sourceFits/write", [](State& state) { benchmarkWriteSources(state, false); });
+
+AFW_REGISTER_BENCHMARK("sourceFits/write/compressed",
+                       [](State& state) { benchmarkWriteSources(state, true); });
+
+AFW_REGISTER_BENCHMARK("sourceFits/read", [](State& state) { benchmarkReadSources(state, false, 0); });
+
+AFW_REGISTER_BENCHMARK("sourceFits/read/compressed",
+                       [](State& state) { benchmarkReadSources(state, true, 0); });
+
+AFW_REGISTER_BENCHMARK("sourceFits/read/noHeavyFootprints", [](State& state) {
+    benchmarkReadSources(state, false, table::SOURCE_IO_NO_HEAVY_FOOTPRINTS);
+});
+
+}  // namespace
+
+}  // namespace benchmarks
+}  // namespace afw
+}  // namespace lsst
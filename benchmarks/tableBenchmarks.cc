@@ -0,0 +1,166 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Benchmarks of catalogs: spatial matching and FITS persistence
+ */
+
+#include <cmath>
+#include <string>
+
+#include "lsst/geom.h"
+#include "lsst/afw/fits.h"
+#include "lsst/afw/math/Random.h"
+#include "lsst/afw/table/Match.h"
+#include "lsst/afw/table/Simple.h"
+#include "lsst/afw/table/Source.h"
+
+#include "Benchmark.h"
+
+namespace lsst {
+namespace afw {
+namespace benchmarks {
+
+namespace {
+
+int const N_RECORDS = 100000;
+
+// Catalog positions uniformly distributed over a field 1 degree in radius
+table::SimpleCatalog makeSimpleCatalog(int n, unsigned long seed) {
+    table::SimpleCatalog result(table::SimpleTable::make(table::SimpleTable::makeMinimalSchema()));
+    result.reserve(n);
+    math::Random rand(math::Random::PHILOX4X32, seed);
+    lsst::geom::SpherePoint const center(45.0 * lsst::geom::degrees, -30.0 * lsst::geom::degrees);
+    for (int i = 0; i < n; ++i) {
+        auto record = result.addNew();
+        record->setId(i + 1);
+        lsst::geom::Angle const bearing = rand.flat(0.0, 360.0) * lsst::geom::degrees;
+        lsst::geom::Angle const distance = std::sqrt(rand.uniform()) * lsst::geom::degrees;
+        record->setCoord(center.offset(bearing, distance));
+    }
+    return result;
+}
+
+// The same positions, perturbed by up to 0.5 arcseconds, with 10% of them replaced
+table::SimpleCatalog perturbCatalog(table::SimpleCatalog const& catalog, unsigned long seed) {
+    table::SimpleCatalog result(table::SimpleTable::make(catalog.getSchema()));
+    table::SimpleCatalog const others = makeSimpleCatalog(catalog.size(), seed + 1);
+    result.reserve(catalog.size());
+    math::Random rand(math::Random::PHILOX4X32, seed);
+    for (std::size_t i = 0; i < catalog.size(); ++i) {
+        auto record = result.addNew();
+        record->setId(catalog[i].getId());
+        if (rand.uniform() < 0.1) {
+            record->setCoord(others[i].getCoord());
+        } else {
+            lsst::geom::Angle const bearing = rand.flat(0.0, 360.0) * lsst::geom::degrees;
+            lsst::geom::Angle const distance = rand.flat(0.0, 0.5) * lsst::geom::arcseconds;
+            record->setCoord(catalog[i].getCoord().offset(bearing, distance));
+        }
+    }
+    return result;
+}
+
+void benchmarkMatchRaDec(State& state, int numThreads) {
+    table::SimpleCatalog const cat1 = makeSimpleCatalog(N_RECORDS, 1);
+    table::SimpleCatalog const cat2 = perturbCatalog(cat1, 2);
+    table::MatchControl control;
+    control.numThreads = numThreads;
+    while (state.keepRunning()) {
+        doNotOptimize(table::matchRaDec(cat1, cat2, 1.0 * lsst::geom::arcseconds, control));
+    }
+    state.setItemsProcessed(2 * N_RECORDS);
+}
+
+AFW_REGISTER_BENCHMARK("matchRaDec/twoCatalogs", [](State& state) { benchmarkMatchRaDec(state, 1); });
+
+AFW_REGISTER_BENCHMARK("matchRaDec/twoCatalogs/allThreads",
+                       [](State& state) { benchmarkMatchRaDec(state, 0); });
+
+AFW_REGISTER_BENCHMARK("matchRaDec/selfMatch", [](State& state) {
+    table::SimpleCatalog const cat = makeSimpleCatalog(N_RECORDS, 1);
+    while (state.keepRunning()) {
+        doNotOptimize(table::matchRaDec(cat, 2.0 * lsst::geom::arcseconds));
+    }
+    state.setItemsProcessed(N_RECORDS);
+});
+
+/*
+ * A source catalog with a schema like that of a single-frame measurement catalog: a few dozen
+ * measurements with errors, and flags
+ */
+table::SourceCatalog makeSourceCatalog(int n) {
+    table::Schema schema = table::SourceTable::makeMinimalSchema();
+    std::vector<table::Key<double>> fluxKeys;
+    std::vector<table::Key<float>> errKeys;
+    std::vector<table::Key<table::Flag>> flagKeys;
+    for (int i = 0; i < 40; ++i) {
+        std::string const name = "measurement" + std::to_string(i);
+        fluxKeys.push_back(schema.addField<double>(name + "_instFlux", "a measurement", "count"));
+        errKeys.push_back(schema.addField<float>(name + "_instFluxErr", "its uncertainty", "count"));
+        flagKeys.push_back(schema.addField<table::Flag>(name + "_flag", "whether the measurement failed"));
+    }
+    table::SourceCatalog result(table::SourceTable::make(schema));
+    result.reserve(n);
+    math::Random rand(math::Random::PHILOX4X32, 3);
+    for (int i = 0; i < n; ++i) {
+        auto record = result.addNew();
+        record->setCoord(lsst::geom::SpherePoint(rand.flat(0.0, 360.0), rand.flat(-90.0, 90.0),
+                                                 lsst::geom::degrees));
+        for (std::size_t j = 0; j < fluxKeys.size(); ++j) {
+            record->set(fluxKeys[j], rand.flat(0.0, 1e5));
+            record->set(errKeys[j], rand.flat(1.0, 100.0));
+            record->set(flagKeys[j], rand.uniform() < 0.05);
+        }
+    }
+    return result;
+}
+
+AFW_REGISTER_BENCHMARK("catalogFits/write", [](State& state) {
+    table::SourceCatalog const catalog = makeSourceCatalog(N_RECORDS);
+    std::size_t size = 0;
+    while (state.keepRunning()) {
+        fits::MemFileManager manager;
+        catalog.writeFits(manager);
+        size = manager.getLength();
+    }
+    state.setItemsProcessed(N_RECORDS);
+    state.setBytesProcessed(size);
+});
+
+AFW_REGISTER_BENCHMARK("catalogFits/read", [](State& state) {
+    fits::MemFileManager manager;
+    makeSourceCatalog(N_RECORDS).writeFits(manager);
+    while (state.keepRunning()) {
+        doNotOptimize(table::SourceCatalog::readFits(manager));
+    }
+    state.setItemsProcessed(N_RECORDS);
+    state.setBytesProcessed(manager.getLength());
+});
+
+}  // namespace
+
+}  // namespace benchmarks
+}  // namespace afw
+}  // namespace lsst
@@ -23,6 +23,8 @@
 #if !defined(LSST_AFW_CAMERAGEOM_H)
 #define LSST_AFW_CAMERAGEOM_H
 
+#include "lsst/afw/cameraGeom/AmplifierCorrections.h"
+#include "lsst/afw/cameraGeom/AssembleImage.h"
 #include "lsst/afw/cameraGeom/CameraSys.h"
 #include "lsst/afw/cameraGeom/Detector.h"
 #include "lsst/afw/cameraGeom/Orientation.h"
@@ -0,0 +1,128 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_CAMERAGEOM_AMPLIFIERCORRECTIONS_H
+#define LSST_AFW_CAMERAGEOM_AMPLIFIERCORRECTIONS_H
+
+#include <vector>
+
+#include "ndarray.h"
+
+#include "lsst/afw/image/Image.h"
+#include "lsst/afw/math/Statistics.h"
+#include "lsst/afw/cameraGeom/Detector.h"
+
+namespace lsst {
+namespace afw {
+namespace cameraGeom {
+
+/*
+ * Amplifier-level corrections of raw detector images, done for all the amplifiers of a detector in
+ * one call.
+ *
+ * All of these work on a raw image in the amplifiers' raw coordinates (as for
+ * assembleDetectorImage): the boxes used are each amplifier's raw data and raw horizontal overscan
+ * boxes, in PARENT coordinates.  A typical sequence is to measure the overscan, correct the raw data
+ * regions, and then assemble the corrected image.
+ */
+
+/**
+ * Measure the level of the horizontal (serial) overscan of each amplifier.
+ *
+ * Non-finite pixels are ignored; an amplifier with no finite overscan pixels has a level of NaN.
+ *
+ * @param detector detector whose amplifiers describe the raw layout
+ * @param rawImage raw image containing the raw horizontal overscan box of every amplifier
+ * @param statistic statistic to compute: math::MEAN or math::MEDIAN
+ * @param numThreads number of threads to use; 0 means one per hardware thread
+ * @returns one level per amplifier, in the order of the detector's amplifiers
+ *
+ * @throws lsst::pex::exceptions::LengthError if an amplifier's overscan box is not contained in the
+ *         raw image
+ * @throws lsst::pex::exceptions::InvalidParameterError if the statistic is not supported, or if
+ *         numThreads < 0
+ */
+template <typename PixelT>
+std::vector<double> measureOverscanLevels(Detector const &detector, image::Image<PixelT> const &rawImage,
+                                          math::Property statistic = math::MEDIAN, int numThreads = 1);
+
+/**
+ * Measure the level of the horizontal (serial) overscan of each row of each amplifier.
+ *
+ * Element `j` of an amplifier's array is the statistic of the overscan pixels in row
+ * `amp.getRawDataBBox().getMinY() + j`, i.e. there is one element per row of the amplifier's raw data
+ * box, ready to be passed to correctAmplifiers.  Non-finite pixels are ignored; a row with no finite
+ * overscan pixels has a level of NaN.
+ *
+ * @param detector detector whose amplifiers describe the raw layout
+ * @param rawImage raw image containing the raw horizontal overscan box of every amplifier
+ * @param statistic statistic to compute: math::MEAN or math::MEDIAN
+ * @param numThreads number of threads to use; 0 means one per hardware thread
+ * @returns one array per amplifier, in the order of the detector's amplifiers
+ *
+ * @throws lsst::pex::exceptions::LengthError if an amplifier's overscan box is not contained in the
+ *         raw image, or does not span the rows of its raw data box
+ * @throws lsst::pex::exceptions::InvalidParameterError if the statistic is not supported, or if
+ *         numThreads < 0
+ */
+template <typename PixelT>
+std::vector<ndarray::Array<double, 1, 1>> measureOverscanRows(Detector const &detector,
+                                                              image::Image<PixelT> const &rawImage,
+                                                              math::Property statistic = math::MEDIAN,
+                                                              int numThreads = 1);
+
+/**
+ * Correct the raw data region of every amplifier of a raw image, in place.
+ *
+ * Each pixel `v` of an amplifier's raw data box is replaced by `(u + L(u)) * g`, where
+ * `u = v - offset` with the offset taken from `offsets`, `L` is the amplifier's linearity correction
+ * and `g` its gain.  The supported linearity types are "None" (or an empty string), "Squared"
+ * (`L(u) = c[0] u^2`) and "Polynomial" (`L(u) = sum_i c[i] u^(i + 2)`), where `c` are the
+ * amplifier's linearity coefficients.  Pixels outside the raw data boxes are not changed.
+ *
+ * @param rawImage raw image containing the raw data box of every amplifier
+ * @param detector detector whose amplifiers describe the raw layout
+ * @param offsets levels to subtract, one array per amplifier in the order of the detector's
+ *                amplifiers, each with either one element for the whole amplifier or one per row of
+ *                its raw data box (as returned by measureOverscanRows); empty to subtract nothing
+ * @param doLinearity if true, apply each amplifier's linearity correction
+ * @param doGain if true, multiply by each amplifier's gain
+ * @param numThreads number of threads to use; 0 means one per hardware thread
+ *
+ * @throws lsst::pex::exceptions::LengthError if an amplifier's raw data box is not contained in the
+ *         raw image, if `offsets` is neither empty nor has one array per amplifier, or if an array
+ *         has the wrong size
+ * @throws lsst::pex::exceptions::InvalidParameterError if doLinearity and an amplifier has an
+ *         unsupported linearity type, or if numThreads < 0
+ */
+template <typename PixelT>
+void correctAmplifiers(image::Image<PixelT> &rawImage, Detector const &detector,
+                       std::vector<ndarray::Array<double const, 1, 1>> const &offsets,
+                       bool doLinearity = true, bool doGain = true, int numThreads = 1);
+
+}  // namespace cameraGeom
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_CAMERAGEOM_AMPLIFIERCORRECTIONS_H
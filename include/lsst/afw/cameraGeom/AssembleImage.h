@@ -0,0 +1,95 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LSST_AFW_CAMERAGEOM_ASSEMBLEIMAGE_H
+#define LSST_AFW_CAMERAGEOM_ASSEMBLEIMAGE_H
+
+#include <memory>
+#include <vector>
+
+#include "lsst/afw/cameraGeom/Detector.h"
+
+namespace lsst {
+namespace afw {
+namespace cameraGeom {
+
+/**
+ * Assemble the image of a detector from its raw amplifier images.
+ *
+ * This does the work of calling assembleAmplifierImage (or assembleAmplifierRawImage) on each
+ * amplifier of the detector: for each amplifier, the pixels of its raw data box (or, if
+ * `isTrimmed` is false, its whole raw box) are copied from the raw image, flipped as required by
+ * the amplifier's raw flip flags, to its box in the assembled image (or to its raw box shifted by
+ * the amplifier's raw offset). The copy plan is worked out for all amplifiers before any pixels
+ * are copied, and the amplifiers are then copied concurrently.
+ *
+ * @param detector detector whose amplifiers describe the raw layout
+ * @param rawImage raw image containing the raw box of every amplifier (in PARENT coordinates);
+ *                 an Image or MaskedImage
+ * @param isTrimmed if true, assemble the data regions only into an image with bounding box
+ *                  detector.getBBox(); if false, assemble the whole raw amplifier regions, including
+ *                  prescan and overscan, into an image bounded by their shifted raw boxes
+ * @param numThreads number of threads to use; 0 means one per hardware thread
+ * @returns the assembled image; pixels not covered by any amplifier are 0
+ *
+ * @throws lsst::pex::exceptions::LengthError if an amplifier's raw box is not contained in the
+ *         raw image, or if isTrimmed and an amplifier's box is not contained in detector.getBBox()
+ * @throws lsst::pex::exceptions::InvalidParameterError if the detector has no amplifiers, if the
+ *         raw and assembled boxes of an amplifier have different dimensions, or if numThreads < 0
+ */
+template <typename ImageT>
+std::shared_ptr<ImageT> assembleDetectorImage(Detector const &detector, ImageT const &rawImage,
+                                              bool isTrimmed = true, int numThreads = 1);
+
+/**
+ * Assemble the image of a detector from one raw image per amplifier.
+ *
+ * This is the form to use for cameras that store each amplifier in a separate image. It is
+ * otherwise identical to the single-image form.
+ *
+ * @param detector detector whose amplifiers describe the raw layout
+ * @param rawImages raw images, one per amplifier in the order of the detector's amplifiers; each
+ *                  must contain the raw box of its amplifier
+ * @param isTrimmed if true, assemble the data regions only; if false, the whole raw regions
+ * @param numThreads number of threads to use; 0 means one per hardware thread
+ * @returns the assembled image; pixels not covered by any amplifier are 0
+ *
+ * @throws lsst::pex::exceptions::LengthError if the number of images differs from the number of
+ *         amplifiers, if an amplifier's raw box is not contained in its raw image, or if isTrimmed
+ *         and an amplifier's box is not contained in detector.getBBox()
+ * @throws lsst::pex::exceptions::InvalidParameterError if the detector has no amplifiers, if any
+ *         image is null, if the raw and assembled boxes of an amplifier have different dimensions,
+ *         or if numThreads < 0
+ */
+template <typename ImageT>
+std::shared_ptr<ImageT> assembleDetectorImage(Detector const &detector,
+                                              std::vector<std::shared_ptr<ImageT const>> const &rawImages,
+                                              bool isTrimmed = true, int numThreads = 1);
+
+}  // namespace cameraGeom
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_CAMERAGEOM_ASSEMBLEIMAGE_H
@@ -24,6 +24,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "lsst/afw/cameraGeom/DetectorCollection.h"
 #include "lsst/afw/cameraGeom/TransformMap.h"
@@ -81,6 +82,10 @@ public:
      * @param[in] point  position to use in lookup (lsst::geom::Point2D)
      * @param[in] cameraSys  camera coordinate system of `point`
      * @returns a list of zero or more Detectors that overlap the specified point
+     *
+     * Candidate detectors are chosen from a focal-plane grid of detector
+     * footprints, built on first use, so only detectors near the point are
+     * transformed to their pixel frames.
      */
     DetectorList findDetectors(lsst::geom::Point2D const &point, CameraSys const &cameraSys) const;
 
@@ -91,6 +96,10 @@ public:
      * @param[in] cameraSys the camera coordinate system of the points in `pointList`
      * @returns a list of lists; each list contains the names of all detectors
      *    which contain the corresponding point
+     *
+     * The points are transformed to the focal plane in one call and binned
+     * against the same footprint grid as findDetectors; each detector then
+     * transforms only the points that fall near it, in a single call.
      */
     std::vector<DetectorList> findDetectorsList(std::vector<lsst::geom::Point2D> const &pointList,
                                                 CameraSys const &cameraSys) const;
@@ -189,11 +198,19 @@ private:
 
     std::string getPersistenceName() const override;
 
+    // Grid over the detectors' focal-plane footprints, used by findDetectors
+    // and findDetectorsList to skip detectors far from a point.
+    struct DetectorIndex;
+
+    // Return _detectorIndex, building its contents on first call.
+    DetectorIndex const & _getDetectorIndex() const;
+
     // getPythonModule implementation inherited from DetectorCollection.
 
     std::string _name;
     std::string _pupilFactoryName;
     std::shared_ptr<TransformMap const> _transformMap;
+    std::shared_ptr<DetectorIndex> _detectorIndex;
 };
 
 
@@ -23,8 +23,11 @@
 #define LSST_AFW_CAMERAGEOM_TRANSFORMMAP_H
 
 #include <vector>
+#include <map>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
+#include <utility>
 
 #include "boost/iterator/transform_iterator.hpp"
 #include "astshim/FrameSet.h"
@@ -156,10 +159,14 @@ public:
     /**
      * Convert a list of points from one coordinate system to another.
      *
+     * Long lists may be split across up to `numThreads` threads (0 means one per hardware thread),
+     * as for geom::Transform::applyForward.
+     *
      * @overload
      */
     std::vector<lsst::geom::Point2D> transform(std::vector<lsst::geom::Point2D> const &pointList,
-                                               CameraSys const &fromSys, CameraSys const &toSys) const;
+                                               CameraSys const &fromSys, CameraSys const &toSys,
+                                               int numThreads = 1) const;
 
     CameraSysIterator begin() const { return boost::make_transform_iterator(_frameIds.begin(), GetKey()); }
 
@@ -182,6 +189,9 @@ public:
      * @returns a Transform that converts from `fromSys` to `toSys` in the forward direction.
      *      The Transform will be invertible.
      *
+     * The simplified mapping for each pair of systems is built once and cached; each call returns
+     * a new Transform holding its own copy.
+     *
      * @throws lsst::pex::exceptions::InvalidParameterError Thrown if either
      *         `fromSys` or `toSys` is not supported.
      */
@@ -230,16 +240,21 @@ private:
      */
     int _getFrame(CameraSys const &system) const;
 
+    // A simplified Mapping between two frames, with the lock that must be held while it is used.
+    struct CachedMapping;
+
     /*
-     * Return ast::Mapping that transforms between two coordinate systems.
+     * Return the cached ast::Mapping that transforms between two coordinate systems, making and
+     * simplifying it on first use.
      *
      * @param fromSys, toSys  Coordinate systems between which to transform
-     * @return an invertible Mapping that converts from `fromSys` to `toSys`
+     * @return an invertible Mapping that converts from `fromSys` to `toSys`; lock its mutex while
+     *         using it, as AST objects must not be used by two threads at once
      *
      * @throws lsst::pex::exceptions::InvalidParameterError Thrown if either
      *         `fromSys` or `toSys` is not supported.
      */
-    std::shared_ptr<ast::Mapping const> _getMapping(CameraSys const &fromSys, CameraSys const &toSys) const;
+    std::shared_ptr<CachedMapping> _getMapping(CameraSys const &fromSys, CameraSys const &toSys) const;
 
     std::string getPersistenceName() const override;
 
@@ -263,6 +278,11 @@ private:
      */
     CameraSysFrameIdMap _frameIds;
 
+    // Mappings already built by _getMapping, keyed by (from, to) frame ID; _cacheMutex guards both
+    // this and _frameSet.
+    mutable std::mutex _cacheMutex;
+    mutable std::map<std::pair<int, int>, std::shared_ptr<CachedMapping>> _mappingCache;
+
 };
 
 
@@ -27,6 +27,7 @@
 #define LSST_AFW_COORD_H
 
 #include "lsst/afw/coord/Observatory.h"
+#include "lsst/afw/coord/Refraction.h"
 #include "lsst/afw/coord/Weather.h"
 
 #endif  // LSST_AFW_COORD_H
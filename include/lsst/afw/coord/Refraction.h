@@ -0,0 +1,89 @@
+// -*- lsst-c++ -*-
+
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_COORD_REFRACTION_H_INCLUDED
+#define LSST_AFW_COORD_REFRACTION_H_INCLUDED
+
+#include "ndarray.h"
+
+#include "lsst/afw/coord/Observatory.h"
+#include "lsst/afw/coord/Weather.h"
+
+namespace lsst {
+namespace afw {
+namespace coord {
+
+/**
+ * Typical weather at an observatory of some altitude
+ *
+ * A temperature falling from 19 C at sea level by 6.5 C per km, the pressure of an isothermal
+ * atmosphere at that temperature, and a humidity of 40%.  This is the default weather of
+ * lsst.afw.coord.refraction.
+ *
+ * @param[in] altitude  altitude of the observatory (m)
+ */
+Weather makeDefaultWeather(double altitude);
+
+/**
+ * Compute the atmospheric refraction of light of one wavelength at many elevations
+ *
+ * This is the vectorized equivalent of lsst.afw.coord.refraction, following R. C. Stone, "An Accurate
+ * Method for Computing Atmospheric Refraction," PASP 108, 1051 (1996).  Everything but the dependence
+ * on elevation is computed once per call.
+ *
+ * @param[in] wavelength  wavelength (nm), in the range [230.2, 2058.6]
+ * @param[in] elevation  elevations of the observations (rad)
+ * @param[in] observatory  location of the observatory
+ * @param[in] weather  weather at the observatory; see makeDefaultWeather if unknown
+ * @returns the refraction at each elevation (rad)
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if the wavelength is out of range.
+ */
+ndarray::Array<double, 1, 1> computeRefraction(double wavelength,
+                                               ndarray::Array<double const, 1> const &elevation,
+                                               Observatory const &observatory, Weather const &weather);
+
+/**
+ * Compute the refraction at one wavelength minus that at a reference wavelength, at many elevations
+ *
+ * @param[in] wavelength  wavelength (nm), in the range [230.2, 2058.6]
+ * @param[in] wavelengthRef  reference wavelength (nm), typically the effective wavelength of a filter
+ * @param[in] elevation  elevations of the observations (rad)
+ * @param[in] observatory  location of the observatory
+ * @param[in] weather  weather at the observatory; see makeDefaultWeather if unknown
+ * @returns the differential refraction at each elevation (rad)
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if either wavelength is out of range.
+ */
+ndarray::Array<double, 1, 1> computeDifferentialRefraction(double wavelength, double wavelengthRef,
+                                                           ndarray::Array<double const, 1> const &elevation,
+                                                           Observatory const &observatory,
+                                                           Weather const &weather);
+
+}  // namespace coord
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !LSST_AFW_COORD_REFRACTION_H_INCLUDED
@@ -91,6 +91,20 @@ public:
     explicit Footprint(std::shared_ptr<geom::SpanSet> inputSpans, afw::table::Schema const &peakSchema,
                        lsst::geom::Box2I const &region = lsst::geom::Box2I());
 
+    /** @brief Constructor for the Footprint object, sharing a table for its Peaks
+     *
+     * Footprints made with the same table draw their PeakRecords from the same blocks of memory,
+     * so all their Peaks may be gathered into one contiguous PeakCatalog.
+     *
+     * @param inputSpans Shared pointer to a SpanSet defining the pixels included in
+                         the Footprint.
+     * @param peakTable table to be used in the PeakCatalog
+     * @param region Bounding box of the image in which the Footprint was created,
+                     defaults to empty box.
+     */
+    explicit Footprint(std::shared_ptr<geom::SpanSet> inputSpans, std::shared_ptr<PeakTable> const &peakTable,
+                       lsst::geom::Box2I const &region = lsst::geom::Box2I());
+
     /** @brief Constructor of a empty Footprint object
      */
     explicit Footprint()
@@ -363,8 +377,10 @@ public:
      * Split a multi-component Footprint such that each Footprint in the output vector
      * is contiguous and contains only peaks that can be found within the bounds of the
      * Footprint
+     *
+     * @param numThreads number of threads to use to find the pieces; 0 means one per hardware thread
      */
-    std::vector<std::shared_ptr<Footprint>> split() const;
+    std::vector<std::shared_ptr<Footprint>> split(int numThreads = 1) const;
 
     /**
      * equality operator
@@ -433,6 +449,51 @@ std::shared_ptr<Footprint> mergeFootprints(Footprint const &footprint1, Footprin
  * @param footprint Footprint to turn into bounding box list
  */
 std::vector<lsst::geom::Box2I> footprintToBBoxList(Footprint const &footprint);
+
+/**
+ * Transform many Footprints at once, as for Footprint::transform.
+ *
+ * The spans and peaks of all the Footprints are mapped with a few large calls to the transform
+ * (see geom::SpanSet::transformEach), rather than several calls per Footprint, which makes this much
+ * faster for the Footprints of a catalog.  As with Footprint::transform, the results are ordinary
+ * Footprints, even if the inputs are HeavyFootprints.
+ *
+ * @param footprints Footprints to transform
+ * @param t A 2-D transform which will be used to map the pixels
+ * @param region Used to set the "region" box of the returned footprints; note that this is
+ *               NOT the same as the footprints' bounding boxes.
+ * @param doClip If true, clip the new footprints to the region bbox before returning them.
+ * @param numThreads number of threads to spread the work over; 0 means one per hardware thread
+ *
+ * @returns one Footprint per element of footprints, in the same order
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
+ */
+std::vector<std::shared_ptr<Footprint>> transformFootprints(
+        std::vector<std::shared_ptr<Footprint>> const &footprints, geom::TransformPoint2ToPoint2 const &t,
+        lsst::geom::Box2I const &region, bool doClip = true, int numThreads = 1);
+
+/**
+ * Transform many Footprints at once from one WCS to another, as for Footprint::transform.
+ *
+ * The transform between the WCSs is made once, and used as for the overload taking a transform.
+ *
+ * @param footprints Footprints to transform
+ * @param source Wcs that defines the coordinate system of the input footprints.
+ * @param target Wcs that defines that desired coordinate system of the returned footprints.
+ * @param region Used to set the "region" box of the returned footprints; note that this is
+ *               NOT the same as the footprints' bounding boxes.
+ * @param doClip If true, clip the new footprints to the region bbox before returning them.
+ * @param numThreads number of threads to spread the work over; 0 means one per hardware thread
+ *
+ * @returns one Footprint per element of footprints, in the same order
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
+ */
+std::vector<std::shared_ptr<Footprint>> transformFootprints(
+        std::vector<std::shared_ptr<Footprint>> const &footprints, geom::SkyWcs const &source,
+        geom::SkyWcs const &target, lsst::geom::Box2I const &region, bool doClip = true,
+        int numThreads = 1);
 }  // namespace detection
 }  // namespace afw
 }  // namespace lsst
@@ -49,8 +49,8 @@ class FootprintMerge;
  *  existing FootprintMerge, the Footprint will be added to it.  If not, then a new FootprintMerge will be
  *  created and added to the vector.
  *
- *  The search algorithm uses a brute force approach over the current list.  This should be fine if we
- *  are operating on smallish number of objects, such as at the tract level.
+ *  Candidate overlaps are found through a coarse grid of the merges' bounding boxes, so the cost of
+ *  adding a Footprint depends on how crowded its neighborhood is, not on the length of the list.
  *
  */
 class FootprintMergeList final {
@@ -27,6 +27,7 @@
  * Represent a collections of footprints associated with image data
  */
 #include <cstdint>
+#include <utility>
 
 #include "lsst/geom.h"
 #include "lsst/afw/detection/Threshold.h"
@@ -57,6 +58,12 @@ public:
     /// The FootprintSet's set of Footprint%s
     using FootprintList = std::vector<std::shared_ptr<Footprint>>;
 
+    /// Algorithms for growing the Footprints of a FootprintSet
+    enum class GrowthAlgorithm {
+        DILATE,             ///< Dilate each Footprint by a stencil, then merge those that touch
+        DISTANCE_TRANSFORM  ///< Threshold the distance transform of all Footprints in the region at once
+    };
+
     /**
      * Find a FootprintSet given an Image and a threshold.
      *
@@ -67,11 +74,15 @@ public:
      * @param npixMin minimum number of pixels in an object
      * @param setPeaks should I set the Peaks list?
      * @param peakSchema Schema for peak records, even if we don't measure them here.
+     * @param numThreads number of threads to search the image with, in bands of rows; 0 means one
+     *                   per hardware thread.  The result does not depend on it.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
      */
     template <typename ImagePixelT>
     FootprintSet(image::Image<ImagePixelT> const& img, Threshold const& threshold, int const npixMin = 1,
                  bool const setPeaks = true,
-                 table::Schema const& peakSchema = PeakTable::makeMinimalSchema());
+                 table::Schema const& peakSchema = PeakTable::makeMinimalSchema(), int const numThreads = 1);
 
     /**
      * Find a FootprintSet given a Mask and a threshold
@@ -79,9 +90,14 @@ public:
      * @param img Image to search for objects
      * @param threshold threshold to find objects
      * @param npixMin minimum number of pixels in an object
+     * @param numThreads number of threads to search the image with, in bands of rows; 0 means one
+     *                   per hardware thread.  The result does not depend on it.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
      */
     template <typename MaskPixelT>
-    FootprintSet(image::Mask<MaskPixelT> const& img, Threshold const& threshold, int const npixMin = 1);
+    FootprintSet(image::Mask<MaskPixelT> const& img, Threshold const& threshold, int const npixMin = 1,
+                 int const numThreads = 1);
 
     /**
      * Find a FootprintSet given a MaskedImage and a threshold
@@ -100,10 +116,42 @@ public:
      * @param planeName mask plane to set (if != "")
      * @param npixMin minimum number of pixels in an object
      * @param setPeaks should I set the Peaks list?
+     * @param numThreads number of threads to search the image with, in bands of rows; 0 means one
+     *                   per hardware thread.  The result does not depend on it.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
      */
     template <typename ImagePixelT, typename MaskPixelT>
     FootprintSet(image::MaskedImage<ImagePixelT, MaskPixelT> const& img, Threshold const& threshold,
-                 std::string const& planeName = "", int const npixMin = 1, bool const setPeaks = true);
+                 std::string const& planeName = "", int const npixMin = 1, bool const setPeaks = true,
+                 int const numThreads = 1);
+
+    /**
+     * Find the Footprints above a threshold and those below minus the threshold in one pass.
+     *
+     * The results are the same as those of constructing a FootprintSet from `img` twice, with
+     * `threshold` set to positive and to negative polarity, but each pixel is read and the threshold
+     * (e.g. the image statistics for a STDEV threshold) evaluated only once, as is wanted when
+     * detecting both kinds of source in difference images.
+     *
+     * @param img MaskedImage to search for objects
+     * @param threshold threshold for footprints (controls size); its polarity is ignored
+     * @param positivePlaneName mask plane to set in the positive Footprints (if != "")
+     * @param negativePlaneName mask plane to set in the negative Footprints (if != "")
+     * @param npixMin minimum number of pixels in an object
+     * @param setPeaks should I set the Peaks lists?
+     * @param numThreads number of threads to search the image with, in bands of rows; 0 means one
+     *                   per hardware thread.  The result does not depend on it.
+     * @returns the FootprintSets of positive and of negative objects, in that order
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if the threshold is a BITMASK one, or if
+     *         numThreads < 0
+     */
+    template <typename ImagePixelT, typename MaskPixelT>
+    static std::pair<FootprintSet, FootprintSet> makeBothPolarities(
+            image::MaskedImage<ImagePixelT, MaskPixelT> const& img, Threshold const& threshold,
+            std::string const& positivePlaneName = "", std::string const& negativePlaneName = "",
+            int const npixMin = 1, bool const setPeaks = true, int const numThreads = 1);
 
     /**
      * Construct an empty FootprintSet given a region that its footprints would have lived in
@@ -132,6 +180,28 @@ public:
      * @note Isotropic grows are significantly slower
      */
     FootprintSet(FootprintSet const& set, int rGrow, bool isotropic = true);
+    /**
+     * Grow all the Footprints in the input FootprintSet with a chosen algorithm
+     *
+     * Both algorithms give the same Footprints and Peaks as FootprintSet(set, rGrow, isotropic), as
+     * long as the input Footprints lie within the set's region.  DILATE costs of order the number of
+     * Footprints times the area of the growth stencil, while DISTANCE_TRANSFORM paints every Footprint
+     * into an image of the region and grows them all at once, at a cost of order the area of the region
+     * whatever rGrow is; the latter is much faster for large grows of crowded regions, such as those of
+     * deep coadds.
+     *
+     * @param set the input FootprintSet
+     * @param rGrow Grow Footprints by r pixels
+     * @param isotropic Grow isotropically (as opposed to a Manhattan metric)
+     * @param algorithm how to grow the Footprints
+     * @param numThreads number of threads to use with DISTANCE_TRANSFORM, which spreads the distance
+     *                   transform and the detection of the grown Footprints over bands of the region;
+     *                   0 means one per hardware thread
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if rGrow < 0 or numThreads < 0
+     */
+    FootprintSet(FootprintSet const& set, int rGrow, bool isotropic, GrowthAlgorithm algorithm,
+                 int numThreads = 1);
     /**
      * Return the FootprintSet corresponding to the merge of two input FootprintSets
      *
@@ -181,6 +251,20 @@ public:
      */
     void makeSources(afw::table::SourceCatalog& catalog) const;
 
+    /**
+     *  Return a catalog of the Peaks of all the Footprints, in order.
+     *
+     *  The catalog shares its records with the Footprints, and uses the table of the first
+     *  Footprint's Peaks.  The Footprints found by the FootprintSet constructors share a PeakTable,
+     *  from which their Peaks are allocated in this order, so unless the Peaks have since been
+     *  changed or reordered the catalog is contiguous and its columns may be viewed with
+     *  getColumnView().
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if the Footprints' Peaks do not all
+     *          have the same schema.
+     */
+    PeakCatalog makePeakCatalog() const;
+
     /**
      * Set the corners of the FootprintSet's MaskedImage to region
      *
@@ -198,24 +282,50 @@ public:
     /**
      * Return an Image with pixels set to the Footprint%s in the FootprintSet
      *
+     * Each pixel of the image over the FootprintSet's region is set to the sum of one plus the indices
+     * of the Footprints containing it (i.e. to the Footprint's index plus one, if they don't overlap).
+     *
+     * @param numThreads number of threads to paint bands of rows with; 0 means one per hardware thread
+     *
      * @returns an std::shared_ptr<image::Image>
+     *
+     * @throws lsst::pex::exceptions::OutOfRangeError if a Footprint extends beyond the region
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
      */
-    std::shared_ptr<image::Image<FootprintIdPixel>> insertIntoImage() const;
+    std::shared_ptr<image::Image<FootprintIdPixel>> insertIntoImage(int numThreads = 1) const;
 
+    /**
+     * Set the pixels of an existing image to the Footprint%s in the FootprintSet
+     *
+     * This is insertIntoImage(), painting into an image that may be reused across calls; pixels
+     * outside all the Footprints are set to zero.
+     *
+     * @param idImage image to set; it need not cover the same region as the FootprintSet
+     * @param numThreads number of threads to paint bands of rows with; 0 means one per hardware thread
+     *
+     * @throws lsst::pex::exceptions::OutOfRangeError if a Footprint extends beyond the image
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
+     */
+    void insertIntoImage(image::Image<FootprintIdPixel>& idImage, int numThreads = 1) const;
+
+    /**
+     * Set a mask plane in the pixels of all the Footprint%s
+     *
+     * @param mask mask to set bits in
+     * @param planeName name of the mask plane to set
+     * @param numThreads number of threads to paint bands of rows with; 0 means one per hardware thread
+     *
+     * @throws lsst::pex::exceptions::OutOfRangeError if a Footprint extends beyond the mask
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
+     */
     template <typename MaskPixelT>
-    void setMask(image::Mask<MaskPixelT>* mask,  ///< Set bits in the mask
-                 std::string const& planeName    ///< Here's the name of the mask plane to fit
-    ) {
-        for (auto const& foot : *_footprints) {
-            foot->getSpans()->setMask(*mask, image::Mask<MaskPixelT>::getPlaneBitMask(planeName));
-        }
-    }
+    void setMask(image::Mask<MaskPixelT>* mask, std::string const& planeName, int numThreads = 1);
 
+    /// @copydoc setMask(image::Mask<MaskPixelT>*, std::string const&, int)
     template <typename MaskPixelT>
-    void setMask(std::shared_ptr<image::Mask<MaskPixelT>> mask,  ///< Set bits in the mask
-                 std::string const& planeName                    ///< Here's the name of the mask plane to fit
-    ) {
-        setMask(mask.get(), planeName);
+    void setMask(std::shared_ptr<image::Mask<MaskPixelT>> mask, std::string const& planeName,
+                 int numThreads = 1) {
+        setMask(mask.get(), planeName, numThreads);
     }
 
     /**
@@ -231,12 +341,48 @@ public:
     /**
      * Convert all the Footprints in the FootprintSet to be HeavyFootprint%s
      *
+     * Unless ctrl asks for the source pixels to be modified, all the Footprints are filled in one pass
+     * over the image (see makeHeavyFootprints).
+     *
      * @param mimg the image providing pixel values
      * @param ctrl Control how we manipulate HeavyFootprints
+     * @param numThreads number of threads to spread bands of rows over; 0 means one per hardware thread
      */
     template <typename ImagePixelT, typename MaskPixelT>
     void makeHeavy(image::MaskedImage<ImagePixelT, MaskPixelT> const& mimg,
-                   HeavyFootprintCtrl const* ctrl = nullptr);
+                   HeavyFootprintCtrl const* ctrl = nullptr, int numThreads = 1);
+
+    /**
+     * Return a new FootprintSet whose Footprints are those of this one, transformed
+     *
+     * All the Footprints are transformed at once, as by transformFootprints.
+     *
+     * @param t A 2-D transform which will be used to map the pixels
+     * @param region The region of the new FootprintSet, also used to set the "region" box of its
+     *               Footprints.
+     * @param doClip If true, clip the new footprints to the region bbox.
+     * @param numThreads number of threads to spread the work over; 0 means one per hardware thread
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
+     */
+    FootprintSet transform(geom::TransformPoint2ToPoint2 const& t, lsst::geom::Box2I const& region,
+                           bool doClip = true, int numThreads = 1) const;
+
+    /**
+     * Return a new FootprintSet whose Footprints are those of this one, transformed from one WCS to
+     * another
+     *
+     * @param source Wcs that defines the coordinate system of this FootprintSet.
+     * @param target Wcs that defines that desired coordinate system of the returned FootprintSet.
+     * @param region The region of the new FootprintSet, also used to set the "region" box of its
+     *               Footprints.
+     * @param doClip If true, clip the new footprints to the region bbox.
+     * @param numThreads number of threads to spread the work over; 0 means one per hardware thread
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
+     */
+    FootprintSet transform(geom::SkyWcs const& source, geom::SkyWcs const& target,
+                           lsst::geom::Box2I const& region, bool doClip = true, int numThreads = 1) const;
 
 private:
     std::shared_ptr<FootprintList> _footprints;  ///< the Footprints of detected objects
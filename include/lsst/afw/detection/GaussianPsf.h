@@ -76,6 +76,19 @@ public:
     /// Return the radius of the Gaussian.
     double getSigma() const { return _sigma; }
 
+    /**
+     *  Write the kernel image into a caller-provided array, without allocating an Image.
+     *
+     *  The values are those of the image returned by computeKernelImage(), whose origin is
+     *  computeBBox().getMin().  The Gaussian is separable, so they are computed as products of two
+     *  normalized 1-d profiles, which takes width + height exponentials rather than width*height.
+     *
+     *  @param[out] array  Array to fill, with shape (height, width).
+     *
+     *  @throws lsst::pex::exceptions::LengthError if the shape of array does not match getDimensions().
+     */
+    void computeKernelArray(ndarray::Array<Pixel, 2, 1> const& array) const;
+
     /// Whether the Psf is persistable; always true.
     bool isPersistable() const noexcept override { return true; }
 
@@ -31,6 +31,7 @@
 #include <list>
 #include <cmath>
 #include <memory>
+#include <vector>
 #include "lsst/afw/detection/Footprint.h"
 
 namespace lsst {
@@ -152,6 +153,44 @@ HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT> makeHeavyFootprint(
     return HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>(foot, img, ctrl);
 }
 
+/**
+ * Create HeavyFootprints for many Footprints at once, taking pixel values from the given MaskedImage.
+ *
+ * The spans of all the Footprints are sorted by row, so the image, mask and variance planes are each
+ * read in a single pass.  The result is the same as constructing each HeavyFootprint in turn.
+ *
+ * @param footprints The Footprints defining the pixels of each HeavyFootprint
+ * @param mimage The pixel values
+ * @param numThreads Number of threads to spread bands of rows over; 0 means one per hardware thread
+ *
+ * @throws lsst::pex::exceptions::OutOfRangeError if a Footprint does not lie within mimage.
+ */
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+std::vector<std::shared_ptr<HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT> > > makeHeavyFootprints(
+        std::vector<std::shared_ptr<Footprint> > const& footprints,
+        lsst::afw::image::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT> const& mimage,
+        int numThreads = 1);
+
+/**
+ * Replace the pixels of a MaskedImage with the values in many HeavyFootprints at once.
+ *
+ * The spans of all the HeavyFootprints are sorted by row, so the image is written in a single pass.
+ * The result is the same as calling HeavyFootprint::insert on each in turn: where HeavyFootprints
+ * overlap, later ones win.
+ *
+ * @param heavies The HeavyFootprints to insert
+ * @param[out] mimage The image to set
+ * @param numThreads Number of threads to spread bands of rows over; 0 means one per hardware thread
+ *
+ * @throws lsst::pex::exceptions::OutOfRangeError if a HeavyFootprint does not lie within mimage, in
+ *     which case mimage is unchanged.
+ */
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+void insertHeavyFootprints(
+        std::vector<std::shared_ptr<HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT> > > const&
+                heavies,
+        lsst::afw::image::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>& mimage, int numThreads = 1);
+
 /**
  * Sum the two given HeavyFootprints *h1* and *h2*, returning a
  * HeavyFootprint with the union footprint, and summed pixels where
@@ -25,6 +25,7 @@
 
 #include <string>
 #include <limits>
+#include <vector>
 
 #include <memory>
 
@@ -44,6 +45,9 @@ namespace detail {
 /// Key for caching PSFs with lsst::cpputils::Cache
 struct PsfCacheKey;
 
+/// Thread-safe cache of PSF images, sharded by position
+class PsfCache;
+
 }  // namespace detail
 
 /**
@@ -88,6 +92,14 @@ public:
     using Pixel = math::Kernel::Pixel;  ///< Pixel type of Image returned by computeImage
     using Image = image::Image<Pixel>;  ///< Image type returned by computeImage
 
+    /// Numbers of lookups in the image caches that did and did not find an image.
+    struct CacheStatistics {
+        std::size_t imageHits = 0;
+        std::size_t imageMisses = 0;
+        std::size_t kernelImageHits = 0;
+        std::size_t kernelImageMisses = 0;
+    };
+
     /// Enum passed to computeImage and computeKernelImage to determine image ownership.
     enum ImageOwnerEnum {
         COPY = 0,    ///< The image will be copied before returning; caller will own it.
@@ -182,6 +194,28 @@ public:
                                               image::Color color = image::Color(),
                                               ImageOwnerEnum owner = COPY) const;
 
+    /**
+     *  Return Images of the PSF at many positions, in a form suitable for convolution.
+     *
+     *  The images are those computeKernelImage would return at each position, but they are computed
+     *  through doComputeKernelImages in batches, without looking up or filling the caches.  Each
+     *  returned image is owned by the caller.
+     *
+     *  @param[in]  positions    Positions at which to evaluate the PSF.
+     *  @param[in]  colors       Colors of the sources for which to evaluate the PSF, one per position;
+     *                           if empty, getAverageColor() is used for all of them.
+     *  @param[in]  numThreads   Number of threads to spread the batches over; 0 means one per hardware
+     *                           thread.  Values other than 1 require doComputeKernelImages to be safe to
+     *                           call concurrently.
+     *
+     *  @throws lsst::pex::exceptions::LengthError if colors is neither empty nor the same length as
+     *      positions.
+     */
+    std::vector<std::shared_ptr<Image>> computeKernelImages(
+            std::vector<lsst::geom::Point2D> const& positions,
+            std::vector<image::Color> const& colors = std::vector<image::Color>(),
+            int numThreads = 1) const;
+
     /**
      *   Return the peak value of the PSF image.
      *
@@ -319,6 +353,37 @@ public:
      */
     void setCacheCapacity(std::size_t capacity);
 
+    /// Return the spacing of the grid that kernel image cache positions are snapped to; 0 if none.
+    double getCacheGridSize() const { return _cacheGridSize; }
+
+    /** Snap the positions used to look up and compute kernel images to a grid
+     *
+     * With a nonzero grid size, computeKernelImage (and everything built on it, including the default
+     * computeImage) evaluates the Psf at the grid point nearest the requested position, so nearby
+     * sources share one cached image.  This trades accuracy for speed, and is only appropriate for
+     * Psf models that vary little over the grid spacing.  computeImage still centers its image on
+     * the exact position, by shifting the kernel image by a fraction of a pixel.
+     *
+     * This is off (0) by default.  It must not be changed while other threads are using the Psf.
+     *
+     * @param[in] gridSize  Spacing of the grid in pixels, or 0 to use exact positions.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if gridSize is negative or not finite.
+     */
+    void setCacheGridSize(double gridSize);
+
+    /** Return the numbers of cache hits and misses since construction or resetCacheStatistics
+     *
+     * The caches are safe to use from several threads at once; they are split into shards by
+     * position, each with its own lock, so threads evaluating the Psf at different positions rarely
+     * wait on each other.  An image missing from the cache is computed without holding a lock, so
+     * two threads asking for the same new position at once may both compute it.
+     */
+    CacheStatistics getCacheStatistics() const;
+
+    /// Set the counts returned by getCacheStatistics to zero.
+    void resetCacheStatistics();
+
 protected:
     /**
      *  Main constructor for subclasses.
@@ -344,6 +409,17 @@ protected:
                                                  image::Color const& color) const;
     //@}
 
+    /**
+     *  Compute kernel images for a batch of positions and colors of the same length, for
+     *  computeKernelImages.
+     *
+     *  The default implementation calls doComputeKernelImage for each position in turn.  Derived
+     *  classes that can share work between positions (e.g. by evaluating spatial models for all of
+     *  them at once) should override it, returning one image per position, in order.
+     */
+    virtual std::vector<std::shared_ptr<Image>> doComputeKernelImages(
+            std::vector<lsst::geom::Point2D> const& positions, std::vector<image::Color> const& colors) const;
+
 private:
     //@{
     /**
@@ -363,10 +439,13 @@ private:
                                             image::Color const& color) const = 0;
     //@}
 
+    // Return position, snapped to the cache grid if there is one
+    lsst::geom::Point2D snapToCacheGrid(lsst::geom::Point2D const& position) const;
+
     bool const _isFixed;
-    using PsfCache = cpputils::Cache<detail::PsfCacheKey, std::shared_ptr<Image>>;
-    std::unique_ptr<PsfCache> _imageCache;
-    std::unique_ptr<PsfCache> _kernelImageCache;
+    double _cacheGridSize = 0.0;
+    std::unique_ptr<detail::PsfCache> _imageCache;
+    std::unique_ptr<detail::PsfCache> _kernelImageCache;
 };
 }  // namespace detection
 }  // namespace afw
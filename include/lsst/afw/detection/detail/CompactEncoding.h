@@ -0,0 +1,95 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_DETECTION_DETAIL_COMPACTENCODING_H
+#define LSST_AFW_DETECTION_DETAIL_COMPACTENCODING_H
+
+#include <cstdint>
+#include <vector>
+
+#include "lsst/afw/table/io/Persistable.h"
+
+namespace lsst {
+namespace afw {
+namespace detection {
+namespace detail {
+
+/*
+ * Variable-length integers used by the compact archive encodings of Footprints and HeavyFootprints.
+ *
+ * An unsigned value is written 7 bits at a time, least significant first, with the high bit of each
+ * byte set if more bytes follow; a signed value is first mapped to an unsigned one by interleaving
+ * negative and positive values (0, -1, 1, -2, ...), so that small values of either sign are short.
+ */
+
+/// Append an unsigned value to a buffer.
+inline void appendVarint(std::uint64_t value, std::vector<std::uint8_t> &buffer) {
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<std::uint8_t>(value));
+}
+
+/// Append a signed value to a buffer.
+inline void appendSignedVarint(std::int64_t value, std::vector<std::uint8_t> &buffer) {
+    appendVarint((static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63), buffer);
+}
+
+/**
+ * Read an unsigned value, advancing `data` past it.
+ *
+ * @throws lsst::afw::table::io::MalformedArchiveError if the buffer ends before the value does.
+ */
+inline std::uint64_t readVarint(std::uint8_t const *&data, std::uint8_t const *end) {
+    std::uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (data == end) {
+            break;
+        }
+        std::uint8_t const byte = *data++;
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    throw LSST_EXCEPT(table::io::MalformedArchiveError, "Truncated or invalid variable-length integer");
+}
+
+/**
+ * Read a signed value, advancing `data` past it.
+ *
+ * @throws lsst::afw::table::io::MalformedArchiveError if the buffer ends before the value does.
+ */
+inline std::int64_t readSignedVarint(std::uint8_t const *&data, std::uint8_t const *end) {
+    std::uint64_t const value = readVarint(data, end);
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+}  // namespace detail
+}  // namespace detection
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_DETECTION_DETAIL_COMPACTENCODING_H
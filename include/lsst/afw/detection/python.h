@@ -25,6 +25,7 @@
 #define LSST_AFW_DETECTION_PYTHON_H
 
 #include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
 #include "lsst/afw/detection/Psf.h"
 #include "lsst/afw/typehandling/python.h"
 
@@ -109,6 +110,16 @@ public:
         );
     }
 
+    std::vector<std::shared_ptr<Image>> doComputeKernelImages(
+        std::vector<lsst::geom::Point2D> const& positions,
+        std::vector<image::Color> const& colors
+    ) const override {
+        PYBIND11_OVERLOAD_NAME(
+            std::vector<std::shared_ptr<Image>>, Base, "_doComputeKernelImages", doComputeKernelImages,
+            positions, colors
+        );
+    }
+
     double doComputeApertureFlux(
         double radius, lsst::geom::Point2D const& position,
         image::Color const& color
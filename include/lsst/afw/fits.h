@@ -14,8 +14,13 @@
  */
 
 #include <climits>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 #include <boost/format.hpp>
 
@@ -23,6 +28,7 @@
 #include "lsst/pex/exceptions.h"
 #include "lsst/daf/base.h"
 #include "ndarray.h"
+#include "lsst/geom/Box.h"
 #include "lsst/afw/fitsCompression.h"
 #include "lsst/afw/fitsDefaults.h"
 
@@ -121,6 +127,11 @@ int getBitPix();
 
 /**
  *  Lifetime-management for memory that goes into FITS memory files.
+ *
+ *  Memory that the manager allocates is kept when a new file is written into it, and is never
+ *  shrunk by cfitsio, so a manager that is reused for a series of similarly-sized files allocates
+ *  memory only for the first of them.  getLength() is always the size of the file, while
+ *  getCapacity() is the size of the memory that holds it.
  */
 class MemFileManager {
 public:
@@ -130,7 +141,7 @@ public:
      *  The manager will still free the memory when it goes out of scope, but all allocation
      *  and reallocation will be performed by cfitsio as needed.
      */
-    MemFileManager() : _ptr(nullptr), _len(0), _managed(true) {}
+    MemFileManager() : _ptr(nullptr), _len(0), _managed(true), _readOnly(false) {}
 
     /**
      *  Construct a MemFileManager with (len) bytes of initial memory.
@@ -138,7 +149,9 @@ public:
      *  The manager will free the memory when it goes out of scope, and cfitsio will be allowed
      *  to reallocate the internal memory as needed.
      */
-    explicit MemFileManager(std::size_t len) : _ptr(nullptr), _len(0), _managed(true) { reset(len); }
+    explicit MemFileManager(std::size_t len) : _ptr(nullptr), _len(0), _managed(true), _readOnly(false) {
+        reset(len);
+    }
 
     /**
      *  Construct a MemFileManager that references and does not manage external memory.
@@ -147,7 +160,7 @@ public:
      *  either.  The user must provide enough initial memory and is responsible for freeing
      *  it manually after the FITS file has been closed.
      */
-    MemFileManager(void* ptr, std::size_t len) : _ptr(ptr), _len(len), _managed(false) {}
+    MemFileManager(void* ptr, std::size_t len) : _ptr(ptr), _len(len), _managed(false), _readOnly(false) {}
 
     /**
      *  Return the manager to the same state it would be if default-constructed.
@@ -162,7 +175,8 @@ public:
      *  This must not be called while a FITS file that uses this memory is open.
      *
      *  Memory allocated with this overload of reset can be reallocated by cfitsio
-     *  and will be freed when the manager goes out of scope or is reset.
+     *  and will be freed when the manager goes out of scope or is reset.  If the manager already
+     *  manages at least `len` bytes, that memory is reused; its contents are unspecified.
      */
     void reset(std::size_t len);
 
@@ -181,6 +195,19 @@ public:
         _managed = false;
     }
 
+    /**
+     *  Set the internal memory buffer to an external block that may only be read.
+     *
+     *  This must not be called while a FITS file that uses this memory is open.
+     *
+     *  As for reset(void*, std::size_t), the memory will not be freed by the manager.  Fits
+     *  objects may only open it with mode "r".
+     */
+    void resetReadOnly(void const* ptr, std::size_t len) {
+        reset(const_cast<void*>(ptr), len);
+        _readOnly = true;
+    }
+
     ~MemFileManager() { reset(); }
 
     // No copying
@@ -197,12 +224,19 @@ public:
     /// Return the buffer length
     std::size_t getLength() const { return _len; }
 
+    /// Return the number of bytes available to the file without reallocation
+    std::size_t getCapacity() const;
+
+    /// Return true if the buffer may only be read
+    bool isReadOnly() const { return _readOnly; }
+
 private:
     friend class Fits;
 
     void* _ptr;
     std::size_t _len;
     bool _managed;
+    bool _readOnly;
 };
 
 /// Construct a contiguous ndarray
@@ -223,6 +257,14 @@ ndarray::Array<T const, N, N> const makeContiguousArray(ndarray::Array<T, N, C>
 struct ImageWriteOptions {
     ImageCompressionOptions compression;  ///< Options controlling compression
     ImageScalingOptions scaling;          ///< Options controlling scaling
+    /// Write DATASUM and CHECKSUM keywords?
+    ///
+    /// Where the pixels are written without conversion (no compression, and no scaling by cfitsio),
+    /// DATASUM is computed from the pixels in memory as they are written (on several threads, as
+    /// allowed by getImageCompressionThreads), so the data are not read back; otherwise cfitsio
+    /// computes both keywords from the HDU as written.  Keywords added to the HDU afterwards
+    /// invalidate CHECKSUM.
+    bool checksum = false;
 
     /// Construct with default options for images
     template <typename T>
@@ -258,6 +300,7 @@ struct ImageWriteOptions {
     /// * scaling.quantizePad: number of stdev to allow on the low side (for STDEV_POSITIVE/NEGATIVE)
     /// * scaling.bscale: manually specified BSCALE (for MANUAL scaling)
     /// * scaling.bzero: manually specified BSCALE (for MANUAL scaling)
+    /// * checksum (bool): write DATASUM and CHECKSUM keywords? (optional; default false)
     ///
     /// Use the 'validate' method to set default values for the above.
     ///
@@ -289,6 +332,22 @@ struct ImageWriteOptions {
  */
 enum class HduType : int { IMAGE = 0, ASCII_TABLE = 1, BIN_TABLE = 2, ANY = -1 };
 
+/// How one column of a binary table is stored in each row, as returned by Fits::getTableLayout.
+struct TableColumnLayout {
+    std::size_t offset;  ///< Offset of the column's first byte from the start of a row.
+    std::size_t size;    ///< Number of bytes the column occupies in each row.
+    double zero;         ///< The column's TZERO; stored values are offset from true values by this.
+    double scale;        ///< The column's TSCAL; stored values are true values divided by this.
+};
+
+/// How the rows of a binary table are stored, as returned by Fits::getTableLayout.
+struct TableLayout {
+    std::size_t rowWidth;                   ///< Number of bytes in each row (NAXIS1).
+    std::vector<TableColumnLayout> columns;  ///< The layout of each column, in column order.
+};
+
+class ByteRangeCache;
+
 /**
  *  @brief A simple struct that combines the two arguments that must be passed to most cfitsio routines
  *         and contains thin and/or templated wrappers around common cfitsio routines.
@@ -311,8 +370,15 @@ class Fits {
     void writeImageImpl(T const* data, int nElements);
     template <typename T>
     void readImageImpl(int nAxis, T* data, long* begin, long* end, long* increment);
+    // Read a subset of a tile-compressed image on disk by decompressing rows of tiles concurrently;
+    // returns false, having read nothing, if the image cannot be read that way
+    template <typename T>
+    bool readCompressedImageConcurrently(int nAxis, T* data, long const* begin, long const* end,
+                                         long const* increment);
     void getImageShapeImpl(int maxDim, long* nAxes);
 
+    TableCompressionOptions _tableCompression;  // for tables written by table::io::FitsWriter
+
 public:
     enum BehaviorFlags {
         AUTO_CLOSE = 0x01,  // Close files when the Fits object goes out of scope if fptr != NULL
@@ -451,6 +517,16 @@ public:
      */
     void createEmpty();
 
+    /**
+     *  Append a copy of the current HDU of another file to the end of this file.
+     *
+     *  The HDU is copied as it is stored, so compressed images are not decompressed and recompressed.
+     *  The new HDU is set as the active one.
+     *
+     *  @param[in] source  File whose current HDU is copied.
+     */
+    void copyHdu(Fits& source);
+
     /**
      *  @brief Create an image with pixel type provided by the given explicit PixelT template parameter
      *         and shape defined by an ndarray index.
@@ -569,6 +645,25 @@ public:
         readImageImpl(N, array.getData(), begin.elems, end.elems, increment.elems);
     }
 
+    /**
+     *  Map part of an uncompressed FITS image into memory instead of reading it.
+     *
+     *  Only the part of the file holding the requested rows is mapped, privately, and the requested
+     *  pixels are converted to native byte order in place; the returned array may be modified without
+     *  changing the file.  The mapping lasts as long as any array that views it.
+     *
+     *  @param[in]   shape    Shape ([y, x]) of the region to be mapped.
+     *  @param[in]   offset   Indices of the first pixel to be mapped.
+     *
+     *  @throws FitsTypeError if the on-disk pixel type is not T.
+     *  @throws FitsError if the image is compressed, scaled (BSCALE != 1 or BZERO != 0), or not
+     *          two-dimensional, or if the file is not a plain FITS file on disk opened read-only.
+     *  @throws lsst::pex::exceptions::LengthError if the region does not lie within the image.
+     */
+    template <typename T>
+    ndarray::Array<T, 2, 1> mapImage(ndarray::Vector<int, 2> const& shape,
+                                     ndarray::Vector<int, 2> const& offset);
+
     /// Create a new binary table extension.
     void createTable();
 
@@ -621,12 +716,85 @@ public:
     /// Read a string from a binary table.
     void readTableScalar(std::size_t row, int col, std::string& value, bool isVariableLength);
 
+    /**
+     *  Read the raw bytes of consecutive rows of a binary table.
+     *
+     *  The bytes are copied as they are stored in the file: big-endian, with no TZERO or TSCAL applied,
+     *  and with variable-length arrays represented by their descriptors.  Use getTableLayout() to find
+     *  the columns within each row.
+     *
+     *  @param[in]   firstRow  Index of the first row to read.
+     *  @param[in]   nRows     Number of rows to read.
+     *  @param[out]  data      Buffer of at least nRows*getTableLayout().rowWidth bytes.
+     */
+    void readTableBytes(std::size_t firstRow, std::size_t nRows, unsigned char* data);
+
+    /**
+     *  Write the raw bytes of consecutive rows of a binary table.
+     *
+     *  This is the inverse of readTableBytes(); the rows must already exist (see addRows()).
+     *
+     *  @param[in]   firstRow  Index of the first row to write.
+     *  @param[in]   nRows     Number of rows to write.
+     *  @param[in]   data      Buffer of nRows*getTableLayout().rowWidth bytes.
+     */
+    void writeTableBytes(std::size_t firstRow, std::size_t nRows, unsigned char const* data);
+
+    /**
+     *  Map the raw bytes of consecutive rows of a binary table into memory instead of reading them.
+     *
+     *  The bytes are those readTableBytes() would read, in a private mapping of only the part of the
+     *  file that holds them; the returned array may be modified without changing the file, and the
+     *  mapping lasts as long as any array that views it.
+     *
+     *  @param[in]   firstRow  Index of the first row to map.
+     *  @param[in]   nRows     Number of rows to map.
+     *
+     *  @throws FitsError if the HDU is not a binary table, or if the file is not a plain FITS file on
+     *          disk opened read-only.
+     *  @throws lsst::pex::exceptions::LengthError if the rows do not lie within the table.
+     */
+    ndarray::Array<unsigned char, 1, 1> mapTableBytes(std::size_t firstRow, std::size_t nRows);
+
+    /**
+     *  Return how the rows of the current binary table HDU are stored, for use with readTableBytes().
+     *
+     *  @throws FitsError if the HDU is not a binary table.
+     */
+    TableLayout getTableLayout();
+
     /// Return the size of an array column.
     long getTableArraySize(int col);
 
     /// Return the size of an variable-length array field.
     long getTableArraySize(std::size_t row, int col);
 
+    /// Return true if the current HDU is a tile-compressed binary table.
+    bool isCompressedTable();
+
+    /**
+     *  Append a tile-compressed copy of the current binary table HDU of another file.
+     *
+     *  A table without rows is copied uncompressed, as cfitsio cannot compress it.
+     *
+     *  @param[in] source   File positioned at the table to compress, which must be writable: the
+     *                      FZALGn and FZTILELN keywords through which cfitsio is told how to
+     *                      compress each column are added to it.
+     *  @param[in] options  How to compress the table.
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if the algorithm is PLIO.
+     */
+    void writeCompressedTable(Fits& source, TableCompressionOptions const& options);
+
+    /**
+     *  Append an uncompressed copy of the current (tile-compressed binary table) HDU of another file.
+     *
+     *  Groups of tiles are decompressed on up to nThreads threads (0 means one per hardware thread)
+     *  if cfitsio is reentrant, the source is a file on disk opened read-only and the table has no
+     *  variable-length arrays; otherwise cfitsio decompresses the whole table itself.
+     */
+    void writeUncompressedTable(Fits& source, int nThreads = 1);
+
     /// Default constructor; set all data members to 0.
     Fits() : fptr(nullptr), status(0), behavior(0) {}
 
@@ -636,6 +804,12 @@ public:
     /// Open or create a FITS file from an in-memory file.
     Fits(MemFileManager& manager, std::string const& mode, int behavior);
 
+    /**
+     *  Open a FITS file read-only, reading its bytes through a cache of byte ranges (e.g. of a file in
+     *  an object store); see ByteRangeCache.
+     */
+    Fits(std::shared_ptr<ByteRangeCache> cache, int behavior);
+
     /// Close a FITS file.
     void closeFile();
 
@@ -647,6 +821,12 @@ public:
     /// Return the current image compression settings
     ImageCompressionOptions getImageCompression();
 
+    /// Set compression options for binary tables written by table::io::FitsWriter (e.g. catalogs)
+    void setTableCompression(TableCompressionOptions const& options) { _tableCompression = options; }
+
+    /// Return the current table compression settings
+    TableCompressionOptions getTableCompression() const { return _tableCompression; }
+
     /// Go to the first image header in the FITS file
     ///
     /// If a single image is written compressed, it appears as an extension,
@@ -673,6 +853,226 @@ public:
     int behavior;  // bitwise OR of BehaviorFlags
 };
 
+/**
+ *  Write a FITS image HDU a strip of rows at a time, so that the whole image need never be held
+ *  in memory.
+ *
+ *  The HDU is created, and its header written, when the writer is constructed.  Rows are then
+ *  supplied in order, starting with the lowest row of the image, and are passed to cfitsio as soon
+ *  as a complete row of compression tiles (or, for an uncompressed image, any number of complete
+ *  rows) is available, so at most one row of tiles is buffered.  close() writes the scaling keywords
+ *  and finalizes the header.
+ *
+ *  Only NONE and MANUAL scaling are supported, without fuzz: the other algorithms must see the whole
+ *  image, and fuzz depends on each pixel's position within the whole image.
+ *
+ *  The Fits object must outlive the writer and must not be used for anything else until the writer
+ *  has been closed.  Its compression settings are restored when the writer is closed or destroyed.
+ */
+template <typename T>
+class ImageStreamWriter final {
+public:
+    /**
+     *  Create the image HDU and write its header.
+     *
+     *  @param[in] fitsfile  FITS file to which to append the image.
+     *  @param[in] bbox      Bounding box of the whole image; its minimum determines XY0.
+     *  @param[in] options   Options controlling compression and scaling.
+     *  @param[in] header    Optional FITS header to write.
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if the scaling options are not supported.
+     */
+    ImageStreamWriter(Fits& fitsfile, lsst::geom::Box2I const& bbox, ImageWriteOptions const& options,
+                      daf::base::PropertySet const* header = nullptr);
+
+    /// Restore the compression settings of the file; the image is left incomplete if not closed.
+    ~ImageStreamWriter() noexcept;
+
+    // No copying
+    ImageStreamWriter(ImageStreamWriter const&) = delete;
+    ImageStreamWriter& operator=(ImageStreamWriter const&) = delete;
+
+    // No moving
+    ImageStreamWriter(ImageStreamWriter&&) = delete;
+    ImageStreamWriter& operator=(ImageStreamWriter&&) = delete;
+
+    /**
+     *  Write the next rows of the image.
+     *
+     *  @param[in] rows  Rows ([y, x]) to write; they must be as wide as the image.
+     *
+     *  @throws lsst::pex::exceptions::LengthError if the rows have the wrong width or run past the
+     *          end of the image.
+     *  @throws lsst::pex::exceptions::LogicError if the writer has been closed.
+     */
+    void writeRows(ndarray::Array<T const, 2, 1> const& rows);
+
+    /// Return the number of rows supplied so far.
+    int getRowsWritten() const noexcept { return _rowsFlushed + _rowsBuffered; }
+
+    /// Return the bounding box of the whole image.
+    lsst::geom::Box2I getBBox() const noexcept { return _bbox; }
+
+    /// Return true if close() has completed.
+    bool isClosed() const noexcept { return _closed; }
+
+    /**
+     *  Finish the image: write the scaling keywords, finalize the header and restore the
+     *  compression settings of the file.
+     *
+     *  @throws lsst::pex::exceptions::LogicError if not all rows have been written, or the writer
+     *          has already been closed.
+     */
+    void close();
+
+private:
+    // Pass complete rows to cfitsio
+    void _flush(ndarray::Array<T const, 2, 1> const& rows);
+
+    Fits& _fits;
+    lsst::geom::Box2I _bbox;
+    ImageWriteOptions _options;         // options, with compression disabled for an empty image
+    ImageCompressionOptions _previous;  // compression settings of the file, to be restored
+    ImageScale _scale;
+    int _stripHeight;                   // the rows passed to cfitsio are a multiple of this
+    ndarray::Array<T, 2, 2> _buffer;    // rows awaiting a complete strip
+    int _rowsBuffered;
+    int _rowsFlushed;
+    int _dataSumBitpix;                 // BITPIX of the pixels summed into _dataSum; 0 if not summed
+    std::uint32_t _dataSum;             // ones' complement sum of the data written so far
+    bool _restored;
+    bool _closed;
+};
+
+/**
+ *  The header of a FITS HDU, read once as raw cards and parsed only on demand.
+ *
+ *  Fits::readMetadata parses every card into a PropertyList; when only a few keys are wanted
+ *  (e.g. when scanning the headers of many files), most of that work is wasted.  A LazyHeader
+ *  instead reads the cards of the current HDU, indexes them by keyword name, and parses just the
+ *  keywords that are asked for.  Values are interpreted exactly as Fits::readMetadata interprets
+ *  them, including the concatenation of long strings continued with CONTINUE cards, and the whole
+ *  header may be converted to a PropertyList.  As for Fits::readMetadata, the INHERIT convention
+ *  is not applied.
+ *
+ *  Keyword names are upper-cased, as by Fits::forEachKey, and cards with a blank name are
+ *  treated as COMMENT cards, as by readMetadata.
+ */
+class LazyHeader final {
+public:
+    /**
+     *  Read the header of the current HDU.
+     *
+     *  The file is not used once this returns.
+     */
+    explicit LazyHeader(Fits& fitsfile);
+
+    /**
+     *  Read the header of an HDU of a file.
+     *
+     *  @param[in] fileName  Name of the file to read.
+     *  @param[in] hdu       HDU to read (0-indexed); DEFAULT_HDU behaves as for readMetadata.
+     */
+    explicit LazyHeader(std::string const& fileName, int hdu = DEFAULT_HDU);
+
+    LazyHeader(LazyHeader const&) = default;
+    LazyHeader(LazyHeader&&) = default;
+    LazyHeader& operator=(LazyHeader const&) = default;
+    LazyHeader& operator=(LazyHeader&&) = default;
+    ~LazyHeader() noexcept = default;
+
+    /// Return the number of keywords, not counting CONTINUE cards.
+    std::size_t size() const noexcept { return _keywords.size(); }
+
+    /// Return true if at least one keyword has the given name.
+    bool exists(std::string const& name) const { return _index.count(name) > 0; }
+
+    /// Return the distinct keyword names, in the order of their first appearance.
+    std::vector<std::string> getNames() const;
+
+    /**
+     *  Return the unparsed value of the last keyword with a given name.
+     *
+     *  As for Fits::forEachKey, the quotes around a string value are not removed, but long
+     *  strings are concatenated.
+     *
+     *  @throws lsst::pex::exceptions::NotFoundError if there is no such keyword.
+     */
+    std::string getValueString(std::string const& name) const;
+
+    /**
+     *  Return the comment of the last keyword with a given name.
+     *
+     *  @throws lsst::pex::exceptions::NotFoundError if there is no such keyword.
+     */
+    std::string getComment(std::string const& name) const;
+
+    /**
+     *  Return the value of a keyword, as `readMetadata(...)->get<T>(name)` would.
+     *
+     *  @throws lsst::pex::exceptions::NotFoundError if there is no such keyword.
+     */
+    template <typename T>
+    T get(std::string const& name) const {
+        return extract({name})->template get<T>(name);
+    }
+
+    /**
+     *  Return all the values of a keyword, as `readMetadata(...)->getArray<T>(name)` would.
+     *
+     *  @throws lsst::pex::exceptions::NotFoundError if there is no such keyword.
+     */
+    template <typename T>
+    std::vector<T> getArray(std::string const& name) const {
+        return extract({name})->template getArray<T>(name);
+    }
+
+    /**
+     *  Parse some keywords into a PropertyList.
+     *
+     *  @param[in] names  Names of the keywords to parse; names that are not present are ignored.
+     *  @param[in] strip  If true, common FITS keys that usually have non-metadata intepretations
+     *                    (e.g. NAXIS, BITPIX) will be ignored.
+     *
+     *  The keywords are parsed in the order they appear in the header, so the result is the subset
+     *  of `toPropertyList(strip)` with the given names.
+     */
+    std::shared_ptr<daf::base::PropertyList> extract(std::vector<std::string> const& names,
+                                                     bool strip = false) const;
+
+    /**
+     *  Parse the whole header into a PropertyList, as Fits::readMetadata does.
+     *
+     *  @param[in] strip  If true, common FITS keys that usually have non-metadata intepretations
+     *                    (e.g. NAXIS, BITPIX) will be ignored.
+     */
+    std::shared_ptr<daf::base::PropertyList> toPropertyList(bool strip = false) const;
+
+    /// Call a polymorphic functor for every key in the header, as Fits::forEachKey does.
+    void forEachKey(HeaderIterationFunctor& functor) const;
+
+private:
+    struct Keyword {
+        std::string name;  // upper-cased; "COMMENT" for a blank name
+        int card;          // index of its first card
+    };
+
+    // Copy card i, NUL-terminated, to a buffer of at least 81 characters
+    void _copyCard(int i, char* buffer) const;
+
+    // Parse the keyword whose first card is card i, joining any CONTINUE cards of a long string, and
+    // return the index of the card that follows it
+    int _parseKeyword(int i, std::string& key, std::string& value, std::string& comment) const;
+
+    // Return the last keyword with the given name
+    Keyword const& _findLast(std::string const& name) const;
+
+    std::string _fileName;                                     // for error messages
+    std::string _cards;                                        // all of the cards, 80 characters each
+    std::vector<Keyword> _keywords;                            // in header order
+    std::unordered_map<std::string, std::vector<int>> _index;  // indices into _keywords, by name
+};
+
 //@{
 /**
  * Combine two sets of metadata in a FITS-appropriate fashion
@@ -768,6 +1168,46 @@ std::shared_ptr<daf::base::PropertyList> readMetadata(fits::Fits& fitsfile, bool
 void setAllowImageCompression(bool allow);
 bool getAllowImageCompression();
 
+/**
+ * Set the number of threads used to compress and decompress images
+ *
+ * When more than one thread is allowed, writeHdusConcurrently writes each HDU (e.g. the image, mask
+ * and variance planes of a MaskedImage) to its own in-memory file concurrently, so that their
+ * compression is done in parallel, and then copies them to the output in order.  The output is the
+ * same as if the HDUs had been written one after another.
+ *
+ * Reading a tile-compressed image (or a subimage of one) from a file on disk likewise decompresses
+ * the rows of tiles that intersect the requested region concurrently, each thread opening the file
+ * itself.  Threads are only used if cfitsio was built to be thread-safe.
+ *
+ * The same number of threads is used, regardless of cfitsio, to measure the statistics used by
+ * ImageScalingOptions and to scale and quantize the pixels of large images (see ImageScale::toFits);
+ * the results do not depend on the number of threads.
+ *
+ * @param numThreads the number of threads; 0 means one per hardware thread.  The default is 1.
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
+ */
+void setImageCompressionThreads(int numThreads);
+int getImageCompressionThreads();
+
+/// Return true if cfitsio was built to be thread-safe, so files may be opened and read on several threads.
+bool isCfitsioThreadSafe();
+
+/**
+ * Append HDUs to a file, preparing them concurrently
+ *
+ * Each writer must append one or more HDUs to the file it is given, without depending on what the
+ * file already holds.  If getImageCompressionThreads() allows more than one thread and cfitsio was
+ * built to be thread-safe, each writer is given its own in-memory file containing only an empty
+ * primary HDU, the writers are run concurrently, and the new HDUs are copied to `fitsfile` in order.
+ * Otherwise the writers are called on `fitsfile` in order.
+ *
+ * @param fitsfile the file to append to
+ * @param writers functions that each append HDUs to the file they are given
+ */
+void writeHdusConcurrently(Fits& fitsfile, std::vector<std::function<void(Fits&)>> const& writers);
+
 
 
 /**
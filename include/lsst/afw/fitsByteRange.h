@@ -0,0 +1,149 @@
+// -*- lsst-c++ -*-
+#ifndef LSST_AFW_fitsByteRange_h_INCLUDED
+#define LSST_AFW_fitsByteRange_h_INCLUDED
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "lsst/cpputils/Cache.h"
+
+namespace lsst {
+namespace afw {
+namespace fits {
+
+/**
+ *  The bytes of a read-only file that can be read a range at a time, e.g. by HTTP range requests
+ *  to an object store.
+ *
+ *  afw has no network client of its own: subclasses (which may be written in Python) make the
+ *  requests.  Each call to read is expected to be one request, so it should be served directly,
+ *  without caching; see ByteRangeCache.
+ */
+class ByteRangeSource {
+public:
+    ByteRangeSource() = default;
+    ByteRangeSource(ByteRangeSource const &) = delete;
+    ByteRangeSource &operator=(ByteRangeSource const &) = delete;
+    virtual ~ByteRangeSource() = default;
+
+    /// Return a name for the file, for error messages.
+    virtual std::string getName() const = 0;
+
+    /// Return the size of the file in bytes.
+    virtual std::size_t getSize() = 0;
+
+    /**
+     *  Read bytes [offset, offset + size) of the file into buffer.
+     *
+     *  The range always lies within the file.  Failures should be reported by throwing.
+     */
+    virtual void read(std::size_t offset, std::size_t size, char *buffer) = 0;
+};
+
+/**
+ *  A ByteRangeSource for a file on disk, mostly for testing.
+ */
+class FileByteRangeSource final : public ByteRangeSource {
+public:
+    /**
+     *  Open a file.
+     *
+     *  @throws lsst::pex::exceptions::IoError if the file cannot be opened.
+     */
+    explicit FileByteRangeSource(std::string const &fileName);
+    ~FileByteRangeSource() override;
+
+    std::string getName() const override { return _fileName; }
+    std::size_t getSize() override { return _size; }
+
+    /// @throws lsst::pex::exceptions::IoError if the file cannot be read.
+    void read(std::size_t offset, std::size_t size, char *buffer) override;
+
+private:
+    std::string _fileName;
+    int _fd;
+    std::size_t _size;
+};
+
+/**
+ *  A cache of fixed-size blocks of a ByteRangeSource, through which Fits reads remote files.
+ *
+ *  cfitsio reads a file in many small pieces (2880-byte records, and compressed tiles of a few
+ *  kilobytes), which would be one slow request each.  The cache instead fetches whole blocks,
+ *  merging the blocks missing from one read into a single request, and then fetching up to
+ *  readAhead more blocks while they are not cached either (cfitsio mostly reads forwards).
+ *  The least recently used blocks are dropped to keep at most capacity blocks.
+ *
+ *  Only data that are read are fetched: opening a file reads its headers, and reading part of a
+ *  tile-compressed image (e.g. with image::ExposureFitsReader::readImage and a bounding box) reads
+ *  only the tiles that overlap it, because cfitsio locates each tile from the table of tile
+ *  offsets.  A cache may be shared by several Fits objects reading the same file, from any thread.
+ */
+class ByteRangeCache final {
+public:
+    static constexpr std::size_t DEFAULT_BLOCK_SIZE = 1 << 18;
+    static constexpr std::size_t DEFAULT_CAPACITY = 256;
+    static constexpr std::size_t DEFAULT_READ_AHEAD = 1;
+
+    /**
+     *  Construct a cache; nothing is fetched until data are read.
+     *
+     *  @param[in] source     Source of the bytes.
+     *  @param[in] blockSize  Size of a block in bytes (the unit of fetching and caching).
+     *  @param[in] capacity   Maximum number of blocks kept in memory.
+     *  @param[in] readAhead  Maximum number of blocks fetched beyond those being read.
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if source is null or blockSize or
+     *          capacity is zero.
+     */
+    explicit ByteRangeCache(std::shared_ptr<ByteRangeSource> source,
+                            std::size_t blockSize = DEFAULT_BLOCK_SIZE,
+                            std::size_t capacity = DEFAULT_CAPACITY,
+                            std::size_t readAhead = DEFAULT_READ_AHEAD);
+
+    ByteRangeCache(ByteRangeCache const &) = delete;
+    ByteRangeCache &operator=(ByteRangeCache const &) = delete;
+
+    /// Return the source of the bytes.
+    std::shared_ptr<ByteRangeSource> getSource() const { return _source; }
+
+    /// Return the size of the file in bytes (asking the source only once).
+    std::size_t getSize();
+
+    /**
+     *  Read bytes [offset, offset + size) of the file into buffer.
+     *
+     *  @throws lsst::pex::exceptions::LengthError if the range does not lie within the file.
+     */
+    void read(std::size_t offset, std::size_t size, char *buffer);
+
+    /// Return the number of reads made from the source.
+    std::size_t getRequestCount() const;
+
+    /// Return the number of bytes read from the source.
+    std::size_t getBytesFetched() const;
+
+private:
+    using Block = std::shared_ptr<std::vector<char> const>;
+
+    std::size_t _getSize();  // with the lock held
+
+    std::shared_ptr<ByteRangeSource> const _source;
+    std::size_t const _blockSize;
+    std::size_t const _readAhead;
+    mutable std::mutex _mutex;
+    std::unique_ptr<cpputils::Cache<std::size_t, Block>> _blocks;
+    std::size_t _size;
+    bool _haveSize;
+    std::size_t _requestCount;
+    std::size_t _bytesFetched;
+};
+
+}  // namespace fits
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !LSST_AFW_fitsByteRange_h_INCLUDED
@@ -249,6 +249,24 @@ ImageCompressionOptions::CompressionAlgorithm compressionAlgorithmFromCfitsio(in
 /// Convert ImageCompressionOptions::CompressionAlgorithm to cfitsio
 int compressionAlgorithmToCfitsio(ImageCompressionOptions::CompressionAlgorithm algorithm);
 
+/// Options for tile compression of binary tables
+///
+/// cfitsio's tiled table compression compresses each column of each tile (a group of
+/// consecutive rows) separately.  The algorithm applies to the numeric columns: RICE applies
+/// only to 16- and 32-bit integer columns, and GZIP_SHUFFLE is used for other numeric columns;
+/// GZIP is used for strings, flags and bytes whatever the algorithm, and cfitsio chooses how to
+/// compress variable-length arrays.  PLIO is not supported for tables.
+struct TableCompressionOptions {
+    using CompressionAlgorithm = ImageCompressionOptions::CompressionAlgorithm;
+
+    CompressionAlgorithm algorithm;  ///< Compression algorithm to use
+    long rows;                       ///< Number of rows per tile (0 = let cfitsio choose)
+
+    explicit TableCompressionOptions(CompressionAlgorithm algorithm_ = ImageCompressionOptions::NONE,
+                                     long rows_ = 0)
+            : algorithm(algorithm_), rows(rows_) {}
+};
+
 /// Scale to apply to image
 ///
 /// Images are scaled to the type implied by the provided BITPIX
@@ -289,6 +307,9 @@ struct ImageScale {
     /// @param[in] tiles  Tile dimensions
     /// @param[in] seed  Seed for random number generator
     /// @return Array of pixel values, appropriately scaled.
+    ///
+    /// Large images are scaled using the number of threads set by setImageCompressionThreads;
+    /// the fuzz is the same as a single thread would add.
     template <typename T>
     std::shared_ptr<detail::PixelArrayBase> toFits(
             ndarray::Array<T const, 2, 2> const& image, bool forceNonfiniteRemoval, bool fuzz = true,
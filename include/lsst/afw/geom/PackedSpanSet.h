@@ -0,0 +1,165 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_GEOM_PACKEDSPANSET_H
+#define LSST_AFW_GEOM_PACKEDSPANSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+
+#include "lsst/geom/Box.h"
+#include "lsst/afw/geom/Span.h"
+
+namespace lsst {
+namespace afw {
+namespace geom {
+
+class SpanSet;
+
+/**
+ * A compact, immutable copy of the Spans of a SpanSet, for holding very many small regions.
+ *
+ * Each Span is stored as three variable-length integers: the change in row from the previous Span,
+ * the offset of its first column from the leftmost column of the set, and its width. Values below 2^15
+ * take 16 bits, so a Span usually costs 6 bytes rather than the 12 bytes of a Span object, and the
+ * Spans of small regions are stored inside the object itself, with no separate allocation.
+ *
+ * PackedSpanSet supports iteration over its Spans, in the order of the SpanSet it was made from,
+ * and conversion back to a SpanSet for anything else.
+ */
+class PackedSpanSet final {
+public:
+    /// Forward iterator that decodes Spans one at a time.
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Span;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Span const *;
+        using reference = Span const &;
+
+        const_iterator() noexcept : _next(nullptr), _end(nullptr), _minX(0) {}
+
+        reference operator*() const noexcept { return _span; }
+        pointer operator->() const noexcept { return &_span; }
+
+        const_iterator &operator++() noexcept {
+            _decode();
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept {
+            const_iterator old(*this);
+            _decode();
+            return old;
+        }
+
+        bool operator==(const_iterator const &other) const noexcept { return _next == other._next; }
+        bool operator!=(const_iterator const &other) const noexcept { return _next != other._next; }
+
+    private:
+        friend class PackedSpanSet;
+
+        // Decode the first Span of data, whose row offsets start from y
+        const_iterator(std::uint16_t const *data, std::uint16_t const *end, int minX, int y) noexcept;
+
+        // Decode the Span at _next into _span, or become an end iterator if there are no more
+        void _decode() noexcept;
+
+        // The encoded Span after _span, or null once every Span has been read
+        std::uint16_t const *_next;
+        std::uint16_t const *_end;
+        int _minX;
+        Span _span;
+    };
+
+    using iterator = const_iterator;
+
+    /// Construct an empty PackedSpanSet.
+    PackedSpanSet() noexcept;
+
+    /// Pack the Spans of a SpanSet.
+    explicit PackedSpanSet(SpanSet const &spanSet);
+
+    PackedSpanSet(PackedSpanSet const &other);
+    PackedSpanSet(PackedSpanSet &&other) noexcept;
+    PackedSpanSet &operator=(PackedSpanSet const &other);
+    PackedSpanSet &operator=(PackedSpanSet &&other) noexcept;
+    ~PackedSpanSet() noexcept;
+
+    /// Exchange the contents of two PackedSpanSets.
+    void swap(PackedSpanSet &other) noexcept;
+
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept { return const_iterator(); }
+
+    /// Return the number of Spans.
+    std::size_t size() const noexcept { return _nSpans; }
+
+    /// Return whether there are no Spans.
+    bool empty() const noexcept { return _nSpans == 0; }
+
+    /// Return the number of pixels.
+    std::size_t getArea() const noexcept { return _area; }
+
+    /// Return the smallest box containing every Span.
+    lsst::geom::Box2I getBBox() const noexcept { return _bbox; }
+
+    /// Return the number of bytes used, including any separate allocation.
+    std::size_t getMemorySize() const noexcept;
+
+    /// Unpack into a new SpanSet, with the same Spans in the same order.
+    std::shared_ptr<SpanSet> toSpanSet() const;
+
+    /// Return whether two PackedSpanSets hold the same Spans in the same order.
+    bool operator==(PackedSpanSet const &other) const noexcept;
+    bool operator!=(PackedSpanSet const &other) const noexcept { return !(*this == other); }
+
+private:
+    // Number of 16-bit units stored inside the object; enough for a handful of Spans
+    static constexpr std::size_t INLINE_SIZE = 12;
+
+    bool _isInline() const noexcept { return _nUnits <= INLINE_SIZE; }
+    std::uint16_t const *_data() const noexcept { return _isInline() ? _inline : _heap; }
+
+    lsst::geom::Box2I _bbox;
+    // Origin of the encoded offsets: the smallest row and starting column of any Span
+    int _minX;
+    int _minY;
+    std::size_t _area;
+    std::uint32_t _nSpans;
+    std::uint32_t _nUnits;
+    union {
+        std::uint16_t _inline[INLINE_SIZE];
+        std::uint16_t *_heap;
+    };
+};
+
+}  // namespace geom
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_GEOM_PACKEDSPANSET_H
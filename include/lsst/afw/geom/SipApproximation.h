@@ -118,9 +118,13 @@ public:
      *                              declare smaller singular values zero in the least
      *                              squares solution.  Negative values use Eigen's
      *                              internal default.
+     *  @param[in]  numThreads      Maximum number of threads to use when evaluating
+     *                              pixelToIwc on the grid and when fitting; 0 means
+     *                              one per hardware thread.  Also used by later calls
+     *                              to updateGrid, refineGrid, and fit.
      *
-     *  @throws lsst::pex::exceptions::InvalidParameterError Thrown if order is negative
-     *      or gridShape is non-positive.
+     *  @throws lsst::pex::exceptions::InvalidParameterError Thrown if order is negative,
+     *      gridShape is non-positive, or numThreads is negative.
      *
      *  @exceptsafe strong
      */
@@ -132,7 +136,8 @@ public:
         lsst::geom::Extent2I const & gridShape,
         int order,
         bool useInverse=true,
-        double svdThreshold=-1
+        double svdThreshold=-1,
+        int numThreads=1
     );
 
     /**
@@ -167,9 +172,12 @@ public:
      *                              to data points generated by calls to
      *                              pixelToIwc.applyInverse instead of
      *                              pixelToIwc.applyForward.
+     *  @param[in]  numThreads      Maximum number of threads to use, as for the
+     *                              fitting constructor.
      *
      *  @throws lsst::pex::exceptions::InvalidParameterError Thrown if gridShape
-     *       is non-positive, or any matrix argument is non-square.
+     *       is non-positive, any matrix argument is non-square, or numThreads is
+     *       negative.
      *
      *  @exceptsafe strong
      */
@@ -183,7 +191,8 @@ public:
         ndarray::Array<double const, 2> const & b,
         ndarray::Array<double const, 2> const & ap,
         ndarray::Array<double const, 2> const & bp,
-        bool useInverse=true
+        bool useInverse=true,
+        int numThreads=1
     );
 
     // No copies just because they'd be a pain to implement and probably aren't necessary
@@ -323,6 +332,10 @@ public:
     /**
      *  Obtain a new solution at the given order with the current grid.
      *
+     *  The basis functions are evaluated on the grid only if they have not
+     *  already been evaluated there at this or a higher order, so refitting
+     *  at different orders on the same grid is cheap.
+     *
      *  @param[in]  order           Polynomial order to fit.
      *  @param[in]  svdThreshold    Fraction of the largest singular value at which to
      *                              declare smaller singular values zero in the least
@@ -337,6 +350,34 @@ public:
      */
     void fit(int order, double svdThreshold=-1);
 
+    /**
+     *  Obtain a new solution with the current grid at the lowest order that
+     *  meets a tolerance.
+     *
+     *  Orders from zero to maxOrder are tried in turn, and the first whose
+     *  forward and reverse deviations (see computeMaxDeviation) are both no
+     *  larger than tolerance is kept.  If no order meets the tolerance, the
+     *  solution at maxOrder is kept.  The grid's basis matrices are evaluated
+     *  once, at maxOrder, and reused for every lower order; later calls to fit
+     *  or fitToTolerance on the same grid at no higher order reuse them too.
+     *
+     *  @param[in]  maxOrder        Highest polynomial order to fit.
+     *  @param[in]  tolerance       Largest acceptable deviation, in the units of
+     *                              computeMaxDeviation.
+     *  @param[in]  svdThreshold    As for fit.
+     *
+     *  @returns the order of the new solution.
+     *
+     *  @throws pex::exceptions::InvalidParameterError Thrown if maxOrder is
+     *          negative.
+     *  @throws pex::exceptions::LogicError Thrown if the number of free
+     *          parameters implied by maxOrder is larger than the number of
+     *          data points defined by the grid.
+     *
+     *  @exceptsafe strong
+     */
+    int fitToTolerance(int maxOrder, double tolerance, double svdThreshold=-1);
+
     /**
      *  Return the maximum deviation of the solution from the exact transform
      *  on the current grid.
@@ -357,6 +398,7 @@ private:
     struct Solution;
 
     bool _useInverse;
+    int _numThreads;
     std::shared_ptr<TransformPoint2ToPoint2> _pixelToIwc;
     lsst::geom::Box2D _bbox;
     lsst::geom::Extent2D _crpix;
@@ -24,6 +24,7 @@
 #ifndef LSST_AFW_GEOM_SKYWCS_H
 #define LSST_AFW_GEOM_SKYWCS_H
 
+#include <cstddef>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -198,6 +199,14 @@ public:
      */
     lsst::geom::Angle getPixelScale(lsst::geom::Point2D const &pixel) const;
 
+    /**
+     * Get the pixel scale at each of a list of pixel positions
+     *
+     * This gives the same results as calling getPixelScale(pixel) for each position, but transforms all
+     * the points needed in a single call, which is much faster for many points.
+     */
+    std::vector<lsst::geom::Angle> getPixelScale(std::vector<lsst::geom::Point2D> const &pixels) const;
+
     /**
      * Get the pixel scale at the pixel origin
      *
@@ -327,31 +336,52 @@ public:
     lsst::geom::AffineTransform linearizeSkyToPixel(lsst::geom::Point2D const &pixel,
                                                     lsst::geom::AngleUnit const &skyUnit) const;
 
+    /**
+     * Return the local linear approximations to pixelToSky or skyToPixel at each of a list of points
+     *
+     * These give the same results as calling the single-point methods of the same names for each point,
+     * but transform all the points needed in two calls, which is much faster for many points (for
+     * example, all the sources of a catalog).
+     *
+     * @param[in] coords    Positions in sky coordinates where transforms are desired.
+     * @param[in] pixels    Positions in pixel coordinates where transforms are desired.
+     * @param[in] skyUnit   Units to use for sky coordinates.
+     */
+    //@{
+    std::vector<lsst::geom::AffineTransform> linearizePixelToSky(
+            std::vector<lsst::geom::SpherePoint> const &coords, lsst::geom::AngleUnit const &skyUnit) const;
+    std::vector<lsst::geom::AffineTransform> linearizePixelToSky(
+            std::vector<lsst::geom::Point2D> const &pixels, lsst::geom::AngleUnit const &skyUnit) const;
+    std::vector<lsst::geom::AffineTransform> linearizeSkyToPixel(
+            std::vector<lsst::geom::SpherePoint> const &coords, lsst::geom::AngleUnit const &skyUnit) const;
+    std::vector<lsst::geom::AffineTransform> linearizeSkyToPixel(
+            std::vector<lsst::geom::Point2D> const &pixels, lsst::geom::AngleUnit const &skyUnit) const;
+    //@}
+
     /**
      * Compute sky position(s) from pixel position(s)
+     *
+     * A WCS that can be written exactly as FITS TAN or TAN-SIP metadata is evaluated directly, rather
+     * than through AST, once it has been used for enough points to repay checking the direct evaluation
+     * against AST. The results agree with AST to far better than any astrometric requirement.
      */
     //@{
-    lsst::geom::SpherePoint pixelToSky(lsst::geom::Point2D const &pixel) const {
-        return _transform->applyForward(pixel);
-    }
+    lsst::geom::SpherePoint pixelToSky(lsst::geom::Point2D const &pixel) const;
     lsst::geom::SpherePoint pixelToSky(double x, double y) const {
         return pixelToSky(lsst::geom::Point2D(x, y));
     }
-    std::vector<lsst::geom::SpherePoint> pixelToSky(std::vector<lsst::geom::Point2D> const &pixels) const {
-        return _transform->applyForward(pixels);
-    }
+    std::vector<lsst::geom::SpherePoint> pixelToSky(std::vector<lsst::geom::Point2D> const &pixels) const;
     //@}
 
     /**
      * Compute pixel position(s) from sky position(s)
+     *
+     * As for pixelToSky, TAN and TAN-SIP WCS are evaluated directly; for TAN-SIP this requires the
+     * inverse (AP and BP) coefficients.
      */
     //@{
-    lsst::geom::Point2D skyToPixel(lsst::geom::SpherePoint const &sky) const {
-        return _transform->applyInverse(sky);
-    }
-    std::vector<lsst::geom::Point2D> skyToPixel(std::vector<lsst::geom::SpherePoint> const &sky) const {
-        return _transform->applyInverse(sky);
-    }
+    lsst::geom::Point2D skyToPixel(lsst::geom::SpherePoint const &sky) const;
+    std::vector<lsst::geom::Point2D> skyToPixel(std::vector<lsst::geom::SpherePoint> const &sky) const;
     //@}
 
     static std::string getShortClassName();
@@ -453,6 +483,16 @@ private:
     lsst::geom::Point2D _pixelOrigin;       // cached pixel origin
     lsst::geom::Angle _pixelScaleAtOrigin;  // cached pixel scale at pixel origin
 
+    // direct TAN-SIP evaluation, built on demand and shared by copies
+    struct FastPath;
+    std::shared_ptr<FastPath> _fastPath;
+
+    /*
+     * Return the direct evaluator if it is known to be usable, counting nPoints towards the number of
+     * points that must be transformed before it is built; otherwise return null.
+     */
+    FastPath const *_getFastPath(std::size_t nPoints) const;
+
     /*
      * Implementation for the overloaded public linearizePixelToSky methods, requiring both a pixel coordinate
      * and the corresponding sky coordinate.
@@ -461,6 +501,14 @@ private:
                                                      lsst::geom::SpherePoint const &coord,
                                                      lsst::geom::AngleUnit const &skyUnit) const;
 
+    /*
+     * Implementation for the public linearizePixelToSky and linearizeSkyToPixel methods for lists of points,
+     * requiring both the pixel coordinates and the corresponding sky coordinates.
+     */
+    std::vector<lsst::geom::AffineTransform> _linearizePixelToSky(
+            std::vector<lsst::geom::Point2D> const &pixels,
+            std::vector<lsst::geom::SpherePoint> const &coords, lsst::geom::AngleUnit const &skyUnit) const;
+
     /*
      * Implementation for the overloaded public linearizeSkyToPixel methods, requiring both a pixel coordinate
      * and the corresponding sky coordinate.
@@ -469,12 +517,8 @@ private:
                                                      lsst::geom::SpherePoint const &coord,
                                                      lsst::geom::AngleUnit const &skyUnit) const;
 
-    /// Compute _pixelOrigin and _pixelScaleAtOrigin
-    void _computeCache() {
-        _transform = std::make_shared<TransformPoint2ToSpherePoint>(*_frameDict->getMapping(), true);
-        _pixelOrigin = skyToPixel(getSkyOrigin());
-        _pixelScaleAtOrigin = getPixelScale(_pixelOrigin);
-    }
+    /// Compute _transform, _pixelOrigin and _pixelScaleAtOrigin, and reset _fastPath
+    void _computeCache();
 };
 
 /**
@@ -524,15 +568,32 @@ std::shared_ptr<SkyWcs> makeModifiedWcs(TransformPoint2ToPoint2 const &pixelTran
  * because it allows us to change SkyWcs to an abstract base class in the future,
  * without affecting code that constructs a WCS from FITS metadata.
  *
+ * Unless `useCache` is false, the SkyWcs is looked up in a process-wide cache keyed on the WCS-related
+ * cards of `metadata` (see setSkyWcsMetadataCacheCapacity), so that reading many files with the same WCS
+ * gives one shared SkyWcs (which is immutable) instead of parsing each header.  `metadata` is stripped
+ * (or not) exactly as it would be without the cache.
+ *
  * @param[in] metadata  FITS header metadata
  * @param[in] strip  If true: strip items from `metadata` used to create the WCS,
  *    such as RADESYS, EQUINOX, CTYPE12, CRPIX12, CRVAL12, etc.
  *    Always keep keywords that might be wanted for other purpposes, including NAXIS12
  *    and date-related keywords such as "DATE-OBS" and "TIMESYS" (but not "EQUINOX").
+ * @param[in] useCache  If false, always read a new SkyWcs from `metadata`.
  *
  * @throws lsst::pex::exceptions::TypeError if the metadata does not describe a celestial WCS.
  */
-std::shared_ptr<SkyWcs> makeSkyWcs(daf::base::PropertySet &metadata, bool strip = false);
+std::shared_ptr<SkyWcs> makeSkyWcs(daf::base::PropertySet &metadata, bool strip = false,
+                                   bool useCache = true);
+
+/**
+ * Set the number of SkyWcs read from FITS metadata that makeSkyWcs caches.
+ *
+ * Changing the capacity empties the cache; a capacity of 0 disables it.
+ */
+void setSkyWcsMetadataCacheCapacity(std::size_t capacity);
+
+/// Return the number of SkyWcs read from FITS metadata that makeSkyWcs caches
+std::size_t getSkyWcsMetadataCacheCapacity();
 
 /**
  * Construct a simple FITS SkyWcs with no distortion
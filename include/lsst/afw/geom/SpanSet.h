@@ -37,10 +37,13 @@
 #include "lsst/afw/table/io/Persistable.h"
 #include "lsst/afw/geom/ellipses/Ellipse.h"
 #include "lsst/afw/geom/ellipses/Quadrupole.h"
+#include "lsst/afw/geom/ellipses/PixelRegion.h"
 #include "lsst/afw/geom/SpanSetFunctorGetters.h"
 #include "lsst/afw/geom/Transform.h"
 #include "lsst/afw/image/Image.h"
 #include "lsst/afw/image/MaskedImage.h"
+#include "lsst/afw/math/Instrumentation.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace lsst {
 namespace afw {
@@ -55,6 +58,35 @@ public:
     bool operator()(T pixelValue) { return pixelValue != 0; }
 };
 
+/* Return the number of elements held by each pixel if every run of consecutive pixels along a row of
+ * image (whose first two dimensions are y,x) is one block of memory, as is every run of consecutive
+ * pixels of flat (whose first dimension indexes pixels), and both have the same per-pixel shape.
+ * SpanSet can then copy whole spans between the two with std::copy; otherwise return 0.
+ */
+template <typename ImagePixel, int imageN, int imageC, typename FlatPixel, int flatC>
+std::ptrdiff_t getSpanRunPixelSize(ndarray::Array<ImagePixel, imageN, imageC> const &image,
+                                   ndarray::Array<FlatPixel, imageN - 1, flatC> const &flat) {
+    auto const imageShape = image.getShape();
+    auto const imageStrides = image.getStrides();
+    auto const flatShape = flat.getShape();
+    auto const flatStrides = flat.getStrides();
+    std::ptrdiff_t pixelSize = 1;
+    for (int i = imageN - 2; i >= 0; --i) {
+        // Strides of dimensions of length one are never used, so need not match
+        if (i > 0 && imageShape[i + 1] != flatShape[i]) {
+            return 0;
+        }
+        if ((imageShape[i + 1] > 1 && imageStrides[i + 1] != pixelSize) ||
+            (flatShape[i] > 1 && flatStrides[i] != pixelSize)) {
+            return 0;
+        }
+        if (i > 0) {
+            pixelSize *= flatShape[i];
+        }
+    }
+    return pixelSize;
+}
+
 }  // namespace details
 
 /** An enumeration class which describes the shapes
@@ -223,6 +255,26 @@ public:
      */
     std::shared_ptr<SpanSet> transformedBy(TransformPoint2ToPoint2 const &t) const;
 
+    /** Apply a 2-D transform to each of many SpanSets
+     *
+     * The result is the same as calling transformedBy on each SpanSet, but the points of all of
+     * them are transformed in a few large calls, and the SpanSets are rebuilt from the
+     * transformed points in parallel. This is much faster than transformedBy for the many small
+     * SpanSets of a catalog, each of which would otherwise cost several calls to the transform.
+     *
+     * @param spanSets SpanSets to transform
+     * @param t A 2-D transform which will be used to map the pixels
+     * @param numThreads number of threads to spread the transformed points and SpanSets over;
+     *                   0 means one per hardware thread
+     *
+     * @returns one SpanSet per element of spanSets, in the same order
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
+     */
+    static std::vector<std::shared_ptr<SpanSet>> transformEach(
+            std::vector<std::shared_ptr<SpanSet>> const &spanSets, TransformPoint2ToPoint2 const &t,
+            int numThreads = 1);
+
     /** Specifies if this SpanSet overlaps with another SpanSet
      *
      * @param other A SpanSet for which overlapping comparison will be made
@@ -256,16 +308,24 @@ public:
      * @param r radius of the stencil, the length is inclusive i.e. 3 ranges from -3 to 3
      * @param s must be an enumeration of type geom::Stencil. Specifies the shape of the
                 dilation kernel. May be CIRCLE, MANHATTAN, or BOX
+     * @param numThreads number of threads to spread bands of rows over; 0 means one per hardware
+                thread
      */
-    std::shared_ptr<SpanSet> dilated(int r, Stencil s = Stencil::CIRCLE) const;
+    std::shared_ptr<SpanSet> dilated(int r, Stencil s = Stencil::CIRCLE, int numThreads = 1) const;
 
     /** Perform a set dilation operation, and return a new object
      *
      * Dilate a SpanSet with a kernel specified by another SpanSet
      *
+     * The result is built a row at a time: each output row merges the input rows it draws from,
+     * widened by the kernel's spans, so the cost is proportional to the number of input spans
+     * times the number of kernel spans, and rows may be computed in parallel.
+     *
      * @param other A SpanSet which specifies the kernel to use for dilation
+     * @param numThreads number of threads to spread bands of rows over; 0 means one per hardware
+                thread
      */
-    std::shared_ptr<SpanSet> dilated(SpanSet const &other) const;
+    std::shared_ptr<SpanSet> dilated(SpanSet const &other, int numThreads = 1) const;
 
     /** Perform a set erosion, and return a new object
      *
@@ -274,16 +334,23 @@ public:
      * @param r radius of the stencil, the length is inclusive i.e. 3 ranges from -3 to 3
      * @param s must be an enumeration of type geom::Stencil. Specifies the shape of the
                 erosion kernel. May be CIRCLE, MANHATTAN, or BOX
+     * @param numThreads number of threads to spread bands of rows over; 0 means one per hardware
+                thread
      */
-    std::shared_ptr<SpanSet> eroded(int r, Stencil s = Stencil::CIRCLE) const;
+    std::shared_ptr<SpanSet> eroded(int r, Stencil s = Stencil::CIRCLE, int numThreads = 1) const;
 
     /** Perform a set erosion operation, and return a new object
      *
      * Erode a SpanSet with a kernel specified by another SpanSet
      *
+     * The result is built a row at a time, as the intersection of the input rows under each of
+     * the kernel's spans, shrunk by the width of that span; rows may be computed in parallel.
+     *
      * @param other A SpanSet which specifies the kernel to use for erosion
+     * @param numThreads number of threads to spread bands of rows over; 0 means one per hardware
+                thread
      */
-    std::shared_ptr<SpanSet> eroded(SpanSet const &other) const;
+    std::shared_ptr<SpanSet> eroded(SpanSet const &other, int numThreads = 1) const;
 
     /** Reduce the pixel dimensionality from 2 to 1 of an array at points given by SpanSet
      *
@@ -298,18 +365,19 @@ public:
      *
      * @param input The ndarray from which the values will be taken
      * @param xy0 A point object with is used as the origin point for the SpanSet coordinate system
+     * @param numThreads number of threads to spread the spans over; 0 means one per hardware thread
      */
     template <typename Pixel, int inN, int inC>
     ndarray::Array<typename std::remove_const<Pixel>::type, inN - 1, inN - 1> flatten(
             ndarray::Array<Pixel, inN, inC> const &input,
-            lsst::geom::Point2I const &xy0 = lsst::geom::Point2I()) const {
+            lsst::geom::Point2I const &xy0 = lsst::geom::Point2I(), int numThreads = 1) const {
         // Populate a lower dimensional array with the values from input taken at the points of SpanSet
         auto outputShape = ndarray::concatenate(ndarray::makeVector(getArea()),
                                                 input.getShape().template last<inN - 2>());
         ndarray::Array<typename std::remove_const<Pixel>::type, inN - 1, inN - 1> outputArray =
                 ndarray::allocate(outputShape);
         outputArray.deep() = 0;
-        flatten(outputArray, input, xy0);
+        flatten(outputArray, input, xy0, numThreads);
         return outputArray;
     }
 
@@ -320,6 +388,10 @@ public:
      * dimensions of the input array must be the h,w which correspond to the SpanSet coordinates. Any
      * number of remaining dimensions is permissible.
      *
+     * When each row of the input and the whole of each output pixel range are contiguous in memory, as
+     * they are for image arrays and freshly-allocated arrays, every span is copied as a single block,
+     * and blocks of spans may be copied in parallel; otherwise pixels are copied one at a time.
+     *
      * @tparam PixelOut The data-type for the output ndarray
      * @tparam PixelIn The data-type for the input ndarray
      * @tparam inA The number of dimensions in the input array
@@ -331,11 +403,29 @@ public:
      * @param[out] output The 1d ndarray which will be populated with output parameters, will happen in place
      * @param[in] input The ndarray from which the values will be taken
      * @param[in] xy0 A point object which is used as the origin point for the SpanSet coordinate system
+     * @param[in] numThreads number of threads to spread the spans over when they are copied as blocks;
+     *                       0 means one per hardware thread
      */
     template <typename PixelIn, typename PixelOut, int inA, int outC, int inC>
     void flatten(ndarray::Array<PixelOut, inA - 1, outC> const &output,
                  ndarray::Array<PixelIn, inA, inC> const &input,
-                 lsst::geom::Point2I const &xy0 = lsst::geom::Point2I()) const {
+                 lsst::geom::Point2I const &xy0 = lsst::geom::Point2I(), int numThreads = 1) const {
+        std::ptrdiff_t const pixelSize = details::getSpanRunPixelSize(input, output);
+        if (pixelSize > 0) {
+            ndarray::ndFlat(output).checkExtents(_bbox, _area);
+            ndarray::ndImage(input, xy0).checkExtents(_bbox, _area);
+            PixelIn *const inData = input.getData();
+            PixelOut *const outData = output.getData();
+            std::ptrdiff_t const rowStride = input.template getStride<0>();
+            _forEachSpan(
+                    [&](Span const &spn, std::size_t offset) {
+                        PixelIn *const begin = inData + (spn.getY() - xy0.getY()) * rowStride +
+                                               (spn.getX0() - xy0.getX()) * pixelSize;
+                        std::copy(begin, begin + spn.getWidth() * pixelSize, outData + offset * pixelSize);
+                    },
+                    numThreads);
+            return;
+        }
         auto ndAssigner = [](lsst::geom::Point2I const &point,
                              typename details::FlatNdGetter<PixelOut, inA - 1, outC>::Reference out,
                              typename details::ImageNdGetter<PixelIn, inA, inC>::Reference in) { out = in; };
@@ -355,10 +445,11 @@ public:
      * @tparam inC Number of guaranteed row-major contiguous dimensions, starting from the end
      *
      * @param input The ndarray from which the values will be taken
+     * @param numThreads number of threads to spread the spans over; 0 means one per hardware thread
      */
     template <typename Pixel, int inA, int inC>
     ndarray::Array<typename std::remove_const<Pixel>::type, inA + 1, inA + 1> unflatten(
-            ndarray::Array<Pixel, inA, inC> const &input) const {
+            ndarray::Array<Pixel, inA, inC> const &input, int numThreads = 1) const {
         // Create a higher dimensional array the size of the bounding box and extra dimensions of input.
         // Populate values from input, placed at locations corresponding to SpanSet, offset by the
         // lower corner of the bounding box
@@ -370,7 +461,7 @@ public:
         ndarray::Array<typename std::remove_const<Pixel>::type, inA + 1, inA + 1> outputArray =
                 ndarray::allocate(outputShape);
         outputArray.deep() = 0;
-        unflatten(outputArray, input, lsst::geom::Point2I(_bbox.getMinX(), _bbox.getMinY()));
+        unflatten(outputArray, input, lsst::geom::Point2I(_bbox.getMinX(), _bbox.getMinY()), numThreads);
         return outputArray;
     }
 
@@ -381,6 +472,9 @@ public:
     * bounding box of the SpanSet. The first two dimensions of the output array will correspond to the
     * y,x dimensions of the SpanSet
     *
+    * As with flatten, spans are copied as single blocks, possibly in parallel, when the arrays' layout
+    * allows it.
+    *
     * @tparam PixelOut The datatype for the output ndarray
     * @tparam PixelIn The datatype for the input ndarray
     * @tparam inA Number of dimensions of the input ndarray
@@ -392,11 +486,30 @@ public:
     * @param[out] output The 1d ndarray which will be populated with output parameters, will happen in place
     * @param[in] input The ndarray from which the values will be taken
     * @param[in] xy0 A point object with is used as the origin point for the SpanSet coordinate system
+    * @param[in] numThreads number of threads to spread the spans over when they are copied as blocks;
+    *                       0 means one per hardware thread
     */
     template <typename PixelIn, typename PixelOut, int inA, int outC, int inC>
     void unflatten(ndarray::Array<PixelOut, inA + 1, outC> const &output,
                    ndarray::Array<PixelIn, inA, inC> const &input,
-                   lsst::geom::Point2I const &xy0 = lsst::geom::Point2I()) const {
+                   lsst::geom::Point2I const &xy0 = lsst::geom::Point2I(), int numThreads = 1) const {
+        std::ptrdiff_t const pixelSize = details::getSpanRunPixelSize(output, input);
+        if (pixelSize > 0) {
+            ndarray::ndImage(output, xy0).checkExtents(_bbox, _area);
+            ndarray::ndFlat(input).checkExtents(_bbox, _area);
+            PixelIn *const inData = input.getData();
+            PixelOut *const outData = output.getData();
+            std::ptrdiff_t const rowStride = output.template getStride<0>();
+            _forEachSpan(
+                    [&](Span const &spn, std::size_t offset) {
+                        PixelIn *const begin = inData + offset * pixelSize;
+                        std::copy(begin, begin + spn.getWidth() * pixelSize,
+                                  outData + (spn.getY() - xy0.getY()) * rowStride +
+                                          (spn.getX0() - xy0.getX()) * pixelSize);
+                    },
+                    numThreads);
+            return;
+        }
         // Populate 2D ndarray output with values from input, at locations defined by SpanSet, optionally
         // offset by xy0
         auto ndAssigner = [](lsst::geom::Point2I const &point,
@@ -414,10 +527,7 @@ public:
      */
     template <typename ImageT>
     void copyImage(image::Image<ImageT> const &src, image::Image<ImageT> &dest) {
-        auto copyFunc = [](lsst::geom::Point2I const &point, ImageT const &srcPix, ImageT &destPix) {
-            destPix = srcPix;
-        };
-        applyFunctor(copyFunc, src, dest);
+        _copySpans(src.getArray(), src.getXY0(), dest.getArray(), dest.getXY0());
     }
 
     /** Copy contents of source MaskedImage into destination image at the positions defined in the SpanSet
@@ -432,14 +542,17 @@ public:
     template <typename ImageT, typename MaskT, typename VarT>
     void copyMaskedImage(image::MaskedImage<ImageT, MaskT, VarT> const &src,
                          image::MaskedImage<ImageT, MaskT, VarT> &dest) {
-        auto copyFunc = [](lsst::geom::Point2I const &point, ImageT const &srcPix, MaskT const &srcMask,
-                           VarT const &srcVar, ImageT &destPix, MaskT &destMask, VarT &destVar) {
-            destPix = srcPix;
-            destMask = srcMask;
-            destVar = srcVar;
-        };
-        applyFunctor(copyFunc, *(src.getImage()), *(src.getMask()), *(src.getVariance()), *(dest.getImage()),
-                     *(dest.getMask()), *(dest.getVariance()));
+        // Check all the planes before copying any, so a bad destination is left untouched
+        for (auto const &box : {src.getBBox(), dest.getBBox()}) {
+            if (!box.contains(_bbox)) {
+                throw LSST_EXCEPT(lsst::pex::exceptions::OutOfRangeError,
+                                  "SpanSet bounding box lands outside array");
+            }
+        }
+        _copySpans(src.getImage()->getArray(), src.getXY0(), dest.getImage()->getArray(), dest.getXY0());
+        _copySpans(src.getMask()->getArray(), src.getXY0(), dest.getMask()->getArray(), dest.getXY0());
+        _copySpans(src.getVariance()->getArray(), src.getXY0(), dest.getVariance()->getArray(),
+                   dest.getXY0());
     }
 
     /** Set the values of an Image at points defined by the SpanSet
@@ -548,6 +661,41 @@ public:
      */
     std::shared_ptr<SpanSet> intersect(SpanSet const &other) const;
 
+    /** Determine the common points between two SpanSets, as normalized Spans in caller-provided storage
+     *
+     * This and the other set operations that take an output vector merge the two sorted lists of
+     * Spans in a single pass, and let callers that perform many operations reuse one vector rather
+     * than allocate a new SpanSet each time.
+     *
+     * @param other The other SpanSet with which to intersect with
+     * @param[out] output Replaced by the Spans of the intersection, sorted and normalized
+     */
+    void intersect(SpanSet const &other, std::vector<Span> &output) const;
+
+    /** Intersect this SpanSet with each of many others
+     *
+     * @param others SpanSets with which to intersect this one
+     * @param numThreads number of threads to spread the intersections over; 0 means one per
+                hardware thread
+     *
+     * @returns one SpanSet per element of others, in the same order
+     */
+    std::vector<std::shared_ptr<SpanSet>> intersectEach(std::vector<std::shared_ptr<SpanSet>> const &others,
+                                                        int numThreads = 1) const;
+
+    /** Clip this SpanSet to each of many boxes, such as the amplifiers of a detector
+     *
+     * Each box only visits the Spans in its rows, so this is much faster than clippedTo for many
+     * small boxes.
+     *
+     * @param boxes Boxes to clip to
+     * @param numThreads number of threads to spread the boxes over; 0 means one per hardware thread
+     *
+     * @returns one SpanSet per box, in the same order
+     */
+    std::vector<std::shared_ptr<SpanSet>> intersectEach(std::vector<lsst::geom::Box2I> const &boxes,
+                                                        int numThreads = 1) const;
+
     /** Determine the common points between a SpanSet and a Mask with a given bit pattern
      *
      * @tparam T Pixel type of the Mask
@@ -565,6 +713,14 @@ public:
      */
     std::shared_ptr<SpanSet> intersectNot(SpanSet const &other) const;
 
+    /** Determine the points of this SpanSet not in a second SpanSet, as normalized Spans in
+     *  caller-provided storage
+     *
+     * @param other The spanset which will be logically inverted when computing the intersection
+     * @param[out] output Replaced by the Spans of the result, sorted and normalized
+     */
+    void intersectNot(SpanSet const &other, std::vector<Span> &output) const;
+
     /** @brief Determine the common points between a SpanSet and the logical inverse of a Mask for a
      *  given bit pattern
      *
@@ -582,6 +738,13 @@ public:
      */
     std::shared_ptr<SpanSet> union_(SpanSet const &other) const;
 
+    /** Determine all points from two SpanSets, as normalized Spans in caller-provided storage
+     *
+     * @param other The SpanSet from which the union will be calculated
+     * @param[out] output Replaced by the Spans of the union, sorted and normalized
+     */
+    void union_(SpanSet const &other, std::vector<Span> &output) const;
+
     /** Determine the union between a SpanSet and a Mask for a given bit pattern
      *
      * @tparam T Pixel type of the Mask
@@ -624,6 +787,14 @@ public:
      */
     static std::shared_ptr<geom::SpanSet> fromShape(geom::ellipses::Ellipse const &ellipse);
 
+    /** Factory function for creating SpanSets from an ellipse object, reusing cached setup for its core
+     *
+     * @param ellipse An ellipse defining the region to create a SpanSet from
+     * @param cache   Cache of per-core setup shared by calls for ellipses with the same core
+     */
+    static std::shared_ptr<geom::SpanSet> fromShape(geom::ellipses::Ellipse const &ellipse,
+                                                    geom::ellipses::PixelRegionCache &cache);
+
     /** Create a SpanSet from a mask.
      *
      * Create a SpanSet from a class. The default behavior is to include any pixels which have any
@@ -692,19 +863,46 @@ public:
      *
      * Create a SpanSet from a Mask at pixels with the specified bit pattern
      *
+     * Unlike the overload taking a functor, this tests blocks of pixels at a time, skipping quickly
+     * over blocks entirely inside or outside the SpanSet, so it is much faster for the large, mostly
+     * empty masks of full detectors.
+     *
      * @tparam T Pixel type of the Mask
      *
      * @param mask mask to convert to a SpanSet
-     * @param bitmask bit pattern used to specify which pixel to include
+     * @param bitmask bit pattern used to specify which pixel to include; a pixel is included if any of
+     *                these bits is set
+     * @param numThreads number of threads to spread bands of rows over; 0 means one per hardware
+     *                   thread
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
      */
     template <typename T>
-    static std::shared_ptr<geom::SpanSet> fromMask(image::Mask<T> const &mask, T bitmask) {
-        return fromMask(mask, [bitmask](T const &bitPattern) { return bitPattern & bitmask; });
-    }
+    static std::shared_ptr<geom::SpanSet> fromMask(image::Mask<T> const &mask, T bitmask,
+                                                   int numThreads = 1);
 
     /** Split a discontinuous SpanSet into multiple SpanSets which are contiguous
+     *
+     * Spans are connected when they are in adjacent rows and overlap in x. The pieces are in order of
+     * their first Span in this SpanSet. An empty SpanSet splits into a single empty SpanSet.
+     *
+     * @param numThreads number of threads to spread bands of rows over; 0 means one per hardware
+                thread
      */
-    std::vector<std::shared_ptr<geom::SpanSet>> split() const;
+    std::vector<std::shared_ptr<geom::SpanSet>> split(int numThreads = 1) const;
+
+    /** Find the contiguous pieces of a SpanSet, without making a SpanSet for each
+     *
+     * The Spans of every piece are written to one buffer, each piece's sorted, and normalized if this
+     * SpanSet is. Pieces are in the same order as those returned by split().
+     *
+     * @param[out] spans Spans of all the pieces, one piece after another
+     * @param[out] offsets Spans of piece i are spans[offsets[i]] to spans[offsets[i + 1] - 1]; has one
+     *                     element more than there are pieces, so is {0} for an empty SpanSet
+     * @param[in] numThreads number of threads to spread bands of rows over; 0 means one per hardware
+     *                       thread
+     */
+    void split(std::vector<Span> &spans, std::vector<std::size_t> &offsets, int numThreads = 1) const;
 
     bool isPersistable() const noexcept override { return true; }
 
@@ -739,15 +937,59 @@ private:
      */
     void _initialize();
 
-    /* Label Spans according to contiguous group. If the SpanSet is contiguous, all Spans will be labeled 1.
-     * If there is more than one group each group will receive a label one higher than the previous.
+    /* Charge the memory held by the spans to the "geom.SpanSet" memory counter
      */
-    void _label(geom::Span const &spn, std::vector<std::size_t> &labelVector, std::size_t currentLabel,
-                std::unordered_map<int, std::vector<std::pair<std::size_t, const Span *>>> &sortVector) const;
-    std::pair<std::vector<std::size_t>, std::size_t> _makeLabels() const;
+    void _chargeMemory();
 
     std::shared_ptr<SpanSet> makeShift(int x, int y) const;
 
+    /* Call func(span, offset) for each span, where offset is the number of pixels in the spans before
+     * it, so that flattened arrays can be indexed directly. With more than one thread, contiguous blocks
+     * of spans go to different threads, so func must be safe to call concurrently on different spans.
+     */
+    template <typename F>
+    void _forEachSpan(F const &func, int numThreads) const {
+        int const nThreads = math::detail::resolveNumThreads(numThreads);
+        int const nSpans = static_cast<int>(_spanVector.size());
+        if (nThreads == 1 || nSpans < 2) {
+            std::size_t offset = 0;
+            for (auto const &spn : _spanVector) {
+                func(spn, offset);
+                offset += spn.getWidth();
+            }
+            return;
+        }
+        auto const blocks = math::detail::splitRange(0, nSpans, nThreads);
+        std::vector<std::size_t> blockOffsets(blocks.size(), 0);
+        for (std::size_t i = 1; i < blocks.size(); ++i) {
+            blockOffsets[i] = blockOffsets[i - 1];
+            for (int j = blocks[i - 1].first; j < blocks[i - 1].second; ++j) {
+                blockOffsets[i] += _spanVector[j].getWidth();
+            }
+        }
+        math::detail::parallelFor(static_cast<int>(blocks.size()), nThreads, [&](int i) {
+            std::size_t offset = blockOffsets[i];
+            for (int j = blocks[i].first; j < blocks[i].second; ++j) {
+                func(_spanVector[j], offset);
+                offset += _spanVector[j].getWidth();
+            }
+        });
+    }
+
+    /* Copy the pixels of the SpanSet between two image arrays, whose rows are contiguous, a span at a time
+     */
+    template <typename SrcPixel, typename DestPixel>
+    void _copySpans(ndarray::Array<SrcPixel, 2, 1> const &src, lsst::geom::Point2I const &srcXY0,
+                    ndarray::Array<DestPixel, 2, 1> const &dest, lsst::geom::Point2I const &destXY0) const {
+        ndarray::ndImage(src, srcXY0).checkExtents(_bbox, _area);
+        ndarray::ndImage(dest, destXY0).checkExtents(_bbox, _area);
+        for (auto const &spn : _spanVector) {
+            SrcPixel *const begin = src[spn.getY() - srcXY0.getY()].getData() + (spn.getX0() - srcXY0.getX());
+            std::copy(begin, begin + spn.getWidth(),
+                      dest[spn.getY() - destXY0.getY()].getData() + (spn.getX0() - destXY0.getX()));
+        }
+    }
+
     template <typename F, typename... T>
     void applyFunctorImpl(F &&f, T... args) const {
         /* Implementation for applying functors, loop over each of the spans, and then
@@ -775,6 +1017,9 @@ private:
 
     // Number of pixels in the SpanSet
     std::size_t _area;
+
+    // Charge for the memory held by _spanVector
+    math::MemoryCharge _memoryCharge;
 };
 }  // namespace geom
 }  // namespace afw
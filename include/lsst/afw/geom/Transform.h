@@ -150,8 +150,13 @@ public:
      * The first dimension of the array must match the number of input axes, and the data order is
      * values for the first axis, then values for the next axis, and so on, e.g. for 2 axes:
      *     x0, x1, x2, ..., y0, y1, y2...
+     *
+     * @param[in] array  points to transform
+     * @param[in] numThreads  maximum number of threads to use; 0 means one per hardware thread.
+     *                        Each thread needs its own copy of the mapping, so only arrays of
+     *                        many thousands of points are split.
      */
-    ToArray applyForward(FromArray const &array) const;
+    ToArray applyForward(FromArray const &array, int numThreads = 1) const;
 
     /**
      * Transform one point in the inverse direction ("to" to "from")
@@ -164,8 +169,11 @@ public:
      * The first dimension of the array must match the number of output axes, and the data order is
      * values for the first axis, then values for the next axis, and so on, e.g. for 2 axes:
      *     x0, x1, x2, ..., y0, y1, y2...
+     *
+     * @param[in] array  points to transform
+     * @param[in] numThreads  maximum number of threads to use, as for applyForward
      */
-    FromArray applyInverse(ToArray const &array) const;
+    FromArray applyInverse(ToArray const &array, int numThreads = 1) const;
 
     /**
      * The inverse of this Transform.
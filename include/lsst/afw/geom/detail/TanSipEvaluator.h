@@ -0,0 +1,98 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_GEOM_DETAIL_TANSIPEVALUATOR_H
+#define LSST_AFW_GEOM_DETAIL_TANSIPEVALUATOR_H
+
+#include <memory>
+
+#include "Eigen/Core"
+
+#include "lsst/daf/base/PropertySet.h"
+
+namespace lsst {
+namespace afw {
+namespace geom {
+namespace detail {
+
+/**
+ * @internal Direct evaluation of a FITS TAN or TAN-SIP WCS, without going through AST.
+ *
+ * Pixel positions use the LSST convention (the center of the first pixel is 0, where FITS uses 1) and
+ * sky positions are right ascension and declination in radians, in the system of the metadata.
+ *
+ * The evaluator only knows the FITS keywords it was built from; SkyWcs checks it against the AST
+ * mapping before trusting it.
+ */
+class TanSipEvaluator final {
+public:
+    /**
+     * Make an evaluator from FITS WCS metadata, or return null if the metadata describes a WCS this class
+     * cannot evaluate.
+     *
+     * Supported are a longitude-first TAN or TAN-SIP projection with a CD matrix, in degrees, with
+     * the default LONPOLE and no PV distortion terms. The SIP inverse is used only if AP and BP are present.
+     */
+    static std::shared_ptr<TanSipEvaluator const> make(daf::base::PropertySet const &metadata);
+
+    /**
+     * Compute the sky position of a pixel.
+     *
+     * @returns false, leaving ra and dec unset, if the pixel is not finite.
+     */
+    bool pixelToSky(double x, double y, double &ra, double &dec) const noexcept;
+
+    /**
+     * Compute the pixel position of a sky position.
+     *
+     * @returns false, leaving x and y unset, if there are no inverse SIP coefficients or the sky
+     *          position is 90 degrees or more from CRVAL.
+     */
+    bool skyToPixel(double ra, double dec, double &x, double &y) const noexcept;
+
+    /// Return whether skyToPixel can be used at all.
+    bool hasInverse() const noexcept { return _hasInverse; }
+
+private:
+    TanSipEvaluator() = default;
+
+    double _crpix[2];           // CRPIX, minus 1 for the LSST pixel convention
+    Eigen::Matrix2d _cd;        // CD matrix, in radians per pixel
+    Eigen::Matrix2d _cdInverse;
+    double _ra0;                // CRVAL, in radians
+    double _sinDec0;
+    double _cosDec0;
+    Eigen::MatrixXd _a;         // SIP coefficients; 0x0 for a pure TAN WCS
+    Eigen::MatrixXd _b;
+    Eigen::MatrixXd _ap;
+    Eigen::MatrixXd _bp;
+    bool _hasInverse;
+};
+
+}  // namespace detail
+}  // namespace geom
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_GEOM_DETAIL_TANSIPEVALUATOR_H
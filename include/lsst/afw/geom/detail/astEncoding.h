@@ -0,0 +1,61 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_GEOM_DETAIL_ASTENCODING_H
+#define LSST_AFW_GEOM_DETAIL_ASTENCODING_H
+
+#include <cstdint>
+#include <string>
+
+#include "ndarray.h"
+
+namespace lsst {
+namespace afw {
+namespace geom {
+namespace detail {
+
+/**
+ * @internal Encode the text serialization of an AST object compactly, for table::io persistence.
+ *
+ * The text is split into lines, and each line into its indentation and its space-separated words.
+ * Every distinct word is stored once and then referred to by index, while integers and floating-point
+ * numbers that `printf` reproduces exactly are stored as binary; this removes most of the indentation,
+ * the repeated attribute names and the long decimal numbers that dominate AST's output. The encoding
+ * is lossless: decodeAstText returns exactly the text that was encoded, whatever it holds.
+ */
+ndarray::Array<std::uint8_t, 1, 1> encodeAstText(std::string const &text);
+
+/**
+ * @internal Recover the text encoded by encodeAstText.
+ *
+ * @throws lsst::afw::table::io::MalformedArchiveError if `encoded` is not a valid encoding.
+ */
+std::string decodeAstText(ndarray::Array<std::uint8_t const, 1, 1> const &encoded);
+
+}  // namespace detail
+}  // namespace geom
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_GEOM_DETAIL_ASTENCODING_H
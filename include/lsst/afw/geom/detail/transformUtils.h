@@ -71,6 +71,26 @@ std::shared_ptr<Transform> readStream(std::istream& is);
 template <class Transform>
 void writeStream(Transform const& transform, std::ostream& os);
 
+/**
+ * Apply a mapping to an array of points, optionally splitting the points across threads
+ *
+ * AST objects must not be used by more than one thread at a time, so each thread works on its own copy
+ * of the mapping, read back from its serialization. That costs about as much as transforming a few
+ * thousand points, so arrays too small to give each thread many thousands of points are transformed
+ * by `mapping` itself, on the calling thread.
+ *
+ * @param[in] mapping  mapping to apply
+ * @param[in] from  points to transform, with one row per axis and one column per point
+ * @param[in] forward  apply the forward transform if true, else the inverse
+ * @param[in] numThreads  maximum number of threads to use; 0 means one per hardware thread
+ * @returns the transformed points, with one row per axis and one column per point
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0.
+ */
+ndarray::Array<double, 2, 2> applyMapping(ast::Mapping const& mapping,
+                                          ndarray::Array<double, 2, 2> const& from, bool forward,
+                                          int numThreads = 1);
+
 /*
  * Provide definitions here in the header file to avoid the need for explicit instantiations
  */
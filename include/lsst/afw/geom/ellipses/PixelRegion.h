@@ -24,6 +24,8 @@
 #ifndef LSST_AFW_GEOM_ELLIPSES_PixelRegion_h_INCLUDED
 #define LSST_AFW_GEOM_ELLIPSES_PixelRegion_h_INCLUDED
 
+#include <cstddef>
+#include <string>
 #include <vector>
 
 #include "lsst/geom/Box.h"
@@ -88,10 +90,59 @@ public:
     Span const getSpanAt(int y) const;
 
 private:
+    friend class PixelRegionCache;
+
+    // Quantities that depend only on the ellipse core, not its center.
+    struct CoreGeometry {
+        explicit CoreGeometry(BaseCore const& core);
+
+        lsst::geom::Extent2D dimensions;  // as returned by BaseCore::computeDimensions
+        double p;  // see EllipseHorizontalLineIntersection in PixelRegion.cc for p, r, and t
+        double r;
+        double t;
+    };
+
+    PixelRegion(CoreGeometry const& geometry, lsst::geom::Point2D const& center);
+
     std::vector<Span> _spans;
     lsst::geom::Box2I _bbox;
 };
 
+/**
+ *  A cache of the core-dependent setup for making PixelRegions.
+ *
+ *  Making PixelRegions for many ellipses that share a few cores, such as a
+ *  fixed set of apertures at many source positions, would otherwise convert
+ *  each core to quadrupole form and compute its extent once per ellipse.
+ *  A PixelRegionCache does that once per distinct core (compared by type
+ *  and exact parameters), keeping up to a fixed number of cores.  The regions
+ *  it makes are identical to the ones PixelRegion(Ellipse const&) makes.
+ *
+ *  A PixelRegionCache is not safe to share between threads.
+ */
+class PixelRegionCache final {
+public:
+    /// Construct an empty cache that holds the setup for at most `maxSize` cores.
+    explicit PixelRegionCache(std::size_t maxSize = 16);
+
+    /// Return the PixelRegion of an ellipse, reusing the setup for its core if cached.
+    PixelRegion makePixelRegion(Ellipse const& ellipse);
+
+    /// Return the number of cores whose setup is cached.
+    std::size_t size() const noexcept { return _entries.size(); }
+
+private:
+    struct Entry {
+        std::string name;
+        BaseCore::ParameterVector parameters;
+        PixelRegion::CoreGeometry geometry;
+    };
+
+    std::size_t _maxSize;
+    std::size_t _next;  // entry to replace when the cache is full
+    std::vector<Entry> _entries;
+};
+
 }  // namespace ellipses
 }  // namespace geom
 }  // namespace afw
@@ -0,0 +1,118 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_GEOM_ELLIPSES_batch_h_INCLUDED
+#define LSST_AFW_GEOM_ELLIPSES_batch_h_INCLUDED
+
+/*
+ *  Conversions and transformations of many ellipse cores held as columns of parameters.
+ *
+ *  Note: do not include directly; use the main ellipse header file.
+ */
+
+#include <string>
+
+#include "ndarray.h"
+#include "lsst/geom/LinearTransform.h"
+
+namespace lsst {
+namespace afw {
+namespace geom {
+namespace ellipses {
+
+/**
+ *  Convert columns of quadrupole moments to Axes parameters.
+ *
+ *  Each output element is the same as that of `Axes(Quadrupole(ixx, iyy, ixy))`, but the conversion
+ *  is done in a single loop over plain arrays, with no ellipse core objects.  The inputs and outputs
+ *  may be strided, as catalog columns are.
+ *
+ *  @param[in]  ixx, iyy, ixy   Quadrupole moments.
+ *  @param[out] a, b, theta     Semimajor and semiminor axes and position angle.
+ *
+ *  @throws lsst::pex::exceptions::LengthError if the arrays differ in length.
+ */
+void convertQuadrupolesToAxes(ndarray::Array<double const, 1> const& ixx,
+                              ndarray::Array<double const, 1> const& iyy,
+                              ndarray::Array<double const, 1> const& ixy, ndarray::Array<double, 1> const& a,
+                              ndarray::Array<double, 1> const& b, ndarray::Array<double, 1> const& theta);
+
+/**
+ *  Convert columns of Axes parameters to quadrupole moments.
+ *
+ *  Each output element is the same as that of `Quadrupole(Axes(a, b, theta))`.
+ *
+ *  @param[in]  a, b, theta     Semimajor and semiminor axes and position angle.
+ *  @param[out] ixx, iyy, ixy   Quadrupole moments.
+ *
+ *  @throws lsst::pex::exceptions::LengthError if the arrays differ in length.
+ */
+void convertAxesToQuadrupoles(ndarray::Array<double const, 1> const& a,
+                              ndarray::Array<double const, 1> const& b,
+                              ndarray::Array<double const, 1> const& theta,
+                              ndarray::Array<double, 1> const& ixx, ndarray::Array<double, 1> const& iyy,
+                              ndarray::Array<double, 1> const& ixy);
+
+/**
+ *  Apply a linear transform to columns of quadrupole moments.
+ *
+ *  Each output element equals, to within rounding, that of
+ *  `Quadrupole(ixx, iyy, ixy).transform(transform).copy()`.  The outputs may be the same arrays as
+ *  the inputs.
+ *
+ *  @param[in]  transform       Transform to apply.
+ *  @param[in]  ixx, iyy, ixy   Quadrupole moments to transform.
+ *  @param[out] ixxOut, iyyOut, ixyOut  Transformed quadrupole moments.
+ *
+ *  @throws lsst::pex::exceptions::LengthError if the arrays differ in length.
+ */
+void transformQuadrupoles(lsst::geom::LinearTransform const& transform,
+                          ndarray::Array<double const, 1> const& ixx,
+                          ndarray::Array<double const, 1> const& iyy,
+                          ndarray::Array<double const, 1> const& ixy, ndarray::Array<double, 1> const& ixxOut,
+                          ndarray::Array<double, 1> const& iyyOut, ndarray::Array<double, 1> const& ixyOut);
+
+/**
+ *  Convert the parameters of many ellipse cores from one parametrization to another.
+ *
+ *  Conversions between Quadrupole and Axes use the column functions above; others reuse a single
+ *  pair of ellipse cores for all rows, so no core is allocated per ellipse.
+ *
+ *  @param[in] fromName    Name of the input parametrization, as returned by BaseCore::getName().
+ *  @param[in] toName      Name of the output parametrization.
+ *  @param[in] parameters  Array of shape (N, 3), each row the parameters of one core.
+ *
+ *  @return Array of shape (N, 3) holding the converted parameters.
+ *
+ *  @throws lsst::pex::exceptions::LengthError if `parameters` does not have 3 columns.
+ */
+ndarray::Array<double, 2, 2> convertCores(std::string const& fromName, std::string const& toName,
+                                          ndarray::Array<double const, 2, 1> const& parameters);
+
+}  // namespace ellipses
+}  // namespace geom
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !LSST_AFW_GEOM_ELLIPSES_batch_h_INCLUDED
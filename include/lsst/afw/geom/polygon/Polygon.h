@@ -25,12 +25,14 @@
 #if !defined(LSST_AFW_GEOM_POLYGON_POLYGON_H)
 #define LSST_AFW_GEOM_POLYGON_POLYGON_H
 
+#include <cstddef>
 #include <vector>
 #include <utility>  // for std::pair
 
 #include <memory>
 
 #include "lsst/base.h"
+#include "ndarray.h"
 #include "lsst/pex/exceptions.h"
 #include "lsst/geom/Box.h"
 #include "lsst/geom/Point.h"
@@ -149,6 +151,18 @@ public:
     std::vector<bool> contains(std::vector<lsst::geom::Point2I> const &points) const;
     //@}
 
+    /**
+     * Returns whether the polygon contains each (x, y) pair
+     *
+     * Points on the boundary are not contained, as for the single-point form.
+     * All points are tested against each edge in turn, which is much faster
+     * than testing them one at a time.
+     *
+     * @throws lsst::pex::exceptions::LengthError if `x` and `y` differ in length.
+     */
+    ndarray::Array<bool, 1, 1> contains(ndarray::Array<double const, 1> const &x,
+                                        ndarray::Array<double const, 1> const &y) const;
+
     /// Returns whether the polygon contains the x, y pair
     template <typename Xtype, typename Ytype>
     bool contains(Xtype x, Ytype y) const {
@@ -285,6 +299,8 @@ protected:
     void write(OutputArchiveHandle& handle) const override;
 
 private:
+    friend class PolygonUnion;
+
     //@{
     /// pImpl pattern to hide implementation
     struct Impl;
@@ -292,6 +308,64 @@ private:
     Polygon(std::shared_ptr<Impl> impl) : _impl(impl) {}
     //@}
 };
+
+/// An overlapping pair of polygons found by intersectPairs
+struct PolygonIntersection {
+    std::size_t first;   ///< Index of the first polygon of the pair
+    std::size_t second;  ///< Index of the second polygon of the pair; always greater than `first`
+    std::vector<std::shared_ptr<Polygon>> intersection;  ///< Intersection of the pair; never empty
+};
+
+/**
+ * Intersect every overlapping pair in a list of polygons
+ *
+ * Pairs whose bounding boxes are disjoint are pruned with an R-tree before
+ * any intersection is computed, and the surviving pairs are divided among
+ * threads.
+ *
+ * @param polygons  Polygons to intersect.
+ * @param numThreads  Number of threads to use; 0 means one per hardware thread.
+ * @returns the pairs with a non-empty intersection, ordered by `first` and then `second`.
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if any polygon is null or
+ *         `numThreads` is negative.
+ */
+std::vector<PolygonIntersection> intersectPairs(std::vector<std::shared_ptr<Polygon>> const& polygons,
+                                                int numThreads = 1);
+
+/**
+ * Accumulate the union of many polygons
+ *
+ * Polygons are merged in a balanced order, each partial union combining
+ * two of about the same size, which costs much less than adding every
+ * polygon to a single growing union.
+ */
+class PolygonUnion final {
+public:
+    PolygonUnion();
+    ~PolygonUnion() noexcept;
+
+    PolygonUnion(PolygonUnion const& other);
+    PolygonUnion(PolygonUnion&& other) noexcept;
+    PolygonUnion& operator=(PolygonUnion const& other);
+    PolygonUnion& operator=(PolygonUnion&& other) noexcept;
+
+    /// Add a polygon to the union
+    void add(Polygon const& polygon);
+
+    /// Return the number of polygons added so far
+    std::size_t getNumAdded() const noexcept;
+
+    /// Return the disjoint polygons that make up the union of all polygons added so far
+    std::vector<std::shared_ptr<Polygon>> getPolygons() const;
+
+    /// Return the area of the union of all polygons added so far
+    double calculateArea() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> _impl;
+};
 /// \cond DOXYGEN_IGNORE
 template bool Polygon::contains<double, double>(double, double) const;
 template bool Polygon::contains<float, float>(float, float) const;
@@ -30,6 +30,8 @@
  */
 
 #include "lsst/geom/AffineTransform.h"
+#include "lsst/geom/Box.h"
+#include "lsst/geom/Extent.h"
 #include "lsst/afw/geom/Transform.h"
 
 namespace lsst {
@@ -118,6 +120,52 @@ std::shared_ptr<TransformPoint2ToPoint2> makeRadialTransform(std::vector<double>
  */
 std::shared_ptr<TransformPoint2ToPoint2> makeIdentityTransform();
 
+/**
+ * A polynomial approximation to a Transform, with the errors it achieved.
+ *
+ * Errors are measured in the units of the input ("from") coordinates. For the forward direction the
+ * difference in output coordinates is mapped back through the inverse of the Jacobian of the original
+ * Transform at the center of the box, so that a forward error of 0.01 for a transform whose inputs are
+ * pixels means about a hundredth of a pixel.
+ */
+struct TransformApproximation {
+    /// The approximation, as an ordinary Transform that may be persisted and composed like any other.
+    std::shared_ptr<TransformPoint2ToPoint2> transform;
+    /// Order of the polynomials in both directions.
+    int order;
+    /// Largest error of `transform.applyForward` over the test points.
+    double maxForwardError;
+    /// Largest error of `transform.applyInverse` over the test points.
+    double maxInverseError;
+};
+
+/**
+ * Approximate a Transform over a box by polynomials, in both directions, to a given accuracy.
+ *
+ * Expensive compositions (e.g. through several camera coordinate systems with distortion) are much
+ * cheaper to evaluate as a single polynomial. The polynomials are fit on a grid of points covering
+ * `bbox` with increasing order until the errors at the centers of the grid cells, which are not used
+ * in the fit, are both within `maxError`. The inverse is fit to the forward transform of the grid,
+ * so `original` need not have an inverse.
+ *
+ * @param original the Transform to approximate
+ * @param bbox the region of input coordinates over which the approximation must be valid; it is only
+ *             an approximation outside this region
+ * @param maxError the largest acceptable error, in both directions; see TransformApproximation
+ * @param maxOrder the highest polynomial order to try
+ * @param gridShape the number of grid points in x and y used for fitting
+ * @returns the approximation of lowest order that meets `maxError`, or if none does, the most accurate
+ *          one found up to `maxOrder`; check the errors it reports.
+ *
+ * @throws pex::exceptions::InvalidParameterError Thrown if `bbox` is empty, `maxError` is not positive,
+ *         `maxOrder` is less than 1, `gridShape` is too small for `maxOrder`, or `original` is not finite
+ *         over `bbox`.
+ * @exceptsafe Provides basic exception safety.
+ */
+TransformApproximation approximateTransform(
+        TransformPoint2ToPoint2 const &original, lsst::geom::Box2D const &bbox, double maxError,
+        int maxOrder = 9, lsst::geom::Extent2I const &gridShape = lsst::geom::Extent2I(50, 50));
+
 }  // namespace geom
 }  // namespace afw
 }  // namespace lsst
@@ -29,12 +29,15 @@
 #include "lsst/geom.h"
 #include "lsst/afw/image/LsstImageTypes.h"
 #include "lsst/afw/image/ApCorrMap.h"
+#include "lsst/afw/image/CoaddInputsIndex.h"
 #include "lsst/afw/cameraGeom/Detector.h"
 #include "lsst/afw/image/Exposure.h"  // Exposure.h brings in almost everything
 #include "lsst/afw/image/ImageAlgorithm.h"
+#include "lsst/afw/image/ImageExpression.h"
 #include "lsst/afw/image/ImagePca.h"
 #include "lsst/afw/image/ImageUtils.h"
 #include "lsst/afw/image/ImageSlice.h"
+#include "lsst/afw/image/MaskSummary.h"
 #include "lsst/afw/fits.h" /* stuff here is forward-declared in headers in afw::image, but
                             * since we need it in SWIG (and that's the only place anyone
                             * should really be including image.h) we include it here.
@@ -26,7 +26,9 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
+#include "lsst/afw/table/Source.h"
 #include "lsst/afw/table/io/Persistable.h"
 #include "lsst/afw/typehandling/Storable.h"
 #include "lsst/afw/math/BoundedField.h"
@@ -77,6 +79,34 @@ public:
     /// Whether the map is persistable (true IFF all contained BoundedFields are persistable).
     bool isPersistable() const noexcept override;
 
+    /**
+     *  Apply aperture corrections to the fluxes of a catalog, in place.
+     *
+     *  For each name in `names`, the field named `<name>_instFlux` is evaluated at the centroid slot
+     *  of every record, and the record's `<name>_instFlux` and `<name>_instFluxErr` fields (the latter
+     *  if the schema has it) are multiplied by that correction.  The uncertainty of the correction is
+     *  ignored.  If the schema has them, the correction is also written to `<name>_apCorr`, the field
+     *  named `<name>_instFluxErr` evaluated at the centroid to `<name>_apCorrErr`, and
+     *  `<name>_flag_apCorr` is set on the records whose correction is not finite and positive; the
+     *  fluxes of those records are left unchanged.
+     *
+     *  The positions are read once, and each distinct field is evaluated once for all records with the
+     *  array form of BoundedField::evaluate; with several threads, different fields are evaluated
+     *  concurrently, so they must be safe to evaluate from several threads at once.
+     *
+     *  @param[in,out] catalog  Catalog to correct; its centroid slot must be defined.  Contiguous
+     *                          catalogs are read and written through column views.
+     *  @param[in] names        Prefixes of the flux fields to correct, e.g. "base_PsfFlux".
+     *  @param[in] numThreads   number of threads to use; 0 means one per hardware thread
+     *
+     *  @throws lsst::pex::exceptions::NotFoundError if the map has no correction for one of the
+     *      names, or the catalog has no `<name>_instFlux` field or centroid slot; the catalog is
+     *      not modified.
+     *  @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0.
+     */
+    void applyToCatalog(table::SourceCatalog& catalog, std::vector<std::string> const& names,
+                        int numThreads = 1) const;
+
     /// Scale all fields by a constant
     ApCorrMap& operator*=(double const scale);
     ApCorrMap& operator/=(double const scale) { return *this *= 1.0 / scale; }
@@ -0,0 +1,154 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_IMAGE_CoaddInputsIndex_h_INCLUDED
+#define LSST_AFW_IMAGE_CoaddInputsIndex_h_INCLUDED
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "lsst/geom/Box.h"
+#include "lsst/geom/Point.h"
+#include "lsst/afw/geom/SkyWcs.h"
+#include "lsst/afw/geom/polygon/Polygon.h"
+#include "lsst/afw/table/Exposure.h"
+#include "lsst/afw/table/io/Persistable.h"
+#include "lsst/afw/image/CoaddInputs.h"
+
+namespace lsst {
+namespace afw {
+namespace image {
+
+/**
+ *  A spatial index on the inputs of a coadd, in the coadd's pixel frame.
+ *
+ *  Finding the input CCDs that cover a point of a coadd with ExposureCatalogT::subsetContaining
+ *  maps the point through every CCD's WCS.  A CoaddInputsIndex instead maps each CCD's bounding box
+ *  (and, optionally, its valid polygon) into the coadd pixel frame once, as a polygon with several
+ *  points along each edge, and arranges the polygons' bounding boxes in a tree, so a query costs
+ *  about log(N) box tests and a point-in-polygon test for each of the few CCDs left.  Because the
+ *  projected edges are sampled, results may differ from subsetContaining within a small fraction of
+ *  a pixel of a CCD's boundary.
+ *
+ *  The index holds a shallow copy of the catalog, and does not see later changes to it or to its
+ *  records.  It can be persisted, with the catalog, so that it need not be rebuilt when a coadd is
+ *  read.
+ */
+class CoaddInputsIndex final : public table::io::PersistableFacade<CoaddInputsIndex>,
+                               public table::io::Persistable {
+public:
+    /**
+     *  Index the records of a catalog of coadd inputs.
+     *
+     *  Records whose regions cannot be mapped into the coadd frame (for instance, because they
+     *  lie where the coadd's WCS is not valid) cover no points of the index.
+     *
+     *  @param catalog              Catalog of input images, usually the `ccds` of a CoaddInputs.
+     *  @param coaddWcs             WCS of the coadd, whose pixel frame queries are made in.
+     *  @param includeValidPolygon  If true, limit each record to its valid polygon, if it has one.
+     *
+     *  @throws lsst::pex::exceptions::LogicError if any record does not have a Wcs.
+     */
+    CoaddInputsIndex(table::ExposureCatalog const &catalog, geom::SkyWcs const &coaddWcs,
+                     bool includeValidPolygon = false);
+
+    /// Index the `ccds` catalog of a CoaddInputs.
+    CoaddInputsIndex(CoaddInputs const &inputs, geom::SkyWcs const &coaddWcs,
+                     bool includeValidPolygon = false)
+            : CoaddInputsIndex(inputs.ccds, coaddWcs, includeValidPolygon) {}
+
+    CoaddInputsIndex(CoaddInputsIndex const &) = default;
+    CoaddInputsIndex(CoaddInputsIndex &&) = default;
+    CoaddInputsIndex &operator=(CoaddInputsIndex const &) = default;
+    CoaddInputsIndex &operator=(CoaddInputsIndex &&) = default;
+    ~CoaddInputsIndex() override = default;
+
+    /// Return the indexed catalog.
+    table::ExposureCatalog const &getCatalog() const noexcept { return _catalog; }
+
+    /// Return the number of indexed records.
+    std::size_t size() const noexcept { return _catalog.size(); }
+
+    /**
+     *  Return the region of a record in the coadd pixel frame, or an empty pointer if the record
+     *  covers no point.
+     *
+     *  @throws lsst::pex::exceptions::OutOfRangeError if `i >= size()`.
+     */
+    std::shared_ptr<geom::polygon::Polygon const> getPolygon(std::size_t i) const;
+
+    /// Return the positions in the catalog (in ascending order) of the records that cover a point.
+    std::vector<std::size_t> findContaining(lsst::geom::Point2D const &position) const;
+
+    /// Return findContaining(position) for each of several points.
+    std::vector<std::vector<std::size_t>> findContaining(
+            std::vector<lsst::geom::Point2D> const &positions) const;
+
+    /// Return a shallow subset of the catalog with only those records that cover a point.
+    table::ExposureCatalog subsetContaining(lsst::geom::Point2D const &position) const;
+
+    /// Return subsetContaining(position) for each of several points.
+    std::vector<table::ExposureCatalog> subsetContaining(
+            std::vector<lsst::geom::Point2D> const &positions) const;
+
+    /// Whether the index can be persisted (true IFF its catalog can be, up to the permissive
+    /// handling of unpersistable Psfs and Wcss used for CoaddInputs).
+    bool isPersistable() const noexcept override { return true; }
+
+protected:
+    std::string getPersistenceName() const override;
+    std::string getPythonModule() const override;
+    void write(OutputArchiveHandle &handle) const override;
+
+private:
+    friend class CoaddInputsIndexFactory;
+
+    // A node of the tree; leaves hold the records _order[begin:end], and other nodes two children.
+    struct Node {
+        lsst::geom::Box2D bbox;
+        std::size_t begin;
+        std::size_t end;
+        int left;
+        int right;
+    };
+
+    CoaddInputsIndex(table::ExposureCatalog const &catalog,
+                     std::vector<std::shared_ptr<geom::polygon::Polygon const>> polygons);
+
+    void _build();
+    int _build(std::size_t begin, std::size_t end);
+
+    table::ExposureCatalog _catalog;
+    std::vector<std::shared_ptr<geom::polygon::Polygon const>> _polygons;  // one per record, may be null
+    std::vector<lsst::geom::Box2D> _boxes;  // bounding boxes of the polygons
+    std::vector<std::size_t> _order;        // positions of records with polygons, grouped by leaf
+    std::vector<Node> _nodes;               // the root is the first, if there are any records
+};
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !LSST_AFW_IMAGE_CoaddInputsIndex_h_INCLUDED
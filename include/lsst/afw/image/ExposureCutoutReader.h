@@ -0,0 +1,151 @@
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_IMAGE_EXPOSURECUTOUTREADER_H
+#define LSST_AFW_IMAGE_EXPOSURECUTOUTREADER_H
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "lsst/geom/Box.h"
+#include "lsst/afw/image/ExposureFitsReader.h"
+
+namespace lsst {
+namespace afw {
+namespace image {
+
+/**
+ * A reader for many cutouts from many Exposure FITS files.
+ *
+ * Each batch of requests is grouped by file, so that every file is opened and its headers and archive
+ * are read at most once per batch, and the files are read concurrently.  The ExposureFitsReader for
+ * each file, and the ExposureInfo read from it, are kept in a cache of the most recently used files,
+ * so later batches that return to a file do not reread it either.
+ *
+ * The cutouts from one file share its (immutable) components, such as the Psf and Wcs, but each has
+ * its own ExposureInfo and metadata, as if it had been read on its own.
+ *
+ * An ExposureCutoutReader may not be used by more than one thread at a time.
+ */
+class ExposureCutoutReader final {
+public:
+    /**
+     * Construct a reader with an empty cache.
+     *
+     * @param  maxOpenFiles  The number of files to keep open between and within batches.
+     * @param  numThreads    The number of files to read at once; 0 means one per hardware thread.
+     *                       Files are read one at a time unless cfitsio is thread-safe.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if maxOpenFiles < 1 or numThreads < 0.
+     */
+    explicit ExposureCutoutReader(int maxOpenFiles = 16, int numThreads = 1);
+
+    ExposureCutoutReader(ExposureCutoutReader const &) = delete;
+    ExposureCutoutReader(ExposureCutoutReader &&) = delete;
+    ExposureCutoutReader &operator=(ExposureCutoutReader const &) = delete;
+    ExposureCutoutReader &operator=(ExposureCutoutReader &&) = delete;
+
+    ~ExposureCutoutReader() noexcept;
+
+    /**
+     * Read a batch of Exposure cutouts.
+     *
+     * @param  fileNames     The file to read each cutout from.
+     * @param  bboxes        The region of each cutout; an empty box reads the whole image.
+     * @param  origin        Coordinate system convention for the boxes.
+     * @param  conformMasks  If True, conform the global mask dict to match each file.
+     * @param  allowUnsafe   Permit reading into the requested pixel type even
+     *                       when on-disk values may overflow or truncate.
+     *
+     * @returns the cutouts, in the order requested.
+     *
+     * @throws lsst::pex::exceptions::LengthError if fileNames and bboxes have different sizes.
+     *
+     * If reading any cutout fails, the first exception is rethrown once the batch has stopped.
+     *
+     * In Python, this templated method is wrapped with an additional `dtype`
+     * argument to provide the type to read (for the image plane).  This
+     * defaults to the type of the on-disk image of the first file.
+     */
+    template <typename ImagePixelT, typename MaskPixelT = MaskPixel, typename VariancePixelT = VariancePixel>
+    std::vector<Exposure<ImagePixelT, MaskPixelT, VariancePixelT>> read(
+            std::vector<std::string> const &fileNames, std::vector<lsst::geom::Box2I> const &bboxes,
+            ImageOrigin origin = PARENT, bool conformMasks = false, bool allowUnsafe = false);
+
+    /**
+     * Read a batch of MaskedImage cutouts, without the Exposures' components.
+     *
+     * Parameters, exceptions and Python wrapping are as for read().
+     */
+    template <typename ImagePixelT, typename MaskPixelT = MaskPixel, typename VariancePixelT = VariancePixel>
+    std::vector<MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>> readMaskedImages(
+            std::vector<std::string> const &fileNames, std::vector<lsst::geom::Box2I> const &bboxes,
+            ImageOrigin origin = PARENT, bool conformMasks = false, bool allowUnsafe = false);
+
+    /**
+     * Return the reader for a file, opening it if it is not in the cache.
+     *
+     * The returned reader must not be used while a batch is being read.
+     */
+    std::shared_ptr<ExposureFitsReader> getReader(std::string const &fileName);
+
+    /// Return the number of files that are kept open.
+    int getMaxOpenFiles() const noexcept { return _maxOpenFiles; }
+
+    /// Return the number of files read at once, as passed to the constructor.
+    int getNumThreads() const noexcept { return _numThreads; }
+
+    /// Return the number of files in the cache.
+    std::size_t getNumOpenFiles() const;
+
+    /// Close all of the files in the cache.
+    void clear();
+
+private:
+    struct Entry;
+
+    // Return the cache entry for a file, opening it if necessary and making it the most recently used
+    std::shared_ptr<Entry> _acquire(std::string const &fileName);
+
+    // Call readOne(reader, info, i) for every request i, concurrently for distinct files; info is null
+    // unless needInfo is true
+    template <typename ReadOne>
+    void _forEachRequest(std::vector<std::string> const &fileNames,
+                         std::vector<lsst::geom::Box2I> const &bboxes, bool needInfo, ReadOne const &readOne);
+
+    using EntryList = std::list<std::shared_ptr<Entry>>;  // most recently used first
+
+    int const _maxOpenFiles;
+    int const _numThreads;
+    mutable std::mutex _mutex;
+    EntryList _entryList;
+    std::map<std::string, EntryList::iterator> _entryMap;
+};
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !LSST_AFW_IMAGE_EXPOSURECUTOUTREADER_H
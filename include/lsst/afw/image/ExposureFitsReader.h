@@ -57,6 +57,16 @@ public:
      */
     explicit ExposureFitsReader(fits::MemFileManager &manager);
 
+    /**
+     * Construct a FITS reader object.
+     *
+     * Reading a subimage of a tile-compressed file only reads the tiles
+     * that overlap it.
+     *
+     * @param  cache    Cache of byte ranges of a (typically remote) FITS file.
+     */
+    explicit ExposureFitsReader(std::shared_ptr<fits::ByteRangeCache> cache);
+
     /**
      * Construct a FITS reader object.
      *
@@ -109,6 +119,31 @@ public:
      */
     int readSerializationVersion();
 
+    /**
+     * Start reading the Exposure's archive of components in the background.
+     *
+     * The archive HDUs are read on another thread, with their own handle on
+     * the file, while the caller goes on to read pixels or metadata; the
+     * first component getter (readPsf, readWcs, readExposureInfo, ...) then
+     * waits only for that read to finish.  Components are still unpersisted
+     * on the calling thread.
+     *
+     * This does nothing if the file has no archive, is not a file on disk,
+     * cfitsio is not thread-safe, or afw calls on this thread are limited
+     * to one thread (see lsst/afw/math/ExecutionContext.h).  Errors from the background read are
+     * reported by the first getter that needs the archive.
+     */
+    void prefetch();
+
+    /**
+     * Block until a read started by prefetch() has finished.
+     *
+     * Getters wait as needed, so this is never required; it lets callers
+     * choose where to block (e.g. without holding a lock the background
+     * read might need).
+     */
+    void waitForPrefetch() const;
+
     /**
      * Read the flexible metadata associated with the Exposure.
      *
@@ -158,8 +193,19 @@ public:
     /// Read the Exposure's non-standard components
     std::map<std::string, std::shared_ptr<table::io::Persistable>> readExtraComponents();
 
-    /// Read the ExposureInfo containing all non-image components.
-    std::shared_ptr<ExposureInfo> readExposureInfo();
+    /**
+     * Read the ExposureInfo containing all non-image components.
+     *
+     * @param lazyComponents  If true, only read the metadata, visit info and
+     *                        exposure ID now, and read each other component
+     *                        when it is first requested from the ExposureInfo
+     *                        (see ExposureInfo::setLazyComponents), through a
+     *                        new handle on the file.  The file must then not
+     *                        be modified while the ExposureInfo is in use.
+     *                        Ignored (all components are read now) if the
+     *                        file is not on disk.
+     */
+    std::shared_ptr<ExposureInfo> readExposureInfo(bool lazyComponents = false);
 
     ///@{
     /**
@@ -273,6 +319,9 @@ public:
      *                       this file.
      * @param  allowUnsafe   Permit reading into the requested pixel type even
      *                       when on-disk values may overflow or truncate.
+     * @param  lazyComponents  If True, read the non-image components only
+     *                       when they are first requested; see
+     *                       readExposureInfo.
      *
      * In Python, this templated method is wrapped with an additional `dtype`
      * argument to provide the type to read (for the image plane).  This
@@ -281,7 +330,7 @@ public:
     template <typename ImagePixelT, typename MaskPixelT = MaskPixel, typename VariancePixelT = VariancePixel>
     Exposure<ImagePixelT, MaskPixelT, VariancePixelT> read(
             lsst::geom::Box2I const &bbox = lsst::geom::Box2I(), ImageOrigin origin = PARENT,
-            bool conformMasks = false, bool allowUnsafe = false);
+            bool conformMasks = false, bool allowUnsafe = false, bool lazyComponents = false);
 
     /**
      * Return the name of the file this reader targets.
@@ -291,9 +340,16 @@ public:
 private:
     class MetadataReader;
     class ArchiveReader;
+    class LazyComponentReader;
 
     void _ensureReaders();
 
+    // The ids of the components readExposureInfo puts in an ExposureInfo
+    std::vector<std::string> _getInfoComponentIds();
+
+    // Read a component for readExposureInfo, warning and returning null if it can't be unpersisted
+    std::shared_ptr<typehandling::Storable const> _readInfoComponent(std::string const &id);
+
     fits::Fits *_getFitsFile() { return _maskedImageReader._getFitsFile(); }
 
     MaskedImageFitsReader _maskedImageReader;
@@ -25,7 +25,11 @@
 #ifndef LSST_AFW_IMAGE_ExposureInfo_h_INCLUDED
 #define LSST_AFW_IMAGE_ExposureInfo_h_INCLUDED
 
+#include <map>
+#include <mutex>
 #include <optional>
+#include <string>
+#include <vector>
 
 #include "lsst/base.h"
 #include "lsst/daf/base.h"
@@ -84,6 +88,16 @@ class TransmissionCurve;
  *  and hence we don't need to ensure strict ownership.  The setter for Detector does *not*
  *  clone its input argument, because while it technically isn't, we can safely consider a
  *  Detector to be immutable once it's attached to an ExposureInfo.
+ *
+ *  Copying an ExposureInfo (including the copies made by Exposure's copy constructor, subset() and
+ *  getCutout()) takes constant time: the copy shares the metadata, VisitInfo and components with the
+ *  original, and shares the tables that map component names to components (and to unread lazy
+ *  components) until one of the two is modified.  Only these operations copy anything:
+ *   - the copy constructor with copyMetadata=true (used by deep Exposure copies) deep-copies the
+ *     metadata;
+ *   - the first setComponent, removeComponent, setLazyComponents or lazy component read on either
+ *     copy copies the table of component pointers, but never the components themselves;
+ *   - setWcs and setApCorrMap clone their arguments, as described above.
  */
 class ExposureInfo final {
 public:
@@ -285,7 +299,8 @@ public:
      */
     template <class T>
     bool hasComponent(typehandling::Key<std::string, T> const& key) const {
-        return _components->contains(key);
+        auto lock = _lockComponent(key.getId());
+        return _components.contains(key);
     }
 
     /**
@@ -299,8 +314,9 @@ public:
      */
     template <class T>
     std::shared_ptr<T> getComponent(typehandling::Key<std::string, std::shared_ptr<T>> const& key) const {
+        auto lock = _lockComponent(key.getId());
         try {
-            return _components->at(key);
+            return _components.at(key);
         } catch (pex::exceptions::OutOfRangeError const& e) {
             return nullptr;
         }
@@ -317,9 +333,55 @@ public:
      */
     template <class T>
     bool removeComponent(typehandling::Key<std::string, T> const& key) {
-        return _components->erase(key);
+        bool const wasLazy = _cancelLazyComponent(key.getId());
+        return _components.erase(key) || wasLazy;
     }
 
+    /**
+     * A source of components that an ExposureInfo reads only when they are first needed.
+     *
+     * @see ExposureInfo::setLazyComponents
+     */
+    class LazyComponentReader {
+    public:
+        LazyComponentReader() = default;
+        LazyComponentReader(LazyComponentReader const&) = delete;
+        LazyComponentReader(LazyComponentReader&&) = delete;
+        LazyComponentReader& operator=(LazyComponentReader const&) = delete;
+        LazyComponentReader& operator=(LazyComponentReader&&) = delete;
+        virtual ~LazyComponentReader() noexcept;
+
+        /**
+         * Read a component.
+         *
+         * @param id the id of the component's key
+         * @return the component, or a null pointer if there is none
+         *
+         * Calls are never concurrent, and each id is requested at most once unless a call throws.
+         */
+        virtual std::shared_ptr<typehandling::Storable const> readComponent(std::string const& id) = 0;
+    };
+
+    /**
+     * Read some components only when they are first needed.
+     *
+     * Each component whose key has one of the given ids is read from `reader` the first time it is
+     * requested by a getter or `hasComponent`, or when the ExposureInfo is written, and is then held as
+     * if it had been set.  Setting or removing such a component before then cancels its read.  Copies
+     * of this ExposureInfo share the reader, and each component is read only once for all of them.
+     *
+     * As for an ExposureInfo with no lazy components, const member functions may be called from
+     * several threads at once.
+     *
+     * @param reader source of the components
+     * @param ids ids of the keys of the components to read from `reader`; any components already
+     *            present with these ids are removed
+     */
+    void setLazyComponents(std::shared_ptr<LazyComponentReader> reader, std::vector<std::string> const& ids);
+
+    /// Return the ids of the lazy components that have not been read yet.
+    std::vector<std::string> getUnreadLazyComponents() const;
+
     /// Get the version of FITS serialization that this ExposureInfo understands.
     static int getFitsSerializationVersion();
 
@@ -444,15 +506,16 @@ private:
     template <class T>
     void _setComponent(typehandling::Key<std::string, std::shared_ptr<T>> const& key,
                        std::shared_ptr<T> const& object) {
-        if (_components->contains(key)) {
-            _components->erase(key);
-        } else if (_components->contains(key.getId())) {
+        _cancelLazyComponent(key.getId());
+        if (_components.contains(key)) {
+            _components.erase(key);
+        } else if (_components.contains(key.getId())) {
             std::stringstream buffer;
             buffer << "Map has a key that conflicts with " << key;
             throw LSST_EXCEPT(pex::exceptions::TypeError, buffer.str());
         }
         try {
-            bool success = _components->insert(key, object);
+            bool success = _components.insert(key, object);
             if (!success) {
                 throw LSST_EXCEPT(
                         pex::exceptions::RuntimeError,
@@ -464,12 +527,41 @@ private:
         }
     }
 
+    // A LazyComponentReader and the components it has read, shared by copies of an ExposureInfo
+    class LazySource;
+
+    // Read the lazy component with this id, if it is still unread, and return a lock on _components
+    // (empty if there are no lazy components)
+    std::unique_lock<std::mutex> _lockComponent(std::string const& id) const;
+
+    // Lock _components, reading all the unread lazy components
+    std::unique_lock<std::mutex> _lockAllComponents() const;
+
+    // Read the lazy component with this id, if it is still unread; _lazyMutex must be held
+    void _readLazyComponent(std::string const& id) const;
+
+    // Forget the lazy component with this id, returning whether it was unread
+    bool _cancelLazyComponent(std::string const& id);
+
     std::optional<table::RecordId> _exposureId;
     std::shared_ptr<daf::base::PropertySet> _metadata;
     std::shared_ptr<image::VisitInfo const> _visitInfo;
 
+    using LazyMap = std::map<std::string, std::shared_ptr<LazySource>>;
+
+    // Return _lazy for modification, first copying it if it is shared with another ExposureInfo
+    LazyMap& _mutableLazy() const;
+
     // Class invariant: all pointers in _components are not null
-    std::unique_ptr<detail::StorableMap> _components;
+    // Modified by const member functions only while _lazyMutex is held, like _lazy.
+    mutable detail::StorableMap _components;
+
+    // Unread lazy components, by id, and their sources; may be null if there are none, and is shared
+    // between copies until modified.  Only modified by const member functions while _lazyMutex is held,
+    // and only if _hasLazy is set; _hasLazy is only modified by non-const ones.
+    mutable std::shared_ptr<LazyMap> _lazy;
+    mutable std::mutex _lazyMutex;  // guards _components and _lazy if _hasLazy
+    bool _hasLazy = false;
 };
 }  // namespace image
 }  // namespace afw
@@ -0,0 +1,232 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Half-precision storage for floating-point images
+ */
+#ifndef LSST_AFW_IMAGE_FLOAT16IMAGE_H
+#define LSST_AFW_IMAGE_FLOAT16IMAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "lsst/geom/Box.h"
+#include "lsst/afw/fits.h"
+#include "lsst/afw/image/Image.h"
+#include "lsst/daf/base/PropertySet.h"
+
+namespace lsst {
+namespace afw {
+namespace image {
+
+/**
+ * Convert a float to the nearest IEEE 754 binary16 ("half") value, returned as its bit pattern.
+ *
+ * Ties are rounded to even, values beyond the half range become infinities and NaNs stay NaNs.
+ */
+inline std::uint16_t floatToFloat16(float value) noexcept {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    std::uint16_t const sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000u);
+    std::uint32_t const absBits = bits & 0x7fffffffu;
+    if (absBits > 0x7f800000u) {  // NaN: keep the top of the payload, and make it quiet
+        return sign | 0x7e00u | ((absBits >> 13) & 0x3ffu);
+    }
+    if (absBits >= 0x477ff000u) {  // rounds beyond 65504, the largest half
+        return sign | 0x7c00u;
+    }
+    if (absBits >= 0x38800000u) {  // normal half: rebias the exponent then round the mantissa
+        std::uint32_t const rebiased = absBits - 0x38000000u;
+        return sign | static_cast<std::uint16_t>((rebiased + 0x0fffu + ((rebiased >> 13) & 1u)) >> 13);
+    }
+    if (absBits <= 0x33000000u) {  // at most half the smallest subnormal half
+        return sign;
+    }
+    // subnormal half
+    std::uint32_t const mantissa = (absBits & 0x7fffffu) | 0x800000u;
+    std::uint32_t const shift = 126u - (absBits >> 23);
+    std::uint32_t const truncated = mantissa >> shift;
+    std::uint32_t const remainder = mantissa & ((1u << shift) - 1u);
+    std::uint32_t const halfway = 1u << (shift - 1u);
+    return sign | static_cast<std::uint16_t>(truncated + (remainder > halfway ||
+                                                         (remainder == halfway && (truncated & 1u))));
+}
+
+/// Convert the bit pattern of an IEEE 754 binary16 ("half") value to a float, which is exact.
+inline float float16ToFloat(std::uint16_t value) noexcept {
+    std::uint32_t const sign = static_cast<std::uint32_t>(value & 0x8000u) << 16;
+    std::uint32_t const exponent = (value >> 10) & 0x1fu;
+    std::uint32_t const mantissa = value & 0x3ffu;
+    std::uint32_t bits;
+    if (exponent == 0x1fu) {  // infinity or NaN
+        bits = sign | 0x7f800000u | (mantissa << 13);
+    } else if (exponent != 0) {  // normal
+        bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    } else {  // zero or subnormal: mantissa * 2^-24
+        float const magnitude = static_cast<float>(mantissa) * 5.9604644775390625e-08f;
+        std::memcpy(&bits, &magnitude, sizeof(bits));
+        bits |= sign;
+    }
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+/// Convert n floats to half-precision bit patterns.
+void floatToFloat16(float const *in, std::uint16_t *out, std::size_t n) noexcept;
+
+/// Convert n half-precision bit patterns to floats.
+void float16ToFloat(std::uint16_t const *in, float *out, std::size_t n) noexcept;
+
+/**
+ * An image stored in half precision, for products that do not need the precision (or range) of float.
+ *
+ * A Float16Image takes half the memory of an Image<float>, for example to hold warps, PSF-matched
+ * temporaries or variance planes while many of them are needed at once.  Pixels are stored as IEEE 754
+ * binary16 values, with 11 significant bits and a largest finite value of 65504, and computed as
+ * floats: arithmetic, statistics and everything else are done on the Image<float> returned by
+ * convertF (or by get, one pixel at a time), and results are stored back with assign.  Conversions
+ * round to nearest (even) and preserve infinities and NaNs.
+ *
+ * Like Image, copies and subimages share pixels.  FITS files are written from the float image, so
+ * they are ordinary BITPIX=-32 images (or, with fits::ImageWriteOptions, scaled integers or
+ * compressed); every half value is exactly representable as a float, so they read back unchanged.
+ */
+class Float16Image final {
+public:
+    /// Construct an image of zeros
+    explicit Float16Image(lsst::geom::Box2I const &bbox = lsst::geom::Box2I());
+
+    /// Construct from a float image, rounding each pixel to half precision
+    explicit Float16Image(Image<float> const &image);
+
+    /**
+     * Construct a subimage, sharing pixels with rhs.
+     *
+     * @throws lsst::pex::exceptions::LengthError if bbox does not lie within rhs.
+     */
+    Float16Image(Float16Image const &rhs, lsst::geom::Box2I const &bbox, ImageOrigin origin = PARENT);
+
+    Float16Image(Float16Image const &) = default;
+    Float16Image(Float16Image &&) = default;
+    Float16Image &operator=(Float16Image const &) = default;
+    Float16Image &operator=(Float16Image &&) = default;
+    ~Float16Image() = default;
+
+    /// Return the bounding box of the image
+    lsst::geom::Box2I getBBox(ImageOrigin origin = PARENT) const { return _bits.getBBox(origin); }
+    /// Return the number of columns in the image
+    int getWidth() const { return _bits.getWidth(); }
+    /// Return the number of rows in the image
+    int getHeight() const { return _bits.getHeight(); }
+    /// Return the image's column-origin
+    int getX0() const { return _bits.getX0(); }
+    /// Return the image's row-origin
+    int getY0() const { return _bits.getY0(); }
+    /// Return the image's origin
+    lsst::geom::Point2I getXY0() const { return _bits.getXY0(); }
+    /// Return the image's size
+    lsst::geom::Extent2I getDimensions() const { return _bits.getDimensions(); }
+
+    /**
+     * Return the bit patterns of the pixels, shared with the image.
+     *
+     * In Python, `getArray().view(numpy.float16)` gives the pixel values themselves.
+     */
+    ndarray::Array<std::uint16_t, 2, 1> getArray() { return _bits.getArray(); }
+    ndarray::Array<std::uint16_t const, 2, 1> getArray() const { return _bits.getArray(); }
+
+    /**
+     * Return the value of one pixel.
+     *
+     * @throws lsst::pex::exceptions::LengthError if the pixel is not within the image.
+     */
+    float get(lsst::geom::Point2I const &point, ImageOrigin origin = PARENT) const;
+
+    /**
+     * Set the value of one pixel, rounding it to half precision.
+     *
+     * @throws lsst::pex::exceptions::LengthError if the pixel is not within the image.
+     */
+    void set(lsst::geom::Point2I const &point, float value, ImageOrigin origin = PARENT);
+
+    /// Return a new float image with the values of the pixels.
+    Image<float> convertF() const;
+
+    /**
+     * Set the pixels from a float image of the same dimensions, rounding them to half precision.
+     *
+     * @throws lsst::pex::exceptions::LengthError if the dimensions differ.
+     */
+    void assign(Image<float> const &image);
+
+    /// Return a deep copy of the image.
+    Float16Image clone() const;
+
+    /**
+     *  Write the image, converted to float, to a regular FITS file.
+     *
+     *  @param[in] fileName      Name of the file to write.
+     *  @param[in] metadata      Additional values to write to the header (may be null).
+     *  @param[in] mode          "w"=Create a new file; "a"=Append a new HDU.
+     */
+    void writeFits(std::string const &fileName, daf::base::PropertySet const *metadata = nullptr,
+                   std::string const &mode = "w") const;
+
+    /**
+     *  Write the image, converted to float, to a regular FITS file.
+     *
+     *  @param[in] fileName      Name of the file to write.
+     *  @param[in] options       Options controlling writing of FITS image, e.g. to scale to BITPIX=16.
+     *  @param[in] mode          "w"=Create a new file; "a"=Append a new HDU.
+     *  @param[in] header        Additional values to write to the header (may be null).
+     */
+    void writeFits(std::string const &fileName, fits::ImageWriteOptions const &options,
+                   std::string const &mode = "w", daf::base::PropertySet const *header = nullptr) const;
+
+    /**
+     *  Read an image from a regular FITS file of any pixel type, rounding it to half precision.
+     *
+     *  @param[in] fileName    Name of the file to read.
+     *  @param[in] hdu         Number of the "header-data unit" to read (where 0 is the Primary HDU).
+     *                         The default value of afw::fits::DEFAULT_HDU is interpreted as
+     *                         "the first HDU with NAXIS != 0".
+     */
+    static Float16Image readFits(std::string const &fileName, int hdu = fits::DEFAULT_HDU);
+
+private:
+    explicit Float16Image(Image<std::uint16_t> bits) : _bits(std::move(bits)) {}
+
+    Image<std::uint16_t> _bits;  // binary16 bit patterns
+};
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_IMAGE_FLOAT16IMAGE_H
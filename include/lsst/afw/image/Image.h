@@ -92,6 +92,22 @@ public:
      * @param initialValue Initial value
      */
     explicit Image(lsst::geom::Box2I const& bbox, PixelT initialValue = 0);
+    /**
+     * Create an Image of the specified size without initializing its pixels
+     *
+     * @param dimensions Number of columns, rows
+     *
+     * @note Use only when every pixel will be set before it is read; see UninitializedTag.
+     */
+    Image(lsst::geom::Extent2I const& dimensions, UninitializedTag);
+    /**
+     * Create an Image of the specified size and origin without initializing its pixels
+     *
+     * @param bbox dimensions and origin of desired Image
+     *
+     * @note Use only when every pixel will be set before it is read; see UninitializedTag.
+     */
+    Image(lsst::geom::Box2I const& bbox, UninitializedTag);
 
     /**
      * Copy constructor to make a copy of part of an Image.
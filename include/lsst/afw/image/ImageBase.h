@@ -93,6 +93,17 @@ struct ConstReference {
 
 enum ImageOrigin { PARENT, LOCAL };
 
+/**
+ * Tag requesting that the pixels of a newly allocated image be left uninitialized.
+ *
+ * Pass UNINITIALIZED to the Image, Mask or MaskedImage constructors when every pixel will be written
+ * before it is read (e.g. the output of a convolution, or a pixel-by-pixel copy), to save the pass
+ * over memory that would otherwise fill it.  Reading a pixel before it has been set gives an
+ * unspecified value.
+ */
+struct UninitializedTag {};
+constexpr UninitializedTag UNINITIALIZED{};
+
 /// The base class for all %image classed (Image, Mask, MaskedImage, ...)
 //
 // You are not expected to use this class directly in your own code; use one of the
@@ -65,6 +65,15 @@ public:
      */
     explicit ImageBaseFitsReader(fits::MemFileManager& manager, int hdu=fits::DEFAULT_HDU);
 
+    /**
+     * Construct a FITS reader object.
+     *
+     * @param  cache    Cache of byte ranges of a (typically remote) FITS file.
+     * @param  hdu      HDU index, where 0 is the primary HDU and DEFAULT_HDU
+     *                  is the first non-empty HDU.
+     */
+    explicit ImageBaseFitsReader(std::shared_ptr<fits::ByteRangeCache> cache, int hdu=fits::DEFAULT_HDU);
+
     /**
      * Construct a FITS reader object.
      *
@@ -130,6 +139,24 @@ public:
         bool allowUnsafe=false
     );
 
+    /**
+     * Map the image's data array into memory instead of reading it.
+     *
+     * @param  bbox   A bounding box used to defined a subimage, or an empty
+     *                box (default) to map the whole image.
+     * @param  origin Coordinate system convention for the given box.
+     *
+     * The returned array views a private mapping of the file, so only the
+     * pages holding the requested rows are read, and modifying it does not
+     * change the file.  This requires an uncompressed, unscaled image whose
+     * pixel type is T, in a plain FITS file on disk; see fits::Fits::mapImage.
+     */
+    template <typename T>
+    ndarray::Array<T, 2, 1> mapArray(
+        lsst::geom::Box2I const & bbox,
+        ImageOrigin origin=PARENT
+    );
+
     /**
      * Return the HDU this reader targets.
      */
@@ -0,0 +1,417 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Lazy, fused pixel-wise arithmetic on Images and MaskedImages
+ */
+#ifndef LSST_AFW_IMAGE_IMAGEEXPRESSION_H
+#define LSST_AFW_IMAGE_IMAGEEXPRESSION_H
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "boost/format.hpp"
+
+#include "lsst/geom/Extent.h"
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/image/Image.h"
+#include "lsst/afw/image/LsstImageTypes.h"
+#include "lsst/afw/image/MaskedImage.h"
+#include "lsst/afw/math/detail/Parallel.h"
+
+namespace lsst {
+namespace afw {
+namespace image {
+/**
+ * Lazily-evaluated arithmetic on whole images.
+ *
+ * Combining operands made by lazy() with `+`, `-`, `*`, `/` (and scalars) builds an expression
+ * without touching any pixels; evaluate() then computes every plane of the result in a single pass,
+ * with no temporary images.  For example, the equivalent of
+ * @code
+ * a = b; a -= c; a *= s; a += d;
+ * @endcode
+ * for MaskedImages a, b, c, d is
+ * @code
+ * using namespace lsst::afw::image::expr;
+ * evaluate(a, (lazy(b) - lazy(c)) * s + lazy(d));
+ * @endcode
+ *
+ * Masks and variances propagate as for the in-place MaskedImage operators: masks are ORed, and
+ * variances are those of independent pixels, e.g. @f$b^2 V_a + a^2 V_b@f$ for @f$a b@f$.  An Image
+ * operand or a scalar has no mask bits and zero variance.  Values are computed in double precision
+ * and converted to the destination pixel types once, so results can differ from a chain of
+ * in-place operators on float images by rounding.
+ *
+ * Evaluation is pixel-wise, so the destination may also appear as an operand.
+ */
+namespace expr {
+
+/// Base class of all expressions; Derived is the concrete expression type.
+template <typename Derived>
+class Expression {
+public:
+    Derived const& derived() const noexcept { return static_cast<Derived const&>(*this); }
+};
+
+namespace detail {
+
+inline void checkOperandDimensions(lsst::geom::Extent2I const& operand,
+                                   lsst::geom::Extent2I const& dimensions) {
+    if (operand != dimensions) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("Images are of different size, %dx%d v %dx%d") % dimensions.getX() %
+                           dimensions.getY() % operand.getX() % operand.getY())
+                                  .str());
+    }
+}
+
+template <typename PixelT, typename ImageT>
+PixelT* getRow(ImageT const& image, int y) {
+    return reinterpret_cast<PixelT*>(image.row_begin(y));
+}
+
+}  // namespace detail
+
+/*
+ * Every expression type provides
+ *  - static constexpr bools hasMask and hasVariance, false if the mask (respectively variance) is
+ *    known to be zero at compile time, so that terms that would only add zero are never computed;
+ *  - checkDimensions(dimensions), which throws LengthError unless every image operand has the
+ *    given dimensions;
+ *  - setRow(y), which points the expression at row y; copies of an expression have independent rows;
+ *  - image(x), mask(x) and variance(x), which evaluate column x of the current row.
+ */
+
+/// An operand that is a scalar (no mask bits, zero variance).
+class ScalarTerm final : public Expression<ScalarTerm> {
+public:
+    static constexpr bool hasMask = false;
+    static constexpr bool hasVariance = false;
+
+    explicit ScalarTerm(double value) noexcept : _value(value) {}
+
+    void checkDimensions(lsst::geom::Extent2I const&) const noexcept {}
+    void setRow(int) noexcept {}
+    double image(int) const noexcept { return _value; }
+    MaskPixel mask(int) const noexcept { return 0; }
+    double variance(int) const noexcept { return 0.0; }
+
+private:
+    double _value;
+};
+
+/// An operand that is an Image (no mask bits, zero variance).
+template <typename PixelT>
+class ImageTerm final : public Expression<ImageTerm<PixelT>> {
+public:
+    static constexpr bool hasMask = false;
+    static constexpr bool hasVariance = false;
+
+    explicit ImageTerm(Image<PixelT> const& image) : _image(&image), _row(nullptr) {}
+
+    void checkDimensions(lsst::geom::Extent2I const& dimensions) const {
+        detail::checkOperandDimensions(_image->getDimensions(), dimensions);
+    }
+    void setRow(int y) { _row = detail::getRow<PixelT const>(*_image, y); }
+    double image(int x) const noexcept { return _row[x]; }
+    MaskPixel mask(int) const noexcept { return 0; }
+    double variance(int) const noexcept { return 0.0; }
+
+private:
+    Image<PixelT> const* _image;
+    PixelT const* _row;
+};
+
+/// An operand that is a MaskedImage.
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+class MaskedImageTerm final : public Expression<MaskedImageTerm<ImagePixelT, MaskPixelT, VariancePixelT>> {
+public:
+    static constexpr bool hasMask = true;
+    static constexpr bool hasVariance = true;
+
+    explicit MaskedImageTerm(MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT> const& maskedImage)
+            : _image(maskedImage.getImage()),
+              _mask(maskedImage.getMask()),
+              _variance(maskedImage.getVariance()),
+              _imageRow(nullptr),
+              _maskRow(nullptr),
+              _varianceRow(nullptr) {}
+
+    void checkDimensions(lsst::geom::Extent2I const& dimensions) const {
+        detail::checkOperandDimensions(_image->getDimensions(), dimensions);
+    }
+    void setRow(int y) {
+        _imageRow = detail::getRow<ImagePixelT const>(*_image, y);
+        _maskRow = detail::getRow<MaskPixelT const>(*_mask, y);
+        _varianceRow = detail::getRow<VariancePixelT const>(*_variance, y);
+    }
+    double image(int x) const noexcept { return _imageRow[x]; }
+    MaskPixel mask(int x) const noexcept { return _maskRow[x]; }
+    double variance(int x) const noexcept { return _varianceRow[x]; }
+
+private:
+    std::shared_ptr<Image<ImagePixelT> const> _image;
+    std::shared_ptr<Mask<MaskPixelT> const> _mask;
+    std::shared_ptr<Image<VariancePixelT> const> _variance;
+    ImagePixelT const* _imageRow;
+    MaskPixelT const* _maskRow;
+    VariancePixelT const* _varianceRow;
+};
+
+/// Operations of binary expressions: the image value and the variance of independent operands.
+struct Plus {
+    static double image(double a, double b) noexcept { return a + b; }
+    template <bool lhsVariance, bool rhsVariance>
+    static double variance(double, double, double va, double vb) noexcept {
+        double result = 0.0;
+        if constexpr (lhsVariance) result += va;
+        if constexpr (rhsVariance) result += vb;
+        return result;
+    }
+};
+
+struct Minus {
+    static double image(double a, double b) noexcept { return a - b; }
+    template <bool lhsVariance, bool rhsVariance>
+    static double variance(double a, double b, double va, double vb) noexcept {
+        return Plus::variance<lhsVariance, rhsVariance>(a, b, va, vb);
+    }
+};
+
+struct Multiplies {
+    static double image(double a, double b) noexcept { return a * b; }
+    template <bool lhsVariance, bool rhsVariance>
+    static double variance(double a, double b, double va, double vb) noexcept {
+        double result = 0.0;
+        if constexpr (lhsVariance) result += b * b * va;
+        if constexpr (rhsVariance) result += a * a * vb;
+        return result;
+    }
+};
+
+struct Divides {
+    static double image(double a, double b) noexcept { return a / b; }
+    template <bool lhsVariance, bool rhsVariance>
+    static double variance(double a, double b, double va, double vb) noexcept {
+        double const b2 = b * b;
+        if constexpr (lhsVariance && rhsVariance) {
+            return (a * a * vb + b2 * va) / (b2 * b2);
+        } else if constexpr (lhsVariance) {
+            return va / b2;
+        } else if constexpr (rhsVariance) {
+            return a * a * vb / (b2 * b2);
+        } else {
+            return 0.0;
+        }
+    }
+};
+
+/// The negation of an expression.
+template <typename E>
+class NegatedExpression final : public Expression<NegatedExpression<E>> {
+public:
+    static constexpr bool hasMask = E::hasMask;
+    static constexpr bool hasVariance = E::hasVariance;
+
+    explicit NegatedExpression(E const& operand) : _operand(operand) {}
+
+    void checkDimensions(lsst::geom::Extent2I const& dimensions) const {
+        _operand.checkDimensions(dimensions);
+    }
+    void setRow(int y) { _operand.setRow(y); }
+    double image(int x) const noexcept { return -_operand.image(x); }
+    MaskPixel mask(int x) const noexcept { return _operand.mask(x); }
+    double variance(int x) const noexcept { return _operand.variance(x); }
+
+private:
+    E _operand;
+};
+
+/// A binary operation on two expressions.
+template <typename L, typename R, typename Op>
+class BinaryExpression final : public Expression<BinaryExpression<L, R, Op>> {
+public:
+    static constexpr bool hasMask = L::hasMask || R::hasMask;
+    static constexpr bool hasVariance = L::hasVariance || R::hasVariance;
+
+    BinaryExpression(L const& lhs, R const& rhs) : _lhs(lhs), _rhs(rhs) {}
+
+    void checkDimensions(lsst::geom::Extent2I const& dimensions) const {
+        _lhs.checkDimensions(dimensions);
+        _rhs.checkDimensions(dimensions);
+    }
+    void setRow(int y) {
+        _lhs.setRow(y);
+        _rhs.setRow(y);
+    }
+    double image(int x) const noexcept { return Op::image(_lhs.image(x), _rhs.image(x)); }
+    MaskPixel mask(int x) const noexcept {
+        if constexpr (L::hasMask && R::hasMask) {
+            return _lhs.mask(x) | _rhs.mask(x);
+        } else if constexpr (L::hasMask) {
+            return _lhs.mask(x);
+        } else {
+            return _rhs.mask(x);
+        }
+    }
+    double variance(int x) const noexcept {
+        return Op::template variance<L::hasVariance, R::hasVariance>(_lhs.image(x), _rhs.image(x),
+                                                                     _lhs.variance(x), _rhs.variance(x));
+    }
+
+private:
+    L _lhs;
+    R _rhs;
+};
+
+/// Make an expression operand from a MaskedImage, which must outlive the expression.
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+MaskedImageTerm<ImagePixelT, MaskPixelT, VariancePixelT> lazy(
+        MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT> const& maskedImage) {
+    return MaskedImageTerm<ImagePixelT, MaskPixelT, VariancePixelT>(maskedImage);
+}
+
+/// Make an expression operand from an Image, which must outlive the expression.
+template <typename PixelT>
+ImageTerm<PixelT> lazy(Image<PixelT> const& image) {
+    return ImageTerm<PixelT>(image);
+}
+
+template <typename E>
+NegatedExpression<E> operator-(Expression<E> const& operand) {
+    return NegatedExpression<E>(operand.derived());
+}
+
+#define LSST_AFW_IMAGE_EXPR_BINARY_OPERATOR(OPERATOR, OP)                                           \
+    template <typename L, typename R>                                                               \
+    BinaryExpression<L, R, OP> operator OPERATOR(Expression<L> const& lhs, Expression<R> const& rhs) { \
+        return BinaryExpression<L, R, OP>(lhs.derived(), rhs.derived());                            \
+    }                                                                                               \
+    template <typename L>                                                                           \
+    BinaryExpression<L, ScalarTerm, OP> operator OPERATOR(Expression<L> const& lhs, double rhs) {   \
+        return BinaryExpression<L, ScalarTerm, OP>(lhs.derived(), ScalarTerm(rhs));                 \
+    }                                                                                               \
+    template <typename R>                                                                           \
+    BinaryExpression<ScalarTerm, R, OP> operator OPERATOR(double lhs, Expression<R> const& rhs) {   \
+        return BinaryExpression<ScalarTerm, R, OP>(ScalarTerm(lhs), rhs.derived());                 \
+    }
+
+LSST_AFW_IMAGE_EXPR_BINARY_OPERATOR(+, Plus)
+LSST_AFW_IMAGE_EXPR_BINARY_OPERATOR(-, Minus)
+LSST_AFW_IMAGE_EXPR_BINARY_OPERATOR(*, Multiplies)
+LSST_AFW_IMAGE_EXPR_BINARY_OPERATOR(/, Divides)
+
+#undef LSST_AFW_IMAGE_EXPR_BINARY_OPERATOR
+
+namespace detail {
+
+// Call func(y, expression) for every row y of an image of the given height, with each thread
+// working on its own copy of the expression and a contiguous block of rows.
+template <typename E, typename F>
+void forEachRow(E const& expression, int height, int numThreads, F func) {
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    std::vector<std::pair<int, int>> const blocks = math::detail::splitRange(0, height, nThreads);
+    math::detail::parallelFor(static_cast<int>(blocks.size()), nThreads, [&](int i) {
+        E local(expression);
+        for (int y = blocks[i].first; y < blocks[i].second; ++y) {
+            local.setRow(y);
+            func(y, local);
+        }
+    });
+}
+
+}  // namespace detail
+
+/**
+ * Evaluate an expression into every plane of a MaskedImage, in one pass over the pixels.
+ *
+ * The destination's mask is set to the OR of the operands' masks (zero if there are none), and its
+ * variance to the propagated variance (zero if no operand has one).
+ *
+ * @param[out] dest  image to set; it may also be an operand of the expression
+ * @param[in] expression  expression to evaluate
+ * @param[in] numThreads  maximum number of threads to use; 0 means one per hardware thread
+ *
+ * @throws lsst::pex::exceptions::LengthError if any operand's dimensions differ from dest's
+ * @throws lsst::pex::exceptions::InvalidParameterError if numThreads is negative
+ */
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT, typename E>
+void evaluate(MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>& dest, Expression<E> const& expression,
+              int numThreads = 1) {
+    E const& e = expression.derived();
+    e.checkDimensions(dest.getDimensions());
+    int const width = dest.getWidth();
+    auto const& image = *dest.getImage();
+    auto const& mask = *dest.getMask();
+    auto const& variance = *dest.getVariance();
+    detail::forEachRow(e, dest.getHeight(), numThreads, [width, &image, &mask, &variance](int y, E row) {
+        ImagePixelT* imageRow = detail::getRow<ImagePixelT>(image, y);
+        MaskPixelT* maskRow = detail::getRow<MaskPixelT>(mask, y);
+        VariancePixelT* varianceRow = detail::getRow<VariancePixelT>(variance, y);
+        int const n = width;  // a local bound lets the compiler vectorize despite the stores below
+        for (int x = 0; x < n; ++x) {
+            // Read everything before writing, so that dest may be an operand
+            double const value = row.image(x);
+            MaskPixel const bits = row.mask(x);
+            double const var = row.variance(x);
+            imageRow[x] = static_cast<ImagePixelT>(value);
+            maskRow[x] = static_cast<MaskPixelT>(bits);
+            varianceRow[x] = static_cast<VariancePixelT>(var);
+        }
+    });
+}
+
+/**
+ * Evaluate the image part of an expression into an Image, in one pass over the pixels.
+ *
+ * Masks and variances of the operands are not computed.
+ *
+ * @param[out] dest  image to set; it may also be an operand of the expression
+ * @param[in] expression  expression to evaluate
+ * @param[in] numThreads  maximum number of threads to use; 0 means one per hardware thread
+ *
+ * @throws lsst::pex::exceptions::LengthError if any operand's dimensions differ from dest's
+ * @throws lsst::pex::exceptions::InvalidParameterError if numThreads is negative
+ */
+template <typename PixelT, typename E>
+void evaluate(Image<PixelT>& dest, Expression<E> const& expression, int numThreads = 1) {
+    E const& e = expression.derived();
+    e.checkDimensions(dest.getDimensions());
+    int const width = dest.getWidth();
+    detail::forEachRow(e, dest.getHeight(), numThreads, [width, &dest](int y, E row) {
+        PixelT* destRow = detail::getRow<PixelT>(dest, y);
+        for (int x = 0; x < width; ++x) {
+            destRow[x] = static_cast<PixelT>(row.image(x));
+        }
+    });
+}
+
+}  // namespace expr
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !LSST_AFW_IMAGE_IMAGEEXPRESSION_H
@@ -58,6 +58,24 @@ public:
     Image<PixelT> read(lsst::geom::Box2I const & bbox=lsst::geom::Box2I(), ImageOrigin origin=PARENT,
                        bool allowUnsafe=false);
 
+    /**
+     * Map the Image into memory instead of reading it.
+     *
+     * @param  bbox   A bounding box used to defined a subimage, or an empty
+     *                box (default) to map the whole image.
+     * @param  origin Coordinate system convention for the given box.
+     *
+     * The image's pixels view a private mapping of the file, which lasts as
+     * long as they do; see ImageBaseFitsReader::mapArray for the
+     * requirements on the file.
+     *
+     * In Python, this templated method is wrapped with an additional `dtype`
+     * argument to provide the type to map.  This defaults to the type of the
+     * on-disk image.
+     */
+    template <typename PixelT>
+    Image<PixelT> map(lsst::geom::Box2I const & bbox=lsst::geom::Box2I(), ImageOrigin origin=PARENT);
+
 };
 
 }}} // namespace lsst::afw::image
@@ -78,6 +78,31 @@ public:
      * Return the mean of the images in ImagePca's list
      */
     std::shared_ptr<ImageT> getMean() const;
+
+    /**
+     * Set the number of threads used by analyze to compute the inner products of the images
+     *
+     * @param numThreads number of threads to use; 0 means one per hardware thread
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
+     */
+    void setNumThreads(int numThreads);
+    /// Return the number of threads used by analyze; 0 means one per hardware thread
+    int getNumThreads() const { return _numThreads; }
+
+    /**
+     * Set whether analyze reuses the inner products computed by its previous call
+     *
+     * If true, a call to analyze after more images have been added only computes the inner products
+     * involving the new images.  The caller is then responsible for not modifying the images already
+     * analyzed, except through updateBadPixels (which discards the saved inner products).
+     *
+     * @param incremental Should analyze reuse earlier inner products?
+     */
+    void setIncremental(bool incremental) { _incremental = incremental; }
+    /// Return whether analyze reuses the inner products computed by its previous call
+    bool isIncremental() const { return _incremental; }
+
     virtual void analyze();
     /**
      * Update the bad pixels (i.e. those for which (value & mask) != 0) based on the current PCA
@@ -110,6 +135,11 @@ private:
 
     std::vector<double> _eigenValues;  // Eigen values
     ImageList _eigenImages;            // Eigen images
+
+    int _numThreads;    // number of threads used by analyze
+    bool _incremental;  // should analyze reuse _innerProducts?
+    // Unweighted inner products of images i and j <= i, for the images seen by the last analyze
+    std::vector<std::vector<double>> _innerProducts;
 };
 
 /**
@@ -144,6 +144,25 @@ public:
      */
     explicit Mask(lsst::geom::Box2I const& bbox, MaskPixelT initialValue,
                   MaskPlaneDict const& planeDefs = MaskPlaneDict());
+    /**
+     * Construct a Mask without initializing its pixels
+     *
+     * @param dimensions Number of columns, rows
+     * @param planeDefs desired mask planes
+     *
+     * @note Use only when every pixel will be set before it is read; see UninitializedTag.
+     */
+    Mask(lsst::geom::Extent2I const& dimensions, UninitializedTag,
+         MaskPlaneDict const& planeDefs = MaskPlaneDict());
+    /**
+     * Construct a Mask without initializing its pixels
+     *
+     * @param bbox Desired number of columns/rows and origin
+     * @param planeDefs desired mask planes
+     *
+     * @note Use only when every pixel will be set before it is read; see UninitializedTag.
+     */
+    Mask(lsst::geom::Box2I const& bbox, UninitializedTag, MaskPlaneDict const& planeDefs = MaskPlaneDict());
 
     /**
      *  Construct a Mask by reading a regular FITS file.
@@ -523,9 +542,15 @@ public:
      * Any new mask planes found in this mask are added to unused slots in the Mask class's mask plane
      * dictionary.
      *
+     * The bits are permuted in a single pass, looking up each byte of a pixel in a table built from the
+     * two dictionaries.
+     *
      * @param masterPlaneDict mask plane dictionary currently in use for this mask
+     * @param numThreads number of threads to use; 0 means one per hardware thread
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
      */
-    void conformMaskPlanes(const MaskPlaneDict& masterPlaneDict);
+    void conformMaskPlanes(const MaskPlaneDict& masterPlaneDict, int numThreads = 1);
 
 private:
     friend class MaskFitsReader;
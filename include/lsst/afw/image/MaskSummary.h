@@ -0,0 +1,174 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Per-plane summaries of a Mask, computed in one pass over its pixels
+ */
+#ifndef LSST_AFW_IMAGE_MASKSUMMARY_H
+#define LSST_AFW_IMAGE_MASKSUMMARY_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "lsst/geom.h"
+#include "lsst/afw/image/LsstImageTypes.h"
+#include "lsst/afw/image/Mask.h"
+
+namespace lsst {
+namespace afw {
+namespace image {
+
+/**
+ * Which mask planes are set where in a Mask.
+ *
+ * A MaskSummary records, for each mask plane, the number of pixels with that plane's bit set and the
+ * bounding box of those pixels, and optionally the OR of the pixel values in each tile of a regular grid.
+ * All of these are computed in a single pass over the pixels, after which questions such as "does this
+ * region have any BAD or SAT pixels?" can be answered without reading the mask again, and loops over
+ * pixels can skip the tiles that have none of the bits they care about.
+ *
+ * A MaskSummary is a snapshot: it does not change if the Mask is modified later.
+ */
+class MaskSummary final {
+public:
+    /**
+     * Summarize a Mask.
+     *
+     * @param[in] mask  the mask to summarize
+     * @param[in] tileSize  side of the square tiles in which to record the OR of the pixel values, or 0
+     *                      to record no tiles.  Tiles in the last row and column may be smaller.
+     * @param[in] numThreads  number of threads to use; 0 means one per hardware thread
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if tileSize < 0 or numThreads < 0
+     */
+    template <typename MaskPixelT>
+    explicit MaskSummary(Mask<MaskPixelT> const& mask, int tileSize = 0, int numThreads = 1);
+
+    MaskSummary(MaskSummary const&) = default;
+    MaskSummary(MaskSummary&&) = default;
+    MaskSummary& operator=(MaskSummary const&) = default;
+    MaskSummary& operator=(MaskSummary&&) = default;
+    ~MaskSummary() = default;
+
+    /// The bounding box (in PARENT coordinates) of the summarized mask
+    lsst::geom::Box2I getBBox() const { return _bbox; }
+
+    /// The mask planes of the summarized mask
+    MaskPlaneDict const& getMaskPlaneDict() const { return _planes; }
+
+    /// The OR of all pixel values: the bits set anywhere in the mask
+    MaskPixel getUnion() const { return _union; }
+
+    //@{
+    /**
+     * Return the number of pixels with a mask plane set.
+     *
+     * @param[in] bit  index of the plane's bit
+     * @param[in] name  name of the plane
+     *
+     * @throws lsst::pex::exceptions::OutOfRangeError if bit is not a valid bit index
+     * @throws lsst::pex::exceptions::NotFoundError if the mask has no plane called name
+     */
+    std::size_t getPlaneCount(int bit) const;
+    std::size_t getPlaneCount(std::string const& name) const;
+    //@}
+
+    //@{
+    /**
+     * Return the bounding box (in PARENT coordinates) of the pixels with a mask plane set.
+     *
+     * The box is empty if no pixel has the plane set.
+     *
+     * @param[in] bit  index of the plane's bit
+     * @param[in] name  name of the plane
+     *
+     * @throws lsst::pex::exceptions::OutOfRangeError if bit is not a valid bit index
+     * @throws lsst::pex::exceptions::NotFoundError if the mask has no plane called name
+     */
+    lsst::geom::Box2I getPlaneBBox(int bit) const;
+    lsst::geom::Box2I getPlaneBBox(std::string const& name) const;
+    //@}
+
+    /// Return the bounding box (in PARENT coordinates) of the pixels with any of a set of bits set
+    lsst::geom::Box2I getBBox(MaskPixel bitmask) const;
+
+    /**
+     * Return whether any pixel in a region may have any of a set of bits set.
+     *
+     * The answer is exact when it is false; true means that the region overlaps a plane's bounding box
+     * and, if tiles were recorded, a tile, with one of the bits set.
+     *
+     * @param[in] bbox  region to test, in PARENT coordinates
+     * @param[in] bitmask  bits to test for
+     */
+    bool mayIntersect(lsst::geom::Box2I const& bbox, MaskPixel bitmask) const;
+
+    /// The side of the tiles, or 0 if none were recorded
+    int getTileSize() const { return _tileSize; }
+
+    /// The number of tiles in each direction; zero if none were recorded
+    lsst::geom::Extent2I getTileDimensions() const { return lsst::geom::Extent2I(_nTilesX, _nTilesY); }
+
+    /**
+     * Return the OR of the pixel values in a tile.
+     *
+     * @param[in] ix, iy  index of the tile, counting from the tile with the mask's origin
+     *
+     * @throws lsst::pex::exceptions::OutOfRangeError if there is no such tile
+     */
+    MaskPixel getTileUnion(int ix, int iy) const;
+
+    /// Return the bounding box (in PARENT coordinates) of a tile
+    lsst::geom::Box2I getTileBBox(int ix, int iy) const;
+
+    /**
+     * Return the bounding boxes (in PARENT coordinates) of the tiles that have any of a set of bits set.
+     *
+     * @throws lsst::pex::exceptions::LogicError if no tiles were recorded
+     */
+    std::vector<lsst::geom::Box2I> getTileBBoxes(MaskPixel bitmask) const;
+
+private:
+    // The bit index of a named plane
+    int _getBit(std::string const& name) const;
+    void _checkBit(int bit) const;
+    void _checkTile(int ix, int iy) const;
+
+    lsst::geom::Box2I _bbox;
+    MaskPlaneDict _planes;
+    MaskPixel _union;
+    std::vector<std::size_t> _counts;          // indexed by bit
+    std::vector<lsst::geom::Box2I> _planeBBoxes;  // indexed by bit
+    int _tileSize;
+    int _nTilesX;
+    int _nTilesY;
+    std::vector<MaskPixel> _tiles;  // row-major
+};
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !LSST_AFW_IMAGE_MASKSUMMARY_H
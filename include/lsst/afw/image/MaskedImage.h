@@ -29,6 +29,7 @@
 #ifndef LSST_IMAGE_MASKEDIMAGE_H
 #define LSST_IMAGE_MASKEDIMAGE_H
 
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
@@ -599,6 +600,26 @@ public:
      * which may be conveniently used to make objects of an appropriate size
      */
     explicit MaskedImage(lsst::geom::Box2I const& bbox, MaskPlaneDict const& planeDict = MaskPlaneDict());
+    /**
+     * Construct from supplied dimensions without initializing the Image, Mask, or Variance pixels
+     *
+     * @param dimensions Number of columns, rows in image
+     * @param planeDict Make Mask conform to this mask layout (ignore if empty)
+     *
+     * @note Use only when every pixel will be set before it is read; see UninitializedTag.
+     */
+    MaskedImage(lsst::geom::Extent2I const& dimensions, UninitializedTag,
+                MaskPlaneDict const& planeDict = MaskPlaneDict());
+    /**
+     * Create a MaskedImage of the specified size and origin without initializing its pixels
+     *
+     * @param bbox dimensions and origin of image
+     * @param planeDict Make Mask conform to this mask layout (ignore if empty)
+     *
+     * @note Use only when every pixel will be set before it is read; see UninitializedTag.
+     */
+    MaskedImage(lsst::geom::Box2I const& bbox, UninitializedTag,
+                MaskPlaneDict const& planeDict = MaskPlaneDict());
 
     /**
      *  Construct a MaskedImage by reading a regular FITS file.
@@ -995,6 +1016,31 @@ public:
                    std::shared_ptr<daf::base::PropertySet const> maskMetadata = nullptr,
                    std::shared_ptr<daf::base::PropertySet const> varianceMetadata = nullptr) const;
 
+    /**
+     *  Write a MaskedImage to a FITS file, followed by additional HDUs.
+     *
+     *  @param[in] fitsfile           An empty FITS file object.
+     *  @param[in] imageOptions       Options controlling writing of image as FITS.
+     *  @param[in] maskOptions        Options controlling writing of mask as FITS.
+     *  @param[in] varianceOptions    Options controlling writing of variance as FITS.
+     *  @param[in] metadata           Additional values to write to the primary HDU header (may be null).
+     *  @param[in] imageMetadata      Metadata to be written to the image header.
+     *  @param[in] maskMetadata       Metadata to be written to the mask header.
+     *  @param[in] varianceMetadata   Metadata to be written to the variance header.
+     *  @param[in] writeExtraHdus     Function that appends HDUs (e.g. an archive of ancillary objects)
+     *                                after the variance HDU, to the file it is given.
+     *
+     *  As with the other overloads, the planes and the extra HDUs are prepared concurrently if
+     *  fits::setImageCompressionThreads allows it; see fits::writeHdusConcurrently.
+     */
+    void writeFits(fits::Fits& fitsfile, fits::ImageWriteOptions const& imageOptions,
+                   fits::ImageWriteOptions const& maskOptions, fits::ImageWriteOptions const& varianceOptions,
+                   std::shared_ptr<daf::base::PropertySet const> metadata,
+                   std::shared_ptr<daf::base::PropertySet const> imageMetadata,
+                   std::shared_ptr<daf::base::PropertySet const> maskMetadata,
+                   std::shared_ptr<daf::base::PropertySet const> varianceMetadata,
+                   std::function<void(fits::Fits&)> const& writeExtraHdus) const;
+
     /**
      *  Read a MaskedImage from a regular FITS file.
      *
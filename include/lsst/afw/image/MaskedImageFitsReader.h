@@ -59,6 +59,16 @@ public:
      */
     explicit MaskedImageFitsReader(fits::MemFileManager& manager, int hdu=fits::DEFAULT_HDU);
 
+    /**
+     * Construct a FITS reader object.
+     *
+     * @param  cache    Cache of byte ranges of a (typically remote) FITS file.
+     * @param  hdu      HDU index for the image plane, where 0 is the primary
+     *                  HDU and DEFAULT_HDU is the first non-empty HDU.
+     */
+    explicit MaskedImageFitsReader(std::shared_ptr<fits::ByteRangeCache> cache,
+                                   int hdu=fits::DEFAULT_HDU);
+
     /**
      * Construct a FITS reader object.
      *
@@ -366,6 +366,43 @@ public:
     MaskedImage<float> uncalibrateImage(MaskedImage<float> const &maskedImage,
                                         bool includeScaleUncertainty = true) const;
 
+    /**
+     * Flux calibrate an image in place, so that its pixel values are in nJy.
+     *
+     * This gives the same result as calibrateImage, without copying the image or evaluating the
+     * calibration into a full-size temporary: the calibration is evaluated one band of rows at a time and
+     * applied to the image and variance planes together.  Mask pixels are not modified.
+     *
+     * @param maskedImage The masked image to calibrate.
+     * @param includeScaleUncertainty Include the uncertainty on the calibration in the resulting variance?
+     * @param tolerance If positive, interpolate the calibration from a grid to within this relative
+     *     tolerance (see math::BoundedField::fillImageInterpolated) instead of evaluating it at every pixel.
+     * @param numThreads The number of threads to use; 0 means one per hardware thread.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if tolerance or numThreads is negative.
+     */
+    void calibrateImageInPlace(MaskedImage<float> &maskedImage, bool includeScaleUncertainty = true,
+                               double tolerance = 0.0, int numThreads = 1) const;
+
+    /**
+     * Un-calibrate an image in place, so that its pixel values are in ADU (or whatever the original
+     * input to this photoCalib was).
+     *
+     * This is the inverse of calibrateImageInPlace, and gives the same result as uncalibrateImage.
+     *
+     * @param maskedImage The masked image with pixel units of nJy to uncalibrate.
+     * @param includeScaleUncertainty Remove uncertainty from this calibration that was previously propagated
+     * into the variance plane. Must have the same value as the parameter of the same name when
+     * the image was calibrated.
+     * @param tolerance If positive, interpolate the calibration from a grid to within this relative
+     *     tolerance (see math::BoundedField::fillImageInterpolated) instead of evaluating it at every pixel.
+     * @param numThreads The number of threads to use; 0 means one per hardware thread.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if tolerance or numThreads is negative.
+     */
+    void uncalibrateImageInPlace(MaskedImage<float> &maskedImage, bool includeScaleUncertainty = true,
+                                 double tolerance = 0.0, int numThreads = 1) const;
+
     /**
      * Return a flux calibrated catalog, with new `_flux`, `_fluxErr`, `_mag`, and `_magErr` fields.
      *
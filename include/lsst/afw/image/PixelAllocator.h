@@ -0,0 +1,174 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Pluggable allocation of image pixel buffers
+ */
+#ifndef LSST_AFW_IMAGE_PIXELALLOCATOR_H
+#define LSST_AFW_IMAGE_PIXELALLOCATOR_H
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "ndarray.h"
+
+namespace lsst {
+namespace afw {
+namespace image {
+
+/**
+ * A source of memory for the pixels of new images.
+ *
+ * Every ImageBase (and hence Image, Mask, and the planes of MaskedImage and Exposure) that allocates
+ * its own pixels gets them from the allocator returned by getPixelAllocator(), or from the system
+ * allocator if that is null.  Images that view existing memory (e.g. numpy arrays) are unaffected.
+ */
+class PixelAllocator {
+public:
+    /// Alignment, in bytes, of every buffer returned by allocate.
+    static constexpr std::size_t ALIGNMENT = 64;
+
+    PixelAllocator() = default;
+    PixelAllocator(PixelAllocator const&) = delete;
+    PixelAllocator(PixelAllocator&&) = delete;
+    PixelAllocator& operator=(PixelAllocator const&) = delete;
+    PixelAllocator& operator=(PixelAllocator&&) = delete;
+    virtual ~PixelAllocator() noexcept;
+
+    /**
+     * Allocate an uninitialized buffer.
+     *
+     * @param[in] nBytes  minimum size of the buffer in bytes
+     *
+     * @returns a manager that owns the buffer, and the buffer, aligned to ALIGNMENT bytes.  The
+     *          buffer is released when the last reference to the manager goes away, even if that is
+     *          after the allocator itself has been destroyed.
+     *
+     * @throws std::bad_alloc if the memory cannot be allocated
+     */
+    virtual std::pair<ndarray::Manager::Ptr, void*> allocate(std::size_t nBytes) = 0;
+};
+
+/**
+ * A PixelAllocator that recycles freed buffers.
+ *
+ * Requests are rounded up to size classes (eight per power of two, so at most 12.5% of a buffer is
+ * unused), and a released buffer is kept for the next request of its size class as long as the
+ * total size of the kept buffers stays within a limit.  Reusing a buffer avoids both the system
+ * allocator and the page faults of touching freshly mapped memory, which dominate the cost of
+ * creating large temporary images.  Requests smaller than MIN_POOLED_BYTES, for which the system
+ * allocator is already fast, are not pooled.
+ *
+ * All member functions may be called from several threads at once.
+ */
+class PooledPixelAllocator final : public PixelAllocator {
+public:
+    /// Smallest request, in bytes, that is served from the pool.
+    static constexpr std::size_t MIN_POOLED_BYTES = 1 << 16;
+
+    /// Numbers of pooled requests that did and did not reuse a buffer, and the size of the pool.
+    struct Statistics {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t cachedBytes = 0;  ///< total size of the buffers kept for reuse
+    };
+
+    /**
+     * Construct an empty pool.
+     *
+     * @param[in] maxCachedBytes  largest total size of the buffers kept for reuse
+     * @param[in] useHugePages  if true, round pooled buffers up to whole 2 MiB pages and ask the
+     *                          operating system to back them with transparent huge pages, which
+     *                          reduces TLB misses when iterating over large images.  This is only a
+     *                          hint, and is ignored on platforms other than Linux.
+     */
+    explicit PooledPixelAllocator(std::size_t maxCachedBytes = std::size_t(1) << 30,
+                                  bool useHugePages = false);
+
+    ~PooledPixelAllocator() noexcept override;
+
+    std::pair<ndarray::Manager::Ptr, void*> allocate(std::size_t nBytes) override;
+
+    /// Return the hit and miss counts since construction, and the current size of the pool.
+    Statistics getStatistics() const;
+
+    /// Release all buffers kept for reuse back to the system.
+    void clear();
+
+private:
+    struct Pool;
+
+    std::shared_ptr<Pool> _pool;
+};
+
+/**
+ * Return the allocator for new image pixels on the calling thread.
+ *
+ * This is the allocator of the innermost ScopedPixelAllocator on this thread, if there is one, and
+ * otherwise the default set by setDefaultPixelAllocator.  Null means the system allocator.
+ */
+std::shared_ptr<PixelAllocator> getPixelAllocator();
+
+/**
+ * Set the allocator for new image pixels on threads with no ScopedPixelAllocator.
+ *
+ * @param[in] allocator  allocator to use; null (the initial state) means the system allocator
+ */
+void setDefaultPixelAllocator(std::shared_ptr<PixelAllocator> allocator);
+
+/**
+ * Use a PixelAllocator for new images on the calling thread while this object exists.
+ *
+ * Scopes may be nested; destroying one restores the allocator that was in use when it was made.
+ * They must be destroyed in the reverse order of construction, on the thread that made them.
+ * Images allocated within the scope keep their pixels until they are destroyed, even if that is
+ * after the scope has ended.
+ */
+class ScopedPixelAllocator final {
+public:
+    /**
+     * Start using an allocator on this thread.
+     *
+     * @param[in] allocator  allocator to use; null means the system allocator
+     */
+    explicit ScopedPixelAllocator(std::shared_ptr<PixelAllocator> allocator);
+
+    ScopedPixelAllocator(ScopedPixelAllocator const&) = delete;
+    ScopedPixelAllocator(ScopedPixelAllocator&&) = delete;
+    ScopedPixelAllocator& operator=(ScopedPixelAllocator const&) = delete;
+    ScopedPixelAllocator& operator=(ScopedPixelAllocator&&) = delete;
+
+    ~ScopedPixelAllocator() noexcept;
+
+private:
+    bool _previousActive;
+    std::shared_ptr<PixelAllocator> _previous;
+};
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !LSST_AFW_IMAGE_PIXELALLOCATOR_H
@@ -0,0 +1,215 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * An image too large for memory, made of tiles that are loaded on demand
+ */
+#ifndef LSST_AFW_IMAGE_TILEDIMAGE_H
+#define LSST_AFW_IMAGE_TILEDIMAGE_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lsst/geom/Box.h"
+#include "lsst/afw/fits.h"
+#include "lsst/afw/image/Image.h"
+
+namespace lsst {
+namespace afw {
+namespace image {
+
+/**
+ * A read-only image made of tiles that are loaded when their pixels are needed.
+ *
+ * A TiledImage covers a bounding box with a set of tiles, each with its own (PARENT) bounding box,
+ * for example the patches of a tract-scale mosaic, each stored in its own FITS file.  Tiles are
+ * loaded by a user-supplied function (or read from FITS files, see readFits), and a bounded number of
+ * the most recently used ones are kept in memory, so an image of any size can be processed in a
+ * bounded amount of memory as long as it is accessed with some locality.  Where tiles overlap the
+ * last one in the list takes precedence; pixels not covered by any tile have a padding value.
+ *
+ * Subimage views (see the bounding-box constructor) share the tiles and the cache of their parent,
+ * and load nothing until their pixels are needed.  Algorithms that need whole images (e.g.
+ * math::makeStatistics, math::convolve or detection::FootprintSet) can be run piece by piece with
+ * forEachBlock, which reads each block of a regular grid together with a halo of neighbouring pixels.
+ *
+ * The cache may be used from several threads at once; tiles are loaded without holding its lock.
+ */
+template <typename PixelT>
+class TiledImage final {
+public:
+    using Pixel = PixelT;
+    using ImageT = Image<PixelT>;
+    /// Function returning tile i, whose bounding box must be the ith tile box
+    using TileLoader = std::function<std::shared_ptr<ImageT const>(std::size_t)>;
+    /// Function called by forEachBlock with a block and the (PARENT) bounding box of its core
+    using BlockFunction = std::function<void(ImageT const &, lsst::geom::Box2I const &)>;
+
+    /// Default number of tiles kept in memory
+    static constexpr std::size_t DEFAULT_CACHE_CAPACITY = 16;
+
+    /**
+     * Construct from a list of tile bounding boxes and a function to load the tiles.
+     *
+     * @param bbox Bounding box of the image (PARENT)
+     * @param tileBoxes Bounding box of each tile (PARENT); tiles may extend beyond bbox
+     * @param loader Function to load a tile, given its index
+     * @param cacheCapacity Maximum number of tiles kept in memory
+     * @param padValue Value of pixels not covered by any tile
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if cacheCapacity is zero.
+     */
+    TiledImage(lsst::geom::Box2I const &bbox, std::vector<lsst::geom::Box2I> tileBoxes, TileLoader loader,
+               std::size_t cacheCapacity = DEFAULT_CACHE_CAPACITY, PixelT padValue = 0);
+
+    /**
+     * Construct a view of part of another TiledImage, sharing its tiles and cache.
+     *
+     * @param rhs TiledImage to view
+     * @param bbox Bounding box of the view
+     * @param origin Coordinate system of bbox
+     *
+     * @throws lsst::pex::exceptions::LengthError if bbox does not lie within rhs.
+     */
+    TiledImage(TiledImage const &rhs, lsst::geom::Box2I const &bbox, ImageOrigin origin = PARENT);
+
+    /**
+     * Make a TiledImage from one tile per FITS file.
+     *
+     * Only the headers are read here (to find each tile's bounding box); the pixels are read when
+     * they are needed.  The bounding box of the image is the smallest that contains every tile.
+     *
+     * @param fileNames Names of the files, one tile each
+     * @param hdu HDU to read from each file
+     * @param cacheCapacity Maximum number of tiles kept in memory
+     * @param padValue Value of pixels not covered by any tile
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if cacheCapacity is zero.
+     * @throws lsst::afw::fits::FitsError if a header cannot be read.
+     */
+    static TiledImage readFits(std::vector<std::string> const &fileNames, int hdu = fits::DEFAULT_HDU,
+                               std::size_t cacheCapacity = DEFAULT_CACHE_CAPACITY, PixelT padValue = 0);
+
+    TiledImage(TiledImage const &) = default;
+    TiledImage(TiledImage &&) = default;
+    TiledImage &operator=(TiledImage const &) = default;
+    TiledImage &operator=(TiledImage &&) = default;
+    ~TiledImage() = default;
+
+    /// Return the bounding box of the image
+    lsst::geom::Box2I getBBox(ImageOrigin origin = PARENT) const {
+        return origin == PARENT ? _bbox
+                                : lsst::geom::Box2I(lsst::geom::Point2I(0, 0), _bbox.getDimensions());
+    }
+    /// Return the number of columns in the image
+    int getWidth() const { return _bbox.getWidth(); }
+    /// Return the number of rows in the image
+    int getHeight() const { return _bbox.getHeight(); }
+    /// Return the image's column-origin
+    int getX0() const { return _bbox.getMinX(); }
+    /// Return the image's row-origin
+    int getY0() const { return _bbox.getMinY(); }
+    /// Return the image's origin
+    lsst::geom::Point2I getXY0() const { return _bbox.getMin(); }
+    /// Return the image's size
+    lsst::geom::Extent2I getDimensions() const { return _bbox.getDimensions(); }
+
+    /// Return the number of tiles (including any that do not overlap this view)
+    std::size_t getTileCount() const;
+    /// Return the bounding box of tile i (PARENT), without bounds checking
+    lsst::geom::Box2I const &getTileBBox(std::size_t i) const;
+    /// Return the value of pixels not covered by any tile
+    PixelT getPadValue() const;
+
+    /**
+     * Return the value of one pixel.
+     *
+     * @throws lsst::pex::exceptions::LengthError if the pixel is not within the image.
+     */
+    PixelT get(lsst::geom::Point2I const &point, ImageOrigin origin = PARENT) const;
+
+    /**
+     * Copy part of the image into memory.
+     *
+     * @param bbox Region to read
+     * @param origin Coordinate system of bbox
+     * @returns an image with the PARENT bounding box of the region
+     *
+     * @throws lsst::pex::exceptions::LengthError if bbox does not lie within the image.
+     */
+    std::shared_ptr<ImageT> read(lsst::geom::Box2I const &bbox, ImageOrigin origin = PARENT) const;
+
+    /// Copy the whole image into memory.
+    std::shared_ptr<ImageT> read() const { return read(_bbox); }
+
+    /**
+     * Process the image one block at a time.
+     *
+     * The image is divided into a grid of blocks of blockSize pixels (smaller at the top and right
+     * edges).  For each block, func is called with an in-memory image of the block grown by halo
+     * pixels on every side (clipped to the image) and the bounding box of the block itself, the
+     * "core".  With a halo at least as wide as an algorithm's reach (e.g. half a convolution kernel),
+     * the results of the algorithm on the cores of all blocks are those on the whole image.
+     * Blocks are processed in row-major order, on up to numThreads threads (0 means as many as
+     * allowed), in which case func must be safe to call concurrently.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if blockSize is not positive, halo is
+     *         negative or numThreads is negative.
+     */
+    void forEachBlock(lsst::geom::Extent2I const &blockSize, int halo, BlockFunction const &func,
+                      int numThreads = 1) const;
+
+    /// Return the maximum number of tiles kept in memory
+    std::size_t getCacheCapacity() const;
+
+    /**
+     * Set the maximum number of tiles kept in memory, emptying the cache.
+     *
+     * This affects every view of the same tiles.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if capacity is zero.
+     */
+    void setCacheCapacity(std::size_t capacity);
+
+    /// Return the number of tiles loaded so far, counting each time a tile is loaded again
+    std::size_t getTileLoadCount() const;
+
+private:
+    class TileStore;
+
+    // Copy the pixels of every tile overlapping bbox into image, whose bbox is bbox
+    void _fill(ImageT &image) const;
+
+    std::shared_ptr<TileStore> _store;
+    lsst::geom::Box2I _bbox;
+};
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_IMAGE_TILEDIMAGE_H
@@ -23,6 +23,8 @@
 #ifndef LSST_AFW_IMAGE_TRANSMISSIONCURVE_H_INCLUDED
 #define LSST_AFW_IMAGE_TRANSMISSIONCURVE_H_INCLUDED
 
+#include <vector>
+
 #include "ndarray_fwd.h"
 
 #include "lsst/afw/geom/Transform.h"
@@ -200,6 +202,45 @@ public:
     ndarray::Array<double, 1, 1> sampleAt(lsst::geom::Point2D const &position,
                                           ndarray::Array<double const, 1, 1> const &wavelengths) const;
 
+    /**
+     *  Evaluate the throughput at many positions into a provided output array.
+     *
+     *  This is equivalent to calling the single-position overload for each
+     *  row of `out`, but implementations share the work that does not depend
+     *  on position: spatially-constant curves are only evaluated once, and
+     *  radial curves are sampled at each wavelength once per call and then
+     *  only interpolated in radius.
+     *
+     *  @param[in]  positions    Spatial positions at which to evaluate.
+     *  @param[in]  wavelengths  Wavelengths at which to evaluate.
+     *
+     *  @param[in,out]  out      Computed throughput values, with one row per
+     *                           position and one column per wavelength.  Must
+     *                           be pre-allocated with shape
+     *                           (positions.size(), wavelengths.size()).
+     *
+     *  @throw Throws pex::exceptions::LengthError if the shape of `out` does
+     *         not match the sizes of `positions` and `wavelengths`.
+     *
+     *  @exceptsafe Provides basic exception safety: the `out` array values
+     *              may be modified if an exception is thrown.
+     */
+    virtual void sampleAt(std::vector<lsst::geom::Point2D> const &positions,
+                          ndarray::Array<double const, 1, 1> const &wavelengths,
+                          ndarray::Array<double, 2, 1> const &out) const;
+
+    /**
+     *  Evaluate the throughput at many positions into a new array.
+     *
+     *  @param[in]  positions    Spatial positions at which to evaluate.
+     *  @param[in]  wavelengths  Wavelengths at which to evaluate.
+     *
+     *  @return  Computed throughput values, in an array with shape
+     *           (positions.size(), wavelengths.size()).
+     */
+    ndarray::Array<double, 2, 2> sampleAt(std::vector<lsst::geom::Point2D> const &positions,
+                                          ndarray::Array<double const, 1, 1> const &wavelengths) const;
+
 protected:
     /**
      *  Polymorphic implementation for transformedBy().
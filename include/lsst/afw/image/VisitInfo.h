@@ -27,6 +27,8 @@
 #include <cmath>
 #include <limits>
 
+#include "ndarray.h"
+
 #include "lsst/base.h"
 #include "lsst/daf/base.h"
 #include "lsst/afw/coord/Observatory.h"
@@ -216,6 +218,56 @@ public:
      */
     lsst::geom::Angle getBoresightParAngle() const;
 
+    /**
+     * @name Quantities at many sky positions
+     *
+     * Vectorized equivalents, for arrays of sky positions, of the quantities for the boresight, computed
+     * in one pass without per-position overhead.  Positions are given by ICRS right ascension and
+     * declination (rad), in arrays of the same shape; as for the boresight, the hour angle of a position
+     * is the local Earth Rotation Angle minus its right ascension.  Angles are returned in radians.
+     *
+     * These throw lsst::pex::exceptions::LengthError if ra and dec differ in length.
+     */
+    ///@{
+
+    /// Get the altitudes of sky positions above the horizon
+    ndarray::Array<double, 1, 1> getAltitude(ndarray::Array<double const, 1> const &ra,
+                                             ndarray::Array<double const, 1> const &dec) const;
+
+    /// Get the parallactic angles of sky positions; see getBoresightParAngle
+    ndarray::Array<double, 1, 1> getParAngle(ndarray::Array<double const, 1> const &ra,
+                                             ndarray::Array<double const, 1> const &dec) const;
+
+    /**
+     * Get the airmasses of sky positions, relative to zenith
+     *
+     * Computed from the zenith distance with the interpolation formula of A. T. Young, "Air mass and
+     * refraction," Applied Optics 33, 1108 (1994), which is accurate to the horizon; NaN below it.
+     */
+    ndarray::Array<double, 1, 1> getAirmass(ndarray::Array<double const, 1> const &ra,
+                                            ndarray::Array<double const, 1> const &dec) const;
+
+    /**
+     * Get the atmospheric refraction of light of one wavelength (nm) at sky positions
+     *
+     * If any part of the weather is unknown (NaN), coord::makeDefaultWeather is used for the altitude of
+     * the observatory, as by lsst.afw.coord.refraction.  See coord::computeRefraction.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if the wavelength is out of range.
+     */
+    ndarray::Array<double, 1, 1> getRefraction(double wavelength, ndarray::Array<double const, 1> const &ra,
+                                               ndarray::Array<double const, 1> const &dec) const;
+
+    /**
+     * Get the refraction at one wavelength minus that at a reference wavelength (nm) at sky positions
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if either wavelength is out of range.
+     */
+    ndarray::Array<double, 1, 1> getDifferentialRefraction(double wavelength, double wavelengthRef,
+                                                           ndarray::Array<double const, 1> const &ra,
+                                                           ndarray::Array<double const, 1> const &dec) const;
+    ///@}
+
     /// Create a new VisitInfo that is a copy of this one.
     std::shared_ptr<typehandling::Storable> cloneStorable() const override;
 
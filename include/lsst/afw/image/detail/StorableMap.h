@@ -55,6 +55,10 @@ namespace detail {
  * object if instead there is a Psf labeled "value". At present, a StorableMap
  * does not store type information internally, instead relying on RTTI for
  * type checking.
+ *
+ * Copies of a StorableMap share their contents until one of them is modified,
+ * so copying a map (as when an Exposure is copied or a subimage is made) takes
+ * constant time.
  */
 class StorableMap final {
 public:
@@ -126,7 +130,7 @@ public:
                       "Due to implementation constraints, pointers to non-const are not supported.");
         try {
             // unordered_map::at(Key<Storable>) does not do any type-checking.
-            mapped_type const& pointer = _contents.at(key);
+            mapped_type const& pointer = _contents->at(key);
 
             // Null pointer stored; skip dynamic_cast because won't change result.
             if (pointer == nullptr) {
@@ -203,9 +207,9 @@ public:
                       "Can only retrieve pointers to subclasses of Storable.");
         static_assert(std::is_const<T>::value,
                       "Due to implementation constraints, pointers to non-const are not supported.");
-        if (_contents.count(key) > 0) {
+        if (_contents->count(key) > 0) {
             // unordered_map::at(Key<Storable>) does not do any type-checking.
-            mapped_type const& pointer = _contents.at(key);
+            mapped_type const& pointer = _contents->at(key);
 
             // Null pointer stored; dynamic_cast will always return null.
             if (pointer == nullptr) {
@@ -267,7 +271,10 @@ public:
                       "Due to implementation constraints, pointers to non-const are not supported.");
         // unordered_map uses Key<shared_ptr<Storable>> internally, so
         // any key with the same ID will block emplacement.
-        return _contents.emplace(key, value).second;
+        if (_contents->count(key) > 0) {
+            return false;
+        }
+        return _mutableContents().emplace(key, value).second;
     }
 
     /**
@@ -306,12 +313,14 @@ public:
      * @param key the key to remove
      *
      * @return `true` if `key` was removed, `false` if it was not present.
+     *
+     * @exceptsafe Provides strong exception safety.
      */
     template <typename T>
-    bool erase(Key<T> const& key) noexcept {
+    bool erase(Key<T> const& key) {
         // unordered_map::erase(Key<Storable>) does no type checking.
         if (this->contains(key)) {
-            return _contents.erase(key) > 0;
+            return _mutableContents().erase(key) > 0;
         } else {
             return false;
         }
@@ -325,7 +334,7 @@ public:
      *
      * @{
      */
-    iterator begin() noexcept;
+    iterator begin();
     const_iterator begin() const noexcept;
     const_iterator cbegin() const noexcept { return begin(); }
 
@@ -339,14 +348,21 @@ public:
      *
      * @{
      */
-    iterator end() noexcept;
+    iterator end();
     const_iterator end() const noexcept;
     const_iterator cend() const noexcept { return end(); }
 
     /** @} */
 
 private:
-    _Impl _contents;
+    // Return the contents shared by all empty maps
+    static std::shared_ptr<_Impl> const& _emptyContents();
+
+    // Return the contents for modification, first copying them if they are shared with another map
+    _Impl& _mutableContents();
+
+    std::shared_ptr<_Impl> _contents;
+    // Class invariant: _contents is never null
 };
 
 }  // namespace detail
@@ -30,6 +30,7 @@
 #define LSST_AFW_MATH_H
 
 #include "lsst/afw/math/GaussianProcess.h"
+#include "lsst/afw/math/FlatKdTree.h"
 #include "lsst/afw/math/Background.h"
 #include "lsst/afw/math/Function.h"
 #include "lsst/afw/math/FunctionLibrary.h"
@@ -41,10 +42,12 @@
 #include "lsst/afw/math/offsetImage.h"
 #include "lsst/afw/math/MaskedVector.h"
 #include "lsst/afw/math/Statistics.h"
+#include "lsst/afw/math/MultiRegionStatistics.h"
 #include "lsst/afw/math/Integrate.h"
 #include "lsst/afw/math/Interpolate.h"
 #include "lsst/afw/math/Random.h"
 #include "lsst/afw/math/LeastSquares.h"
+#include "lsst/afw/math/LeastSquaresBatch.h"
 #include "lsst/afw/math/BoundedField.h"
 #include "lsst/afw/math/ChebyshevBoundedField.h"
 
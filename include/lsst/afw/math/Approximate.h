@@ -78,12 +78,23 @@ public:
     bool getWeighting() const { return _weighting; }
     /// Set whether inverse variance weighting will be used in calculation
     void setWeighting(bool const weighting) { _weighting = weighting; }
+    /// Return the number of threads used to evaluate the approximation
+    int getNumThreads() const noexcept { return _numThreads; }
+    /**
+     * Set the number of threads used to evaluate the approximation
+     *
+     * @param numThreads number of threads; 0 means one per hardware thread
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
+     */
+    void setNumThreads(int numThreads);
 
 private:
     Style _style;
     int _orderX;
     int _orderY;
     bool _weighting;
+    int _numThreads;
 };
 
 /**
@@ -126,6 +137,19 @@ public:
     std::shared_ptr<image::Image<OutPixelT>> getImage(int orderX = -1, int orderY = -1) const {
         return doGetImage(orderX, orderY);
     }
+    /**
+     * Return the approximate %image over part of the approximation's domain
+     *
+     * @param bbox Region to evaluate, in the coordinates of the bbox passed to makeApproximate
+     * @param orderX Order of approximation to use in x-direction
+     * @param orderY Order of approximation to use in y-direction
+     *
+     * @throws lsst::pex::exceptions::LengthError if bbox does not lie within the domain
+     */
+    std::shared_ptr<image::Image<OutPixelT>> getImage(lsst::geom::Box2I const& bbox, int orderX = -1,
+                                                      int orderY = -1) const {
+        return doGetImage(bbox, orderX, orderY);
+    }
     /// Return the approximate %image as a MaskedImage
     std::shared_ptr<image::MaskedImage<OutPixelT>> getMaskedImage(int orderX = -1, int orderY = -1) const {
         return doGetMaskedImage(orderX, orderY);
@@ -148,6 +172,8 @@ protected:
     ApproximateControl const _ctrl;   ///< desired approximation algorithm
 private:
     virtual std::shared_ptr<image::Image<OutPixelT>> doGetImage(int orderX, int orderY) const = 0;
+    virtual std::shared_ptr<image::Image<OutPixelT>> doGetImage(lsst::geom::Box2I const& bbox, int orderX,
+                                                                int orderY) const = 0;
     virtual std::shared_ptr<image::MaskedImage<OutPixelT>> doGetMaskedImage(int orderX, int orderY) const = 0;
 };
 }  // namespace math
@@ -29,6 +29,9 @@
  */
 #include <boost/preprocessor/seq.hpp>
 #include <memory>
+#include <utility>
+#include <vector>
+#include "ndarray.h"
 #include "lsst/pex/exceptions.h"
 #include "lsst/geom/Box.h"
 #include "lsst/afw/math/Statistics.h"
@@ -71,7 +74,8 @@ public:
               _undersampleStyle(THROW_EXCEPTION),
               _sctrl(new StatisticsControl(sctrl)),
               _prop(prop),
-              _actrl(new ApproximateControl(actrl)) {
+              _actrl(new ApproximateControl(actrl)),
+              _numThreads(1) {
         if (nxSample <= 0 || nySample <= 0) {
             throw LSST_EXCEPT(lsst::pex::exceptions::LengthError,
                               str(boost::format("You must specify at least one point, not %dx%d") % nxSample %
@@ -97,7 +101,8 @@ public:
               _undersampleStyle(THROW_EXCEPTION),
               _sctrl(new StatisticsControl(sctrl)),
               _prop(stringToStatisticsProperty(prop)),
-              _actrl(new ApproximateControl(actrl)) {
+              _actrl(new ApproximateControl(actrl)),
+              _numThreads(1) {
         if (nxSample <= 0 || nySample <= 0) {
             throw LSST_EXCEPT(lsst::pex::exceptions::LengthError,
                               str(boost::format("You must specify at least one point, not %dx%d") % nxSample %
@@ -127,7 +132,8 @@ public:
               _undersampleStyle(undersampleStyle),
               _sctrl(new StatisticsControl(sctrl)),
               _prop(prop),
-              _actrl(new ApproximateControl(actrl)) {
+              _actrl(new ApproximateControl(actrl)),
+              _numThreads(1) {
         if (nxSample <= 0 || nySample <= 0) {
             throw LSST_EXCEPT(lsst::pex::exceptions::LengthError,
                               str(boost::format("You must specify at least one point, not %dx%d") % nxSample %
@@ -157,7 +163,8 @@ public:
               _undersampleStyle(math::stringToUndersampleStyle(undersampleStyle)),
               _sctrl(new StatisticsControl(sctrl)),
               _prop(stringToStatisticsProperty(prop)),
-              _actrl(new ApproximateControl(actrl)) {
+              _actrl(new ApproximateControl(actrl)),
+              _numThreads(1) {
         if (nxSample <= 0 || nySample <= 0) {
             throw LSST_EXCEPT(lsst::pex::exceptions::LengthError,
                               str(boost::format("You must specify at least one point, not %dx%d") % nxSample %
@@ -219,6 +226,23 @@ public:
     std::shared_ptr<ApproximateControl> getApproximateControl() { return _actrl; }
     std::shared_ptr<ApproximateControl const> getApproximateControl() const { return _actrl; }
 
+    /// Return the number of threads used to measure the grid cells and to interpolate the background
+    int getNumThreads() const noexcept { return _numThreads; }
+    /**
+     * Set the number of threads used to measure the grid cells and to interpolate the background
+     *
+     * @param numThreads number of threads; 0 means one per hardware thread
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
+     */
+    void setNumThreads(int numThreads) {
+        if (numThreads < 0) {
+            throw LSST_EXCEPT(lsst::pex::exceptions::InvalidParameterError,
+                              "numThreads must be >= 0 (0 means one per hardware thread)");
+        }
+        _numThreads = numThreads;
+    }
+
 private:
     Interpolate::Style _style;           // style of interpolation to use
     int _nxSample;                       // number of grid squares to divide image into to sample in x
@@ -227,6 +251,7 @@ private:
     std::shared_ptr<StatisticsControl> _sctrl;   // statistics control object
     Property _prop;                              // statistics Property
     std::shared_ptr<ApproximateControl> _actrl;  // approximate control object
+    int _numThreads;                             // number of threads; 0 means one per hardware thread
 };
 
 /**
@@ -484,6 +509,32 @@ public:
      */
     BackgroundMI& operator-=(float const delta) override;
 
+    /**
+     * Re-measure the cells of the grid that overlap a changed part of the image
+     *
+     * Use this after changing some of the pixels of the image the background was estimated from
+     * (e.g. setting DETECTED bits in its mask).  Only the cells that overlap `changedBBox` are
+     * measured again, as the constructor measured them.
+     *
+     * @param img The image the background was estimated from, after the change
+     * @param changedBBox Region containing all the changed pixels, in PARENT coordinates
+     *
+     * @throws lsst::pex::exceptions::LengthError if img's bbox differs from getImageBBox()
+     */
+    template <typename ImageT>
+    void update(ImageT const& img, lsst::geom::Box2I const& changedBBox);
+    /**
+     * Re-measure selected cells of the grid
+     *
+     * @param img The image the background was estimated from, after the change
+     * @param dirtyCells true for each cell to measure again, indexed as [iY][iX] like the statsImage
+     *
+     * @throws lsst::pex::exceptions::LengthError if img's bbox differs from getImageBBox(), or
+     *         dirtyCells' shape differs from that of the statsImage
+     */
+    template <typename ImageT>
+    void update(ImageT const& img, ndarray::Array<bool const, 2, 1> const& dirtyCells);
+
     /**
      * Return the image of statistical quantities extracted from the image
      */
@@ -493,9 +544,26 @@ private:
     lsst::afw::image::MaskedImage<InternalPixelT>
             _statsImage;  // statistical properties for the grid of subimages
     mutable std::vector<std::vector<double>> _gridColumns;  // interpolated columns for the bicubic spline
+    // the statsImage columns and styles that _gridColumns were interpolated from; empty if unset
+    mutable std::vector<std::vector<InternalPixelT>> _gridColumnInputs;
+    mutable Interpolate::Style _gridColumnsInterpStyle;
+    mutable UndersampleStyle _gridColumnsUndersampleStyle;
+
+    // measure the statistics of the cells (iX, iY) of img
+    template <typename ImageT>
+    void _measureCells(ImageT const& img, std::vector<std::pair<int, int>> const& cells);
 
     void _setGridColumns(Interpolate::Style const interpStyle, UndersampleStyle const undersampleStyle,
                          int const iX, std::vector<int> const& ypix) const;
+    // check that there are enough samples for interpStyle, returning the style to actually use
+    Interpolate::Style _checkInterpStyle(Interpolate::Style const interpStyle,
+                                         UndersampleStyle const undersampleStyle) const;
+    // set _gridColumns for every column of the stats image, re-interpolating only the columns whose
+    // values (or the styles) changed since they were last interpolated
+    void _setAllGridColumns(Interpolate::Style const interpStyle,
+                            UndersampleStyle const undersampleStyle) const;
+
+    friend class BackgroundImageView;
 
 #if defined(LSST_makeBackground_getImage)
     BOOST_PP_SEQ_FOR_EACH(LSST_makeBackground_getImage, override, LSST_makeBackground_getImage_types);
@@ -517,6 +585,171 @@ private:
     std::shared_ptr<Approximate<PixelT>> doGetApproximate(ApproximateControl const& actrl,
                                                           UndersampleStyle const undersampleStyle) const;
 };
+
+/**
+ * A lazily-evaluated background image
+ *
+ * BackgroundMI::getImage interpolates the background over the whole image at once.  A BackgroundImageView
+ * instead does the work that is shared by every pixel (checking the sampling, interpolating the grid
+ * columns or fitting the approximation) when it is constructed, and then evaluates the background only
+ * for the regions that are asked for.  In particular, subtractFrom() evaluates and subtracts the
+ * background one strip of rows at a time, so no full-size background image is ever allocated.
+ *
+ * The results are identical to those of BackgroundMI::getImage with the same styles.
+ */
+class BackgroundImageView final {
+public:
+    using InternalPixelT = Background::InternalPixelT;
+
+    /**
+     * Prepare to evaluate a background using the styles in its BackgroundControl
+     *
+     * @param background The background to evaluate
+     */
+    explicit BackgroundImageView(std::shared_ptr<BackgroundMI const> background);
+    /**
+     * Prepare to evaluate a background
+     *
+     * @param background The background to evaluate
+     * @param interpStyle Style of the interpolation
+     * @param undersampleStyle Behaviour if there are too few points
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if there are too few points for
+     *         interpStyle and undersampleStyle is THROW_EXCEPTION
+     */
+    BackgroundImageView(std::shared_ptr<BackgroundMI const> background, Interpolate::Style const interpStyle,
+                        UndersampleStyle const undersampleStyle = THROW_EXCEPTION);
+
+    BackgroundImageView(BackgroundImageView const&) = default;
+    BackgroundImageView(BackgroundImageView&&) = default;
+    BackgroundImageView& operator=(BackgroundImageView const&) = default;
+    BackgroundImageView& operator=(BackgroundImageView&&) = default;
+    ~BackgroundImageView() = default;
+
+    /// Return the (PARENT) bounding box of the image the background was estimated from
+    lsst::geom::Box2I getBBox() const noexcept { return _bbox; }
+
+    /// Return the number of threads used by subtractFrom; 0 means one per hardware thread
+    int getNumThreads() const noexcept { return _numThreads; }
+
+    /**
+     * Evaluate the background over part of the image
+     *
+     * @param bbox Region to evaluate, in PARENT coordinates
+     * @returns an image of the background, with xy0 set to bbox's minimum
+     *
+     * @throws lsst::pex::exceptions::LengthError if bbox does not lie within getBBox()
+     */
+    std::shared_ptr<image::Image<InternalPixelT>> evaluate(lsst::geom::Box2I const& bbox) const;
+
+    /**
+     * Subtract the background from an image, in place
+     *
+     * @param img Image to subtract the background from; its bbox selects the part of the background used
+     *
+     * @throws lsst::pex::exceptions::LengthError if img does not lie within getBBox()
+     */
+    template <typename PixelT>
+    void subtractFrom(image::Image<PixelT>& img) const;
+    /**
+     * Subtract the background from a MaskedImage's image plane, in place
+     *
+     * @param mimg MaskedImage to subtract the background from; its bbox selects the part of the
+     *             background used
+     *
+     * @throws lsst::pex::exceptions::LengthError if mimg does not lie within getBBox()
+     */
+    template <typename PixelT>
+    void subtractFrom(image::MaskedImage<PixelT>& mimg) const;
+
+private:
+    lsst::geom::Box2I _bbox;                               // PARENT bbox of the background's image
+    Interpolate::Style _interpStyle;                       // the style actually used
+    UndersampleStyle _undersampleStyle;                    // what to do when interpolation is undersampled
+    int _numThreads;                                       // threads used by subtractFrom
+    std::vector<double> _xcen;                             // x centers of the grid cells
+    std::vector<std::vector<double>> _gridColumns;         // grid columns interpolated to every row
+    std::shared_ptr<Approximate<InternalPixelT>> _approx;  // the approximation, if one was requested
+};
+
+/**
+ * The sum of several backgrounds of the same image, evaluated together
+ *
+ * The model of a BackgroundList is the sum of its backgrounds.  Rather than evaluating each of them
+ * over the whole image and adding the results, a BackgroundListView evaluates all of them over the same
+ * strip of rows, accumulating them in a single strip buffer; subtractFrom() then subtracts that sum
+ * from the strip of the image before moving on.
+ *
+ * The sum is accumulated in component order in InternalPixelT, so the results are identical to adding
+ * the images from BackgroundImageView::evaluate of each component in turn.
+ */
+class BackgroundListView final {
+public:
+    using InternalPixelT = Background::InternalPixelT;
+
+    /**
+     * Prepare to evaluate the sum of several backgrounds
+     *
+     * @param components The backgrounds to sum, in order.  The strips are processed using the number
+     *                   of threads of the first component.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if components is empty
+     * @throws lsst::pex::exceptions::LengthError if the components were estimated from images with
+     *         different bounding boxes
+     */
+    explicit BackgroundListView(std::vector<BackgroundImageView> components);
+
+    BackgroundListView(BackgroundListView const&) = default;
+    BackgroundListView(BackgroundListView&&) = default;
+    BackgroundListView& operator=(BackgroundListView const&) = default;
+    BackgroundListView& operator=(BackgroundListView&&) = default;
+    ~BackgroundListView() = default;
+
+    /// Return the (PARENT) bounding box of the image the backgrounds were estimated from
+    lsst::geom::Box2I getBBox() const noexcept { return _components.front().getBBox(); }
+
+    /// Return the number of backgrounds summed
+    std::size_t size() const noexcept { return _components.size(); }
+
+    /**
+     * Evaluate the sum of the backgrounds over part of the image
+     *
+     * @param bbox Region to evaluate, in PARENT coordinates
+     * @returns an image of the summed background, with xy0 set to bbox's minimum
+     *
+     * @throws lsst::pex::exceptions::LengthError if bbox does not lie within getBBox()
+     */
+    std::shared_ptr<image::Image<InternalPixelT>> evaluate(lsst::geom::Box2I const& bbox) const;
+
+    /**
+     * Subtract the sum of the backgrounds from an image, in place
+     *
+     * @param img Image to subtract the backgrounds from; its bbox selects the part of the
+     *            backgrounds used
+     *
+     * @throws lsst::pex::exceptions::LengthError if img does not lie within getBBox()
+     */
+    template <typename PixelT>
+    void subtractFrom(image::Image<PixelT>& img) const;
+    /**
+     * Subtract the sum of the backgrounds from a MaskedImage's image plane, in place
+     *
+     * @param mimg MaskedImage to subtract the backgrounds from; its bbox selects the part of the
+     *             backgrounds used
+     *
+     * @throws lsst::pex::exceptions::LengthError if mimg does not lie within getBBox()
+     */
+    template <typename PixelT>
+    void subtractFrom(image::MaskedImage<PixelT>& mimg) const;
+
+private:
+    // Call func(stripBox, sum) for each strip of rows of bbox, where sum is the summed background
+    template <typename Func>
+    void _forEachStrip(lsst::geom::Box2I const& bbox, Func func) const;
+
+    std::vector<BackgroundImageView> _components;
+};
+
 /**
  * A convenience function that uses function overloading to make the correct type of Background
  *
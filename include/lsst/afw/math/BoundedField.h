@@ -87,6 +87,23 @@ public:
     virtual ndarray::Array<double, 1, 1> evaluate(ndarray::Array<double const, 1> const& x,
                                                   ndarray::Array<double const, 1> const& y) const;
 
+    /**
+     *  Evaluate the field on a grid of points
+     *
+     *  @param[in]  x         array of x coordinates of the grid columns
+     *  @param[in]  y         array of y coordinates of the grid rows
+     *  @returns an array of shape (y.size, x.size) whose [i][j] element is the field at (x[j], y[i])
+     *
+     *  The default implementation calls the array form of evaluate() once per row; subclasses whose
+     *  functional form is separable in x and y may do much better.  fillImage(), addToImage(),
+     *  multiplyImage() and divideImage() are implemented in terms of this method.
+     *
+     *  There is no bounds-checking on the given positions; this is the responsibility
+     *  of the user, who can almost always do it more efficiently.
+     */
+    virtual ndarray::Array<double, 2, 2> evaluateGrid(ndarray::Array<double const, 1> const& x,
+                                                      ndarray::Array<double const, 1> const& y) const;
+
     /**
      * Compute the integral of this function over its bounding-box.
      *
@@ -181,6 +198,63 @@ public:
     template <typename T>
     void divideImage(image::Image<T>& image, bool overlapOnly = false, int xStep = 1, int yStep = 1) const;
 
+    /**
+     *  Assign the field to an image, interpolating it from as coarse a grid as a tolerance allows.
+     *
+     *  The field is evaluated on successively finer evenly-spaced grids, each with twice as many cells
+     *  on a side as the last, until bicubic (Catmull-Rom) interpolation from one grid reproduces the
+     *  next to within `tolerance`; the image is then interpolated from the finer of the two.  This is
+     *  much faster than evaluating the field at every pixel for smooth but expensive fields such as
+     *  PixelAreaBoundedField and TransformBoundedField.  If no grid coarser than a few pixels is good
+     *  enough, or the field is not finite at some grid point, the field is evaluated at every pixel, as
+     *  by fillImage().
+     *
+     *  @param[out]   image         Image to fill.
+     *  @param[in]    tolerance     Largest acceptable interpolation error, relative to the largest
+     *                              absolute value of the field on the grid; 0 to evaluate the field at
+     *                              every pixel.
+     *  @param[in]    overlapOnly   If true, only modify the region in the intersection of
+     *                              image.getBBox(image::PARENT) and this->getBBox().
+     *
+     *  @throws pex::exceptions::RuntimeError if the bounding boxes do not overlap
+     *         and overlapOnly=false.
+     *  @throws pex::exceptions::InvalidParameterError if `tolerance` is negative or NaN.
+     */
+    template <typename T>
+    void fillImageInterpolated(image::Image<T>& image, double tolerance, bool overlapOnly = false) const;
+
+    /**
+     *  Multiply an image in-place by the field, interpolated as by fillImageInterpolated().
+     *
+     *  @param[out]   image         Image to multiply.
+     *  @param[in]    tolerance     Largest acceptable relative interpolation error; see
+     *                              fillImageInterpolated().
+     *  @param[in]    overlapOnly   If true, only modify the region in the intersection of
+     *                              image.getBBox(image::PARENT) and this->getBBox().
+     *
+     *  @throws pex::exceptions::RuntimeError if the bounding boxes do not overlap
+     *         and overlapOnly=false.
+     *  @throws pex::exceptions::InvalidParameterError if `tolerance` is negative or NaN.
+     */
+    template <typename T>
+    void multiplyImageInterpolated(image::Image<T>& image, double tolerance, bool overlapOnly = false) const;
+
+    /**
+     *  Divide an image in-place by the field, interpolated as by fillImageInterpolated().
+     *
+     *  @param[out]   image         Image to divide.
+     *  @param[in]    tolerance     Largest acceptable relative interpolation error; see
+     *                              fillImageInterpolated().
+     *  @param[in]    overlapOnly   If true, only modify the region in the intersection of
+     *                              image.getBBox(image::PARENT) and this->getBBox().
+     *
+     *  @throws pex::exceptions::RuntimeError if the bounding boxes do not overlap
+     *         and overlapOnly=false.
+     *  @throws pex::exceptions::InvalidParameterError if `tolerance` is negative or NaN.
+     */
+    template <typename T>
+    void divideImageInterpolated(image::Image<T>& image, double tolerance, bool overlapOnly = false) const;
+
     /**
      *  Return a scaled BoundedField
      *
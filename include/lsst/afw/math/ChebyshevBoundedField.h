@@ -37,7 +37,7 @@ namespace math {
 /// A control object used when fitting ChebyshevBoundedField to data (see ChebyshevBoundedField::fit)
 class ChebyshevBoundedFieldControl {
 public:
-    ChebyshevBoundedFieldControl() : orderX(2), orderY(2), triangular(true) {}
+    ChebyshevBoundedFieldControl() : orderX(2), orderY(2), triangular(true), numThreads(1) {}
 
     LSST_CONTROL_FIELD(orderX, int, "maximum Chebyshev function order in x");
 
@@ -47,6 +47,10 @@ public:
                        "if true, only include terms where the sum of the x and y order "
                        "is less than or equal to max(orderX, orderY)");
 
+    LSST_CONTROL_FIELD(numThreads, int,
+                       "number of threads used to accumulate the normal equations when fitting an image; "
+                       "0 means one per hardware thread");
+
     /// Return the number of nonzero coefficients in the Chebyshev function defined by this object
     int computeSize() const;
 };
@@ -159,6 +163,10 @@ public:
     /**
      *  Fit a Chebyshev approximation to gridded data with equal weights.
      *
+     *  The normal equations are accumulated one row of the image at a time, so the memory needed
+     *  does not depend on the size of the image; rows are processed concurrently using
+     *  ctrl.numThreads threads.
+     *
      *  @param[in]  image    The Image containing the data to fit.  image.getBBox(PARENT) is
      *                       used as the bounding box of the BoundedField.
      *  @param[in]  ctrl     Specifies the orders and triangularity of the coefficient matrix.
@@ -195,6 +203,15 @@ public:
 
     using BoundedField::evaluate;
 
+    /**
+     *  @copydoc BoundedField::evaluateGrid
+     *
+     *  The Chebyshev basis functions are computed once per column and once per row, and the grid is
+     *  then formed as a product of small matrices, T(y) C T(x)^T.
+     */
+    ndarray::Array<double, 2, 2> evaluateGrid(ndarray::Array<double const, 1> const& x,
+                                              ndarray::Array<double const, 1> const& y) const override;
+
     /// @copydoc BoundedField::integrate
     double integrate() const override;
 
@@ -31,7 +31,9 @@
  *   This would only be used for unit testing and trace messages suffice (barely), so not a high priority.
  */
 #include <limits>
+#include <memory>
 #include <sstream>
+#include <vector>
 
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/image/Image.h"
@@ -52,22 +54,47 @@ public:
     ConvolutionControl(bool doNormalize = true,  ///< normalize the kernel to sum=1?
                        bool doCopyEdge = false,  ///< copy edge pixels from source image
                        ///< instead of setting them to the standard edge pixel?
-                       int maxInterpolationDistance = 10  ///< maximum width or height of a region
+                       int maxInterpolationDistance = 10,  ///< maximum width or height of a region
                        ///< over which to use linear interpolation interpolate
+                       int numThreads = 1  ///< number of threads to use; 0 for one per hardware thread
                        )
             : _doNormalize(doNormalize),
               _doCopyEdge(doCopyEdge),
-              _maxInterpolationDistance(maxInterpolationDistance) {}
+              _maxInterpolationDistance(maxInterpolationDistance),
+              _numThreads(numThreads),
+              _minFftKernelSize(0) {}
 
     bool getDoNormalize() const { return _doNormalize; }
     bool getDoCopyEdge() const { return _doCopyEdge; }
     int getMaxInterpolationDistance() const { return _maxInterpolationDistance; };
+    int getNumThreads() const { return _numThreads; }
+    int getMinFftKernelSize() const { return _minFftKernelSize; }
 
     void setDoNormalize(bool doNormalize) { _doNormalize = doNormalize; }
     void setDoCopyEdge(bool doCopyEdge) { _doCopyEdge = doCopyEdge; }
     void setMaxInterpolationDistance(int maxInterpolationDistance) {
         _maxInterpolationDistance = maxInterpolationDistance;
     }
+    /**
+     * Set the number of threads used by convolve
+     *
+     * If more than one, the good region of the output is split into bands of rows that are convolved
+     * concurrently (or, when convolving with linear interpolation, the interpolation subregions are);
+     * the result is bit-identical to single-threaded convolution.
+     * 0 means use one thread per hardware thread.
+     */
+    void setNumThreads(int numThreads) { _numThreads = numThreads; }
+    /**
+     * Set the minimum kernel size for which convolve uses fast Fourier transforms
+     *
+     * If > 0, an Image (not a MaskedImage) with floating-point pixels convolved with a spatially
+     * invariant kernel whose width and height are both at least this size is convolved with FFTs
+     * (see detail::convolveWithFft) instead of in real space. 1 requests FFT convolution for all
+     * such kernels; 0 (the default) disables it. FFT convolution agrees with real-space convolution
+     * to within floating-point round-off, and is faster for kernels larger than about 31x31.
+     * DeltaFunctionKernels and SeparableKernels are always convolved in real space.
+     */
+    void setMinFftKernelSize(int minFftKernelSize) { _minFftKernelSize = minFftKernelSize; }
 
 private:
     bool _doNormalize;              ///< normalize the kernel to sum=1?
@@ -75,6 +102,8 @@ private:
                                     ///< instead of setting them to the standard edge pixel?
     int _maxInterpolationDistance;  ///< maximum width or height of a region
                                     ///< over which to attempt interpolation
+    int _numThreads;                ///< number of threads; 0 for one per hardware thread
+    int _minFftKernelSize;          ///< minimum kernel width and height for FFT convolution; 0 to disable
 };
 
 /**
@@ -131,9 +160,9 @@ inline typename OutImageT::SinglePixel convolveAtAPoint(
  * to the lower left corner of the sub-image, but it will almost certainly change to be
  * the lower left corner of the parent image.
  *
- * All convolution is performed in real space. This allows convolution to handle masked pixels
- * and spatially varying kernels. Although convolution of an Image with a spatially invariant kernel could,
- * in fact, be performed in Fourier space, the code does not do this.
+ * Convolution is normally performed in real space. This allows convolution to handle masked pixels
+ * and spatially varying kernels. Convolution of an Image with a large spatially invariant kernel
+ * may instead be performed in Fourier space; see ConvolutionControl::setMinFftKernelSize.
  *
  * Note that mask bits are smeared by convolution; all nonzero pixels in the kernel smear the mask, even
  * pixels that have very small values. Larger kernels smear the mask more and are also slower to convolve.
@@ -189,6 +218,79 @@ template <typename OutImageT, typename InImageT, typename KernelT>
 void convolve(OutImageT& convolvedImage, InImageT const& inImage, KernelT const& kernel,
               ConvolutionControl const& convolutionControl = ConvolutionControl());
 
+/**
+ * Convolve one Image with many LinearCombinationKernels that share a basis, reusing the convolutions
+ * of the image with each basis kernel
+ *
+ * A LinearCombinationKernel K(x, y) = sum_i c_i(x, y) B_i is linear in its basis kernels B_i,
+ * so the image convolved with K is sum_i c_i(x, y) (image convolved with B_i) at each pixel (x, y).
+ * The first call to convolve() for a given image and basis convolves the image with each basis kernel
+ * and caches the results; later calls for the same image and basis, e.g. on each iteration of a fit
+ * of the kernel's spatial parameters, only recombine the cached basis convolutions.
+ * The result agrees with math::convolve to within floating-point round-off.
+ *
+ * The cache is keyed on the identity of the input image (the object, not its pixel values: call clear()
+ * if the pixels are modified in place) and on the basis kernel images and kernel center, so kernels
+ * constructed separately from the same basis list share cached convolutions.
+ * Only one image and basis is cached at a time.
+ *
+ * Only Images are supported: the variance of a MaskedImage convolved with K depends on products
+ * of pairs of basis kernels, so it cannot be recombined from the basis convolutions.
+ *
+ * This class is not thread-safe; use one cache per thread.
+ *
+ * @ingroup afw
+ */
+template <typename PixelT>
+class BasisConvolutionCache {
+public:
+    using ImageT = lsst::afw::image::Image<PixelT>;
+
+    BasisConvolutionCache() = default;
+    BasisConvolutionCache(BasisConvolutionCache const&) = delete;
+    BasisConvolutionCache(BasisConvolutionCache&&) = default;
+    BasisConvolutionCache& operator=(BasisConvolutionCache const&) = delete;
+    BasisConvolutionCache& operator=(BasisConvolutionCache&&) = default;
+    ~BasisConvolutionCache() = default;
+
+    /**
+     * Convolve an Image with a LinearCombinationKernel, as math::convolve does
+     *
+     * @param[out] convolvedImage convolved %image; must be the same size as inImage
+     * @param[in] inImage %image to convolve
+     * @param[in] kernel convolution kernel
+     * @param[in] convolutionControl convolution control parameters; the basis convolutions use its
+     *            number of threads, and it is never FFT-based (minFftKernelSize is ignored)
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if convolvedImage is not the same size as inImage
+     * @throws lsst::pex::exceptions::InvalidParameterError if inImage is smaller than kernel
+     *  in columns and/or rows.
+     */
+    void convolve(ImageT& convolvedImage, std::shared_ptr<ImageT const> const& inImage,
+                  LinearCombinationKernel const& kernel,
+                  ConvolutionControl const& convolutionControl = ConvolutionControl());
+
+    /**
+     * Are the basis convolutions of this image with this kernel's basis cached?
+     */
+    bool isCached(std::shared_ptr<ImageT const> const& inImage, LinearCombinationKernel const& kernel) const;
+
+    /**
+     * Discard the cached basis convolutions
+     */
+    void clear();
+
+private:
+    using BasisImageList = std::vector<std::shared_ptr<lsst::afw::image::Image<Kernel::Pixel>>>;
+
+    static BasisImageList _computeBasisImages(LinearCombinationKernel const& kernel);
+
+    std::weak_ptr<ImageT const> _inImage;  ///< image whose basis convolutions are cached
+    lsst::geom::Point2I _kernelCtr;        ///< center of the basis kernels
+    BasisImageList _basisImageList;        ///< images of the basis kernels
+    std::vector<std::shared_ptr<lsst::afw::image::Image<double>>> _basisConvolutionList;  ///< one per basis
+};
+
 /**
  * Return an off-the-edge pixel appropriate for a given Image type
  *
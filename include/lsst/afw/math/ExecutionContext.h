@@ -0,0 +1,114 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_MATH_EXECUTIONCONTEXT_H
+#define LSST_AFW_MATH_EXECUTIONCONTEXT_H
+
+/*
+ * Process-wide control of the threads used by afw's parallel algorithms.
+ *
+ * Every parallel code path in afw (convolution, warping, image stacking, FITS compression, catalog
+ * I/O, ...) takes its worker threads from a single shared pool, and the number of threads any one
+ * call uses is the smaller of the count it asks for (a `numThreads` argument or control field,
+ * where 0 means "as many as allowed") and the limits set here:
+ *
+ *  - setMaxNumThreads() caps all calls in the process.  Its initial value is taken from the
+ *    AFW_MAX_NUM_THREADS environment variable if that is set, or else is the number of hardware
+ *    threads.  A pipeline that runs one process per core should set it (or the environment
+ *    variable) to 1, which guarantees that afw never starts a thread of its own.
+ *  - an ExecutionContext lowers the cap further for calls made by the current thread while it
+ *    exists, without affecting other threads.
+ *
+ * Parallel calls made from within another parallel call always run serially, so nesting never
+ * multiplies the number of threads.
+ */
+
+namespace lsst {
+namespace afw {
+namespace math {
+
+/**
+ * Set the largest number of threads any parallel afw call may use, including the calling thread.
+ *
+ * @param maxNumThreads thread limit; 0 means one per hardware thread, and 1 makes all of afw serial
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if maxNumThreads < 0.
+ */
+void setMaxNumThreads(int maxNumThreads);
+
+/// Return the process-wide thread limit set by setMaxNumThreads (always >= 1)
+int getMaxNumThreads();
+
+/**
+ * Return the thread limit that applies to parallel calls made by the current thread.
+ *
+ * This is the process-wide limit, lowered by any active ExecutionContext on this thread, and 1 if
+ * this thread is itself running part of a parallel call.
+ */
+int getCurrentMaxNumThreads();
+
+/**
+ * Limit the threads used by parallel afw calls made from the current thread.
+ *
+ * The limit lasts for the lifetime of the object.  Contexts may be nested, but an inner context can
+ * only lower the limit, so code called from within a serial context stays serial; nor can a context
+ * raise the limit above getMaxNumThreads().
+ *
+ *     {
+ *         ExecutionContext serial(1);
+ *         convolve(out, in, kernel, control);  // runs on this thread only
+ *     }
+ */
+class ExecutionContext final {
+public:
+    /**
+     * Set the thread limit of the current thread.
+     *
+     * @param maxNumThreads thread limit; 0 means no limit beyond getMaxNumThreads()
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if maxNumThreads < 0.
+     */
+    explicit ExecutionContext(int maxNumThreads);
+
+    ExecutionContext(ExecutionContext const &) = delete;
+    ExecutionContext(ExecutionContext &&) = delete;
+    ExecutionContext &operator=(ExecutionContext const &) = delete;
+    ExecutionContext &operator=(ExecutionContext &&) = delete;
+
+    /// Restore the thread limit that was in effect when this object was created
+    ~ExecutionContext() noexcept;
+
+    /// Return the limit set by this context (0 for none)
+    int getMaxNumThreads() const noexcept { return _maxNumThreads; }
+
+private:
+    int _maxNumThreads;
+    int _previous;
+};
+
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_MATH_EXECUTIONCONTEXT_H
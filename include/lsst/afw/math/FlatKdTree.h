@@ -0,0 +1,163 @@
+// -*- LSST-C++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_MATH_FLATKDTREE_H
+#define LSST_AFW_MATH_FLATKDTREE_H
+
+#include <utility>
+#include <vector>
+
+#include "ndarray.h"
+
+namespace lsst {
+namespace afw {
+namespace math {
+
+/**
+ * A k-d tree over a fixed set of points, built in one pass and stored in flat arrays.
+ *
+ * The points are copied into one contiguous array, ordered so that every node of the tree covers a
+ * contiguous range of it.  Each node splits its range in half at the median of the dimension in which
+ * its points are most spread out, so the tree is balanced and its nodes are stored implicitly in
+ * breadth-first order (the children of node i are nodes 2i+1 and 2i+2); a node stores only its split
+ * dimension and value.  Leaves hold at most `leafSize` points, which are searched linearly.
+ *
+ * Unlike KdTree, points cannot be added or removed once the tree is built, but every query is const
+ * and keeps its search state local to the call, so queries may be made from several threads at once.
+ * Distances are Euclidean.
+ */
+template <typename T>
+class FlatKdTree final {
+public:
+    /**
+     * Build a tree over a set of points
+     *
+     * @param points the points to store; points[i][j] is the jth component of the ith point.  They
+     *               are copied.
+     * @param leafSize the maximum number of points in a leaf
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if there are no points, the points have
+     *         no dimensions, or leafSize < 1
+     */
+    explicit FlatKdTree(ndarray::Array<T const, 2, 1> const &points, int leafSize = 8);
+
+    FlatKdTree(FlatKdTree const &) = default;
+    FlatKdTree(FlatKdTree &&) = default;
+    FlatKdTree &operator=(FlatKdTree const &) = default;
+    FlatKdTree &operator=(FlatKdTree &&) = default;
+    ~FlatKdTree() noexcept = default;
+
+    /// Return the number of points in the tree
+    int size() const noexcept { return _indices.size(); }
+
+    /// Return the dimensionality of the points
+    int getDimensions() const noexcept { return _dimensions; }
+
+    /**
+     * Find the nearest neighbors of a point
+     *
+     * @param [out] indices the indices of the neighbors (rows of the array the tree was built from),
+     *              nearest first; its size is the number of neighbors to find
+     * @param [out] distances the distances to the neighbors, in the same order
+     * @param [in] point the point whose neighbors are wanted
+     *
+     * Points equally distant from `point` are ordered by index.
+     *
+     * @throws lsst::pex::exceptions::LengthError if `point` has the wrong dimensionality, `indices`
+     *         and `distances` differ in size, or more neighbors are requested than there are points
+     */
+    void findNeighbors(ndarray::Array<int, 1, 1> indices, ndarray::Array<double, 1, 1> distances,
+                       ndarray::Array<T const, 1, 1> const &point) const;
+
+    /**
+     * Find the nearest neighbors of many points
+     *
+     * @param [out] indices indices[i][j] is the index of the jth nearest neighbor of the ith query;
+     *              the number of columns is the number of neighbors to find
+     * @param [out] distances distances[i][j] is the distance to the jth nearest neighbor of the ith
+     *              query
+     * @param [in] queries the points whose neighbors are wanted, one per row
+     * @param [in] numThreads the number of threads to use; 0 means one per hardware thread
+     *
+     * @throws lsst::pex::exceptions::LengthError if the queries have the wrong dimensionality,
+     *         `indices` and `distances` differ in shape or do not have one row per query, or more
+     *         neighbors are requested than there are points
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
+     */
+    void findNeighbors(ndarray::Array<int, 2, 2> indices, ndarray::Array<double, 2, 2> distances,
+                       ndarray::Array<T const, 2, 1> const &queries, int numThreads = 1) const;
+
+    /**
+     * Find all of the points within a given distance of a point
+     *
+     * @param point the point whose neighborhood is searched
+     * @param radius the largest distance from `point` to include
+     *
+     * @returns the indices of the points no farther than `radius` from `point`, in increasing order
+     *
+     * @throws lsst::pex::exceptions::LengthError if `point` has the wrong dimensionality
+     */
+    std::vector<int> findWithinRadius(ndarray::Array<T const, 1, 1> const &point, double radius) const;
+
+    /**
+     * Find all of the points within a given distance of each of many points
+     *
+     * @param queries the points whose neighborhoods are searched, one per row
+     * @param radius the largest distance from a query to include
+     * @param numThreads the number of threads to use; 0 means one per hardware thread
+     *
+     * @returns one list per query of the indices of the points no farther than `radius` from it,
+     *          each in increasing order
+     *
+     * @throws lsst::pex::exceptions::LengthError if the queries have the wrong dimensionality
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
+     */
+    std::vector<std::vector<int>> findWithinRadius(ndarray::Array<T const, 2, 1> const &queries,
+                                                   double radius, int numThreads = 1) const;
+
+private:
+    // Search for the k nearest neighbors of point, writing them (nearest first) to indices and distances;
+    // heap is workspace, so that a thread making many queries allocates it only once
+    void _findNeighbors(T const *point, int k, std::vector<std::pair<double, int>> &heap, int *indices,
+                        double *distances) const;
+
+    // Search for the points within radius of point, returning them in increasing order of index
+    std::vector<int> _findWithinRadius(T const *point, double radius) const;
+
+    // Return the squared distance between point and the point in tree order slot
+    double _distanceSquared(T const *point, int slot) const;
+
+    int _dimensions;
+    int _depth;                   // number of levels of splitting nodes
+    std::vector<T> _points;       // the points in tree order, row-major
+    std::vector<int> _indices;    // _indices[slot] is the original index of the point in slot
+    std::vector<int> _splitDims;  // the split of node i is _points[*][_splitDims[i]] at _splitValues[i]
+    std::vector<T> _splitValues;
+};
+
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_MATH_FLATKDTREE_H
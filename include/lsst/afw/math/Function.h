@@ -33,6 +33,7 @@
 #include <vector>
 
 #include "boost/format.hpp"
+#include "ndarray.h"
 
 #include "lsst/pex/exceptions.h"
 
@@ -237,6 +238,17 @@ public:
 
     virtual ReturnT operator()(double x) const = 0;
 
+    /**
+     * Evaluate the function at many points
+     *
+     * @param[in] x array of x values
+     * @returns an array of the function values at x
+     *
+     * The default implementation calls operator() for each point; subclasses such as the polynomials
+     * in FunctionLibrary.h evaluate all the points together, which is much faster.
+     */
+    virtual ndarray::Array<ReturnT, 1, 1> evaluate(ndarray::Array<double const, 1> const& x) const;
+
     std::string toString(std::string const& prefix = "") const override {
         return std::string("Function1: ") + Function<ReturnT>::toString(prefix);
     }
@@ -296,6 +308,34 @@ public:
 
     virtual ReturnT operator()(double x, double y) const = 0;
 
+    /**
+     * Evaluate the function at many arbitrary points
+     *
+     * @param[in] x array of x values, the same size as y
+     * @param[in] y array of y values, the same size as x
+     * @returns an array of the function values at (x[i], y[i])
+     *
+     * The default implementation calls operator() for each point; subclasses such as the polynomials
+     * in FunctionLibrary.h evaluate all the points together, which is much faster.
+     *
+     * @throws lsst::pex::exceptions::LengthError if x and y differ in size
+     */
+    virtual ndarray::Array<ReturnT, 1, 1> evaluate(ndarray::Array<double const, 1> const& x,
+                                                   ndarray::Array<double const, 1> const& y) const;
+
+    /**
+     * Evaluate the function on a grid of points
+     *
+     * @param[in] x array of x values of the grid columns
+     * @param[in] y array of y values of the grid rows
+     * @returns an array of shape (y.size, x.size) whose [i][j] element is the function at (x[j], y[i])
+     *
+     * The default implementation calls operator() for each point, a row at a time; the polynomials
+     * in FunctionLibrary.h reduce each row to a polynomial in x and evaluate that across the row.
+     */
+    virtual ndarray::Array<ReturnT, 2, 2> evaluateGrid(ndarray::Array<double const, 1> const& x,
+                                                       ndarray::Array<double const, 1> const& y) const;
+
     std::string toString(std::string const& prefix = "") const override {
         return std::string("Function2: ") + Function<ReturnT>::toString(prefix);
     }
@@ -412,6 +412,9 @@ public:
         return static_cast<ReturnT>(retVal);
     }
 
+    /// Evaluate the polynomial at all the points at once, by Horner's method
+    ndarray::Array<ReturnT, 1, 1> evaluate(ndarray::Array<double const, 1> const& x) const override;
+
     /**
      * Get the polynomial order
      */
@@ -531,6 +534,20 @@ public:
         return static_cast<ReturnT>(retVal);
     }
 
+    /**
+     * Evaluate the polynomial at many points, by nested Horner recurrences in y and x that run
+     * across all the points at once
+     */
+    ndarray::Array<ReturnT, 1, 1> evaluate(ndarray::Array<double const, 1> const& x,
+                                           ndarray::Array<double const, 1> const& y) const override;
+
+    /**
+     * Evaluate the polynomial on a grid, by reducing it to a polynomial in x for each row and
+     * evaluating that across the row
+     */
+    ndarray::Array<ReturnT, 2, 2> evaluateGrid(ndarray::Array<double const, 1> const& x,
+                                               ndarray::Array<double const, 1> const& y) const override;
+
     /**
      * Return the coefficients of the Function's parameters, evaluated at (x, y)
      * I.e. given c0, c1, c2, c3 ... return 1, x, y, x^2 ...
@@ -657,6 +674,9 @@ public:
         return (xPrime * csh) + this->_params[0] - cshPrev;
     }
 
+    /// Evaluate the polynomial at all the points at once, by Clenshaw's recurrence
+    ndarray::Array<ReturnT, 1, 1> evaluate(ndarray::Array<double const, 1> const& x) const override;
+
     std::string toString(std::string const& prefix) const override {
         std::ostringstream os;
         os << "Chebyshev1Function1 [" << _minX << ", " << _maxX << "]: ";
@@ -850,6 +870,20 @@ public:
         return (xPrime * csh) + _xCoeffs[0] - cshPrev;
     }
 
+    /**
+     * Evaluate the polynomial at many points, by nested Clenshaw recurrences in y and x that run
+     * across all the points at once
+     */
+    ndarray::Array<ReturnT, 1, 1> evaluate(ndarray::Array<double const, 1> const& x,
+                                           ndarray::Array<double const, 1> const& y) const override;
+
+    /**
+     * Evaluate the polynomial on a grid, by reducing it to a Chebyshev series in x for each row and
+     * evaluating that across the row
+     */
+    ndarray::Array<ReturnT, 2, 2> evaluateGrid(ndarray::Array<double const, 1> const& x,
+                                               ndarray::Array<double const, 1> const& y) const override;
+
     std::string toString(std::string const& prefix) const override {
         std::ostringstream os;
         os << "Chebyshev1Function2 [";
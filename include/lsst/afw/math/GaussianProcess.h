@@ -149,6 +149,22 @@ public:
      */
     virtual T operator()(ndarray::Array<const T, 1, 1> const &p1,
                          ndarray::Array<const T, 1, 1> const &p2) const;
+
+    /**
+     * Evaluate the covariogram function relating one point to each of many others
+     *
+     * @param [out] result will contain the covariogram between `point` and each row of `points`
+     *
+     * @param [in] point the point
+     *
+     * @param [in] points the other points; points[i][j] is the jth component of the ith point
+     *
+     * The default implementation calls operator() once per row of `points`; subclasses override it
+     * to evaluate all of the rows at once.  GaussianProcess may call this from several threads at
+     * once, so it must not modify the Covariogram.
+     */
+    virtual void evaluate(ndarray::Array<T, 1, 1> result, ndarray::Array<const T, 1, 1> const &point,
+                          ndarray::Array<const T, 2, 2> const &points) const;
 };
 
 /**
@@ -175,6 +191,9 @@ public:
 
     T operator()(ndarray::Array<const T, 1, 1> const &, ndarray::Array<const T, 1, 1> const &) const override;
 
+    void evaluate(ndarray::Array<T, 1, 1> result, ndarray::Array<const T, 1, 1> const &point,
+                  ndarray::Array<const T, 2, 2> const &points) const override;
+
 private:
     double _ellSquared;
 };
@@ -208,6 +227,9 @@ public:
 
     T operator()(ndarray::Array<const T, 1, 1> const &, ndarray::Array<const T, 1, 1> const &) const override;
 
+    void evaluate(ndarray::Array<T, 1, 1> result, ndarray::Array<const T, 1, 1> const &point,
+                  ndarray::Array<const T, 2, 2> const &points) const override;
+
 private:
     double _sigma0, _sigma1;
 };
@@ -258,6 +280,9 @@ public:
      * neighbors will be returned in ascending order of distance
      *
      * note that distance is forced to be the Euclidean distance
+     *
+     * The search keeps its state in the output arrays, so several threads may search the same tree
+     * at once, provided that each passes its own arrays and that the tree is not modified meanwhile.
      */
     void findNeighbors(ndarray::Array<int, 1, 1> neighdex, ndarray::Array<double, 1, 1> dd,
                        ndarray::Array<const T, 1, 1> const &v, int n_nn) const;
@@ -348,14 +373,27 @@ private:
     //_data actually stores the data points
 
     int _npts, _dimensions, _room, _roomStep, _masterParent;
-    mutable int _neighborsFound, _neighborsWanted;
 
     //_room denotes the capacity of _data and _tree.  It will usually be larger
     // than _npts so that we do not have to reallocate
     //_tree and _data every time we add a new point to the tree
 
-    mutable ndarray::Array<double, 1, 1> _neighborDistances;
-    mutable ndarray::Array<int, 1, 1> _neighborCandidates;
+    // The state of one nearest neighbor search
+    struct NeighborSearch {
+        T const *point;     // the point whose neighbors are wanted
+        int wanted;         // the number of neighbors wanted
+        int found;          // the number of neighbors found so far
+        double *distances;  // the distances to the neighbors found, in ascending order
+        int *candidates;    // the indices of the neighbors found
+    };
+
+    // Return a pointer to the ipt-th data point; unlike _data[ipt], this is safe to call concurrently
+    T const *_point(int ipt) const { return _data.getData() + ipt * _data.template getStride<0>(); }
+
+    // Return _tree[ipt][field]; unlike _tree[ipt][field], this is safe to call concurrently
+    int _node(int ipt, int field) const {
+        return _tree.getData()[ipt * _tree.template getStride<0>() + field];
+    }
 
     /**
      * Find the daughter point of a node in the tree and segregate the points around it
@@ -382,19 +420,15 @@ private:
      * @brief This method actually looks for the neighbors, determining whether or
      * not to descend branches of the tree
      *
-     * @param [in] v the point whose neighbors you are looking for
+     * @param [in,out] search the point whose neighbors you are looking for, and the neighbors
+     *  found so far
      *
      * @param [in] consider the index of the data point you are considering as a possible nearest neighbor
      *
      * @param [in] from the index of the point you last considered as a nearest neighbor
      *  (so the search does not backtrack along the tree)
-     *
-     * The class KdTree keeps track of how many neighbors you want and how many
-     * neighbors you have found and what their distances from v are in the class member
-     * variables _neighborsWanted, _neighborsFound, _neighborCandidates,
-     * and _neighborDistances
      */
-    void _lookForNeighbors(ndarray::Array<const T, 1, 1> const &v, int consider, int from) const;
+    void _lookForNeighbors(NeighborSearch &search, int consider, int from) const;
 
     /**
      * Make sure that the tree is properly constructed.  Returns 1 of it is.  Return zero if not.
@@ -443,7 +477,7 @@ private:
     /**
      * calculate the Euclidean distance between the points p1 and p2
      */
-    double _distance(ndarray::Array<const T, 1, 1> const &p1, ndarray::Array<const T, 1, 1> const &p2) const;
+    double _distance(T const *p1, T const *p2) const;
 };
 
 /**
@@ -659,6 +693,47 @@ public:
     void selfInterpolate(ndarray::Array<T, 1, 1> mu, ndarray::Array<T, 1, 1> variance, int dex,
                          int numberOfNeighbors) const;
 
+    /**
+     * Self interpolate many data points at once, for purposes of optimizing hyper parameters
+     *
+     * @param [out] mu the interpolated function values will be stored here; mu[i] is the value at
+     * the data point indices[i]
+     *
+     * @param [out] variance the variances on mu will be stored here
+     *
+     * @param [in] indices the indices of the points you wish to self interpolate
+     *
+     * @param [in] numberOfNeighbors the number of nearest neighbors to use in each interpolation
+     *
+     * @throws pex::exceptions::RuntimeError if you are interpolating more than one function, if
+     * mu or variance is not the size of indices, if an index does not exist, or if the nearest
+     * neighbor search does not find a data point itself as its nearest neighbor
+     *
+     * The results are those of calling selfInterpolate on each point in turn, but the points are
+     * divided among getNumThreads() threads, each with its own neighbor search and covariance workspace.
+     */
+    void batchSelfInterpolate(ndarray::Array<T, 1, 1> mu, ndarray::Array<T, 1, 1> variance,
+                              ndarray::Array<int, 1, 1> const &indices, int numberOfNeighbors) const;
+
+    /**
+     * This is the version of batchSelfInterpolate that is called for a vector of functions
+     *
+     * @param [out] mu the interpolated function values will be stored here; mu[i][j] is the value
+     * of the jth function at the data point indices[i]
+     *
+     * @param [out] variance the variances on mu will be stored here
+     *
+     * @param [in] indices the indices of the points you wish to self interpolate
+     *
+     * @param [in] numberOfNeighbors the number of nearest neighbors to use in each interpolation
+     *
+     * @throws pex::exceptions::RuntimeError if mu or variance does not have one row per index and
+     * one column per function, if an index does not exist, or if the nearest neighbor search does
+     * not find a data point itself as its nearest neighbor
+     */
+    void batchSelfInterpolate(ndarray::Array<T, 2, 2> mu, ndarray::Array<T, 2, 2> variance,
+                              ndarray::Array<int, 1, 1> const &indices, int numberOfNeighbors) const;
+
     /**
      * Interpolate a list of query points using all of the input data (rather than nearest neighbors)
      *
@@ -673,6 +748,8 @@ public:
      * This method will attempt to construct a _npts X _npts covariance matrix C and solve the problem Cx=b.
      * Be wary of using it in the case where _npts is very large.
      *
+     * The query points are divided among getNumThreads() threads, each with its own workspace.
+     *
      * This version of the method will also return variances for all of the query points.
      * That is a very time consuming calculation relative to just returning estimates for
      * the function.  Consider calling the version of this method that does not calculate
@@ -695,6 +772,8 @@ public:
      * This method will attempt to construct a _npts X _npts covariance matrix C and solve the problem Cx=b.
      * Be wary of using it in the case where _npts is very large.
      *
+     * The query points are divided among getNumThreads() threads, each with its own workspace.
+     *
      * This version of the method does not return variances.
      * It is an order of magnitude faster than the version of the method
      * that does return variances (timing done on a case with 189 data points and 1 million query points).
@@ -786,6 +865,45 @@ public:
      */
     void setLambda(T lambda);
 
+    /**
+     * Set the number of threads used by batchInterpolate and batchSelfInterpolate
+     *
+     * @param [in] numThreads the number of threads; 0 means one per hardware thread
+     *
+     * @throws pex::exceptions::InvalidParameterError if numThreads is negative
+     *
+     * The covariogram is evaluated concurrently when this is not 1, so it must be safe to call from
+     * several threads at once (as are all of the Covariograms provided here).
+     */
+    void setNumThreads(int numThreads);
+
+    /**
+     * Return the number of threads used by batchInterpolate and batchSelfInterpolate;
+     * 0 means one per hardware thread
+     */
+    int getNumThreads() const noexcept { return _numThreads; }
+
+    /**
+     * Set the rank of the low-rank approximation used by batchInterpolate
+     *
+     * @param [in] rank the number of inducing points; 0 (the default) means no approximation
+     *
+     * @throws pex::exceptions::InvalidParameterError if rank is negative
+     *
+     * If rank is positive and smaller than the number of data points, batchInterpolate uses the
+     * fully independent training conditional (FITC) approximation: the covariances are expressed
+     * through `rank` inducing points, chosen from the data by farthest-point sampling so that they
+     * cover it evenly.  Memory then scales as rank^2 rather than as the square of the number of data
+     * points, and time as rank^2 per data point and per query point.  Larger ranks are slower but
+     * more accurate; the approximation becomes exact as rank approaches the number of data points.
+     */
+    void setApproximationRank(int rank);
+
+    /**
+     * Return the rank of the low-rank approximation used by batchInterpolate; 0 means no approximation
+     */
+    int getApproximationRank() const noexcept { return _approximationRank; }
+
     /**
      * @brief Give the user acces to _timer, an object keeping track of the time spent on
      * various processes within interpolate
@@ -803,7 +921,28 @@ public:
     GaussianProcessTimer &getTimes() const;
 
 private:
+    /*
+     * The implementation of batchInterpolate
+     *
+     * mu and variance point to row-major nQueries x _nFunctions outputs; if variance is null, no
+     * variances are computed.
+     */
+    void _batchInterpolate(T *mu, T *variance, ndarray::Array<T, 2, 2> const &queries) const;
+
+    // The implementation of batchInterpolate using the FITC approximation; arguments as above
+    void _batchInterpolateApproximate(T *mu, T *variance, ndarray::Array<T, 2, 2> const &queries) const;
+
+    /*
+     * The implementation of batchSelfInterpolate
+     *
+     * mu and variance point to row-major nIndices x _nFunctions outputs.
+     */
+    void _batchSelfInterpolate(T *mu, T *variance, ndarray::Array<int, 1, 1> const &indices,
+                               int numberOfNeighbors) const;
+
     int _npts, _useMaxMin, _dimensions, _room, _roomStep, _nFunctions;
+    int _numThreads = 1;
+    int _approximationRank = 0;
 
     T _krigingParameter, _lambda;
 
@@ -0,0 +1,376 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_MATH_INSTRUMENTATION_H
+#define LSST_AFW_MATH_INSTRUMENTATION_H
+
+/*
+ * Named counters and cumulative timers for afw's hot paths.
+ *
+ * The primitives that dominate pipeline run time (convolution, warping, FITS I/O, archive reads,
+ * PSF image caching and image statistics) each update a counter, so that the time a task spends
+ * in them can be attributed without a profiler:
+ *
+ *     setInstrumentationEnabled(true);
+ *     ...
+ *     for (auto const & [name, record] : getInstrumentationSnapshot()) { ... }
+ *
+ * Counters cost a single relaxed atomic load per call while instrumentation is disabled at run time
+ * (the default), and nothing at all if afw is compiled with LSST_AFW_INSTRUMENTATION=0.
+ *
+ * Memory counters likewise track the bytes held, and their high-water mark, by category: image pixel
+ * buffers ("image.pixels"), table record blocks ("table.Block") and SpanSets ("geom.SpanSet"), with
+ * the allocations made while reading or writing archives ("table.io.archive") and filling the PSF
+ * image cache ("detection.Psf.cache") charged to those categories instead (see MemoryScope):
+ *
+ *     for (auto const & [name, record] : getMemorySnapshot()) { ... }
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <utility>
+
+#ifndef LSST_AFW_INSTRUMENTATION
+#define LSST_AFW_INSTRUMENTATION 1
+#endif
+
+namespace lsst {
+namespace afw {
+namespace math {
+
+/// The accumulated value of an InstrumentationCounter
+struct InstrumentationRecord {
+    std::uint64_t count = 0;  ///< Number of calls (or events) recorded
+    double time = 0.0;        ///< Total elapsed wall-clock time of the timed calls, in seconds
+};
+
+namespace detail {
+extern std::atomic<bool> instrumentationEnabled;
+}  // namespace detail
+
+/// Return whether instrumentation counters are currently being updated
+inline bool isInstrumentationEnabled() noexcept {
+    return detail::instrumentationEnabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * Start or stop updating the instrumentation counters.
+ *
+ * The counters keep their values while instrumentation is disabled; use resetInstrumentation to zero
+ * them.  Has no effect if afw was compiled with LSST_AFW_INSTRUMENTATION=0.
+ */
+void setInstrumentationEnabled(bool enabled) noexcept;
+
+/**
+ * A named, thread-safe count of calls and their cumulative elapsed time.
+ *
+ * Counters are owned by a process-wide registry; obtain one with getInstrumentationCounter.  Timed
+ * calls that nest (e.g. a warp that convolves) are each charged their full, inclusive time.
+ */
+class InstrumentationCounter {
+public:
+    explicit InstrumentationCounter(std::string const &name) : _name(name), _count(0), _nanoseconds(0) {}
+
+    InstrumentationCounter(InstrumentationCounter const &) = delete;
+    InstrumentationCounter(InstrumentationCounter &&) = delete;
+    InstrumentationCounter &operator=(InstrumentationCounter const &) = delete;
+    InstrumentationCounter &operator=(InstrumentationCounter &&) = delete;
+    ~InstrumentationCounter() = default;
+
+    /// Record `n` events, if instrumentation is enabled
+    void add(std::uint64_t n = 1) noexcept {
+        if (isInstrumentationEnabled()) {
+            _count.fetch_add(n, std::memory_order_relaxed);
+        }
+    }
+
+    /// Record one call that took `elapsed`, regardless of whether instrumentation is enabled
+    void addCall(std::chrono::nanoseconds elapsed) noexcept {
+        _count.fetch_add(1, std::memory_order_relaxed);
+        _nanoseconds.fetch_add(elapsed.count(), std::memory_order_relaxed);
+    }
+
+    std::string const &getName() const noexcept { return _name; }
+
+    /// Return the current count and time
+    InstrumentationRecord get() const noexcept;
+
+    /// Set the count and time to zero
+    void reset() noexcept;
+
+private:
+    std::string const _name;
+    std::atomic<std::uint64_t> _count;
+    std::atomic<std::uint64_t> _nanoseconds;
+};
+
+/**
+ * Return the counter with the given name, creating it if necessary.
+ *
+ * The reference remains valid for the life of the process, so callers should look a counter up once
+ * (e.g. into a function-local static) rather than by name on every call.
+ */
+InstrumentationCounter &getInstrumentationCounter(std::string const &name);
+
+/// Return the values of all counters that have been created, keyed by name
+std::map<std::string, InstrumentationRecord> getInstrumentationSnapshot();
+
+/// Set all counters to zero, and start a new peak for all memory counters (see resetMemoryPeaks)
+void resetInstrumentation();
+
+/**
+ * Charge the lifetime of a scope to an InstrumentationCounter.
+ *
+ * The clock is only read if instrumentation is enabled when the timer is constructed.
+ */
+class InstrumentationTimer {
+public:
+    explicit InstrumentationTimer(InstrumentationCounter &counter) noexcept
+            : _counter(counter), _active(isInstrumentationEnabled()) {
+        if (_active) {
+            _start = std::chrono::steady_clock::now();
+        }
+    }
+
+    InstrumentationTimer(InstrumentationTimer const &) = delete;
+    InstrumentationTimer(InstrumentationTimer &&) = delete;
+    InstrumentationTimer &operator=(InstrumentationTimer const &) = delete;
+    InstrumentationTimer &operator=(InstrumentationTimer &&) = delete;
+
+    ~InstrumentationTimer() noexcept {
+        if (_active) {
+            _counter.addCall(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - _start));
+        }
+    }
+
+private:
+    InstrumentationCounter &_counter;
+    bool _active;
+    std::chrono::steady_clock::time_point _start;
+};
+
+/// The accumulated value of a MemoryCounter
+struct MemoryRecord {
+    std::int64_t current = 0;       ///< Bytes currently held
+    std::int64_t peak = 0;          ///< Greatest number of bytes held since the peak was last reset
+    std::uint64_t allocations = 0;  ///< Number of allocations since the peak was last reset
+};
+
+/**
+ * A named, thread-safe count of the bytes held by one category of allocations.
+ *
+ * Like InstrumentationCounter, memory counters are owned by a process-wide registry; obtain one with
+ * getMemoryCounter.  Allocations are normally charged through a MemoryCharge, which only charges
+ * them while instrumentation is enabled, so that every charge is matched by its release.
+ */
+class MemoryCounter {
+public:
+    explicit MemoryCounter(std::string const &name) : _name(name), _current(0), _peak(0), _allocations(0) {}
+
+    MemoryCounter(MemoryCounter const &) = delete;
+    MemoryCounter(MemoryCounter &&) = delete;
+    MemoryCounter &operator=(MemoryCounter const &) = delete;
+    MemoryCounter &operator=(MemoryCounter &&) = delete;
+    ~MemoryCounter() = default;
+
+    /// Record the allocation of `bytes`, regardless of whether instrumentation is enabled
+    void allocate(std::size_t bytes) noexcept;
+
+    /// Record the release of `bytes` recorded earlier by allocate
+    void deallocate(std::size_t bytes) noexcept {
+        _current.fetch_sub(static_cast<std::int64_t>(bytes), std::memory_order_relaxed);
+    }
+
+    std::string const &getName() const noexcept { return _name; }
+
+    /// Return the bytes held, their peak and the number of allocations
+    MemoryRecord get() const noexcept;
+
+    /// Set the peak to the bytes currently held, and the number of allocations to zero
+    void resetPeak() noexcept;
+
+private:
+    std::string const _name;
+    std::atomic<std::int64_t> _current;
+    std::atomic<std::int64_t> _peak;
+    std::atomic<std::uint64_t> _allocations;
+};
+
+/**
+ * Return the memory counter with the given name, creating it if necessary.
+ *
+ * As with getInstrumentationCounter, the reference remains valid for the life of the process.
+ */
+MemoryCounter &getMemoryCounter(std::string const &name);
+
+/// Return the values of all memory counters that have been created, keyed by name
+std::map<std::string, MemoryRecord> getMemorySnapshot();
+
+/**
+ * Start a new peak for all memory counters.
+ *
+ * The bytes currently held cannot be reset, as they are still to be released; resetInstrumentation
+ * also calls this.
+ */
+void resetMemoryPeaks();
+
+namespace detail {
+
+/// Return the counter of the innermost MemoryScope on this thread, or null if there is none
+MemoryCounter *getMemoryScopeCounter() noexcept;
+
+/// Make `counter` that of the innermost MemoryScope on this thread, returning the one it replaces
+MemoryCounter *setMemoryScopeCounter(MemoryCounter *counter) noexcept;
+
+}  // namespace detail
+
+/**
+ * The charge of one allocation to a MemoryCounter, released when the charge is destroyed.
+ *
+ * The charge is only made if instrumentation is enabled when it is constructed, and is then made to
+ * the counter of the innermost MemoryScope on this thread, if any, rather than to `counter`.
+ * Copying a charge charges the same counter again, for the copy of the memory it accounts for.
+ */
+class MemoryCharge {
+public:
+    MemoryCharge() noexcept : _counter(nullptr), _bytes(0) {}
+
+    MemoryCharge(MemoryCounter &counter, std::size_t bytes) noexcept : _counter(nullptr), _bytes(bytes) {
+        if (LSST_AFW_INSTRUMENTATION && isInstrumentationEnabled()) {
+            MemoryCounter *scopeCounter = detail::getMemoryScopeCounter();
+            _counter = scopeCounter ? scopeCounter : &counter;
+            _counter->allocate(_bytes);
+        }
+    }
+
+    MemoryCharge(MemoryCharge const &other) noexcept : _counter(other._counter), _bytes(other._bytes) {
+        if (_counter) {
+            _counter->allocate(_bytes);
+        }
+    }
+
+    MemoryCharge(MemoryCharge &&other) noexcept : _counter(other._counter), _bytes(other._bytes) {
+        other._counter = nullptr;
+    }
+
+    MemoryCharge &operator=(MemoryCharge const &other) noexcept {
+        if (this != &other) {
+            MemoryCharge copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    MemoryCharge &operator=(MemoryCharge &&other) noexcept {
+        MemoryCharge moved(std::move(other));
+        swap(moved);
+        return *this;
+    }
+
+    ~MemoryCharge() noexcept {
+        if (_counter) {
+            _counter->deallocate(_bytes);
+        }
+    }
+
+    void swap(MemoryCharge &other) noexcept {
+        std::swap(_counter, other._counter);
+        std::swap(_bytes, other._bytes);
+    }
+
+private:
+    MemoryCounter *_counter;  // null if nothing was charged
+    std::size_t _bytes;
+};
+
+/**
+ * Charge the memory allocated by this thread during the lifetime of a scope to a MemoryCounter.
+ *
+ * This attributes memory to what it is for rather than to what holds it, e.g. the images of a cache.
+ * Scopes nest, with the innermost taking precedence.
+ */
+class MemoryScope {
+public:
+    explicit MemoryScope(MemoryCounter &counter) noexcept
+            : _previous(detail::setMemoryScopeCounter(&counter)) {}
+
+    MemoryScope(MemoryScope const &) = delete;
+    MemoryScope(MemoryScope &&) = delete;
+    MemoryScope &operator=(MemoryScope const &) = delete;
+    MemoryScope &operator=(MemoryScope &&) = delete;
+
+    ~MemoryScope() noexcept { detail::setMemoryScopeCounter(_previous); }
+
+private:
+    MemoryCounter *_previous;
+};
+
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
+
+#define LSST_AFW_INSTRUMENT_CONCAT_IMPL(a, b) a##b
+#define LSST_AFW_INSTRUMENT_CONCAT(a, b) LSST_AFW_INSTRUMENT_CONCAT_IMPL(a, b)
+
+#if LSST_AFW_INSTRUMENTATION
+
+/// Time the rest of the enclosing scope with the counter called `name` (a string literal)
+#define LSST_AFW_INSTRUMENT_SCOPE(name)                                                                 \
+    static ::lsst::afw::math::InstrumentationCounter &LSST_AFW_INSTRUMENT_CONCAT(afwInstrumentCounter, \
+                                                                                 __LINE__) =           \
+            ::lsst::afw::math::getInstrumentationCounter(name);                                          \
+    ::lsst::afw::math::InstrumentationTimer LSST_AFW_INSTRUMENT_CONCAT(afwInstrumentTimer, __LINE__)(   \
+            LSST_AFW_INSTRUMENT_CONCAT(afwInstrumentCounter, __LINE__))
+
+/// Add `n` events to the counter called `name` (a string literal)
+#define LSST_AFW_INSTRUMENT_COUNT(name, n)                                                               \
+    do {                                                                                                 \
+        static ::lsst::afw::math::InstrumentationCounter &afwInstrumentCounter =                        \
+                ::lsst::afw::math::getInstrumentationCounter(name);                                      \
+        afwInstrumentCounter.add(n);                                                                     \
+    } while (false)
+
+/// Charge the memory allocated in the rest of the enclosing scope to the memory counter called `name`
+#define LSST_AFW_MEMORY_SCOPE(name)                                                                  \
+    static ::lsst::afw::math::MemoryCounter &LSST_AFW_INSTRUMENT_CONCAT(afwMemoryCounter, __LINE__) = \
+            ::lsst::afw::math::getMemoryCounter(name);                                               \
+    ::lsst::afw::math::MemoryScope LSST_AFW_INSTRUMENT_CONCAT(afwMemoryScope, __LINE__)(             \
+            LSST_AFW_INSTRUMENT_CONCAT(afwMemoryCounter, __LINE__))
+
+#else
+
+#define LSST_AFW_INSTRUMENT_SCOPE(name) static_assert(true, "")
+#define LSST_AFW_INSTRUMENT_COUNT(name, n) \
+    do {                                   \
+    } while (false)
+#define LSST_AFW_MEMORY_SCOPE(name) static_assert(true, "")
+
+#endif
+
+#endif  // LSST_AFW_MATH_INSTRUMENTATION_H
@@ -39,11 +39,14 @@
 #include <queue>
 #include <sstream>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "lsst/pex/exceptions.h"
 
 #include "lsst/afw/math/IntGKPData10.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 // == The following is based on Mike Jarvis original comment ==
 //
@@ -128,6 +131,28 @@
 //
 // (It is intended to be an overestimate of the actual error,
 // but it doesn't always get it completely right.)
+//
+//
+//
+// Batched Integrands:
+//
+// The integrators evaluate the integrand at all the nodes of a
+// Gauss-Kronrod-Patterson rule before using any of the values, so a
+// function that can be evaluated efficiently on many points at once
+// (e.g. with vectorized arithmetic, or by interpolating a tabulated curve
+// in one pass) can be given all of them in one call.  Wrap such a function
+// with makeBatchIntegrand; it must set f[i] = f(x[i]) for every node:
+//
+// auto gauss = lsst::afw::math::makeBatchIntegrand(
+//         [](std::vector<double> const &x, std::vector<double> &f) {
+//             for (std::size_t i = 0; i < x.size(); ++i) {
+//                 f[i] = std::exp(-0.5 * x[i] * x[i]);
+//             }
+//         });
+// double integ3 = lsst::afw::math::integrate(gauss, -1., 1.);
+//
+// For integrate2d, a batched integrand is called as func(x, y, f), with
+// all the nodes x of the inner (x) integral at a fixed y.
 
 
 namespace lsst {
@@ -238,8 +263,97 @@ private:
 double const DEFABSERR = 1.e-15;
 double const DEFRELERR = 1.e-6;
 
+/**
+ * An integrand that is evaluated on all the nodes of a quadrature rule at once
+ *
+ * The wrapped function is called as `func(x, f)` (or `func(x, y, f)` as the integrand of
+ * integrate2d), where `x` is a `std::vector` of abscissae and `f` a `std::vector` of the same
+ * size, whose elements it must set to the integrand at the corresponding abscissae.
+ * Use makeBatchIntegrand to construct one.
+ */
+template <typename BatchFunctionT>
+class BatchIntegrand final {
+public:
+    explicit BatchIntegrand(BatchFunctionT func) : _func(std::move(func)) {}
+
+    template <typename... Args>
+    void operator()(Args &&... args) const {
+        _func(std::forward<Args>(args)...);
+    }
+
+private:
+    BatchFunctionT _func;
+};
+
+/**
+ * Wrap a function that evaluates an integrand on many points at once, for use with
+ * int1d, integrate and integrate2d
+ */
+template <typename BatchFunctionT>
+inline BatchIntegrand<BatchFunctionT> makeBatchIntegrand(BatchFunctionT func) {
+    return BatchIntegrand<BatchFunctionT>(std::move(func));
+}
+
 namespace details {
 
+template <typename UnaryFunctionT>
+struct AuxFunc1;
+template <typename UnaryFunctionT>
+struct AuxFunc2;
+
+template <typename T>
+struct IsBatchIntegrand : std::false_type {};
+template <typename BatchFunctionT>
+struct IsBatchIntegrand<BatchIntegrand<BatchFunctionT>> : std::true_type {};
+
+/**
+ * Set f[i] = func(x[i]) for all i
+ *
+ * A BatchIntegrand is called once for all the points; any other function is called on each point
+ * in order.
+ */
+template <typename UnaryFunctionT, typename Arg>
+inline void evaluateNodes(UnaryFunctionT &func, std::vector<Arg> const &x, std::vector<Arg> &f) {
+    f.resize(x.size());
+    if constexpr (IsBatchIntegrand<std::remove_const_t<UnaryFunctionT>>::value) {
+        func(x, f);
+    } else {
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            f[i] = func(x[i]);
+        }
+    }
+}
+
+/**
+ * Evaluate the change of variables of AuxFunc1 by evaluating its integrand on all the nodes at once
+ */
+template <typename UnaryFunctionT, typename Arg>
+inline void evaluateNodes(AuxFunc1<UnaryFunctionT> &func, std::vector<Arg> const &x, std::vector<Arg> &f) {
+    std::vector<Arg> t(x.size());
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        t[i] = 1.0 / x[i] - 1.0;
+    }
+    evaluateNodes(func.getFunction(), t, f);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        f[i] /= (x[i] * x[i]);
+    }
+}
+
+/**
+ * Evaluate the change of variables of AuxFunc2 by evaluating its integrand on all the nodes at once
+ */
+template <typename UnaryFunctionT, typename Arg>
+inline void evaluateNodes(AuxFunc2<UnaryFunctionT> &func, std::vector<Arg> const &x, std::vector<Arg> &f) {
+    std::vector<Arg> t(x.size());
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        t[i] = 1.0 / x[i] + 1.0;
+    }
+    evaluateNodes(func.getFunction(), t, f);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        f[i] /= (x[i] * x[i]);
+    }
+}
+
 template <class T>
 inline T Epsilon() {
     return std::numeric_limits<T>::epsilon();
@@ -304,7 +418,19 @@ inline bool intGKPNA(UnaryFunctionT func, IntRegion<Arg> &reg,
     Arg const halfLength = 0.5 * (b - a);
     Arg const absHalfLength = fabs(halfLength);
     Arg const center = 0.5 * (b + a);
-    Arg const fCenter = func(center);
+
+    // The nodes of each level are evaluated together: the center first (level 0 only),
+    // then the pairs (center - abscissa, center + abscissa) in order.
+    std::vector<Arg> xv, fv;
+    xv.reserve(2 * gkp_x<Arg>(NGKPLEVELS - 1).size() + 1);
+    xv.push_back(center);
+    for (size_t k = 0; k < gkp_x<Arg>(0).size(); k++) {
+        Arg const abscissa = halfLength * gkp_x<Arg>(0)[k];
+        xv.push_back(center - abscissa);
+        xv.push_back(center + abscissa);
+    }
+    evaluateNodes(func, xv, fv);
+    Arg const fCenter = fv[0];
 #ifdef COUNTFEVAL
     nfeval++;
 #endif
@@ -315,15 +441,14 @@ inline bool intGKPNA(UnaryFunctionT func, IntRegion<Arg> &reg,
     fv1.reserve(2 * gkp_x<Arg>(0).size() + 1);
     fv2.reserve(2 * gkp_x<Arg>(0).size() + 1);
     for (size_t k = 0; k < gkp_x<Arg>(0).size(); k++) {
-        Arg const abscissa = halfLength * gkp_x<Arg>(0)[k];
-        Arg const fval1 = func(center - abscissa);
-        Arg const fval2 = func(center + abscissa);
+        Arg const fval1 = fv[2 * k + 1];
+        Arg const fval2 = fv[2 * k + 2];
         area1 += gkp_wb<Arg>(0)[k] * (fval1 + fval2);
         fv1.push_back(fval1);
         fv2.push_back(fval2);
         if (fxmap) {
-            (*fxmap)[center - abscissa] = fval1;
-            (*fxmap)[center + abscissa] = fval2;
+            (*fxmap)[xv[2 * k + 1]] = fval1;
+            (*fxmap)[xv[2 * k + 2]] = fval2;
         }
     }
 #ifdef COUNTFEVAL
@@ -350,10 +475,16 @@ inline bool intGKPNA(UnaryFunctionT func, IntRegion<Arg> &reg,
                 resabs += gkp_wa<Arg>(level)[k] * (fabs(fv1[k]) + fabs(fv2[k]));
             }
         }
+        xv.clear();
         for (size_t k = 0; k < gkp_x<Arg>(level).size(); k++) {
             Arg const abscissa = halfLength * gkp_x<Arg>(level)[k];
-            Arg const fval1 = func(center - abscissa);
-            Arg const fval2 = func(center + abscissa);
+            xv.push_back(center - abscissa);
+            xv.push_back(center + abscissa);
+        }
+        evaluateNodes(func, xv, fv);
+        for (size_t k = 0; k < gkp_x<Arg>(level).size(); k++) {
+            Arg const fval1 = fv[2 * k];
+            Arg const fval2 = fv[2 * k + 1];
             Arg const fval = fval1 + fval2;
             area2 += gkp_wb<Arg>(level)[k] * fval;
             if (calcabsasc) {
@@ -362,8 +493,8 @@ inline bool intGKPNA(UnaryFunctionT func, IntRegion<Arg> &reg,
             fv1.push_back(fval1);
             fv2.push_back(fval2);
             if (fxmap) {
-                (*fxmap)[center - abscissa] = fval1;
-                (*fxmap)[center + abscissa] = fval2;
+                (*fxmap)[xv[2 * k]] = fval1;
+                (*fxmap)[xv[2 * k + 1]] = fval2;
             }
         }
 #ifdef COUNTFEVAL
@@ -571,6 +702,7 @@ template <typename UnaryFunctionT>
 struct AuxFunc1 { // f(1/x-1) for int(a..infinity)
 public:
     AuxFunc1(UnaryFunctionT const &f) : _f(f) {}
+    UnaryFunctionT const &getFunction() const { return _f; }
     template <typename Arg>
     auto operator()(Arg x) const {
         return _f(1.0 / x - 1.0) / (x * x);
@@ -592,6 +724,7 @@ template <typename UnaryFunctionT>
 struct AuxFunc2 { // f(1/x+1) for int(-infinity..b)
 public:
     AuxFunc2(UnaryFunctionT const &f) : _f(f) {}
+    UnaryFunctionT const &getFunction() const { return _f; }
     template <typename Arg>
     auto operator()(Arg x) const {
         return _f(1.0 / x + 1.0) / (x * x);
@@ -759,6 +892,7 @@ inline Arg int1d(UnaryFunctionT func, IntRegion<Arg> &reg,
  *
  * @note This simply wraps the int1d function above and handles the
  *       instantiation of the intRegion.
+ *       func may be a BatchIntegrand (see makeBatchIntegrand).
  *
  */
 template <typename UnaryFunctionT, typename Arg>
@@ -770,17 +904,52 @@ auto integrate(UnaryFunctionT func,
     return int1d(func, region, DEFABSERR, eps);
 }
 
+namespace details {
+
+/**
+ * Return the integrand of the inner (x) integral of integrate2d at fixed y
+ */
+template <typename BinaryFunctionT, typename Y>
+inline auto bindY(BinaryFunctionT const &func, Y y) {
+    if constexpr (IsBatchIntegrand<BinaryFunctionT>::value) {
+        return makeBatchIntegrand(
+                [&func, y](auto const &x, auto &f) { func(x, y, f); });
+    } else {
+        return [&func, y](auto x) { return func(x, y); };
+    }
+}
+
+}  // namespace details
+
 // =============================================================
 /**
  * The 2D integrator
  *
+ * The integral over x is done for each y node of the outer integral; if numThreads != 1 the inner
+ * integrals for all the nodes of each outer Gauss-Kronrod-Patterson rule are computed concurrently,
+ * so func must then be safe to call concurrently (as a non-mutating functor is). The result does
+ * not depend on the number of threads.
+ *
+ * @param func integrand, called as func(x, y); or a BatchIntegrand (see makeBatchIntegrand),
+ *             called as func(x, y, f) for a vector of x at a single y
+ * @param x1, x2 range of the inner integral
+ * @param y1, y2 range of the outer integral
+ * @param eps required relative error
+ * @param numThreads number of threads to use; 0 means one per hardware thread
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
  */
 template <typename BinaryFunctionT, typename X, typename Y>
-auto integrate2d(BinaryFunctionT func, X x1, X x2, Y y1, Y y2, double eps = 1.0e-6) {
-    auto outer = [func, x1, x2, eps](auto y) {
-        auto inner = [func, y](auto x) { return func(x, y); };
-        return integrate(inner, x1, x2, eps);
-    };
+auto integrate2d(BinaryFunctionT func, X x1, X x2, Y y1, Y y2, double eps = 1.0e-6, int numThreads = 1) {
+    if (numThreads == 1) {
+        auto outer = [&func, x1, x2, eps](auto y) { return integrate(details::bindY(func, y), x1, x2, eps); };
+        return integrate(outer, y1, y2, eps);
+    }
+    int const nThreads = detail::resolveNumThreads(numThreads);
+    auto outer = makeBatchIntegrand([&func, x1, x2, eps, nThreads](auto const &y, auto &f) {
+        detail::parallelFor(y.size(), nThreads,
+                            [&](int i) { f[i] = integrate(details::bindY(func, y[i]), x1, x2, eps); });
+    });
     return integrate(outer, y1, y2, eps);
 }
 }  // namespace math
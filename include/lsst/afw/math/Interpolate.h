@@ -23,6 +23,9 @@
  * the GNU General Public License along with this program.  If not,
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
+#include <cstddef>
+#include <memory>
+#include <vector>
 #include "lsst/base.h"
 #include "ndarray_fwd.h"
 
@@ -59,6 +62,18 @@ public:
     virtual double interpolate(double const x) const = 0;
     std::vector<double> interpolate(std::vector<double> const &x) const;
     ndarray::Array<double, 1> interpolate(ndarray::Array<double const, 1> const &x) const;
+    /**
+     * Interpolate to many points in one call
+     *
+     * The result is the same as calling interpolate(x[i]) for each point, but is much faster when
+     * the points are sorted in increasing order, as each point's interval is then found starting from
+     * the previous point's.
+     *
+     * @param x the points to interpolate to
+     * @param n the number of points
+     * @param out the n interpolated values
+     */
+    void interpolate(double const *x, std::size_t n, double *out) const { doInterpolate(x, n, out); }
 
 protected:
     /**
@@ -80,6 +95,9 @@ protected:
     Interpolate(std::pair<std::vector<double>, std::vector<double> > const xy,
                 Interpolate::Style const style = UNKNOWN);
 
+    /// Worker for the many-point interpolate; the default calls interpolate(double) for each point
+    virtual void doInterpolate(double const *x, std::size_t n, double *out) const;
+
     std::vector<double> const _x;
     std::vector<double> const _y;
     Interpolate::Style const _style;
@@ -27,6 +27,7 @@
 /*
  * Declare the Kernel class and subclasses.
  */
+#include <cstddef>
 #include <memory>
 #include <type_traits>
 #include <utility>
@@ -383,6 +384,39 @@ public:
      */
     void computeKernelParametersFromSpatialModel(std::vector<double> &kernelParams, double x, double y) const;
 
+    /**
+     * Compute the kernel parameters at every point of a grid
+     *
+     * Each spatial function is evaluated over the whole grid in one batched call (see
+     * Function2::evaluateGrid), which is much faster than calling computeKernelParametersFromSpatialModel
+     * at each point. If the kernel is not spatially varying, every point gets the current kernel parameters.
+     *
+     * @param x x positions of the grid columns
+     * @param y y positions of the grid rows
+     * @returns kernel parameters, indexed as [kernel parameter, y index, x index]
+     */
+    ndarray::Array<double, 3, 3> computeKernelParametersOnGrid(
+            ndarray::Array<double const, 1> const &x, ndarray::Array<double const, 1> const &y) const;
+
+    /**
+     * Compute an image (pixellized representation of the kernel) for given kernel parameters
+     *
+     * This is intended to be used with computeKernelParametersOnGrid, to compute images of a spatially
+     * varying kernel at many positions without evaluating the spatial model at each one. The kernel's
+     * parameters are left set to kernelParams, and the image cache (if any) is neither used nor updated.
+     *
+     * @param image image whose pixels are to be set (output); xy0 of the image will be set to
+     *              -kernel.getCtr()
+     * @param doNormalize if true, normalize the image (so sum of pixels = 1)
+     * @param kernelParams kernel parameters
+     * @returns the kernel sum before normalization
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if the image is the wrong size
+     *  or kernelParams is the wrong length
+     */
+    double computeImageFromKernelParameters(lsst::afw::image::Image<Pixel> &image, bool doNormalize,
+                                            std::vector<double> const &kernelParams) const;
+
     /**
      * Return a string representation of the kernel
      */
@@ -402,6 +436,59 @@ public:
      */
     virtual int getCacheSize() const { return 0; };
 
+    /**
+     * Enable or disable caching of the images computed by computeImage for a spatially varying kernel
+     *
+     * When enabled, computeImage snaps the position (x, y) to the nearest multiple of positionQuantum
+     * and remembers the last maxSize images it computed, keyed on the snapped position, the kernel
+     * parameters there, doNormalize and the image dimensions; the least recently used image is discarded
+     * when the cache is full. A request matching a cached image copies it instead of recomputing it.
+     * The kernel parameters are part of the key, so changing the spatial parameters never returns
+     * stale images.
+     *
+     * Snapping means that, for positionQuantum > 0, computeImage (and hence convolution) evaluates
+     * the kernel at the snapped position; use positionQuantum = 0 to cache exact positions only.
+     * While the cache is enabled computeImage is thread-safe: lookups are guarded by a mutex and
+     * cache misses are computed one at a time. The cache has no effect on spatially invariant kernels.
+     * Clones of the kernel get an empty cache with the same settings.
+     *
+     * @param maxSize maximum number of images to cache; 0 to disable caching and discard the cache
+     * @param positionQuantum spacing of the grid to which positions are snapped; 0 for none
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if maxSize < 0 or positionQuantum < 0
+     */
+    void setImageCache(int maxSize, double positionQuantum = 1.0);
+
+    /**
+     * Get the maximum number of images in the image cache (0 if disabled)
+     */
+    int getImageCacheMaxSize() const;
+
+    /**
+     * Get the spacing of the grid to which the image cache snaps positions
+     */
+    double getImageCachePositionQuantum() const;
+
+    /**
+     * Get the number of images currently in the image cache
+     */
+    int getImageCacheSize() const;
+
+    /**
+     * Get the number of computeImage calls satisfied from the image cache
+     */
+    std::size_t getImageCacheHits() const;
+
+    /**
+     * Get the number of computeImage calls that missed the image cache
+     */
+    std::size_t getImageCacheMisses() const;
+
+    /**
+     * Discard all cached images and reset the hit and miss counts
+     */
+    void clearImageCache();
+
 #if 0  // fails to compile with icc; is it actually used?
         virtual void toFile(std::string fileName) const;
 #endif
@@ -433,6 +520,17 @@ protected:
      */
     void setKernelParametersFromSpatialModel(double x, double y) const;
 
+    /**
+     * Set the kernel parameters from the spatial model at (x, y) and compute the image,
+     * using the image cache if it is enabled
+     *
+     * For use by computeImage of spatially varying kernels, after the image's xy0 is set.
+     *
+     * @returns The kernel sum
+     */
+    double computeSpatiallyVaryingImage(lsst::afw::image::Image<Pixel> &image, bool doNormalize, double x,
+                                        double y) const;
+
     /**
      * Low-level version of computeImage
      *
@@ -454,6 +552,8 @@ private:
     int _ctrX;
     int _ctrY;
     unsigned int _nKernelParams;
+    class ImageCache;
+    std::shared_ptr<ImageCache> _imageCache;  ///< cache of computed images, or null if disabled
 
     // Set the Kernel's ideas about the x- and y- coordinates
     virtual void _setKernelXY() {}
@@ -960,6 +1060,10 @@ public:
      * 10,000 typically results in a warping error of a fraction of a count.
      * 100,000 typically results in a warping error of less than 0.01 count.
      *
+     * Caches are immutable and shared: every kernel with the same functions, dimensions and center
+     * (such as clones of a warping kernel) uses the same cache of a given size, which is computed
+     * only the first time it is needed and kept for the life of the process.
+     *
      * @param cacheSize cache size (number of double precision array elements in the x and y caches)
      */
     void computeCache(int const cacheSize) override;
@@ -998,10 +1102,10 @@ private:
     mutable std::vector<double> _kernelX;  // used by SeparableKernel::basicComputeVectors
     mutable std::vector<double> _kernelY;
     //
-    // Cached values of the row- and column- kernels
+    // Cached values of the row- and column- kernels (null if none), shared with other kernels
     //
-    mutable std::vector<std::vector<double>> _kernelRowCache;
-    mutable std::vector<std::vector<double>> _kernelColCache;
+    std::shared_ptr<std::vector<std::vector<double>> const> _kernelRowCache;
+    std::shared_ptr<std::vector<std::vector<double>> const> _kernelColCache;
 
     virtual void _setKernelXY() override {
         lsst::geom::Extent2I const dim = getDimensions();
@@ -0,0 +1,118 @@
+// -*- LSST-C++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_MATH_LeastSquaresBatch_h_INCLUDED
+#define LSST_AFW_MATH_LeastSquaresBatch_h_INCLUDED
+
+#include <limits>
+
+#include "ndarray.h"
+#include "lsst/afw/math/LeastSquares.h"
+
+namespace lsst {
+namespace afw {
+namespace math {
+
+/**
+ *  Solver for many small linear least-squares problems of the same dimension.
+ *
+ *  Where LeastSquares solves one problem at a time, LeastSquaresBatch takes the normal
+ *  equations of N problems with the same number of parameters n, packed into contiguous arrays,
+ *  and solves them all at once.  Problems with up to 10 parameters (typical of per-source or
+ *  per-cell fits) are solved with fixed-size factorizations whose loops the compiler can unroll and
+ *  vectorize, and the problems may be spread over several threads.
+ *
+ *  The factorizations behave as they do in LeastSquares, and the rank and diagnostic vector of
+ *  each problem are kept, so rank-deficient problems can be found after the fact without
+ *  stopping the batch.
+ */
+class LeastSquaresBatch final {
+public:
+    /**
+     *  Solve a batch of problems given the terms in their normal equations.
+     *
+     *  @param fisher Fisher matrices, with shape (N, n, n).  Each must be exactly symmetric; see
+     *                LeastSquares.
+     *  @param rhs right-hand side vectors, with shape (N, n)
+     *  @param factorization NORMAL_EIGENSYSTEM or NORMAL_CHOLESKY; DIRECT_SVD needs the design
+     *                       matrix, and so is not available here.
+     *  @param threshold relative threshold below which elements of a problem's diagnostic vector
+     *                   are considered zero when computing its rank (see LeastSquares::setThreshold).
+     *                   Unlike LeastSquares, it is also used to estimate the rank for
+     *                   NORMAL_CHOLESKY, by comparing each element of @f$D@f$ to the largest.
+     *  @param numThreads number of threads to use; 0 means one per hardware thread
+     *
+     *  @throws lsst::pex::exceptions::LengthError if the shapes of fisher and rhs don't match.
+     *  @throws lsst::pex::exceptions::InvalidParameterError if factorization is DIRECT_SVD or
+     *          numThreads < 0.
+     */
+    static LeastSquaresBatch fromNormalEquations(
+            ndarray::Array<double const, 3, 3> const& fisher, ndarray::Array<double const, 2, 2> const& rhs,
+            LeastSquares::Factorization factorization = LeastSquares::NORMAL_CHOLESKY,
+            double threshold = std::numeric_limits<double>::epsilon(), int numThreads = 1);
+
+    /// Return the number of problems in the batch.
+    int getSize() const { return _rank.getSize<0>(); }
+
+    /// Return the number of parameters of each problem.
+    int getDimension() const { return _solution.getSize<1>(); }
+
+    /// Return the type of factorization used by the solver.
+    LeastSquares::Factorization getFactorization() const { return _factorization; }
+
+    /**
+     *  Return the solution vectors, with shape (N, n).
+     *
+     *  For NORMAL_EIGENSYSTEM, a rank-deficient problem has the minimum-norm solution.  For
+     *  NORMAL_CHOLESKY, the solution of a problem whose rank is less than getDimension() is not
+     *  reliable.
+     */
+    ndarray::Array<double const, 2, 2> getSolution() const { return _solution; }
+
+    /**
+     *  Return the diagnostic vectors, with shape (N, n).
+     *
+     *  For NORMAL_EIGENSYSTEM these are the Eigenvalues of each Fisher matrix in descending order,
+     *  and for NORMAL_CHOLESKY the @f$D@f$ of each pivoted @f$L D L^T@f$ factorization, as for
+     *  LeastSquares::getDiagnostic.
+     */
+    ndarray::Array<double const, 2, 2> getDiagnostic() const { return _diagnostic; }
+
+    /// Return the rank of each problem, with shape (N,).
+    ndarray::Array<int const, 1, 1> getRank() const { return _rank; }
+
+private:
+    LeastSquaresBatch(LeastSquares::Factorization factorization, int size, int dimension);
+
+    LeastSquares::Factorization _factorization;
+    ndarray::Array<double, 2, 2> _solution;
+    ndarray::Array<double, 2, 2> _diagnostic;
+    ndarray::Array<int, 1, 1> _rank;
+};
+
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !LSST_AFW_MATH_LeastSquaresBatch_h_INCLUDED
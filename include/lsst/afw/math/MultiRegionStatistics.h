@@ -0,0 +1,192 @@
+// -*- LSST-C++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_MATH_MULTIREGIONSTATISTICS_H
+#define LSST_AFW_MATH_MULTIREGIONSTATISTICS_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "ndarray.h"
+#include "lsst/geom/Box.h"
+#include "lsst/afw/geom/SpanSet.h"
+#include "lsst/afw/image/MaskedImage.h"
+#include "lsst/afw/math/Statistics.h"
+
+namespace lsst {
+namespace afw {
+namespace math {
+
+/**
+ * The results of computing the same statistics over many regions of one image.
+ *
+ * Each region's result is a full Statistics object; the `getValues`, `getErrors` and `getOrMasks`
+ * accessors additionally return one property for every region as a column, in region order.
+ *
+ * Use makeMultiRegionStatistics() to compute these.
+ */
+class MultiRegionStatistics final {
+public:
+    /**
+     * Construct from per-region results.
+     *
+     * @param statistics one Statistics per region, in region order
+     * @param flags the properties that were requested for every region
+     */
+    MultiRegionStatistics(std::vector<Statistics> statistics, int flags);
+
+    MultiRegionStatistics(MultiRegionStatistics const &) = default;
+    MultiRegionStatistics(MultiRegionStatistics &&) = default;
+    MultiRegionStatistics &operator=(MultiRegionStatistics const &) = default;
+    MultiRegionStatistics &operator=(MultiRegionStatistics &&) = default;
+    ~MultiRegionStatistics() noexcept = default;
+
+    /// Return the number of regions
+    std::size_t size() const noexcept { return _statistics.size(); }
+
+    /// Return the properties that were requested
+    int getFlags() const noexcept { return _flags; }
+
+    /// Return the statistics of region i, without bounds checking
+    Statistics const &operator[](std::size_t i) const noexcept { return _statistics[i]; }
+
+    /**
+     * Return the statistics of region i
+     *
+     * @throws lsst::pex::exceptions::LengthError if i >= size()
+     */
+    Statistics const &get(std::size_t i) const;
+
+    /**
+     * Return the value of a property for every region
+     *
+     * @param prop the property to retrieve; as for Statistics::getValue, NOTHING selects the only
+     *             property requested
+     */
+    ndarray::Array<double, 1, 1> getValues(Property const prop = NOTHING) const;
+
+    /**
+     * Return the error in a property for every region
+     *
+     * @param prop the property to retrieve; as for Statistics::getError, NOTHING selects the only
+     *             property requested
+     */
+    ndarray::Array<double, 1, 1> getErrors(Property const prop = NOTHING) const;
+
+    /// Return the OR of the mask bits of the pixels used in every region
+    ndarray::Array<image::MaskPixel, 1, 1> getOrMasks() const;
+
+private:
+    std::vector<Statistics> _statistics;
+    int _flags;
+};
+
+/**
+ * Compute statistics over many rectangular regions of a MaskedImage.
+ *
+ * Each region is evaluated exactly as `makeStatistics` would evaluate the corresponding subimage;
+ * the regions are processed concurrently using `sctrl.getNumThreads()` threads.
+ *
+ * @param mimg image whose regions are to be measured
+ * @param boxes regions to measure, in PARENT coordinates
+ * @param flags Describe what we want to calculate
+ * @param sctrl Control how things are calculated
+ *
+ * @throws lsst::pex::exceptions::LengthError if a box does not lie within `mimg`
+ * @throws lsst::pex::exceptions::InvalidParameterError if a box is empty
+ *
+ * @relatesalso MultiRegionStatistics
+ */
+template <typename Pixel>
+MultiRegionStatistics makeMultiRegionStatistics(image::MaskedImage<Pixel> const &mimg,
+                                                std::vector<lsst::geom::Box2I> const &boxes, int const flags,
+                                                StatisticsControl const &sctrl = StatisticsControl());
+
+/**
+ * Compute statistics over many arbitrarily-shaped regions of a MaskedImage.
+ *
+ * Each region's pixels are gathered into a scratch buffer that is shared by all regions handled
+ * by the same thread, then evaluated as `makeStatistics` would evaluate a MaskedVector of them;
+ * the regions are processed concurrently using `sctrl.getNumThreads()` threads.
+ *
+ * @param mimg image whose regions are to be measured
+ * @param spanSets regions to measure, in PARENT coordinates
+ * @param flags Describe what we want to calculate
+ * @param sctrl Control how things are calculated
+ *
+ * @throws lsst::pex::exceptions::LengthError if a region does not lie within `mimg`
+ * @throws lsst::pex::exceptions::InvalidParameterError if a region is null or empty
+ *
+ * @relatesalso MultiRegionStatistics
+ */
+template <typename Pixel>
+MultiRegionStatistics makeMultiRegionStatistics(
+        image::MaskedImage<Pixel> const &mimg,
+        std::vector<std::shared_ptr<geom::SpanSet const>> const &spanSets, int const flags,
+        StatisticsControl const &sctrl = StatisticsControl());
+
+/**
+ * Compute statistics over every row of a MaskedImage.
+ *
+ * Row i of the result is evaluated exactly as `makeStatistics` would evaluate the one-row subimage
+ * at y = mimg.getY0() + i; the rows are processed concurrently using `sctrl.getNumThreads()` threads.
+ *
+ * @param mimg image whose rows are to be measured
+ * @param flags Describe what we want to calculate
+ * @param sctrl Control how things are calculated
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if the image is empty
+ *
+ * @relatesalso MultiRegionStatistics
+ */
+template <typename Pixel>
+MultiRegionStatistics makeRowStatistics(image::MaskedImage<Pixel> const &mimg, int const flags,
+                                        StatisticsControl const &sctrl = StatisticsControl());
+
+/**
+ * Compute statistics over every column of a MaskedImage.
+ *
+ * Column i of the result is evaluated as `makeStatistics` would evaluate the one-column subimage at
+ * x = mimg.getX0() + i.  Blocks of adjacent columns are transposed into a scratch buffer one image
+ * row at a time, so the image is read in row order; the blocks are processed concurrently using
+ * `sctrl.getNumThreads()` threads.
+ *
+ * @param mimg image whose columns are to be measured
+ * @param flags Describe what we want to calculate
+ * @param sctrl Control how things are calculated
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if the image is empty
+ *
+ * @relatesalso MultiRegionStatistics
+ */
+template <typename Pixel>
+MultiRegionStatistics makeColumnStatistics(image::MaskedImage<Pixel> const &mimg, int const flags,
+                                           StatisticsControl const &sctrl = StatisticsControl());
+
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // LSST_AFW_MATH_MULTIREGIONSTATISTICS_H
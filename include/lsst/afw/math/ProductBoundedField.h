@@ -64,6 +64,14 @@ public:
 
     using BoundedField::evaluate;
 
+    /**
+     *  @copydoc BoundedField::evaluateGrid
+     *
+     *  Each factor is evaluated with its own evaluateGrid, so separable factors keep their fast path.
+     */
+    ndarray::Array<double, 2, 2> evaluateGrid(ndarray::Array<double const, 1> const& x,
+                                              ndarray::Array<double const, 1> const& y) const override;
+
     /**
      *  ProductBoundedField is persistable if and only if all of its factors
      *  are.
@@ -29,7 +29,10 @@
 #ifndef LSST_AFW_MATH_RANDOM_H
 #define LSST_AFW_MATH_RANDOM_H
 
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "gsl/gsl_rng.h"
 
@@ -49,6 +52,11 @@ namespace math {
  * additional distributions that can easily be added to this class as the
  * need arises.
  *
+ * The Random::PHILOX4X32 algorithm is a counter-based generator: its output is a function of a
+ * key and a counter, so it can be split into many independent substreams without generating the
+ * numbers in between (see getSubstream()).  The image fills below use this to fill the rows of an
+ * image in parallel, with results that do not depend on the number of threads.
+ *
  * @see <a href="http://www.gnu.org/software/gsl/manual/html_node/Random-Number-Generation.html">Random number
  * generation in GSL</a>
  * @see <a href="http://www.gnu.org/software/gsl/manual/html_node/Random-Number-Distributions.html">Random
@@ -88,6 +96,9 @@ public:
         TAUS2,
         /** A fifth-order multiple recursive generator by L'Ecuyer, Blouin, and Coutre. */
         GFSR4,
+        /** The counter-based Philox4x32-10 generator of Salmon, Moraes, Dror, and Shaw (2011), keyed
+           by the seed; see isCounterBased(). */
+        PHILOX4X32,
         /** Number of supported algorithms */
         NUM_ALGORITHMS
     };
@@ -176,6 +187,38 @@ public:
      */
     unsigned long getSeed() const;
 
+    // -- Substreams of counter-based generators --------
+    /**
+     * @returns  Whether this generator's algorithm is counter-based, and so supports getSubstream()
+     *           and skipSubstreams().  Only Random::PHILOX4X32 is.
+     */
+    bool isCounterBased() const;
+    /**
+     * Return a generator for one of the independent substreams that follow this generator's current
+     * position.
+     *
+     * Substream `index` is the same however many other substreams are used, and in whatever order, so
+     * work split between threads by substream gives the same results on any number of threads.  This
+     * generator is not changed; call skipSubstreams() once the substreams have been used, so that later
+     * numbers from this generator are independent of them.
+     *
+     * @param[in] index     index of the substream, counting from the one after the current position
+     * @returns          a new generator at the start of the substream
+     *
+     * @throws lsst::pex::exceptions::LogicError
+     *      Thrown if this generator is not counter-based.
+     */
+    Random getSubstream(std::uint64_t index) const;
+    /**
+     * Move this generator to the start of the substream that would be returned by getSubstream(n).
+     *
+     * @param[in] n     number of substreams to skip
+     *
+     * @throws lsst::pex::exceptions::LogicError
+     *      Thrown if this generator is not counter-based.
+     */
+    void skipSubstreams(std::uint64_t n);
+
     // -- Modifiers: generating random numbers --------
     /**
      * Returns a uniformly distributed random double precision floating point number from the
@@ -190,6 +233,15 @@ public:
      * @see uniformPositiveDouble()
      */
     double uniform();
+    /**
+     * Fill an array with uniformly distributed random doubles in the range [0, 1), in the same
+     * sequence as calling uniform() once for each element.
+     *
+     * For counter-based generators the values are computed several at a time, which is much faster.
+     *
+     * @param[out] begin, end   the array to fill
+     */
+    void uniform(double *begin, double *end);
     /**
      * Returns a uniformly distributed random double precision floating point number from the
      * generator. The random number will be in the range (0, 1); the range excludes both 0.0
@@ -282,24 +334,35 @@ private:
 
 /*
  * Create Images containing random numbers
+ *
+ * If `rand` is counter-based (see Random::isCounterBased), each row of the image is drawn from its own
+ * substream (row y from rand.getSubstream(y)), so the rows may be filled by several threads with the same
+ * result as on one; rand is then moved past those substreams.  Other generators fill the image one pixel
+ * at a time, in row-major order, on the calling thread whatever the value of numThreads.
  */
 /**
  * Set image to random numbers uniformly distributed in the range [0, 1)
  *
  * @param[out] image The image to set
  * @param[in, out] rand definition of random number algorithm, seed, etc.
+ * @param[in] numThreads number of threads to use if rand is counter-based; 0 means one per hardware thread
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
  */
 template <typename ImageT>
-void randomUniformImage(ImageT *image, Random &rand);
+void randomUniformImage(ImageT *image, Random &rand, int numThreads = 1);
 
 /**
  * Set image to random numbers uniformly distributed in the range (0, 1)
  *
  * @param[out] image The image to set
  * @param[in, out] rand definition of random number algorithm, seed, etc.
+ * @param[in] numThreads number of threads to use if rand is counter-based; 0 means one per hardware thread
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
  */
 template <typename ImageT>
-void randomUniformPosImage(ImageT *image, Random &rand);
+void randomUniformPosImage(ImageT *image, Random &rand, int numThreads = 1);
 
 /**
  * Set image to random integers uniformly distributed in the range 0 ... n - 1
@@ -307,9 +370,12 @@ void randomUniformPosImage(ImageT *image, Random &rand);
  * @param[out] image The image to set
  * @param[in, out] rand definition of random number algorithm, seed, etc.
  * @param[in] n (exclusive) upper limit for random variates
+ * @param[in] numThreads number of threads to use if rand is counter-based; 0 means one per hardware thread
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
  */
 template <typename ImageT>
-void randomUniformIntImage(ImageT *image, Random &rand, unsigned long n);
+void randomUniformIntImage(ImageT *image, Random &rand, unsigned long n, int numThreads = 1);
 
 /**
  * Set image to random numbers uniformly distributed in the range [a, b)
@@ -318,18 +384,24 @@ void randomUniformIntImage(ImageT *image, Random &rand, unsigned long n);
  * @param[in, out] rand definition of random number algorithm, seed, etc.
  * @param[in] a (inclusive) lower limit for random variates
  * @param[in] b (exclusive) upper limit for random variates
+ * @param[in] numThreads number of threads to use if rand is counter-based; 0 means one per hardware thread
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
  */
 template <typename ImageT>
-void randomFlatImage(ImageT *image, Random &rand, double const a, double const b);
+void randomFlatImage(ImageT *image, Random &rand, double const a, double const b, int numThreads = 1);
 
 /**
  * Set image to random numbers with a gaussian N(0, 1) distribution
  *
  * @param[out] image The image to set
  * @param[in, out] rand definition of random number algorithm, seed, etc.
+ * @param[in] numThreads number of threads to use if rand is counter-based; 0 means one per hardware thread
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
  */
 template <typename ImageT>
-void randomGaussianImage(ImageT *image, Random &rand);
+void randomGaussianImage(ImageT *image, Random &rand, int numThreads = 1);
 
 /**
  * Set image to random numbers with a chi^2_{nu} distribution
@@ -337,9 +409,12 @@ void randomGaussianImage(ImageT *image, Random &rand);
  * @param[out] image The image to set
  * @param[in, out] rand definition of random number algorithm, seed, etc.
  * @param[in] nu number of degrees of freedom
+ * @param[in] numThreads number of threads to use if rand is counter-based; 0 means one per hardware thread
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
  */
 template <typename ImageT>
-void randomChisqImage(ImageT *image, Random &rand, double const nu);
+void randomChisqImage(ImageT *image, Random &rand, double const nu, int numThreads = 1);
 
 /**
  * Set image to random numbers with a Poisson distribution with mean mu (n.b. not per-pixel)
@@ -347,9 +422,12 @@ void randomChisqImage(ImageT *image, Random &rand, double const nu);
  * @param[out] image The image to set
  * @param[in, out] rand definition of random number algorithm, seed, etc.
  * @param[in] mu mean of distribution
+ * @param[in] numThreads number of threads to use if rand is counter-based; 0 means one per hardware thread
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
  */
 template <typename ImageT>
-void randomPoissonImage(ImageT *image, Random &rand, double const mu);
+void randomPoissonImage(ImageT *image, Random &rand, double const mu, int numThreads = 1);
 }  // namespace math
 }  // namespace afw
 }  // namespace lsst
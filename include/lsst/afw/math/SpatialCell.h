@@ -62,6 +62,23 @@ public:
 
     virtual void reset() {}
     virtual void processCandidate(SpatialCellCandidate*) {}
+
+    /**
+     * Return a new visitor for use on other threads, or null if this visitor can't be cloned
+     *
+     * Visitors that support the parallel SpatialCellSet visits return an object of their own type whose
+     * processCandidate may run concurrently with this one's, sharing no mutable state with it.  Each
+     * clone is reset before it visits any candidates, and its results are returned to this visitor by
+     * merge.  The default returns null, so parallel visits fall back to visiting serially.
+     */
+    virtual std::shared_ptr<CandidateVisitor> clone() const { return nullptr; }
+
+    /**
+     * Add the results accumulated by a clone of this visitor (see clone) to this visitor's own
+     *
+     * @param other a visitor returned by this visitor's clone method
+     */
+    virtual void merge(CandidateVisitor const& other) {}
 };
 
 /**
@@ -429,13 +446,22 @@ public:
      * @param visitor Pass this object to every Candidate
      * @param nMaxPerCell Visit no more than this many Candidates (<= 0: all)
      * @param ignoreExceptions Ignore any exceptions thrown by the processing
+     * @param numThreads number of threads to use; 0 means one per hardware thread
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
+     *
+     * With numThreads != 1 and a visitor that supports cloning (see CandidateVisitor::clone), the
+     * cells are visited concurrently, each by its own clone of the visitor, and the clones are then
+     * merged into `visitor` in the order of the cell list.  The result therefore doesn't depend on the
+     * number of threads, though it may differ in rounding from a serial visit.  Candidates in different
+     * cells, and anything they share, must be safe to process concurrently.
      *
      * @note This is obviously similar to the Design Patterns (Go4) Visitor pattern, but we've simplified the
      * double dispatch (i.e. we don't call a virtual method on SpatialCellCandidate that in turn calls
      * processCandidate(*this), but can be re-defined)
      */
     void visitCandidates(CandidateVisitor* visitor, int const nMaxPerCell = -1,
-                         bool const ignoreExceptions = false);
+                         bool const ignoreExceptions = false, int numThreads = 1);
     /**
      * Call the visitor's processCandidate method for each Candidate in the SpatialCellSet (const version)
      *
@@ -444,18 +470,25 @@ public:
      * @param visitor Pass this object to every Candidate
      * @param nMaxPerCell Visit no more than this many Candidates (-ve: all)
      * @param ignoreExceptions Ignore any exceptions thrown by the processing
+     * @param numThreads number of threads to use; 0 means one per hardware thread
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
      */
     void visitCandidates(CandidateVisitor* visitor, int const nMaxPerCell = -1,
-                         bool const ignoreExceptions = false) const;
+                         bool const ignoreExceptions = false, int numThreads = 1) const;
     /**
      * Call the visitor's processCandidate method for every Candidate in the SpatialCellSet
      *
      * @param visitor Pass this object to every Candidate
      * @param ignoreExceptions Ignore any exceptions thrown by the processing
+     * @param numThreads number of threads to use; 0 means one per hardware thread
      *
-     * @see visitCandidates
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
+     *
+     * @see visitCandidates, which describes how the cells are visited when numThreads != 1
      */
-    void visitAllCandidates(CandidateVisitor* visitor, bool const ignoreExceptions = false);
+    void visitAllCandidates(CandidateVisitor* visitor, bool const ignoreExceptions = false,
+                            int numThreads = 1);
     /**
      * Call the visitor's processCandidate method for every Candidate in the SpatialCellSet (const version)
      *
@@ -463,8 +496,12 @@ public:
      *
      * @param visitor Pass this object to every Candidate
      * @param ignoreExceptions Ignore any exceptions thrown by the processing
+     * @param numThreads number of threads to use; 0 means one per hardware thread
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
      */
-    void visitAllCandidates(CandidateVisitor* visitor, bool const ignoreExceptions = false) const;
+    void visitAllCandidates(CandidateVisitor* visitor, bool const ignoreExceptions = false,
+                            int numThreads = 1) const;
 
     /**
      * Return the SpatialCellCandidate with the specified id
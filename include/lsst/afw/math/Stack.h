@@ -27,7 +27,10 @@
 /*
  * Functions to stack images
  */
+#include <functional>
+#include <limits>
 #include <vector>
+#include "lsst/geom/Box.h"
 #include "lsst/afw/image/Image.h"
 #include "lsst/afw/image/Mask.h"
 #include "lsst/afw/math/Statistics.h"
@@ -166,6 +169,225 @@ std::vector<PixelT> statisticsStack(
                 std::vector<lsst::afw::image::VariancePixel>(0)  ///< vector containing weights
 );
 
+/* ****************************************************************** *
+ *
+ * streaming z stacks
+ *
+ * ******************************************************************* */
+
+/**
+ * A source of row strips of one input to streamingStatisticsStack
+ *
+ * It is called with a box in the parent coordinate system of the stack and must return a MaskedImage
+ * with the dimensions of that box, e.g. by calling `MaskedImageFitsReader::read(bbox)`.
+ */
+template <typename PixelT>
+using MaskedImageStripReader =
+        std::function<std::shared_ptr<lsst::afw::image::MaskedImage<PixelT>>(lsst::geom::Box2I const&)>;
+
+/**
+ * A consumer of the output strips of streamingStatisticsStack; the xy0 of each strip is its position
+ * in the parent coordinate system of the stack.
+ */
+template <typename PixelT>
+using MaskedImageStripWriter = std::function<void(lsst::afw::image::MaskedImage<PixelT> const&)>;
+
+/**
+ * How streamingStatisticsStack holds the strips it has read while it stacks them
+ *
+ * By default the strips are held as they were read, i.e. 12 bytes per float pixel. The compact
+ * precisions need 6 bytes per pixel, halving the memory and bandwidth needed to hold and scan a strip
+ * of every input:
+ *
+ *  - HALF holds each strip's image and variance as IEEE binary16 values, scaled by a power of two chosen
+ *    for the strip so that the range of the data does not matter; the error of an image value is at most
+ *    2^-11 of the largest absolute value in the strip.
+ *  - SCALED_INT16 holds each strip's image as 16-bit integers with an offset and a scale chosen for the
+ *    strip; the error of an image value is at most 1/131068 of the range of the values in the strip.
+ *    The variance is held as in HALF.
+ *
+ * The relative error of a variance is at most 2^-11 (unless it is more than 2^29 times smaller than the
+ * largest variance in its strip), and masks are held in 16 bits if no higher bit is set in the strip.
+ * The strip of an input is held at full precision instead whenever the bound on the error of its image
+ * exceeds `maxImageError`, or it cannot be encoded (e.g. SCALED_INT16 cannot represent infinities).
+ * The statistics are always computed in double precision from the decoded values.
+ */
+class StackSampleStorage final {
+public:
+    enum Precision {
+        FULL,         ///< hold the strips as they were read
+        HALF,         ///< binary16 image and variance
+        SCALED_INT16  ///< scaled 16-bit integer image and binary16 variance
+    };
+
+    /**
+     * Construct a storage policy
+     *
+     * @param[in] precision      How to hold the strips.
+     * @param[in] maxImageError  Largest error of an image value for a strip to be held compactly.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if maxImageError is not positive.
+     */
+    explicit StackSampleStorage(Precision precision = FULL,
+                                double maxImageError = std::numeric_limits<double>::infinity());
+
+    /// Return how the strips are held
+    Precision getPrecision() const noexcept { return _precision; }
+
+    /// Return the largest error of an image value for a strip to be held compactly
+    double getMaxImageError() const noexcept { return _maxImageError; }
+
+private:
+    Precision _precision;
+    double _maxImageError;
+};
+
+/**
+ * Compute some statistics of a stack of Masked Images, one strip of rows at a time
+ *
+ * Unlike statisticsStack, the inputs never have to be resident in memory as a whole: for each strip
+ * of at most `stripHeight` rows of `bbox`, a strip is read from every input, the strips are stacked
+ * exactly as statisticsStack would stack them, and the output strip is passed to `writer` before the
+ * next strip is read. Memory use therefore scales with `stripHeight` rather than with the size of the
+ * inputs, and the result is identical to that of statisticsStack.
+ *
+ * @param[in] readers      One source of strips per input.
+ * @param[in] bbox         Region to stack, in the parent coordinate system of the inputs.
+ * @param[in] flags        Statistics requested.
+ * @param[in] writer       Called with each output strip, in order of increasing y.
+ * @param[in] sctrl        Control structure.
+ * @param[in] wvector      Vector of weights.
+ * @param[in] clipped      Mask to set for pixels that were clipped (NOT rejected
+ *                         due to masks).
+ * @param[in] maskMap      Vector of pairs of mask pixel values; see statisticsStack.
+ * @param[in] stripHeight  Maximum number of rows to read from each input at a time.
+ * @param[in] storage      How to hold the strips while they are stacked; unless its precision is FULL
+ *                         the result is only as close to that of statisticsStack as it allows.
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if stripHeight is not positive, a reader returns
+ *     nothing or a strip of the wrong size, or the arguments are invalid for statisticsStack.
+ */
+template <typename PixelT>
+void streamingStatisticsStack(std::vector<MaskedImageStripReader<PixelT>> const& readers,
+                              lsst::geom::Box2I const& bbox, Property flags,
+                              MaskedImageStripWriter<PixelT> const& writer, StatisticsControl const& sctrl,
+                              std::vector<lsst::afw::image::VariancePixel> const& wvector,
+                              image::MaskPixel clipped,
+                              std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const& maskMap,
+                              int stripHeight = 256,
+                              StackSampleStorage const& storage = StackSampleStorage());
+
+/**
+ * Compute some statistics of a stack of Masked Images, one strip of rows at a time
+ *
+ * Delegates to the more general version of streamingStatisticsStack taking a maskMap.
+ */
+template <typename PixelT>
+void streamingStatisticsStack(
+        std::vector<MaskedImageStripReader<PixelT>> const& readers,  ///< one source of strips per input
+        lsst::geom::Box2I const& bbox,                               ///< region to stack
+        Property flags,                                              ///< statistics requested
+        MaskedImageStripWriter<PixelT> const& writer,                ///< consumer of output strips
+        StatisticsControl const& sctrl = StatisticsControl(),        ///< control structure
+        std::vector<lsst::afw::image::VariancePixel> const& wvector =
+                std::vector<lsst::afw::image::VariancePixel>(0),  ///< vector containing weights
+        image::MaskPixel clipped = 0,  ///< bitmask to set if any input was clipped or masked
+        image::MaskPixel excuse = 0,   ///< bitmask to excuse from marking as clipped
+        int stripHeight = 256,         ///< maximum number of rows to read from each input at a time
+        StackSampleStorage const& storage = StackSampleStorage()  ///< how to hold the strips
+);
+
+/**
+ * Accumulate a stack of Masked Images one input at a time
+ *
+ * Only the statistics that can be computed in a single pass are supported: MEAN and VARIANCE.
+ * Each input is folded into per-pixel running sums (using Welford's algorithm, weighted as in West 1979)
+ * as soon as it is added, so it may be freed straight away and memory use does not grow with the number
+ * of inputs. The result agrees, to rounding error, with statisticsStack for the same inputs, including
+ * weighting, error estimation and mask propagation (the StatisticsControl mask propagation thresholds,
+ * the no-good-pixels mask, and the `clipped` and `excuse` bits).
+ *
+ * MEANCLIP is not supported: its first clipping iteration is centred on the median of all the inputs,
+ * which needs every sample at once.
+ */
+template <typename PixelT>
+class StackAccumulator final {
+public:
+    /**
+     * Construct an empty accumulator
+     *
+     * @param[in] bbox     Bounding box of the inputs and of the result.
+     * @param[in] flags    Statistic to compute; MEAN or VARIANCE, optionally with ERRORS.
+     * @param[in] sctrl    Control structure.
+     * @param[in] clipped  Bitmask to set if any input was masked with a bit that was not excused.
+     * @param[in] excuse   Bitmask to excuse from marking as clipped.
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if flags does not request exactly one of
+     *     MEAN or VARIANCE, or sctrl requests both calcErrorFromInputVariance and calcErrorMosaicMode.
+     */
+    explicit StackAccumulator(lsst::geom::Box2I const& bbox, Property flags,
+                              StatisticsControl const& sctrl = StatisticsControl(),
+                              image::MaskPixel clipped = 0, image::MaskPixel excuse = 0);
+
+    StackAccumulator(StackAccumulator const&) = default;
+    StackAccumulator(StackAccumulator&&) = default;
+    StackAccumulator& operator=(StackAccumulator const&) = default;
+    StackAccumulator& operator=(StackAccumulator&&) = default;
+    ~StackAccumulator() = default;
+
+    /**
+     * Add an input, weighted by its inverse variance if the StatisticsControl asks for weighting
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if the dimensions of maskedImage differ from
+     *     those of the accumulator.
+     */
+    void add(lsst::afw::image::MaskedImage<PixelT> const& maskedImage);
+
+    /**
+     * Add an input with a constant weight; the weight is ignored unless the StatisticsControl asks
+     * for weighting
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if the dimensions of maskedImage differ from
+     *     those of the accumulator.
+     */
+    void add(lsst::afw::image::MaskedImage<PixelT> const& maskedImage, double weight);
+
+    /**
+     * Return the stack of the inputs added so far
+     *
+     * More inputs may be added afterwards.
+     */
+    std::shared_ptr<lsst::afw::image::MaskedImage<PixelT>> finish() const;
+
+    /// Return the number of inputs added so far
+    int getNumInputs() const noexcept { return _numInputs; }
+
+    /// Return the bounding box of the inputs and of the result
+    lsst::geom::Box2I getBBox() const noexcept { return _bbox; }
+
+private:
+    template <bool useVariance>
+    void _add(lsst::afw::image::MaskedImage<PixelT> const& maskedImage, double weight);
+
+    lsst::geom::Box2I _bbox;
+    Property _flags;
+    StatisticsControl _sctrl;
+    image::MaskPixel _clipped;
+    image::MaskPixel _clippedMask;     // input bits that cause _clipped to be set
+    std::vector<int> _propagatedBits;  // mask bits with a propagation threshold < 1
+    int _numInputs;
+    // per-pixel accumulators
+    std::vector<int> _n;                     // number of accepted values
+    std::vector<double> _sumw;               // sum(weight)
+    std::vector<double> _sumw2;              // sum(weight^2)
+    std::vector<double> _mean;               // running weighted mean
+    std::vector<double> _m2;                 // running sum(weight*(value - mean)^2)
+    std::vector<double> _sumvw;              // sum(variance*weight^2), or sum(variance*weight) if mosaicking
+    std::vector<image::MaskPixel> _orMask;   // OR of the masks of the accepted values
+    std::vector<image::MaskPixel> _allMask;  // OR of the masks of all the values
+    std::vector<double> _rejectedWeights;    // rejected weight for each of _propagatedBits, bit-major
+};
+
 /* ****************************************************************** *
  *
  * x,y stacks
@@ -100,7 +100,8 @@ public:
               _useWeights(useWeights),
               _calcErrorFromInputVariance(false),
               _calcErrorMosaicMode(false),
-              _maskPropagationThresholds() {
+              _maskPropagationThresholds(),
+              _numThreads(1) {
         try {
             _noGoodPixelsMask = lsst::afw::image::Mask<>::getPlaneBitMask("NO_DATA");
         } catch (lsst::pex::exceptions::InvalidParameterError const &) {
@@ -130,6 +131,8 @@ public:
     bool getWeightedIsSet() const noexcept { return _useWeights != WEIGHTS_NONE ? true : false; }
     bool getCalcErrorFromInputVariance() const noexcept { return _calcErrorFromInputVariance; }
     bool getCalcErrorMosaicMode() const noexcept { return _calcErrorMosaicMode; }
+    /// Number of threads used by statisticsStack; 0 for one per hardware thread
+    int getNumThreads() const noexcept { return _numThreads; }
 
     void setNumSigmaClip(double numSigmaClip) {
         if (!(numSigmaClip > 0)) {
@@ -155,6 +158,13 @@ public:
     void setCalcErrorMosaicMode(bool calcErrorMosaicMode) noexcept {
         _calcErrorMosaicMode = calcErrorMosaicMode;
     }
+    void setNumThreads(int numThreads) {
+        if (numThreads < 0) {
+            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                              "numThreads must be >= 0 (0 means one per hardware thread)");
+        }
+        _numThreads = numThreads;
+    }
 
 private:
     friend class Statistics;
@@ -169,6 +179,7 @@ private:
     bool _calcErrorMosaicMode;         // Calculate errors by taking mean of input variances
     std::vector<double> _maskPropagationThresholds;  // Thresholds for when to propagate mask bits,
                                                      // treated like a dict (unset bits are set to 1.0)
+    int _numThreads;                   // Number of threads used by statisticsStack; 0 for one per core
 };
 
 /**
@@ -69,6 +69,14 @@ public:
 
     using BoundedField::evaluate;
 
+    /**
+     *  @copydoc BoundedField::evaluateGrid
+     *
+     *  The whole grid is transformed with a single call to the underlying mapping.
+     */
+    ndarray::Array<double, 2, 2> evaluateGrid(ndarray::Array<double const, 1> const &x,
+                                              ndarray::Array<double const, 1> const &y) const override;
+
     /// TransformBoundedField is always persistable.
     bool isPersistable() const noexcept override { return true; }
 
@@ -29,6 +29,7 @@
  */
 #include <memory>
 #include <sstream>
+#include <type_traits>
 
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/geom.h"
@@ -86,8 +87,9 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage,
  *
  * The Algorithm:
  * - If the kernel is spatially varying and contains only DeltaFunctionKernels
- *   then convolves the input Image by each basis kernel in turn, solves the spatial model
- *   for that component and adds in the appropriate amount of the convolved %image.
+ *   then each output row is the sum of the input rows shifted by each basis kernel's pixel,
+ *   weighted by that component's spatial model evaluated along the row; this is exact,
+ *   so maxInterpolationDistance is ignored.
  * - In all other cases uses normal convolution
  *
  * @param[out] convolvedImage convolved %image
@@ -148,6 +150,93 @@ void convolveWithBruteForce(OutImageT& convolvedImage, InImageT const& inImage,
                             lsst::afw::math::Kernel const& kernel,
                             lsst::afw::math::ConvolutionControl const& convolutionControl);
 
+/**
+ * Convolve an Image or MaskedImage with a Kernel using several threads.
+ *
+ * The good region of convolvedImage is split into bands of rows; each band is convolved
+ * by basicConvolve on its own thread, using views of the input and output images and its own
+ * clone of the kernel (computing a spatially varying kernel image modifies the kernel).
+ * Band boundaries are multiples of the kernel height (relative to the first good row),
+ * which keeps the order of operations, and hence every output pixel, identical to basicConvolve.
+ *
+ * Kernels that basicConvolve would convolve with linear interpolation are not split into bands
+ * (a LinearCombinationKernel with a delta-function basis is never interpolated),
+ * because the interpolation subregions depend on the size of the image being convolved;
+ * instead convolveWithInterpolation convolves its subregions concurrently.
+ *
+ * Like basicConvolve, this does not set edge pixels.
+ *
+ * @param[out] convolvedImage convolved %image
+ * @param[in] inImage %image to convolve
+ * @param[in] kernel convolution kernel
+ * @param[in] convolutionControl convolution control parameters; getNumThreads sets the number of bands
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if convolvedImage dimensions != inImage dimensions
+ * @throws lsst::pex::exceptions::InvalidParameterError if inImage smaller than kernel in width or height
+ * @throws lsst::pex::exceptions::InvalidParameterError if kernel width or height < 1
+ * @throws lsst::pex::exceptions::InvalidParameterError if convolutionControl.getNumThreads() < 0
+ */
+template <typename OutImageT, typename InImageT>
+void convolveInRowBands(OutImageT& convolvedImage, InImageT const& inImage,
+                        lsst::afw::math::Kernel const& kernel,
+                        lsst::afw::math::ConvolutionControl const& convolutionControl);
+
+/**
+ * Can convolveWithFft convolve images of these types?
+ *
+ * True for Images (not MaskedImages) whose output pixels are floating point.
+ */
+template <typename OutImageT, typename InImageT>
+struct IsFftConvolvable
+        : std::integral_constant<
+                  bool, std::is_same<typename lsst::afw::image::detail::image_traits<OutImageT>::image_category,
+                                     lsst::afw::image::detail::Image_tag>::value &&
+                                std::is_same<typename lsst::afw::image::detail::image_traits<
+                                                     InImageT>::image_category,
+                                             lsst::afw::image::detail::Image_tag>::value &&
+                                std::is_floating_point<typename OutImageT::SinglePixel>::value> {};
+
+/**
+ * Should convolve use convolveWithFft for this kernel?
+ *
+ * True if convolutionControl.getMinFftKernelSize() > 0, the kernel is spatially invariant, is neither
+ * a DeltaFunctionKernel nor a SeparableKernel, and is at least that size along both axes.
+ */
+bool shouldConvolveWithFft(lsst::afw::math::Kernel const& kernel,
+                           lsst::afw::math::ConvolutionControl const& convolutionControl);
+
+/**
+ * Convolve an Image with a spatially invariant Kernel using fast Fourier transforms.
+ *
+ * The good region of the output is divided into tiles that are convolved independently
+ * (the overlap-save method): each tile of input, which overlaps its neighbors by the kernel size - 1,
+ * is transformed, multiplied by the transform of the kernel image and transformed back.
+ * The transform size is a few times the kernel size, so memory use is bounded regardless of image size.
+ * Tiles are convolved concurrently if convolutionControl.getNumThreads() is not 1.
+ *
+ * Input tiles that contain non-finite pixels are convolved in real space, so NaNs and infinities
+ * propagate exactly as they do in real-space convolution (including not propagating through
+ * kernel pixels that are exactly zero). Elsewhere the result agrees with real-space convolution
+ * to within floating-point round-off.
+ *
+ * Like basicConvolve, this does not set edge pixels.
+ *
+ * @param[out] convolvedImage convolved %image
+ * @param[in] inImage %image to convolve
+ * @param[in] kernel convolution kernel
+ * @param[in] convolutionControl convolution control parameters
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if convolvedImage dimensions != inImage dimensions
+ * @throws lsst::pex::exceptions::InvalidParameterError if inImage smaller than kernel in width or height
+ * @throws lsst::pex::exceptions::InvalidParameterError if kernel width or height < 1
+ * @throws lsst::pex::exceptions::InvalidParameterError if kernel is spatially varying
+ * @throws std::bad_alloc when allocation of CPU memory fails
+ */
+template <typename OutImageT, typename InImageT>
+void convolveWithFft(OutImageT& convolvedImage, InImageT const& inImage,
+                     lsst::afw::math::Kernel const& kernel,
+                     lsst::afw::math::ConvolutionControl const& convolutionControl);
+
 // I would prefer this to be nested in KernelImagesForRegion but SWIG doesn't support that
 class RowOfKernelImagesForRegion;
 
@@ -280,12 +369,30 @@ public:
 private:
     using LocationList = std::vector<Location>;
 
+    /*
+     * Kernel parameters at the corners of all subregions of a region, computed in one batched pass
+     * over the spatial model and shared by the subregions
+     */
+    struct KernelParameterGrid {
+        std::vector<int> xIndexList;  ///< pixel index of each grid column, ascending
+        std::vector<int> yIndexList;  ///< pixel index of each grid row, ascending
+        ndarray::Array<double const, 3, 3> kernelParams;  ///< indexed as [kernel parameter, row, column]
+    };
+
     /**
      * Compute image at a particular location
      *
      * @throws lsst::pex::exceptions::NotFoundError if there is no pointer at that location
      */
     void _computeImage(Location location) const;
+    /**
+     * Compute the kernel parameters at the corners of the nx x ny subregions of this region
+     *
+     * Does nothing if the kernel is not spatially varying or has its image cache enabled (so that
+     * cached, position-snapped images are used as before), in which case _computeImage
+     * evaluates the spatial model at each corner.
+     */
+    void _computeKernelParameterGrid(int nx, int ny) const;
     inline void _insertImage(Location location, ImagePtr imagePtr) const;
     /**
      * Move the region up one segment
@@ -322,6 +429,7 @@ private:
     lsst::geom::Point2I _xy0;
     bool _doNormalize;
     mutable std::vector<ImagePtr> _imagePtrList;
+    mutable std::shared_ptr<KernelParameterGrid const> _kernelParameterGrid;  ///< null if not computed
 
     static int const _MinInterpolationSize;
 };
@@ -400,6 +508,10 @@ private:
  *
  * Note that this routine will also work with spatially invariant kernels, but not efficiently.
  *
+ * If convolutionControl.getNumThreads() is not 1, the subregions of each row of subregions are
+ * convolved concurrently, each thread using its own working kernel images. The subregions and
+ * their corner kernel images are the same as in the single-threaded case, so is the result.
+ *
  * @param[out] outImage convolved image = inImage convolved with kernel
  * @param[in] inImage input image
  * @param[in] kernel convolution kernel
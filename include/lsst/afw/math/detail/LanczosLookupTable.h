@@ -0,0 +1,126 @@
+// -*- LSST-C++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_MATH_DETAIL_LANCZOSLOOKUPTABLE_H
+#define LSST_AFW_MATH_DETAIL_LANCZOSLOOKUPTABLE_H
+
+#include <memory>
+#include <vector>
+
+namespace lsst {
+namespace afw {
+namespace math {
+
+class SeparableKernel;
+
+namespace detail {
+
+/**
+ * A finely sampled table of the values of a Lanczos warping kernel, used in place of evaluating the
+ * Lanczos function for each warped pixel
+ *
+ * The table holds the 2*order kernel values at fractional pixel offsets 0, 1/resolution, ..., 1;
+ * kernel values at other offsets are linearly interpolated between the two nearest samples.
+ * Tables are immutable and shared: there is one per Lanczos order, which may be used concurrently
+ * by any number of threads.
+ */
+class LanczosLookupTable final {
+public:
+    /// Number of samples per pixel of fractional offset
+    static int const resolution = 4096;
+
+    /**
+     * Get the lookup table for a warping kernel
+     *
+     * @param kernel warping kernel
+     * @returns the shared lookup table if kernel is a LanczosWarpingKernel with the default center
+     *          and no spatial variation, else a null pointer
+     */
+    static std::shared_ptr<LanczosLookupTable const> get(SeparableKernel const &kernel);
+
+    /**
+     * Get the lookup table for a Lanczos warping kernel of a given order
+     *
+     * @param order order of Lanczos function
+     *
+     * @throws lsst::pex::exceptions::InvalidParameterError if order < 1
+     */
+    static std::shared_ptr<LanczosLookupTable const> get(int order);
+
+    /// Construct a table; use get() to obtain a shared instance instead
+    explicit LanczosLookupTable(int order);
+
+    LanczosLookupTable(LanczosLookupTable const &) = delete;
+    LanczosLookupTable(LanczosLookupTable &&) = delete;
+    LanczosLookupTable &operator=(LanczosLookupTable const &) = delete;
+    LanczosLookupTable &operator=(LanczosLookupTable &&) = delete;
+    ~LanczosLookupTable() noexcept = default;
+
+    /// Get the order of the Lanczos function
+    int getOrder() const noexcept { return _order; }
+
+    /// Get the number of kernel values (the width and height of the kernel)
+    int getSize() const noexcept { return 2 * _order; }
+
+    /**
+     * Compute the kernel values for one axis
+     *
+     * Equivalent to setting the corresponding kernel parameter of a LanczosWarpingKernel to `frac`
+     * and computing its vectors, to within the error of linear interpolation (a few parts in 10^8).
+     *
+     * @param[out] values kernel values; must have getSize() elements
+     * @param[in] frac fractional pixel offset, in the range [0, 1]
+     * @returns the sum of the kernel values
+     */
+    double computeValues(double *values, double frac) const noexcept {
+        int const size = getSize();
+        double const pos = frac * resolution;
+        int ind = static_cast<int>(pos);
+        if (ind >= resolution) {
+            ind = resolution - 1;
+        } else if (ind < 0) {
+            ind = 0;
+        }
+        double const weight = pos - ind;
+        double const *low = _table.data() + ind * size;
+        double const *high = low + size;
+        double sum = 0;
+        for (int i = 0; i < size; ++i) {
+            values[i] = low[i] + weight * (high[i] - low[i]);
+            sum += values[i];
+        }
+        return sum;
+    }
+
+private:
+    int _order;
+    std::vector<double> _table;  ///< (resolution + 1) rows of getSize() kernel values
+};
+
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !defined(LSST_AFW_MATH_DETAIL_LANCZOSLOOKUPTABLE_H)
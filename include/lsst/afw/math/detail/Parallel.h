@@ -0,0 +1,116 @@
+// -*- LSST-C++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSST_AFW_MATH_DETAIL_PARALLEL_H
+#define LSST_AFW_MATH_DETAIL_PARALLEL_H
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+
+/**
+ * Resolve a user-supplied thread count.
+ *
+ * @param nThreads requested number of threads; 0 means as many as allowed.
+ * @returns a thread count >= 1, no more than the limit set for this thread through the
+ *          execution-context API (see lsst/afw/math/ExecutionContext.h).
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if nThreads < 0.
+ */
+int resolveNumThreads(int nThreads);
+
+/**
+ * Split the half-open range [begin, end) into at most nParts contiguous, non-empty pieces.
+ *
+ * Every piece but the last starts at begin plus a multiple of `alignment`, so algorithms whose
+ * operation order depends on position modulo some period (e.g. a circular row buffer) behave
+ * identically on each piece and on the whole range.
+ *
+ * @param begin first index of the range
+ * @param end one past the last index of the range
+ * @param nParts maximum number of pieces; values < 1 are treated as 1
+ * @param alignment granularity of piece boundaries; values < 1 are treated as 1
+ * @returns list of (begin, end) pairs, in increasing order; empty if end <= begin
+ */
+std::vector<std::pair<int, int>> splitRange(int begin, int end, int nParts, int alignment = 1);
+
+/**
+ * Call `func(i)` for each i in [0, n), spreading the calls over up to nThreads threads.
+ *
+ * The calling thread participates in the work, helped by threads from afw's shared pool.  Parallel
+ * calls made by `func` itself run serially. Each index is processed exactly once, but in no
+ * particular order, so `func` must be safe to call concurrently for distinct indices.
+ * If any call throws, the remaining unstarted indices are skipped and the first exception
+ * is rethrown on the calling thread once all threads have finished.
+ *
+ * @param n number of work items
+ * @param nThreads maximum number of threads to use (see resolveNumThreads)
+ * @param func function to call for each work item
+ */
+void parallelFor(int n, int nThreads, std::function<void(int)> const& func);
+
+/**
+ * Sort the range [first, last) with `cmp`, spreading the work over up to nThreads threads.
+ *
+ * The range is split into pieces that are sorted concurrently and then merged pairwise, with the
+ * merges of each round also done concurrently.  Like std::sort, this is not stable.
+ *
+ * @param first, last range to sort; it must hold fewer than 2^31 elements
+ * @param cmp strict weak ordering of the elements
+ * @param nThreads maximum number of threads to use (see resolveNumThreads)
+ */
+template <typename RandomIt, typename Compare>
+void parallelSort(RandomIt first, RandomIt last, Compare cmp, int nThreads) {
+    std::vector<std::pair<int, int>> pieces = splitRange(0, static_cast<int>(last - first), nThreads);
+    parallelFor(static_cast<int>(pieces.size()), nThreads, [&](int i) {
+        std::sort(first + pieces[i].first, first + pieces[i].second, cmp);
+    });
+    while (pieces.size() > 1) {
+        std::vector<std::pair<int, int>> merged((pieces.size() + 1) / 2);
+        parallelFor(static_cast<int>(merged.size()), nThreads, [&](int i) {
+            std::size_t const a = 2 * i, b = 2 * i + 1;
+            if (b < pieces.size()) {
+                std::inplace_merge(first + pieces[a].first, first + pieces[b].first, first + pieces[b].second,
+                                   cmp);
+                merged[i] = std::make_pair(pieces[a].first, pieces[b].second);
+            } else {
+                merged[i] = pieces[a];
+            }
+        });
+        pieces.swap(merged);
+    }
+}
+
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !defined(LSST_AFW_MATH_DETAIL_PARALLEL_H)
@@ -34,6 +34,14 @@ public:
      * @param[out] dydx derivatives at x
      */
     void derivative(std::vector<double> const& x, std::vector<double>& dydx) const;
+    /**
+     * Interpolate a Spline and find its derivative in the same pass.
+     *
+     * @param[in] x points to evaluate at; evaluation is fastest if they are sorted in increasing order
+     * @param[out] y values of spline interpolation at x
+     * @param[out] dydx derivatives at x
+     */
+    void interpolate(std::vector<double> const& x, std::vector<double>& y, std::vector<double>& dydx) const;
 
     /**
      * Find the roots of
@@ -51,6 +59,10 @@ protected:
      * Allocate the storage a Spline needs
      */
     void _allocateSpline(int const nknot);
+    /**
+     * Evaluate the spline (if y is not null) and its derivative (if dydx is not null) at n points x
+     */
+    void _evaluate(double const* x, int n, double* y, double* dydx) const;
 
     std::vector<double> _knots;                 // positions of knots
     std::vector<std::vector<double> > _coeffs;  // and associated coefficients
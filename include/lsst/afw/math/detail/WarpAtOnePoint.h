@@ -21,9 +21,12 @@
  * the GNU General Public License along with this program.  If not,
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
+#include <algorithm>
+#include <memory>
 #include <vector>
 
 #include "lsst/afw/math/Kernel.h"
+#include "lsst/afw/math/detail/LanczosLookupTable.h"
 #include "lsst/afw/image/Image.h"
 #include "lsst/afw/image/MaskedImage.h"
 #include "lsst/geom/Point.h"
@@ -33,6 +36,40 @@ namespace afw {
 namespace math {
 namespace detail {
 
+/**
+ * The rows of the planes of a warping source
+ *
+ * Only MaskedImage sources need them (see WarpAtOnePoint::_convolveSeparableMasked); for anything else this
+ * is empty.  Row iterators touch no reference counts, so they may be used by many threads at once.
+ */
+template <typename SrcImageT>
+struct WarpSourceRows {
+    explicit WarpSourceRows(SrcImageT const &) {}
+};
+
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+struct WarpSourceRows<lsst::afw::image::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>> {
+    explicit WarpSourceRows(
+            lsst::afw::image::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT> const &srcImage)
+            : image(getRows(*srcImage.getImage())),
+              mask(getRows(*srcImage.getMask())),
+              variance(getRows(*srcImage.getVariance())) {}
+
+    template <typename ImageT>
+    static std::vector<typename ImageT::x_iterator> getRows(ImageT const &img) {
+        std::vector<typename ImageT::x_iterator> rows;
+        rows.reserve(img.getHeight());
+        for (int y = 0; y < img.getHeight(); ++y) {
+            rows.push_back(img.row_begin(y));
+        }
+        return rows;
+    }
+
+    std::vector<typename lsst::afw::image::Image<ImagePixelT>::x_iterator> image;
+    std::vector<typename lsst::afw::image::Mask<MaskPixelT>::x_iterator> mask;
+    std::vector<typename lsst::afw::image::Image<VariancePixelT>::x_iterator> variance;
+};
+
 /**
  * A functor that computes one warped pixel
  */
@@ -53,7 +90,17 @@ public:
               _maskXList(_maskKernelPtr ? _maskKernelPtr->getWidth() : 0),
               _maskYList(_maskKernelPtr ? _maskKernelPtr->getHeight() : 0),
               _padValue(padValue),
-              _srcGoodBBox(_kernelPtr->shrinkBBox(srcImage.getBBox(lsst::afw::image::LOCAL))){};
+              _srcGoodBBox(_kernelPtr->shrinkBBox(srcImage.getBBox(lsst::afw::image::LOCAL))),
+              _lanczosTablePtr(control.getUseLanczosLookupTable() ? LanczosLookupTable::get(*_kernelPtr)
+                                                                   : nullptr),
+              _maskLanczosTablePtr(control.getUseLanczosLookupTable() && _maskKernelPtr
+                                           ? LanczosLookupTable::get(*_maskKernelPtr)
+                                           : nullptr),
+              _srcRows(_srcImage),
+              _colSumList(_kernelPtr->getWidth()),
+              _colVarianceSumList(_kernelPtr->getWidth()),
+              _colMaskList(_kernelPtr->getWidth()),
+              _colMaskKernelMaskList(_kernelPtr->getWidth()){};
 
     /**
      * Compute one warped pixel, Image specialization
@@ -84,6 +131,12 @@ public:
             // Compute warped pixel
             double kSum = _setFracIndex(srcIndFracX.second, srcIndFracY.second);
 
+            if (_lanczosTablePtr) {
+                *destXIter = static_cast<typename DestImageT::SinglePixel>(
+                        _convolveSeparable(srcStartX, srcStartY) * (relativeArea / kSum));
+                return true;
+            }
+
             typename SrcImageT::const_xy_locator srcLoc = _srcImage.xy_at(srcStartX, srcStartY);
 
             *destXIter = lsst::afw::math::convolveAtAPoint<DestImageT, SrcImageT>(srcLoc, _xList, _yList);
@@ -100,7 +153,8 @@ public:
      * Compute one warped pixel, MaskedImage specialization
      *
      * The MaskedImage specialization uses the mask warping kernel, if present, to compute the mask plane;
-     * otherwise it uses the normal kernel to compute the mask plane.
+     * otherwise it uses the normal kernel to compute the mask plane.  All three planes are computed in a
+     * single pass over the source pixels; see _convolveSeparableMasked.
      */
     bool operator()(typename DestImageT::x_iterator &destXIter, lsst::geom::Point2D const &srcPos,
                     double relativeArea, lsst::afw::image::detail::MaskedImage_tag) {
@@ -125,42 +179,7 @@ public:
 
             // Compute warped pixel
             double kSum = _setFracIndex(srcIndFracX.second, srcIndFracY.second);
-
-            typename SrcImageT::const_xy_locator srcLoc = _srcImage.xy_at(srcStartX, srcStartY);
-
-            *destXIter = lsst::afw::math::convolveAtAPoint<DestImageT, SrcImageT>(srcLoc, _xList, _yList);
-            *destXIter *= relativeArea / kSum;
-
-            if (_hasMaskKernel) {
-                // compute mask value based on the mask kernel (replacing the value computed above)
-                int maskStartX = srcIndFracX.first - _maskKernelCtr[0];
-                int maskStartY = srcIndFracY.first - _maskKernelCtr[1];
-
-                typename SrcImageT::Mask::const_xy_locator srcMaskLoc =
-                        _srcImage.getMask()->xy_at(maskStartX, maskStartY);
-
-                using k_iter = typename std::vector<lsst::afw::math::Kernel::Pixel>::const_iterator;
-
-                typename DestImageT::Mask::SinglePixel destMaskValue = 0;
-                for (double kValY : _maskYList) {
-                    typename DestImageT::Mask::SinglePixel destMaskValueY = 0;
-                    for (k_iter kernelXIter = _maskXList.begin(), xEnd = _maskXList.end();
-                         kernelXIter != xEnd; ++kernelXIter, ++srcMaskLoc.x()) {
-                        typename lsst::afw::math::Kernel::Pixel const kValX = *kernelXIter;
-                        if (kValX != 0) {
-                            destMaskValueY |= *srcMaskLoc;
-                        }
-                    }
-
-                    if (kValY != 0) {
-                        destMaskValue |= destMaskValueY;
-                    }
-
-                    srcMaskLoc += lsst::afw::image::detail::difference_type(-_maskXList.size(), 1);
-                }
-
-                destXIter.mask() = (destXIter.mask() & _growFullMask) | destMaskValue;
-            }
+            *destXIter = _convolveSeparableMasked(srcStartX, srcStartY, relativeArea / kSum);
             return true;
         } else {
             // Edge pixel
@@ -177,15 +196,128 @@ private:
      */
     double _setFracIndex(double xFrac, double yFrac) {
         std::pair<double, double> srcFracInd(xFrac, yFrac);
-        _kernelPtr->setKernelParameters(srcFracInd);
-        double kSum = _kernelPtr->computeVectors(_xList, _yList, false);
-        if (_maskKernelPtr) {
+        double kSum;
+        if (_lanczosTablePtr) {
+            kSum = _lanczosTablePtr->computeValues(_xList.data(), xFrac) *
+                   _lanczosTablePtr->computeValues(_yList.data(), yFrac);
+        } else {
+            _kernelPtr->setKernelParameters(srcFracInd);
+            kSum = _kernelPtr->computeVectors(_xList, _yList, false);
+        }
+        if (_maskLanczosTablePtr) {
+            _maskLanczosTablePtr->computeValues(_maskXList.data(), xFrac);
+            _maskLanczosTablePtr->computeValues(_maskYList.data(), yFrac);
+        } else if (_maskKernelPtr) {
             _maskKernelPtr->setKernelParameters(srcFracInd);
             _maskKernelPtr->computeVectors(_maskXList, _maskYList, false);
         }
         return kSum;
     }
 
+    /**
+     * Apply the separable kernel (_xList, _yList) to the source image at one point, Image only
+     *
+     * Weighted source rows are first accumulated into per-column sums and only then combined
+     * with _xList. The inner loop runs over contiguous source pixels with no dependency between
+     * iterations, so the compiler can vectorize it; sums are accumulated in double precision.
+     *
+     * @returns the unnormalized kernel sum
+     */
+    double _convolveSeparable(int srcStartX, int srcStartY) {
+        int const width = _xList.size();
+        int const height = _yList.size();
+        double *const colSums = _colSumList.data();
+        std::fill(_colSumList.begin(), _colSumList.end(), 0.0);
+        for (int j = 0; j < height; ++j) {
+            double const kValY = _yList[j];
+            typename SrcImageT::x_iterator const srcIter = _srcImage.x_at(srcStartX, srcStartY + j);
+            for (int i = 0; i < width; ++i) {
+                colSums[i] += static_cast<double>(srcIter[i]) * kValY;
+            }
+        }
+        double sum = 0;
+        for (int i = 0; i < width; ++i) {
+            sum += colSums[i] * _xList[i];
+        }
+        return sum;
+    }
+
+    /**
+     * Apply the separable kernel to the image, variance and mask of the source at one point, MaskedImage only
+     *
+     * The source window is visited once.  Each of its rows with a nonzero weight in _yList is accumulated
+     * into per-column sums of the image (weighted by _yList) and variance (weighted by _yList^2) and
+     * per-column ORs of the mask; each row with a nonzero weight in _maskYList is also ORed into the mask
+     * of the mask kernel, whose window lies within that of the main kernel.  The columns with nonzero
+     * weights in _xList (and _maskXList) are then combined, exactly as convolveAtAPoint would, except that
+     * sums are accumulated in double precision.
+     *
+     * @param[in] srcStartX, srcStartY  Source pixel under pixel (0, 0) of the kernel.
+     * @param[in] scale  Factor by which to multiply the image (and its square, the variance).
+     * @returns the warped pixel; if there is a mask kernel, its mask is that of the mask kernel combined
+     *     with the bits of growFullMask set by the main kernel
+     */
+    typename DestImageT::SinglePixel _convolveSeparableMasked(int srcStartX, int srcStartY, double scale) {
+        using MaskPixelT = lsst::afw::image::MaskPixel;
+        int const width = _xList.size();
+        int const height = _yList.size();
+        // the position of the mask kernel's window within that of the main kernel
+        int const maskOffsetX = _kernelCtr[0] - _maskKernelCtr[0];
+        int const maskOffsetY = _kernelCtr[1] - _maskKernelCtr[1];
+        int const maskHeight = _maskYList.size();
+
+        double *const colSums = _colSumList.data();
+        double *const colVarianceSums = _colVarianceSumList.data();
+        MaskPixelT *const colMasks = _colMaskList.data();
+        MaskPixelT *const colMaskKernelMasks = _colMaskKernelMaskList.data();
+        std::fill(_colSumList.begin(), _colSumList.end(), 0.0);
+        std::fill(_colVarianceSumList.begin(), _colVarianceSumList.end(), 0.0);
+        std::fill(_colMaskList.begin(), _colMaskList.end(), 0);
+        std::fill(_colMaskKernelMaskList.begin(), _colMaskKernelMaskList.end(), 0);
+        for (int j = 0; j < height; ++j) {
+            auto const srcImage = _srcRows.image[srcStartY + j] + srcStartX;
+            auto const srcMask = _srcRows.mask[srcStartY + j] + srcStartX;
+            double const kValY = _yList[j];
+            if (kValY != 0) {
+                double const kValY2 = kValY * kValY;
+                auto const srcVariance = _srcRows.variance[srcStartY + j] + srcStartX;
+                for (int i = 0; i < width; ++i) {
+                    colSums[i] += static_cast<double>(srcImage[i]) * kValY;
+                    colVarianceSums[i] += static_cast<double>(srcVariance[i]) * kValY2;
+                    colMasks[i] |= static_cast<MaskPixelT>(srcMask[i]);
+                }
+            }
+            int const maskJ = j - maskOffsetY;
+            if (_hasMaskKernel && maskJ >= 0 && maskJ < maskHeight && _maskYList[maskJ] != 0) {
+                for (int i = 0, maskWidth = _maskXList.size(); i < maskWidth; ++i) {
+                    colMaskKernelMasks[i] |= static_cast<MaskPixelT>(srcMask[i + maskOffsetX]);
+                }
+            }
+        }
+
+        double sum = 0;
+        double varianceSum = 0;
+        MaskPixelT mask = 0;
+        for (int i = 0; i < width; ++i) {
+            double const kValX = _xList[i];
+            if (kValX != 0) {
+                sum += colSums[i] * kValX;
+                varianceSum += colVarianceSums[i] * kValX * kValX;
+                mask |= colMasks[i];
+            }
+        }
+        if (_hasMaskKernel) {
+            MaskPixelT maskKernelMask = 0;
+            for (int i = 0, maskWidth = _maskXList.size(); i < maskWidth; ++i) {
+                if (_maskXList[i] != 0) {
+                    maskKernelMask |= colMaskKernelMasks[i];
+                }
+            }
+            mask = (mask & _growFullMask) | maskKernelMask;
+        }
+        return typename DestImageT::SinglePixel(sum * scale, mask, varianceSum * scale * scale);
+    }
+
     SrcImageT _srcImage;
     std::shared_ptr<lsst::afw::math::SeparableKernel> _kernelPtr;
     std::shared_ptr<lsst::afw::math::SeparableKernel> _maskKernelPtr;
@@ -199,6 +331,13 @@ private:
     std::vector<double> _maskYList;
     typename DestImageT::SinglePixel _padValue;
     lsst::geom::Box2I const _srcGoodBBox;
+    std::shared_ptr<LanczosLookupTable const> _lanczosTablePtr;      ///< null unless using the table
+    std::shared_ptr<LanczosLookupTable const> _maskLanczosTablePtr;  ///< null unless using the table
+    WarpSourceRows<SrcImageT> _srcRows;  ///< the rows of _srcImage, for _convolveSeparableMasked
+    std::vector<double> _colSumList;  ///< per-column sums for _convolveSeparable(Masked)
+    std::vector<double> _colVarianceSumList;  ///< per-column variance sums for _convolveSeparableMasked
+    std::vector<lsst::afw::image::MaskPixel> _colMaskList;  ///< per-column ORs of the mask
+    std::vector<lsst::afw::image::MaskPixel> _colMaskKernelMaskList;  ///< same, for the mask kernel
 };
 }  // namespace detail
 }  // namespace math
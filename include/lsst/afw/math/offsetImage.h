@@ -40,25 +40,33 @@ namespace math {
  * @param buffer Width of buffer (border) around kernel image to allow for warping edge
  *               effects (pixels). Values < 0 are treated as 0. This is only used during
  *               computation; the final image has the same dimensions as the kernel.
+ * @param numThreads number of threads to use for the convolution; 0 means one per hardware thread
  *
  * @note The image pixels are always offset by a fraction of a pixel and the image origin (XY0)
  * picks is modified to handle the integer portion of the offset.
  * In the special case that the offset in both x and y lies in the range (-1, 1) the origin is not changed.
  * Otherwise the pixels are shifted by (-0.5, 0.5] pixels and the origin shifted accordingly.
  *
- * @throws lsst::pex::exceptions::InvalidParameterError if the algorithm is invalid
+ * The warping kernel for each algorithm is built once per thread and reused by later calls, which
+ * matters when many small images (e.g. PSF models) are offset.
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if the algorithm is invalid or numThreads < 0
  */
 template <typename ImageT>
 std::shared_ptr<ImageT> offsetImage(ImageT const& image, float dx, float dy,
-                                    std::string const& algorithmName = "lanczos5", unsigned int buffer = 0);
+                                    std::string const& algorithmName = "lanczos5", unsigned int buffer = 0,
+                                    int numThreads = 1);
 /**
  * Rotate an image by an integral number of quarter turns
  *
  * @param image The %image to rotate
  * @param nQuarter the desired number of quarter turns
+ * @param numThreads number of threads to use; 0 means one per hardware thread
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
  */
 template <typename ImageT>
-std::shared_ptr<ImageT> rotateImageBy90(ImageT const& image, int nQuarter);
+std::shared_ptr<ImageT> rotateImageBy90(ImageT const& image, int nQuarter, int numThreads = 1);
 
 /**
  * Flip an image left--right and/or top--bottom
@@ -66,26 +74,37 @@ std::shared_ptr<ImageT> rotateImageBy90(ImageT const& image, int nQuarter);
  * @param inImage The %image to flip
  * @param flipLR Flip left <--> right?
  * @param flipTB Flip top <--> bottom?
+ * @param numThreads number of threads to use; 0 means one per hardware thread
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
  */
 template <typename ImageT>
-std::shared_ptr<ImageT> flipImage(ImageT const& inImage, bool flipLR, bool flipTB);
+std::shared_ptr<ImageT> flipImage(ImageT const& inImage, bool flipLR, bool flipTB, int numThreads = 1);
 /**
  * @param inImage The %image to bin
  * @param binX Output pixels are binX*binY input pixels
  * @param binY Output pixels are binX*binY input pixels
  * @param flags how to generate super-pixels
+ * @param numThreads number of threads to use; 0 means one per hardware thread
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
  */
 template <typename ImageT>
 std::shared_ptr<ImageT> binImage(ImageT const& inImage, int const binX, int const binY,
-                                 lsst::afw::math::Property const flags = lsst::afw::math::MEAN);
+                                 lsst::afw::math::Property const flags = lsst::afw::math::MEAN,
+                                 int numThreads = 1);
 /**
  * @param inImage The %image to bin
  * @param binsize Output pixels are binsize*binsize input pixels
  * @param flags how to generate super-pixels
+ * @param numThreads number of threads to use; 0 means one per hardware thread
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0
  */
 template <typename ImageT>
 std::shared_ptr<ImageT> binImage(ImageT const& inImage, int const binsize,
-                                 lsst::afw::math::Property const flags = lsst::afw::math::MEAN);
+                                 lsst::afw::math::Property const flags = lsst::afw::math::MEAN,
+                                 int numThreads = 1);
 }  // namespace math
 }  // namespace afw
 }  // namespace lsst
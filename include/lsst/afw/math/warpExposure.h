@@ -29,8 +29,11 @@
 #ifndef LSST_AFW_MATH_WARPEXPOSURE_H
 #define LSST_AFW_MATH_WARPEXPOSURE_H
 
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "lsst/base.h"
 #include "lsst/pex/exceptions.h"
@@ -292,14 +295,18 @@ public:
             int cacheSize = 0,  ///< cache size for warping kernel; no cache if 0
             ///< (used as the argument to the warping kernels' computeCache method)
             int interpLength = 0,  ///< distance over which the WCS can be linearly interpolated
-            lsst::afw::image::MaskPixel growFullMask = 0
+            lsst::afw::image::MaskPixel growFullMask = 0,
             ///< mask bits to grow to full width of image/variance kernel
+            int numThreads = 1  ///< number of threads to use; 0 for one per hardware thread
             )
             : _warpingKernelPtr(makeWarpingKernel(warpingKernelName)),
               _maskWarpingKernelPtr(),
               _cacheSize(cacheSize),
               _interpLength(interpLength),
-              _growFullMask(growFullMask) {
+              _growFullMask(growFullMask),
+              _numThreads(numThreads),
+              _useLanczosLookupTable(false),
+              _maxInterpError(0) {
         setMaskWarpingKernelName(maskWarpingKernelName);
     }
 
@@ -341,6 +348,31 @@ public:
         _interpLength = interpLength;
     };
 
+    /**
+     * get the maximum error of adaptive interpolation (source pixels); 0 if interpolation is not adaptive
+     */
+    double getMaxInterpError() const { return _maxInterpError; }
+
+    /**
+     * set the maximum error of adaptive interpolation
+     *
+     * If > 0 and interpLength > 0, source positions are interpolated over destination tiles
+     * of adaptive size, instead of fixed bands interpLength pixels wide: the destination image is
+     * covered by tiles interpLength pixels on a side, each of which is recursively split until
+     * bilinear interpolation of the source positions at its corners matches the transform
+     * to within maxInterpError source pixels at the midpoints of its edges and at its center.
+     * This evaluates the transform sparsely where it is smooth and densely where it is not.
+     * The number of transform evaluations made and saved is logged at debug level
+     * to "lsst.afw.math.warp".
+     * 0 (the default) disables adaptive interpolation.
+     *
+     * @note This is a run-time setting and is not persisted.
+     */
+    void setMaxInterpError(double maxInterpError  ///< maximum interpolation error (source pixels)
+    ) {
+        _maxInterpError = maxInterpError;
+    }
+
     /**
      * get the warping kernel
      */
@@ -399,6 +431,52 @@ public:
         _growFullMask = growFullMask;
     }
 
+    /**
+     * get the number of threads used by warpImage
+     */
+    int getNumThreads() const { return _numThreads; }
+
+    /**
+     * set the number of threads used by warpImage
+     *
+     * If more than one, the destination image is split into blocks of rows that are warped
+     * concurrently, each with its own copy of the warping kernel(s). Blocks start on interpolation
+     * band edges, so the interpolation bands are unchanged, but source positions are recomputed
+     * exactly at the start of each block, so results may differ from a single-threaded warp by
+     * rounding error when interpLength > 0 (they are identical when interpLength = 0).
+     * 0 means use one thread per hardware thread.
+     *
+     * @note This is a run-time setting and is not persisted.
+     */
+    void setNumThreads(int numThreads  ///< number of threads; 0 for one per hardware thread
+    ) {
+        _numThreads = numThreads;
+    }
+
+    /**
+     * get whether Lanczos warping kernels are evaluated using a shared lookup table
+     */
+    bool getUseLanczosLookupTable() const { return _useLanczosLookupTable; }
+
+    /**
+     * set whether Lanczos warping kernels are evaluated using a shared lookup table
+     *
+     * If true, and the warping kernel (or mask warping kernel) is a LanczosWarpingKernel with its
+     * default center, kernel values are linearly interpolated from a finely sampled table that is
+     * computed once per Lanczos order and shared by all threads (see detail::LanczosLookupTable),
+     * instead of evaluating the Lanczos function, or using the kernel cache, at every pixel.
+     * The kernel values are accurate to a few parts in 10^8, much better than a kernel cache of
+     * any practical size. When warping an Image (rather than a MaskedImage) the kernel is also
+     * applied to the source pixels in double precision in an order the compiler can vectorize,
+     * so results may differ from warping without the table by rounding error.
+     *
+     * @note This is a run-time setting and is not persisted.
+     */
+    void setUseLanczosLookupTable(bool useLanczosLookupTable  ///< use the lookup table?
+    ) {
+        _useLanczosLookupTable = useLanczosLookupTable;
+    }
+
     bool isPersistable() const noexcept override;
 
 protected:
@@ -422,6 +500,9 @@ private:
     int _cacheSize;
     int _interpLength;
     lsst::afw::image::MaskPixel _growFullMask;
+    int _numThreads;
+    bool _useLanczosLookupTable;
+    double _maxInterpError;
 };
 
 /**
@@ -444,6 +525,43 @@ int warpExposure(
         ///< use this value for undefined (edge) pixels
 );
 
+/**
+ * Warp many exposures onto one destination grid, passing each warped exposure to a callback.
+ *
+ * This is equivalent to calling warpExposure for each source exposure in turn, with a new destination
+ * exposure each time, but is faster when warping many exposures, e.g. all the visits overlapping
+ * one coadd patch:
+ * - The destination pixels are allocated once and reused for every source exposure.
+ * - The warping kernels (and their caches) used by each thread are set up once and reused.
+ * - The transform between the pixels of each source exposure and the destination is computed
+ *   on a separate thread while the previous source exposure is being warped.
+ *
+ * Results are streamed to the callback rather than returned, so only one warped exposure is in memory
+ * at a time.
+ *
+ * @warning The destination exposure passed to the callback shares its pixels with the exposure passed
+ * on every other call, and they are overwritten as soon as the callback returns. Make a deep copy
+ * of any result that you wish to keep.
+ *
+ * @throws lsst::pex::exceptions::InvalidParameterError if any source exposure is null or has no WCS.
+ */
+template <typename DestExposureT, typename SrcExposureT>
+void warpExposures(
+        std::vector<std::shared_ptr<SrcExposureT const>> const &srcExposures,  ///< source exposures
+        lsst::geom::Box2I const &destBBox,                 ///< parent bounding box of the destination
+        std::shared_ptr<geom::SkyWcs const> const &destWcs,  ///< WCS of the destination
+        WarpingControl const &control,                       ///< control parameters
+        std::function<void(std::size_t, DestExposureT const &, int)> const &callback,
+        ///< function called with the index of each source exposure, the warped exposure
+        ///< (with PhotoCalib, FilterLabel, VisitInfo and ID copied from the source exposure, as by
+        ///< warpExposure) and the number of good pixels, in the order of srcExposures
+        typename DestExposureT::MaskedImageT::SinglePixel padValue =
+                lsst::afw::math::edgePixel<typename DestExposureT::MaskedImageT>(
+                        typename lsst::afw::image::detail::image_traits<
+                                typename DestExposureT::MaskedImageT>::image_category())
+        ///< use this value for undefined (edge) pixels
+);
+
 /**
  * @brief Warp an Image or MaskedImage to a new Wcs. See also convenience function
  * warpExposure() to warp an Exposure.
@@ -6,8 +6,12 @@
 #include "lsst/afw/table/SchemaMapper.h"
 #include "lsst/afw/table/Source.h"
 #include "lsst/afw/table/Exposure.h"
+#include "lsst/afw/table/ExposureSkyIndex.h"
 #include "lsst/afw/table/Match.h"
+#include "lsst/afw/table/MatchIndex.h"
 #include "lsst/afw/table/BaseColumnView.h"
+#include "lsst/afw/table/ColumnStore.h"
+#include "lsst/afw/table/HashIndex.h"
 #include "lsst/afw/table/FunctorKey.h"
 #include "lsst/afw/table/aggregates.h"
 #include "lsst/afw/table/arrays.h"
@@ -3,7 +3,9 @@
 #define AFW_TABLE_AliasMap_h_INCLUDED
 
 #include <map>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 namespace lsst {
 namespace afw {
@@ -49,8 +51,8 @@ public:
     // Delegate to copy-constructor for backwards compatibility
     AliasMap(AliasMap&& other) : AliasMap(other) {}
 
-    AliasMap& operator=(AliasMap const&) = default;
-    AliasMap& operator=(AliasMap&&) = default;
+    AliasMap& operator=(AliasMap const& other);
+    AliasMap& operator=(AliasMap&& other);
     ~AliasMap() = default;
 
     /// An iterator over alias->target pairs.
@@ -128,8 +130,20 @@ private:
     // Internal in-place implementation of apply()
     void _apply(std::string& name) const;
 
+    // Return apply(name), without allocating a string when the result has been seen before.
+    // The result points to name itself if there are no aliases, to an entry in _cache, or (if the
+    // cache is full) to buffer; it is valid until the map is next modified.
+    std::string const* _applyCached(std::string const& name, std::string& buffer) const;
+
+    void _clearCache();
+
     Internal _internal;
 
+    // Results of _apply, so that repeated lookups of the same names through a Schema don't have to
+    // search for aliases and build new strings; cleared whenever the aliases change.
+    mutable std::mutex _cacheMutex;
+    mutable std::unordered_map<std::string, std::string> _cache;
+
     // Table to notify of any changes.  We can't use a shared_ptr here because the Table needs to set
     // this in its own constructor, but the Table does guarantee that this pointer is either valid or
     // null.
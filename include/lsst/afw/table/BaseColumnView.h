@@ -51,6 +51,32 @@ public:
     SizeT getMask(Key<Flag> const& key) const { return SizeT(1) << getBit(key); }
     SizeT getMask(std::string const& name) const { return SizeT(1) << getBit(name); }
 
+    /// Return the union of the masks of several fields, given by name.
+    SizeT getMask(std::vector<std::string> const& names) const;
+
+    /**
+     *  Return a mask that is true for the rows whose bits satisfy a combination of flags.
+     *
+     *  A row is selected if all of the bits in allOf are set, any of the bits in anyOf are set (or
+     *  anyOf is zero), and none of the bits in noneOf are set.  All rows are tested in a single
+     *  branch-free pass over the packed bits.  The result may be passed to CatalogT::subset to
+     *  obtain the selected records.
+     *
+     *  @throws pex::exceptions::InvalidParameterError if any of the masks has a bit that does not
+     *          correspond to a field of this BitsColumn.
+     */
+    ndarray::Array<bool, 1, 1> select(SizeT allOf, SizeT anyOf = 0, SizeT noneOf = 0) const;
+
+    /**
+     *  Return the (ascending) indices of the rows whose bits satisfy a combination of flags.
+     *
+     *  The selection is that of select().
+     *
+     *  @throws pex::exceptions::InvalidParameterError if any of the masks has a bit that does not
+     *          correspond to a field of this BitsColumn.
+     */
+    ndarray::Array<SizeT, 1, 1> selectIndices(SizeT allOf, SizeT anyOf = 0, SizeT noneOf = 0) const;
+
     std::vector<SchemaItem<Flag> > const& getSchemaItems() const { return _items; }
 
 private:
@@ -58,6 +84,9 @@ private:
 
     explicit BitsColumn(std::size_t size);
 
+    // Throw InvalidParameterError if any of the selection masks has bits beyond those of _items.
+    void _checkMasks(SizeT allOf, SizeT anyOf, SizeT noneOf) const;
+
     ndarray::Array<SizeT, 1, 1> _array;
     std::vector<SchemaItem<Flag> > _items;
 };
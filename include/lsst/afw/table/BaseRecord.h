@@ -216,6 +216,7 @@ protected:
 private:
     friend class BaseTable;
     friend class BaseColumnView;
+    friend class CopyPlan;
 
     // All these are definitely private, not protected - we don't want derived classes mucking with them.
     void* _data;                        // pointer to field data
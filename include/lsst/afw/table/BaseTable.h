@@ -33,6 +33,7 @@ struct RecordData {
     void* data;
     std::shared_ptr<BaseTable> table;
     ndarray::Manager::Ptr manager;
+    bool filled = false;  // if true, data already holds field values and must not be initialized
 };
 
 }  // namespace detail
@@ -157,6 +158,83 @@ public:
      */
     std::size_t getBufferSize() const;
 
+    /**
+     *  Make the next new records of this table view existing memory that already holds their fields.
+     *
+     *  The next nRecords records made by this table (as with preallocate(), they are contiguous) view
+     *  consecutive record-sized chunks of data, in order, and their fields are not initialized, so
+     *  they have the values already stored there.  This lets FITS readers keep records in a mapping
+     *  of the file (see io::FitsSchemaInputMapper::MAP_ROWS).  The records keep manager, which must
+     *  keep data alive, as long as any of them exist.
+     *
+     *  @param[in] data      Memory for nRecords records laid out as this table's Schema lays them
+     *                       out, aligned as memory allocated by the table would be.
+     *  @param[in] nRecords  Number of records data holds.
+     *  @param[in] manager   Owner of data.
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if data is not suitably aligned or the
+     *          Schema has variable-length fields (which must be constructed by the table).
+     */
+    void adoptRecordData(void* data, std::size_t nRecords, ndarray::Manager::Ptr const& manager);
+
+    /**
+     *  Make the current thread allocate a table's new records from a memory block of its own.
+     *
+     *  Record creation normally takes memory from a block shared by all users of the table, so
+     *  makeRecord() may not be called from several threads at once.  While a ThreadLocalBlock exists,
+     *  records of its table made by the thread that created it come from a private block (preallocated
+     *  as with preallocate(), and replaced when full), so each thread of a parallel loop may create
+     *  records in a shared table as long as it holds its own ThreadLocalBlock.  Record IDs from the
+     *  IdFactory objects returned by IdFactory::makeSimple() and IdFactory::makeSource() stay unique.
+     *
+     *  Records made this way are contiguous within each thread only.  A contiguous catalog ordered by
+     *  ID is obtained by deep-copying the per-thread catalogs into one and sorting it:
+     *
+     *      std::vector<SourceCatalog> parts(nThreads, SourceCatalog(table));
+     *      parallelFor(nThreads, nThreads, [&](int i) {
+     *          BaseTable::ThreadLocalBlock block(*table, expectedRecordsPerThread);
+     *          ... parts[i].push_back(table->makeRecord()) ...
+     *      });
+     *      SourceCatalog merged(table);
+     *      merged.reserve(totalSize);
+     *      for (auto const &part : parts) merged.insert(merged.end(), part.begin(), part.end(), true);
+     *      merged.sort();
+     *
+     *  A ThreadLocalBlock must be destroyed by the thread that created it.  Records made from it must
+     *  not be destroyed while another thread is creating records from the same block, which holds as
+     *  long as each thread only destroys its own records until the parallel section ends.  Other
+     *  operations on the table (such as changing its schema aliases or metadata) are no more
+     *  thread-safe than before.
+     */
+    class ThreadLocalBlock final {
+    public:
+        /**
+         *  Start allocating records of a table on this thread from a new block.
+         *
+         *  @param[in] table     Table whose records are to be made.
+         *  @param[in] nRecords  Number of records to preallocate space for.
+         */
+        ThreadLocalBlock(BaseTable& table, std::size_t nRecords);
+
+        ThreadLocalBlock(ThreadLocalBlock const&) = delete;
+        ThreadLocalBlock(ThreadLocalBlock&&) = delete;
+        ThreadLocalBlock& operator=(ThreadLocalBlock const&) = delete;
+        ThreadLocalBlock& operator=(ThreadLocalBlock&&) = delete;
+
+        /// Return this thread's record allocation to the table's shared block.
+        ~ThreadLocalBlock() noexcept;
+
+    private:
+        friend class BaseTable;
+
+        // Return the innermost ThreadLocalBlock of the current thread for the given table, or null.
+        static ThreadLocalBlock* find(BaseTable const* table) noexcept;
+
+        BaseTable const* _table;
+        ndarray::Manager::Ptr _manager;
+        ThreadLocalBlock* _previous;
+    };
+
     /**
      *  Construct a new table.
      *
@@ -2,6 +2,7 @@
 #ifndef AFW_TABLE_Catalog_h_INCLUDED
 #define AFW_TABLE_Catalog_h_INCLUDED
 
+#include <numeric>
 #include <type_traits>
 #include <vector>
 
@@ -15,6 +16,8 @@
 #include "lsst/afw/table/io/FitsWriter.h"
 #include "lsst/afw/table/io/FitsReader.h"
 #include "lsst/afw/table/SchemaMapper.h"
+#include "lsst/afw/table/CopyPlan.h"
+#include "lsst/afw/table/SortKey.h"
 #include "lsst/log/Log.h"
 
 namespace lsst {
@@ -362,6 +365,52 @@ public:
         return io::FitsReader::apply<CatalogT>(manager, hdu, flags);
     }
 
+    /**
+     *  Read some of the columns and rows of a FITS binary table from a regular file.
+     *
+     *  The fields of the table's minimal schema, and any first-class objects (such as Footprints),
+     *  are read as usual; of the regular columns, only those named (and the one compared by rows)
+     *  are read.  Rows that are not selected are never added to the catalog.
+     *
+     *  @param[in] filename    Name of the file to read.
+     *  @param[in] hdu         Number of the "header-data unit" to read (where 0 is the Primary HDU).
+     *  @param[in] flags       Table-subclass-dependent bitflags that control the details of how to read
+     *                         the catalog.  See e.g. SourceFitsFlags.
+     *  @param[in] columns     Names of the columns (or aliases to them) to read; if empty, all columns
+     *                         are read.
+     *  @param[in] rows        The rows to read.
+     *
+     *  @throws lsst::pex::exceptions::NotFoundError if a name does not match any column or field.
+     *  @throws lsst::pex::exceptions::TypeError if rows compares a field that is not a scalar number,
+     *          Angle or Flag.
+     */
+    static CatalogT readFits(std::string const& filename, int hdu, int flags,
+                             std::vector<std::string> const& columns,
+                             io::FitsRowFilter const& rows = io::FitsRowFilter()) {
+        return io::FitsReader::apply<CatalogT>(filename, hdu, flags, nullptr, columns, rows);
+    }
+
+    /**
+     *  Read some of the columns and rows of a FITS binary table from a RAM file.
+     *
+     *  @param[in] manager     Object that manages the memory to be read.
+     *  @param[in] hdu         Number of the "header-data unit" to read (where 0 is the Primary HDU).
+     *  @param[in] flags       Table-subclass-dependent bitflags that control the details of how to read
+     *                         the catalog.  See e.g. SourceFitsFlags.
+     *  @param[in] columns     Names of the columns (or aliases to them) to read; if empty, all columns
+     *                         are read.
+     *  @param[in] rows        The rows to read.
+     *
+     *  @throws lsst::pex::exceptions::NotFoundError if a name does not match any column or field.
+     *  @throws lsst::pex::exceptions::TypeError if rows compares a field that is not a scalar number,
+     *          Angle or Flag.
+     */
+    static CatalogT readFits(fits::MemFileManager& manager, int hdu, int flags,
+                             std::vector<std::string> const& columns,
+                             io::FitsRowFilter const& rows = io::FitsRowFilter()) {
+        return io::FitsReader::apply<CatalogT>(manager, hdu, flags, nullptr, columns, rows);
+    }
+
     /**
      *  Read a FITS binary table from a file object already at the correct extension.
      *
@@ -533,20 +582,101 @@ public:
         }
     }
 
-    /// Insert a range of records into the catalog by copying them with a SchemaMapper.
+    /**
+     *  Insert a range of records into the catalog by copying them with a SchemaMapper.
+     *
+     *  The mapper is compiled into a CopyPlan once, and the records are copied with it on up to
+     *  numThreads threads (0 means one per hardware thread).
+     */
     template <typename InputIterator>
-    void insert(SchemaMapper const& mapper, iterator pos, InputIterator first, InputIterator last) {
+    void insert(SchemaMapper const& mapper, iterator pos, InputIterator first, InputIterator last,
+                int numThreads = 1) {
         if (!_table->getSchema().contains(mapper.getOutputSchema())) {
             throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
                               "SchemaMapper's output schema does not match catalog's schema");
         }
+        CopyPlan const plan(mapper);
         _maybeReserve(pos, first, last, true,
                       (typename std::iterator_traits<InputIterator>::iterator_category*)nullptr);
-        while (first != last) {
-            pos = insert(pos, _table->copyRecord(*first, mapper));
-            ++pos;
-            ++first;
+        Internal records;
+        std::vector<BaseRecord const*> inputs;
+        std::vector<BaseRecord*> outputs;
+        for (; first != last; ++first) {
+            records.push_back(_table->makeRecord());
+            inputs.push_back(&(*first));
+            outputs.push_back(records.back().get());
+        }
+        plan.apply(inputs, outputs, numThreads);
+        _internal.insert(pos.base(), records.begin(), records.end());
+    }
+
+    /**
+     *  Concatenate catalogs into a new catalog whose records are contiguous in memory.
+     *
+     *  The records of all catalogs are deep-copied in order into space allocated for all of them at
+     *  once, so the result supports getColumnView.  The records are copied with a CopyPlan (a memcpy
+     *  per run of adjacent fields) on up to numThreads threads (0 means one per hardware thread).
+     *  The result's table is a clone of the first catalog's table.
+     *
+     *  @throws lsst::pex::exceptions::LengthError if `catalogs` is empty.
+     *  @throws lsst::pex::exceptions::InvalidParameterError if the catalogs do not all have the schema
+     *          of the first, or if numThreads < 0.
+     */
+    template <typename InputCatalogT = CatalogT>
+    static CatalogT concatenate(std::vector<InputCatalogT> const& catalogs, int numThreads = 1) {
+        if (catalogs.empty()) {
+            throw LSST_EXCEPT(pex::exceptions::LengthError, "Cannot concatenate an empty list of catalogs");
+        }
+        Schema const schema = catalogs.front().getSchema();
+        for (auto const& catalog : catalogs) {
+            if (catalog.getSchema() != schema) {
+                throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                                  "Catalogs to concatenate do not all have the same schema; "
+                                  "use a SchemaMapper to concatenate catalogs with different schemas");
+            }
+        }
+        SchemaMapper mapper(schema, schema);
+        mapper.addMappingsWhere([](auto const&) { return true; }, true);
+        return concatenate(catalogs.front().getTable()->clone(), mapper, catalogs, numThreads);
+    }
+
+    /**
+     *  Concatenate catalogs into a new catalog by copying their records with a SchemaMapper.
+     *
+     *  As the other overload, but every record is copied with the given mapper into a record of the
+     *  given table.
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if the mapper's output schema does not match
+     *          the table's schema, or if numThreads < 0.
+     *  @throws lsst::pex::exceptions::LogicError if the schema of a catalog does not match the mapper's
+     *          input schema.
+     */
+    template <typename InputCatalogT = CatalogT>
+    static CatalogT concatenate(std::shared_ptr<Table> const& table, SchemaMapper const& mapper,
+                                std::vector<InputCatalogT> const& catalogs, int numThreads = 1) {
+        CatalogT result(table);
+        if (!table->getSchema().contains(mapper.getOutputSchema())) {
+            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                              "SchemaMapper's output schema does not match catalog's schema");
+        }
+        CopyPlan const plan(mapper);
+        size_type total = 0;
+        for (auto const& catalog : catalogs) {
+            total += catalog.size();
+        }
+        result.reserve(total);
+        std::vector<BaseRecord const*> inputs;
+        std::vector<BaseRecord*> outputs;
+        inputs.reserve(total);
+        outputs.reserve(total);
+        for (auto const& catalog : catalogs) {
+            for (auto const& record : catalog) {
+                inputs.push_back(&record);
+                outputs.push_back(result.addNew().get());
+            }
         }
+        plan.apply(inputs, outputs, numThreads);
+        return result;
     }
 
     /// Insert a copy of the given record at the given position.
@@ -589,9 +719,26 @@ public:
     template <typename Compare>
     bool isSorted(Compare cmp) const;
 
-    /// Sort the catalog in-place by the field with the given key.
+    /**
+     *  Sort the catalog in-place (and stably) by the field with the given key.
+     *
+     *  The field's values are copied into a dense array, which is sorted on up to numThreads threads
+     *  (0 means one per hardware thread), and the records are then permuted once.
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0.
+     */
     template <typename T>
-    void sort(Key<T> const& key);
+    void sort(Key<T> const& key, int numThreads = 1);
+
+    /**
+     *  Sort the catalog in-place (and stably) by several fields, with records ordered by the first
+     *  field, then records with equal values of that by the second, and so on.
+     *
+     *  Each field is sorted as by sort(Key<T> const &, int), from the last to the first.
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0.
+     */
+    void sort(std::vector<SortKey> const& keys, int numThreads = 1);
 
     /**
      *  Sort the catalog in-place by the field with the given predicate.
@@ -614,7 +761,8 @@ public:
      *  @note The catalog must be sorted in ascending order according to the given key
      *        before calling find (i.e. isSorted(key) must be true) for maximal efficiency.
      *        If the value searched for is not found, it assumes that the catalog is unsorted
-     *        and performs a brute-force search instead of failing immediately.
+     *        and performs a brute-force search instead of failing immediately.  For many
+     *        lookups into an unsorted catalog, use a HashIndex instead.
      *
      *  Returns end() if the Record cannot be found.
      */
@@ -677,6 +825,16 @@ public:
     //@}
 
 private:
+    // Reorder the records so the new i-th record is the old order[i]-th.
+    void _permute(std::vector<std::size_t> const& order) {
+        Internal permuted;
+        permuted.reserve(order.size());
+        for (std::size_t i : order) {
+            permuted.push_back(_internal[i]);
+        }
+        _internal.swap(permuted);
+    }
+
     template <typename InputIterator>
     void _maybeReserve(iterator& pos, InputIterator first, InputIterator last, bool deep,
                        std::random_access_iterator_tag*) {
@@ -752,9 +910,29 @@ bool CatalogT<RecordT>::isSorted(Key<T> const& key) const {
 
 template <typename RecordT>
 template <typename T>
-void CatalogT<RecordT>::sort(Key<T> const& key) {
-    detail::KeyComparisonFunctor<RecordT, T> f = {key};
-    return sort(f);
+void CatalogT<RecordT>::sort(Key<T> const& key, int numThreads) {
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    std::vector<std::size_t> order(size());
+    std::iota(order.begin(), order.end(), 0);
+    detail::stableSortOrder<typename Field<T>::Value>(
+            order, [this, &key](std::size_t i) { return _internal[i]->get(key); }, nThreads);
+    _permute(order);
+}
+
+template <typename RecordT>
+void CatalogT<RecordT>::sort(std::vector<SortKey> const& keys, int numThreads) {
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    std::vector<BaseRecord const*> records;
+    records.reserve(size());
+    for (auto const& record : _internal) {
+        records.push_back(record.get());
+    }
+    std::vector<std::size_t> order(size());
+    std::iota(order.begin(), order.end(), 0);
+    for (auto iter = keys.rbegin(); iter != keys.rend(); ++iter) {
+        iter->refine(records, order, nThreads);
+    }
+    _permute(order);
 }
 
 template <typename RecordT>
@@ -0,0 +1,161 @@
+// -*- lsst-c++ -*-
+#ifndef AFW_TABLE_ColumnStore_h_INCLUDED
+#define AFW_TABLE_ColumnStore_h_INCLUDED
+
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "ndarray.h"
+#include "lsst/geom/Angle.h"
+#include "lsst/afw/table/Catalog.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+
+/**
+ *  A structure-of-arrays copy of the fields of a catalog.
+ *
+ *  Catalogs store records row-major, so the columns of a BaseColumnView are strided by the record
+ *  size; with wide schemas that wastes most of every cache line and defeats vectorization.  A
+ *  ColumnStore instead holds each field in its own contiguous array (with one row per record, and
+ *  the elements of array fields contiguous within each row), so column-wise work runs at full
+ *  memory bandwidth.  Flags are unpacked to one bool per record.
+ *
+ *  Scalar numeric, Angle, Flag and fixed-size array fields are stored; strings and variable-length
+ *  arrays are not.  The arrays returned by get() are views into the store, and any changes made to
+ *  them can be copied back to a catalog with assignTo().  Copies of a ColumnStore share its columns.
+ */
+class ColumnStore final {
+public:
+    /**
+     *  Copy the fields of all records in a catalog into contiguous columns.
+     *
+     *  @param[in] catalog     Catalog to copy; it need not be contiguous.
+     *  @param[in] numThreads  Number of threads to copy with; 0 means one per hardware thread.
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0.
+     */
+    template <typename RecordT>
+    explicit ColumnStore(CatalogT<RecordT> const &catalog, int numThreads = 1)
+            : ColumnStore(catalog.getSchema(), _getRecords(catalog), numThreads) {}
+
+    ColumnStore(ColumnStore const &) = default;
+    ColumnStore(ColumnStore &&) = default;
+    ColumnStore &operator=(ColumnStore const &) = default;
+    ColumnStore &operator=(ColumnStore &&) = default;
+    ~ColumnStore() noexcept = default;
+
+    /// Return the schema of the catalog the columns were copied from.
+    Schema getSchema() const { return _schema; }
+
+    /// Return the number of rows.
+    std::size_t size() const noexcept { return _size; }
+
+    //@{
+    /**
+     *  Return the column for a field.
+     *
+     *  Angles are returned in radians, and fixed-size arrays as two-dimensional arrays with one row
+     *  per record.
+     *
+     *  @throws lsst::pex::exceptions::NotFoundError if the field is not stored.
+     */
+    template <typename T>
+    ndarray::Array<T, 1, 1> get(Key<T> const &key) const {
+        return _makeColumn<T>(key.getOffset(), -1);
+    }
+    ndarray::Array<double, 1, 1> get(Key<lsst::geom::Angle> const &key) const {
+        return _makeColumn<double>(key.getOffset(), -1);
+    }
+    template <typename T>
+    ndarray::Array<T, 2, 2> get(Key<Array<T>> const &key) const {
+        return _makeArrayColumn<T>(key.getOffset(), key.getSize());
+    }
+    ndarray::Array<bool, 1, 1> get(Key<Flag> const &key) const {
+        return _makeColumn<bool>(key.getOffset(), static_cast<int>(key.getBit()));
+    }
+    //@}
+
+    /**
+     *  Copy the stored columns into the records of a catalog.
+     *
+     *  @param[in,out] catalog     Catalog to fill; its schema must be equal to the store's, and it
+     *                             must have the same number of records.
+     *  @param[in]     numThreads  Number of threads to copy with; 0 means one per hardware thread.
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if the catalog's schema does not match or
+     *          if numThreads < 0.
+     *  @throws lsst::pex::exceptions::LengthError if the catalog has a different number of records.
+     */
+    template <typename RecordT>
+    void assignTo(CatalogT<RecordT> &catalog, int numThreads = 1) const {
+        std::vector<BaseRecord *> records;
+        records.reserve(catalog.size());
+        for (auto &record : catalog) {
+            records.push_back(&record);
+        }
+        _assignTo(catalog.getSchema(), records, numThreads);
+    }
+
+private:
+    // A column's data; a Flag column is identified by its key's offset and bit, and any other by its
+    // key's offset (with a bit of -1).
+    struct Column {
+        std::size_t rowBytes;
+        ndarray::Array<std::uint8_t, 1, 1> bytes;
+    };
+
+    using ColumnMap = std::map<std::pair<std::size_t, int>, Column>;
+
+    template <typename RecordT>
+    static std::vector<BaseRecord const *> _getRecords(CatalogT<RecordT> const &catalog) {
+        std::vector<BaseRecord const *> records;
+        records.reserve(catalog.size());
+        for (auto const &record : catalog) {
+            records.push_back(&record);
+        }
+        return records;
+    }
+
+    ColumnStore(Schema const &schema, std::vector<BaseRecord const *> const &records, int numThreads);
+
+    void _assignTo(Schema const &schema, std::vector<BaseRecord *> const &records, int numThreads) const;
+
+    Column const &_find(std::size_t offset, int bit) const;
+
+    template <typename T>
+    ndarray::Array<T, 1, 1> _makeColumn(std::size_t offset, int bit) const;
+
+    template <typename T>
+    ndarray::Array<T, 2, 2> _makeArrayColumn(std::size_t offset, std::size_t nElements) const;
+
+    Schema _schema;
+    std::size_t _size;
+    ColumnMap _columns;
+};
+
+template <typename T>
+ndarray::Array<T, 1, 1> ColumnStore::_makeColumn(std::size_t offset, int bit) const {
+    Column const &column = _find(offset, bit);
+    return ndarray::external(reinterpret_cast<T *>(column.bytes.getData()),
+                             ndarray::makeVector<ndarray::Size>(_size), ndarray::makeVector<ndarray::Offset>(1),
+                             column.bytes.getManager());
+}
+
+template <typename T>
+ndarray::Array<T, 2, 2> ColumnStore::_makeArrayColumn(std::size_t offset, std::size_t nElements) const {
+    Column const &column = _find(offset, -1);
+    return ndarray::external(reinterpret_cast<T *>(column.bytes.getData()),
+                             ndarray::makeVector<ndarray::Size>(_size, nElements),
+                             ndarray::makeVector<ndarray::Offset>(nElements, 1),
+                             column.bytes.getManager());
+}
+
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !AFW_TABLE_ColumnStore_h_INCLUDED
@@ -0,0 +1,100 @@
+// -*- lsst-c++ -*-
+#ifndef AFW_TABLE_CopyPlan_h_INCLUDED
+#define AFW_TABLE_CopyPlan_h_INCLUDED
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "lsst/afw/table/BaseRecord.h"
+#include "lsst/afw/table/SchemaMapper.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+
+/**
+ *  A SchemaMapper compiled into a flat list of byte copies, for copying many records.
+ *
+ *  BaseRecord::assign(BaseRecord const &, SchemaMapper const &) visits each of the mapper's key
+ *  pairs, dispatching on their types, for every record.  A CopyPlan does that once: fields that
+ *  are adjacent in both the input and output schemas are coalesced into a single memcpy, flags
+ *  that share an input and an output storage element (with the same bit shift) are copied with a
+ *  single masked shift, and only variable-length fields are still copied one at a time.
+ */
+class CopyPlan final {
+public:
+    /**
+     *  Compile a SchemaMapper.
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if a variable-length field is mapped to a
+     *          fixed-length one, or vice-versa.
+     */
+    explicit CopyPlan(SchemaMapper const &mapper);
+
+    CopyPlan(CopyPlan const &) = default;
+    CopyPlan(CopyPlan &&) = default;
+    CopyPlan &operator=(CopyPlan const &) = default;
+    CopyPlan &operator=(CopyPlan &&) = default;
+    ~CopyPlan() = default;
+
+    /// Return the mapper the plan was compiled from.
+    SchemaMapper const &getMapper() const noexcept { return _mapper; }
+
+    /// Return the number of memcpy calls the plan makes per record.
+    std::size_t getRunCount() const noexcept { return _runs.size(); }
+
+    /**
+     *  Copy the mapped fields of one record to another, as BaseRecord::assign would.
+     *
+     *  @throws lsst::pex::exceptions::LogicError if the records' schemas do not contain the mapper's.
+     */
+    void apply(BaseRecord const &input, BaseRecord &output) const;
+
+    /**
+     *  Copy the mapped fields of each input record to the corresponding output record.
+     *
+     *  The schemas of the records are checked once for each distinct table, not for every record.
+     *
+     *  @param[in]     inputs      Records to copy from.
+     *  @param[in,out] outputs     Records to copy to; must have the same size as inputs.
+     *  @param[in]     numThreads  Number of threads to copy with; 0 means one per hardware thread.
+     *
+     *  @throws lsst::pex::exceptions::LengthError if inputs and outputs have different sizes.
+     *  @throws lsst::pex::exceptions::LogicError if the records' schemas do not contain the mapper's.
+     *  @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0.
+     */
+    void apply(std::vector<BaseRecord const *> const &inputs, std::vector<BaseRecord *> const &outputs,
+               int numThreads = 1) const;
+
+private:
+    // A block of bytes copied verbatim.
+    struct Run {
+        std::size_t inputOffset;
+        std::size_t outputOffset;
+        std::size_t size;
+    };
+
+    // Flags copied from one storage element to another, shifted left by shift bits.
+    struct FlagRemap {
+        std::size_t inputOffset;
+        std::size_t outputOffset;
+        int shift;
+        std::uint64_t inputMask;
+    };
+
+    void _checkSchemas(BaseRecord const &input, BaseRecord const &output) const;
+
+    void _copy(BaseRecord const &input, BaseRecord &output) const;
+
+    SchemaMapper _mapper;
+    std::vector<Run> _runs;
+    std::vector<FlagRemap> _flags;
+    std::vector<std::function<void(BaseRecord const &, BaseRecord &)>> _variable;
+};
+
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !AFW_TABLE_CopyPlan_h_INCLUDED
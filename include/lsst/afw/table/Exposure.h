@@ -73,6 +73,15 @@ class InputArchive;
 
 }  // namespace io
 
+/**
+ *  Bitflags to be passed to ExposureCatalog::readFits.
+ */
+enum ExposureFitsFlags {
+    /// Load every object in the catalog's archive before reading the rows, using all allowed threads
+    /// (see InputArchive::getAll(int)); useful for catalogs with many Wcs, Psf and PhotoCalib objects.
+    EXPOSURE_IO_PARALLEL_ARCHIVE = 0x1
+};
+
 /**
  *  Record class used to store exposure metadata.
  */
@@ -380,7 +389,7 @@ public:
      *                         The default value of afw::fits::DEFAULT_HDU is interpreted as
      *                         "the first HDU with NAXIS != 0".
      *  @param[in] flags       Table-subclass-dependent bitflags that control the details of how to read
-     *                         the catalog.  See e.g. SourceFitsFlags.
+     *                         the catalog.  See ExposureFitsFlags.
      */
     static ExposureCatalogT readFits(std::string const& filename, int hdu = fits::DEFAULT_HDU,
                                      int flags = 0) {
@@ -395,19 +404,65 @@ public:
      *                         The default value of afw::fits::DEFAULT_HDU is interpreted as
      *                         "the first HDU with NAXIS != 0".
      *  @param[in] flags       Table-subclass-dependent bitflags that control the details of how to read
-     *                         the catalog.  See e.g. SourceFitsFlags.
+     *                         the catalog.  See ExposureFitsFlags.
      */
     static ExposureCatalogT readFits(fits::MemFileManager& manager, int hdu = fits::DEFAULT_HDU,
                                      int flags = 0) {
         return io::FitsReader::apply<ExposureCatalogT>(manager, hdu, flags);
     }
 
+    /**
+     *  Read some of the columns and rows of a FITS binary table from a regular file.
+     *
+     *  The fields of the table's minimal schema, and any first-class objects (such as Footprints),
+     *  are read as usual; of the regular columns, only those named (and the one compared by rows)
+     *  are read.  Rows that are not selected are never added to the catalog.
+     *
+     *  @param[in] filename    Name of the file to read.
+     *  @param[in] hdu         Number of the "header-data unit" to read (where 0 is the Primary HDU).
+     *  @param[in] flags       Table-subclass-dependent bitflags that control the details of how to read
+     *                         the catalog.  See ExposureFitsFlags.
+     *  @param[in] columns     Names of the columns (or aliases to them) to read; if empty, all columns
+     *                         are read.
+     *  @param[in] rows        The rows to read.
+     *
+     *  @throws lsst::pex::exceptions::NotFoundError if a name does not match any column or field.
+     *  @throws lsst::pex::exceptions::TypeError if rows compares a field that is not a scalar number,
+     *          Angle or Flag.
+     */
+    static ExposureCatalogT readFits(std::string const& filename, int hdu, int flags,
+                                     std::vector<std::string> const& columns,
+                                     io::FitsRowFilter const& rows = io::FitsRowFilter()) {
+        return io::FitsReader::apply<ExposureCatalogT>(filename, hdu, flags, nullptr, columns, rows);
+    }
+
+    /**
+     *  Read some of the columns and rows of a FITS binary table from a RAM file.
+     *
+     *  @param[in] manager     Object that manages the memory to be read.
+     *  @param[in] hdu         Number of the "header-data unit" to read (where 0 is the Primary HDU).
+     *  @param[in] flags       Table-subclass-dependent bitflags that control the details of how to read
+     *                         the catalog.  See ExposureFitsFlags.
+     *  @param[in] columns     Names of the columns (or aliases to them) to read; if empty, all columns
+     *                         are read.
+     *  @param[in] rows        The rows to read.
+     *
+     *  @throws lsst::pex::exceptions::NotFoundError if a name does not match any column or field.
+     *  @throws lsst::pex::exceptions::TypeError if rows compares a field that is not a scalar number,
+     *          Angle or Flag.
+     */
+    static ExposureCatalogT readFits(fits::MemFileManager& manager, int hdu, int flags,
+                                     std::vector<std::string> const& columns,
+                                     io::FitsRowFilter const& rows = io::FitsRowFilter()) {
+        return io::FitsReader::apply<ExposureCatalogT>(manager, hdu, flags, nullptr, columns, rows);
+    }
+
     /**
      *  Read a FITS binary table from a file object already at the correct extension.
      *
      *  @param[in] fitsfile    Fits file object to read from.
      *  @param[in] flags       Table-subclass-dependent bitflags that control the details of how to read
-     *                         the catalog.  See e.g. SourceFitsFlags.
+     *                         the catalog.  See ExposureFitsFlags.
      */
     static ExposureCatalogT readFits(fits::Fits& fitsfile, int flags = 0) {
         return io::FitsReader::apply<ExposureCatalogT>(fitsfile, flags);
@@ -441,6 +496,19 @@ public:
      */
     static ExposureCatalogT readFromArchive(io::InputArchive const& archive, BaseCatalog const& catalog);
 
+    /// Concatenate catalogs into a new, contiguous catalog; see CatalogT::concatenate.
+    template <typename InputCatalogT = ExposureCatalogT>
+    static ExposureCatalogT concatenate(std::vector<InputCatalogT> const& catalogs, int numThreads = 1) {
+        return ExposureCatalogT(Base::concatenate(catalogs, numThreads));
+    }
+
+    /// Concatenate catalogs into a new, contiguous catalog with a SchemaMapper; see CatalogT::concatenate.
+    template <typename InputCatalogT = ExposureCatalogT>
+    static ExposureCatalogT concatenate(std::shared_ptr<Table> const& table, SchemaMapper const& mapper,
+                                        std::vector<InputCatalogT> const& catalogs, int numThreads = 1) {
+        return ExposureCatalogT(Base::concatenate(table, mapper, catalogs, numThreads));
+    }
+
     /**
      *  Return the subset of a catalog corresponding to the True values of the given mask array.
      *
@@ -464,6 +532,8 @@ public:
      *  If includeValidPolygon is true we check that the point is within the validPolygon of those
      *         records which have one; if they don't, this argument is ignored.
      *
+     *  This tests every record; use an ExposureSkyIndex for many queries against one catalog.
+     *
      *  @see ExposureRecord::contains
      */
     ExposureCatalogT subsetContaining(lsst::geom::SpherePoint const& coord,
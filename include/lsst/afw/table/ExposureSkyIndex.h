@@ -0,0 +1,102 @@
+// -*- lsst-c++ -*-
+#ifndef AFW_TABLE_ExposureSkyIndex_h_INCLUDED
+#define AFW_TABLE_ExposureSkyIndex_h_INCLUDED
+
+#include <cstddef>
+#include <vector>
+
+#include "Eigen/Core"
+
+#include "lsst/geom/SpherePoint.h"
+#include "lsst/afw/table/Exposure.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+
+/**
+ *  A spatial index on the sky regions of the records of an ExposureCatalog.
+ *
+ *  ExposureCatalogT::subsetContaining tests every record's WCS (and valid polygon) against the
+ *  query point.  An ExposureSkyIndex bounds each record's bounding box on the sky by a circle, once,
+ *  and arranges the circles in a tree of bounding circles, so a query only tests the records whose
+ *  circles contain the point: about log(N) of them for catalogs of non-overlapping detectors.
+ *  Results are exactly those of subsetContaining.
+ *
+ *  The index holds a shallow copy of the catalog, and does not see later changes to it or to its
+ *  records' WCSs or bounding boxes.
+ */
+class ExposureSkyIndex final {
+public:
+    /**
+     *  Index the records of a catalog.
+     *
+     *  @throws lsst::pex::exceptions::LogicError if any record does not have a Wcs.
+     */
+    explicit ExposureSkyIndex(ExposureCatalog const &catalog);
+
+    ExposureSkyIndex(ExposureSkyIndex const &) = default;
+    ExposureSkyIndex(ExposureSkyIndex &&) = default;
+    ExposureSkyIndex &operator=(ExposureSkyIndex const &) = default;
+    ExposureSkyIndex &operator=(ExposureSkyIndex &&) = default;
+    ~ExposureSkyIndex() = default;
+
+    /// Return the indexed catalog.
+    ExposureCatalog const &getCatalog() const noexcept { return _catalog; }
+
+    /// Return the number of indexed records.
+    std::size_t size() const noexcept { return _catalog.size(); }
+
+    /**
+     *  Return the positions in the catalog (in ascending order) of the records that contain the
+     *  given point.
+     *
+     *  @see ExposureRecord::contains
+     */
+    std::vector<std::size_t> findContaining(lsst::geom::SpherePoint const &coord,
+                                            bool includeValidPolygon = false) const;
+
+    /**
+     *  Return a shallow subset of the catalog with only those records that contain the given point.
+     *
+     *  @see ExposureCatalogT::subsetContaining
+     */
+    ExposureCatalog subsetContaining(lsst::geom::SpherePoint const &coord,
+                                     bool includeValidPolygon = false) const;
+
+    /// Return subsetContaining(coord, includeValidPolygon) for each of several points.
+    std::vector<ExposureCatalog> subsetContaining(std::vector<lsst::geom::SpherePoint> const &coords,
+                                                  bool includeValidPolygon = false) const;
+
+private:
+    // A circle on the sky, as a unit vector and the cosine of its angular radius.
+    struct Cap {
+        Eigen::Vector3d center;
+        double radius;
+        double cosRadius;
+
+        bool contains(Eigen::Vector3d const &v) const { return center.dot(v) >= cosRadius; }
+    };
+
+    // A node of the tree; leaves hold the records _order[begin:end], and other nodes two children.
+    struct Node {
+        Cap cap;
+        std::size_t begin;
+        std::size_t end;
+        int left;
+        int right;
+    };
+
+    int _build(std::size_t begin, std::size_t end);
+
+    ExposureCatalog _catalog;
+    std::vector<Cap> _caps;           // one per record; empty records have none and are not indexed
+    std::vector<std::size_t> _order;  // positions of indexed records, grouped by leaf
+    std::vector<Node> _nodes;         // the root is the first, if there are any records
+};
+
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !AFW_TABLE_ExposureSkyIndex_h_INCLUDED
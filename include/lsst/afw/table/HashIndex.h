@@ -0,0 +1,157 @@
+// -*- lsst-c++ -*-
+#ifndef AFW_TABLE_HashIndex_h_INCLUDED
+#define AFW_TABLE_HashIndex_h_INCLUDED
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "ndarray.h"
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/table/Catalog.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+
+/**
+ *  A hash table from the values of an integer or string field to the records of a catalog.
+ *
+ *  CatalogT::find is a binary search on catalogs sorted by the field, and falls back to a linear
+ *  search otherwise.  A HashIndex finds records in constant time whatever the catalog's order,
+ *  which makes it the better choice for many lookups into an unsorted catalog (e.g. when
+ *  associating one catalog with another).
+ *
+ *  The index holds the catalog's records, not the catalog itself, and does not see any later
+ *  changes to the catalog or to the indexed field.  Call invalidate() when it is known to be stale
+ *  (after which lookups throw until it is rebuilt) and rebuild() to index the catalog again.
+ *
+ *  When several records have the same value, the index finds the first of them in catalog order.
+ */
+template <typename RecordT, typename T>
+class HashIndex final {
+    static_assert(std::is_integral_v<T> || std::is_same_v<T, std::string>,
+                  "HashIndex only supports integer and string fields");
+
+public:
+    using Value = typename Field<T>::Value;
+
+    /**
+     *  Index the records of a catalog by a field.
+     *
+     *  @param[in] catalog  Catalog to index.
+     *  @param[in] key      Key for the field to index.
+     */
+    HashIndex(CatalogT<RecordT> const &catalog, Key<T> const &key) : _key(key) { rebuild(catalog); }
+
+    HashIndex(HashIndex const &) = default;
+    HashIndex(HashIndex &&) = default;
+    HashIndex &operator=(HashIndex const &) = default;
+    HashIndex &operator=(HashIndex &&) = default;
+    ~HashIndex() = default;
+
+    /// Return the key for the indexed field.
+    Key<T> const &getKey() const noexcept { return _key; }
+
+    /// Return the number of indexed records.
+    std::size_t size() const noexcept { return _records.size(); }
+
+    /// Return whether the index may be used, i.e. it has not been invalidated since it was built.
+    bool isValid() const noexcept { return _valid; }
+
+    /// Mark the index as stale and release its records; lookups throw until rebuild() is called.
+    void invalidate() noexcept {
+        _valid = false;
+        _records.clear();
+        _positions.clear();
+    }
+
+    /// Index the records of a catalog again, by the same field.
+    void rebuild(CatalogT<RecordT> const &catalog) {
+        std::vector<std::shared_ptr<RecordT>> records(catalog.getInternal());
+        std::unordered_map<Value, std::size_t> positions;
+        positions.reserve(records.size());
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            positions.emplace(records[i]->get(_key), i);
+        }
+        _records.swap(records);
+        _positions.swap(positions);
+        _valid = true;
+    }
+
+    /**
+     *  Return whether any record has the given value.
+     *
+     *  @throws lsst::pex::exceptions::LogicError if the index has been invalidated.
+     */
+    bool contains(Value const &value) const {
+        _checkValid();
+        return _positions.count(value) > 0;
+    }
+
+    /**
+     *  Return the (first) record with the given value, or an empty pointer if there is none.
+     *
+     *  @throws lsst::pex::exceptions::LogicError if the index has been invalidated.
+     */
+    std::shared_ptr<RecordT> find(Value const &value) const {
+        _checkValid();
+        auto const iter = _positions.find(value);
+        return iter == _positions.end() ? std::shared_ptr<RecordT>() : _records[iter->second];
+    }
+
+    /**
+     *  Return the (first) record with each of the given values, with empty pointers for values no
+     *  record has.
+     *
+     *  @throws lsst::pex::exceptions::LogicError if the index has been invalidated.
+     */
+    std::vector<std::shared_ptr<RecordT>> findAll(std::vector<Value> const &values) const {
+        _checkValid();
+        std::vector<std::shared_ptr<RecordT>> result;
+        result.reserve(values.size());
+        for (auto const &value : values) {
+            auto const iter = _positions.find(value);
+            result.push_back(iter == _positions.end() ? std::shared_ptr<RecordT>() : _records[iter->second]);
+        }
+        return result;
+    }
+
+    /**
+     *  Return the position in the indexed catalog of the (first) record with each of the given values,
+     *  or -1 for values no record has.
+     *
+     *  @throws lsst::pex::exceptions::LogicError if the index has been invalidated.
+     */
+    ndarray::Array<std::int64_t, 1, 1> getIndices(std::vector<Value> const &values) const {
+        _checkValid();
+        ndarray::Array<std::int64_t, 1, 1> result = ndarray::allocate(values.size());
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            auto const iter = _positions.find(values[i]);
+            result[i] = iter == _positions.end() ? -1 : static_cast<std::int64_t>(iter->second);
+        }
+        return result;
+    }
+
+private:
+    void _checkValid() const {
+        if (!_valid) {
+            throw LSST_EXCEPT(pex::exceptions::LogicError,
+                              "HashIndex has been invalidated; rebuild it first");
+        }
+    }
+
+    Key<T> _key;
+    bool _valid = false;
+    std::vector<std::shared_ptr<RecordT>> _records;
+    std::unordered_map<Value, std::size_t> _positions;
+};
+
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !AFW_TABLE_HashIndex_h_INCLUDED
@@ -17,6 +17,9 @@ namespace table {
  *  The IDs produced by an IdFactory need not be sequential, but they must be unique, both with respect
  *  to the IDs it generates itself and those passed to it via the notify() member function.  Valid IDs
  *  must be nonzero, as zero is used to indicate null in some contexts.
+ *
+ *  The factories returned by makeSimple() and makeSource() are lock-free and may be called from several
+ *  threads at once (see BaseTable::ThreadLocalBlock); each ID is still returned only once.
  */
 class IdFactory {
 public:
@@ -44,7 +44,7 @@ namespace table {
  */
 class MatchControl {
 public:
-    MatchControl() : findOnlyClosest(true), symmetricMatch(true), includeMismatches(false) {}
+    MatchControl() : findOnlyClosest(true), symmetricMatch(true), includeMismatches(false), numThreads(1) {}
     LSST_CONTROL_FIELD(findOnlyClosest, bool,
                        "Return only the closest match if more than one is found "
                        "(default: true)");
@@ -54,6 +54,9 @@ public:
     LSST_CONTROL_FIELD(includeMismatches, bool,
                        "Include failed matches (i.e. one 'match' is NULL) "
                        "(default: false)");
+    LSST_CONTROL_FIELD(numThreads, int,
+                       "Number of threads to match on, for matchRaDec; 0 means one per hardware thread "
+                       "(default: 1)");
 };
 
 /**
@@ -90,7 +93,9 @@ using SourceMatchVector = std::vector<SourceMatch>;
  * Compute all tuples (s1,s2,d) where s1 belings to `cat1`, s2 belongs to `cat2` and
  * d, the distance between s1 and s2, in pixels, is at most `radius`. If cat1 and
  * cat2 are identical, then this call is equivalent to `matchXy(cat1,radius)`.
- * The match is performed in pixel space (2d cartesian).
+ * The match is performed in pixel space (2d cartesian), by bucketing `cat2` in a uniform grid with
+ * cells about `radius` across; the matches of the records of `cat1` are found on up to
+ * `mc.numThreads` threads, and are returned in the order of `cat1`.
  */
 SourceMatchVector matchXy(
         SourceCatalog const &cat1,  ///< first catalog
@@ -103,7 +108,8 @@ SourceMatchVector matchXy(
 /**
  * Compute all tuples (s1,s2,d) where s1 != s2, s1 and s2 both belong to `cat`,
  * and d, the distance between s1 and s2, in pixels, is at most `radius`. The
- * match is performed in pixel space (2d cartesian).
+ * match is performed in pixel space (2d cartesian), as for the two-catalog matchXy; each pair is
+ * reported with its first record earlier in `cat` than its second.
  */
 SourceMatchVector matchXy(
         SourceCatalog const &cat,  ///< the catalog to self-match
@@ -159,25 +165,29 @@ BaseCatalog packMatches(std::vector<Match<Record1, Record2> > const &matches);
  *  @brief Reconstruct a MatchVector from a BaseCatalog representation of the matches
  *         and a pair of catalogs.
  *
- *  @note The first and second catalog arguments must be sorted in ascending ID order on input; this will
- *        allow us to use binary search algorithms to find the records referred to by the match
- *        table.
+ *  The records referred to by the match table are found with a hash index on the IDs of each catalog
+ *  (see HashIndex), built once, so the catalogs need not be sorted; the matches are then resolved on
+ *  up to numThreads threads (0 means one per hardware thread).  When several records of a catalog
+ *  have the same ID, the first of them is used.
  *
  *  If an ID cannot be found in the given tables, that pointer will be set to null
  *  in the returned match vector.
  *
  *  @param[in]  matches     A normalized BaseCatalog representation, as produced by packMatches.
- *  @param[in]  cat1        A CatalogT containing the records used on the 'first' side of the match,
- *                          sorted by ascending ID.
- *  @param[in]  cat2        A CatalogT containing the records used on the 'second' side of the match,
- *                          sorted by ascending ID.  May be the same as first.
+ *  @param[in]  cat1        A CatalogT containing the records used on the 'first' side of the match.
+ *  @param[in]  cat2        A CatalogT containing the records used on the 'second' side of the match.
+ *                          May be the same as first.
+ *  @param[in]  numThreads  Number of threads to resolve matches on.
+ *
+ *  @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0.
  *
  * This is instantiated for Simple-Simple, Simple-Source, and Source-Source catalog combinations.
  */
 template <typename Cat1, typename Cat2>
 std::vector<Match<typename Cat1::Record, typename Cat2::Record> > unpackMatches(BaseCatalog const &matches,
                                                                                 Cat1 const &cat1,
-                                                                                Cat2 const &cat2);
+                                                                                Cat2 const &cat2,
+                                                                                int numThreads = 1);
 }  // namespace table
 }  // namespace afw
 }  // namespace lsst
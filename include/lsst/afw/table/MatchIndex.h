@@ -0,0 +1,156 @@
+// -*- lsst-c++ -*-
+#ifndef AFW_TABLE_MatchIndex_h_INCLUDED
+#define AFW_TABLE_MatchIndex_h_INCLUDED
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "ndarray.h"
+#include "lsst/geom/Angle.h"
+#include "lsst/afw/table/Match.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+
+/**
+ *  Matches as columns: for each match, the positions of its records in the query and indexed
+ *  catalogs, and the distance between them.
+ */
+struct MatchIndices final {
+    ndarray::Array<std::int64_t, 1, 1> first;   ///< positions in the query catalog
+    ndarray::Array<std::int64_t, 1, 1> second;  ///< positions in the indexed catalog; -1 for mismatches
+    ndarray::Array<double, 1, 1> distance;      ///< radians or pixels; NaN for mismatches
+};
+
+/**
+ *  A catalog's positions, arranged for matching many other catalogs against it.
+ *
+ *  matchRaDec and matchXy extract and sort the positions of both catalogs on every call.  A
+ *  MatchIndex extracts the positions of one catalog once, into a k-d tree, and can then be matched
+ *  against any number of (query) catalogs, with any radius.  It is immutable, so queries may be run
+ *  concurrently.
+ *
+ *  Queries obey MatchControl::findOnlyClosest, MatchControl::includeMismatches and
+ *  MatchControl::numThreads.  Matches are returned in the order of the query catalog's records,
+ *  and then of the indexed catalog's; records with NaN positions in either catalog are skipped.
+ *
+ *  The index holds the indexed catalog's records, and does not see later changes to their positions.
+ *
+ *  This is instantiated for SimpleRecord and SourceRecord.
+ */
+template <typename RecordT>
+class MatchIndex final {
+public:
+    /// Build an index on the sky coordinates of a catalog's records.
+    static MatchIndex makeSky(CatalogT<RecordT> const &catalog);
+
+    /**
+     *  Build an index on the centroids of a catalog's records.
+     *
+     *  @throws lsst::pex::exceptions::LogicError if RecordT is not SourceRecord.
+     */
+    static MatchIndex makeXy(CatalogT<RecordT> const &catalog);
+
+    MatchIndex(MatchIndex const &) = default;
+    MatchIndex(MatchIndex &&) = default;
+    MatchIndex &operator=(MatchIndex const &) = default;
+    MatchIndex &operator=(MatchIndex &&) = default;
+    ~MatchIndex() = default;
+
+    /// Return whether the index is on sky coordinates (as opposed to centroids).
+    bool isSky() const noexcept;
+
+    /// Return the number of indexed records (those without NaN positions).
+    std::size_t size() const noexcept;
+
+    //@{
+    /**
+     *  Match the records of a catalog to the indexed records within a radius on the sky.
+     *
+     *  Instantiated for SimpleCatalog and SourceCatalog.
+     *
+     *  @throws lsst::pex::exceptions::LogicError if the index is not on sky coordinates.
+     *  @throws lsst::pex::exceptions::RangeError if the radius is not between 0 and 45 degrees.
+     */
+    template <typename Cat>
+    std::vector<Match<typename Cat::Record, RecordT>> matchRaDec(
+            Cat const &catalog, lsst::geom::Angle radius, MatchControl const &mc = MatchControl()) const;
+
+    template <typename Cat>
+    MatchIndices matchRaDecIndices(Cat const &catalog, lsst::geom::Angle radius,
+                                   MatchControl const &mc = MatchControl()) const;
+    //@}
+
+    //@{
+    /**
+     *  Match the records of a catalog to the indexed records within a radius in pixels.
+     *
+     *  @throws lsst::pex::exceptions::LogicError if the index is not on centroids.
+     */
+    std::vector<Match<SourceRecord, RecordT>> matchXy(SourceCatalog const &catalog, double radius,
+                                                      MatchControl const &mc = MatchControl()) const;
+
+    MatchIndices matchXyIndices(SourceCatalog const &catalog, double radius,
+                                MatchControl const &mc = MatchControl()) const;
+    //@}
+
+private:
+    struct Impl;
+
+    explicit MatchIndex(std::shared_ptr<Impl const> impl);
+
+    std::shared_ptr<Impl const> _impl;
+};
+
+//@{
+/**
+ *  Match two catalogs on the sky, returning matches as columns rather than Match objects.
+ *
+ *  These find the same matches as the corresponding matchRaDec and matchXy, but in the order of the
+ *  records of the first catalog (and then of the second), and without holding any records; with
+ *  many matches, they need several times less memory and no reference counting.  Each is
+ *  instantiated for the same catalog types as its matchRaDec or matchXy.
+ */
+template <typename Cat1, typename Cat2>
+MatchIndices matchRaDecIndices(Cat1 const &cat1, Cat2 const &cat2, lsst::geom::Angle radius,
+                               MatchControl const &mc = MatchControl());
+
+MatchIndices matchXyIndices(SourceCatalog const &cat1, SourceCatalog const &cat2, double radius,
+                            MatchControl const &mc = MatchControl());
+//@}
+
+//@{
+/**
+ *  Match a catalog with itself, returning matches as columns rather than Match objects.
+ *
+ *  Obeys MatchControl::symmetricMatch and MatchControl::numThreads.
+ */
+template <typename Cat>
+MatchIndices matchRaDecIndices(Cat const &cat, lsst::geom::Angle radius,
+                               MatchControl const &mc = MatchControl());
+
+MatchIndices matchXyIndices(SourceCatalog const &cat, double radius, MatchControl const &mc = MatchControl());
+//@}
+
+/**
+ *  Make a catalog of matches from match columns, as packMatches does from Match objects.
+ *
+ *  Mismatches (second < 0) are omitted, since the catalog has no way to record them.
+ *
+ *  @param[in] matches  Positions of matched records in cat1 and cat2, and their distances.
+ *  @param[in] cat1     Catalog whose records the positions in matches.first refer to.
+ *  @param[in] cat2     Catalog whose records the positions in matches.second refer to.
+ *
+ *  @throws lsst::pex::exceptions::LengthError if the columns differ in length, or a position is
+ *      out of range.
+ */
+template <typename Cat1, typename Cat2>
+BaseCatalog packMatches(MatchIndices const &matches, Cat1 const &cat1, Cat2 const &cat2);
+
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !AFW_TABLE_MatchIndex_h_INCLUDED
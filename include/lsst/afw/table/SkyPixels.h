@@ -0,0 +1,76 @@
+// -*- lsst-c++ -*-
+#ifndef AFW_TABLE_SkyPixels_h_INCLUDED
+#define AFW_TABLE_SkyPixels_h_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "ndarray.h"
+#include "lsst/sphgeom/Pixelization.h"
+#include "lsst/afw/table/Catalog.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+
+/// The pixel given to records whose coordinates are not finite; it sorts after every real pixel.
+constexpr std::uint64_t NO_SKY_PIXEL = std::numeric_limits<std::uint64_t>::max();
+
+/// The records [begin, end) of a catalog sorted by sortBySkyPixel, all of which lie in one pixel.
+struct SkyPixelRange final {
+    std::uint64_t pixel;  ///< index of the pixel
+    std::size_t begin;    ///< position of the first record in the pixel
+    std::size_t end;      ///< one past the position of the last record in the pixel
+};
+
+/**
+ *  Return the pixel containing the coordinates of each record of a catalog.
+ *
+ *  The coordinates (the coord field of the minimal SimpleTable schema) are read a column at a time
+ *  and indexed on up to numThreads threads (0 means one per hardware thread).  Any
+ *  sphgeom::Pixelization may be used, e.g. sphgeom::HtmPixelization or sphgeom::HealpixPixelization
+ *  (whose pixels are in the nested scheme, so that, as with HTM, the pixel at a coarser level is found
+ *  by shifting the index right by two bits per level).  Records with non-finite coordinates get
+ *  NO_SKY_PIXEL.
+ *
+ *  Instantiated for SimpleRecord and SourceRecord.
+ *
+ *  @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0.
+ */
+template <typename RecordT>
+ndarray::Array<std::uint64_t, 1, 1> computeSkyPixels(CatalogT<RecordT> const &catalog,
+                                                     sphgeom::Pixelization const &pixelization,
+                                                     int numThreads = 1);
+
+/**
+ *  Return the ranges of consecutive equal values of an array of pixels.
+ *
+ *  The ranges are in order; if the pixels are sorted, each pixel has at most one range.
+ */
+std::vector<SkyPixelRange> findSkyPixelRanges(ndarray::Array<std::uint64_t const, 1, 1> const &pixels);
+
+/**
+ *  Sort a catalog in-place (and stably) by the pixel containing each record, and return the range of
+ *  records in each pixel.
+ *
+ *  Records close together on the sky end up close together in the catalog (and, for a contiguous
+ *  catalog deep-copied afterwards, in memory), which gives locality to matching and other per-region
+ *  processing, and the ranges are natural units of work to share among threads.  The pixels are
+ *  those of computeSkyPixels, and are sorted on up to numThreads threads; records with non-finite
+ *  coordinates end up in a last range, with pixel NO_SKY_PIXEL.
+ *
+ *  Instantiated for SimpleRecord and SourceRecord.
+ *
+ *  @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0.
+ */
+template <typename RecordT>
+std::vector<SkyPixelRange> sortBySkyPixel(CatalogT<RecordT> &catalog,
+                                          sphgeom::Pixelization const &pixelization, int numThreads = 1);
+
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !AFW_TABLE_SkyPixels_h_INCLUDED
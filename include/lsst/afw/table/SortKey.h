@@ -0,0 +1,91 @@
+// -*- lsst-c++ -*-
+#ifndef AFW_TABLE_SortKey_h_INCLUDED
+#define AFW_TABLE_SortKey_h_INCLUDED
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "lsst/afw/table/BaseRecord.h"
+#include "lsst/afw/math/detail/Parallel.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+
+namespace detail {
+
+/**
+ *  Stably reorder a list of indices by the values getValue(index), on up to nThreads threads.
+ *
+ *  The values are extracted once into a dense array along with their positions, which are sorted
+ *  together (breaking ties by position, which makes the unstable parallel sort stable).
+ */
+template <typename Value, typename GetValue>
+void stableSortOrder(std::vector<std::size_t> &order, GetValue const &getValue, int nThreads) {
+    std::size_t const n = order.size();
+    std::vector<std::pair<Value, std::size_t>> items(n);
+    auto const pieces = math::detail::splitRange(0, static_cast<int>(n), nThreads);
+    math::detail::parallelFor(static_cast<int>(pieces.size()), nThreads, [&](int i) {
+        for (int k = pieces[i].first; k < pieces[i].second; ++k) {
+            items[k] = std::make_pair(getValue(order[k]), static_cast<std::size_t>(k));
+        }
+    });
+    math::detail::parallelSort(
+            items.begin(), items.end(),
+            [](std::pair<Value, std::size_t> const &a, std::pair<Value, std::size_t> const &b) {
+                return a.first < b.first || (!(b.first < a.first) && a.second < b.second);
+            },
+            nThreads);
+    std::vector<std::size_t> result(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        result[k] = order[items[k].second];
+    }
+    order.swap(result);
+}
+
+}  // namespace detail
+
+/**
+ *  One of the fields to sort a catalog by, in CatalogT::sort(std::vector<SortKey> const &, int).
+ *
+ *  A SortKey can be constructed (implicitly) from the Key of any scalar field.
+ */
+class SortKey final {
+public:
+    template <typename T>
+    SortKey(Key<T> const &key)
+            : _refine([key](std::vector<BaseRecord const *> const &records, std::vector<std::size_t> &order,
+                            int nThreads) {
+                  detail::stableSortOrder<typename Field<T>::Value>(
+                          order, [&records, &key](std::size_t i) { return records[i]->get(key); }, nThreads);
+              }) {}
+
+    SortKey(SortKey const &) = default;
+    SortKey(SortKey &&) = default;
+    SortKey &operator=(SortKey const &) = default;
+    SortKey &operator=(SortKey &&) = default;
+    ~SortKey() = default;
+
+    /**
+     *  Stably reorder indices into records by this field.
+     *
+     *  @param[in]     records   Records being sorted.
+     *  @param[in,out] order     Indices into records, in their current order.
+     *  @param[in]     nThreads  Number of threads to sort with; must be >= 1.
+     */
+    void refine(std::vector<BaseRecord const *> const &records, std::vector<std::size_t> &order,
+                int nThreads) const {
+        _refine(records, order, nThreads);
+    }
+
+private:
+    std::function<void(std::vector<BaseRecord const *> const &, std::vector<std::size_t> &, int)> _refine;
+};
+
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !AFW_TABLE_SortKey_h_INCLUDED
@@ -142,6 +142,52 @@ public:
         return io::FitsReader::apply<SortedCatalogT>(manager, hdu, flags);
     }
 
+    /**
+     *  Read some of the columns and rows of a FITS binary table from a regular file.
+     *
+     *  The fields of the table's minimal schema, and any first-class objects (such as Footprints),
+     *  are read as usual; of the regular columns, only those named (and the one compared by rows)
+     *  are read.  Rows that are not selected are never added to the catalog.
+     *
+     *  @param[in] filename    Name of the file to read.
+     *  @param[in] hdu         Number of the "header-data unit" to read (where 0 is the Primary HDU).
+     *  @param[in] flags       Table-subclass-dependent bitflags that control the details of how to read
+     *                         the catalog.  See e.g. SourceFitsFlags.
+     *  @param[in] columns     Names of the columns (or aliases to them) to read; if empty, all columns
+     *                         are read.
+     *  @param[in] rows        The rows to read.
+     *
+     *  @throws lsst::pex::exceptions::NotFoundError if a name does not match any column or field.
+     *  @throws lsst::pex::exceptions::TypeError if rows compares a field that is not a scalar number,
+     *          Angle or Flag.
+     */
+    static SortedCatalogT readFits(std::string const& filename, int hdu, int flags,
+                                   std::vector<std::string> const& columns,
+                                   io::FitsRowFilter const& rows = io::FitsRowFilter()) {
+        return io::FitsReader::apply<SortedCatalogT>(filename, hdu, flags, nullptr, columns, rows);
+    }
+
+    /**
+     *  Read some of the columns and rows of a FITS binary table from a RAM file.
+     *
+     *  @param[in] manager     Object that manages the memory to be read.
+     *  @param[in] hdu         Number of the "header-data unit" to read (where 0 is the Primary HDU).
+     *  @param[in] flags       Table-subclass-dependent bitflags that control the details of how to read
+     *                         the catalog.  See e.g. SourceFitsFlags.
+     *  @param[in] columns     Names of the columns (or aliases to them) to read; if empty, all columns
+     *                         are read.
+     *  @param[in] rows        The rows to read.
+     *
+     *  @throws lsst::pex::exceptions::NotFoundError if a name does not match any column or field.
+     *  @throws lsst::pex::exceptions::TypeError if rows compares a field that is not a scalar number,
+     *          Angle or Flag.
+     */
+    static SortedCatalogT readFits(fits::MemFileManager& manager, int hdu, int flags,
+                                   std::vector<std::string> const& columns,
+                                   io::FitsRowFilter const& rows = io::FitsRowFilter()) {
+        return io::FitsReader::apply<SortedCatalogT>(manager, hdu, flags, nullptr, columns, rows);
+    }
+
     /**
      *  Read a FITS binary table from a file object already at the correct extension.
      *
@@ -153,6 +199,19 @@ public:
         return io::FitsReader::apply<SortedCatalogT>(fitsfile, flags);
     }
 
+    /// Concatenate catalogs into a new, contiguous catalog; see CatalogT::concatenate.
+    template <typename InputCatalogT = SortedCatalogT>
+    static SortedCatalogT concatenate(std::vector<InputCatalogT> const& catalogs, int numThreads = 1) {
+        return SortedCatalogT(Base::concatenate(catalogs, numThreads));
+    }
+
+    /// Concatenate catalogs into a new, contiguous catalog with a SchemaMapper; see CatalogT::concatenate.
+    template <typename InputCatalogT = SortedCatalogT>
+    static SortedCatalogT concatenate(std::shared_ptr<Table> const& table, SchemaMapper const& mapper,
+                                      std::vector<InputCatalogT> const& catalogs, int numThreads = 1) {
+        return SortedCatalogT(Base::concatenate(table, mapper, catalogs, numThreads));
+    }
+
     /**
      *  Return the subset of a catalog corresponding to the True values of the given mask array.
      *
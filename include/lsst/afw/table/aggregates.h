@@ -44,6 +44,8 @@ namespace table {
 
 template <typename T, int N>
 class CovarianceMatrixKey;
+class BaseColumnView;
+
 /**
  *  A FunctorKey used to get or set a lsst::geom::Point from an (x,y) pair of int or double Keys.
  */
@@ -335,6 +337,23 @@ public:
     /// Set an lsst::geom::SpherePoint in the given record
     void set(BaseRecord& record, lsst::geom::SpherePoint const& value) const override;
 
+    /**
+     *  Return the coordinates of all records in a catalog as an (N, 2) array of (ra, dec) in radians.
+     *
+     *  @param[in] columns  Column view of a contiguous catalog with this key's schema.
+     */
+    ndarray::Array<double, 2, 2> getColumns(BaseColumnView const& columns) const;
+
+    /**
+     *  Set the coordinates of all records in a catalog from an (N, 2) array of (ra, dec) in radians.
+     *
+     *  @param[in] columns  Column view of a contiguous catalog with this key's schema.
+     *  @param[in] values   Coordinates, with one row per record.
+     *
+     *  @throws lsst::pex::exceptions::LengthError if values does not have shape (N, 2).
+     */
+    void setColumns(BaseColumnView const& columns, ndarray::Array<double const, 2> const& values) const;
+
     //@{
     /// Compare CoordKeys for equality using the constituent `ra` and `dec` Keys
     bool operator==(CoordKey const& other) const noexcept { return _ra == other._ra && _dec == other._dec; }
@@ -411,6 +430,23 @@ public:
     /// Set a Quadrupole in the given record
     void set(BaseRecord& record, geom::ellipses::Quadrupole const& value) const override;
 
+    /**
+     *  Return the moments of all records in a catalog as an (N, 3) array of (ixx, iyy, ixy).
+     *
+     *  @param[in] columns  Column view of a contiguous catalog with this key's schema.
+     */
+    ndarray::Array<double, 2, 2> getColumns(BaseColumnView const& columns) const;
+
+    /**
+     *  Set the moments of all records in a catalog from an (N, 3) array of (ixx, iyy, ixy).
+     *
+     *  @param[in] columns  Column view of a contiguous catalog with this key's schema.
+     *  @param[in] values   Moments, with one row per record.
+     *
+     *  @throws lsst::pex::exceptions::LengthError if values does not have shape (N, 3).
+     */
+    void setColumns(BaseColumnView const& columns, ndarray::Array<double const, 2> const& values) const;
+
     //@{
     /// Compare the FunctorKey for equality with another, using the underlying Ixx, Iyy, Ixy Keys
     bool operator==(QuadrupoleKey const& other) const noexcept {
@@ -487,6 +523,23 @@ public:
     /// Set an Ellipse in the given record
     void set(BaseRecord& record, geom::ellipses::Ellipse const& value) const override;
 
+    /**
+     *  Return the ellipses of all records in a catalog as an (N, 5) array of (ixx, iyy, ixy, x, y).
+     *
+     *  @param[in] columns  Column view of a contiguous catalog with this key's schema.
+     */
+    ndarray::Array<double, 2, 2> getColumns(BaseColumnView const& columns) const;
+
+    /**
+     *  Set the ellipses of all records in a catalog from an (N, 5) array of (ixx, iyy, ixy, x, y).
+     *
+     *  @param[in] columns  Column view of a contiguous catalog with this key's schema.
+     *  @param[in] values   Ellipses, with one row per record.
+     *
+     *  @throws lsst::pex::exceptions::LengthError if values does not have shape (N, 5).
+     */
+    void setColumns(BaseColumnView const& columns, ndarray::Array<double const, 2> const& values) const;
+
     //@{
     /// Compare the FunctorKey for equality with another, using the underlying Ixx, Iyy, Ixy Keys
     bool operator==(EllipseKey const& other) const noexcept {
@@ -610,6 +663,29 @@ public:
     /// Set the element in row i and column j
     void setElement(BaseRecord& record, int i, int j, T value) const;
 
+    /**
+     *  Return the covariance matrices of all records in a catalog as an (N, n, n) array.
+     *
+     *  The columns are looked up once and unpacked in a single pass over the records, which is much
+     *  faster than calling get() on each record.  Elements with no field are zero, as in get().
+     *
+     *  @param[in] columns  Column view of a contiguous catalog with this key's schema.
+     */
+    ndarray::Array<T, 3, 3> getColumns(BaseColumnView const& columns) const;
+
+    /**
+     *  Set the covariance matrices of all records in a catalog from an (N, n, n) array.
+     *
+     *  As with set(), only the lower triangle of each matrix is used, and elements with no field are
+     *  ignored.
+     *
+     *  @param[in] columns  Column view of a contiguous catalog with this key's schema.
+     *  @param[in] values   Matrices, with one per record.
+     *
+     *  @throws lsst::pex::exceptions::LengthError if values does not have shape (N, n, n).
+     */
+    void setColumns(BaseColumnView const& columns, ndarray::Array<T const, 3> const& values) const;
+
     /**
      *  Return True if all the constituent error Keys are valid
      *
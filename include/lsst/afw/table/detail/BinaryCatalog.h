@@ -0,0 +1,59 @@
+// -*- lsst-c++ -*-
+#ifndef AFW_TABLE_DETAIL_BinaryCatalog_h_INCLUDED
+#define AFW_TABLE_DETAIL_BinaryCatalog_h_INCLUDED
+
+#include <cstdint>
+#include <vector>
+
+#include "lsst/afw/table/BaseRecord.h"
+#include "lsst/afw/table/Catalog.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+namespace detail {
+
+/**
+ *  Append the header of a binary archive to a buffer: a magic string and the number of catalogs
+ *  that follow it.
+ */
+void writeBinaryArchiveHeader(std::size_t nCatalogs, std::vector<std::uint8_t> &buffer);
+
+/**
+ *  Read the header written by writeBinaryArchiveHeader, returning the number of catalogs.
+ *
+ *  @param[in,out] data  Start of the archive; set to the byte after the header.
+ *  @param[in]     end   End of the buffer.
+ *
+ *  @throws lsst::afw::table::io::MalformedArchiveError if the buffer is not a binary archive.
+ */
+std::size_t readBinaryArchiveHeader(std::uint8_t const *&data, std::uint8_t const *end);
+
+/**
+ *  Append a catalog and its schema to a buffer, in a compact binary format.
+ *
+ *  The format is a flat sequence of little-endian values: the number of fields, then the type,
+ *  name, doc, units and size of each, then the number of records, then the value of each field of
+ *  each record.  Strings and arrays are prefixed by their lengths.  Aliases and metadata are not
+ *  saved.  This is the format used by OutputArchive::writeBinary, and only needs to be read back by
+ *  the same version of afw.
+ */
+void writeBinaryCatalog(BaseCatalog const &catalog, std::vector<std::uint8_t> &buffer);
+
+/**
+ *  Read a catalog written by writeBinaryCatalog.
+ *
+ *  @param[in,out] data  Start of the catalog; set to the byte after it.
+ *  @param[in]     end   End of the buffer.
+ *
+ *  @throws lsst::afw::table::io::MalformedArchiveError if the buffer ends early or names an
+ *      unknown field type.
+ */
+BaseCatalog readBinaryCatalog(std::uint8_t const *&data, std::uint8_t const *end);
+
+}  // namespace detail
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !AFW_TABLE_DETAIL_BinaryCatalog_h_INCLUDED
@@ -0,0 +1,158 @@
+// -*- lsst-c++ -*-
+#ifndef AFW_TABLE_DETAIL_PointGrid_h_INCLUDED
+#define AFW_TABLE_DETAIL_PointGrid_h_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace lsst {
+namespace afw {
+namespace table {
+namespace detail {
+
+/**
+ *  A uniform grid of buckets over 2-d points, for finding all points within some distance of another.
+ *
+ *  This is an implementation detail of matchXy.  With cells about as large as the search distance,
+ *  a query visits at most four cells, so its cost depends only on the density of points near the
+ *  query, and not (as for a sweep over a band of y) on that of all points in the band.  Cells are
+ *  enlarged as needed so there are at most a few per point, however sparse the points.  The grid is
+ *  immutable once built, so it may be queried concurrently.
+ */
+class PointGrid final {
+public:
+    using Point = std::array<double, 2>;
+
+    /**
+     *  Build a grid over a list of points; points are identified by their positions in the list.
+     *
+     *  Points that are not finite are never found.
+     *
+     *  @param[in] points    Points to index.
+     *  @param[in] cellSize  Minimum size of a cell; queries are fastest for distances of about this.
+     */
+    PointGrid(std::vector<Point> const &points, double cellSize) : _nx(0), _ny(0), _cellSize(1.0) {
+        std::size_t const n = points.size();
+        std::size_t nFinite = 0;
+        for (auto const &p : points) {
+            if (!std::isfinite(p[0]) || !std::isfinite(p[1])) {
+                continue;
+            }
+            if (nFinite++ == 0) {
+                _lower = _upper = p;
+            }
+            for (int k = 0; k < 2; ++k) {
+                _lower[k] = std::min(_lower[k], p[k]);
+                _upper[k] = std::max(_upper[k], p[k]);
+            }
+        }
+        if (nFinite == 0) {
+            return;
+        }
+        double const width = _upper[0] - _lower[0];
+        double const height = _upper[1] - _lower[1];
+        // Keep the number of cells within a small multiple of the number of points.
+        double const maxCells = 4.0 * nFinite;
+        _cellSize = std::max({cellSize, std::sqrt(width * height / maxCells), width / maxCells,
+                              height / maxCells});
+        if (!(_cellSize > 0.0) || !std::isfinite(_cellSize)) {
+            _cellSize = std::max({width, height, 1.0});
+        }
+        _nx = static_cast<std::size_t>(width / _cellSize) + 1;
+        _ny = static_cast<std::size_t>(height / _cellSize) + 1;
+
+        // Sort the points by cell (counting sort), keeping their order within each cell.
+        std::size_t const nCells = _nx * _ny;
+        std::vector<std::size_t> cells(n, nCells);
+        _cellStart.assign(nCells + 1, 0);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (std::isfinite(points[i][0]) && std::isfinite(points[i][1])) {
+                cells[i] = _cellOf(points[i][0], 0, _nx) + _nx * _cellOf(points[i][1], 1, _ny);
+                ++_cellStart[cells[i] + 1];
+            }
+        }
+        for (std::size_t c = 0; c < nCells; ++c) {
+            _cellStart[c + 1] += _cellStart[c];
+        }
+        std::vector<std::size_t> next(_cellStart.begin(), _cellStart.end() - 1);
+        _points.resize(nFinite);
+        _index.resize(nFinite);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (cells[i] < nCells) {
+                std::size_t const k = next[cells[i]]++;
+                _points[k] = points[i];
+                _index[k] = i;
+            }
+        }
+    }
+
+    /// Return the number of (finite) points.
+    std::size_t size() const noexcept { return _points.size(); }
+
+    /**
+     *  Find all points whose squared distance from a point is less than d2Limit.
+     *
+     *  @param[in]  point    Point to search around.
+     *  @param[in]  d2Limit  Squared distance limit.
+     *  @param[out] found    Set to (index, squared distance) pairs, in ascending order of index.
+     */
+    void findWithin(Point const &point, double d2Limit,
+                    std::vector<std::pair<std::size_t, double>> &found) const {
+        found.clear();
+        if (_points.empty() || !(d2Limit > 0.0)) {
+            return;
+        }
+        double const r = std::sqrt(d2Limit);
+        if (point[0] + r < _lower[0] || point[0] - r > _upper[0] || point[1] + r < _lower[1] ||
+            point[1] - r > _upper[1]) {
+            return;
+        }
+        std::size_t const x0 = _cellOf(point[0] - r, 0, _nx);
+        std::size_t const x1 = _cellOf(point[0] + r, 0, _nx);
+        std::size_t const y0 = _cellOf(point[1] - r, 1, _ny);
+        std::size_t const y1 = _cellOf(point[1] + r, 1, _ny);
+        for (std::size_t y = y0; y <= y1; ++y) {
+            // The cells of a row of the grid are contiguous.
+            std::size_t const end = _cellStart[x1 + 1 + _nx * y];
+            for (std::size_t i = _cellStart[x0 + _nx * y]; i < end; ++i) {
+                double const dx = point[0] - _points[i][0];
+                double const dy = point[1] - _points[i][1];
+                double const d2 = dx * dx + dy * dy;
+                if (d2 < d2Limit) {
+                    found.emplace_back(_index[i], d2);
+                }
+            }
+        }
+        std::sort(found.begin(), found.end());
+    }
+
+private:
+    // Return the cell holding a coordinate along an axis, clamped to the grid.
+    std::size_t _cellOf(double value, int axis, std::size_t nCells) const {
+        double const cell = std::floor((value - _lower[axis]) / _cellSize);
+        if (cell <= 0.0) {
+            return 0;
+        }
+        return std::min(static_cast<std::size_t>(cell), nCells - 1);
+    }
+
+    Point _lower;
+    Point _upper;
+    std::size_t _nx;
+    std::size_t _ny;
+    double _cellSize;
+    std::vector<std::size_t> _cellStart;  // points of cell c are [_cellStart[c], _cellStart[c + 1])
+    std::vector<Point> _points;           // in cell order
+    std::vector<std::size_t> _index;      // positions in the original list, in cell order
+};
+
+}  // namespace detail
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !AFW_TABLE_DETAIL_PointGrid_h_INCLUDED
@@ -0,0 +1,149 @@
+// -*- lsst-c++ -*-
+#ifndef AFW_TABLE_DETAIL_PointTree_h_INCLUDED
+#define AFW_TABLE_DETAIL_PointTree_h_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace lsst {
+namespace afw {
+namespace table {
+namespace detail {
+
+/**
+ *  A k-d tree over N-dimensional points, for finding all points within some distance of another.
+ *
+ *  This is an implementation detail of the matching code (matchRaDec and MatchIndex), which use it
+ *  on unit vectors (N=3) and on pixel positions (N=2).  The tree is immutable once built, so it may
+ *  be queried concurrently.
+ */
+template <int N>
+class PointTree final {
+public:
+    using Point = std::array<double, N>;
+
+    /// Build a tree over a list of points; points are identified by their positions in the list.
+    explicit PointTree(std::vector<Point> points) : _points(std::move(points)), _index(_points.size()) {
+        for (std::size_t i = 0; i < _index.size(); ++i) {
+            _index[i] = i;
+        }
+        if (!_points.empty()) {
+            _nodes.reserve(2 * (_points.size() / LEAF_SIZE + 1));
+            _build(0, _points.size());
+        }
+        // Store the points in tree order, so leaves are contiguous.
+        std::vector<Point> ordered;
+        ordered.reserve(_points.size());
+        for (std::size_t i : _index) {
+            ordered.push_back(_points[i]);
+        }
+        _points.swap(ordered);
+    }
+
+    /// Return the number of points.
+    std::size_t size() const noexcept { return _points.size(); }
+
+    /**
+     *  Find all points whose squared distance from a point is less than d2Limit.
+     *
+     *  @param[in]  point    Point to search around.
+     *  @param[in]  d2Limit  Squared distance limit.
+     *  @param[out] found    Set to (index, squared distance) pairs, in ascending order of index.
+     */
+    void findWithin(Point const &point, double d2Limit,
+                    std::vector<std::pair<std::size_t, double>> &found) const {
+        found.clear();
+        if (_nodes.empty()) {
+            return;
+        }
+        std::vector<int> stack(1, 0);
+        while (!stack.empty()) {
+            Node const &node = _nodes[stack.back()];
+            stack.pop_back();
+            double boxD2 = 0.0;
+            for (int k = 0; k < N; ++k) {
+                double const d = std::max({node.lower[k] - point[k], point[k] - node.upper[k], 0.0});
+                boxD2 += d * d;
+            }
+            if (boxD2 >= d2Limit) {
+                continue;
+            }
+            if (node.left >= 0) {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+                continue;
+            }
+            for (std::size_t i = node.begin; i < node.end; ++i) {
+                double d2 = 0.0;
+                for (int k = 0; k < N; ++k) {
+                    double const d = point[k] - _points[i][k];
+                    d2 += d * d;
+                }
+                if (d2 < d2Limit) {
+                    found.emplace_back(_index[i], d2);
+                }
+            }
+        }
+        std::sort(found.begin(), found.end());
+    }
+
+private:
+    static constexpr std::size_t LEAF_SIZE = 16;
+
+    // A node of the tree, with the bounding box of its points; leaves hold the points
+    // [begin, end), and other nodes two children.
+    struct Node {
+        Point lower;
+        Point upper;
+        std::size_t begin;
+        std::size_t end;
+        int left;
+        int right;
+    };
+
+    int _build(std::size_t begin, std::size_t end) {
+        Node node{_points[_index[begin]], _points[_index[begin]], begin, end, -1, -1};
+        for (std::size_t i = begin; i < end; ++i) {
+            for (int k = 0; k < N; ++k) {
+                node.lower[k] = std::min(node.lower[k], _points[_index[i]][k]);
+                node.upper[k] = std::max(node.upper[k], _points[_index[i]][k]);
+            }
+        }
+        int const index = static_cast<int>(_nodes.size());
+        _nodes.push_back(node);
+        if (end - begin <= LEAF_SIZE) {
+            return index;
+        }
+        // Split at the median along the axis on which the points are most spread.
+        int axis = 0;
+        for (int k = 1; k < N; ++k) {
+            if (node.upper[k] - node.lower[k] > node.upper[axis] - node.lower[axis]) {
+                axis = k;
+            }
+        }
+        std::size_t const middle = begin + (end - begin) / 2;
+        std::nth_element(_index.begin() + begin, _index.begin() + middle, _index.begin() + end,
+                         [this, axis](std::size_t a, std::size_t b) {
+                             return _points[a][axis] < _points[b][axis];
+                         });
+        int const left = _build(begin, middle);
+        int const right = _build(middle, end);
+        _nodes[index].left = left;
+        _nodes[index].right = right;
+        return index;
+    }
+
+    std::vector<Point> _points;  // in tree order, once built
+    std::vector<std::size_t> _index;
+    std::vector<Node> _nodes;
+};
+
+}  // namespace detail
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
+
+#endif  // !AFW_TABLE_DETAIL_PointTree_h_INCLUDED
@@ -5,6 +5,7 @@
 #include <vector>
 #include <algorithm>
 #include <map>
+#include <unordered_map>
 #include <variant>
 
 namespace lsst {
@@ -57,6 +58,8 @@ public:
     using ItemContainer = std::vector<ItemVariant>;
     /// A map from field names to position in the vector, so we can do name lookups.
     using NameMap = std::map<std::string, std::size_t>;
+    /// A hash table with the same contents as NameMap, for constant-time lookups of exact names.
+    using NameIndex = std::unordered_map<std::string, std::size_t>;
     /// A map from standard field offsets to position in the vector, so we can do field lookups.
     using OffsetMap = std::map<std::size_t, std::size_t>;
     /// A map from Flag field offset/bit pairs to position in the vector, so we can do Flag field lookups.
@@ -88,8 +91,8 @@ public:
     /// Find an item by name and run the given functor on it.
     template <typename F>
     decltype(auto) findAndApply(std::string const& name, F&& func) const {
-        auto iter = _names.find(name);
-        if (iter == _names.end()) {
+        auto iter = _nameIndex.find(name);
+        if (iter == _nameIndex.end()) {
             throw LSST_EXCEPT(pex::exceptions::NotFoundError,
                               (boost::format("Field with name '%s' not found") % name).str());
         }
@@ -146,6 +149,7 @@ private:
     std::size_t _lastFlagBit;      // Bit of the last flag field.
     ItemContainer _items;  // Vector of variants of SchemaItem<T>.
     NameMap _names;        // Field name to vector-index map.
+    NameIndex _nameIndex;  // Field name to vector-index hash table; always has the same contents as _names.
     OffsetMap _offsets;    // Offset to vector-index map for regular fields.
     FlagMap _flags;        // Offset to vector-index map for flags.
     bool _initFlag;        // Indicates if record is valid
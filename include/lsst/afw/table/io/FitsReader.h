@@ -2,7 +2,13 @@
 #ifndef AFW_TABLE_IO_FitsReader_h_INCLUDED
 #define AFW_TABLE_IO_FitsReader_h_INCLUDED
 
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
 #include <type_traits>
+#include <vector>
 
 #include "lsst/afw/fits.h"
 #include "lsst/afw/table/Schema.h"
@@ -16,6 +22,73 @@ namespace afw {
 namespace table {
 namespace io {
 
+/**
+ *  A selection of the rows of a FITS binary table to read into a catalog.
+ *
+ *  Rows are selected by a half-open range of row indices and, optionally, by comparing the value of
+ *  one scalar numeric, Angle or Flag field to a number (e.g. "parent == 0").  The comparison is
+ *  evaluated as the rows are read, and rows that fail it are never added to the catalog.
+ */
+class FitsRowFilter final {
+public:
+    /// A row index past the end of any table, used to read rows up to the end.
+    static constexpr std::size_t END = std::numeric_limits<std::size_t>::max();
+
+    /**
+     *  Select the rows with indices in [begin, end).
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if end < begin.
+     */
+    explicit FitsRowFilter(std::size_t begin = 0, std::size_t end = END);
+
+    /**
+     *  Select the rows with indices in [begin, end) for which `field comparison value` holds.
+     *
+     *  @param[in] field       Name (or alias) of the field to compare.
+     *  @param[in] comparison  One of "==", "!=", "<", "<=", ">" and ">=".  Angles are compared in
+     *                         radians, and Flags as 0 or 1.
+     *  @param[in] value       Value to compare each row's field to.
+     *  @param[in] begin       Index of the first row to read.
+     *  @param[in] end         One past the index of the last row to read; clipped to the table size.
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if the comparison is not recognized or
+     *          end < begin.
+     */
+    FitsRowFilter(std::string const& field, std::string const& comparison, double value,
+                  std::size_t begin = 0, std::size_t end = END);
+
+    FitsRowFilter(FitsRowFilter const&) = default;
+    FitsRowFilter(FitsRowFilter&&) = default;
+    FitsRowFilter& operator=(FitsRowFilter const&) = default;
+    FitsRowFilter& operator=(FitsRowFilter&&) = default;
+    ~FitsRowFilter() = default;
+
+    std::size_t getBegin() const noexcept { return _begin; }
+    std::size_t getEnd() const noexcept { return _end; }
+
+    /// Return true if rows are also selected by comparing a field to a value.
+    bool hasComparison() const noexcept { return !_field.empty(); }
+
+    std::string const& getField() const noexcept { return _field; }
+    std::string const& getComparison() const noexcept { return _comparison; }
+    double getValue() const noexcept { return _value; }
+
+    /**
+     *  Return a function that tests whether a record passes the comparison.
+     *
+     *  @throws lsst::pex::exceptions::NotFoundError if the schema has no such field.
+     *  @throws lsst::pex::exceptions::TypeError if the field is not a scalar number, Angle or Flag.
+     */
+    std::function<bool(BaseRecord const&)> makeTest(Schema const& schema) const;
+
+private:
+    std::size_t _begin;
+    std::size_t _end;
+    std::string _field;
+    std::string _comparison;
+    double _value;
+};
+
 /**
  *  A utility class for reading FITS binary tables.
  *
@@ -66,30 +139,88 @@ public:
      *                       archive argument is provided only for cases in which the catalog itself is
      *                       part of a larger object, and does not "own" its own archive (e.g. CoaddPsf
      *                       persistence).
+     *  @param[in]  columns  Names of the columns to read (see FitsSchemaInputMapper::select); the
+     *                       fields of the table's minimal schema, and the field compared by rows,
+     *                       are always read.  If empty, all columns are read.
+     *  @param[in]  rows     The rows to read.
      */
     template <typename ContainerT>
     static ContainerT apply(afw::fits::Fits& fits, int ioFlags,
-                            std::shared_ptr<InputArchive> archive = std::shared_ptr<InputArchive>()) {
+                            std::shared_ptr<InputArchive> archive = std::shared_ptr<InputArchive>(),
+                            std::vector<std::string> const& columns = {},
+                            FitsRowFilter const& rows = FitsRowFilter()) {
+        // We need to be able to support reading Catalog<T const>, since it shares the same template
+        // as Catalog<T> (which invokes this method in readFits).
+        using Record = typename std::remove_const<typename ContainerT::Record>::type;
+        // A tile-compressed table is decompressed into memory and read from there; the archive is
+        // still read from the file's other HDUs.
+        afw::fits::MemFileManager uncompressedManager;
+        std::unique_ptr<afw::fits::Fits> uncompressed;
+        if (fits.isCompressedTable()) {
+            uncompressed = std::make_unique<afw::fits::Fits>(
+                    uncompressedManager, "w", afw::fits::Fits::AUTO_CLOSE | afw::fits::Fits::AUTO_CHECK);
+            uncompressed->createEmpty();
+            uncompressed->writeUncompressedTable(fits, FitsSchemaInputMapper::READ_THREADS);
+        }
+        afw::fits::Fits& tableFits = uncompressed ? *uncompressed : fits;
         std::shared_ptr<daf::base::PropertyList> metadata = std::make_shared<daf::base::PropertyList>();
-        fits.readMetadata(*metadata, true);
+        tableFits.readMetadata(*metadata, true);
         FitsReader const* reader = _lookupFitsReader(*metadata);
         FitsSchemaInputMapper mapper(*metadata, true);
         reader->_setupArchive(fits, mapper, archive, ioFlags);
+        mapper.select(columns);
+        if (!columns.empty() && rows.hasComparison()) {
+            mapper.select({rows.getField()});
+        }
         std::shared_ptr<BaseTable> table = reader->makeTable(mapper, metadata, ioFlags, true);
         ContainerT container(std::dynamic_pointer_cast<typename ContainerT::Table>(table));
         if (!container.getTable()) {
             throw LSST_EXCEPT(pex::exceptions::RuntimeError, "Invalid table class for catalog.");
         }
-        std::size_t nRows = fits.countRows();
-        container.reserve(nRows);
-        for (std::size_t row = 0; row < nRows; ++row) {
-            mapper.readRecord(
-                    // We need to be able to support reading Catalog<T const>, since it shares the same
-                    // template
-                    // as Catalog<T> (which invokes this method in readFits).
-                    const_cast<typename std::remove_const<typename ContainerT::Record>::type&>(
-                            *container.addNew()),
-                    fits, row);
+        std::size_t const nFileRows = tableFits.countRows();
+        std::size_t const begin = std::min(rows.getBegin(), nFileRows);
+        std::size_t const end = std::min(rows.getEnd(), nFileRows);
+        if (!rows.hasComparison()) {
+            if (FitsSchemaInputMapper::MAP_ROWS && end > begin) {
+                auto mapped = mapper.mapRecords(*table, tableFits, begin, end - begin);
+                if (!mapped.empty()) {
+                    container.getInternal().reserve(mapped.size());
+                    for (auto const& record : mapped) {
+                        container.push_back(std::static_pointer_cast<Record>(record));
+                    }
+                    return container;
+                }
+            }
+            container.reserve(end - begin);
+            std::vector<BaseRecord*> records;
+            records.reserve(end - begin);
+            for (std::size_t row = begin; row < end; ++row) {
+                records.push_back(const_cast<Record*>(container.addNew().get()));
+            }
+            mapper.readRecords(records, tableFits, begin);
+            return container;
+        }
+        // Read a chunk of rows at a time into scratch records from a table of their own, and copy
+        // only those that pass into the catalog.
+        auto const test = rows.makeTest(table->getSchema());
+        ContainerT scratch(std::static_pointer_cast<typename ContainerT::Table>(table->clone()));
+        std::size_t const chunkRows = std::min(
+                std::max(FitsSchemaInputMapper::READ_CHUNK_BYTES / table->getSchema().getRecordSize(),
+                         std::size_t(1)),
+                end - begin);
+        std::vector<BaseRecord*> records;
+        records.reserve(chunkRows);
+        for (std::size_t i = 0; i < chunkRows; ++i) {
+            records.push_back(const_cast<Record*>(scratch.addNew().get()));
+        }
+        for (std::size_t row = begin; row < end; row += records.size()) {
+            records.resize(std::min(records.size(), end - row));
+            mapper.readRecords(records, tableFits, row);
+            for (BaseRecord const* record : records) {
+                if (test(*record)) {
+                    const_cast<Record*>(container.addNew().get())->assign(*record);
+                }
+            }
         }
         return container;
     }
@@ -102,10 +233,12 @@ public:
      */
     template <typename ContainerT, typename SourceT>
     static ContainerT apply(SourceT& source, int hdu, int ioFlags,
-                            std::shared_ptr<InputArchive> archive = std::shared_ptr<InputArchive>()) {
+                            std::shared_ptr<InputArchive> archive = std::shared_ptr<InputArchive>(),
+                            std::vector<std::string> const& columns = {},
+                            FitsRowFilter const& rows = FitsRowFilter()) {
         afw::fits::Fits fits(source, "r", afw::fits::Fits::AUTO_CLOSE | afw::fits::Fits::AUTO_CHECK);
         fits.setHdu(hdu);
-        return apply<ContainerT>(fits, ioFlags, archive);
+        return apply<ContainerT>(fits, ioFlags, archive, columns, rows);
     }
 
     /**
@@ -115,7 +248,8 @@ public:
      *  Most implementations can simply call mapper.finalize() to create the Schema, then construct a
      *  new Table and set its metadata to the given PropertyList.
      *  Readers for record classes that have first-class objects in addition to regular fields
-     *  should call mapper.customize() with a custom FitsColumnReader before calling finalize().
+     *  should call mapper.customize() with a custom FitsColumnReader before calling finalize(), and
+     *  readers for tables with a minimal schema should pass it to mapper.require().
      *
      *  @param[in]  mapper    A representation of the FITS binary table schema, capable of producing
      *                        an afw::table::Schema from it while allowing customization of the mapping
@@ -2,6 +2,9 @@
 #ifndef AFW_TABLE_IO_FitsSchemaInputMapper_h_INCLUDED
 #define AFW_TABLE_IO_FitsSchemaInputMapper_h_INCLUDED
 
+#include <functional>
+#include <vector>
+
 #include "lsst/afw/fits.h"
 #include "lsst/afw/table/Schema.h"
 #include "lsst/afw/table/io/InputArchive.h"
@@ -53,6 +56,39 @@ public:
     virtual void readCell(BaseRecord &record, std::size_t row, fits::Fits &fits,
                           std::shared_ptr<InputArchive> const &archive) const = 0;
 
+    /**
+     *  A function that fills records from the raw bytes of the corresponding rows.
+     *
+     *  Called as decoder(records, nRows, rows, rowWidth), it should set its fields of records[i]
+     *  from the bytes starting at rows + i*rowWidth, for i in [0, nRows), as read by
+     *  fits::Fits::readTableBytes.  Decoders for different readers may be called at the same time
+     *  on the same records, and one decoder on different records, so a decoder may set only its
+     *  own fields and must not modify shared state.
+     */
+    using Decoder = std::function<void(BaseRecord *const *records, std::size_t nRows,
+                                       unsigned char const *rows, std::size_t rowWidth)>;
+
+    /**
+     *  Optionally return a Decoder that reads this reader's values from raw row bytes.
+     *
+     *  Readers that return an empty function (the default) are read through prepRead and readCell.
+     *
+     *  @param[in] layout   How the columns of the table are stored.
+     */
+    virtual Decoder makeDecoder(fits::TableLayout const &layout) const { return Decoder(); }
+
+    /**
+     *  Return true if this reader's Decoder may decode rows in place.
+     *
+     *  That is the case if each value it writes to a record occupies the same bytes, relative to the
+     *  start of the record, as the stored value it is decoded from does relative to the start of the
+     *  row, so records that view the rows themselves (see FitsSchemaInputMapper::MAP_ROWS) can be
+     *  filled without copying.  The default returns false.
+     *
+     *  @param[in] layout   How the columns of the table are stored.
+     */
+    virtual bool decodesInPlace(fits::TableLayout const &layout) const { return false; }
+
     virtual ~FitsColumnReader() noexcept = default;
 };
 
@@ -85,8 +121,8 @@ struct FitsSchemaItem {
  *  "regular" fields via the erase() method.  Those regular fields are filled in by the finalize()
  *  method, which automatically generates mappings for any FitsSchemaItems that have not been
  *  removed by calls to erase().  Once finalize() has been called, readRecord() may be called
- *  repeatedly to read FITS rows into record objects according to the mapping that has been
- *  defined.
+ *  repeatedly (or readRecords() once for many rows) to read FITS rows into record objects according
+ *  to the mapping that has been defined.
  */
 class FitsSchemaInputMapper {
 public:
@@ -106,6 +142,27 @@ public:
      */
     static std::size_t PREPPED_ROWS_FACTOR;
 
+    /**
+     *  The number of bytes of rows that readRecords() reads from the file
+     *  at once.
+     *
+     *  Columns whose readers provide a FitsColumnReader::Decoder are then
+     *  filled from these bytes, without further calls to CFITSIO.
+     */
+    static std::size_t READ_CHUNK_BYTES;
+
+    /**
+     *  The number of threads readRecords() uses to decode each chunk of
+     *  rows; 0 means one per hardware thread.
+     */
+    static int READ_THREADS;
+
+    /**
+     *  Whether FitsReader maps the rows of uncompressed tables in plain FITS files on disk into memory
+     *  (see mapRecords()) instead of reading them; false by default.
+     */
+    static bool MAP_ROWS;
+
     /// Construct a mapper from a PropertyList of FITS header values, stripping recognized keys if desired.
     FitsSchemaInputMapper(daf::base::PropertyList &metadata, bool stripMetadata);
 
@@ -130,6 +187,9 @@ public:
     /// Return true if the mapper has an InputArchive.
     bool hasArchive() const;
 
+    /// Return the mapper's InputArchive, or null if it has none.
+    std::shared_ptr<InputArchive> getArchive() const;
+
     /**
      *  Find an item with the given column name (ttype), returning nullptr if no such column exists.
      *
@@ -169,6 +229,26 @@ public:
      */
     void customize(std::unique_ptr<FitsColumnReader> reader);
 
+    /**
+     *  Restrict the regular fields added by finalize() to the columns with the given names.
+     *
+     *  Columns that are not selected are neither read nor allocated.  Names are FITS column names
+     *  (which are the field names of tables written by current versions), or aliases to them; Flag
+     *  fields may be selected individually.  Further calls add to the selection, and an empty list
+     *  leaves it unchanged.  Columns read by custom readers (see customize()) are not affected.
+     *
+     *  @throws lsst::pex::exceptions::NotFoundError if a name does not match any column.
+     */
+    void select(std::vector<std::string> const &names);
+
+    /**
+     *  Add the fields of the given Schema that have a matching column to any selection made by select().
+     *
+     *  Table readers call this with their minimal Schema before finalize(), so projected catalogs can
+     *  still be used with their table classes.  It does nothing if no columns have been selected.
+     */
+    void require(Schema const &schema);
+
     /**
      *  Map any remaining items into regular Schema items, and return the final Schema.
      *
@@ -181,6 +261,48 @@ public:
      */
     void readRecord(BaseRecord &record, afw::fits::Fits &fits, std::size_t row);
 
+    /**
+     *  Fill records from consecutive FITS binary table rows.
+     *
+     *  This has the same result as calling readRecord() for each row, but
+     *  reads the rows READ_CHUNK_BYTES at a time, and fills the flags and
+     *  the columns of readers that provide a FitsColumnReader::Decoder from
+     *  those bytes a block of rows and a column at a time, on READ_THREADS
+     *  threads; only the remaining columns are read a row at a time.
+     *
+     *  @param[in,out] records   Records to fill; records[i] is filled from row firstRow + i.
+     *  @param[in]     fits      FITS file manager object.
+     *  @param[in]     firstRow  Index of the row to fill the first record from.
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if READ_THREADS < 0.
+     */
+    void readRecords(std::vector<BaseRecord *> const &records, afw::fits::Fits &fits,
+                     std::size_t firstRow = 0);
+
+    /**
+     *  Make records that view consecutive FITS binary table rows mapped into memory, if possible.
+     *
+     *  This requires a table whose rows are stored exactly as the records of the given table, aside
+     *  from byte order: each row must be as wide as a record, and every field must be read by a
+     *  FitsColumnReader that decodes in place (see FitsColumnReader::decodesInPlace), so there can be
+     *  no Flag or variable-length fields.  The rows are then mapped privately with
+     *  afw::fits::Fits::mapTableBytes, decoded in place on READ_THREADS threads, and adopted by the
+     *  table as contiguous records (see BaseTable::adoptRecordData), without reading the file through
+     *  CFITSIO.  If the table or file does not allow this, nothing is read or made.
+     *
+     *  @param[in,out] table     Table whose Schema is that returned by finalize() (perhaps padded) to
+     *                           make the records with.
+     *  @param[in]     fits      FITS file manager object.
+     *  @param[in]     firstRow  Index of the row the first record views.
+     *  @param[in]     nRows     Number of rows to map; must be positive.
+     *
+     *  @return The new records, or an empty vector if the rows could not be mapped.
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if READ_THREADS < 0.
+     */
+    std::vector<std::shared_ptr<BaseRecord>> mapRecords(BaseTable &table, afw::fits::Fits &fits,
+                                                        std::size_t firstRow, std::size_t nRows);
+
 private:
     class Impl;
     std::shared_ptr<Impl> _impl;
@@ -2,7 +2,9 @@
 #ifndef AFW_TABLE_IO_FitsWriter_h_INCLUDED
 #define AFW_TABLE_IO_FitsWriter_h_INCLUDED
 
+#include <memory>
 #include <set>
+#include <vector>
 
 #include "lsst/base.h"
 #include "lsst/pex/exceptions.h"
@@ -26,6 +28,18 @@ class FitsWriter {
 public:
     using Fits = afw::fits::Fits;
 
+    /**
+     *  The number of bytes of rows that are encoded in memory and written to
+     *  the file at once, for writers whose records are written unchanged.
+     */
+    static std::size_t WRITE_CHUNK_BYTES;
+
+    /**
+     *  The number of threads used to encode each chunk of rows; 0 means one
+     *  per hardware thread.
+     */
+    static int WRITE_THREADS;
+
     /**
      *  Driver for writing FITS files.
      *
@@ -67,9 +81,37 @@ public:
                                   "Cannot save Catalog with heterogenous schemas");
             }
         }
-        _writeTable(container.getTable(), container.size());
-        for (typename ContainerT::const_iterator i = container.begin(); i != container.end(); ++i) {
-            _writeRecord(*i);
+        // A table to be compressed (see Fits::setTableCompression) is written to memory first, and
+        // compressed from there into the file; anything written by _finish goes to the file itself.
+        Fits* const output = _fits;
+        auto const compression = output->getTableCompression();
+        afw::fits::MemFileManager scratchManager;
+        std::unique_ptr<Fits> scratch;
+        if (compression.algorithm != afw::fits::ImageCompressionOptions::NONE) {
+            scratch = std::make_unique<Fits>(scratchManager, "w", Fits::AUTO_CLOSE | Fits::AUTO_CHECK);
+            _fits = scratch.get();
+        }
+        try {
+            _writeTable(container.getTable(), container.size());
+            if (_writesRecordsUnchanged()) {
+                std::vector<BaseRecord const*> records;
+                records.reserve(container.size());
+                for (typename ContainerT::const_iterator i = container.begin(); i != container.end(); ++i) {
+                    records.push_back(&*i);
+                }
+                _writeRecords(records);
+            } else {
+                for (typename ContainerT::const_iterator i = container.begin(); i != container.end(); ++i) {
+                    _writeRecord(*i);
+                }
+            }
+        } catch (...) {
+            _fits = output;
+            throw;
+        }
+        _fits = output;
+        if (scratch) {
+            _fits->writeCompressedTable(*scratch, compression);
         }
         _finish();
     }
@@ -93,6 +135,18 @@ protected:
     /// Finish writing a catalog.
     virtual void _finish() {}
 
+    /**
+     *  Return true if _writeRecord writes each record as it is given.
+     *
+     *  Catalogs are then written WRITE_CHUNK_BYTES of rows at a time: the flags and fixed-size
+     *  numeric fields are encoded directly into the rows' bytes, on WRITE_THREADS threads, and
+     *  only strings and variable-length arrays are written a record at a time; _writeRecord is
+     *  not called.  The default is true only for FitsWriter itself, as subclasses that override
+     *  _writeRecord usually modify or add to the records; subclasses that do not may override
+     *  this to return true.
+     */
+    virtual bool _writesRecordsUnchanged() const;
+
     Fits* _fits;       // wrapped cfitsio pointer
     int _flags;        // subclass-defined flags to control writing
     std::size_t _row;  // which row we're currently processing
@@ -100,6 +154,9 @@ protected:
 private:
     struct ProcessRecords;
 
+    // Write all the records of a catalog whose records are written unchanged.
+    void _writeRecords(std::vector<BaseRecord const*> const& records);
+
     std::shared_ptr<ProcessRecords> _processor;  // a private Schema::forEach functor that write records
 };
 }  // namespace io
@@ -2,6 +2,7 @@
 #ifndef AFW_TABLE_IO_InputArchive_h_INCLUDED
 #define AFW_TABLE_IO_InputArchive_h_INCLUDED
 
+#include <cstdint>
 #include <map>
 
 #include "lsst/base.h"
@@ -52,6 +53,7 @@ public:
      *  Load the Persistable with the given ID and return it.
      *
      *  If the object has already been loaded once, the same instance will be returned again.
+     *  Objects may be loaded from several threads at once.
      */
     std::shared_ptr<Persistable> get(int id) const;
 
@@ -66,6 +68,20 @@ public:
     /// Load and return all objects in the archive.
     Map const& getAll() const;
 
+    /**
+     *  Load and return all objects in the archive, reading independent objects concurrently.
+     *
+     *  All data catalogs are read first.  Objects whose factories are not thread-safe (see
+     *  PersistableFactory::isThreadSafe) are then loaded in the calling thread, and the rest are spread
+     *  over up to `numThreads` threads; an object referred to by several others is still loaded only
+     *  once, and get returns the same instance for it afterwards.
+     *
+     *  @param[in]  numThreads   Maximum number of threads to use; 0 means as many as allowed.
+     *
+     *  @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0.
+     */
+    Map const& getAll(int numThreads) const;
+
     /**
      *  Read an object from an already open FITS object.
      *
@@ -73,6 +89,29 @@ public:
      */
     static InputArchive readFits(fits::Fits& fitsfile);
 
+    /**
+     *  Read an archive's index from an already open FITS object, deferring its data catalogs.
+     *
+     *  Data catalogs are read only when an object that needs them is first loaded, so loading one
+     *  object from a large archive (e.g. a Wcs alongside a CoaddPsf) reads only that object's HDUs.
+     *  The file is opened again read-only when a data catalog is first needed, so the archive does
+     *  not depend on `fitsfile` staying open, but the file must not change while the archive is in
+     *  use.  If the file is not on disk (e.g. it is in memory), this is equivalent to readFits.
+     *
+     *  @param[in]  fitsfile     FITS object to read from, already positioned at the archive index HDU.
+     */
+    static InputArchive readFitsLazy(fits::Fits& fitsfile);
+
+    /**
+     *  Read an archive written by OutputArchive::writeBinary.
+     *
+     *  @param[in]  data     Start of the buffer.
+     *  @param[in]  size     Size of the buffer in bytes.
+     *
+     *  @throws lsst::afw::table::io::MalformedArchiveError if the buffer is not a binary archive.
+     */
+    static InputArchive readBinary(std::uint8_t const* data, std::size_t size);
+
 private:
     class Impl;
 
@@ -2,6 +2,9 @@
 #ifndef AFW_TABLE_IO_OutputArchive_h_INCLUDED
 #define AFW_TABLE_IO_OutputArchive_h_INCLUDED
 
+#include <cstdint>
+#include <vector>
+
 #include "lsst/base.h"
 #include "lsst/afw/table/io/Persistable.h"
 
@@ -82,6 +85,21 @@ public:
     int put(Persistable const & obj, bool permissive = false) { return put(&obj, permissive); }
     ///@}
 
+    /**
+     *  Set whether to save objects with identical contents only once.
+     *
+     *  When enabled, an object whose saved rows (and name) exactly equal those of an object already
+     *  in the archive is removed again after it is written, and put() returns the ID of the earlier
+     *  object, even if the two are distinct C++ objects.  Because nested objects are deduplicated
+     *  first, this also catches containers of equal objects.  Reading the archive then yields one
+     *  shared instance for all of them, so this should only be enabled for archives of objects
+     *  that are not modified after they are read.  Disabled by default.
+     */
+    void setDeduplicate(bool deduplicate);
+
+    /// Return whether objects with identical contents are saved only once; see setDeduplicate.
+    bool getDeduplicate() const noexcept;
+
     /**
      *  @brief Return the index catalog that specifies where objects are stored in the
      *         data catalogs.
@@ -103,6 +121,16 @@ public:
      */
     void writeFits(fits::Fits& fitsfile) const;
 
+    /**
+     *  Return the archive in a compact binary format that can be read by InputArchive::readBinary.
+     *
+     *  The catalogs are written as flat little-endian buffers, with none of the FITS headers,
+     *  padding or column descriptions; this is much faster than writing to an in-memory FITS file,
+     *  and is intended for transient uses like pickling.  Catalog metadata is not saved, and the
+     *  format is only guaranteed to be readable by the same version of afw.
+     */
+    std::vector<std::uint8_t> writeBinary() const;
+
 private:
     class Impl;
 
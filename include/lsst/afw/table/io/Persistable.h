@@ -3,6 +3,9 @@
 #define AFW_TABLE_IO_Persistable_h_INCLUDED
 
 #include <climits>
+#include <cstdint>
+#include <vector>
+
 #include "lsst/base.h"
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/fitsDefaults.h"
@@ -98,6 +101,14 @@ public:
      */
     void writeFits(fits::Fits& fitsfile) const;
 
+    /**
+     *  Return the object in the compact binary format of OutputArchive::writeBinary.
+     *
+     *  This is much faster than writing to a FITS file in memory, and is intended for transient
+     *  uses like pickling; use PersistableFacade::readBinary to read it back.
+     */
+    std::vector<std::uint8_t> writeBinary() const;
+
     /// Return true if this particular object can be persisted using afw::table::io.
     virtual bool isPersistable() const noexcept { return false; }
 
@@ -153,6 +164,8 @@ private:
     static std::shared_ptr<Persistable> _readFits(fits::MemFileManager& manager, int hdu = fits::DEFAULT_HDU);
 
     static std::shared_ptr<Persistable> _readFits(fits::Fits& fitsfile);
+
+    static std::shared_ptr<Persistable> _readBinary(std::uint8_t const* data, std::size_t size);
 };
 
 /**
@@ -206,6 +219,16 @@ public:
         return dynamicCast(Persistable::_readFits(manager, hdu));
     }
 
+    /**
+     *  Read an object from a buffer written by Persistable::writeBinary.
+     *
+     *  @param[in] data      Start of the buffer.
+     *  @param[in] size      Size of the buffer in bytes.
+     */
+    static std::shared_ptr<T> readBinary(std::uint8_t const* data, std::size_t size) {
+        return dynamicCast(Persistable::_readBinary(data, size));
+    }
+
     /**
      * Dynamically cast a shared_ptr
      *
@@ -248,6 +271,15 @@ public:
     virtual std::shared_ptr<Persistable> read(InputArchive const& archive,
                                               CatalogVector const& catalogs) const = 0;
 
+    /**
+     *  Return true if read may be called from several threads at once (the default).
+     *
+     *  InputArchive::getAll(int) loads the objects of factories that return false in the calling thread,
+     *  before it loads the others concurrently; factories that call Python or modify shared state
+     *  without synchronization must override this to return false.
+     */
+    virtual bool isThreadSafe() const { return true; }
+
     /**
      *  Return the factory that has been registered with the given name.
      *
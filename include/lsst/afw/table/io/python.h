@@ -26,8 +26,10 @@
 
 #include "pybind11/pybind11.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "lsst/afw/fits.h"
 #include "lsst/afw/table/io/Persistable.h"
@@ -66,6 +68,18 @@ void addPersistableMethods(pybind11::class_<Class, Args...> &cls) {
     cls.def("writeFits",
             (void (Class::*)(fits::MemFileManager &, std::string const &) const) & Class::writeFits,
             "manager"_a, "mode"_a = "w");
+    cls.def_static(
+            "readBinary",
+            [](py::buffer data) -> std::shared_ptr<Class> {
+                py::buffer_info info = data.request();
+                return PersistableFacade<Class>::readBinary(static_cast<std::uint8_t const *>(info.ptr),
+                                                            info.size * info.itemsize);
+            },
+            "data"_a);
+    cls.def("writeBinary", [](Class const &self) {
+        std::vector<std::uint8_t> buffer = self.writeBinary();
+        return py::bytes(reinterpret_cast<char const *>(buffer.data()), buffer.size());
+    });
     cls.def("isPersistable", &Class::isPersistable);
 }
 }  // namespace python
@@ -23,12 +23,16 @@
 #ifndef AFW_TABLE_PYTHON_CATALOG_H_INCLUDED
 #define AFW_TABLE_PYTHON_CATALOG_H_INCLUDED
 
+#include <optional>
+
 #include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
 
 #include "ndarray/pybind11.h"
 #include "lsst/cpputils/python.h"
 #include "lsst/afw/table/BaseColumnView.h"
 #include "lsst/afw/table/Catalog.h"
+#include "lsst/afw/table/HashIndex.h"
 
 namespace lsst {
 namespace afw {
@@ -174,7 +178,7 @@ void declareCatalogOverloads(PyCatalog<Record> &cls) {
     using ColumnView = typename Record::ColumnView;
 
     cls.def("isSorted", (bool (Catalog::*)(Key<T> const &) const) & Catalog::isSorted);
-    cls.def("sort", (void (Catalog::*)(Key<T> const &)) & Catalog::sort);
+    cls.def("sort", (void (Catalog::*)(Key<T> const &, int)) & Catalog::sort, "key"_a, "numThreads"_a = 1);
     cls.def("find", [](Catalog &self, Value const &value, Key<T> const &key) -> std::shared_ptr<Record> {
         auto iter = self.find(value, key);
         if (iter == self.end()) {
@@ -259,6 +263,42 @@ void declareCatalogArrayOverloads(PyCatalog<Record> &cls) {
             });
 }
 
+/**
+ * Wrap an instantiation of lsst::afw::table::HashIndex<Record, T>, and declare the catalog method
+ * that makes one.
+ *
+ * @tparam T  Field type.
+ * @tparam Record  Record type, e.g. BaseRecord or SimpleRecord.
+ *
+ * @param[in] wrappers Package manager class will be added to.
+ * @param[in] name   Name prefix of the record type, e.g. "Base" or "Simple".
+ * @param[in] suffix Suffix for the field type, e.g. "I" or "String".
+ */
+template <typename T, typename Record>
+void declareHashIndex(cpputils::python::WrapperCollection &wrappers, std::string const &name,
+                      std::string const &suffix) {
+    namespace py = pybind11;
+    using namespace pybind11::literals;
+
+    using Index = HashIndex<Record, T>;
+
+    wrappers.wrapType(py::class_<Index>(wrappers.module, (name + "HashIndex" + suffix).c_str()),
+                      [](auto &mod, auto &cls) {
+                          cls.def(py::init<CatalogT<Record> const &, Key<T> const &>(), "catalog"_a, "key"_a);
+                          cls.def("getKey", &Index::getKey);
+                          cls.def_property_readonly("key", &Index::getKey);
+                          cls.def("__len__", &Index::size);
+                          cls.def("isValid", &Index::isValid);
+                          cls.def("invalidate", &Index::invalidate);
+                          cls.def("rebuild", &Index::rebuild, "catalog"_a);
+                          cls.def("contains", &Index::contains, "value"_a);
+                          cls.def("__contains__", &Index::contains);
+                          cls.def("find", &Index::find, "value"_a);
+                          cls.def("findAll", &Index::findAll, "values"_a);
+                          cls.def("getIndices", &Index::getIndices, "values"_a);
+                      });
+}
+
 /**
  * Wrap an instantiation of lsst::afw::table::CatalogT<Record>.
  *
@@ -289,6 +329,10 @@ PyCatalog<Record> declareCatalog(cpputils::python::WrapperCollection &wrappers,
         fullName = name + "Catalog";
     }
 
+    declareHashIndex<std::int32_t, Record>(wrappers, name, "I");
+    declareHashIndex<std::int64_t, Record>(wrappers, name, "L");
+    declareHashIndex<std::string, Record>(wrappers, name, "String");
+
     // We need py::dynamic_attr() in the class definition to support our Python-side caching
     // of the associated ColumnView.
     return wrappers.wrapType(
@@ -304,7 +348,40 @@ PyCatalog<Record> declareCatalog(cpputils::python::WrapperCollection &wrappers,
                                "filename"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
                 cls.def_static("readFits", (Catalog(*)(fits::MemFileManager &, int, int)) & Catalog::readFits,
                                "manager"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
+                cls.def_static(
+                        "readFits",
+                        [](std::string const &filename, int hdu, int flags,
+                           std::vector<std::string> const &columns,
+                           std::optional<io::FitsRowFilter> const &rows) {
+                            return Catalog::readFits(filename, hdu, flags, columns,
+                                                     rows ? *rows : io::FitsRowFilter());
+                        },
+                        "filename"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0,
+                        "columns"_a = std::vector<std::string>(), "rows"_a = py::none());
+                cls.def_static(
+                        "readFits",
+                        [](fits::MemFileManager &manager, int hdu, int flags,
+                           std::vector<std::string> const &columns,
+                           std::optional<io::FitsRowFilter> const &rows) {
+                            return Catalog::readFits(manager, hdu, flags, columns,
+                                                     rows ? *rows : io::FitsRowFilter());
+                        },
+                        "manager"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0,
+                        "columns"_a = std::vector<std::string>(), "rows"_a = py::none());
                 // readFits taking Fits objects not wrapped, because Fits objects are not wrapped.
+                cls.def_static(
+                        "concatenate",
+                        [](std::vector<Catalog> const &catalogs, int numThreads) {
+                            return Catalog::concatenate(catalogs, numThreads);
+                        },
+                        "catalogs"_a, "numThreads"_a = 1);
+                cls.def_static(
+                        "concatenate",
+                        [](std::shared_ptr<Table> const &table, SchemaMapper const &mapper,
+                           std::vector<Catalog> const &catalogs, int numThreads) {
+                            return Catalog::concatenate(table, mapper, catalogs, numThreads);
+                        },
+                        "table"_a, "mapper"_a, "catalogs"_a, "numThreads"_a = 1);
 
                 /* Methods */
                 cls.def("getTable", &Catalog::getTable);
@@ -322,8 +399,9 @@ PyCatalog<Record> declareCatalog(cpputils::python::WrapperCollection &wrappers,
                 cls.def("_extend", [](Catalog &self, Catalog const &other, bool deep) {
                     self.insert(self.end(), other.begin(), other.end(), deep);
                 });
-                cls.def("_extend", [](Catalog &self, Catalog const &other, SchemaMapper const &mapper) {
-                    self.insert(mapper, self.end(), other.begin(), other.end());
+                cls.def("_extend", [](Catalog &self, Catalog const &other, SchemaMapper const &mapper,
+                                      int numThreads) {
+                    self.insert(mapper, self.end(), other.begin(), other.end(), numThreads);
                 });
                 cls.def("_append",
                         [](Catalog &self, std::shared_ptr<Record> const &rec) { self.push_back(rec); });
@@ -387,6 +465,8 @@ PyCatalog<Record> declareCatalog(cpputils::python::WrapperCollection &wrappers,
                         (void (Catalog::*)(fits::MemFileManager &, std::string const &, int) const) &
                                 Catalog::writeFits,
                         "manager"_a, "mode"_a = "w", "flags"_a = 0);
+                cls.def("writeFits", (void (Catalog::*)(fits::Fits &, int) const) & Catalog::writeFits,
+                        "fitsfile"_a, "flags"_a = 0);
                 cls.def("reserve", &Catalog::reserve);
                 cls.def("subset",
                         (Catalog(Catalog::*)(ndarray::Array<bool const, 1> const &) const) & Catalog::subset);
@@ -404,6 +484,17 @@ PyCatalog<Record> declareCatalog(cpputils::python::WrapperCollection &wrappers,
                 declareCatalogArrayOverloads<int>(cls);
                 declareCatalogArrayOverloads<float>(cls);
                 declareCatalogArrayOverloads<double>(cls);
+                cls.def("sort", (void (Catalog::*)(std::vector<SortKey> const &, int)) & Catalog::sort,
+                        "keys"_a, "numThreads"_a = 1);
+                cls.def("makeHashIndex", [](Catalog const &self, Key<std::int32_t> const &key) {
+                    return HashIndex<Record, std::int32_t>(self, key);
+                }, "key"_a);
+                cls.def("makeHashIndex", [](Catalog const &self, Key<std::int64_t> const &key) {
+                    return HashIndex<Record, std::int64_t>(self, key);
+                }, "key"_a);
+                cls.def("makeHashIndex", [](Catalog const &self, Key<std::string> const &key) {
+                    return HashIndex<Record, std::string>(self, key);
+                }, "key"_a);
 
                 cls.def("_get_column_from_key",
                         [](Catalog const &self, Key<Flag> const &key, pybind11::object py_column_view) {
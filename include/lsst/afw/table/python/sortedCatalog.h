@@ -87,7 +87,40 @@ PySortedCatalog<Record> declareSortedCatalog(cpputils::python::WrapperCollection
                                "filename"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
                 cls.def_static("readFits", (Catalog(*)(fits::MemFileManager &, int, int)) & Catalog::readFits,
                                "manager"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
+                cls.def_static(
+                        "readFits",
+                        [](std::string const &filename, int hdu, int flags,
+                           std::vector<std::string> const &columns,
+                           std::optional<io::FitsRowFilter> const &rows) {
+                            return Catalog::readFits(filename, hdu, flags, columns,
+                                                     rows ? *rows : io::FitsRowFilter());
+                        },
+                        "filename"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0,
+                        "columns"_a = std::vector<std::string>(), "rows"_a = py::none());
+                cls.def_static(
+                        "readFits",
+                        [](fits::MemFileManager &manager, int hdu, int flags,
+                           std::vector<std::string> const &columns,
+                           std::optional<io::FitsRowFilter> const &rows) {
+                            return Catalog::readFits(manager, hdu, flags, columns,
+                                                     rows ? *rows : io::FitsRowFilter());
+                        },
+                        "manager"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0,
+                        "columns"_a = std::vector<std::string>(), "rows"_a = py::none());
                 // readFits taking Fits objects not wrapped, because Fits objects are not wrapped.
+                cls.def_static(
+                        "concatenate",
+                        [](std::vector<Catalog> const &catalogs, int numThreads) {
+                            return Catalog::concatenate(catalogs, numThreads);
+                        },
+                        "catalogs"_a, "numThreads"_a = 1);
+                cls.def_static(
+                        "concatenate",
+                        [](std::shared_ptr<Table> const &table, SchemaMapper const &mapper,
+                           std::vector<Catalog> const &catalogs, int numThreads) {
+                            return Catalog::concatenate(table, mapper, catalogs, numThreads);
+                        },
+                        "table"_a, "mapper"_a, "catalogs"_a, "numThreads"_a = 1);
 
                 cls.def("subset",
                         (Catalog(Catalog::*)(ndarray::Array<bool const, 1> const &) const) & Catalog::subset);
@@ -108,13 +141,13 @@ PySortedCatalog<Record> declareSortedCatalog(cpputils::python::WrapperCollection
                         },
                         "key"_a = py::none());
                 cls.def("sort",
-                        [clsBase](py::object const &self, py::object key) -> py::object {
+                        [clsBase](py::object const &self, py::object key, int numThreads) -> py::object {
                             if (key.is(py::none())) {
                                 key = self.attr("table").attr("getIdKey")();
                             }
-                            return clsBase.attr("sort")(self, key);
+                            return clsBase.attr("sort")(self, key, numThreads);
                         },
-                        "key"_a = py::none());
+                        "key"_a = py::none(), "numThreads"_a = 1);
                 cls.def("find",
                         [clsBase](py::object const &self, py::object const &value,
                                   py::object key) -> py::object {
@@ -25,11 +25,11 @@
 #ifndef LSST_AFW_TYPEHANDLING_SIMPLEGENERICMAP_H
 #define LSST_AFW_TYPEHANDLING_SIMPLEGENERICMAP_H
 
-#include <exception>
+#include <algorithm>
 #include <sstream>
-#include <unordered_map>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "lsst/afw/typehandling/GenericMap.h"
 
@@ -43,7 +43,12 @@ namespace typehandling {
  * In Python, a SimpleGenericMap behaves like a `dict`. In particular, it will
  * iterate over keys in the order they were added.
  *
- * @tparam K the key type of the map. Must be hashable.
+ * The map is stored as a flat vector sorted by key, since maps of this kind
+ * rarely have more than a few dozen entries: a copy costs two allocations
+ * rather than one per entry, and lookups are binary searches over contiguous
+ * memory.
+ *
+ * @tparam K the key type of the map. Must be less-than comparable.
  */
 template <typename K>
 class SimpleGenericMap final : public MutableGenericMap<K> {
@@ -66,18 +71,19 @@ public:
     virtual ~SimpleGenericMap() noexcept = default;
 
     SimpleGenericMap& operator=(SimpleGenericMap const& other) {
+        Storage newStorage = other._storage;
         std::vector<K> newKeys = other._keyView;
-        _storage = other._storage;
         // strong exception safety because no exceptions can occur past this point
         using std::swap;
+        swap(_storage, newStorage);
         swap(_keyView, newKeys);
         return *this;
     }
     SimpleGenericMap& operator=(SimpleGenericMap&&) noexcept = default;
     SimpleGenericMap& operator=(GenericMap<K> const& other) {
         std::vector<K> newKeys = other.keys();
-        // strong exception safety: unordered_map is nothrow move-assignable and
-        // vector is nothrow swappable, so no exceptions can occur after _convertStorage returns
+        // strong exception safety: vector is nothrow move-assignable and nothrow
+        // swappable, so no exceptions can occur after _convertStorage returns
         _storage = _convertStorage(other);
         using std::swap;
         swap(_keyView, newKeys);
@@ -92,7 +98,7 @@ public:
         return std::min(_storage.max_size(), _keyView.max_size());
     }
 
-    bool contains(K const& key) const override { return _storage.count(key) > 0; }
+    bool contains(K const& key) const override { return _find(key) != _storage.end(); }
 
     std::vector<K> const& keys() const noexcept override { return _keyView; }
 
@@ -103,57 +109,63 @@ public:
 
 protected:
     ConstValueReference unsafeLookup(K key) const override {
-        try {
-            return std::visit(
-                [](auto const & v) { return ConstValueReference(std::cref(v)); },
-                _storage.at(key)
-            );
-        } catch (std::out_of_range& e) {
+        auto const it = _find(key);
+        if (it == _storage.end()) {
             std::stringstream message;
             message << "Key not found: " << key;
-            std::throw_with_nested(LSST_EXCEPT(pex::exceptions::OutOfRangeError, message.str()));
+            throw LSST_EXCEPT(pex::exceptions::OutOfRangeError, message.str());
         }
+        return std::visit([](auto const& v) { return ConstValueReference(std::cref(v)); }, it->second);
     }
 
     bool unsafeInsert(K key, StorableType&& value) override {
-        std::vector<K> newKeys = _keyView;
-        newKeys.emplace_back(key);
-        bool inserted = _storage.emplace(key, std::move(value)).second;
-        // strong exception safety because no exceptions can occur past this point
-        if (inserted) {
-            // _storage did not previously include key, so the key appended to newKeys is unique
-            using std::swap;
-            swap(_keyView, newKeys);
+        auto const it = _lowerBound(key);
+        if (it != _storage.end() && it->first == key) {
+            return false;
         }
-        return inserted;
+        // Do everything that can throw before changing _storage, so that after it is changed
+        // the new key can be appended to _keyView without reallocating
+        _keyView.reserve(_keyView.size() + 1);
+        K newKey = key;
+        _storage.emplace(it, std::move(key), std::move(value));
+        // strong exception safety because no exceptions can occur past this point
+        _keyView.push_back(std::move(newKey));
+        return true;
     }
 
     bool unsafeErase(K key) override {
-        std::vector<K> newKeys = _keyView;
-        for (auto it = newKeys.cbegin(); it != newKeys.cend();) {
-            if (*it == key) {
-                it = newKeys.erase(it);
-            } else {
-                ++it;
-            }
+        auto const it = _find(key);
+        if (it == _storage.end()) {
+            return false;
         }
         // strong exception safety because no exceptions can occur past this point
-        bool erased = _storage.erase(key) > 0;
-        if (erased) {
-            using std::swap;
-            swap(_keyView, newKeys);
-        }
-        return erased;
+        _keyView.erase(std::find(_keyView.begin(), _keyView.end(), key));
+        _storage.erase(it);
+        return true;
     }
 
 private:
     // StorableType is a value, so we might as well use it in the implementation
-    std::unordered_map<K, StorableType> _storage;
+    using Storage = std::vector<std::pair<K, StorableType>>;
+
+    Storage _storage;
     std::vector<K> _keyView;
-    // Class invariant: the elements of _keyView are unique
+    // Class invariant: the keys of _storage are unique and sorted in increasing order
     // Class invariant: the elements of _keyView and the keys of _storage are the same
     // Class invariant: the elements of _keyView are arranged in insertion order, oldest to newest
 
+    // Return the first element of _storage whose key is not less than key
+    typename Storage::const_iterator _lowerBound(K const& key) const {
+        return std::lower_bound(_storage.begin(), _storage.end(), key,
+                                [](auto const& element, K const& k) { return element.first < k; });
+    }
+
+    // Return the element of _storage with the given key, or _storage.end()
+    typename Storage::const_iterator _find(K const& key) const {
+        auto const it = _lowerBound(key);
+        return (it != _storage.end() && it->first == key) ? it : _storage.end();
+    }
+
     /**
      * Create a new back-end map that contains the same mappings as a GenericMap.
      *
@@ -162,9 +174,12 @@ private:
      *
      * @exceptsafe Provides strong exception-safety.
      */
-    static std::unordered_map<K, StorableType> _convertStorage(GenericMap<K> const& map) {
-        std::unordered_map<K, StorableType> newStorage;
-        map.apply([&newStorage](K const& key, auto const& value) { newStorage.emplace(key, value); });
+    static Storage _convertStorage(GenericMap<K> const& map) {
+        Storage newStorage;
+        newStorage.reserve(map.size());
+        map.apply([&newStorage](K const& key, auto const& value) { newStorage.emplace_back(key, value); });
+        std::sort(newStorage.begin(), newStorage.end(),
+                  [](auto const& a, auto const& b) { return a.first < b.first; });
         return newStorage;
     }
 };
@@ -181,6 +181,9 @@ public:
         return pyobj.cast<std::shared_ptr<Storable>>();
     }
 
+    // Reading needs the GIL, which a thread that is waiting for a parallel load may hold
+    bool isThreadSafe() const override { return false; }
+
 private:
     std::string _module;
     std::string _name;
@@ -0,0 +1,77 @@
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "pybind11/pybind11.h"
+#include <lsst/cpputils/python.h>
+
+#include "pybind11/stl.h"
+#include "ndarray/pybind11.h"
+
+#include "lsst/afw/cameraGeom/AmplifierCorrections.h"
+
+namespace py = pybind11;
+using namespace py::literals;
+
+namespace lsst {
+namespace afw {
+namespace cameraGeom {
+namespace {
+
+template <typename PixelT>
+void declareMeasureOverscan(lsst::cpputils::python::WrapperCollection &wrappers) {
+    wrappers.wrap([](auto &mod) {
+        mod.def("measureOverscanLevels", &measureOverscanLevels<PixelT>, "detector"_a, "rawImage"_a,
+                "statistic"_a = math::MEDIAN, "numThreads"_a = 1, py::call_guard<py::gil_scoped_release>());
+        mod.def("measureOverscanRows", &measureOverscanRows<PixelT>, "detector"_a, "rawImage"_a,
+                "statistic"_a = math::MEDIAN, "numThreads"_a = 1, py::call_guard<py::gil_scoped_release>());
+    });
+}
+
+template <typename PixelT>
+void declareCorrectAmplifiers(lsst::cpputils::python::WrapperCollection &wrappers) {
+    wrappers.wrap([](auto &mod) {
+        mod.def("correctAmplifiers", &correctAmplifiers<PixelT>, "rawImage"_a, "detector"_a,
+                "offsets"_a = std::vector<ndarray::Array<double const, 1, 1>>(), "doLinearity"_a = true,
+                "doGain"_a = true, "numThreads"_a = 1, py::call_guard<py::gil_scoped_release>());
+    });
+}
+
+}  // namespace
+
+void wrapAmplifierCorrections(lsst::cpputils::python::WrapperCollection &wrappers) {
+    wrappers.addSignatureDependency("lsst.afw.image");
+    wrappers.addSignatureDependency("lsst.afw.math");
+    declareMeasureOverscan<std::uint16_t>(wrappers);
+    declareMeasureOverscan<int>(wrappers);
+    declareMeasureOverscan<float>(wrappers);
+    declareMeasureOverscan<double>(wrappers);
+    declareCorrectAmplifiers<float>(wrappers);
+    declareCorrectAmplifiers<double>(wrappers);
+}
+
+}  // namespace cameraGeom
+}  // namespace afw
+}  // namespace lsst
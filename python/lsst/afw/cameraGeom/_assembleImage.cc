@@ -0,0 +1,81 @@
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "pybind11/pybind11.h"
+#include <lsst/cpputils/python.h>
+
+#include "pybind11/stl.h"
+
+#include "lsst/afw/image/Image.h"
+#include "lsst/afw/image/MaskedImage.h"
+#include "lsst/afw/cameraGeom/AssembleImage.h"
+
+namespace py = pybind11;
+using namespace py::literals;
+
+namespace lsst {
+namespace afw {
+namespace cameraGeom {
+namespace {
+
+template <typename ImageT>
+void declareAssembleDetectorImage(lsst::cpputils::python::WrapperCollection &wrappers) {
+    wrappers.wrap([](auto &mod) {
+        std::shared_ptr<ImageT> (*assembleOne)(Detector const &, ImageT const &, bool, int) =
+                &assembleDetectorImage<ImageT>;
+        mod.def("assembleDetectorImage", assembleOne, "detector"_a, "rawImage"_a, "isTrimmed"_a = true,
+                "numThreads"_a = 1, py::call_guard<py::gil_scoped_release>());
+        mod.def(
+                "assembleDetectorImage",
+                [](Detector const &detector, std::vector<std::shared_ptr<ImageT>> const &rawImages,
+                   bool isTrimmed, int numThreads) {
+                    std::vector<std::shared_ptr<ImageT const>> constImages(rawImages.begin(),
+                                                                           rawImages.end());
+                    py::gil_scoped_release release;
+                    return assembleDetectorImage(detector, constImages, isTrimmed, numThreads);
+                },
+                "detector"_a, "rawImages"_a, "isTrimmed"_a = true, "numThreads"_a = 1);
+    });
+}
+
+}  // namespace
+
+void wrapAssembleImage(lsst::cpputils::python::WrapperCollection &wrappers) {
+    wrappers.addSignatureDependency("lsst.afw.image");
+    declareAssembleDetectorImage<image::Image<std::uint16_t>>(wrappers);
+    declareAssembleDetectorImage<image::Image<int>>(wrappers);
+    declareAssembleDetectorImage<image::Image<float>>(wrappers);
+    declareAssembleDetectorImage<image::Image<double>>(wrappers);
+    declareAssembleDetectorImage<image::MaskedImage<std::uint16_t>>(wrappers);
+    declareAssembleDetectorImage<image::MaskedImage<int>>(wrappers);
+    declareAssembleDetectorImage<image::MaskedImage<float>>(wrappers);
+    declareAssembleDetectorImage<image::MaskedImage<double>>(wrappers);
+}
+
+}  // namespace cameraGeom
+}  // namespace afw
+}  // namespace lsst
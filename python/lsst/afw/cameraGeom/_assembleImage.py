@@ -65,6 +65,11 @@ def assembleAmplifierImage(destImage, rawImage, amplifier):
     ------
     RuntimeError
         Raised if image types do not match or amplifier has no raw amplifier info.
+
+    Notes
+    -----
+    `assembleDetectorImage` assembles all the amplifiers of a detector at
+    once, and is much faster than calling this function for each one.
     """
     if type(destImage.Factory) != type(rawImage.Factory):  # noqa: E721
         raise RuntimeError(f"destImage type = {type(destImage.Factory).__name__} != "
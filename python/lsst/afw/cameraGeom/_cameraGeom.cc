@@ -28,6 +28,8 @@ namespace afw {
 namespace cameraGeom {
 
 void wrapAmplifier(lsst::cpputils::python::WrapperCollection &);
+void wrapAmplifierCorrections(lsst::cpputils::python::WrapperCollection &);
+void wrapAssembleImage(lsst::cpputils::python::WrapperCollection &);
 void wrapCamera(lsst::cpputils::python::WrapperCollection &);
 void wrapCameraSys(lsst::cpputils::python::WrapperCollection &);
 void wrapDetector(lsst::cpputils::python::WrapperCollection &);
@@ -44,6 +46,8 @@ PYBIND11_MODULE(_cameraGeom, mod) {
     wrapCameraSys(wrappers);
     wrapOrientation(wrappers);
     wrapTransformMap(wrappers);
+    wrapAssembleImage(wrappers);
+    wrapAmplifierCorrections(wrappers);
     wrappers.finish();
 }
 }  // namespace cameraGeom
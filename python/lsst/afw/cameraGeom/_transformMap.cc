@@ -73,8 +73,8 @@ void declareTransformMap(lsst::cpputils::python::WrapperCollection &wrappers) {
                 "point"_a, "fromSys"_a, "toSys"_a);
         cls.def("transform",
                 py::overload_cast<std::vector<lsst::geom::Point2D> const &, CameraSys const &,
-                                  CameraSys const &>(&TransformMap::transform, py::const_),
-                "pointList"_a, "fromSys"_a, "toSys"_a);
+                                  CameraSys const &, int>(&TransformMap::transform, py::const_),
+                "pointList"_a, "fromSys"_a, "toSys"_a, "numThreads"_a = 1);
         cls.def("getTransform", &TransformMap::getTransform, "fromSys"_a, "toSys"_a);
         cls.def("getConnections", &TransformMap::getConnections);
         table::io::python::addPersistableMethods(cls);
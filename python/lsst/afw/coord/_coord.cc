@@ -35,11 +35,13 @@ namespace coord {
 using cpputils::python::WrapperCollection;
 void wrapObservatory(WrapperCollection&);
 void wrapWeather(WrapperCollection&);
+void wrapRefraction(WrapperCollection&);
 
 PYBIND11_MODULE(_coord, mod) {
     WrapperCollection wrappers(mod, "lsst.afw.coord");
     wrapObservatory(wrappers);
     wrapWeather(wrappers);
+    wrapRefraction(wrappers);
     wrappers.finish();
 }
 
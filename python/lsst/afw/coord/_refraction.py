@@ -58,7 +58,8 @@ def refraction(wavelength, elevation, observatory, weather=None):
 
     Notes
     -----
-    The calculation is taken from [1]_.
+    The calculation is taken from [1]_.  `computeRefraction` computes the
+    refraction at an array of elevations in one call.
 
     References
     ----------
@@ -114,6 +115,11 @@ def differentialRefraction(wavelength, wavelengthRef, elevation, observatory, we
     -------
     differentialRefraction : `lsst.geom.Angle`
         The refraction at `wavelength` minus the refraction at `wavelengthRef`.
+
+    Notes
+    -----
+    `computeDifferentialRefraction` computes the differential refraction at
+    an array of elevations in one call.
     """
     refractionStart = refraction(wavelength, elevation, observatory, weather=weather)
     refractionEnd = refraction(wavelengthRef, elevation, observatory, weather=weather)
@@ -21,6 +21,7 @@
 
 from ._detection import *
 from ._footprintContinued import *
+from ._psfContinued import *
 from ._footprintMerge import *
 from ._peak import *
 from .multiband import *
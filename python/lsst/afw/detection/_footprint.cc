@@ -88,6 +88,9 @@ void wrapFootprint(WrapperCollection &wrappers) {
                 cls.def(py::init<std::shared_ptr<geom::SpanSet>, afw::table::Schema const &,
                                  lsst::geom::Box2I const &>(),
                         "inputSpans"_a, "peakSchema"_a, "region"_a = lsst::geom::Box2I());
+                cls.def(py::init<std::shared_ptr<geom::SpanSet>, std::shared_ptr<PeakTable> const &,
+                                 lsst::geom::Box2I const &>(),
+                        "inputSpans"_a, "peakTable"_a, "region"_a = lsst::geom::Box2I());
                 cls.def(py::init<Footprint const &>());
                 cls.def(py::init<>());
 
@@ -144,16 +147,19 @@ void wrapFootprint(WrapperCollection &wrappers) {
                 cls.def("isHeavy", &Footprint::isHeavy);
                 cls.def("assign", (Footprint & (Footprint::*)(Footprint const &)) & Footprint::operator=);
 
-                cls.def("split", [](Footprint const &self) -> py::list {
-                    /* This is a work around for pybind not properly
-                     * handling converting a vector of unique pointers
-                     * to python lists of shared pointers */
-                    py::list l;
-                    for (auto &ptr : self.split()) {
-                        l.append(py::cast(std::shared_ptr<Footprint>(std::move(ptr))));
-                    }
-                    return l;
-                });
+                cls.def(
+                        "split",
+                        [](Footprint const &self, int numThreads) -> py::list {
+                            /* This is a work around for pybind not properly
+                             * handling converting a vector of unique pointers
+                             * to python lists of shared pointers */
+                            py::list l;
+                            for (auto &ptr : self.split(numThreads)) {
+                                l.append(py::cast(std::shared_ptr<Footprint>(std::move(ptr))));
+                            }
+                            return l;
+                        },
+                        "numThreads"_a = 1);
 
                 cls.def_property("spans", &Footprint::getSpans, &Footprint::setSpans);
                 cls.def_property_readonly("peaks", (PeakCatalog & (Footprint::*)()) & Footprint::getPeaks,
@@ -174,6 +180,18 @@ void wrapFootprint(WrapperCollection &wrappers) {
     wrappers.wrap([](auto &mod) {
         mod.def("mergeFootprints", &mergeFootprints);
         mod.def("footprintToBBoxList", &footprintToBBoxList);
+        mod.def("transformFootprints",
+                py::overload_cast<std::vector<std::shared_ptr<Footprint>> const &,
+                                  geom::TransformPoint2ToPoint2 const &, lsst::geom::Box2I const &, bool,
+                                  int>(&transformFootprints),
+                "footprints"_a, "transform"_a, "region"_a, "doClip"_a = true, "numThreads"_a = 1,
+                py::call_guard<py::gil_scoped_release>());
+        mod.def("transformFootprints",
+                py::overload_cast<std::vector<std::shared_ptr<Footprint>> const &, geom::SkyWcs const &,
+                                  geom::SkyWcs const &, lsst::geom::Box2I const &, bool, int>(
+                        &transformFootprints),
+                "footprints"_a, "source"_a, "target"_a, "region"_a, "doClip"_a = true, "numThreads"_a = 1,
+                py::call_guard<py::gil_scoped_release>());
     });
 }
 
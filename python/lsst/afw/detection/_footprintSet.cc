@@ -49,29 +49,35 @@ void declareMakeHeavy(PyClass &cls) {
     //            });
     cls.def("makeHeavy",
             (void (FootprintSet::*)(image::MaskedImage<PixelT, image::MaskPixel> const &,
-                                    HeavyFootprintCtrl const *)) &
+                                    HeavyFootprintCtrl const *, int)) &
                     FootprintSet::makeHeavy<PixelT, image::MaskPixel>,
-            "mimg"_a, "ctrl"_a = nullptr);
+            "mimg"_a, "ctrl"_a = nullptr, "numThreads"_a = 1);
 }
 
 template <typename PixelT, typename PyClass>
 void declareSetMask(PyClass &cls) {
     cls.def("setMask",
-            (void (FootprintSet::*)(image::Mask<PixelT> *, std::string const &)) &
+            (void (FootprintSet::*)(image::Mask<PixelT> *, std::string const &, int)) &
                     FootprintSet::setMask<PixelT>,
-            "mask"_a, "planeName"_a);
+            "mask"_a, "planeName"_a, "numThreads"_a = 1);
 }
 
 template <typename PixelT, typename PyClass>
 void declareTemplatedMembers(PyClass &cls) {
     /* Constructors */
     cls.def(py::init<image::Image<PixelT> const &, Threshold const &, int const, bool const,
-                     table::Schema const &>(),
+                     table::Schema const &, int const>(),
             "img"_a, "threshold"_a, "npixMin"_a = 1, "setPeaks"_a = true,
-            "peakSchema"_a = PeakTable::makeMinimalSchema());
+            "peakSchema"_a = PeakTable::makeMinimalSchema(), "numThreads"_a = 1,
+            py::call_guard<py::gil_scoped_release>());
     cls.def(py::init<image::MaskedImage<PixelT, image::MaskPixel> const &, Threshold const &,
-                     std::string const &, int const, bool const>(),
-            "img"_a, "threshold"_a, "planeName"_a = "", "npixMin"_a = 1, "setPeaks"_a = true);
+                     std::string const &, int const, bool const, int const>(),
+            "img"_a, "threshold"_a, "planeName"_a = "", "npixMin"_a = 1, "setPeaks"_a = true,
+            "numThreads"_a = 1, py::call_guard<py::gil_scoped_release>());
+    cls.def_static("makeBothPolarities", &FootprintSet::makeBothPolarities<PixelT, image::MaskPixel>,
+                   "img"_a, "threshold"_a, "positivePlaneName"_a = "", "negativePlaneName"_a = "",
+                   "npixMin"_a = 1, "setPeaks"_a = true, "numThreads"_a = 1,
+                   py::call_guard<py::gil_scoped_release>());
 
     /* Members */
     declareMakeHeavy<int>(cls);
@@ -87,7 +93,7 @@ void wrapFootprintSet(cpputils::python::WrapperCollection &wrappers) {
     wrappers.addSignatureDependency("lsst.afw.image");
     wrappers.addSignatureDependency("lsst.afw.table");
 
-    wrappers.wrapType(
+    auto clsFootprintSet = wrappers.wrapType(
             py::class_<FootprintSet, std::shared_ptr<FootprintSet>>(wrappers.module, "FootprintSet"),
             [](auto &mod, auto &cls) {
                 declareTemplatedMembers<std::uint16_t>(cls);
@@ -95,16 +101,22 @@ void wrapFootprintSet(cpputils::python::WrapperCollection &wrappers) {
                 declareTemplatedMembers<float>(cls);
                 declareTemplatedMembers<double>(cls);
 
-                cls.def(py::init<image::Mask<image::MaskPixel> const &, Threshold const &, int const>(),
-                        "img"_a, "threshold"_a, "npixMin"_a = 1);
+                cls.def(py::init<image::Mask<image::MaskPixel> const &, Threshold const &, int const,
+                                 int const>(),
+                        "img"_a, "threshold"_a, "npixMin"_a = 1, "numThreads"_a = 1,
+                        py::call_guard<py::gil_scoped_release>());
 
                 cls.def(py::init<lsst::geom::Box2I>(), "region"_a);
                 cls.def(py::init<FootprintSet const &>(), "set"_a);
                 cls.def(py::init<FootprintSet const &, int, FootprintControl const &>(), "set"_a, "rGrow"_a,
-                        "ctrl"_a);
-                cls.def(py::init<FootprintSet const &, int, bool>(), "set"_a, "rGrow"_a, "isotropic"_a);
+                        "ctrl"_a, py::call_guard<py::gil_scoped_release>());
+                cls.def(py::init<FootprintSet const &, int, bool>(), "set"_a, "rGrow"_a, "isotropic"_a,
+                        py::call_guard<py::gil_scoped_release>());
+                cls.def(py::init<FootprintSet const &, int, bool, FootprintSet::GrowthAlgorithm, int>(),
+                        "set"_a, "rGrow"_a, "isotropic"_a, "algorithm"_a, "numThreads"_a = 1,
+                        py::call_guard<py::gil_scoped_release>());
                 cls.def(py::init<FootprintSet const &, FootprintSet const &, bool>(), "footprints1"_a,
-                        "footprints2"_a, "includePeaks"_a);
+                        "footprints2"_a, "includePeaks"_a, py::call_guard<py::gil_scoped_release>());
 
                 cls.def("swap", &FootprintSet::swap);
                 // setFootprints takes shared_ptr<FootprintList> and getFootprints returns it,
@@ -114,20 +126,42 @@ void wrapFootprintSet(cpputils::python::WrapperCollection &wrappers) {
                 });
                 cls.def("getFootprints", [](FootprintSet &self) { return *(self.getFootprints()); });
                 cls.def("makeSources", &FootprintSet::makeSources);
+                cls.def("makePeakCatalog", &FootprintSet::makePeakCatalog);
                 cls.def("setRegion", &FootprintSet::setRegion);
                 cls.def("getRegion", &FootprintSet::getRegion);
-                cls.def("insertIntoImage", &FootprintSet::insertIntoImage);
-                cls.def("setMask", (void (FootprintSet::*)(image::Mask<lsst::afw::image::MaskPixel> *,
-                                                           std::string const &)) &
-                                           FootprintSet::setMask<lsst::afw::image::MaskPixel>);
+                cls.def("insertIntoImage",
+                        py::overload_cast<int>(&FootprintSet::insertIntoImage, py::const_),
+                        "numThreads"_a = 1, py::call_guard<py::gil_scoped_release>());
+                cls.def("insertIntoImage",
+                        py::overload_cast<image::Image<FootprintIdPixel> &, int>(
+                                &FootprintSet::insertIntoImage, py::const_),
+                        "idImage"_a, "numThreads"_a = 1, py::call_guard<py::gil_scoped_release>());
                 cls.def("setMask",
                         (void (FootprintSet::*)(std::shared_ptr<image::Mask<lsst::afw::image::MaskPixel>>,
-                                                std::string const &)) &
-                                FootprintSet::setMask<lsst::afw::image::MaskPixel>);
+                                                std::string const &, int)) &
+                                FootprintSet::setMask<lsst::afw::image::MaskPixel>,
+                        "mask"_a, "planeName"_a, "numThreads"_a = 1);
                 cls.def("merge", &FootprintSet::merge, "rhs"_a, "tGrow"_a = 0, "rGrow"_a = 0,
                         "isotropic"_a = true);
+                cls.def("transform",
+                        py::overload_cast<geom::TransformPoint2ToPoint2 const &, lsst::geom::Box2I const &,
+                                          bool, int>(&FootprintSet::transform, py::const_),
+                        "transform"_a, "region"_a, "doClip"_a = true, "numThreads"_a = 1,
+                        py::call_guard<py::gil_scoped_release>());
+                cls.def("transform",
+                        py::overload_cast<geom::SkyWcs const &, geom::SkyWcs const &,
+                                          lsst::geom::Box2I const &, bool, int>(&FootprintSet::transform,
+                                                                               py::const_),
+                        "source"_a, "target"_a, "region"_a, "doClip"_a = true, "numThreads"_a = 1,
+                        py::call_guard<py::gil_scoped_release>());
                 cpputils::python::addOutputOp(cls, "__repr__");
             });
+
+    wrappers.wrapType(py::enum_<FootprintSet::GrowthAlgorithm>(clsFootprintSet, "GrowthAlgorithm"),
+                      [](auto &mod, auto &enm) {
+                          enm.value("DILATE", FootprintSet::GrowthAlgorithm::DILATE);
+                          enm.value("DISTANCE_TRANSFORM", FootprintSet::GrowthAlgorithm::DISTANCE_TRANSFORM);
+                      });
 }
 
 }  // namespace detection
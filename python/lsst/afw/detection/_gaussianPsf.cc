@@ -23,6 +23,8 @@
 
 #include <pybind11/pybind11.h>
 
+#include "ndarray/pybind11.h"
+
 #include "lsst/afw/table/io/python.h"  // for addPersistableMethods
 #include "lsst/afw/detection/GaussianPsf.h"
 
@@ -48,6 +50,7 @@ void wrapGaussianPsf(cpputils::python::WrapperCollection& wrappers) {
                 cls.def("resized", &GaussianPsf::resized, "width"_a, "height"_a);
                 cls.def("getDimensions", &GaussianPsf::getDimensions);
                 cls.def("getSigma", &GaussianPsf::getSigma);
+                cls.def("computeKernelArray", &GaussianPsf::computeKernelArray, "array"_a);
                 cls.def("isPersistable", &GaussianPsf::isPersistable);
             });
 }
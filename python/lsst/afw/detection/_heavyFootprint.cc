@@ -81,6 +81,10 @@ void declareHeavyFootprint(WrapperCollection &wrappers, std::string const &suffi
                 "foot"_a, "img"_a, "ctrl"_a = nullptr);
 
         mod.def("mergeHeavyFootprints", mergeHeavyFootprints<ImagePixelT, MaskPixelT, VariancePixelT>);
+        mod.def("makeHeavyFootprints", makeHeavyFootprints<ImagePixelT, MaskPixelT, VariancePixelT>,
+                "footprints"_a, "mimage"_a, "numThreads"_a = 1, py::call_guard<py::gil_scoped_release>());
+        mod.def("insertHeavyFootprints", insertHeavyFootprints<ImagePixelT, MaskPixelT, VariancePixelT>,
+                "heavies"_a, "mimage"_a, "numThreads"_a = 1, py::call_guard<py::gil_scoped_release>());
     });
 }
 }  // namespace
@@ -24,6 +24,7 @@
 #include <memory>
 
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
 
 #include "lsst/cpputils/python.h"
 #include "lsst/cpputils/python/PySharedPtr.h"
@@ -79,6 +80,14 @@ void wrapPsf(cpputils::python::WrapperCollection& wrappers) {
                         "color"_a = image::Color(),
                         "owner"_a = Psf::ImageOwnerEnum::COPY
                 );
+                // Release the GIL so worker threads can call doComputeKernelImages overrides in Python
+                cls.def("computeKernelImages",
+                        &Psf::computeKernelImages,
+                        "positions"_a,
+                        "colors"_a = std::vector<image::Color>(),
+                        "numThreads"_a = 1,
+                        py::call_guard<py::gil_scoped_release>()
+                );
                 cls.def("computePeak",
                         &Psf::computePeak,
                         "position"_a,
@@ -122,9 +131,20 @@ void wrapPsf(cpputils::python::WrapperCollection& wrappers) {
                                "warpAlgorithm"_a = "lanczos5", "warpBuffer"_a = 5);
                 cls.def("getCacheCapacity", &Psf::getCacheCapacity);
                 cls.def("setCacheCapacity", &Psf::setCacheCapacity);
+                cls.def("getCacheGridSize", &Psf::getCacheGridSize);
+                cls.def("setCacheGridSize", &Psf::setCacheGridSize, "gridSize"_a);
+                cls.def("getCacheStatistics", &Psf::getCacheStatistics);
+                cls.def("resetCacheStatistics", &Psf::resetCacheStatistics);
             }
     );
 
+    wrappers.wrapType(py::class_<Psf::CacheStatistics>(clsPsf, "CacheStatistics"), [](auto& mod, auto& cls) {
+        cls.def_readonly("imageHits", &Psf::CacheStatistics::imageHits);
+        cls.def_readonly("imageMisses", &Psf::CacheStatistics::imageMisses);
+        cls.def_readonly("kernelImageHits", &Psf::CacheStatistics::kernelImageHits);
+        cls.def_readonly("kernelImageMisses", &Psf::CacheStatistics::kernelImageMisses);
+    });
+
     wrappers.wrapType(py::enum_<Psf::ImageOwnerEnum>(clsPsf, "ImageOwnerEnum"), [](auto& mod, auto& enm) {
         enm.value("COPY", Psf::ImageOwnerEnum::COPY);
         enm.value("INTERNAL", Psf::ImageOwnerEnum::INTERNAL);
@@ -26,6 +26,12 @@
 #if !defined(LSST_AFW_DISPLAY_RGB_H)
 #define LSST_AFW_DISPLAY_RGB_H 1
 
+#include <array>
+#include <cstdint>
+
+#include "ndarray.h"
+#include "lsst/afw/image/Image.h"
+
 namespace lsst {
 namespace afw {
 namespace display {
@@ -101,6 +107,40 @@ std::pair<double, double> getZScale(image::Image<T> const& image,  ///< The imag
                                     int const nSamples = 1000,     ///< Number of samples to use
                                     double const contrast = 0.25   ///< Stretch parameter; see description
                                     );
+
+/**
+ * Map three images to an RGB image with an asinh stretch (Lupton et al. 2004, PASP 116, 133).
+ *
+ * This is AsinhMapping.makeRgbImage for images of the same shape, done in one pass over the pixels
+ * (on up to numThreads threads; 0 means as many as allowed) rather than with numpy temporaries.
+ * After subtracting minimum from each band, every band is multiplied by
+ * asinh(soften*I)*slope/I, where I is the mean of the bands (or by zero where I <= 0); negative
+ * values are set to zero, pixels whose brightest band exceeds 255 are scaled down to preserve their
+ * colour, and the values are truncated to uint8.  Non-finite pixels are black.
+ *
+ * @returns an array of shape (height, width, 3)
+ *
+ * @throws lsst::pex::exceptions::LengthError if the images have different shapes.
+ * @throws lsst::pex::exceptions::InvalidParameterError if numThreads < 0.
+ */
+template <typename T>
+ndarray::Array<std::uint8_t, 3, 3> makeAsinhRgbArray(
+        ndarray::Array<T const, 2, 1> const& imageR,  ///< image mapped to red, indexed [y][x]
+        ndarray::Array<T const, 2, 1> const& imageG,  ///< image mapped to green
+        ndarray::Array<T const, 2, 1> const& imageB,  ///< image mapped to blue
+        std::array<double, 3> const& minimum,         ///< intensity of each band mapped to black
+        double soften,                                ///< Q/dataRange
+        double slope,                                 ///< scale of the stretched intensity
+        int numThreads = 1                            ///< number of threads to use
+);
+
+/// Map three Images to an RGB image with an asinh stretch; see makeAsinhRgbArray.
+template <typename T>
+ndarray::Array<std::uint8_t, 3, 3> makeAsinhRgbImage(image::Image<T> const& imageR,
+                                                     image::Image<T> const& imageG,
+                                                     image::Image<T> const& imageB,
+                                                     std::array<double, 3> const& minimum, double soften,
+                                                     double slope, int numThreads = 1);
 }
 }
 }
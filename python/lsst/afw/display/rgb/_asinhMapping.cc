@@ -0,0 +1,110 @@
+/*
+ * Map three images to an RGB image with an asinh stretch, in a single pass.  This does what
+ * AsinhMapping.makeRgbImage does with numpy, without its full-image temporaries.
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "boost/format.hpp"
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/image/Image.h"
+#include "lsst/afw/math/detail/Parallel.h"
+#include "Rgb.h"
+
+namespace lsst {
+namespace afw {
+namespace display {
+
+namespace {
+
+double const UINT8_MAX_VALUE = 255.0;
+
+// Convert a value in [0, 255] (or NaN) to uint8, truncating as numpy's astype does
+inline std::uint8_t toUint8(double value) {
+    if (!(value > 0.0)) {
+        return 0;
+    }
+    return static_cast<std::uint8_t>(std::min(value, UINT8_MAX_VALUE));
+}
+
+}  // namespace
+
+template <typename T>
+ndarray::Array<std::uint8_t, 3, 3> makeAsinhRgbArray(ndarray::Array<T const, 2, 1> const& imageR,
+                                                     ndarray::Array<T const, 2, 1> const& imageG,
+                                                     ndarray::Array<T const, 2, 1> const& imageB,
+                                                     std::array<double, 3> const& minimum, double soften,
+                                                     double slope, int numThreads) {
+    if (imageG.getShape() != imageR.getShape() || imageB.getShape() != imageR.getShape()) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("Images have different shapes: (%d, %d), (%d, %d), (%d, %d)") %
+                           imageR.getSize<0>() % imageR.getSize<1>() % imageG.getSize<0>() %
+                           imageG.getSize<1>() % imageB.getSize<0>() % imageB.getSize<1>())
+                                  .str());
+    }
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    int const height = imageR.getSize<0>();
+    int const width = imageR.getSize<1>();
+    ndarray::Array<std::uint8_t, 3, 3> result = ndarray::allocate(height, width, 3);
+
+    auto const pieces = math::detail::splitRange(0, height, nThreads);
+    math::detail::parallelFor(static_cast<int>(pieces.size()), nThreads, [&](int piece) {
+        for (int y = pieces[piece].first; y < pieces[piece].second; ++y) {
+            T const* rowR = imageR[y].getData();
+            T const* rowG = imageG[y].getData();
+            T const* rowB = imageB[y].getData();
+            std::uint8_t* out = result[y].getData();
+            for (int x = 0; x < width; ++x, out += 3) {
+                double r = rowR[x] - minimum[0];
+                double g = rowG[x] - minimum[1];
+                double b = rowB[x] - minimum[2];
+                double const intensity = (r + g + b) / 3.0;
+                double const factor =
+                        (intensity <= 0.0) ? 0.0 : std::asinh(intensity * soften) * slope / intensity;
+                // individual bands can still be < 0, even if the factor isn't
+                r = std::max(r * factor, 0.0);
+                g = std::max(g * factor, 0.0);
+                b = std::max(b * factor, 0.0);
+                // scale saturated pixels down to preserve their colour
+                double const brightest = (r > g) ? ((r > b) ? r : b) : ((g > b) ? g : b);
+                if (brightest >= UINT8_MAX_VALUE) {
+                    double const scale = UINT8_MAX_VALUE / brightest;
+                    r *= scale;
+                    g *= scale;
+                    b *= scale;
+                }
+                out[0] = toUint8(r);
+                out[1] = toUint8(g);
+                out[2] = toUint8(b);
+            }
+        }
+    });
+    return result;
+}
+
+template <typename T>
+ndarray::Array<std::uint8_t, 3, 3> makeAsinhRgbImage(image::Image<T> const& imageR,
+                                                     image::Image<T> const& imageG,
+                                                     image::Image<T> const& imageB,
+                                                     std::array<double, 3> const& minimum, double soften,
+                                                     double slope, int numThreads) {
+    return makeAsinhRgbArray<T>(imageR.getArray(), imageG.getArray(), imageB.getArray(), minimum, soften,
+                                slope, numThreads);
+}
+
+#define INSTANTIATE(T)                                                                                    \
+    template ndarray::Array<std::uint8_t, 3, 3> makeAsinhRgbArray(                                       \
+            ndarray::Array<T const, 2, 1> const&, ndarray::Array<T const, 2, 1> const&,                  \
+            ndarray::Array<T const, 2, 1> const&, std::array<double, 3> const&, double, double, int);   \
+    template ndarray::Array<std::uint8_t, 3, 3> makeAsinhRgbImage(                                       \
+            image::Image<T> const&, image::Image<T> const&, image::Image<T> const&,                      \
+            std::array<double, 3> const&, double, double, int);
+
+INSTANTIATE(std::uint16_t)
+INSTANTIATE(float)
+INSTANTIATE(double)
+
+}  // namespace display
+}  // namespace afw
+}  // namespace lsst
@@ -23,6 +23,7 @@
 #include <pybind11/pybind11.h>
 #include <lsst/cpputils/python.h>
 #include <pybind11/stl.h>
+#include "ndarray/pybind11.h"
 
 #include "lsst/afw/image/Image.h"
 #include "lsst/afw/image/MaskedImage.h"
@@ -43,6 +44,12 @@ PYBIND11_MODULE(_rgb, mod) {
                 "rim"_a, "gim"_a, "bim"_a, "borderWidth"_a = 2, "saturatedPixelValue"_a = 65535);
         mod.def("getZScale", getZScale<std::uint16_t>, "image"_a, "nsamples"_a = 1000, "contrast"_a = 0.25);
         mod.def("getZScale", getZScale<float>, "image"_a, "nsamples"_a = 1000, "contrast"_a = 0.25);
+        mod.def("makeAsinhRgbArray", makeAsinhRgbArray<std::uint16_t>, "imageR"_a, "imageG"_a, "imageB"_a,
+                "minimum"_a, "soften"_a, "slope"_a, "numThreads"_a = 1);
+        mod.def("makeAsinhRgbArray", makeAsinhRgbArray<float>, "imageR"_a, "imageG"_a, "imageB"_a,
+                "minimum"_a, "soften"_a, "slope"_a, "numThreads"_a = 1);
+        mod.def("makeAsinhRgbArray", makeAsinhRgbArray<double>, "imageR"_a, "imageG"_a, "imageB"_a,
+                "minimum"_a, "soften"_a, "slope"_a, "numThreads"_a = 1);
     });
     wrappers.finish();
 }
@@ -24,7 +24,7 @@ import numpy as np
 
 import lsst.afw.image as afwImage
 import lsst.afw.math as afwMath
-from ._rgb import replaceSaturatedPixels, getZScale
+from ._rgb import replaceSaturatedPixels, getZScale, makeAsinhRgbArray
 
 
 def computeIntensity(imageR, imageG=None, imageB=None):
@@ -96,7 +96,7 @@ class Mapping:
         self._image = image
 
     def makeRgbImage(self, imageR=None, imageG=None, imageB=None,
-                     xSize=None, ySize=None, rescaleFactor=None):
+                     xSize=None, ySize=None, rescaleFactor=None, numThreads=1):
         """Convert 3 arrays, imageR, imageG, and imageB into a numpy RGB image
 
         imageR : `lsst.afw.image.Image` or `numpy.ndarray`, (Nx, Ny)
@@ -111,6 +111,9 @@ class Mapping:
             Desired height of RGB image
         rescaleFactor : `float`, optional
             Make size of output image ``rescaleFactor*size`` of the input image
+        numThreads : `int`, optional
+            Number of threads to use where the mapping supports it (0 means as
+            many as allowed).
         """
         if imageR is None:
             if self._image is None:
@@ -155,8 +158,17 @@ class Mapping:
                 imageRGB[i] = scipy.misc.imresize(
                     im, size, interp='bilinear', mode='F')
 
+        rgbImage = self._fuseImagesToUint8(imageRGB, numThreads)
+        if rgbImage is not None:
+            return rgbImage
         return np.dstack(self._convertImagesToUint8(*imageRGB)).astype(np.uint8)
 
+    def _fuseImagesToUint8(self, imageRGB, numThreads):
+        """Convert three arrays to an RGB image in a single pass, if the
+        mapping can; otherwise return `None`
+        """
+        return None
+
     def intensity(self, imageR, imageG, imageB):
         """Return the total intensity from the red, blue, and green intensities
 
@@ -320,6 +332,19 @@ class AsinhMapping(Mapping):
         with np.errstate(invalid='ignore', divide='ignore'):  # n.b. np.where can't and doesn't short-circuit
             return np.where(intensity <= 0, 0, np.arcsinh(intensity*self._soften)*self._slope/intensity)
 
+    def _fuseImagesToUint8(self, imageRGB, numThreads):
+        # The fused C++ mapping only knows the naive intensity and asinh stretch
+        if (type(self).intensity is not Mapping.intensity
+                or type(self).mapIntensityToUint8 is not AsinhMapping.mapIntensityToUint8):
+            return None
+        dtype = imageRGB[0].dtype
+        if (dtype not in (np.uint16, np.float32, np.float64)
+                or any(c.dtype != dtype or c.shape != imageRGB[0].shape or c.ndim != 2 for c in imageRGB)):
+            return None
+        return makeAsinhRgbArray(*[np.ascontiguousarray(c) for c in imageRGB],
+                                 minimum=[float(m) for m in self.minimum],
+                                 soften=self._soften, slope=self._slope, numThreads=numThreads)
+
 
 class AsinhZScaleMapping(AsinhMapping):
     """A mapping for an asinh stretch, estimating the linear stretch by zscale
@@ -21,10 +21,13 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <cstring>
+
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
 #include "lsst/cpputils/python.h"
+#include "lsst/cpputils/python/PySharedPtr.h"
 
 #include "ndarray/pybind11.h"
 
@@ -32,13 +35,16 @@
 #include "lsst/pex/exceptions/Runtime.h"
 #include "lsst/pex/exceptions/python/Exception.h"
 #include "lsst/daf/base.h"
+#include "lsst/geom/Box.h"
 #include "lsst/afw/image/Image.h"
 
 #include "lsst/afw/fits.h"
+#include "lsst/afw/fitsByteRange.h"
 
 namespace py = pybind11;
 
 using namespace pybind11::literals;
+using lsst::cpputils::python::PySharedPtr;
 namespace lsst {
 namespace afw {
 namespace fits {
@@ -83,6 +89,16 @@ void declareImageCompression(lsst::cpputils::python::WrapperCollection &wrappers
             });
 }
 
+void declareTableCompression(lsst::cpputils::python::WrapperCollection &wrappers) {
+    wrappers.wrapType(py::class_<TableCompressionOptions>(wrappers.module, "TableCompressionOptions"),
+                      [](auto &mod, auto &cls) {
+                          cls.def(py::init<TableCompressionOptions::CompressionAlgorithm, long>(),
+                                  "algorithm"_a = ImageCompressionOptions::NONE, "rows"_a = 0);
+                          cls.def_readonly("algorithm", &TableCompressionOptions::algorithm);
+                          cls.def_readonly("rows", &TableCompressionOptions::rows);
+                      });
+}
+
 template <typename T>
 void declareImageScalingOptionsTemplates(py::class_<ImageScalingOptions> &cls) {
     cls.def(
@@ -176,6 +192,7 @@ void declareImageWriteOptions(lsst::cpputils::python::WrapperCollection &wrapper
 
                           cls.def_readonly("compression", &ImageWriteOptions::compression);
                           cls.def_readonly("scaling", &ImageWriteOptions::scaling);
+                          cls.def_readwrite("checksum", &ImageWriteOptions::checksum);
 
                           cls.def_static("validate", &ImageWriteOptions::validate);
                       });
@@ -191,6 +208,8 @@ void declareFits(lsst::cpputils::python::WrapperCollection &wrappers) {
                 "behavior"_a = Fits::AUTO_CLOSE | Fits::AUTO_CHECK);
         cls.def(py::init<MemFileManager &, std::string const &, int>(), "manager"_a, "mode"_a,
                 "behavior"_a = Fits::AUTO_CLOSE | Fits::AUTO_CHECK);
+        cls.def(py::init<std::shared_ptr<ByteRangeCache>, int>(), "cache"_a,
+                "behavior"_a = Fits::AUTO_CLOSE | Fits::AUTO_CHECK);
 
         cls.def("closeFile", &Fits::closeFile);
         cls.def("getFileName", &Fits::getFileName);
@@ -218,18 +237,148 @@ void declareFits(lsst::cpputils::python::WrapperCollection &wrappers) {
 
         cls.def("setImageCompression", &Fits::setImageCompression);
         cls.def("getImageCompression", &Fits::getImageCompression);
+        cls.def("setTableCompression", &Fits::setTableCompression);
+        cls.def("getTableCompression", &Fits::getTableCompression);
+        cls.def("isCompressedTable", &Fits::isCompressedTable);
         cls.def("checkCompressedImagePhu", &Fits::checkCompressedImagePhu);
 
         cls.def_readonly("status", &Fits::status);
     });
 }
 
+// Lets Python subclasses of ByteRangeSource make the requests, e.g. with an object-store client.
+class PyByteRangeSource : public ByteRangeSource {
+public:
+    std::string getName() const override {
+        PYBIND11_OVERLOAD_PURE(std::string, ByteRangeSource, getName, );
+    }
+
+    std::size_t getSize() override { PYBIND11_OVERLOAD_PURE(std::size_t, ByteRangeSource, getSize, ); }
+
+    // The Python method returns the bytes (any buffer) rather than filling one.
+    void read(std::size_t offset, std::size_t size, char *buffer) override {
+        py::gil_scoped_acquire gil;
+        py::function override = py::get_overload(static_cast<ByteRangeSource const *>(this), "read");
+        if (!override) {
+            throw LSST_EXCEPT(pex::exceptions::LogicError, "ByteRangeSource.read is not implemented");
+        }
+        py::buffer_info const data = py::buffer(override(offset, size)).request();
+        if (static_cast<std::size_t>(data.size * data.itemsize) != size) {
+            throw LSST_EXCEPT(pex::exceptions::IoError,
+                              (boost::format("ByteRangeSource.read returned %d bytes at %d of '%s', not %d") %
+                               (data.size * data.itemsize) % offset % getName() % size)
+                                      .str());
+        }
+        std::memcpy(buffer, data.ptr, size);
+    }
+};
+
+void declareByteRange(lsst::cpputils::python::WrapperCollection &wrappers) {
+    wrappers.wrapType(py::class_<ByteRangeSource, PySharedPtr<ByteRangeSource>, PyByteRangeSource>(
+                              wrappers.module, "ByteRangeSource"),
+                      [](auto &mod, auto &cls) {
+                          cls.def(py::init<>());
+                          cls.def("getName", &ByteRangeSource::getName);
+                          cls.def("getSize", &ByteRangeSource::getSize);
+                          cls.def("read", [](ByteRangeSource &self, std::size_t offset, std::size_t size) {
+                              std::string result(size, '\0');
+                              self.read(offset, size, &result[0]);
+                              return py::bytes(result);
+                          }, "offset"_a, "size"_a);
+                      });
+    wrappers.wrapType(py::class_<FileByteRangeSource, std::shared_ptr<FileByteRangeSource>, ByteRangeSource>(
+                              wrappers.module, "FileByteRangeSource"),
+                      [](auto &mod, auto &cls) { cls.def(py::init<std::string const &>(), "fileName"_a); });
+    wrappers.wrapType(
+            py::class_<ByteRangeCache, std::shared_ptr<ByteRangeCache>>(wrappers.module, "ByteRangeCache"),
+            [](auto &mod, auto &cls) {
+                cls.def(py::init<std::shared_ptr<ByteRangeSource>, std::size_t, std::size_t, std::size_t>(),
+                        "source"_a, "blockSize"_a = ByteRangeCache::DEFAULT_BLOCK_SIZE,
+                        "capacity"_a = ByteRangeCache::DEFAULT_CAPACITY,
+                        "readAhead"_a = ByteRangeCache::DEFAULT_READ_AHEAD);
+                cls.def("getSource", &ByteRangeCache::getSource);
+                cls.def("getSize", &ByteRangeCache::getSize);
+                cls.def("read", [](ByteRangeCache &self, std::size_t offset, std::size_t size) {
+                    std::string result(size, '\0');
+                    self.read(offset, size, &result[0]);
+                    return py::bytes(result);
+                }, "offset"_a, "size"_a);
+                cls.def("getRequestCount", &ByteRangeCache::getRequestCount);
+                cls.def("getBytesFetched", &ByteRangeCache::getBytesFetched);
+            });
+}
+
+void declareLazyHeader(lsst::cpputils::python::WrapperCollection &wrappers) {
+    wrappers.wrapType(py::class_<LazyHeader>(wrappers.module, "LazyHeader"), [](auto &mod, auto &cls) {
+        cls.def(py::init<Fits &>(), "fitsfile"_a);
+        cls.def(py::init<std::string const &, int>(), "fileName"_a, "hdu"_a = DEFAULT_HDU);
+        cls.def("__len__", &LazyHeader::size);
+        cls.def("__contains__", &LazyHeader::exists);
+        cls.def("exists", &LazyHeader::exists, "name"_a);
+        cls.def("getNames", &LazyHeader::getNames);
+        cls.def("getValueString", &LazyHeader::getValueString, "name"_a);
+        cls.def("getComment", &LazyHeader::getComment, "name"_a);
+        cls.def("extract", &LazyHeader::extract, "names"_a, "strip"_a = false);
+        cls.def("toPropertyList", &LazyHeader::toPropertyList, "strip"_a = false);
+        // Values are returned as the equivalent PropertyList methods would return them
+        cls.def(
+                "get",
+                [](LazyHeader const &self, std::string const &name, py::object defaultValue) {
+                    return py::cast(self.extract({name})).attr("get")(name, defaultValue);
+                },
+                "name"_a, "default"_a = py::none());
+        cls.def("__getitem__", [](LazyHeader const &self, std::string const &name) {
+            return py::cast(self.extract({name})).attr("__getitem__")(name);
+        });
+    });
+}
+
+template <typename T>
+void declareImageStreamWriter(lsst::cpputils::python::WrapperCollection &wrappers, std::string const &suffix) {
+    using Class = ImageStreamWriter<T>;
+    wrappers.wrapType(py::class_<Class>(wrappers.module, ("ImageStreamWriter" + suffix).c_str()),
+                      [](auto &mod, auto &cls) {
+                          cls.def(py::init<Fits &, lsst::geom::Box2I const &, ImageWriteOptions const &,
+                                           daf::base::PropertySet const *>(),
+                                  "fitsfile"_a, "bbox"_a, "options"_a = ImageWriteOptions(),
+                                  "header"_a = nullptr, py::keep_alive<1, 2>());
+                          cls.def("writeRows", &Class::writeRows, "rows"_a);
+                          cls.def("getRowsWritten", &Class::getRowsWritten);
+                          cls.def("getBBox", &Class::getBBox);
+                          cls.def("isClosed", &Class::isClosed);
+                          cls.def("close", &Class::close);
+                          cls.def("__enter__", [](Class &self) -> Class & { return self; });
+                          cls.def("__exit__", [](Class &self, py::object type, py::object, py::object) {
+                              if (type.is_none()) self.close();
+                          });
+                      });
+}
+
 void declareFitsModule(lsst::cpputils::python::WrapperCollection &wrappers) {
     wrappers.wrap([](auto &mod) {
-        py::class_<MemFileManager> clsMemFileManager(mod, "MemFileManager");
+        py::class_<MemFileManager> clsMemFileManager(mod, "MemFileManager", py::buffer_protocol());
 
         clsMemFileManager.def(py::init<>());
         clsMemFileManager.def(py::init<size_t>());
+        // Wrap an existing (e.g. bytes or memoryview) buffer without copying it; it may only be read
+        clsMemFileManager.def(py::init([](py::buffer data) {
+                                  py::buffer_info info = data.request();
+                                  if (info.ndim != 1 || info.strides[0] != info.itemsize) {
+                                      throw LSST_EXCEPT(lsst::pex::exceptions::InvalidParameterError,
+                                                        "Memory file data must be a contiguous 1-d buffer");
+                                  }
+                                  auto manager = std::make_unique<MemFileManager>();
+                                  manager->resetReadOnly(info.ptr, info.size * info.itemsize);
+                                  return manager;
+                              }),
+                              "data"_a, py::keep_alive<1, 2>());
+        // A view of the file contents, valid until the manager is next written to or reset
+        clsMemFileManager.def_buffer([](MemFileManager &m) {
+            return py::buffer_info(m.getData(), 1, py::format_descriptor<std::uint8_t>::format(), 1,
+                                   {static_cast<py::ssize_t>(m.getLength())}, {1}, m.isReadOnly());
+        });
+        clsMemFileManager.def("getCapacity", &MemFileManager::getCapacity);
+        clsMemFileManager.def("isReadOnly", &MemFileManager::isReadOnly);
 
         /* TODO: We should really revisit persistence and pickling as this is quite ugly.
          * But it is what Swig did (sort of, it used the cdata.i extension), so I reckon this
@@ -273,6 +422,8 @@ void declareFitsModule(lsst::cpputils::python::WrapperCollection &wrappers) {
 
         mod.def("setAllowImageCompression", &setAllowImageCompression, "allow"_a);
         mod.def("getAllowImageCompression", &getAllowImageCompression);
+        mod.def("setImageCompressionThreads", &setImageCompressionThreads, "numThreads"_a);
+        mod.def("getImageCompressionThreads", &getImageCompressionThreads);
 
         mod.def("compressionAlgorithmFromString", &compressionAlgorithmFromString);
         mod.def("compressionAlgorithmToString", &compressionAlgorithmToString);
@@ -285,15 +436,24 @@ PYBIND11_MODULE(_fits, mod) {
     lsst::cpputils::python::WrapperCollection wrappers(mod, "lsst.afw.fits");
     wrappers.addInheritanceDependency("lsst.pex.exceptions");
     wrappers.addSignatureDependency("lsst.daf.base");
+    wrappers.addSignatureDependency("lsst.geom");
     // FIXME: after afw.image pybind wrappers are converted
     //wrappers.addSignatureDependency("lsst.afw.image");
     auto cls = wrappers.wrapException<FitsError, lsst::pex::exceptions::IoError>("FitsError", "IoError");
     cls.def(py::init<std::string const &>());
     declareImageCompression(wrappers);
+    declareTableCompression(wrappers);
     declareImageScalingOptions(wrappers);
     declareImageScale(wrappers);
     declareImageWriteOptions(wrappers);
+    declareByteRange(wrappers);
     declareFits(wrappers);
+    declareLazyHeader(wrappers);
+    declareImageStreamWriter<std::uint16_t>(wrappers, "U");
+    declareImageStreamWriter<int>(wrappers, "I");
+    declareImageStreamWriter<std::uint64_t>(wrappers, "L");
+    declareImageStreamWriter<float>(wrappers, "F");
+    declareImageStreamWriter<double>(wrappers, "D");
     declareFitsModule(wrappers);
     wrappers.finish();
 }
@@ -38,7 +38,8 @@ class Fits:  # noqa: F811
 @continueClass
 class ImageWriteOptions:  # noqa: F811
     def __repr__(self):
-        return f"{self.__class__.__name__}(compression={self.compression!r}, scaling={self.scaling!r})"
+        return (f"{self.__class__.__name__}(compression={self.compression!r}, scaling={self.scaling!r}, "
+                f"checksum={self.checksum})")
 
 
 @continueClass
@@ -19,11 +19,33 @@
 # You should have received a copy of the GNU General Public License
 # along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+import threading
+
 from lsst.afw.fits import MemFileManager, ImageWriteOptions, ImageCompressionOptions
 
 import lsst.afw.table
 import lsst.afw.image
 
+# Memory files are reused across pickles, so that pickling many objects of
+# similar size (e.g. to send them to other processes) allocates their
+# buffers only once.  A manager keeps its memory when written to again.
+_MAX_POOLED_MANAGERS = 4
+_managerPool = []
+_managerPoolLock = threading.Lock()
+
+
+def _acquireManager():
+    with _managerPoolLock:
+        if _managerPool:
+            return _managerPool.pop()
+    return MemFileManager()
+
+
+def _releaseManager(manager):
+    with _managerPoolLock:
+        if len(_managerPool) < _MAX_POOLED_MANAGERS:
+            _managerPool.append(manager)
+
 
 def reduceToFits(obj):
     """Pickle to FITS
@@ -42,20 +64,24 @@ def reduceToFits(obj):
     reduced : `tuple` [callable, `tuple`]
         a tuple in the format returned by `~object.__reduce__`
     """
-    manager = MemFileManager()
-    options = ImageWriteOptions(ImageCompressionOptions(ImageCompressionOptions.NONE))
-    table = getattr(obj, 'table', None)
-    if isinstance(table, lsst.afw.table.BaseTable):
-        # table objects don't take `options`
-        obj.writeFits(manager)
-    else:
-        # MaskedImage and Exposure both require options for each plane (image, mask, variance)
-        if isinstance(obj, (lsst.afw.image.MaskedImage, lsst.afw.image.Exposure)):
-            obj.writeFits(manager, options, options, options)
+    manager = _acquireManager()
+    try:
+        options = ImageWriteOptions(ImageCompressionOptions(ImageCompressionOptions.NONE))
+        table = getattr(obj, 'table', None)
+        if isinstance(table, lsst.afw.table.BaseTable):
+            # table objects don't take `options`
+            obj.writeFits(manager)
         else:
-            obj.writeFits(manager, options)
-    size = manager.getLength()
-    data = manager.getData()
+            # MaskedImage and Exposure both require options for each plane (image, mask, variance)
+            if isinstance(obj, (lsst.afw.image.MaskedImage, lsst.afw.image.Exposure)):
+                obj.writeFits(manager, options, options, options)
+            else:
+                obj.writeFits(manager, options)
+        size = manager.getLength()
+        # pickle needs data it owns, so this is the one copy of the file
+        data = manager.getData()
+    finally:
+        _releaseManager(manager)
     return (unreduceFromFits, (obj.__class__, data, size))
 
 
@@ -81,6 +107,6 @@ def unreduceFromFits(cls, data, size):
     unpickled : ``cls``
         the object represented by ``data``
     """
-    manager = MemFileManager(size)
-    manager.setData(data, size)
+    # read directly from ``data``, without copying it
+    manager = MemFileManager(memoryview(data)[:size])
     return cls.readFits(manager)
@@ -27,7 +27,7 @@ from ._geom import makeTanSipMetadata
 __all__ = ("calculateSipWcsHeader",)
 
 
-def calculateSipWcsHeader(wcs, order, bbox, spacing, header=None):
+def calculateSipWcsHeader(wcs, order, bbox, spacing, header=None, numThreads=1):
     """Generate a SIP WCS header approximating a given ``SkyWcs``
 
     Parameters
@@ -42,6 +42,9 @@ def calculateSipWcsHeader(wcs, order, bbox, spacing, header=None):
         Spacing between sample points.
     header : `lsst.daf.base.PropertyList`, optional
         Header to which to add SIP WCS keywords.
+    numThreads : `int`, optional
+        Maximum number of threads to use when evaluating ``wcs`` on the grid
+        of sample points and fitting; 0 means one per hardware thread.
 
     Returns
     -------
@@ -59,7 +62,7 @@ def calculateSipWcsHeader(wcs, order, bbox, spacing, header=None):
     crval = wcs.getSkyOrigin()
     gridNum = Extent2I(int(bbox.getWidth()/spacing + 0.5), int(bbox.getHeight()/spacing + 0.5))
 
-    sip = SipApproximation(transform, crpix, cdMatrix, Box2D(bbox), gridNum, order)
+    sip = SipApproximation(transform, crpix, cdMatrix, Box2D(bbox), gridNum, order, numThreads=numThreads)
 
     md = makeTanSipMetadata(sip.getPixelOrigin(), crval, sip.getCdMatrix(), sip.getA(), sip.getB(),
                             sip.getAP(), sip.getBP())
@@ -28,6 +28,7 @@
 #include <lsst/cpputils/python.h>
 
 #include <pybind11/stl.h>
+#include "ndarray/pybind11.h"
 
 #include "lsst/pex/exceptions/Runtime.h"
 #include "lsst/pex/exceptions/python/Exception.h"
@@ -79,6 +80,12 @@ void declarePolygon(lsst::cpputils::python::WrapperCollection &wrappers) {
                 cls.def("contains", (bool (Polygon::*)(Polygon::Point const&) const) &Polygon::contains);
                 cls.def("contains", (std::vector<bool> (Polygon::*)(std::vector<Polygon::Point> const&) const) &Polygon::contains);
                 cls.def("contains", (std::vector<bool> (Polygon::*)(std::vector<lsst::geom::Point2I> const&) const) &Polygon::contains);
+                cls.def("contains",
+                        (ndarray::Array<bool, 1, 1>(Polygon::*)(ndarray::Array<double const, 1> const &,
+                                                                ndarray::Array<double const, 1> const &)
+                                 const) &
+                                Polygon::contains,
+                        "x"_a, "y"_a);
                 cls.def("contains", py::vectorize((bool (Polygon::*)(double x, double y) const) &Polygon::contains<double, double>));
                 cls.def("contains", py::vectorize((bool (Polygon::*)(float x, float y) const) &Polygon::contains<float, float>));
                 cls.def("contains", py::vectorize((bool (Polygon::*)(int x, int y) const) &Polygon::contains<int, int>));
@@ -133,6 +140,27 @@ void declarePolygon(lsst::cpputils::python::WrapperCollection &wrappers) {
                                                Polygon::createImage);
             });
 }
+
+void declarePolygonBatch(lsst::cpputils::python::WrapperCollection &wrappers) {
+    wrappers.wrapType(py::class_<PolygonIntersection>(wrappers.module, "PolygonIntersection"),
+                      [](auto &mod, auto &cls) {
+                          cls.def_readonly("first", &PolygonIntersection::first);
+                          cls.def_readonly("second", &PolygonIntersection::second);
+                          cls.def_readonly("intersection", &PolygonIntersection::intersection);
+                      });
+    wrappers.wrapType(
+            py::class_<PolygonUnion, std::shared_ptr<PolygonUnion>>(wrappers.module, "PolygonUnion"),
+            [](auto &mod, auto &cls) {
+                cls.def(py::init<>());
+                cls.def("add", &PolygonUnion::add, "polygon"_a);
+                cls.def("getNumAdded", &PolygonUnion::getNumAdded);
+                cls.def("getPolygons", &PolygonUnion::getPolygons);
+                cls.def("calculateArea", &PolygonUnion::calculateArea);
+            });
+    wrappers.wrap([](auto &mod) {
+        mod.def("intersectPairs", &intersectPairs, "polygons"_a, "numThreads"_a = 1);
+    });
+}
 }  // namespace
 void wrapPolygon(lsst::cpputils::python::WrapperCollection &wrappers) {
     wrappers.addInheritanceDependency("lsst.pex.exceptions");
@@ -141,6 +169,7 @@ void wrapPolygon(lsst::cpputils::python::WrapperCollection &wrappers) {
     wrappers.wrapException<SinglePolygonException, pex::exceptions::RuntimeError>("SinglePolygonException",
                                                                                   "RuntimeError");
     declarePolygon(wrappers);
+    declarePolygonBatch(wrappers);
 }
 }  // namespace polygon
 }  // namespace geom
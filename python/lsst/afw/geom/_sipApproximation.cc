@@ -44,17 +44,17 @@ void declareSipApproximation(lsst::cpputils::python::WrapperCollection &wrappers
     wrappers.wrapType(PySipApproximation(wrappers.module, "SipApproximation"), [](auto &mod, auto &cls) {
         cls.def(py::init<std::shared_ptr<TransformPoint2ToPoint2>, lsst::geom::Point2D const &,
                          Eigen::MatrixXd const &, lsst::geom::Box2D const &, lsst::geom::Extent2I const &,
-                         int, bool, double>(),
+                         int, bool, double, int>(),
                 "pixelToIwc"_a, "crpix"_a, "cd"_a, "bbox"_a, "gridShape"_a, "order"_a, "useInverse"_a = true,
-                "svdThreshold"_a = -1);
+                "svdThreshold"_a = -1, "numThreads"_a = 1);
 
         cls.def(py::init<std::shared_ptr<TransformPoint2ToPoint2>, lsst::geom::Point2D const &,
                          Eigen::MatrixXd const &, lsst::geom::Box2D const &, lsst::geom::Extent2I const &,
                          ndarray::Array<double const, 2> const &, ndarray::Array<double const, 2> const &,
                          ndarray::Array<double const, 2> const &, ndarray::Array<double const, 2> const &,
-                         bool>(),
+                         bool, int>(),
                 "pixelToIwc"_a, "crpix"_a, "cd"_a, "bbox"_a, "gridShape"_a, "a"_a, "b"_a, "ap"_a, "bp"_a,
-                "useInverse"_a = true);
+                "useInverse"_a = true, "numThreads"_a = 1);
 
         using ScalarTransform = lsst::geom::Point2D (SipApproximation::*)(lsst::geom::Point2D const &) const;
         using VectorTransform = std::vector<lsst::geom::Point2D> (SipApproximation::*)(
@@ -81,6 +81,8 @@ void declareSipApproximation(lsst::cpputils::python::WrapperCollection &wrappers
         cls.def("updateGrid", &SipApproximation::updateGrid, "shape"_a);
         cls.def("refineGrid", &SipApproximation::refineGrid, "factor"_a = 2);
         cls.def("fit", &SipApproximation::fit, "order"_a, "svdThreshold"_a = -1);
+        cls.def("fitToTolerance", &SipApproximation::fitToTolerance, "maxOrder"_a, "tolerance"_a,
+                "svdThreshold"_a = -1);
         cls.def("computeMaxDeviation", &SipApproximation::computeMaxDeviation);
     });
 }
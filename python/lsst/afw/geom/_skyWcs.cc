@@ -56,8 +56,11 @@ void declareSkyWcs(lsst::cpputils::python::WrapperCollection &wrappers) {
                 (std::shared_ptr<SkyWcs>(*)(lsst::geom::Point2D const &, lsst::geom::SpherePoint const &,
                                             Eigen::Matrix2d const &, std::string const &))makeSkyWcs,
                 "crpix"_a, "crval"_a, "cdMatrix"_a, "projection"_a = "TAN");
-        mod.def("makeSkyWcs", (std::shared_ptr<SkyWcs>(*)(daf::base::PropertySet &, bool))makeSkyWcs,
-                "metadata"_a, "strip"_a = false);
+        mod.def("makeSkyWcs",
+                (std::shared_ptr<SkyWcs>(*)(daf::base::PropertySet &, bool, bool))makeSkyWcs,
+                "metadata"_a, "strip"_a = false, "useCache"_a = true);
+        mod.def("setSkyWcsMetadataCacheCapacity", setSkyWcsMetadataCacheCapacity, "capacity"_a);
+        mod.def("getSkyWcsMetadataCacheCapacity", getSkyWcsMetadataCacheCapacity);
         mod.def("makeSkyWcs",
                 (std::shared_ptr<SkyWcs>(*)(TransformPoint2ToPoint2 const &, lsst::geom::Angle const &, bool,
                                             lsst::geom::SpherePoint const &, std::string const &))makeSkyWcs,
@@ -96,6 +99,11 @@ void declareSkyWcs(lsst::cpputils::python::WrapperCollection &wrappers) {
                         (lsst::geom::Angle(SkyWcs::*)(lsst::geom::Point2D const &) const) &
                                 SkyWcs::getPixelScale,
                         "pixel"_a);
+                cls.def("getPixelScale",
+                        (std::vector<lsst::geom::Angle>(SkyWcs::*)(std::vector<lsst::geom::Point2D> const &)
+                                 const) &
+                                SkyWcs::getPixelScale,
+                        "pixel"_a);
                 cls.def("getPixelScale", (lsst::geom::Angle(SkyWcs::*)() const) & SkyWcs::getPixelScale);
                 cls.def("getPixelOrigin", &SkyWcs::getPixelOrigin);
                 cls.def("getSkyOrigin", &SkyWcs::getSkyOrigin);
@@ -129,6 +137,30 @@ void declareSkyWcs(lsst::cpputils::python::WrapperCollection &wrappers) {
                                                                 lsst::geom::AngleUnit const &) const) &
                                 SkyWcs::linearizeSkyToPixel,
                         "coord"_a, "skyUnit"_a);
+                cls.def("linearizePixelToSky",
+                        (std::vector<lsst::geom::AffineTransform>(SkyWcs::*)(
+                                std::vector<lsst::geom::SpherePoint> const &,
+                                lsst::geom::AngleUnit const &) const) &
+                                SkyWcs::linearizePixelToSky,
+                        "coord"_a, "skyUnit"_a);
+                cls.def("linearizePixelToSky",
+                        (std::vector<lsst::geom::AffineTransform>(SkyWcs::*)(
+                                std::vector<lsst::geom::Point2D> const &,
+                                lsst::geom::AngleUnit const &) const) &
+                                SkyWcs::linearizePixelToSky,
+                        "coord"_a, "skyUnit"_a);
+                cls.def("linearizeSkyToPixel",
+                        (std::vector<lsst::geom::AffineTransform>(SkyWcs::*)(
+                                std::vector<lsst::geom::SpherePoint> const &,
+                                lsst::geom::AngleUnit const &) const) &
+                                SkyWcs::linearizeSkyToPixel,
+                        "coord"_a, "skyUnit"_a);
+                cls.def("linearizeSkyToPixel",
+                        (std::vector<lsst::geom::AffineTransform>(SkyWcs::*)(
+                                std::vector<lsst::geom::Point2D> const &,
+                                lsst::geom::AngleUnit const &) const) &
+                                SkyWcs::linearizeSkyToPixel,
+                        "coord"_a, "skyUnit"_a);
                 cls.def("pixelToSky",
                         (lsst::geom::SpherePoint(SkyWcs::*)(lsst::geom::Point2D const &) const) &
                                 SkyWcs::pixelToSky,
@@ -35,6 +35,7 @@
 
 #include "lsst/afw/geom/ellipses/Quadrupole.h"
 #include "lsst/afw/geom/SpanSet.h"
+#include "lsst/afw/geom/PackedSpanSet.h"
 #include "lsst/afw/table/io/python.h"  // for addPersistableMethods
 
 namespace py = pybind11;
@@ -52,44 +53,46 @@ template <typename Pixel, typename PyClass>
 void declareFlattenMethod(PyClass &cls) {
     cls.def("flatten",
             (ndarray::Array<Pixel, 1, 1>(SpanSet::*)(ndarray::Array<Pixel, 2, 0> const &,
-                                                     lsst::geom::Point2I const &) const) &
+                                                     lsst::geom::Point2I const &, int) const) &
                     SpanSet::flatten<Pixel, 2, 0>,
-            "input"_a, "xy0"_a = lsst::geom::Point2I());
+            "input"_a, "xy0"_a = lsst::geom::Point2I(), "numThreads"_a = 1);
     cls.def("flatten",
             (ndarray::Array<Pixel, 2, 2>(SpanSet::*)(ndarray::Array<Pixel, 3, 0> const &,
-                                                     lsst::geom::Point2I const &) const) &
+                                                     lsst::geom::Point2I const &, int) const) &
                     SpanSet::flatten<Pixel, 3, 0>,
-            "input"_a, "xy0"_a = lsst::geom::Point2I());
+            "input"_a, "xy0"_a = lsst::geom::Point2I(), "numThreads"_a = 1);
     cls.def("flatten",
             (void (SpanSet::*)(ndarray::Array<Pixel, 1, 0> const &, ndarray::Array<Pixel, 2, 0> const &,
-                               lsst::geom::Point2I const &) const) &
+                               lsst::geom::Point2I const &, int) const) &
                     SpanSet::flatten<Pixel, Pixel, 2, 0, 0>,
-            "output"_a, "input"_a, "xy0"_a = lsst::geom::Point2I());
+            "output"_a, "input"_a, "xy0"_a = lsst::geom::Point2I(), "numThreads"_a = 1);
     cls.def("flatten",
             (void (SpanSet::*)(ndarray::Array<Pixel, 2, 0> const &, ndarray::Array<Pixel, 3, 0> const &,
-                               lsst::geom::Point2I const &) const) &
+                               lsst::geom::Point2I const &, int) const) &
                     SpanSet::flatten<Pixel, Pixel, 3, 0, 0>,
-            "output"_a, "input"_a, "xy0"_a = lsst::geom::Point2I());
+            "output"_a, "input"_a, "xy0"_a = lsst::geom::Point2I(), "numThreads"_a = 1);
 }
 
 template <typename Pixel, typename PyClass>
 void declareUnflattenMethod(PyClass &cls) {
     cls.def("unflatten",
-            (ndarray::Array<Pixel, 2, 2>(SpanSet::*)(ndarray::Array<Pixel, 1, 0> const &input) const) &
-                    SpanSet::unflatten<Pixel, 1, 0>);
+            (ndarray::Array<Pixel, 2, 2>(SpanSet::*)(ndarray::Array<Pixel, 1, 0> const &input, int) const) &
+                    SpanSet::unflatten<Pixel, 1, 0>,
+            "input"_a, "numThreads"_a = 1);
     cls.def("unflatten",
-            (ndarray::Array<Pixel, 3, 3>(SpanSet::*)(ndarray::Array<Pixel, 2, 0> const &input) const) &
-                    SpanSet::unflatten<Pixel, 2, 0>);
+            (ndarray::Array<Pixel, 3, 3>(SpanSet::*)(ndarray::Array<Pixel, 2, 0> const &input, int) const) &
+                    SpanSet::unflatten<Pixel, 2, 0>,
+            "input"_a, "numThreads"_a = 1);
     cls.def("unflatten",
             (void (SpanSet::*)(ndarray::Array<Pixel, 2, 0> const &, ndarray::Array<Pixel, 1, 0> const &,
-                               lsst::geom::Point2I const &) const) &
+                               lsst::geom::Point2I const &, int) const) &
                     SpanSet::unflatten<Pixel, Pixel, 1, 0, 0>,
-            "output"_a, "input"_a, "xy0"_a = lsst::geom::Point2I());
+            "output"_a, "input"_a, "xy0"_a = lsst::geom::Point2I(), "numThreads"_a = 1);
     cls.def("unflatten",
             (void (SpanSet::*)(ndarray::Array<Pixel, 3, 0> const &, ndarray::Array<Pixel, 2, 0> const &,
-                               lsst::geom::Point2I const &) const) &
+                               lsst::geom::Point2I const &, int) const) &
                     SpanSet::unflatten<Pixel, Pixel, 2, 0, 0>,
-            "output"_a, "input"_a, "xy0"_a = lsst::geom::Point2I());
+            "output"_a, "input"_a, "xy0"_a = lsst::geom::Point2I(), "numThreads"_a = 1);
 }
 
 template <typename Pixel, typename PyClass>
@@ -172,9 +175,12 @@ void declareSetImage(PyClass &cls) {
 template <typename MaskPixel, typename PyClass>
 void declarefromMask(PyClass &cls) {
     cls.def_static("fromMask", [](image::Mask<MaskPixel> mask) { return SpanSet::fromMask(mask); });
-    cls.def_static("fromMask", [](image::Mask<MaskPixel> mask, MaskPixel const &bitmask) {
-        return SpanSet::fromMask(mask, bitmask);
-    });
+    cls.def_static(
+            "fromMask",
+            [](image::Mask<MaskPixel> const &mask, MaskPixel bitmask, int numThreads) {
+                return SpanSet::fromMask(mask, bitmask, numThreads);
+            },
+            "mask"_a, "bitmask"_a, "numThreads"_a = 1, py::call_guard<py::gil_scoped_release>());
 }
 
 template <typename Pixel, typename PyClass>
@@ -203,6 +209,29 @@ void declareStencil(lsst::cpputils::python::WrapperCollection &wrappers) {
     });
 }
 
+void declarePackedSpanSet(lsst::cpputils::python::WrapperCollection &wrappers) {
+    wrappers.wrapType(py::class_<PackedSpanSet>(wrappers.module, "PackedSpanSet"), [](auto &mod, auto &cls) {
+        cls.def(py::init<>());
+        cls.def(py::init<SpanSet const &>(), "spanSet"_a);
+        cls.def("getArea", &PackedSpanSet::getArea);
+        cls.def("getBBox", &PackedSpanSet::getBBox);
+        cls.def("getMemorySize", &PackedSpanSet::getMemorySize);
+        cls.def("toSpanSet", &PackedSpanSet::toSpanSet);
+        cls.def("__len__", &PackedSpanSet::size);
+        // Iterators decode into a member, so Spans must be copied out rather than referenced
+        cls.def(
+                "__iter__",
+                [](PackedSpanSet const &self) {
+                    return py::make_iterator<py::return_value_policy::copy>(self.begin(), self.end());
+                },
+                py::keep_alive<0, 1>());
+        cls.def("__eq__", [](PackedSpanSet const &self, PackedSpanSet const &other) { return self == other; },
+                py::is_operator());
+        cls.def("__ne__", [](PackedSpanSet const &self, PackedSpanSet const &other) { return self != other; },
+                py::is_operator());
+    });
+}
+
 void declareSpanSet(lsst::cpputils::python::WrapperCollection &wrappers) {
     using MaskPixel = image::MaskPixel;
 
@@ -231,19 +260,36 @@ void declareSpanSet(lsst::cpputils::python::WrapperCollection &wrappers) {
         cls.def("transformedBy",
                 (std::shared_ptr<SpanSet>(SpanSet::*)(TransformPoint2ToPoint2 const &) const) &
                         SpanSet::transformedBy);
+        cls.def_static("transformEach", &SpanSet::transformEach, "spanSets"_a, "transform"_a,
+                       "numThreads"_a = 1, py::call_guard<py::gil_scoped_release>());
         cls.def("overlaps", &SpanSet::overlaps);
         cls.def("contains", (bool (SpanSet::*)(SpanSet const &) const) & SpanSet::contains);
         cls.def("contains", (bool (SpanSet::*)(lsst::geom::Point2I const &) const) & SpanSet::contains);
         cls.def("computeCentroid", &SpanSet::computeCentroid);
         cls.def("computeShape", &SpanSet::computeShape);
-        cls.def("dilated", (std::shared_ptr<SpanSet>(SpanSet::*)(int, Stencil) const) & SpanSet::dilated,
-                "radius"_a, "stencil"_a = Stencil::CIRCLE);
-        cls.def("dilated", (std::shared_ptr<SpanSet>(SpanSet::*)(SpanSet const &) const) & SpanSet::dilated);
-        cls.def("eroded", (std::shared_ptr<SpanSet>(SpanSet::*)(int, Stencil) const) & SpanSet::eroded,
-                "radius"_a, "stencil"_a = Stencil::CIRCLE);
-        cls.def("eroded", (std::shared_ptr<SpanSet>(SpanSet::*)(SpanSet const &) const) & SpanSet::eroded);
+        cls.def("dilated",
+                (std::shared_ptr<SpanSet>(SpanSet::*)(int, Stencil, int) const) & SpanSet::dilated,
+                "radius"_a, "stencil"_a = Stencil::CIRCLE, "numThreads"_a = 1);
+        cls.def("dilated",
+                (std::shared_ptr<SpanSet>(SpanSet::*)(SpanSet const &, int) const) & SpanSet::dilated,
+                "other"_a, "numThreads"_a = 1);
+        cls.def("eroded", (std::shared_ptr<SpanSet>(SpanSet::*)(int, Stencil, int) const) & SpanSet::eroded,
+                "radius"_a, "stencil"_a = Stencil::CIRCLE, "numThreads"_a = 1);
+        cls.def("eroded",
+                (std::shared_ptr<SpanSet>(SpanSet::*)(SpanSet const &, int) const) & SpanSet::eroded,
+                "other"_a, "numThreads"_a = 1);
         cls.def("intersect",
                 (std::shared_ptr<SpanSet>(SpanSet::*)(SpanSet const &) const) & SpanSet::intersect);
+        cls.def("intersectEach",
+                (std::vector<std::shared_ptr<SpanSet>>(SpanSet::*)(
+                        std::vector<std::shared_ptr<SpanSet>> const &, int) const) &
+                        SpanSet::intersectEach,
+                "others"_a, "numThreads"_a = 1);
+        cls.def("intersectEach",
+                (std::vector<std::shared_ptr<SpanSet>>(SpanSet::*)(
+                        std::vector<lsst::geom::Box2I> const &, int) const) &
+                        SpanSet::intersectEach,
+                "boxes"_a, "numThreads"_a = 1);
         cls.def("intersectNot",
                 (std::shared_ptr<SpanSet>(SpanSet::*)(SpanSet const &) const) & SpanSet::intersectNot);
         cls.def("union", (std::shared_ptr<SpanSet>(SpanSet::*)(SpanSet const &) const) & SpanSet::union_);
@@ -258,7 +304,14 @@ void declareSpanSet(lsst::cpputils::python::WrapperCollection &wrappers) {
                 "radius"_a, "stencil"_a = Stencil::CIRCLE, "offset"_a = std::pair<int, int>(0, 0));
         cls.def_static("fromShape",
                        (std::shared_ptr<SpanSet>(*)(geom::ellipses::Ellipse const &)) & SpanSet::fromShape);
-        cls.def("split", &SpanSet::split);
+        cls.def_static("fromShape",
+                       (std::shared_ptr<SpanSet>(*)(geom::ellipses::Ellipse const &,
+                                                    geom::ellipses::PixelRegionCache &)) &
+                               SpanSet::fromShape,
+                       "ellipse"_a, "cache"_a);
+        cls.def("split",
+                (std::vector<std::shared_ptr<SpanSet>>(SpanSet::*)(int) const) & SpanSet::split,
+                "numThreads"_a = 1);
         cls.def("findEdgePixels", &SpanSet::findEdgePixels);
         cls.def("indices", [](SpanSet const &self) -> ndarray::Array<int, 2, 2> {
             unsigned long dims = 2;
@@ -338,6 +391,7 @@ void wrapSpanSet(lsst::cpputils::python::WrapperCollection &wrappers) {
     wrappers.addSignatureDependency("lsst.afw.geom.ellipses");
     declareStencil(wrappers);
     declareSpanSet(wrappers);
+    declarePackedSpanSet(wrappers);
 }
 }  // namespace geom
 }  // namespace afw
@@ -95,11 +95,13 @@ void declareTransform(lsst::cpputils::python::WrapperCollection &wrappers) {
                 cls.def("getMapping", [](Class const &self) { return self.getMapping()->copy(); });
 
                 cls.def("applyForward",
-                        py::overload_cast<FromArray const &>(&Class::applyForward, py::const_), "array"_a);
+                        py::overload_cast<FromArray const &, int>(&Class::applyForward, py::const_),
+                        "array"_a, "numThreads"_a = 1);
                 cls.def("applyForward",
                         py::overload_cast<FromPoint const &>(&Class::applyForward, py::const_), "point"_a);
-                cls.def("applyInverse", py::overload_cast<ToArray const &>(&Class::applyInverse, py::const_),
-                        "array"_a);
+                cls.def("applyInverse",
+                        py::overload_cast<ToArray const &, int>(&Class::applyInverse, py::const_),
+                        "array"_a, "numThreads"_a = 1);
                 cls.def("applyInverse", py::overload_cast<ToPoint const &>(&Class::applyInverse, py::const_),
                         "point"_a);
                 cls.def("inverted", &Class::inverted);
@@ -29,6 +29,8 @@
 
 #include "lsst/geom/Point.h"
 #include "lsst/geom/AffineTransform.h"
+#include "lsst/geom/Box.h"
+#include "lsst/geom/Extent.h"
 #include "lsst/afw/geom/transformFactory.h"
 
 namespace py = pybind11;
@@ -61,6 +63,17 @@ void declareTransformFactory(lsst::cpputils::python::WrapperCollection &wrappers
                 "forwardCoeffs"_a, "inverseCoeffs"_a);
         mod.def("makeIdentityTransform", &makeIdentityTransform);
     });
+    wrappers.wrapType(py::class_<TransformApproximation>(wrappers.module, "TransformApproximation"),
+                      [](auto &mod, auto &cls) {
+                          cls.def_readonly("transform", &TransformApproximation::transform);
+                          cls.def_readonly("order", &TransformApproximation::order);
+                          cls.def_readonly("maxForwardError", &TransformApproximation::maxForwardError);
+                          cls.def_readonly("maxInverseError", &TransformApproximation::maxInverseError);
+                      });
+    wrappers.wrap([](auto &mod) {
+        mod.def("approximateTransform", &approximateTransform, "original"_a, "bbox"_a, "maxError"_a,
+                "maxOrder"_a = 9, "gridShape"_a = lsst::geom::Extent2I(50, 50));
+    });
 }
 }  // namespace
 void wrapTransformFactory(lsst::cpputils::python::WrapperCollection &wrappers) {
@@ -0,0 +1,78 @@
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "pybind11/pybind11.h"
+#include "lsst/cpputils/python.h"
+
+#include "ndarray/pybind11.h"
+
+#include "lsst/afw/geom/ellipses/batch.h"
+
+namespace py = pybind11;
+using namespace pybind11::literals;
+
+namespace lsst {
+namespace afw {
+namespace geom {
+namespace ellipses {
+void wrapBatch(lsst::cpputils::python::WrapperCollection &wrappers) {
+    using Column = ndarray::Array<double const, 1>;
+    wrappers.wrap([](auto &mod) {
+        mod.def(
+                "convertQuadrupolesToAxes",
+                [](Column const &ixx, Column const &iyy, Column const &ixy) {
+                    ndarray::Array<double, 1, 1> a = ndarray::allocate(ixx.getSize<0>());
+                    ndarray::Array<double, 1, 1> b = ndarray::allocate(ixx.getSize<0>());
+                    ndarray::Array<double, 1, 1> theta = ndarray::allocate(ixx.getSize<0>());
+                    convertQuadrupolesToAxes(ixx, iyy, ixy, a, b, theta);
+                    return py::make_tuple(a, b, theta);
+                },
+                "ixx"_a, "iyy"_a, "ixy"_a);
+        mod.def(
+                "convertAxesToQuadrupoles",
+                [](Column const &a, Column const &b, Column const &theta) {
+                    ndarray::Array<double, 1, 1> ixx = ndarray::allocate(a.getSize<0>());
+                    ndarray::Array<double, 1, 1> iyy = ndarray::allocate(a.getSize<0>());
+                    ndarray::Array<double, 1, 1> ixy = ndarray::allocate(a.getSize<0>());
+                    convertAxesToQuadrupoles(a, b, theta, ixx, iyy, ixy);
+                    return py::make_tuple(ixx, iyy, ixy);
+                },
+                "a"_a, "b"_a, "theta"_a);
+        mod.def(
+                "transformQuadrupoles",
+                [](lsst::geom::LinearTransform const &transform, Column const &ixx, Column const &iyy,
+                   Column const &ixy) {
+                    ndarray::Array<double, 1, 1> ixxOut = ndarray::allocate(ixx.getSize<0>());
+                    ndarray::Array<double, 1, 1> iyyOut = ndarray::allocate(ixx.getSize<0>());
+                    ndarray::Array<double, 1, 1> ixyOut = ndarray::allocate(ixx.getSize<0>());
+                    transformQuadrupoles(transform, ixx, iyy, ixy, ixxOut, iyyOut, ixyOut);
+                    return py::make_tuple(ixxOut, iyyOut, ixyOut);
+                },
+                "transform"_a, "ixx"_a, "iyy"_a, "ixy"_a);
+        mod.def("convertCores", &convertCores, "fromName"_a, "toName"_a, "parameters"_a);
+    });
+}
+}  // namespace ellipses
+}  // namespace geom
+}  // namespace afw
+}  // namespace lsst
@@ -39,6 +39,7 @@ void wrapConformalShear(lsst::cpputils::python::WrapperCollection &);
 void wrapReducedShear(lsst::cpputils::python::WrapperCollection &);
 void wrapQuadrupole(lsst::cpputils::python::WrapperCollection &);
 void wrapSeparable(lsst::cpputils::python::WrapperCollection &);
+void wrapBatch(lsst::cpputils::python::WrapperCollection &);
 
 PYBIND11_MODULE(_ellipses, mod) {
     lsst::cpputils::python::WrapperCollection wrappers(mod, "lsst.afw.geom.ellipses");
@@ -54,6 +55,7 @@ PYBIND11_MODULE(_ellipses, mod) {
     wrapQuadrupole(wrappers);
     wrapReducedShear(wrappers);
     wrapSeparable(wrappers);
+    wrapBatch(wrappers);
     wrappers.finish();
 }
 }  // namespace ellipses
@@ -27,6 +27,7 @@
 #include "lsst/afw/geom/ellipses/PixelRegion.h"
 
 namespace py = pybind11;
+using namespace pybind11::literals;
 
 namespace lsst {
 namespace afw {
@@ -45,6 +46,12 @@ void wrapPixelRegion(lsst::cpputils::python::WrapperCollection &wrappers) {
                 [](const PixelRegion &self) { return py::make_iterator(self.begin(), self.end()); },
                 py::keep_alive<0, 1>() /* Essential: keep object alive while iterator exists */);
     });
+    wrappers.wrapType(py::class_<PixelRegionCache>(wrappers.module, "PixelRegionCache"),
+                      [](auto &mod, auto &cls) {
+                          cls.def(py::init<std::size_t>(), "maxSize"_a = 16);
+                          cls.def("makePixelRegion", &PixelRegionCache::makePixelRegion, "ellipse"_a);
+                          cls.def("__len__", &PixelRegionCache::size);
+                      });
 }
 }  // namespace ellipses
 }  // namespace geom
@@ -27,13 +27,14 @@ import lsst.geom
 from ._python import reduceTransform
 from ._geom import (SkyWcs, makeCdMatrix, makeFlippedWcs, makeModifiedWcs,
                     makeSkyWcs, makeTanSipWcs, makeWcsPairTransform,
-                    getIntermediateWorldCoordsToSky, getPixelToIntermediateWorldCoords)
+                    getIntermediateWorldCoordsToSky, getPixelToIntermediateWorldCoords,
+                    setSkyWcsMetadataCacheCapacity, getSkyWcsMetadataCacheCapacity)
 from ._hpxUtils import makeHpxWcs
 
 __all__ = ["SkyWcs", "makeCdMatrix", "makeFlippedWcs", "makeSkyWcs",
            "makeModifiedWcs", "makeTanSipWcs", "makeWcsPairTransform",
            "getIntermediateWorldCoordsToSky", "getPixelToIntermediateWorldCoords",
-           "makeHpxWcs"]
+           "makeHpxWcs", "setSkyWcsMetadataCacheCapacity", "getSkyWcsMetadataCacheCapacity"]
 
 
 @continueClass
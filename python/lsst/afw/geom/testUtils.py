@@ -1115,4 +1115,7 @@ class TransformTestBaseClass(lsst.utils.tests.TestCase):
         # Check afw::table::io persistence round-trip
         with lsst.utils.tests.getTempFilePath(".fits") as filename:
             transform.writeFits(filename)
-            self.assertTransformsEqual(transform, type(transform).readFits(filename))
+            transformFromFits = type(transform).readFits(filename)
+        self.assertTransformsEqual(transform, transformFromFits)
+        # the compact archive encoding must reproduce the serialization exactly
+        self.assertEqual(transformFromFits.writeString(), transformStr)
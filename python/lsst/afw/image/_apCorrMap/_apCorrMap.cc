@@ -30,6 +30,7 @@
 
 #include "lsst/afw/table/io/python.h"  // for addPersistableMethods
 #include "lsst/afw/typehandling/Storable.h"
+#include "lsst/afw/table/Source.h"
 #include "lsst/afw/image/ApCorrMap.h"
 
 namespace py = pybind11;
@@ -63,6 +64,8 @@ void wrapApCorrMap(lsst::cpputils::python::WrapperCollection &wrappers) {
         cls.def("__len__", &ApCorrMap::size);
         cls.def("__getitem__", &ApCorrMap::operator[]);
         cls.def("__setitem__", &ApCorrMap::set);
+        cls.def("applyToCatalog", &ApCorrMap::applyToCatalog, "catalog"_a, "names"_a, "numThreads"_a = 1,
+                py::call_guard<py::gil_scoped_release>());
         cls.def("__contains__",
                 [](ApCorrMap const &self, std::string name) { return static_cast<bool>(self.get(name)); });
     });
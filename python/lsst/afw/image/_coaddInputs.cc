@@ -22,13 +22,17 @@
  */
 
 #include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
 #include "lsst/cpputils/python.h"
 
+#include <vector>
+
 #include "lsst/afw/table/io/python.h"  // for addPersistableMethods
 #include "lsst/afw/table/Schema.h"
 #include "lsst/afw/table/Exposure.h"
 #include "lsst/afw/typehandling/Storable.h"
 #include "lsst/afw/image/CoaddInputs.h"
+#include "lsst/afw/image/CoaddInputsIndex.h"
 
 namespace py = pybind11;
 using namespace pybind11::literals;
@@ -38,9 +42,12 @@ namespace afw {
 namespace image {
 
 using PyCoaddInputs = py::class_<CoaddInputs, std::shared_ptr<CoaddInputs>, typehandling::Storable>;
+using PyCoaddInputsIndex =
+        py::class_<CoaddInputsIndex, std::shared_ptr<CoaddInputsIndex>, table::io::Persistable>;
 
 void wrapCoaddInputs(lsst::cpputils::python::WrapperCollection &wrappers) {
     wrappers.addInheritanceDependency("lsst.afw.typehandling");
+    wrappers.addInheritanceDependency("lsst.afw.table.io");
     wrappers.wrapType(PyCoaddInputs(wrappers.module, "CoaddInputs"), [](auto &mod, auto &cls) {
         /* Constructors */
         cls.def(py::init<>());
@@ -55,6 +62,36 @@ void wrapCoaddInputs(lsst::cpputils::python::WrapperCollection &wrappers) {
         cls.def_readwrite("ccds", &CoaddInputs::ccds);
         cls.def("isPersistable", &CoaddInputs::isPersistable);
     });
+    wrappers.wrapType(PyCoaddInputsIndex(wrappers.module, "CoaddInputsIndex"), [](auto &mod, auto &cls) {
+        cls.def(py::init<table::ExposureCatalog const &, geom::SkyWcs const &, bool>(), "catalog"_a,
+                "coaddWcs"_a, "includeValidPolygon"_a = false);
+        cls.def(py::init<CoaddInputs const &, geom::SkyWcs const &, bool>(), "inputs"_a, "coaddWcs"_a,
+                "includeValidPolygon"_a = false);
+
+        table::io::python::addPersistableMethods<CoaddInputsIndex>(cls);
+
+        cls.def("getCatalog", &CoaddInputsIndex::getCatalog);
+        cls.def_property_readonly("catalog", &CoaddInputsIndex::getCatalog);
+        cls.def("__len__", &CoaddInputsIndex::size);
+        cls.def("getPolygon", &CoaddInputsIndex::getPolygon, "i"_a);
+        cls.def("findContaining",
+                py::overload_cast<lsst::geom::Point2D const &>(&CoaddInputsIndex::findContaining,
+                                                               py::const_),
+                "position"_a);
+        cls.def("findContaining",
+                py::overload_cast<std::vector<lsst::geom::Point2D> const &>(
+                        &CoaddInputsIndex::findContaining, py::const_),
+                "positions"_a);
+        cls.def("subsetContaining",
+                py::overload_cast<lsst::geom::Point2D const &>(&CoaddInputsIndex::subsetContaining,
+                                                               py::const_),
+                "position"_a);
+        cls.def("subsetContaining",
+                py::overload_cast<std::vector<lsst::geom::Point2D> const &>(
+                        &CoaddInputsIndex::subsetContaining, py::const_),
+                "positions"_a);
+        cls.def("isPersistable", &CoaddInputsIndex::isPersistable);
+    });
 }
 
 }  // namespace image
@@ -141,6 +141,7 @@ void declareExposureInfo(lsst::cpputils::python::WrapperCollection &wrappers) {
 
         declareGenericMethods<std::shared_ptr<typehandling::Storable const>>(cls);
         declareGenericMethodsMerged(cls);
+        cls.def("getUnreadLazyComponents", &ExposureInfo::getUnreadLazyComponents);
 
         cls.attr("KEY_PHOTO_CALIB") = ExposureInfo::KEY_PHOTO_CALIB.getId();
         cls.def("hasPhotoCalib", &ExposureInfo::hasPhotoCalib);
@@ -0,0 +1,81 @@
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <string>
+
+#include "pybind11/pybind11.h"
+#include "ndarray/pybind11.h"
+#include "lsst/cpputils/python.h"
+
+#include "lsst/afw/image/Float16Image.h"
+
+namespace py = pybind11;
+using namespace pybind11::literals;
+
+namespace lsst {
+namespace afw {
+namespace image {
+
+void wrapFloat16Image(lsst::cpputils::python::WrapperCollection &wrappers) {
+    wrappers.addSignatureDependency("lsst.geom");
+    wrappers.addSignatureDependency("lsst.daf.base");
+    wrappers.addSignatureDependency("lsst.afw.fits");
+    wrappers.addSignatureDependency("lsst.afw.image._image");
+    wrappers.wrapType(
+            py::class_<Float16Image, std::shared_ptr<Float16Image>>(wrappers.module, "Float16Image"),
+            [](auto &mod, auto &cls) {
+                cls.def(py::init<lsst::geom::Box2I const &>(), "bbox"_a = lsst::geom::Box2I());
+                cls.def(py::init<Image<float> const &>(), "image"_a);
+                cls.def(py::init<Float16Image const &, lsst::geom::Box2I const &, ImageOrigin>(), "rhs"_a,
+                        "bbox"_a, "origin"_a = PARENT);
+                cls.def("getBBox", &Float16Image::getBBox, "origin"_a = PARENT);
+                cls.def("getWidth", &Float16Image::getWidth);
+                cls.def("getHeight", &Float16Image::getHeight);
+                cls.def("getX0", &Float16Image::getX0);
+                cls.def("getY0", &Float16Image::getY0);
+                cls.def("getXY0", &Float16Image::getXY0);
+                cls.def("getDimensions", &Float16Image::getDimensions);
+                cls.def("getArray", py::overload_cast<>(&Float16Image::getArray));
+                cls.def("get", &Float16Image::get, "point"_a, "origin"_a = PARENT);
+                cls.def("set", &Float16Image::set, "point"_a, "value"_a, "origin"_a = PARENT);
+                cls.def("convertF", &Float16Image::convertF);
+                cls.def("assign", &Float16Image::assign, "image"_a);
+                cls.def("clone", &Float16Image::clone);
+                cls.def("writeFits",
+                        py::overload_cast<std::string const &, daf::base::PropertySet const *,
+                                          std::string const &>(&Float16Image::writeFits, py::const_),
+                        "fileName"_a, "metadata"_a = nullptr, "mode"_a = "w");
+                cls.def("writeFits",
+                        py::overload_cast<std::string const &, fits::ImageWriteOptions const &,
+                                          std::string const &, daf::base::PropertySet const *>(
+                                &Float16Image::writeFits, py::const_),
+                        "fileName"_a, "options"_a, "mode"_a = "w", "header"_a = nullptr);
+                cls.def_static("readFits", &Float16Image::readFits, "fileName"_a,
+                               "hdu"_a = fits::DEFAULT_HDU);
+            });
+}
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
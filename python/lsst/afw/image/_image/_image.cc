@@ -246,7 +246,8 @@ static void declareMask(lsst::cpputils::python::WrapperCollection &wrappers, std
         cls.def("getMaskPlaneDict", &Mask<MaskPixelT>::getMaskPlaneDict);
         cls.def("printMaskPlanes", &Mask<MaskPixelT>::printMaskPlanes);
         cls.def_static("addMaskPlanesToMetadata", Mask<MaskPixelT>::addMaskPlanesToMetadata);
-        cls.def("conformMaskPlanes", &Mask<MaskPixelT>::conformMaskPlanes);
+        cls.def("conformMaskPlanes", &Mask<MaskPixelT>::conformMaskPlanes, "masterPlaneDict"_a,
+                "numThreads"_a = 1);
         cls.def_static("addMaskPlane", (int (*)(const std::string &))Mask<MaskPixelT>::addMaskPlane);
     });
 }
@@ -30,11 +30,13 @@ namespace image {
 
 void wrapImage(lsst::cpputils::python::WrapperCollection &);
 void wrapImageSlice(lsst::cpputils::python::WrapperCollection &);
+void wrapMaskSummary(lsst::cpputils::python::WrapperCollection &);
 
 PYBIND11_MODULE(_imageLib, mod) {
     lsst::cpputils::python::WrapperCollection wrappers(mod, "lsst.afw.image._image");
     wrapImage(wrappers);
     wrapImageSlice(wrappers);
+    wrapMaskSummary(wrappers);
     wrappers.finish();
 }
 }  // namespace image
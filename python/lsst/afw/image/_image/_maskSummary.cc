@@ -0,0 +1,64 @@
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
+#include "lsst/cpputils/python.h"
+
+#include "lsst/afw/image/MaskSummary.h"
+
+namespace py = pybind11;
+
+using namespace py::literals;
+
+namespace lsst {
+namespace afw {
+namespace image {
+
+void wrapMaskSummary(lsst::cpputils::python::WrapperCollection &wrappers) {
+    wrappers.wrapType(py::class_<MaskSummary>(wrappers.module, "MaskSummary"), [](auto &mod, auto &cls) {
+        cls.def(py::init<Mask<MaskPixel> const &, int, int>(), "mask"_a, "tileSize"_a = 0,
+                "numThreads"_a = 1);
+        cls.def("getBBox", py::overload_cast<>(&MaskSummary::getBBox, py::const_));
+        cls.def("getBBox", py::overload_cast<MaskPixel>(&MaskSummary::getBBox, py::const_), "bitmask"_a);
+        cls.def("getMaskPlaneDict", &MaskSummary::getMaskPlaneDict);
+        cls.def("getUnion", &MaskSummary::getUnion);
+        cls.def("getPlaneCount", py::overload_cast<int>(&MaskSummary::getPlaneCount, py::const_), "bit"_a);
+        cls.def("getPlaneCount",
+                py::overload_cast<std::string const &>(&MaskSummary::getPlaneCount, py::const_), "name"_a);
+        cls.def("getPlaneBBox", py::overload_cast<int>(&MaskSummary::getPlaneBBox, py::const_), "bit"_a);
+        cls.def("getPlaneBBox",
+                py::overload_cast<std::string const &>(&MaskSummary::getPlaneBBox, py::const_), "name"_a);
+        cls.def("mayIntersect", &MaskSummary::mayIntersect, "bbox"_a, "bitmask"_a);
+        cls.def("getTileSize", &MaskSummary::getTileSize);
+        cls.def("getTileDimensions", &MaskSummary::getTileDimensions);
+        cls.def("getTileUnion", &MaskSummary::getTileUnion, "ix"_a, "iy"_a);
+        cls.def("getTileBBox", &MaskSummary::getTileBBox, "ix"_a, "iy"_a);
+        cls.def("getTileBBoxes", &MaskSummary::getTileBBoxes, "bitmask"_a);
+    });
+}
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
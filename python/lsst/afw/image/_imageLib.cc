@@ -34,10 +34,13 @@ void wrapDefect(lsst::cpputils::python::WrapperCollection &);
 void wrapExposure(lsst::cpputils::python::WrapperCollection &);
 void wrapExposureInfo(lsst::cpputils::python::WrapperCollection &);
 void wrapFilterLabel(lsst::cpputils::python::WrapperCollection &);
+void wrapFloat16Image(lsst::cpputils::python::WrapperCollection &);
 void wrapImagePca(lsst::cpputils::python::WrapperCollection &);
 void wrapImageUtils(lsst::cpputils::python::WrapperCollection &);
 void wrapPhotoCalib(lsst::cpputils::python::WrapperCollection &);
+void wrapPixelAllocator(lsst::cpputils::python::WrapperCollection &);
 void wrapReaders(lsst::cpputils::python::WrapperCollection &);
+void wrapTiledImage(lsst::cpputils::python::WrapperCollection &);
 void wrapTransmissionCurve(lsst::cpputils::python::WrapperCollection &);
 void wrapVisitInfo(lsst::cpputils::python::WrapperCollection &);
 
@@ -49,10 +52,13 @@ PYBIND11_MODULE(_imageLib, mod) {
     wrapDefect(wrappers);
     wrapExposureInfo(wrappers);
     wrapFilterLabel(wrappers);
+    wrapFloat16Image(wrappers);
     wrapImagePca(wrappers);
     wrapImageUtils(wrappers);
     wrapPhotoCalib(wrappers);
+    wrapPixelAllocator(wrappers);
     wrapReaders(wrappers);
+    wrapTiledImage(wrappers);
     wrapTransmissionCurve(wrappers);
     wrapVisitInfo(wrappers);
     wrappers.finish();
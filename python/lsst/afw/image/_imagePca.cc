@@ -52,6 +52,10 @@ static void declareImagePca(lsst::cpputils::python::WrapperCollection &wrappers,
                 cls.def("getImageList", &ImagePca<ImageT>::getImageList);
                 cls.def("getDimensions", &ImagePca<ImageT>::getDimensions);
                 cls.def("getMean", &ImagePca<ImageT>::getMean);
+                cls.def("setNumThreads", &ImagePca<ImageT>::setNumThreads, "numThreads"_a);
+                cls.def("getNumThreads", &ImagePca<ImageT>::getNumThreads);
+                cls.def("setIncremental", &ImagePca<ImageT>::setIncremental, "incremental"_a);
+                cls.def("isIncremental", &ImagePca<ImageT>::isIncremental);
                 cls.def("analyze", &ImagePca<ImageT>::analyze);
                 cls.def("updateBadPixels", &ImagePca<ImageT>::updateBadPixels);
                 cls.def("getEigenValues", &ImagePca<ImageT>::getEigenValues);
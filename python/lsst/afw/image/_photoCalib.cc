@@ -173,6 +173,10 @@ void declarePhotoCalib(lsst::cpputils::python::WrapperCollection &wrappers) {
                         "includeScaleUncertainty"_a = true);
                 cls.def("uncalibrateImage", &PhotoCalib::uncalibrateImage, "maskedImage"_a,
                         "includeScaleUncertainty"_a = true);
+                cls.def("calibrateImageInPlace", &PhotoCalib::calibrateImageInPlace, "maskedImage"_a,
+                        "includeScaleUncertainty"_a = true, "tolerance"_a = 0.0, "numThreads"_a = 1);
+                cls.def("uncalibrateImageInPlace", &PhotoCalib::uncalibrateImageInPlace, "maskedImage"_a,
+                        "includeScaleUncertainty"_a = true, "tolerance"_a = 0.0, "numThreads"_a = 1);
 
                 cls.def("calibrateCatalog",
                         py::overload_cast<afw::table::SourceCatalog const &,
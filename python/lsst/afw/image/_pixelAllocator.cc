@@ -0,0 +1,102 @@
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include <optional>
+
+#include "pybind11/pybind11.h"
+#include "lsst/cpputils/python.h"
+
+#include "lsst/afw/image/PixelAllocator.h"
+
+namespace py = pybind11;
+using namespace pybind11::literals;
+
+namespace lsst {
+namespace afw {
+namespace image {
+namespace {
+
+// Context manager that installs an allocator on __enter__ and restores the previous one on __exit__,
+// since the lifetime of a Python object is not a scope.
+class PythonScopedPixelAllocator {
+public:
+    explicit PythonScopedPixelAllocator(std::shared_ptr<PixelAllocator> allocator)
+            : _allocator(std::move(allocator)) {}
+
+    void enter() {
+        if (_scope) {
+            throw py::value_error("ScopedPixelAllocator is already in use");
+        }
+        _scope.emplace(_allocator);
+    }
+
+    void exit() { _scope.reset(); }
+
+private:
+    std::shared_ptr<PixelAllocator> _allocator;
+    std::optional<ScopedPixelAllocator> _scope;
+};
+
+}  // namespace
+
+void wrapPixelAllocator(lsst::cpputils::python::WrapperCollection &wrappers) {
+    wrappers.wrapType(py::class_<PixelAllocator, std::shared_ptr<PixelAllocator>>(wrappers.module,
+                                                                                "PixelAllocator"),
+                      [](auto &mod, auto &cls) { cls.attr("ALIGNMENT") = PixelAllocator::ALIGNMENT; });
+    wrappers.wrapType(
+            py::class_<PooledPixelAllocator, std::shared_ptr<PooledPixelAllocator>, PixelAllocator>(
+                    wrappers.module, "PooledPixelAllocator"),
+            [](auto &mod, auto &cls) {
+                cls.def(py::init<std::size_t, bool>(), "maxCachedBytes"_a = std::size_t(1) << 30,
+                        "useHugePages"_a = false);
+                cls.def("getStatistics", &PooledPixelAllocator::getStatistics);
+                cls.def("clear", &PooledPixelAllocator::clear);
+                cls.attr("MIN_POOLED_BYTES") = PooledPixelAllocator::MIN_POOLED_BYTES;
+                py::class_<PooledPixelAllocator::Statistics>(cls, "Statistics")
+                        .def_readonly("hits", &PooledPixelAllocator::Statistics::hits)
+                        .def_readonly("misses", &PooledPixelAllocator::Statistics::misses)
+                        .def_readonly("cachedBytes", &PooledPixelAllocator::Statistics::cachedBytes);
+            });
+    wrappers.wrapType(
+            py::class_<PythonScopedPixelAllocator>(wrappers.module, "ScopedPixelAllocator"),
+            [](auto &mod, auto &cls) {
+                cls.def(py::init<std::shared_ptr<PixelAllocator>>(), "allocator"_a);
+                cls.def(
+                        "__enter__",
+                        [](PythonScopedPixelAllocator &self) -> PythonScopedPixelAllocator & {
+                            self.enter();
+                            return self;
+                        },
+                        py::return_value_policy::reference_internal);
+                cls.def("__exit__", [](PythonScopedPixelAllocator &self, py::args) { self.exit(); });
+            });
+    wrappers.wrap([](auto &mod) {
+        mod.def("getPixelAllocator", &getPixelAllocator);
+        mod.def("setDefaultPixelAllocator", &setDefaultPixelAllocator, "allocator"_a);
+    });
+}
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
@@ -28,11 +28,13 @@
 #include "ndarray/pybind11.h"
 
 #include "lsst/cpputils/python/TemplateInvoker.h"
+#include "lsst/afw/fitsByteRange.h"
 #include "lsst/afw/image/ImageBaseFitsReader.h"
 #include "lsst/afw/image/ImageFitsReader.h"
 #include "lsst/afw/image/MaskFitsReader.h"
 #include "lsst/afw/image/MaskedImageFitsReader.h"
 #include "lsst/afw/image/ExposureFitsReader.h"
+#include "lsst/afw/image/ExposureCutoutReader.h"
 #include "lsst/afw/geom/SkyWcs.h"
 #include "lsst/afw/geom/polygon/Polygon.h"
 #include "lsst/afw/detection/Psf.h"
@@ -58,6 +60,7 @@ using PyImageFitsReader = py::class_<ImageFitsReader, std::shared_ptr<ImageFitsR
 using PyMaskFitsReader = py::class_<MaskFitsReader, std::shared_ptr<MaskFitsReader>>;
 using PyMaskedImageFitsReader = py::class_<MaskedImageFitsReader, std::shared_ptr<MaskedImageFitsReader>>;
 using PyExposureFitsReader = py::class_<ExposureFitsReader, std::shared_ptr<ExposureFitsReader>>;
+using PyExposureCutoutReader = py::class_<ExposureCutoutReader, std::shared_ptr<ExposureCutoutReader>>;
 
 // Declare attributes common to all FitsReaders.  Excludes constructors
 // because ExposureFitsReader's don't take an HDU argument.
@@ -74,6 +77,7 @@ template <typename Class, typename... Args>
 void declareSinglePlaneMethods(py::class_<Class, Args...> &cls) {
     cls.def(py::init<std::string const &, int>(), "fileName"_a, "hdu"_a = fits::DEFAULT_HDU);
     cls.def(py::init<fits::MemFileManager &, int>(), "manager"_a, "hdu"_a = fits::DEFAULT_HDU);
+    cls.def(py::init<std::shared_ptr<fits::ByteRangeCache>, int>(), "cache"_a, "hdu"_a = fits::DEFAULT_HDU);
     cls.def("readMetadata", &Class::readMetadata);
     cls.def("readDType", [](Class &self) { return py::dtype(self.readDType()); });
     cls.def("getHdu", &Class::getHdu);
@@ -87,6 +91,7 @@ void declareSinglePlaneMethods(py::class_<Class, Args...> &cls) {
                 }
                 return cpputils::python::TemplateInvoker().apply(
                         [&](auto t) {
+                            py::gil_scoped_release release;
                             return self.template readArray<decltype(t)>(bbox, origin, allowUnsafe);
                         },
                         py::dtype(dtype),
@@ -95,6 +100,19 @@ void declareSinglePlaneMethods(py::class_<Class, Args...> &cls) {
             },
             "bbox"_a = lsst::geom::Box2I(), "origin"_a = PARENT, "allowUnsafe"_a = false,
             "dtype"_a = py::none());
+    cls.def(
+            "mapArray",
+            [](Class &self, lsst::geom::Box2I const &bbox, ImageOrigin origin, py::object dtype) {
+                if (dtype.is(py::none())) {
+                    dtype = py::dtype(self.readDType());
+                }
+                return cpputils::python::TemplateInvoker().apply(
+                        [&](auto t) { return self.template mapArray<decltype(t)>(bbox, origin); },
+                        py::dtype(dtype),
+                        cpputils::python::TemplateInvoker::Tag<std::uint16_t, int, float, double,
+                                                            std::uint64_t>());
+            },
+            "bbox"_a = lsst::geom::Box2I(), "origin"_a = PARENT, "dtype"_a = py::none());
 }
 
 // Declare attributes shared by MaskedImageFitsReader and MaskedImageFitsReader.
@@ -112,6 +130,7 @@ void declareMultiPlaneMethods(py::class_<Class, Args...> &cls) {
                 }
                 return cpputils::python::TemplateInvoker().apply(
                         [&](auto t) {
+                            py::gil_scoped_release release;
                             return self.template readImage<decltype(t)>(bbox, origin, allowUnsafe);
                         },
                         py::dtype(dtype),
@@ -129,6 +148,7 @@ void declareMultiPlaneMethods(py::class_<Class, Args...> &cls) {
                 }
                 return cpputils::python::TemplateInvoker().apply(
                         [&](auto t) {
+                            py::gil_scoped_release release;
                             return self.template readImageArray<decltype(t)>(bbox, origin, allowUnsafe);
                         },
                         py::dtype(dtype),
@@ -146,6 +166,7 @@ void declareMultiPlaneMethods(py::class_<Class, Args...> &cls) {
                 }
                 return cpputils::python::TemplateInvoker().apply(
                         [&](auto t) {
+                            py::gil_scoped_release release;
                             return self.template readMask<decltype(t)>(bbox, origin, conformMasks,
                                                                        allowUnsafe);
                         },
@@ -162,6 +183,7 @@ void declareMultiPlaneMethods(py::class_<Class, Args...> &cls) {
                 }
                 return cpputils::python::TemplateInvoker().apply(
                         [&](auto t) {
+                            py::gil_scoped_release release;
                             return self.template readMaskArray<decltype(t)>(bbox, origin, allowUnsafe);
                         },
                         py::dtype(dtype), cpputils::python::TemplateInvoker::Tag<MaskPixel>());
@@ -177,6 +199,7 @@ void declareMultiPlaneMethods(py::class_<Class, Args...> &cls) {
                 }
                 return cpputils::python::TemplateInvoker().apply(
                         [&](auto t) {
+                            py::gil_scoped_release release;
                             return self.template readVariance<decltype(t)>(bbox, origin, allowUnsafe);
                         },
                         py::dtype(dtype), cpputils::python::TemplateInvoker::Tag<VariancePixel>());
@@ -192,6 +215,7 @@ void declareMultiPlaneMethods(py::class_<Class, Args...> &cls) {
                 }
                 return cpputils::python::TemplateInvoker().apply(
                         [&](auto t) {
+                            py::gil_scoped_release release;
                             return self.template readVarianceArray<decltype(t)>(bbox, origin, allowUnsafe);
                         },
                         py::dtype(dtype), cpputils::python::TemplateInvoker::Tag<VariancePixel>());
@@ -212,13 +236,29 @@ void declareImageFitsReader(lsst::cpputils::python::WrapperCollection &wrappers)
                         dtype = py::dtype(self.readDType());
                     }
                     return cpputils::python::TemplateInvoker().apply(
-                            [&](auto t) { return self.read<decltype(t)>(bbox, origin, allowUnsafe); },
+                            [&](auto t) {
+                                py::gil_scoped_release release;
+                                return self.read<decltype(t)>(bbox, origin, allowUnsafe);
+                            },
                             py::dtype(dtype),
                             cpputils::python::TemplateInvoker::Tag<std::uint16_t, int, float, double,
                                                                 std::uint64_t>());
                 },
                 "bbox"_a = lsst::geom::Box2I(), "origin"_a = PARENT, "allowUnsafe"_a = false,
                 "dtype"_a = py::none());
+        cls.def(
+                "map",
+                [](ImageFitsReader &self, lsst::geom::Box2I const &bbox, ImageOrigin origin,
+                   py::object dtype) {
+                    if (dtype.is(py::none())) {
+                        dtype = py::dtype(self.readDType());
+                    }
+                    return cpputils::python::TemplateInvoker().apply(
+                            [&](auto t) { return self.map<decltype(t)>(bbox, origin); }, py::dtype(dtype),
+                            cpputils::python::TemplateInvoker::Tag<std::uint16_t, int, float, double,
+                                                                std::uint64_t>());
+                },
+                "bbox"_a = lsst::geom::Box2I(), "origin"_a = PARENT, "dtype"_a = py::none());
     });
 }
 
@@ -235,6 +275,7 @@ void declareMaskFitsReader(lsst::cpputils::python::WrapperCollection &wrappers)
                     }
                     return cpputils::python::TemplateInvoker().apply(
                             [&](auto t) {
+                                py::gil_scoped_release release;
                                 return self.read<decltype(t)>(bbox, origin, conformMasks, allowUnsafe);
                             },
                             py::dtype(dtype), cpputils::python::TemplateInvoker::Tag<MaskPixel>());
@@ -250,6 +291,8 @@ void declareMaskedImageFitsReader(lsst::cpputils::python::WrapperCollection &wra
                                                                                             auto &cls) {
         cls.def(py::init<std::string const &, int>(), "fileName"_a, "hdu"_a = fits::DEFAULT_HDU);
         cls.def(py::init<fits::MemFileManager &, int>(), "manager"_a, "hdu"_a = fits::DEFAULT_HDU);
+        cls.def(py::init<std::shared_ptr<fits::ByteRangeCache>, int>(), "cache"_a,
+                "hdu"_a = fits::DEFAULT_HDU);
         declareCommonMethods(cls);
         declareMultiPlaneMethods(cls);
         cls.def("readPrimaryMetadata", &MaskedImageFitsReader::readPrimaryMetadata);
@@ -265,6 +308,7 @@ void declareMaskedImageFitsReader(lsst::cpputils::python::WrapperCollection &wra
                     }
                     return cpputils::python::TemplateInvoker().apply(
                             [&](auto t) {
+                                py::gil_scoped_release release;
                                 return self.read<decltype(t)>(bbox, origin, conformMasks, allowUnsafe);
                             },
                             py::dtype(dtype),
@@ -276,27 +320,44 @@ void declareMaskedImageFitsReader(lsst::cpputils::python::WrapperCollection &wra
     });
 }
 
+// Wrap an ExposureFitsReader getter that may need the archive so that it
+// first waits for any prefetch without holding the GIL, which the background
+// read may need (e.g. to forward log messages to Python).
+template <typename Result, typename... Args>
+auto afterPrefetch(Result (ExposureFitsReader::*getter)(Args...)) {
+    return [getter](ExposureFitsReader &self, Args... args) {
+        {
+            py::gil_scoped_release release;
+            self.waitForPrefetch();
+        }
+        return (self.*getter)(args...);
+    };
+}
+
 void declareExposureFitsReader(lsst::cpputils::python::WrapperCollection &wrappers) {
     wrappers.wrapType(PyExposureFitsReader(wrappers.module, "ExposureFitsReader"), [](auto &mod, auto &cls) {
         cls.def(py::init<std::string const &>(), "fileName"_a);
         cls.def(py::init<fits::MemFileManager &>(), "manager"_a);
+        cls.def(py::init<std::shared_ptr<fits::ByteRangeCache>>(), "cache"_a);
         declareCommonMethods(cls);
         declareMultiPlaneMethods(cls);
         cls.def("readSerializationVersion", &ExposureFitsReader::readSerializationVersion);
         cls.def("readExposureId", &ExposureFitsReader::readExposureId);
         cls.def("readMetadata", &ExposureFitsReader::readMetadata);
-        cls.def("readWcs", &ExposureFitsReader::readWcs);
-        cls.def("readFilter", &ExposureFitsReader::readFilter);
-        cls.def("readPhotoCalib", &ExposureFitsReader::readPhotoCalib);
-        cls.def("readPsf", &ExposureFitsReader::readPsf);
-        cls.def("readValidPolygon", &ExposureFitsReader::readValidPolygon);
-        cls.def("readApCorrMap", &ExposureFitsReader::readApCorrMap);
-        cls.def("readCoaddInputs", &ExposureFitsReader::readCoaddInputs);
+        cls.def("prefetch", &ExposureFitsReader::prefetch);
+        cls.def("readWcs", afterPrefetch(&ExposureFitsReader::readWcs));
+        cls.def("readFilter", afterPrefetch(&ExposureFitsReader::readFilter));
+        cls.def("readPhotoCalib", afterPrefetch(&ExposureFitsReader::readPhotoCalib));
+        cls.def("readPsf", afterPrefetch(&ExposureFitsReader::readPsf));
+        cls.def("readValidPolygon", afterPrefetch(&ExposureFitsReader::readValidPolygon));
+        cls.def("readApCorrMap", afterPrefetch(&ExposureFitsReader::readApCorrMap));
+        cls.def("readCoaddInputs", afterPrefetch(&ExposureFitsReader::readCoaddInputs));
         cls.def("readVisitInfo", &ExposureFitsReader::readVisitInfo);
-        cls.def("readTransmissionCurve", &ExposureFitsReader::readTransmissionCurve);
-        cls.def("readComponent", &ExposureFitsReader::readComponent);
-        cls.def("readDetector", &ExposureFitsReader::readDetector);
-        cls.def("readExposureInfo", &ExposureFitsReader::readExposureInfo);
+        cls.def("readTransmissionCurve", afterPrefetch(&ExposureFitsReader::readTransmissionCurve));
+        cls.def("readComponent", afterPrefetch(&ExposureFitsReader::readComponent));
+        cls.def("readDetector", afterPrefetch(&ExposureFitsReader::readDetector));
+        cls.def("readExposureInfo", afterPrefetch(&ExposureFitsReader::readExposureInfo),
+                "lazyComponents"_a = false);
         cls.def(
                 "readMaskedImage",
                 [](ExposureFitsReader &self, lsst::geom::Box2I const &bbox, ImageOrigin origin,
@@ -306,6 +367,7 @@ void declareExposureFitsReader(lsst::cpputils::python::WrapperCollection &wrappe
                     }
                     return cpputils::python::TemplateInvoker().apply(
                             [&](auto t) {
+                                py::gil_scoped_release release;
                                 return self.readMaskedImage<decltype(t)>(bbox, origin, conformMasks,
                                                                          allowUnsafe);
                             },
@@ -318,20 +380,66 @@ void declareExposureFitsReader(lsst::cpputils::python::WrapperCollection &wrappe
         cls.def(
                 "read",
                 [](ExposureFitsReader &self, lsst::geom::Box2I const &bbox, ImageOrigin origin,
-                   bool conformMasks, bool allowUnsafe, py::object dtype) {
+                   bool conformMasks, bool allowUnsafe, py::object dtype, bool lazyComponents) {
                     if (dtype.is(py::none())) {
                         dtype = py::dtype(self.readImageDType());
                     }
                     return cpputils::python::TemplateInvoker().apply(
                             [&](auto t) {
-                                return self.read<decltype(t)>(bbox, origin, conformMasks, allowUnsafe);
+                                py::gil_scoped_release release;
+                                return self.read<decltype(t)>(bbox, origin, conformMasks, allowUnsafe,
+                                                              lazyComponents);
                             },
                             py::dtype(dtype),
                             cpputils::python::TemplateInvoker::Tag<std::uint16_t, int, float, double,
                                                                 std::uint64_t>());
                 },
                 "bbox"_a = lsst::geom::Box2I(), "origin"_a = PARENT, "conformMasks"_a = false,
-                "allowUnsafe"_a = false, "dtype"_a = py::none());
+                "allowUnsafe"_a = false, "dtype"_a = py::none(), "lazyComponents"_a = false);
+    });
+}
+
+// Wrap ExposureCutoutReader::read (asExposures) or readMaskedImages, whose
+// dtype defaults to that of the first file.  The GIL is released while the
+// files are read, as reads on other threads may need it (e.g. to forward log
+// messages).
+template <bool asExposures>
+auto readCutouts() {
+    return [](ExposureCutoutReader &self, std::vector<std::string> const &fileNames,
+              std::vector<lsst::geom::Box2I> const &bboxes, ImageOrigin origin, bool conformMasks,
+              bool allowUnsafe, py::object dtype) {
+        if (dtype.is(py::none())) {
+            dtype = fileNames.empty() ? py::dtype::of<float>()
+                                      : py::dtype(self.getReader(fileNames.front())->readImageDType());
+        }
+        return cpputils::python::TemplateInvoker().apply(
+                [&](auto t) {
+                    py::gil_scoped_release release;
+                    if constexpr (asExposures) {
+                        return self.read<decltype(t)>(fileNames, bboxes, origin, conformMasks, allowUnsafe);
+                    } else {
+                        return self.readMaskedImages<decltype(t)>(fileNames, bboxes, origin, conformMasks,
+                                                                  allowUnsafe);
+                    }
+                },
+                py::dtype(dtype),
+                cpputils::python::TemplateInvoker::Tag<std::uint16_t, int, float, double, std::uint64_t>());
+    };
+}
+
+void declareExposureCutoutReader(lsst::cpputils::python::WrapperCollection &wrappers) {
+    wrappers.wrapType(PyExposureCutoutReader(wrappers.module, "ExposureCutoutReader"), [](auto &mod,
+                                                                                          auto &cls) {
+        cls.def(py::init<int, int>(), "maxOpenFiles"_a = 16, "numThreads"_a = 1);
+        cls.def("read", readCutouts<true>(), "fileNames"_a, "bboxes"_a, "origin"_a = PARENT,
+                "conformMasks"_a = false, "allowUnsafe"_a = false, "dtype"_a = py::none());
+        cls.def("readMaskedImages", readCutouts<false>(), "fileNames"_a, "bboxes"_a, "origin"_a = PARENT,
+                "conformMasks"_a = false, "allowUnsafe"_a = false, "dtype"_a = py::none());
+        cls.def("getReader", &ExposureCutoutReader::getReader, "fileName"_a);
+        cls.def("getMaxOpenFiles", &ExposureCutoutReader::getMaxOpenFiles);
+        cls.def("getNumThreads", &ExposureCutoutReader::getNumThreads);
+        cls.def("getNumOpenFiles", &ExposureCutoutReader::getNumOpenFiles);
+        cls.def("clear", &ExposureCutoutReader::clear);
     });
 }
 }  // namespace
@@ -345,6 +453,7 @@ void wrapReaders(lsst::cpputils::python::WrapperCollection &wrappers) {
     declareMaskFitsReader(wrappers);
     declareMaskedImageFitsReader(wrappers);
     declareExposureFitsReader(wrappers);
+    declareExposureCutoutReader(wrappers);
 }
 }  // namespace image
 }  // namespace afw
@@ -0,0 +1,109 @@
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "pybind11/pybind11.h"
+#include "pybind11/functional.h"
+#include "pybind11/stl.h"
+#include "lsst/cpputils/python.h"
+
+#include "lsst/afw/image/TiledImage.h"
+
+namespace py = pybind11;
+using namespace pybind11::literals;
+
+namespace lsst {
+namespace afw {
+namespace image {
+namespace {
+
+template <typename PixelT>
+void declareTiledImage(lsst::cpputils::python::WrapperCollection &wrappers, std::string const &suffix) {
+    using Class = TiledImage<PixelT>;
+    wrappers.wrapType(
+            py::class_<Class, std::shared_ptr<Class>>(wrappers.module, ("TiledImage" + suffix).c_str()),
+            [](auto &mod, auto &cls) {
+                // Python loaders return non-const Images, which pybind11 holds more naturally
+                cls.def(py::init([](lsst::geom::Box2I const &bbox, std::vector<lsst::geom::Box2I> tileBoxes,
+                                    std::function<std::shared_ptr<Image<PixelT>>(std::size_t)> loader,
+                                    std::size_t cacheCapacity, PixelT padValue) {
+                            return std::make_shared<Class>(
+                                    bbox, std::move(tileBoxes),
+                                    [loader](std::size_t i) -> std::shared_ptr<Image<PixelT> const> {
+                                        return loader(i);
+                                    },
+                                    cacheCapacity, padValue);
+                        }),
+                        "bbox"_a, "tileBoxes"_a, "loader"_a,
+                        "cacheCapacity"_a = Class::DEFAULT_CACHE_CAPACITY, "padValue"_a = 0);
+                cls.def(py::init<Class const &, lsst::geom::Box2I const &, ImageOrigin>(), "rhs"_a, "bbox"_a,
+                        "origin"_a = PARENT);
+                cls.def_static("readFits", &Class::readFits, "fileNames"_a, "hdu"_a = fits::DEFAULT_HDU,
+                               "cacheCapacity"_a = Class::DEFAULT_CACHE_CAPACITY, "padValue"_a = 0);
+                cls.def("getBBox", &Class::getBBox, "origin"_a = PARENT);
+                cls.def("getWidth", &Class::getWidth);
+                cls.def("getHeight", &Class::getHeight);
+                cls.def("getX0", &Class::getX0);
+                cls.def("getY0", &Class::getY0);
+                cls.def("getXY0", &Class::getXY0);
+                cls.def("getDimensions", &Class::getDimensions);
+                cls.def("getTileCount", &Class::getTileCount);
+                cls.def("getTileBBox", [](Class const &self, std::size_t i) {
+                    if (i >= self.getTileCount()) {
+                        throw py::index_error("Tile index out of range");
+                    }
+                    return self.getTileBBox(i);
+                });
+                cls.def("getPadValue", &Class::getPadValue);
+                cls.def("get", &Class::get, "point"_a, "origin"_a = PARENT);
+                cls.def("read", py::overload_cast<lsst::geom::Box2I const &, ImageOrigin>(&Class::read,
+                                                                                          py::const_),
+                        "bbox"_a, "origin"_a = PARENT);
+                cls.def("read", py::overload_cast<>(&Class::read, py::const_));
+                // Release the GIL so that other threads can call Python loaders and functions
+                cls.def("forEachBlock", &Class::forEachBlock, "blockSize"_a, "halo"_a, "func"_a,
+                        "numThreads"_a = 1, py::call_guard<py::gil_scoped_release>());
+                cls.def("getCacheCapacity", &Class::getCacheCapacity);
+                cls.def("setCacheCapacity", &Class::setCacheCapacity, "capacity"_a);
+                cls.def("getTileLoadCount", &Class::getTileLoadCount);
+            });
+}
+
+}  // namespace
+
+void wrapTiledImage(lsst::cpputils::python::WrapperCollection &wrappers) {
+    wrappers.addSignatureDependency("lsst.geom");
+    wrappers.addSignatureDependency("lsst.afw.image._image");
+    declareTiledImage<std::uint16_t>(wrappers, "U");
+    declareTiledImage<int>(wrappers, "I");
+    declareTiledImage<float>(wrappers, "F");
+    declareTiledImage<double>(wrappers, "D");
+}
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
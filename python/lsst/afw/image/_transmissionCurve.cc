@@ -26,6 +26,7 @@
 #include "lsst/cpputils/python.h"
 
 #include <memory>
+#include <vector>
 
 #include "ndarray/pybind11.h"
 
@@ -70,6 +71,18 @@ void wrapTransmissionCurve(lsst::cpputils::python::WrapperCollection &wrappers)
                         lsst::geom::Point2D const &, ndarray::Array<double const, 1, 1> const &) const) &
                         TransmissionCurve::sampleAt,
                 "position"_a, "wavelengths"_a);
+        cls.def("sampleAt",
+                (void (TransmissionCurve::*)(std::vector<lsst::geom::Point2D> const &,
+                                             ndarray::Array<double const, 1, 1> const &,
+                                             ndarray::Array<double, 2, 1> const &) const) &
+                        TransmissionCurve::sampleAt,
+                "positions"_a, "wavelengths"_a, "out"_a);
+        cls.def("sampleAt",
+                (ndarray::Array<double, 2, 2>(TransmissionCurve::*)(
+                        std::vector<lsst::geom::Point2D> const &, ndarray::Array<double const, 1, 1> const &)
+                         const) &
+                        TransmissionCurve::sampleAt,
+                "positions"_a, "wavelengths"_a);
     });
 }
 
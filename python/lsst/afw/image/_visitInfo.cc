@@ -22,6 +22,7 @@
  */
 
 #include "pybind11/pybind11.h"
+#include "ndarray/pybind11.h"
 #include "lsst/cpputils/python.h"
 
 #include <memory>
@@ -115,6 +116,12 @@ void declareVisitInfo(lsst::cpputils::python::WrapperCollection &wrappers) {
                 cls.def("getObservationReason", &VisitInfo::getObservationReason);
                 cls.def("getObject", &VisitInfo::getObject);
                 cls.def("getHasSimulatedContent", &VisitInfo::getHasSimulatedContent);
+                cls.def("getAltitude", &VisitInfo::getAltitude, "ra"_a, "dec"_a);
+                cls.def("getParAngle", &VisitInfo::getParAngle, "ra"_a, "dec"_a);
+                cls.def("getAirmass", &VisitInfo::getAirmass, "ra"_a, "dec"_a);
+                cls.def("getRefraction", &VisitInfo::getRefraction, "wavelength"_a, "ra"_a, "dec"_a);
+                cls.def("getDifferentialRefraction", &VisitInfo::getDifferentialRefraction, "wavelength"_a,
+                        "wavelengthRef"_a, "ra"_a, "dec"_a);
 
                 /* readonly property accessors */
                 cls.def_property_readonly("exposureTime", &VisitInfo::getExposureTime);
@@ -43,7 +43,15 @@ void declareApproximate(lsst::cpputils::python::WrapperCollection &wrappers, std
     wrappers.wrapType(
             py::class_<Class, std::shared_ptr<Class>>(wrappers.module, ("Approximate" + suffix).c_str()),
             [](auto &mod, auto &cls) {
-                cls.def("getImage", &Class::getImage, "orderX"_a = -1, "orderY"_a = -1);
+                cls.def("getImage",
+                        (std::shared_ptr<image::Image<typename Class::OutPixelT>>(Class::*)(int, int) const) &
+                                Class::getImage,
+                        "orderX"_a = -1, "orderY"_a = -1);
+                cls.def("getImage",
+                        (std::shared_ptr<image::Image<typename Class::OutPixelT>>(Class::*)(
+                                lsst::geom::Box2I const &, int, int) const) &
+                                Class::getImage,
+                        "bbox"_a, "orderX"_a = -1, "orderY"_a = -1);
                 cls.def("getMaskedImage", &Class::getMaskedImage, "orderX"_a = -1, "orderY"_a = -1);
 
                 mod.def("makeApproximate",
@@ -70,6 +78,9 @@ void declareApproximate(lsst::cpputils::python::WrapperCollection &wrappers) {
                                   cls.def("setOrderY", &ApproximateControl::setOrderY);
                                   cls.def("getWeighting", &ApproximateControl::getWeighting);
                                   cls.def("setWeighting", &ApproximateControl::setWeighting);
+                                  cls.def("getNumThreads", &ApproximateControl::getNumThreads);
+                                  cls.def("setNumThreads", &ApproximateControl::setNumThreads,
+                                          "numThreads"_a);
                               });
     wrappers.wrapType(py::enum_<ApproximateControl::Style>(control, "Style"), [](auto &mod, auto &enm) {
         enm.value("UNKNOWN", ApproximateControl::Style::UNKNOWN);
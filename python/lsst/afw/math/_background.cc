@@ -23,6 +23,7 @@
 #include <pybind11/pybind11.h>
 #include <lsst/cpputils/python.h>
 #include <pybind11/stl.h>
+#include "ndarray/pybind11.h"
 
 #include "lsst/afw/image/Image.h"
 #include "lsst/afw/image/MaskedImage.h"
@@ -115,6 +116,8 @@ void declareBackground(lsst::cpputils::python::WrapperCollection &wrappers) {
                 (void (BackgroundControl::*)(std::string const &)) & BackgroundControl::setUndersampleStyle);
         cls.def("getNxSample", &BackgroundControl::getNxSample);
         cls.def("getNySample", &BackgroundControl::getNySample);
+        cls.def("getNumThreads", &BackgroundControl::getNumThreads);
+        cls.def("setNumThreads", &BackgroundControl::setNumThreads, "numThreads"_a);
         cls.def("getInterpStyle", &BackgroundControl::getInterpStyle);
         cls.def("getUndersampleStyle", &BackgroundControl::getUndersampleStyle);
         cls.def("getStatisticsControl", (std::shared_ptr<StatisticsControl>(BackgroundControl::*)()) &
@@ -153,11 +156,84 @@ void declareBackground(lsst::cpputils::python::WrapperCollection &wrappers) {
         cls.def("__isub__", &BackgroundMI::operator-=);
 
         /* Members */
+        cls.def("update",
+                (void (BackgroundMI::*)(image::Image<float> const &, lsst::geom::Box2I const &)) &
+                        BackgroundMI::update,
+                "img"_a, "changedBBox"_a);
+        cls.def("update",
+                (void (BackgroundMI::*)(image::MaskedImage<float> const &, lsst::geom::Box2I const &)) &
+                        BackgroundMI::update,
+                "img"_a, "changedBBox"_a);
+        cls.def("update",
+                (void (BackgroundMI::*)(image::Image<float> const &,
+                                        ndarray::Array<bool const, 2, 1> const &)) &
+                        BackgroundMI::update,
+                "img"_a, "dirtyCells"_a);
+        cls.def("update",
+                (void (BackgroundMI::*)(image::MaskedImage<float> const &,
+                                        ndarray::Array<bool const, 2, 1> const &)) &
+                        BackgroundMI::update,
+                "img"_a, "dirtyCells"_a);
         cls.def("getStatsImage", &BackgroundMI::getStatsImage);
         cls.def("getImageBBox", &BackgroundMI::getImageBBox);
 
         // Yes, really only float
     });
+
+    using PyBackgroundImageView = py::class_<BackgroundImageView>;
+    wrappers.wrapType(PyBackgroundImageView(wrappers.module, "BackgroundImageView"),
+                      [](auto &mod, auto &cls) {
+                          cls.def(py::init<std::shared_ptr<BackgroundMI const>>(), "background"_a);
+                          cls.def(py::init<std::shared_ptr<BackgroundMI const>, Interpolate::Style const,
+                                           UndersampleStyle const>(),
+                                  "background"_a, "interpStyle"_a, "undersampleStyle"_a = THROW_EXCEPTION);
+
+                          cls.def("getBBox", &BackgroundImageView::getBBox);
+                          cls.def("evaluate", &BackgroundImageView::evaluate, "bbox"_a);
+                          cls.def("subtractFrom",
+                                  (void (BackgroundImageView::*)(image::Image<float> &) const) &
+                                          BackgroundImageView::subtractFrom<float>,
+                                  "img"_a);
+                          cls.def("subtractFrom",
+                                  (void (BackgroundImageView::*)(image::Image<double> &) const) &
+                                          BackgroundImageView::subtractFrom<double>,
+                                  "img"_a);
+                          cls.def("subtractFrom",
+                                  (void (BackgroundImageView::*)(image::MaskedImage<float> &) const) &
+                                          BackgroundImageView::subtractFrom<float>,
+                                  "mimg"_a);
+                          cls.def("subtractFrom",
+                                  (void (BackgroundImageView::*)(image::MaskedImage<double> &) const) &
+                                          BackgroundImageView::subtractFrom<double>,
+                                  "mimg"_a);
+                          cls.def("getNumThreads", &BackgroundImageView::getNumThreads);
+                      });
+
+    using PyBackgroundListView = py::class_<BackgroundListView>;
+    wrappers.wrapType(PyBackgroundListView(wrappers.module, "BackgroundListView"), [](auto &mod, auto &cls) {
+        cls.def(py::init<std::vector<BackgroundImageView>>(), "components"_a);
+
+        cls.def("getBBox", &BackgroundListView::getBBox);
+        cls.def("__len__", &BackgroundListView::size);
+        cls.def("evaluate", &BackgroundListView::evaluate, "bbox"_a,
+                py::call_guard<py::gil_scoped_release>());
+        cls.def("subtractFrom",
+                (void (BackgroundListView::*)(image::Image<float> &) const) &
+                        BackgroundListView::subtractFrom<float>,
+                "img"_a, py::call_guard<py::gil_scoped_release>());
+        cls.def("subtractFrom",
+                (void (BackgroundListView::*)(image::Image<double> &) const) &
+                        BackgroundListView::subtractFrom<double>,
+                "img"_a, py::call_guard<py::gil_scoped_release>());
+        cls.def("subtractFrom",
+                (void (BackgroundListView::*)(image::MaskedImage<float> &) const) &
+                        BackgroundListView::subtractFrom<float>,
+                "mimg"_a, py::call_guard<py::gil_scoped_release>());
+        cls.def("subtractFrom",
+                (void (BackgroundListView::*)(image::MaskedImage<double> &) const) &
+                        BackgroundListView::subtractFrom<double>,
+                "mimg"_a, py::call_guard<py::gil_scoped_release>());
+    });
 }
 void wrapBackground(lsst::cpputils::python::WrapperCollection &wrappers) {
     // FIXME: review when lsst.afw.image is converted to python wrappers
@@ -27,6 +27,7 @@ import lsst.geom
 import lsst.afw.image as afwImage
 from lsst.afw.fits import MemFileManager, reduceToFits, Fits
 from ._math import Interpolate, ApproximateControl, BackgroundMI, UndersampleStyle
+from ._math import BackgroundImageView, BackgroundListView
 
 
 class BackgroundList:
@@ -210,26 +211,51 @@ class BackgroundList:
 
         return self
 
-    def getImage(self):
-        """Compute and return a full-resolution image from our list of
-        (Background, interpStyle, undersampleStyle).
-        """
+    def getImageView(self):
+        """Return a view that evaluates the sum of our backgrounds together.
 
-        bkgdImage = None
+        Returns
+        -------
+        view : `lsst.afw.math.BackgroundListView`
+            View evaluating the sum of the backgrounds, each with its
+            (interpStyle, undersampleStyle) or approximation; `None` if
+            the list is empty.
+        """
+        components = []
         for (bkgd, interpStyle, undersampleStyle, approxStyle,
              approxOrderX, approxOrderY, approxWeighting) in self:
-            if not bkgdImage:
-                if approxStyle != ApproximateControl.UNKNOWN:
-                    bkgdImage = bkgd.getImageF()
-                else:
-                    bkgdImage = bkgd.getImageF(interpStyle, undersampleStyle)
+            if approxStyle != ApproximateControl.UNKNOWN:
+                components.append(BackgroundImageView(bkgd))
             else:
-                if approxStyle != ApproximateControl.UNKNOWN:
-                    bkgdImage += bkgd.getImageF()
-                else:
-                    bkgdImage += bkgd.getImageF(interpStyle, undersampleStyle)
+                components.append(BackgroundImageView(bkgd, interpStyle, undersampleStyle))
+        return BackgroundListView(components) if components else None
 
+    def getImage(self):
+        """Compute and return a full-resolution image from our list of
+        (Background, interpStyle, undersampleStyle).
+        """
+        view = self.getImageView()
+        if view is None:
+            return None
+        bkgdImage = view.evaluate(view.getBBox())
+        if self._backgrounds[0][3] != ApproximateControl.UNKNOWN:
+            # Background.getImage returns approximations in LOCAL coordinates
+            bkgdImage.setXY0(lsst.geom.Point2I(0, 0))
         return bkgdImage
 
+    def subtractFrom(self, image):
+        """Subtract the sum of our backgrounds from an image, in place,
+        without computing a full-resolution background image.
+
+        Parameters
+        ----------
+        image : `lsst.afw.image.Image` or `lsst.afw.image.MaskedImage`
+            Image to subtract the backgrounds from; its bounding box selects
+            the part of the backgrounds used.
+        """
+        view = self.getImageView()
+        if view is not None:
+            view.subtractFrom(image)
+
     def __reduce__(self):
         return reduceToFits(self)
@@ -55,6 +55,12 @@ void declareTemplates(PyClass &cls) {
             "xStep"_a = 1, "yStep"_a = 1);
     cls.def("divideImage", &BoundedField::divideImage<PixelT>, "image"_a, "overlapOnly"_a = false,
             "xStep"_a = 1, "yStep"_a = 1);
+    cls.def("fillImageInterpolated", &BoundedField::fillImageInterpolated<PixelT>, "image"_a, "tolerance"_a,
+            "overlapOnly"_a = false);
+    cls.def("multiplyImageInterpolated", &BoundedField::multiplyImageInterpolated<PixelT>, "image"_a,
+            "tolerance"_a, "overlapOnly"_a = false);
+    cls.def("divideImageInterpolated", &BoundedField::divideImageInterpolated<PixelT>, "image"_a,
+            "tolerance"_a, "overlapOnly"_a = false);
 }
 }  // namespace
 void declareBoundedField(lsst::cpputils::python::WrapperCollection &wrappers) {
@@ -76,6 +82,7 @@ void declareBoundedField(lsst::cpputils::python::WrapperCollection &wrappers) {
                                     BoundedField::evaluate);
         cls.def("evaluate",
                 (double (BoundedField::*)(lsst::geom::Point2D const &) const) & BoundedField::evaluate);
+        cls.def("evaluateGrid", &BoundedField::evaluateGrid, "x"_a, "y"_a);
         cls.def("integrate", &BoundedField::integrate);
         cls.def("mean", &BoundedField::mean);
         cls.def("getBBox", &BoundedField::getBBox);
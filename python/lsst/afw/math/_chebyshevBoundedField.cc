@@ -58,6 +58,7 @@ void declareChebyshevBoundedField(lsst::cpputils::python::WrapperCollection &wra
                 LSST_DECLARE_CONTROL_FIELD(cls, ChebyshevBoundedFieldControl, orderX);
                 LSST_DECLARE_CONTROL_FIELD(cls, ChebyshevBoundedFieldControl, orderY);
                 LSST_DECLARE_CONTROL_FIELD(cls, ChebyshevBoundedFieldControl, triangular);
+                LSST_DECLARE_CONTROL_FIELD(cls, ChebyshevBoundedFieldControl, numThreads);
                 cls.def("computeSize", &ChebyshevBoundedFieldControl::computeSize);
             });
 
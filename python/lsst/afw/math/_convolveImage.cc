@@ -20,6 +20,8 @@
  * see <https://www.lsstcorp.org/LegalNotices/>.
  */
 
+#include <string>
+
 #include <pybind11/pybind11.h>
 #include <lsst/cpputils/python.h>
 
@@ -39,11 +41,13 @@ void declareConvolve(lsst::cpputils::python::WrapperCollection &wrappers) {
         mod.def("convolve",
                 (void (*)(OutImageT &, InImageT const &, KernelT const &,
                           ConvolutionControl const &))convolve<OutImageT, InImageT, KernelT>,
-                "convolvedImage"_a, "inImage"_a, "kernel"_a, "convolutionControl"_a = ConvolutionControl());
+                "convolvedImage"_a, "inImage"_a, "kernel"_a, "convolutionControl"_a = ConvolutionControl(),
+                py::call_guard<py::gil_scoped_release>());
         mod.def("convolve",
                 (void (*)(OutImageT &, InImageT const &, KernelT const &, bool,
                           bool))convolve<OutImageT, InImageT, KernelT>,
-                "convolvedImage"_a, "inImage"_a, "kernel"_a, "doNormalize"_a, "doCopyEdge"_a = false);
+                "convolvedImage"_a, "inImage"_a, "kernel"_a, "doNormalize"_a, "doCopyEdge"_a = false,
+                py::call_guard<py::gil_scoped_release>());
     });
 }
 
@@ -75,18 +79,37 @@ void declareAll(lsst::cpputils::python::WrapperCollection &wrappers) {
     declareByType<M1, M2>(wrappers);
 }
 
+template <typename PixelT>
+void declareBasisConvolutionCache(lsst::cpputils::python::WrapperCollection &wrappers,
+                                  std::string const &suffix) {
+    using Class = BasisConvolutionCache<PixelT>;
+    using PyClass = py::class_<Class, std::shared_ptr<Class>>;
+    wrappers.wrapType(PyClass(wrappers.module, ("BasisConvolutionCache" + suffix).c_str()),
+                      [](auto &mod, auto &cls) {
+                          cls.def(py::init<>());
+                          cls.def("convolve", &Class::convolve, "convolvedImage"_a, "inImage"_a, "kernel"_a,
+                                  "convolutionControl"_a = ConvolutionControl());
+                          cls.def("isCached", &Class::isCached, "inImage"_a, "kernel"_a);
+                          cls.def("clear", &Class::clear);
+                      });
+}
+
 void declareConvolveImage(lsst::cpputils::python::WrapperCollection &wrappers) {
     using PyClass = py::class_<ConvolutionControl, std::shared_ptr<ConvolutionControl>>;
     wrappers.wrapType(PyClass(wrappers.module, "ConvolutionControl"), [](auto &mod, auto &clsl) {
-        clsl.def(py::init<bool, bool, int>(), "doNormalize"_a = true, "doCopyEdge"_a = false,
-                 "maxInterpolationDistance"_a = 10);
+        clsl.def(py::init<bool, bool, int, int>(), "doNormalize"_a = true, "doCopyEdge"_a = false,
+                 "maxInterpolationDistance"_a = 10, "numThreads"_a = 1);
 
         clsl.def("getDoNormalize", &ConvolutionControl::getDoNormalize);
         clsl.def("getDoCopyEdge", &ConvolutionControl::getDoCopyEdge);
         clsl.def("getMaxInterpolationDistance", &ConvolutionControl::getMaxInterpolationDistance);
+        clsl.def("getNumThreads", &ConvolutionControl::getNumThreads);
+        clsl.def("getMinFftKernelSize", &ConvolutionControl::getMinFftKernelSize);
         clsl.def("setDoNormalize", &ConvolutionControl::setDoNormalize);
         clsl.def("setDoCopyEdge", &ConvolutionControl::setDoCopyEdge);
         clsl.def("setMaxInterpolationDistance", &ConvolutionControl::setMaxInterpolationDistance);
+        clsl.def("setNumThreads", &ConvolutionControl::setNumThreads);
+        clsl.def("setMinFftKernelSize", &ConvolutionControl::setMinFftKernelSize);
     });
 }
 }  // namespace
@@ -94,6 +117,8 @@ void declareConvolveImage(lsst::cpputils::python::WrapperCollection &wrappers) {
 void wrapConvolveImage(lsst::cpputils::python::WrapperCollection &wrappers) {
     wrappers.addSignatureDependency("lsst.afw.image");
     declareConvolveImage(wrappers);
+    declareBasisConvolutionCache<double>(wrappers, "D");
+    declareBasisConvolutionCache<float>(wrappers, "F");
     declareAll<double, double>(wrappers);
     declareAll<double, float>(wrappers);
     declareAll<double, int>(wrappers);
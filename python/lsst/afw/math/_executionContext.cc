@@ -0,0 +1,85 @@
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <optional>
+
+#include <pybind11/pybind11.h>
+#include <lsst/cpputils/python.h>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/math/ExecutionContext.h"
+
+namespace py = pybind11;
+using namespace pybind11::literals;
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace {
+
+// ExecutionContext as a Python context manager: the limit applies between __enter__ and __exit__
+class PyExecutionContext {
+public:
+    explicit PyExecutionContext(int maxNumThreads) : _maxNumThreads(maxNumThreads) {
+        ExecutionContext check(maxNumThreads);  // validate now, rather than on entry
+    }
+
+    PyExecutionContext &enter() {
+        if (_context) {
+            throw LSST_EXCEPT(pex::exceptions::LogicError, "ExecutionContext is already active");
+        }
+        _context.emplace(_maxNumThreads);
+        return *this;
+    }
+
+    void exit() { _context.reset(); }
+
+    int getMaxNumThreads() const { return _maxNumThreads; }
+
+private:
+    int _maxNumThreads;
+    std::optional<ExecutionContext> _context;
+};
+
+}  // namespace
+
+void wrapExecutionContext(lsst::cpputils::python::WrapperCollection &wrappers) {
+    wrappers.wrap([](auto &mod) {
+        mod.def("setMaxNumThreads", &setMaxNumThreads, "maxNumThreads"_a);
+        mod.def("getMaxNumThreads", &getMaxNumThreads);
+        mod.def("getCurrentMaxNumThreads", &getCurrentMaxNumThreads);
+    });
+    wrappers.wrapType(py::class_<PyExecutionContext>(wrappers.module, "ExecutionContext"),
+                      [](auto &mod, auto &cls) {
+                          cls.def(py::init<int>(), "maxNumThreads"_a);
+                          cls.def("__enter__", &PyExecutionContext::enter,
+                                  py::return_value_policy::reference);
+                          cls.def("__exit__", [](PyExecutionContext &self, py::object, py::object,
+                                                 py::object) { self.exit(); });
+                          cls.def("getMaxNumThreads", &PyExecutionContext::getMaxNumThreads);
+                      });
+}
+
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
@@ -0,0 +1,81 @@
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <lsst/cpputils/python.h>
+
+#include "ndarray/pybind11.h"
+
+#include "lsst/afw/math/FlatKdTree.h"
+
+namespace py = pybind11;
+using namespace pybind11::literals;
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace {
+
+template <typename T>
+void declareFlatKdTree(lsst::cpputils::python::WrapperCollection &wrappers, std::string const &suffix) {
+    using Class = FlatKdTree<T>;
+    using Points = ndarray::Array<T const, 2, 1>;
+    using Point = ndarray::Array<T const, 1, 1>;
+    using IndexLists = std::vector<std::vector<int>>;
+    wrappers.wrapType(py::class_<Class>(wrappers.module, ("FlatKdTree" + suffix).c_str()),
+                      [](auto &mod, auto &cls) {
+                          cls.def(py::init<Points const &, int>(), "points"_a, "leafSize"_a = 8);
+                          cls.def("__len__", &Class::size);
+                          cls.def("getDimensions", &Class::getDimensions);
+                          cls.def("findNeighbors",
+                                  (void (Class::*)(ndarray::Array<int, 1, 1>, ndarray::Array<double, 1, 1>,
+                                                   Point const &) const) &
+                                          Class::findNeighbors,
+                                  "indices"_a, "distances"_a, "point"_a);
+                          cls.def("findNeighbors",
+                                  (void (Class::*)(ndarray::Array<int, 2, 2>, ndarray::Array<double, 2, 2>,
+                                                   Points const &, int) const) &
+                                          Class::findNeighbors,
+                                  "indices"_a, "distances"_a, "queries"_a, "numThreads"_a = 1);
+                          cls.def("findWithinRadius",
+                                  (std::vector<int>(Class::*)(Point const &, double) const) &
+                                          Class::findWithinRadius,
+                                  "point"_a, "radius"_a);
+                          cls.def("findWithinRadius",
+                                  (IndexLists(Class::*)(Points const &, double, int) const) &
+                                          Class::findWithinRadius,
+                                  "queries"_a, "radius"_a, "numThreads"_a = 1);
+                      });
+}
+
+}  // namespace
+
+void wrapFlatKdTree(lsst::cpputils::python::WrapperCollection &wrappers) {
+    declareFlatKdTree<double>(wrappers, "D");
+    declareFlatKdTree<float>(wrappers, "F");
+}
+
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
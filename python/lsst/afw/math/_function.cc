@@ -26,6 +26,8 @@
 #include <lsst/cpputils/python.h>
 #include <pybind11/stl.h>
 
+#include "ndarray/pybind11.h"
+
 #include "lsst/afw/table/io/python.h"  // for addPersistableMethods
 #include "lsst/afw/math/Function.h"
 
@@ -68,6 +70,7 @@ void declareFunction1(lsst::cpputils::python::WrapperCollection &wrappers, const
 
         cls.def("clone", &Function1<ReturnT>::clone);
         cls.def("__call__", &Function1<ReturnT>::operator(), "x"_a);
+        cls.def("evaluate", &Function1<ReturnT>::evaluate, "x"_a);
         cls.def("toString", &Function1<ReturnT>::toString, "prefix"_a = "");
         cls.def("computeCache", &Function1<ReturnT>::computeCache, "n"_a);
     });
@@ -82,6 +85,8 @@ void declareFunction2(lsst::cpputils::python::WrapperCollection &wrappers, const
 
         cls.def("clone", &Function2<ReturnT>::clone);
         cls.def("__call__", &Function2<ReturnT>::operator(), "x"_a, "y"_a);
+        cls.def("evaluate", &Function2<ReturnT>::evaluate, "x"_a, "y"_a);
+        cls.def("evaluateGrid", &Function2<ReturnT>::evaluateGrid, "x"_a, "y"_a);
         cls.def("toString", &Function2<ReturnT>::toString, "prefix"_a = "");
         cls.def("getDFuncDParameters", &Function2<ReturnT>::getDFuncDParameters, "x"_a, "y"_a);
     });
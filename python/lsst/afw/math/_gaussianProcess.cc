@@ -59,6 +59,7 @@ void declareCovariograms(lsst::cpputils::python::WrapperCollection &wrappers, co
                       [](auto &mod, auto &cls) {
                           cls.def(py::init<>());
                           cls.def("__call__", &Covariogram<T>::operator());
+                          cls.def("evaluate", &Covariogram<T>::evaluate);
                       });
     /* SquaredExpCovariogram */
     wrappers.wrapType(
@@ -112,7 +113,19 @@ void declareGaussianProcess(lsst::cpputils::python::WrapperCollection &wrappers,
                         (void (GaussianProcess<T>::*)(ndarray::Array<T, 1, 1>, ndarray::Array<T, 1, 1>, int,
                                                       int) const) &
                                 GaussianProcess<T>::selfInterpolate);
+                cls.def("batchSelfInterpolate",
+                        (void (GaussianProcess<T>::*)(ndarray::Array<T, 1, 1>, ndarray::Array<T, 1, 1>,
+                                                      ndarray::Array<int, 1, 1> const &, int) const) &
+                                GaussianProcess<T>::batchSelfInterpolate);
+                cls.def("batchSelfInterpolate",
+                        (void (GaussianProcess<T>::*)(ndarray::Array<T, 2, 2>, ndarray::Array<T, 2, 2>,
+                                                      ndarray::Array<int, 1, 1> const &, int) const) &
+                                GaussianProcess<T>::batchSelfInterpolate);
                 cls.def("setLambda", &GaussianProcess<T>::setLambda);
+                cls.def("setNumThreads", &GaussianProcess<T>::setNumThreads);
+                cls.def("getNumThreads", &GaussianProcess<T>::getNumThreads);
+                cls.def("setApproximationRank", &GaussianProcess<T>::setApproximationRank);
+                cls.def("getApproximationRank", &GaussianProcess<T>::getApproximationRank);
                 cls.def("setCovariogram", &GaussianProcess<T>::setCovariogram);
                 cls.def("addPoint", (void (GaussianProcess<T>::*)(ndarray::Array<T, 1, 1> const &, T)) &
                                             GaussianProcess<T>::addPoint);
@@ -0,0 +1,62 @@
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <pybind11/pybind11.h>
+#include <lsst/cpputils/python.h>
+
+#include "lsst/afw/math/Instrumentation.h"
+
+namespace py = pybind11;
+using namespace pybind11::literals;
+
+namespace lsst {
+namespace afw {
+namespace math {
+
+void wrapInstrumentation(lsst::cpputils::python::WrapperCollection &wrappers) {
+    wrappers.wrap([](auto &mod) {
+        mod.def("isInstrumentationEnabled", &isInstrumentationEnabled);
+        mod.def("setInstrumentationEnabled", &setInstrumentationEnabled, "enabled"_a);
+        mod.def("resetInstrumentation", &resetInstrumentation);
+        mod.def("getInstrumentationSnapshot", []() {
+            py::dict result;
+            for (auto const &[name, record] : getInstrumentationSnapshot()) {
+                result[py::str(name)] = py::dict("count"_a = record.count, "time"_a = record.time);
+            }
+            return result;
+        });
+        mod.def("resetMemoryPeaks", &resetMemoryPeaks);
+        mod.def("getMemorySnapshot", []() {
+            py::dict result;
+            for (auto const &[name, record] : getMemorySnapshot()) {
+                result[py::str(name)] = py::dict("current"_a = record.current, "peak"_a = record.peak,
+                                                 "allocations"_a = record.allocations);
+            }
+            return result;
+        });
+    });
+}
+
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
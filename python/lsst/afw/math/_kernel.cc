@@ -24,6 +24,7 @@
 #include <lsst/cpputils/python.h>
 
 #include <pybind11/stl.h>
+#include "ndarray/pybind11.h"
 
 #include "lsst/afw/math/Kernel.h"
 #include "lsst/afw/table/io/python.h"  // for addPersistableMethods
@@ -73,9 +74,19 @@ void wrapKernel(lsst::cpputils::python::WrapperCollection &wrappers) {
                 (void (Kernel::*)(std::pair<double, double> const &)) & Kernel::setKernelParameters);
         cls.def("setSpatialParameters", &Kernel::setSpatialParameters);
         cls.def("computeKernelParametersFromSpatialModel", &Kernel::computeKernelParametersFromSpatialModel);
+        cls.def("computeKernelParametersOnGrid", &Kernel::computeKernelParametersOnGrid, "x"_a, "y"_a);
+        cls.def("computeImageFromKernelParameters", &Kernel::computeImageFromKernelParameters, "image"_a,
+                "doNormalize"_a, "kernelParams"_a);
         cls.def("toString", &Kernel::toString, "prefix"_a = "");
         cls.def("computeCache", &Kernel::computeCache);
         cls.def("getCacheSize", &Kernel::getCacheSize);
+        cls.def("setImageCache", &Kernel::setImageCache, "maxSize"_a, "positionQuantum"_a = 1.0);
+        cls.def("getImageCacheMaxSize", &Kernel::getImageCacheMaxSize);
+        cls.def("getImageCachePositionQuantum", &Kernel::getImageCachePositionQuantum);
+        cls.def("getImageCacheSize", &Kernel::getImageCacheSize);
+        cls.def("getImageCacheHits", &Kernel::getImageCacheHits);
+        cls.def("getImageCacheMisses", &Kernel::getImageCacheMisses);
+        cls.def("clearImageCache", &Kernel::clearImageCache);
     });
 
     using PyFixedKernel = py::class_<FixedKernel, std::shared_ptr<FixedKernel>, Kernel>;
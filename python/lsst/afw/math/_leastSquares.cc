@@ -20,12 +20,15 @@
  * see <https://www.lsstcorp.org/LegalNotices/>.
  */
 
+#include <limits>
+
 #include <pybind11/pybind11.h>
 #include <lsst/cpputils/python.h>
 
 #include "ndarray/pybind11.h"
 
 #include "lsst/afw/math/LeastSquares.h"
+#include "lsst/afw/math/LeastSquaresBatch.h"
 
 namespace py = pybind11;
 using namespace pybind11::literals;
@@ -75,10 +78,27 @@ void declareLeastSquares(lsst::cpputils::python::WrapperCollection &wrappers) {
                           enm.export_values();
                       });
 };
+
+void declareLeastSquaresBatch(lsst::cpputils::python::WrapperCollection &wrappers) {
+    wrappers.wrapType(
+            py::class_<LeastSquaresBatch>(wrappers.module, "LeastSquaresBatch"), [](auto &mod, auto &cls) {
+                cls.def_static("fromNormalEquations", &LeastSquaresBatch::fromNormalEquations, "fisher"_a,
+                               "rhs"_a, "factorization"_a = LeastSquares::NORMAL_CHOLESKY,
+                               "threshold"_a = std::numeric_limits<double>::epsilon(), "numThreads"_a = 1,
+                               py::call_guard<py::gil_scoped_release>());
+                cls.def("getSize", &LeastSquaresBatch::getSize);
+                cls.def("getDimension", &LeastSquaresBatch::getDimension);
+                cls.def("getFactorization", &LeastSquaresBatch::getFactorization);
+                cls.def("getSolution", &LeastSquaresBatch::getSolution);
+                cls.def("getDiagnostic", &LeastSquaresBatch::getDiagnostic);
+                cls.def("getRank", &LeastSquaresBatch::getRank);
+            });
+}
 }  // namespace
 
 void wrapLeastSquares(lsst::cpputils::python::WrapperCollection &wrappers) {
     declareLeastSquares<double, double, 0, 0>(wrappers);
+    declareLeastSquaresBatch(wrappers);
 }
 }  // namespace math
 }  // namespace afw
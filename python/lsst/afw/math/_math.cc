@@ -31,9 +31,12 @@ void wrapBackground(lsst::cpputils::python::WrapperCollection &);
 void wrapBoundedField(lsst::cpputils::python::WrapperCollection &);
 void wrapChebyshevBoundedField(lsst::cpputils::python::WrapperCollection &);
 void wrapConvolveImage(lsst::cpputils::python::WrapperCollection &);
+void wrapExecutionContext(lsst::cpputils::python::WrapperCollection &);
+void wrapFlatKdTree(lsst::cpputils::python::WrapperCollection &);
 void wrapFunction(lsst::cpputils::python::WrapperCollection &);
 void wrapFunctionLibrary(lsst::cpputils::python::WrapperCollection &);
 void wrapGaussianProcess(lsst::cpputils::python::WrapperCollection &);
+void wrapInstrumentation(lsst::cpputils::python::WrapperCollection &);
 void wrapInterpolate(lsst::cpputils::python::WrapperCollection &);
 void wrapKernel(lsst::cpputils::python::WrapperCollection &);
 void wrapLeastSquares(lsst::cpputils::python::WrapperCollection &);
@@ -55,9 +58,12 @@ PYBIND11_MODULE(_math, mod) {
     wrapBoundedField(wrappers);
     wrapChebyshevBoundedField(wrappers);
     wrapConvolveImage(wrappers);
+    wrapExecutionContext(wrappers);
+    wrapFlatKdTree(wrappers);
     wrapFunction(wrappers);
     wrapFunctionLibrary(wrappers);
     wrapGaussianProcess(wrappers);
+    wrapInstrumentation(wrappers);
     wrapInterpolate(wrappers);
     wrapKernel(wrappers);
     wrapLeastSquares(wrappers);
@@ -40,20 +40,22 @@ template <typename ImageT>
 static void declareOffsetImage(lsst::cpputils::python::WrapperCollection &wrappers) {
     wrappers.wrap([](auto &mod) {
         mod.def("offsetImage", offsetImage<ImageT>, "image"_a, "dx"_a, "dy"_a, "algorithmName"_a = "lanczos5",
-                "buffer"_a = 0);
+                "buffer"_a = 0, "numThreads"_a = 1);
     });
 }
 
 template <typename ImageT>
 static void declareRotateImageBy90(lsst::cpputils::python::WrapperCollection &wrappers) {
-    wrappers.wrap(
-            [](auto &mod) { mod.def("rotateImageBy90", rotateImageBy90<ImageT>, "image"_a, "nQuarter"_a); });
+    wrappers.wrap([](auto &mod) {
+        mod.def("rotateImageBy90", rotateImageBy90<ImageT>, "image"_a, "nQuarter"_a, "numThreads"_a = 1);
+    });
 }
 
 template <typename ImageT>
 static void declareFlipImage(lsst::cpputils::python::WrapperCollection &wrappers) {
-    wrappers.wrap(
-            [](auto &mod) { mod.def("flipImage", flipImage<ImageT>, "inImage"_a, "flipLR"_a, "flipTB"_a); });
+    wrappers.wrap([](auto &mod) {
+        mod.def("flipImage", flipImage<ImageT>, "inImage"_a, "flipLR"_a, "flipTB"_a, "numThreads"_a = 1);
+    });
 }
 
 template <typename ImageT>
@@ -61,12 +63,12 @@ static void declareBinImage(lsst::cpputils::python::WrapperCollection &wrappers)
     wrappers.wrap([](auto &mod) {
         mod.def("binImage",
                 (std::shared_ptr<ImageT>(*)(ImageT const &, int const, int const,
-                                            lsst::afw::math::Property const))binImage<ImageT>,
-                "inImage"_a, "binX"_a, "binY"_a, "flags"_a = lsst::afw::math::MEAN);
+                                            lsst::afw::math::Property const, int))binImage<ImageT>,
+                "inImage"_a, "binX"_a, "binY"_a, "flags"_a = lsst::afw::math::MEAN, "numThreads"_a = 1);
         mod.def("binImage",
-                (std::shared_ptr<ImageT>(*)(ImageT const &, int const,
-                                            lsst::afw::math::Property const))binImage<ImageT>,
-                "inImage"_a, "binsize"_a, "flags"_a = lsst::afw::math::MEAN);
+                (std::shared_ptr<ImageT>(*)(ImageT const &, int const, lsst::afw::math::Property const,
+                                            int))binImage<ImageT>,
+                "inImage"_a, "binsize"_a, "flags"_a = lsst::afw::math::MEAN, "numThreads"_a = 1);
     });
 }
 }  // namespace
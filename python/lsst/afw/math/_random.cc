@@ -37,15 +37,23 @@ namespace math {
 template <typename ImageT>
 void declareRandomImage(lsst::cpputils::python::WrapperCollection &wrappers) {
     wrappers.wrap([](auto &mod) {
-        mod.def("randomUniformImage", (void (*)(ImageT *, Random &))randomUniformImage<ImageT>);
-        mod.def("randomUniformPosImage", (void (*)(ImageT *, Random &))randomUniformPosImage<ImageT>);
+        mod.def("randomUniformImage", (void (*)(ImageT *, Random &, int))randomUniformImage<ImageT>,
+                "image"_a, "rand"_a, "numThreads"_a = 1);
+        mod.def("randomUniformPosImage", (void (*)(ImageT *, Random &, int))randomUniformPosImage<ImageT>,
+                "image"_a, "rand"_a, "numThreads"_a = 1);
         mod.def("randomUniformIntImage",
-                (void (*)(ImageT *, Random &, unsigned long))randomUniformIntImage<ImageT>);
+                (void (*)(ImageT *, Random &, unsigned long, int))randomUniformIntImage<ImageT>, "image"_a,
+                "rand"_a, "n"_a, "numThreads"_a = 1);
         mod.def("randomFlatImage",
-                (void (*)(ImageT *, Random &, double const, double const))randomFlatImage<ImageT>);
-        mod.def("randomGaussianImage", (void (*)(ImageT *, Random &))randomGaussianImage<ImageT>);
-        mod.def("randomChisqImage", (void (*)(ImageT *, Random &, double const))randomChisqImage<ImageT>);
-        mod.def("randomPoissonImage", (void (*)(ImageT *, Random &, double const))randomPoissonImage<ImageT>);
+                (void (*)(ImageT *, Random &, double const, double const, int))randomFlatImage<ImageT>,
+                "image"_a, "rand"_a, "a"_a, "b"_a, "numThreads"_a = 1);
+        mod.def("randomGaussianImage", (void (*)(ImageT *, Random &, int))randomGaussianImage<ImageT>,
+                "image"_a, "rand"_a, "numThreads"_a = 1);
+        mod.def("randomChisqImage", (void (*)(ImageT *, Random &, double const, int))randomChisqImage<ImageT>,
+                "image"_a, "rand"_a, "nu"_a, "numThreads"_a = 1);
+        mod.def("randomPoissonImage",
+                (void (*)(ImageT *, Random &, double const, int))randomPoissonImage<ImageT>, "image"_a,
+                "rand"_a, "mu"_a, "numThreads"_a = 1);
     });
 }
 
@@ -63,7 +71,10 @@ void declareRandom(lsst::cpputils::python::WrapperCollection &wrappers) {
         cls.def("getAlgorithmName", &Random::getAlgorithmName);
         cls.def_static("getAlgorithmNames", &Random::getAlgorithmNames);
         cls.def("getSeed", &Random::getSeed);
-        cls.def("uniform", &Random::uniform);
+        cls.def("isCounterBased", &Random::isCounterBased);
+        cls.def("getSubstream", &Random::getSubstream, "index"_a);
+        cls.def("skipSubstreams", &Random::skipSubstreams, "n"_a);
+        cls.def("uniform", (double (Random::*)()) & Random::uniform);
         cls.def("uniformPos", &Random::uniformPos);
         cls.def("uniformInt", &Random::uniformInt);
         cls.def("flat", &Random::flat);
@@ -95,6 +106,7 @@ void declareRandom(lsst::cpputils::python::WrapperCollection &wrappers) {
         enm.value("TAUS", Random::Algorithm::TAUS);
         enm.value("TAUS2", Random::Algorithm::TAUS2);
         enm.value("GFSR4", Random::Algorithm::GFSR4);
+        enm.value("PHILOX4X32", Random::Algorithm::PHILOX4X32);
         enm.value("NUM_ALGORITHMS", Random::Algorithm::NUM_ALGORITHMS);
         enm.export_values();
     });
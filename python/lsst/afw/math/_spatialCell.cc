@@ -132,13 +132,15 @@ void declareSpatialCellSet(lsst::cpputils::python::WrapperCollection &wrappers)
                 cls.def("insertCandidate", &SpatialCellSet::insertCandidate);
                 cls.def("sortCandidates", &SpatialCellSet::sortCandidates);
                 cls.def("visitCandidates",
-                        (void (SpatialCellSet::*)(CandidateVisitor *, int const, bool const)) &
+                        (void (SpatialCellSet::*)(CandidateVisitor *, int const, bool const, int)) &
                                 SpatialCellSet::visitCandidates,
-                        "visitor"_a, "nMaxPerCell"_a = -1, "ignoreExceptions"_a = false);
+                        "visitor"_a, "nMaxPerCell"_a = -1, "ignoreExceptions"_a = false, "numThreads"_a = 1,
+                        py::call_guard<py::gil_scoped_release>());
                 cls.def("visitAllCandidates",
-                        (void (SpatialCellSet::*)(CandidateVisitor *, bool const)) &
+                        (void (SpatialCellSet::*)(CandidateVisitor *, bool const, int)) &
                                 SpatialCellSet::visitAllCandidates,
-                        "visitor"_a, "ignoreExceptions"_a = false);
+                        "visitor"_a, "ignoreExceptions"_a = false, "numThreads"_a = 1,
+                        py::call_guard<py::gil_scoped_release>());
                 cls.def("getCandidateById", &SpatialCellSet::getCandidateById, "id"_a, "noThrow"_a = false);
                 cls.def("setIgnoreBad", &SpatialCellSet::setIgnoreBad, "ignoreBad"_a);
             });
@@ -153,6 +155,8 @@ void declareCandidateVisitor(lsst::cpputils::python::WrapperCollection &wrappers
 
                           cls.def("reset", &CandidateVisitor::reset);
                           cls.def("processCandidate", &CandidateVisitor::processCandidate);
+                          cls.def("clone", &CandidateVisitor::clone);
+                          cls.def("merge", &CandidateVisitor::merge, "other"_a);
                       });
 }
 
@@ -201,6 +205,14 @@ void declareTestClasses(lsst::cpputils::python::WrapperCollection &wrappers) {
         // Called by SpatialCellSet::visitCandidates for each Candidate
         void processCandidate(SpatialCellCandidate *candidate) override { ++_n; }
 
+        std::shared_ptr<CandidateVisitor> clone() const override {
+            return std::make_shared<TestCandidateVisitor>();
+        }
+
+        void merge(CandidateVisitor const &other) override {
+            _n += dynamic_cast<TestCandidateVisitor const &>(other)._n;
+        }
+
         int getN() const { return _n; }
 
     private:
@@ -20,11 +20,14 @@
  * see <https://www.lsstcorp.org/LegalNotices/>.
  */
 
+#include <limits>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <pybind11/pybind11.h>
 #include <lsst/cpputils/python.h>
+#include <pybind11/functional.h>
 #include <pybind11/stl.h>
 
 #include "lsst/afw/math/Stack.h"
@@ -46,19 +49,22 @@ void declareStatisticsStack(lsst::cpputils::python::WrapperCollection &wrappers)
                 (std::shared_ptr<lsst::afw::image::MaskedImage<PixelT>>(*)(
                         lsst::afw::image::Image<PixelT> const &, Property, char,
                         StatisticsControl const &))statisticsStack<PixelT>,
-                "image"_a, "flags"_a, "dimensions"_a, "sctrl"_a = StatisticsControl());
+                "image"_a, "flags"_a, "dimensions"_a, "sctrl"_a = StatisticsControl(),
+                py::call_guard<py::gil_scoped_release>());
         mod.def("statisticsStack",
                 (std::shared_ptr<lsst::afw::image::MaskedImage<PixelT>>(*)(
                         lsst::afw::image::MaskedImage<PixelT> const &, Property, char,
                         StatisticsControl const &))statisticsStack<PixelT>,
-                "image"_a, "flags"_a, "dimensions"_a, "sctrl"_a = StatisticsControl());
+                "image"_a, "flags"_a, "dimensions"_a, "sctrl"_a = StatisticsControl(),
+                py::call_guard<py::gil_scoped_release>());
         mod.def("statisticsStack",
                 (void (*)(lsst::afw::image::Image<PixelT> &,
                           std::vector<std::shared_ptr<lsst::afw::image::Image<PixelT>>> &, Property,
                           StatisticsControl const &,
                           std::vector<lsst::afw::image::VariancePixel> const &))statisticsStack<PixelT>,
                 "out"_a, "images"_a, "flags"_a, "sctrl"_a = StatisticsControl(),
-                "wvector"_a = std::vector<lsst::afw::image::VariancePixel>(0));
+                "wvector"_a = std::vector<lsst::afw::image::VariancePixel>(0),
+                py::call_guard<py::gil_scoped_release>());
         mod.def("statisticsStack",
                 (void (*)(lsst::afw::image::MaskedImage<PixelT> &,
                           std::vector<std::shared_ptr<lsst::afw::image::MaskedImage<PixelT>>> &, Property,
@@ -66,7 +72,7 @@ void declareStatisticsStack(lsst::cpputils::python::WrapperCollection &wrappers)
                           lsst::afw::image::MaskPixel, lsst::afw::image::MaskPixel))statisticsStack<PixelT>,
                 "out"_a, "images"_a, "flags"_a, "sctrl"_a = StatisticsControl(),
                 "wvector"_a = std::vector<lsst::afw::image::VariancePixel>(0), "clipped"_a = 0,
-                "excuse"_a = 0);
+                "excuse"_a = 0, py::call_guard<py::gil_scoped_release>());
         mod.def("statisticsStack",
                 (void (*)(
                         lsst::afw::image::MaskedImage<PixelT> &,
@@ -75,14 +81,16 @@ void declareStatisticsStack(lsst::cpputils::python::WrapperCollection &wrappers)
                         lsst::afw::image::MaskPixel,
                         std::vector<std::pair<lsst::afw::image::MaskPixel, lsst::afw::image::MaskPixel>> const
                                 &))statisticsStack<PixelT>,
-                "out"_a, "images"_a, "flags"_a, "sctrl"_a, "wvector"_a, "clipped"_a, "maskMap"_a);
+                "out"_a, "images"_a, "flags"_a, "sctrl"_a, "wvector"_a, "clipped"_a, "maskMap"_a,
+                py::call_guard<py::gil_scoped_release>());
         mod.def("statisticsStack",
                 (std::shared_ptr<lsst::afw::image::Image<PixelT>>(*)(
                         std::vector<std::shared_ptr<lsst::afw::image::Image<PixelT>>> &, Property,
                         StatisticsControl const &,
                         std::vector<lsst::afw::image::VariancePixel> const &))statisticsStack<PixelT>,
                 "images"_a, "flags"_a, "sctrl"_a = StatisticsControl(),
-                "wvector"_a = std::vector<lsst::afw::image::VariancePixel>(0));
+                "wvector"_a = std::vector<lsst::afw::image::VariancePixel>(0),
+                py::call_guard<py::gil_scoped_release>());
         mod.def("statisticsStack",
                 (std::shared_ptr<lsst::afw::image::MaskedImage<PixelT>>(*)(
                         std::vector<std::shared_ptr<lsst::afw::image::MaskedImage<PixelT>>> &, Property,
@@ -90,7 +98,7 @@ void declareStatisticsStack(lsst::cpputils::python::WrapperCollection &wrappers)
                         lsst::afw::image::MaskPixel, lsst::afw::image::MaskPixel))statisticsStack<PixelT>,
                 "images"_a, "flags"_a, "sctrl"_a = StatisticsControl(),
                 "wvector"_a = std::vector<lsst::afw::image::VariancePixel>(0), "clipped"_a = 0,
-                "excuse"_a = 0);
+                "excuse"_a = 0, py::call_guard<py::gil_scoped_release>());
         mod.def("statisticsStack",
                 (std::shared_ptr<lsst::afw::image::MaskedImage<PixelT>>(*)(
                         std::vector<std::shared_ptr<lsst::afw::image::MaskedImage<PixelT>>> &, Property,
@@ -98,22 +106,99 @@ void declareStatisticsStack(lsst::cpputils::python::WrapperCollection &wrappers)
                         lsst::afw::image::MaskPixel,
                         std::vector<std::pair<lsst::afw::image::MaskPixel, lsst::afw::image::MaskPixel>> const
                                 &))statisticsStack<PixelT>,
-                "images"_a, "flags"_a, "sctrl"_a, "wvector"_a, "clipped"_a, "maskMap"_a);
+                "images"_a, "flags"_a, "sctrl"_a, "wvector"_a, "clipped"_a, "maskMap"_a,
+                py::call_guard<py::gil_scoped_release>());
         mod.def("statisticsStack",
                 (std::vector<PixelT>(*)(
                         std::vector<std::vector<PixelT>> &, Property, StatisticsControl const &,
                         std::vector<lsst::afw::image::VariancePixel> const &))statisticsStack<PixelT>,
                 "vectors"_a, "flags"_a, "sctrl"_a = StatisticsControl(),
-                "wvector"_a = std::vector<lsst::afw::image::VariancePixel>(0));
+                "wvector"_a = std::vector<lsst::afw::image::VariancePixel>(0),
+                py::call_guard<py::gil_scoped_release>());
     });
 }
 
+template <typename PixelT>
+void declareStreamingStatisticsStack(lsst::cpputils::python::WrapperCollection &wrappers,
+                                     std::string const &suffix) {
+    // A Python callable converts to a reader of any pixel type, so the pixel type is in the name
+    wrappers.wrap([suffix](auto &mod) {
+        mod.def(("streamingStatisticsStack" + suffix).c_str(),
+                (void (*)(std::vector<MaskedImageStripReader<PixelT>> const &, lsst::geom::Box2I const &,
+                          Property, MaskedImageStripWriter<PixelT> const &, StatisticsControl const &,
+                          std::vector<lsst::afw::image::VariancePixel> const &, lsst::afw::image::MaskPixel,
+                          lsst::afw::image::MaskPixel, int,
+                          StackSampleStorage const &))streamingStatisticsStack<PixelT>,
+                "readers"_a, "bbox"_a, "flags"_a, "writer"_a, "sctrl"_a = StatisticsControl(),
+                "wvector"_a = std::vector<lsst::afw::image::VariancePixel>(0), "clipped"_a = 0,
+                "excuse"_a = 0, "stripHeight"_a = 256, "storage"_a = StackSampleStorage());
+        mod.def(("streamingStatisticsStack" + suffix).c_str(),
+                (void (*)(std::vector<MaskedImageStripReader<PixelT>> const &, lsst::geom::Box2I const &,
+                          Property, MaskedImageStripWriter<PixelT> const &, StatisticsControl const &,
+                          std::vector<lsst::afw::image::VariancePixel> const &, lsst::afw::image::MaskPixel,
+                          std::vector<std::pair<lsst::afw::image::MaskPixel,
+                                                lsst::afw::image::MaskPixel>> const &,
+                          int, StackSampleStorage const &))streamingStatisticsStack<PixelT>,
+                "readers"_a, "bbox"_a, "flags"_a, "writer"_a, "sctrl"_a, "wvector"_a, "clipped"_a,
+                "maskMap"_a, "stripHeight"_a = 256, "storage"_a = StackSampleStorage());
+    });
+}
+
+void declareStackSampleStorage(lsst::cpputils::python::WrapperCollection &wrappers) {
+    auto storage = wrappers.wrapType(
+            py::class_<StackSampleStorage, std::shared_ptr<StackSampleStorage>>(wrappers.module,
+                                                                                "StackSampleStorage"),
+            [](auto &mod, auto &cls) {
+                cls.def(py::init<StackSampleStorage::Precision, double>(),
+                        "precision"_a = StackSampleStorage::FULL,
+                        "maxImageError"_a = std::numeric_limits<double>::infinity());
+                cls.def("getPrecision", &StackSampleStorage::getPrecision);
+                cls.def("getMaxImageError", &StackSampleStorage::getMaxImageError);
+            });
+    wrappers.wrapType(py::enum_<StackSampleStorage::Precision>(storage, "Precision"),
+                      [](auto &mod, auto &enm) {
+                          enm.value("FULL", StackSampleStorage::FULL);
+                          enm.value("HALF", StackSampleStorage::HALF);
+                          enm.value("SCALED_INT16", StackSampleStorage::SCALED_INT16);
+                          enm.export_values();
+                      });
+}
+
+template <typename PixelT>
+void declareStackAccumulator(lsst::cpputils::python::WrapperCollection &wrappers, std::string const &suffix) {
+    using Class = StackAccumulator<PixelT>;
+
+    wrappers.wrapType(
+            py::class_<Class, std::shared_ptr<Class>>(wrappers.module, ("StackAccumulator" + suffix).c_str()),
+            [](auto &mod, auto &cls) {
+                cls.def(py::init<lsst::geom::Box2I const &, Property, StatisticsControl const &,
+                                 lsst::afw::image::MaskPixel, lsst::afw::image::MaskPixel>(),
+                        "bbox"_a, "flags"_a, "sctrl"_a = StatisticsControl(), "clipped"_a = 0,
+                        "excuse"_a = 0);
+                cls.def("add",
+                        (void (Class::*)(lsst::afw::image::MaskedImage<PixelT> const &)) & Class::add,
+                        "maskedImage"_a);
+                cls.def("add",
+                        (void (Class::*)(lsst::afw::image::MaskedImage<PixelT> const &, double)) &
+                                Class::add,
+                        "maskedImage"_a, "weight"_a);
+                cls.def("finish", &Class::finish);
+                cls.def("getNumInputs", &Class::getNumInputs);
+                cls.def("getBBox", &Class::getBBox);
+            });
+}
+
 }  // namespace
 
 void wrapStack(lsst::cpputils::python::WrapperCollection &wrappers) {
     wrappers.addSignatureDependency("lsst.afw.image");
     declareStatisticsStack<float>(wrappers);
     declareStatisticsStack<double>(wrappers);
+    declareStackSampleStorage(wrappers);
+    declareStreamingStatisticsStack<float>(wrappers, "F");
+    declareStreamingStatisticsStack<double>(wrappers, "D");
+    declareStackAccumulator<float>(wrappers, "F");
+    declareStackAccumulator<double>(wrappers, "D");
 }
 }  // namespace math
 }  // namespace afw
@@ -24,7 +24,10 @@
 #include <lsst/cpputils/python.h>
 #include <pybind11/stl.h>
 
+#include "ndarray/pybind11.h"
+
 #include "lsst/afw/math/Statistics.h"
+#include "lsst/afw/math/MultiRegionStatistics.h"
 
 namespace py = pybind11;
 using namespace pybind11::literals;
@@ -39,23 +42,51 @@ void declareStatistics(lsst::cpputils::python::WrapperCollection &wrappers) {
         mod.def("makeStatistics",
                 (Statistics(*)(image::Image<Pixel> const &, image::Mask<image::MaskPixel> const &, int const,
                                StatisticsControl const &))makeStatistics<Pixel>,
-                "img"_a, "msk"_a, "flags"_a, "sctrl"_a = StatisticsControl());
+                "img"_a, "msk"_a, "flags"_a, "sctrl"_a = StatisticsControl(),
+                py::call_guard<py::gil_scoped_release>());
         mod.def("makeStatistics",
                 (Statistics(*)(image::MaskedImage<Pixel> const &, int const,
                                StatisticsControl const &))makeStatistics<Pixel>,
-                "mimg"_a, "flags"_a, "sctrl"_a = StatisticsControl());
+                "mimg"_a, "flags"_a, "sctrl"_a = StatisticsControl(),
+                py::call_guard<py::gil_scoped_release>());
         mod.def("makeStatistics",
                 (Statistics(*)(image::MaskedImage<Pixel> const &, image::Image<WeightPixel> const &,
                                int const, StatisticsControl const &))makeStatistics<Pixel>,
-                "mimg"_a, "weights"_a, "flags"_a, "sctrl"_a = StatisticsControl());
+                "mimg"_a, "weights"_a, "flags"_a, "sctrl"_a = StatisticsControl(),
+                py::call_guard<py::gil_scoped_release>());
         mod.def("makeStatistics",
                 (Statistics(*)(image::Mask<image::MaskPixel> const &, int const, StatisticsControl const &))
                         makeStatistics,  // this is not a template, just a regular overload
-                "msk"_a, "flags"_a, "sctrl"_a = StatisticsControl());
+                "msk"_a, "flags"_a, "sctrl"_a = StatisticsControl(),
+                py::call_guard<py::gil_scoped_release>());
         mod.def("makeStatistics",
                 (Statistics(*)(image::Image<Pixel> const &, int const,
                                StatisticsControl const &))makeStatistics<Pixel>,
-                "img"_a, "flags"_a, "sctrl"_a = StatisticsControl());
+                "img"_a, "flags"_a, "sctrl"_a = StatisticsControl(),
+                py::call_guard<py::gil_scoped_release>());
+    });
+}
+
+template <typename Pixel>
+void declareMultiRegionStatistics(lsst::cpputils::python::WrapperCollection &wrappers) {
+    wrappers.wrap([](auto &mod) {
+        mod.def("makeMultiRegionStatistics",
+                (MultiRegionStatistics(*)(image::MaskedImage<Pixel> const &,
+                                          std::vector<lsst::geom::Box2I> const &, int const,
+                                          StatisticsControl const &))makeMultiRegionStatistics<Pixel>,
+                "mimg"_a, "boxes"_a, "flags"_a, "sctrl"_a = StatisticsControl(),
+                py::call_guard<py::gil_scoped_release>());
+        mod.def("makeMultiRegionStatistics",
+                (MultiRegionStatistics(*)(image::MaskedImage<Pixel> const &,
+                                          std::vector<std::shared_ptr<geom::SpanSet const>> const &,
+                                          int const, StatisticsControl const &))
+                        makeMultiRegionStatistics<Pixel>,
+                "mimg"_a, "spanSets"_a, "flags"_a, "sctrl"_a = StatisticsControl(),
+                py::call_guard<py::gil_scoped_release>());
+        mod.def("makeRowStatistics", makeRowStatistics<Pixel>, "mimg"_a, "flags"_a,
+                "sctrl"_a = StatisticsControl(), py::call_guard<py::gil_scoped_release>());
+        mod.def("makeColumnStatistics", makeColumnStatistics<Pixel>, "mimg"_a, "flags"_a,
+                "sctrl"_a = StatisticsControl(), py::call_guard<py::gil_scoped_release>());
     });
 }
 
@@ -118,6 +149,7 @@ void declareStatistics(lsst::cpputils::python::WrapperCollection &wrappers) {
         cls.def("getWeightedIsSet", &StatisticsControl::getWeightedIsSet);
         cls.def("getCalcErrorFromInputVariance", &StatisticsControl::getCalcErrorFromInputVariance);
         cls.def("getCalcErrorMosaicMode", &StatisticsControl::getCalcErrorMosaicMode);
+        cls.def("getNumThreads", &StatisticsControl::getNumThreads);
         cls.def("setNumSigmaClip", &StatisticsControl::setNumSigmaClip);
         cls.def("setNumIter", &StatisticsControl::setNumIter);
         cls.def("setAndMask", &StatisticsControl::setAndMask);
@@ -126,6 +158,7 @@ void declareStatistics(lsst::cpputils::python::WrapperCollection &wrappers) {
         cls.def("setWeighted", &StatisticsControl::setWeighted);
         cls.def("setCalcErrorFromInputVariance", &StatisticsControl::setCalcErrorFromInputVariance);
         cls.def("setCalcErrorMosaicMode", &StatisticsControl::setCalcErrorMosaicMode);
+        cls.def("setNumThreads", &StatisticsControl::setNumThreads, "numThreads"_a);
     });
 
     wrappers.wrapType(py::enum_<StatisticsControl::WeightsBoolean>(control, "WeightsBoolean"),
@@ -142,14 +175,31 @@ void declareStatistics(lsst::cpputils::python::WrapperCollection &wrappers) {
         cls.def("getValue", &Statistics::getValue, "prop"_a = Property::NOTHING);
         cls.def("getOrMask", &Statistics::getOrMask);
     });
+
+    wrappers.wrapType(
+            py::class_<MultiRegionStatistics>(wrappers.module, "MultiRegionStatistics"),
+            [](auto &mod, auto &cls) {
+                cls.def("__len__", &MultiRegionStatistics::size);
+                cls.def("__getitem__", &MultiRegionStatistics::get,
+                        py::return_value_policy::reference_internal);
+                cls.def("getFlags", &MultiRegionStatistics::getFlags);
+                cls.def("getValues", &MultiRegionStatistics::getValues, "prop"_a = Property::NOTHING);
+                cls.def("getErrors", &MultiRegionStatistics::getErrors, "prop"_a = Property::NOTHING);
+                cls.def("getOrMasks", &MultiRegionStatistics::getOrMasks);
+            });
 }
 void wrapStatistics(lsst::cpputils::python::WrapperCollection &wrappers) {
     wrappers.addSignatureDependency("lsst.afw.image");
+    wrappers.addSignatureDependency("lsst.afw.geom");
     declareStatistics(wrappers);
     declareStatistics<unsigned short>(wrappers);
     declareStatistics<double>(wrappers);
     declareStatistics<float>(wrappers);
     declareStatistics<int>(wrappers);
+    declareMultiRegionStatistics<unsigned short>(wrappers);
+    declareMultiRegionStatistics<double>(wrappers);
+    declareMultiRegionStatistics<float>(wrappers);
+    declareMultiRegionStatistics<int>(wrappers);
     // Declare vector overloads separately to prevent casting errors
     // that otherwise (mysteriously) occur when overloads are tried
     // in order.
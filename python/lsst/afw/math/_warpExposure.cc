@@ -23,8 +23,11 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <type_traits>
 
 #include <pybind11/pybind11.h>
+#include <pybind11/functional.h>
+#include <pybind11/stl.h>
 #include <lsst/cpputils/python.h>
 
 #include "lsst/afw/geom/SkyWcs.h"
@@ -97,16 +100,19 @@ void declareImageWarpingFunctions(lsst::cpputils::python::WrapperCollection &wra
                 (int (*)(DestImageT &, geom::SkyWcs const &, SrcImageT const &, geom::SkyWcs const &,
                          WarpingControl const &, typename DestImageT::SinglePixel)) &
                         warpImage<DestImageT, SrcImageT>,
-                "destImage"_a, "destWcs"_a, "srcImage"_a, "srcWcs"_a, "control"_a, "padValue"_a = EdgePixel);
+                "destImage"_a, "destWcs"_a, "srcImage"_a, "srcWcs"_a, "control"_a, "padValue"_a = EdgePixel,
+                py::call_guard<py::gil_scoped_release>());
 
         mod.def("warpImage",
                 (int (*)(DestImageT &, SrcImageT const &, geom::TransformPoint2ToPoint2 const &,
                          WarpingControl const &, typename DestImageT::SinglePixel)) &
                         warpImage<DestImageT, SrcImageT>,
-                "destImage"_a, "srcImage"_a, "srcToDest"_a, "control"_a, "padValue"_a = EdgePixel);
+                "destImage"_a, "srcImage"_a, "srcToDest"_a, "control"_a, "padValue"_a = EdgePixel,
+                py::call_guard<py::gil_scoped_release>());
 
         mod.def("warpCenteredImage", &warpCenteredImage<DestImageT, SrcImageT>, "destImage"_a, "srcImage"_a,
-                "linearTransform"_a, "centerPoint"_a, "control"_a, "padValue"_a = EdgePixel);
+                "linearTransform"_a, "centerPoint"_a, "control"_a, "padValue"_a = EdgePixel,
+                py::call_guard<py::gil_scoped_release>());
     });
 }
 
@@ -132,7 +138,17 @@ void declareWarpingFunctions(lsst::cpputils::python::WrapperCollection &wrappers
         mod.def("warpExposure", &warpExposure<DestExposureT, SrcExposureT>, "destExposure"_a, "srcExposure"_a,
                 "control"_a,
                 "padValue"_a = edgePixel<DestMaskedImageT>(
-                        typename image::detail::image_traits<DestMaskedImageT>::image_category()));
+                        typename image::detail::image_traits<DestMaskedImageT>::image_category()),
+                py::call_guard<py::gil_scoped_release>());
+        // the destination pixel type cannot be deduced from the arguments, so only wrap the variant
+        // that warps to the source pixel type
+        if constexpr (std::is_same_v<DestPixelT, SrcPixelT>) {
+            mod.def("warpExposures", &warpExposures<DestExposureT, SrcExposureT>, "srcExposures"_a,
+                    "destBBox"_a, "destWcs"_a, "control"_a, "callback"_a,
+                    "padValue"_a = edgePixel<DestMaskedImageT>(
+                            typename image::detail::image_traits<DestMaskedImageT>::image_category()),
+                    py::call_guard<py::gil_scoped_release>());
+        }
     });
     declareImageWarpingFunctions<DestImageT, SrcImageT>(wrappers);
     declareImageWarpingFunctions<DestMaskedImageT, SrcMaskedImageT>(wrappers);
@@ -141,14 +157,16 @@ void declareWarpingFunctions(lsst::cpputils::python::WrapperCollection &wrappers
 void declareWarpExposure(lsst::cpputils::python::WrapperCollection &wrappers) {
     using PyClass = py::class_<WarpingControl, std::shared_ptr<WarpingControl>>;
     wrappers.wrapType(PyClass(wrappers.module, "WarpingControl"), [](auto &mod, auto cls) {
-        cls.def(py::init<std::string, std::string, int, int, image::MaskPixel>(), "warpingKernelName"_a,
-                "maskWarpingKernelName"_a = "", "cacheSize"_a = 0, "interpLength"_a = 0,
-                "growFullMask"_a = 0);
+        cls.def(py::init<std::string, std::string, int, int, image::MaskPixel, int>(),
+                "warpingKernelName"_a, "maskWarpingKernelName"_a = "", "cacheSize"_a = 0,
+                "interpLength"_a = 0, "growFullMask"_a = 0, "numThreads"_a = 1);
 
         cls.def("getCacheSize", &WarpingControl::getCacheSize);
         cls.def("setCacheSize", &WarpingControl::setCacheSize, "cacheSize"_a);
         cls.def("getInterpLength", &WarpingControl::getInterpLength);
         cls.def("setInterpLength", &WarpingControl::setInterpLength, "interpLength"_a);
+        cls.def("getMaxInterpError", &WarpingControl::getMaxInterpError);
+        cls.def("setMaxInterpError", &WarpingControl::setMaxInterpError, "maxInterpError"_a);
         cls.def("setWarpingKernelName", &WarpingControl::setWarpingKernelName, "warpingKernelName"_a);
         cls.def("getWarpingKernel", &WarpingControl::getWarpingKernel);
         cls.def("setWarpingKernel", &WarpingControl::setWarpingKernel, "warpingKernel"_a);
@@ -161,6 +179,11 @@ void declareWarpExposure(lsst::cpputils::python::WrapperCollection &wrappers) {
         cls.def("setMaskWarpingKernel", &WarpingControl::setMaskWarpingKernel, "maskWarpingKernel"_a);
         cls.def("getGrowFullMask", &WarpingControl::getGrowFullMask);
         cls.def("setGrowFullMask", &WarpingControl::setGrowFullMask, "growFullMask"_a);
+        cls.def("getNumThreads", &WarpingControl::getNumThreads);
+        cls.def("setNumThreads", &WarpingControl::setNumThreads, "numThreads"_a);
+        cls.def("getUseLanczosLookupTable", &WarpingControl::getUseLanczosLookupTable);
+        cls.def("setUseLanczosLookupTable", &WarpingControl::setUseLanczosLookupTable,
+                "useLanczosLookupTable"_a);
         table::io::python::addPersistableMethods(cls);
     });
 }
@@ -27,6 +27,7 @@ import lsst.afw.image as afwImage
 from ._math import warpImage
 from ._math import WarpingControl
 from ._math import warpExposure
+from ._math import warpExposures
 
 
 def computeWarpedBBox(destWcs, srcBBox, srcWcs):
@@ -91,6 +92,12 @@ class WarperConfig(pexConfig.Config):
         doc="``interpLength`` argument to `lsst.afw.math.warpExposure`",
         default=_DefaultInterpLength,
     )
+    maxInterpError = pexConfig.Field(
+        dtype=float,
+        doc="maximum error of adaptive interpolation of source positions (pixels); 0 for fixed "
+            "interpolation bands; see `lsst.afw.math.WarpingControl.setMaxInterpError`",
+        default=0.0,
+    )
     cacheSize = pexConfig.Field(
         dtype=int,
         doc="``cacheSize`` argument to `lsst.afw.math.SeparableKernel.computeCache`",
@@ -101,6 +108,17 @@ class WarperConfig(pexConfig.Config):
         doc="mask bits to grow to full width of image/variance kernel,",
         default=afwImage.Mask.getPlaneBitMask("EDGE"),
     )
+    numThreads = pexConfig.Field(
+        dtype=int,
+        doc="number of threads used to warp each image; 0 for one per hardware thread",
+        default=1,
+    )
+    useLanczosLookupTable = pexConfig.Field(
+        dtype=bool,
+        doc="evaluate Lanczos warping kernels using a shared lookup table? "
+            "see `lsst.afw.math.WarpingControl.setUseLanczosLookupTable`",
+        default=False,
+    )
 
 
 class Warper:
@@ -119,6 +137,14 @@ class Warper:
         see `WarperConfig.maskWarpingKernelName`
     growFullMask : `int`, optional
         mask bits to grow to full width of image/variance kernel
+    numThreads : `int`, optional
+        number of threads used to warp each image; 0 for one per hardware thread
+    useLanczosLookupTable : `bool`, optional
+        evaluate Lanczos warping kernels using a shared lookup table?
+        see `WarperConfig.useLanczosLookupTable`
+    maxInterpError : `float`, optional
+        maximum error of adaptive interpolation (pixels); 0 for fixed interpolation bands;
+        see `WarperConfig.maxInterpError`
     """
     ConfigClass = WarperConfig
 
@@ -127,9 +153,14 @@ class Warper:
                  interpLength=_DefaultInterpLength,
                  cacheSize=_DefaultCacheSize,
                  maskWarpingKernelName="",
-                 growFullMask=afwImage.Mask.getPlaneBitMask("EDGE"),):
+                 growFullMask=afwImage.Mask.getPlaneBitMask("EDGE"),
+                 numThreads=1,
+                 useLanczosLookupTable=False,
+                 maxInterpError=0.0,):
         self._warpingControl = WarpingControl(
-            warpingKernelName, maskWarpingKernelName, cacheSize, interpLength, growFullMask)
+            warpingKernelName, maskWarpingKernelName, cacheSize, interpLength, growFullMask, numThreads)
+        self._warpingControl.setUseLanczosLookupTable(useLanczosLookupTable)
+        self._warpingControl.setMaxInterpError(maxInterpError)
 
     @classmethod
     def fromConfig(cls, config):
@@ -146,6 +177,9 @@ class Warper:
             interpLength=config.interpLength,
             cacheSize=config.cacheSize,
             growFullMask=config.growFullMask,
+            numThreads=config.numThreads,
+            useLanczosLookupTable=config.useLanczosLookupTable,
+            maxInterpError=config.maxInterpError,
         )
 
     def getWarpingKernel(self):
@@ -205,6 +239,35 @@ class Warper:
         warpExposure(destExposure, srcExposure, self._warpingControl)
         return destExposure
 
+    def warpExposures(self, destWcs, srcExposures, destBBox, callback):
+        """Warp many exposures onto one destination grid.
+
+        Parameters
+        ----------
+        destWcs : `lsst.afw.geom.SkyWcs`
+            WCS of warped exposures
+        srcExposures : `list` of `lsst.afw.image.Exposure`
+            exposures to warp; all must have the same pixel type
+        destBBox : `lsst.geom.Box2I`
+            exact parent bbox of warped exposures
+        callback : callable
+            called as ``callback(index, destExposure, numGoodPixels)`` for each
+            source exposure, in order, where ``index`` is the index of the
+            source exposure in ``srcExposures``, ``destExposure`` is the warped
+            exposure (same pixel type as the source exposures)
+            and ``numGoodPixels`` is the number of pixels that were warped
+
+        Notes
+        -----
+        Calls `lsst.afw.math.warpExposures`, which is faster than calling
+        `warpExposure` for each source exposure. The pixels of
+        ``destExposure`` are reused for every source exposure, so
+        ``callback`` must make a deep copy of any warped exposure it keeps.
+
+        The PSF is not warped. To warp the PSF, use `lsst.meas.algorithms.WarpedPsf`
+        """
+        warpExposures(srcExposures, destBBox, destWcs, self._warpingControl, callback)
+
     def warpImage(self, destWcs, srcImage, srcWcs, border=0, maxBBox=None, destBBox=None):
         """Warp an image or masked image.
 
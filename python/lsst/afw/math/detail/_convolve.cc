@@ -54,6 +54,14 @@ void declareByType(lsst::cpputils::python::WrapperCollection &wrappers) {
                 (void (*)(OutImageT &, InImageT const &, lsst::afw::math::Kernel const &,
                           lsst::afw::math::ConvolutionControl const &))
                         convolveWithBruteForce<OutImageT, InImageT>);
+        mod.def("convolveInRowBands",
+                (void (*)(OutImageT &, InImageT const &, lsst::afw::math::Kernel const &,
+                          lsst::afw::math::ConvolutionControl const &))convolveInRowBands<OutImageT, InImageT>);
+        if constexpr (IsFftConvolvable<OutImageT, InImageT>::value) {
+            mod.def("convolveWithFft",
+                    (void (*)(OutImageT &, InImageT const &, lsst::afw::math::Kernel const &,
+                              lsst::afw::math::ConvolutionControl const &))convolveWithFft<OutImageT, InImageT>);
+        }
     });
 }
 template <typename PixelType1, typename PixelType2>
@@ -67,6 +75,7 @@ void declareAll(lsst::cpputils::python::WrapperCollection &wrappers) {
 }  // namespace
 
 void declareConvolve(lsst::cpputils::python::WrapperCollection &wrappers) {
+    wrappers.wrap([](auto &mod) { mod.def("shouldConvolveWithFft", &shouldConvolveWithFft); });
     using PyClass = py::class_<KernelImagesForRegion, std::shared_ptr<KernelImagesForRegion>>;
     auto clsKernelImagesForRegion =
             wrappers.wrapType(PyClass(wrappers.module, "KernelImagesForRegion"), [](auto &mod, auto &cls) {
@@ -38,8 +38,18 @@ namespace detail {
 void wrapSpline(lsst::cpputils::python::WrapperCollection &wrappers) {
     /* Module level */
     wrappers.wrapType(py::class_<Spline>(wrappers.module, "Spline"), [](auto &mod, auto &cls) {
-        cls.def("interpolate", &Spline::interpolate);
+        cls.def("interpolate",
+                (void (Spline::*)(std::vector<double> const &, std::vector<double> &) const) &
+                        Spline::interpolate);
         cls.def("derivative", &Spline::derivative);
+        cls.def(
+                "interpolateWithDerivative",
+                [](Spline const &self, std::vector<double> const &x) {
+                    std::vector<double> y, dydx;
+                    self.interpolate(x, y, dydx);
+                    return py::make_tuple(y, dydx);
+                },
+                "x"_a);
     });
     auto clsTautSpline = wrappers.wrapType(
             py::class_<TautSpline, Spline>(wrappers.module, "TautSpline"), [](auto &mod, auto &cls) {
@@ -36,6 +36,7 @@
 #include "lsst/afw/table/Key.h"
 #include "lsst/afw/table/Schema.h"
 #include "lsst/afw/table/BaseRecord.h"
+#include "lsst/afw/table/BaseColumnView.h"
 #include "lsst/afw/table/FunctorKey.h"
 #include "lsst/afw/table/aggregates.h"
 
@@ -145,6 +146,8 @@ static void declareCoordKey(WrapperCollection &wrappers) {
         cls.def("isValid", &CoordKey::isValid);
         cls.def("get", [](CoordKey &self, BaseRecord const &record) { return self.get(record); });
         cls.def("set", &CoordKey::set);
+        cls.def("getColumns", &CoordKey::getColumns, "columns"_a);
+        cls.def("setColumns", &CoordKey::setColumns, "columns"_a, "values"_a);
     });
 }
 
@@ -164,6 +167,8 @@ static void declareQuadrupoleKey(WrapperCollection &wrappers) {
         cls.def("isValid", &QuadrupoleKey::isValid);
         cls.def("set", &QuadrupoleKey::set);
         cls.def("get", &QuadrupoleKey::get);
+        cls.def("getColumns", &QuadrupoleKey::getColumns, "columns"_a);
+        cls.def("setColumns", &QuadrupoleKey::setColumns, "columns"_a, "values"_a);
     });
 }
 
@@ -177,6 +182,8 @@ static void declareEllipseKey(WrapperCollection &wrappers) {
         cls.def_static("addFields", &EllipseKey::addFields, "schema"_a, "name"_a, "doc"_a, "unit"_a);
         cls.def("get", &EllipseKey::get);
         cls.def("set", &EllipseKey::set);
+        cls.def("getColumns", &EllipseKey::getColumns, "columns"_a);
+        cls.def("setColumns", &EllipseKey::setColumns, "columns"_a, "values"_a);
         cls.def("isValid", &EllipseKey::isValid);
         cls.def("getCore", &EllipseKey::getCore);
         cls.def("getCenter", &EllipseKey::getCenter);
@@ -217,6 +224,8 @@ static void declareCovarianceMatrixKey(WrapperCollection &wrappers, const ::std:
                 cls.def("isValid", &CovarianceMatrixKey<T, N>::isValid);
                 cls.def("setElement", &CovarianceMatrixKey<T, N>::setElement);
                 cls.def("getElement", &CovarianceMatrixKey<T, N>::getElement);
+                cls.def("getColumns", &CovarianceMatrixKey<T, N>::getColumns, "columns"_a);
+                cls.def("setColumns", &CovarianceMatrixKey<T, N>::setColumns, "columns"_a, "values"_a);
             });
 }
 
@@ -0,0 +1,183 @@
+# This file is part of afw.
+#
+# Developed for the LSST Data Management System.
+# This product includes software developed by the LSST Project
+# (https://www.lsst.org).
+# See the COPYRIGHT file at the top-level directory of this distribution
+# for details of code ownership.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+"""Conversions between afw.table catalogs and Apache Arrow record batches.
+
+These are used by `Catalog.asArrow`, `Catalog.fromArrow`,
+`Catalog.writeParquet` and `Catalog.readParquet`; pyarrow is only imported
+when one of them is called.
+
+Each Arrow field carries the afw field type, documentation, units and (for
+strings and arrays) size in its metadata, and the schema carries the
+catalog's aliases, so catalogs round-trip through Arrow and Parquet with
+the same schema.  Tables from other sources are read with field types
+inferred from their Arrow types.
+"""
+
+__all__ = []
+
+import json
+
+import numpy as np
+
+from ._schema import Schema
+
+
+# afw scalar types and the Arrow types that store them
+_SCALAR_TYPES = {
+    "B": "uint8",
+    "U": "uint16",
+    "I": "int32",
+    "L": "int64",
+    "F": "float32",
+    "D": "float64",
+    "Angle": "float64",
+}
+
+# afw type codes for Arrow types, used when there is no afw metadata
+_INFERRED_TYPES = {
+    "uint8": "B",
+    "uint16": "U",
+    "int32": "I",
+    "int64": "L",
+    "float": "F",
+    "double": "D",
+}
+
+
+def _arrowType(pa, typeString):
+    if typeString.startswith("Array"):
+        return getattr(pa, _SCALAR_TYPES[typeString[len("Array"):]])()
+    return getattr(pa, _SCALAR_TYPES[typeString])()
+
+
+def catalogToArrow(catalog):
+    """Return a `pyarrow.RecordBatch` with the contents of a catalog.
+
+    Arrow requires each column to be contiguous, while afw.table stores
+    records row by row, so every column is copied once (non-contiguous
+    catalogs are first deep-copied).  Flags are unpacked to booleans and
+    fixed-size arrays become fixed-size lists.
+    """
+    import pyarrow as pa
+
+    if not catalog.isContiguous():
+        catalog = catalog.copy(deep=True)
+    columns = []
+    fields = []
+    for name, item in catalog.schema.extract("*", ordered=True).items():
+        key = item.key
+        typeString = key.getTypeString()
+        metadata = {"afw_type": typeString, "doc": item.field.getDoc(), "units": item.field.getUnits()}
+        if typeString == "Flag":
+            array = pa.array(catalog[key], type=pa.bool_())
+        elif typeString == "String":
+            metadata["size"] = str(key.getSize())
+            array = pa.array([record.get(key) for record in catalog], type=pa.string())
+        elif typeString.startswith("Array"):
+            valueType = _arrowType(pa, typeString)
+            metadata["size"] = str(key.getSize())
+            if key.isVariableLength():
+                array = pa.array([record.get(key) for record in catalog], type=pa.list_(valueType))
+            else:
+                values = np.ascontiguousarray(catalog.columns.get(key)).reshape(-1)
+                array = pa.FixedSizeListArray.from_arrays(pa.array(values, type=valueType), key.getSize())
+        else:
+            array = pa.array(np.ascontiguousarray(catalog.columns.get(key)),
+                             type=_arrowType(pa, typeString))
+        columns.append(array)
+        fields.append(pa.field(name, array.type, metadata=metadata))
+    aliases = {alias: target for alias, target in catalog.schema.getAliasMap().items()}
+    schema = pa.schema(fields, metadata={"afw_aliases": json.dumps(aliases)})
+    return pa.RecordBatch.from_arrays(columns, schema=schema)
+
+
+def _combine(pa, column):
+    """Return an Array with the values of an Array or ChunkedArray."""
+    if isinstance(column, pa.ChunkedArray):
+        if column.num_chunks == 0:
+            return pa.array([], type=column.type)
+        return pa.concat_arrays(column.chunks)
+    return column
+
+
+def _fieldType(pa, field):
+    """Return the afw type code and size for an Arrow field."""
+    metadata = {k.decode(): v.decode() for k, v in (field.metadata or {}).items()}
+    if "afw_type" in metadata:
+        return metadata["afw_type"], int(metadata.get("size", 0)), metadata
+    arrowType = field.type
+    if pa.types.is_boolean(arrowType):
+        return "Flag", 0, metadata
+    if pa.types.is_string(arrowType) or pa.types.is_large_string(arrowType):
+        return "String", None, metadata
+    if pa.types.is_fixed_size_list(arrowType) or pa.types.is_list(arrowType):
+        valueType = str(arrowType.value_type)
+        if valueType in _INFERRED_TYPES and valueType != "int64":
+            size = arrowType.list_size if pa.types.is_fixed_size_list(arrowType) else 0
+            return "Array" + _INFERRED_TYPES[valueType], size, metadata
+    elif str(arrowType) in _INFERRED_TYPES:
+        return _INFERRED_TYPES[str(arrowType)], 0, metadata
+    raise TypeError(f"Arrow field {field.name!r} has unsupported type {arrowType}")
+
+
+def catalogFromArrow(cls, data):
+    """Return a new catalog of type ``cls`` with the contents of a
+    `pyarrow.RecordBatch` or `pyarrow.Table`.
+
+    Null values are not supported.
+    """
+    import pyarrow as pa
+
+    columns = [_combine(pa, data.column(i)) for i in range(data.num_columns)]
+    schema = Schema()
+    keys = []
+    for field, column in zip(data.schema, columns):
+        typeString, size, metadata = _fieldType(pa, field)
+        if column.null_count:
+            raise ValueError(f"Arrow field {field.name!r} has null values")
+        if size is None:  # inferred string size
+            size = max([len(s.encode()) for s in column.to_pylist()], default=0) or 1
+        kwargs = {"doc": metadata.get("doc", ""), "units": metadata.get("units", "")}
+        if typeString == "String" or typeString.startswith("Array"):
+            kwargs["size"] = size
+        keys.append(schema.addField(field.name, type=typeString, **kwargs))
+    aliases = json.loads((data.schema.metadata or {}).get(b"afw_aliases", b"{}").decode())
+    for alias, target in aliases.items():
+        schema.getAliasMap().set(alias, target)
+
+    catalog = cls(schema)
+    catalog.resize(data.num_rows)
+    for key, column in zip(keys, columns):
+        typeString = key.getTypeString()
+        if typeString == "String" or (typeString.startswith("Array") and key.isVariableLength()):
+            values = column.to_pylist()
+            if typeString != "String":
+                dtype = np.dtype(_SCALAR_TYPES[typeString[len("Array"):]])
+                values = [np.array(v, dtype=dtype) for v in values]
+            for record, value in zip(catalog, values):
+                record.set(key, value)
+        elif typeString.startswith("Array"):
+            values = column.flatten().to_numpy(zero_copy_only=False)
+            catalog[key] = values.reshape(len(column), key.getSize())
+        else:
+            catalog[key] = column.to_numpy(zero_copy_only=False)
+    return catalog
@@ -40,6 +40,7 @@ and makes wrapping Base catalogs more similar to all other types of catalog.
 #include "lsst/afw/table/BaseColumnView.h"
 #include "lsst/afw/table/BaseRecord.h"
 #include "lsst/afw/table/BaseTable.h"
+#include "lsst/afw/table/SortKey.h"
 #include "lsst/afw/table/python/catalog.h"
 #include "lsst/afw/table/python/columnView.h"
 
@@ -170,11 +171,31 @@ PyBaseTable declareBaseTable(WrapperCollection &wrappers) {
     });
 }
 
+template <typename T>
+void declareSortKeyConstructor(py::class_<SortKey> &cls) {
+    cls.def(py::init<Key<T> const &>(), "key"_a);
+    py::implicitly_convertible<Key<T>, SortKey>();
+}
+
+void declareSortKey(WrapperCollection &wrappers) {
+    wrappers.wrapType(py::class_<SortKey>(wrappers.module, "SortKey"), [](auto &mod, auto &cls) {
+        declareSortKeyConstructor<std::uint8_t>(cls);
+        declareSortKeyConstructor<std::uint16_t>(cls);
+        declareSortKeyConstructor<std::int32_t>(cls);
+        declareSortKeyConstructor<std::int64_t>(cls);
+        declareSortKeyConstructor<float>(cls);
+        declareSortKeyConstructor<double>(cls);
+        declareSortKeyConstructor<lsst::geom::Angle>(cls);
+        declareSortKeyConstructor<Flag>(cls);
+    });
+}
+
 }  // namespace
 
 void wrapBase(WrapperCollection &wrappers) {
     wrappers.addSignatureDependency("lsst.daf.base");
 
+    declareSortKey(wrappers);
     auto clsBaseTable = declareBaseTable(wrappers);
     auto clsBaseRecord = declareBaseRecord(wrappers);
     auto clsBaseCatalog = table::python::declareCatalog<BaseRecord>(wrappers, "Base");
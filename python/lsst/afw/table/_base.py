@@ -180,7 +180,7 @@ class Catalog(metaclass=TemplateMeta):
         """
         return self.cast(type(self), deep)
 
-    def extend(self, iterable, deep=False, mapper=None):
+    def extend(self, iterable, deep=False, mapper=None, numThreads=1):
         """Append all records in the given iterable to the catalog.
 
         Parameters
@@ -192,6 +192,10 @@ class Catalog(metaclass=TemplateMeta):
             mapper is not `None` (that always implies `True`).
         mapper : `lsst.afw.table.schemaMapper.SchemaMapper`, optional
             Used to translate records.
+        numThreads : `int`, optional
+            Number of threads to copy records with when ``iterable`` is a
+            catalog of the same type and ``mapper`` is not `None`; 0 means
+            one per hardware thread.
         """
         self._columns = None
         # We can't use isinstance here, because the SchemaMapper symbol isn't available
@@ -201,7 +205,7 @@ class Catalog(metaclass=TemplateMeta):
             deep = None
         if isinstance(iterable, type(self)):
             if mapper is not None:
-                self._extend(iterable, mapper)
+                self._extend(iterable, mapper, numThreads)
             else:
                 self._extend(iterable, deep)
         else:
@@ -308,6 +312,67 @@ class Catalog(metaclass=TemplateMeta):
             )
         return cls(columns, meta=meta, copy=False)
 
+    def asArrow(self):
+        """Return a `pyarrow.RecordBatch` with the contents of this catalog.
+
+        Returns
+        -------
+        batch : `pyarrow.RecordBatch`
+            Record batch with one column per field.  Flags are unpacked to
+            booleans, fixed-size arrays become fixed-size lists, and each
+            field's afw type, documentation and units are kept in its
+            metadata.
+
+        Notes
+        -----
+        Arrow columns must be contiguous, so each column is copied once;
+        unlike `asAstropy`, this cannot be a view.
+        """
+        from ._arrow import catalogToArrow
+        return catalogToArrow(self)
+
+    @classmethod
+    def fromArrow(cls, data):
+        """Return a new catalog with the contents of a `pyarrow.RecordBatch`
+        or `pyarrow.Table`.
+
+        Field types are taken from the metadata written by `asArrow`, or
+        inferred from the Arrow types when it is absent.
+
+        Raises
+        ------
+        TypeError
+            Raised if a column has an Arrow type with no afw equivalent.
+        ValueError
+            Raised if a column has null values.
+        """
+        from ._arrow import catalogFromArrow
+        return catalogFromArrow(cls, data)
+
+    def writeParquet(self, filename):
+        """Write this catalog to a Parquet file.
+
+        Only the fields are written; first-class objects attached to
+        records (such as Footprints) and catalog metadata are not.
+        """
+        import pyarrow
+        import pyarrow.parquet
+        pyarrow.parquet.write_table(pyarrow.Table.from_batches([self.asArrow()]), filename)
+
+    @classmethod
+    def readParquet(cls, filename, columns=None):
+        """Read a catalog from a Parquet file.
+
+        Parameters
+        ----------
+        filename : `str`
+            Name of the file to read.
+        columns : `list` [`str`], optional
+            Names of the columns to read; `None` reads them all.
+        """
+        import pyarrow.parquet
+        return cls.fromArrow(pyarrow.parquet.read_table(filename, columns=columns))
+
     def __dir__(self):
         """
         This custom dir is necessary due to the custom getattr below.
@@ -120,6 +120,13 @@ static void declareBitsColumn(WrapperCollection &wrappers) {
                 "key"_a);
         cls.def("getMask", (BitsColumn::SizeT(BitsColumn::*)(std::string const &) const) & BitsColumn::getMask,
                 "name"_a);
+        cls.def("getMask",
+                (BitsColumn::SizeT(BitsColumn::*)(std::vector<std::string> const &) const) &
+                        BitsColumn::getMask,
+                "names"_a);
+        cls.def("select", &BitsColumn::select, "allOf"_a = 0, "anyOf"_a = 0, "noneOf"_a = 0);
+        cls.def("selectIndices", &BitsColumn::selectIndices, "allOf"_a = 0, "anyOf"_a = 0,
+                "noneOf"_a = 0);
     });
 }
 
@@ -0,0 +1,93 @@
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <type_traits>
+
+#include "pybind11/pybind11.h"
+
+#include "ndarray/pybind11.h"
+
+#include "lsst/cpputils/python.h"
+
+#include "lsst/afw/table/ColumnStore.h"
+#include "lsst/afw/table/Simple.h"
+#include "lsst/afw/table/Source.h"
+#include "lsst/afw/table/Exposure.h"
+
+namespace py = pybind11;
+using namespace py::literals;
+
+namespace lsst {
+namespace afw {
+namespace table {
+
+using cpputils::python::WrapperCollection;
+
+namespace {
+
+using PyColumnStore = py::class_<ColumnStore, std::shared_ptr<ColumnStore>>;
+
+template <typename RecordT>
+void declareCatalogOverloads(PyColumnStore &cls) {
+    cls.def(py::init<CatalogT<RecordT> const &, int>(), "catalog"_a, "numThreads"_a = 1);
+    cls.def("assignTo", &ColumnStore::assignTo<RecordT>, "catalog"_a, "numThreads"_a = 1);
+}
+
+// Schema::findAndApply functor that returns a field's column as a NumPy array.
+struct GetColumn {
+    template <typename T>
+    void operator()(SchemaItem<T> const &item) const {
+        if constexpr (std::is_same_v<T, std::string>) {
+            throw LSST_EXCEPT(pex::exceptions::NotFoundError,
+                              "String field '" + item.field.getName() + "' is not stored in a ColumnStore");
+        } else {
+            result = py::cast(self.get(item.key));
+        }
+    }
+
+    ColumnStore const &self;
+    mutable py::object result;
+};
+
+}  // namespace
+
+void wrapColumnStore(WrapperCollection &wrappers) {
+    wrappers.wrapType(PyColumnStore(wrappers.module, "ColumnStore"), [](auto &mod, auto &cls) {
+        declareCatalogOverloads<BaseRecord>(cls);
+        declareCatalogOverloads<SimpleRecord>(cls);
+        declareCatalogOverloads<SourceRecord>(cls);
+        declareCatalogOverloads<ExposureRecord>(cls);
+        cls.def("getSchema", &ColumnStore::getSchema);
+        cls.def_property_readonly("schema", &ColumnStore::getSchema);
+        cls.def("__len__", &ColumnStore::size);
+        cls.def("__getitem__", [](ColumnStore const &self, std::string const &name) {
+            GetColumn functor{self, py::none()};
+            self.getSchema().findAndApply(name, functor);
+            return functor.result;
+        });
+    });
+}
+
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
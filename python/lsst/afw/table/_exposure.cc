@@ -43,6 +43,7 @@
 #include "lsst/afw/table/BaseTable.h"
 #include "lsst/afw/table/Catalog.h"
 #include "lsst/afw/table/Exposure.h"
+#include "lsst/afw/table/ExposureSkyIndex.h"
 #include "lsst/afw/table/python/catalog.h"
 #include "lsst/afw/table/python/columnView.h"
 #include "lsst/afw/table/python/sortedCatalog.h"
@@ -151,7 +152,40 @@ PyExposureCatalog declareExposureCatalog(WrapperCollection &wrappers) {
                                "filename"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
                 cls.def_static("readFits", (Catalog(*)(fits::MemFileManager &, int, int)) & Catalog::readFits,
                                "manager"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0);
+                cls.def_static(
+                        "readFits",
+                        [](std::string const &filename, int hdu, int flags,
+                           std::vector<std::string> const &columns,
+                           std::optional<io::FitsRowFilter> const &rows) {
+                            return Catalog::readFits(filename, hdu, flags, columns,
+                                                     rows ? *rows : io::FitsRowFilter());
+                        },
+                        "filename"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0,
+                        "columns"_a = std::vector<std::string>(), "rows"_a = py::none());
+                cls.def_static(
+                        "readFits",
+                        [](fits::MemFileManager &manager, int hdu, int flags,
+                           std::vector<std::string> const &columns,
+                           std::optional<io::FitsRowFilter> const &rows) {
+                            return Catalog::readFits(manager, hdu, flags, columns,
+                                                     rows ? *rows : io::FitsRowFilter());
+                        },
+                        "manager"_a, "hdu"_a = fits::DEFAULT_HDU, "flags"_a = 0,
+                        "columns"_a = std::vector<std::string>(), "rows"_a = py::none());
                 // readFits taking Fits objects not wrapped, because Fits objects are not wrapped.
+                cls.def_static(
+                        "concatenate",
+                        [](std::vector<Catalog> const &catalogs, int numThreads) {
+                            return Catalog::concatenate(catalogs, numThreads);
+                        },
+                        "catalogs"_a, "numThreads"_a = 1);
+                cls.def_static(
+                        "concatenate",
+                        [](std::shared_ptr<ExposureTable> const &table, SchemaMapper const &mapper,
+                           std::vector<Catalog> const &catalogs, int numThreads) {
+                            return Catalog::concatenate(table, mapper, catalogs, numThreads);
+                        },
+                        "table"_a, "mapper"_a, "catalogs"_a, "numThreads"_a = 1);
 
                 cls.def("subset",
                         (Catalog(Catalog::*)(ndarray::Array<bool const, 1> const &) const) & Catalog::subset,
@@ -171,6 +205,27 @@ PyExposureCatalog declareExposureCatalog(WrapperCollection &wrappers) {
             });
 };
 
+void declareExposureSkyIndex(WrapperCollection &wrappers) {
+    using PyExposureSkyIndex = py::class_<ExposureSkyIndex>;
+    wrappers.wrapType(PyExposureSkyIndex(wrappers.module, "ExposureSkyIndex"), [](auto &mod, auto &cls) {
+        cls.def(py::init<ExposureCatalog const &>(), "catalog"_a);
+        cls.def("getCatalog", &ExposureSkyIndex::getCatalog);
+        cls.def_property_readonly("catalog", &ExposureSkyIndex::getCatalog);
+        cls.def("__len__", &ExposureSkyIndex::size);
+        cls.def("findContaining", &ExposureSkyIndex::findContaining, "coord"_a,
+                "includeValidPolygon"_a = false);
+        cls.def("subsetContaining",
+                (ExposureCatalog(ExposureSkyIndex::*)(lsst::geom::SpherePoint const &, bool) const) &
+                        ExposureSkyIndex::subsetContaining,
+                "coord"_a, "includeValidPolygon"_a = false);
+        cls.def("subsetContaining",
+                (std::vector<ExposureCatalog>(ExposureSkyIndex::*)(
+                        std::vector<lsst::geom::SpherePoint> const &, bool) const) &
+                        ExposureSkyIndex::subsetContaining,
+                "coords"_a, "includeValidPolygon"_a = false);
+    });
+}
+
 }  // anonymous namespace
 
 void wrapExposure(WrapperCollection &wrappers) {
@@ -179,10 +234,15 @@ void wrapExposure(WrapperCollection &wrappers) {
     // circular dependencies until at least afw.image uses WrapperCollection
     // in DM-20703
 
+    // ExposureFitsFlags enum values are used as integer masks, so wrap as attributes instead of an enum
+    wrappers.module.attr("EXPOSURE_IO_PARALLEL_ARCHIVE") =
+            static_cast<int>(ExposureFitsFlags::EXPOSURE_IO_PARALLEL_ARCHIVE);
+
     auto clsExposureRecord = declareExposureRecord(wrappers);
     auto clsExposureTable = declareExposureTable(wrappers);
     auto clsExposureColumnView = table::python::declareColumnView<ExposureRecord>(wrappers, "Exposure");
     auto clsExposureCatalog = declareExposureCatalog(wrappers);
+    declareExposureSkyIndex(wrappers);
 
     clsExposureRecord.attr("Table") = clsExposureTable;
     clsExposureRecord.attr("ColumnView") = clsExposureColumnView;
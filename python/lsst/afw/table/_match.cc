@@ -23,6 +23,7 @@
 
 #include "pybind11/pybind11.h"
 #include "pybind11/stl.h"
+#include "ndarray/pybind11.h"
 
 #include "lsst/cpputils/python.h"
 
@@ -30,6 +31,8 @@
 #include "lsst/afw/table/Simple.h"
 #include "lsst/afw/table/Source.h"
 #include "lsst/afw/table/Match.h"
+#include "lsst/afw/table/MatchIndex.h"
+#include "lsst/afw/table/SkyPixels.h"
 
 namespace py = pybind11;
 using namespace pybind11::literals;
@@ -64,12 +67,19 @@ void declareMatch2(WrapperCollection &wrappers, std::string const &prefix) {
 
     // Free Functions
     wrappers.wrap([](auto &mod) {
-        mod.def("unpackMatches", &unpackMatches<Catalog1, Catalog2>, "matches"_a, "cat1"_a, "cat2"_a);
+        mod.def("unpackMatches", &unpackMatches<Catalog1, Catalog2>, "matches"_a, "cat1"_a, "cat2"_a,
+                "numThreads"_a = 1);
 
         mod.def("matchRaDec",
                 (MatchList(*)(Catalog1 const &, Catalog2 const &, lsst::geom::Angle,
                               MatchControl const &))matchRaDec<Catalog1, Catalog2>,
                 "cat1"_a, "cat2"_a, "radius"_a, "mc"_a = MatchControl());
+        mod.def("matchRaDecIndices",
+                (MatchIndices(*)(Catalog1 const &, Catalog2 const &, lsst::geom::Angle,
+                                 MatchControl const &))matchRaDecIndices<Catalog1, Catalog2>,
+                "cat1"_a, "cat2"_a, "radius"_a, "mc"_a = MatchControl());
+        // Wrapped for packMatches in _match.py, which also takes Match objects.
+        mod.def("_packMatchIndices", &packMatches<Catalog1, Catalog2>, "matches"_a, "cat1"_a, "cat2"_a);
     });
 };
 
@@ -81,17 +91,51 @@ void declareMatch1(WrapperCollection &wrappers) {
         mod.def("matchRaDec",
                 (MatchList(*)(Catalog const &, lsst::geom::Angle, MatchControl const &))matchRaDec<Catalog>,
                 "cat"_a, "radius"_a, "mc"_a = MatchControl());
+        mod.def("matchRaDecIndices",
+                (MatchIndices(*)(Catalog const &, lsst::geom::Angle,
+                                 MatchControl const &))matchRaDecIndices<Catalog>,
+                "cat"_a, "radius"_a, "mc"_a = MatchControl());
+    });
+}
+
+/// @internal Declare MatchIndex on the records of a Catalog, with Match objects returned for queries on
+/// each of QueryCatalogs (those for which the Match type is wrapped).
+template <typename Catalog, typename... QueryCatalogs>
+void declareMatchIndex(WrapperCollection &wrappers, std::string const &prefix) {
+    using Class = MatchIndex<typename Catalog::Record>;
+    using PyClass = py::class_<Class, std::shared_ptr<Class>>;
+    wrappers.wrapType(PyClass(wrappers.module, (prefix + "MatchIndex").c_str()), [](auto &mod, auto &cls) {
+        cls.def_static("makeSky", &Class::makeSky, "catalog"_a);
+        cls.def_static("makeXy", &Class::makeXy, "catalog"_a);
+        cls.def("isSky", &Class::isSky);
+        cls.def("__len__", &Class::size);
+        (cls.def("matchRaDec", &Class::template matchRaDec<QueryCatalogs>, "catalog"_a, "radius"_a,
+                 "mc"_a = MatchControl()),
+         ...);
+        cls.def("matchRaDecIndices", &Class::template matchRaDecIndices<SimpleCatalog>, "catalog"_a,
+                "radius"_a, "mc"_a = MatchControl());
+        cls.def("matchRaDecIndices", &Class::template matchRaDecIndices<SourceCatalog>, "catalog"_a,
+                "radius"_a, "mc"_a = MatchControl());
+        cls.def("matchXy", &Class::matchXy, "catalog"_a, "radius"_a, "mc"_a = MatchControl());
+        cls.def("matchXyIndices", &Class::matchXyIndices, "catalog"_a, "radius"_a, "mc"_a = MatchControl());
     });
 }
 
 }  // namespace
 
 void wrapMatch(WrapperCollection &wrappers) {
+    wrappers.addSignatureDependency("lsst.sphgeom");
     wrappers.wrapType(py::class_<MatchControl>(wrappers.module, "MatchControl"), [](auto &mod, auto &cls) {
         cls.def(py::init<>());
         LSST_DECLARE_CONTROL_FIELD(cls, MatchControl, findOnlyClosest);
         LSST_DECLARE_CONTROL_FIELD(cls, MatchControl, symmetricMatch);
         LSST_DECLARE_CONTROL_FIELD(cls, MatchControl, includeMismatches);
+        LSST_DECLARE_CONTROL_FIELD(cls, MatchControl, numThreads);
+    });
+    wrappers.wrapType(py::class_<MatchIndices>(wrappers.module, "MatchIndices"), [](auto &mod, auto &cls) {
+        cls.def_readonly("first", &MatchIndices::first);
+        cls.def_readonly("second", &MatchIndices::second);
+        cls.def_readonly("distance", &MatchIndices::distance);
     });
 
     declareMatch2<SimpleCatalog, SimpleCatalog>(wrappers, "Simple");
@@ -99,6 +143,30 @@ void wrapMatch(WrapperCollection &wrappers) {
     declareMatch2<SourceCatalog, SourceCatalog>(wrappers, "Source");
     declareMatch1<SimpleCatalog>(wrappers);
     declareMatch1<SourceCatalog>(wrappers);
+    declareMatchIndex<SimpleCatalog, SimpleCatalog>(wrappers, "Simple");
+    declareMatchIndex<SourceCatalog, SimpleCatalog, SourceCatalog>(wrappers, "Source");
+
+    wrappers.wrapType(py::class_<SkyPixelRange>(wrappers.module, "SkyPixelRange"), [](auto &mod, auto &cls) {
+        cls.def_readonly("pixel", &SkyPixelRange::pixel);
+        cls.def_readonly("begin", &SkyPixelRange::begin);
+        cls.def_readonly("end", &SkyPixelRange::end);
+        cls.def("__repr__", [](SkyPixelRange const &self) {
+            return "SkyPixelRange(pixel=" + std::to_string(self.pixel) + ", begin=" +
+                   std::to_string(self.begin) + ", end=" + std::to_string(self.end) + ")";
+        });
+    });
+    wrappers.wrap([](auto &mod) {
+        mod.attr("NO_SKY_PIXEL") = py::int_(NO_SKY_PIXEL);
+        mod.def("computeSkyPixels", &computeSkyPixels<SimpleRecord>, "catalog"_a, "pixelization"_a,
+                "numThreads"_a = 1);
+        mod.def("computeSkyPixels", &computeSkyPixels<SourceRecord>, "catalog"_a, "pixelization"_a,
+                "numThreads"_a = 1);
+        mod.def("findSkyPixelRanges", &findSkyPixelRanges, "pixels"_a);
+        mod.def("sortBySkyPixel", &sortBySkyPixel<SimpleRecord>, "catalog"_a, "pixelization"_a,
+                "numThreads"_a = 1);
+        mod.def("sortBySkyPixel", &sortBySkyPixel<SourceRecord>, "catalog"_a, "pixelization"_a,
+                "numThreads"_a = 1);
+    });
 
     wrappers.wrap([](auto &mod) {
         mod.def("matchXy",
@@ -107,6 +175,13 @@ void wrapMatch(WrapperCollection &wrappers) {
                 "cat1"_a, "cat2"_a, "radius"_a, "mc"_a = MatchControl());
         mod.def("matchXy", (SourceMatchVector(*)(SourceCatalog const &, double, MatchControl const &))matchXy,
                 "cat"_a, "radius"_a, "mc"_a = MatchControl());
+        mod.def("matchXyIndices",
+                (MatchIndices(*)(SourceCatalog const &, SourceCatalog const &, double,
+                                 MatchControl const &))matchXyIndices,
+                "cat1"_a, "cat2"_a, "radius"_a, "mc"_a = MatchControl());
+        mod.def("matchXyIndices",
+                (MatchIndices(*)(SourceCatalog const &, double, MatchControl const &))matchXyIndices, "cat"_a,
+                "radius"_a, "mc"_a = MatchControl());
     });
 }
 
@@ -25,7 +25,7 @@ import numpy as np
 
 from ._base import BaseCatalog
 from ._schema import Schema
-from ._table import SimpleMatch, ReferenceMatch, SourceMatch
+from ._table import SimpleMatch, ReferenceMatch, SourceMatch, MatchIndices, _packMatchIndices
 
 
 def __repr__(self):  # noqa: N807
@@ -106,8 +106,9 @@ for matchCls in (SimpleMatch, ReferenceMatch, SourceMatch):
 #    matchCls.__setstate__ = __setstate__
 
 
-def packMatches(matches):
-    """Make a catalog of matches from a sequence of matches.
+def packMatches(matches, cat1=None, cat2=None):
+    """Make a catalog of matches from a sequence of matches, or from match
+    columns.
 
     The catalog contains three fields:
     - first: the ID of the first source record in each match
@@ -120,7 +121,12 @@ def packMatches(matches):
         Sequence of matches, typically of type SimpleMatch,
         ReferenceMatch or SourceMatch.  Each element must support:
         `.first.getId()`->int, `.second.getId()->int` and
-        `.distance->float`.
+        `.distance->float`.  May instead be a `MatchIndices`, as returned
+        by `matchRaDecIndices`, in which case ``cat1`` and ``cat2`` must be
+        given.
+    cat1, cat2 : `SimpleCatalog` or `SourceCatalog`, optional
+        The catalogs the positions in a `MatchIndices` refer to.  Unused for
+        a sequence of matches.
 
     Returns
     -------
@@ -133,7 +139,14 @@ def packMatches(matches):
     related to SWIG limitations. It might be practical to wrap the
     overloaded C++ functions with pybind11, but there didn't seem much
     point.
+
+    Match columns are packed in C++, without making Match objects;
+    mismatches among them are omitted.
     """
+    if isinstance(matches, MatchIndices):
+        if cat1 is None or cat2 is None:
+            raise TypeError("cat1 and cat2 are required to pack MatchIndices")
+        return _packMatchIndices(matches, cat1, cat2)
     schema = Schema()
     outKey1 = schema.addField("first", type=np.int64,
                               doc="ID for first source record in match.")
@@ -39,6 +39,7 @@ void wrapAliasMap(WrapperCollection&);
 void wrapArrays(WrapperCollection&);
 void wrapBase(WrapperCollection&);
 void wrapBaseColumnView(WrapperCollection&);
+void wrapColumnStore(WrapperCollection&);
 void wrapExposure(WrapperCollection&);
 void wrapIdFactory(WrapperCollection&);
 void wrapMatch(WrapperCollection&);
@@ -55,6 +56,7 @@ PYBIND11_MODULE(_table, mod) {
     wrapSchema(wrappers);
     wrapSchemaMapper(wrappers);
     wrapBaseColumnView(wrappers);
+    wrapColumnStore(wrappers);
     wrapBase(wrappers);
     wrapIdFactory(wrappers);
     wrapArrays(wrappers);
@@ -23,7 +23,9 @@
 
 #include "lsst/cpputils/python.h"
 
+#include "lsst/afw/table/io/FitsReader.h"
 #include "lsst/afw/table/io/FitsSchemaInputMapper.h"
+#include "lsst/afw/table/io/FitsWriter.h"
 
 namespace py = pybind11;
 using namespace py::literals;
@@ -38,6 +40,27 @@ void wrapFits(cpputils::python::WrapperCollection& wrappers) {
         mod.def("setPreppedRowsFactor",
                 [](std::size_t n) { FitsSchemaInputMapper::PREPPED_ROWS_FACTOR = n; });
         mod.def("getPreppedRowsFactor", []() { return FitsSchemaInputMapper::PREPPED_ROWS_FACTOR; });
+        mod.def("setReadChunkBytes", [](std::size_t n) { FitsSchemaInputMapper::READ_CHUNK_BYTES = n; });
+        mod.def("getReadChunkBytes", []() { return FitsSchemaInputMapper::READ_CHUNK_BYTES; });
+        mod.def("setReadThreads", [](int n) { FitsSchemaInputMapper::READ_THREADS = n; });
+        mod.def("getReadThreads", []() { return FitsSchemaInputMapper::READ_THREADS; });
+        mod.def("setMapRows", [](bool b) { FitsSchemaInputMapper::MAP_ROWS = b; });
+        mod.def("getMapRows", []() { return FitsSchemaInputMapper::MAP_ROWS; });
+        mod.def("setWriteChunkBytes", [](std::size_t n) { FitsWriter::WRITE_CHUNK_BYTES = n; });
+        mod.def("getWriteChunkBytes", []() { return FitsWriter::WRITE_CHUNK_BYTES; });
+        mod.def("setWriteThreads", [](int n) { FitsWriter::WRITE_THREADS = n; });
+        mod.def("getWriteThreads", []() { return FitsWriter::WRITE_THREADS; });
+    });
+    wrappers.wrapType(py::class_<FitsRowFilter>(wrappers.module, "FitsRowFilter"), [](auto& mod, auto& cls) {
+        cls.def(py::init<std::size_t, std::size_t>(), "begin"_a = 0, "end"_a = FitsRowFilter::END);
+        cls.def(py::init<std::string const&, std::string const&, double, std::size_t, std::size_t>(),
+                "field"_a, "comparison"_a, "value"_a, "begin"_a = 0, "end"_a = FitsRowFilter::END);
+        cls.def_property_readonly("begin", &FitsRowFilter::getBegin);
+        cls.def_property_readonly("end", &FitsRowFilter::getEnd);
+        cls.def("hasComparison", &FitsRowFilter::hasComparison);
+        cls.def_property_readonly("field", &FitsRowFilter::getField);
+        cls.def_property_readonly("comparison", &FitsRowFilter::getComparison);
+        cls.def_property_readonly("value", &FitsRowFilter::getValue);
     });
 }
 
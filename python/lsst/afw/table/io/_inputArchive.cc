@@ -40,6 +40,7 @@ void wrapInputArchive(cpputils::python::WrapperCollection &wrappers) {
     wrappers.wrapType(PyInputArchive(wrappers.module, "InputArchive"), [](auto &mod, auto &cls) {
         cls.def("get", &InputArchive::get<Persistable>);
         cls.def("readFits", &InputArchive::readFits);
+        cls.def_static("readFitsLazy", &InputArchive::readFitsLazy);
     });
 }
 
@@ -44,6 +44,8 @@ void wrapOutputArchive(cpputils::python::WrapperCollection &wrappers) {
                 py::overload_cast<std::shared_ptr<Persistable const>, bool>(&OutputArchive::put),
                 "obj"_a, "permissive"_a=false
                 );
+        cls.def("setDeduplicate", &OutputArchive::setDeduplicate);
+        cls.def("getDeduplicate", &OutputArchive::getDeduplicate);
         cls.def("writeFits", &OutputArchive::writeFits);
     });
 }
@@ -21,6 +21,9 @@
 
 #include "pybind11/pybind11.h"
 
+#include <cstdint>
+#include <vector>
+
 #include "lsst/cpputils/python.h"
 
 #include "lsst/afw/table/io/Persistable.h"
@@ -49,6 +52,10 @@ void wrapPersistable(cpputils::python::WrapperCollection &wrappers) {
                 (void (Persistable::*)(fits::MemFileManager &, std::string const &) const) &
                         Persistable::writeFits,
                 "manager"_a, "mode"_a = "w");
+        cls.def("writeBinary", [](Persistable const &self) {
+            std::vector<std::uint8_t> buffer = self.writeBinary();
+            return py::bytes(reinterpret_cast<char const *>(buffer.data()), buffer.size());
+        });
         cls.def("isPersistable", &Persistable::isPersistable);
     });
 }
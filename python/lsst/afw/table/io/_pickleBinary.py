@@ -0,0 +1,66 @@
+# This file is part of afw.
+#
+# Developed for the LSST Data Management System.
+# This product includes software developed by the LSST Project
+# (https://www.lsst.org).
+# See the COPYRIGHT file at the top-level directory of this distribution
+# for details of code ownership.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+__all__ = ["reduceToBinary", "unreduceFromBinary"]
+
+
+def reduceToBinary(obj):
+    """Pickle to the compact binary archive format
+
+    Intended to be used by the ``__reduce__`` method of a
+    `~lsst.afw.table.io.Persistable` class.  This is much faster than
+    `~lsst.afw.fits.reduceToFits` for small objects like PSFs, because it
+    skips the FITS layer entirely.
+
+    Parameters
+    ----------
+    obj
+        any object with a ``writeBinary`` method returning `bytes`.
+
+    Returns
+    -------
+    reduced : `tuple` [callable, `tuple`]
+        a tuple in the format returned by `~object.__reduce__`
+    """
+    return (unreduceFromBinary, (obj.__class__, obj.writeBinary()))
+
+
+def unreduceFromBinary(cls, data):
+    """Unpickle from the compact binary archive format
+
+    Unpack data produced by `reduceToBinary`. This method is used by the
+    pickling framework and should not need to be called from user code.
+
+    Parameters
+    ----------
+    cls : `type`
+        the class of object to unpickle. Must have a class-level
+        ``readBinary`` method taking `bytes`.
+    data : `bytes`
+        the object, as returned by its ``writeBinary`` method
+
+    Returns
+    -------
+    unpickled : ``cls``
+        the object represented by ``data``
+    """
+    return cls.readBinary(data)
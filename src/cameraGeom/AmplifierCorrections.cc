@@ -0,0 +1,292 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <sstream>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/math/detail/Parallel.h"
+#include "lsst/afw/cameraGeom/AmplifierCorrections.h"
+
+namespace lsst {
+namespace afw {
+namespace cameraGeom {
+
+namespace {
+
+// The pixels of an image and the distance between its rows, captured so that amplifiers can be
+// processed concurrently without touching the reference counts of the image's array
+template <typename PixelT>
+struct Plane {
+    template <typename ArrayT>
+    explicit Plane(ArrayT const &array) : data(array.getData()), stride(array.template getStride<0>()) {}
+
+    PixelT *row(int y) const { return data + y * stride; }
+
+    PixelT *data;
+    std::ptrdiff_t stride;
+};
+
+void checkStatistic(math::Property statistic) {
+    if (statistic != math::MEAN && statistic != math::MEDIAN) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "Only MEAN and MEDIAN overscan statistics are supported");
+    }
+}
+
+// Return the statistic of a list of finite values, reordering them; NaN if there are none
+double computeStatistic(std::vector<double> &values, math::Property statistic) {
+    std::size_t const n = values.size();
+    if (n == 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (statistic == math::MEAN) {
+        return std::accumulate(values.begin(), values.end(), 0.0) / n;
+    }
+    auto const middle = values.begin() + n / 2;
+    std::nth_element(values.begin(), middle, values.end());
+    if (n % 2 == 1) {
+        return *middle;
+    }
+    return 0.5 * (*middle + *std::max_element(values.begin(), middle));
+}
+
+// Append the finite pixels of columns [x0, x0 + width) of a row to values
+template <typename PixelT>
+void appendFinite(PixelT const *row, int x0, int width, std::vector<double> &values) {
+    for (int x = x0; x < x0 + width; ++x) {
+        double const value = row[x];
+        if (std::isfinite(value)) {
+            values.push_back(value);
+        }
+    }
+}
+
+// Return an amplifier's box relative to the origin of the image, checking that the image contains it
+template <typename PixelT>
+lsst::geom::Box2I getLocalBox(lsst::geom::Box2I const &box, Amplifier const &amp, std::string const &what,
+                              image::Image<PixelT> const &image) {
+    if (!image.getBBox().contains(box)) {
+        std::ostringstream os;
+        os << "Raw " << what << " box " << box << " of amplifier " << amp.getName()
+           << " is not contained in raw image box " << image.getBBox();
+        throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
+    }
+    return lsst::geom::Box2I(lsst::geom::Point2I(box.getMin() - image.getXY0()), box.getDimensions());
+}
+
+// The correction of one amplifier's raw data region
+struct AmpCorrection {
+    lsst::geom::Box2I box;  // relative to the image origin
+    double const *offsets;  // nOffsets levels to subtract, or null
+    std::size_t nOffsets;
+    std::vector<double> linearity;  // polynomial coefficients of u^2, u^3, ...; empty for none
+    double gain;
+};
+
+std::vector<double> getLinearityCoefficients(Amplifier const &amp) {
+    std::string const type = amp.getLinearityType();
+    if (type.empty() || type == "None") {
+        return std::vector<double>();
+    }
+    auto const coeffs = amp.getLinearityCoeffs();
+    if (type == "Squared" || type == "Polynomial") {
+        if (coeffs.isEmpty() || coeffs.getSize<0>() == 0) {
+            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                              "Amplifier " + amp.getName() + " has " + type +
+                                      " linearity but no coefficients");
+        }
+        std::size_t const n = type == "Squared" ? 1 : coeffs.getSize<0>();
+        return std::vector<double>(coeffs.begin(), coeffs.begin() + n);
+    }
+    throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                      "Linearity type '" + type + "' of amplifier " + amp.getName() + " is not supported");
+}
+
+template <typename PixelT>
+void correctAmp(Plane<PixelT> const &plane, AmpCorrection const &correction) {
+    auto const &c = correction.linearity;
+    for (int j = 0; j < correction.box.getHeight(); ++j) {
+        double const offset = correction.offsets == nullptr
+                                      ? 0.0
+                                      : correction.offsets[correction.nOffsets == 1 ? 0 : j];
+        PixelT *row = plane.row(correction.box.getMinY() + j);
+        for (int x = correction.box.getMinX(); x <= correction.box.getMaxX(); ++x) {
+            double u = row[x] - offset;
+            if (!c.empty()) {
+                double poly = c.back();
+                for (std::size_t k = c.size() - 1; k > 0; --k) {
+                    poly = poly * u + c[k - 1];
+                }
+                u += poly * u * u;
+            }
+            row[x] = static_cast<PixelT>(u * correction.gain);
+        }
+    }
+}
+
+}  // namespace
+
+template <typename PixelT>
+std::vector<double> measureOverscanLevels(Detector const &detector, image::Image<PixelT> const &rawImage,
+                                          math::Property statistic, int numThreads) {
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    checkStatistic(statistic);
+    std::vector<lsst::geom::Box2I> boxes;
+    boxes.reserve(detector.size());
+    for (auto const &amp : detector) {
+        boxes.push_back(getLocalBox(amp->getRawHorizontalOverscanBBox(), *amp, "overscan", rawImage));
+    }
+    Plane<PixelT const> const plane(rawImage.getArray());
+    std::vector<double> result(boxes.size());
+    math::detail::parallelFor(boxes.size(), nThreads, [&](int i) {
+        auto const &box = boxes[i];
+        std::vector<double> values;
+        values.reserve(box.getArea());
+        for (int y = box.getMinY(); y <= box.getMaxY(); ++y) {
+            appendFinite(plane.row(y), box.getMinX(), box.getWidth(), values);
+        }
+        result[i] = computeStatistic(values, statistic);
+    });
+    return result;
+}
+
+template <typename PixelT>
+std::vector<ndarray::Array<double, 1, 1>> measureOverscanRows(Detector const &detector,
+                                                              image::Image<PixelT> const &rawImage,
+                                                              math::Property statistic, int numThreads) {
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    checkStatistic(statistic);
+    std::vector<lsst::geom::Box2I> boxes;  // the overscan columns of the data rows
+    std::vector<ndarray::Array<double, 1, 1>> result;
+    std::vector<double *> outputs;
+    boxes.reserve(detector.size());
+    result.reserve(detector.size());
+    for (auto const &amp : detector) {
+        lsst::geom::Box2I const overscan = amp->getRawHorizontalOverscanBBox();
+        lsst::geom::Box2I const data = amp->getRawDataBBox();
+        if (overscan.getMinY() > data.getMinY() || overscan.getMaxY() < data.getMaxY()) {
+            std::ostringstream os;
+            os << "Raw overscan box " << overscan << " of amplifier " << amp->getName()
+               << " does not span the rows of its raw data box " << data;
+            throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
+        }
+        lsst::geom::Box2I const box(lsst::geom::Point2I(overscan.getMinX(), data.getMinY()),
+                                    lsst::geom::Extent2I(overscan.getWidth(), data.getHeight()));
+        boxes.push_back(getLocalBox(box, *amp, "overscan", rawImage));
+        result.push_back(ndarray::allocate(data.getHeight()));
+        outputs.push_back(result.back().getData());
+    }
+    Plane<PixelT const> const plane(rawImage.getArray());
+    math::detail::parallelFor(boxes.size(), nThreads, [&](int i) {
+        auto const &box = boxes[i];
+        std::vector<double> values;
+        values.reserve(box.getWidth());
+        for (int j = 0; j < box.getHeight(); ++j) {
+            values.clear();
+            appendFinite(plane.row(box.getMinY() + j), box.getMinX(), box.getWidth(), values);
+            outputs[i][j] = computeStatistic(values, statistic);
+        }
+    });
+    return result;
+}
+
+template <typename PixelT>
+void correctAmplifiers(image::Image<PixelT> &rawImage, Detector const &detector,
+                       std::vector<ndarray::Array<double const, 1, 1>> const &offsets, bool doLinearity,
+                       bool doGain, int numThreads) {
+    int nThreads = math::detail::resolveNumThreads(numThreads);
+    if (!offsets.empty() && offsets.size() != detector.size()) {
+        std::ostringstream os;
+        os << "Got " << offsets.size() << " offset arrays for the " << detector.size()
+           << " amplifiers of detector " << detector.getName();
+        throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
+    }
+    std::vector<AmpCorrection> corrections;
+    corrections.reserve(detector.size());
+    for (std::size_t i = 0; i < detector.size(); ++i) {
+        Amplifier const &amp = *detector[i];
+        AmpCorrection correction{getLocalBox(amp.getRawDataBBox(), amp, "data", rawImage), nullptr, 0,
+                                 std::vector<double>(), doGain ? amp.getGain() : 1.0};
+        if (!offsets.empty()) {
+            std::size_t const n = offsets[i].getSize<0>();
+            if (n != 1 && n != static_cast<std::size_t>(correction.box.getHeight())) {
+                std::ostringstream os;
+                os << "Offset array of amplifier " << amp.getName() << " has " << n
+                   << " elements, not 1 or " << correction.box.getHeight();
+                throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
+            }
+            correction.offsets = offsets[i].getData();
+            correction.nOffsets = n;
+        }
+        if (doLinearity) {
+            correction.linearity = getLinearityCoefficients(amp);
+        }
+        corrections.push_back(std::move(correction));
+    }
+
+    // Amplifiers whose data boxes overlap are corrected serially, in order
+    for (std::size_t i = 0; i < corrections.size() && nThreads > 1; ++i) {
+        for (std::size_t j = i + 1; j < corrections.size(); ++j) {
+            if (corrections[i].box.overlaps(corrections[j].box)) {
+                nThreads = 1;
+                break;
+            }
+        }
+    }
+
+    Plane<PixelT> const plane(rawImage.getArray());
+    math::detail::parallelFor(corrections.size(), nThreads,
+                              [&](int i) { correctAmp(plane, corrections[i]); });
+}
+
+//
+// Explicit instantiations
+//
+#define INSTANTIATE_MEASURE(PIXEL)                                                                   \
+    template std::vector<double> measureOverscanLevels(Detector const &, image::Image<PIXEL> const &, \
+                                                       math::Property, int);                         \
+    template std::vector<ndarray::Array<double, 1, 1>> measureOverscanRows(                          \
+            Detector const &, image::Image<PIXEL> const &, math::Property, int);
+
+#define INSTANTIATE_CORRECT(PIXEL)                                                                \
+    template void correctAmplifiers(image::Image<PIXEL> &, Detector const &,                       \
+                                    std::vector<ndarray::Array<double const, 1, 1>> const &, bool, \
+                                    bool, int);
+
+INSTANTIATE_MEASURE(std::uint16_t)
+INSTANTIATE_MEASURE(int)
+INSTANTIATE_MEASURE(float)
+INSTANTIATE_MEASURE(double)
+INSTANTIATE_CORRECT(float)
+INSTANTIATE_CORRECT(double)
+
+}  // namespace cameraGeom
+}  // namespace afw
+}  // namespace lsst
@@ -0,0 +1,225 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/image/Image.h"
+#include "lsst/afw/image/MaskedImage.h"
+#include "lsst/afw/math/detail/Parallel.h"
+#include "lsst/afw/cameraGeom/AssembleImage.h"
+
+namespace lsst {
+namespace afw {
+namespace cameraGeom {
+
+namespace {
+
+// The copy of one amplifier; positions are relative to the origins of the images
+struct AmpCopy {
+    std::size_t rawIndex;        // index of the raw image holding the amplifier
+    lsst::geom::Point2I inMin;   // first pixel of the region in the raw image
+    lsst::geom::Point2I outMin;  // first pixel of the region in the assembled image
+    lsst::geom::Extent2I dimensions;
+    bool flipX;
+    bool flipY;
+};
+
+// The pixels of an image plane and the distance between its rows, captured so that the planes can be
+// copied concurrently without touching the reference counts of the images' arrays
+template <typename PixelT>
+struct Plane {
+    template <typename ArrayT>
+    explicit Plane(ArrayT const &array) : data(array.getData()), stride(array.template getStride<0>()) {}
+
+    PixelT *data;
+    std::ptrdiff_t stride;
+};
+
+template <typename PixelT>
+void copyAmp(Plane<PixelT const> const &in, Plane<PixelT> const &out, AmpCopy const &ampCopy) {
+    int const width = ampCopy.dimensions.getX();
+    int const height = ampCopy.dimensions.getY();
+    for (int j = 0; j < height; ++j) {
+        int const inY = ampCopy.inMin.getY() + (ampCopy.flipY ? height - 1 - j : j);
+        PixelT const *inRow = in.data + inY * in.stride + ampCopy.inMin.getX();
+        PixelT *outRow = out.data + (ampCopy.outMin.getY() + j) * out.stride + ampCopy.outMin.getX();
+        if (ampCopy.flipX) {
+            std::reverse_copy(inRow, inRow + width, outRow);
+        } else {
+            std::copy(inRow, inRow + width, outRow);
+        }
+    }
+}
+
+template <typename PixelT>
+void assemblePlanes(std::vector<image::Image<PixelT> const *> const &rawList, image::Image<PixelT> &out,
+                    std::vector<AmpCopy> const &plan, int nThreads) {
+    std::vector<Plane<PixelT const>> inPlanes;
+    inPlanes.reserve(rawList.size());
+    for (auto const *raw : rawList) {
+        inPlanes.emplace_back(raw->getArray());
+    }
+    Plane<PixelT> const outPlane(out.getArray());
+    math::detail::parallelFor(plan.size(), nThreads, [&](int i) {
+        copyAmp(inPlanes[plan[i].rawIndex], outPlane, plan[i]);
+    });
+}
+
+template <typename PixelT, typename MaskPixelT, typename VariancePixelT>
+void assemblePlanes(
+        std::vector<image::MaskedImage<PixelT, MaskPixelT, VariancePixelT> const *> const &rawList,
+        image::MaskedImage<PixelT, MaskPixelT, VariancePixelT> &out, std::vector<AmpCopy> const &plan,
+        int nThreads) {
+    std::vector<image::Image<PixelT> const *> imageList;
+    std::vector<image::Image<MaskPixelT> const *> maskList;
+    std::vector<image::Image<VariancePixelT> const *> varianceList;
+    for (auto const *raw : rawList) {
+        imageList.push_back(raw->getImage().get());
+        maskList.push_back(raw->getMask().get());
+        varianceList.push_back(raw->getVariance().get());
+    }
+    assemblePlanes(imageList, *out.getImage(), plan, nThreads);
+    assemblePlanes(maskList, *out.getMask(), plan, nThreads);
+    assemblePlanes(varianceList, *out.getVariance(), plan, nThreads);
+}
+
+template <typename ImageT>
+std::shared_ptr<ImageT> assemble(Detector const &detector, std::vector<ImageT const *> const &rawList,
+                                 bool isTrimmed, int numThreads) {
+    int nThreads = math::detail::resolveNumThreads(numThreads);
+    if (detector.size() == 0) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "Detector " + detector.getName() + " has no amplifiers");
+    }
+
+    std::vector<lsst::geom::Box2I> outBBoxList;
+    lsst::geom::Box2I outBBox = isTrimmed ? detector.getBBox() : lsst::geom::Box2I();
+    for (auto const &amp : detector) {
+        lsst::geom::Box2I ampBBox = amp->getBBox();
+        if (!isTrimmed) {
+            ampBBox = amp->getRawBBox();
+            ampBBox.shift(amp->getRawXYOffset());
+            outBBox.include(ampBBox);
+        }
+        outBBoxList.push_back(ampBBox);
+    }
+
+    std::vector<AmpCopy> plan;
+    plan.reserve(detector.size());
+    for (std::size_t i = 0; i < detector.size(); ++i) {
+        Amplifier const &amp = *detector[i];
+        std::size_t const rawIndex = rawList.size() == 1 ? 0 : i;
+        ImageT const &raw = *rawList[rawIndex];
+        lsst::geom::Box2I const inBBox = isTrimmed ? amp.getRawDataBBox() : amp.getRawBBox();
+        if (inBBox.getDimensions() != outBBoxList[i].getDimensions()) {
+            std::ostringstream os;
+            os << "Raw box " << inBBox << " and assembled box " << outBBoxList[i] << " of amplifier "
+               << amp.getName() << " have different dimensions";
+            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, os.str());
+        }
+        if (!raw.getBBox().contains(inBBox)) {
+            std::ostringstream os;
+            os << "Raw box " << inBBox << " of amplifier " << amp.getName()
+               << " is not contained in raw image box " << raw.getBBox();
+            throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
+        }
+        if (!outBBox.contains(outBBoxList[i])) {
+            std::ostringstream os;
+            os << "Box " << outBBoxList[i] << " of amplifier " << amp.getName()
+               << " is not contained in the detector box " << outBBox;
+            throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
+        }
+        plan.push_back(AmpCopy{rawIndex, lsst::geom::Point2I(inBBox.getMin() - raw.getXY0()),
+                               lsst::geom::Point2I(outBBoxList[i].getMin() - outBBox.getMin()),
+                               inBBox.getDimensions(), amp.getRawFlipX(), amp.getRawFlipY()});
+    }
+
+    // Amplifiers whose boxes overlap are copied serially, in order, so that the last one wins as it
+    // would when assembling one amplifier at a time
+    for (std::size_t i = 0; i < outBBoxList.size() && nThreads > 1; ++i) {
+        for (std::size_t j = i + 1; j < outBBoxList.size(); ++j) {
+            if (outBBoxList[i].overlaps(outBBoxList[j])) {
+                nThreads = 1;
+                break;
+            }
+        }
+    }
+
+    auto result = std::make_shared<ImageT>(outBBox);
+    assemblePlanes(rawList, *result, plan, nThreads);
+    return result;
+}
+
+}  // namespace
+
+template <typename ImageT>
+std::shared_ptr<ImageT> assembleDetectorImage(Detector const &detector, ImageT const &rawImage,
+                                              bool isTrimmed, int numThreads) {
+    return assemble(detector, std::vector<ImageT const *>{&rawImage}, isTrimmed, numThreads);
+}
+
+template <typename ImageT>
+std::shared_ptr<ImageT> assembleDetectorImage(Detector const &detector,
+                                              std::vector<std::shared_ptr<ImageT const>> const &rawImages,
+                                              bool isTrimmed, int numThreads) {
+    if (rawImages.size() != detector.size()) {
+        std::ostringstream os;
+        os << "Number of raw images = " << rawImages.size() << " != " << detector.size()
+           << " = number of amplifiers";
+        throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
+    }
+    std::vector<ImageT const *> rawList;
+    for (auto const &rawImage : rawImages) {
+        if (!rawImage) {
+            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "Raw image is null");
+        }
+        rawList.push_back(rawImage.get());
+    }
+    return assemble(detector, rawList, isTrimmed, numThreads);
+}
+
+/// @cond
+#define INSTANTIATE(IMAGE)                                                                               \
+    template std::shared_ptr<IMAGE> assembleDetectorImage(Detector const &, IMAGE const &, bool, int); \
+    template std::shared_ptr<IMAGE> assembleDetectorImage(                                               \
+            Detector const &, std::vector<std::shared_ptr<IMAGE const>> const &, bool, int);
+
+#define INSTANTIATE_PIXEL(PIXEL)     \
+    INSTANTIATE(image::Image<PIXEL>) \
+    INSTANTIATE(image::MaskedImage<PIXEL>)
+
+INSTANTIATE_PIXEL(std::uint16_t)
+INSTANTIATE_PIXEL(int)
+INSTANTIATE_PIXEL(float)
+INSTANTIATE_PIXEL(double)
+/// @endcond
+
+}  // namespace cameraGeom
+}  // namespace afw
+}  // namespace lsst
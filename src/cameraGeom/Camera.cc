@@ -19,6 +19,11 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <mutex>
+
 #include "lsst/afw/table/io/Persistable.cc"
 #include "lsst/afw/table/io/CatalogVector.h"
 #include "lsst/afw/table/io/InputArchive.h"
@@ -34,24 +39,141 @@ namespace {
 // Set this as a function to ensure FOCAL_PLANE is defined before use.
 CameraSys const getNativeCameraSys() { return FOCAL_PLANE; }
 
+// Number of points sampled along each edge of a detector when finding its focal-plane footprint
+int const FOOTPRINT_POINTS_PER_EDGE = 16;
+
+// Fraction of its larger dimension by which a footprint is grown, to allow for curvature of the
+// detector edges between the sampled points
+double const FOOTPRINT_PADDING = 0.01;
+
 } // anonymoous
 
+struct Camera::DetectorIndex {
+    std::once_flag built;
+
+    // Detectors in getIdMap() order, with their padded focal-plane footprints
+    DetectorList detectors;
+    std::vector<lsst::geom::Box2D> footprints;
+
+    // Indices of detectors whose edges could not be mapped to the focal plane; always checked
+    std::vector<std::size_t> unindexed;
+
+    // Grid of nx by ny cells covering `bounds`, each listing the detectors whose footprints overlap it
+    lsst::geom::Box2D bounds;
+    int nx = 0;
+    int ny = 0;
+    std::vector<std::vector<std::size_t>> cells;
+
+    int getColumn(double x) const {
+        int const i = static_cast<int>((x - bounds.getMinX()) / bounds.getWidth() * nx);
+        return std::max(0, std::min(nx - 1, i));
+    }
+
+    int getRow(double y) const {
+        int const j = static_cast<int>((y - bounds.getMinY()) / bounds.getHeight() * ny);
+        return std::max(0, std::min(ny - 1, j));
+    }
+
+    // Call func(i) for each indexed detector i whose footprint contains a focal-plane point
+    template <typename Func>
+    void forEachIndexed(lsst::geom::Point2D const &point, Func func) const {
+        if (!bounds.contains(point)) {
+            return;
+        }
+        for (std::size_t i : cells[getRow(point.getY()) * nx + getColumn(point.getX())]) {
+            if (footprints[i].contains(point)) {
+                func(i);
+            }
+        }
+    }
+};
+
 Camera::~Camera() noexcept = default;
 
 Camera::Builder Camera::rebuild() const {
     return Camera::Builder(*this);
 }
 
+Camera::DetectorIndex const &Camera::_getDetectorIndex() const {
+    DetectorIndex &index = *_detectorIndex;
+    std::call_once(index.built, [this, &index]() {
+        for (auto const &item : getIdMap()) {
+            auto const &detector = item.second;
+            lsst::geom::Box2D const pixelBox(detector->getBBox());
+            std::size_t const i = index.detectors.size();
+            index.detectors.push_back(detector);
+            index.footprints.emplace_back();
+            if (pixelBox.isEmpty()) {
+                continue;  // contains no points, so never a candidate
+            }
+            std::vector<lsst::geom::Point2D> edge;
+            edge.reserve(4 * FOOTPRINT_POINTS_PER_EDGE);
+            for (int k = 0; k < FOOTPRINT_POINTS_PER_EDGE; ++k) {
+                double const f = static_cast<double>(k) / FOOTPRINT_POINTS_PER_EDGE;
+                double const x = pixelBox.getMinX() + f * pixelBox.getWidth();
+                double const y = pixelBox.getMinY() + f * pixelBox.getHeight();
+                edge.emplace_back(x, pixelBox.getMinY());
+                edge.emplace_back(pixelBox.getMaxX(), y);
+                edge.emplace_back(pixelBox.getMaxX() - f * pixelBox.getWidth(), pixelBox.getMaxY());
+                edge.emplace_back(pixelBox.getMinX(), pixelBox.getMaxY() - f * pixelBox.getHeight());
+            }
+            lsst::geom::Box2D footprint;
+            bool isFinite = true;
+            for (auto const &point : detector->transform(edge, PIXELS, getNativeCameraSys())) {
+                if (!std::isfinite(point.getX()) || !std::isfinite(point.getY())) {
+                    isFinite = false;
+                    break;
+                }
+                footprint.include(point);
+            }
+            if (!isFinite || !(std::max(footprint.getWidth(), footprint.getHeight()) > 0.0)) {
+                index.unindexed.push_back(i);
+                continue;
+            }
+            footprint.grow(FOOTPRINT_PADDING * std::max(footprint.getWidth(), footprint.getHeight()));
+            index.footprints.back() = footprint;
+            index.bounds.include(footprint);
+        }
+
+        if (index.bounds.isEmpty()) {
+            return;
+        }
+        // About one detector per cell for a camera whose detectors tile a square
+        std::size_t const nIndexed = index.detectors.size() - index.unindexed.size();
+        index.nx = index.ny = std::max(1, static_cast<int>(std::ceil(std::sqrt(nIndexed))));
+        index.cells.resize(index.nx * index.ny);
+        for (std::size_t i = 0; i < index.footprints.size(); ++i) {
+            auto const &footprint = index.footprints[i];
+            if (footprint.isEmpty()) {
+                continue;
+            }
+            int const jMax = index.getRow(footprint.getMaxY());
+            int const iMax = index.getColumn(footprint.getMaxX());
+            for (int row = index.getRow(footprint.getMinY()); row <= jMax; ++row) {
+                for (int col = index.getColumn(footprint.getMinX()); col <= iMax; ++col) {
+                    index.cells[row * index.nx + col].push_back(i);
+                }
+            }
+        }
+    });
+    return index;
+}
+
 Camera::DetectorList Camera::findDetectors(lsst::geom::Point2D const &point,
                                            CameraSys const &cameraSys) const {
     auto nativePoint = transform(point, cameraSys, getNativeCameraSys());
+    auto const &index = _getDetectorIndex();
+
+    std::vector<std::size_t> candidates(index.unindexed);
+    index.forEachIndexed(nativePoint, [&candidates](std::size_t i) { candidates.push_back(i); });
+    std::sort(candidates.begin(), candidates.end());
 
     DetectorList detectorList;
-    for (auto const &item : getIdMap()) {
-        auto detector = item.second;
+    for (std::size_t i : candidates) {
+        auto const &detector = index.detectors[i];
         auto pointPixels = detector->transform(nativePoint, getNativeCameraSys(), PIXELS);
         if (lsst::geom::Box2D(detector->getBBox()).contains(pointPixels)) {
-            detectorList.push_back(std::move(detector));
+            detectorList.push_back(detector);
         }
     }
     return detectorList;
@@ -61,14 +183,38 @@ std::vector<Camera::DetectorList> Camera::findDetectorsList(std::vector<lsst::ge
                                                             CameraSys const &cameraSys) const {
     std::vector<DetectorList> detectorListList(pointList.size());
     auto nativePointList = transform(pointList, cameraSys, getNativeCameraSys());
+    auto const &index = _getDetectorIndex();
+
+    // Indices of the points that may lie on each detector, in increasing order
+    std::vector<std::vector<std::size_t>> candidates(index.detectors.size());
+    for (std::size_t j = 0; j < nativePointList.size(); ++j) {
+        index.forEachIndexed(nativePointList[j], [&candidates, j](std::size_t i) {
+            candidates[i].push_back(j);
+        });
+    }
+    for (std::size_t i : index.unindexed) {
+        candidates[i].resize(nativePointList.size());
+        for (std::size_t j = 0; j < nativePointList.size(); ++j) {
+            candidates[i][j] = j;
+        }
+    }
 
-    for (auto const &item: getIdMap()) {
-        auto const &detector = item.second;
-        auto pointPixelsList = detector->transform(nativePointList, getNativeCameraSys(), PIXELS);
-        for (std::size_t i = 0; i < pointPixelsList.size(); ++i) {
-            auto const &pointPixels = pointPixelsList[i];
-            if (lsst::geom::Box2D(detector->getBBox()).contains(pointPixels)) {
-                detectorListList[i].push_back(detector);
+    // Visit detectors in getIdMap() order so each list is ordered as it would be by findDetectors
+    std::vector<lsst::geom::Point2D> nativeCandidates;
+    for (std::size_t i = 0; i < index.detectors.size(); ++i) {
+        if (candidates[i].empty()) {
+            continue;
+        }
+        auto const &detector = index.detectors[i];
+        nativeCandidates.clear();
+        for (std::size_t j : candidates[i]) {
+            nativeCandidates.push_back(nativePointList[j]);
+        }
+        auto pointPixelsList = detector->transform(nativeCandidates, getNativeCameraSys(), PIXELS);
+        lsst::geom::Box2D const pixelBox(detector->getBBox());
+        for (std::size_t k = 0; k < pointPixelsList.size(); ++k) {
+            if (pixelBox.contains(pointPixelsList[k])) {
+                detectorListList[candidates[i][k]].push_back(detector);
             }
         }
     }
@@ -179,11 +325,13 @@ Camera::Camera(std::string const & name, DetectorList detectors,
     DetectorCollection(std::move(detectors)),
     _name(name),
     _pupilFactoryName(pupilFactoryName),
-    _transformMap(std::move(transformMap))
+    _transformMap(std::move(transformMap)),
+    _detectorIndex(std::make_shared<DetectorIndex>())
 {}
 
 Camera::Camera(table::io::InputArchive const & archive, table::io::CatalogVector const & catalogs) :
-    DetectorCollection(archive, catalogs)
+    DetectorCollection(archive, catalogs),
+    _detectorIndex(std::make_shared<DetectorIndex>())
     // deferred initalization for data members is not ideal, but better than
     // trying to initialize them before validating the archive
 {
@@ -247,37 +395,41 @@ std::shared_ptr<Camera const> Camera::Builder::finish() const {
     // Make a big vector of all coordinate transform connections;
     // start with general transforms for the camera as a whole:
     std::vector<TransformMap::Connection> connections(_connections);
+    std::size_t nConnections = connections.size();
+    for (auto const & pair : getIdMap()) {
+        nConnections += getDetectorBuilderConnections(*pair.second).size() + 1;
+    }
+    connections.reserve(nConnections);
     // Loop over detectors and add the transforms from FOCAL_PLANE
-    // to PIXELS (via the Orientation), and then any extra transforms
+    // to PIXELS (via the Orientation), unless the detector already has
+    // a connection between those systems, and then any extra transforms
     // from PIXELS to other things.
     for (auto const & pair : getIdMap()) {
         auto const & detectorBuilder = *pair.second;
-        std::vector<TransformMap::Connection> detectorConnections = getDetectorBuilderConnections(detectorBuilder);
-        std::vector<std::vector<CameraSys>> allDetConnections;
-        for (auto const &connection : detectorConnections) {
-            std::vector<CameraSys> tmpConnection = {connection.fromSys, connection.toSys};
-            allDetConnections.push_back(tmpConnection);
-        }
-        std::vector<CameraSys> connection = {detectorBuilder.getNativeCoordSys(), getNativeCameraSys()};
-        std::vector<CameraSys> invConnection = {getNativeCameraSys(), detectorBuilder.getNativeCoordSys()};
-        if ((std::find(allDetConnections.begin(), allDetConnections.end(), connection) == allDetConnections.end()) 
-            && (std::find(allDetConnections.begin(), allDetConnections.end(), invConnection) == allDetConnections.end()) ) {
-        
+        auto const & detectorConnections = getDetectorBuilderConnections(detectorBuilder);
+        CameraSys const pixelSys = detectorBuilder.getNativeCoordSys();
+        bool const hasFpPixelConnection = std::any_of(
+            detectorConnections.begin(), detectorConnections.end(),
+            [&pixelSys](TransformMap::Connection const & connection) {
+                return (connection.fromSys == pixelSys && connection.toSys == getNativeCameraSys()) ||
+                       (connection.fromSys == getNativeCameraSys() && connection.toSys == pixelSys);
+            }
+        );
+        if (!hasFpPixelConnection) {
             connections.push_back(
                 TransformMap::Connection{
                     detectorBuilder.getOrientation().makeFpPixelTransform(detectorBuilder.getPixelSize()),
                     getNativeCameraSys(),
-                    detectorBuilder.getNativeCoordSys()
+                    pixelSys
                 }
             );
         }
-        connections.insert(connections.end(),
-                           getDetectorBuilderConnections(detectorBuilder).begin(),
-                           getDetectorBuilderConnections(detectorBuilder).end());
+        connections.insert(connections.end(), detectorConnections.begin(), detectorConnections.end());
     }
     // Make a single big TransformMap.
     auto transformMap = TransformMap::make(getNativeCameraSys(), connections);
-    // Make actual Detector objects, giving each the full TransformMap.
+    // Make actual Detector objects, all sharing the one TransformMap (and
+    // hence its frames and cached mappings).
     DetectorList detectors;
     detectors.reserve(size());
     for (auto const & pair : getIdMap()) {
@@ -19,14 +19,17 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
+#include <mutex>
 #include <sstream>
 #include <unordered_set>
+#include <utility>
 
 #include "lsst/log/Log.h"
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/table/io/OutputArchive.h"
 #include "lsst/afw/table/io/CatalogVector.h"
 #include "lsst/afw/table/io/Persistable.cc"
+#include "lsst/afw/geom/detail/transformUtils.h"
 #include "lsst/afw/cameraGeom/TransformMap.h"
 
 namespace lsst {
@@ -199,24 +202,40 @@ std::shared_ptr<TransformMap const> TransformMap::make(
 // All resources owned by value or by smart pointer
 TransformMap::~TransformMap() noexcept = default;
 
+struct TransformMap::CachedMapping {
+    explicit CachedMapping(std::shared_ptr<ast::Mapping const> mapping_) : mapping(std::move(mapping_)) {}
+
+    std::shared_ptr<ast::Mapping const> const mapping;
+    std::mutex mutex;
+};
+
 lsst::geom::Point2D TransformMap::transform(lsst::geom::Point2D const &point, CameraSys const &fromSys,
                                             CameraSys const &toSys) const {
-    auto mapping = _getMapping(fromSys, toSys);
-    return POINT2_ENDPOINT.pointFromData(mapping->applyForward(POINT2_ENDPOINT.dataFromPoint(point)));
+    auto cached = _getMapping(fromSys, toSys);
+    auto const rawFromData = POINT2_ENDPOINT.dataFromPoint(point);
+    std::lock_guard<std::mutex> lock(cached->mutex);
+    return POINT2_ENDPOINT.pointFromData(cached->mapping->applyForward(rawFromData));
 }
 
 std::vector<lsst::geom::Point2D> TransformMap::transform(std::vector<lsst::geom::Point2D> const &pointList,
                                                          CameraSys const &fromSys,
-                                                         CameraSys const &toSys) const {
-    auto mapping = _getMapping(fromSys, toSys);
-    return POINT2_ENDPOINT.arrayFromData(mapping->applyForward(POINT2_ENDPOINT.dataFromArray(pointList)));
+                                                         CameraSys const &toSys, int numThreads) const {
+    auto cached = _getMapping(fromSys, toSys);
+    auto const rawFromData = POINT2_ENDPOINT.dataFromArray(pointList);
+    std::unique_lock<std::mutex> lock(cached->mutex);
+    auto const rawToData = geom::detail::applyMapping(*cached->mapping, rawFromData, true, numThreads);
+    lock.unlock();
+    return POINT2_ENDPOINT.arrayFromData(rawToData);
 }
 
 bool TransformMap::contains(CameraSys const &system) const noexcept { return _frameIds.count(system) > 0; }
 
 std::shared_ptr<geom::TransformPoint2ToPoint2> TransformMap::getTransform(CameraSys const &fromSys,
                                                                           CameraSys const &toSys) const {
-    return std::make_shared<geom::TransformPoint2ToPoint2>(*_getMapping(fromSys, toSys));
+    auto cached = _getMapping(fromSys, toSys);
+    std::lock_guard<std::mutex> lock(cached->mutex);
+    // The cached mapping is already simplified, so the Transform need only copy it
+    return std::make_shared<geom::TransformPoint2ToPoint2>(*cached->mapping, false);
 }
 
 int TransformMap::_getFrame(CameraSys const &system) const {
@@ -229,9 +248,16 @@ int TransformMap::_getFrame(CameraSys const &system) const {
     }
 }
 
-std::shared_ptr<ast::Mapping const> TransformMap::_getMapping(CameraSys const &fromSys,
-                                                              CameraSys const &toSys) const {
-    return _frameSet->getMapping(_getFrame(fromSys), _getFrame(toSys));
+std::shared_ptr<TransformMap::CachedMapping> TransformMap::_getMapping(CameraSys const &fromSys,
+                                                                       CameraSys const &toSys) const {
+    auto const key = std::make_pair(_getFrame(fromSys), _getFrame(toSys));
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    auto iter = _mappingCache.find(key);
+    if (iter == _mappingCache.end()) {
+        auto mapping = _frameSet->getMapping(key.first, key.second)->simplified();
+        iter = _mappingCache.emplace(key, std::make_shared<CachedMapping>(std::move(mapping))).first;
+    }
+    return iter->second;
 }
 
 size_t TransformMap::size() const noexcept { return _frameIds.size(); }
@@ -0,0 +1,143 @@
+// -*- lsst-c++ -*-
+
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <sstream>
+#include <utility>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/coord/Refraction.h"
+
+namespace lsst {
+namespace afw {
+namespace coord {
+
+namespace {
+
+double const KELVIN_OFFSET = 273.15;  // 0 C in K
+double const PASCALS_PER_MBAR = 100.0;
+
+// Water vapor pressure (Pa) from humidity and temperature; equations 18 & 20 of Stone 1996
+double getWaterVaporPressure(Weather const &weather) {
+    double const x = std::log(weather.getHumidity() / 100.0);
+    double const temperature = weather.getAirTemperature();
+    double const eqn1 = (temperature + 238.3) * x + 17.2694 * temperature;
+    double const eqn2 = (temperature + 238.3) * (17.2694 - x) - 17.2694 * temperature;
+    double const dewPoint = 238.3 * eqn1 / eqn2;
+    return (4.50874 + 0.341724 * dewPoint + 0.0106778 * std::pow(dewPoint, 2) +
+            0.184889E-3 * std::pow(dewPoint, 3) + 0.238294E-5 * std::pow(dewPoint, 4) +
+            0.203447E-7 * std::pow(dewPoint, 5)) *
+           133.32239;
+}
+
+// (n_air - 1)*10^8; equations 14-16 of Stone 1996
+double getDeltaN(double wavelength, Weather const &weather) {
+    double const temperature = weather.getAirTemperature() + KELVIN_OFFSET;
+    double const waterPressure = getWaterVaporPressure(weather) / PASCALS_PER_MBAR;
+    double const dryPressure = weather.getAirPressure() / PASCALS_PER_MBAR - waterPressure;
+
+    double const dryEqn =
+            dryPressure * (57.90E-8 - 9.3250E-4 / temperature + 0.25844 / std::pow(temperature, 2));
+    double const densityFactorDry = (1.0 + dryEqn) * dryPressure / temperature;
+    double const waterEqn1 = -2.37321E-3 + 2.23366 / temperature - 710.792 / std::pow(temperature, 2) +
+                             7.75141E-4 / std::pow(temperature, 3);
+    double const waterEqn2 = waterPressure * (1.0 + 3.7E-4 * waterPressure);
+    double const densityFactorWater = (1.0 + waterEqn2 * waterEqn1) * waterPressure / temperature;
+
+    double const waveNum2 = std::pow(1E3 / wavelength, 2);  // (wave number in 1/micron)^2
+    double const dryAirTerm = 2371.34 + 683939.7 / (130.0 - waveNum2) + 4547.3 / (38.9 - waveNum2);
+    double const wetAirTerm =
+            6487.31 + 58.058 * waveNum2 - 0.71150 * std::pow(waveNum2, 2) + 0.08851 * std::pow(waveNum2, 3);
+    return dryAirTerm * densityFactorDry + wetAirTerm * densityFactorWater;
+}
+
+// Coefficients (a, b) of the refraction a*tan(z) + b*tan(z)^3 at zenith distance z
+std::pair<double, double> getRefractionCoefficients(double wavelength, Observatory const &observatory,
+                                                    Weather const &weather) {
+    if (!(wavelength >= 230.2 && wavelength <= 2058.6)) {
+        std::ostringstream os;
+        os << "Refraction calculation is valid for wavelengths between 230.2 and 2058.6 nm, not "
+           << wavelength;
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, os.str());
+    }
+    double const latitude = observatory.getLatitude().asRadians();
+    double const altitude = observatory.getElevation();
+    double const reducedN = getDeltaN(wavelength, weather) / 1.0E8;
+    double const atmosScaleheightRatio = 4.5908E-6 * (weather.getAirTemperature() + KELVIN_OFFSET);
+    // Account for oblate Earth; equation 10 of Stone 1996
+    double const relativeGravity = 1.0 + 0.005302 * std::pow(std::sin(latitude), 2) -
+                                   0.00000583 * std::pow(std::sin(2.0 * latitude), 2) -
+                                   0.000000315 * altitude;
+    return {reducedN * relativeGravity * (1.0 - atmosScaleheightRatio),
+            reducedN * relativeGravity * (atmosScaleheightRatio - reducedN / 2.0)};
+}
+
+ndarray::Array<double, 1, 1> applyRefraction(std::pair<double, double> const &coefficients,
+                                             ndarray::Array<double const, 1> const &elevation) {
+    ndarray::Array<double, 1, 1> result = ndarray::allocate(elevation.getSize<0>());
+    auto out = result.begin();
+    for (auto in = elevation.begin(); in != elevation.end(); ++in, ++out) {
+        double const tanZ = std::tan(M_PI / 2.0 - *in);
+        *out = (coefficients.first + coefficients.second * tanZ * tanZ) * tanZ;
+    }
+    return result;
+}
+
+}  // namespace
+
+Weather makeDefaultWeather(double altitude) {
+    double const p0 = 101325.0;     // sea level air pressure (Pa)
+    double const g = 9.80665;       // typical gravitational acceleration at sea level (m/s^2)
+    double const R0 = 8.31447;      // gas constant (J/(mol K))
+    double const T0 = 19.0;         // typical sea-level temperature (C)
+    double const lapseRate = -6.5;  // typical rate of change of temperature with altitude (C/km)
+    double const M = 0.0289644;     // molar mass of dry air (kg/mol)
+
+    double const temperature = T0 + lapseRate * altitude / 1000.0;
+    double const pressure = p0 * std::exp(-(g * M * altitude) / (R0 * (temperature + KELVIN_OFFSET)));
+    double const humidity = 40.0;  // typical humidity at many observatory sites
+    return Weather(temperature, pressure, humidity);
+}
+
+ndarray::Array<double, 1, 1> computeRefraction(double wavelength,
+                                               ndarray::Array<double const, 1> const &elevation,
+                                               Observatory const &observatory, Weather const &weather) {
+    return applyRefraction(getRefractionCoefficients(wavelength, observatory, weather), elevation);
+}
+
+ndarray::Array<double, 1, 1> computeDifferentialRefraction(double wavelength, double wavelengthRef,
+                                                           ndarray::Array<double const, 1> const &elevation,
+                                                           Observatory const &observatory,
+                                                           Weather const &weather) {
+    auto const coefficients = getRefractionCoefficients(wavelength, observatory, weather);
+    auto const refCoefficients = getRefractionCoefficients(wavelengthRef, observatory, weather);
+    return applyRefraction(
+            {coefficients.first - refCoefficients.first, coefficients.second - refCoefficients.second},
+            elevation);
+}
+
+}  // namespace coord
+}  // namespace afw
+}  // namespace lsst
@@ -21,10 +21,16 @@
  * see <https://www.lsstcorp.org/LegalNotices/>.
  */
 
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
 #include "lsst/afw/detection/Footprint.h"
+#include "lsst/afw/detection/detail/CompactEncoding.h"
 #include "lsst/afw/table/io/CatalogVector.h"
 #include "lsst/afw/table/io/OutputArchive.h"
 #include "lsst/afw/geom/transformFactory.h"
+#include "lsst/afw/math/detail/Parallel.h"
 #include "lsst/afw/table/io/Persistable.cc"
 
 namespace lsst {
@@ -42,6 +48,10 @@ Footprint::Footprint(std::shared_ptr<geom::SpanSet> inputSpans, afw::table::Sche
                      lsst::geom::Box2I const& region)
         : _spans(inputSpans), _peaks(peakSchema), _region(region) {}
 
+Footprint::Footprint(std::shared_ptr<geom::SpanSet> inputSpans, std::shared_ptr<PeakTable> const& peakTable,
+                     lsst::geom::Box2I const& region)
+        : _spans(inputSpans), _peaks(peakTable), _region(region) {}
+
 void Footprint::setSpans(std::shared_ptr<geom::SpanSet> otherSpanSet) { _spans = otherSpanSet; }
 
 std::shared_ptr<PeakRecord> Footprint::addPeak(float fx, float fy, float height) {
@@ -156,8 +166,8 @@ void Footprint::updatePeakSignificance(image::Image<float> const& variance, int
     }
 }
 
-std::vector<std::shared_ptr<Footprint>> Footprint::split() const {
-    auto splitSpanSets = getSpans()->split();
+std::vector<std::shared_ptr<Footprint>> Footprint::split(int numThreads) const {
+    auto splitSpanSets = getSpans()->split(numThreads);
     std::vector<std::shared_ptr<Footprint>> footprintList;
     footprintList.reserve(splitSpanSets.size());
     for (auto& spanPtr : splitSpanSets) {
@@ -230,6 +240,73 @@ private:
               spanX1(spanSchema.addField<int>("x1", "Second column of span (inclusive)", "pixel")) {}
 };
 
+// Schema and Key of the compact form of the spans: a single record whose only field holds the Spans
+// encoded by encodeSpans
+struct CompactSpansPersistenceHelper {
+    table::Schema schema;
+    table::Key<table::Array<std::uint8_t>> spans;
+
+    static CompactSpansPersistenceHelper const& get() {
+        static CompactSpansPersistenceHelper const instance;
+        return instance;
+    }
+
+private:
+    CompactSpansPersistenceHelper()
+            : schema(),
+              spans(schema.addField<table::Array<std::uint8_t>>(
+                      "spans", "Spans of the Footprint, as varints of the change from the previous Span")) {}
+};
+
+// Version of the compact encoding, written as its first byte
+constexpr std::uint8_t COMPACT_SPANS_VERSION = 1;
+
+// Encode the Spans of a SpanSet as their number, then the change in row and in first column from the
+// previous Span (from zero for the first) and the difference between the last and first columns of
+// each, all as variable-length integers.  The Spans of a SpanSet are sorted, so most of these values
+// take one byte.
+ndarray::Array<std::uint8_t, 1, 1> encodeSpans(geom::SpanSet const& spans) {
+    std::vector<std::uint8_t> buffer;
+    buffer.reserve(3 * spans.size() + 8);
+    buffer.push_back(COMPACT_SPANS_VERSION);
+    detail::appendVarint(spans.size(), buffer);
+    int y = 0;
+    int x0 = 0;
+    for (auto const& span : spans) {
+        detail::appendSignedVarint(static_cast<std::int64_t>(span.getY()) - y, buffer);
+        detail::appendSignedVarint(static_cast<std::int64_t>(span.getX0()) - x0, buffer);
+        detail::appendSignedVarint(static_cast<std::int64_t>(span.getX1()) - span.getX0(), buffer);
+        y = span.getY();
+        x0 = span.getX0();
+    }
+    ndarray::Array<std::uint8_t, 1, 1> result = ndarray::allocate(buffer.size());
+    std::copy(buffer.begin(), buffer.end(), result.begin());
+    return result;
+}
+
+std::shared_ptr<geom::SpanSet> decodeSpans(ndarray::Array<std::uint8_t const, 1, 1> const& encoded) {
+    std::uint8_t const* data = encoded.getData();
+    std::uint8_t const* const end = data + encoded.getNumElements();
+    LSST_ARCHIVE_ASSERT(data != end && *data == COMPACT_SPANS_VERSION);
+    ++data;
+    std::uint64_t const nSpans = detail::readVarint(data, end);
+    // Every Span takes at least three bytes, which bounds the allocation for a corrupt count
+    LSST_ARCHIVE_ASSERT(nSpans <= static_cast<std::uint64_t>(end - data) / 3);
+    std::vector<geom::Span> spans;
+    spans.reserve(nSpans);
+    std::int64_t y = 0;
+    std::int64_t x0 = 0;
+    for (std::uint64_t i = 0; i < nSpans; ++i) {
+        y += detail::readSignedVarint(data, end);
+        x0 += detail::readSignedVarint(data, end);
+        std::int64_t const x1 = x0 + detail::readSignedVarint(data, end);
+        spans.emplace_back(y, x0, x1);
+    }
+    LSST_ARCHIVE_ASSERT(data == end);
+    // The Spans were written from a SpanSet, so they are already normalized
+    return std::make_shared<geom::SpanSet>(std::move(spans), false);
+}
+
 std::pair<afw::table::Schema&, table::Key<int>&> spanSetPersistenceHelper() {
     static afw::table::Schema spanSetIdSchema;
     static int initialize = true;
@@ -269,14 +346,11 @@ FootprintFactory registration(getFootprintPersistenceName());
 std::string Footprint::getPersistenceName() const { return getFootprintPersistenceName(); }
 
 void Footprint::write(afw::table::io::OutputArchiveHandle& handle) const {
-    // get the span schema and key
-    auto const keys = spanSetPersistenceHelper();
-    // create the output catalog
-    afw::table::BaseCatalog spanSetCat = handle.makeCatalog(keys.first);
-    // create a record that will hold the ID of the recursively saved SpanSet
-    auto record = spanSetCat.addNew();
-    record->set(keys.second, handle.put(getSpans()));
-    handle.saveCatalog(spanSetCat);
+    // save the spans, in their compact form, into a single-record catalog
+    auto const& keys = CompactSpansPersistenceHelper::get();
+    afw::table::BaseCatalog spanCat = handle.makeCatalog(keys.schema);
+    spanCat.addNew()->set(keys.spans, encodeSpans(*getSpans()));
+    handle.saveCatalog(spanCat);
     // save the peaks into a catalog
     afw::table::BaseCatalog peakCat = handle.makeCatalog(getPeaks().getSchema());
     peakCat.insert(peakCat.end(), getPeaks().begin(), getPeaks().end(), true);
@@ -288,8 +362,13 @@ std::unique_ptr<Footprint> Footprint::readSpanSet(afw::table::BaseCatalog const&
     int fieldCount = catalog.getSchema().getFieldCount();
     LSST_ARCHIVE_ASSERT(fieldCount == 1 || fieldCount == 3);
     std::shared_ptr<geom::SpanSet> loadedSpanSet;
-    if (fieldCount == 1) {
-        // This is a new style footprint with a SpanSet as a member, treat accordingly
+    auto const& compactKeys = CompactSpansPersistenceHelper::get();
+    if (catalog.getSchema() == compactKeys.schema) {
+        // This is a footprint whose spans were saved in their compact form
+        LSST_ARCHIVE_ASSERT(catalog.size() == 1u);
+        loadedSpanSet = decodeSpans(catalog.front().get(compactKeys.spans));
+    } else if (fieldCount == 1) {
+        // This is a footprint whose SpanSet was saved as a separate object, treat accordingly
         auto const schemaAndKey = spanSetPersistenceHelper();
         int persistedSpanSetId = catalog.front().get(schemaAndKey.second);
         loadedSpanSet = std::dynamic_pointer_cast<geom::SpanSet>(archive.get(persistedSpanSetId));
@@ -428,6 +507,47 @@ std::vector<lsst::geom::Box2I> footprintToBBoxList(Footprint const& footprint) {
     return bboxes;
 }
 
+std::vector<std::shared_ptr<Footprint>> transformFootprints(
+        std::vector<std::shared_ptr<Footprint>> const& footprints, geom::TransformPoint2ToPoint2 const& t,
+        lsst::geom::Box2I const& region, bool doClip, int numThreads) {
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    std::vector<std::shared_ptr<geom::SpanSet>> spanSets;
+    spanSets.reserve(footprints.size());
+    std::vector<lsst::geom::Point2D> peakPosList;
+    for (auto const& footprint : footprints) {
+        spanSets.push_back(footprint->getSpans());
+        for (auto const& peak : footprint->getPeaks()) {
+            peakPosList.emplace_back(peak.getF());
+        }
+    }
+    auto const newSpanSets = geom::SpanSet::transformEach(spanSets, t, nThreads);
+    auto const newPeakPosList = peakPosList.empty() ? peakPosList : t.applyForward(peakPosList, nThreads);
+
+    // Adding peaks uses each peak table's ID factory, so the Footprints are assembled serially
+    std::vector<std::shared_ptr<Footprint>> result;
+    result.reserve(footprints.size());
+    auto newPeakPos = newPeakPosList.cbegin();
+    for (std::size_t i = 0; i < footprints.size(); ++i) {
+        auto const& peaks = footprints[i]->getPeaks();
+        auto newFootprint = std::make_shared<Footprint>(newSpanSets[i], peaks.getSchema(), region);
+        for (auto peak = peaks.cbegin(), endPeak = peaks.cend(); peak != endPeak; ++peak, ++newPeakPos) {
+            newFootprint->addPeak(newPeakPos->getX(), newPeakPos->getY(), peak->getPeakValue());
+        }
+        if (doClip) {
+            newFootprint->clipTo(region);
+        }
+        result.push_back(std::move(newFootprint));
+    }
+    return result;
+}
+
+std::vector<std::shared_ptr<Footprint>> transformFootprints(
+        std::vector<std::shared_ptr<Footprint>> const& footprints, geom::SkyWcs const& source,
+        geom::SkyWcs const& target, lsst::geom::Box2I const& region, bool doClip, int numThreads) {
+    auto const srcToTarget = geom::makeWcsPairTransform(source, target);
+    return transformFootprints(footprints, *srcToTarget, region, doClip, numThreads);
+}
+
 void Footprint::setPeakSchema(afw::table::Schema const& peakSchema) {
     setPeakCatalog(PeakCatalog(peakSchema));
 }
@@ -19,7 +19,9 @@
  * the GNU General Public License along with this program.  If not,
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
+#include <algorithm>
 #include <cstdint>
+#include <unordered_map>
 
 #include "lsst/afw/detection/FootprintMerge.h"
 #include "lsst/afw/table/IdFactory.h"
@@ -202,6 +204,70 @@ private:
     std::shared_ptr<afw::table::SourceRecord> _source;
 };
 
+namespace {
+
+/*
+ * A coarse grid of square cells that records which FootprintMerges have bounding boxes touching each
+ * cell, so the merges a new Footprint might overlap can be found without scanning all of them.
+ *
+ * Merges are identified by their position in insertion order.  Entries are never removed, so a lookup
+ * can return merges that have since been absorbed into others; the caller must skip those.
+ */
+class MergeGrid {
+public:
+    using Index = std::size_t;
+
+    // Record that the merge at index covers box
+    void insert(lsst::geom::Box2I const &box, Index index) { extend(lsst::geom::Box2I(), box, index); }
+
+    // Record that the merge at index has grown from oldBox to newBox, skipping cells it already touched
+    void extend(lsst::geom::Box2I const &oldBox, lsst::geom::Box2I const &newBox, Index index) {
+        if (newBox.isEmpty()) return;
+        for (int cy = toCell(newBox.getMinY()); cy <= toCell(newBox.getMaxY()); ++cy) {
+            for (int cx = toCell(newBox.getMinX()); cx <= toCell(newBox.getMaxX()); ++cx) {
+                if (!oldBox.isEmpty() && cx >= toCell(oldBox.getMinX()) && cx <= toCell(oldBox.getMaxX()) &&
+                    cy >= toCell(oldBox.getMinY()) && cy <= toCell(oldBox.getMaxY())) {
+                    continue;
+                }
+                _cells[key(cx, cy)].push_back(index);
+            }
+        }
+    }
+
+    // Return the indices of all merges touching a cell that box touches, sorted and without duplicates
+    std::vector<Index> query(lsst::geom::Box2I const &box) const {
+        std::vector<Index> result;
+        if (box.isEmpty()) return result;
+        for (int cy = toCell(box.getMinY()); cy <= toCell(box.getMaxY()); ++cy) {
+            for (int cx = toCell(box.getMinX()); cx <= toCell(box.getMaxX()); ++cx) {
+                auto cell = _cells.find(key(cx, cy));
+                if (cell != _cells.end()) {
+                    result.insert(result.end(), cell->second.begin(), cell->second.end());
+                }
+            }
+        }
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+
+private:
+    // Side of a cell in pixels; comparable to the size of a typical detection
+    static constexpr int CELL_SIZE = 64;
+
+    // Floor division, so cells don't straddle zero
+    static int toCell(int x) { return x >= 0 ? x / CELL_SIZE : -((-x - 1) / CELL_SIZE) - 1; }
+
+    static std::int64_t key(int cx, int cy) {
+        return static_cast<std::int64_t>(static_cast<std::uint64_t>(static_cast<std::uint32_t>(cx)) << 32 |
+                                         static_cast<std::uint32_t>(cy));
+    }
+
+    std::unordered_map<std::int64_t, std::vector<Index>> _cells;
+};
+
+}  // namespace
+
 FootprintMergeList::FootprintMergeList(afw::table::Schema &sourceSchema,
                                        std::vector<std::string> const &filterList,
                                        afw::table::Schema const &initialPeakSchema)
@@ -248,6 +314,17 @@ void FootprintMergeList::addCatalog(std::shared_ptr<afw::table::SourceTable> sou
     // If list is empty or merging not requested, don't check for any matches, just add all the objects
     bool checkForMatches = !_mergeList.empty() && doMerge;
 
+    // Merges are identified by their position in the list; those absorbed into others are only
+    // dropped at the end, so positions stay valid and follow the list's order.
+    FootprintMergeVec &merges = _mergeList;
+    std::vector<bool> absorbed(merges.size(), false);
+    MergeGrid grid;
+    if (checkForMatches) {
+        for (std::size_t i = 0; i < merges.size(); ++i) {
+            grid.insert(merges[i]->getBBox(), i);
+        }
+    }
+
     for (afw::table::SourceCatalog::const_iterator srcIter = inputCat.begin(); srcIter != inputCat.end();
          ++srcIter) {
         // Only consider unblended objects
@@ -255,45 +332,62 @@ void FootprintMergeList::addCatalog(std::shared_ptr<afw::table::SourceTable> sou
 
         std::shared_ptr<Footprint> foot = srcIter->getFootprint();
 
-        // Empty pointer to account for the first match in the catalog.  If there is more than one
+        // Index of the first match in the catalog.  If there is more than one
         // match, subsequent matches will be merged with this one
-        std::shared_ptr<FootprintMerge> first = std::shared_ptr<FootprintMerge>();
+        std::size_t const none = merges.size();
+        std::size_t first = none;
+        lsst::geom::Box2I firstBBox;
 
         if (checkForMatches) {
-            FootprintMergeVec::iterator iter = _mergeList.begin();
-            while (iter != _mergeList.end()) {
-                // Grow by one pixel to allow for touching
-                lsst::geom::Box2I box((**iter).getBBox());
-                box.grow(lsst::geom::Extent2I(1, 1));
-                if (box.overlaps(foot->getBBox()) && (**iter).overlaps(*foot)) {
-                    if (!first) {
-                        first = *iter;
+            // Grow by one pixel to allow for touching
+            lsst::geom::Box2I footBBox(foot->getBBox());
+            footBBox.grow(lsst::geom::Extent2I(1, 1));
+            // Candidates come back in list order, which decides which merge absorbs the others
+            for (std::size_t i : grid.query(footBBox)) {
+                if (absorbed[i]) continue;
+                FootprintMerge &merge = *merges[i];
+                if (merge.getBBox().overlaps(footBBox) && merge.overlaps(*foot)) {
+                    if (first == none) {
+                        first = i;
+                        firstBBox = merge.getBBox();
                         // Spatially extend existing FootprintMerge in order to connect subsequent,
                         // now-overlapping FootprintMerges. If a subsequent FootprintMerge overlaps with
                         // the new footprint, it's now guaranteed to overlap with this first FootprintMerge.
                         // Hold off adding foot's lower-priority footprints and peaks until the
                         // higher-priority existing peaks are merged into this first FootprintMerge.
-                        first->addSpans(foot);
+                        merge.addSpans(foot);
                     } else {
                         // Add existing merged Footprint to first
-                        first->add(**iter, _filterMap, minNewPeakDist, maxSamePeakDist);
-                        iter = _mergeList.erase(iter);
-                        continue;
+                        merges[first]->add(merge, _filterMap, minNewPeakDist, maxSamePeakDist);
+                        absorbed[i] = true;
                     }
                 }
-                ++iter;
-            } // while mergeList
-        } //     if checkForMatches
+            }  // for candidates
+        }      // if checkForMatches
 
-        if (first) {
+        if (first != none) {
             // Now merge footprint including peaks into the newly-connected, higher-priority FootprintMerge
-            first->add(foot, _peakSchemaMapper, keyIter->second, minNewPeakDist, maxSamePeakDist);
+            merges[first]->add(foot, _peakSchemaMapper, keyIter->second, minNewPeakDist, maxSamePeakDist);
+            grid.extend(firstBBox, merges[first]->getBBox(), first);
         } else {
-           // Footprint did not overlap with any existing FootprintMerges. Add to MergeList
-            _mergeList.push_back(std::make_shared<FootprintMerge>(foot, sourceTable, _peakTable,
-                                                                  _peakSchemaMapper, keyIter->second));
+            // Footprint did not overlap with any existing FootprintMerges. Add to MergeList
+            merges.push_back(std::make_shared<FootprintMerge>(foot, sourceTable, _peakTable,
+                                                              _peakSchemaMapper, keyIter->second));
+            absorbed.push_back(false);
+            if (checkForMatches) {
+                grid.insert(merges.back()->getBBox(), merges.size() - 1);
+            }
+        }
+    }
+
+    std::size_t nKept = 0;
+    for (std::size_t i = 0; i < merges.size(); ++i) {
+        if (!absorbed[i]) {
+            if (nKept != i) merges[nKept] = std::move(merges[i]);
+            ++nKept;
         }
     }
+    merges.resize(nKept);
 }
 
 void FootprintMergeList::getFinalSources(afw::table::SourceCatalog &outputCat) {
@@ -45,6 +45,7 @@
 #include <cassert>
 #include <iostream>
 #include <iterator>  // for ostream_iterator
+#include <limits>
 #include <set>
 #include <string>
 #include <map>
@@ -54,6 +55,7 @@
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/image/MaskedImage.h"
 #include "lsst/afw/math/Statistics.h"
+#include "lsst/afw/math/detail/Parallel.h"
 #include "lsst/afw/detection/Peak.h"
 #include "lsst/afw/detection/FootprintSet.h"
 #include "lsst/afw/detection/FootprintCtrl.h"
@@ -436,6 +438,150 @@ FootprintSet mergeFootprintSets(FootprintSet const &lhs,      // the FootprintSe
 
     return fs;
 }
+/*
+ * Worker routine for growing a FootprintSet with a distance transform
+ *
+ * The CIRCLE and MANHATTAN stencils of radius r cover exactly the pixels within Euclidean and Manhattan
+ * distance r of their centre, so the union of the grown Footprints is the set of pixels whose distance
+ * to the nearest Footprint pixel is at most r.  We compute that distance, capped at r + 1, in two
+ * separable passes (down the columns, then along the rows, using the lower envelope of parabolae of
+ * Felzenszwalb & Huttenlocher for Euclidean distances), detect the grown Footprints in the result,
+ * and merge into each the Peaks of the Footprints beneath it, just as mergeFootprintSets does.
+ */
+FootprintSet growByDistanceTransform(FootprintSet const &rhs, int r, bool isotropic, int numThreads) {
+    using FootprintList = FootprintSet::FootprintList;
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    lsst::geom::Box2I const region = rhs.getRegion();
+    FootprintList const &footprints = *rhs.getFootprints();
+    if (footprints.empty() || region.isEmpty()) {
+        return FootprintSet(region);
+    }
+    int const width = region.getWidth();
+    int const height = region.getHeight();
+    int const far = r + 1;  // all larger distances are equivalent
+
+    // Distance to the nearest Footprint pixel in the same column
+    std::vector<int> distance(static_cast<std::size_t>(width) * height, far);
+    for (auto const &foot : footprints) {
+        auto const spans = foot->getSpans()->clippedTo(region);
+        for (auto const &span : *spans) {
+            int *row = distance.data() + static_cast<std::size_t>(span.getY() - region.getMinY()) * width;
+            int const x0 = span.getX0() - region.getMinX();
+            std::fill(row + x0, row + x0 + span.getWidth(), 0);
+        }
+    }
+    auto const columnBands = math::detail::splitRange(0, width, nThreads);
+    math::detail::parallelFor(columnBands.size(), nThreads, [&](int i) {
+        int const x0 = columnBands[i].first;
+        int const x1 = columnBands[i].second;
+        for (int y = 1; y < height; ++y) {
+            int *row = distance.data() + static_cast<std::size_t>(y) * width;
+            for (int x = x0; x < x1; ++x) {
+                row[x] = std::min(row[x], row[x - width] + 1);
+            }
+        }
+        for (int y = height - 2; y >= 0; --y) {
+            int *row = distance.data() + static_cast<std::size_t>(y) * width;
+            for (int x = x0; x < x1; ++x) {
+                row[x] = std::min(row[x], row[x + width] + 1);
+            }
+        }
+    });
+
+    // Threshold the full distance to find the pixels of the grown Footprints
+    image::Image<IdPixelT> idImage(region);
+    IdPixelT *const idData = idImage.getArray().getData();
+    std::ptrdiff_t const idStride = idImage.getArray().getStride<0>();
+    double const r2 = static_cast<double>(r) * r;
+    auto const rowBands = math::detail::splitRange(0, height, nThreads);
+    math::detail::parallelFor(rowBands.size(), nThreads, [&](int i) {
+        std::vector<int> sites(width);       // columns of the parabolae in the lower envelope
+        std::vector<double> bounds(width);   // left ends of the parabolae's intervals
+        std::vector<int> forward(width);
+        for (int y = rowBands[i].first; y < rowBands[i].second; ++y) {
+            int const *g = distance.data() + static_cast<std::size_t>(y) * width;
+            IdPixelT *out = idData + y * idStride;
+            if (isotropic) {
+                int k = -1;
+                for (int q = 0; q < width; ++q) {
+                    if (g[q] >= far) {
+                        continue;
+                    }
+                    double const fq = static_cast<double>(g[q]) * g[q] + static_cast<double>(q) * q;
+                    double s = -std::numeric_limits<double>::infinity();
+                    while (k >= 0) {
+                        int const p = sites[k];
+                        s = (fq - static_cast<double>(g[p]) * g[p] - static_cast<double>(p) * p) /
+                            (2.0 * (q - p));
+                        if (s > bounds[k]) {
+                            break;
+                        }
+                        --k;
+                    }
+                    ++k;
+                    sites[k] = q;
+                    bounds[k] = k == 0 ? -std::numeric_limits<double>::infinity() : s;
+                }
+                for (int x = 0, j = 0; x < width; ++x) {
+                    if (k < 0) {
+                        out[x] = 0;
+                        continue;
+                    }
+                    while (j < k && bounds[j + 1] < x) {
+                        ++j;
+                    }
+                    double const dx = x - sites[j];
+                    double const dy = g[sites[j]];
+                    out[x] = (dx * dx + dy * dy <= r2) ? 1 : 0;
+                }
+            } else {
+                int d = far;
+                for (int x = 0; x < width; ++x) {
+                    forward[x] = d = std::min(g[x], d + 1);
+                }
+                d = far;
+                for (int x = width - 1; x >= 0; --x) {
+                    d = std::min(forward[x], d + 1);
+                    out[x] = (d <= r) ? 1 : 0;
+                }
+            }
+        }
+    });
+
+    table::Schema const schema = footprints[0]->getPeaks().getSchema();
+    FootprintSet fs(idImage, Threshold(1), 1, false, schema, nThreads);
+
+    // Label the grown Footprints, and find the input Footprints that lie beneath each
+    idImage = 0;
+    FootprintList const &grown = *fs.getFootprints();
+    for (std::size_t j = 0; j < grown.size(); ++j) {
+        grown[j]->getSpans()->applyFunctor(setIdImage<IdPixelT>(j + 1), idImage);
+    }
+    std::vector<std::vector<std::size_t>> progenitors(grown.size());
+    FindIdsInFootprint<IdPixelT> idFinder;
+    for (std::size_t i = 0; i < footprints.size(); ++i) {
+        footprints[i]->getSpans()->clippedTo(region)->applyFunctor(idFinder, idImage);
+        for (IdPixelT id : idFinder.getIds()) {
+            progenitors[id - 1].push_back(i);
+        }
+        idFinder.reset();
+    }
+
+    for (std::size_t j = 0; j < grown.size(); ++j) {
+        PeakCatalog &peaks = grown[j]->getPeaks();
+        for (std::size_t i : progenitors[j]) {
+            PeakCatalog const &oldPeaks = footprints[i]->getPeaks();
+
+            int const nold = peaks.size();
+            peaks.insert(peaks.end(), oldPeaks.begin(), oldPeaks.end());
+            // See mergeFootprintSets on why we're using getInternal() here.
+            std::inplace_merge(peaks.getInternal().begin(), peaks.getInternal().begin() + nold,
+                               peaks.getInternal().end(), SortPeaks());
+        }
+    }
+
+    return fs;
+}
 /*
  * run-length code for part of object
  */
@@ -474,14 +620,76 @@ int resolve_alias(std::vector<int> const &aliases, /* list of aliases */
 
     return (resolved);
 }
+/*
+ * Call paint(row, x0, x1, index) for every Span of a list of Footprints, where row points to the
+ * pixels of the Span's row in an image with the given bbox and stride, [x0, x1] are the Span's
+ * columns relative to bbox, and index is the Footprint's position in the list.
+ *
+ * With several threads the Spans are sorted into bands of rows and the bands painted concurrently,
+ * so each pixel is only ever touched by one thread and paint may modify it without locking.
+ */
+template <typename PixelT, typename PaintT>
+void paintFootprints(FootprintSet::FootprintList const &footprints, lsst::geom::Box2I const &bbox,
+                     PixelT *data, std::ptrdiff_t stride, int numThreads, PaintT const &paint) {
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    for (auto const &foot : footprints) {
+        if (!bbox.contains(foot->getSpans()->getBBox())) {
+            throw LSST_EXCEPT(pex::exceptions::OutOfRangeError,
+                              "SpanSet bounding box lands outside array");
+        }
+    }
+    auto paintSpan = [&](geom::Span const &span, std::size_t index) {
+        paint(data + (span.getY() - bbox.getMinY()) * stride, span.getX0() - bbox.getMinX(),
+              span.getX1() - bbox.getMinX(), index);
+    };
+    if (nThreads == 1) {
+        for (std::size_t i = 0; i < footprints.size(); ++i) {
+            for (auto const &span : *footprints[i]->getSpans()) {
+                paintSpan(span, i);
+            }
+        }
+        return;
+    }
+
+    auto const bands = math::detail::splitRange(bbox.getMinY(), bbox.getEndY(), nThreads);
+    std::vector<int> bandStarts;
+    bandStarts.reserve(bands.size());
+    for (auto const &band : bands) {
+        bandStarts.push_back(band.first);
+    }
+    std::vector<std::vector<std::pair<geom::Span, std::size_t>>> spansByBand(bands.size());
+    for (std::size_t i = 0; i < footprints.size(); ++i) {
+        for (auto const &span : *footprints[i]->getSpans()) {
+            auto const band = std::upper_bound(bandStarts.begin(), bandStarts.end(), span.getY()) - 1;
+            spansByBand[band - bandStarts.begin()].emplace_back(span, i);
+        }
+    }
+    math::detail::parallelFor(bands.size(), nThreads, [&](int b) {
+        for (auto const &item : spansByBand[b]) {
+            paintSpan(item.first, item.second);
+        }
+    });
+}
 /// @endcond
 }  // namespace
 
 namespace {
+/*
+ * A peak found in a Footprint, before it is added to the Footprint's PeakCatalog
+ */
+struct PeakCandidate {
+    int x, y;
+    double value;
+};
+
+/*
+ * Append the local maxima (or minima, if !polarity) of image within spanSet to peaks, in the order
+ * of the spans; pixels within margin of the edge of the image are ignored.
+ */
 template <typename ImageT>
-void findPeaksInFootprint(ImageT const &image, bool polarity, Footprint &foot, const long margin = 0) {
-    auto spanSet = foot.getSpans();
-    if (spanSet->size() == 0) {
+void findPeaksInSpans(ImageT const &image, bool polarity, geom::SpanSet const &spanSet,
+                      std::vector<PeakCandidate> &peaks, const long margin = 0) {
+    if (spanSet.size() == 0) {
         return;
     }
     if(!(margin > 0)) {
@@ -498,7 +706,7 @@ void findPeaksInFootprint(ImageT const &image, bool polarity, Footprint &foot, c
     const auto image_x0 = image.getX0();
     const auto image_y0 = image.getY0();
 
-    for (auto const &spanIter : *spanSet) {
+    for (auto const &spanIter : spanSet) {
         auto y = spanIter.getY() - image_y0;
         if (((y + image_y0) < y_min) || ((y + image_y0) > y_max)) {
             continue;
@@ -521,7 +729,8 @@ void findPeaksInFootprint(ImageT const &image, bool polarity, Footprint &foot, c
                     continue;
                 }
             }
-            foot.addPeak(x + image_x0, y + image_y0, val);
+            peaks.push_back(PeakCandidate{static_cast<int>(x + image_x0), static_cast<int>(y + image_y0),
+                                          static_cast<double>(val)});
         }
     }
 }
@@ -552,7 +761,7 @@ public:
         }
     }
 
-    void addRecord(Footprint &foot) const { foot.addPeak(_x, _y, _polarity ? _max : _min); }
+    PeakCandidate getPeak() const { return PeakCandidate{_x, _y, _polarity ? _max : _min}; }
 
 private:
     bool _polarity;
@@ -560,26 +769,62 @@ private:
     double _min, _max;
 };
 
+/*
+ * Set the peaks of each Footprint: its local extrema, or if it has none its most extreme pixel,
+ * sorted by SortPeaks.
+ *
+ * The Footprints are searched concurrently, into per-Footprint scratch lists.  The peaks are then
+ * added in Footprint order on one thread, because the Footprints' PeakCatalogs may share a table
+ * (and so an IdFactory), which makes peak IDs independent of the number of threads.
+ */
 template <typename ImageT, typename ThresholdT>
-void findPeaks(std::shared_ptr<Footprint> foot, ImageT const &img, bool polarity, ThresholdT) {
-    findPeaksInFootprint(img, polarity, *foot, 1);
-
-    // We use getInternal() here to get the vector of shared_ptr that Catalog uses internally,
-    // which causes the STL algorithm to copy pointers instead of PeakRecords (which is what
-    // it'd try to do if we passed Catalog's own iterators).
-    std::stable_sort(foot->getPeaks().getInternal().begin(), foot->getPeaks().getInternal().end(),
-                     SortPeaks());
+void findPeaks(FootprintSet::FootprintList &footprints, ImageT const &img, bool polarity, int numThreads,
+               ThresholdT) {
+    int const nFootprints = footprints.size();
+    std::vector<std::vector<PeakCandidate>> peaks(nFootprints);
+    math::detail::parallelFor(nFootprints, numThreads, [&](int i) {
+        auto const &spans = footprints[i]->getSpans();
+        findPeaksInSpans(img, polarity, *spans, peaks[i], 1);
+        if (peaks[i].empty()) {
+            FindMaxInFootprint<typename ImageT::Pixel> maxFinder(polarity);
+            spans->applyFunctor(maxFinder, ndarray::ndImage(img.getArray(), img.getXY0()));
+            peaks[i].push_back(maxFinder.getPeak());
+        }
+    });
 
-    if (foot->getPeaks().empty()) {
-        FindMaxInFootprint<typename ImageT::Pixel> maxFinder(polarity);
-        foot->getSpans()->applyFunctor(maxFinder, ndarray::ndImage(img.getArray(), img.getXY0()));
-        maxFinder.addRecord(*foot);
+    /*
+     * Add the peaks already sorted, in the order SortPeaks would give them (their values are stored as
+     * floats), so the records of Footprints sharing a PeakTable are laid out in the order of the
+     * Footprints and their Peaks, and may be viewed as one contiguous catalog.
+     */
+    std::size_t nPeaks = 0;
+    for (auto const &footPeaks : peaks) {
+        nPeaks += footPeaks.size();
+    }
+    if (nPeaks == 0) {
+        return;
+    }
+    auto const sortPeaks = [](PeakCandidate const &a, PeakCandidate const &b) {
+        float const aValue = a.value;
+        float const bValue = b.value;
+        if (aValue != bValue) {
+            return aValue > bValue;
+        }
+        return (a.x != b.x) ? (a.x < b.x) : (a.y < b.y);
+    };
+    math::detail::parallelFor(nFootprints, numThreads,
+                              [&](int i) { std::stable_sort(peaks[i].begin(), peaks[i].end(), sortPeaks); });
+    footprints[0]->getPeaks().getTable()->preallocate(nPeaks);
+    for (int i = 0; i < nFootprints; ++i) {
+        for (auto const &peak : peaks[i]) {
+            footprints[i]->addPeak(peak.x, peak.y, peak.value);
+        }
     }
 }
 
 // No need to search for peaks when processing a Mask
 template <typename ImageT>
-void findPeaks(std::shared_ptr<Footprint>, ImageT const &, bool, ThresholdBitmask_traits) {
+void findPeaks(FootprintSet::FootprintList &, ImageT const &, bool, int, ThresholdBitmask_traits) {
     ;
 }
 }  // namespace
@@ -606,136 +851,177 @@ static inline bool inFootprint(ImagePixelT pixVal, IterT, bool, double threshold
 }
 
 /*
- * Advance the x_iterator to the variance image, when relevant (it may be NULL otherwise)
+ * Offset a pointer into a row of the variance image, when relevant (it may be NULL otherwise)
  */
-template <typename IterT>
-static inline IterT advancePtr(IterT varPtr, Threshold_traits) {
+template <typename PtrT>
+static inline PtrT offsetPtr(PtrT varPtr, int, Threshold_traits) {
     return varPtr;
 }
 
-template <typename IterT>
-static inline IterT advancePtr(IterT varPtr, ThresholdPixelLevel_traits) {
-    return varPtr + 1;
+template <typename PtrT>
+static inline PtrT offsetPtr(PtrT varPtr, int x, ThresholdPixelLevel_traits) {
+    return varPtr + x;
 }
 
 /*
- * Here's the working routine for the FootprintSet constructors; see documentation
- * of the constructors themselves
+ * Set isIn[x] to whether pixel x of a row is good and passes the threshold, for x in [0, width).
+ *
+ * The tests are made without branches, with the polarity known at compile time, so the compiler
+ * can vectorise the loop.
  */
-template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT, typename ThresholdTraitT>
-static void findFootprints(
-        typename FootprintSet::FootprintList *_footprints,  // Footprints
-        lsst::geom::Box2I const &_region,                   // BBox of pixels that are being searched
-        image::ImageBase<ImagePixelT> const &img,           // Image to search for objects
-        image::Image<VariancePixelT> const *var,            // img's variance
-        double const footprintThreshold,                    // threshold value for footprint
-        double const includeThresholdMultiplier,  // threshold (relative to footprintThreshold) for inclusion
-        bool const polarity,                      // if false, search _below_ thresholdVal
-        int const npixMin,                        // minimum number of pixels in an object
-        bool const setPeaks,                      // should I set the Peaks list?
-        table::Schema const &peakSchema =
-                PeakTable::makeMinimalSchema()  // Schema to use when defining peak catalog.
-) {
-    int id;       /* object ID */
-    int in_span;  /* object ID of current IdSpan */
-    int nobj = 0; /* number of objects found */
-    int x0 = 0;   /* unpacked from a IdSpan */
+template <bool polarity, typename ThresholdTraitT, typename ImagePixelT, typename VariancePixelT>
+static void testRow(ImagePixelT const *pixPtr, VariancePixelT const *varPtr, int const width,
+             double const thresholdVal, std::uint8_t *isIn) {
+    for (int x = 0; x < width; ++x) {
+        ImagePixelT const pixVal = pixPtr[x];
+        isIn[x] = !isBadPixel(pixVal) &
+                  inFootprint(pixVal, offsetPtr(varPtr, x, ThresholdTraitT()), polarity, thresholdVal,
+                              ThresholdTraitT());
+    }
+}
 
-    double includeThreshold = footprintThreshold * includeThresholdMultiplier;  // Threshold for inclusion
+template <typename ThresholdTraitT, typename ImagePixelT, typename VariancePixelT>
+static void testRow(ImagePixelT const *pixPtr, VariancePixelT const *varPtr, int const width,
+                    bool const polarity, double const thresholdVal, std::uint8_t *isIn) {
+    if (polarity) {
+        testRow<true, ThresholdTraitT>(pixPtr, varPtr, width, thresholdVal, isIn);
+    } else {
+        testRow<false, ThresholdTraitT>(pixPtr, varPtr, width, thresholdVal, isIn);
+    }
+}
 
-    int const row0 = img.getY0();
-    int const col0 = img.getX0();
-    int const height = img.getHeight();
+/*
+ * Append the IdSpans (with id 0) of the pixels in rows [yBegin, yEnd) that pass the threshold
+ *
+ * Each row is first tested as a whole by testRow, and its spans are then read off the results.
+ * If oppositeSpans is not null, the spans of the pixels that pass the threshold with the opposite
+ * polarity are appended to it, testing each row while it is still in the cache.
+ */
+template <typename ImagePixelT, typename VariancePixelT, typename ThresholdTraitT>
+static void findSpansInRows(image::ImageBase<ImagePixelT> const &img, image::Image<VariancePixelT> const *var,
+                            double const footprintThreshold, double const includeThresholdMultiplier,
+                            bool const polarity, int const yBegin, int const yEnd,
+                            std::vector<IdSpan> &spans, std::vector<IdSpan> *oppositeSpans = nullptr) {
+    double const includeThreshold = footprintThreshold * includeThresholdMultiplier;  // for inclusion
+    // Every span passes the inclusion threshold if it is the footprint threshold
+    bool const allGood = (includeThresholdMultiplier == 1.0);
     int const width = img.getWidth();
-    /*
-     * Storage for arrays that identify objects by ID. We want to be able to
-     * refer to idp[-1] and idp[width], hence the (width + 2)
-     */
-    std::vector<int> id1(width + 2);
-    std::fill(id1.begin(), id1.end(), 0);
-    std::vector<int> id2(width + 2);
-    std::fill(id2.begin(), id2.end(), 0);
-    std::vector<int>::iterator idc = id1.begin() + 1;  // object IDs in current/
-    std::vector<int>::iterator idp = id2.begin() + 1;  //                       previous row
-
-    std::vector<int> aliases;          // aliases for initially disjoint parts of Footprints
-    aliases.reserve(1 + height / 20);  // initial size of aliases
-
-    std::vector<IdSpan> spans;          // y:x0,x1 for objects
-    spans.reserve(aliases.capacity());  // initial size of spans
-
-    aliases.push_back(0);  // 0 --> 0
-                           /*
-                            * Go through image identifying objects
-                            */
-    using x_iterator = typename image::Image<ImagePixelT>::x_iterator;
-    using x_var_iterator = typename image::Image<VariancePixelT>::x_iterator;
-
-    in_span = 0;  // not in a span
-    for (int y = 0; y != height; ++y) {
-        if (idc == id1.begin() + 1) {
-            idc = id2.begin() + 1;
-            idp = id1.begin() + 1;
-        } else {
-            idc = id1.begin() + 1;
-            idp = id2.begin() + 1;
-        }
-        std::fill_n(idc - 1, width + 2, 0);
-
-        in_span = 0;                                     /* not in a span */
-        bool good = (includeThresholdMultiplier == 1.0); /* Span exceeds the threshold? */
-
-        x_iterator pixPtr = img.row_begin(y);
-        x_var_iterator varPtr = (var == nullptr) ? nullptr : var->row_begin(y);
-        for (int x = 0; x < width; ++x, ++pixPtr, varPtr = advancePtr(varPtr, ThresholdTraitT())) {
-            ImagePixelT const pixVal = *pixPtr;
-
-            if (isBadPixel(pixVal) ||
-                !inFootprint(pixVal, varPtr, polarity, footprintThreshold, ThresholdTraitT())) {
-                if (in_span) {
-                    spans.emplace_back(in_span, y, x0, x - 1, good);
 
-                    in_span = 0;
-                    good = false;
-                }
-            } else { /* a pixel to fix */
-                if (idc[x - 1] != 0) {
-                    id = idc[x - 1];
-                } else if (idp[x - 1] != 0) {
-                    id = idp[x - 1];
-                } else if (idp[x] != 0) {
-                    id = idp[x];
-                } else if (idp[x + 1] != 0) {
-                    id = idp[x + 1];
-                } else {
-                    id = ++nobj;
-                    aliases.push_back(id);
+    auto const imgArray = img.getArray();
+    ndarray::Array<VariancePixelT const, 2, 1> varArray;
+    if (var != nullptr) {
+        varArray = var->getArray();
+    }
+    std::vector<std::uint8_t> isIn(width);    // does each pixel of the row pass the threshold?
+    std::vector<std::uint8_t> isGood(width);  // does each pixel of a span pass the inclusion threshold?
+    auto const rowEnd = isIn.end();
+
+    for (int y = yBegin; y != yEnd; ++y) {
+        ImagePixelT const *pixPtr = imgArray[y].getData();
+        VariancePixelT const *varPtr = (var == nullptr) ? nullptr : varArray[y].getData();
+        auto findSpans = [&](bool const rowPolarity, std::vector<IdSpan> &rowSpans) {
+            testRow<ThresholdTraitT>(pixPtr, varPtr, width, rowPolarity, footprintThreshold, isIn.data());
+
+            for (auto x0 = std::find(isIn.begin(), rowEnd, 1); x0 != rowEnd;
+                 x0 = std::find(x0, rowEnd, 1)) {
+                auto const x1 = std::find(x0, rowEnd, 0);
+                int const begin = x0 - isIn.begin();
+                int const end = x1 - isIn.begin();
+                bool good = allGood;  // Span exceeds the threshold?
+                if (!good) {
+                    testRow<ThresholdTraitT>(pixPtr + begin, offsetPtr(varPtr, begin, ThresholdTraitT()),
+                                             end - begin, rowPolarity, includeThreshold, isGood.data());
+                    good = std::find(isGood.begin(), isGood.begin() + (end - begin), 1) !=
+                           isGood.begin() + (end - begin);
                 }
+                rowSpans.emplace_back(0, y, begin, end - 1, good);
+                x0 = x1;
+            }
+        };
+        findSpans(polarity, spans);
+        if (oppositeSpans != nullptr) {
+            findSpans(!polarity, *oppositeSpans);
+        }
+    }
+}
 
-                idc[x] = id;
-                if (!in_span) {
-                    x0 = x;
-                    in_span = id;
-                }
-                /*
-                 * Do we need to merge ID numbers? If so, make suitable entries in aliases[]
-                 */
-                if (idp[x + 1] != 0 && idp[x + 1] != id) {
-                    aliases[resolve_alias(aliases, idp[x + 1])] = resolve_alias(aliases, id);
+/*
+ * Give object IDs to spans sorted by row and then column, recording in aliases which IDs belong
+ * to the same object.
+ *
+ * Spans touching (8-connected) spans in the previous row join their objects; the first such span
+ * gives its ID, and the others' objects are aliased to it, left to right.  This makes the same
+ * choices, in the same order, as labeling the image a pixel at a time, so objects get the same
+ * IDs (and Footprints the same order) however the spans were found.
+ */
+static void labelSpans(std::vector<IdSpan> &spans, std::vector<int> &aliases) {
+    int nobj = 0;                           /* number of objects found */
+    std::size_t prevBegin = 0, prevEnd = 0; /* spans in the previous row */
+    for (std::size_t rowBegin = 0; rowBegin != spans.size();) {
+        int const y = spans[rowBegin].y;
+        std::size_t rowEnd = rowBegin + 1;
+        while (rowEnd != spans.size() && spans[rowEnd].y == y) {
+            ++rowEnd;
+        }
+        if (prevBegin == prevEnd || spans[prevBegin].y != y - 1) {
+            prevBegin = prevEnd = rowBegin;  // previous row is empty
+        }
 
-                    idc[x] = id = idp[x + 1];
-                }
+        std::size_t first = prevBegin;  // first span in previous row that may touch the current one
+        for (std::size_t i = rowBegin; i != rowEnd; ++i) {
+            IdSpan &span = spans[i];
+            while (first != prevEnd && spans[first].x1 < span.x0 - 1) {
+                ++first;
+            }
+            std::size_t last = first;  // one past the last span in previous row touching this one
+            while (last != prevEnd && spans[last].x0 <= span.x1 + 1) {
+                ++last;
+            }
 
-                if (!good && inFootprint(pixVal, varPtr, polarity, includeThreshold, ThresholdTraitT())) {
-                    good = true;
+            if (first != last && spans[first].x0 <= span.x0 + 1) {
+                span.id = spans[first].id;
+            } else {
+                span.id = ++nobj;
+                aliases.push_back(span.id);
+            }
+            /*
+             * Do we need to merge ID numbers? If so, make suitable entries in aliases[]
+             */
+            for (std::size_t j = first; j != last; ++j) {
+                if (spans[j].x1 >= span.x0 + 1) {
+                    int const prevId = resolve_alias(aliases, spans[j].id);
+                    int const id = resolve_alias(aliases, span.id);
+                    if (prevId != id) {
+                        aliases[prevId] = id;
+                    }
                 }
             }
         }
 
-        if (in_span) {
-            spans.emplace_back(in_span, y, x0, width - 1, good);
-        }
+        prevBegin = rowBegin;
+        prevEnd = rowEnd;
+        rowBegin = rowEnd;
     }
+}
+
+/*
+ * Assemble spans found by findSpansInRows into Footprints, appending those that are good and have at
+ * least npixMin pixels to footprints
+ */
+static void makeFootprints(std::vector<IdSpan> &spans, FootprintSet::FootprintList &footprints,
+                           lsst::geom::Box2I const &region, int const row0, int const col0,
+                           int const npixMin, table::Schema const &peakSchema) {
+    int id; /* object ID */
+    // One table for all the Footprints' Peaks, so their records are allocated together
+    auto const peakTable = PeakTable::make(peakSchema);
+
+    std::vector<int> aliases;                 // aliases for initially disjoint parts of Footprints
+    aliases.reserve(1 + region.getHeight() / 20);  // initial size of aliases
+    aliases.push_back(0);  // 0 --> 0
+    /*
+     * Identify objects, merging those that meet across rows (and so across bands)
+     */
+    labelSpans(spans, aliases);
     /*
      * Resolve aliases; first alias chains, then the IDs in the spans
      */
@@ -764,10 +1050,10 @@ static void findFootprints(
                     tempSpanList.emplace_back(spans[i0].y + row0, spans[i0].x0 + col0, spans[i0].x1 + col0);
                 }
                 auto tempSpanSet = std::make_shared<geom::SpanSet>(std::move(tempSpanList));
-                auto fp = std::make_shared<Footprint>(tempSpanSet, peakSchema, _region);
+                auto fp = std::make_shared<Footprint>(tempSpanSet, peakTable, region);
 
                 if (good && fp->getArea() >= static_cast<std::size_t>(npixMin)) {
-                    _footprints->push_back(fp);
+                    footprints.push_back(fp);
                 }
             }
 
@@ -776,44 +1062,108 @@ static void findFootprints(
             }
         }
     }
+}
+
+/*
+ * Here's the working routine for the FootprintSet constructors; see documentation
+ * of the constructors themselves
+ *
+ * If _oppositeFootprints is not null, the Footprints found with the opposite polarity are put there,
+ * from the same pass over the image.
+ */
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT, typename ThresholdTraitT>
+static void findFootprints(
+        typename FootprintSet::FootprintList *_footprints,  // Footprints
+        lsst::geom::Box2I const &_region,                   // BBox of pixels that are being searched
+        image::ImageBase<ImagePixelT> const &img,           // Image to search for objects
+        image::Image<VariancePixelT> const *var,            // img's variance
+        double const footprintThreshold,                    // threshold value for footprint
+        double const includeThresholdMultiplier,  // threshold (relative to footprintThreshold) for inclusion
+        bool const polarity,                      // if false, search _below_ thresholdVal
+        int const npixMin,                        // minimum number of pixels in an object
+        bool const setPeaks,                      // should I set the Peaks list?
+        int const numThreads,                     // number of threads to search rows with
+        table::Schema const &peakSchema =
+                PeakTable::makeMinimalSchema(),  // Schema to use when defining peak catalog.
+        typename FootprintSet::FootprintList *_oppositeFootprints = nullptr  // Footprints of !polarity
+) {
+    int const row0 = img.getY0();
+    int const col0 = img.getX0();
+    int const height = img.getHeight();
+
+    std::vector<IdSpan> spans;  // y:x0,x1 for objects
+    spans.reserve(1 + height / 20);  // initial size of spans
+    std::vector<IdSpan> oppositeSpans;  // y:x0,x1 for objects of the opposite polarity
+    std::vector<IdSpan> *const oppositeSpansPtr = (_oppositeFootprints == nullptr) ? nullptr : &oppositeSpans;
+    /*
+     * Go through image identifying spans; bands of rows are independent, so may be searched concurrently
+     */
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    if (nThreads == 1) {
+        findSpansInRows<ImagePixelT, VariancePixelT, ThresholdTraitT>(img, var, footprintThreshold,
+                                                                      includeThresholdMultiplier, polarity,
+                                                                      0, height, spans, oppositeSpansPtr);
+    } else {
+        std::vector<std::pair<int, int>> const bands = math::detail::splitRange(0, height, nThreads);
+        std::vector<std::vector<IdSpan>> bandSpans(bands.size());
+        std::vector<std::vector<IdSpan>> bandOppositeSpans(bands.size());
+        math::detail::parallelFor(static_cast<int>(bands.size()), nThreads, [&](int i) {
+            findSpansInRows<ImagePixelT, VariancePixelT, ThresholdTraitT>(
+                    img, var, footprintThreshold, includeThresholdMultiplier, polarity, bands[i].first,
+                    bands[i].second, bandSpans[i], oppositeSpansPtr ? &bandOppositeSpans[i] : nullptr);
+        });
+        for (auto const &band : bandSpans) {
+            spans.insert(spans.end(), band.begin(), band.end());
+        }
+        for (auto const &band : bandOppositeSpans) {
+            oppositeSpans.insert(oppositeSpans.end(), band.begin(), band.end());
+        }
+    }
+    makeFootprints(spans, *_footprints, _region, row0, col0, npixMin, peakSchema);
+    if (_oppositeFootprints != nullptr) {
+        makeFootprints(oppositeSpans, *_oppositeFootprints, _region, row0, col0, npixMin, peakSchema);
+    }
     /*
      * Find all peaks within those Footprints
      */
     if (setPeaks) {
-        using fiterator = FootprintSet::FootprintList::iterator;
-        for (auto const &_footprint : *_footprints) {
-            findPeaks(_footprint, img, polarity, ThresholdTraitT());
+        findPeaks(*_footprints, img, polarity, nThreads, ThresholdTraitT());
+        if (_oppositeFootprints != nullptr) {
+            findPeaks(*_oppositeFootprints, img, !polarity, nThreads, ThresholdTraitT());
         }
     }
 }
 
 template <typename ImagePixelT>
 FootprintSet::FootprintSet(image::Image<ImagePixelT> const &img, Threshold const &threshold,
-                           int const npixMin, bool const setPeaks, table::Schema const &peakSchema)
+                           int const npixMin, bool const setPeaks, table::Schema const &peakSchema,
+                           int const numThreads)
         : _footprints(new FootprintList()), _region(img.getBBox()) {
     using VariancePixelT = float;
 
     findFootprints<ImagePixelT, image::MaskPixel, VariancePixelT, ThresholdLevel_traits>(
             _footprints.get(), _region, img, nullptr, threshold.getValue(img),
-            threshold.getIncludeMultiplier(), threshold.getPolarity(), npixMin, setPeaks, peakSchema);
+            threshold.getIncludeMultiplier(), threshold.getPolarity(), npixMin, setPeaks, numThreads,
+            peakSchema);
 }
 
 // NOTE: not a template to appease swig (see note by instantiations at bottom)
 
 template <typename MaskPixelT>
-FootprintSet::FootprintSet(image::Mask<MaskPixelT> const &msk, Threshold const &threshold, int const npixMin)
+FootprintSet::FootprintSet(image::Mask<MaskPixelT> const &msk, Threshold const &threshold, int const npixMin,
+                           int const numThreads)
         : _footprints(new FootprintList()), _region(msk.getBBox()) {
     switch (threshold.getType()) {
         case Threshold::BITMASK:
             findFootprints<MaskPixelT, MaskPixelT, float, ThresholdBitmask_traits>(
                     _footprints.get(), _region, msk, nullptr, threshold.getValue(),
-                    threshold.getIncludeMultiplier(), threshold.getPolarity(), npixMin, false);
+                    threshold.getIncludeMultiplier(), threshold.getPolarity(), npixMin, false, numThreads);
             break;
 
         case Threshold::VALUE:
             findFootprints<MaskPixelT, MaskPixelT, float, ThresholdLevel_traits>(
                     _footprints.get(), _region, msk, nullptr, threshold.getValue(),
-                    threshold.getIncludeMultiplier(), threshold.getPolarity(), npixMin, false);
+                    threshold.getIncludeMultiplier(), threshold.getPolarity(), npixMin, false, numThreads);
             break;
 
         default:
@@ -825,7 +1175,7 @@ FootprintSet::FootprintSet(image::Mask<MaskPixelT> const &msk, Threshold const &
 template <typename ImagePixelT, typename MaskPixelT>
 FootprintSet::FootprintSet(const image::MaskedImage<ImagePixelT, MaskPixelT> &maskedImg,
                            Threshold const &threshold, std::string const &planeName, int const npixMin,
-                           bool const setPeaks)
+                           bool const setPeaks, int const numThreads)
         : _footprints(new FootprintList()),
           _region(lsst::geom::Point2I(maskedImg.getX0(), maskedImg.getY0()),
                   lsst::geom::Extent2I(maskedImg.getWidth(), maskedImg.getHeight())) {
@@ -836,13 +1186,13 @@ FootprintSet::FootprintSet(const image::MaskedImage<ImagePixelT, MaskPixelT> &ma
             findFootprints<ImagePixelT, MaskPixelT, VariancePixelT, ThresholdPixelLevel_traits>(
                     _footprints.get(), _region, *maskedImg.getImage(), maskedImg.getVariance().get(),
                     threshold.getValue(maskedImg), threshold.getIncludeMultiplier(), threshold.getPolarity(),
-                    npixMin, setPeaks);
+                    npixMin, setPeaks, numThreads);
             break;
         default:
             findFootprints<ImagePixelT, MaskPixelT, VariancePixelT, ThresholdLevel_traits>(
                     _footprints.get(), _region, *maskedImg.getImage(), maskedImg.getVariance().get(),
                     threshold.getValue(maskedImg), threshold.getIncludeMultiplier(), threshold.getPolarity(),
-                    npixMin, setPeaks);
+                    npixMin, setPeaks, numThreads);
             break;
     }
     // Set Mask if requested
@@ -864,6 +1214,46 @@ FootprintSet::FootprintSet(const image::MaskedImage<ImagePixelT, MaskPixelT> &ma
     }
 }
 
+template <typename ImagePixelT, typename MaskPixelT>
+std::pair<FootprintSet, FootprintSet> FootprintSet::makeBothPolarities(
+        image::MaskedImage<ImagePixelT, MaskPixelT> const &maskedImg, Threshold const &threshold,
+        std::string const &positivePlaneName, std::string const &negativePlaneName, int const npixMin,
+        bool const setPeaks, int const numThreads) {
+    using VariancePixelT = typename image::MaskedImage<ImagePixelT, MaskPixelT>::Variance::Pixel;
+    lsst::geom::Box2I const region = maskedImg.getBBox();
+    std::pair<FootprintSet, FootprintSet> result(FootprintSet{region}, FootprintSet{region});
+    FootprintList *positive = result.first._footprints.get();
+    FootprintList *negative = result.second._footprints.get();
+    // Find the Footprints
+    switch (threshold.getType()) {
+        case Threshold::BITMASK:
+            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                              "A BITMASK threshold has no negative polarity");
+        case Threshold::PIXEL_STDEV:
+            findFootprints<ImagePixelT, MaskPixelT, VariancePixelT, ThresholdPixelLevel_traits>(
+                    positive, region, *maskedImg.getImage(), maskedImg.getVariance().get(),
+                    threshold.getValue(maskedImg), threshold.getIncludeMultiplier(), true, npixMin, setPeaks,
+                    numThreads, PeakTable::makeMinimalSchema(), negative);
+            break;
+        default:
+            findFootprints<ImagePixelT, MaskPixelT, VariancePixelT, ThresholdLevel_traits>(
+                    positive, region, *maskedImg.getImage(), maskedImg.getVariance().get(),
+                    threshold.getValue(maskedImg), threshold.getIncludeMultiplier(), true, npixMin, setPeaks,
+                    numThreads, PeakTable::makeMinimalSchema(), negative);
+            break;
+    }
+    // Set Masks if requested
+    for (auto const &planeAndSet : {std::make_pair(&positivePlaneName, &result.first),
+                                    std::make_pair(&negativePlaneName, &result.second)}) {
+        if (*planeAndSet.first == "") {
+            continue;
+        }
+        maskedImg.getMask()->addMaskPlane(*planeAndSet.first);
+        planeAndSet.second->setMask(maskedImg.getMask(), *planeAndSet.first, numThreads);
+    }
+    return result;
+}
+
 FootprintSet::FootprintSet(lsst::geom::Box2I region)
         : _footprints(std::make_shared<FootprintList>()), _region(region) {}
 
@@ -896,6 +1286,20 @@ void FootprintSet::merge(FootprintSet const &rhs, int tGrow, int rGrow, bool iso
     swap(fs);  // Swap the new FootprintSet into place
 }
 
+FootprintSet FootprintSet::transform(geom::TransformPoint2ToPoint2 const &t, lsst::geom::Box2I const &region,
+                                     bool doClip, int numThreads) const {
+    FootprintSet result(region);
+    *result._footprints = transformFootprints(*_footprints, t, region, doClip, numThreads);
+    return result;
+}
+
+FootprintSet FootprintSet::transform(geom::SkyWcs const &source, geom::SkyWcs const &target,
+                                     lsst::geom::Box2I const &region, bool doClip, int numThreads) const {
+    FootprintSet result(region);
+    *result._footprints = transformFootprints(*_footprints, source, target, region, doClip, numThreads);
+    return result;
+}
+
 void FootprintSet::setRegion(lsst::geom::Box2I const &region) {
     _region = region;
 
@@ -920,6 +1324,20 @@ FootprintSet::FootprintSet(FootprintSet const &rhs, int r, bool isotropic)
     swap(fs);  // Swap the new FootprintSet into place
 }
 
+FootprintSet::FootprintSet(FootprintSet const &rhs, int r, bool isotropic, GrowthAlgorithm algorithm,
+                           int numThreads)
+        : _footprints(new FootprintList), _region(rhs._region) {
+    math::detail::resolveNumThreads(numThreads);  // check it even when it's not used
+    if (algorithm == GrowthAlgorithm::DILATE || r <= 0) {
+        FootprintSet fs(rhs, r, isotropic);
+        swap(fs);  // Swap the new FootprintSet into place
+        return;
+    }
+
+    FootprintSet fs = growByDistanceTransform(rhs, r, isotropic, numThreads);
+    swap(fs);  // Swap the new FootprintSet into place
+}
+
 FootprintSet::FootprintSet(FootprintSet const &rhs, int ngrow, FootprintControl const &ctrl)
         : _footprints(new FootprintList), _region(rhs._region) {
     if (ngrow == 0) {
@@ -941,28 +1359,50 @@ FootprintSet::FootprintSet(FootprintSet const &fs1, FootprintSet const &fs2, boo
     throw LSST_EXCEPT(pex::exceptions::LogicError, "NOT IMPLEMENTED");
 }
 
-std::shared_ptr<image::Image<FootprintIdPixel>> FootprintSet::insertIntoImage() const {
+std::shared_ptr<image::Image<FootprintIdPixel>> FootprintSet::insertIntoImage(int numThreads) const {
     auto im = std::make_shared<image::Image<FootprintIdPixel>>(_region);
-    *im = 0;
+    insertIntoImage(*im, numThreads);
+    return im;
+}
 
-    FootprintIdPixel id = 0;
-    for (auto const &fIter : *_footprints) {
-        id++;
-        fIter->getSpans()->applyFunctor(setIdImage<FootprintIdPixel>(id), *im);
-    }
+void FootprintSet::insertIntoImage(image::Image<FootprintIdPixel> &idImage, int numThreads) const {
+    idImage = 0;
+    paintFootprints(*_footprints, idImage.getBBox(), idImage.getArray().getData(),
+                    idImage.getArray().getStride<0>(), numThreads,
+                    [](FootprintIdPixel *row, int x0, int x1, std::size_t index) {
+                        for (int x = x0; x <= x1; ++x) {
+                            row[x] += index + 1;
+                        }
+                    });
+}
 
-    return im;
+template <typename MaskPixelT>
+void FootprintSet::setMask(image::Mask<MaskPixelT> *mask, std::string const &planeName, int numThreads) {
+    MaskPixelT const bitmask = image::Mask<MaskPixelT>::getPlaneBitMask(planeName);
+    paintFootprints(*_footprints, mask->getBBox(), mask->getArray().getData(),
+                    mask->getArray().template getStride<0>(), numThreads,
+                    [bitmask](MaskPixelT *row, int x0, int x1, std::size_t) {
+                        for (int x = x0; x <= x1; ++x) {
+                            row[x] |= bitmask;
+                        }
+                    });
 }
 
 template <typename ImagePixelT, typename MaskPixelT>
 void FootprintSet::makeHeavy(image::MaskedImage<ImagePixelT, MaskPixelT> const &mimg,
-                             HeavyFootprintCtrl const *ctrl) {
+                             HeavyFootprintCtrl const *ctrl, int numThreads) {
     HeavyFootprintCtrl ctrl_s = HeavyFootprintCtrl();
 
     if (!ctrl) {
         ctrl = &ctrl_s;
     }
 
+    if (ctrl->getModifySource() == HeavyFootprintCtrl::NONE) {
+        auto heavies = makeHeavyFootprints(*_footprints, mimg, numThreads);
+        std::copy(heavies.begin(), heavies.end(), _footprints->begin());
+        return;
+    }
+    // Modifying the source makes each Footprint depend on those before it, so go one at a time
     for (FootprintList::iterator ptr = _footprints->begin(), end = _footprints->end(); ptr != end; ++ptr) {
         ptr->reset(new HeavyFootprint<ImagePixelT, MaskPixelT>(**ptr, mimg, ctrl));
     }
@@ -976,6 +1416,27 @@ void FootprintSet::makeSources(afw::table::SourceCatalog &cat) const {
     }
 }
 
+PeakCatalog FootprintSet::makePeakCatalog() const {
+    if (_footprints->empty()) {
+        return PeakCatalog(PeakTable::makeMinimalSchema());
+    }
+    PeakCatalog result(_footprints->front()->getPeaks().getTable());
+    std::size_t nPeaks = 0;
+    for (auto const &foot : *_footprints) {
+        if (foot->getPeaks().getSchema() != result.getSchema()) {
+            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                              "The Peaks of all the Footprints must have the same schema");
+        }
+        nPeaks += foot->getPeaks().size();
+    }
+    result.reserve(nPeaks);
+    for (auto const &foot : *_footprints) {
+        PeakCatalog const &peaks = foot->getPeaks();
+        result.insert(result.end(), peaks.begin(), peaks.end());
+    }
+    return result;
+}
+
 std::ostream &operator<<(std::ostream &os, FootprintSet const &rhs) {
     os << rhs.getFootprints()->size() << " footprints:\n";
     auto delimiter = "";
@@ -994,16 +1455,20 @@ std::ostream &operator<<(std::ostream &os, FootprintSet const &rhs) {
 
 #define INSTANTIATE(PIXEL)                                                                              \
     template FootprintSet::FootprintSet(image::Image<PIXEL> const &, Threshold const &, int const,      \
-                                        bool const, table::Schema const &);                             \
+                                        bool const, table::Schema const &, int const);                  \
     template FootprintSet::FootprintSet(image::MaskedImage<PIXEL, image::MaskPixel> const &,            \
-                                        Threshold const &, std::string const &, int const, bool const); \
+                                        Threshold const &, std::string const &, int const, bool const,  \
+                                        int const);                                                     \
+    template std::pair<FootprintSet, FootprintSet> FootprintSet::makeBothPolarities(                    \
+            image::MaskedImage<PIXEL, image::MaskPixel> const &, Threshold const &,                     \
+            std::string const &, std::string const &, int const, bool const, int const);                \
     template void FootprintSet::makeHeavy(image::MaskedImage<PIXEL, image::MaskPixel> const &,          \
-                                          HeavyFootprintCtrl const *)
+                                          HeavyFootprintCtrl const *, int)
 
-template FootprintSet::FootprintSet(image::Mask<image::MaskPixel> const &, Threshold const &, int const);
+template FootprintSet::FootprintSet(image::Mask<image::MaskPixel> const &, Threshold const &, int const,
+                                    int const);
 
-template void FootprintSet::setMask(image::Mask<image::MaskPixel> *, std::string const &);
-template void FootprintSet::setMask(std::shared_ptr<image::Mask<image::MaskPixel>>, std::string const &);
+template void FootprintSet::setMask(image::Mask<image::MaskPixel> *, std::string const &, int);
 
 INSTANTIATE(std::uint16_t);
 INSTANTIATE(int);
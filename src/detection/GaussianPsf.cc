@@ -21,9 +21,11 @@
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
 
+#include <cmath>
 #include <memory>
+#include <vector>
 
-#include "ndarray/eigen.h"
+#include "boost/format.hpp"
 
 #include "lsst/afw/detection/GaussianPsf.h"
 #include "lsst/afw/table/io/OutputArchive.h"
@@ -93,6 +95,20 @@ void checkDimensions(lsst::geom::Extent2I const& dimensions) {
     }
 }
 
+// Values of a normalized 1-d Gaussian at n consecutive integer positions starting at x0.
+std::vector<double> makeProfile(int x0, int n, double sigma) {
+    std::vector<double> profile(n);
+    double sum = 0.0;
+    for (int i = 0; i < n; ++i) {
+        double const x = x0 + i;
+        sum += profile[i] = std::exp(-0.5 * x * x / (sigma * sigma));
+    }
+    for (double& value : profile) {
+        value /= sum;
+    }
+    return profile;
+}
+
 }  // namespace
 
 GaussianPsf::GaussianPsf(int width, int height, double sigma)
@@ -131,18 +147,32 @@ void GaussianPsf::write(OutputArchiveHandle& handle) const {
     handle.saveCatalog(catalog);
 }
 
-std::shared_ptr<GaussianPsf::Image> GaussianPsf::doComputeKernelImage(lsst::geom::Point2D const&,
-                                                                      image::Color const&) const {
-    std::shared_ptr<Image> r(new Image(computeBBox(getAveragePosition())));
-    Image::Array array = r->getArray();
-    double sum = 0.0;
-    for (int yIndex = 0, y = r->getY0(); yIndex < _dimensions.getY(); ++yIndex, ++y) {
-        Image::Array::Reference row = array[yIndex];
-        for (int xIndex = 0, x = r->getX0(); xIndex < _dimensions.getX(); ++xIndex, ++x) {
-            sum += row[xIndex] = std::exp(-0.5 * (x * x + y * y) / (_sigma * _sigma));
+void GaussianPsf::computeKernelArray(ndarray::Array<Pixel, 2, 1> const& array) const {
+    int const width = _dimensions.getX();
+    int const height = _dimensions.getY();
+    if (array.getSize<0>() != static_cast<std::size_t>(height) ||
+        array.getSize<1>() != static_cast<std::size_t>(width)) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("Array has shape (%d, %d); GaussianPsf dimensions are %dx%d") %
+                           array.getSize<0>() % array.getSize<1>() % width % height)
+                                  .str());
+    }
+    lsst::geom::Point2I const min = doComputeBBox(getAveragePosition(), getAverageColor()).getMin();
+    std::vector<double> const xProfile = makeProfile(min.getX(), width, _sigma);
+    std::vector<double> const yProfile = makeProfile(min.getY(), height, _sigma);
+    for (int y = 0; y < height; ++y) {
+        Pixel* row = array[y].getData();
+        double const yValue = yProfile[y];
+        for (int x = 0; x < width; ++x) {
+            row[x] = yValue * xProfile[x];
         }
     }
-    ndarray::asEigenMatrix(array) /= sum;
+}
+
+std::shared_ptr<GaussianPsf::Image> GaussianPsf::doComputeKernelImage(lsst::geom::Point2D const&,
+                                                                      image::Color const&) const {
+    auto r = std::make_shared<Image>(computeBBox(getAveragePosition()));
+    computeKernelArray(r->getArray());
     return r;
 }
 
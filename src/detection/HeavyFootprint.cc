@@ -20,9 +20,13 @@
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include <memory>
+#include <type_traits>
+#include <vector>
 
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/image/MaskedImage.h"
@@ -30,6 +34,8 @@
 #include "lsst/afw/detection/HeavyFootprint.h"
 #include "lsst/afw/detection/Footprint.h"
 #include "lsst/afw/detection/FootprintCtrl.h"
+#include "lsst/afw/detection/detail/CompactEncoding.h"
+#include "lsst/afw/math/detail/Parallel.h"
 #include "lsst/afw/table/io/CatalogVector.h"
 #include "lsst/afw/table/io/OutputArchive.h"
 #include "lsst/afw/table/io/Persistable.cc"
@@ -198,13 +204,155 @@ double HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>::dot(
     return sum;
 }
 
+namespace {
+
+// A span of one of many Footprints, and where its pixels start in that Footprint's arrays
+struct SpanRun {
+    int y;
+    int x0;
+    int width;
+    std::size_t footprint;
+    std::size_t offset;
+};
+
+/* Gather the spans of many Footprints, sorted by row and in the Footprints' order within a row, after
+ * checking that every Footprint lies within bbox; image rows can then be swept once, in order.
+ */
+template <typename FootprintPtr>
+std::vector<SpanRun> gatherSpanRuns(std::vector<FootprintPtr> const& footprints,
+                                    lsst::geom::Box2I const& bbox) {
+    std::size_t nSpans = 0;
+    for (auto const& footprint : footprints) {
+        if (!bbox.contains(footprint->getBBox())) {
+            throw LSST_EXCEPT(pex::exceptions::OutOfRangeError, "Footprint lands outside image");
+        }
+        nSpans += footprint->getSpans()->size();
+    }
+    std::vector<SpanRun> runs;
+    runs.reserve(nSpans);
+    for (std::size_t i = 0; i < footprints.size(); ++i) {
+        std::size_t offset = 0;
+        for (auto const& span : *footprints[i]->getSpans()) {
+            runs.push_back(SpanRun{span.getY(), span.getX0(), span.getWidth(), i, offset});
+            offset += span.getWidth();
+        }
+    }
+    std::stable_sort(runs.begin(), runs.end(), [](SpanRun const& a, SpanRun const& b) { return a.y < b.y; });
+    return runs;
+}
+
+/* Call func(run) for every run, spreading bands of whole rows over threads; runs in one row are
+ * always handled in order by one thread, so later Footprints win where Footprints overlap.
+ */
+template <typename F>
+void forEachSpanRun(std::vector<SpanRun> const& runs, int numThreads, F const& func) {
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    if (nThreads == 1 || runs.empty()) {
+        std::for_each(runs.begin(), runs.end(), func);
+        return;
+    }
+    std::vector<std::size_t> rowStarts;
+    for (std::size_t i = 0; i < runs.size(); ++i) {
+        if (i == 0 || runs[i].y != runs[i - 1].y) {
+            rowStarts.push_back(i);
+        }
+    }
+    rowStarts.push_back(runs.size());
+    auto const bands = math::detail::splitRange(0, static_cast<int>(rowStarts.size()) - 1, nThreads);
+    math::detail::parallelFor(static_cast<int>(bands.size()), nThreads, [&](int i) {
+        std::for_each(runs.begin() + rowStarts[bands[i].first], runs.begin() + rowStarts[bands[i].second],
+                      func);
+    });
+}
+
+// Pointer to the pixel of an image plane at a position in PARENT coordinates
+template <typename T>
+class PlanePointer {
+public:
+    template <typename ImageT>
+    explicit PlanePointer(ImageT& image)
+            : _data(image.getArray().getData()),
+              _stride(image.getArray().template getStride<0>()),
+              _xy0(image.getXY0()) {}
+
+    T* operator()(int y, int x) const { return _data + (y - _xy0.getY()) * _stride + (x - _xy0.getX()); }
+
+private:
+    T* _data;
+    std::ptrdiff_t _stride;
+    lsst::geom::Point2I _xy0;
+};
+
+}  // namespace
+
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+std::vector<std::shared_ptr<HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>>> makeHeavyFootprints(
+        std::vector<std::shared_ptr<Footprint>> const& footprints,
+        image::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT> const& mimage, int numThreads) {
+    std::vector<SpanRun> const runs = gatherSpanRuns(footprints, mimage.getBBox());
+    std::vector<std::shared_ptr<HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>>> heavies;
+    heavies.reserve(footprints.size());
+    // Find the arrays once, not for every span
+    std::vector<ImagePixelT*> imageData;
+    std::vector<MaskPixelT*> maskData;
+    std::vector<VariancePixelT*> varianceData;
+    for (auto const& footprint : footprints) {
+        auto heavy = std::make_shared<HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>>(*footprint);
+        imageData.push_back(heavy->getImageArray().getData());
+        maskData.push_back(heavy->getMaskArray().getData());
+        varianceData.push_back(heavy->getVarianceArray().getData());
+        heavies.push_back(std::move(heavy));
+    }
+    PlanePointer<ImagePixelT const> const image(*mimage.getImage());
+    PlanePointer<MaskPixelT const> const mask(*mimage.getMask());
+    PlanePointer<VariancePixelT const> const variance(*mimage.getVariance());
+    forEachSpanRun(runs, numThreads, [&](SpanRun const& run) {
+        std::copy_n(image(run.y, run.x0), run.width, imageData[run.footprint] + run.offset);
+        std::copy_n(mask(run.y, run.x0), run.width, maskData[run.footprint] + run.offset);
+        std::copy_n(variance(run.y, run.x0), run.width, varianceData[run.footprint] + run.offset);
+    });
+    return heavies;
+}
+
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+void insertHeavyFootprints(
+        std::vector<std::shared_ptr<HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>>> const& heavies,
+        image::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>& mimage, int numThreads) {
+    // Find the arrays once, not for every span
+    std::vector<ImagePixelT const*> imageData;
+    std::vector<MaskPixelT const*> maskData;
+    std::vector<VariancePixelT const*> varianceData;
+    for (auto const& ptr : heavies) {
+        HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT> const& heavy = *ptr;
+        std::size_t const area = heavy.getArea();
+        if (heavy.getImageArray().template getSize<0>() < area ||
+            heavy.getMaskArray().template getSize<0>() < area ||
+            heavy.getVarianceArray().template getSize<0>() < area) {
+            throw LSST_EXCEPT(pex::exceptions::OutOfRangeError, "HeavyFootprint has fewer pixels than spans");
+        }
+        imageData.push_back(heavy.getImageArray().getData());
+        maskData.push_back(heavy.getMaskArray().getData());
+        varianceData.push_back(heavy.getVarianceArray().getData());
+    }
+    std::vector<SpanRun> const runs = gatherSpanRuns(heavies, mimage.getBBox());
+    PlanePointer<ImagePixelT> const image(*mimage.getImage());
+    PlanePointer<MaskPixelT> const mask(*mimage.getMask());
+    PlanePointer<VariancePixelT> const variance(*mimage.getVariance());
+    forEachSpanRun(runs, numThreads, [&](SpanRun const& run) {
+        std::copy_n(imageData[run.footprint] + run.offset, run.width, image(run.y, run.x0));
+        std::copy_n(maskData[run.footprint] + run.offset, run.width, mask(run.y, run.x0));
+        std::copy_n(varianceData[run.footprint] + run.offset, run.width, variance(run.y, run.x0));
+    });
+}
+
 // Persistence (using afw::table::io)
 //
 
 namespace {
 
-// Schema and Keys used to persist the pixels of a HeavyFootprint (Spans and Peaks are handled by the
-// Footprint base class).  This is a singleton, but a different one for each template instantiation.
+// Schema and Keys used to read the uncompressed pixels written by older versions (Spans and Peaks are
+// handled by the Footprint base class).  This is a singleton, but a different one for each template
+// instantiation.
 template <typename ImagePixelT, typename MaskPixelT = image::MaskPixel,
           typename VariancePixelT = image::VariancePixel>
 struct HeavyFootprintPersistenceHelper {
@@ -228,6 +376,171 @@ private:
                       "variance", "variance pixels for HeavyFootprint", "count^2")) {}
 };
 
+// Schema and Key of the compact form of the pixels: a single field holding the image, mask and variance
+// pixels encoded by encodePixels.  Unlike HeavyFootprintPersistenceHelper, this is the same for all
+// pixel types.
+struct CompactPixelsPersistenceHelper {
+    afw::table::Schema schema;
+    afw::table::Key<afw::table::Array<std::uint8_t>> pixels;
+
+    static CompactPixelsPersistenceHelper const& get() {
+        static CompactPixelsPersistenceHelper const instance;
+        return instance;
+    }
+
+private:
+    CompactPixelsPersistenceHelper()
+            : schema(),
+              pixels(schema.addField<afw::table::Array<std::uint8_t>>(
+                      "pixels", "compressed image, mask and variance pixels for HeavyFootprint")) {}
+};
+
+// Version of the compact encoding, written as its first byte
+constexpr std::uint8_t COMPACT_PIXELS_VERSION = 1;
+
+// Unsigned integer with the same size as T, for handling its bits
+template <typename T>
+using BitsOf = std::conditional_t<sizeof(T) == 8, std::uint64_t,
+                                  std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint16_t>>;
+
+// Append n bytes to a buffer with PackBits run-length encoding: a control byte c < 128 is followed by
+// c + 1 literal bytes, and a control byte c > 128 by one byte to be repeated 257 - c times.
+void appendPackBits(std::uint8_t const* bytes, std::size_t n, std::vector<std::uint8_t>& buffer) {
+    std::size_t i = 0;
+    while (i < n) {
+        std::size_t run = 1;
+        while (i + run < n && run < 128 && bytes[i + run] == bytes[i]) {
+            ++run;
+        }
+        if (run >= 3) {
+            buffer.push_back(static_cast<std::uint8_t>(257 - run));
+            buffer.push_back(bytes[i]);
+            i += run;
+            continue;
+        }
+        // Gather literals until the next run of three equal bytes
+        std::size_t literal = 0;
+        while (i + literal < n && literal < 128 &&
+               !(i + literal + 2 < n && bytes[i + literal] == bytes[i + literal + 1] &&
+                 bytes[i + literal] == bytes[i + literal + 2])) {
+            ++literal;
+        }
+        buffer.push_back(static_cast<std::uint8_t>(literal - 1));
+        buffer.insert(buffer.end(), bytes + i, bytes + i + literal);
+        i += literal;
+    }
+}
+
+// Read n bytes written by appendPackBits, advancing data past them
+void readPackBits(std::uint8_t const*& data, std::uint8_t const* end, std::uint8_t* bytes, std::size_t n) {
+    std::size_t i = 0;
+    while (i < n) {
+        LSST_ARCHIVE_ASSERT(data != end && *data != 128);
+        std::size_t const control = *data++;
+        if (control < 128) {
+            std::size_t const literal = control + 1;
+            LSST_ARCHIVE_ASSERT(literal <= n - i && literal <= static_cast<std::size_t>(end - data));
+            std::copy_n(data, literal, bytes + i);
+            data += literal;
+            i += literal;
+        } else {
+            std::size_t const run = 257 - control;
+            LSST_ARCHIVE_ASSERT(run <= n - i && data != end);
+            std::fill_n(bytes + i, run, *data++);
+            i += run;
+        }
+    }
+}
+
+// Append the pixels of one plane.  Integer pixels are written as variable-length differences from
+// the previous pixel.  Floating-point pixels are XORed with the previous pixel, so that the sign,
+// exponent and leading mantissa bits shared by neighbouring pixels become zero, and the result is
+// split into one plane per byte, each run-length encoded.
+template <typename T>
+void appendPlane(T const* pixels, std::size_t n, std::vector<std::uint8_t>& buffer) {
+    if constexpr (std::is_integral<T>::value) {
+        std::int64_t previous = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            detail::appendSignedVarint(static_cast<std::int64_t>(pixels[i]) - previous, buffer);
+            previous = pixels[i];
+        }
+    } else {
+        using Bits = BitsOf<T>;
+        std::vector<Bits> bits(n);
+        Bits previous = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            Bits current;
+            std::memcpy(&current, pixels + i, sizeof(T));
+            bits[i] = current ^ previous;
+            previous = current;
+        }
+        std::vector<std::uint8_t> bytes(n);
+        for (std::size_t k = 0; k < sizeof(T); ++k) {
+            for (std::size_t i = 0; i < n; ++i) {
+                bytes[i] = static_cast<std::uint8_t>(bits[i] >> (8 * k));
+            }
+            appendPackBits(bytes.data(), n, buffer);
+        }
+    }
+}
+
+// Read the pixels of one plane written by appendPlane, advancing data past them
+template <typename T>
+void readPlane(std::uint8_t const*& data, std::uint8_t const* end, T* pixels, std::size_t n) {
+    if constexpr (std::is_integral<T>::value) {
+        std::int64_t previous = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            previous += detail::readSignedVarint(data, end);
+            pixels[i] = static_cast<T>(previous);
+        }
+    } else {
+        using Bits = BitsOf<T>;
+        std::vector<Bits> bits(n, 0);
+        std::vector<std::uint8_t> bytes(n);
+        for (std::size_t k = 0; k < sizeof(T); ++k) {
+            readPackBits(data, end, bytes.data(), n);
+            for (std::size_t i = 0; i < n; ++i) {
+                bits[i] |= static_cast<Bits>(bytes[i]) << (8 * k);
+            }
+        }
+        Bits previous = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            previous ^= bits[i];
+            std::memcpy(pixels + i, &previous, sizeof(T));
+        }
+    }
+}
+
+// Append mask pixels as runs of equal values: each run is its value and its length, as
+// variable-length integers.  Most of the pixels of a typical HeavyFootprint share a few mask values.
+template <typename MaskPixelT>
+void appendMaskPlane(MaskPixelT const* pixels, std::size_t n, std::vector<std::uint8_t>& buffer) {
+    using Bits = std::make_unsigned_t<MaskPixelT>;
+    std::size_t i = 0;
+    while (i < n) {
+        std::size_t run = 1;
+        while (i + run < n && pixels[i + run] == pixels[i]) {
+            ++run;
+        }
+        detail::appendVarint(static_cast<Bits>(pixels[i]), buffer);
+        detail::appendVarint(run, buffer);
+        i += run;
+    }
+}
+
+template <typename MaskPixelT>
+void readMaskPlane(std::uint8_t const*& data, std::uint8_t const* end, MaskPixelT* pixels, std::size_t n) {
+    using Bits = std::make_unsigned_t<MaskPixelT>;
+    std::size_t i = 0;
+    while (i < n) {
+        auto const value = static_cast<MaskPixelT>(static_cast<Bits>(detail::readVarint(data, end)));
+        std::uint64_t const run = detail::readVarint(data, end);
+        LSST_ARCHIVE_ASSERT(run > 0u && run <= n - i);
+        std::fill_n(pixels + i, run, value);
+        i += run;
+    }
+}
+
 // These suffix-computing structs are used to compute the string name associated with a HeavyFootprint
 // for Persistence.
 // We don't instantiate HeavyFootprints with anything other than defaults for Mask and Variance, so we
@@ -262,19 +575,22 @@ std::string HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>::getPersiste
 
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
 void HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>::write(OutputArchiveHandle& handle) const {
-    HeavyFootprintPersistenceHelper<ImagePixelT, MaskPixelT, VariancePixelT> const& keys =
-            HeavyFootprintPersistenceHelper<ImagePixelT, MaskPixelT, VariancePixelT>::get();
     // delegate to Footprint::write to handle spans and peaks
     Footprint::write(handle);
-    // add one more catalog for pixel values
+    // add one more catalog for pixel values, compressed into a single blob
+    auto const& keys = CompactPixelsPersistenceHelper::get();
+    std::size_t const n = getArea();
+    std::vector<std::uint8_t> buffer;
+    buffer.reserve(n * (sizeof(ImagePixelT) + sizeof(VariancePixelT)) / 2 + 16);
+    buffer.push_back(COMPACT_PIXELS_VERSION);
+    detail::appendVarint(n, buffer);
+    appendPlane(getImageArray().getData(), n, buffer);
+    appendMaskPlane(getMaskArray().getData(), n, buffer);
+    appendPlane(getVarianceArray().getData(), n, buffer);
+    ndarray::Array<std::uint8_t, 1, 1> pixels = ndarray::allocate(buffer.size());
+    std::copy(buffer.begin(), buffer.end(), pixels.begin());
     afw::table::BaseCatalog cat = handle.makeCatalog(keys.schema);
-    std::shared_ptr<afw::table::BaseRecord> record = cat.addNew();
-    // We could deep-copy the arrays instead of const-casting them, which might be marginally safer,
-    // but we always save an OutputArchive to disk immediately after we create it, so there's really
-    // no chance that we could get the HeavyFootprint in trouble by having this view modified.
-    record->set(keys.image, ndarray::const_array_cast<ImagePixelT>(getImageArray()));
-    record->set(keys.mask, ndarray::const_array_cast<MaskPixelT>(getMaskArray()));
-    record->set(keys.variance, ndarray::const_array_cast<VariancePixelT>(getVarianceArray()));
+    cat.addNew()->set(keys.pixels, pixels);
     handle.saveCatalog(cat);
 }
 
@@ -301,6 +617,24 @@ public:
         // Create the HeavyFootprint from the above Footprint
         auto result =
                 std::make_shared<HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>>(*loadedFootprint);
+
+        // Handle pixels saved in their compact form
+        auto const& compactKeys = CompactPixelsPersistenceHelper::get();
+        if (catalogs[2].getSchema() == compactKeys.schema) {
+            auto const encoded = record.get(compactKeys.pixels);
+            std::uint8_t const* data = encoded.getData();
+            std::uint8_t const* const end = data + encoded.getNumElements();
+            LSST_ARCHIVE_ASSERT(data != end && *data == COMPACT_PIXELS_VERSION);
+            ++data;
+            std::size_t const n = result->getArea();
+            LSST_ARCHIVE_ASSERT(detail::readVarint(data, end) == n);
+            readPlane(data, end, result->_image.getData(), n);
+            readMaskPlane(data, end, result->_mask.getData(), n);
+            readPlane(data, end, result->_variance.getData(), n);
+            LSST_ARCHIVE_ASSERT(data == end);
+            return result;
+        }
+
         result->_image = ndarray::const_array_cast<ImagePixelT>(record.get(keys.image));
 
         // Handle legacy Masks prior to change to int32
@@ -334,7 +668,13 @@ typename HeavyFootprint<ImagePixelT, MaskPixelT, VariancePixelT>::Factory
             std::shared_ptr<table::io::Persistable> const&);                                         \
     template class detection::HeavyFootprint<TYPE>;                                                  \
     template std::shared_ptr<detection::HeavyFootprint<TYPE>> detection::mergeHeavyFootprints<TYPE>( \
-            detection::HeavyFootprint<TYPE> const&, detection::HeavyFootprint<TYPE> const&);
+            detection::HeavyFootprint<TYPE> const&, detection::HeavyFootprint<TYPE> const&);         \
+    template std::vector<std::shared_ptr<detection::HeavyFootprint<TYPE>>>                           \
+    detection::makeHeavyFootprints<TYPE>(std::vector<std::shared_ptr<detection::Footprint>> const&,  \
+                                         image::MaskedImage<TYPE> const&, int);                      \
+    template void detection::insertHeavyFootprints<TYPE>(                                            \
+            std::vector<std::shared_ptr<detection::HeavyFootprint<TYPE>>> const&,                    \
+            image::MaskedImage<TYPE>&, int);
 
 INSTANTIATE(std::uint16_t);
 INSTANTIATE(double);
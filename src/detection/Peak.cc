@@ -43,6 +43,7 @@ public:
 
 protected:
     void _writeTable(std::shared_ptr<afw::table::BaseTable const> const& table, std::size_t nRows) override;
+    bool _writesRecordsUnchanged() const override { return true; }
 };
 
 void PeakFitsWriter::_writeTable(std::shared_ptr<afw::table::BaseTable const> const& t, std::size_t nRows) {
@@ -73,6 +74,7 @@ public:
     std::shared_ptr<afw::table::BaseTable> makeTable(afw::table::io::FitsSchemaInputMapper& mapper,
                                                      std::shared_ptr<daf::base::PropertyList> metadata,
                                                      int ioFlags, bool stripMetadata) const override {
+        mapper.require(PeakTable::makeMinimalSchema());
         std::shared_ptr<PeakTable> table = PeakTable::make(mapper.finalize());
         table->setMetadata(metadata);
         return table;
@@ -2,10 +2,18 @@
 #include <limits>
 #include <cmath>
 #include <memory>
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "boost/format.hpp"
 
 #include "lsst/cpputils/Cache.h"
 #include "lsst/afw/detection/Psf.h"
+#include "lsst/afw/math/Instrumentation.h"
 #include "lsst/afw/math/offsetImage.h"
+#include "lsst/afw/math/detail/Parallel.h"
 #include "lsst/afw/table/io/Persistable.cc"
 
 namespace lsst {
@@ -61,6 +69,98 @@ struct hash<lsst::afw::detection::detail::PsfCacheKey> {
 namespace lsst {
 namespace afw {
 namespace detection {
+namespace detail {
+
+// Cache of PSF images that may be used from several threads at once.
+//
+// cpputils::Cache reorders its entries even on lookup, so it needs a lock for every access.  To keep
+// threads working at different positions from contending for one lock, the entries are spread over
+// shards by the hash of their key, each an independent Cache with its own lock and a share of the
+// capacity.  Images are computed outside the lock, so computing one may look up others (even in the
+// same shard) without deadlocking.
+class PsfCache {
+public:
+    using Value = std::shared_ptr<image::Image<double>>;
+
+    explicit PsfCache(std::size_t capacity) : _capacity(capacity) {
+        _shards.reserve(N_SHARDS);
+        for (std::size_t i = 0; i < N_SHARDS; ++i) {
+            _shards.push_back(std::make_unique<Shard>(shardCapacity(capacity)));
+        }
+    }
+
+    // Return the cached value for key, or compute it with func(key) and cache it
+    template <typename Generator>
+    Value operator()(PsfCacheKey const &key, Generator func) {
+        Shard &shard = getShard(key);
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            std::optional<Value> cached = shard.cache.get(key);
+            if (cached) {
+                ++_hits;
+                LSST_AFW_INSTRUMENT_COUNT("detection.Psf.cacheHit", 1);
+                return *cached;
+            }
+        }
+        ++_misses;
+        LSST_AFW_INSTRUMENT_COUNT("detection.Psf.cacheMiss", 1);
+        Value value;
+        {
+            LSST_AFW_MEMORY_SCOPE("detection.Psf.cache");
+            value = func(key);
+        }
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        // If another thread cached this key meanwhile, keep its value so all callers share one image
+        return shard.cache(key, [&value](PsfCacheKey const &) { return value; });
+    }
+
+    // Return the cached value for key, if any; doesn't count towards the statistics
+    std::optional<Value> get(PsfCacheKey const &key) {
+        Shard &shard = getShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.cache.get(key);
+    }
+
+    std::size_t capacity() const { return _capacity; }
+
+    void reserve(std::size_t capacity) {
+        for (auto &shard : _shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->cache.reserve(shardCapacity(capacity));
+        }
+        _capacity = capacity;
+    }
+
+    std::size_t getHits() const { return _hits; }
+    std::size_t getMisses() const { return _misses; }
+
+    void resetStatistics() {
+        _hits = 0;
+        _misses = 0;
+    }
+
+private:
+    static constexpr std::size_t N_SHARDS = 8;
+
+    struct Shard {
+        explicit Shard(std::size_t capacity) : cache(capacity) {}
+
+        std::mutex mutex;
+        cpputils::Cache<PsfCacheKey, Value> cache;
+    };
+
+    // Round up, so that a nonzero capacity leaves room in every shard
+    static std::size_t shardCapacity(std::size_t capacity) { return (capacity + N_SHARDS - 1) / N_SHARDS; }
+
+    Shard &getShard(PsfCacheKey const &key) { return *_shards[std::hash<PsfCacheKey>()(key) % N_SHARDS]; }
+
+    std::atomic<std::size_t> _capacity;
+    std::vector<std::unique_ptr<Shard>> _shards;
+    std::atomic<std::size_t> _hits{0};
+    std::atomic<std::size_t> _misses{0};
+};
+
+}  // namespace detail
 
 namespace {
 
@@ -69,16 +169,19 @@ bool isPointNull(lsst::geom::Point2D const &p) { return std::isnan(p.getX()) &&
 }  // namespace
 
 Psf::Psf(bool isFixed, std::size_t capacity) : _isFixed(isFixed) {
-    _imageCache = std::make_unique<PsfCache>(capacity);
-    _kernelImageCache = std::make_unique<PsfCache>(capacity);
+    _imageCache = std::make_unique<detail::PsfCache>(capacity);
+    _kernelImageCache = std::make_unique<detail::PsfCache>(capacity);
 }
 
 Psf::~Psf() = default;
 
-Psf::Psf(Psf const &other) : Psf(other._isFixed, other.getCacheCapacity()) {}
+Psf::Psf(Psf const &other) : Psf(other._isFixed, other.getCacheCapacity()) {
+    _cacheGridSize = other._cacheGridSize;
+}
 
 Psf::Psf(Psf &&other)
         : _isFixed(other._isFixed),
+          _cacheGridSize(other._cacheGridSize),
           _imageCache(std::move(other._imageCache)),
           _kernelImageCache(std::move(other._kernelImageCache)) {}
 
@@ -115,6 +218,7 @@ std::shared_ptr<Psf::Image> Psf::computeKernelImage(lsst::geom::Point2D position
                                                     ImageOwnerEnum owner) const {
     if (_isFixed || isPointNull(position)) position = getAveragePosition();
     if (_isFixed || color.isIndeterminate()) color = getAverageColor();
+    if (!_isFixed) position = snapToCacheGrid(position);
     std::shared_ptr<Psf::Image> result = (*_kernelImageCache)(
             detail::PsfCacheKey(position, color),
             [this](detail::PsfCacheKey const &key) { return doComputeKernelImage(key.position, key.color); });
@@ -124,9 +228,56 @@ std::shared_ptr<Psf::Image> Psf::computeKernelImage(lsst::geom::Point2D position
     return result;
 }
 
+std::vector<std::shared_ptr<Psf::Image>> Psf::computeKernelImages(
+        std::vector<lsst::geom::Point2D> const &positions, std::vector<image::Color> const &colors,
+        int numThreads) const {
+    if (!colors.empty() && colors.size() != positions.size()) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("Number of colors (%d) does not match number of positions (%d)") %
+                           colors.size() % positions.size())
+                                  .str());
+    }
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    std::vector<std::shared_ptr<Image>> result(positions.size());
+    if (result.empty()) return result;
+    if (_isFixed) {
+        std::shared_ptr<Image> image = computeKernelImage(getAveragePosition(), getAverageColor(), INTERNAL);
+        for (auto &element : result) {
+            element = std::make_shared<Image>(*image, true);
+        }
+        return result;
+    }
+
+    std::vector<lsst::geom::Point2D> fullPositions(positions);
+    std::vector<image::Color> fullColors(positions.size(), getAverageColor());
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        if (isPointNull(fullPositions[i])) fullPositions[i] = getAveragePosition();
+        fullPositions[i] = snapToCacheGrid(fullPositions[i]);
+        if (!colors.empty() && !colors[i].isIndeterminate()) fullColors[i] = colors[i];
+    }
+
+    auto const batches = math::detail::splitRange(0, static_cast<int>(positions.size()), nThreads);
+    math::detail::parallelFor(static_cast<int>(batches.size()), nThreads, [&](int b) {
+        auto const begin = batches[b].first;
+        auto const end = batches[b].second;
+        std::vector<std::shared_ptr<Image>> images = doComputeKernelImages(
+                std::vector<lsst::geom::Point2D>(fullPositions.begin() + begin, fullPositions.begin() + end),
+                std::vector<image::Color>(fullColors.begin() + begin, fullColors.begin() + end));
+        if (images.size() != static_cast<std::size_t>(end - begin)) {
+            throw LSST_EXCEPT(pex::exceptions::LogicError,
+                              (boost::format("doComputeKernelImages returned %d images for %d positions") %
+                               images.size() % (end - begin))
+                                      .str());
+        }
+        std::move(images.begin(), images.end(), result.begin() + begin);
+    });
+    return result;
+}
+
 lsst::geom::Box2I Psf::computeBBox(lsst::geom::Point2D position, image::Color color) const {
     if (isPointNull(position)) position = getAveragePosition();
     if (color.isIndeterminate()) color = getAverageColor();
+    if (!_isFixed) position = snapToCacheGrid(position);
     auto cached_image = _kernelImageCache->get(detail::PsfCacheKey(position, color));
     if (cached_image.has_value()) {
         return cached_image.value()->getBBox();
@@ -186,6 +337,16 @@ lsst::geom::Box2I Psf::doComputeImageBBox(lsst::geom::Point2D const& position,
     return im->getBBox();
 }
 
+std::vector<std::shared_ptr<Psf::Image>> Psf::doComputeKernelImages(
+        std::vector<lsst::geom::Point2D> const &positions, std::vector<image::Color> const &colors) const {
+    std::vector<std::shared_ptr<Image>> result;
+    result.reserve(positions.size());
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        result.push_back(doComputeKernelImage(positions[i], colors[i]));
+    }
+    return result;
+}
+
 lsst::geom::Point2D Psf::getAveragePosition() const { return lsst::geom::Point2D(); }
 
 std::size_t Psf::getCacheCapacity() const { return _kernelImageCache->capacity(); }
@@ -195,6 +356,35 @@ void Psf::setCacheCapacity(std::size_t capacity) {
     _kernelImageCache->reserve(capacity);
 }
 
+void Psf::setCacheGridSize(double gridSize) {
+    if (!(gridSize >= 0.0 && std::isfinite(gridSize))) {
+        throw LSST_EXCEPT(
+                pex::exceptions::InvalidParameterError,
+                (boost::format("Cache grid size must be finite and non-negative; got %g") % gridSize).str());
+    }
+    _cacheGridSize = gridSize;
+}
+
+lsst::geom::Point2D Psf::snapToCacheGrid(lsst::geom::Point2D const &position) const {
+    if (_cacheGridSize == 0.0) return position;
+    return lsst::geom::Point2D(std::round(position.getX() / _cacheGridSize) * _cacheGridSize,
+                               std::round(position.getY() / _cacheGridSize) * _cacheGridSize);
+}
+
+Psf::CacheStatistics Psf::getCacheStatistics() const {
+    CacheStatistics result;
+    result.imageHits = _imageCache->getHits();
+    result.imageMisses = _imageCache->getMisses();
+    result.kernelImageHits = _kernelImageCache->getHits();
+    result.kernelImageMisses = _kernelImageCache->getMisses();
+    return result;
+}
+
+void Psf::resetCacheStatistics() {
+    _imageCache->resetStatistics();
+    _kernelImageCache->resetStatistics();
+}
+
 }  // namespace detection
 }  // namespace afw
 }  // namespace lsst
@@ -1,7 +1,10 @@
 // -*- lsst-c++ -*-
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
 #include <complex>
 #include <cmath>
 #include <sstream>
@@ -10,6 +13,18 @@
 #include <filesystem>
 #include <regex>
 #include <cctype>
+#include <cerrno>
+#include <cfloat>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <optional>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include "fitsio.h"
 extern "C" {
@@ -26,6 +41,8 @@ extern "C" {
 #include "lsst/geom/Angle.h"
 #include "lsst/afw/geom/wcsUtils.h"
 #include "lsst/afw/fitsCompression.h"
+#include "lsst/afw/math/Instrumentation.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace lsst {
 namespace afw {
@@ -371,6 +388,7 @@ bool isFitsImageTypeSigned(int constant) {
 }
 
 static bool allowImageCompression = true;
+static int imageCompressionThreads = 1;
 
 int fitsTypeForBitpix(int bitpix) {
     switch (bitpix) {
@@ -483,18 +501,66 @@ std::string makeLimitedFitsHeader(daf::base::PropertySet const &metadata,
     return makeLimitedFitsHeaderImpl(desiredParamNames, metadata);
 }
 
+namespace {
+
+// Memory managed by a MemFileManager is allocated with a prefix that records its size, so that it can
+// be reused for later files: cfitsio is told only the size of the file, and reallocates as it grows.
+std::size_t const BLOCK_PREFIX = alignof(std::max_align_t);
+static_assert(BLOCK_PREFIX >= sizeof(std::size_t), "Memory block prefix cannot hold its capacity");
+
+std::size_t &blockCapacity(void *ptr) {
+    return *reinterpret_cast<std::size_t *>(static_cast<char *>(ptr) - BLOCK_PREFIX);
+}
+
+void *resizeBlock(void *block, std::size_t capacity) {
+    block = std::realloc(block, BLOCK_PREFIX + capacity);
+    if (!block) {
+        return nullptr;
+    }
+    *static_cast<std::size_t *>(block) = capacity;
+    return static_cast<char *>(block) + BLOCK_PREFIX;
+}
+
+void freeBlock(void *ptr) {
+    if (ptr) std::free(static_cast<char *>(ptr) - BLOCK_PREFIX);
+}
+
+// The reallocator given to cfitsio for managed memory.  It never shrinks a block, and grows it
+// geometrically, since cfitsio grows a file a few records at a time.
+void *reallocateBlock(void *ptr, std::size_t size) {
+    if (!ptr) {
+        return resizeBlock(nullptr, size);
+    }
+    std::size_t const capacity = blockCapacity(ptr);
+    if (size <= capacity) {
+        return ptr;
+    }
+    return resizeBlock(static_cast<char *>(ptr) - BLOCK_PREFIX, std::max(size, capacity + capacity / 2));
+}
+
+}  // namespace
+
 void MemFileManager::reset() {
-    if (_managed) std::free(_ptr);
+    if (_managed) freeBlock(_ptr);
     _ptr = nullptr;
     _len = 0;
     _managed = true;
+    _readOnly = false;
 }
 
 void MemFileManager::reset(std::size_t len) {
-    reset();
-    _ptr = std::malloc(len);
+    if (!_managed || !_ptr || blockCapacity(_ptr) < len) {
+        reset();
+        _ptr = resizeBlock(nullptr, len);
+        if (!_ptr) {
+            throw std::bad_alloc();
+        }
+    }
     _len = len;
-    _managed = true;
+}
+
+std::size_t MemFileManager::getCapacity() const {
+    return (_managed && _ptr) ? blockCapacity(_ptr) : _len;
 }
 
 template <typename T>
@@ -797,69 +863,7 @@ void Fits::readKey(std::string const &key, T &value) {
     }
 }
 
-void Fits::forEachKey(HeaderIterationFunctor &functor) {
-    char key[81];  // allow for terminating NUL
-    char value[81];
-    char comment[81];
-    int nKeys = 0;
-    fits_get_hdrspace(reinterpret_cast<fitsfile *>(fptr), &nKeys, nullptr, &status);
-    std::string keyStr;
-    std::string valueStr;
-    std::string commentStr;
-    int i = 1;
-    while (i <= nKeys) {
-        fits_read_keyn(reinterpret_cast<fitsfile *>(fptr), i, key, value, comment, &status);
-        // fits_read_keyn does not convert the key case on read, like other fits methods in cfitsio>=3.38
-        // We uppercase to try to be more consistent.
-        std::string upperKey(key);
-        boost::to_upper(upperKey);
-        if (upperKey.compare(key) != 0){
-            LOGLS_DEBUG("lsst.afw.fits",
-                        boost::format("In %s, standardizing key '%s' to uppercase '%s' on read.") %
-                        BOOST_CURRENT_FUNCTION % key % upperKey);
-        }
-        keyStr = upperKey;
-        valueStr = value;
-        commentStr = comment;
-        ++i;
-        while (valueStr.size() > 2 && valueStr[valueStr.size() - 2] == '&' && i <= nKeys) {
-            // we're using key to hold the entire record here; the actual key is safe in keyStr
-            fits_read_record(reinterpret_cast<fitsfile *>(fptr), i, key, &status);
-            if (strncmp(key, "CONTINUE", 8) != 0) {
-                // require both trailing '&' and CONTINUE to invoke long-string handling
-                break;
-            }
-            std::string card = key;
-            valueStr.erase(valueStr.size() - 2);
-            std::size_t firstQuote = card.find('\'');
-            if (firstQuote == std::string::npos) {
-                throw LSST_EXCEPT(
-                        FitsError,
-                        makeErrorMessage(
-                                fptr, status,
-                                boost::format("Invalid CONTINUE at header key %d: \"%s\".") % i % card));
-            }
-            std::size_t lastQuote = card.find('\'', firstQuote + 1);
-            if (lastQuote == std::string::npos) {
-                throw LSST_EXCEPT(
-                        FitsError,
-                        makeErrorMessage(
-                                fptr, status,
-                                boost::format("Invalid CONTINUE at header key %d: \"%s\".") % i % card));
-            }
-            valueStr += card.substr(firstQuote + 1, lastQuote - firstQuote);
-            std::size_t slash = card.find('/', lastQuote + 1);
-            if (slash != std::string::npos) {
-                commentStr += strip(card.substr(slash + 1));
-            }
-            ++i;
-        }
-        if (behavior & AUTO_CHECK) {
-            LSST_FITS_CHECK_STATUS(*this, boost::format("Reading key '%s'") % keyStr);
-        }
-        functor(keyStr, valueStr, commentStr);
-    }
-}
+void Fits::forEachKey(HeaderIterationFunctor &functor) { LazyHeader(*this).forEachKey(functor); }
 
 // ---- Reading and writing PropertySet/PropertyList --------------------------------------------------------
 
@@ -996,8 +1000,101 @@ void MetadataIterationFunctor::operator()(std::string const &key, std::string co
     }
 }
 
-void writeKeyFromProperty(Fits &fits, daf::base::PropertySet const &metadata, std::string const &key,
-                          char const *comment = nullptr) {
+/*
+ *  Header cards for Fits::writeMetadata, formatted in memory and then written together.
+ *
+ *  Cards are formatted as fits_write_key would format them.  String values are still written by
+ *  cfitsio itself (in their place among the other cards), so long strings are continued over several
+ *  cards exactly as before.  Once all cards are known, room is made for them in the header at once:
+ *  left to itself, cfitsio inserts one header block at a time as a header that already has a data
+ *  unit fills, moving everything after the header each time.
+ */
+class HeaderCardBuffer {
+public:
+    template <typename T>
+    void add(Fits &fits, char const *key, T const &value, char const *comment) {
+        char valueString[FLEN_VALUE];
+        ffi2c(static_cast<LONGLONG>(value), valueString, &fits.status);
+        _addCard(fits, key, valueString, comment);
+    }
+
+    void add(Fits &fits, char const *key, bool const &value, char const *comment) {
+        char valueString[FLEN_VALUE];
+        ffl2c(value, valueString, &fits.status);
+        _addCard(fits, key, valueString, comment);
+    }
+
+    void add(Fits &fits, char const *key, double const &value, char const *comment) {
+        std::string strValue = nonFiniteDoubleToString(value);
+        if (!strValue.empty()) {
+            add(fits, key, strValue, comment);
+            return;
+        }
+        char valueString[FLEN_VALUE];
+        ffd2e(value, -DBL_DIG, valueString, &fits.status);  // as fits_write_key does for TDOUBLE
+        _addCard(fits, key, valueString, comment);
+    }
+
+    void add(Fits &, char const *key, std::string const &value, char const *comment) {
+        _entries.push_back({std::string(), key, value, comment ? comment : "", comment != nullptr});
+    }
+
+    // Add a key with an undefined value, as fits_write_key_null does
+    void add(Fits &fits, char const *key, char const *comment) {
+        char valueString[] = " ";
+        _addCard(fits, key, valueString, comment);
+    }
+
+    // Write all cards to the current HDU, after the cards already there.
+    void write(Fits &fits) {
+        auto fptr = reinterpret_cast<fitsfile *>(fits.fptr);
+        int nExisting = 0;
+        int nMore = 0;  // -1 if the header has no data unit after it yet, and so can grow freely
+        fits_get_hdrspace(fptr, &nExisting, &nMore, &fits.status);
+        long const nCards = _entries.size();  // strings may take more, but take at least one
+        if (fits.status == 0 && nMore >= 0 && nCards > nMore) {
+            long const nBlocks = (nCards - nMore + CARDS_PER_BLOCK - 1) / CARDS_PER_BLOCK;
+            ffiblk(fptr, nBlocks, 0, &fits.status);
+        }
+        for (auto const &entry : _entries) {
+            if (fits.status != 0) {
+                break;
+            }
+            if (!entry.card.empty()) {
+                fits_write_record(fptr, entry.card.c_str(), &fits.status);
+            } else {
+                writeKeyImpl(fits, entry.key.c_str(), entry.value,
+                             entry.hasComment ? entry.comment.c_str() : nullptr);
+            }
+        }
+        _entries.clear();
+    }
+
+private:
+    static long const CARDS_PER_BLOCK = 36;  // 2880-byte block / 80-character card
+
+    // A formatted card, or (if card is empty) a string value to be written by cfitsio
+    struct Entry {
+        std::string card;
+        std::string key;
+        std::string value;
+        std::string comment;
+        bool hasComment;
+    };
+
+    void _addCard(Fits &fits, char const *key, char *valueString, char const *comment) {
+        char card[FLEN_CARD];
+        ffmkky(const_cast<char *>(key), valueString, const_cast<char *>(comment), card, &fits.status);
+        if (fits.status == 0) {
+            _entries.push_back({card, std::string(), std::string(), std::string(), false});
+        }
+    }
+
+    std::vector<Entry> _entries;
+};
+
+void writeKeyFromProperty(Fits &fits, HeaderCardBuffer &cards, daf::base::PropertySet const &metadata,
+                          std::string const &key, char const *comment = nullptr) {
     std::string upperKey(key);
     boost::to_upper(upperKey);
     if (upperKey.compare(key) != 0){
@@ -1018,83 +1115,83 @@ void writeKeyFromProperty(Fits &fits, daf::base::PropertySet const &metadata, st
             std::vector<bool> tmp = metadata.getArray<bool>(key);
             // work around unfortunate specialness of std::vector<bool>
             for (std::size_t i = 0; i != tmp.size(); ++i) {
-                writeKeyImpl(fits, keyName.c_str(), static_cast<bool>(tmp[i]), comment);
+                cards.add(fits, keyName.c_str(), static_cast<bool>(tmp[i]), comment);
             }
         } else {
-            writeKeyImpl(fits, keyName.c_str(), metadata.get<bool>(key), comment);
+            cards.add(fits, keyName.c_str(), metadata.get<bool>(key), comment);
         }
     } else if (valueType == typeid(std::uint8_t)) {
         if (metadata.isArray(key)) {
             std::vector<std::uint8_t> tmp = metadata.getArray<std::uint8_t>(key);
             for (std::size_t i = 0; i != tmp.size(); ++i) {
-                writeKeyImpl(fits, keyName.c_str(), tmp[i], comment);
+                cards.add(fits, keyName.c_str(), tmp[i], comment);
             }
         } else {
-            writeKeyImpl(fits, keyName.c_str(), metadata.get<std::uint8_t>(key), comment);
+            cards.add(fits, keyName.c_str(), metadata.get<std::uint8_t>(key), comment);
         }
     } else if (valueType == typeid(int)) {
         if (metadata.isArray(key)) {
             std::vector<int> tmp = metadata.getArray<int>(key);
             for (std::size_t i = 0; i != tmp.size(); ++i) {
-                writeKeyImpl(fits, keyName.c_str(), tmp[i], comment);
+                cards.add(fits, keyName.c_str(), tmp[i], comment);
             }
         } else {
-            writeKeyImpl(fits, keyName.c_str(), metadata.get<int>(key), comment);
+            cards.add(fits, keyName.c_str(), metadata.get<int>(key), comment);
         }
     } else if (valueType == typeid(long)) {
         if (metadata.isArray(key)) {
             std::vector<long> tmp = metadata.getArray<long>(key);
             for (std::size_t i = 0; i != tmp.size(); ++i) {
-                writeKeyImpl(fits, keyName.c_str(), tmp[i], comment);
+                cards.add(fits, keyName.c_str(), tmp[i], comment);
             }
         } else {
-            writeKeyImpl(fits, keyName.c_str(), metadata.get<long>(key), comment);
+            cards.add(fits, keyName.c_str(), metadata.get<long>(key), comment);
         }
     } else if (valueType == typeid(long long)) {
         if (metadata.isArray(key)) {
             std::vector<long long> tmp = metadata.getArray<long long>(key);
             for (std::size_t i = 0; i != tmp.size(); ++i) {
-                writeKeyImpl(fits, keyName.c_str(), tmp[i], comment);
+                cards.add(fits, keyName.c_str(), tmp[i], comment);
             }
         } else {
-            writeKeyImpl(fits, keyName.c_str(), metadata.get<long long>(key), comment);
+            cards.add(fits, keyName.c_str(), metadata.get<long long>(key), comment);
         }
     } else if (valueType == typeid(std::int64_t)) {
         if (metadata.isArray(key)) {
             std::vector<std::int64_t> tmp = metadata.getArray<std::int64_t>(key);
             for (std::size_t i = 0; i != tmp.size(); ++i) {
-                writeKeyImpl(fits, keyName.c_str(), tmp[i], comment);
+                cards.add(fits, keyName.c_str(), tmp[i], comment);
             }
         } else {
-            writeKeyImpl(fits, keyName.c_str(), metadata.get<std::int64_t>(key), comment);
+            cards.add(fits, keyName.c_str(), metadata.get<std::int64_t>(key), comment);
         }
     } else if (valueType == typeid(double)) {
         if (metadata.isArray(key)) {
             std::vector<double> tmp = metadata.getArray<double>(key);
             for (std::size_t i = 0; i != tmp.size(); ++i) {
-                writeKeyImpl(fits, keyName.c_str(), tmp[i], comment);
+                cards.add(fits, keyName.c_str(), tmp[i], comment);
             }
         } else {
-            writeKeyImpl(fits, keyName.c_str(), metadata.get<double>(key), comment);
+            cards.add(fits, keyName.c_str(), metadata.get<double>(key), comment);
         }
     } else if (valueType == typeid(std::string)) {
         if (metadata.isArray(key)) {
             std::vector<std::string> tmp = metadata.getArray<std::string>(key);
             for (std::size_t i = 0; i != tmp.size(); ++i) {
-                writeKeyImpl(fits, keyName.c_str(), tmp[i], comment);
+                cards.add(fits, keyName.c_str(), tmp[i], comment);
             }
         } else {
-            writeKeyImpl(fits, keyName.c_str(), metadata.get<std::string>(key), comment);
+            cards.add(fits, keyName.c_str(), metadata.get<std::string>(key), comment);
         }
     } else if (valueType == typeid(std::nullptr_t)) {
         if (metadata.isArray(key)) {
             // Write multiple undefined values for the same key
             auto tmp = metadata.getArray<std::nullptr_t>(key);
             for (std::size_t i = 0; i != tmp.size(); ++i) {
-                writeKeyImpl(fits, keyName.c_str(), comment);
+                cards.add(fits, keyName.c_str(), comment);
             }
         } else {
-            writeKeyImpl(fits, keyName.c_str(), comment);
+            cards.add(fits, keyName.c_str(), comment);
         }
     } else {
         // FIXME: inherited this error handling from fitsIo.cc; need a better option.
@@ -1110,6 +1207,202 @@ void writeKeyFromProperty(Fits &fits, daf::base::PropertySet const &metadata, st
 
 }  // namespace
 
+namespace {
+
+int const CARD_LENGTH = 80;  // characters in a FITS header card, not counting a terminating NUL
+
+}  // namespace
+
+LazyHeader::LazyHeader(Fits &fits) : _fileName(fits.getFileName()) {
+    auto fptr = reinterpret_cast<fitsfile *>(fits.fptr);
+    int nCards = 0;
+    fits_get_hdrspace(fptr, &nCards, nullptr, &fits.status);
+    _cards.assign(static_cast<std::size_t>(std::max(nCards, 0)) * CARD_LENGTH, ' ');
+    char card[FLEN_CARD];
+    for (int i = 0; i < nCards && fits.status == 0; ++i) {
+        fits_read_record(fptr, i + 1, card, &fits.status);
+        std::size_t const length = std::min<std::size_t>(std::strlen(card), CARD_LENGTH);
+        std::copy_n(card, length, _cards.begin() + static_cast<std::size_t>(i) * CARD_LENGTH);
+    }
+    if (fits.behavior & Fits::AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(fits, "Reading header");
+    }
+    if (fits.status != 0) {
+        _cards.clear();
+        return;
+    }
+
+    // Only the names are parsed here; a CONTINUE card belongs to the keyword before it
+    _keywords.reserve(nCards);
+    char name[FLEN_CARD];
+    for (int i = 0; i < nCards; ++i) {
+        _copyCard(i, card);
+        int length = 0;
+        int status = 0;
+        fits_get_keyname(card, name, &length, &status);
+        if (status != 0) {
+            throw LSST_EXCEPT(FitsError, makeErrorMessage(_fileName, status,
+                                                          boost::format("Reading name of header card %d") %
+                                                                  (i + 1)));
+        }
+        std::string upperName(name);
+        boost::to_upper(upperName);
+        if (upperName == "CONTINUE" && !_keywords.empty()) {
+            continue;
+        }
+        if (upperName.empty()) {
+            upperName = "COMMENT";
+        }
+        _index[upperName].push_back(static_cast<int>(_keywords.size()));
+        _keywords.push_back({upperName, i});
+    }
+}
+
+LazyHeader::LazyHeader(std::string const &fileName, int hdu) {
+    Fits fits(fileName, "r", Fits::AUTO_CLOSE | Fits::AUTO_CHECK);
+    fits.setHdu(hdu);
+    *this = LazyHeader(fits);
+}
+
+void LazyHeader::_copyCard(int i, char *buffer) const {
+    std::copy_n(_cards.begin() + static_cast<std::size_t>(i) * CARD_LENGTH, CARD_LENGTH, buffer);
+    buffer[CARD_LENGTH] = '\0';
+}
+
+int LazyHeader::_parseKeyword(int i, std::string &key, std::string &value, std::string &comment) const {
+    char card[FLEN_CARD];
+    char name[FLEN_CARD];
+    char valueBuffer[FLEN_CARD];
+    char commentBuffer[FLEN_CARD];
+    int length = 0;
+    int status = 0;
+    int const nCards = _cards.size() / CARD_LENGTH;
+
+    // This is what fits_read_keyn does, given the card
+    _copyCard(i, card);
+    fits_get_keyname(card, name, &length, &status);
+    fits_parse_value(card, valueBuffer, commentBuffer, &status);
+    fits_test_record(name, &status);
+    // fits_read_keyn does not convert the key case on read, like other fits methods in cfitsio>=3.38
+    // We uppercase to try to be more consistent.
+    std::string upperKey(name);
+    boost::to_upper(upperKey);
+    if (upperKey.compare(name) != 0) {
+        LOGLS_DEBUG("lsst.afw.fits",
+                    boost::format("In %s, standardizing key '%s' to uppercase '%s' on read.") %
+                            BOOST_CURRENT_FUNCTION % name % upperKey);
+    }
+    key = upperKey;
+    value = valueBuffer;
+    comment = commentBuffer;
+    ++i;
+    while (value.size() > 2 && value[value.size() - 2] == '&' && i < nCards) {
+        _copyCard(i, card);
+        if (strncmp(card, "CONTINUE", 8) != 0) {
+            // require both trailing '&' and CONTINUE to invoke long-string handling
+            break;
+        }
+        std::string const continued = strip(card);
+        value.erase(value.size() - 2);
+        std::size_t firstQuote = continued.find('\'');
+        std::size_t lastQuote =
+                firstQuote == std::string::npos ? std::string::npos : continued.find('\'', firstQuote + 1);
+        if (lastQuote == std::string::npos) {
+            throw LSST_EXCEPT(FitsError,
+                              makeErrorMessage(_fileName, status,
+                                               boost::format("Invalid CONTINUE at header key %d: \"%s\".") %
+                                                       (i + 1) % continued));
+        }
+        value += continued.substr(firstQuote + 1, lastQuote - firstQuote);
+        std::size_t slash = continued.find('/', lastQuote + 1);
+        if (slash != std::string::npos) {
+            comment += strip(continued.substr(slash + 1));
+        }
+        ++i;
+    }
+    if (status != 0) {
+        throw LSST_EXCEPT(FitsError,
+                          makeErrorMessage(_fileName, status, boost::format("Reading key '%s'") % key));
+    }
+    return i;
+}
+
+LazyHeader::Keyword const &LazyHeader::_findLast(std::string const &name) const {
+    auto const iter = _index.find(name);
+    if (iter == _index.end()) {
+        throw LSST_EXCEPT(pex::exceptions::NotFoundError,
+                          (boost::format("No keyword '%s' in header of %s") % name % _fileName).str());
+    }
+    return _keywords[iter->second.back()];
+}
+
+std::vector<std::string> LazyHeader::getNames() const {
+    std::vector<std::string> names;
+    std::unordered_set<std::string> seen;
+    for (auto const &keyword : _keywords) {
+        if (seen.insert(keyword.name).second) {
+            names.push_back(keyword.name);
+        }
+    }
+    return names;
+}
+
+std::string LazyHeader::getValueString(std::string const &name) const {
+    std::string key, value, comment;
+    _parseKeyword(_findLast(name).card, key, value, comment);
+    return value;
+}
+
+std::string LazyHeader::getComment(std::string const &name) const {
+    std::string key, value, comment;
+    _parseKeyword(_findLast(name).card, key, value, comment);
+    return comment;
+}
+
+std::shared_ptr<daf::base::PropertyList> LazyHeader::extract(std::vector<std::string> const &names,
+                                                             bool strip) const {
+    std::vector<int> selected;
+    for (auto const &name : names) {
+        auto const iter = _index.find(name);
+        if (iter != _index.end()) {
+            selected.insert(selected.end(), iter->second.begin(), iter->second.end());
+        }
+    }
+    std::sort(selected.begin(), selected.end());
+    selected.erase(std::unique(selected.begin(), selected.end()), selected.end());
+
+    auto metadata = std::make_shared<daf::base::PropertyList>();
+    MetadataIterationFunctor functor;
+    functor.strip = strip;
+    functor.set = metadata.get();
+    functor.list = metadata.get();
+    std::string key, value, comment;
+    for (int k : selected) {
+        _parseKeyword(_keywords[k].card, key, value, comment);
+        functor(key, value, comment);
+    }
+    return metadata;
+}
+
+std::shared_ptr<daf::base::PropertyList> LazyHeader::toPropertyList(bool strip) const {
+    auto metadata = std::make_shared<daf::base::PropertyList>();
+    MetadataIterationFunctor functor;
+    functor.strip = strip;
+    functor.set = metadata.get();
+    functor.list = metadata.get();
+    forEachKey(functor);
+    return metadata;
+}
+
+void LazyHeader::forEachKey(HeaderIterationFunctor &functor) const {
+    int const nCards = _cards.size() / CARD_LENGTH;
+    std::string key, value, comment;
+    for (int i = 0; i < nCards;) {
+        i = _parseKeyword(i, key, value, comment);
+        functor(key, value, comment);
+    }
+}
+
 void Fits::readMetadata(daf::base::PropertySet &metadata, bool strip) {
     MetadataIterationFunctor f;
     f.strip = strip;
@@ -1127,15 +1420,20 @@ void Fits::writeMetadata(daf::base::PropertySet const &metadata) {
     } else {
         paramNames = metadata.paramNames(false);
     }
+    HeaderCardBuffer cards;
     for (auto const &paramName : paramNames) {
         if (!isKeyIgnored(paramName, true)) {
             if (pl) {
-                writeKeyFromProperty(*this, metadata, paramName, pl->getComment(paramName).c_str());
+                writeKeyFromProperty(*this, cards, metadata, paramName, pl->getComment(paramName).c_str());
             } else {
-                writeKeyFromProperty(*this, metadata, paramName);
+                writeKeyFromProperty(*this, cards, metadata, paramName);
             }
         }
     }
+    cards.write(*this);
+    if (behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(*this, "Writing metadata");
+    }
 }
 
 // ---- Manipulating tables ---------------------------------------------------------------------------------
@@ -1240,6 +1538,84 @@ void Fits::readTableScalar(std::size_t row, int col, std::string &value, bool is
     value = std::string(tmp);
 }
 
+void Fits::readTableBytes(std::size_t firstRow, std::size_t nRows, unsigned char *data) {
+    if (nRows == 0) {
+        return;
+    }
+    fitsfile *fd = reinterpret_cast<fitsfile *>(fptr);
+    LONGLONG rowWidth = 0;
+    fits_read_key(fd, TLONGLONG, const_cast<char *>("NAXIS1"), &rowWidth, nullptr, &status);
+    fits_read_tblbytes(fd, firstRow + 1, 1, nRows * rowWidth, data, &status);
+    if (behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(*this, boost::format("Reading %d table rows from row %d") % nRows % firstRow);
+    }
+}
+
+void Fits::writeTableBytes(std::size_t firstRow, std::size_t nRows, unsigned char const *data) {
+    if (nRows == 0) {
+        return;
+    }
+    fitsfile *fd = reinterpret_cast<fitsfile *>(fptr);
+    LONGLONG rowWidth = 0;
+    fits_read_key(fd, TLONGLONG, const_cast<char *>("NAXIS1"), &rowWidth, nullptr, &status);
+    fits_write_tblbytes(fd, firstRow + 1, 1, nRows * rowWidth, const_cast<unsigned char *>(data), &status);
+    if (behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(*this, boost::format("Writing %d table rows from row %d") % nRows % firstRow);
+    }
+}
+
+TableLayout Fits::getTableLayout() {
+    fitsfile *fd = reinterpret_cast<fitsfile *>(fptr);
+    int hduType = 0;
+    fits_get_hdu_type(fd, &hduType, &status);
+    if (status == 0 && hduType != BINARY_TBL) {
+        throw LSST_EXCEPT(FitsError, makeErrorMessage(fptr, status, "Current HDU is not a binary table"));
+    }
+    LONGLONG rowWidth = 0;
+    int nCols = 0;
+    fits_read_key(fd, TLONGLONG, const_cast<char *>("NAXIS1"), &rowWidth, nullptr, &status);
+    fits_get_num_cols(fd, &nCols, &status);
+    TableLayout layout{static_cast<std::size_t>(rowWidth), {}};
+    std::size_t offset = 0;
+    for (int col = 0; col < nCols && status == 0; ++col) {
+        char tform[FLEN_VALUE];
+        char ttype[FLEN_VALUE], tunit[FLEN_VALUE], dtype[FLEN_VALUE], tdisp[FLEN_VALUE];
+        std::string const key = (boost::format("TFORM%d") % (col + 1)).str();
+        fits_read_key(fd, TSTRING, const_cast<char *>(key.c_str()), tform, nullptr, &status);
+        int typecode = 0;
+        LONGLONG repeat = 0;
+        long width = 0;
+        fits_binary_tformll(tform, &typecode, &repeat, &width, &status);
+        long bclRepeat = 0, tnull = 0;
+        double scale = 1.0, zero = 0.0;
+        fits_get_bcolparms(fd, col + 1, ttype, tunit, dtype, &bclRepeat, &scale, &zero, &tnull, tdisp,
+                           &status);
+        std::size_t size = 0;
+        if (typecode < 0) {
+            // variable-length arrays store a descriptor of two 32-bit ('P') or 64-bit ('Q') integers
+            size = std::strchr(tform, 'Q') ? 16 : 8;
+        } else if (typecode == TBIT) {
+            size = (repeat + 7) / 8;
+        } else if (typecode == TSTRING) {
+            size = repeat;
+        } else {
+            size = repeat * width;
+        }
+        layout.columns.push_back(TableColumnLayout{offset, size, zero, scale});
+        offset += size;
+    }
+    if (behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(*this, "Reading binary table layout");
+    }
+    if (status == 0 && offset != layout.rowWidth) {
+        throw LSST_EXCEPT(FitsError,
+                          makeErrorMessage(fptr, status,
+                                           boost::format("Columns occupy %d bytes of %d-byte rows") % offset %
+                                                   layout.rowWidth));
+    }
+    return layout;
+}
+
 long Fits::getTableArraySize(int col) {
     int typecode = 0;
     long result = 0;
@@ -1261,6 +1637,252 @@ long Fits::getTableArraySize(std::size_t row, int col) {
     return result;
 }
 
+namespace {
+
+// Delete the keywords through which cfitsio is told how to compress a table, where present
+void deleteTableCompressionKeys(fitsfile *fd, int nCols) {
+    int keyStatus = 0;
+    fits_delete_key(fd, const_cast<char *>("FZTILELN"), &keyStatus);
+    for (int col = 1; col <= nCols; ++col) {
+        keyStatus = 0;
+        std::string const key = (boost::format("FZALG%d") % col).str();
+        fits_delete_key(fd, const_cast<char *>(key.c_str()), &keyStatus);
+    }
+}
+
+// Return the cfitsio name of the algorithm with which to compress a column, given its TFORM, or
+// null to let cfitsio choose (for variable-length arrays)
+char const *getColumnCompression(std::string const &tform,
+                                 TableCompressionOptions::CompressionAlgorithm algorithm) {
+    std::size_t const pos = tform.find_first_not_of("0123456789 ");
+    char const code = pos == std::string::npos ? 'A' : tform[pos];
+    if (code == 'P' || code == 'Q') {
+        return nullptr;
+    }
+    bool const isInteger = code == 'I' || code == 'J';
+    bool const isNumeric =
+            isInteger || code == 'K' || code == 'E' || code == 'D' || code == 'C' || code == 'M';
+    if (!isNumeric || algorithm == ImageCompressionOptions::GZIP) {
+        return "GZIP_1";
+    }
+    if (isInteger && algorithm == ImageCompressionOptions::RICE) {
+        return "RICE_1";
+    }
+    return "GZIP_2";
+}
+
+// Copy the header of a compressed table and its tiles [begin, end) to a new HDU of an empty file,
+// with ZNAXIS2 set to the number of (uncompressed) rows in those tiles
+void copyTableTiles(Fits &source, Fits &destination, long begin, long end, long tileRows, long nRows) {
+    static std::regex const structural(
+            "XTENSION|BITPIX|NAXIS[12]?|PCOUNT|GCOUNT|TFIELDS|THEAP|CHECKSUM|DATASUM|TTYPE\\d+|TFORM\\d+");
+    fitsfile *in = reinterpret_cast<fitsfile *>(source.fptr);
+    fitsfile *out = reinterpret_cast<fitsfile *>(destination.fptr);
+    int nCols = 0;
+    fits_get_num_cols(in, &nCols, &source.status);
+    std::vector<std::string> ttypes(nCols), tforms(nCols);
+    for (int col = 0; col < nCols; ++col) {
+        char value[FLEN_VALUE];
+        std::string key = (boost::format("TTYPE%d") % (col + 1)).str();
+        fits_read_key(in, TSTRING, const_cast<char *>(key.c_str()), value, nullptr, &source.status);
+        ttypes[col] = value;
+        key = (boost::format("TFORM%d") % (col + 1)).str();
+        fits_read_key(in, TSTRING, const_cast<char *>(key.c_str()), value, nullptr, &source.status);
+        tforms[col] = value;
+    }
+    LSST_FITS_CHECK_STATUS(source, "Reading compressed table columns");
+    std::vector<char *> ttypePtrs, tformPtrs;
+    for (int col = 0; col < nCols; ++col) {
+        ttypePtrs.push_back(const_cast<char *>(ttypes[col].c_str()));
+        tformPtrs.push_back(const_cast<char *>(tforms[col].c_str()));
+    }
+    destination.createEmpty();
+    fits_create_tbl(out, BINARY_TBL, 0, nCols, ttypePtrs.data(), tformPtrs.data(), nullptr, nullptr,
+                    &destination.status);
+
+    int nKeys = 0;
+    fits_get_hdrspace(in, &nKeys, nullptr, &source.status);
+    for (int i = 1; i <= nKeys && source.status == 0; ++i) {
+        char card[FLEN_CARD];
+        char name[FLEN_KEYWORD];
+        int length = 0;
+        fits_read_record(in, i, card, &source.status);
+        fits_get_keyname(card, name, &length, &source.status);
+        if (!std::regex_match(name, structural)) {
+            fits_write_record(out, card, &destination.status);
+        }
+    }
+    fits_update_key_lng(out, "ZNAXIS2", std::min(end * tileRows, nRows) - begin * tileRows, nullptr,
+                        &destination.status);
+
+    // Each tile is a row holding each column's compressed bytes
+    fits_insert_rows(out, 0, end - begin, &destination.status);
+    std::vector<unsigned char> bytes;
+    for (long tile = begin; tile < end; ++tile) {
+        for (int col = 1; col <= nCols && source.status == 0; ++col) {
+            LONGLONG size = 0, offset = 0;
+            fits_read_descriptll(in, col, tile + 1, &size, &offset, &source.status);
+            if (size == 0) {
+                continue;
+            }
+            bytes.resize(size);
+            int anyNull = 0;
+            fits_read_col(in, TBYTE, col, tile + 1, 1, size, nullptr, bytes.data(), &anyNull, &source.status);
+            fits_write_col(out, TBYTE, col, tile - begin + 1, 1, size, bytes.data(), &destination.status);
+        }
+    }
+    LSST_FITS_CHECK_STATUS(source, "Reading compressed table tiles");
+    LSST_FITS_CHECK_STATUS(destination, "Copying compressed table tiles");
+}
+
+// Decompress groups of the tiles of a compressed table concurrently, and append the table to
+// destination; returns false, having written nothing, if the table cannot be decompressed that way
+bool uncompressTableConcurrently(Fits &source, Fits &destination, int nThreads) {
+    nThreads = fits_is_reentrant() ? math::detail::resolveNumThreads(nThreads) : 1;
+    fitsfile *in = reinterpret_cast<fitsfile *>(source.fptr);
+    if (nThreads == 1 || source.status != 0 || in->Fptr->writemode != READONLY) {
+        return false;
+    }
+    // cfitsio handles are not thread-safe, so each thread opens the file itself; that requires a
+    // file on disk
+    std::string const fileName = source.getFileName();
+    if (!std::filesystem::is_regular_file(fileName)) {
+        return false;
+    }
+    int localStatus = 0;
+    long nTiles = 0;  // each row of a compressed table is a tile
+    long tileRows = 0;
+    long nRows = 0;
+    int nCols = 0;
+    fits_get_num_rows(in, &nTiles, &localStatus);
+    fits_get_num_cols(in, &nCols, &localStatus);
+    fits_read_key_lng(in, "ZTILELEN", &tileRows, nullptr, &localStatus);
+    fits_read_key_lng(in, "ZNAXIS2", &nRows, nullptr, &localStatus);
+    if (localStatus != 0 || nTiles < 2 || tileRows <= 0) {
+        return false;
+    }
+    // Tiles are only independent if the table has no variable-length arrays (which share a heap),
+    // and we only know how to copy columns of compressed bytes
+    for (int col = 1; col <= nCols; ++col) {
+        for (auto const &prefix : {"TFORM", "ZFORM"}) {
+            char tform[FLEN_VALUE];
+            std::string const key = (boost::format("%s%d") % prefix % col).str();
+            fits_read_key(in, TSTRING, const_cast<char *>(key.c_str()), tform, nullptr, &localStatus);
+            int typecode = 0;
+            LONGLONG repeat = 0;
+            long width = 0;
+            fits_binary_tformll(tform, &typecode, &repeat, &width, &localStatus);
+            bool const isCompressed = std::string(prefix) == "TFORM";
+            if (localStatus != 0 || (isCompressed ? typecode != -TBYTE : typecode < 0)) {
+                return false;
+            }
+        }
+    }
+
+    int const hdu = source.getHdu();
+    auto const chunks = math::detail::splitRange(0, static_cast<int>(nTiles), nThreads);
+    int const nChunks = chunks.size();
+    std::vector<MemFileManager> managers(nChunks);
+    std::vector<std::unique_ptr<Fits>> pieces(nChunks);
+    math::detail::parallelFor(nChunks, nThreads, [&](int iChunk) {
+        Fits reader(fileName, "r", Fits::AUTO_CLOSE | Fits::AUTO_CHECK);
+        reader.setHdu(hdu);
+        MemFileManager tilesManager;
+        Fits tiles(tilesManager, "w", Fits::AUTO_CLOSE | Fits::AUTO_CHECK);
+        copyTableTiles(reader, tiles, chunks[iChunk].first, chunks[iChunk].second, tileRows, nRows);
+        auto piece = std::make_unique<Fits>(managers[iChunk], "w", Fits::AUTO_CLOSE | Fits::AUTO_CHECK);
+        piece->createEmpty();
+        fits_uncompress_table(reinterpret_cast<fitsfile *>(tiles.fptr),
+                              reinterpret_cast<fitsfile *>(piece->fptr), &piece->status);
+        LSST_FITS_CHECK_STATUS(*piece, "Decompressing binary table");
+        pieces[iChunk] = std::move(piece);
+    });
+
+    // The first piece has the header, and the others' rows follow its own
+    destination.copyHdu(*pieces[0]);
+    std::size_t row = pieces[0]->countRows();
+    destination.addRows(nRows - row);
+    std::vector<unsigned char> buffer;
+    std::size_t const rowWidth = destination.getTableLayout().rowWidth;
+    for (int iChunk = 1; iChunk < nChunks; ++iChunk) {
+        std::size_t const n = pieces[iChunk]->countRows();
+        buffer.resize(n * rowWidth);
+        pieces[iChunk]->readTableBytes(0, n, buffer.data());
+        destination.writeTableBytes(row, n, buffer.data());
+        row += n;
+    }
+    return true;
+}
+
+}  // anonymous namespace
+
+bool Fits::isCompressedTable() {
+    fitsfile *fd = reinterpret_cast<fitsfile *>(fptr);
+    int hduType = 0;
+    fits_get_hdu_type(fd, &hduType, &status);
+    if (behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(*this, "Checking HDU type");
+    }
+    if (hduType != BINARY_TBL) {
+        return false;
+    }
+    int keyStatus = 0;
+    int compressed = 0;
+    fits_read_key(fd, TLOGICAL, const_cast<char *>("ZTABLE"), &compressed, nullptr, &keyStatus);
+    return keyStatus == 0 && compressed;
+}
+
+void Fits::writeCompressedTable(Fits &source, TableCompressionOptions const &options) {
+    if (options.algorithm == ImageCompressionOptions::PLIO) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "PLIO compression is not supported for tables");
+    }
+    if (options.algorithm == ImageCompressionOptions::NONE || source.countRows() == 0) {
+        copyHdu(source);
+        return;
+    }
+    fitsfile *in = reinterpret_cast<fitsfile *>(source.fptr);
+    int nCols = 0;
+    fits_get_num_cols(in, &nCols, &source.status);
+    for (int col = 1; col <= nCols && source.status == 0; ++col) {
+        char tform[FLEN_VALUE];
+        std::string const key = (boost::format("TFORM%d") % col).str();
+        fits_read_key(in, TSTRING, const_cast<char *>(key.c_str()), tform, nullptr, &source.status);
+        char const *algorithm = getColumnCompression(tform, options.algorithm);
+        if (algorithm) {
+            std::string const algorithmKey = (boost::format("FZALG%d") % col).str();
+            fits_update_key_str(in, algorithmKey.c_str(), algorithm, "Compression of column", &source.status);
+        }
+    }
+    if (options.rows > 0) {
+        fits_update_key_lng(in, "FZTILELN", options.rows, "Rows per compressed tile", &source.status);
+    }
+    if (source.behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(source, "Writing table compression keywords");
+    }
+    fits_compress_table(in, reinterpret_cast<fitsfile *>(fptr), &status);
+    if (behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(*this, "Compressing binary table");
+    }
+    deleteTableCompressionKeys(reinterpret_cast<fitsfile *>(fptr), nCols);
+}
+
+void Fits::writeUncompressedTable(Fits &source, int nThreads) {
+    int nCols = 0;
+    fits_get_num_cols(reinterpret_cast<fitsfile *>(source.fptr), &nCols, &source.status);
+    if (source.behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(source, "Reading number of columns");
+    }
+    if (!uncompressTableConcurrently(source, *this, nThreads)) {
+        fits_uncompress_table(reinterpret_cast<fitsfile *>(source.fptr), reinterpret_cast<fitsfile *>(fptr),
+                              &status);
+        if (behavior & AUTO_CHECK) {
+            LSST_FITS_CHECK_STATUS(*this, "Decompressing binary table");
+        }
+    }
+    deleteTableCompressionKeys(reinterpret_cast<fitsfile *>(fptr), nCols);
+}
+
 // ---- Manipulating images ---------------------------------------------------------------------------------
 
 void Fits::createEmpty() {
@@ -1271,6 +1893,13 @@ void Fits::createEmpty() {
     }
 }
 
+void Fits::copyHdu(Fits &source) {
+    fits_copy_hdu(reinterpret_cast<fitsfile *>(source.fptr), reinterpret_cast<fitsfile *>(fptr), 0, &status);
+    if (behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(*this, "Copying HDU");
+    }
+}
+
 void Fits::createImageImpl(int bitpix, int naxis, long const *naxes) {
     fits_create_img(reinterpret_cast<fitsfile *>(fptr), bitpix, naxis, const_cast<long *>(naxes), &status);
     if (behavior & AUTO_CHECK) {
@@ -1293,55 +1922,36 @@ namespace {
 ///
 /// Compression is a property of the file in cfitsio, so we need to set it,
 /// do our stuff and then disable it.
+// Restore compression settings without throwing, preserving any cfitsio error status
+void restoreImageCompression(Fits &fits, ImageCompressionOptions const &old) noexcept {
+    int status = 0;
+    std::swap(status, fits.status);
+    try {
+        fits.setImageCompression(old);
+    } catch (...) {
+        LOGLS_WARN("lsst.afw.fits",
+                   makeErrorMessage(fits.fptr, fits.status, "Failed to restore compression settings"));
+    }
+    std::swap(status, fits.status);
+}
+
 struct ImageCompressionContext {
 public:
     ImageCompressionContext(Fits &fits_, ImageCompressionOptions const &useThis)
             : fits(fits_), old(fits.getImageCompression()) {
         fits.setImageCompression(useThis);
     }
-    ~ImageCompressionContext() {
-        int status = 0;
-        std::swap(status, fits.status);
-        try {
-            fits.setImageCompression(old);
-        } catch (...) {
-            LOGLS_WARN("lsst.afw.fits",
-                       makeErrorMessage(fits.fptr, fits.status, "Failed to restore compression settings"));
-        }
-        std::swap(status, fits.status);
-    }
+    ~ImageCompressionContext() { restoreImageCompression(fits, old); }
 
 private:
     Fits &fits;                   // FITS file we're working on
     ImageCompressionOptions old;  // Former compression options, to be restored
 };
 
-}  // anonymous namespace
-
-template <typename T>
-void Fits::writeImage(image::ImageBase<T> const &image, ImageWriteOptions const &options,
-                      daf::base::PropertySet const * header,
-                      image::Mask<image::MaskPixel> const * mask) {
-    auto fits = reinterpret_cast<fitsfile *>(fptr);
-    ImageCompressionOptions const &compression =
-            image.getBBox().getArea() > 0
-                    ? options.compression
-                    : ImageCompressionOptions(
-                              ImageCompressionOptions::NONE);  // cfitsio can't compress empty images
-    ImageCompressionContext comp(*this, compression);          // RAII
-    if (behavior & AUTO_CHECK) {
-        LSST_FITS_CHECK_STATUS(*this, "Activating compression for write image");
-    }
-
-    ImageScale scale = options.scaling.determine(image, mask);
-
-    // We need a place to put the image+header, and CFITSIO needs to know the dimenions.
-    ndarray::Vector<long, 2> dims(image.getArray().getShape().reverse());
-    createImageImpl(scale.bitpix == 0 ? detail::Bitpix<T>::value : scale.bitpix, 2, dims.elems);
-
-    // Write the header
+// Write the header of a newly-created image HDU, including the WCS that records XY0
+void writeImageHeader(Fits &fits, daf::base::PropertySet const *header, lsst::geom::Point2I const &xy0) {
     std::shared_ptr<daf::base::PropertyList> wcsMetadata =
-            geom::createTrivialWcsMetadata(image::detail::wcsNameForXY0, image.getXY0());
+            geom::createTrivialWcsMetadata(image::detail::wcsNameForXY0, xy0);
     std::shared_ptr<daf::base::PropertySet> fullMetadata;
     if (header) {
         fullMetadata = header->deepCopy();
@@ -1349,13 +1959,11 @@ void Fits::writeImage(image::ImageBase<T> const &image, ImageWriteOptions const
     } else {
         fullMetadata = wcsMetadata;
     }
-    writeMetadata(*fullMetadata);
-
-    // Scale the image how we want it on disk
-    ndarray::Array<T const, 2, 2> array = makeContiguousArray(image.getArray());
-    auto pixels = scale.toFits(array, compression.quantizeLevel != 0, options.scaling.fuzz,
-                               options.compression.tiles, options.scaling.seed);
+    fits.writeMetadata(*fullMetadata);
+}
 
+template <typename T>
+void disableCfitsioScaling(Fits &fits) {
     // We only want cfitsio to do the scale and zero for unsigned 64-bit integer types. For those,
     // "double bzero" has sufficient precision to represent the appropriate value. We'll let
     // cfitsio handle it itself.
@@ -1363,19 +1971,19 @@ void Fits::writeImage(image::ImageBase<T> const &image, ImageWriteOptions const
     // (because we want to fuzz the numbers in the quantisation), so we don't want cfitsio
     // rescaling.
     if (!std::is_same<T, std::uint64_t>::value) {
-        fits_set_bscale(fits, 1.0, 0.0, &status);
-        if (behavior & AUTO_CHECK) {
-            LSST_FITS_CHECK_STATUS(*this, "Setting bscale,bzero");
+        fits_set_bscale(reinterpret_cast<fitsfile *>(fits.fptr), 1.0, 0.0, &fits.status);
+        if (fits.behavior & Fits::AUTO_CHECK) {
+            LSST_FITS_CHECK_STATUS(fits, "Setting bscale,bzero");
         }
     }
+}
 
-    // Write the pixels
-    int const fitsType = scale.bitpix == 0 ? FitsType<T>::CONSTANT : fitsTypeForBitpix(scale.bitpix);
-    fits_write_img(fits, fitsType, 1, pixels->getNumElements(), const_cast<void *>(pixels->getData()),
-                   &status);
-    if (behavior & AUTO_CHECK) {
-        LSST_FITS_CHECK_STATUS(*this, "Writing image");
-    }
+// Write the scaling keywords and finalize the header, once all of the pixels of an image are written
+template <typename T>
+void finishImage(Fits &fits, ImageScale const &scale, ImageScalingOptions const &scaling) {
+    auto fptr = reinterpret_cast<fitsfile *>(fits.fptr);
+    int &status = fits.status;
+    bool const check = fits.behavior & Fits::AUTO_CHECK;
 
     // Now write the headers we didn't want cfitsio to know about when we were writing the pixels
     // (because we don't want it using them to modify the pixels, and we don't want it overwriting
@@ -1384,42 +1992,390 @@ void Fits::writeImage(image::ImageBase<T> const &image, ImageWriteOptions const
         std::isfinite(scale.bzero) && std::isfinite(scale.bscale) && (scale.bscale != 0.0)) {
         if (std::numeric_limits<T>::is_integer) {
             if (scale.bzero != 0.0) {
-                fits_write_key_lng(fits, "BZERO", static_cast<long>(scale.bzero),
+                fits_write_key_lng(fptr, "BZERO", static_cast<long>(scale.bzero),
                                    "Scaling: MEMORY = BZERO + BSCALE * DISK", &status);
             }
             if (scale.bscale != 1.0) {
-                fits_write_key_lng(fits, "BSCALE", static_cast<long>(scale.bscale),
+                fits_write_key_lng(fptr, "BSCALE", static_cast<long>(scale.bscale),
                                    "Scaling: MEMORY = BZERO + BSCALE * DISK", &status);
             }
         } else {
-            fits_write_key_dbl(fits, "BZERO", scale.bzero, 12, "Scaling: MEMORY = BZERO + BSCALE * DISK",
+            fits_write_key_dbl(fptr, "BZERO", scale.bzero, 12, "Scaling: MEMORY = BZERO + BSCALE * DISK",
                                &status);
-            fits_write_key_dbl(fits, "BSCALE", scale.bscale, 12, "Scaling: MEMORY = BZERO + BSCALE * DISK",
+            fits_write_key_dbl(fptr, "BSCALE", scale.bscale, 12, "Scaling: MEMORY = BZERO + BSCALE * DISK",
                                &status);
         }
-        if (behavior & AUTO_CHECK) {
-            LSST_FITS_CHECK_STATUS(*this, "Writing BSCALE,BZERO");
+        if (check) {
+            LSST_FITS_CHECK_STATUS(fits, "Writing BSCALE,BZERO");
         }
     }
 
     if (scale.bitpix > 0 && !std::numeric_limits<T>::is_integer) {
-        fits_write_key_lng(fits, "BLANK", scale.blank, "Value for undefined pixels", &status);
-        fits_write_key_lng(fits, "ZDITHER0", options.scaling.seed, "Dithering seed", &status);
-        fits_write_key_str(fits, "ZQUANTIZ", "SUBTRACTIVE_DITHER_1", "Dithering algorithm", &status);
-        if (behavior & AUTO_CHECK) {
-            LSST_FITS_CHECK_STATUS(*this, "Writing [Z]BLANK");
+        fits_write_key_lng(fptr, "BLANK", scale.blank, "Value for undefined pixels", &status);
+        fits_write_key_lng(fptr, "ZDITHER0", scaling.seed, "Dithering seed", &status);
+        fits_write_key_str(fptr, "ZQUANTIZ", "SUBTRACTIVE_DITHER_1", "Dithering algorithm", &status);
+        if (check) {
+            LSST_FITS_CHECK_STATUS(fits, "Writing [Z]BLANK");
         }
     }
 
     // cfitsio says this is deprecated, but Pan-STARRS found that it was sometimes necessary, writing:
     // "This forces a re-scan of the header to ensure everything's kosher.
     // Without this, compressed HDUs have been written out with PCOUNT=0 and TFORM1 not correctly set."
-    fits_set_hdustruc(fits, &status);
+    fits_set_hdustruc(fptr, &status);
+    if (check) {
+        LSST_FITS_CHECK_STATUS(fits, "Finalizing header");
+    }
+}
+
+// DATASUM is the 32-bit ones' complement sum of the data unit read as big-endian words.  That sum is
+// associative and commutative, so it may be accumulated a piece at a time, in any order, as pixels
+// are written; each pixel contributes its value shifted to its place within a word.
+
+/// Add with end-around carry, reducing a sum of 32-bit words to 32 bits (zero only if all are)
+std::uint32_t foldCarries(std::uint64_t sum) {
+    while (sum >> 32) {
+        sum = (sum & 0xffffffff) + (sum >> 32);
+    }
+    return sum;
+}
+
+/// The ones' complement sum of pixels [begin, end), where pixel 0 is pixel number `first` of the image
+template <typename U>
+std::uint32_t sumPixels(U const *pixels, std::size_t begin, std::size_t end, std::size_t first) {
+    static_assert(sizeof(U) == 1 || sizeof(U) == 2 || sizeof(U) == 4 || sizeof(U) == 8,
+                  "Pixels must be 1, 2, 4 or 8 bytes");
+    using Bits = std::conditional_t<
+            sizeof(U) == 1, std::uint8_t,
+            std::conditional_t<sizeof(U) == 2, std::uint16_t,
+                               std::conditional_t<sizeof(U) == 4, std::uint32_t, std::uint64_t>>>;
+    constexpr std::size_t nLanes = sizeof(U) < 4 ? 4 / sizeof(U) : 1;  // pixels per word
+    std::uint64_t lanes[nLanes] = {};
+    std::uint64_t sum = 0;
+    for (std::size_t i = begin; i < end;) {
+        // Fold often enough that the lanes cannot overflow
+        std::size_t const stop = std::min(end, i + (std::size_t(1) << 30));
+        for (; i < stop; ++i) {
+            Bits bits;
+            std::memcpy(&bits, pixels + i, sizeof(U));
+            if constexpr (sizeof(U) == 8) {
+                lanes[0] += (bits >> 32) + (bits & 0xffffffff);  // 2^32 == 1 in this arithmetic
+            } else {
+                lanes[(first + i) % nLanes] += bits;
+            }
+        }
+        for (std::size_t lane = 0; lane < nLanes; ++lane) {
+            // the first pixel of a word is its most significant
+            int const shift = sizeof(U) < 4 ? 8 * (4 - sizeof(U) * (lane + 1)) : 0;
+            sum = foldCarries(sum + (std::uint64_t(foldCarries(lanes[lane])) << shift));
+            lanes[lane] = 0;
+        }
+    }
+    return sum;
+}
+
+/// Add the next pixels of an image to its DATASUM, splitting the work between threads
+template <typename U>
+std::uint32_t addToDataSum(std::uint32_t sum, U const *pixels, std::size_t num, std::size_t first) {
+    // As in fitsCompression.cc, pieces of fewer than 2^16 pixels aren't worth a thread
+    std::size_t const nThreads = math::detail::resolveNumThreads(getImageCompressionThreads());
+    std::size_t const nParts = std::max<std::size_t>(1, std::min(nThreads, num >> 16));
+    std::vector<std::uint32_t> sums(nParts, 0);
+    math::detail::parallelFor(nParts, nParts, [&](int iPart) {
+        sums[iPart] = sumPixels(pixels, num * iPart / nParts, num * (iPart + 1) / nParts, first);
+    });
+    std::uint64_t total = sum;
+    for (auto part : sums) {
+        total += part;
+    }
+    return foldCarries(total);
+}
+
+/// Add the next pixels of an image to its DATASUM, given their BITPIX
+std::uint32_t addToDataSum(std::uint32_t sum, detail::PixelArrayBase const &pixels, int bitpix,
+                           std::size_t first) {
+    void const *data = pixels.getData();
+    std::size_t const num = pixels.getNumElements();
+    switch (bitpix) {
+        case 8:
+            return addToDataSum(sum, static_cast<std::uint8_t const *>(data), num, first);
+        case 16:
+            return addToDataSum(sum, static_cast<std::int16_t const *>(data), num, first);
+        case 32:
+            return addToDataSum(sum, static_cast<std::int32_t const *>(data), num, first);
+        case 64:
+            return addToDataSum(sum, static_cast<std::int64_t const *>(data), num, first);
+        case -32:
+            return addToDataSum(sum, static_cast<float const *>(data), num, first);
+        case -64:
+            return addToDataSum(sum, static_cast<double const *>(data), num, first);
+        default:
+            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                              (boost::format("Invalid bitpix value: %d") % bitpix).str());
+    }
+}
+
+/// Return the BITPIX of the pixels that toFits returns for a scale, if cfitsio writes them
+/// unchanged (but for byte order), or 0 if it converts them (or compresses them)
+template <typename T>
+int getUnconvertedBitpix(Fits &fits, ImageScale const &scale) {
+    int compressed = 0;
+    int localStatus = 0;
+    fits_is_compressed_image(reinterpret_cast<fitsfile *>(fits.fptr), &compressed, &localStatus);
+    if (localStatus != 0 || compressed) {
+        return 0;
+    }
+    if (scale.bitpix != 0) {
+        return scale.bitpix;  // pixels have been converted to the type on disk
+    }
+    // Unsigned types other than 8-bit are offset by cfitsio
+    bool const unconverted = !std::numeric_limits<T>::is_integer || std::numeric_limits<T>::is_signed ||
+                             sizeof(T) == 1;
+    return unconverted ? detail::Bitpix<T>::value : 0;
+}
+
+/// Write DATASUM and CHECKSUM for an image whose data and header are complete
+///
+/// If dataSum is given, only the header is summed; otherwise cfitsio reads back the whole HDU.
+void writeChecksums(Fits &fits, std::optional<std::uint32_t> dataSum) {
+    auto fptr = reinterpret_cast<fitsfile *>(fits.fptr);
+    if (dataSum) {
+        std::string const value = std::to_string(*dataSum);
+        fits_update_key_str(fptr, "CHECKSUM", "0000000000000000", "HDU checksum", &fits.status);
+        fits_update_key_str(fptr, "DATASUM", value.c_str(), "data unit checksum", &fits.status);
+        fits_update_chksum(fptr, &fits.status);
+    } else {
+        fits_write_chksum(fptr, &fits.status);
+    }
+    if (fits.behavior & Fits::AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(fits, "Writing checksums");
+    }
+}
+
+}  // anonymous namespace
+
+template <typename T>
+void Fits::writeImage(image::ImageBase<T> const &image, ImageWriteOptions const &options,
+                      daf::base::PropertySet const * header,
+                      image::Mask<image::MaskPixel> const * mask) {
+    LSST_AFW_INSTRUMENT_SCOPE("fits.writeImage");
+    auto fits = reinterpret_cast<fitsfile *>(fptr);
+    ImageCompressionOptions const &compression =
+            image.getBBox().getArea() > 0
+                    ? options.compression
+                    : ImageCompressionOptions(
+                              ImageCompressionOptions::NONE);  // cfitsio can't compress empty images
+    ImageCompressionContext comp(*this, compression);          // RAII
     if (behavior & AUTO_CHECK) {
-        LSST_FITS_CHECK_STATUS(*this, "Finalizing header");
+        LSST_FITS_CHECK_STATUS(*this, "Activating compression for write image");
+    }
+
+    ImageScale scale = options.scaling.determine(image, mask);
+
+    // We need a place to put the image+header, and CFITSIO needs to know the dimenions.
+    ndarray::Vector<long, 2> dims(image.getArray().getShape().reverse());
+    createImageImpl(scale.bitpix == 0 ? detail::Bitpix<T>::value : scale.bitpix, 2, dims.elems);
+
+    writeImageHeader(*this, header, image.getXY0());
+
+    // Scale the image how we want it on disk
+    ndarray::Array<T const, 2, 2> array = makeContiguousArray(image.getArray());
+    auto pixels = scale.toFits(array, compression.quantizeLevel != 0, options.scaling.fuzz,
+                               options.compression.tiles, options.scaling.seed);
+
+    disableCfitsioScaling<T>(*this);
+
+    // Write the pixels
+    int const fitsType = scale.bitpix == 0 ? FitsType<T>::CONSTANT : fitsTypeForBitpix(scale.bitpix);
+    fits_write_img(fits, fitsType, 1, pixels->getNumElements(), const_cast<void *>(pixels->getData()),
+                   &status);
+    if (behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(*this, "Writing image");
+    }
+
+    finishImage<T>(*this, scale, options.scaling);
+
+    if (options.checksum) {
+        int const bitpix = getUnconvertedBitpix<T>(*this, scale);
+        writeChecksums(*this, bitpix != 0 ? std::make_optional(addToDataSum(0, *pixels, bitpix, 0))
+                                          : std::nullopt);
+    }
+}
+
+namespace {
+
+// Determine the scaling of an image that is written a strip at a time, which can't depend on the pixels
+template <typename T>
+ImageScale determineStreamScale(ImageScalingOptions const &scaling) {
+    switch (scaling.algorithm) {
+        case ImageScalingOptions::NONE:
+            break;
+        case ImageScalingOptions::MANUAL:
+            if (scaling.fuzz && !std::numeric_limits<T>::is_integer && scaling.bitpix > 0) {
+                throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                                  "Fuzz is not supported when writing an image a strip at a time");
+            }
+            break;
+        default:
+            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                              "Only NONE and MANUAL scaling are supported when writing an image a strip "
+                              "at a time");
+    }
+    return scaling.determine(ndarray::Array<T const, 2, 2>(), ndarray::Array<bool, 2, 2>());
+}
+
+}  // anonymous namespace
+
+template <typename T>
+ImageStreamWriter<T>::ImageStreamWriter(Fits &fitsfile, lsst::geom::Box2I const &bbox,
+                                        ImageWriteOptions const &options,
+                                        daf::base::PropertySet const *header)
+        : _fits(fitsfile),
+          _bbox(bbox),
+          _options(options),
+          _previous(fitsfile.getImageCompression()),
+          _scale(determineStreamScale<T>(options.scaling)),
+          _stripHeight(1),
+          _rowsBuffered(0),
+          _rowsFlushed(0),
+          _dataSumBitpix(0),
+          _dataSum(0),
+          _restored(false),
+          _closed(false) {
+    if (bbox.isEmpty()) {
+        _options.compression = ImageCompressionOptions(ImageCompressionOptions::NONE);  // as in writeImage
+    }
+    _fits.setImageCompression(_options.compression);
+    try {
+        if (_fits.behavior & Fits::AUTO_CHECK) {
+            LSST_FITS_CHECK_STATUS(_fits, "Activating compression for write image");
+        }
+        _fits.createImage(_scale.bitpix == 0 ? detail::Bitpix<T>::value : _scale.bitpix,
+                          ndarray::makeVector<ndarray::Size>(bbox.getHeight(), bbox.getWidth()));
+        writeImageHeader(_fits, header, bbox.getMin());
+        disableCfitsioScaling<T>(_fits);
+
+        // cfitsio compresses whole tiles, so rows are buffered until a row of tiles is complete
+        auto fptr = reinterpret_cast<fitsfile *>(_fits.fptr);
+        int localStatus = 0;
+        if (fits_is_compressed_image(fptr, &localStatus)) {
+            long tileHeight = 0;
+            fits_read_key_lng(fptr, "ZTILE2", &tileHeight, nullptr, &localStatus);
+            _stripHeight = (localStatus == 0 && tileHeight > 0 && tileHeight < bbox.getHeight())
+                                   ? tileHeight
+                                   : std::max(bbox.getHeight(), 1);
+        }
+        _buffer = ndarray::allocate(_stripHeight > 1 ? _stripHeight : 0, bbox.getWidth());
+        if (_options.checksum) {
+            _dataSumBitpix = getUnconvertedBitpix<T>(_fits, _scale);
+        }
+    } catch (...) {
+        restoreImageCompression(_fits, _previous);
+        throw;
+    }
+}
+
+template <typename T>
+ImageStreamWriter<T>::~ImageStreamWriter() noexcept {
+    if (!_closed) {
+        LOGLS_WARN("lsst.afw.fits", "Image stream destroyed before being closed; " << getRowsWritten()
+                                            << " of " << _bbox.getHeight() << " rows were supplied");
+    }
+    if (!_restored) {
+        restoreImageCompression(_fits, _previous);
+    }
+}
+
+template <typename T>
+void ImageStreamWriter<T>::writeRows(ndarray::Array<T const, 2, 1> const &rows) {
+    if (_closed) {
+        throw LSST_EXCEPT(pex::exceptions::LogicError, "Cannot write rows to a closed image stream");
+    }
+    int const nRows = rows.template getSize<0>();
+    if (nRows == 0) {
+        return;
+    }
+    int const height = _bbox.getHeight();
+    if (rows.template getSize<1>() != static_cast<ndarray::Size>(_bbox.getWidth())) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("Rows have width %d; the image has width %d") %
+                           rows.template getSize<1>() % _bbox.getWidth())
+                                  .str());
+    }
+    if (getRowsWritten() + nRows > height) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("Cannot write %d rows: only %d of the image's %d rows remain") %
+                           nRows % (height - getRowsWritten()) % height)
+                                  .str());
+    }
+
+    int row = 0;
+    while (row < nRows) {
+        int const remaining = nRows - row;
+        if (_rowsBuffered == 0) {
+            // Complete strips, and the last strip of the image, are written without copying
+            int const direct =
+                    _rowsFlushed + remaining == height ? remaining : remaining - remaining % _stripHeight;
+            if (direct > 0) {
+                _flush(rows[ndarray::view(row, row + direct)()]);
+                row += direct;
+                continue;
+            }
+        }
+        int const n = std::min(remaining, _stripHeight - _rowsBuffered);
+        _buffer[ndarray::view(_rowsBuffered, _rowsBuffered + n)()].deep() =
+                rows[ndarray::view(row, row + n)()];
+        _rowsBuffered += n;
+        row += n;
+        if (_rowsBuffered == _stripHeight || _rowsFlushed + _rowsBuffered == height) {
+            int const nBuffered = _rowsBuffered;
+            _rowsBuffered = 0;
+            _flush(_buffer[ndarray::view(0, nBuffered)()]);
+        }
     }
 }
 
+template <typename T>
+void ImageStreamWriter<T>::_flush(ndarray::Array<T const, 2, 1> const &rows) {
+    ndarray::Array<T const, 2, 2> array = makeContiguousArray(rows);
+    auto pixels = _scale.toFits(array, _options.compression.quantizeLevel != 0, _options.scaling.fuzz,
+                                _options.compression.tiles, _options.scaling.seed);
+    int const fitsType = _scale.bitpix == 0 ? FitsType<T>::CONSTANT : fitsTypeForBitpix(_scale.bitpix);
+    LONGLONG const first = static_cast<LONGLONG>(_rowsFlushed) * _bbox.getWidth() + 1;
+    fits_write_img(reinterpret_cast<fitsfile *>(_fits.fptr), fitsType, first, pixels->getNumElements(),
+                   const_cast<void *>(pixels->getData()), &_fits.status);
+    if (_fits.behavior & Fits::AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(_fits, "Writing image rows");
+    }
+    if (_dataSumBitpix != 0) {
+        _dataSum = addToDataSum(_dataSum, *pixels, _dataSumBitpix, static_cast<std::size_t>(first - 1));
+    }
+    _rowsFlushed += array.template getSize<0>();
+}
+
+template <typename T>
+void ImageStreamWriter<T>::close() {
+    if (_closed) {
+        throw LSST_EXCEPT(pex::exceptions::LogicError, "Image stream has already been closed");
+    }
+    if (getRowsWritten() != _bbox.getHeight()) {
+        throw LSST_EXCEPT(pex::exceptions::LogicError,
+                          (boost::format("Cannot close image stream: only %d of %d rows were written") %
+                           getRowsWritten() % _bbox.getHeight())
+                                  .str());
+    }
+    finishImage<T>(_fits, _scale, _options.scaling);
+    if (_options.checksum) {
+        writeChecksums(_fits, _dataSumBitpix != 0 ? std::make_optional(_dataSum) : std::nullopt);
+    }
+    _restored = true;
+    _fits.setImageCompression(_previous);
+    if (_fits.behavior & Fits::AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(_fits, "Restoring compression settings");
+    }
+    _closed = true;
+}
+
 
 namespace {
 
@@ -1439,6 +2395,10 @@ struct NullValue<T, typename std::enable_if<std::numeric_limits<T>::has_quiet_Na
 
 template <typename T>
 void Fits::readImageImpl(int nAxis, T *data, long *begin, long *end, long *increment) {
+    LSST_AFW_INSTRUMENT_SCOPE("fits.readImage");
+    if (readCompressedImageConcurrently(nAxis, data, begin, end, increment)) {
+        return;
+    }
     T null = NullValue<T>::value;
     int anyNulls = 0;
     fits_read_subset(reinterpret_cast<fitsfile *>(fptr), FitsType<T>::CONSTANT, begin, end, increment,
@@ -1446,6 +2406,258 @@ void Fits::readImageImpl(int nAxis, T *data, long *begin, long *end, long *incre
     if (behavior & AUTO_CHECK) LSST_FITS_CHECK_STATUS(*this, "Reading image");
 }
 
+template <typename T>
+bool Fits::readCompressedImageConcurrently(int nAxis, T *data, long const *begin, long const *end,
+                                           long const *increment) {
+    int const nThreads =
+            fits_is_reentrant() ? afw::math::detail::resolveNumThreads(imageCompressionThreads) : 1;
+    fitsfile *fd = reinterpret_cast<fitsfile *>(fptr);
+    if (nThreads == 1 || nAxis < 1 || status != 0 || fd->Fptr->writemode != READONLY) {
+        return false;
+    }
+    if (!std::all_of(increment, increment + nAxis, [](long i) { return i == 1; })) {
+        return false;
+    }
+    // cfitsio handles are not thread-safe, so each thread opens the file itself; that requires a
+    // file on disk
+    std::string const fileName = getFileName();
+    if (!std::filesystem::is_regular_file(fileName)) {
+        return false;
+    }
+    int localStatus = 0;
+    if (!fits_is_compressed_image(fd, &localStatus) || localStatus != 0) {
+        return false;
+    }
+    std::vector<long> tileDims(nAxis);
+    fits_get_tile_dim(fd, nAxis, tileDims.data(), &localStatus);
+    if (localStatus != 0) {
+        return false;
+    }
+
+    // Split the requested pixels along the slowest axis, at tile boundaries so that no tile is
+    // decompressed by more than one thread (FITS pixel indices are 1-indexed and inclusive)
+    int const slow = nAxis - 1;
+    long const tile = tileDims[slow];
+    int const firstTile = (begin[slow] - 1) / tile;
+    int const lastTile = (end[slow] - 1) / tile;
+    if (lastTile == firstTile) {
+        return false;
+    }
+    long rowSize = 1;
+    for (int i = 0; i < slow; ++i) {
+        rowSize *= end[i] - begin[i] + 1;
+    }
+    int const hdu = getHdu();
+    auto const chunks = afw::math::detail::splitRange(firstTile, lastTile + 1, nThreads);
+    int const nChunks = chunks.size();
+    afw::math::detail::parallelFor(nChunks, nThreads, [&](int iChunk) {
+        std::vector<long> chunkBegin(begin, begin + nAxis);
+        std::vector<long> chunkEnd(end, end + nAxis);
+        std::vector<long> chunkIncrement(increment, increment + nAxis);
+        chunkBegin[slow] = std::max(begin[slow], chunks[iChunk].first * tile + 1);
+        chunkEnd[slow] = std::min(end[slow], chunks[iChunk].second * tile);
+        Fits reader(fileName, "r", AUTO_CLOSE | AUTO_CHECK);
+        reader.setHdu(hdu);
+        T null = NullValue<T>::value;
+        int anyNulls = 0;
+        fits_read_subset(reinterpret_cast<fitsfile *>(reader.fptr), FitsType<T>::CONSTANT,
+                         chunkBegin.data(), chunkEnd.data(), chunkIncrement.data(),
+                         reinterpret_cast<void *>(&null), data + (chunkBegin[slow] - begin[slow]) * rowSize,
+                         &anyNulls, &reader.status);
+        LSST_FITS_CHECK_STATUS(reader, "Reading image");
+    });
+    return true;
+}
+
+namespace {
+
+// A private mapping of part of a file into memory.  It inherits from ndarray::Manager, so arrays that
+// view it keep it alive; changes to the mapped pixels are never written back to the file.
+class MappedRegion : public ndarray::Manager {
+public:
+    MappedRegion(std::string const &fileName, off_t offset, std::size_t length)
+            : _address(MAP_FAILED), _length(length) {
+        int const fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            _address = ::mmap(nullptr, _length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, offset);
+            ::close(fd);
+        }
+        if (_address == MAP_FAILED) {
+            throw LSST_EXCEPT(FitsError, (boost::format("Could not map file '%s': %s") % fileName %
+                                          std::strerror(errno)).str());
+        }
+    }
+
+    ~MappedRegion() noexcept override { ::munmap(_address, _length); }
+
+    char *getAddress() const { return static_cast<char *>(_address); }
+
+private:
+    void *_address;
+    std::size_t _length;
+};
+
+// Return true if a FITS header starts at the given offset of a file.  The offsets cfitsio reports refer
+// to the FITS stream, which is only the file's contents if it is not (e.g. gzip-)compressed as a whole.
+bool startsHeader(std::string const &fileName, long long headStart) {
+    std::ifstream stream(fileName, std::ios::binary);
+    char card[8] = {};
+    stream.seekg(headStart);
+    stream.read(card, sizeof(card));
+    std::string const keyword(card, stream ? sizeof(card) : 0);
+    return keyword == "SIMPLE  " || keyword == "XTENSION";
+}
+
+// Convert pixels from FITS (big-endian) byte order to native order, in place
+template <typename T>
+void bigEndianToNative(T *data, std::size_t n) {
+    std::uint16_t const one = 1;
+    if (sizeof(T) == 1 || *reinterpret_cast<unsigned char const *>(&one) == 0) {
+        return;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        auto bytes = reinterpret_cast<unsigned char *>(data + i);
+        std::reverse(bytes, bytes + sizeof(T));
+    }
+}
+
+}  // namespace
+
+template <typename T>
+ndarray::Array<T, 2, 1> Fits::mapImage(ndarray::Vector<int, 2> const &shape,
+                                       ndarray::Vector<int, 2> const &offset) {
+    fitsfile *fd = reinterpret_cast<fitsfile *>(fptr);
+    std::string const fileName = getFileName();
+    auto fail = [this, &fileName](std::string const &why) {
+        return LSST_FITS_EXCEPT(FitsError, *this,
+                                boost::format("Cannot map HDU %d of '%s': %s") % getHdu() % fileName % why);
+    };
+    if (fd->Fptr->writemode != READONLY) {
+        throw fail("file is open for writing");
+    }
+    if (!std::filesystem::is_regular_file(fileName)) {
+        throw fail("not a file on disk");
+    }
+    if (fits_is_compressed_image(fd, &status)) {
+        throw fail("image is compressed");
+    }
+    int bitpix = 0;
+    fits_get_img_type(fd, &bitpix, &status);
+    int const nAxis = getImageDim();
+    long nAxes[3] = {1, 1, 1};
+    fits_get_img_size(fd, 3, nAxes, &status);
+    if (behavior & AUTO_CHECK) LSST_FITS_CHECK_STATUS(*this, "Getting image type and size");
+    if (bitpix != FitsBitPix<T>::CONSTANT) {
+        throw LSST_FITS_EXCEPT(FitsTypeError, *this,
+                               boost::format("Cannot map HDU %d of '%s': BITPIX %d is not the "
+                                             "in-memory pixel type") %
+                                       getHdu() % fileName % bitpix);
+    }
+    if (nAxis < 2 || nAxis > 3 || nAxes[2] != 1) {
+        throw fail("image is not two-dimensional");
+    }
+    for (auto const &key : {std::make_pair("BSCALE", 1.0), std::make_pair("BZERO", 0.0)}) {
+        int keyStatus = 0;
+        double value = key.second;
+        fits_read_key_dbl(fd, key.first, &value, nullptr, &keyStatus);
+        if ((keyStatus != 0 && keyStatus != KEY_NO_EXIST) || value != key.second) {
+            throw fail("image is scaled");
+        }
+    }
+    long const width = nAxes[0];
+    long const height = nAxes[1];
+    if (offset[0] < 0 || offset[1] < 0 || shape[0] < 0 || shape[1] < 0 || offset[0] + shape[0] > height ||
+        offset[1] + shape[1] > width) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("Region of shape (%d, %d) at (%d, %d) does not fit in image of "
+                                         "shape (%d, %d)") %
+                           shape[0] % shape[1] % offset[0] % offset[1] % height % width)
+                                  .str());
+    }
+    if (shape[0] == 0 || shape[1] == 0) {
+        return ndarray::allocate(shape[0], shape[1]);
+    }
+
+    LONGLONG headStart = 0, dataStart = 0, dataEnd = 0;
+    fits_get_hduaddrll(fd, &headStart, &dataStart, &dataEnd, &status);
+    if (behavior & AUTO_CHECK) LSST_FITS_CHECK_STATUS(*this, "Getting HDU address");
+    if (!startsHeader(fileName, headStart)) {
+        throw fail("file is not stored as plain FITS");
+    }
+
+    // Map only the rows that are needed, from the start of the page holding the first pixel
+    std::size_t const pixelSize = sizeof(T);
+    LONGLONG const first = dataStart + (static_cast<LONGLONG>(offset[0]) * width + offset[1]) * pixelSize;
+    LONGLONG const last =
+            dataStart + (static_cast<LONGLONG>(offset[0] + shape[0] - 1) * width + offset[1] + shape[1]) *
+                                pixelSize;
+    LONGLONG const pageSize = ::sysconf(_SC_PAGESIZE);
+    LONGLONG const mapStart = first - first % pageSize;
+    boost::intrusive_ptr<MappedRegion> region(new MappedRegion(fileName, mapStart, last - mapStart));
+
+    T *data = reinterpret_cast<T *>(region->getAddress() + (first - mapStart));
+    for (int y = 0; y < shape[0]; ++y) {
+        bigEndianToNative(data + y * width, shape[1]);
+    }
+    return ndarray::external(data, ndarray::makeVector(shape[0], shape[1]),
+                             ndarray::makeVector(static_cast<int>(width), 1), ndarray::Manager::Ptr(region));
+}
+
+ndarray::Array<unsigned char, 1, 1> Fits::mapTableBytes(std::size_t firstRow, std::size_t nRows) {
+    fitsfile *fd = reinterpret_cast<fitsfile *>(fptr);
+    std::string const fileName = getFileName();
+    auto fail = [this, &fileName](std::string const &why) {
+        return LSST_FITS_EXCEPT(FitsError, *this,
+                                boost::format("Cannot map HDU %d of '%s': %s") % getHdu() % fileName % why);
+    };
+    if (fd->Fptr->writemode != READONLY) {
+        throw fail("file is open for writing");
+    }
+    if (!std::filesystem::is_regular_file(fileName)) {
+        throw fail("not a file on disk");
+    }
+    int hduType = 0;
+    fits_get_hdu_type(fd, &hduType, &status);
+    if (behavior & AUTO_CHECK) LSST_FITS_CHECK_STATUS(*this, "Getting HDU type");
+    if (hduType != BINARY_TBL) {
+        throw fail("HDU is not a binary table");
+    }
+    LONGLONG rowWidth = 0;
+    fits_read_key(fd, TLONGLONG, const_cast<char *>("NAXIS1"), &rowWidth, nullptr, &status);
+    if (behavior & AUTO_CHECK) LSST_FITS_CHECK_STATUS(*this, "Reading NAXIS1");
+    std::size_t const nFileRows = countRows();
+    if (firstRow > nFileRows || nRows > nFileRows - firstRow) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("Rows [%d, %d) do not fit in table of %d rows") % firstRow %
+                           (firstRow + nRows) % nFileRows)
+                                  .str());
+    }
+    if (nRows == 0 || rowWidth == 0) {
+        return ndarray::allocate(nRows * rowWidth);
+    }
+
+    LONGLONG headStart = 0, dataStart = 0, dataEnd = 0;
+    fits_get_hduaddrll(fd, &headStart, &dataStart, &dataEnd, &status);
+    if (behavior & AUTO_CHECK) LSST_FITS_CHECK_STATUS(*this, "Getting HDU address");
+    if (!startsHeader(fileName, headStart)) {
+        throw fail("file is not stored as plain FITS");
+    }
+
+    // Map only the requested rows, from the start of the page holding the first of them
+    LONGLONG const first = dataStart + static_cast<LONGLONG>(firstRow) * rowWidth;
+    LONGLONG const length = static_cast<LONGLONG>(nRows) * rowWidth;
+    if (length > INT_MAX) {
+        throw fail("rows are too large to map at once");
+    }
+    LONGLONG const pageSize = ::sysconf(_SC_PAGESIZE);
+    LONGLONG const mapStart = first - first % pageSize;
+    boost::intrusive_ptr<MappedRegion> region(
+            new MappedRegion(fileName, mapStart, first + length - mapStart));
+    auto data = reinterpret_cast<unsigned char *>(region->getAddress() + (first - mapStart));
+    return ndarray::external(data, ndarray::makeVector(static_cast<int>(length)), ndarray::makeVector(1),
+                             ndarray::Manager::Ptr(region));
+}
+
 int Fits::getImageDim() {
     int nAxis = 0;
     fits_get_img_dim(reinterpret_cast<fitsfile *>(fptr), &nAxis, &status);
@@ -1574,6 +2786,47 @@ void setAllowImageCompression(bool allow) { allowImageCompression = allow; }
 
 bool getAllowImageCompression() { return allowImageCompression; }
 
+void setImageCompressionThreads(int numThreads) {
+    if (numThreads < 0) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "numThreads must be >= 0 (0 means one per hardware thread)");
+    }
+    imageCompressionThreads = numThreads;
+}
+
+int getImageCompressionThreads() { return imageCompressionThreads; }
+
+bool isCfitsioThreadSafe() { return fits_is_reentrant(); }
+
+void writeHdusConcurrently(Fits &fitsfile, std::vector<std::function<void(Fits &)>> const &writers) {
+    int const nWriters = writers.size();
+    int const nThreads =
+            fits_is_reentrant() ? afw::math::detail::resolveNumThreads(imageCompressionThreads) : 1;
+    if (nThreads == 1 || nWriters < 2) {
+        for (auto const &writer : writers) {
+            writer(fitsfile);
+        }
+        return;
+    }
+    // Each HDU is written to its own in-memory file; cfitsio lays out (and, for lossy compression,
+    // dithers) an HDU the same way whatever file it is in, so copying the HDUs reproduces the output
+    // of writing them directly.
+    std::vector<MemFileManager> managers(nWriters);
+    std::vector<std::unique_ptr<Fits>> scratch(nWriters);
+    afw::math::detail::parallelFor(nWriters, nThreads, [&](int i) {
+        scratch[i] = std::make_unique<Fits>(managers[i], "w", Fits::AUTO_CLOSE | Fits::AUTO_CHECK);
+        scratch[i]->createEmpty();
+        writers[i](*scratch[i]);
+    });
+    for (auto &file : scratch) {
+        int const nHdus = file->countHdus();
+        for (int hdu = 1; hdu < nHdus; ++hdu) {
+            file->setHdu(hdu);
+            fitsfile.copyHdu(*file);
+        }
+    }
+}
+
 // ---- Manipulating files ----------------------------------------------------------------------------------
 
 Fits::Fits(std::string const &filename, std::string const &mode, int behavior_)
@@ -1609,6 +2862,12 @@ Fits::Fits(std::string const &filename, std::string const &mode, int behavior_)
 Fits::Fits(MemFileManager &manager, std::string const &mode, int behavior_)
         : fptr(nullptr), status(0), behavior(behavior_) {
     using Reallocator = void *(*)(void *, std::size_t);
+    if (manager._readOnly && mode != "r" && mode != "rb") {
+        throw LSST_EXCEPT(FitsError,
+                          (boost::format("Cannot open read-only memory file at '%s' with mode '%s'") %
+                           manager._ptr % mode)
+                                  .str());
+    }
     // It's a shame this logic is essentially a duplicate of above, but the innards are different enough
     // we can't really reuse it.
     if (mode == "r" || mode == "rb") {
@@ -1617,13 +2876,18 @@ Fits::Fits(MemFileManager &manager, std::string const &mode, int behavior_)
                           &status);
     } else if (mode == "w" || mode == "wb") {
         Reallocator reallocator = nullptr;
-        if (manager._managed) reallocator = &std::realloc;
+        if (manager._managed) {
+            // cfitsio takes the length to be the size of the file, which is now empty; the memory
+            // already allocated is reused as the file grows
+            manager._len = 0;
+            reallocator = &reallocateBlock;
+        }
         fits_create_memfile(reinterpret_cast<fitsfile **>(&fptr), &manager._ptr, &manager._len, 0,
                             reallocator,  // use default deltasize
                             &status);
     } else if (mode == "a" || mode == "ab") {
         Reallocator reallocator = nullptr;
-        if (manager._managed) reallocator = &std::realloc;
+        if (manager._managed) reallocator = &reallocateBlock;
         fits_open_memfile(reinterpret_cast<fitsfile **>(&fptr), "unused", READWRITE, &manager._ptr,
                           &manager._len, 0, reallocator, &status);
         int nHdu = 0;
@@ -1808,7 +3072,8 @@ ImageWriteOptions::ImageWriteOptions(daf::base::PropertySet const &config)
                                                       : std::vector<std::string>{},
                   config.getAsInt("scaling.seed"), config.getAsDouble("scaling.quantizeLevel"),
                   config.getAsDouble("scaling.quantizePad"), config.get<bool>("scaling.fuzz"),
-                  config.getAsDouble("scaling.bscale"), config.getAsDouble("scaling.bzero")) {}
+                  config.getAsDouble("scaling.bscale"), config.getAsDouble("scaling.bzero")),
+          checksum(config.get<bool>("checksum", false)) {}
 
 namespace {
 
@@ -1844,6 +3109,8 @@ std::shared_ptr<daf::base::PropertySet> ImageWriteOptions::validate(daf::base::P
     validateEntry(*validated, config, "scaling.bscale", 1.0);
     validateEntry(*validated, config, "scaling.bzero", 0.0);
 
+    validateEntry(*validated, config, "checksum", false);
+
     // Check for additional entries that we don't support (e.g., from typos)
     for (auto const &name : config.names(false)) {
         if (!validated->exists(name)) {
@@ -1873,8 +3140,11 @@ std::shared_ptr<daf::base::PropertySet> ImageWriteOptions::validate(daf::base::P
                                    daf::base::PropertySet const *,          \
                                    image::Mask<image::MaskPixel> const *);  \
     template void Fits::readImageImpl(int, T *, long *, long *, long *);                   \
+    template ndarray::Array<T, 2, 1> Fits::mapImage(ndarray::Vector<int, 2> const &,       \
+                                                    ndarray::Vector<int, 2> const &);      \
     template bool Fits::checkImageType<T>();                                               \
-    template int getBitPix<T>();
+    template int getBitPix<T>();                                                           \
+    template class ImageStreamWriter<T>;
 
 #define INSTANTIATE_TABLE_OPS(r, data, T)                                \
     template int Fits::addColumn<T>(std::string const &ttype, int size); \
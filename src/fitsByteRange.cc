@@ -0,0 +1,332 @@
+// -*- lsst-c++ -*-
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "fitsio.h"
+extern "C" {
+#include "fitsio2.h"
+}
+
+#include "boost/format.hpp"
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/fits.h"
+#include "lsst/afw/fitsByteRange.h"
+
+namespace lsst {
+namespace afw {
+namespace fits {
+
+// ---- FileByteRangeSource ---------------------------------------------------------------------------------
+
+FileByteRangeSource::FileByteRangeSource(std::string const &fileName)
+        : _fileName(fileName), _fd(::open(fileName.c_str(), O_RDONLY)), _size(0) {
+    struct stat info;
+    if (_fd < 0 || ::fstat(_fd, &info) != 0) {
+        int const error = errno;
+        if (_fd >= 0) {
+            ::close(_fd);
+        }
+        throw LSST_EXCEPT(pex::exceptions::IoError,
+                          (boost::format("Cannot open '%s': %s") % fileName % std::strerror(error)).str());
+    }
+    _size = info.st_size;
+}
+
+FileByteRangeSource::~FileByteRangeSource() { ::close(_fd); }
+
+void FileByteRangeSource::read(std::size_t offset, std::size_t size, char *buffer) {
+    while (size > 0) {
+        ssize_t const n = ::pread(_fd, buffer, size, offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            throw LSST_EXCEPT(pex::exceptions::IoError,
+                              (boost::format("Cannot read %d bytes at %d of '%s': %s") % size % offset %
+                               _fileName % (n < 0 ? std::strerror(errno) : "unexpected end of file"))
+                                      .str());
+        }
+        buffer += n;
+        offset += n;
+        size -= n;
+    }
+}
+
+// ---- ByteRangeCache --------------------------------------------------------------------------------------
+
+ByteRangeCache::ByteRangeCache(std::shared_ptr<ByteRangeSource> source, std::size_t blockSize,
+                               std::size_t capacity, std::size_t readAhead)
+        : _source(std::move(source)),
+          _blockSize(blockSize),
+          _readAhead(readAhead),
+          _size(0),
+          _haveSize(false),
+          _requestCount(0),
+          _bytesFetched(0) {
+    if (!_source) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "No source given for a ByteRangeCache");
+    }
+    if (blockSize == 0 || capacity == 0) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          (boost::format("Block size (%d) and capacity (%d) must be positive") % blockSize %
+                           capacity)
+                                  .str());
+    }
+    _blocks = std::make_unique<cpputils::Cache<std::size_t, Block>>(capacity);
+}
+
+std::size_t ByteRangeCache::_getSize() {
+    if (!_haveSize) {
+        _size = _source->getSize();
+        _haveSize = true;
+    }
+    return _size;
+}
+
+std::size_t ByteRangeCache::getSize() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _getSize();
+}
+
+void ByteRangeCache::read(std::size_t offset, std::size_t size, char *buffer) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::size_t const fileSize = _getSize();
+    if (offset > fileSize || size > fileSize - offset) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("Cannot read %d bytes at %d of '%s', which has %d") % size % offset %
+                           _source->getName() % fileSize)
+                                  .str());
+    }
+    if (size == 0) {
+        return;
+    }
+    std::size_t const nBlocks = (fileSize + _blockSize - 1) / _blockSize;
+    std::size_t const first = offset / _blockSize;
+    std::size_t const last = (offset + size - 1) / _blockSize;
+    // Copy the part of a block that lies within the read.
+    auto copyBlock = [&](std::size_t i, std::vector<char> const &block) {
+        std::size_t const blockBegin = i * _blockSize;
+        std::size_t const begin = std::max(offset, blockBegin);
+        std::size_t const end = std::min(offset + size, blockBegin + block.size());
+        std::memcpy(buffer + (begin - offset), block.data() + (begin - blockBegin), end - begin);
+    };
+    for (std::size_t i = first; i <= last;) {
+        if (auto cached = _blocks->get(i)) {
+            copyBlock(i, **cached);
+            ++i;
+            continue;
+        }
+        // Fetch the run of missing blocks starting here, then read ahead while blocks are missing.
+        std::size_t const maxEnd = std::min(nBlocks, i + _blocks->capacity());
+        std::size_t end = i + 1;
+        while (end <= last && end < maxEnd && !_blocks->get(end)) {
+            ++end;
+        }
+        for (std::size_t ahead = 0; ahead < _readAhead && end > last && end < maxEnd && !_blocks->get(end);
+             ++ahead) {
+            ++end;
+        }
+        std::size_t const fetchBegin = i * _blockSize;
+        std::vector<char> data(std::min(end * _blockSize, fileSize) - fetchBegin);
+        _source->read(fetchBegin, data.size(), data.data());
+        ++_requestCount;
+        _bytesFetched += data.size();
+        for (std::size_t j = i; j < end; ++j) {
+            auto const blockBegin = data.begin() + (j - i) * _blockSize;
+            Block block = std::make_shared<std::vector<char> const>(
+                    blockBegin, blockBegin + std::min<std::size_t>(_blockSize, data.end() - blockBegin));
+            if (j <= last) {
+                copyBlock(j, *block);
+            }
+            (*_blocks)(j, [&block](std::size_t) { return block; });
+        }
+        i = end;
+    }
+}
+
+std::size_t ByteRangeCache::getRequestCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _requestCount;
+}
+
+std::size_t ByteRangeCache::getBytesFetched() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _bytesFetched;
+}
+
+// ---- cfitsio driver --------------------------------------------------------------------------------------
+
+namespace {
+
+// A cfitsio I/O driver for files read through a ByteRangeCache.
+//
+// cfitsio opens files by name, so Fits registers each cache under a unique name just long enough to
+// open it; the driver then keeps the cache (and the position of the next read) until the file is
+// closed.  Exceptions cannot pass through cfitsio, so they are turned into cfitsio error messages.
+
+char const *const DRIVER_PREFIX = "afwbyterange://";
+
+struct OpenFile {
+    std::shared_ptr<ByteRangeCache> cache;
+    LONGLONG position;
+};
+
+std::mutex registryMutex;
+std::map<std::string, std::shared_ptr<ByteRangeCache>> pendingFiles;  // by name, while being opened
+std::map<int, OpenFile> openFiles;                                    // by driver handle
+int nextName = 0;
+int nextHandle = 0;
+
+int reportError(std::exception const &err, int status) {
+    ffpmsg(const_cast<char *>(err.what()));
+    return status;
+}
+
+std::shared_ptr<ByteRangeCache> findFile(int handle, LONGLONG *position = nullptr) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto iter = openFiles.find(handle);
+    if (iter == openFiles.end()) {
+        return nullptr;
+    }
+    if (position) {
+        *position = iter->second.position;
+    }
+    return iter->second.cache;
+}
+
+int driverInit() { return 0; }
+int driverShutdown() { return 0; }
+int driverSetOptions(int) { return 0; }
+int driverGetOptions(int *options) {
+    *options = 0;
+    return 0;
+}
+int driverGetVersion(int *version) {
+    *version = 10;
+    return 0;
+}
+int driverCheckFile(char *, char *, char *) { return 0; }
+
+int driverOpen(char *fileName, int rwmode, int *handle) {
+    if (rwmode != READONLY) {
+        ffpmsg(const_cast<char *>("Files read through a ByteRangeCache are read-only"));
+        return FILE_NOT_OPENED;
+    }
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto iter = pendingFiles.find(fileName);
+    if (iter == pendingFiles.end()) {
+        return FILE_NOT_OPENED;
+    }
+    *handle = nextHandle++;
+    openFiles[*handle] = OpenFile{iter->second, 0};
+    return 0;
+}
+
+int driverCreate(char *, int *) { return FILE_NOT_CREATED; }
+int driverTruncate(int, LONGLONG) { return READONLY_FILE; }
+int driverRemove(char *) { return READONLY_FILE; }
+int driverFlush(int) { return 0; }
+int driverWrite(int, void *, long) { return READONLY_FILE; }
+
+int driverClose(int handle) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    openFiles.erase(handle);
+    return 0;
+}
+
+int driverSize(int handle, LONGLONG *size) {
+    auto cache = findFile(handle);
+    if (!cache) {
+        return BAD_FILEPTR;
+    }
+    try {
+        *size = cache->getSize();
+    } catch (std::exception const &err) {
+        return reportError(err, READ_ERROR);
+    }
+    return 0;
+}
+
+int driverSeek(int handle, LONGLONG offset) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto iter = openFiles.find(handle);
+    if (iter == openFiles.end()) {
+        return BAD_FILEPTR;
+    }
+    iter->second.position = offset;
+    return 0;
+}
+
+int driverRead(int handle, void *buffer, long nBytes) {
+    LONGLONG position = 0;
+    auto cache = findFile(handle, &position);
+    if (!cache) {
+        return BAD_FILEPTR;
+    }
+    try {
+        if (position < 0 || static_cast<std::size_t>(position) + nBytes > cache->getSize()) {
+            return END_OF_FILE;
+        }
+        cache->read(position, nBytes, static_cast<char *>(buffer));
+    } catch (std::exception const &err) {
+        return reportError(err, READ_ERROR);
+    }
+    std::lock_guard<std::mutex> lock(registryMutex);
+    openFiles[handle].position = position + nBytes;
+    return 0;
+}
+
+void registerDriver() {
+    static std::once_flag registered;
+    std::call_once(registered, []() {
+        int const status = fits_register_driver(
+                const_cast<char *>(DRIVER_PREFIX), &driverInit, &driverShutdown, &driverSetOptions,
+                &driverGetOptions, &driverGetVersion, &driverCheckFile, &driverOpen, &driverCreate,
+                &driverTruncate, &driverClose, &driverRemove, &driverSize, &driverFlush, &driverSeek,
+                &driverRead, &driverWrite);
+        if (status != 0) {
+            throw LSST_EXCEPT(FitsError, makeErrorMessage("", status, "Registering the byte-range driver"));
+        }
+    });
+}
+
+}  // namespace
+
+Fits::Fits(std::shared_ptr<ByteRangeCache> cache, int behavior_)
+        : fptr(nullptr), status(0), behavior(behavior_) {
+    if (!cache) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "No ByteRangeCache given");
+    }
+    registerDriver();
+    std::string name;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        name = std::to_string(nextName++);
+        pendingFiles[name] = cache;
+    }
+    std::string const url = DRIVER_PREFIX + name;
+    fits_open_file(reinterpret_cast<fitsfile **>(&fptr), const_cast<char *>(url.c_str()), READONLY,
+                   &status);
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        pendingFiles.erase(name);
+    }
+    if (behavior & AUTO_CHECK) {
+        LSST_FITS_CHECK_STATUS(*this, boost::format("Opening '%s' through a byte-range cache") %
+                                              cache->getSource()->getName());
+    }
+}
+
+}  // namespace fits
+}  // namespace afw
+}  // namespace lsst
@@ -5,9 +5,14 @@ extern "C" {
 #include "fitsio2.h"
 }
 
+#include <algorithm>
+#include <numeric>
+
 #include "lsst/pex/exceptions.h"
 
+#include "lsst/afw/fits.h"
 #include "lsst/afw/fitsCompression.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 extern float* fits_rand_value;     // Random numbers, defined in cfitsio
 int const N_RESERVED_VALUES = 10;  // Number of reserved values for float --> bitpix=32 conversions (cfitsio)
@@ -143,24 +148,54 @@ ImageScalingOptions::ImageScalingOptions(ScalingAlgorithm algorithm_, int bitpix
 
 namespace {
 
+/// Smallest number of pixels worth giving to a thread of its own when scaling
+std::size_t const MIN_PIXELS_PER_THREAD = 1 << 16;
+
+/// Split [0, num) items of `pixelsPerItem` pixels into contiguous pieces to be scaled concurrently
+///
+/// There is at most one piece per thread allowed by getImageCompressionThreads().
+std::vector<std::pair<std::size_t, std::size_t>> splitPixels(std::size_t num, std::size_t pixelsPerItem = 1) {
+    std::size_t const nThreads = math::detail::resolveNumThreads(getImageCompressionThreads());
+    std::size_t const nParts = std::max<std::size_t>(
+            1, std::min({nThreads, num, num * pixelsPerItem / MIN_PIXELS_PER_THREAD}));
+    std::vector<std::pair<std::size_t, std::size_t>> parts;
+    parts.reserve(nParts);
+    for (std::size_t i = 0; i < nParts; ++i) {
+        parts.emplace_back(num * i / nParts, num * (i + 1) / nParts);
+    }
+    return parts;
+}
+
+/// Call func(iPart) for each piece of splitPixels, concurrently
+template <typename Func>
+void forEachPart(std::vector<std::pair<std::size_t, std::size_t>> const& parts, Func func) {
+    int const nParts = parts.size();
+    math::detail::parallelFor(nParts, nParts, func);
+}
+
 /// Calculate median and standard deviation for an image
 template <typename T, int N>
 std::pair<T, T> calculateMedianStdev(ndarray::Array<T const, N, N> const& image,
                                      ndarray::Array<bool, N, N> const& mask) {
-    std::size_t num = 0;
-    auto const& flatMask = ndarray::flatten<1>(mask);
-    for (auto mm = flatMask.begin(); mm != flatMask.end(); ++mm) {
-        if (!*mm) ++num;
-    }
+    // Gather the unmasked pixels, in order, with each thread copying its own part of the image
+    T const* const imageData = image.getData();
+    bool const* const maskData = mask.getData();
+    auto const parts = splitPixels(image.getNumElements());
+    std::vector<std::size_t> offsets(parts.size() + 1, 0);
+    forEachPart(parts, [&](int iPart) {
+        offsets[iPart + 1] = std::count(maskData + parts[iPart].first, maskData + parts[iPart].second, false);
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::size_t const num = offsets.back();
     ndarray::Array<T, 1, 1> array = ndarray::allocate(num);
-    auto const& flatImage = ndarray::flatten<1>(image);
-    auto mm = ndarray::flatten<1>(mask).begin();
-    auto aa = array.begin();
-    for (auto ii = flatImage.begin(); ii != flatImage.end(); ++ii, ++mm) {
-        if (*mm) continue;
-        *aa = *ii;
-        ++aa;
-    }
+    forEachPart(parts, [&](int iPart) {
+        T* aa = array.getData() + offsets[iPart];
+        for (std::size_t ii = parts[iPart].first; ii < parts[iPart].second; ++ii) {
+            if (maskData[ii]) continue;
+            *aa = imageData[ii];
+            ++aa;
+        }
+    });
 
     // Quartiles; from https://stackoverflow.com/a/11965377/834250
     auto const q1 = num / 4;
@@ -182,14 +217,25 @@ std::pair<T, T> calculateMedianStdev(ndarray::Array<T const, N, N> const& image,
 template <typename T, int N>
 std::pair<T, T> calculateMinMax(ndarray::Array<T const, N, N> const& image,
                                 ndarray::Array<bool, N, N> const& mask) {
+    T const* const imageData = image.getData();
+    bool const* const maskData = mask.getData();
+    auto const parts = splitPixels(image.getNumElements());
+    std::vector<std::pair<T, T>> partMinMax(parts.size());
+    forEachPart(parts, [&](int iPart) {
+        T min = std::numeric_limits<T>::max(), max = std::numeric_limits<T>::min();
+        for (std::size_t ii = parts[iPart].first; ii < parts[iPart].second; ++ii) {
+            if (maskData[ii]) continue;
+            T const value = imageData[ii];
+            if (!std::isfinite(value)) continue;
+            if (value > max) max = value;
+            if (value < min) min = value;
+        }
+        partMinMax[iPart] = std::make_pair(min, max);
+    });
     T min = std::numeric_limits<T>::max(), max = std::numeric_limits<T>::min();
-    auto mm = ndarray::flatten<1>(mask).begin();
-    auto const& flatImage = ndarray::flatten<1>(image);
-    for (auto ii = flatImage.begin(); ii != flatImage.end(); ++ii, ++mm) {
-        if (*mm) continue;
-        if (!std::isfinite(*ii)) continue;
-        if (*ii > max) max = *ii;
-        if (*ii < min) min = *ii;
+    for (auto const& minMax : partMinMax) {
+        if (minMax.second > max) max = minMax.second;
+        if (minMax.first < min) min = minMax.first;
     }
     return std::make_pair(min, max);
 }
@@ -366,43 +412,32 @@ public:
     void increment() {
         ++_index;
         if (_index == N_RANDOM) {
-            ++_start;
-            if (_start == N_RANDOM) {
-                _start = 0;
-            }
-            reseed();
+            nextRun();
         }
     }
 
-    /// Generate a flattened image of random numbers
-    template <typename T>
-    ndarray::Array<T, 1, 1> forImage(typename ndarray::Array<T const, 2, 2>::Index const& shape,
-                                     ndarray::Array<long, 1> const& tiles) {
-        std::size_t const xSize = shape[1], ySize = shape[0];
-        ndarray::Array<T, 1, 1> out = ndarray::allocate(xSize * ySize);
-        std::size_t const xTileSize = tiles[0] <= 0 ? xSize : tiles[0];
-        std::size_t const yTileSize = tiles[1] < 0 ? ySize : (tiles[1] == 0 ? 1 : tiles[1]);
-        int const xNumTiles = std::ceil(xSize / static_cast<float>(xTileSize));
-        int const yNumTiles = std::ceil(ySize / static_cast<float>(yTileSize));
-        for (int iTile = 0, yTile = 0; yTile < yNumTiles; ++yTile) {
-            int const yStart = yTile * yTileSize;
-            int const yStop = std::min(yStart + yTileSize, ySize);
-            for (int xTile = 0; xTile < xNumTiles; ++xTile, ++iTile) {
-                int const xStart = xTile * xTileSize;
-                int const xStop = std::min(xStart + xTileSize, xSize);
-                resetForTile(iTile);
-                for (int y = yStart; y < yStop; ++y) {
-                    auto iter = out.begin() + y * xSize + xStart;
-                    for (int x = xStart; x < xStop; ++x, ++iter) {
-                        *iter = static_cast<T>(getNext());
-                    }
-                }
+    /// Skip the next n values, as if getNext had been called n times
+    void skip(std::size_t n) {
+        while (n > 0) {
+            std::size_t const step = std::min<std::size_t>(n, N_RANDOM - _index);
+            _index += step;
+            n -= step;
+            if (_index == N_RANDOM) {
+                nextRun();
             }
         }
-        return out;
     }
 
 private:
+    /// Move on to the next run of indices, once the current one is exhausted
+    void nextRun() {
+        ++_start;
+        if (_start == N_RANDOM) {
+            _start = 0;
+        }
+        reseed();
+    }
+
     /// Start the run of indices over with the new seed value
     void reseed() { _index = static_cast<int>(fits_rand_value[_start] * 500); }
 
@@ -437,11 +472,14 @@ std::shared_ptr<detail::PixelArrayBase> ImageScale::toFits(ndarray::Array<T cons
         }
         if (!std::numeric_limits<T>::is_integer) {
             ndarray::Array<T, 1, 1> out = ndarray::allocate(image.getNumElements());
-            auto outIter = out.begin();
-            auto const& flatImage = ndarray::flatten<1>(image);
-            for (auto inIter = flatImage.begin(); inIter != flatImage.end(); ++inIter, ++outIter) {
-                *outIter = std::isfinite(*inIter) ? *inIter : std::numeric_limits<T>::max();
-            }
+            T const* const inData = image.getData();
+            T* const outData = out.getData();
+            auto const parts = splitPixels(image.getNumElements());
+            forEachPart(parts, [&](int iPart) {
+                for (std::size_t ii = parts[iPart].first; ii < parts[iPart].second; ++ii) {
+                    outData[ii] = std::isfinite(inData[ii]) ? inData[ii] : std::numeric_limits<T>::max();
+                }
+            });
             return detail::makePixelArray(bitpix, out);
         }
         // Fall through for explicit scaling
@@ -459,34 +497,70 @@ std::shared_ptr<detail::PixelArrayBase> ImageScale::toFits(ndarray::Array<T cons
     double const scale = 1.0 / bscale;
     std::size_t const num = image.getNumElements();
     bool const applyFuzz = fuzz && !std::numeric_limits<T>::is_integer && bitpix > 0;
-    ndarray::Array<double, 1, 1> out;
-    if (applyFuzz) {
-        if (tiles.isEmpty()) {
-            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
-                              "Tile sizes must be provided if fuzzing is desired");
-        }
-        out = CfitsioRandom(seed).forImage<double>(image.getShape(), tiles);
-    } else {
-        out = ndarray::allocate(num);
-        out.deep() = 0;
+    if (applyFuzz && tiles.isEmpty()) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "Tile sizes must be provided if fuzzing is desired");
     }
-    auto outIter = out.begin();
-    auto const& flatImage = ndarray::flatten<1>(image);
-    for (auto inIter = flatImage.begin(); inIter != flatImage.end(); ++inIter, ++outIter) {
-        double value = (*inIter - bzero) * scale;
-        if (!std::isfinite(value)) {
-            // This choice of "max" for non-finite and overflow pixels is mainly cosmetic --- it has to be
-            // something, and "min" would produce holes in the cores of bright stars.
-            *outIter = blank;
-            continue;
-        }
-        if (applyFuzz) {
-            // Add random factor [0.0,1.0): adds a variance of 1/12,
-            // but preserves the expectation value given the floor()
-            value += *outIter;
+    // Scale n pixels, adding the corresponding values of `random` if non-null
+    auto const quantize = [this, scale, min, max](T const* in, double* out, std::size_t n,
+                                                  float const* random) {
+        for (std::size_t ii = 0; ii < n; ++ii) {
+            double value = (in[ii] - bzero) * scale;
+            if (!std::isfinite(value)) {
+                // This choice of "max" for non-finite and overflow pixels is mainly cosmetic --- it has to
+                // be something, and "min" would produce holes in the cores of bright stars.
+                out[ii] = blank;
+                continue;
+            }
+            if (random) {
+                // Add random factor [0.0,1.0): adds a variance of 1/12,
+                // but preserves the expectation value given the floor()
+                value += static_cast<double>(random[ii]);
+            }
+            out[ii] = (value < min ? blank : (value > max ? blank : std::floor(value)));
         }
-        *outIter = (value < min ? blank : (value > max ? blank : std::floor(value)));
+    };
+
+    ndarray::Array<double, 1, 1> out = ndarray::allocate(num);
+    T const* const inData = image.getData();
+    double* const outData = out.getData();
+    if (!applyFuzz || num == 0) {
+        auto const parts = splitPixels(num);
+        forEachPart(parts, [&](int iPart) {
+            quantize(inData + parts[iPart].first, outData + parts[iPart].first,
+                     parts[iPart].second - parts[iPart].first, nullptr);
+        });
+        return detail::makePixelArray(bitpix, out);
     }
+
+    // The fuzz is the sequence of random numbers cfitsio would use, restarted for each tile (numbered in
+    // row-major order) and running along the tile's rows.  Each thread handles a contiguous range of image
+    // rows, picking up the sequence of every tile it crosses partway through.
+    std::size_t const xSize = image.getShape()[1], ySize = image.getShape()[0];
+    std::size_t const xTileSize = tiles[0] <= 0 ? xSize : tiles[0];
+    std::size_t const yTileSize = tiles[1] < 0 ? ySize : (tiles[1] == 0 ? 1 : tiles[1]);
+    std::size_t const xNumTiles = (xSize + xTileSize - 1) / xTileSize;
+    CfitsioRandom const initial(seed);
+    auto const parts = splitPixels(ySize, xSize);
+    forEachPart(parts, [&](int iPart) {
+        std::vector<CfitsioRandom> random(xNumTiles, initial);  // the state of each tile in this row
+        std::vector<float> fuzzValues(std::min(xTileSize, xSize));
+        for (std::size_t y = parts[iPart].first; y < parts[iPart].second; ++y) {
+            bool const restart = (y == parts[iPart].first || y % yTileSize == 0);
+            for (std::size_t xTile = 0; xTile < xNumTiles; ++xTile) {
+                std::size_t const xStart = xTile * xTileSize;
+                std::size_t const width = std::min(xStart + xTileSize, xSize) - xStart;
+                if (restart) {
+                    random[xTile].resetForTile((y / yTileSize) * xNumTiles + xTile);
+                    random[xTile].skip((y % yTileSize) * width);
+                }
+                for (std::size_t x = 0; x < width; ++x) {
+                    fuzzValues[x] = random[xTile].getNext();
+                }
+                quantize(inData + y * xSize + xStart, outData + y * xSize + xStart, width, fuzzValues.data());
+            }
+        }
+    });
     return detail::makePixelArray(bitpix, out);
 }
 
@@ -0,0 +1,210 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/geom/PackedSpanSet.h"
+#include "lsst/afw/geom/SpanSet.h"
+
+namespace lsst {
+namespace afw {
+namespace geom {
+
+namespace {
+
+/*
+ * Values are written in 15-bit groups, least significant first, one group per 16-bit unit; the top
+ * bit of a unit is set when another group follows.  Signed values are zigzag-encoded first, so that
+ * small magnitudes of either sign stay small.
+ */
+
+void appendUnsigned(std::uint64_t value, std::vector<std::uint16_t> &units) {
+    while (value >= 0x8000) {
+        units.push_back(static_cast<std::uint16_t>((value & 0x7fff) | 0x8000));
+        value >>= 15;
+    }
+    units.push_back(static_cast<std::uint16_t>(value));
+}
+
+void appendSigned(std::int64_t value, std::vector<std::uint16_t> &units) {
+    appendUnsigned((static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63),
+                   units);
+}
+
+std::uint64_t readUnsigned(std::uint16_t const *&data) noexcept {
+    std::uint64_t value = 0;
+    int shift = 0;
+    std::uint16_t unit;
+    do {
+        unit = *data++;
+        value |= static_cast<std::uint64_t>(unit & 0x7fff) << shift;
+        shift += 15;
+    } while (unit & 0x8000);
+    return value;
+}
+
+std::int64_t readSigned(std::uint16_t const *&data) noexcept {
+    std::uint64_t const value = readUnsigned(data);
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+}  // namespace
+
+PackedSpanSet::const_iterator::const_iterator(std::uint16_t const *data, std::uint16_t const *end, int minX,
+                                              int y) noexcept
+        : _next(data), _end(end), _minX(minX), _span(y, 0, -1) {
+    _decode();
+}
+
+void PackedSpanSet::const_iterator::_decode() noexcept {
+    if (_next == _end) {
+        _next = nullptr;
+        return;
+    }
+    int const y = static_cast<int>(_span.getY() + readSigned(_next));
+    int const x0 = static_cast<int>(_minX + static_cast<std::int64_t>(readUnsigned(_next)));
+    int const x1 = static_cast<int>(x0 + readSigned(_next));
+    _span = Span(y, x0, x1);
+}
+
+PackedSpanSet::PackedSpanSet() noexcept : _bbox(), _minX(0), _minY(0), _area(0), _nSpans(0), _nUnits(0) {}
+
+PackedSpanSet::PackedSpanSet(SpanSet const &spanSet)
+        : _bbox(spanSet.getBBox()), _minX(0), _minY(0), _area(spanSet.getArea()), _nSpans(0), _nUnits(0) {
+    if (spanSet.size() > std::numeric_limits<std::uint32_t>::max() / 9) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError, "SpanSet has too many Spans to pack");
+    }
+    if (spanSet.size() == 0) {
+        return;
+    }
+    // Unnormalized SpanSets need not be sorted, so find the origin of the offsets directly
+    _minX = std::numeric_limits<int>::max();
+    _minY = std::numeric_limits<int>::max();
+    for (auto const &span : spanSet) {
+        _minX = std::min(_minX, span.getX0());
+        _minY = std::min(_minY, span.getY());
+    }
+    std::vector<std::uint16_t> units;
+    units.reserve(3 * spanSet.size());
+    std::int64_t y = _minY;
+    for (auto const &span : spanSet) {
+        appendSigned(span.getY() - y, units);
+        appendUnsigned(static_cast<std::int64_t>(span.getX0()) - _minX, units);
+        appendSigned(static_cast<std::int64_t>(span.getX1()) - span.getX0(), units);
+        y = span.getY();
+    }
+    _nSpans = static_cast<std::uint32_t>(spanSet.size());
+    _nUnits = static_cast<std::uint32_t>(units.size());
+    if (_isInline()) {
+        std::copy(units.begin(), units.end(), _inline);
+    } else {
+        _heap = new std::uint16_t[_nUnits];
+        std::copy(units.begin(), units.end(), _heap);
+    }
+}
+
+PackedSpanSet::PackedSpanSet(PackedSpanSet const &other)
+        : _bbox(other._bbox),
+          _minX(other._minX),
+          _minY(other._minY),
+          _area(other._area),
+          _nSpans(other._nSpans),
+          _nUnits(other._nUnits) {
+    if (_isInline()) {
+        std::copy(other._inline, other._inline + _nUnits, _inline);
+    } else {
+        _heap = new std::uint16_t[_nUnits];
+        std::copy(other._heap, other._heap + _nUnits, _heap);
+    }
+}
+
+PackedSpanSet::PackedSpanSet(PackedSpanSet &&other) noexcept : PackedSpanSet() { swap(other); }
+
+PackedSpanSet &PackedSpanSet::operator=(PackedSpanSet const &other) {
+    PackedSpanSet copy(other);
+    swap(copy);
+    return *this;
+}
+
+PackedSpanSet &PackedSpanSet::operator=(PackedSpanSet &&other) noexcept {
+    PackedSpanSet moved(std::move(other));
+    swap(moved);
+    return *this;
+}
+
+void PackedSpanSet::swap(PackedSpanSet &other) noexcept {
+    using std::swap;
+    swap(_bbox, other._bbox);
+    swap(_minX, other._minX);
+    swap(_minY, other._minY);
+    swap(_area, other._area);
+    swap(_nSpans, other._nSpans);
+    swap(_nUnits, other._nUnits);
+    // Swapping the bytes of the union swaps whichever of the inline units or heap pointer is in use
+    unsigned char storage[sizeof(_inline)];
+    std::memcpy(storage, _inline, sizeof(_inline));
+    std::memcpy(_inline, other._inline, sizeof(_inline));
+    std::memcpy(other._inline, storage, sizeof(_inline));
+}
+
+PackedSpanSet::~PackedSpanSet() noexcept {
+    if (!_isInline()) {
+        delete[] _heap;
+    }
+}
+
+PackedSpanSet::const_iterator PackedSpanSet::begin() const noexcept {
+    if (empty()) {
+        return end();
+    }
+    std::uint16_t const *data = _data();
+    return const_iterator(data, data + _nUnits, _minX, _minY);
+}
+
+std::size_t PackedSpanSet::getMemorySize() const noexcept {
+    return sizeof(PackedSpanSet) + (_isInline() ? 0 : _nUnits * sizeof(std::uint16_t));
+}
+
+std::shared_ptr<SpanSet> PackedSpanSet::toSpanSet() const {
+    std::vector<Span> spans(begin(), end());
+    return std::make_shared<SpanSet>(std::move(spans), false);
+}
+
+bool PackedSpanSet::operator==(PackedSpanSet const &other) const noexcept {
+    // The encoding is a function of the Spans alone, so equal Spans give equal units
+    if (_nSpans != other._nSpans || _nUnits != other._nUnits || _minX != other._minX ||
+        _minY != other._minY) {
+        return false;
+    }
+    std::uint16_t const *data = _data();
+    return std::equal(data, data + _nUnits, other._data());
+}
+
+}  // namespace geom
+}  // namespace afw
+}  // namespace lsst
@@ -21,10 +21,13 @@
  */
 
 #include <algorithm>
+#include <optional>
 #include <vector>
 
 #include "Eigen/QR"
+#include "Eigen/SVD"
 #include "lsst/afw/geom/SipApproximation.h"
+#include "lsst/afw/math/detail/Parallel.h"
 #include "lsst/geom/polynomials/PolynomialFunction2d.h"
 
 namespace lsst { namespace afw { namespace geom {
@@ -33,40 +36,6 @@ namespace poly = lsst::geom::polynomials;
 
 namespace {
 
-std::pair<poly::PolynomialFunction2dYX, poly::PolynomialFunction2dYX> fitSipOneDirection(
-    int order,
-    lsst::geom::Box2D const & box,
-    double svdThreshold,
-    std::vector<lsst::geom::Point2D> const & input,
-    std::vector<lsst::geom::Point2D> const & output
-) {
-    // The scaled polynomial basis evaluates polynomials after mapping the
-    // input coordinates from the given box to [-1, 1]x[-1, 1] (for numerical
-    // stability).
-    auto basis = poly::ScaledPolynomialBasis2dYX(order, box);
-    auto workspace = basis.makeWorkspace();
-    Eigen::MatrixXd matrix = Eigen::MatrixXd::Zero(input.size(), basis.size());
-    Eigen::VectorXd xRhs(input.size());
-    Eigen::VectorXd yRhs(input.size());
-    for (int i = 0; i < matrix.rows(); ++i) {
-        basis.fill(input[i], matrix.row(i), workspace);
-        auto rhs = output[i] - input[i];
-        xRhs[i] = rhs.getX();
-        yRhs[i] = rhs.getY();
-    }
-    // Since we're not trying to null the zeroth- and first-order terms, the
-    // solution is just linear least squares, and we can do that with SVD.
-    auto decomp = matrix.jacobiSvd(Eigen::ComputeThinU | Eigen::ComputeThinV);
-    if (svdThreshold >= 0) {
-        decomp.setThreshold(svdThreshold);
-    }
-    auto scaledX = makeFunction2d(basis, decomp.solve(xRhs));
-    auto scaledY = makeFunction2d(basis, decomp.solve(yRhs));
-    // On return, we simplify the polynomials by moving the remapping transform
-    // into the coefficients themselves.
-    return std::make_pair(simplified(scaledX), simplified(scaledY));
-}
-
 // Return a vector of points on a grid, covering the given bounding box.
 std::vector<lsst::geom::Point2D> makeGrid(lsst::geom::Box2D const & bbox,
                                           lsst::geom::Extent2I const & shape) {
@@ -107,6 +76,28 @@ poly::PolynomialFunction2dYX makePolynomialFromCoeffMatrix(ndarray::Array<double
 // we evaluate the exact transform.
 struct SipApproximation::Grid {
 
+    // Linear least-squares problem for the polynomials of one direction.  The basis matrix is kept
+    // for the highest order evaluated so far: packed bases of lower order are its leading columns,
+    // so refitting at the same or a lower order does not evaluate the basis again.
+    struct Direction {
+
+        using FunctionPair = std::pair<poly::PolynomialFunction2dYX, poly::PolynomialFunction2dYX>;
+
+        // Evaluate the basis at the input points, unless it has already been evaluated at this
+        // order or a higher one.
+        void fill(int order_, std::vector<lsst::geom::Point2D> const & input,
+                  std::vector<lsst::geom::Point2D> const & output);
+
+        // Solve for the polynomials of the given order, which must be no larger than order.
+        FunctionPair fit(int order_, double svdThreshold) const;
+
+        lsst::geom::Box2D box;  //  input box; the scaled basis maps it to [-1, 1]x[-1, 1]
+        int order = -1;         //  order of the basis evaluated in matrix, or -1 if none
+        Eigen::MatrixXd matrix;
+        Eigen::VectorXd xRhs;
+        Eigen::VectorXd yRhs;
+    };
+
     // Set up the grid.
     Grid(lsst::geom::Extent2I const & shape_, SipApproximation const & parent);
 
@@ -114,6 +105,8 @@ struct SipApproximation::Grid {
     std::vector<lsst::geom::Point2D> dpix1; //  [pixel coords] - CRPIX
     std::vector<lsst::geom::Point2D> siwc;  //  CD^{-1}([intermediate world coords])
     std::vector<lsst::geom::Point2D> dpix2; //  round-tripped version of dpix1 if useInverse, or exactly dpix1
+    mutable Direction forward;  //  fit from dpix1 to siwc
+    mutable Direction inverse;  //  fit from siwc to dpix2
 };
 
 // Private implementation object for SipApproximation that manages the solution
@@ -121,6 +114,10 @@ struct SipApproximation::Solution {
 
     static std::unique_ptr<Solution> fit(int order_, double svdThreshold, SipApproximation const & parent);
 
+    // Fit as above, but with the grid's basis matrices evaluated at no less than fillOrder.
+    static std::unique_ptr<Solution> fit(int order_, int fillOrder, double svdThreshold,
+                                         SipApproximation const & parent);
+
     Solution(poly::PolynomialFunction2dYX const & a_,
              poly::PolynomialFunction2dYX const & b_,
              poly::PolynomialFunction2dYX const & ap_,
@@ -150,16 +147,62 @@ struct SipApproximation::Solution {
         return siwc + lsst::geom::Extent2D(ap(siwc, ws), bp(siwc, ws));
     }
 
+    std::pair<double, double> computeMaxDeviation(Grid const & grid) const;
+
     poly::PolynomialFunction2dYX a;
     poly::PolynomialFunction2dYX b;
     poly::PolynomialFunction2dYX ap;
     poly::PolynomialFunction2dYX bp;
 };
 
+void SipApproximation::Grid::Direction::fill(int order_, std::vector<lsst::geom::Point2D> const & input,
+                                              std::vector<lsst::geom::Point2D> const & output) {
+    if (order_ <= order) {
+        return;
+    }
+    // The scaled polynomial basis evaluates polynomials after mapping the
+    // input coordinates from the given box to [-1, 1]x[-1, 1] (for numerical
+    // stability).
+    auto basis = poly::ScaledPolynomialBasis2dYX(order_, box);
+    auto workspace = basis.makeWorkspace();
+    Eigen::MatrixXd newMatrix = Eigen::MatrixXd::Zero(input.size(), basis.size());
+    Eigen::VectorXd newXRhs(input.size());
+    Eigen::VectorXd newYRhs(input.size());
+    for (int i = 0; i < newMatrix.rows(); ++i) {
+        basis.fill(input[i], newMatrix.row(i), workspace);
+        auto rhs = output[i] - input[i];
+        newXRhs[i] = rhs.getX();
+        newYRhs[i] = rhs.getY();
+    }
+    matrix.swap(newMatrix);
+    xRhs.swap(newXRhs);
+    yRhs.swap(newYRhs);
+    order = order_;
+}
+
+SipApproximation::Grid::Direction::FunctionPair SipApproximation::Grid::Direction::fit(
+    int order_,
+    double svdThreshold
+) const {
+    auto basis = poly::ScaledPolynomialBasis2dYX(order_, box);
+    // Since we're not trying to null the zeroth- and first-order terms, the
+    // solution is just linear least squares, and we can do that with SVD.
+    Eigen::JacobiSVD<Eigen::MatrixXd> decomp(matrix.leftCols(basis.size()),
+                                             Eigen::ComputeThinU | Eigen::ComputeThinV);
+    if (svdThreshold >= 0) {
+        decomp.setThreshold(svdThreshold);
+    }
+    auto scaledX = makeFunction2d(basis, decomp.solve(xRhs));
+    auto scaledY = makeFunction2d(basis, decomp.solve(yRhs));
+    // On return, we simplify the polynomials by moving the remapping transform
+    // into the coefficients themselves.
+    return std::make_pair(simplified(scaledX), simplified(scaledY));
+}
+
 SipApproximation::Grid::Grid(lsst::geom::Extent2I const & shape_, SipApproximation const & parent) :
     shape(shape_),
     dpix1(makeGrid(parent._bbox, shape)),
-    siwc(parent._pixelToIwc->applyForward(dpix1))
+    siwc(parent._pixelToIwc->applyForward(dpix1, parent._numThreads))
 {
     // Apply the CRPIX offset to make pix1 into dpix1 (in-place)
     std::for_each(dpix1.begin(), dpix1.end(), [&parent](lsst::geom::Point2D & p){ p -= parent._crpix; });
@@ -167,7 +210,7 @@ SipApproximation::Grid::Grid(lsst::geom::Extent2I const & shape_, SipApproximati
     if (parent._useInverse) {
         // Set from the given inverse of the given pixels-to-iwc transform
         // Note that at this point, siwc is still just iwc, because the scaling by cdInv is later.
-        dpix2 = parent._pixelToIwc->applyInverse(siwc);
+        dpix2 = parent._pixelToIwc->applyInverse(siwc, parent._numThreads);
         // Apply the CRPIX offset to make pix1 into dpix2 (in-place)
         std::for_each(dpix2.begin(), dpix2.end(), [&parent](lsst::geom::Point2D & p){ p -= parent._crpix; });
     } else {
@@ -177,33 +220,64 @@ SipApproximation::Grid::Grid(lsst::geom::Extent2I const & shape_, SipApproximati
 
     // Apply the CD^{-1} transform to siwc
     std::for_each(siwc.begin(), siwc.end(), [&parent](lsst::geom::Point2D & p){ p = parent._cdInv(p); });
+
+    forward.box = parent._bbox;
+    forward.box.shift(-parent._crpix);
+    for (auto const & point : siwc) {
+        inverse.box.include(point);
+    }
+}
+
+std::unique_ptr<SipApproximation::Solution> SipApproximation::Solution::fit(
+    int order,
+    double svdThreshold,
+    SipApproximation const & parent
+) {
+    return fit(order, order, svdThreshold, parent);
 }
 
 std::unique_ptr<SipApproximation::Solution> SipApproximation::Solution::fit(
     int order,
+    int fillOrder,
     double svdThreshold,
     SipApproximation const & parent
 ) {
-    poly::PolynomialBasis2dYX basis(order);
-    if (basis.size() > parent._grid->dpix1.size()) {
+    Grid const & grid = *parent._grid;
+    poly::PolynomialBasis2dYX basis(std::max(order, fillOrder));
+    if (basis.size() > grid.dpix1.size()) {
         throw LSST_EXCEPT(
             pex::exceptions::LogicError,
             (boost::format("Number of parameters (%d) is larger than number of data points (%d)")
-             % (2*basis.size()) % (2*parent._grid->dpix1.size())).str()
+             % (2*basis.size()) % (2*grid.dpix1.size())).str()
         );
     }
 
-    lsst::geom::Box2D boxFwd(parent._bbox);
-    boxFwd.shift(-parent._crpix);
-    auto fwd = fitSipOneDirection(order, boxFwd, svdThreshold, parent._grid->dpix1, parent._grid->siwc);
+    // The two directions are independent problems, so they can be solved concurrently.
+    std::optional<Grid::Direction::FunctionPair> fwd;
+    std::optional<Grid::Direction::FunctionPair> inv;
+    math::detail::parallelFor(2, parent._numThreads, [&](int i) {
+        if (i == 0) {
+            grid.forward.fill(std::max(order, fillOrder), grid.dpix1, grid.siwc);
+            fwd = grid.forward.fit(order, svdThreshold);
+        } else {
+            grid.inverse.fill(std::max(order, fillOrder), grid.siwc, grid.dpix2);
+            inv = grid.inverse.fit(order, svdThreshold);
+        }
+    });
+
+    return std::make_unique<Solution>(fwd->first, fwd->second, inv->first, inv->second);
+}
 
-    lsst::geom::Box2D boxInv;
-    for (auto const & point : parent._grid->siwc) {
-        boxInv.include(point);
+std::pair<double, double> SipApproximation::Solution::computeMaxDeviation(Grid const & grid) const {
+    std::pair<double, double> maxDiff(0.0, 0.0);
+    auto ws = makeWorkspace();
+    for (std::size_t i = 0; i < grid.dpix1.size(); ++i) {
+        auto siwc2 = applyForward(grid.dpix1[i], ws);
+        auto dpix2 = applyInverse(grid.siwc[i], ws);
+        maxDiff.first = std::max(maxDiff.first, (grid.siwc[i] - siwc2).computeNorm());
+        maxDiff.second = std::max(maxDiff.second, (grid.dpix2[i] - dpix2).computeNorm());
     }
-    auto inv = fitSipOneDirection(order, boxInv, svdThreshold, parent._grid->siwc, parent._grid->dpix2);
-
-    return std::make_unique<Solution>(fwd.first, fwd.second, inv.first, inv.second);
+    return maxDiff;
 }
 
 SipApproximation::SipApproximation(
@@ -214,9 +288,11 @@ SipApproximation::SipApproximation(
     lsst::geom::Extent2I const & gridShape,
     int order,
     bool useInverse,
-    double svdThreshold
+    double svdThreshold,
+    int numThreads
 ) :
     _useInverse(useInverse),
+    _numThreads(math::detail::resolveNumThreads(numThreads)),
     _pixelToIwc(std::move(pixelToIwc)),
     _bbox(bbox),
     _crpix(crpix),
@@ -235,9 +311,11 @@ SipApproximation::SipApproximation(
     ndarray::Array<double const, 2> const & b,
     ndarray::Array<double const, 2> const & ap,
     ndarray::Array<double const, 2> const & bp,
-    bool useInverse
+    bool useInverse,
+    int numThreads
 ) :
     _useInverse(useInverse),
+    _numThreads(math::detail::resolveNumThreads(numThreads)),
     _pixelToIwc(std::move(pixelToIwc)),
     _bbox(bbox),
     _crpix(crpix),
@@ -377,16 +455,29 @@ void SipApproximation::fit(int order, double svdThreshold) {
     _solution = Solution::fit(order, svdThreshold, *this);
 }
 
-std::pair<double, double> SipApproximation::computeMaxDeviation() const noexcept {
-    std::pair<double, double> maxDiff(0.0, 0.0);
-    auto ws = _solution->makeWorkspace();
-    for (std::size_t i = 0; i < _grid->dpix1.size(); ++i) {
-        auto siwc2 = _solution->applyForward(_grid->dpix1[i], ws);
-        auto dpix2 = _solution->applyInverse(_grid->siwc[i], ws);
-        maxDiff.first = std::max(maxDiff.first, (_grid->siwc[i] - siwc2).computeNorm());
-        maxDiff.second = std::max(maxDiff.second, (_grid->dpix2[i] - dpix2).computeNorm());
+int SipApproximation::fitToTolerance(int maxOrder, double tolerance, double svdThreshold) {
+    if (maxOrder < 0) {
+        throw LSST_EXCEPT(
+            pex::exceptions::InvalidParameterError,
+            (boost::format("Maximum order (%d) must not be negative.") % maxOrder).str()
+        );
     }
-    return maxDiff;
+    // Fitting at maxOrder first checks the number of data points and evaluates the bases once.
+    auto best = Solution::fit(maxOrder, svdThreshold, *this);
+    for (int order = 0; order < maxOrder; ++order) {
+        auto candidate = Solution::fit(order, maxOrder, svdThreshold, *this);
+        auto diffs = candidate->computeMaxDeviation(*_grid);
+        if (diffs.first <= tolerance && diffs.second <= tolerance) {
+            best = std::move(candidate);
+            break;
+        }
+    }
+    _solution = std::move(best);
+    return getOrder();
+}
+
+std::pair<double, double> SipApproximation::computeMaxDeviation() const noexcept {
+    return _solution->computeMaxDeviation(*_grid);
 }
 
 }}}  // namespace lsst::afw::geom
@@ -22,8 +22,15 @@
 
 #include <cmath>
 #include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <exception>
+#include <iomanip>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
 #include <vector>
 
 #include "astshim.h"
@@ -34,12 +41,15 @@
 #include "lsst/afw/formatters/Utils.h"
 #include "lsst/afw/table/io/CatalogVector.h"
 #include "lsst/afw/table/io/OutputArchive.h"
+#include "lsst/afw/geom/detail/astEncoding.h"
 #include "lsst/afw/geom/detail/frameSetUtils.h"
+#include "lsst/afw/geom/detail/TanSipEvaluator.h"
 #include "lsst/afw/geom/wcsUtils.h"
 #include "lsst/afw/geom/SkyWcs.h"
 #include "lsst/daf/base/PropertyList.h"
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/table/io/Persistable.cc"
+#include "lsst/cpputils/Cache.h"
 
 namespace lsst {
 namespace afw {
@@ -60,6 +70,14 @@ int const SERIALIZATION_VERSION = 1;
 // see FitsTol in the AST manual http://starlink.eao.hawaii.edu/devdocs/sun211.htx/sun211.html
 double const TIGHT_FITS_TOL = 0.0001;
 
+// Number of points a SkyWcs must transform before it tries to build its direct TAN-SIP evaluator;
+// building costs about as much as this many transformations through AST.
+std::size_t const FAST_PATH_MIN_POINTS = 50;
+
+// Maximum allowed disagreement between the direct evaluator and AST, checked when the evaluator is built
+double const FAST_PATH_SKY_TOL = 1.0e-11;  // radians, about 2 microarcseconds
+double const FAST_PATH_PIXEL_TOL = 1.0e-7;  // pixels
+
 class SkyWcsPersistenceHelper {
 public:
     table::Schema schema;
@@ -84,6 +102,25 @@ private:
               wcs(schema.addField<table::Array<std::uint8_t>>("wcs", "wcs string representation", "")) {}
 };
 
+// Schema and Key of the compact form: a single record whose only field holds the output of
+// SkyWcs::writeString encoded by detail::encodeAstText
+class CompactSkyWcsPersistenceHelper {
+public:
+    table::Schema schema;
+    table::Key<table::Array<std::uint8_t>> wcs;
+
+    static CompactSkyWcsPersistenceHelper const& get() {
+        static CompactSkyWcsPersistenceHelper const instance;
+        return instance;
+    }
+
+private:
+    CompactSkyWcsPersistenceHelper()
+            : schema(),
+              wcs(schema.addField<table::Array<std::uint8_t>>(
+                      "compactWcs", "wcs string representation, encoded by detail::encodeAstText", "")) {}
+};
+
 class SkyWcsFactory : public table::io::PersistableFactory {
 public:
     explicit SkyWcsFactory(std::string const& name) : table::io::PersistableFactory(name) {}
@@ -91,10 +128,15 @@ public:
     std::shared_ptr<table::io::Persistable> read(InputArchive const& archive,
                                                  CatalogVector const& catalogs) const override {
         SkyWcsPersistenceHelper const& keys = SkyWcsPersistenceHelper::get();
+        CompactSkyWcsPersistenceHelper const& compactKeys = CompactSkyWcsPersistenceHelper::get();
         LSST_ARCHIVE_ASSERT(catalogs.size() == 1u);
         LSST_ARCHIVE_ASSERT(catalogs.front().size() == 1u);
-        LSST_ARCHIVE_ASSERT(catalogs.front().getSchema() == keys.schema);
         table::BaseRecord const& record = catalogs.front().front();
+        if (catalogs.front().getSchema() == compactKeys.schema) {
+            return SkyWcs::readString(detail::decodeAstText(record.get(compactKeys.wcs)));
+        }
+        // Written before the compact form was introduced
+        LSST_ARCHIVE_ASSERT(catalogs.front().getSchema() == keys.schema);
         std::string stringRep = formatters::bytesToString(record.get(keys.wcs));
         return SkyWcs::readString(stringRep);
     }
@@ -128,6 +170,54 @@ ast::FrameDict makeSkyWcsFrameDict(TransformPoint2ToPoint2 const& pixelsToFieldA
     return finalFrameDict;
 }
 
+// Length of the sides, in pixels, of the square used to measure the local pixel scale and linearization
+double const LINEARIZATION_SIDE = 1.0;
+
+/*
+ * Return the local linear approximation to pixelToSky at pix00, given its sky position coord and those
+ * of the pixels LINEARIZATION_SIDE away in x (sky10) and in y (sky01)
+ */
+lsst::geom::AffineTransform makeLinearization(lsst::geom::Point2D const& pix00,
+                                              lsst::geom::SpherePoint const& coord,
+                                              lsst::geom::SpherePoint const& sky10,
+                                              lsst::geom::SpherePoint const& sky01,
+                                              lsst::geom::AngleUnit const& skyUnit) {
+    double const side = LINEARIZATION_SIDE;
+    auto const sky00 = coord.getPosition(skyUnit);
+    auto const dsky10 = coord.getTangentPlaneOffset(sky10);
+    auto const dsky01 = coord.getTangentPlaneOffset(sky01);
+
+    Eigen::Matrix2d m;
+    m(0, 0) = dsky10.first.asAngularUnits(skyUnit) / side;
+    m(0, 1) = dsky01.first.asAngularUnits(skyUnit) / side;
+    m(1, 0) = dsky10.second.asAngularUnits(skyUnit) / side;
+    m(1, 1) = dsky01.second.asAngularUnits(skyUnit) / side;
+
+    Eigen::Vector2d sky00v;
+    sky00v << sky00.getX(), sky00.getY();
+    Eigen::Vector2d pix00v;
+    pix00v << pix00.getX(), pix00.getY();
+    return lsst::geom::AffineTransform(m, (sky00v - m * pix00v));
+}
+
+/*
+ * Return the pixel scale given the sky positions of a pixel (sky00) and of the pixels LINEARIZATION_SIDE
+ * away from it in x (sky10) and in y (sky01)
+ */
+lsst::geom::Angle makePixelScale(lsst::geom::SpherePoint const& sky00, lsst::geom::SpherePoint const& sky10,
+                                 lsst::geom::SpherePoint const& sky01) {
+    // Work in 3-space to avoid RA wrapping and pole issues
+    auto skyLL = sky00.getVector();
+    auto skyDx = sky10.getVector() - skyLL;
+    auto skyDy = sky01.getVector() - skyLL;
+
+    // Compute pixel scale in radians = sqrt(pixel area in radians^2)
+    // pixel area in radians^2 = area of parallelogram with sides skyDx, skyDy = |skyDx cross skyDy|
+    // Use squared norm to avoid two square roots
+    double skyAreaSq = skyDx.cross(skyDy).getSquaredNorm();
+    return (std::pow(skyAreaSq, 0.25) / LINEARIZATION_SIDE) * lsst::geom::radians;
+}
+
 }  // namespace
 
 Eigen::Matrix2d makeCdMatrix(lsst::geom::Angle const& scale, lsst::geom::Angle const& orientation,
@@ -156,27 +246,28 @@ SkyWcs::SkyWcs(ast::FrameDict const& frameDict) : SkyWcs(_checkFrameDict(frameDi
 bool SkyWcs::operator==(SkyWcs const& other) const { return writeString() == other.writeString(); }
 
 lsst::geom::Angle SkyWcs::getPixelScale(lsst::geom::Point2D const& pixel) const {
-    // Compute pixVec containing the pixel position and two nearby points
-    // (use a vector so all three points can be converted to sky in a single call)
-    double const side = 1.0;
-    std::vector<lsst::geom::Point2D> pixVec = {
-            pixel,
-            pixel + lsst::geom::Extent2D(side, 0),
-            pixel + lsst::geom::Extent2D(0, side),
-    };
-
-    auto skyVec = pixelToSky(pixVec);
-
-    // Work in 3-space to avoid RA wrapping and pole issues
-    auto skyLL = skyVec[0].getVector();
-    auto skyDx = skyVec[1].getVector() - skyLL;
-    auto skyDy = skyVec[2].getVector() - skyLL;
+    return getPixelScale(std::vector<lsst::geom::Point2D>{pixel}).front();
+}
+
+std::vector<lsst::geom::Angle> SkyWcs::getPixelScale(std::vector<lsst::geom::Point2D> const& pixels) const {
+    // Compute pixVec containing each pixel position and two nearby points
+    // (use a vector so all the points can be converted to sky in a single call)
+    double const side = LINEARIZATION_SIDE;
+    std::vector<lsst::geom::Point2D> pixVec;
+    pixVec.reserve(3 * pixels.size());
+    for (auto const& pixel : pixels) {
+        pixVec.push_back(pixel);
+        pixVec.push_back(pixel + lsst::geom::Extent2D(side, 0));
+        pixVec.push_back(pixel + lsst::geom::Extent2D(0, side));
+    }
 
-    // Compute pixel scale in radians = sqrt(pixel area in radians^2)
-    // pixel area in radians^2 = area of parallelogram with sides skyDx, skyDy = |skyDx cross skyDy|
-    // Use squared norm to avoid two square roots
-    double skyAreaSq = skyDx.cross(skyDy).getSquaredNorm();
-    return (std::pow(skyAreaSq, 0.25) / side) * lsst::geom::radians;
+    auto const skyVec = pixelToSky(pixVec);
+    std::vector<lsst::geom::Angle> result;
+    result.reserve(pixels.size());
+    for (std::size_t i = 0; i < pixels.size(); ++i) {
+        result.push_back(makePixelScale(skyVec[3 * i], skyVec[3 * i + 1], skyVec[3 * i + 2]));
+    }
+    return result;
 }
 
 lsst::geom::SpherePoint SkyWcs::getSkyOrigin() const {
@@ -291,6 +382,34 @@ lsst::geom::AffineTransform SkyWcs::linearizeSkyToPixel(lsst::geom::Point2D cons
     return _linearizeSkyToPixel(pix, pixelToSky(pix), skyUnit);
 }
 
+std::vector<lsst::geom::AffineTransform> SkyWcs::linearizePixelToSky(
+        std::vector<lsst::geom::SpherePoint> const& coords, lsst::geom::AngleUnit const& skyUnit) const {
+    return _linearizePixelToSky(skyToPixel(coords), coords, skyUnit);
+}
+
+std::vector<lsst::geom::AffineTransform> SkyWcs::linearizePixelToSky(
+        std::vector<lsst::geom::Point2D> const& pixels, lsst::geom::AngleUnit const& skyUnit) const {
+    return _linearizePixelToSky(pixels, pixelToSky(pixels), skyUnit);
+}
+
+std::vector<lsst::geom::AffineTransform> SkyWcs::linearizeSkyToPixel(
+        std::vector<lsst::geom::SpherePoint> const& coords, lsst::geom::AngleUnit const& skyUnit) const {
+    auto result = linearizePixelToSky(coords, skyUnit);
+    for (auto& transform : result) {
+        transform = transform.inverted();
+    }
+    return result;
+}
+
+std::vector<lsst::geom::AffineTransform> SkyWcs::linearizeSkyToPixel(
+        std::vector<lsst::geom::Point2D> const& pixels, lsst::geom::AngleUnit const& skyUnit) const {
+    auto result = linearizePixelToSky(pixels, skyUnit);
+    for (auto& transform : result) {
+        transform = transform.inverted();
+    }
+    return result;
+}
+
 std::string SkyWcs::getShortClassName() { return "SkyWcs"; };
 
 bool SkyWcs::isFlipped() const {
@@ -379,10 +498,10 @@ std::string SkyWcs::getPersistenceName() const { return getSkyWcsPersistenceName
 std::string SkyWcs::getPythonModule() const { return "lsst.afw.geom"; }
 
 void SkyWcs::write(OutputArchiveHandle& handle) const {
-    SkyWcsPersistenceHelper const& keys = SkyWcsPersistenceHelper::get();
+    CompactSkyWcsPersistenceHelper const& keys = CompactSkyWcsPersistenceHelper::get();
     table::BaseCatalog cat = handle.makeCatalog(keys.schema);
     std::shared_ptr<table::BaseRecord> record = cat.addNew();
-    record->set(keys.wcs, formatters::stringToBytes(writeString()));
+    record->set(keys.wcs, detail::encodeAstText(writeString()));
     handle.saveCatalog(cat);
 }
 
@@ -391,6 +510,138 @@ SkyWcs::SkyWcs(std::shared_ptr<ast::FrameDict> frameDict)
     _computeCache();
 };
 
+struct SkyWcs::FastPath {
+    // Points transformed so far, until the evaluator is built
+    std::atomic<std::size_t> nPoints{0};
+    std::once_flag buildFlag;
+    std::atomic<bool> isBuilt{false};
+    // Null if the WCS is not TAN-SIP or the evaluator disagrees with AST
+    std::shared_ptr<detail::TanSipEvaluator const> evaluator;
+    // Whether skyToPixel may use the evaluator, as well as pixelToSky
+    bool hasInverse = false;
+};
+
+void SkyWcs::_computeCache() {
+    _transform = std::make_shared<TransformPoint2ToSpherePoint>(*_frameDict->getMapping(), true);
+    _fastPath = std::make_shared<FastPath>();
+    _pixelOrigin = skyToPixel(getSkyOrigin());
+    _pixelScaleAtOrigin = getPixelScale(_pixelOrigin);
+}
+
+SkyWcs::FastPath const* SkyWcs::_getFastPath(std::size_t nPoints) const {
+    FastPath& fastPath = *_fastPath;
+    if (!fastPath.isBuilt.load(std::memory_order_acquire)) {
+        if (fastPath.nPoints.fetch_add(nPoints, std::memory_order_relaxed) + nPoints < FAST_PATH_MIN_POINTS) {
+            return nullptr;
+        }
+        std::call_once(fastPath.buildFlag, [this, &fastPath] {
+            std::shared_ptr<detail::TanSipEvaluator const> evaluator;
+            try {
+                evaluator = detail::TanSipEvaluator::make(*getFitsMetadata(true));
+            } catch (lsst::pex::exceptions::Exception const&) {
+            } catch (std::runtime_error const&) {
+            }
+            if (evaluator) {
+                // Trust the evaluator only where it reproduces AST, over a grid about the pixel origin
+                std::vector<lsst::geom::Point2D> pixels;
+                for (double dy = -1000; dy <= 1000; dy += 500) {
+                    for (double dx = -1000; dx <= 1000; dx += 500) {
+                        pixels.push_back(_pixelOrigin + lsst::geom::Extent2D(dx, dy));
+                    }
+                }
+                auto const skies = _transform->applyForward(pixels);
+                auto const astPixels = _transform->applyInverse(skies);
+                bool forwardOk = true;
+                bool inverseOk = evaluator->hasInverse();
+                for (std::size_t i = 0; i < pixels.size(); ++i) {
+                    if (!skies[i].isFinite()) {
+                        continue;  // AST could not transform this point, so there is nothing to compare
+                    }
+                    double ra, dec, x, y;
+                    if (!evaluator->pixelToSky(pixels[i].getX(), pixels[i].getY(), ra, dec) ||
+                        !(skies[i].separation(lsst::geom::SpherePoint(ra, dec, lsst::geom::radians))
+                                  .asRadians() <= FAST_PATH_SKY_TOL)) {
+                        forwardOk = false;
+                        break;
+                    }
+                    if (inverseOk && (!evaluator->skyToPixel(skies[i].getLongitude().asRadians(),
+                                                             skies[i].getLatitude().asRadians(), x, y) ||
+                                      !(std::hypot(x - astPixels[i].getX(), y - astPixels[i].getY()) <=
+                                        FAST_PATH_PIXEL_TOL))) {
+                        inverseOk = false;
+                    }
+                }
+                if (forwardOk) {
+                    fastPath.evaluator = evaluator;
+                    fastPath.hasInverse = inverseOk;
+                }
+            }
+            fastPath.isBuilt.store(true, std::memory_order_release);
+        });
+    }
+    return fastPath.evaluator ? &fastPath : nullptr;
+}
+
+lsst::geom::SpherePoint SkyWcs::pixelToSky(lsst::geom::Point2D const& pixel) const {
+    if (auto const fastPath = _getFastPath(1)) {
+        double ra, dec;
+        if (fastPath->evaluator->pixelToSky(pixel.getX(), pixel.getY(), ra, dec)) {
+            return lsst::geom::SpherePoint(ra, dec, lsst::geom::radians);
+        }
+    }
+    return _transform->applyForward(pixel);
+}
+
+std::vector<lsst::geom::SpherePoint> SkyWcs::pixelToSky(
+        std::vector<lsst::geom::Point2D> const& pixels) const {
+    auto const fastPath = _getFastPath(pixels.size());
+    if (!fastPath) {
+        return _transform->applyForward(pixels);
+    }
+    std::vector<lsst::geom::SpherePoint> result;
+    result.reserve(pixels.size());
+    for (auto const& pixel : pixels) {
+        double ra, dec;
+        if (fastPath->evaluator->pixelToSky(pixel.getX(), pixel.getY(), ra, dec)) {
+            result.emplace_back(ra, dec, lsst::geom::radians);
+        } else {
+            result.push_back(_transform->applyForward(pixel));
+        }
+    }
+    return result;
+}
+
+lsst::geom::Point2D SkyWcs::skyToPixel(lsst::geom::SpherePoint const& sky) const {
+    auto const fastPath = _getFastPath(1);
+    if (fastPath && fastPath->hasInverse) {
+        double x, y;
+        if (fastPath->evaluator->skyToPixel(sky.getLongitude().asRadians(), sky.getLatitude().asRadians(), x,
+                                            y)) {
+            return lsst::geom::Point2D(x, y);
+        }
+    }
+    return _transform->applyInverse(sky);
+}
+
+std::vector<lsst::geom::Point2D> SkyWcs::skyToPixel(std::vector<lsst::geom::SpherePoint> const& sky) const {
+    auto const fastPath = _getFastPath(sky.size());
+    if (!fastPath || !fastPath->hasInverse) {
+        return _transform->applyInverse(sky);
+    }
+    std::vector<lsst::geom::Point2D> result;
+    result.reserve(sky.size());
+    for (auto const& point : sky) {
+        double x, y;
+        if (fastPath->evaluator->skyToPixel(point.getLongitude().asRadians(), point.getLatitude().asRadians(),
+                                            x, y)) {
+            result.emplace_back(x, y);
+        } else {
+            result.push_back(_transform->applyInverse(point));
+        }
+    }
+    return result;
+}
+
 std::shared_ptr<ast::FrameDict> SkyWcs::_checkFrameDict(ast::FrameDict const& frameDict) const {
     // Check that each frame is present and has the right type and number of axes
     std::vector<std::string> const domainNames = {"ACTUAL_PIXELS", "PIXELS", "IWC", "SKY"};
@@ -438,23 +689,29 @@ lsst::geom::AffineTransform SkyWcs::_linearizePixelToSky(lsst::geom::Point2D con
     // Figure out the (0, 0), (0, 1), and (1, 0) ra/dec coordinates of the corners
     // of a square drawn in pixel. It'd be better to center the square at sky00,
     // but that would involve another conversion between sky and pixel coordinates
-    const double side = 1.0;  // length of the square's sides in pixels
-    auto const sky00 = coord.getPosition(skyUnit);
-    auto const dsky10 = coord.getTangentPlaneOffset(pixelToSky(pix00 + lsst::geom::Extent2D(side, 0)));
-    auto const dsky01 = coord.getTangentPlaneOffset(pixelToSky(pix00 + lsst::geom::Extent2D(0, side)));
-
-    Eigen::Matrix2d m;
-    m(0, 0) = dsky10.first.asAngularUnits(skyUnit) / side;
-    m(0, 1) = dsky01.first.asAngularUnits(skyUnit) / side;
-    m(1, 0) = dsky10.second.asAngularUnits(skyUnit) / side;
-    m(1, 1) = dsky01.second.asAngularUnits(skyUnit) / side;
-
-    Eigen::Vector2d sky00v;
-    sky00v << sky00.getX(), sky00.getY();
-    Eigen::Vector2d pix00v;
-    pix00v << pix00.getX(), pix00.getY();
-    // return lsst::geom::AffineTransform(m, lsst::geom::Extent2D(sky00v - m * pix00v));
-    return lsst::geom::AffineTransform(m, (sky00v - m * pix00v));
+    double const side = LINEARIZATION_SIDE;
+    return makeLinearization(pix00, coord, pixelToSky(pix00 + lsst::geom::Extent2D(side, 0)),
+                             pixelToSky(pix00 + lsst::geom::Extent2D(0, side)), skyUnit);
+}
+
+std::vector<lsst::geom::AffineTransform> SkyWcs::_linearizePixelToSky(
+        std::vector<lsst::geom::Point2D> const& pixels, std::vector<lsst::geom::SpherePoint> const& coords,
+        lsst::geom::AngleUnit const& skyUnit) const {
+    // Convert the (0, 1) and (1, 0) corners of the squares at all the points in a single call
+    double const side = LINEARIZATION_SIDE;
+    std::vector<lsst::geom::Point2D> pixVec;
+    pixVec.reserve(2 * pixels.size());
+    for (auto const& pixel : pixels) {
+        pixVec.push_back(pixel + lsst::geom::Extent2D(side, 0));
+        pixVec.push_back(pixel + lsst::geom::Extent2D(0, side));
+    }
+    auto const skyVec = pixelToSky(pixVec);
+    std::vector<lsst::geom::AffineTransform> result;
+    result.reserve(pixels.size());
+    for (std::size_t i = 0; i < pixels.size(); ++i) {
+        result.push_back(makeLinearization(pixels[i], coords[i], skyVec[2 * i], skyVec[2 * i + 1], skyUnit));
+    }
+    return result;
 }
 
 lsst::geom::AffineTransform SkyWcs::_linearizeSkyToPixel(lsst::geom::Point2D const& pix00,
@@ -518,8 +775,170 @@ std::shared_ptr<SkyWcs> makeModifiedWcs(TransformPoint2ToPoint2 const& pixelTran
     return std::make_shared<SkyWcs>(*newFrameDict);
 }
 
-std::shared_ptr<SkyWcs> makeSkyWcs(daf::base::PropertySet& metadata, bool strip) {
-    return std::make_shared<SkyWcs>(metadata, strip);
+namespace {
+
+std::size_t const DEFAULT_METADATA_CACHE_CAPACITY = 100;
+
+// Prefixes of the names of the FITS cards that can affect a SkyWcs read from metadata: the FITS WCS, SIP
+// and DSS keywords, and the dates, times and observatory position AST may use to set up the sky frame
+std::vector<std::string> const WCS_CARD_PREFIXES = {
+        "CRPIX",   "CRVAL",   "CDELT",   "CTYPE",    "CUNIT",   "CROTA",   "CRDER", "CSYER",
+        "CNAME",   "CD",      "PC",      "PV",       "PS",      "A_",      "B_",    "AP_",
+        "BP_",     "LONPOLE", "LATPOLE", "RADESYS",  "RADECSYS", "EQUINOX", "EPOCH", "WCSAXES",
+        "WCSNAME", "MJD",     "DATE-",   "TIMESYS",  "OBSGEO",  "SPECSYS", "SSYS",  "RESTFR",
+        "VELREF",  "ZSOURCE", "CNPIX",   "PLT",      "AMD",     "PPO",     "XPIXELSZ", "YPIXELSZ"};
+
+bool isWcsCardName(std::string const& name) {
+    // Longer names are never given to AST; see detail::getFitsChanFromPropertyList
+    if (name.size() > 8) {
+        return false;
+    }
+    auto const matches = [&name](std::string const& prefix) {
+        return name.compare(0, prefix.size(), prefix) == 0;
+    };
+    return std::any_of(WCS_CARD_PREFIXES.begin(), WCS_CARD_PREFIXES.end(), matches);
+}
+
+// Return the key under which a SkyWcs read from metadata is cached: the WCS cards, sorted by name, with
+// the values that detail::getFitsChanFromPropertyList would give AST
+std::string makeMetadataCacheKey(daf::base::PropertySet const& metadata) {
+    std::vector<std::string> names = metadata.paramNames(false);
+    std::sort(names.begin(), names.end());
+    std::ostringstream os;
+    os << std::setprecision(17);
+    for (auto const& name : names) {
+        if (!isWcsCardName(name)) {
+            continue;
+        }
+        std::type_info const& type = metadata.typeOf(name);
+        os << name << '=';
+        if (type == typeid(bool)) {
+            os << 'L' << metadata.get<bool>(name);
+        } else if (type == typeid(std::uint8_t)) {
+            os << 'I' << static_cast<int>(metadata.get<std::uint8_t>(name));
+        } else if (type == typeid(int)) {
+            os << 'I' << metadata.get<int>(name);
+        } else if (type == typeid(double)) {
+            os << 'F' << metadata.get<double>(name);
+        } else if (type == typeid(float)) {
+            os << 'F' << static_cast<double>(metadata.get<float>(name));
+        } else if (type == typeid(std::string)) {
+            std::string const str = metadata.get<std::string>(name);
+            os << 'S' << str.size() << ':' << str;
+        } else {
+            os << '?';  // not given to AST
+        }
+        os << '\n';
+    }
+    return os.str();
+}
+
+// Replace RADECSYS with RADESYS if only the former is present, as detail::readFitsWcs does
+void replaceRadecsys(daf::base::PropertySet& metadata) {
+    if (metadata.exists("RADECSYS") && !metadata.exists("RADESYS")) {
+        metadata.set("RADESYS", metadata.getAsString("RADECSYS"));
+        metadata.remove("RADECSYS");
+    }
+}
+
+// Process-wide cache of the SkyWcs read by makeSkyWcs from FITS metadata.
+//
+// cpputils::Cache reorders its entries even on lookup, so every access is locked; SkyWcs are read
+// outside the lock.
+class MetadataCache {
+public:
+    struct Entry {
+        std::shared_ptr<SkyWcs> wcs;
+        std::vector<std::string> strippedNames;  // the cards removed from the metadata by strip=true
+    };
+
+    explicit MetadataCache(std::size_t capacity) { setCapacity(capacity); }
+
+    std::optional<Entry> get(std::string const& key) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _capacity > 0 ? _cache->get(key) : std::nullopt;
+    }
+
+    // Cache an entry, returning the one already cached for key if another thread got there first
+    Entry add(std::string const& key, Entry const& entry) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_capacity == 0) {
+            return entry;
+        }
+        return (*_cache)(key, [&entry](std::string const&) { return entry; });
+    }
+
+    std::size_t getCapacity() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _capacity;
+    }
+
+    void setCapacity(std::size_t capacity) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cache = std::make_unique<cpputils::Cache<std::string, Entry>>(std::max<std::size_t>(capacity, 1));
+        _capacity = capacity;
+    }
+
+private:
+    std::mutex _mutex;
+    std::size_t _capacity = 0;
+    std::unique_ptr<cpputils::Cache<std::string, Entry>> _cache;
+};
+
+MetadataCache& getMetadataCache() {
+    static MetadataCache cache(DEFAULT_METADATA_CACHE_CAPACITY);
+    return cache;
+}
+
+}  // namespace
+
+void setSkyWcsMetadataCacheCapacity(std::size_t capacity) { getMetadataCache().setCapacity(capacity); }
+
+std::size_t getSkyWcsMetadataCacheCapacity() { return getMetadataCache().getCapacity(); }
+
+std::shared_ptr<SkyWcs> makeSkyWcs(daf::base::PropertySet& metadata, bool strip, bool useCache) {
+    MetadataCache& cache = getMetadataCache();
+    if (!useCache || cache.getCapacity() == 0) {
+        return std::make_shared<SkyWcs>(metadata, strip);
+    }
+    std::string const key = makeMetadataCacheKey(metadata);
+    std::optional<MetadataCache::Entry> cached = cache.get(key);
+    if (cached) {
+        // Modify the metadata just as reading the WCS would have
+        if (strip) {
+            for (auto const& name : cached->strippedNames) {
+                metadata.remove(name);
+            }
+        } else {
+            replaceRadecsys(metadata);
+        }
+        return cached->wcs;
+    }
+
+    // Always read with strip=true, from a copy if necessary, to find out which cards AST used
+    std::vector<std::string> const initialNames = metadata.paramNames(false);
+    std::shared_ptr<daf::base::PropertySet> copy;
+    daf::base::PropertySet* stripped = &metadata;
+    if (!strip) {
+        copy = metadata.deepCopy();
+        stripped = copy.get();
+    }
+    MetadataCache::Entry entry{std::make_shared<SkyWcs>(*stripped, true), {}};
+    if (!strip) {
+        replaceRadecsys(metadata);
+    }
+
+    // The entry can only be reused if the key includes every card that was used, and reading added none
+    bool cacheable = true;
+    for (auto const& name : initialNames) {
+        if (!stripped->exists(name)) {
+            entry.strippedNames.push_back(name);
+            cacheable = cacheable && isWcsCardName(name);
+        }
+    }
+    cacheable = cacheable &&
+                stripped->paramNames(false).size() + entry.strippedNames.size() == initialNames.size();
+    return cacheable ? cache.add(key, entry).wcs : entry.wcs;
 }
 
 std::shared_ptr<SkyWcs> makeSkyWcs(lsst::geom::Point2D const& crpix, lsst::geom::SpherePoint const& crval,
@@ -23,12 +23,14 @@
 
 #include <algorithm>
 #include <iterator>
+#include <numeric>
 #include "lsst/afw/geom/SpanSet.h"
 #include "lsst/afw/table/io/CatalogVector.h"
 #include "lsst/afw/table/io/OutputArchive.h"
 #include "lsst/afw/geom/ellipses/PixelRegion.h"
 #include "lsst/afw/geom/transformFactory.h"
 #include "lsst/afw/image/LsstImageTypes.h"
+#include "lsst/afw/math/detail/Parallel.h"
 #include "lsst/afw/table/io/Persistable.cc"
 
 namespace lsst {
@@ -40,35 +42,203 @@ template std::shared_ptr<geom::SpanSet> table::io::PersistableFacade<geom::SpanS
 namespace geom {
 namespace {
 
-/* These classes are used in the erode operator to quickly calculate the
- * contents of the shrunken SpanSet
+/* Index of the spans on each row of a sorted vector of Spans, used by dilation and erosion to
+ * visit the rows of a SpanSet in any order.
  */
+class RowIndex {
+public:
+    using Iterator = std::vector<Span>::const_iterator;
+
+    explicit RowIndex(std::vector<Span> const& spans) : _spans(spans), _y0(0) {
+        if (spans.empty()) return;
+        _y0 = spans.front().getY();
+        // _offsets[i] is the index of the first span on row _y0 + i
+        _offsets.assign(spans.back().getY() - _y0 + 2, 0);
+        for (auto const& spn : spans) {
+            ++_offsets[spn.getY() - _y0 + 1];
+        }
+        std::partial_sum(_offsets.begin(), _offsets.end(), _offsets.begin());
+    }
+
+    int getMinY() const { return _y0; }
+    int getMaxY() const { return _y0 + static_cast<int>(_offsets.size()) - 2; }
 
-struct PrimaryRun {
-    int m, y, xmin, xmax;
+    // Return the spans on row y, in order of increasing x; empty if there are none
+    std::pair<Iterator, Iterator> getRow(int y) const {
+        if (_offsets.empty() || y < getMinY() || y > getMaxY()) {
+            return std::make_pair(_spans.end(), _spans.end());
+        }
+        return std::make_pair(_spans.begin() + _offsets[y - _y0], _spans.begin() + _offsets[y - _y0 + 1]);
+    }
+
+private:
+    std::vector<Span> const& _spans;
+    int _y0;
+    std::vector<std::size_t> _offsets;
 };
 
-bool comparePrimaryRun(PrimaryRun const& first, PrimaryRun const& second) {
-    if (first.y != second.y) {
-        return first.y < second.y;
-    } else if (first.m != second.m) {
-        return first.m < second.m;
+/* Append the rows [yBegin, yEnd) of the dilation of the spans in index by stencil to result.
+ *
+ * Row Y of the output is the union, over stencil spans at dy, of the spans on input row Y - dy
+ * widened by the stencil span; those are gathered, sorted and merged one row at a time, so the
+ * output comes out normalized.
+ */
+void dilateRows(RowIndex const& index, std::vector<Span> const& stencil, int yBegin, int yEnd,
+                std::vector<Span>& result) {
+    std::vector<Span> row;
+    for (int y = yBegin; y < yEnd; ++y) {
+        row.clear();
+        for (auto const& stencilSpan : stencil) {
+            auto const inputRow = index.getRow(y - stencilSpan.getY());
+            for (auto spn = inputRow.first; spn != inputRow.second; ++spn) {
+                row.emplace_back(y, spn->getMinX() + stencilSpan.getMinX(),
+                                 spn->getMaxX() + stencilSpan.getMaxX());
+            }
+        }
+        if (row.empty()) continue;
+        std::sort(row.begin(), row.end());
+        result.push_back(row.front());
+        for (auto spn = row.begin() + 1; spn != row.end(); ++spn) {
+            Span& last = result.back();
+            if (spn->getMinX() <= last.getMaxX() + 1) {
+                last = Span(y, last.getMinX(), std::max(last.getMaxX(), spn->getMaxX()));
+            } else {
+                result.push_back(*spn);
+            }
+        }
+    }
+}
+
+/* Append the rows [yBegin, yEnd) of the erosion of the spans in index by stencil to result.
+ *
+ * Pixel x of row Y survives if, for each stencil span [a, b] at dy, [x + a, x + b] lies within a
+ * single span of input row Y + dy, i.e. if x lies in one of that row's spans shrunk by the stencil
+ * span.  Each stencil span thus yields a sorted list of disjoint runs, and the output row is their
+ * intersection.  The input spans must be normalized, so each run of pixels is a single span.
+ */
+void erodeRows(RowIndex const& index, std::vector<Span> const& stencil, int yBegin, int yEnd,
+               std::vector<Span>& result) {
+    using Run = std::pair<int, int>;
+    std::vector<Run> good, allowed, intersection;
+    for (int y = yBegin; y < yEnd; ++y) {
+        good.clear();
+        bool first = true;
+        for (auto const& stencilSpan : stencil) {
+            allowed.clear();
+            int const width = stencilSpan.getMaxX() - stencilSpan.getMinX();
+            auto const inputRow = index.getRow(y + stencilSpan.getY());
+            for (auto spn = inputRow.first; spn != inputRow.second; ++spn) {
+                if (spn->getMaxX() - spn->getMinX() >= width) {
+                    allowed.emplace_back(spn->getMinX() - stencilSpan.getMinX(),
+                                         spn->getMaxX() - stencilSpan.getMaxX());
+                }
+            }
+            if (first) {
+                std::swap(good, allowed);
+                first = false;
+            } else {
+                intersection.clear();
+                auto g = good.begin();
+                auto a = allowed.begin();
+                while (g != good.end() && a != allowed.end()) {
+                    int const start = std::max(g->first, a->first);
+                    int const end = std::min(g->second, a->second);
+                    if (start <= end) {
+                        intersection.emplace_back(start, end);
+                    }
+                    // Advance whichever run ends first
+                    if (g->second < a->second) {
+                        ++g;
+                    } else {
+                        ++a;
+                    }
+                }
+                std::swap(good, intersection);
+            }
+            if (good.empty()) break;
+        }
+        for (auto const& run : good) {
+            result.emplace_back(y, run.first, run.second);
+        }
+    }
+}
+
+/* Compute the rows [yBegin, yEnd] of a dilation or erosion with rowFunc, spreading bands of rows
+ * over up to numThreads threads, and return them as a SpanSet.
+ */
+template <typename RowFunc>
+std::shared_ptr<SpanSet> sweepRows(int yBegin, int yEnd, int numThreads, RowFunc rowFunc) {
+    std::vector<Span> result;
+    if (yEnd < yBegin) {
+        return std::make_shared<SpanSet>(std::move(result), false);
+    }
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    if (nThreads == 1) {
+        rowFunc(yBegin, yEnd + 1, result);
     } else {
-        return first.xmin < second.xmin;
+        auto const bands = math::detail::splitRange(yBegin, yEnd + 1, nThreads);
+        std::vector<std::vector<Span>> bandResults(bands.size());
+        math::detail::parallelFor(static_cast<int>(bands.size()), nThreads, [&](int i) {
+            rowFunc(bands[i].first, bands[i].second, bandResults[i]);
+        });
+        std::size_t size = 0;
+        for (auto const& band : bandResults) {
+            size += band.size();
+        }
+        result.reserve(size);
+        for (auto const& band : bandResults) {
+            result.insert(result.end(), band.begin(), band.end());
+        }
     }
+    // Rows are produced in order, each already normalized
+    return std::make_shared<SpanSet>(std::move(result), false);
 }
 
-class ComparePrimaryRunY {
-public:
-    bool operator()(PrimaryRun const& pr, int yval) { return pr.y < yval; }
-    bool operator()(int yval, PrimaryRun const& pr) { return yval < pr.y; }
-};
+/* Append the Spans of the pixels of a row that have any bit of bitmask set (or, if invert, that have
+ * none set); row[0] is at column x0.
+ *
+ * Pixels are tested in blocks of 64 bytes; a block that is entirely outside (or, within a Span,
+ * entirely inside) the result is skipped after one vectorizable pass, without following each pixel.
+ */
+template <bool invert = false, typename T>
+void appendMaskRuns(T const* row, int width, T bitmask, int y, int x0, std::vector<Span>& output) {
+    constexpr int blockSize = 64 / sizeof(T);
+    int start = -1;  // start of the current Span, or -1 if not in one
+    int x = 0;
+    while (x < width) {
+        if (x + blockSize <= width) {
+            int count = 0;
+            for (int i = 0; i < blockSize; ++i) {
+                count += ((row[x + i] & bitmask) != 0) != invert;
+            }
+            if (count == (start < 0 ? 0 : blockSize)) {
+                x += blockSize;
+                continue;
+            }
+        }
+        int const blockEnd = std::min(x + blockSize, width);
+        for (; x < blockEnd; ++x) {
+            bool const selected = ((row[x] & bitmask) != 0) != invert;
+            if (selected && start < 0) {
+                start = x;
+            } else if (!selected && start >= 0) {
+                output.emplace_back(y, start + x0, x - 1 + x0);
+                start = -1;
+            }
+        }
+    }
+    if (start >= 0) {
+        output.emplace_back(y, start + x0, width - 1 + x0);
+    }
+}
 
-class ComparePrimaryRunM {
-public:
-    bool operator()(PrimaryRun const& pr, int mval) { return pr.m < mval; }
-    bool operator()(int mval, PrimaryRun const& pr) { return mval < pr.m; }
-};
+// Return the range of y covered by a set of Spans, which need not be sorted
+std::pair<int, int> getYRange(SpanSet const& spans) {
+    auto const range = std::minmax_element(spans.begin(), spans.end(), [](Span const& a, Span const& b) {
+        return a.getY() < b.getY();
+    });
+    return std::make_pair(range.first->getY(), range.second->getY());
+}
 
 /* Determine if two spans overlap
  *
@@ -105,6 +275,175 @@ bool spansContiguous(Span const& a, Span const& b, bool compareY = true) {
                    : false;
 }
 
+using SpanIterator = SpanSet::const_iterator;
+
+// Whether spans are sorted, with contiguous spans merged, as SpanSet's constructors leave them
+bool isNormalized(SpanIterator begin, SpanIterator end) {
+    if (begin == end) return true;
+    for (auto spn = begin + 1; spn != end; ++spn) {
+        if (!(*(spn - 1) < *spn) || spansContiguous(*(spn - 1), *spn)) return false;
+    }
+    return true;
+}
+
+// Return the root of element i of a union-find forest, halving the path to it on the way
+std::size_t findRoot(std::vector<std::size_t>& parent, std::size_t i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+// Join the sets of elements a and b, keeping the smaller root as the root of both
+void joinSets(std::vector<std::size_t>& parent, std::size_t a, std::size_t b) {
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a < b) {
+        parent[b] = a;
+    } else if (b < a) {
+        parent[a] = b;
+    }
+}
+
+// Whether the sorted spans [begin, end) of one row are disjoint
+bool rowIsDisjoint(std::vector<Span> const& spans, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin + 1; i < end; ++i) {
+        if (spans[i].getX0() <= spans[i - 1].getX1()) return false;
+    }
+    return true;
+}
+
+/* Join the sets of the spans of a row, [begin, middle), with those of the spans of the next row,
+ * [middle, end), that overlap them in x. Only these spans' entries of parent are touched.
+ */
+void joinRows(std::vector<Span> const& spans, std::size_t begin, std::size_t middle, std::size_t end,
+              std::vector<std::size_t>& parent) {
+    if (rowIsDisjoint(spans, begin, middle) && rowIsDisjoint(spans, middle, end)) {
+        // Ends of disjoint sorted spans increase too, so a single sweep finds every overlap
+        std::size_t i = begin, j = middle;
+        while (i < middle && j < end) {
+            if (spansOverlap(spans[i], spans[j], false)) {
+                joinSets(parent, i, j);
+            }
+            if (spans[i].getX1() < spans[j].getX1()) {
+                ++i;
+            } else {
+                ++j;
+            }
+        }
+        return;
+    }
+    // Unnormalized SpanSets may hold overlapping spans in a row: compare every plausible pair
+    for (std::size_t i = begin; i < middle; ++i) {
+        for (std::size_t j = middle; j < end && spans[j].getX0() <= spans[i].getX1(); ++j) {
+            if (spans[j].getX1() >= spans[i].getX0()) {
+                joinSets(parent, i, j);
+            }
+        }
+    }
+}
+
+/* Return the spans of spanSet, normalized; SpanSets built with normalize=false need not be,
+ * in which case a normalized copy is made in storage.
+ *
+ * The merges below need normalized input, and then produce normalized output.
+ */
+std::pair<SpanIterator, SpanIterator> getNormalizedSpans(SpanSet const& spanSet, std::vector<Span>& storage) {
+    if (isNormalized(spanSet.begin(), spanSet.end())) {
+        return std::make_pair(spanSet.begin(), spanSet.end());
+    }
+    SpanSet const normalized(spanSet.begin(), spanSet.end());
+    storage.assign(normalized.begin(), normalized.end());
+    return std::make_pair(storage.cbegin(), storage.cend());
+}
+
+// Append the intersection of two normalized ranges of spans to result
+void intersectSpans(SpanIterator a, SpanIterator aEnd, SpanIterator b, SpanIterator bEnd,
+                    std::vector<Span>& result) {
+    while (a != aEnd && b != bEnd) {
+        if (a->getY() != b->getY()) {
+            if (a->getY() < b->getY()) {
+                ++a;
+            } else {
+                ++b;
+            }
+            continue;
+        }
+        int const minX = std::max(a->getMinX(), b->getMinX());
+        int const maxX = std::min(a->getMaxX(), b->getMaxX());
+        if (minX <= maxX) {
+            result.emplace_back(a->getY(), minX, maxX);
+        }
+        // The span that ends first can't overlap anything further in the other range
+        if (a->getMaxX() < b->getMaxX()) {
+            ++a;
+        } else {
+            ++b;
+        }
+    }
+}
+
+// Append the pixels of normalized range a that are not in normalized range b to result
+void subtractSpans(SpanIterator a, SpanIterator aEnd, SpanIterator b, SpanIterator bEnd,
+                   std::vector<Span>& result) {
+    for (; a != aEnd; ++a) {
+        int const y = a->getY();
+        // First pixel of a not yet accounted for
+        int x = a->getMinX();
+        while (b != bEnd && (b->getY() < y || (b->getY() == y && b->getMaxX() < x))) {
+            ++b;
+        }
+        // A span of b may also cover the next span of a, so only look ahead from b here
+        for (auto c = b; c != bEnd && c->getY() == y && c->getMinX() <= a->getMaxX(); ++c) {
+            if (c->getMinX() > x) {
+                result.emplace_back(y, x, c->getMinX() - 1);
+            }
+            x = c->getMaxX() + 1;
+            if (x > a->getMaxX()) break;
+        }
+        if (x <= a->getMaxX()) {
+            result.emplace_back(y, x, a->getMaxX());
+        }
+    }
+}
+
+// Append the union of two normalized ranges of spans to result
+void uniteSpans(SpanIterator a, SpanIterator aEnd, SpanIterator b, SpanIterator bEnd,
+                std::vector<Span>& result) {
+    std::size_t const first = result.size();
+    auto append = [&result, first](Span const& spn) {
+        if (result.size() > first && spansContiguous(result.back(), spn)) {
+            Span& last = result.back();
+            last = Span(last.getY(), last.getMinX(), std::max(last.getMaxX(), spn.getMaxX()));
+        } else {
+            result.push_back(spn);
+        }
+    };
+    while (a != aEnd || b != bEnd) {
+        if (b == bEnd || (a != aEnd && *a < *b)) {
+            append(*a++);
+        } else {
+            append(*b++);
+        }
+    }
+}
+
+// Append the parts of a normalized range of spans that lie within box to result
+void clipSpans(SpanIterator begin, SpanIterator end, lsst::geom::Box2I const& box,
+               std::vector<Span>& result) {
+    if (box.isEmpty()) return;
+    auto spn = std::lower_bound(begin, end, box.getMinY(),
+                                [](Span const& s, int y) { return s.getY() < y; });
+    for (; spn != end && spn->getY() <= box.getMaxY(); ++spn) {
+        int const minX = std::max(spn->getMinX(), box.getMinX());
+        int const maxX = std::min(spn->getMaxX(), box.getMaxX());
+        if (minX <= maxX) {
+            result.emplace_back(spn->getY(), minX, maxX);
+        }
+    }
+}
+
 /* Determine the intersection with a mask or its logical inverse
  *
  * spanSet - SpanSet object with which to intersect the mask
@@ -120,54 +459,29 @@ template <typename T, bool invert>
 std::shared_ptr<SpanSet> maskIntersect(SpanSet const& spanSet, image::Mask<T> const& mask, T bitmask) {
     // This vector will store our output spans
     std::vector<Span> newVec;
+    std::vector<Span> storage;
+    auto const spans = getNormalizedSpans(spanSet, storage);
     auto maskBBox = mask.getBBox();
-    for (auto const& spn : spanSet) {
-        // Variable to mark if a new span has been started
-        // Reset the started flag for each different span
-        bool started = false;
+    auto maskArray = mask.getArray();
+    for (auto spn = spans.first; spn != spans.second; ++spn) {
         // Limit the y iteration to be within the mask's bounding box
-        int y = spn.getY();
+        int y = spn->getY();
         if (y < maskBBox.getMinY() || y > maskBBox.getMaxY()) {
             continue;
         }
-        // Reset the min and max variables
-        int minX = 0;
-        int maxX = 0;
         // Limit the scope of iteration to be within the mask's bounds
-        int startX = std::max(spn.getMinX(), maskBBox.getMinX());
-        int endX = std::min(spn.getMaxX(), maskBBox.getMaxX());
-        for (int x = startX; x <= endX; ++x) {
-            // Find if the pixel matches the given bit pattern
-            bool pixelCompare = mask.get(lsst::geom::Point2I(x, y), image::ImageOrigin::PARENT) & bitmask;
-            // if the templated boolean indicates the compliment of the mask is desired, invert the
-            // pixel comparison
-            if (invert) {
-                pixelCompare = !pixelCompare;
-            }
-            // If the pixel is to be included in the operation, start or append recording values
-            // needed to later construct a Span
-            if (pixelCompare) {
-                if (!started) {
-                    started = true;
-                    minX = x;
-                    maxX = x;
-                } else {
-                    maxX = x;
-                }
-                if (x == endX) {
-                    // We have reached the end of a row and the pixel evaluates true, should add the
-                    // Span
-                    newVec.emplace_back(y, minX, maxX);
-                }
-            } else if (started) {
-                // A span was started but the current pixel is not to be included in the new SpanSet,
-                // the current SpanSet should be close and added to the vector
-                newVec.emplace_back(y, minX, maxX);
-                started = false;
-            }
+        int startX = std::max(spn->getMinX(), maskBBox.getMinX());
+        int endX = std::min(spn->getMaxX(), maskBBox.getMaxX());
+        if (startX > endX) {
+            continue;
         }
+        // Find each run of pixels that match the given bit pattern (or, if the templated boolean
+        // indicates the complement of the mask is desired, that don't)
+        T const* row = maskArray[y - maskBBox.getMinY()].getData() + (startX - maskBBox.getMinX());
+        appendMaskRuns<invert>(row, endX - startX + 1, bitmask, y, startX, newVec);
     }
-    return std::make_shared<SpanSet>(std::move(newVec));
+    // Runs come out in order, separated by excluded pixels, so they are already normalized
+    return std::make_shared<SpanSet>(std::move(newVec), false);
 }
 
 }  // namespace
@@ -186,6 +500,7 @@ SpanSet::SpanSet(lsst::geom::Box2I const& box) : _bbox(box), _area(box.getArea()
     for (int i = beginY; i < _bbox.getEndY(); ++i) {
         _spanVector.emplace_back(i, beginX, maxX);
     }
+    _chargeMemory();
 }
 
 // Construct a SpanSet from a std vector by copying
@@ -277,6 +592,12 @@ void SpanSet::_initialize() {
     }
     _bbox = lsst::geom::Box2I(lsst::geom::Point2I(minX, _spanVector.front().getY()),
                               lsst::geom::Point2I(maxX, _spanVector.back().getY()));
+    _chargeMemory();
+}
+
+void SpanSet::_chargeMemory() {
+    static math::MemoryCounter& counter = math::getMemoryCounter("geom.SpanSet");
+    _memoryCharge = math::MemoryCharge(counter, _spanVector.capacity() * sizeof(Span));
 }
 
 // Getter for the area property
@@ -285,125 +606,118 @@ std::size_t SpanSet::getArea() const { return _area; }
 // Getter for the bounding box of the SpanSet
 lsst::geom::Box2I SpanSet::getBBox() const { return _bbox; }
 
-/* Here is a description of how the _makeLabels and _label function works. In the
-   _makeLabels function, a vector is created with the same number of elements as
-   spans in the SpanSet. This vector will contain the label for each Span in the
-   SpanSet. These labels correspond to which connected region the span falls in.
-   If the whole SpanSet is connected than there will only be one region and every
-   Span will be labeled with a 1. If there are two regions (i.e. there are points
-   in between not contained in the SpanSet) then Some of the Spans will be labeled
-   1, and the rest labeled 2. _makeLabels also sorts each of the Spans in the
-   current span into an unordered map that is indexed by the y position of each
-   span. This allows efficient lookups of corresponding rows.
-
-   The function loops over all the Spans in the Spanset. If the Span has not been
-   labeled, the _label function is called, with the current span, the vector
-   containing the labels, the label for the current region under consideration,
-   and the indexed map of Spans.
-
-   The _label function will then loop over all Spans in the SpanSet looking for
-   rows adjacent to the currently being labeled Span which overlap in the x
-   dimension and have not yet been labeled, and mark them with the current label,
-   and recursively call the _label function with the adjacent row as the new Span
-   under consideration. This results in all Spans which overlap each other in x
-   being labeled with the current label.
-
-   Once _label reaches the end of Spans which meet it's criteria, control falls
-   back to the _makeLabels function and the current label is incremented. The
-   function then moves onto the next Span in the SpanSet which has not been
-   labeled. If all spans were labeled in the recursive call the loop falls to the
-   end, and the label vector and one past the last label number (number of labels +1)
-   are returned to the caller. If instead _makeLabels finds a Span that has not
-   been labeled, the next label is assigned and the process is repeated until
-   all Spans have been labeled.
+/* Connected components are found with a union-find forest over the spans, sorted by row and then
+ * column. Spans in adjacent rows whose columns overlap are joined; each set's root is its first
+ * span. Bands of rows are joined concurrently, each band touching only its own spans, and then
+ * the rows on either side of each band boundary are joined serially.
  */
 
-void SpanSet::_label(
-        Span const& spn, std::vector<std::size_t>& labelVector, std::size_t currentLabel,
-        std::unordered_map<int, std::vector<std::pair<std::size_t, const Span*>>>& sortMap) const {
-    auto currentIndex = spn.getY();
-    if (currentIndex > 0) {
-        // loop over the prevous row
-        for (auto const& tup : sortMap[currentIndex - 1]) {
-            if (!labelVector[tup.first] && spansOverlap(spn, *(tup.second), false)) {
-                labelVector[tup.first] = currentLabel;
-                _label(*(tup.second), labelVector, currentLabel, sortMap);
-            }
+bool SpanSet::isContiguous() const {
+    std::vector<Span> spans;
+    std::vector<std::size_t> offsets;
+    split(spans, offsets);
+    return offsets.size() <= 2;
+}
+
+void SpanSet::split(std::vector<Span>& spans, std::vector<std::size_t>& offsets, int numThreads) const {
+    spans.clear();
+    offsets.assign(1, 0);
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    std::size_t const n = _spanVector.size();
+    if (n == 0) {
+        return;
+    }
+    // Unnormalized SpanSets need not be sorted; if not, sort a copy and remember where each span was
+    std::vector<Span> sortedStorage;
+    std::vector<std::size_t> order;
+    if (!std::is_sorted(_spanVector.begin(), _spanVector.end())) {
+        order.resize(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(),
+                  [this](std::size_t a, std::size_t b) { return _spanVector[a] < _spanVector[b]; });
+        sortedStorage.reserve(n);
+        for (std::size_t i : order) {
+            sortedStorage.push_back(_spanVector[i]);
         }
     }
-    if (currentIndex <= _spanVector.back().getY() - 1) {
-        // loop over the next row
-        for (auto& tup : sortMap[currentIndex + 1]) {
-            if (!labelVector[tup.first] && spansOverlap(spn, *(tup.second), false)) {
-                labelVector[tup.first] = currentLabel;
-                _label(*(tup.second), labelVector, currentLabel, sortMap);
-            }
+    std::vector<Span> const& sorted = order.empty() ? _spanVector : sortedStorage;
+
+    std::vector<std::size_t> rowStarts;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (i == 0 || sorted[i].getY() != sorted[i - 1].getY()) {
+            rowStarts.push_back(i);
         }
     }
-}
+    rowStarts.push_back(n);
+    int const nRows = static_cast<int>(rowStarts.size()) - 1;
+
+    std::vector<std::size_t> parent(n);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto joinWithNextRow = [&](int row) {
+        if (sorted[rowStarts[row + 1]].getY() == sorted[rowStarts[row]].getY() + 1) {
+            joinRows(sorted, rowStarts[row], rowStarts[row + 1], rowStarts[row + 2], parent);
+        }
+    };
+    auto const bands = math::detail::splitRange(0, nRows, nThreads);
+    math::detail::parallelFor(static_cast<int>(bands.size()), nThreads, [&](int i) {
+        for (int row = bands[i].first; row + 1 < bands[i].second; ++row) {
+            joinWithNextRow(row);
+        }
+    });
+    for (std::size_t i = 0; i + 1 < bands.size(); ++i) {
+        joinWithNextRow(bands[i].second - 1);
+    }
 
-std::pair<std::vector<std::size_t>, std::size_t> SpanSet::_makeLabels() const {
-    std::vector<std::size_t> labelVector(_spanVector.size(), 0);
-    std::size_t currentLabel = 1;
-    std::size_t index = 0;
-    // Create a sorted array of arrays
-    std::unordered_map<int, std::vector<std::pair<std::size_t, const Span*>>> sortMap;
-    std::size_t tempIndex = 0;
-    for (auto const& spn : _spanVector) {
-        sortMap[spn.getY()].push_back(std::make_pair(tempIndex, &spn));
-        tempIndex++;
-    }
-    for (auto const& currentSpan : _spanVector) {
-        if (!labelVector[index]) {
-            labelVector[index] = currentLabel;
-            _label(currentSpan, labelVector, currentLabel, sortMap);
-            /* At this point we have recursed enough to reach all of the connected
-             * region, and should increment the label such that any spans not
-             * labeled in the first loop will get a new value. If all of the spans
-             * were connected in the first pass, the rest of this loop will just
-             * fall though.
-             */
-            ++currentLabel;
+    // Number the components in order of their first span in this SpanSet, as they always have been
+    std::vector<std::size_t> roots;
+    std::vector<std::size_t> firstIndex(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::size_t const root = findRoot(parent, i);
+        parent[i] = root;
+        std::size_t const index = order.empty() ? i : order[i];
+        if (root == i) {
+            roots.push_back(i);
+            firstIndex[i] = index;
+        } else {
+            firstIndex[root] = std::min(firstIndex[root], index);
         }
-        ++index;
     }
-    return std::pair<std::vector<std::size_t>, std::size_t>(labelVector, currentLabel);
+    if (!order.empty()) {
+        std::sort(roots.begin(), roots.end(),
+                  [&firstIndex](std::size_t a, std::size_t b) { return firstIndex[a] < firstIndex[b]; });
+    }
+    // Every parent is now a root; reuse firstIndex to hold the next free slot of each root's piece
+    std::vector<std::size_t> counts(n, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        ++counts[parent[i]];
+    }
+    offsets.reserve(roots.size() + 1);
+    for (std::size_t root : roots) {
+        firstIndex[root] = offsets.back();
+        offsets.push_back(offsets.back() + counts[root]);
+    }
+    spans.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        spans[firstIndex[parent[i]]++] = sorted[i];
+    }
 }
 
-bool SpanSet::isContiguous() const {
-    auto labeledPair = _makeLabels();
-    // Here we want to check if there is only one label. Since _makeLabels always increments
-    // at the end of each loop, we need to compare against the number 2. I.e. if everything
-    // gets labeled 1, the label counter will increment to 2, and the if statement will always
-    // be false and _makeLabels will fall through to the end and return to here.
-    return labeledPair.second <= 2;
-}
-
-std::vector<std::shared_ptr<SpanSet>> SpanSet::split() const {
-    auto labeledPair = _makeLabels();
-    auto labels = labeledPair.first;
-    auto numberOfLabels = labeledPair.second;
+std::vector<std::shared_ptr<SpanSet>> SpanSet::split(int numThreads) const {
+    std::vector<Span> spans;
+    std::vector<std::size_t> offsets;
+    split(spans, offsets, numThreads);
     std::vector<std::shared_ptr<SpanSet>> subRegions;
-    // As the number of labels is known, the number of SpanSets to be created is also known
-    // make a vector of vectors to hold the Spans which will correspond to each SpanSet
-    std::vector<std::vector<Span>> subSpanLists(numberOfLabels - 1);
-
-    // if numberOfLabels is 1, that means a null SpanSet is being operated on,
-    // and we should return like
-    if (numberOfLabels == 1) {
+    // A null SpanSet splits into one null SpanSet
+    if (offsets.size() == 1) {
         subRegions.push_back(std::make_shared<SpanSet>());
         return subRegions;
     }
-    subRegions.reserve(numberOfLabels - 1);
-
-    // loop over the current SpanSet's spans sorting each of the spans according to the label
-    // that was assigned
-    for (std::size_t i = 0; i < _spanVector.size(); ++i) {
-        subSpanLists[labels[i] - 1].push_back(_spanVector[i]);
-    }
-    // Transform each of the vectors of Spans into a SpanSet
-    for (std::size_t i = 0; i < numberOfLabels - 1; ++i) {
-        subRegions.push_back(std::make_shared<SpanSet>(subSpanLists[i]));
+    // The pieces of a normalized SpanSet are normalized already
+    bool const normalize = !isNormalized(_spanVector.begin(), _spanVector.end());
+    subRegions.reserve(offsets.size() - 1);
+    for (std::size_t i = 0; i + 1 < offsets.size(); ++i) {
+        subRegions.push_back(std::make_shared<SpanSet>(
+                std::vector<Span>(spans.begin() + offsets[i], spans.begin() + offsets[i + 1]), normalize));
     }
     return subRegions;
 }
@@ -413,7 +727,7 @@ std::shared_ptr<SpanSet> SpanSet::findEdgePixels() const {
     setMask(tempMask, static_cast<image::MaskPixel>(1));
     auto erodedSpanSet = eroded(1, Stencil::CIRCLE);
     erodedSpanSet->clearMask(tempMask, static_cast<image::MaskPixel>(1));
-    return SpanSet::fromMask(tempMask);
+    return SpanSet::fromMask(tempMask, static_cast<image::MaskPixel>(1));
 }
 
 std::shared_ptr<SpanSet> SpanSet::shiftedBy(int x, int y) const {
@@ -541,138 +855,61 @@ ellipses::Quadrupole SpanSet::computeShape() const {
     return ellipses::Quadrupole(sumxx / _area, sumyy / _area, sumxy / _area);
 }
 
-std::shared_ptr<SpanSet> SpanSet::dilated(int r, Stencil s) const {
+std::shared_ptr<SpanSet> SpanSet::dilated(int r, Stencil s, int numThreads) const {
     // Return a dilated SpanSet made with the given stencil, by creating a SpanSet
     // from the stencil and forwarding to the appropriate overloaded method
     std::shared_ptr<SpanSet> stencilToSpanSet = fromShape(r, s);
-    return dilated(*stencilToSpanSet);
+    return dilated(*stencilToSpanSet, numThreads);
 }
 
-std::shared_ptr<SpanSet> SpanSet::dilated(SpanSet const& other) const {
+std::shared_ptr<SpanSet> SpanSet::dilated(SpanSet const& other, int numThreads) const {
     // Handle a null SpanSet nothing should be dilated
     if (other.size() == 0) {
         return std::make_shared<SpanSet>(_spanVector.begin(), _spanVector.end(), false);
     }
+    if (size() == 0) {
+        return std::make_shared<SpanSet>();
+    }
 
-    // Return a dilated Spanset by the given SpanSet
-    std::vector<Span> tempVec;
-
-    for (auto const& spn : _spanVector) {
-        for (auto const& otherSpn : other) {
-            int const xmin = spn.getMinX() + otherSpn.getMinX();
-            int const xmax = spn.getMaxX() + otherSpn.getMaxX();
-            int const yval = spn.getY() + otherSpn.getY();
-            tempVec.emplace_back(yval, xmin, xmax);
-        }
+    // The row index needs spans sorted by row, which SpanSets built without normalization may not be
+    std::unique_ptr<SpanSet> sorted;
+    if (!std::is_sorted(_spanVector.begin(), _spanVector.end())) {
+        sorted = std::make_unique<SpanSet>(_spanVector);
     }
-    // Allow constructor to handle merging adjacent and overlapping spans
-    return std::make_shared<SpanSet>(std::move(tempVec));
+    RowIndex const index(sorted ? sorted->_spanVector : _spanVector);
+    std::vector<Span> const stencil(other.begin(), other.end());
+    auto const stencilY = getYRange(other);
+    return sweepRows(index.getMinY() + stencilY.first, index.getMaxY() + stencilY.second, numThreads,
+                     [&index, &stencil](int yBegin, int yEnd, std::vector<Span>& result) {
+                         dilateRows(index, stencil, yBegin, yEnd, result);
+                     });
 }
 
-std::shared_ptr<SpanSet> SpanSet::eroded(int r, Stencil s) const {
+std::shared_ptr<SpanSet> SpanSet::eroded(int r, Stencil s, int numThreads) const {
     // Return an eroded SpanSet made with the given stencil, by creating a SpanSet
     // from the stencil and forwarding to the appropriate overloaded method
     std::shared_ptr<SpanSet> stencilToSpanSet = fromShape(r, s);
-    return eroded(*stencilToSpanSet);
+    return eroded(*stencilToSpanSet, numThreads);
 }
 
-std::shared_ptr<SpanSet> SpanSet::eroded(SpanSet const& other) const {
+std::shared_ptr<SpanSet> SpanSet::eroded(SpanSet const& other, int numThreads) const {
     // Handle a null SpanSet nothing should be eroded
     if (other.size() == 0 || this->size() == 0) {
         return std::make_shared<SpanSet>(_spanVector.begin(), _spanVector.end(), false);
     }
 
-    // Return a SpanSet eroded by the given SpanSet
-    std::vector<Span> tempVec;
-
-    // Calculate all possible primary runs.
-    std::vector<PrimaryRun> primaryRuns;
-    for (auto const& spn : _spanVector) {
-        int m = 0;
-        for (auto const& otherSpn : other) {
-            if ((otherSpn.getMaxX() - otherSpn.getMinX()) <= (spn.getMaxX() - spn.getMinX())) {
-                int xmin = spn.getMinX() - otherSpn.getMinX();
-                int xmax = spn.getMaxX() - otherSpn.getMaxX();
-                int y = spn.getY() - otherSpn.getY();
-                primaryRuns.push_back(PrimaryRun({m, y, xmin, xmax}));
-            }
-            ++m;
-        }
+    // Erosion needs each run of pixels to be a single span, so normalize if that can't be assumed
+    std::unique_ptr<SpanSet> normalized;
+    if (!isNormalized(_spanVector.begin(), _spanVector.end())) {
+        normalized = std::make_unique<SpanSet>(_spanVector);
     }
-
-    // Iterate over the primary runs in such a way that we consider all values of m
-    // for a given y, then all m for y+1 etc.
-    std::sort(primaryRuns.begin(), primaryRuns.end(), comparePrimaryRun);
-
-    for (int y = primaryRuns.front().y; y <= primaryRuns.back().y; ++y) {
-        auto yRange = std::equal_range(primaryRuns.begin(), primaryRuns.end(), y, ComparePrimaryRunY());
-
-        /* Discard runs for any value of y for which we find fewer groups than M,
-         * the total Y range of the structuring element. This is step 3.1 of the
-         * Kim et al. algorithm.
-         */
-        // Plus one because end points are inclusive
-        auto otherYRange = other.back().getY() - other.front().getY() + 1;
-        if (std::distance(yRange.first, yRange.second) < otherYRange) {
-            continue;
-        }
-
-        /* "good" runs are those which are covered by each value of m, ie by each
-         * row in the structuring element. Our algorithm will consider each value
-         * of m in turn, gradually whittling down the list of good runs, then
-         * finally convert the remainder into Spans.
-         */
-        std::list<PrimaryRun> goodRuns;
-
-        for (int m = 0; m < otherYRange; ++m) {
-            auto mRange = std::equal_range(yRange.first, yRange.second, m, ComparePrimaryRunM());
-            if ((mRange.first == mRange.second)) {
-                // If a particular m is missing, we known that this y contains
-                // no good runs; this is equivalent to Kim et al. step 3.2.
-                goodRuns.clear();
-            } else {
-                // Consolidate all primary runs at this m so that they don't overlap.
-                std::list<PrimaryRun> candidateRuns;
-                int startX = mRange.first->xmin;
-                int endX = mRange.first->xmax;
-                for (auto run = mRange.first + 1; run != mRange.second; ++run) {
-                    if (run->xmin > endX) {
-                        // Start of a new run
-                        candidateRuns.push_back(PrimaryRun{m, y, startX, endX});
-                        startX = run->xmin;
-                        endX = run->xmax;
-                    } else {
-                        // Continuation of an existing run
-                        endX = run->xmax;
-                    }
-                }
-                candidateRuns.push_back(PrimaryRun{m, y, startX, endX});
-
-                // Otherwise, calculate the intersection of candidate runs at
-                // this m with good runs from all previous m.
-                if (m == 0) {
-                    // For m = 0 we have nothing to compare to; all runs are accepted
-                    std::swap(goodRuns, candidateRuns);
-                } else {
-                    std::list<PrimaryRun> newlist;
-                    for (auto& good : goodRuns) {
-                        for (auto& cand : candidateRuns) {
-                            int start = std::max(good.xmin, cand.xmin);
-                            int end = std::min(good.xmax, cand.xmax);
-                            if (end >= start) {
-                                newlist.push_back(PrimaryRun({m, y, start, end}));
-                            }
-                        }
-                    }
-                    std::swap(newlist, goodRuns);
-                }
-            }
-        }
-        for (auto& run : goodRuns) {
-            tempVec.emplace_back(run.y, run.xmin, run.xmax);
-        }
-    }
-    return std::make_shared<SpanSet>(std::move(tempVec));
+    RowIndex const index(normalized ? normalized->_spanVector : _spanVector);
+    std::vector<Span> const stencil(other.begin(), other.end());
+    auto const stencilY = getYRange(other);
+    return sweepRows(index.getMinY() - stencilY.first, index.getMaxY() - stencilY.second, numThreads,
+                     [&index, &stencil](int yBegin, int yEnd, std::vector<Span>& result) {
+                         erodeRows(index, stencil, yBegin, yEnd, result);
+                     });
 }
 
 bool SpanSet::operator==(SpanSet const& other) const {
@@ -714,131 +951,89 @@ std::shared_ptr<SpanSet> SpanSet::fromShape(int r, Stencil s, lsst::geom::Point2
 
 std::shared_ptr<SpanSet> SpanSet::fromShape(ellipses::Ellipse const& ellipse) {
     ellipses::PixelRegion pr(ellipse);
-    return std::make_shared<SpanSet>(pr.begin(), pr.end());
+    // PixelRegion spans are sorted, one per row, so they are already normalized
+    return std::make_shared<SpanSet>(pr.begin(), pr.end(), false);
+}
+
+std::shared_ptr<SpanSet> SpanSet::fromShape(ellipses::Ellipse const& ellipse,
+                                            ellipses::PixelRegionCache& cache) {
+    ellipses::PixelRegion pr = cache.makePixelRegion(ellipse);
+    return std::make_shared<SpanSet>(pr.begin(), pr.end(), false);
 }
 
 std::shared_ptr<SpanSet> SpanSet::intersect(SpanSet const& other) const {
-    // Check if the bounding boxes overlap, if not return null SpanSet
+    std::vector<Span> tempVec;
+    intersect(other, tempVec);
+    return std::make_shared<SpanSet>(std::move(tempVec), false);
+}
+
+void SpanSet::intersect(SpanSet const& other, std::vector<Span>& output) const {
+    output.clear();
+    // Check if the bounding boxes overlap, if not the intersection is empty
     if (!_bbox.overlaps(other.getBBox())) {
-        return std::make_shared<SpanSet>();
-    }
-    // Handel intersecting a SpanSet with itself
-    if (other == *this) {
-        return std::make_shared<SpanSet>(this->_spanVector);
+        return;
     }
-    std::vector<Span> tempVec;
-    auto otherBeginIter = other.begin();
-    for (auto const& spn : _spanVector) {
-        while(otherBeginIter != other.end() && otherBeginIter->getY() < spn.getY()) {
-            ++otherBeginIter;
-        }
-        for (auto otherIter = otherBeginIter; otherIter != other.end() && otherIter->getY() <= spn.getY(); ++otherIter) {
-            if (spansOverlap(spn, *otherIter)) {
-                auto newMin = std::max(spn.getMinX(), otherIter->getMinX());
-                auto newMax = std::min(spn.getMaxX(), otherIter->getMaxX());
-                auto newSpan = Span(spn.getY(), newMin, newMax);
-                tempVec.push_back(newSpan);
-            }
+    std::vector<Span> thisStorage, otherStorage;
+    auto const a = getNormalizedSpans(*this, thisStorage);
+    auto const b = getNormalizedSpans(other, otherStorage);
+    intersectSpans(a.first, a.second, b.first, b.second, output);
+}
+
+std::vector<std::shared_ptr<SpanSet>> SpanSet::intersectEach(
+        std::vector<std::shared_ptr<SpanSet>> const& others, int numThreads) const {
+    std::vector<std::shared_ptr<SpanSet>> result(others.size());
+    math::detail::parallelFor(static_cast<int>(others.size()), numThreads,
+                              [this, &others, &result](int i) { result[i] = intersect(*others[i]); });
+    return result;
+}
+
+std::vector<std::shared_ptr<SpanSet>> SpanSet::intersectEach(std::vector<lsst::geom::Box2I> const& boxes,
+                                                             int numThreads) const {
+    std::vector<Span> storage;
+    auto const spans = getNormalizedSpans(*this, storage);
+    std::vector<std::shared_ptr<SpanSet>> result(boxes.size());
+    math::detail::parallelFor(static_cast<int>(boxes.size()), numThreads, [&](int i) {
+        std::vector<Span> tempVec;
+        if (_bbox.overlaps(boxes[i])) {
+            clipSpans(spans.first, spans.second, boxes[i], tempVec);
         }
-    }
-    return std::make_shared<SpanSet>(std::move(tempVec));
+        result[i] = std::make_shared<SpanSet>(std::move(tempVec), false);
+    });
+    return result;
 }
 
 std::shared_ptr<SpanSet> SpanSet::intersectNot(SpanSet const& other) const {
-    // Check if the bounding boxes overlap, if not simply return a copy of this
-    if (!getBBox().overlaps(other.getBBox())) {
-        return std::make_shared<SpanSet>(this->begin(), this->end());
-    }
-    // Handle calling a SpanSet's intersectNot with itself as an argument
-    if (other == *this) {
-        return std::make_shared<SpanSet>();
-    }
-    /* This function must find all the areas in this and not in other. These SpanSets
-     * may be overlapping with this less than other a1|    b1|   a2|    b2|,
-     * with this greater than other b1|    a1|     b2|    a2|,
-     * with this containing other a1|    b1|     b2|     a2|,
-     * or with other containing this  b1|    a1|    a2|   b2|
-     */
     std::vector<Span> tempVec;
-    auto otherBeginIter = other.begin();
-    for (auto const& spn : _spanVector) {
-        bool added = false;
-        bool spanStarted = false;
-        int spanBottom = 0;
-        while(otherBeginIter != other.end() && otherBeginIter->getY() < spn.getY()) {
-            ++otherBeginIter;
-        }
-        for (auto otherIter = otherBeginIter; otherIter != other.end() && otherIter->getY() <= spn.getY(); ++otherIter) {
-            if (spansOverlap(spn, *otherIter)) {
-                added = true;
-                /* To handle one span containing the other, the spans will be added
-                 * piecewise, and let the SpanSet constructor normalize spans which
-                 * end up contiguous. In the case where this is contained in other,
-                 * these statements will all be false, and nothing will be added,
-                 * which is the expected behavior.
-                 *
-                 * Intersection with the logical not of another SpanSet requires that the Intersection
-                 * be tested against the condition that multiple Spans may be present in the other
-                 * SpanSet at the same Y coordinate. I.E. If one row in *this would contain two
-                 * disconnected Spans in other, the result should be three new Spans.
-                 */
-                // Check if a span is in the process of being created
-                if (!spanStarted) {
-                    // If the minimum value of the Span in  *this is less than that of other, add a new Span
-                    if (spn.getMinX() < otherIter->getMinX()) {
-                        tempVec.emplace_back(spn.getY(), spn.getMinX(), otherIter->getMinX() - 1);
-                    }
-                    // Conversely if the maximum value of the Span in *this is greater than that of other,
-                    // Start a new span, and record what the minimum value of that span should be. This is
-                    // because SpanSets can be disconnected, and the function must check if there are any
-                    // additional Spans which fall in the same row
-                    if (spn.getMaxX() > otherIter->getMaxX()) {
-                        spanStarted = true;
-                        spanBottom = otherIter->getMaxX() + 1;
-                    }
-                } else {
-                    // A span is in the process of being created and should be finished and added
-                    tempVec.emplace_back(spn.getY(), spanBottom, std::min(spn.getMaxX(), otherIter->getMinX() - 1));
-                    spanStarted = false;
-                    // Check if the span in *this extends past that of the Span from other, if so
-                    // begin a new Span
-                    if (spn.getMaxX() > otherIter->getMaxX()) {
-                        spanStarted = true;
-                        spanBottom = otherIter->getMaxX() + 1;
-                    }
-                }
-            }
-            if (otherIter->getMaxX() > spn.getMaxX()) {
-                break;
-            }
-        }
-        // Check if a span has been started but not finished, if that is the case that means there are
-        // no further spans on this row to consider and the span should be closed and added
-        if (spanStarted) {
-            tempVec.emplace_back(spn.getY(), spanBottom, spn.getMaxX());
-        }
-        /* If added is still zero, that means it did not overlap any of the spans in other
-         * and should be included in the new span
-         */
-        if (!added) {
-            tempVec.emplace_back(spn);
-        }
+    intersectNot(other, tempVec);
+    return std::make_shared<SpanSet>(std::move(tempVec), false);
+}
+
+void SpanSet::intersectNot(SpanSet const& other, std::vector<Span>& output) const {
+    output.clear();
+    std::vector<Span> thisStorage, otherStorage;
+    auto const a = getNormalizedSpans(*this, thisStorage);
+    // Check if the bounding boxes overlap, if not the result is simply a copy of this
+    if (!getBBox().overlaps(other.getBBox())) {
+        output.assign(a.first, a.second);
+        return;
     }
-    return std::make_shared<SpanSet>(std::move(tempVec));
+    auto const b = getNormalizedSpans(other, otherStorage);
+    subtractSpans(a.first, a.second, b.first, b.second, output);
 }
 
 std::shared_ptr<SpanSet> SpanSet::union_(SpanSet const& other) const {
-    /* Simply include Spans from both SpanSets in a new vector and let the SpanSet
-     * constructor normalize any of the SpanSets which may be contiguous
-     */
-    std::size_t combineSize = size() + other.size();
     std::vector<Span> tempVec;
-    tempVec.reserve(combineSize);
-    // Copy this
-    tempVec.insert(tempVec.end(), _spanVector.begin(), _spanVector.end());
-    // Copy other
-    tempVec.insert(tempVec.end(), other.begin(), other.end());
-    return std::make_shared<SpanSet>(std::move(tempVec));
+    union_(other, tempVec);
+    return std::make_shared<SpanSet>(std::move(tempVec), false);
+}
+
+void SpanSet::union_(SpanSet const& other, std::vector<Span>& output) const {
+    output.clear();
+    output.reserve(size() + other.size());
+    std::vector<Span> thisStorage, otherStorage;
+    auto const a = getNormalizedSpans(*this, thisStorage);
+    auto const b = getNormalizedSpans(other, otherStorage);
+    uniteSpans(a.first, a.second, b.first, b.second, output);
 }
 
 std::shared_ptr<SpanSet> SpanSet::transformedBy(lsst::geom::LinearTransform const& t) const {
@@ -922,6 +1117,125 @@ std::shared_ptr<SpanSet> SpanSet::transformedBy(TransformPoint2ToPoint2 const& t
     return std::make_shared<SpanSet>(std::move(tempVec));
 }
 
+std::vector<std::shared_ptr<SpanSet>> SpanSet::transformEach(
+        std::vector<std::shared_ptr<SpanSet>> const& spanSets, TransformPoint2ToPoint2 const& t,
+        int numThreads) {
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    std::vector<std::shared_ptr<SpanSet>> result(spanSets.size());
+
+    // Transform the bounding box corners of every non-empty SpanSet, and check the transformation as
+    // transformedBy does
+    std::vector<std::size_t> todo;
+    std::vector<lsst::geom::Point2D> fromCorners;
+    for (std::size_t i = 0; i < spanSets.size(); ++i) {
+        if (spanSets[i]->empty()) {
+            result[i] = std::make_shared<SpanSet>();
+            continue;
+        }
+        todo.push_back(i);
+        for (auto const& fc : spanSets[i]->getBBox().getCorners()) {
+            fromCorners.emplace_back(lsst::geom::Point2D(fc));
+        }
+    }
+    if (todo.empty()) {
+        return result;
+    }
+    auto const toCorners = t.applyForward(fromCorners, nThreads);
+    auto const fromToCorners = t.applyInverse(toCorners, nThreads);
+    std::vector<lsst::geom::Box2I> newBoxes(todo.size());
+    for (std::size_t k = 0; k < todo.size(); ++k) {
+        lsst::geom::Box2D newBBoxD;
+        bool valid = true;
+        for (std::size_t c = 4 * k; c < 4 * k + 4; ++c) {
+            if ((std::abs(fromToCorners[c].getX() - fromCorners[c].getX()) > 1.0) ||
+                (std::abs(fromToCorners[c].getY() - fromCorners[c].getY()) > 1.0)) {
+                valid = false;
+            }
+            newBBoxD.include(toCorners[c]);
+        }
+        if (valid) {
+            newBoxes[k] = lsst::geom::Box2I(newBBoxD);
+        } else {
+            result[todo[k]] = std::make_shared<SpanSet>();
+        }
+    }
+
+    // Map the pixels of the new bounding boxes back in batches of SpanSets, limiting the number of
+    // points held at once; a SpanSet whose box alone exceeds the limit is transformed on its own
+    std::size_t const maxPoints = 1u << 22;
+    std::vector<std::size_t> batch;
+    std::vector<std::size_t> batchOffsets;
+    std::vector<lsst::geom::Point2D> newPoints;
+    auto processBatch = [&]() {
+        if (batch.empty()) {
+            return;
+        }
+        auto const oldPoints = newPoints.empty() ? newPoints : t.applyInverse(newPoints, nThreads);
+        math::detail::parallelFor(static_cast<int>(batch.size()), nThreads, [&](int b) {
+            std::size_t const k = batch[b];
+            lsst::geom::Box2I const& box = newBoxes[k];
+            std::vector<Span> storage;
+            auto const spans = getNormalizedSpans(*spanSets[todo[k]], storage);
+            // Spans are sorted by row, then by starting column, and do not overlap
+            auto contains = [&spans](int x, int y) {
+                auto next = std::upper_bound(spans.first, spans.second, std::make_pair(y, x),
+                                             [](std::pair<int, int> const& p, Span const& s) {
+                                                 return p.first < s.getY() ||
+                                                        (p.first == s.getY() && p.second < s.getX0());
+                                             });
+                return next != spans.first && std::prev(next)->getY() == y && std::prev(next)->getX1() >= x;
+            };
+            std::vector<Span> tempVec;
+            auto oldPoint = oldPoints.cbegin() + batchOffsets[b];
+            for (int y = box.getBeginY(); y < box.getEndY(); ++y) {
+                int start = -1;  // Start of the current span, or -1 if not in one
+                for (int x = box.getBeginX(); x < box.getEndX(); ++x, ++oldPoint) {
+                    int const xSource = std::floor(0.5 + oldPoint->getX());
+                    int const ySource = std::floor(0.5 + oldPoint->getY());
+                    if (contains(xSource, ySource)) {
+                        if (start < 0) {
+                            start = x;
+                        }
+                    } else if (start >= 0) {
+                        tempVec.emplace_back(y, start, x - 1);
+                        start = -1;
+                    }
+                }
+                if (start >= 0) {
+                    tempVec.emplace_back(y, start, box.getMaxX());
+                }
+            }
+            result[todo[k]] = std::make_shared<SpanSet>(std::move(tempVec));
+        });
+        batch.clear();
+        batchOffsets.clear();
+        newPoints.clear();
+    };
+    for (std::size_t k = 0; k < todo.size(); ++k) {
+        if (result[todo[k]]) {
+            continue;  // the transformation was not valid
+        }
+        lsst::geom::Box2I const& box = newBoxes[k];
+        std::size_t const area = box.getArea();
+        if (area > maxPoints) {
+            result[todo[k]] = spanSets[todo[k]]->transformedBy(t);
+            continue;
+        }
+        if (newPoints.size() + area > maxPoints) {
+            processBatch();
+        }
+        batch.push_back(k);
+        batchOffsets.push_back(newPoints.size());
+        for (int y = box.getBeginY(); y < box.getEndY(); ++y) {
+            for (int x = box.getBeginX(); x < box.getEndX(); ++x) {
+                newPoints.emplace_back(x, y);
+            }
+        }
+    }
+    processBatch();
+    return result;
+}
+
 template <typename ImageT>
 void SpanSet::setImage(image::Image<ImageT>& image, ImageT val, lsst::geom::Box2I const& region,
                        bool doClip) const {
@@ -979,11 +1293,27 @@ std::shared_ptr<SpanSet> SpanSet::intersectNot(image::Mask<T> const& other, T bi
 
 template <typename T>
 std::shared_ptr<SpanSet> SpanSet::union_(image::Mask<T> const& other, T bitmask) const {
-    auto comparator = [bitmask](T pixelValue) { return (pixelValue & bitmask); };
-    auto spanSetFromMask = fromMask(other, comparator);
+    auto spanSetFromMask = fromMask(other, bitmask);
     return union_(*spanSetFromMask);
 }
 
+template <typename T>
+std::shared_ptr<SpanSet> SpanSet::fromMask(image::Mask<T> const& mask, T bitmask, int numThreads) {
+    // Capture the pixels before starting any threads, which must not copy the array
+    auto const maskArray = mask.getArray();
+    T const* const data = maskArray.getData();
+    std::ptrdiff_t const stride = maskArray.template getStride<0>();
+    int const width = mask.getWidth();
+    int const minX = mask.getX0();
+    int const minY = mask.getY0();
+    return sweepRows(minY, minY + mask.getHeight() - 1, numThreads,
+                     [=](int yBegin, int yEnd, std::vector<Span>& output) {
+                         for (int y = yBegin; y < yEnd; ++y) {
+                             appendMaskRuns(data + (y - minY) * stride, width, bitmask, y, minX, output);
+                         }
+                     });
+}
+
 namespace {
 // Singleton helper class that manages the schema and keys for the persistence of SpanSets
 class SpanSetPersistenceHelper {
@@ -1071,7 +1401,8 @@ void SpanSet::write(OutputArchiveHandle& handle) const {
     template std::shared_ptr<SpanSet> SpanSet::intersect<T>(image::Mask<T> const& other, T bitmask) const; \
     template std::shared_ptr<SpanSet> SpanSet::intersectNot<T>(image::Mask<T> const& other, T bitmask)     \
             const;                                                                                         \
-    template std::shared_ptr<SpanSet> SpanSet::union_<T>(image::Mask<T> const& other, T bitmask) const;
+    template std::shared_ptr<SpanSet> SpanSet::union_<T>(image::Mask<T> const& other, T bitmask) const;    \
+    template std::shared_ptr<SpanSet> SpanSet::fromMask<T>(image::Mask<T> const& mask, T bitmask, int);
 
 INSTANTIATE_IMAGE_TYPE(std::uint16_t);
 INSTANTIATE_IMAGE_TYPE(std::uint64_t);
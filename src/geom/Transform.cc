@@ -27,6 +27,7 @@
 
 #include "astshim.h"
 #include "lsst/afw/formatters/Utils.h"
+#include "lsst/afw/geom/detail/astEncoding.h"
 #include "lsst/afw/geom/detail/transformUtils.h"
 #include "lsst/afw/geom/Endpoint.h"
 #include "lsst/afw/geom/Transform.h"
@@ -84,9 +85,9 @@ typename ToEndpoint::Point Transform<FromEndpoint, ToEndpoint>::applyForward(
 
 template <class FromEndpoint, class ToEndpoint>
 typename ToEndpoint::Array Transform<FromEndpoint, ToEndpoint>::applyForward(
-        typename FromEndpoint::Array const &array) const {
+        typename FromEndpoint::Array const &array, int numThreads) const {
     auto const rawFromData = _fromEndpoint.dataFromArray(array);
-    auto rawToData = _mapping->applyForward(rawFromData);
+    auto rawToData = detail::applyMapping(*_mapping, rawFromData, true, numThreads);
     return _toEndpoint.arrayFromData(rawToData);
 }
 
@@ -100,9 +101,9 @@ typename FromEndpoint::Point Transform<FromEndpoint, ToEndpoint>::applyInverse(
 
 template <class FromEndpoint, class ToEndpoint>
 typename FromEndpoint::Array Transform<FromEndpoint, ToEndpoint>::applyInverse(
-        typename ToEndpoint::Array const &array) const {
+        typename ToEndpoint::Array const &array, int numThreads) const {
     auto const rawFromData = _toEndpoint.dataFromArray(array);
-    auto rawToData = _mapping->applyInverse(rawFromData);
+    auto rawToData = detail::applyMapping(*_mapping, rawFromData, false, numThreads);
     return _fromEndpoint.arrayFromData(rawToData);
 }
 
@@ -217,6 +218,26 @@ private:
                       "bytes", "a bytestring containing the output of Transform.writeString", "")) {}
 };
 
+// Schema and Key of the compact form: a single record whose only field holds the output of
+// Transform::writeString encoded by detail::encodeAstText
+class CompactTransformPersistenceHelper {
+public:
+    table::Schema schema;
+    table::Key<table::Array<std::uint8_t>> bytes;
+
+    static CompactTransformPersistenceHelper const &get() {
+        static CompactTransformPersistenceHelper const instance;
+        return instance;
+    }
+
+private:
+    CompactTransformPersistenceHelper()
+            : schema(),
+              bytes(schema.addField<table::Array<std::uint8_t>>(
+                      "compactBytes", "the output of Transform.writeString, encoded by detail::encodeAstText",
+                      "")) {}
+};
+
 template <typename FromEndpoint, typename ToEndpoint>
 class TransformFactory : public table::io::PersistableFactory {
 public:
@@ -225,10 +246,16 @@ public:
     std::shared_ptr<table::io::Persistable> read(InputArchive const &archive,
                                                  CatalogVector const &catalogs) const override {
         auto const &keys = TransformPersistenceHelper::get();
+        auto const &compactKeys = CompactTransformPersistenceHelper::get();
         LSST_ARCHIVE_ASSERT(catalogs.size() == 1u);
         LSST_ARCHIVE_ASSERT(catalogs.front().size() == 1u);
-        LSST_ARCHIVE_ASSERT(catalogs.front().getSchema() == keys.schema);
         auto const &record = catalogs.front().front();
+        if (catalogs.front().getSchema() == compactKeys.schema) {
+            return Transform<FromEndpoint, ToEndpoint>::readString(
+                    detail::decodeAstText(record.get(compactKeys.bytes)));
+        }
+        // Written before the compact form was introduced
+        LSST_ARCHIVE_ASSERT(catalogs.front().getSchema() == keys.schema);
         std::string stringRep = formatters::bytesToString(record.get(keys.bytes));
         return Transform<FromEndpoint, ToEndpoint>::readString(stringRep);
     }
@@ -238,10 +265,10 @@ public:
 
 template <class FromEndpoint, class ToEndpoint>
 void Transform<FromEndpoint, ToEndpoint>::write(OutputArchiveHandle &handle) const {
-    auto const &keys = TransformPersistenceHelper::get();
+    auto const &keys = CompactTransformPersistenceHelper::get();
     table::BaseCatalog cat = handle.makeCatalog(keys.schema);
     std::shared_ptr<table::BaseRecord> record = cat.addNew();
-    record->set(keys.bytes, formatters::stringToBytes(writeString()));
+    record->set(keys.bytes, detail::encodeAstText(writeString()));
     handle.saveCatalog(cat);
 }
 
@@ -0,0 +1,181 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <string>
+
+#include "Eigen/LU"
+
+#include "lsst/geom/Angle.h"
+#include "lsst/afw/geom/wcsUtils.h"
+#include "lsst/afw/geom/detail/TanSipEvaluator.h"
+
+namespace lsst {
+namespace afw {
+namespace geom {
+namespace detail {
+
+namespace {
+
+std::string getTrimmedString(daf::base::PropertySet const &metadata, std::string const &name) {
+    std::string value = metadata.getAsString(name);
+    value.erase(value.find_last_not_of(' ') + 1);
+    return value;
+}
+
+// Sum of matrix(i, j) u^i v^j
+double evaluateSip(Eigen::MatrixXd const &matrix, double u, double v) noexcept {
+    double sum = 0.0;
+    for (Eigen::Index i = matrix.rows() - 1; i >= 0; --i) {
+        double row = 0.0;
+        for (Eigen::Index j = matrix.cols() - 1; j >= 0; --j) {
+            row = row * v + matrix(i, j);
+        }
+        sum = sum * u + row;
+    }
+    return sum;
+}
+
+}  // namespace
+
+std::shared_ptr<TanSipEvaluator const> TanSipEvaluator::make(daf::base::PropertySet const &metadata) {
+    if (!metadata.exists("CTYPE1") || !metadata.exists("CTYPE2")) {
+        return nullptr;
+    }
+    std::string const ctype1 = getTrimmedString(metadata, "CTYPE1");
+    std::string const ctype2 = getTrimmedString(metadata, "CTYPE2");
+    bool const isSip = ctype1 == "RA---TAN-SIP" && ctype2 == "DEC--TAN-SIP";
+    if (!isSip && !(ctype1 == "RA---TAN" && ctype2 == "DEC--TAN")) {
+        return nullptr;
+    }
+    for (auto const &name : metadata.names(false)) {
+        // PV terms would add a distortion we do not evaluate, and PC or CDELT a second form of the matrix
+        if (name.compare(0, 2, "PV") == 0 || name.compare(0, 2, "PC") == 0 ||
+            name.compare(0, 5, "CDELT") == 0) {
+            return nullptr;
+        }
+    }
+    for (auto const &name : {"CUNIT1", "CUNIT2"}) {
+        if (metadata.exists(name) && getTrimmedString(metadata, name) != "deg") {
+            return nullptr;
+        }
+    }
+    if (metadata.exists("LONPOLE") && metadata.getAsDouble("LONPOLE") != 180.0) {
+        return nullptr;
+    }
+    for (auto const &name : {"CRPIX1", "CRPIX2", "CRVAL1", "CRVAL2", "CD1_1", "CD1_2", "CD2_1", "CD2_2"}) {
+        if (!metadata.exists(name)) {
+            return nullptr;
+        }
+    }
+    if (isSip && !(hasSipMatrix(metadata, "A") && hasSipMatrix(metadata, "B"))) {
+        return nullptr;
+    }
+
+    std::shared_ptr<TanSipEvaluator> evaluator(new TanSipEvaluator());
+    evaluator->_crpix[0] = metadata.getAsDouble("CRPIX1") - 1;
+    evaluator->_crpix[1] = metadata.getAsDouble("CRPIX2") - 1;
+    double const degToRad = lsst::geom::PI / 180.0;
+    evaluator->_cd << metadata.getAsDouble("CD1_1"), metadata.getAsDouble("CD1_2"),
+            metadata.getAsDouble("CD2_1"), metadata.getAsDouble("CD2_2");
+    evaluator->_cd *= degToRad;
+    if (evaluator->_cd.determinant() == 0.0) {
+        return nullptr;
+    }
+    evaluator->_cdInverse = evaluator->_cd.inverse();
+    evaluator->_ra0 = metadata.getAsDouble("CRVAL1") * degToRad;
+    double const dec0 = metadata.getAsDouble("CRVAL2") * degToRad;
+    evaluator->_sinDec0 = std::sin(dec0);
+    evaluator->_cosDec0 = std::cos(dec0);
+    evaluator->_hasInverse = true;
+    if (isSip) {
+        evaluator->_a = getSipMatrixFromMetadata(metadata, "A");
+        evaluator->_b = getSipMatrixFromMetadata(metadata, "B");
+        if (hasSipMatrix(metadata, "AP") && hasSipMatrix(metadata, "BP")) {
+            evaluator->_ap = getSipMatrixFromMetadata(metadata, "AP");
+            evaluator->_bp = getSipMatrixFromMetadata(metadata, "BP");
+        } else {
+            evaluator->_hasInverse = false;
+        }
+    }
+    return evaluator;
+}
+
+bool TanSipEvaluator::pixelToSky(double x, double y, double &ra, double &dec) const noexcept {
+    if (!std::isfinite(x) || !std::isfinite(y)) {
+        return false;
+    }
+    double u = x - _crpix[0];
+    double v = y - _crpix[1];
+    if (_a.size() > 0) {
+        double const du = evaluateSip(_a, u, v);
+        double const dv = evaluateSip(_b, u, v);
+        u += du;
+        v += dv;
+    }
+    // Gnomonic deprojection of the intermediate world coordinates, with the native pole at 180 degrees
+    double const xi = _cd(0, 0) * u + _cd(0, 1) * v;
+    double const eta = _cd(1, 0) * u + _cd(1, 1) * v;
+    double const denom = _cosDec0 - eta * _sinDec0;
+    ra = _ra0 + std::atan2(xi, denom);
+    dec = std::atan2(_sinDec0 + eta * _cosDec0, std::hypot(xi, denom));
+    ra = std::fmod(ra, lsst::geom::TWOPI);
+    if (ra < 0) {
+        ra += lsst::geom::TWOPI;
+    }
+    return true;
+}
+
+bool TanSipEvaluator::skyToPixel(double ra, double dec, double &x, double &y) const noexcept {
+    if (!_hasInverse) {
+        return false;
+    }
+    double const dRa = ra - _ra0;
+    double const sinDec = std::sin(dec);
+    double const cosDec = std::cos(dec);
+    double const cosDRa = std::cos(dRa);
+    double const denom = sinDec * _sinDec0 + cosDec * _cosDec0 * cosDRa;
+    // Positions 90 degrees or more from CRVAL are not on the tangent plane
+    if (!(denom > 0.0)) {
+        return false;
+    }
+    double const xi = cosDec * std::sin(dRa) / denom;
+    double const eta = (sinDec * _cosDec0 - cosDec * _sinDec0 * cosDRa) / denom;
+    double u = _cdInverse(0, 0) * xi + _cdInverse(0, 1) * eta;
+    double v = _cdInverse(1, 0) * xi + _cdInverse(1, 1) * eta;
+    if (_ap.size() > 0) {
+        double const du = evaluateSip(_ap, u, v);
+        double const dv = evaluateSip(_bp, u, v);
+        u += du;
+        v += dv;
+    }
+    x = u + _crpix[0];
+    y = v + _crpix[1];
+    return true;
+}
+
+}  // namespace detail
+}  // namespace geom
+}  // namespace afw
+}  // namespace lsst
@@ -0,0 +1,303 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "lsst/afw/table/io/Persistable.h"
+#include "lsst/afw/geom/detail/astEncoding.h"
+
+namespace lsst {
+namespace afw {
+namespace geom {
+namespace detail {
+
+namespace {
+
+// Version of the encoding, written as its first byte
+constexpr std::uint8_t AST_ENCODING_VERSION = 1;
+
+// Each word starts with one of these tags; TAG_DOUBLE + p is a double that "%.<p>g" reproduces
+constexpr std::uint64_t TAG_NEW_STRING = 0;  // followed by the length and the bytes of the word
+constexpr std::uint64_t TAG_STRING = 1;      // followed by the index of an earlier new string
+constexpr std::uint64_t TAG_INTEGER = 2;     // followed by the value as a signed varint
+constexpr std::uint64_t TAG_DOUBLE = 3;      // followed by the 8 bytes of the value, least significant first
+constexpr int MAX_PRECISION = 17;            // enough to reproduce any double
+
+// Lines indented by more than this many spaces are stored whole, which bounds what decoding allocates
+constexpr std::size_t MAX_INDENT = 1 << 12;
+
+// Precisions tried for a floating-point word, most likely first: AST writes doubles with at least
+// DBL_DIG significant digits and adds digits until the value reads back exactly
+constexpr int PRECISIONS[] = {15, 16, 17, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1};
+
+// Unsigned varints are written 7 bits at a time, least significant first, with the high bit of each
+// byte set if more bytes follow; signed values are first zigzag-mapped (0, -1, 1, -2, ...)
+void appendVarint(std::uint64_t value, std::vector<std::uint8_t> &buffer) {
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<std::uint8_t>(value));
+}
+
+void appendSignedVarint(std::int64_t value, std::vector<std::uint8_t> &buffer) {
+    appendVarint((static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63), buffer);
+}
+
+std::uint64_t readVarint(std::uint8_t const *&data, std::uint8_t const *end) {
+    std::uint64_t value = 0;
+    for (int shift = 0; shift < 64 && data != end; shift += 7) {
+        std::uint8_t const byte = *data++;
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    throw LSST_EXCEPT(table::io::MalformedArchiveError, "Truncated or invalid variable-length integer");
+}
+
+std::int64_t readSignedVarint(std::uint8_t const *&data, std::uint8_t const *end) {
+    std::uint64_t const value = readVarint(data, end);
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+// Format a double with "%.<precision>g"
+std::string formatDouble(double value, int precision) {
+    char buffer[32];
+    int const n = std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+    return std::string(buffer, n);
+}
+
+// Return true if a word is the canonical decimal form of an integer that fits a varint comfortably
+bool isInteger(std::string const &word) {
+    std::size_t const start = word[0] == '-' ? 1 : 0;
+    std::size_t const nDigits = word.size() - start;
+    if (nDigits == 0 || nDigits > 18 || (word[start] == '0' && (nDigits > 1 || start == 1))) {
+        return false;
+    }
+    return std::all_of(word.begin() + start, word.end(), [](char c) { return c >= '0' && c <= '9'; });
+}
+
+// Return the precision with which "%g" reproduces a word holding a finite number, or 0 if none does
+int findPrecision(std::string const &word, double &value) {
+    char const first = word[0];
+    if (!(first == '-' || first == '+' || first == '.' || (first >= '0' && first <= '9'))) {
+        return 0;
+    }
+    char *end = nullptr;
+    value = std::strtod(word.c_str(), &end);
+    if (end != word.c_str() + word.size() || !std::isfinite(value)) {
+        return 0;
+    }
+    for (int precision : PRECISIONS) {
+        if (formatDouble(value, precision) == word) {
+            return precision;
+        }
+    }
+    return 0;
+}
+
+class Encoder {
+public:
+    explicit Encoder(std::size_t size) { _buffer.reserve(size / 4 + 16); }
+
+    void appendWord(std::string const &word) {
+        if (!word.empty()) {
+            double value = 0.0;
+            if (isInteger(word)) {
+                appendVarint(TAG_INTEGER, _buffer);
+                appendSignedVarint(std::stoll(word), _buffer);
+                return;
+            } else if (int const precision = findPrecision(word, value)) {
+                appendVarint(TAG_DOUBLE + precision, _buffer);
+                std::uint64_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                for (int i = 0; i < 8; ++i, bits >>= 8) {
+                    _buffer.push_back(static_cast<std::uint8_t>(bits));
+                }
+                return;
+            }
+        }
+        auto const inserted = _strings.emplace(word, _strings.size());
+        if (inserted.second) {
+            appendVarint(TAG_NEW_STRING, _buffer);
+            appendVarint(word.size(), _buffer);
+            _buffer.insert(_buffer.end(), word.begin(), word.end());
+        } else {
+            appendVarint(TAG_STRING, _buffer);
+            appendVarint(inserted.first->second, _buffer);
+        }
+    }
+
+    std::vector<std::uint8_t> &getBuffer() { return _buffer; }
+
+private:
+    std::vector<std::uint8_t> _buffer;
+    std::unordered_map<std::string, std::uint64_t> _strings;
+};
+
+// Split a line (with its indentation removed) at single spaces, or return no words if that cannot be
+// undone by joining them with single spaces
+std::vector<std::string> splitWords(std::string const &line, std::size_t start) {
+    std::vector<std::string> words;
+    while (start < line.size()) {
+        std::size_t stop = line.find(' ', start);
+        if (stop == std::string::npos) {
+            stop = line.size();
+        } else if (stop + 1 == line.size()) {
+            return std::vector<std::string>();  // trailing space
+        }
+        if (stop == start) {
+            return std::vector<std::string>();  // repeated space
+        }
+        words.push_back(line.substr(start, stop - start));
+        start = stop + 1;
+    }
+    return words;
+}
+
+class Decoder {
+public:
+    Decoder(std::uint8_t const *data, std::uint8_t const *end) : _data(data), _end(end) {}
+
+    std::uint64_t readCount(std::size_t minBytesEach) {
+        std::uint64_t const count = readVarint(_data, _end);
+        // Bound the count, so a corrupt one cannot cause a huge allocation or loop
+        LSST_ARCHIVE_ASSERT(count <= static_cast<std::uint64_t>(_end - _data) / minBytesEach);
+        return count;
+    }
+
+    std::uint64_t readIndent() {
+        std::uint64_t const indent = readVarint(_data, _end);
+        LSST_ARCHIVE_ASSERT(indent <= MAX_INDENT);
+        return indent;
+    }
+
+    void readWord(std::string &out) {
+        std::uint64_t const tag = readVarint(_data, _end);
+        if (tag == TAG_NEW_STRING) {
+            std::uint64_t const size = readVarint(_data, _end);
+            LSST_ARCHIVE_ASSERT(size <= static_cast<std::uint64_t>(_end - _data));
+            _strings.emplace_back(reinterpret_cast<char const *>(_data), size);
+            _data += size;
+            out += _strings.back();
+        } else if (tag == TAG_STRING) {
+            std::uint64_t const index = readVarint(_data, _end);
+            LSST_ARCHIVE_ASSERT(index < _strings.size());
+            out += _strings[index];
+        } else if (tag == TAG_INTEGER) {
+            out += std::to_string(readSignedVarint(_data, _end));
+        } else {
+            LSST_ARCHIVE_ASSERT(tag > TAG_DOUBLE && tag <= TAG_DOUBLE + MAX_PRECISION && _end - _data >= 8);
+            std::uint64_t bits = 0;
+            for (int i = 0; i < 8; ++i) {
+                bits |= static_cast<std::uint64_t>(*_data++) << (8 * i);
+            }
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            out += formatDouble(value, static_cast<int>(tag - TAG_DOUBLE));
+        }
+    }
+
+    bool atEnd() const { return _data == _end; }
+
+private:
+    std::uint8_t const *_data;
+    std::uint8_t const *const _end;
+    std::vector<std::string> _strings;
+};
+
+}  // namespace
+
+ndarray::Array<std::uint8_t, 1, 1> encodeAstText(std::string const &text) {
+    Encoder encoder(text.size());
+    auto &buffer = encoder.getBuffer();
+    buffer.push_back(AST_ENCODING_VERSION);
+    appendVarint(std::count(text.begin(), text.end(), '\n') + 1, buffer);
+    std::size_t lineStart = 0;
+    while (true) {
+        std::size_t lineEnd = text.find('\n', lineStart);
+        std::string const line = text.substr(lineStart, lineEnd - lineStart);
+        std::size_t indent = std::min(line.find_first_not_of(' '), line.size());
+        if (indent > MAX_INDENT) {
+            indent = 0;
+        }
+        appendVarint(indent, buffer);
+        auto const words = splitWords(line, indent);
+        appendVarint(words.size(), buffer);
+        if (words.empty()) {
+            encoder.appendWord(line.substr(indent));
+        }
+        for (auto const &word : words) {
+            encoder.appendWord(word);
+        }
+        if (lineEnd == std::string::npos) {
+            break;
+        }
+        lineStart = lineEnd + 1;
+    }
+    ndarray::Array<std::uint8_t, 1, 1> result = ndarray::allocate(buffer.size());
+    std::copy(buffer.begin(), buffer.end(), result.begin());
+    return result;
+}
+
+std::string decodeAstText(ndarray::Array<std::uint8_t const, 1, 1> const &encoded) {
+    std::uint8_t const *data = encoded.getData();
+    std::uint8_t const *const end = data + encoded.getNumElements();
+    LSST_ARCHIVE_ASSERT(data != end && *data == AST_ENCODING_VERSION);
+    Decoder decoder(data + 1, end);
+    std::string text;
+    text.reserve(4 * encoded.getNumElements());
+    // Every line takes at least three bytes: its indentation, its number of words and one word
+    std::uint64_t const nLines = decoder.readCount(3);
+    LSST_ARCHIVE_ASSERT(nLines > 0);
+    for (std::uint64_t i = 0; i < nLines; ++i) {
+        if (i > 0) {
+            text += '\n';
+        }
+        std::uint64_t const indent = decoder.readIndent();
+        text.append(indent, ' ');
+        // Every word takes at least two bytes
+        std::uint64_t const nWords = std::max<std::uint64_t>(decoder.readCount(2), 1);
+        for (std::uint64_t j = 0; j < nWords; ++j) {
+            if (j > 0) {
+                text += ' ';
+            }
+            decoder.readWord(text);
+        }
+    }
+    LSST_ARCHIVE_ASSERT(decoder.atEnd());
+    return text;
+}
+
+}  // namespace detail
+}  // namespace geom
+}  // namespace afw
+}  // namespace lsst
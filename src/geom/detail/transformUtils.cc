@@ -0,0 +1,84 @@
+// -*- LSST-C++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "astshim.h"
+#include "ndarray.h"
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/geom/detail/transformUtils.h"
+#include "lsst/afw/math/detail/Parallel.h"
+
+namespace lsst {
+namespace afw {
+namespace geom {
+namespace detail {
+
+namespace {
+
+// Fewest points worth handing to a thread with its own copy of the mapping
+std::size_t const MIN_POINTS_PER_THREAD = 10000;
+
+}  // namespace
+
+ndarray::Array<double, 2, 2> applyMapping(ast::Mapping const& mapping,
+                                          ndarray::Array<double, 2, 2> const& from, bool forward,
+                                          int numThreads) {
+    std::size_t const nThreads = math::detail::resolveNumThreads(numThreads);
+    std::size_t const nPoints = from.getSize<1>();
+    int const nChunks = static_cast<int>(std::min(nThreads, nPoints / MIN_POINTS_PER_THREAD));
+    if (nChunks <= 1) {
+        return forward ? mapping.applyForward(from) : mapping.applyInverse(from);
+    }
+
+    std::ostringstream os;
+    mapping.show(os, false);  // false = do not write comments
+    std::string const serialized = os.str();
+    int const nOut = forward ? mapping.getNOut() : mapping.getNIn();
+    ndarray::Array<double, 2, 2> result = ndarray::allocate(nOut, nPoints);
+    math::detail::parallelFor(nChunks, nChunks, [&](int i) {
+        std::size_t const begin = nPoints * i / nChunks;
+        std::size_t const end = nPoints * (i + 1) / nChunks;
+        std::istringstream is(serialized);
+        auto astStream = ast::Stream(&is, nullptr);
+        auto copy = std::dynamic_pointer_cast<ast::Mapping>(ast::Channel(astStream).read());
+        if (!copy) {
+            throw LSST_EXCEPT(pex::exceptions::LogicError, "Copy of a Mapping was not read as a Mapping");
+        }
+        ndarray::Array<double, 2, 2> chunk = ndarray::copy(from[ndarray::view()(begin, end)]);
+        auto const transformed = forward ? copy->applyForward(chunk) : copy->applyInverse(chunk);
+        result[ndarray::view()(begin, end)].deep() = transformed;
+    });
+    return result;
+}
+
+}  // namespace detail
+}  // namespace geom
+}  // namespace afw
+}  // namespace lsst
@@ -21,6 +21,7 @@
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include "boost/optional.hpp"
@@ -62,21 +63,10 @@ namespace ellipses {
 class EllipseHorizontalLineIntersection {
 public:
 
-    explicit EllipseHorizontalLineIntersection(Ellipse const& ellipse) :
-        _center(ellipse.getCenter()),
-        _p(0.0), _t(0.0), _r(0.0)
-    {
-        Quadrupole converted(ellipse.getCore());
-        converted.normalize();
-        auto q = converted.getMatrix();
-        if (q(1, 1) < q(0, 0)*std::numeric_limits<double>::epsilon()) {
-            _r = q(0, 0);
-        } else {
-            _p = q(0, 1)/q(1, 1);
-            _r = q(0, 0) - q(0, 1)*_p;
-            _t = _r/q(1, 1);
-        }
-    }
+    EllipseHorizontalLineIntersection(double p, double r, double t, lsst::geom::Point2D const& center) :
+        _center(center),
+        _p(p), _t(t), _r(r)
+    {}
 
     boost::optional<std::pair<double, double>> xAt(double y) const {
         double yc = y - _center.getY();
@@ -97,11 +87,32 @@ private:
     double _r;
 };
 
+PixelRegion::CoreGeometry::CoreGeometry(BaseCore const& core)
+    : dimensions(core.computeDimensions()), p(0.0), r(0.0), t(0.0)
+{
+    Quadrupole converted(core);
+    converted.normalize();
+    auto q = converted.getMatrix();
+    if (q(1, 1) < q(0, 0)*std::numeric_limits<double>::epsilon()) {
+        r = q(0, 0);
+    } else {
+        p = q(0, 1)/q(1, 1);
+        r = q(0, 0) - q(0, 1)*p;
+        t = r/q(1, 1);
+    }
+}
+
 PixelRegion::PixelRegion(Ellipse const& ellipse)
-    : _bbox(ellipse.computeBBox(), lsst::geom::Box2I::EXPAND)
+    : PixelRegion(CoreGeometry(ellipse.getCore()), ellipse.getCenter())
+{}
+
+PixelRegion::PixelRegion(CoreGeometry const& geometry, lsst::geom::Point2D const& center)
+    // Same box as Ellipse::computeBBox
+    : _bbox(lsst::geom::Box2D(center - geometry.dimensions*0.5, geometry.dimensions),
+            lsst::geom::Box2I::EXPAND)
 {
     // Initial temporary bounding box that may be larger than the final one.
-    lsst::geom::Box2I envelope(ellipse.computeBBox(), lsst::geom::Box2I::EXPAND);
+    lsst::geom::Box2I const envelope = _bbox;
 
     if (envelope.isEmpty()) {
         // If the outer bbox is empty, we know there can't be any spans that
@@ -111,10 +122,13 @@ PixelRegion::PixelRegion(Ellipse const& ellipse)
 
     // Helper class that does the hard work: compute the boundary points of the
     // ellipse in x that intersect a horizontal line at some given y.
-    EllipseHorizontalLineIntersection intersection(ellipse);
+    EllipseHorizontalLineIntersection intersection(geometry.p, geometry.r, geometry.t, center);
 
     // Iterate over pixel rows in the bounding box, computing the intersection
     // of the ellipse with that y coordinate.
+    _spans.reserve(envelope.getHeight());
+    int xMinAll = envelope.getMinX();
+    int xMaxAll = envelope.getMaxX();
     int const yEnd = envelope.getEndY();
     for (int y = envelope.getBeginY(); y != yEnd; ++y) {
         auto x = intersection.xAt(y);
@@ -123,10 +137,36 @@ PixelRegion::PixelRegion(Ellipse const& ellipse)
             int xMax = std::floor(x->second);
             if (xMax < xMin) continue;
             _spans.emplace_back(y, xMin, xMax);
-            _bbox.include(lsst::geom::Point2I(xMin, y));
-            _bbox.include(lsst::geom::Point2I(xMax, y));
+            xMinAll = std::min(xMinAll, xMin);
+            xMaxAll = std::max(xMaxAll, xMax);
         }
     }
+    // Spans are one per row within the envelope, so only x can grow the box
+    _bbox.include(lsst::geom::Point2I(xMinAll, envelope.getMinY()));
+    _bbox.include(lsst::geom::Point2I(xMaxAll, envelope.getMinY()));
+}
+
+PixelRegionCache::PixelRegionCache(std::size_t maxSize)
+    : _maxSize(std::max(maxSize, std::size_t(1))), _next(0) {}
+
+PixelRegion PixelRegionCache::makePixelRegion(Ellipse const& ellipse) {
+    BaseCore const& core = ellipse.getCore();
+    std::string const name = core.getName();
+    BaseCore::ParameterVector const parameters = core.getParameterVector();
+    for (auto const& entry : _entries) {
+        if (entry.parameters == parameters && entry.name == name) {
+            return PixelRegion(entry.geometry, ellipse.getCenter());
+        }
+    }
+    Entry entry{name, parameters, PixelRegion::CoreGeometry(core)};
+    PixelRegion region(entry.geometry, ellipse.getCenter());
+    if (_entries.size() < _maxSize) {
+        _entries.push_back(std::move(entry));
+    } else {
+        _entries[_next] = std::move(entry);
+        _next = (_next + 1) % _maxSize;
+    }
+    return region;
 }
 
 Span const PixelRegion::getSpanAt(int y) const {
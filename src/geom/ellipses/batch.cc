@@ -0,0 +1,148 @@
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <initializer_list>
+#include <memory>
+
+#include "boost/format.hpp"
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/geom/ellipses/BaseCore.h"
+#include "lsst/afw/geom/ellipses/batch.h"
+
+namespace lsst {
+namespace afw {
+namespace geom {
+namespace ellipses {
+
+namespace {
+
+void checkLengths(std::size_t expected, std::initializer_list<std::size_t> sizes) {
+    for (std::size_t size : sizes) {
+        if (size != expected) {
+            throw LSST_EXCEPT(pex::exceptions::LengthError,
+                              (boost::format("Ellipse parameter arrays differ in length: %d vs. %d") %
+                               expected % size)
+                                      .str());
+        }
+    }
+}
+
+}  // namespace
+
+void convertQuadrupolesToAxes(ndarray::Array<double const, 1> const& ixx,
+                              ndarray::Array<double const, 1> const& iyy,
+                              ndarray::Array<double const, 1> const& ixy, ndarray::Array<double, 1> const& a,
+                              ndarray::Array<double, 1> const& b, ndarray::Array<double, 1> const& theta) {
+    std::size_t const n = ixx.getSize<0>();
+    checkLengths(n, {iyy.getSize<0>(), ixy.getSize<0>(), a.getSize<0>(), b.getSize<0>(),
+                     theta.getSize<0>()});
+    // Same arithmetic as BaseCore::_assignQuadrupoleToAxes; the result needs no further normalization
+    for (std::size_t i = 0; i < n; ++i) {
+        double const xx_p_yy = ixx[i] + iyy[i];
+        double const xx_m_yy = ixx[i] - iyy[i];
+        double const t = std::sqrt(xx_m_yy * xx_m_yy + 4 * ixy[i] * ixy[i]);
+        double const xy2 = 2.0 * ixy[i];
+        a[i] = std::sqrt(0.5 * (xx_p_yy + t));
+        b[i] = std::sqrt(0.5 * (xx_p_yy - t));
+        theta[i] = 0.5 * std::atan2(xy2, xx_m_yy);
+    }
+}
+
+void convertAxesToQuadrupoles(ndarray::Array<double const, 1> const& a,
+                              ndarray::Array<double const, 1> const& b,
+                              ndarray::Array<double const, 1> const& theta,
+                              ndarray::Array<double, 1> const& ixx, ndarray::Array<double, 1> const& iyy,
+                              ndarray::Array<double, 1> const& ixy) {
+    std::size_t const n = a.getSize<0>();
+    checkLengths(n, {b.getSize<0>(), theta.getSize<0>(), ixx.getSize<0>(), iyy.getSize<0>(),
+                     ixy.getSize<0>()});
+    // Same arithmetic as BaseCore::_assignAxesToQuadrupole
+    for (std::size_t i = 0; i < n; ++i) {
+        double const a2 = a[i] * a[i];
+        double const b2 = b[i] * b[i];
+        double const c = std::cos(theta[i]);
+        double const s = std::sin(theta[i]);
+        ixy[i] = (a2 - b2) * c * s;
+        ixx[i] = c * c * a2 + s * s * b2;
+        iyy[i] = s * s * a2 + c * c * b2;
+    }
+}
+
+void transformQuadrupoles(lsst::geom::LinearTransform const& transform,
+                          ndarray::Array<double const, 1> const& ixx,
+                          ndarray::Array<double const, 1> const& iyy,
+                          ndarray::Array<double const, 1> const& ixy, ndarray::Array<double, 1> const& ixxOut,
+                          ndarray::Array<double, 1> const& iyyOut, ndarray::Array<double, 1> const& ixyOut) {
+    std::size_t const n = ixx.getSize<0>();
+    checkLengths(n, {iyy.getSize<0>(), ixy.getSize<0>(), ixxOut.getSize<0>(), iyyOut.getSize<0>(),
+                     ixyOut.getSize<0>()});
+    // Q' = M Q M^T, expanded for symmetric Q
+    auto const& m = transform.getMatrix();
+    double const m00 = m(0, 0), m01 = m(0, 1), m10 = m(1, 0), m11 = m(1, 1);
+    for (std::size_t i = 0; i < n; ++i) {
+        double const xx = ixx[i], yy = iyy[i], xy = ixy[i];
+        ixxOut[i] = m00 * m00 * xx + 2.0 * m00 * m01 * xy + m01 * m01 * yy;
+        iyyOut[i] = m10 * m10 * xx + 2.0 * m10 * m11 * xy + m11 * m11 * yy;
+        ixyOut[i] = m00 * m10 * xx + (m00 * m11 + m01 * m10) * xy + m01 * m11 * yy;
+    }
+}
+
+ndarray::Array<double, 2, 2> convertCores(std::string const& fromName, std::string const& toName,
+                                          ndarray::Array<double const, 2, 1> const& parameters) {
+    if (parameters.getSize<1>() != 3) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("Ellipse parameter array has %d columns, not 3") %
+                           parameters.getSize<1>())
+                                  .str());
+    }
+    std::size_t const n = parameters.getSize<0>();
+    ndarray::Array<double, 2, 2> result = ndarray::allocate(n, 3);
+    if (fromName == "Quadrupole" && toName == "Axes") {
+        convertQuadrupolesToAxes(parameters[ndarray::view()(0)], parameters[ndarray::view()(1)],
+                                 parameters[ndarray::view()(2)], result[ndarray::view()(0)],
+                                 result[ndarray::view()(1)], result[ndarray::view()(2)]);
+        return result;
+    }
+    if (fromName == "Axes" && toName == "Quadrupole") {
+        convertAxesToQuadrupoles(parameters[ndarray::view()(0)], parameters[ndarray::view()(1)],
+                                 parameters[ndarray::view()(2)], result[ndarray::view()(0)],
+                                 result[ndarray::view()(1)], result[ndarray::view()(2)]);
+        return result;
+    }
+    std::shared_ptr<BaseCore> input = BaseCore::make(fromName);
+    std::shared_ptr<BaseCore> output = BaseCore::make(toName);
+    for (std::size_t i = 0; i < n; ++i) {
+        double const row[3] = {parameters[i][0], parameters[i][1], parameters[i][2]};
+        input->readParameters(row);
+        *output = *input;
+        output->writeParameters(result[i].getData());
+    }
+    return result;
+}
+
+}  // namespace ellipses
+}  // namespace geom
+}  // namespace afw
+}  // namespace lsst
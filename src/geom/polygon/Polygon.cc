@@ -1,13 +1,17 @@
 #include <cmath>
 #include <algorithm>
+#include <iterator>
 
 #include "boost/geometry/geometry.hpp"
 #include <boost/container_hash/hash.hpp>
 #include <memory>
 
+#include "boost/geometry/index/rtree.hpp"
+
 #include "lsst/pex/exceptions.h"
 #include "lsst/geom/Extent.h"
 #include "lsst/afw/geom/polygon/Polygon.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 #include "lsst/afw/table/io/OutputArchive.h"
 #include "lsst/afw/table/io/CatalogVector.h"
@@ -20,6 +24,7 @@ using LsstRing = std::vector<LsstPoint>;
 using BoostPolygon = boost::geometry::model::polygon<LsstPoint>;
 using BoostBox = boost::geometry::model::box<LsstPoint>;
 using BoostLineString = boost::geometry::model::linestring<LsstPoint>;
+using BoostMultiPolygon = boost::geometry::model::multi_polygon<BoostPolygon>;
 
 namespace boost {
 namespace geometry {
@@ -118,32 +123,117 @@ void addSubSampledEdge(std::vector<LsstPoint>& vertices,  // Vector of points to
     }
 }
 
-/// @internal Calculate area of overlap between polygon and pixel
-double pixelOverlap(BoostPolygon const& poly, int const x, int const y) {
-    std::vector<BoostPolygon> overlap;  // Overlap between pixel and polygon
-    LsstBox const pixel(lsst::geom::Point2D(static_cast<double>(x) - 0.5, static_cast<double>(y) - 0.5),
-                        lsst::geom::Point2D(static_cast<double>(x) + 0.5, static_cast<double>(y) + 0.5));
-    // Note that the output of boost::geometry::intersection depends
-    // on values down to the precision limit, so minor variations
-    // in poly input can lead to surprisingly large variations in the
-    // output overlap regions and area computation.
-    boost::geometry::intersection(poly, pixel, overlap);
-    double area = 0.0;
-    for (auto const &i : overlap) {
-        double const polyArea = boost::geometry::area(i);
-        area += std::min(polyArea, 1.0);  // remove any rounding error
+/// @internal Add `value` to column `col` of a coverage row, folding columns left of the row into its first
+void addCoverage(double *row, int width, long col, double value) {
+    if (col < width) {
+        row[std::max(col, 0L)] += value;
+    }
+}
+
+/**
+ * @internal Accumulate the signed area to the right of an edge in each pixel of a coverage buffer
+ *
+ * Coordinates are in units of pixels with pixel (col, row) of the buffer covering [col, col + 1) x
+ * [row, row + 1).  Once every edge of a closed polygon has been added, the running sum along each
+ * row is the (signed) fraction of each pixel lying within the polygon.
+ */
+void accumulateEdge(std::vector<double> &coverage, int width, int height, double u0, double v0, double u1,
+                    double v1) {
+    if (v0 == v1) {
+        return;
+    }
+    double dir = 1.0;
+    if (v0 > v1) {
+        std::swap(u0, u1);
+        std::swap(v0, v1);
+        dir = -1.0;
+    }
+    double const dudv = (u1 - u0) / (v1 - v0);
+    int const rowBegin = std::max(0, static_cast<int>(std::floor(v0)));
+    int const rowEnd = std::min(height, static_cast<int>(std::ceil(v1)));
+    for (int r = rowBegin; r < rowEnd; ++r) {
+        double const top = std::max(static_cast<double>(r), v0);
+        double const bottom = std::min(static_cast<double>(r + 1), v1);
+        if (!(bottom > top)) {
+            continue;
+        }
+        double *row = &coverage[static_cast<std::size_t>(r) * width];
+        double const d = dir * (bottom - top);
+        double const ua = u0 + dudv * (top - v0);
+        double const ub = u0 + dudv * (bottom - v0);
+        double const left = std::min(ua, ub);
+        double const right = std::max(ua, ub);
+        double const leftFloor = std::floor(left);
+        double const rightCeil = std::ceil(right);
+        long const iLeft = static_cast<long>(leftFloor);
+        long const iRight = static_cast<long>(rightCeil);
+        if (iRight <= iLeft + 1) {
+            double const mid = 0.5 * (ua + ub) - leftFloor;
+            addCoverage(row, width, iLeft, d * (1.0 - mid));
+            addCoverage(row, width, iLeft + 1, d * mid);
+            continue;
+        }
+        double const s = 1.0 / (right - left);
+        double const fLeft = left - leftFloor;
+        double const fRight = right - rightCeil + 1.0;
+        double const aLeft = 0.5 * s * (1.0 - fLeft) * (1.0 - fLeft);
+        double const aRight = 0.5 * s * fRight * fRight;
+        addCoverage(row, width, iLeft, d * aLeft);
+        if (iRight == iLeft + 2) {
+            addCoverage(row, width, iLeft + 1, d * (1.0 - aLeft - aRight));
+        } else {
+            double const aNext = s * (1.5 - fLeft);
+            addCoverage(row, width, iLeft + 1, d * (aNext - aLeft));
+            long const first = std::max(iLeft + 2, 0L);
+            long const last = std::min(iRight - 2, static_cast<long>(width) - 1);
+            // Columns of the run left of the image all land in its first column
+            double const numLeft = std::min(first, iRight - 1) - (iLeft + 2);
+            addCoverage(row, width, 0, d * s * numLeft);
+            for (long col = first; col <= last; ++col) {
+                row[col] += d * s;
+            }
+            double const aLast = aNext + static_cast<double>(iRight - iLeft - 3) * s;
+            addCoverage(row, width, iRight - 1, d * (1.0 - aLast - aRight));
+        }
+        addCoverage(row, width, iRight, d * aRight);
+    }
+}
+
+/// @internal Accumulate the winding number of a ring about each point, and flag points on its boundary
+void accumulateWinding(BoostPolygon::ring_type const &ring, double const *x, double const *y, std::size_t num,
+                       int *winding, unsigned char *onEdge) {
+    for (std::size_t i = 0; i + 1 < ring.size(); ++i) {
+        double const x0 = ring[i].getX(), y0 = ring[i].getY();
+        double const x1 = ring[i + 1].getX(), y1 = ring[i + 1].getY();
+        double const dx = x1 - x0, dy = y1 - y0;
+        double const xLow = std::min(x0, x1), xHigh = std::max(x0, x1);
+        double const yLow = std::min(y0, y1), yHigh = std::max(y0, y1);
+        // Branch-free so the compiler can vectorize over points
+        for (std::size_t j = 0; j < num; ++j) {
+            double const cross = dx * (y[j] - y0) - (x[j] - x0) * dy;
+            bool const up = (y0 <= y[j]) & (y1 > y[j]) & (cross > 0.0);
+            bool const down = (y0 > y[j]) & (y1 <= y[j]) & (cross < 0.0);
+            winding[j] += static_cast<int>(up) - static_cast<int>(down);
+            onEdge[j] |= (cross == 0.0) & (x[j] >= xLow) & (x[j] <= xHigh) & (y[j] >= yLow) & (y[j] <= yHigh);
+        }
     }
-    return area;
 }
 
-/// @internal Set each pixel in a row to the amount of overlap with polygon
-void pixelRowOverlap(std::shared_ptr<lsst::afw::image::Image<float>> const image, BoostPolygon const& poly,
-                     int const xStart, int const xStop, int const y) {
-    int x = xStart;
-    for (lsst::afw::image::Image<float>::x_iterator i = image->x_at(x - image->getX0(), y - image->getY0());
-         x <= xStop; ++i, ++x) {
-        *i = pixelOverlap(poly, x, y);
+/// @internal Return whether each point lies in the interior of a polygon; points on its boundary do not
+std::vector<bool> containsPoints(BoostPolygon const& poly, std::vector<double> const& x,
+                                 std::vector<double> const& y) {
+    std::size_t const num = x.size();
+    std::vector<int> winding(num, 0);
+    std::vector<unsigned char> onEdge(num, 0);
+    accumulateWinding(poly.outer(), x.data(), y.data(), num, winding.data(), onEdge.data());
+    for (auto const& inner : poly.inners()) {
+        accumulateWinding(inner, x.data(), y.data(), num, winding.data(), onEdge.data());
+    }
+    std::vector<bool> results(num);
+    for (std::size_t j = 0; j < num; ++j) {
+        results[j] = winding[j] != 0 && !onEdge[j];
     }
+    return results;
 }
 
 }  // anonymous namespace
@@ -356,18 +446,39 @@ std::size_t Polygon::hash_value() const noexcept {
 bool Polygon::contains(LsstPoint const& point) const { return boost::geometry::within(point, _impl->poly); }
 
 std::vector<bool> Polygon::contains(std::vector<Point> const &points) const {
-    std::vector<bool> results;
+    std::vector<double> x, y;
+    x.reserve(points.size());
+    y.reserve(points.size());
     for (Point const & p : points) {
-        results.push_back(contains(p));
+        x.push_back(p.getX());
+        y.push_back(p.getY());
     }
-    return results;
+    return containsPoints(_impl->poly, x, y);
 }
 
 std::vector<bool> Polygon::contains(std::vector<lsst::geom::Point2I> const &points) const {
-    std::vector<bool> results;
+    std::vector<double> x, y;
+    x.reserve(points.size());
+    y.reserve(points.size());
     for (lsst::geom::PointI const & p : points) {
-        results.push_back(contains(Point(p)));
+        x.push_back(p.getX());
+        y.push_back(p.getY());
+    }
+    return containsPoints(_impl->poly, x, y);
+}
+
+ndarray::Array<bool, 1, 1> Polygon::contains(ndarray::Array<double const, 1> const &x,
+                                             ndarray::Array<double const, 1> const &y) const {
+    if (x.getSize<0>() != y.getSize<0>()) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("x and y have different lengths: %d vs. %d") % x.getSize<0>() %
+                           y.getSize<0>()).str());
     }
+    std::vector<bool> const inside =
+            containsPoints(_impl->poly, std::vector<double>(x.begin(), x.end()),
+                           std::vector<double>(y.begin(), y.end()));
+    ndarray::Array<bool, 1, 1> results = ndarray::allocate(inside.size());
+    std::copy(inside.begin(), inside.end(), results.begin());
     return results;
 }
 
@@ -465,75 +576,156 @@ std::shared_ptr<afw::image::Image<float>> Polygon::createImage(lsst::geom::Box2I
     image->setXY0(bbox.getMin());
     *image = 0.0;
     lsst::geom::Box2D bounds = getBBox();  // Polygon bounds
-    int xMin = std::max(static_cast<int>(bounds.getMinX()), bbox.getMinX());
-    int xMax = std::min(static_cast<int>(::ceil(bounds.getMaxX())), bbox.getMaxX());
-    int yMin = std::max(static_cast<int>(bounds.getMinY()), bbox.getMinY());
-    int yMax = std::min(static_cast<int>(::ceil(bounds.getMaxY())), bbox.getMaxY());
-    for (int y = yMin; y <= yMax; ++y) {
-        double const yPixelMin = (double)y - 0.5, yPixelMax = (double)y + 0.5;
-        BoostPolygon row;  // A polygon of row y
-        boost::geometry::assign(
-                row, LsstBox(lsst::geom::Point2D(xMin, yPixelMin), lsst::geom::Point2D(xMax, yPixelMax)));
-        std::vector<BoostPolygon> intersections;
-        boost::geometry::intersection(_impl->poly, row, intersections);
-
-        if (intersections.size() == 1 && boost::geometry::num_points(intersections[0]) == 5) {
-            // This row is fairly tame, and should have a long run of pixels within the polygon
-            BoostPolygon const& row = intersections[0];
-            std::vector<double> top, bottom;
-            top.reserve(2);
-            bottom.reserve(2);
-            bool failed = false;
-            for (std::vector<Point>::const_iterator i = row.outer().begin(); i != row.outer().end() - 1;
-                 ++i) {
-                double const xCoord = i->getX(), yCoord = i->getY();
-                if (yCoord == yPixelMin) {
-                    bottom.push_back(xCoord);
-                } else if (yCoord == yPixelMax) {
-                    top.push_back(xCoord);
-                } else {
-                    failed = true;
-                    break;
-                }
+    if (bounds.isEmpty()) {
+        return image;
+    }
+    // Pixel (x, y) covers [x - 0.5, x + 0.5) x [y - 0.5, y + 0.5)
+    int const xMin = std::max(static_cast<int>(std::floor(bounds.getMinX() + 0.5)), bbox.getMinX());
+    int const xMax = std::min(static_cast<int>(std::floor(bounds.getMaxX() + 0.5)), bbox.getMaxX());
+    int const yMin = std::max(static_cast<int>(std::floor(bounds.getMinY() + 0.5)), bbox.getMinY());
+    int const yMax = std::min(static_cast<int>(std::floor(bounds.getMaxY() + 0.5)), bbox.getMaxY());
+    if (xMin > xMax || yMin > yMax) {
+        return image;
+    }
+
+    // Scanline rasterization: each edge adds its exact signed area to the pixels of the rows it crosses,
+    // and a running sum along each row then gives the fraction of each pixel within the polygon.
+    int const width = xMax - xMin + 1;
+    int const height = yMax - yMin + 1;
+    double const uOffset = xMin - 0.5;
+    double const vOffset = yMin - 0.5;
+    std::vector<double> coverage(static_cast<std::size_t>(width) * height, 0.0);
+    auto addRing = [&](BoostPolygon::ring_type const& ring) {
+        for (std::size_t i = 0; i + 1 < ring.size(); ++i) {
+            accumulateEdge(coverage, width, height, ring[i].getX() - uOffset, ring[i].getY() - vOffset,
+                           ring[i + 1].getX() - uOffset, ring[i + 1].getY() - vOffset);
+        }
+    };
+    addRing(_impl->poly.outer());
+    for (auto const& inner : _impl->poly.inners()) {
+        addRing(inner);
+    }
+
+    for (int row = 0; row < height; ++row) {
+        double const* cov = &coverage[static_cast<std::size_t>(row) * width];
+        double sum = 0.0;
+        Image::x_iterator pixel = image->x_at(xMin - image->getX0(), yMin + row - image->getY0());
+        for (int col = 0; col < width; ++col, ++pixel) {
+            sum += cov[col];
+            *pixel = std::min(std::abs(sum), 1.0);  // sign depends on orientation; remove any rounding error
+        }
+    }
+    return image;
+}
+
+std::vector<PolygonIntersection> intersectPairs(std::vector<std::shared_ptr<Polygon>> const& polygons,
+                                                int numThreads) {
+    int const nThreads = static_cast<int>(math::detail::resolveNumThreads(numThreads));
+    using Entry = std::pair<BoostBox, std::size_t>;
+    std::vector<Entry> entries;
+    entries.reserve(polygons.size());
+    for (std::size_t i = 0; i < polygons.size(); ++i) {
+        if (!polygons[i]) {
+            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                              (boost::format("Polygon %d is null") % i).str());
+        }
+        Polygon::Box const bbox = polygons[i]->getBBox();
+        entries.emplace_back(BoostBox(bbox.getMin(), bbox.getMax()), i);
+    }
+    // Packing construction: the tree is built once from all boxes, with no insertions
+    boost::geometry::index::rtree<Entry, boost::geometry::index::quadratic<16>> const tree(entries);
+
+    std::vector<std::pair<std::size_t, std::size_t>> candidates;
+    std::vector<Entry> hits;
+    for (auto const& entry : entries) {
+        hits.clear();
+        tree.query(boost::geometry::index::intersects(entry.first), std::back_inserter(hits));
+        for (auto const& hit : hits) {
+            if (hit.second > entry.second) {
+                candidates.emplace_back(entry.second, hit.second);
             }
-            if (!failed && top.size() == 2 && bottom.size() == 2) {
-                std::sort(top.begin(), top.end());
-                std::sort(bottom.begin(), bottom.end());
-                int const xMin = std::min(top[0], bottom[0]);
-                int const xStart = ::ceil(std::max(top[0], bottom[0])) + 1;
-                int const xStop = std::min(top[1], bottom[1]) - 1;
-                int const xMax = ::ceil(std::max(top[1], bottom[1]));
-                pixelRowOverlap(image, _impl->poly, std::max(xMin, bbox.getMinX()),
-                                std::min(xStart, bbox.getMaxX()), y);
-                int x = xStart;
-                for (Image::x_iterator i = image->x_at(std::max(xStart, bbox.getMinX()) - image->getX0(),
-                                                       y - image->getY0());
-                     x <= std::min(xStop, bbox.getMaxX()); ++i, ++x) {
-                    *i = 1.0;
-                }
-                pixelRowOverlap(image, _impl->poly, std::max(xStop, bbox.getMinX()),
-                                std::min(xMax, bbox.getMaxX()), y);
-                continue;
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    std::vector<std::vector<std::shared_ptr<Polygon>>> results(candidates.size());
+    math::detail::parallelFor(static_cast<int>(candidates.size()), nThreads, [&](int k) {
+        results[k] = polygons[candidates[k].first]->intersection(*polygons[candidates[k].second]);
+    });
+
+    std::vector<PolygonIntersection> intersections;
+    for (std::size_t k = 0; k < candidates.size(); ++k) {
+        if (!results[k].empty()) {
+            intersections.push_back(
+                    PolygonIntersection{candidates[k].first, candidates[k].second, std::move(results[k])});
+        }
+    }
+    return intersections;
+}
+
+struct PolygonUnion::Impl {
+    // Partial unions: levels[k] is empty or the union of 2^k of the polygons added
+    std::vector<BoostMultiPolygon> levels;
+    std::size_t numAdded = 0;
+
+    BoostMultiPolygon merge() const {
+        BoostMultiPolygon result;
+        for (auto const& level : levels) {
+            if (result.empty()) {
+                result = level;
+            } else if (!level.empty()) {
+                BoostMultiPolygon merged;
+                boost::geometry::union_(result, level, merged);
+                result = std::move(merged);
             }
         }
+        return result;
+    }
+};
 
-        // Last resort: do each pixel independently...
-        for (auto const &intersection : intersections) {
-            double xMinRow = xMax, xMaxRow = xMin;
-            std::vector<LsstPoint> const vertices = intersection.outer();
-            for (auto const &vertice : vertices) {
-                double const x = vertice.getX();
-                if (x < xMinRow) xMinRow = x;
-                if (x > xMaxRow) xMaxRow = x;
-            }
+PolygonUnion::PolygonUnion() : _impl(new Impl()) {}
+
+PolygonUnion::~PolygonUnion() noexcept = default;
+
+PolygonUnion::PolygonUnion(PolygonUnion const& other) : _impl(new Impl(*other._impl)) {}
+
+PolygonUnion::PolygonUnion(PolygonUnion&& other) noexcept = default;
+
+PolygonUnion& PolygonUnion::operator=(PolygonUnion const& other) {
+    if (this != &other) {
+        _impl.reset(new Impl(*other._impl));
+    }
+    return *this;
+}
+
+PolygonUnion& PolygonUnion::operator=(PolygonUnion&& other) noexcept = default;
 
-            pixelRowOverlap(image, _impl->poly, std::max(static_cast<int>(xMinRow), bbox.getMinX()),
-                            std::min(static_cast<int>(::ceil(xMaxRow)), bbox.getMaxX()), y);
+void PolygonUnion::add(Polygon const& polygon) {
+    BoostMultiPolygon carry;
+    carry.push_back(polygon._impl->poly);
+    ++_impl->numAdded;
+    // Like incrementing a binary counter: merge with each occupied level until reaching a free one
+    for (auto& level : _impl->levels) {
+        if (level.empty()) {
+            level = std::move(carry);
+            return;
         }
+        BoostMultiPolygon merged;
+        boost::geometry::union_(level, carry, merged);
+        level.clear();
+        carry = std::move(merged);
     }
-    return image;
+    _impl->levels.push_back(std::move(carry));
 }
 
+std::size_t PolygonUnion::getNumAdded() const noexcept { return _impl->numAdded; }
+
+std::vector<std::shared_ptr<Polygon>> PolygonUnion::getPolygons() const {
+    return Polygon::Impl::convertBoostPolygons(_impl->merge());
+}
+
+double PolygonUnion::calculateArea() const { return boost::geometry::area(_impl->merge()); }
+
 // -------------- Table-based Persistence -------------------------------------------------------------------
 
 /*
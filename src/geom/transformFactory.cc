@@ -21,14 +21,19 @@
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
 
-#include <sstream>
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <limits>
+#include <sstream>
+#include <vector>
 
 #include "astshim.h"
 
 #include "Eigen/Core"
 
 #include "lsst/afw/geom/Endpoint.h"
+#include "lsst/afw/geom/SipApproximation.h"
 #include "lsst/afw/geom/transformFactory.h"
 #include "lsst/pex/exceptions.h"
 
@@ -127,6 +132,54 @@ ast::PolyMap makeOneDDistortion(std::vector<double> const &coeffs) {
     return ast::PolyMap(polyCoeffs, 1, "IterInverse=1, TolInverse=1e-8, NIterInverse=30");
 }
 
+/*
+ * Make PolyMap coefficients for the two-dimensional function (x + A(x, y), y + B(x, y)).
+ *
+ * @param a, b square matrices whose (p, q) elements are the coefficients of x^p y^q
+ * @returns coefficients in the form expected by ast::PolyMap, one row per term
+ */
+ndarray::Array<double, 2, 2> makeSipPolyCoeffs(Eigen::MatrixXd const &a, Eigen::MatrixXd const &b) {
+    std::vector<std::array<double, 4>> terms;
+    for (int axis = 0; axis < 2; ++axis) {
+        Eigen::MatrixXd coeffs = (axis == 0) ? a : b;
+        coeffs(axis == 0 ? 1 : 0, axis == 0 ? 0 : 1) += 1.0;
+        for (int p = 0; p < coeffs.rows(); ++p) {
+            for (int q = 0; q < coeffs.cols(); ++q) {
+                if (coeffs(p, q) != 0.0) {
+                    terms.push_back({coeffs(p, q), axis + 1.0, static_cast<double>(p),
+                                     static_cast<double>(q)});
+                }
+            }
+        }
+    }
+    ndarray::Array<double, 2, 2> polyCoeffs =
+            ndarray::allocate(ndarray::makeVector(static_cast<int>(terms.size()), 4));
+    for (std::size_t i = 0; i < terms.size(); ++i) {
+        std::copy(terms[i].begin(), terms[i].end(), polyCoeffs[i].begin());
+    }
+    return polyCoeffs;
+}
+
+/*
+ * Return the points at the centers of the cells of a grid covering a box.
+ *
+ * @param bbox the box covered by the grid
+ * @param shape the number of grid cells in x and y
+ */
+std::vector<lsst::geom::Point2D> makeCellCenters(lsst::geom::Box2D const &bbox,
+                                                 lsst::geom::Extent2I const &shape) {
+    std::vector<lsst::geom::Point2D> points;
+    points.reserve(shape.getX() * shape.getY());
+    double const dx = bbox.getWidth() / shape.getX();
+    double const dy = bbox.getHeight() / shape.getY();
+    for (int iy = 0; iy < shape.getY(); ++iy) {
+        for (int ix = 0; ix < shape.getX(); ++ix) {
+            points.emplace_back(bbox.getMinX() + (ix + 0.5) * dx, bbox.getMinY() + (iy + 0.5) * dy);
+        }
+    }
+    return points;
+}
+
 }  // namespace
 
 lsst::geom::AffineTransform linearizeTransform(TransformPoint2ToPoint2 const &original,
@@ -215,6 +268,86 @@ std::shared_ptr<TransformPoint2ToPoint2> makeIdentityTransform() {
     return std::make_shared<TransformPoint2ToPoint2>(ast::UnitMap(2));
 }
 
+TransformApproximation approximateTransform(TransformPoint2ToPoint2 const &original,
+                                            lsst::geom::Box2D const &bbox, double maxError, int maxOrder,
+                                            lsst::geom::Extent2I const &gridShape) {
+    if (bbox.isEmpty() || !(bbox.getArea() > 0)) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "Bounding box must not be empty");
+    }
+    if (!(maxError > 0)) {
+        std::ostringstream buffer;
+        buffer << "Maximum error must be positive; got " << maxError;
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, buffer.str());
+    }
+    if (maxOrder < 1) {
+        std::ostringstream buffer;
+        buffer << "Maximum order must be at least 1; got " << maxOrder;
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, buffer.str());
+    }
+    if (gridShape.getX() <= 0 || gridShape.getY() <= 0 ||
+        static_cast<long>(gridShape.getX()) * gridShape.getY() < (maxOrder + 1) * (maxOrder + 2) / 2) {
+        std::ostringstream buffer;
+        buffer << "Grid shape " << gridShape << " has too few points to fit order " << maxOrder;
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, buffer.str());
+    }
+
+    // Fit to the original shifted so that its output is zero at the center of the box: polynomials
+    // in the output coordinates are then evaluated near their origin, which keeps the inverse well
+    // conditioned. The Jacobian scales outputs to roughly the units of the inputs.
+    lsst::geom::Point2D const center = bbox.getCenter();
+    lsst::geom::AffineTransform const linear = linearizeTransform(original, center);
+    lsst::geom::Extent2D const outCenter(original.applyForward(center));
+    Eigen::Matrix2d const cd = linear.getLinear().getMatrix();
+    if (cd.determinant() == 0.0) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "Transform has a singular Jacobian at the center of the box");
+    }
+    Eigen::Matrix2d const cdInverse = cd.inverse();
+    auto const shifted = original.then(*makeTransform(lsst::geom::AffineTransform(-outCenter)));
+    SipApproximation sip(shifted, center, cd, bbox, gridShape, 1, false);
+
+    // Check each fit at points between those it was fit to
+    std::vector<lsst::geom::Point2D> const testIn = makeCellCenters(bbox, gridShape);
+    std::vector<lsst::geom::Point2D> const testOut = original.applyForward(testIn);
+    for (auto const &point : testOut) {
+        if (!std::isfinite(point.getX()) || !std::isfinite(point.getY())) {
+            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "Transform is not finite over the box");
+        }
+    }
+
+    TransformApproximation best{nullptr, 0, std::numeric_limits<double>::infinity(),
+                                std::numeric_limits<double>::infinity()};
+    for (int order = 1; order <= maxOrder; ++order) {
+        if (order > 1) {
+            sip.fit(order);
+        }
+        ast::PolyMap const poly(makeSipPolyCoeffs(sip.getA(), sip.getB()),
+                                makeSipPolyCoeffs(sip.getAP(), sip.getBP()));
+        auto const mapping = ast::ShiftMap({-center.getX(), -center.getY()})
+                                     .then(poly)
+                                     .then(ast::MatrixMap(toNdArray(cd)))
+                                     .then(ast::ShiftMap({outCenter.getX(), outCenter.getY()}));
+        auto transform = std::make_shared<TransformPoint2ToPoint2>(mapping);
+
+        std::vector<lsst::geom::Point2D> const approxOut = transform->applyForward(testIn);
+        std::vector<lsst::geom::Point2D> const approxIn = transform->applyInverse(testOut);
+        double forwardError = 0.0;
+        double inverseError = 0.0;
+        for (std::size_t i = 0; i < testIn.size(); ++i) {
+            forwardError = std::max(forwardError, (cdInverse * (approxOut[i] - testOut[i]).asEigen()).norm());
+            inverseError = std::max(inverseError, (approxIn[i] - testIn[i]).computeNorm());
+        }
+        if (!best.transform ||
+            std::max(forwardError, inverseError) < std::max(best.maxForwardError, best.maxInverseError)) {
+            best = TransformApproximation{transform, order, forwardError, inverseError};
+        }
+        if (forwardError <= maxError && inverseError <= maxError) {
+            break;
+        }
+    }
+    return best;
+}
+
 }  // namespace geom
 }  // namespace afw
 }  // namespace lsst
@@ -21,9 +21,13 @@
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
 
+#include <cmath>
+#include <limits>
 #include <memory>
+#include <unordered_map>
 
 #include "lsst/afw/image/ApCorrMap.h"
+#include "lsst/afw/math/detail/Parallel.h"
 #include "lsst/afw/table/io/InputArchive.h"
 #include "lsst/afw/table/io/OutputArchive.h"
 #include "lsst/afw/table/io/CatalogVector.h"
@@ -71,6 +75,162 @@ void ApCorrMap::set(std::string const& name, std::shared_ptr<math::BoundedField>
 
 namespace {
 
+std::size_t const NO_MODEL = std::numeric_limits<std::size_t>::max();
+
+// The catalog keys and fields used to correct one flux
+struct ApCorrKeys {
+    table::Key<double> instFlux;
+    table::Key<double> instFluxErr;
+    table::Key<double> apCorr;
+    table::Key<double> apCorrErr;
+    table::Key<table::Flag> flag;
+    std::size_t model;     // index of the correction among the distinct fields
+    std::size_t modelErr;  // index of the correction's uncertainty, or NO_MODEL
+};
+
+template <typename T>
+table::Key<T> findOptional(table::Schema const& schema, std::string const& name) {
+    try {
+        return schema.find<T>(name).key;
+    } catch (pex::exceptions::NotFoundError const&) {
+        return table::Key<T>();
+    }
+}
+
+bool isUsable(double apCorr) { return std::isfinite(apCorr) && apCorr > 0.0; }
+
+}  // namespace
+
+void ApCorrMap::applyToCatalog(table::SourceCatalog& catalog, std::vector<std::string> const& names,
+                               int numThreads) const {
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    table::Schema const schema = catalog.getSchema();
+    auto const& centroidSlot = catalog.getTable()->getCentroidSlot();
+    if (!centroidSlot.isValid()) {
+        throw LSST_EXCEPT(pex::exceptions::NotFoundError,
+                          "Catalog has no centroid slot to evaluate aperture corrections at");
+    }
+
+    // Look everything up before modifying the catalog, evaluating each distinct field only once even
+    // when several fluxes share it
+    std::vector<std::shared_ptr<math::BoundedField>> models;
+    std::unordered_map<math::BoundedField const*, std::size_t> modelIndices;
+    auto addModel = [&models, &modelIndices](std::shared_ptr<math::BoundedField> const& model) {
+        auto const inserted = modelIndices.emplace(model.get(), models.size());
+        if (inserted.second) {
+            models.push_back(model);
+        }
+        return inserted.first->second;
+    };
+    std::vector<ApCorrKeys> keys;
+    keys.reserve(names.size());
+    for (auto const& name : names) {
+        ApCorrKeys k;
+        k.model = addModel((*this)[name + "_instFlux"]);
+        auto const modelErr = get(name + "_instFluxErr");
+        k.modelErr = modelErr ? addModel(modelErr) : NO_MODEL;
+        k.instFlux = schema.find<double>(schema.join(name, "instFlux")).key;
+        k.instFluxErr = findOptional<double>(schema, schema.join(name, "instFluxErr"));
+        k.apCorr = findOptional<double>(schema, schema.join(name, "apCorr"));
+        k.apCorrErr = findOptional<double>(schema, schema.join(name, "apCorrErr"));
+        k.flag = findOptional<table::Flag>(schema, schema.join(name, "flag_apCorr"));
+        keys.push_back(k);
+    }
+    std::size_t const nRecords = catalog.size();
+    if (nRecords == 0) {
+        return;
+    }
+
+    ndarray::Array<double, 1, 1> x = ndarray::allocate(ndarray::makeVector(nRecords));
+    ndarray::Array<double, 1, 1> y = ndarray::allocate(ndarray::makeVector(nRecords));
+    if (catalog.isContiguous()) {
+        auto const columns = catalog.getColumnView();
+        x.deep() = columns[centroidSlot.getMeasKey().getX()];
+        y.deep() = columns[centroidSlot.getMeasKey().getY()];
+    } else {
+        std::size_t i = 0;
+        for (auto const& record : catalog) {
+            auto const point = record.getCentroid();
+            x[i] = point.getX();
+            y[i] = point.getY();
+            ++i;
+        }
+    }
+
+    // ndarray's reference counts are not thread-safe, so when the fields are evaluated concurrently
+    // each gets its own copy of the positions, and its result is the only array its thread touches
+    std::vector<ndarray::Array<double, 1, 1>> xs(models.size(), x);
+    std::vector<ndarray::Array<double, 1, 1>> ys(models.size(), y);
+    if (nThreads > 1) {
+        for (std::size_t i = 0; i < models.size(); ++i) {
+            xs[i] = ndarray::copy(x);
+            ys[i] = ndarray::copy(y);
+        }
+    }
+    std::vector<ndarray::Array<double, 1, 1>> values(models.size());
+    math::detail::parallelFor(static_cast<int>(models.size()), nThreads,
+                              [&](int i) { values[i] = models[i]->evaluate(xs[i], ys[i]); });
+
+    if (catalog.isContiguous()) {
+        auto const columns = catalog.getColumnView();
+        for (auto const& k : keys) {
+            ndarray::Array<double, 1, 1> const& apCorr = values[k.model];
+            ndarray::ArrayRef<double, 1> const instFlux = columns[k.instFlux];
+            for (std::size_t i = 0; i < nRecords; ++i) {
+                if (isUsable(apCorr[i])) {
+                    instFlux[i] *= apCorr[i];
+                }
+            }
+            if (k.instFluxErr.isValid()) {
+                ndarray::ArrayRef<double, 1> const instFluxErr = columns[k.instFluxErr];
+                for (std::size_t i = 0; i < nRecords; ++i) {
+                    if (isUsable(apCorr[i])) {
+                        instFluxErr[i] *= apCorr[i];
+                    }
+                }
+            }
+            if (k.apCorr.isValid()) {
+                columns[k.apCorr] = apCorr;
+            }
+            if (k.apCorrErr.isValid() && k.modelErr != NO_MODEL) {
+                columns[k.apCorrErr] = values[k.modelErr];
+            }
+        }
+    } else {
+        std::size_t i = 0;
+        for (auto& record : catalog) {
+            for (auto const& k : keys) {
+                double const apCorr = values[k.model][i];
+                if (isUsable(apCorr)) {
+                    record.set(k.instFlux, record.get(k.instFlux) * apCorr);
+                    if (k.instFluxErr.isValid()) {
+                        record.set(k.instFluxErr, record.get(k.instFluxErr) * apCorr);
+                    }
+                }
+                if (k.apCorr.isValid()) {
+                    record.set(k.apCorr, apCorr);
+                }
+                if (k.apCorrErr.isValid() && k.modelErr != NO_MODEL) {
+                    record.set(k.apCorrErr, values[k.modelErr][i]);
+                }
+            }
+            ++i;
+        }
+    }
+    // Flags can't be written through column views
+    for (auto const& k : keys) {
+        if (k.flag.isValid()) {
+            std::size_t i = 0;
+            for (auto& record : catalog) {
+                record.set(k.flag, !isUsable(values[k.model][i]));
+                ++i;
+            }
+        }
+    }
+}
+
+namespace {
+
 struct PersistenceHelper {
     table::Schema schema;
     table::Key<std::string> name;
@@ -0,0 +1,278 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <utility>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/image/CoaddInputsIndex.h"
+#include "lsst/afw/table/io/CatalogVector.h"
+#include "lsst/afw/table/io/InputArchive.h"
+#include "lsst/afw/table/io/OutputArchive.h"
+#include "lsst/afw/table/io/Persistable.cc"
+
+namespace lsst {
+namespace afw {
+
+template std::shared_ptr<image::CoaddInputsIndex>
+table::io::PersistableFacade<image::CoaddInputsIndex>::dynamicCast(
+        std::shared_ptr<table::io::Persistable> const&);
+
+namespace image {
+
+namespace {
+
+using geom::polygon::Polygon;
+
+// Number of points along each edge of a region at which it is mapped into the coadd frame.
+constexpr std::size_t EDGE_SAMPLES = 8;
+
+// Maximum number of records in a leaf of the tree.
+constexpr std::size_t LEAF_SIZE = 8;
+
+// Map a polygon in a record's pixel frame into the coadd pixel frame, or return an empty pointer if
+// that is not possible.
+std::shared_ptr<Polygon const> projectPolygon(Polygon const& polygon,
+                                              geom::TransformPoint2ToPoint2 const& toCoadd) {
+    std::vector<lsst::geom::Point2D> vertices;
+    try {
+        vertices = toCoadd.applyForward(polygon.subSample(EDGE_SAMPLES)->getVertices());
+    } catch (pex::exceptions::Exception&) {
+        return nullptr;
+    }
+    for (auto const& vertex : vertices) {
+        if (!std::isfinite(vertex.getX()) || !std::isfinite(vertex.getY())) {
+            return nullptr;
+        }
+    }
+    return std::make_shared<Polygon>(vertices);
+}
+
+struct PersistenceHelper {
+    table::Schema schema;
+    table::Key<int> polygon;
+
+    static PersistenceHelper const& get() {
+        static PersistenceHelper const instance;
+        return instance;
+    }
+
+private:
+    PersistenceHelper()
+            : schema(),
+              polygon(schema.addField<int>("polygon",
+                                           "archive ID of the record's region in the coadd pixel frame")) {}
+};
+
+std::string getCoaddInputsIndexPersistenceName() { return "CoaddInputsIndex"; }
+
+}  // namespace
+
+class CoaddInputsIndexFactory : public table::io::PersistableFactory {
+public:
+    std::shared_ptr<table::io::Persistable> read(InputArchive const& archive,
+                                                 CatalogVector const& catalogs) const override {
+        PersistenceHelper const& keys = PersistenceHelper::get();
+        LSST_ARCHIVE_ASSERT(catalogs.size() == 2u);
+        LSST_ARCHIVE_ASSERT(catalogs.back().getSchema() == keys.schema);
+        auto catalog = table::ExposureCatalog::readFromArchive(archive, catalogs.front());
+        LSST_ARCHIVE_ASSERT(catalogs.back().size() == catalog.size());
+        std::vector<std::shared_ptr<Polygon const>> polygons;
+        polygons.reserve(catalog.size());
+        for (auto const& record : catalogs.back()) {
+            polygons.push_back(archive.get<Polygon>(record.get(keys.polygon)));
+        }
+        return std::shared_ptr<CoaddInputsIndex>(new CoaddInputsIndex(catalog, std::move(polygons)));
+    }
+
+    explicit CoaddInputsIndexFactory(std::string const& name) : table::io::PersistableFactory(name) {}
+};
+
+namespace {
+
+CoaddInputsIndexFactory registration(getCoaddInputsIndexPersistenceName());
+
+}  // namespace
+
+CoaddInputsIndex::CoaddInputsIndex(table::ExposureCatalog const& catalog, geom::SkyWcs const& coaddWcs,
+                                   bool includeValidPolygon)
+        : _catalog(catalog) {
+    _polygons.reserve(_catalog.size());
+    for (auto const& record : _catalog) {
+        if (!record.getWcs()) {
+            throw LSST_EXCEPT(pex::exceptions::LogicError,
+                              "ExposureRecord does not have a Wcs; cannot build a CoaddInputsIndex");
+        }
+        if (record.getBBox().isEmpty()) {
+            _polygons.emplace_back();
+            continue;
+        }
+        auto const toCoadd = geom::makeWcsPairTransform(*record.getWcs(), coaddWcs);
+        auto region = projectPolygon(Polygon(lsst::geom::Box2D(record.getBBox())), *toCoadd);
+        if (region && includeValidPolygon && record.getValidPolygon()) {
+            // A point must be in both the bounding box and the valid polygon, as in
+            // ExposureRecord::contains.
+            auto const valid = projectPolygon(*record.getValidPolygon(), *toCoadd);
+            try {
+                region = valid ? region->intersectionSingle(*valid) : nullptr;
+            } catch (geom::polygon::SinglePolygonException&) {
+                region = nullptr;  // the valid polygon is outside the bounding box
+            }
+        }
+        _polygons.push_back(std::move(region));
+    }
+    _build();
+}
+
+CoaddInputsIndex::CoaddInputsIndex(table::ExposureCatalog const& catalog,
+                                   std::vector<std::shared_ptr<Polygon const>> polygons)
+        : _catalog(catalog), _polygons(std::move(polygons)) {
+    _build();
+}
+
+void CoaddInputsIndex::_build() {
+    _boxes.reserve(_polygons.size());
+    for (std::size_t i = 0; i < _polygons.size(); ++i) {
+        if (_polygons[i]) {
+            _boxes.push_back(_polygons[i]->getBBox());
+            _order.push_back(i);
+        } else {
+            _boxes.emplace_back();
+        }
+    }
+    if (!_order.empty()) {
+        _nodes.reserve(2 * (_order.size() / LEAF_SIZE + 1));
+        _build(0, _order.size());
+    }
+}
+
+int CoaddInputsIndex::_build(std::size_t begin, std::size_t end) {
+    lsst::geom::Box2D bbox;
+    for (std::size_t k = begin; k < end; ++k) {
+        bbox.include(_boxes[_order[k]]);
+    }
+    int const index = static_cast<int>(_nodes.size());
+    _nodes.push_back(Node{bbox, begin, end, -1, -1});
+    if (end - begin <= LEAF_SIZE) {
+        return index;
+    }
+    // Split the records at the median of their centers along the axis on which the node is widest.
+    int const axis = bbox.getWidth() >= bbox.getHeight() ? 0 : 1;
+    std::size_t const middle = begin + (end - begin) / 2;
+    std::nth_element(_order.begin() + begin, _order.begin() + middle, _order.begin() + end,
+                     [this, axis](std::size_t a, std::size_t b) {
+                         return _boxes[a].getCenter()[axis] < _boxes[b].getCenter()[axis];
+                     });
+    int const left = _build(begin, middle);
+    int const right = _build(middle, end);
+    _nodes[index].left = left;
+    _nodes[index].right = right;
+    return index;
+}
+
+std::shared_ptr<Polygon const> CoaddInputsIndex::getPolygon(std::size_t i) const {
+    if (i >= _polygons.size()) {
+        std::ostringstream os;
+        os << "Index " << i << " out of range for CoaddInputsIndex of size " << _polygons.size();
+        throw LSST_EXCEPT(pex::exceptions::OutOfRangeError, os.str());
+    }
+    return _polygons[i];
+}
+
+std::vector<std::size_t> CoaddInputsIndex::findContaining(lsst::geom::Point2D const& position) const {
+    std::vector<std::size_t> result;
+    if (_nodes.empty()) {
+        return result;
+    }
+    std::vector<int> stack(1, 0);
+    while (!stack.empty()) {
+        Node const& node = _nodes[stack.back()];
+        stack.pop_back();
+        if (!node.bbox.contains(position)) {
+            continue;
+        }
+        if (node.left >= 0) {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+            continue;
+        }
+        for (std::size_t k = node.begin; k < node.end; ++k) {
+            std::size_t const i = _order[k];
+            if (_boxes[i].contains(position) && _polygons[i]->contains(position)) {
+                result.push_back(i);
+            }
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<std::vector<std::size_t>> CoaddInputsIndex::findContaining(
+        std::vector<lsst::geom::Point2D> const& positions) const {
+    std::vector<std::vector<std::size_t>> result;
+    result.reserve(positions.size());
+    for (auto const& position : positions) {
+        result.push_back(findContaining(position));
+    }
+    return result;
+}
+
+table::ExposureCatalog CoaddInputsIndex::subsetContaining(lsst::geom::Point2D const& position) const {
+    table::ExposureCatalog result(_catalog.getTable());
+    for (std::size_t i : findContaining(position)) {
+        result.push_back(_catalog.get(i));
+    }
+    return result;
+}
+
+std::vector<table::ExposureCatalog> CoaddInputsIndex::subsetContaining(
+        std::vector<lsst::geom::Point2D> const& positions) const {
+    std::vector<table::ExposureCatalog> result;
+    result.reserve(positions.size());
+    for (auto const& position : positions) {
+        result.push_back(subsetContaining(position));
+    }
+    return result;
+}
+
+std::string CoaddInputsIndex::getPersistenceName() const { return getCoaddInputsIndexPersistenceName(); }
+
+std::string CoaddInputsIndex::getPythonModule() const { return "lsst.afw.image"; }
+
+void CoaddInputsIndex::write(OutputArchiveHandle& handle) const {
+    PersistenceHelper const& keys = PersistenceHelper::get();
+    _catalog.writeToArchive(handle, true);  // true == permissive, as for CoaddInputs
+    table::BaseCatalog catalog = handle.makeCatalog(keys.schema);
+    for (auto const& polygon : _polygons) {
+        std::shared_ptr<table::BaseRecord> record = catalog.addNew();
+        record->set(keys.polygon, handle.put(polygon));
+    }
+    handle.saveCatalog(catalog);
+}
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
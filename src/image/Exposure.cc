@@ -173,9 +173,10 @@ void Exposure<ImageT, MaskT, VarianceT>::writeFits(fits::Fits &fitsfile,
                                                    fits::ImageWriteOptions const &maskOptions,
                                                    fits::ImageWriteOptions const &varianceOptions) const {
     ExposureInfo::FitsWriteData data = _info->_startWriteFits(getXY0());
+    // The archive does not depend on the pixels, so it may be written concurrently with them
     _maskedImage.writeFits(fitsfile, imageOptions, maskOptions, varianceOptions, data.metadata,
-                           data.imageMetadata, data.maskMetadata, data.varianceMetadata);
-    _info->_finishWriteFits(fitsfile, data);
+                           data.imageMetadata, data.maskMetadata, data.varianceMetadata,
+                           [this, &data](fits::Fits &file) { _info->_finishWriteFits(file, data); });
 }
 
 namespace {
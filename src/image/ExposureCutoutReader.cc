@@ -0,0 +1,184 @@
+/*
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/fits.h"
+#include "lsst/afw/math/detail/Parallel.h"
+#include "lsst/afw/image/ExposureCutoutReader.h"
+
+namespace lsst {
+namespace afw {
+namespace image {
+
+struct ExposureCutoutReader::Entry {
+    explicit Entry(std::string const& fileName_)
+            : fileName(fileName_), reader(std::make_shared<ExposureFitsReader>(fileName_)) {}
+
+    std::string const fileName;
+    std::shared_ptr<ExposureFitsReader> const reader;
+    std::shared_ptr<ExposureInfo> info;  // read with the first Exposure cutout from the file
+};
+
+ExposureCutoutReader::ExposureCutoutReader(int maxOpenFiles, int numThreads)
+        : _maxOpenFiles(maxOpenFiles), _numThreads(numThreads) {
+    if (maxOpenFiles < 1) {
+        std::ostringstream os;
+        os << "maxOpenFiles must be >= 1; got " << maxOpenFiles;
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, os.str());
+    }
+    math::detail::resolveNumThreads(numThreads);  // check it now, rather than on the first read
+}
+
+ExposureCutoutReader::~ExposureCutoutReader() noexcept = default;
+
+std::shared_ptr<ExposureCutoutReader::Entry> ExposureCutoutReader::_acquire(std::string const& fileName) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto const mapIter = _entryMap.find(fileName);
+        if (mapIter != _entryMap.end()) {
+            _entryList.splice(_entryList.begin(), _entryList, mapIter->second);
+            return *mapIter->second;
+        }
+    }
+    // Open the file without holding the lock, so other files can be looked up meanwhile
+    auto entry = std::make_shared<Entry>(fileName);
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entryList.push_front(entry);
+    _entryMap[fileName] = _entryList.begin();
+    while (static_cast<int>(_entryList.size()) > _maxOpenFiles) {
+        // A reader still in use elsewhere in this batch is closed when it is released
+        _entryMap.erase(_entryList.back()->fileName);
+        _entryList.pop_back();
+    }
+    return entry;
+}
+
+std::shared_ptr<ExposureFitsReader> ExposureCutoutReader::getReader(std::string const& fileName) {
+    return _acquire(fileName)->reader;
+}
+
+std::size_t ExposureCutoutReader::getNumOpenFiles() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entryList.size();
+}
+
+void ExposureCutoutReader::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entryMap.clear();
+    _entryList.clear();
+}
+
+template <typename ReadOne>
+void ExposureCutoutReader::_forEachRequest(std::vector<std::string> const& fileNames,
+                                           std::vector<lsst::geom::Box2I> const& bboxes, bool needInfo,
+                                           ReadOne const& readOne) {
+    if (fileNames.size() != bboxes.size()) {
+        std::ostringstream os;
+        os << "Got " << fileNames.size() << " file names but " << bboxes.size() << " boxes";
+        throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
+    }
+    // Group the requests by file, in order of first appearance
+    std::vector<std::string> groupFiles;
+    std::vector<std::vector<std::size_t>> groups;
+    std::map<std::string, std::size_t> groupIndices;
+    for (std::size_t i = 0; i < fileNames.size(); ++i) {
+        auto const inserted = groupIndices.emplace(fileNames[i], groups.size());
+        if (inserted.second) {
+            groupFiles.push_back(fileNames[i]);
+            groups.emplace_back();
+        }
+        groups[inserted.first->second].push_back(i);
+    }
+
+    int const nThreads = fits::isCfitsioThreadSafe() ? math::detail::resolveNumThreads(_numThreads) : 1;
+    math::detail::parallelFor(static_cast<int>(groups.size()), nThreads, [&](int iGroup) {
+        auto const entry = _acquire(groupFiles[iGroup]);
+        if (needInfo && !entry->info) {
+            // Read the archive in the background while the first cutout's pixels are read
+            entry->reader->prefetch();
+        }
+        for (std::size_t i : groups[iGroup]) {
+            readOne(*entry, i);
+        }
+    });
+}
+
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+std::vector<Exposure<ImagePixelT, MaskPixelT, VariancePixelT>> ExposureCutoutReader::read(
+        std::vector<std::string> const& fileNames, std::vector<lsst::geom::Box2I> const& bboxes,
+        ImageOrigin origin, bool conformMasks, bool allowUnsafe) {
+    using ExposureT = Exposure<ImagePixelT, MaskPixelT, VariancePixelT>;
+    std::vector<std::unique_ptr<ExposureT>> cutouts(fileNames.size());
+    _forEachRequest(fileNames, bboxes, true, [&](Entry& entry, std::size_t i) {
+        auto mi = entry.reader->readMaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>(
+                bboxes[i], origin, conformMasks, allowUnsafe);
+        if (!entry.info) {
+            entry.info = entry.reader->readExposureInfo();
+        }
+        cutouts[i] = std::make_unique<ExposureT>(mi, std::make_shared<ExposureInfo>(*entry.info, true));
+    });
+    std::vector<ExposureT> result;
+    result.reserve(cutouts.size());
+    for (auto& cutout : cutouts) {
+        result.push_back(std::move(*cutout));
+    }
+    return result;
+}
+
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+std::vector<MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>> ExposureCutoutReader::readMaskedImages(
+        std::vector<std::string> const& fileNames, std::vector<lsst::geom::Box2I> const& bboxes,
+        ImageOrigin origin, bool conformMasks, bool allowUnsafe) {
+    using MaskedImageT = MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>;
+    std::vector<std::unique_ptr<MaskedImageT>> cutouts(fileNames.size());
+    _forEachRequest(fileNames, bboxes, false, [&](Entry& entry, std::size_t i) {
+        cutouts[i] = std::make_unique<MaskedImageT>(
+                entry.reader->readMaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>(
+                        bboxes[i], origin, conformMasks, allowUnsafe));
+    });
+    std::vector<MaskedImageT> result;
+    result.reserve(cutouts.size());
+    for (auto& cutout : cutouts) {
+        result.push_back(std::move(*cutout));
+    }
+    return result;
+}
+
+#define INSTANTIATE(ImagePixelT)                                                                      \
+    template std::vector<Exposure<ImagePixelT, MaskPixel, VariancePixel>> ExposureCutoutReader::read( \
+            std::vector<std::string> const&, std::vector<lsst::geom::Box2I> const&, ImageOrigin, bool, \
+            bool);                                                                                    \
+    template std::vector<MaskedImage<ImagePixelT, MaskPixel, VariancePixel>>                          \
+    ExposureCutoutReader::readMaskedImages(std::vector<std::string> const&,                           \
+                                           std::vector<lsst::geom::Box2I> const&, ImageOrigin, bool,  \
+                                           bool);
+
+INSTANTIATE(std::uint16_t);
+INSTANTIATE(int);
+INSTANTIATE(float);
+INSTANTIATE(double);
+INSTANTIATE(std::uint64_t);
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
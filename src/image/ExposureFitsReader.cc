@@ -19,6 +19,9 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <filesystem>
+#include <future>
 #include <map>
 #include <optional>
 #include <regex>
@@ -34,6 +37,7 @@
 #include "lsst/afw/detection/Psf.h"
 #include "lsst/afw/image/TransmissionCurve.h"
 #include "lsst/afw/image/ExposureFitsReader.h"
+#include "lsst/afw/math/ExecutionContext.h"
 
 namespace lsst {
 namespace afw {
@@ -360,14 +364,57 @@ public:
         return result;
     }
 
+    /// Return whether a known component was written to the archive.
+    bool hasComponent(Component c) const { return _state != ArchiveState::MISSING && _ids[c] != 0; }
+
+    /// Return the names of the components that are stored using arbitrary-component support.
+    std::set<std::string> const& getExtraComponentNames() const { return _extraIds; }
+
+    /**
+     * Start reading the archive on another thread.
+     *
+     * @param fileName The file from which to read the archive; it is opened
+     *                 again, so it must be on disk.  Must match the metadata
+     *                 used to construct this object.
+     *
+     * Only the archive's catalogs are read in the background; components
+     * are still unpersisted when they are requested, since their factories
+     * may be implemented in Python.  Does nothing if parallel afw calls on
+     * this thread are limited to one thread (see math::ExecutionContext).
+     */
+    void prefetch(std::string const& fileName) {
+        if (_state != ArchiveState::PRESENT || _pending.valid() || math::getCurrentMaxNumThreads() == 1) {
+            return;
+        }
+        _pending = std::async(std::launch::async, [fileName, hdu = _hdu]() {
+            afw::fits::Fits fitsFile(fileName, "r",
+                                     afw::fits::Fits::AUTO_CLOSE | afw::fits::Fits::AUTO_CHECK);
+            fitsFile.setHdu(hdu);
+            return table::io::InputArchive::readFits(fitsFile);
+        });
+    }
+
+    /// Block until a read started by prefetch() has finished.
+    void waitForPrefetch() const {
+        if (_pending.valid()) {
+            _pending.wait();
+        }
+    }
+
 private:
     bool _ensureLoaded(afw::fits::Fits* fitsFile) {
         if (_state == ArchiveState::MISSING) {
             return false;
         }
         if (_state == ArchiveState::PRESENT) {
-            afw::fits::HduMoveGuard guard(*fitsFile, _hdu);
-            _archive = table::io::InputArchive::readFits(*fitsFile);
+            if (_pending.valid()) {
+                // If the background read failed, get() throws and leaves _pending
+                // invalid, so a later call reads the archive here instead
+                _archive = _pending.get();
+            } else {
+                afw::fits::HduMoveGuard guard(*fitsFile, _hdu);
+                _archive = table::io::InputArchive::readFitsLazy(*fitsFile);
+            }
             _state = ArchiveState::LOADED;
         }
         assert(_state == ArchiveState::LOADED);  // constructor body should guarantee it's not UNKNOWN
@@ -379,15 +426,36 @@ private:
     int _hdu = 0;
     ArchiveState _state = ArchiveState::UNKNOWN;
     table::io::InputArchive _archive;
+    std::future<table::io::InputArchive> _pending;  // archive being read by prefetch()
     std::array<int, N_ARCHIVE_COMPONENTS> _ids = {0};
     std::map<std::string, int> _genericIds;
     std::set<std::string> _extraIds;  // _genericIds not included in _ids
 };
 
+// Reads the components of a lazy ExposureInfo, through its own reader on the file
+class ExposureFitsReader::LazyComponentReader final : public ExposureInfo::LazyComponentReader {
+public:
+    explicit LazyComponentReader(std::string fileName) : _fileName(std::move(fileName)) {}
+
+    std::shared_ptr<typehandling::Storable const> readComponent(std::string const& id) override {
+        if (!_reader) {
+            _reader = std::make_unique<ExposureFitsReader>(_fileName);
+        }
+        return _reader->_readInfoComponent(id);
+    }
+
+private:
+    std::string _fileName;
+    std::unique_ptr<ExposureFitsReader> _reader;
+};
+
 ExposureFitsReader::ExposureFitsReader(std::string const& fileName) : _maskedImageReader(fileName) {}
 
 ExposureFitsReader::ExposureFitsReader(fits::MemFileManager& manager) : _maskedImageReader(manager) {}
 
+ExposureFitsReader::ExposureFitsReader(std::shared_ptr<fits::ByteRangeCache> cache)
+        : _maskedImageReader(std::move(cache)) {}
+
 ExposureFitsReader::ExposureFitsReader(fits::Fits* fitsFile) : _maskedImageReader(fitsFile) {}
 
 ExposureFitsReader::~ExposureFitsReader() noexcept = default;
@@ -411,6 +479,20 @@ std::string ExposureFitsReader::readMaskDType() const { return _maskedImageReade
 
 std::string ExposureFitsReader::readVarianceDType() const { return _maskedImageReader.readVarianceDType(); }
 
+void ExposureFitsReader::prefetch() {
+    _ensureReaders();
+    std::string const fileName = getFileName();
+    if (fits::isCfitsioThreadSafe() && std::filesystem::is_regular_file(fileName)) {
+        _archiveReader->prefetch(fileName);
+    }
+}
+
+void ExposureFitsReader::waitForPrefetch() const {
+    if (_archiveReader) {
+        _archiveReader->waitForPrefetch();
+    }
+}
+
 std::shared_ptr<daf::base::PropertyList> ExposureFitsReader::readMetadata() {
     _ensureReaders();
     return _metadataReader->metadata;
@@ -495,86 +577,127 @@ std::map<std::string, std::shared_ptr<table::io::Persistable>> ExposureFitsReade
     return _archiveReader->readExtraComponents(_getFitsFile());
 }
 
-std::shared_ptr<ExposureInfo> ExposureFitsReader::readExposureInfo() {
+std::shared_ptr<ExposureInfo> ExposureFitsReader::readExposureInfo(bool lazyComponents) {
     auto result = std::make_shared<ExposureInfo>();
     result->setMetadata(readMetadata());
-    result->setPhotoCalib(readPhotoCalib());
     result->setVisitInfo(readVisitInfo());
     // Override ID set in visitInfo, if necessary
     std::optional<table::RecordId> exposureId = readExposureId();
     if (exposureId) {
         result->setId(*exposureId);
     }
-    // When reading an ExposureInfo (as opposed to reading individual
-    // components), we warn and try to proceed when a component is present
-    // but can't be read due its serialization factory not being set up
-    // (that's what throws the NotFoundErrors caught below).
-    try {
-        result->setPsf(readPsf());
-    } catch (pex::exceptions::NotFoundError& err) {
-        LOGLS_WARN(_log, "Could not read PSF; setting to null: " << err.what());
-    }
-    try {
-        result->setCoaddInputs(readCoaddInputs());
-    } catch (pex::exceptions::NotFoundError& err) {
-        LOGLS_WARN(_log, "Could not read CoaddInputs; setting to null: " << err.what());
+    std::vector<std::string> const ids = _getInfoComponentIds();
+    std::string const fileName = getFileName();
+    if (lazyComponents && std::filesystem::is_regular_file(fileName)) {
+        result->setLazyComponents(std::make_shared<LazyComponentReader>(fileName), ids);
+    } else {
+        for (std::string const& id : ids) {
+            using StorablePtr = std::shared_ptr<typehandling::Storable const>;
+            result->setComponent(typehandling::makeKey<StorablePtr>(id), _readInfoComponent(id));
+        }
     }
-    try {
-        result->setApCorrMap(readApCorrMap());
-    } catch (pex::exceptions::NotFoundError& err) {
-        LOGLS_WARN(_log, "Could not read ApCorrMap; setting to null: " << err.what());
+    return result;
+}
+
+std::vector<std::string> ExposureFitsReader::_getInfoComponentIds() {
+    _ensureReaders();
+    std::vector<std::string> result;
+    auto addIfPresent = [this, &result](std::string const& id, ArchiveReader::Component c) {
+        if (_archiveReader->hasComponent(c)) {
+            result.push_back(id);
+        }
+    };
+    addIfPresent(ExposureInfo::KEY_PSF.getId(), ArchiveReader::PSF);
+    addIfPresent(ExposureInfo::KEY_COADD_INPUTS.getId(), ArchiveReader::COADD_INPUTS);
+    addIfPresent(ExposureInfo::KEY_AP_CORR_MAP.getId(), ArchiveReader::AP_CORR_MAP);
+    addIfPresent(ExposureInfo::KEY_VALID_POLYGON.getId(), ArchiveReader::VALID_POLYGON);
+    addIfPresent(ExposureInfo::KEY_TRANSMISSION_CURVE.getId(), ArchiveReader::TRANSMISSION_CURVE);
+    addIfPresent(ExposureInfo::KEY_DETECTOR.getId(), ArchiveReader::DETECTOR);
+    if (_metadataReader->version == 0) {
+        if (_metadataReader->photoCalib) {
+            result.push_back(ExposureInfo::KEY_PHOTO_CALIB.getId());
+        }
+    } else {
+        addIfPresent(ExposureInfo::KEY_PHOTO_CALIB.getId(), ArchiveReader::PHOTOCALIB);
     }
-    try {
-        result->setValidPolygon(readValidPolygon());
-    } catch (pex::exceptions::NotFoundError& err) {
-        LOGLS_WARN(_log, "Could not read ValidPolygon; setting to null: " << err.what());
+    if (_metadataReader->wcs || _archiveReader->hasComponent(ArchiveReader::WCS)) {
+        result.push_back(ExposureInfo::KEY_WCS.getId());
     }
-    try {
-        result->setTransmissionCurve(readTransmissionCurve());
-    } catch (pex::exceptions::NotFoundError& err) {
-        LOGLS_WARN(_log, "Could not read TransmissionCurve; setting to null: " << err.what());
+    for (std::string const& name : _archiveReader->getExtraComponentNames()) {
+        result.push_back(name);
     }
-    try {
-        result->setDetector(readDetector());
-    } catch (pex::exceptions::NotFoundError& err) {
-        LOGLS_WARN(_log, "Could not read Detector; setting to null: " << err.what());
+    // Convert old-style Filter to new-style FilterLabel
+    // In newer versions this is one of the extra components
+    std::string const& filterId = ExposureInfo::KEY_FILTER.getId();
+    if (_metadataReader->version < 2 && _metadataReader->filterLabel &&
+        std::find(result.begin(), result.end(), filterId) == result.end()) {
+        result.push_back(filterId);
     }
-    // In the case of WCS, we fall back to the metadata WCS if the one from
-    // the archive can't be read.
+    return result;
+}
+
+std::shared_ptr<typehandling::Storable const> ExposureFitsReader::_readInfoComponent(std::string const& id) {
+    using StorablePtr = std::shared_ptr<typehandling::Storable const>;
     _ensureReaders();
-    result->setWcs(_metadataReader->wcs);
-    try {
-        auto wcs = _archiveReader->readComponent<afw::geom::SkyWcs>(_getFitsFile(), ArchiveReader::WCS);
-        if (!wcs) {
-            LOGLS_DEBUG(_log, "No WCS found in binary table");
-        } else {
-            result->setWcs(wcs);
+    // When reading an ExposureInfo (as opposed to reading individual
+    // components), we warn and try to proceed when a component is present
+    // but can't be read due its serialization factory not being set up
+    // (that's what throws the NotFoundErrors caught below).
+    auto readOrWarn = [](auto read, char const* name) -> StorablePtr {
+        try {
+            return read();
+        } catch (pex::exceptions::NotFoundError& err) {
+            LOGLS_WARN(_log, "Could not read " << name << "; setting to null: " << err.what());
+            return nullptr;
         }
-    } catch (pex::exceptions::NotFoundError& err) {
-        auto msg = str(boost::format("Could not read WCS extension; setting to null: %s") % err.what());
-        if (result->hasWcs()) {
-            msg += " ; using WCS from FITS header";
+    };
+    if (id == ExposureInfo::KEY_PSF.getId()) {
+        return readOrWarn([this]() { return readPsf(); }, "PSF");
+    } else if (id == ExposureInfo::KEY_COADD_INPUTS.getId()) {
+        return readOrWarn([this]() { return readCoaddInputs(); }, "CoaddInputs");
+    } else if (id == ExposureInfo::KEY_AP_CORR_MAP.getId()) {
+        return readOrWarn([this]() { return readApCorrMap(); }, "ApCorrMap");
+    } else if (id == ExposureInfo::KEY_VALID_POLYGON.getId()) {
+        return readOrWarn([this]() { return readValidPolygon(); }, "ValidPolygon");
+    } else if (id == ExposureInfo::KEY_TRANSMISSION_CURVE.getId()) {
+        return readOrWarn([this]() { return readTransmissionCurve(); }, "TransmissionCurve");
+    } else if (id == ExposureInfo::KEY_DETECTOR.getId()) {
+        return readOrWarn([this]() { return readDetector(); }, "Detector");
+    } else if (id == ExposureInfo::KEY_PHOTO_CALIB.getId()) {
+        return readPhotoCalib();
+    } else if (id == ExposureInfo::KEY_WCS.getId()) {
+        // In the case of WCS, we fall back to the metadata WCS if the one from
+        // the archive can't be read.
+        try {
+            auto wcs = _archiveReader->readComponent<afw::geom::SkyWcs>(_getFitsFile(), ArchiveReader::WCS);
+            if (wcs) {
+                return wcs;
+            }
+            LOGLS_DEBUG(_log, "No WCS found in binary table");
+        } catch (pex::exceptions::NotFoundError& err) {
+            auto msg = str(boost::format("Could not read WCS extension; setting to null: %s") % err.what());
+            if (_metadataReader->wcs) {
+                msg += " ; using WCS from FITS header";
+            }
+            LOGLS_WARN(_log, msg);
         }
-        LOGLS_WARN(_log, msg);
+        return _metadataReader->wcs;
+    } else if (id == ExposureInfo::KEY_FILTER.getId() && _metadataReader->version < 2) {
+        return readFilter();
     }
-    for (const auto& keyValue : readExtraComponents()) {
-        using StorablePtr = std::shared_ptr<typehandling::Storable const>;
-        std::string key = keyValue.first;
-        StorablePtr object = std::dynamic_pointer_cast<StorablePtr::element_type>(keyValue.second);
-
-        if (object.use_count() > 0) {  // Failed cast guarantees empty pointer, but not a null one
-            result->setComponent(typehandling::makeKey<StorablePtr>(key), object);
-        } else {
-            LOGLS_WARN(_log, "Data corruption: generic component " << key << " is not a Storable; skipping.");
-        }
+    std::shared_ptr<table::io::Persistable> persistable;
+    try {
+        persistable = _archiveReader->readComponent<table::io::Persistable>(_getFitsFile(), id);
+    } catch (pex::exceptions::NotFoundError const& err) {
+        LOGLS_WARN(_log, "Could not read component " << id << "; skipping: " << err.what());
+        return nullptr;
     }
-    // Convert old-style Filter to new-style FilterLabel
-    // In newer versions this is handled by readExtraComponents()
-    if (_metadataReader->version < 2 && !result->hasFilter()) {
-        result->setFilter(readFilter());
+    StorablePtr object = std::dynamic_pointer_cast<StorablePtr::element_type>(persistable);
+    if (persistable && object.use_count() == 0) {  // Failed cast guarantees empty pointer, but not a null one
+        LOGLS_WARN(_log, "Data corruption: generic component " << id << " is not a Storable; skipping.");
     }
-    return result;
-}  // namespace image
+    return object;
+}
 
 template <typename ImagePixelT>
 Image<ImagePixelT> ExposureFitsReader::readImage(lsst::geom::Box2I const& bbox, ImageOrigin origin,
@@ -625,10 +748,11 @@ template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
 Exposure<ImagePixelT, MaskPixelT, VariancePixelT> ExposureFitsReader::read(lsst::geom::Box2I const& bbox,
                                                                            ImageOrigin origin,
                                                                            bool conformMasks,
-                                                                           bool allowUnsafe) {
+                                                                           bool allowUnsafe,
+                                                                           bool lazyComponents) {
     auto mi =
             readMaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>(bbox, origin, conformMasks, allowUnsafe);
-    return Exposure<ImagePixelT, MaskPixelT, VariancePixelT>(mi, readExposureInfo());
+    return Exposure<ImagePixelT, MaskPixelT, VariancePixelT>(mi, readExposureInfo(lazyComponents));
 }
 
 void ExposureFitsReader::_ensureReaders() {
@@ -644,7 +768,7 @@ void ExposureFitsReader::_ensureReaders() {
 
 #define INSTANTIATE(ImagePixelT)                                                                            \
     template Exposure<ImagePixelT, MaskPixel, VariancePixel> ExposureFitsReader::read(                      \
-            lsst::geom::Box2I const&, ImageOrigin, bool, bool);                                             \
+            lsst::geom::Box2I const&, ImageOrigin, bool, bool, bool);                                       \
     template Image<ImagePixelT> ExposureFitsReader::readImage(lsst::geom::Box2I const&, ImageOrigin, bool); \
     template ndarray::Array<ImagePixelT, 2, 2> ExposureFitsReader::readImageArray(lsst::geom::Box2I const&, \
                                                                                   ImageOrigin, bool);       \
@@ -22,6 +22,9 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
+#include <utility>
+
 #include "lsst/pex/exceptions.h"
 #include "lsst/log/Log.h"
 #include "lsst/afw/image/ExposureInfo.h"
@@ -184,8 +187,7 @@ ExposureInfo::ExposureInfo(std::shared_ptr<geom::SkyWcs const> const& wcs,
         : _exposureId(),
           _metadata(metadata ? metadata
                              : std::shared_ptr<daf::base::PropertySet>(new daf::base::PropertyList())),
-          _visitInfo(visitInfo),
-          _components(std::make_unique<MapClass>()) {
+          _visitInfo(visitInfo) {
     setWcs(wcs);
     setPsf(psf);
     setPhotoCalib(photoCalib);
@@ -202,21 +204,33 @@ ExposureInfo::ExposureInfo(ExposureInfo const& other) : ExposureInfo(other, fals
 ExposureInfo::ExposureInfo(ExposureInfo&& other) : ExposureInfo(other) {}
 
 ExposureInfo::ExposureInfo(ExposureInfo const& other, bool copyMetadata)
-        : _exposureId(other._exposureId),
-          _metadata(other._metadata),
-          _visitInfo(other._visitInfo),
-          // ExposureInfos can (historically) share objects, but should each have their own pointers to them
-          _components(std::make_unique<MapClass>(*(other._components))) {
+        : _exposureId(other._exposureId), _metadata(other._metadata), _visitInfo(other._visitInfo) {
+    std::unique_lock<std::mutex> lock;
+    if (other._hasLazy) {
+        lock = std::unique_lock<std::mutex>(other._lazyMutex);
+    }
+    // ExposureInfos can (historically) share objects, but should each have their own pointers to them;
+    // the tables of pointers are copied on write
+    _components = other._components;
+    _lazy = other._lazy;
+    _hasLazy = _lazy && !_lazy->empty();
     if (copyMetadata) _metadata = _metadata->deepCopy();
 }
 
 ExposureInfo& ExposureInfo::operator=(ExposureInfo const& other) {
     if (&other != this) {
+        std::unique_lock<std::mutex> lock;
+        if (other._hasLazy) {
+            lock = std::unique_lock<std::mutex>(other._lazyMutex);
+        }
         _exposureId = other._exposureId;
         _metadata = other._metadata;
         _visitInfo = other._visitInfo;
-        // ExposureInfos can (historically) share objects, but should each have their own pointers to them
-        _components = std::make_unique<MapClass>(*(other._components));
+        // ExposureInfos can (historically) share objects, but should each have their own pointers to them;
+        // the tables of pointers are copied on write
+        _components = other._components;
+        _lazy = other._lazy;
+        _hasLazy = _lazy && !_lazy->empty();
     }
     return *this;
 }
@@ -225,6 +239,110 @@ ExposureInfo& ExposureInfo::operator=(ExposureInfo&& other) { return *this = oth
 
 ExposureInfo::~ExposureInfo() = default;
 
+ExposureInfo::LazyComponentReader::~LazyComponentReader() noexcept = default;
+
+class ExposureInfo::LazySource {
+public:
+    explicit LazySource(std::shared_ptr<LazyComponentReader> reader) : _reader(std::move(reader)) {}
+
+    // Return a component, reading it if no ExposureInfo sharing this source has yet
+    std::shared_ptr<typehandling::Storable const> get(std::string const& id) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto iter = _read.find(id);
+        if (iter == _read.end()) {
+            iter = _read.emplace(id, _reader->readComponent(id)).first;
+        }
+        return iter->second;
+    }
+
+private:
+    std::mutex _mutex;  // guards _reader and _read
+    std::shared_ptr<LazyComponentReader> _reader;
+    std::map<std::string, std::shared_ptr<typehandling::Storable const>> _read;
+};
+
+void ExposureInfo::setLazyComponents(std::shared_ptr<LazyComponentReader> reader,
+                                     std::vector<std::string> const& ids) {
+    if (!reader) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "Lazy component reader must not be null");
+    }
+    auto source = std::make_shared<LazySource>(std::move(reader));
+    LazyMap& lazy = _mutableLazy();
+    for (std::string const& id : ids) {
+        _components.erase(typehandling::makeKey<MapClass::mapped_type>(id));
+        lazy[id] = source;
+    }
+    _hasLazy = !lazy.empty();
+}
+
+std::vector<std::string> ExposureInfo::getUnreadLazyComponents() const {
+    std::vector<std::string> result;
+    auto lock = _lockComponent(std::string());
+    if (_lazy) {
+        for (auto const& idSource : *_lazy) {
+            result.push_back(idSource.first);
+        }
+    }
+    return result;
+}
+
+std::unique_lock<std::mutex> ExposureInfo::_lockComponent(std::string const& id) const {
+    if (!_hasLazy) {
+        return std::unique_lock<std::mutex>();
+    }
+    std::unique_lock<std::mutex> lock(_lazyMutex);
+    _readLazyComponent(id);
+    return lock;
+}
+
+std::unique_lock<std::mutex> ExposureInfo::_lockAllComponents() const {
+    if (!_hasLazy) {
+        return std::unique_lock<std::mutex>();
+    }
+    std::unique_lock<std::mutex> lock(_lazyMutex);
+    while (_lazy && !_lazy->empty()) {
+        _readLazyComponent(_lazy->begin()->first);
+    }
+    return lock;
+}
+
+ExposureInfo::LazyMap& ExposureInfo::_mutableLazy() const {
+    if (!_lazy) {
+        _lazy = std::make_shared<LazyMap>();
+    } else if (_lazy.use_count() > 1) {
+        _lazy = std::make_shared<LazyMap>(*_lazy);
+    } else {
+        // Make sure any reads by a copy that was destroyed on another thread happen before our writes.
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return *_lazy;
+}
+
+void ExposureInfo::_readLazyComponent(std::string const& id) const {
+    if (!_lazy) {
+        return;
+    }
+    auto iter = _lazy->find(id);
+    if (iter == _lazy->end()) {
+        return;
+    }
+    // If reading throws, the component stays unread so a later request tries again
+    std::shared_ptr<typehandling::Storable const> object = iter->second->get(id);
+    _mutableLazy().erase(id);
+    if (object) {
+        _components.insert(typehandling::makeKey<MapClass::mapped_type>(id), object);
+    }
+}
+
+bool ExposureInfo::_cancelLazyComponent(std::string const& id) {
+    if (!_lazy || _lazy->count(id) == 0) {
+        return false;
+    }
+    _mutableLazy().erase(id);
+    _hasLazy = !_lazy->empty();
+    return true;
+}
+
 int ExposureInfo::_addToArchive(FitsWriteData& data, table::io::Persistable const& object, std::string key,
                                 std::string comment) {
     int componentId = data.archive.put(object);
@@ -254,6 +372,8 @@ std::string _getHeaderComment(std::string mapKey) {
 
 ExposureInfo::FitsWriteData ExposureInfo::_startWriteFits(lsst::geom::Point2I const& xy0) const {
     FitsWriteData data;
+    // Components (and the records of CoaddInputs) often share equal Detectors, TransmissionCurves etc.
+    data.archive.setDeduplicate(true);
 
     data.metadata.reset(new daf::base::PropertyList());
     data.imageMetadata.reset(new daf::base::PropertyList());
@@ -271,17 +391,20 @@ ExposureInfo::FitsWriteData ExposureInfo::_startWriteFits(lsst::geom::Point2I co
     // this is still the case so we're setting AR_HDU to 5 == 4 + 1
     //
     data.metadata->set("AR_HDU", 5, "HDU (1-indexed) containing the archive used to store ancillary objects");
-    for (auto const& keyValue : *_components) {
-        std::string const& key = keyValue.first.getId();
-        std::shared_ptr<typehandling::Storable const> const& object = keyValue.second;
-
-        if (object && object->isPersistable()) {
-            std::string comment = _getHeaderComment(key);
-            // Store archive ID in two header keys:
-            //     - old-style key for backwards compatibility,
-            //     - and new-style key because it's much safer to parse
-            int id = _addToArchive(data, object, _getOldHeaderKey(key), comment);
-            data.metadata->set(_getNewHeaderKey(key), id, comment);
+    {
+        auto lock = _lockAllComponents();
+        for (auto const& keyValue : std::as_const(_components)) {
+            std::string const& key = keyValue.first.getId();
+            std::shared_ptr<typehandling::Storable const> const& object = keyValue.second;
+
+            if (object && object->isPersistable()) {
+                std::string comment = _getHeaderComment(key);
+                // Store archive ID in two header keys:
+                //     - old-style key for backwards compatibility,
+                //     - and new-style key because it's much safer to parse
+                int id = _addToArchive(data, object, _getOldHeaderKey(key), comment);
+                data.metadata->set(_getNewHeaderKey(key), id, comment);
+            }
         }
     }
 
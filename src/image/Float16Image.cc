@@ -0,0 +1,118 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "boost/format.hpp"
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/image/Float16Image.h"
+
+namespace lsst {
+namespace afw {
+namespace image {
+
+namespace {
+
+void checkContains(lsst::geom::Box2I const &bbox, lsst::geom::Point2I const &point) {
+    if (!bbox.contains(point)) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("Pixel %s is not within the image %s") % point % bbox).str());
+    }
+}
+
+}  // namespace
+
+// These loops have no dependencies between iterations, so they are left to the compiler to vectorize.
+void floatToFloat16(float const *in, std::uint16_t *out, std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = floatToFloat16(in[i]);
+    }
+}
+
+void float16ToFloat(std::uint16_t const *in, float *out, std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = float16ToFloat(in[i]);
+    }
+}
+
+Float16Image::Float16Image(lsst::geom::Box2I const &bbox) : _bits(bbox) { _bits = 0; }
+
+Float16Image::Float16Image(Image<float> const &image) : _bits(image.getBBox()) { assign(image); }
+
+Float16Image::Float16Image(Float16Image const &rhs, lsst::geom::Box2I const &bbox, ImageOrigin origin)
+        : _bits(rhs._bits, bbox, origin, false) {}
+
+float Float16Image::get(lsst::geom::Point2I const &point, ImageOrigin origin) const {
+    checkContains(getBBox(origin), point);
+    return float16ToFloat(_bits.get(point, origin));
+}
+
+void Float16Image::set(lsst::geom::Point2I const &point, float value, ImageOrigin origin) {
+    checkContains(getBBox(origin), point);
+    _bits.get(point, origin) = floatToFloat16(value);
+}
+
+Image<float> Float16Image::convertF() const {
+    Image<float> result(getBBox());
+    auto const in = _bits.getArray();
+    auto const out = result.getArray();
+    std::size_t const width = getWidth();
+    for (int y = 0; y < getHeight(); ++y) {
+        float16ToFloat(in[y].getData(), out[y].getData(), width);
+    }
+    return result;
+}
+
+void Float16Image::assign(Image<float> const &image) {
+    if (image.getDimensions() != getDimensions()) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("Dimension mismatch: %dx%d v. %dx%d") % getWidth() % getHeight() %
+                           image.getWidth() % image.getHeight())
+                                  .str());
+    }
+    auto const in = image.getArray();
+    auto const out = _bits.getArray();
+    std::size_t const width = getWidth();
+    for (int y = 0; y < getHeight(); ++y) {
+        floatToFloat16(in[y].getData(), out[y].getData(), width);
+    }
+}
+
+Float16Image Float16Image::clone() const { return Float16Image(Image<std::uint16_t>(_bits, true)); }
+
+void Float16Image::writeFits(std::string const &fileName, daf::base::PropertySet const *metadata,
+                             std::string const &mode) const {
+    convertF().writeFits(fileName, metadata, mode);
+}
+
+void Float16Image::writeFits(std::string const &fileName, fits::ImageWriteOptions const &options,
+                             std::string const &mode, daf::base::PropertySet const *header) const {
+    convertF().writeFits(fileName, options, mode, header);
+}
+
+Float16Image Float16Image::readFits(std::string const &fileName, int hdu) {
+    return Float16Image(Image<float>(fileName, hdu));
+}
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
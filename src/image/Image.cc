@@ -25,8 +25,10 @@
 /*
  * Implementation for ImageBase and Image
  */
+#include <algorithm>
 #include <cstdint>
 #include <functional>
+#include <utility>
 #include "boost/format.hpp"
 #include "boost/gil.hpp"
 
@@ -34,13 +36,64 @@
 #include "lsst/afw/geom/wcsUtils.h"
 #include "lsst/afw/image/Image.h"
 #include "lsst/afw/image/ImageAlgorithm.h"
+#include "lsst/afw/image/PixelAllocator.h"
 #include "lsst/afw/fits.h"
 #include "lsst/afw/image/ImageFitsReader.h"
+#include "lsst/afw/math/Instrumentation.h"
 
 namespace lsst {
 namespace afw {
 namespace image {
 
+namespace {
+
+// Number of rows for which Function2::evaluateGrid is called at once by addFunction
+int const FUNCTION_BAND_HEIGHT = 64;
+
+// Add scale*function(x, y) to each pixel of image, evaluating the function a band of rows at a time
+template <typename PixelT>
+void addFunction(Image<PixelT>& image, math::Function2<double> const& function, double scale) {
+    int const width = image.getWidth();
+    int const height = image.getHeight();
+    if (width == 0) {
+        return;
+    }
+    ndarray::Array<double, 1, 1> xPos = ndarray::allocate(width);
+    for (int x = 0; x < width; ++x) {
+        xPos[x] = image.indexToPosition(x, X);
+    }
+    for (int y0 = 0; y0 < height; y0 += FUNCTION_BAND_HEIGHT) {
+        int const bandHeight = std::min(FUNCTION_BAND_HEIGHT, height - y0);
+        ndarray::Array<double, 1, 1> yPos = ndarray::allocate(bandHeight);
+        for (int i = 0; i < bandHeight; ++i) {
+            yPos[i] = image.indexToPosition(y0 + i, Y);
+        }
+        ndarray::Array<double, 2, 2> const values = function.evaluateGrid(xPos, yPos);
+        for (int i = 0; i < bandHeight; ++i) {
+            double const* value = values[i].getData();
+            auto const end = image.row_end(y0 + i);
+            for (auto ptr = image.row_begin(y0 + i); ptr != end; ++ptr, ++value) {
+                *ptr += scale * (*value);
+            }
+        }
+    }
+}
+
+// Keeps the pixels of an image alive, along with their charge to a memory counter
+class ChargedManager : public ndarray::Manager {
+public:
+    ChargedManager(ndarray::Manager::Ptr manager, math::MemoryCharge charge)
+            : _manager(std::move(manager)), _charge(std::move(charge)) {}
+
+    bool isUnique() const override { return _manager->isUnique(); }
+
+private:
+    ndarray::Manager::Ptr _manager;
+    math::MemoryCharge _charge;
+};
+
+}  // namespace
+
 template <typename PixelT>
 typename ImageBase<PixelT>::_view_t ImageBase<PixelT>::_allocateView(lsst::geom::Extent2I const& dimensions,
                                                                      Manager::Ptr& manager) {
@@ -54,9 +107,20 @@ typename ImageBase<PixelT>::_view_t ImageBase<PixelT>::_allocateView(lsst::geom:
                           str(boost::format("Image dimensions (%d x %d) too large; int overflow detected.") %
                               dimensions.getX() % dimensions.getY()));
     }
-    std::pair<Manager::Ptr, PixelT*> r =
-            ndarray::SimpleManager<PixelT>::allocate(dimensions.getX() * dimensions.getY());
+    std::size_t const nPixels = static_cast<std::size_t>(dimensions.getX()) * dimensions.getY();
+    std::pair<Manager::Ptr, PixelT*> r;
+    if (auto allocator = getPixelAllocator()) {
+        auto buffer = allocator->allocate(nPixels * sizeof(PixelT));
+        r = std::make_pair(buffer.first, static_cast<PixelT*>(buffer.second));
+    } else {
+        r = ndarray::SimpleManager<PixelT>::allocate(nPixels);
+    }
     manager = r.first;
+    if (LSST_AFW_INSTRUMENTATION && math::isInstrumentationEnabled() && nPixels > 0) {
+        static math::MemoryCounter& counter = math::getMemoryCounter("image.pixels");
+        math::MemoryCharge charge(counter, nPixels * sizeof(PixelT));
+        manager = Manager::Ptr(new ChargedManager(manager, std::move(charge)));
+    }
     return boost::gil::interleaved_view(dimensions.getX(), dimensions.getY(),
                                         (typename _view_t::value_type*)r.second,
                                         dimensions.getX() * sizeof(PixelT));
@@ -322,6 +386,13 @@ Image<PixelT>::Image(lsst::geom::Box2I const& bbox, PixelT initialValue) : Image
     *this = initialValue;
 }
 
+template <typename PixelT>
+Image<PixelT>::Image(lsst::geom::Extent2I const& dimensions, UninitializedTag)
+        : ImageBase<PixelT>(dimensions) {}
+
+template <typename PixelT>
+Image<PixelT>::Image(lsst::geom::Box2I const& bbox, UninitializedTag) : ImageBase<PixelT>(bbox) {}
+
 template <typename PixelT>
 Image<PixelT>::Image(Image const& rhs, bool const deep) : ImageBase<PixelT>(rhs, deep) {}
 // Delegate to copy-constructor for backwards compatibility
@@ -472,14 +543,7 @@ Image<PixelT>& Image<PixelT>::operator+=(Image<PixelT> const& rhs) {
 
 template <typename PixelT>
 Image<PixelT>& Image<PixelT>::operator+=(math::Function2<double> const& function) {
-    for (int y = 0; y != this->getHeight(); ++y) {
-        double const yPos = this->indexToPosition(y, Y);
-        double xPos = this->indexToPosition(0, X);
-        for (typename Image<PixelT>::x_iterator ptr = this->row_begin(y), end = this->row_end(y); ptr != end;
-             ++ptr, ++xPos) {
-            *ptr += function(xPos, yPos);
-        }
-    }
+    addFunction(*this, function, 1.0);
     return *this;
 }
 
@@ -530,14 +594,7 @@ void Image<PixelT>::scaledMinus(PixelT const c, Image<PixelT> const& rhs) {
 
 template <typename PixelT>
 Image<PixelT>& Image<PixelT>::operator-=(math::Function2<double> const& function) {
-    for (int y = 0; y != this->getHeight(); ++y) {
-        double const yPos = this->indexToPosition(y, Y);
-        double xPos = this->indexToPosition(0, X);
-        for (typename Image<PixelT>::x_iterator ptr = this->row_begin(y), end = this->row_end(y); ptr != end;
-             ++ptr, ++xPos) {
-            *ptr -= function(xPos, yPos);
-        }
-    }
+    addFunction(*this, function, -1.0);
     return *this;
 }
 
@@ -44,6 +44,16 @@ ImageBaseFitsReader::ImageBaseFitsReader(fits::MemFileManager& manager, int hdu)
     _hdu = _fitsFile->getHdu();
 }
 
+ImageBaseFitsReader::ImageBaseFitsReader(std::shared_ptr<fits::ByteRangeCache> cache, int hdu) :
+    _ownsFitsFile(true),
+    _hdu(0),
+    _fitsFile(new fits::Fits(std::move(cache), fits::Fits::AUTO_CLOSE | fits::Fits::AUTO_CHECK))
+{
+    _fitsFile->setHdu(hdu);
+    _fitsFile->checkCompressedImagePhu();
+    _hdu = _fitsFile->getHdu();
+}
+
 ImageBaseFitsReader::ImageBaseFitsReader(fits::Fits * fitsFile) :
     _ownsFitsFile(false),
     _hdu(0),
@@ -165,6 +175,22 @@ std::string makeDTypeString() {
     return result;
 }
 
+// Return the subimage box to use for a request, checking that it fits in the image.
+lsst::geom::Box2I checkSubBBox(lsst::geom::Box2I const & bbox, lsst::geom::Box2I const & fullBBox, int hdu) {
+    if (bbox.isEmpty()) {
+        return fullBBox;
+    }
+    if (!fullBBox.contains(bbox)) {
+        throw LSST_EXCEPT(
+            pex::exceptions::LengthError,
+            str(boost::format("Subimage box (%d,%d) %dx%d doesn't fit in image (%d,%d) %dx%d in HDU %d") %
+                bbox.getMinX() % bbox.getMinY() % bbox.getWidth() % bbox.getHeight() %
+                fullBBox.getMinX() % fullBBox.getMinY() % fullBBox.getWidth() % fullBBox.getHeight() % hdu)
+        );
+    }
+    return bbox;
+}
+
 } // anonymous
 
 template <typename T>
@@ -172,17 +198,7 @@ ndarray::Array<T, 2, 2> ImageBaseFitsReader::readArray(lsst::geom::Box2I const &
                                                        bool allowUnsafe) {
     checkFitsFile(_fitsFile);
     auto fullBBox = readBBox(origin);
-    auto subBBox = bbox;
-    if (subBBox.isEmpty()) {
-        subBBox = fullBBox;
-    } else if (!fullBBox.contains(subBBox)) {
-        throw LSST_EXCEPT(
-            pex::exceptions::LengthError,
-            str(boost::format("Subimage box (%d,%d) %dx%d doesn't fit in image (%d,%d) %dx%d in HDU %d") %
-                subBBox.getMinX() % subBBox.getMinY() % subBBox.getWidth() % subBBox.getHeight() %
-                fullBBox.getMinX() % fullBBox.getMinY() % fullBBox.getWidth() % fullBBox.getHeight() % _hdu)
-        );
-    }
+    auto subBBox = checkSubBBox(bbox, fullBBox, _hdu);
     fits::HduMoveGuard guard(*_fitsFile, _hdu);
     if (!allowUnsafe & !_fitsFile->checkImageType<T>()) {
         throw LSST_FITS_EXCEPT(
@@ -199,12 +215,27 @@ ndarray::Array<T, 2, 2> ImageBaseFitsReader::readArray(lsst::geom::Box2I const &
     return result;
 }
 
+template <typename T>
+ndarray::Array<T, 2, 1> ImageBaseFitsReader::mapArray(lsst::geom::Box2I const & bbox, ImageOrigin origin) {
+    checkFitsFile(_fitsFile);
+    auto fullBBox = readBBox(origin);
+    auto subBBox = checkSubBBox(bbox, fullBBox, _hdu);
+    fits::HduMoveGuard guard(*_fitsFile, _hdu);
+    return _fitsFile->mapImage<T>(ndarray::makeVector(subBBox.getHeight(), subBBox.getWidth()),
+                                  ndarray::makeVector(subBBox.getMinY() - fullBBox.getMinY(),
+                                                      subBBox.getMinX() - fullBBox.getMinX()));
+}
+
 
 #define INSTANTIATE(T) \
     template ndarray::Array<T, 2, 2> ImageBaseFitsReader::readArray( \
         lsst::geom::Box2I const & bbox, \
         ImageOrigin origin, \
         bool \
+    ); \
+    template ndarray::Array<T, 2, 1> ImageBaseFitsReader::mapArray( \
+        lsst::geom::Box2I const & bbox, \
+        ImageOrigin origin \
     )
 
 INSTANTIATE(std::uint16_t);
@@ -28,8 +28,14 @@ Image<PixelT> ImageFitsReader::read(lsst::geom::Box2I const & bbox, ImageOrigin
     return Image<PixelT>(readArray<PixelT>(bbox, origin, allowUnsafe), false, readXY0(bbox, origin));
 }
 
+template <typename PixelT>
+Image<PixelT> ImageFitsReader::map(lsst::geom::Box2I const & bbox, ImageOrigin origin) {
+    return Image<PixelT>(mapArray<PixelT>(bbox, origin), false, readXY0(bbox, origin));
+}
+
 #define INSTANTIATE(T) \
-    template Image<T> ImageFitsReader::read(lsst::geom::Box2I const &, ImageOrigin, bool)
+    template Image<T> ImageFitsReader::read(lsst::geom::Box2I const &, ImageOrigin, bool); \
+    template Image<T> ImageFitsReader::map(lsst::geom::Box2I const &, ImageOrigin)
 
 INSTANTIATE(std::uint16_t);
 INSTANTIATE(int);
@@ -35,6 +35,7 @@
 
 #include "lsst/afw/image/ImagePca.h"
 #include "lsst/afw/math/Statistics.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace afwMath = lsst::afw::math;
 
@@ -49,7 +50,10 @@ ImagePca<ImageT>::ImagePca(bool constantWeight)
           _dimensions(0, 0),
           _constantWeight(constantWeight),
           _eigenValues(std::vector<double>()),
-          _eigenImages(ImageList()) {}
+          _eigenImages(ImageList()),
+          _numThreads(1),
+          _incremental(false),
+          _innerProducts() {}
 
 template <typename ImageT>
 ImagePca<ImageT>::ImagePca(ImagePca const&) = default;
@@ -104,6 +108,12 @@ std::shared_ptr<ImageT> ImagePca<ImageT>::getMean() const {
     return mean;
 }
 
+template <typename ImageT>
+void ImagePca<ImageT>::setNumThreads(int numThreads) {
+    afwMath::detail::resolveNumThreads(numThreads);  // validate
+    _numThreads = numThreads;
+}
+
 namespace {
 /*
  * Analyze the images in an ImagePca, calculating the PCA decomposition (== Karhunen-Lo\`eve basis)
@@ -137,6 +147,32 @@ void ImagePca<ImageT>::analyze() {
 
         return;
     }
+    /*
+     * Compute the inner products that we don't already have: all of them, unless we're incremental
+     * and have only added images since the last call
+     */
+    if (!_incremental) {
+        _innerProducts.clear();
+    }
+    int const nKnown = _innerProducts.size();
+    std::vector<std::pair<int, int>> pairs;  // (i, j <= i) for the products to compute
+    pairs.reserve((nImage * (nImage + 1) - nKnown * (nKnown + 1)) / 2);
+    for (int i = nKnown; i != nImage; ++i) {
+        _innerProducts.emplace_back(i + 1);
+        for (int j = 0; j <= i; ++j) {
+            pairs.emplace_back(i, j);
+        }
+    }
+    int const nThreads = afwMath::detail::resolveNumThreads(_numThreads);
+    auto const pieces = afwMath::detail::splitRange(0, static_cast<int>(pairs.size()), nThreads);
+    int const nPieces = pieces.size();
+    afwMath::detail::parallelFor(nPieces, nThreads, [&](int iPiece) {
+        for (int k = pieces[iPiece].first; k != pieces[iPiece].second; ++k) {
+            int const i = pairs[k].first, j = pairs[k].second;
+            _innerProducts[i][j] = innerProduct(*GetImage<ImageT>::getImage(_imageList[i]),
+                                                *GetImage<ImageT>::getImage(_imageList[j]));
+        }
+    });
     /*
      * Find the eigenvectors/values of the scalar product matrix, R' (Eq. 7.4)
      */
@@ -144,17 +180,13 @@ void ImagePca<ImageT>::analyze() {
 
     double flux_bar = 0;  // mean of flux for all regions
     for (int i = 0; i != nImage; ++i) {
-        typename GetImage<ImageT>::type const& im_i = *GetImage<ImageT>::getImage(_imageList[i]);
         double const flux_i = getFlux(i);
         flux_bar += flux_i;
 
-        for (int j = i; j != nImage; ++j) {
-            typename GetImage<ImageT>::type const& im_j = *GetImage<ImageT>::getImage(_imageList[j]);
-            double const flux_j = getFlux(j);
-
-            double dot = innerProduct(im_i, im_j);
+        for (int j = 0; j <= i; ++j) {
+            double dot = _innerProducts[i][j];
             if (_constantWeight) {
-                dot /= flux_i * flux_j;
+                dot /= flux_i * getFlux(j);
             }
             R(i, j) = R(j, i) = dot / nImage;
         }
@@ -383,30 +415,33 @@ double do_updateBadPixels(detail::MaskedImage_tag const&,
 }  // namespace
 template <typename ImageT>
 double ImagePca<ImageT>::updateBadPixels(unsigned long mask, int const ncomp) {
+    _innerProducts.clear();  // the images may change
     return do_updateBadPixels<ImageT>(typename ImageT::image_category(), _imageList, _fluxList, _eigenImages,
                                       mask, ncomp);
 }
 
 namespace {
-template <typename T, typename U>
-struct IsSame {
-    IsSame(T const&, U const&) {}
-    bool operator()() { return false; }
-};
-
-template <typename T>
-struct IsSame<T, T> {
-    IsSame(T const& im1, T const& im2) : _same(im1.row_begin(0) == im2.row_begin(0)) {}
-    bool operator()() { return _same; }
-
-private:
-    bool _same;
-};
-
-// Test if two Images are identical; they need not be of the same type
-template <typename Image1T, typename Image2T>
-bool imagesAreIdentical(Image1T const& im1, Image2T const& im2) {
-    return IsSame<Image1T, Image2T>(im1, im2)();
+/*
+ * Return the sum of the finite products lhs[x]*rhs[x] for x in [0, n)
+ *
+ * Four independent partial sums break the dependency between consecutive additions, so that the
+ * loop can be pipelined (and vectorized), at the cost of a slightly different rounding.
+ */
+template <typename Pixel1T, typename Pixel2T>
+double dotRow(Pixel1T const* lhs, Pixel2T const* rhs, int n) {
+    double sums[4] = {0.0, 0.0, 0.0, 0.0};
+    int x = 0;
+    for (; x + 4 <= n; x += 4) {
+        for (int k = 0; k != 4; ++k) {
+            double const tmp = static_cast<double>(lhs[x + k]) * static_cast<double>(rhs[x + k]);
+            sums[k] += std::isfinite(tmp) ? tmp : 0.0;
+        }
+    }
+    for (; x != n; ++x) {
+        double const tmp = static_cast<double>(lhs[x]) * static_cast<double>(rhs[x]);
+        sums[0] += std::isfinite(tmp) ? tmp : 0.0;
+    }
+    return (sums[0] + sums[1]) + (sums[2] + sums[3]);
 }
 }  // namespace
 template <typename Image1T, typename Image2T>
@@ -417,41 +452,19 @@ double innerProduct(Image1T const& lhs, Image2T const& rhs, int border) {
                            lhs.getWidth() % lhs.getHeight())
                                   .str());
     }
+    if (lhs.getDimensions() != rhs.getDimensions()) {
+        throw LSST_EXCEPT(lsst::pex::exceptions::LengthError,
+                          (boost::format("Dimension mismatch: %dx%d v. %dx%d") % lhs.getWidth() %
+                           lhs.getHeight() % rhs.getWidth() % rhs.getHeight())
+                                  .str());
+    }
 
+    auto const lhsArray = lhs.getArray();
+    auto const rhsArray = rhs.getArray();
+    int const width = lhs.getWidth() - 2 * border;
     double sum = 0.0;
-    //
-    // Handle I.I specially for efficiency, and to avoid advancing the iterator twice
-    //
-    if (imagesAreIdentical(lhs, rhs)) {
-        for (int y = border; y != lhs.getHeight() - border; ++y) {
-            for (typename Image1T::const_x_iterator lptr = lhs.row_begin(y) + border,
-                                                    lend = lhs.row_end(y) - border;
-                 lptr != lend; ++lptr) {
-                typename Image1T::Pixel val = *lptr;
-                if (std::isfinite(val)) {
-                    sum += val * val;
-                }
-            }
-        }
-    } else {
-        if (lhs.getDimensions() != rhs.getDimensions()) {
-            throw LSST_EXCEPT(lsst::pex::exceptions::LengthError,
-                              (boost::format("Dimension mismatch: %dx%d v. %dx%d") % lhs.getWidth() %
-                               lhs.getHeight() % rhs.getWidth() % rhs.getHeight())
-                                      .str());
-        }
-
-        for (int y = border; y != lhs.getHeight() - border; ++y) {
-            typename Image2T::const_x_iterator rptr = rhs.row_begin(y) + border;
-            for (typename Image1T::const_x_iterator lptr = lhs.row_begin(y) + border,
-                                                    lend = lhs.row_end(y) - border;
-                 lptr != lend; ++lptr, ++rptr) {
-                double const tmp = (*lptr) * (*rptr);
-                if (std::isfinite(tmp)) {
-                    sum += tmp;
-                }
-            }
-        }
+    for (int y = border; y != lhs.getHeight() - border; ++y) {
+        sum += dotRow(lhsArray[y].getData() + border, rhsArray[y].getData() + border, width);
     }
 
     return sum;
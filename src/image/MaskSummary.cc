@@ -0,0 +1,259 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <type_traits>
+
+#include "boost/format.hpp"
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/image/MaskSummary.h"
+#include "lsst/afw/math/detail/Parallel.h"
+
+namespace lsst {
+namespace afw {
+namespace image {
+
+namespace {
+
+int const N_BITS = 8 * sizeof(MaskPixel);
+
+// What one thread learns about a band of rows; bounding boxes are in LOCAL coordinates
+struct PartialSummary {
+    PartialSummary() : counts(N_BITS, 0), bboxes(N_BITS) {}
+
+    MaskPixel bits = 0;
+    std::vector<std::size_t> counts;
+    std::vector<lsst::geom::Box2I> bboxes;
+};
+
+/*
+ * Summarize rows [yBegin, yEnd) of a mask
+ *
+ * Each row is first reduced to the OR of its pixels, so that only the planes present in the row are
+ * counted, and the counting loops run over contiguous pixels with no branches, so they vectorize.
+ */
+template <typename MaskPixelT>
+void summarizeRows(ndarray::Array<MaskPixelT const, 2, 1> const& array, int yBegin, int yEnd, int tileSize,
+                   int nTilesX, MaskPixel* tiles, PartialSummary& partial) {
+    using Bits = std::make_unsigned_t<MaskPixelT>;
+    int const width = array.template getSize<1>();
+    for (int y = yBegin; y < yEnd; ++y) {
+        MaskPixelT const* row = array[y].getData();
+        Bits rowBits = 0;
+        for (int x = 0; x < width; ++x) {
+            rowBits |= static_cast<Bits>(row[x]);
+        }
+        if (rowBits == 0) {
+            continue;
+        }
+        partial.bits |= static_cast<MaskPixel>(rowBits);
+        for (int bit = 0; bit < N_BITS; ++bit) {
+            if (((rowBits >> bit) & 1u) == 0) {
+                continue;
+            }
+            unsigned int count = 0;
+            for (int x = 0; x < width; ++x) {
+                count += (static_cast<Bits>(row[x]) >> bit) & 1u;
+            }
+            partial.counts[bit] += count;
+            Bits const mask = Bits(1) << bit;
+            int xMin = 0;
+            while ((static_cast<Bits>(row[xMin]) & mask) == 0) {
+                ++xMin;
+            }
+            int xMax = width - 1;
+            while ((static_cast<Bits>(row[xMax]) & mask) == 0) {
+                --xMax;
+            }
+            partial.bboxes[bit].include(lsst::geom::Point2I(xMin, y));
+            partial.bboxes[bit].include(lsst::geom::Point2I(xMax, y));
+        }
+        if (tiles) {
+            MaskPixel* tileRow = tiles + (y / tileSize) * nTilesX;
+            for (int ix = 0; ix < nTilesX; ++ix) {
+                int const xEnd = std::min(width, (ix + 1) * tileSize);
+                Bits tileBits = 0;
+                for (int x = ix * tileSize; x < xEnd; ++x) {
+                    tileBits |= static_cast<Bits>(row[x]);
+                }
+                tileRow[ix] |= static_cast<MaskPixel>(tileBits);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+template <typename MaskPixelT>
+MaskSummary::MaskSummary(Mask<MaskPixelT> const& mask, int tileSize, int numThreads)
+        : _bbox(mask.getBBox()),
+          _planes(mask.getMaskPlaneDict()),
+          _union(0),
+          _counts(N_BITS, 0),
+          _planeBBoxes(N_BITS),
+          _tileSize(tileSize),
+          _nTilesX(0),
+          _nTilesY(0) {
+    static_assert(sizeof(MaskPixelT) <= sizeof(MaskPixel), "Mask pixels must fit in a MaskPixel");
+    if (tileSize < 0) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          (boost::format("Tile size must be >= 0, not %d") % tileSize).str());
+    }
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    if (tileSize > 0) {
+        _nTilesX = (mask.getWidth() + tileSize - 1) / tileSize;
+        _nTilesY = (mask.getHeight() + tileSize - 1) / tileSize;
+        _tiles.assign(static_cast<std::size_t>(_nTilesX) * _nTilesY, 0);
+    }
+
+    // Bands of whole tile rows, so that no two threads update the same tile
+    auto const array = mask.getArray();
+    auto const bands = math::detail::splitRange(0, mask.getHeight(), nThreads, std::max(tileSize, 1));
+    int const nBands = bands.size();
+    std::vector<PartialSummary> partials(nBands);
+    MaskPixel* tiles = _tiles.empty() ? nullptr : _tiles.data();
+    math::detail::parallelFor(nBands, nThreads, [&](int i) {
+        summarizeRows(array, bands[i].first, bands[i].second, tileSize, _nTilesX, tiles, partials[i]);
+    });
+
+    lsst::geom::Extent2I const offset(_bbox.getMin());
+    for (auto const& partial : partials) {
+        _union |= partial.bits;
+        for (int bit = 0; bit < N_BITS; ++bit) {
+            _counts[bit] += partial.counts[bit];
+            if (!partial.bboxes[bit].isEmpty()) {
+                lsst::geom::Box2I bbox = partial.bboxes[bit];
+                bbox.shift(offset);
+                _planeBBoxes[bit].include(bbox);
+            }
+        }
+    }
+}
+
+std::size_t MaskSummary::getPlaneCount(int bit) const {
+    _checkBit(bit);
+    return _counts[bit];
+}
+
+std::size_t MaskSummary::getPlaneCount(std::string const& name) const { return _counts[_getBit(name)]; }
+
+lsst::geom::Box2I MaskSummary::getPlaneBBox(int bit) const {
+    _checkBit(bit);
+    return _planeBBoxes[bit];
+}
+
+lsst::geom::Box2I MaskSummary::getPlaneBBox(std::string const& name) const {
+    return _planeBBoxes[_getBit(name)];
+}
+
+lsst::geom::Box2I MaskSummary::getBBox(MaskPixel bitmask) const {
+    lsst::geom::Box2I result;
+    for (int bit = 0; bit < N_BITS; ++bit) {
+        if ((bitmask >> bit) & 1) {
+            result.include(_planeBBoxes[bit]);
+        }
+    }
+    return result;
+}
+
+bool MaskSummary::mayIntersect(lsst::geom::Box2I const& bbox, MaskPixel bitmask) const {
+    lsst::geom::Box2I region = getBBox(bitmask);
+    region.clip(bbox);
+    if (region.isEmpty()) {
+        return false;
+    }
+    if (_tileSize == 0) {
+        return true;
+    }
+    lsst::geom::Point2I const min(region.getMin() - _bbox.getMin());
+    lsst::geom::Point2I const max(region.getMax() - _bbox.getMin());
+    for (int iy = min.getY() / _tileSize; iy <= max.getY() / _tileSize; ++iy) {
+        for (int ix = min.getX() / _tileSize; ix <= max.getX() / _tileSize; ++ix) {
+            if (_tiles[static_cast<std::size_t>(iy) * _nTilesX + ix] & bitmask) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+MaskPixel MaskSummary::getTileUnion(int ix, int iy) const {
+    _checkTile(ix, iy);
+    return _tiles[static_cast<std::size_t>(iy) * _nTilesX + ix];
+}
+
+lsst::geom::Box2I MaskSummary::getTileBBox(int ix, int iy) const {
+    _checkTile(ix, iy);
+    lsst::geom::Box2I result(_bbox.getMin() + lsst::geom::Extent2I(ix * _tileSize, iy * _tileSize),
+                             lsst::geom::Extent2I(_tileSize, _tileSize));
+    result.clip(_bbox);
+    return result;
+}
+
+std::vector<lsst::geom::Box2I> MaskSummary::getTileBBoxes(MaskPixel bitmask) const {
+    if (_tileSize == 0) {
+        throw LSST_EXCEPT(pex::exceptions::LogicError, "No tiles were recorded for this MaskSummary");
+    }
+    std::vector<lsst::geom::Box2I> result;
+    for (int iy = 0; iy < _nTilesY; ++iy) {
+        for (int ix = 0; ix < _nTilesX; ++ix) {
+            if (_tiles[static_cast<std::size_t>(iy) * _nTilesX + ix] & bitmask) {
+                result.push_back(getTileBBox(ix, iy));
+            }
+        }
+    }
+    return result;
+}
+
+int MaskSummary::_getBit(std::string const& name) const {
+    auto const iter = _planes.find(name);
+    if (iter == _planes.end()) {
+        throw LSST_EXCEPT(pex::exceptions::NotFoundError,
+                          (boost::format("Mask has no plane called %s") % name).str());
+    }
+    return iter->second;
+}
+
+void MaskSummary::_checkBit(int bit) const {
+    if (bit < 0 || bit >= N_BITS) {
+        throw LSST_EXCEPT(pex::exceptions::OutOfRangeError,
+                          (boost::format("Mask plane bit %d is not in [0, %d)") % bit % N_BITS).str());
+    }
+}
+
+void MaskSummary::_checkTile(int ix, int iy) const {
+    if (ix < 0 || ix >= _nTilesX || iy < 0 || iy >= _nTilesY) {
+        throw LSST_EXCEPT(pex::exceptions::OutOfRangeError,
+                          (boost::format("Tile (%d, %d) is not in the %dx%d grid of tiles") % ix % iy %
+                           _nTilesX % _nTilesY)
+                                  .str());
+    }
+}
+
+template MaskSummary::MaskSummary(Mask<MaskPixel> const&, int, int);
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
@@ -26,6 +26,8 @@
  * Implementation for MaskedImage
  */
 #include <cstdint>
+#include <functional>
+#include <vector>
 
 #include "boost/format.hpp"
 #include "lsst/log/Log.h"
@@ -44,31 +46,35 @@ MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>::MaskedImage(unsigned int w
                                                                   MaskPlaneDict const& planeDict)
         : _image(new Image(width, height)),
           _mask(new Mask(width, height, planeDict)),
-          _variance(new Variance(width, height)) {
-    *_image = 0;
-    *_mask = 0x0;
-    *_variance = 0;
-}
+          _variance(new Variance(width, height)) {}
 
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
 MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>::MaskedImage(lsst::geom::Extent2I const& dimensions,
                                                                   MaskPlaneDict const& planeDict)
         : _image(new Image(dimensions)),
           _mask(new Mask(dimensions, planeDict)),
-          _variance(new Variance(dimensions)) {
-    *_image = 0;
-    *_mask = 0x0;
-    *_variance = 0;
-}
+          _variance(new Variance(dimensions)) {}
+
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>::MaskedImage(lsst::geom::Extent2I const& dimensions,
+                                                                  UninitializedTag,
+                                                                  MaskPlaneDict const& planeDict)
+        : _image(new Image(dimensions, UNINITIALIZED)),
+          _mask(new Mask(dimensions, UNINITIALIZED, planeDict)),
+          _variance(new Variance(dimensions, UNINITIALIZED)) {}
 
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
 MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>::MaskedImage(lsst::geom::Box2I const& bbox,
                                                                   MaskPlaneDict const& planeDict)
-        : _image(new Image(bbox)), _mask(new Mask(bbox, planeDict)), _variance(new Variance(bbox)) {
-    *_image = 0;
-    *_mask = 0x0;
-    *_variance = 0;
-}
+        : _image(new Image(bbox)), _mask(new Mask(bbox, planeDict)), _variance(new Variance(bbox)) {}
+
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>::MaskedImage(lsst::geom::Box2I const& bbox,
+                                                                  UninitializedTag,
+                                                                  MaskPlaneDict const& planeDict)
+        : _image(new Image(bbox, UNINITIALIZED)),
+          _mask(new Mask(bbox, UNINITIALIZED, planeDict)),
+          _variance(new Variance(bbox, UNINITIALIZED)) {}
 
 template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
 MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>::MaskedImage(
@@ -498,6 +504,19 @@ void MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>::writeFits(
         std::shared_ptr<daf::base::PropertySet const> imageMetadata,
         std::shared_ptr<daf::base::PropertySet const> maskMetadata,
         std::shared_ptr<daf::base::PropertySet const> varianceMetadata) const {
+    writeFits(fitsfile, imageOptions, maskOptions, varianceOptions, metadata, imageMetadata, maskMetadata,
+              varianceMetadata, nullptr);
+}
+
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+void MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>::writeFits(
+        fits::Fits& fitsfile, fits::ImageWriteOptions const& imageOptions,
+        fits::ImageWriteOptions const& maskOptions, fits::ImageWriteOptions const& varianceOptions,
+        std::shared_ptr<daf::base::PropertySet const> metadata,
+        std::shared_ptr<daf::base::PropertySet const> imageMetadata,
+        std::shared_ptr<daf::base::PropertySet const> maskMetadata,
+        std::shared_ptr<daf::base::PropertySet const> varianceMetadata,
+        std::function<void(fits::Fits&)> const& writeExtraHdus) const {
     std::shared_ptr<daf::base::PropertySet> header;
     if (metadata) {
         header = metadata->deepCopy();
@@ -517,14 +536,22 @@ void MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>::writeFits(
     }
     fitsfile.writeMetadata(*header);
 
-    processPlaneMetadata(imageMetadata.get(), header, "IMAGE");
-    _image->writeFits(fitsfile, imageOptions, header.get(), _mask.get());
-
-    processPlaneMetadata(maskMetadata.get(), header, "MASK");
-    _mask->writeFits(fitsfile, maskOptions, header.get());
-
-    processPlaneMetadata(varianceMetadata.get(), header, "VARIANCE");
-    _variance->writeFits(fitsfile, varianceOptions, header.get(), _mask.get());
+    std::shared_ptr<daf::base::PropertySet> imageHeader, maskHeader, varianceHeader;
+    processPlaneMetadata(imageMetadata.get(), imageHeader, "IMAGE");
+    processPlaneMetadata(maskMetadata.get(), maskHeader, "MASK");
+    processPlaneMetadata(varianceMetadata.get(), varianceHeader, "VARIANCE");
+
+    // The planes are compressed independently, so they may be written concurrently
+    std::vector<std::function<void(fits::Fits&)>> writers = {
+            [&](fits::Fits& file) { _image->writeFits(file, imageOptions, imageHeader.get(), _mask.get()); },
+            [&](fits::Fits& file) { _mask->writeFits(file, maskOptions, maskHeader.get()); },
+            [&](fits::Fits& file) {
+                _variance->writeFits(file, varianceOptions, varianceHeader.get(), _mask.get());
+            }};
+    if (writeExtraHdus) {
+        writers.push_back(writeExtraHdus);
+    }
+    fits::writeHdusConcurrently(fitsfile, writers);
 }
 
 // private function conformSizes() ensures that the Mask and Variance have the same dimensions
@@ -55,6 +55,12 @@ MaskedImageFitsReader::MaskedImageFitsReader(fits::MemFileManager& manager, int
     _varianceReader(nextHdu(_maskReader._fitsFile))
 {}
 
+MaskedImageFitsReader::MaskedImageFitsReader(std::shared_ptr<fits::ByteRangeCache> cache, int hdu) :
+    _imageReader(std::move(cache), hdu),
+    _maskReader(nextHdu(_imageReader._fitsFile)),
+    _varianceReader(nextHdu(_maskReader._fitsFile))
+{}
+
 MaskedImageFitsReader::MaskedImageFitsReader(fits::Fits * fitsFile) :
     _imageReader(fitsFile),
     _maskReader(nextHdu(_imageReader._fitsFile)),
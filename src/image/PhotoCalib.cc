@@ -22,11 +22,14 @@
 
 #include <cmath>
 #include <iostream>
+#include <algorithm>
 #include <iomanip>
+#include <mutex>
 
 #include "lsst/geom/Point.h"
 #include "lsst/afw/image/PhotoCalib.h"
 #include "lsst/afw/math/BoundedField.h"
+#include "lsst/afw/math/detail/Parallel.h"
 #include "lsst/afw/table/io/CatalogVector.h"
 #include "lsst/afw/table/io/OutputArchive.h"
 #include "lsst/daf/base/PropertySet.h"
@@ -125,6 +128,69 @@ double toMagnitudeErr(double instFlux, double instFluxErr, double scale, double
     return 2.5 / std::log(10.0) * hypot(instFluxErr / instFlux, scaleErr / scale);
 }
 
+// Number of rows of an image (un)calibrated at once by the in-place image methods
+int const CALIBRATION_BAND_HEIGHT = 64;
+
+/**
+ * Update the image and variance of every pixel of a MaskedImage with its calibration.
+ *
+ * The calibration is evaluated one band of rows at a time, into a band-sized temporary, and the bands
+ * are processed on up to nThreads threads.  The calibration itself is evaluated by one thread at a time,
+ * as BoundedFields (for example those backed by AST) need not be safe to evaluate concurrently.
+ * Pixels outside the calibration's bounding box are given a calibration of 1.
+ *
+ * @param maskedImage[in,out] The image to update.
+ * @param calibration[in] The calibration, or null if it is the constant calibrationMean.
+ * @param calibrationMean[in] The constant calibration, used if calibration is null.
+ * @param tolerance[in] The tolerance with which to interpolate the calibration (see
+ *     BoundedField::fillImageInterpolated); 0 to evaluate it at every pixel.
+ * @param nThreads[in] The number of threads to use.
+ * @param func[in] Called as func(image, variance, calibration) for each pixel, with references to its
+ *     image and variance pixels.
+ */
+template <typename F>
+void applyCalibrationInPlace(MaskedImage<float> &maskedImage, math::BoundedField const *calibration,
+                             double calibrationMean, double tolerance, int nThreads, F func) {
+    int const width = maskedImage.getWidth();
+    int const height = maskedImage.getHeight();
+    int const nBands = (height + CALIBRATION_BAND_HEIGHT - 1) / CALIBRATION_BAND_HEIGHT;
+    // Row iterators do not touch reference counts, so unlike the images' arrays they can be used by
+    // any thread
+    std::vector<MaskedImage<float>::Image::x_iterator> imageRows;
+    std::vector<MaskedImage<float>::Variance::x_iterator> varianceRows;
+    imageRows.reserve(height);
+    varianceRows.reserve(height);
+    for (int y = 0; y < height; ++y) {
+        imageRows.push_back(maskedImage.getImage()->row_begin(y));
+        varianceRows.push_back(maskedImage.getVariance()->row_begin(y));
+    }
+    lsst::geom::Point2I const xy0 = maskedImage.getXY0();
+    std::mutex calibrationMutex;
+    math::detail::parallelFor(nBands, nThreads, [&](int band) {
+        int const y0 = band * CALIBRATION_BAND_HEIGHT;
+        int const nRows = std::min(CALIBRATION_BAND_HEIGHT, height - y0);
+        Image<double> values(lsst::geom::Box2I(xy0 + lsst::geom::Extent2I(0, y0),
+                                               lsst::geom::Extent2I(width, nRows)),
+                             calibration ? 1.0 : calibrationMean);
+        if (calibration) {
+            std::lock_guard<std::mutex> lock(calibrationMutex);
+            if (tolerance > 0.0) {
+                calibration->fillImageInterpolated(values, tolerance, true);  // only in the overlap region
+            } else {
+                calibration->fillImage(values, true);
+            }
+        }
+        for (int j = 0; j < nRows; ++j) {
+            auto imageIter = imageRows[y0 + j];
+            auto varianceIter = varianceRows[y0 + j];
+            auto valueIter = values.row_begin(j);
+            for (int x = 0; x < width; ++x, ++imageIter, ++varianceIter, ++valueIter) {
+                func(*imageIter, *varianceIter, static_cast<double>(*valueIter));
+            }
+        }
+    });
+}
+
 }  // anonymous namespace
 
 // ------------------- Conversions to nanojansky -------------------
@@ -173,11 +239,15 @@ void PhotoCalib::instFluxToNanojansky(afw::table::SourceCatalog &sourceCatalog,
     auto instFluxErrKey = sourceCatalog.getSchema().find<double>(instFluxField + "_instFluxErr").key;
     auto nanojanskyKey = sourceCatalog.getSchema().find<double>(outField + "_flux").key;
     auto nanojanskyErrKey = sourceCatalog.getSchema().find<double>(outField + "_fluxErr").key;
+    auto calibration = evaluateCatalog(sourceCatalog);
+    int i = 0;
     for (auto &record : sourceCatalog) {
-        auto result = instFluxToNanojansky(record.get(instFluxKey), record.get(instFluxErrKey),
-                                           record.getCentroid());
-        record.set(nanojanskyKey, result.value);
-        record.set(nanojanskyErrKey, result.error);
+        double instFlux = record.get(instFluxKey);
+        double nanojansky = toNanojansky(instFlux, calibration[i]);
+        record.set(nanojanskyKey, nanojansky);
+        record.set(nanojanskyErrKey, toNanojanskyErr(instFlux, record.get(instFluxErrKey), calibration[i],
+                                                     _calibrationErr, nanojansky));
+        ++i;
     }
 }
 
@@ -228,11 +298,14 @@ void PhotoCalib::instFluxToMagnitude(afw::table::SourceCatalog &sourceCatalog,
     auto instFluxErrKey = sourceCatalog.getSchema().find<double>(instFluxField + "_instFluxErr").key;
     auto magKey = sourceCatalog.getSchema().find<double>(outField + "_mag").key;
     auto magErrKey = sourceCatalog.getSchema().find<double>(outField + "_magErr").key;
+    auto calibration = evaluateCatalog(sourceCatalog);
+    int i = 0;
     for (auto &record : sourceCatalog) {
-        auto result = instFluxToMagnitude(record.get(instFluxKey), record.get(instFluxErrKey),
-                                          record.getCentroid());
-        record.set(magKey, result.value);
-        record.set(magErrKey, result.error);
+        double instFlux = record.get(instFluxKey);
+        record.set(magKey, toMagnitude(instFlux, calibration[i]));
+        record.set(magErrKey,
+                   toMagnitudeErr(instFlux, record.get(instFluxErrKey), calibration[i], _calibrationErr));
+        ++i;
     }
 }
 
@@ -329,6 +402,42 @@ MaskedImage<float> PhotoCalib::uncalibrateImage(MaskedImage<float> const &masked
     return result;
 }
 
+void PhotoCalib::calibrateImageInPlace(MaskedImage<float> &maskedImage, bool includeScaleUncertainty,
+                                       double tolerance, int numThreads) const {
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    if (!(tolerance >= 0.0)) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "Calibration interpolation tolerance must be non-negative");
+    }
+    double const scaleErr2 = includeScaleUncertainty ? _calibrationErr * _calibrationErr : 0.0;
+    applyCalibrationInPlace(maskedImage, _isConstant ? nullptr : _calibration.get(), _calibrationMean,
+                            tolerance, nThreads, [scaleErr2](auto &image, auto &variance, double scale) {
+                                double const instFlux = image;
+                                double const instFluxVar = variance;
+                                image = static_cast<float>(instFlux * scale);
+                                variance = static_cast<float>(scale * scale * instFluxVar +
+                                                              instFlux * instFlux * scaleErr2);
+                            });
+}
+
+void PhotoCalib::uncalibrateImageInPlace(MaskedImage<float> &maskedImage, bool includeScaleUncertainty,
+                                         double tolerance, int numThreads) const {
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    if (!(tolerance >= 0.0)) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "Calibration interpolation tolerance must be non-negative");
+    }
+    double const scaleErr2 = includeScaleUncertainty ? _calibrationErr * _calibrationErr : 0.0;
+    applyCalibrationInPlace(maskedImage, _isConstant ? nullptr : _calibration.get(), _calibrationMean,
+                            tolerance, nThreads, [scaleErr2](auto &image, auto &variance, double scale) {
+                                double const instFlux = static_cast<double>(image) / scale;
+                                double const fluxVar = variance;
+                                image = static_cast<float>(instFlux);
+                                variance = static_cast<float>((fluxVar - instFlux * instFlux * scaleErr2) /
+                                                              (scale * scale));
+                            });
+}
+
 afw::table::SourceCatalog PhotoCalib::calibrateCatalog(afw::table::SourceCatalog const &catalog,
                                                        std::vector<std::string> const &instFluxFields) const {
     auto const &inSchema = catalog.getSchema();
@@ -368,20 +477,22 @@ afw::table::SourceCatalog PhotoCalib::calibrateCatalog(afw::table::SourceCatalog
         keys.emplace_back(newKey);
     }
 
-    // Create the new catalog
+    // Create the new catalog; reserving space first makes its records contiguous, so the
+    // centroids can be read as columns
     afw::table::SourceCatalog output(mapper.getOutputSchema());
+    output.reserve(catalog.size());
     output.insert(mapper, output.begin(), catalog.begin(), catalog.end());
 
     auto calibration = evaluateCatalog(output);
 
-    // fill in the catalog values
+    // fill in the catalog values, all the fields of a record at once as they share cache lines
     int iRec = 0;
     for (auto &rec : output) {
         for (auto &key : keys) {
             double instFlux = rec.get(key.instFlux);
             double nanojansky = toNanojansky(instFlux, calibration[iRec]);
             rec.set(key.flux, nanojansky);
-            rec.set(key.mag, toMagnitude(instFlux, calibration[iRec]));
+            rec.set(key.mag, cpputils::nanojanskyToABMagnitude(nanojansky));
             if (key.instFluxErr.isValid()) {
                 double instFluxErr = rec.get(key.instFluxErr);
                 rec.set(key.fluxErr, toNanojanskyErr(instFlux, instFluxErr, calibration[iRec],
@@ -591,6 +702,17 @@ ndarray::Array<double, 1> PhotoCalib::evaluateArray(ndarray::Array<double, 1> co
 }
 
 ndarray::Array<double, 1> PhotoCalib::evaluateCatalog(afw::table::SourceCatalog const &sourceCatalog) const {
+    if (_isConstant || sourceCatalog.empty()) {
+        ndarray::Array<double, 1> result = ndarray::allocate(ndarray::makeVector(sourceCatalog.size()));
+        result.deep() = _calibrationMean;
+        return result;
+    }
+    if (sourceCatalog.isContiguous()) {
+        // evaluate directly on (strided) views of the centroid columns, without copying them
+        auto const centroidKey = sourceCatalog.getTable()->getCentroidSlot().getMeasKey();
+        auto const columns = sourceCatalog.getColumnView();
+        return evaluateArray(columns[centroidKey.getX()].shallow(), columns[centroidKey.getY()].shallow());
+    }
     ndarray::Array<double, 1> xx = ndarray::allocate(ndarray::makeVector(sourceCatalog.size()));
     ndarray::Array<double, 1> yy = ndarray::allocate(ndarray::makeVector(sourceCatalog.size()));
     size_t i = 0;
@@ -0,0 +1,238 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "lsst/afw/image/PixelAllocator.h"
+
+namespace lsst {
+namespace afw {
+namespace image {
+
+namespace {
+
+std::size_t const HUGE_PAGE_BYTES = std::size_t(1) << 21;
+
+std::size_t roundUp(std::size_t n, std::size_t multiple) { return (n + multiple - 1) / multiple * multiple; }
+
+void* allocateBuffer(std::size_t size, std::size_t alignment, [[maybe_unused]] bool hugePages) {
+    void* data = ::operator new(size, std::align_val_t(alignment));
+#ifdef MADV_HUGEPAGE
+    if (hugePages) {
+        // Only a hint: if the kernel has transparent huge pages disabled this fails harmlessly
+        madvise(data, size, MADV_HUGEPAGE);
+    }
+#endif
+    return data;
+}
+
+void freeBuffer(void* data, std::size_t alignment) noexcept {
+    ::operator delete(data, std::align_val_t(alignment));
+}
+
+std::mutex defaultAllocatorMutex;
+std::shared_ptr<PixelAllocator> defaultAllocator;
+
+// The allocator of the innermost ScopedPixelAllocator on this thread, if active
+struct ThreadAllocator {
+    bool active = false;
+    std::shared_ptr<PixelAllocator> allocator;
+};
+thread_local ThreadAllocator threadAllocator;
+
+}  // namespace
+
+PixelAllocator::~PixelAllocator() noexcept = default;
+
+// Shared by a PooledPixelAllocator and all the buffers it has handed out, so buffers can be
+// released after the allocator is gone.
+struct PooledPixelAllocator::Pool {
+    class Buffer;
+
+    Pool(std::size_t maxCachedBytes_, bool useHugePages_)
+            : maxCachedBytes(maxCachedBytes_), useHugePages(useHugePages_) {}
+
+    ~Pool() noexcept { clear(); }
+
+    // Round a pooled request up to its size class: eight classes per power of two.
+    std::size_t getClassSize(std::size_t nBytes) const {
+        std::size_t octave = 1;
+        while (octave <= nBytes / 2) {
+            octave *= 2;
+        }
+        std::size_t const size = roundUp(nBytes, std::max(octave / 8, ALIGNMENT));
+        return useHugePages && size >= HUGE_PAGE_BYTES ? roundUp(size, HUGE_PAGE_BYTES) : size;
+    }
+
+    std::size_t getAlignment(std::size_t size) const noexcept {
+        return useHugePages && size >= HUGE_PAGE_BYTES ? HUGE_PAGE_BYTES : ALIGNMENT;
+    }
+
+    // Remove and return a cached buffer of the given size class, or null if there is none.
+    void* acquire(std::size_t size) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto iter = cached.find(size);
+        if (iter == cached.end() || iter->second.empty()) {
+            ++statistics.misses;
+            return nullptr;
+        }
+        void* data = iter->second.back();
+        iter->second.pop_back();
+        statistics.cachedBytes -= size;
+        ++statistics.hits;
+        return data;
+    }
+
+    // Keep a buffer for reuse if there is room, and free it otherwise.
+    void release(void* data, std::size_t size) noexcept {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (statistics.cachedBytes + size <= maxCachedBytes) {
+                try {
+                    cached[size].push_back(data);
+                    statistics.cachedBytes += size;
+                    return;
+                } catch (std::bad_alloc const&) {
+                    // fall through and free the buffer
+                }
+            }
+        }
+        freeBuffer(data, getAlignment(size));
+    }
+
+    void clear() noexcept {
+        std::map<std::size_t, std::vector<void*>> old;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            old.swap(cached);
+            statistics.cachedBytes = 0;
+        }
+        for (auto const& entry : old) {
+            for (void* data : entry.second) {
+                freeBuffer(data, getAlignment(entry.first));
+            }
+        }
+    }
+
+    std::size_t const maxCachedBytes;
+    bool const useHugePages;
+    mutable std::mutex mutex;  // guards cached and statistics
+    std::map<std::size_t, std::vector<void*>> cached;
+    Statistics statistics;
+};
+
+// Owner of one buffer; returns a pooled buffer to its pool, or frees an unpooled one.
+class PooledPixelAllocator::Pool::Buffer final : public ndarray::Manager {
+public:
+    Buffer(std::shared_ptr<Pool> pool, void* data, std::size_t size, std::size_t alignment) noexcept
+            : _pool(std::move(pool)), _data(data), _size(size), _alignment(alignment) {}
+
+    ~Buffer() noexcept override {
+        if (_pool) {
+            _pool->release(_data, _size);
+        } else {
+            freeBuffer(_data, _alignment);
+        }
+    }
+
+private:
+    std::shared_ptr<Pool> _pool;
+    void* _data;
+    std::size_t _size;
+    std::size_t _alignment;
+};
+
+PooledPixelAllocator::PooledPixelAllocator(std::size_t maxCachedBytes, bool useHugePages)
+        : _pool(std::make_shared<Pool>(maxCachedBytes, useHugePages)) {}
+
+PooledPixelAllocator::~PooledPixelAllocator() noexcept = default;
+
+std::pair<ndarray::Manager::Ptr, void*> PooledPixelAllocator::allocate(std::size_t nBytes) {
+    std::shared_ptr<Pool> pool;
+    std::size_t size;
+    void* data = nullptr;
+    if (nBytes < MIN_POOLED_BYTES) {
+        size = std::max(roundUp(nBytes, ALIGNMENT), ALIGNMENT);
+        data = allocateBuffer(size, ALIGNMENT, false);
+    } else {
+        pool = _pool;
+        size = pool->getClassSize(nBytes);
+        data = pool->acquire(size);
+        if (!data) {
+            data = allocateBuffer(size, pool->getAlignment(size), pool->useHugePages);
+        }
+    }
+    std::size_t const alignment = pool ? pool->getAlignment(size) : ALIGNMENT;
+    ndarray::Manager::Ptr manager;
+    try {
+        manager.reset(new Pool::Buffer(pool, data, size, alignment));
+    } catch (...) {
+        freeBuffer(data, alignment);
+        throw;
+    }
+    return std::make_pair(manager, data);
+}
+
+PooledPixelAllocator::Statistics PooledPixelAllocator::getStatistics() const {
+    std::lock_guard<std::mutex> lock(_pool->mutex);
+    return _pool->statistics;
+}
+
+void PooledPixelAllocator::clear() { _pool->clear(); }
+
+std::shared_ptr<PixelAllocator> getPixelAllocator() {
+    if (threadAllocator.active) {
+        return threadAllocator.allocator;
+    }
+    std::lock_guard<std::mutex> lock(defaultAllocatorMutex);
+    return defaultAllocator;
+}
+
+void setDefaultPixelAllocator(std::shared_ptr<PixelAllocator> allocator) {
+    std::lock_guard<std::mutex> lock(defaultAllocatorMutex);
+    defaultAllocator.swap(allocator);
+}
+
+ScopedPixelAllocator::ScopedPixelAllocator(std::shared_ptr<PixelAllocator> allocator)
+        : _previousActive(threadAllocator.active), _previous(std::move(threadAllocator.allocator)) {
+    threadAllocator.active = true;
+    threadAllocator.allocator = std::move(allocator);
+}
+
+ScopedPixelAllocator::~ScopedPixelAllocator() noexcept {
+    threadAllocator.active = _previousActive;
+    threadAllocator.allocator = std::move(_previous);
+}
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
@@ -0,0 +1,262 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+#include "boost/format.hpp"
+#include "lsst/cpputils/Cache.h"
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/image/ImageFitsReader.h"
+#include "lsst/afw/image/TiledImage.h"
+#include "lsst/afw/math/detail/Parallel.h"
+
+namespace lsst {
+namespace afw {
+namespace image {
+
+namespace {
+
+void checkCacheCapacity(std::size_t capacity) {
+    if (capacity == 0) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "A TiledImage must be able to keep at least one tile in memory");
+    }
+}
+
+}  // namespace
+
+// The tiles shared by a TiledImage and its views, and the cache of those in memory.
+//
+// cpputils::Cache reorders its entries even on lookup, so every access is locked; tiles are loaded
+// outside the lock, so two threads may occasionally both load the same tile.
+template <typename PixelT>
+class TiledImage<PixelT>::TileStore {
+public:
+    TileStore(std::vector<lsst::geom::Box2I> tileBoxes_, TileLoader loader_, std::size_t capacity,
+              PixelT padValue_)
+            : tileBoxes(std::move(tileBoxes_)), loader(std::move(loader_)), padValue(padValue_) {
+        setCapacity(capacity);
+    }
+
+    std::shared_ptr<ImageT const> getTile(std::size_t i) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto cached = _cache->get(i);
+            if (cached) {
+                return *cached;
+            }
+        }
+        std::shared_ptr<ImageT const> tile = loader(i);
+        if (!tile) {
+            throw LSST_EXCEPT(pex::exceptions::RuntimeError,
+                              (boost::format("Tile %d could not be loaded") % i).str());
+        }
+        if (tile->getBBox() != tileBoxes[i]) {
+            throw LSST_EXCEPT(pex::exceptions::RuntimeError,
+                              (boost::format("Tile %d has bounding box %s, not %s") % i % tile->getBBox() %
+                               tileBoxes[i])
+                                      .str());
+        }
+        ++_loadCount;
+        std::lock_guard<std::mutex> lock(_mutex);
+        return (*_cache)(i, [&tile](std::size_t) { return tile; });
+    }
+
+    std::size_t getCapacity() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _cache->capacity();
+    }
+
+    void setCapacity(std::size_t capacity) {
+        checkCacheCapacity(capacity);
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cache = std::make_unique<cpputils::Cache<std::size_t, std::shared_ptr<ImageT const>>>(capacity);
+    }
+
+    std::size_t getLoadCount() const { return _loadCount; }
+
+    std::vector<lsst::geom::Box2I> const tileBoxes;
+    TileLoader const loader;
+    PixelT const padValue;
+
+private:
+    std::mutex _mutex;
+    std::unique_ptr<cpputils::Cache<std::size_t, std::shared_ptr<ImageT const>>> _cache;
+    std::atomic<std::size_t> _loadCount{0};
+};
+
+template <typename PixelT>
+TiledImage<PixelT>::TiledImage(lsst::geom::Box2I const &bbox, std::vector<lsst::geom::Box2I> tileBoxes,
+                               TileLoader loader, std::size_t cacheCapacity, PixelT padValue)
+        : _store(std::make_shared<TileStore>(std::move(tileBoxes), std::move(loader), cacheCapacity,
+                                             padValue)),
+          _bbox(bbox) {}
+
+template <typename PixelT>
+TiledImage<PixelT>::TiledImage(TiledImage const &rhs, lsst::geom::Box2I const &bbox, ImageOrigin origin)
+        : _store(rhs._store), _bbox(bbox) {
+    if (origin == LOCAL) {
+        _bbox.shift(lsst::geom::Extent2I(rhs._bbox.getMin()));
+    }
+    if (!rhs._bbox.contains(_bbox)) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("Bounding box %s is not within the image %s") % _bbox % rhs._bbox)
+                                  .str());
+    }
+}
+
+template <typename PixelT>
+TiledImage<PixelT> TiledImage<PixelT>::readFits(std::vector<std::string> const &fileNames, int hdu,
+                                                std::size_t cacheCapacity, PixelT padValue) {
+    checkCacheCapacity(cacheCapacity);
+    std::vector<lsst::geom::Box2I> tileBoxes;
+    tileBoxes.reserve(fileNames.size());
+    lsst::geom::Box2I bbox;
+    for (auto const &fileName : fileNames) {
+        ImageFitsReader reader(fileName, hdu);
+        tileBoxes.push_back(reader.readBBox());
+        bbox.include(tileBoxes.back());
+    }
+    auto loader = [fileNames, hdu](std::size_t i) {
+        ImageFitsReader reader(fileNames[i], hdu);
+        return std::make_shared<ImageT const>(reader.read<PixelT>());
+    };
+    return TiledImage(bbox, std::move(tileBoxes), loader, cacheCapacity, padValue);
+}
+
+template <typename PixelT>
+std::size_t TiledImage<PixelT>::getTileCount() const {
+    return _store->tileBoxes.size();
+}
+
+template <typename PixelT>
+lsst::geom::Box2I const &TiledImage<PixelT>::getTileBBox(std::size_t i) const {
+    return _store->tileBoxes[i];
+}
+
+template <typename PixelT>
+PixelT TiledImage<PixelT>::getPadValue() const {
+    return _store->padValue;
+}
+
+template <typename PixelT>
+PixelT TiledImage<PixelT>::get(lsst::geom::Point2I const &point, ImageOrigin origin) const {
+    lsst::geom::Point2I const position = (origin == PARENT) ? point : point + lsst::geom::Extent2I(getXY0());
+    if (!_bbox.contains(position)) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("Pixel %s is not within the image %s") % position % _bbox).str());
+    }
+    // the last tile containing the pixel takes precedence
+    for (std::size_t i = _store->tileBoxes.size(); i > 0; --i) {
+        if (_store->tileBoxes[i - 1].contains(position)) {
+            return _store->getTile(i - 1)->get(position, PARENT);
+        }
+    }
+    return _store->padValue;
+}
+
+template <typename PixelT>
+void TiledImage<PixelT>::_fill(ImageT &image) const {
+    lsst::geom::Box2I const bbox = image.getBBox();
+    image = _store->padValue;
+    for (std::size_t i = 0; i < _store->tileBoxes.size(); ++i) {
+        lsst::geom::Box2I overlap = _store->tileBoxes[i];
+        overlap.clip(bbox);
+        if (overlap.isEmpty()) {
+            continue;
+        }
+        std::shared_ptr<ImageT const> tile = _store->getTile(i);
+        image.assign(ImageT(*tile, overlap, PARENT, false), overlap, PARENT);
+    }
+}
+
+template <typename PixelT>
+std::shared_ptr<Image<PixelT>> TiledImage<PixelT>::read(lsst::geom::Box2I const &bbox,
+                                                        ImageOrigin origin) const {
+    TiledImage const view(*this, bbox, origin);
+    auto result = std::make_shared<ImageT>(view._bbox);
+    view._fill(*result);
+    return result;
+}
+
+template <typename PixelT>
+void TiledImage<PixelT>::forEachBlock(lsst::geom::Extent2I const &blockSize, int halo,
+                                      BlockFunction const &func, int numThreads) const {
+    if (blockSize.getX() <= 0 || blockSize.getY() <= 0) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          (boost::format("Block size %s is not positive") % blockSize).str());
+    }
+    if (halo < 0) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          (boost::format("Halo %d is negative") % halo).str());
+    }
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    if (_bbox.isEmpty()) {
+        return;
+    }
+    int const nx = (getWidth() + blockSize.getX() - 1) / blockSize.getX();
+    int const ny = (getHeight() + blockSize.getY() - 1) / blockSize.getY();
+    math::detail::parallelFor(nx * ny, nThreads, [&](int i) {
+        lsst::geom::Point2I const min =
+                getXY0() + lsst::geom::Extent2I((i % nx) * blockSize.getX(), (i / nx) * blockSize.getY());
+        lsst::geom::Box2I core(min, blockSize);
+        core.clip(_bbox);
+        lsst::geom::Box2I grown(core);
+        grown.grow(halo);
+        grown.clip(_bbox);
+        ImageT block(grown);
+        _fill(block);
+        func(block, core);
+    });
+}
+
+template <typename PixelT>
+std::size_t TiledImage<PixelT>::getCacheCapacity() const {
+    return _store->getCapacity();
+}
+
+template <typename PixelT>
+void TiledImage<PixelT>::setCacheCapacity(std::size_t capacity) {
+    _store->setCapacity(capacity);
+}
+
+template <typename PixelT>
+std::size_t TiledImage<PixelT>::getTileLoadCount() const {
+    return _store->getLoadCount();
+}
+
+//
+// Explicit instantiations
+//
+template class TiledImage<std::uint16_t>;
+template class TiledImage<int>;
+template class TiledImage<float>;
+template class TiledImage<double>;
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
@@ -22,6 +22,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <vector>
 
 #include "ndarray.h"
 
@@ -49,6 +50,15 @@ namespace image {
 
 namespace {
 
+void checkBatchShape(std::vector<lsst::geom::Point2D> const& positions,
+                     ndarray::Array<double const, 1, 1> const& wavelengths,
+                     ndarray::Array<double, 2, 1> const& out) {
+    LSST_THROW_IF_NE(positions.size(), out.getSize<0>(), pex::exceptions::LengthError,
+                     "Number of positions (%d) does not match first dimension of output array (%d)");
+    LSST_THROW_IF_NE(wavelengths.getSize<0>(), out.getSize<1>(), pex::exceptions::LengthError,
+                     "Length of wavelength array (%d) does not match second dimension of output array (%d)");
+}
+
 /*
  * The TransmissionCurve implementation returned by TransmissionCurve::makeIdentity.
  *
@@ -75,6 +85,13 @@ public:
         out.deep() = 1.0;
     }
 
+    void sampleAt(std::vector<lsst::geom::Point2D> const& positions,
+                  ndarray::Array<double const, 1, 1> const& wavelengths,
+                  ndarray::Array<double, 2, 1> const& out) const override {
+        checkBatchShape(positions, wavelengths, out);
+        out.deep() = 1.0;
+    }
+
     bool isPersistable() const noexcept override { return true; }
 
 protected:
@@ -285,6 +302,52 @@ public:
         GslPtr<::gsl_interp_accel> _wavelengthAccel;
     };
 
+    // Evaluate at many positions for InterpolatedTransmissionCurve::sampleAt.  Bilinear interpolation
+    // is linear interpolation in radius between samples at the known radii, so we sample each wavelength
+    // at each known radius once, and then only interpolate in radius for each position.
+    void sampleAtRadii(std::vector<lsst::geom::Point2D> const& positions,
+                       ndarray::Array<double const, 1, 1> const& wavelengths,
+                       std::pair<double, double> const& atBounds,
+                       ndarray::Array<double, 2, 1> const& out) const {
+        int const nWavelengths = wavelengths.getSize<0>();
+        int const nRadii = _radii.getSize<0>();
+        auto const bounds = getWavelengthBounds();
+        auto wavelengthAccel = makeGslPtr(::gsl_interp_accel_alloc(), &gsl_interp_accel_free);
+        auto radiusAccel = makeGslPtr(::gsl_interp_accel_alloc(), &gsl_interp_accel_free);
+        ndarray::Array<double, 2, 2> atRadii = ndarray::allocate(nRadii, nWavelengths);
+        for (int j = 0; j < nRadii; ++j) {
+            for (int k = 0; k < nWavelengths; ++k) {
+                double const wavelength = wavelengths[k];
+                double& y = atRadii[j][k];
+                if (wavelength < bounds.first) {
+                    y = atBounds.first;
+                } else if (wavelength > bounds.second) {
+                    y = atBounds.second;
+                } else {
+                    int status = ::gsl_interp2d_eval_e(
+                            _interp.get(), _wavelengths.getData(), _radii.getData(), _throughput.getData(),
+                            wavelength, _radii[j], wavelengthAccel.get(), radiusAccel.get(), &y);
+                    LSST_CHECK_GSL(pex::exceptions::RuntimeError, status);
+                }
+            }
+        }
+        for (std::size_t i = 0; i < positions.size(); ++i) {
+            double radius = positions[i].asEigen().norm();
+            radius = std::max(radius, _radii.front());
+            radius = std::min(radius, _radii.back());
+            // the interval [_radii[j], _radii[j + 1]] containing radius
+            int j = std::upper_bound(_radii.begin(), _radii.end(), radius) - _radii.begin() - 1;
+            j = std::max(0, std::min(j, nRadii - 2));
+            double const u = (radius - _radii[j]) / (_radii[j + 1] - _radii[j]);
+            double const* lower = atRadii[j].getData();
+            double const* upper = atRadii[j + 1].getData();
+            double* row = out[i].getData();
+            for (int k = 0; k < nWavelengths; ++k) {
+                row[k] = lower[k] + u * (upper[k] - lower[k]);
+            }
+        }
+    }
+
 private:
     ndarray::Array<double, 1, 1> _throughput;
     ndarray::Array<double, 1, 1> _wavelengths;
@@ -326,6 +389,25 @@ public:
         }
     }
 
+    void sampleAt(std::vector<lsst::geom::Point2D> const& positions,
+                  ndarray::Array<double const, 1, 1> const& wavelengths,
+                  ndarray::Array<double, 2, 1> const& out) const override {
+        checkBatchShape(positions, wavelengths, out);
+        if (positions.empty()) {
+            return;
+        }
+        if constexpr (Impl::isSpatiallyConstant) {
+            // the throughput is the same everywhere: evaluate it once
+            ndarray::Array<double, 1, 1> first = out[0];
+            sampleAt(positions.front(), wavelengths, first);
+            for (std::size_t i = 1; i < positions.size(); ++i) {
+                out[i] = first;
+            }
+        } else {
+            _impl.sampleAtRadii(positions, wavelengths, _atBounds, out);
+        }
+    }
+
     bool isPersistable() const noexcept override { return true; }
 
 protected:
@@ -455,6 +537,16 @@ public:
         out.deep() *= tmp;
     }
 
+    void sampleAt(std::vector<lsst::geom::Point2D> const& positions,
+                  ndarray::Array<double const, 1, 1> const& wavelengths,
+                  ndarray::Array<double, 2, 1> const& out) const override {
+        checkBatchShape(positions, wavelengths, out);
+        _a->sampleAt(positions, wavelengths, out);
+        ndarray::Array<double, 2, 2> tmp = ndarray::allocate(out.getShape());
+        _b->sampleAt(positions, wavelengths, tmp);
+        out.deep() *= tmp;
+    }
+
     bool isPersistable() const noexcept override { return _a->isPersistable() && _b->isPersistable(); }
 
 protected:
@@ -536,6 +628,13 @@ public:
         return _nested->sampleAt(_transform->applyInverse(position), wavelengths, out);
     }
 
+    void sampleAt(std::vector<lsst::geom::Point2D> const& positions,
+                  ndarray::Array<double const, 1, 1> const& wavelengths,
+                  ndarray::Array<double, 2, 1> const& out) const override {
+        checkBatchShape(positions, wavelengths, out);
+        _nested->sampleAt(_transform->applyInverse(positions), wavelengths, out);
+    }
+
     bool isPersistable() const noexcept override {
         return _nested->isPersistable() && _transform->isPersistable();
     }
@@ -668,6 +767,24 @@ ndarray::Array<double, 1, 1> TransmissionCurve::sampleAt(
     return out;
 }
 
+void TransmissionCurve::sampleAt(std::vector<lsst::geom::Point2D> const& positions,
+                                 ndarray::Array<double const, 1, 1> const& wavelengths,
+                                 ndarray::Array<double, 2, 1> const& out) const {
+    checkBatchShape(positions, wavelengths, out);
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        ndarray::Array<double, 1, 1> row = out[i];
+        sampleAt(positions[i], wavelengths, row);
+    }
+}
+
+ndarray::Array<double, 2, 2> TransmissionCurve::sampleAt(
+        std::vector<lsst::geom::Point2D> const& positions,
+        ndarray::Array<double const, 1, 1> const& wavelengths) const {
+    ndarray::Array<double, 2, 2> out = ndarray::allocate(positions.size(), wavelengths.getSize<0>());
+    sampleAt(positions, wavelengths, out);
+    return out;
+}
+
 std::shared_ptr<TransmissionCurve const> TransmissionCurve::_transformedByImpl(
         std::shared_ptr<geom::TransformPoint2ToPoint2> transform) const {
     return std::make_shared<TransformedTransmissionCurve>(shared_from_this(), std::move(transform));
@@ -20,6 +20,7 @@
  * the GNU General Public License along with this program.  If not,
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <sstream>
@@ -37,6 +38,7 @@
 #include "lsst/afw/table/io/OutputArchive.h"
 #include "lsst/afw/table/io/InputArchive.h"
 #include "lsst/afw/table/io/CatalogVector.h"  // needed, but why?
+#include "lsst/afw/coord/Refraction.h"
 #include "lsst/afw/image/VisitInfo.h"
 #include "lsst/afw/table/io/Persistable.cc"
 
@@ -627,6 +629,86 @@ lsst::geom::Angle VisitInfo::getBoresightParAngle() const {
     return result * lsst::geom::radians;
 }
 
+namespace {
+
+void checkSameLength(ndarray::Array<double const, 1> const& ra, ndarray::Array<double const, 1> const& dec) {
+    if (ra.getSize<0>() != dec.getSize<0>()) {
+        std::ostringstream os;
+        os << "ra has " << ra.getSize<0>() << " elements but dec has " << dec.getSize<0>();
+        throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
+    }
+}
+
+// The weather for computing refraction, with typical weather for the observatory if it is unknown
+coord::Weather getRefractionWeather(VisitInfo const& visitInfo) {
+    coord::Weather const weather = visitInfo.getWeather();
+    if (std::isfinite(weather.getAirTemperature()) && std::isfinite(weather.getAirPressure()) &&
+        std::isfinite(weather.getHumidity())) {
+        return weather;
+    }
+    return coord::makeDefaultWeather(visitInfo.getObservatory().getElevation());
+}
+
+}  // namespace
+
+ndarray::Array<double, 1, 1> VisitInfo::getAltitude(ndarray::Array<double const, 1> const& ra,
+                                                    ndarray::Array<double const, 1> const& dec) const {
+    checkSameLength(ra, dec);
+    double const localEra = getLocalEra().asRadians();
+    double const sinLat = std::sin(getObservatory().getLatitude().asRadians());
+    double const cosLat = std::cos(getObservatory().getLatitude().asRadians());
+    ndarray::Array<double, 1, 1> result = ndarray::allocate(ra.getSize<0>());
+    for (int i = 0, n = ra.getSize<0>(); i < n; ++i) {
+        double const hourAngle = localEra - ra[i];
+        double const sinAlt = std::sin(dec[i]) * sinLat + std::cos(dec[i]) * cosLat * std::cos(hourAngle);
+        result[i] = std::asin(std::max(-1.0, std::min(1.0, sinAlt)));
+    }
+    return result;
+}
+
+ndarray::Array<double, 1, 1> VisitInfo::getParAngle(ndarray::Array<double const, 1> const& ra,
+                                                    ndarray::Array<double const, 1> const& dec) const {
+    checkSameLength(ra, dec);
+    double const localEra = getLocalEra().asRadians();
+    double const tanLat = std::tan(getObservatory().getLatitude().asRadians());
+    ndarray::Array<double, 1, 1> result = ndarray::allocate(ra.getSize<0>());
+    for (int i = 0, n = ra.getSize<0>(); i < n; ++i) {
+        double const hourAngle = localEra - ra[i];
+        result[i] = std::atan2(std::sin(hourAngle),
+                               std::cos(dec[i]) * tanLat - std::sin(dec[i]) * std::cos(hourAngle));
+    }
+    return result;
+}
+
+ndarray::Array<double, 1, 1> VisitInfo::getAirmass(ndarray::Array<double const, 1> const& ra,
+                                                   ndarray::Array<double const, 1> const& dec) const {
+    ndarray::Array<double, 1, 1> result = getAltitude(ra, dec);
+    for (auto& value : result) {
+        double const cosZ = std::sin(value);
+        if (cosZ < 0.0) {
+            value = std::numeric_limits<double>::quiet_NaN();
+            continue;
+        }
+        value = (1.002432 * cosZ * cosZ + 0.148386 * cosZ + 0.0096467) /
+                (cosZ * cosZ * cosZ + 0.149864 * cosZ * cosZ + 0.0102963 * cosZ + 0.000303978);
+    }
+    return result;
+}
+
+ndarray::Array<double, 1, 1> VisitInfo::getRefraction(double wavelength,
+                                                      ndarray::Array<double const, 1> const& ra,
+                                                      ndarray::Array<double const, 1> const& dec) const {
+    return coord::computeRefraction(wavelength, getAltitude(ra, dec), getObservatory(),
+                                    getRefractionWeather(*this));
+}
+
+ndarray::Array<double, 1, 1> VisitInfo::getDifferentialRefraction(
+        double wavelength, double wavelengthRef, ndarray::Array<double const, 1> const& ra,
+        ndarray::Array<double const, 1> const& dec) const {
+    return coord::computeDifferentialRefraction(wavelength, wavelengthRef, getAltitude(ra, dec),
+                                                getObservatory(), getRefractionWeather(*this));
+}
+
 std::shared_ptr<typehandling::Storable> VisitInfo::cloneStorable() const {
     return std::make_unique<VisitInfo>(*this);
 }
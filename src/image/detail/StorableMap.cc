@@ -22,6 +22,7 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
 #include <unordered_map>
 #include <utility>
 
@@ -32,36 +33,59 @@ namespace afw {
 namespace image {
 namespace detail {
 
-StorableMap::StorableMap() = default;
+StorableMap::StorableMap() : _contents(_emptyContents()) {}
 StorableMap::StorableMap(StorableMap const& other) = default;
-StorableMap::StorableMap(StorableMap&& other) = default;
+StorableMap::StorableMap(StorableMap&& other) : _contents(std::exchange(other._contents, _emptyContents())) {}
 StorableMap& StorableMap::operator=(StorableMap const& other) = default;
-StorableMap& StorableMap::operator=(StorableMap&& other) = default;
+StorableMap& StorableMap::operator=(StorableMap&& other) {
+    if (this != &other) {
+        _contents = std::exchange(other._contents, _emptyContents());
+    }
+    return *this;
+}
 StorableMap::~StorableMap() noexcept = default;
 
-StorableMap::StorableMap(std::initializer_list<value_type> init) : _contents(init){};
+StorableMap::StorableMap(std::initializer_list<value_type> init) : _contents(std::make_shared<_Impl>(init)){};
+
+std::shared_ptr<StorableMap::_Impl> const& StorableMap::_emptyContents() {
+    static std::shared_ptr<_Impl> const empty = std::make_shared<_Impl>();
+    return empty;
+}
+
+StorableMap::_Impl& StorableMap::_mutableContents() {
+    // The shared empty contents always have a count of at least 2, so they are never modified.
+    if (_contents.use_count() > 1) {
+        _contents = std::make_shared<_Impl>(*_contents);
+    } else {
+        // Make sure any reads by a copy that was destroyed on another thread happen before our writes.
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return *_contents;
+}
 
-StorableMap::size_type StorableMap::size() const noexcept { return _contents.size(); }
+StorableMap::size_type StorableMap::size() const noexcept { return _contents->size(); }
 
-bool StorableMap::empty() const noexcept { return _contents.empty(); }
+bool StorableMap::empty() const noexcept { return _contents->empty(); }
 
-StorableMap::size_type StorableMap::max_size() const noexcept { return _contents.max_size(); }
+StorableMap::size_type StorableMap::max_size() const noexcept { return _contents->max_size(); }
 
-bool StorableMap::contains(std::string const& key) const { return _contents.count(key_type(key)) == 1; }
+bool StorableMap::contains(std::string const& key) const { return _contents->count(key_type(key)) == 1; }
 
-bool StorableMap::operator==(StorableMap const& other) const noexcept { return _contents == other._contents; }
+bool StorableMap::operator==(StorableMap const& other) const noexcept {
+    return _contents == other._contents || *_contents == *other._contents;
+}
 
-void StorableMap::clear() noexcept { _contents.clear(); }
+void StorableMap::clear() noexcept { _contents = _emptyContents(); }
 
 StorableMap::const_iterator StorableMap::begin() const noexcept {
-    return StorableMap::const_iterator(_contents.begin());
+    return StorableMap::const_iterator(_contents->cbegin());
 }
 StorableMap::const_iterator StorableMap::end() const noexcept {
-    return StorableMap::const_iterator(_contents.end());
+    return StorableMap::const_iterator(_contents->cend());
 };
 
-StorableMap::iterator StorableMap::begin() noexcept { return StorableMap::iterator(_contents.begin()); };
-StorableMap::iterator StorableMap::end() noexcept { return StorableMap::iterator(_contents.end()); };
+StorableMap::iterator StorableMap::begin() { return StorableMap::iterator(_mutableContents().begin()); };
+StorableMap::iterator StorableMap::end() { return StorableMap::iterator(_mutableContents().end()); };
 
 }  // namespace detail
 }  // namespace image
@@ -66,6 +66,7 @@ std::shared_ptr<Kernel> AnalyticKernel::clone() const {
         retPtr.reset(new AnalyticKernel(this->getWidth(), this->getHeight(), *(this->_kernelFunctionPtr)));
     }
     retPtr->setCtr(this->getCtr());
+    retPtr->setImageCache(this->getImageCacheMaxSize(), this->getImageCachePositionQuantum());
     return retPtr;
 }
 
@@ -83,7 +84,7 @@ double AnalyticKernel::computeImage(image::Image<Pixel> &image, bool doNormalize
     lsst::geom::Extent2I llBorder = (image.getDimensions() - getDimensions()) / 2;
     image.setXY0(lsst::geom::Point2I(-lsst::geom::Extent2I(getCtr() + llBorder)));
     if (this->isSpatiallyVarying()) {
-        this->setKernelParametersFromSpatialModel(x, y);
+        return computeSpatiallyVaryingImage(image, doNormalize, x, y);
     }
     return doComputeImage(image, doNormalize);
 }
@@ -30,6 +30,7 @@
 #include <cmath>
 #include <memory>
 #include <numeric>
+#include <vector>
 #include "Eigen/Core"
 #include "Eigen/LU"
 #include "boost/format.hpp"
@@ -37,6 +38,7 @@
 #include "lsst/afw/math/FunctionLibrary.h"
 #include "lsst/afw/image/MaskedImage.h"
 #include "lsst/afw/math/Approximate.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace lsst {
 namespace ex = pex::exceptions;
@@ -44,7 +46,11 @@ namespace afw {
 namespace math {
 
 ApproximateControl::ApproximateControl(Style style, int orderX, int orderY, bool weighting)
-        : _style(style), _orderX(orderX), _orderY(orderY < 0 ? orderX : orderY), _weighting(weighting) {
+        : _style(style),
+          _orderX(orderX),
+          _orderY(orderY < 0 ? orderX : orderY),
+          _weighting(weighting),
+          _numThreads(1) {
     if (_orderX != _orderY) {
         throw LSST_EXCEPT(lsst::pex::exceptions::InvalidParameterError,
                           str(boost::format("X- and Y-orders must be equal (%d != %d) "
@@ -53,6 +59,14 @@ ApproximateControl::ApproximateControl(Style style, int orderX, int orderY, bool
     }
 }
 
+void ApproximateControl::setNumThreads(int numThreads) {
+    if (numThreads < 0) {
+        throw LSST_EXCEPT(lsst::pex::exceptions::InvalidParameterError,
+                          "numThreads must be >= 0 (0 means one per hardware thread)");
+    }
+    _numThreads = numThreads;
+}
+
 namespace {
 /**
  * @internal Specialisation of Approximate in Chebyshev polynomials
@@ -77,6 +91,8 @@ private:
                          ApproximateControl const& ctrl);
     std::shared_ptr<image::Image<typename Approximate<PixelT>::OutPixelT>> doGetImage(
             int orderX, int orderY) const override;
+    std::shared_ptr<image::Image<typename Approximate<PixelT>::OutPixelT>> doGetImage(
+            lsst::geom::Box2I const& bbox, int orderX, int orderY) const override;
     std::shared_ptr<image::MaskedImage<typename Approximate<PixelT>::OutPixelT>> doGetMaskedImage(
             int orderX, int orderY) const override;
 };
@@ -88,6 +104,75 @@ inline void solveMatrix_Eigen(Eigen::MatrixXd& a, Eigen::VectorXd& b, Eigen::Map
     Eigen::PartialPivLU<Eigen::MatrixXd> lu(a);
     c = lu.solve(b);
 }
+
+/*
+ * Return T_0(x') ... T_order(x') for each of `n` positions x = x0, x0 + 1, ..., one position per column,
+ * where x' = (x - centre)/halfWidth maps [min, max] onto [-1, 1] as in Chebyshev1Function2
+ */
+Eigen::MatrixXd chebyshevBasis(int order, double x0, int n, double min, double max) {
+    double const scale = 2.0 / (max - min);
+    double const offset = -(min + max) * 0.5;
+    Eigen::MatrixXd basis(order + 1, n);
+    for (int i = 0; i != n; ++i) {
+        double const xPrime = (x0 + i + offset) * scale;
+        basis(0, i) = 1.0;
+        if (order > 0) {
+            basis(1, i) = xPrime;
+        }
+        for (int k = 2; k <= order; ++k) {
+            basis(k, i) = 2 * xPrime * basis(k - 1, i) - basis(k - 2, i);
+        }
+    }
+    return basis;
+}
+
+/*
+ * Evaluate poly at every pixel of `im`, whose pixel (0, 0) is at (x0, y0) in poly's coordinates
+ *
+ * The polynomial is separable: im(x, y) = sum_jk C(j, k) T_j(y') T_k(x'), so rather than evaluating
+ * it pixel by pixel we tabulate the basis once per column and once per row, and fill each band of
+ * rows with a single matrix product.  Bands are processed concurrently using nThreads threads.
+ */
+template <typename PixelT>
+void evaluateChebyshev(math::Chebyshev1Function2<double> const& poly, double x0, double y0, int nThreads,
+                       image::Image<PixelT>& im) {
+    int const order = poly.getOrder();
+    int const width = im.getWidth();
+    int const height = im.getHeight();
+    if (width == 0 || height == 0) {
+        return;
+    }
+    /*
+     * The parameters are stored by increasing total order, and within an order by increasing
+     * power of y:  T0(x)T0(y), T1(x)T0(y), T0(x)T1(y), T2(x)T0(y), ...
+     */
+    std::vector<double> const& params = poly.getParameters();
+    Eigen::MatrixXd coeffs = Eigen::MatrixXd::Zero(order + 1, order + 1);  // coeffs(yOrder, xOrder)
+    for (int n = 0, iParam = 0; n <= order; ++n) {
+        for (int yOrder = 0; yOrder <= n; ++yOrder, ++iParam) {
+            coeffs(yOrder, n - yOrder) = params[iParam];
+        }
+    }
+
+    lsst::geom::Box2D const range = poly.getXYRange();
+    // coeffs*xBasis holds, for each column, the coefficient of each y basis polynomial
+    Eigen::MatrixXd const xTerms =
+            coeffs * chebyshevBasis(order, x0, width, range.getMinX(), range.getMaxX());
+    Eigen::MatrixXd const yBasis = chebyshevBasis(order, y0, height, range.getMinY(), range.getMaxY());
+
+    auto const bands = detail::splitRange(0, height, detail::resolveNumThreads(nThreads));
+    int const nBands = bands.size();
+    detail::parallelFor(nBands, nThreads, [&bands, &xTerms, &yBasis, &im, width](int iBand) {
+        int const yBegin = bands[iBand].first;
+        int const bandHeight = bands[iBand].second - yBegin;
+        Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> const values =
+                yBasis.middleCols(yBegin, bandHeight).transpose() * xTerms;
+        for (int iy = 0; iy != bandHeight; ++iy) {
+            std::copy(values.data() + iy * width, values.data() + (iy + 1) * width,
+                      im.row_begin(yBegin + iy));
+        }
+    });
+}
 }  // namespace
 
 /**
@@ -216,6 +301,25 @@ ApproximateChebyshev<PixelT>::~ApproximateChebyshev() = default;
 template <typename PixelT>
 std::shared_ptr<image::Image<typename Approximate<PixelT>::OutPixelT>>
 ApproximateChebyshev<PixelT>::doGetImage(int orderX, int orderY) const {
+    return doGetImage(Approximate<PixelT>::_bbox, orderX, orderY);
+}
+/**
+ * @internal worker function for getImage over part of the domain
+ *
+ * @param bbox Region to evaluate
+ * @param orderX Order of approximation to use in x-direction
+ * @param orderY Order of approximation to use in y-direction
+ */
+template <typename PixelT>
+std::shared_ptr<image::Image<typename Approximate<PixelT>::OutPixelT>>
+ApproximateChebyshev<PixelT>::doGetImage(lsst::geom::Box2I const& bbox, int orderX, int orderY) const {
+    lsst::geom::Box2I const& domain = Approximate<PixelT>::_bbox;
+    if (!domain.contains(bbox)) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          str(boost::format("BBox (%d:%d,%d:%d) out of range (%d:%d,%d:%d)") %
+                              bbox.getMinX() % bbox.getMaxX() % bbox.getMinY() % bbox.getMaxY() %
+                              domain.getMinX() % domain.getMaxX() % domain.getMinY() % domain.getMaxY()));
+    }
     if (orderX < 0) orderX = Approximate<PixelT>::_ctrl.getOrderX();
     if (orderY < 0) orderY = Approximate<PixelT>::_ctrl.getOrderY();
 
@@ -226,18 +330,10 @@ ApproximateChebyshev<PixelT>::doGetImage(int orderX, int orderY) const {
 
     using ImageT = typename image::Image<typename Approximate<PixelT>::OutPixelT>;
 
-    std::shared_ptr<ImageT> im(new ImageT(Approximate<PixelT>::_bbox));
-    for (int iy = 0; iy != im->getHeight(); ++iy) {
-        double const y = iy;
-
-        int ix = 0;
-        for (typename ImageT::x_iterator ptr = im->row_begin(iy), end = im->row_end(iy); ptr != end;
-             ++ptr, ++ix) {
-            double const x = ix;
-
-            *ptr = poly(x, y);
-        }
-    }
+    // positions are measured from the corner of the domain, as for the full image
+    auto const offset = bbox.getMin() - domain.getMin();
+    std::shared_ptr<ImageT> im(new ImageT(bbox));
+    evaluateChebyshev(poly, offset.getX(), offset.getY(), Approximate<PixelT>::_ctrl.getNumThreads(), *im);
 
     return im;
 }
@@ -256,22 +352,8 @@ std::shared_ptr<image::MaskedImage<typename Approximate<PixelT>::OutPixelT>>
 ApproximateChebyshev<PixelT>::doGetMaskedImage(int orderX, int orderY) const {
     using MImageT = typename image::MaskedImage<typename Approximate<PixelT>::OutPixelT>;
 
-    std::shared_ptr<MImageT> mi(new MImageT(Approximate<PixelT>::_bbox));
-    std::shared_ptr<typename MImageT::Image> im = mi->getImage();
-
-    for (int iy = 0; iy != im->getHeight(); ++iy) {
-        double const y = iy;
-
-        int ix = 0;
-        for (typename MImageT::Image::x_iterator ptr = im->row_begin(iy), end = im->row_end(iy); ptr != end;
-             ++ptr, ++ix) {
-            double const x = ix;
-
-            *ptr = _poly(x, y);
-        }
-    }
-
-    return mi;
+    // the mask and variance are set to zero
+    return std::make_shared<MImageT>(doGetImage(Approximate<PixelT>::_bbox, orderX, orderY));
 }
 }  // namespace
 
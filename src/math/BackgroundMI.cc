@@ -25,7 +25,9 @@
 /*
  * Background estimation class code
  */
+#include <algorithm>
 #include <limits>
+#include <numeric>
 #include <vector>
 #include <cmath>
 #include "lsst/afw/image/MaskedImage.h"
@@ -33,6 +35,7 @@
 #include "lsst/afw/math/Approximate.h"
 #include "lsst/afw/math/Background.h"
 #include "lsst/afw/math/Statistics.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace lsst {
 namespace ex = pex::exceptions;
@@ -74,11 +77,91 @@ void cullNan(std::vector<double> const& values, std::vector<double> const& refs,
         }
     }
 }
+
+// Number of rows evaluated at a time by BackgroundImageView::subtractFrom
+int const BACKGROUND_STRIP_HEIGHT = 128;
+
+/*
+ * Interpolate rows [yBegin, yEnd) of a background image along x
+ *
+ * Pixel (x, y) of `out` is the background at pixel (x, y) + offset of the image the background was
+ * estimated from, where gridColumns holds the grid columns interpolated to every row of that image.
+ */
+template <typename PixelT>
+void interpolateRows(std::vector<std::vector<double>> const& gridColumns, std::vector<double> const& xcen,
+                     Interpolate::Style const interpStyle, UndersampleStyle const undersampleStyle,
+                     lsst::geom::Extent2I const& offset, int const yBegin, int const yEnd,
+                     image::Image<PixelT>& out) {
+    int const nxSample = xcen.size();
+    std::vector<double> xcenTmp, bgTmp;
+
+    // every row is interpolated to the same (sorted) pixel positions
+    int const width = out.getWidth();
+    std::vector<double> xpix(width);
+    std::iota(xpix.begin(), xpix.end(), offset.getX());
+    std::vector<double> rowValues(width);
+
+    // N.b. There's no API to set defaultValue to other than NaN (due to issues with persistence
+    // that I don't feel like fixing;  #2825).  If we want to address this, this is the place
+    // to start, but note that NaN is treated specially -- it means, "Interpolate" so to allow
+    // us to put a NaN into the outputs some changes will be needed
+    double const defaultValue = std::numeric_limits<double>::quiet_NaN();
+
+    for (int y = yBegin, iY = offset.getY() + yBegin; y < yEnd; ++y, ++iY) {
+        // build an interp object for this row
+        std::vector<double> bg_x(nxSample);
+        for (int iX = 0; iX < nxSample; iX++) {
+            bg_x[iX] = static_cast<double>(gridColumns[iX][iY]);
+        }
+        cullNan(xcen, bg_x, xcenTmp, bgTmp, defaultValue);
+
+        std::shared_ptr<Interpolate> intobj;
+        try {
+            intobj = makeInterpolate(xcenTmp, bgTmp, interpStyle);
+        } catch (pex::exceptions::OutOfRangeError& e) {
+            switch (undersampleStyle) {
+                case THROW_EXCEPTION:
+                    LSST_EXCEPT_ADD(e, str(boost::format("Interpolating in y (iY = %d)") % iY));
+                    throw;
+                case REDUCE_INTERP_ORDER: {
+                    if (bgTmp.empty()) {
+                        xcenTmp.push_back(0);
+                        bgTmp.push_back(defaultValue);
+
+                        intobj = makeInterpolate(xcenTmp, bgTmp, Interpolate::CONSTANT);
+                        break;
+                    } else {
+                        intobj = makeInterpolate(xcenTmp, bgTmp, lookupMaxInterpStyle(bgTmp.size()));
+                    }
+                } break;
+                case INCREASE_NXNYSAMPLE:
+                    LSST_EXCEPT_ADD(e, "The BackgroundControl UndersampleStyle INCREASE_NXNYSAMPLE "
+                                       "is not supported.");
+                    throw;
+                default:
+                    LSST_EXCEPT_ADD(e, str(boost::format("The selected BackgroundControl "
+                                                         "UndersampleStyle %d is not defined.") %
+                                           undersampleStyle));
+                    throw;
+            }
+        } catch (ex::Exception& e) {
+            LSST_EXCEPT_ADD(e, str(boost::format("Interpolating in y (iY = %d)") % iY));
+            throw;
+        }
+
+        // fill the image with interpolated values
+        intobj->interpolate(xpix.data(), width, rowValues.data());
+        std::copy(rowValues.begin(), rowValues.end(), out.row_begin(y));
+    }
+}
 }  // namespace
 
 template <typename ImageT>
 BackgroundMI::BackgroundMI(ImageT const& img, BackgroundControl const& bgCtrl)
-        : Background(img, bgCtrl), _statsImage(image::MaskedImage<InternalPixelT>()) {
+        : Background(img, bgCtrl),
+          _statsImage(image::MaskedImage<InternalPixelT>()),
+          _gridColumnsInterpStyle(Interpolate::UNKNOWN),
+          _gridColumnsUndersampleStyle(THROW_EXCEPTION) {
     // =============================================================
     // Loop over the cells in the image, computing statistical properties
     // of each cell in turn and using them to set _statsImage
@@ -86,27 +169,92 @@ BackgroundMI::BackgroundMI(ImageT const& img, BackgroundControl const& bgCtrl)
     int const nySample = bgCtrl.getNySample();
     _statsImage = image::MaskedImage<InternalPixelT>(nxSample, nySample);
 
+    std::vector<std::pair<int, int>> cells;
+    cells.reserve(nxSample * nySample);
+    for (int iX = 0; iX < nxSample; ++iX) {
+        for (int iY = 0; iY < nySample; ++iY) {
+            cells.emplace_back(iX, iY);
+        }
+    }
+    _measureCells(img, cells);
+}
+
+template <typename ImageT>
+void BackgroundMI::_measureCells(ImageT const& img, std::vector<std::pair<int, int>> const& cells) {
     image::MaskedImage<InternalPixelT>::Image& im = *_statsImage.getImage();
     image::MaskedImage<InternalPixelT>::Variance& var = *_statsImage.getVariance();
 
-    for (int iX = 0; iX < nxSample; ++iX) {
-        for (int iY = 0; iY < nySample; ++iY) {
+    // The cells are independent, so measure bands of them concurrently; each band works with
+    // its own copy of the StatisticsControl
+    int const nThreads = detail::resolveNumThreads(_bctrl->getNumThreads());
+    auto const bands = detail::splitRange(0, static_cast<int>(cells.size()), nThreads);
+    int const nBands = bands.size();
+    detail::parallelFor(nBands, nThreads, [&](int iBand) {
+        StatisticsControl const sctrl(*_bctrl->getStatisticsControl());
+        for (int i = bands[iBand].first; i < bands[iBand].second; ++i) {
+            int const iX = cells[i].first;
+            int const iY = cells[i].second;
             ImageT subimg = ImageT(img,
                                    lsst::geom::Box2I(lsst::geom::Point2I(_xorig[iX], _yorig[iY]),
                                                      lsst::geom::Extent2I(_xsize[iX], _ysize[iY])),
                                    image::LOCAL);
 
-            std::pair<double, double> res = makeStatistics(subimg, bgCtrl.getStatisticsProperty() | ERRORS,
-                                                           *bgCtrl.getStatisticsControl())
-                                                    .getResult();
+            std::pair<double, double> res =
+                    makeStatistics(subimg, _bctrl->getStatisticsProperty() | ERRORS, sctrl).getResult();
             im(iX, iY) = res.first;
             var(iX, iY) = res.second;
         }
+    });
+}
+
+template <typename ImageT>
+void BackgroundMI::update(ImageT const& img, lsst::geom::Box2I const& changedBBox) {
+    // the cells overlapping changedBBox, in LOCAL coordinates
+    lsst::geom::Box2I changed(changedBBox);
+    changed.shift(lsst::geom::Point2I(0, 0) - _imgBBox.getMin());
+    ndarray::Array<bool, 2, 1> dirtyCells =
+            ndarray::allocate(_statsImage.getHeight(), _statsImage.getWidth());
+    for (int iY = 0; iY < _statsImage.getHeight(); ++iY) {
+        for (int iX = 0; iX < _statsImage.getWidth(); ++iX) {
+            lsst::geom::Box2I const cell(lsst::geom::Point2I(_xorig[iX], _yorig[iY]),
+                                         lsst::geom::Extent2I(_xsize[iX], _ysize[iY]));
+            dirtyCells[iY][iX] = cell.overlaps(changed);
+        }
     }
+    update(img, ndarray::Array<bool const, 2, 1>(dirtyCells));
 }
+
+template <typename ImageT>
+void BackgroundMI::update(ImageT const& img, ndarray::Array<bool const, 2, 1> const& dirtyCells) {
+    if (img.getBBox() != _imgBBox) {
+        throw LSST_EXCEPT(ex::LengthError,
+                          str(boost::format("Image bbox %s differs from the background's bbox %s") %
+                              img.getBBox() % _imgBBox));
+    }
+    if (dirtyCells.getSize<0>() != static_cast<std::size_t>(_statsImage.getHeight()) ||
+        dirtyCells.getSize<1>() != static_cast<std::size_t>(_statsImage.getWidth())) {
+        throw LSST_EXCEPT(ex::LengthError,
+                          str(boost::format("Cell array is %dx%d, not %dx%d (nySample x nxSample)") %
+                              dirtyCells.getSize<0>() % dirtyCells.getSize<1>() % _statsImage.getHeight() %
+                              _statsImage.getWidth()));
+    }
+    std::vector<std::pair<int, int>> cells;
+    for (int iX = 0; iX < _statsImage.getWidth(); ++iX) {
+        for (int iY = 0; iY < _statsImage.getHeight(); ++iY) {
+            if (dirtyCells[iY][iX]) {
+                cells.emplace_back(iX, iY);
+            }
+        }
+    }
+    _measureCells(img, cells);
+}
+
 BackgroundMI::BackgroundMI(lsst::geom::Box2I const imageBBox,
                            image::MaskedImage<InternalPixelT> const& statsImage)
-        : Background(imageBBox, statsImage.getWidth(), statsImage.getHeight()), _statsImage(statsImage) {}
+        : Background(imageBBox, statsImage.getWidth(), statsImage.getHeight()),
+          _statsImage(statsImage),
+          _gridColumnsInterpStyle(Interpolate::UNKNOWN),
+          _gridColumnsUndersampleStyle(THROW_EXCEPTION) {}
 
 void BackgroundMI::_setGridColumns(Interpolate::Style const interpStyle,
                                    UndersampleStyle const undersampleStyle, int const iX,
@@ -161,9 +309,8 @@ void BackgroundMI::_setGridColumns(Interpolate::Style const interpStyle,
         throw;
     }
 
-    for (int iY = 0; iY < height; ++iY) {
-        _gridColumns[iX][iY] = intobj->interpolate(ypix[iY]);
-    }
+    std::vector<double> const yInterp(ypix.begin(), ypix.end());
+    intobj->interpolate(yInterp.data(), height, _gridColumns[iX].data());
 }
 
 BackgroundMI& BackgroundMI::operator+=(float const delta) {
@@ -176,32 +323,10 @@ BackgroundMI& BackgroundMI::operator-=(float const delta) {
     return *this;
 }
 
-template <typename PixelT>
-std::shared_ptr<image::Image<PixelT>> BackgroundMI::doGetImage(
-        lsst::geom::Box2I const& bbox,
-        Interpolate::Style const interpStyle_,   // Style of the interpolation
-        UndersampleStyle const undersampleStyle  // Behaviour if there are too few points
-        ) const {
-    if (!_imgBBox.contains(bbox)) {
-        throw LSST_EXCEPT(
-                ex::LengthError,
-                str(boost::format("BBox (%d:%d,%d:%d) out of range (%d:%d,%d:%d)") % bbox.getMinX() %
-                    bbox.getMaxX() % bbox.getMinY() % bbox.getMaxY() % _imgBBox.getMinX() %
-                    _imgBBox.getMaxX() % _imgBBox.getMinY() % _imgBBox.getMaxY()));
-    }
+Interpolate::Style BackgroundMI::_checkInterpStyle(Interpolate::Style const interpStyle,
+                                                   UndersampleStyle const undersampleStyle) const {
     int const nxSample = _statsImage.getWidth();
     int const nySample = _statsImage.getHeight();
-    Interpolate::Style interpStyle = interpStyle_;  // not const -- may be modified if REDUCE_INTERP_ORDER
-
-    /*
-     * Save the as-used interpStyle and undersampleStyle.
-     *
-     * N.b. The undersampleStyle may actually be overridden for some columns of the statsImage if they
-     * have too few good values.  This doesn't prevent you reproducing the results of getImage() by
-     * calling getImage(getInterpStyle(), getUndersampleStyle())
-     */
-    _asUsedInterpStyle = interpStyle;
-    _asUsedUndersampleStyle = undersampleStyle;
     /*
      * Check if the requested nx,ny are sufficient for the requested interpolation style,
      * making suitable adjustments
@@ -227,8 +352,7 @@ std::shared_ptr<image::Image<PixelT>> BackgroundMI::doGetImage(
             if (isXundersampled || isYundersampled) {
                 Interpolate::Style const xStyle = lookupMaxInterpStyle(nxSample);
                 Interpolate::Style const yStyle = lookupMaxInterpStyle(nySample);
-                interpStyle = (nxSample < nySample) ? xStyle : yStyle;
-                _asUsedInterpStyle = interpStyle;
+                return (nxSample < nySample) ? xStyle : yStyle;
             }
             break;
         case INCREASE_NXNYSAMPLE:
@@ -244,99 +368,239 @@ std::shared_ptr<image::Image<PixelT>> BackgroundMI::doGetImage(
                                                 "UndersampleStyle %d is not defined.") %
                                   undersampleStyle));
     }
+    return interpStyle;
+}
 
-    // if we're approximating, don't bother with the rest of the interp-related work.  Return from here.
-    if (_bctrl->getApproximateControl()->getStyle() != ApproximateControl::UNKNOWN) {
-        return doGetApproximate<PixelT>(*_bctrl->getApproximateControl(), _asUsedUndersampleStyle)
-                ->getImage();
-    }
-
-    // =============================================================
-    // --> We'll store nxSample fully-interpolated columns to interpolate the rows over
+void BackgroundMI::_setAllGridColumns(Interpolate::Style const interpStyle,
+                                      UndersampleStyle const undersampleStyle) const {
     // make a vector containing the y pixel coords for the column
-    int const width = _imgBBox.getWidth();
     int const height = _imgBBox.getHeight();
-    auto const bboxOff = bbox.getMin() - _imgBBox.getMin();
-
     std::vector<int> ypix(height);
     for (int iY = 0; iY < height; ++iY) {
         ypix[iY] = iY;
     }
 
-    _gridColumns.resize(width);
+    // Only columns of the statsImage that were changed (by update(), arithmetic, or by writing to
+    // getStatsImage()) since they were last interpolated with these styles need interpolating again
+    int const nxSample = _statsImage.getWidth();
+    bool const sameStyles = !_gridColumnInputs.empty() && interpStyle == _gridColumnsInterpStyle &&
+                            undersampleStyle == _gridColumnsUndersampleStyle;
+    auto const isSame = [](InternalPixelT a, InternalPixelT b) {
+        return a == b || (std::isnan(a) && std::isnan(b));
+    };
+    image::MaskedImage<InternalPixelT>::Image const& im = *_statsImage.getImage();
+    std::vector<std::vector<InternalPixelT>> inputs(nxSample);
+    std::vector<int> stale;
     for (int iX = 0; iX < nxSample; ++iX) {
-        _setGridColumns(interpStyle, undersampleStyle, iX, ypix);
+        inputs[iX].assign(im.col_begin(iX), im.col_end(iX));
+        if (!sameStyles || !std::equal(inputs[iX].begin(), inputs[iX].end(), _gridColumnInputs[iX].begin(),
+                                       _gridColumnInputs[iX].end(), isSame)) {
+            stale.push_back(iX);
+        }
     }
+    if (stale.empty()) {
+        return;
+    }
+
+    // The columns are interpolated independently of each other.  Forget the old inputs first, so a
+    // failure leaves every column to be interpolated again
+    _gridColumnInputs.clear();
+    _gridColumns.resize(_imgBBox.getWidth());
+    detail::parallelFor(stale.size(), _bctrl->getNumThreads(), [&](int i) {
+        _setGridColumns(interpStyle, undersampleStyle, stale[i], ypix);
+    });
+    _gridColumnInputs = std::move(inputs);
+    _gridColumnsInterpStyle = interpStyle;
+    _gridColumnsUndersampleStyle = undersampleStyle;
+}
+
+template <typename PixelT>
+std::shared_ptr<image::Image<PixelT>> BackgroundMI::doGetImage(
+        lsst::geom::Box2I const& bbox,
+        Interpolate::Style const interpStyle_,   // Style of the interpolation
+        UndersampleStyle const undersampleStyle  // Behaviour if there are too few points
+        ) const {
+    if (!_imgBBox.contains(bbox)) {
+        throw LSST_EXCEPT(
+                ex::LengthError,
+                str(boost::format("BBox (%d:%d,%d:%d) out of range (%d:%d,%d:%d)") % bbox.getMinX() %
+                    bbox.getMaxX() % bbox.getMinY() % bbox.getMaxY() % _imgBBox.getMinX() %
+                    _imgBBox.getMaxX() % _imgBBox.getMinY() % _imgBBox.getMaxY()));
+    }
+
+    /*
+     * Save the as-used interpStyle and undersampleStyle.
+     *
+     * N.b. The undersampleStyle may actually be overridden for some columns of the statsImage if they
+     * have too few good values.  This doesn't prevent you reproducing the results of getImage() by
+     * calling getImage(getInterpStyle(), getUndersampleStyle())
+     */
+    _asUsedInterpStyle = interpStyle_;
+    _asUsedUndersampleStyle = undersampleStyle;
+    Interpolate::Style const interpStyle = _checkInterpStyle(interpStyle_, undersampleStyle);
+    _asUsedInterpStyle = interpStyle;
+
+    // if we're approximating, don't bother with the rest of the interp-related work.  Return from here.
+    if (_bctrl->getApproximateControl()->getStyle() != ApproximateControl::UNKNOWN) {
+        return doGetApproximate<PixelT>(*_bctrl->getApproximateControl(), _asUsedUndersampleStyle)
+                ->getImage();
+    }
+
+    // =============================================================
+    // --> We'll store nxSample fully-interpolated columns to interpolate the rows over
+    _setAllGridColumns(interpStyle, undersampleStyle);
 
     // create a shared_ptr to put the background image in and return to caller
     // start with xy0 = 0 and set final xy0 later
-    std::shared_ptr<image::Image<PixelT>> bg =
-            std::shared_ptr<image::Image<PixelT>>(new image::Image<PixelT>(bbox.getDimensions()));
+    auto bg = std::make_shared<image::Image<PixelT>>(bbox.getDimensions(), image::UNINITIALIZED);
 
-    // go through row by row
-    // - interpolate on the gridcolumns that were pre-computed by the constructor
-    // - copy the values to an ImageT to return to the caller.
-    std::vector<double> xcenTmp, bgTmp;
+    // go through the rows in bands, one band per thread, interpolating on the gridcolumns
+    int const nThreads = detail::resolveNumThreads(_bctrl->getNumThreads());
+    auto const bboxOff = bbox.getMin() - _imgBBox.getMin();
+    auto const bands = detail::splitRange(0, bbox.getHeight(), nThreads);
+    int const nBands = bands.size();
+    detail::parallelFor(nBands, nThreads, [&](int iBand) {
+        interpolateRows(_gridColumns, _xcen, interpStyle, undersampleStyle, bboxOff, bands[iBand].first,
+                        bands[iBand].second, *bg);
+    });
+    bg->setXY0(bbox.getMin());
 
-    // N.b. There's no API to set defaultValue to other than NaN (due to issues with persistence
-    // that I don't feel like fixing;  #2825).  If we want to address this, this is the place
-    // to start, but note that NaN is treated specially -- it means, "Interpolate" so to allow
-    // us to put a NaN into the outputs some changes will be needed
-    double defaultValue = std::numeric_limits<double>::quiet_NaN();
+    return bg;
+}
 
-    for (int y = 0, iY = bboxOff.getY(); y < bbox.getHeight(); ++y, ++iY) {
-        // build an interp object for this row
-        std::vector<double> bg_x(nxSample);
-        for (int iX = 0; iX < nxSample; iX++) {
-            bg_x[iX] = static_cast<double>(_gridColumns[iX][iY]);
-        }
-        cullNan(_xcen, bg_x, xcenTmp, bgTmp, defaultValue);
+BackgroundImageView::BackgroundImageView(std::shared_ptr<BackgroundMI const> background)
+        : BackgroundImageView(background, background->getBackgroundControl()->getInterpStyle(),
+                              background->getBackgroundControl()->getUndersampleStyle()) {}
+
+BackgroundImageView::BackgroundImageView(std::shared_ptr<BackgroundMI const> background,
+                                         Interpolate::Style const interpStyle,
+                                         UndersampleStyle const undersampleStyle)
+        : _bbox(background->getImageBBox()),
+          _interpStyle(background->_checkInterpStyle(interpStyle, undersampleStyle)),
+          _undersampleStyle(undersampleStyle),
+          _numThreads(background->getBackgroundControl()->getNumThreads()),
+          _xcen(background->_xcen) {
+    auto const actrl = background->getBackgroundControl()->getApproximateControl();
+    if (actrl->getStyle() != ApproximateControl::UNKNOWN) {
+        _approx = background->getApproximate(*actrl, undersampleStyle);
+    } else {
+        // interpolate the grid columns to every row once; each row of the image is then a cheap
+        // interpolation in x
+        background->_setAllGridColumns(_interpStyle, _undersampleStyle);
+        _gridColumns = background->_gridColumns;
+    }
+}
 
-        std::shared_ptr<Interpolate> intobj;
-        try {
-            intobj = makeInterpolate(xcenTmp, bgTmp, interpStyle);
-        } catch (pex::exceptions::OutOfRangeError& e) {
-            switch (undersampleStyle) {
-                case THROW_EXCEPTION:
-                    LSST_EXCEPT_ADD(e, str(boost::format("Interpolating in y (iY = %d)") % iY));
-                    throw;
-                case REDUCE_INTERP_ORDER: {
-                    if (bgTmp.empty()) {
-                        xcenTmp.push_back(0);
-                        bgTmp.push_back(defaultValue);
+std::shared_ptr<image::Image<BackgroundImageView::InternalPixelT>> BackgroundImageView::evaluate(
+        lsst::geom::Box2I const& bbox) const {
+    if (!_bbox.contains(bbox)) {
+        throw LSST_EXCEPT(
+                ex::LengthError,
+                str(boost::format("BBox (%d:%d,%d:%d) out of range (%d:%d,%d:%d)") % bbox.getMinX() %
+                    bbox.getMaxX() % bbox.getMinY() % bbox.getMaxY() % _bbox.getMinX() % _bbox.getMaxX() %
+                    _bbox.getMinY() % _bbox.getMaxY()));
+    }
+    auto const bboxOff = bbox.getMin() - _bbox.getMin();
 
-                        intobj = makeInterpolate(xcenTmp, bgTmp, Interpolate::CONSTANT);
-                        break;
-                    } else {
-                        intobj = makeInterpolate(xcenTmp, bgTmp, lookupMaxInterpStyle(bgTmp.size()));
-                    }
-                } break;
-                case INCREASE_NXNYSAMPLE:
-                    LSST_EXCEPT_ADD(
-                            e,
-                            "The BackgroundControl UndersampleStyle INCREASE_NXNYSAMPLE is not supported.");
-                    throw;
-                default:
-                    LSST_EXCEPT_ADD(e, str(boost::format("The selected BackgroundControl "
-                                                         "UndersampleStyle %d is not defined.") %
-                                           undersampleStyle));
-                    throw;
-            }
-        } catch (ex::Exception& e) {
-            LSST_EXCEPT_ADD(e, str(boost::format("Interpolating in y (iY = %d)") % iY));
-            throw;
-        }
+    std::shared_ptr<image::Image<InternalPixelT>> bg;
+    if (_approx) {
+        // the approximation is defined on the image's LOCAL coordinates
+        bg = _approx->getImage(lsst::geom::Box2I(lsst::geom::Point2I(bboxOff), bbox.getDimensions()));
+    } else {
+        bg = std::make_shared<image::Image<InternalPixelT>>(bbox.getDimensions(), image::UNINITIALIZED);
+        interpolateRows(_gridColumns, _xcen, _interpStyle, _undersampleStyle, bboxOff, 0, bbox.getHeight(),
+                        *bg);
+    }
+    bg->setXY0(bbox.getMin());
+    return bg;
+}
 
-        // fill the image with interpolated values
-        for (int iX = bboxOff.getX(), x = 0; x < bbox.getWidth(); ++iX, ++x) {
-            (*bg)(x, y) = static_cast<PixelT>(intobj->interpolate(iX));
+template <typename PixelT>
+void BackgroundImageView::subtractFrom(image::Image<PixelT>& img) const {
+    if (!_bbox.contains(img.getBBox())) {
+        throw LSST_EXCEPT(ex::LengthError,
+                          str(boost::format("Image bbox %s does not lie within background bbox %s") %
+                              img.getBBox() % _bbox));
+    }
+    // Evaluate and subtract the background a strip at a time, so that only a strip's worth of
+    // background is ever in memory per thread
+    int const nStrips = (img.getHeight() + BACKGROUND_STRIP_HEIGHT - 1) / BACKGROUND_STRIP_HEIGHT;
+    detail::parallelFor(nStrips, _numThreads, [this, &img](int iStrip) {
+        int const y0 = iStrip * BACKGROUND_STRIP_HEIGHT;
+        int const height = std::min(BACKGROUND_STRIP_HEIGHT, img.getHeight() - y0);
+        lsst::geom::Box2I const stripBox(img.getBBox().getMin() + lsst::geom::Extent2I(0, y0),
+                                         lsst::geom::Extent2I(img.getWidth(), height));
+        image::Image<PixelT> strip(img, stripBox, image::PARENT, false);
+        strip -= *evaluate(stripBox);
+    });
+}
+
+template <typename PixelT>
+void BackgroundImageView::subtractFrom(image::MaskedImage<PixelT>& mimg) const {
+    subtractFrom(*mimg.getImage());
+}
+
+BackgroundListView::BackgroundListView(std::vector<BackgroundImageView> components)
+        : _components(std::move(components)) {
+    if (_components.empty()) {
+        throw LSST_EXCEPT(ex::InvalidParameterError, "There must be at least one background to sum");
+    }
+    for (auto const& component : _components) {
+        if (component.getBBox() != getBBox()) {
+            throw LSST_EXCEPT(ex::LengthError,
+                              str(boost::format("Background bbox %s differs from that of the first, %s") %
+                                  component.getBBox() % getBBox()));
         }
     }
-    bg->setXY0(bbox.getMin());
+}
 
+template <typename Func>
+void BackgroundListView::_forEachStrip(lsst::geom::Box2I const& bbox, Func func) const {
+    if (!getBBox().contains(bbox)) {
+        throw LSST_EXCEPT(ex::LengthError,
+                          str(boost::format("BBox %s does not lie within background bbox %s") % bbox %
+                              getBBox()));
+    }
+    // every component is evaluated over the same strip and summed there, so only a strip's worth of
+    // background is ever in memory per thread
+    int const nStrips = (bbox.getHeight() + BACKGROUND_STRIP_HEIGHT - 1) / BACKGROUND_STRIP_HEIGHT;
+    detail::parallelFor(nStrips, _components.front().getNumThreads(), [this, &bbox, &func](int iStrip) {
+        int const y0 = iStrip * BACKGROUND_STRIP_HEIGHT;
+        int const height = std::min(BACKGROUND_STRIP_HEIGHT, bbox.getHeight() - y0);
+        lsst::geom::Box2I const stripBox(bbox.getMin() + lsst::geom::Extent2I(0, y0),
+                                         lsst::geom::Extent2I(bbox.getWidth(), height));
+        auto const sum = _components.front().evaluate(stripBox);
+        for (std::size_t i = 1; i < _components.size(); ++i) {
+            *sum += *_components[i].evaluate(stripBox);
+        }
+        func(stripBox, *sum);
+    });
+}
+
+std::shared_ptr<image::Image<BackgroundListView::InternalPixelT>> BackgroundListView::evaluate(
+        lsst::geom::Box2I const& bbox) const {
+    auto bg = std::make_shared<image::Image<InternalPixelT>>(bbox, image::UNINITIALIZED);
+    _forEachStrip(bbox, [&bg](lsst::geom::Box2I const& stripBox, image::Image<InternalPixelT> const& sum) {
+        image::Image<InternalPixelT> strip(*bg, stripBox, image::PARENT, false);
+        strip.assign(sum);
+    });
     return bg;
 }
 
+template <typename PixelT>
+void BackgroundListView::subtractFrom(image::Image<PixelT>& img) const {
+    _forEachStrip(img.getBBox(),
+                  [&img](lsst::geom::Box2I const& stripBox, image::Image<InternalPixelT> const& sum) {
+                      image::Image<PixelT> strip(img, stripBox, image::PARENT, false);
+                      strip -= sum;
+                  });
+}
+
+template <typename PixelT>
+void BackgroundListView::subtractFrom(image::MaskedImage<PixelT>& mimg) const {
+    subtractFrom(*mimg.getImage());
+}
+
 template <typename PixelT>
 std::shared_ptr<Approximate<PixelT>> BackgroundMI::doGetApproximate(
         ApproximateControl const& actrl,        /* Approximation style */
@@ -355,6 +619,11 @@ std::shared_ptr<Approximate<PixelT>> BackgroundMI::doGetApproximate(
     template BackgroundMI::BackgroundMI(image::Image<TYPE> const& img, BackgroundControl const& bgCtrl); \
     template BackgroundMI::BackgroundMI(image::MaskedImage<TYPE> const& img,                             \
                                         BackgroundControl const& bgCtrl);                                \
+    template void BackgroundMI::update(image::Image<TYPE> const&, lsst::geom::Box2I const&);             \
+    template void BackgroundMI::update(image::MaskedImage<TYPE> const&, lsst::geom::Box2I const&);       \
+    template void BackgroundMI::update(image::Image<TYPE> const&, ndarray::Array<bool const, 2, 1> const&); \
+    template void BackgroundMI::update(image::MaskedImage<TYPE> const&,                                  \
+                                       ndarray::Array<bool const, 2, 1> const&);                         \
     std::shared_ptr<image::Image<TYPE>> BackgroundMI::_getImage(                                         \
             lsst::geom::Box2I const& bbox,                                                               \
             Interpolate::Style const interpStyle,    /* Style of the interpolation */                    \
@@ -376,6 +645,15 @@ std::shared_ptr<Approximate<PixelT>> BackgroundMI::doGetApproximate(
 BOOST_PP_SEQ_FOR_EACH(CREATE_BACKGROUND, , LSST_makeBackground_getImage_types)
 BOOST_PP_SEQ_FOR_EACH(CREATE_getApproximate, , LSST_makeBackground_getApproximate_types)
 
+#define INSTANTIATE_SUBTRACT_FROM(TYPE)                                                    \
+    template void BackgroundImageView::subtractFrom(image::Image<TYPE>& img) const;        \
+    template void BackgroundImageView::subtractFrom(image::MaskedImage<TYPE>& mimg) const; \
+    template void BackgroundListView::subtractFrom(image::Image<TYPE>& img) const;         \
+    template void BackgroundListView::subtractFrom(image::MaskedImage<TYPE>& mimg) const
+
+INSTANTIATE_SUBTRACT_FROM(float);
+INSTANTIATE_SUBTRACT_FROM(double);
+
 /// @endcond
 }  // namespace math
 }  // namespace afw
@@ -22,7 +22,12 @@
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
 #include <numeric>
+#include <vector>
 
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/math/BoundedField.h"
@@ -46,6 +51,19 @@ ndarray::Array<double, 1, 1> BoundedField::evaluate(ndarray::Array<double const,
     return out;
 }
 
+ndarray::Array<double, 2, 2> BoundedField::evaluateGrid(ndarray::Array<double const, 1> const &x,
+                                                        ndarray::Array<double const, 1> const &y) const {
+    int const nx = x.getSize<0>();
+    int const ny = y.getSize<0>();
+    ndarray::Array<double, 2, 2> out = ndarray::allocate(ny, nx);
+    ndarray::Array<double, 1, 1> yy = ndarray::allocate(nx);
+    for (int i = 0; i < ny; ++i) {
+        yy.deep() = y[i];
+        out[i] = evaluate(x, yy);
+    }
+    return out;
+}
+
 double BoundedField::integrate() const { throw LSST_EXCEPT(pex::exceptions::LogicError, "Not Implemented"); }
 
 double BoundedField::mean() const { throw LSST_EXCEPT(pex::exceptions::LogicError, "Not Implemented"); }
@@ -90,39 +108,47 @@ struct Divide {
     }
 };
 
-// Helper class to do bilinear interpolation with no dynamic memory
-// allocation. This means we evaluate the function multiple times at some
-// points (when we move to a new interval in y, to be specific). Could
-// probably be optimized for the cases where either step is 1, but that seems
-// premature.
+// Number of rows of an image for which BoundedField::evaluateGrid is called at once; large enough for
+// separable fields to be efficient, small enough not to need much memory
+int const GRID_BAND_HEIGHT = 64;
+
+// Return the positions, min, min + step, ..., at which a field is evaluated in order to interpolate it
+// over [min, end).  The last position is always end - 1, even if that duplicates the one before.
+std::vector<int> makeKnots(int min, int end, int step) {
+    std::vector<int> knots = {min};
+    for (int knot = min + step; knot < end; knot += step) {
+        knots.push_back(knot);
+    }
+    knots.push_back(end - 1);
+    return knots;
+}
+
+ndarray::Array<double, 1, 1> toPositions(std::vector<int> const &knots) {
+    ndarray::Array<double, 1, 1> positions = ndarray::allocate(knots.size());
+    std::copy(knots.begin(), knots.end(), positions.begin());
+    return positions;
+}
+
+// Helper class to do bilinear interpolation of a BoundedField evaluated on an evenly-spaced grid.
+// The field is evaluated at all the grid points at once with BoundedField::evaluateGrid, so fields
+// with a fast grid evaluation benefit here too.
 class Interpolator {
 public:
     // Description of a cell to interpolate in one dimension.
     struct Bounds {
-        int const step;  // step between min and max, except in the special last row/column
         int min;  // lower-bound of cell (coordinate of known value and one before first point to fill in)
         int max;  // upper-bound of cell (coordinate of known value)
         int end;  // upper-bound of cell (one after last point to fill in)
-
-        // Construct from step only.
-        //
-        // Other variables are initialized (and re-initialized) by calls to reset().
-        explicit Bounds(int step_) : step(step_), min(0), max(0), end(0) {}
-
-        // Reset all points (aside from the step) to the first cell in this dimension.
-        void reset(int min_) {
-            min = min_;
-            max = min_ + step;
-            end = min_ + step;
-        }
     };
 
     // Construct an object to interpolate the given BoundedField on an evenly-spaced grid within a region.
     Interpolator(BoundedField const *field, lsst::geom::Box2I const *region, int xStep, int yStep)
-            : _field(field),
-              _region(region),
-              _x(xStep),
-              _y(yStep),
+            : _region(region),
+              _xKnots(makeKnots(region->getBeginX(), region->getEndX(), xStep)),
+              _yKnots(makeKnots(region->getBeginY(), region->getEndY(), yStep)),
+              _grid(field->evaluateGrid(toPositions(_xKnots), toPositions(_yKnots))),
+              _x{0, 0, 0},
+              _y{0, 0, 0},
               _z00(std::numeric_limits<double>::quiet_NaN()),
               _z01(std::numeric_limits<double>::quiet_NaN()),
               _z10(std::numeric_limits<double>::quiet_NaN()),
@@ -134,42 +160,28 @@ public:
     // to iterate over cells in x.
     template <typename T, typename F>
     void run(image::Image<T> &img, F functor) {
-        _y.reset(_region->getBeginY());
-        while (_y.end < _region->getEndY()) {
-            _runRow(img, functor);
-            _y.min = _y.max;
-            _y.max += _y.step;
-            _y.end = _y.max;
-        }
-        {  // special-case last iteration in y
-            _y.max = _region->getMaxY();
-            _y.end = _region->getEndY();
-            _runRow(img, functor);
+        int const ny = _yKnots.size();
+        for (int iy = 0; iy + 1 < ny; ++iy) {
+            _y.min = _yKnots[iy];
+            _y.max = _yKnots[iy + 1];
+            _y.end = (iy + 2 == ny) ? _region->getEndY() : _y.max;  // the last row includes its max
+            _runRow(img, functor, iy);
         }
     }
 
 private:
     // Process a row of cells, calling _runCell() on each one.
     template <typename T, typename F>
-    void _runRow(image::Image<T> &img, F functor) {
-        _x.reset(_region->getBeginX());
-        _z00 = _field->evaluate(_x.min, _y.min);
-        _z01 = _field->evaluate(_x.min, _y.max);
-        while (_x.max < _region->getEndX()) {
-            _z10 = _field->evaluate(_x.max, _y.min);
-            _z11 = _field->evaluate(_x.max, _y.max);
-            _runCell(img, functor);
-            _x.min = _x.max;
-            _x.max += _x.step;
-            _x.end = _x.max;
-            _z00 = _z10;
-            _z01 = _z11;
-        }
-        {  // special-case last iteration in x
-            _x.max = _region->getMaxX();
-            _x.end = _region->getEndX();
-            _z10 = _field->evaluate(_x.max, _y.min);
-            _z11 = _field->evaluate(_x.max, _y.max);
+    void _runRow(image::Image<T> &img, F functor, int iy) {
+        int const nx = _xKnots.size();
+        for (int ix = 0; ix + 1 < nx; ++ix) {
+            _x.min = _xKnots[ix];
+            _x.max = _xKnots[ix + 1];
+            _x.end = (ix + 2 == nx) ? _region->getEndX() : _x.max;  // the last column includes its max
+            _z00 = _grid[iy][ix];
+            _z01 = _grid[iy + 1][ix];
+            _z10 = _grid[iy][ix + 1];
+            _z11 = _grid[iy + 1][ix + 1];
             _runCell(img, functor);
         }
     }
@@ -211,16 +223,18 @@ private:
         }
     }
 
-    BoundedField const *_field;
     lsst::geom::Box2I const *_region;
+    std::vector<int> const _xKnots;
+    std::vector<int> const _yKnots;
+    ndarray::Array<double const, 2, 2> const _grid;  // values at (_xKnots[j], _yKnots[i])
     Bounds _x;
     Bounds _y;
     double _z00, _z01, _z10, _z11;
 };
 
-template <typename T, typename F>
-void applyToImage(BoundedField const &field, image::Image<T> &img, F functor, bool overlapOnly, int xStep,
-                  int yStep) {
+// Return the region of an image to be modified by a field
+template <typename T>
+lsst::geom::Box2I getRegion(BoundedField const &field, image::Image<T> const &img, bool overlapOnly) {
     lsst::geom::Box2I region(field.getBBox());
     if (overlapOnly) {
         region.clip(img.getBBox(image::PARENT));
@@ -228,27 +242,229 @@ void applyToImage(BoundedField const &field, image::Image<T> &img, F functor, bo
         throw LSST_EXCEPT(pex::exceptions::RuntimeError,
                           "Image bounding box does not match field bounding box");
     }
+    return region;
+}
+
+template <typename T, typename F>
+void applyToImage(BoundedField const &field, image::Image<T> &img, F functor, bool overlapOnly, int xStep,
+                  int yStep) {
+    lsst::geom::Box2I const region = getRegion(field, img, overlapOnly);
+    if (region.isEmpty()) {
+        return;
+    }
 
     if (yStep > 1 || xStep > 1) {
         Interpolator interpolator(&field, &region, xStep, yStep);
         interpolator.run(img, functor);
     } else {
-        // We iterate over rows as a significant optimization for AST-backed bounded fields
-        // (it's also slightly faster for other bounded fields, too).
+        // We evaluate whole bands of rows at once as a significant optimization for AST-backed
+        // and separable bounded fields (it's also slightly faster for other bounded fields, too).
         auto subImage = img.subset(region);
-        auto size = region.getWidth();
-        ndarray::Array<double, 1> xx = ndarray::allocate(ndarray::makeVector(size));
-        ndarray::Array<double, 1> yy = ndarray::allocate(ndarray::makeVector(size));
-        // y gets incremented each outer loop, x is always xMin->xMax
+        ndarray::Array<double, 1, 1> xx = ndarray::allocate(region.getWidth());
+        // x is always xMin->xMax; don't need indexToPosition, as we're already working in the right box
         std::iota(xx.begin(), xx.end(), region.getBeginX());
         auto outRowIter = subImage.getArray().begin();
-        for (int y = region.getBeginY(); y < region.getEndY(); ++y, ++outRowIter) {
-            yy.deep() = y;  // don't need indexToPosition, as we're already working in the right box (region).
-            functor(*outRowIter, field.evaluate(xx, yy));
+        for (int y0 = region.getBeginY(); y0 < region.getEndY(); y0 += GRID_BAND_HEIGHT) {
+            int const nRows = std::min(GRID_BAND_HEIGHT, region.getEndY() - y0);
+            ndarray::Array<double, 1, 1> yy = ndarray::allocate(nRows);
+            std::iota(yy.begin(), yy.end(), y0);
+            ndarray::Array<double, 2, 2> const values = field.evaluateGrid(xx, yy);
+            for (int i = 0; i < nRows; ++i, ++outRowIter) {
+                functor(*outRowIter, values[i]);
+            }
         }
     }
 }
 
+// The smallest grid spacing, in pixels, from which applyInterpolatedToImage interpolates; finer grids
+// would hardly be cheaper than evaluating the field at every pixel
+double const MIN_CUBIC_SPACING = 4.0;
+
+// Evenly-spaced knots from min to max, inclusive, on one axis
+struct CubicAxis {
+    CubicAxis(double min_, double max_, int nIntervals)
+            : min(min_), max(max_), spacing((max_ - min_) / nIntervals), nKnots(nIntervals + 1) {}
+
+    ndarray::Array<double, 1, 1> getPositions() const {
+        ndarray::Array<double, 1, 1> positions = ndarray::allocate(nKnots);
+        for (int i = 0; i < nKnots; ++i) {
+            positions[i] = min + i * spacing;
+        }
+        positions[nKnots - 1] = max;
+        return positions;
+    }
+
+    double min;
+    double max;
+    double spacing;
+    int nKnots;
+};
+
+// The Catmull-Rom weights of the four knots around a coordinate; index is that of the first of them in a
+// padded grid (see padGrid), whose knot i is knot i - 1 of the unpadded one
+struct CubicWeights {
+    int index;
+    double w[4];
+};
+
+template <typename Iterator>
+std::vector<CubicWeights> makeCubicWeights(CubicAxis const &axis, Iterator begin, Iterator end) {
+    std::vector<CubicWeights> result;
+    result.reserve(end - begin);
+    for (Iterator iter = begin; iter != end; ++iter) {
+        double const s = (*iter - axis.min) / axis.spacing;
+        int const i = std::max(0, std::min(static_cast<int>(std::floor(s)), axis.nKnots - 2));
+        double const t = s - i;
+        double const t2 = t * t;
+        double const t3 = t2 * t;
+        result.push_back(CubicWeights{i,
+                                      {0.5 * (-t3 + 2.0 * t2 - t), 0.5 * (3.0 * t3 - 5.0 * t2 + 2.0),
+                                       0.5 * (-3.0 * t3 + 4.0 * t2 + t), 0.5 * (t3 - t2)}});
+    }
+    return result;
+}
+
+// Return a grid of values (at least 3x3) with an extra knot on each side, extrapolated quadratically so
+// that interpolation near the edges is as accurate as in the interior; row-major, nx + 2 wide
+std::vector<double> padGrid(ndarray::Array<double const, 2, 2> const &grid) {
+    int const ny = grid.getSize<0>();
+    int const nx = grid.getSize<1>();
+    int const width = nx + 2;
+    std::vector<double> padded((ny + 2) * width);
+    for (int i = 0; i < ny; ++i) {
+        double *row = &padded[(i + 1) * width];
+        std::copy(grid[i].begin(), grid[i].end(), row + 1);
+        row[0] = 3.0 * (row[1] - row[2]) + row[3];
+        row[nx + 1] = 3.0 * (row[nx] - row[nx - 1]) + row[nx - 2];
+    }
+    for (int j = 0; j < width; ++j) {
+        double *column = &padded[j];
+        column[0] = 3.0 * (column[width] - column[2 * width]) + column[3 * width];
+        column[(ny + 1) * width] =
+                3.0 * (column[ny * width] - column[(ny - 1) * width]) + column[(ny - 2) * width];
+    }
+    return padded;
+}
+
+// Interpolate a padded grid at every combination of the given coordinates, calling rowFunc(k, values)
+// with the values at all the x coordinates for y coordinate k
+template <typename F>
+void interpolateCubic(std::vector<double> const &padded, int width, std::vector<CubicWeights> const &xWeights,
+                      std::vector<CubicWeights> const &yWeights, F rowFunc) {
+    std::vector<double> knotRow(width);  // the padded grid interpolated to one y
+    std::vector<double> values(xWeights.size());
+    for (std::size_t k = 0; k < yWeights.size(); ++k) {
+        CubicWeights const &wy = yWeights[k];
+        double const *p = &padded[wy.index * width];
+        for (int j = 0; j < width; ++j, ++p) {
+            knotRow[j] =
+                    wy.w[0] * p[0] + wy.w[1] * p[width] + wy.w[2] * p[2 * width] + wy.w[3] * p[3 * width];
+        }
+        for (std::size_t i = 0; i < xWeights.size(); ++i) {
+            CubicWeights const &wx = xWeights[i];
+            double const *q = &knotRow[wx.index];
+            values[i] = wx.w[0] * q[0] + wx.w[1] * q[1] + wx.w[2] * q[2] + wx.w[3] * q[3];
+        }
+        rowFunc(k, values);
+    }
+}
+
+// A padded grid of field values from which the field can be interpolated to within a tolerance
+struct CubicGrid {
+    CubicAxis x;
+    CubicAxis y;
+    std::vector<double> padded;
+};
+
+// Return a grid from which a field can be interpolated over a region to within a relative tolerance, or
+// null if no grid with spacing of at least MIN_CUBIC_SPACING will do
+std::unique_ptr<CubicGrid> makeCubicGrid(BoundedField const &field, lsst::geom::Box2I const &region,
+                                         double tolerance) {
+    double const xMin = region.getMinX();
+    double const xMax = region.getMaxX();
+    double const yMin = region.getMinY();
+    double const yMax = region.getMaxY();
+    // start with two cells along the shorter side, and roughly square cells
+    double const shortSide = std::min(xMax - xMin, yMax - yMin);
+    if (shortSide < 4 * MIN_CUBIC_SPACING) {
+        return nullptr;
+    }
+    int nx = std::max(2, static_cast<int>(std::lround(2.0 * (xMax - xMin) / shortSide)));
+    int ny = std::max(2, static_cast<int>(std::lround(2.0 * (yMax - yMin) / shortSide)));
+    CubicAxis xCoarse(xMin, xMax, nx);
+    CubicAxis yCoarse(yMin, yMax, ny);
+    std::vector<double> coarse = padGrid(field.evaluateGrid(xCoarse.getPositions(), yCoarse.getPositions()));
+    while (true) {
+        CubicAxis const xFine(xMin, xMax, 2 * nx);
+        CubicAxis const yFine(yMin, yMax, 2 * ny);
+        if (std::min(xFine.spacing, yFine.spacing) < MIN_CUBIC_SPACING) {
+            return nullptr;
+        }
+        auto const xPositions = xFine.getPositions();
+        auto const yPositions = yFine.getPositions();
+        ndarray::Array<double, 2, 2> const fine = field.evaluateGrid(xPositions, yPositions);
+        double maxValue = 0.0;
+        for (auto const &row : fine) {
+            for (double value : row) {
+                if (!std::isfinite(value)) {
+                    return nullptr;
+                }
+                maxValue = std::max(maxValue, std::abs(value));
+            }
+        }
+        double maxError = 0.0;
+        interpolateCubic(coarse, xCoarse.nKnots + 2,
+                         makeCubicWeights(xCoarse, xPositions.begin(), xPositions.end()),
+                         makeCubicWeights(yCoarse, yPositions.begin(), yPositions.end()),
+                         [&](std::size_t k, std::vector<double> const &values) {
+                             for (std::size_t i = 0; i < values.size(); ++i) {
+                                 maxError = std::max(maxError, std::abs(values[i] - fine[k][i]));
+                             }
+                         });
+        if (maxError <= tolerance * maxValue) {
+            return std::unique_ptr<CubicGrid>(new CubicGrid{xFine, yFine, padGrid(fine)});
+        }
+        nx *= 2;
+        ny *= 2;
+        xCoarse = xFine;
+        yCoarse = yFine;
+        coarse = padGrid(fine);
+    }
+}
+
+template <typename T, typename F>
+void applyInterpolatedToImage(BoundedField const &field, image::Image<T> &img, F functor, bool overlapOnly,
+                              double tolerance) {
+    if (!(tolerance >= 0.0)) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "Interpolation tolerance must be non-negative");
+    }
+    lsst::geom::Box2I const region = getRegion(field, img, overlapOnly);
+    if (region.isEmpty()) {
+        return;
+    }
+    std::unique_ptr<CubicGrid> const grid =
+            tolerance > 0.0 ? makeCubicGrid(field, region, tolerance) : nullptr;
+    if (!grid) {
+        applyToImage(field, img, functor, overlapOnly, 1, 1);
+        return;
+    }
+    std::vector<double> xx(region.getWidth());
+    std::vector<double> yy(region.getHeight());
+    std::iota(xx.begin(), xx.end(), region.getBeginX());
+    std::iota(yy.begin(), yy.end(), region.getBeginY());
+    interpolateCubic(grid->padded, grid->x.nKnots + 2, makeCubicWeights(grid->x, xx.begin(), xx.end()),
+                     makeCubicWeights(grid->y, yy.begin(), yy.end()),
+                     [&](std::size_t k, std::vector<double> const &values) {
+                         auto rowIter = img.x_at(region.getBeginX() - img.getX0(),
+                                                 region.getBeginY() + static_cast<int>(k) - img.getY0());
+                         for (double value : values) {
+                             functor(*rowIter, value);
+                             ++rowIter;
+                         }
+                     });
+}
+
 }  // namespace
 
 std::shared_ptr<BoundedField> operator*(double const scale, std::shared_ptr<BoundedField const> bf) {
@@ -276,11 +492,29 @@ void BoundedField::divideImage(image::Image<T> &img, bool overlapOnly, int xStep
     applyToImage(*this, img, Divide(), overlapOnly, xStep, yStep);
 }
 
-#define INSTANTIATE(T)                                                                       \
-    template void BoundedField::fillImage(image::Image<T> &, bool, int, int) const;          \
-    template void BoundedField::addToImage(image::Image<T> &, double, bool, int, int) const; \
-    template void BoundedField::multiplyImage(image::Image<T> &, bool, int, int) const;      \
-    template void BoundedField::divideImage(image::Image<T> &, bool, int, int) const
+template <typename T>
+void BoundedField::fillImageInterpolated(image::Image<T> &img, double tolerance, bool overlapOnly) const {
+    applyInterpolatedToImage(*this, img, Assign(), overlapOnly, tolerance);
+}
+
+template <typename T>
+void BoundedField::multiplyImageInterpolated(image::Image<T> &img, double tolerance, bool overlapOnly) const {
+    applyInterpolatedToImage(*this, img, Multiply(), overlapOnly, tolerance);
+}
+
+template <typename T>
+void BoundedField::divideImageInterpolated(image::Image<T> &img, double tolerance, bool overlapOnly) const {
+    applyInterpolatedToImage(*this, img, Divide(), overlapOnly, tolerance);
+}
+
+#define INSTANTIATE(T)                                                                            \
+    template void BoundedField::fillImage(image::Image<T> &, bool, int, int) const;               \
+    template void BoundedField::addToImage(image::Image<T> &, double, bool, int, int) const;      \
+    template void BoundedField::multiplyImage(image::Image<T> &, bool, int, int) const;           \
+    template void BoundedField::divideImage(image::Image<T> &, bool, int, int) const;             \
+    template void BoundedField::fillImageInterpolated(image::Image<T> &, double, bool) const;     \
+    template void BoundedField::multiplyImageInterpolated(image::Image<T> &, double, bool) const; \
+    template void BoundedField::divideImageInterpolated(image::Image<T> &, double, bool) const
 
 INSTANTIATE(float);
 INSTANTIATE(double);
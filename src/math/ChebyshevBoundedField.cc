@@ -21,11 +21,14 @@
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 #include "ndarray/eigen.h"
 #include "lsst/afw/math/LeastSquares.h"
 #include "lsst/afw/math/ChebyshevBoundedField.h"
+#include "lsst/afw/math/detail/Parallel.h"
 #include "lsst/afw/math/detail/TrapezoidalPacker.h"
 #include "lsst/afw/table/io/OutputArchive.h"
 #include "lsst/afw/table/io/CatalogVector.h"
@@ -113,34 +116,32 @@ ndarray::Array<double, 2, 2> makeMatrix(ndarray::Array<double const, 1> const& x
     return out;
 }
 
-// Create a matrix of 2-d Chebyshev functions evaluated on a grid of positions, with
-// Chebyshev order along columns and evaluation positions along rows.  We pack the
-// 2-d functions using the TrapezoidalPacker class, because we don't want any columns
-// that correspond to coefficients that should be set to zero.
-ndarray::Array<double, 2, 2> makeMatrix(lsst::geom::Box2I const& bbox,
-                                        lsst::geom::AffineTransform const& toChebyshevRange,
-                                        Packer const& packer, Control const& ctrl) {
-    // Create a 2-d array that contains T_j(x) for each x value, with x values in rows and j in columns
-    ndarray::Array<double, 2, 2> tx = ndarray::allocate(bbox.getWidth(), packer.nx);
-    for (int x = bbox.getBeginX(), p = 0; p < bbox.getWidth(); ++p, ++x) {
-        evaluateBasis1d(tx[p], toChebyshevRange[lsst::geom::AffineTransform::XX] * x +
-                                       toChebyshevRange[lsst::geom::AffineTransform::X]);
-    }
-
-    // Loop over y values, and at each point, compute T_i(y), then loop over x and multiply by the T_j(x)
-    // we already computed and stored above.
-    ndarray::Array<double, 2, 2> out = ndarray::allocate(bbox.getArea(), packer.size);
-    ndarray::Array<double, 2, 2>::Iterator outIter = out.begin();
-    ndarray::Array<double, 1, 1> ty = ndarray::allocate(ctrl.orderY + 1);
-    for (int y = bbox.getBeginY(), i = 0; i < bbox.getHeight(); ++i, ++y) {
+// Accumulate the normal equations (the lower triangle of X^T X, and X^T z) for a fit to the rows
+// [yBegin, yEnd) of a gridded image, where the rows are numbered from the start of the image's bbox.
+// The design matrix X is only formed for one row at a time; tx holds T_j(x) for each column, with
+// columns in rows and j in columns.
+template <typename T>
+void accumulateNormalEquations(image::Image<T> const& img, int yBegin, int yEnd,
+                               ndarray::Array<double const, 2, 2> const& tx,
+                               lsst::geom::AffineTransform const& toChebyshevRange, Packer const& packer,
+                               Eigen::MatrixXd& fisher, Eigen::VectorXd& rhs) {
+    int const width = img.getWidth();
+    ndarray::Array<double, 2, 2> rowMatrix = ndarray::allocate(width, packer.size);
+    ndarray::Array<double, 1, 1> ty = ndarray::allocate(packer.ny);
+    Eigen::VectorXd z(width);
+    for (int i = yBegin; i < yEnd; ++i) {
+        int const y = img.getY0() + i;
         evaluateBasis1d(ty, toChebyshevRange[lsst::geom::AffineTransform::YY] * y +
                                     toChebyshevRange[lsst::geom::AffineTransform::Y]);
-        for (int j = 0; j < bbox.getWidth(); ++j, ++outIter) {
-            // this sets a row of out to the packed outer product of tx and ty
-            packer.pack(*outIter, tx[j], ty);
+        for (int j = 0; j < width; ++j) {
+            // this sets a row of rowMatrix to the packed outer product of tx and ty
+            packer.pack(rowMatrix[j], tx[j], ty);
         }
+        std::copy(img.row_begin(i), img.row_end(i), z.data());
+        auto const design = ndarray::asEigenMatrix(rowMatrix);
+        fisher.selfadjointView<Eigen::Lower>().rankUpdate(design.adjoint());
+        rhs.noalias() += design.adjoint() * z;
     }
-    return out;
 }
 
 }  // namespace
@@ -198,13 +199,32 @@ std::shared_ptr<ChebyshevBoundedField> ChebyshevBoundedField::fit(image::Image<T
     // This packer object knows how to map the 2-d Chebyshev functions onto a 1-d array,
     // using only those that the control says should have nonzero coefficients.
     Packer const packer(ctrl);
-    ndarray::Array<double, 2, 2> matrix = makeMatrix(bbox, result->_toChebyshevRange, packer, ctrl);
-    // Flatten the data image into a 1-d vector.
-    ndarray::Array<double, 2, 2> imgCopy = ndarray::allocate(img.getArray().getShape());
-    imgCopy.deep() = img.getArray();
-    ndarray::Array<double const, 1, 1> z = ndarray::flatten<1>(imgCopy);
+    // Create a 2-d array that contains T_j(x) for each x value, with x values in rows and j in columns
+    ndarray::Array<double, 2, 2> tx = ndarray::allocate(bbox.getWidth(), packer.nx);
+    for (int x = bbox.getBeginX(), p = 0; p < bbox.getWidth(); ++p, ++x) {
+        evaluateBasis1d(tx[p], result->_toChebyshevRange[lsst::geom::AffineTransform::XX] * x +
+                                       result->_toChebyshevRange[lsst::geom::AffineTransform::X]);
+    }
+    // Rather than building the full design matrix (one row per pixel), accumulate the normal
+    // equations for bands of image rows concurrently, then sum them.
+    int const nThreads = detail::resolveNumThreads(ctrl.numThreads);
+    auto const bands = detail::splitRange(0, bbox.getHeight(), nThreads);
+    int const nBands = bands.size();
+    std::vector<Eigen::MatrixXd> fishers(nBands, Eigen::MatrixXd::Zero(packer.size, packer.size));
+    std::vector<Eigen::VectorXd> rhss(nBands, Eigen::VectorXd::Zero(packer.size));
+    detail::parallelFor(nBands, nThreads, [&](int iBand) {
+        accumulateNormalEquations(img, bands[iBand].first, bands[iBand].second, tx,
+                                  result->_toChebyshevRange, packer, fishers[iBand], rhss[iBand]);
+    });
+    Eigen::MatrixXd fisher = Eigen::MatrixXd::Zero(packer.size, packer.size);
+    Eigen::VectorXd rhs = Eigen::VectorXd::Zero(packer.size);
+    for (int iBand = 0; iBand < nBands; ++iBand) {
+        fisher += fishers[iBand];
+        rhs += rhss[iBand];
+    }
+    fisher.triangularView<Eigen::StrictlyUpper>() = fisher.adjoint();
     // Solve the linear least squares problem.
-    LeastSquares lstsq = LeastSquares::fromDesignMatrix(matrix, z, LeastSquares::NORMAL_EIGENSYSTEM);
+    LeastSquares lstsq = LeastSquares::fromNormalEquations(fisher, rhs, LeastSquares::NORMAL_EIGENSYSTEM);
     // Unpack the solution into a 2-d matrix, with zeros for values we didn't fit.
     result->_coefficients = packer.unpack(lstsq.getSolution());
     return result;
@@ -284,6 +304,29 @@ double ChebyshevBoundedField::evaluate(lsst::geom::Point2D const& position) cons
                               _coefficients.getSize<0>());
 }
 
+ndarray::Array<double, 2, 2> ChebyshevBoundedField::evaluateGrid(
+        ndarray::Array<double const, 1> const& x, ndarray::Array<double const, 1> const& y) const {
+    // As the transform to the Chebyshev range is a scaling and a shift, the basis
+    // functions can be computed independently for each column and each row.
+    int const nx = x.getSize<0>();
+    int const ny = y.getSize<0>();
+    ndarray::Array<double, 2, 2> tx = ndarray::allocate(nx, _coefficients.getSize<1>());
+    for (int j = 0; j < nx; ++j) {
+        evaluateBasis1d(tx[j], _toChebyshevRange[lsst::geom::AffineTransform::XX] * x[j] +
+                                       _toChebyshevRange[lsst::geom::AffineTransform::X]);
+    }
+    ndarray::Array<double, 2, 2> ty = ndarray::allocate(ny, _coefficients.getSize<0>());
+    for (int i = 0; i < ny; ++i) {
+        evaluateBasis1d(ty[i], _toChebyshevRange[lsst::geom::AffineTransform::YY] * y[i] +
+                                       _toChebyshevRange[lsst::geom::AffineTransform::Y]);
+    }
+    // out[i][j] = sum_mn T_m(y_i) C[m][n] T_n(x_j); form C T(x)^T first, as it's the smaller product
+    ndarray::Array<double, 2, 2> out = ndarray::allocate(ny, nx);
+    ndarray::asEigenMatrix(out) = ndarray::asEigenMatrix(ty) * (ndarray::asEigenMatrix(_coefficients) *
+                                                                ndarray::asEigenMatrix(tx).transpose());
+    return out;
+}
+
 // The integral of T_n(x) over [-1,1]:
 // https://en.wikipedia.org/wiki/Chebyshev_polynomials#Differentiation_and_integration
 double integrateTn(int n) {
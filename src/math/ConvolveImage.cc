@@ -25,6 +25,7 @@
 /*
  * Definition of functions declared in ConvolveImage.h
  */
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
 #include <vector>
@@ -32,6 +33,7 @@
 
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/image/MaskedImage.h"
+#include "lsst/afw/math/Instrumentation.h"
 #include "lsst/afw/math/Kernel.h"
 #include "lsst/afw/math/detail/Convolve.h"
 
@@ -147,6 +149,22 @@ inline void setEdgePixels(OutImageT& outImage, Kernel const& kernel, InImageT co
     }
 }
 
+/*
+ * Convolve in Fourier space if the image types support it and convolutionControl requests it
+ * for this kernel; return true if the convolution was done.
+ */
+template <typename OutImageT, typename InImageT>
+bool maybeConvolveWithFft(OutImageT& convolvedImage, InImageT const& inImage, Kernel const& kernel,
+                          ConvolutionControl const& convolutionControl) {
+    if constexpr (detail::IsFftConvolvable<OutImageT, InImageT>::value) {
+        if (detail::shouldConvolveWithFft(kernel, convolutionControl)) {
+            detail::convolveWithFft(convolvedImage, inImage, kernel, convolutionControl);
+            return true;
+        }
+    }
+    return false;
+}
+
 }  // anonymous namespace
 
 template <typename OutImageT, typename InImageT>
@@ -180,7 +198,14 @@ void scaledPlus(OutImageT& outImage, double c1, InImageT const& inImage1, double
 template <typename OutImageT, typename InImageT, typename KernelT>
 void convolve(OutImageT& convolvedImage, InImageT const& inImage, KernelT const& kernel,
               ConvolutionControl const& convolutionControl) {
-    detail::basicConvolve(convolvedImage, inImage, kernel, convolutionControl);
+    LSST_AFW_INSTRUMENT_SCOPE("math.convolve");
+    if (maybeConvolveWithFft(convolvedImage, inImage, kernel, convolutionControl)) {
+        // done in Fourier space
+    } else if (convolutionControl.getNumThreads() != 1) {
+        detail::convolveInRowBands(convolvedImage, inImage, kernel, convolutionControl);
+    } else {
+        detail::basicConvolve(convolvedImage, inImage, kernel, convolutionControl);
+    }
     setEdgePixels(convolvedImage, kernel, inImage, convolutionControl.getDoCopyEdge(),
                   typename image::detail::image_traits<OutImageT>::image_category());
     convolvedImage.setXY0(inImage.getXY0());
@@ -195,6 +220,117 @@ void convolve(OutImageT& convolvedImage, InImageT const& inImage, KernelT const&
     convolve(convolvedImage, inImage, kernel, convolutionControl);
 }
 
+template <typename PixelT>
+void BasisConvolutionCache<PixelT>::convolve(ImageT& convolvedImage,
+                                             std::shared_ptr<ImageT const> const& inImage,
+                                             LinearCombinationKernel const& kernel,
+                                             ConvolutionControl const& convolutionControl) {
+    if (convolvedImage.getDimensions() != inImage->getDimensions()) {
+        std::ostringstream os;
+        os << "convolvedImage dimensions = ( " << convolvedImage.getWidth() << ", "
+           << convolvedImage.getHeight() << ") != (" << inImage->getWidth() << ", " << inImage->getHeight()
+           << ") = inImage dimensions";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+    if (inImage->getWidth() < kernel.getWidth() || inImage->getHeight() < kernel.getHeight()) {
+        std::ostringstream os;
+        os << "inImage dimensions = ( " << inImage->getWidth() << ", " << inImage->getHeight()
+           << ") smaller than (" << kernel.getWidth() << ", " << kernel.getHeight()
+           << ") = kernel dimensions in width and/or height";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+
+    int const nBasis = kernel.getNBasisKernels();
+    if (!isCached(inImage, kernel)) {
+        clear();
+        ConvolutionControl basisControl(false, false, convolutionControl.getMaxInterpolationDistance(),
+                                        convolutionControl.getNumThreads());
+        for (auto const& basisKernel : kernel.getKernelList()) {
+            // only the good region, which basicConvolve always sets, is used
+            auto basisConvolution =
+                    std::make_shared<image::Image<double>>(inImage->getDimensions(), image::UNINITIALIZED);
+            if (basisControl.getNumThreads() != 1) {
+                detail::convolveInRowBands(*basisConvolution, *inImage, *basisKernel, basisControl);
+            } else {
+                detail::basicConvolve(*basisConvolution, *inImage, *basisKernel, basisControl);
+            }
+            _basisConvolutionList.push_back(basisConvolution);
+        }
+        _inImage = inImage;
+        _kernelCtr = kernel.getCtr();
+        _basisImageList = _computeBasisImages(kernel);
+    }
+
+    // combine the basis convolutions over the good region, using the kernel coefficients
+    // at each pixel, as convolveWithBruteForce does for spatially varying kernels
+    bool const doNormalize = convolutionControl.getDoNormalize();
+    std::vector<double> const basisSumList = kernel.getKernelSumList();
+    std::vector<double> kernelParams = kernel.getKernelParameters();
+    std::vector<double const*> basisRowList(nBasis);
+    lsst::geom::Box2I const goodBBox = kernel.shrinkBBox(
+            lsst::geom::Box2I(lsst::geom::Point2I(0, 0), inImage->getDimensions()));
+    for (int y = goodBBox.getMinY(); y <= goodBBox.getMaxY(); ++y) {
+        double const rowPos = inImage->indexToPosition(y, image::Y);
+        for (int i = 0; i < nBasis; ++i) {
+            basisRowList[i] = _basisConvolutionList[i]->getArray()[y].getData();
+        }
+        PixelT* cnvRow = convolvedImage.getArray()[y].getData();
+        for (int x = goodBBox.getMinX(); x <= goodBBox.getMaxX(); ++x) {
+            if (kernel.isSpatiallyVarying()) {
+                double const colPos = inImage->indexToPosition(x, image::X);
+                kernel.computeKernelParametersFromSpatialModel(kernelParams, colPos, rowPos);
+            }
+            double sum = 0;
+            double kSum = 0;
+            for (int i = 0; i < nBasis; ++i) {
+                sum += kernelParams[i] * basisRowList[i][x];
+                kSum += kernelParams[i] * basisSumList[i];
+            }
+            cnvRow[x] = static_cast<PixelT>(doNormalize ? sum / kSum : sum);
+        }
+    }
+    setEdgePixels(convolvedImage, kernel, *inImage, convolutionControl.getDoCopyEdge(),
+                  image::detail::Image_tag());
+    convolvedImage.setXY0(inImage->getXY0());
+}
+
+template <typename PixelT>
+bool BasisConvolutionCache<PixelT>::isCached(std::shared_ptr<ImageT const> const& inImage,
+                                             LinearCombinationKernel const& kernel) const {
+    if (_basisConvolutionList.empty() || _inImage.lock() != inImage || _kernelCtr != kernel.getCtr() ||
+        static_cast<int>(_basisImageList.size()) != kernel.getNBasisKernels()) {
+        return false;
+    }
+    BasisImageList const basisImageList = _computeBasisImages(kernel);
+    for (std::size_t i = 0; i < basisImageList.size(); ++i) {
+        if (basisImageList[i]->getDimensions() != _basisImageList[i]->getDimensions() ||
+            !std::equal(basisImageList[i]->begin(), basisImageList[i]->end(), _basisImageList[i]->begin())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename PixelT>
+void BasisConvolutionCache<PixelT>::clear() {
+    _inImage.reset();
+    _basisImageList.clear();
+    _basisConvolutionList.clear();
+}
+
+template <typename PixelT>
+typename BasisConvolutionCache<PixelT>::BasisImageList BasisConvolutionCache<PixelT>::_computeBasisImages(
+        LinearCombinationKernel const& kernel) {
+    BasisImageList basisImageList;
+    for (auto const& basisKernel : kernel.getKernelList()) {
+        auto basisImage = std::make_shared<image::Image<Kernel::Pixel>>(basisKernel->getDimensions(),
+                                                                        image::UNINITIALIZED);
+        basisKernel->computeImage(*basisImage, false);
+        basisImageList.push_back(basisImage);
+    }
+    return basisImageList;
+}
+
 /// @cond
 /*
  * Explicit instantiation of all convolve functions.
@@ -256,6 +392,9 @@ INSTANTIATE(float, int)
 INSTANTIATE(float, std::uint16_t)
 INSTANTIATE(int, int)
 INSTANTIATE(std::uint16_t, std::uint16_t)
+
+template class BasisConvolutionCache<double>;
+template class BasisConvolutionCache<float>;
 /// @endcond
 }  // namespace math
 }  // namespace afw
@@ -0,0 +1,97 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <sstream>
+#include <thread>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/math/ExecutionContext.h"
+
+namespace lsst {
+namespace afw {
+namespace math {
+
+namespace {
+
+int getHardwareNumThreads() { return std::max(1u, std::thread::hardware_concurrency()); }
+
+void checkMaxNumThreads(int maxNumThreads) {
+    if (maxNumThreads < 0) {
+        std::ostringstream os;
+        os << "maxNumThreads = " << maxNumThreads << " < 0";
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, os.str());
+    }
+}
+
+// The initial process-wide limit: AFW_MAX_NUM_THREADS if it holds a valid count, else the hardware's
+int getInitialMaxNumThreads() {
+    char const *value = std::getenv("AFW_MAX_NUM_THREADS");
+    if (value && *value) {
+        char *end = nullptr;
+        long const n = std::strtol(value, &end, 10);
+        if (*end == '\0' && n > 0) {
+            return static_cast<int>(std::min<long>(n, getHardwareNumThreads() * 64L));
+        }
+    }
+    return getHardwareNumThreads();
+}
+
+std::atomic<int> &getGlobalMaxNumThreads() {
+    static std::atomic<int> maxNumThreads(getInitialMaxNumThreads());
+    return maxNumThreads;
+}
+
+// The limit of the innermost ExecutionContext on this thread; 0 if there is none
+thread_local int threadMaxNumThreads = 0;
+
+}  // namespace
+
+void setMaxNumThreads(int maxNumThreads) {
+    checkMaxNumThreads(maxNumThreads);
+    getGlobalMaxNumThreads() = maxNumThreads == 0 ? getHardwareNumThreads() : maxNumThreads;
+}
+
+int getMaxNumThreads() { return getGlobalMaxNumThreads(); }
+
+int getCurrentMaxNumThreads() {
+    int const global = getGlobalMaxNumThreads();
+    return threadMaxNumThreads > 0 ? std::min(global, threadMaxNumThreads) : global;
+}
+
+ExecutionContext::ExecutionContext(int maxNumThreads)
+        : _maxNumThreads(maxNumThreads), _previous(threadMaxNumThreads) {
+    checkMaxNumThreads(maxNumThreads);
+    if (maxNumThreads > 0) {
+        threadMaxNumThreads = _previous > 0 ? std::min(_previous, maxNumThreads) : maxNumThreads;
+    }
+}
+
+ExecutionContext::~ExecutionContext() noexcept { threadMaxNumThreads = _previous; }
+
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
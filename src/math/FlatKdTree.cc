@@ -0,0 +1,326 @@
+// -*- LSST-C++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <sstream>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/math/FlatKdTree.h"
+#include "lsst/afw/math/detail/Parallel.h"
+
+namespace lsst {
+namespace afw {
+namespace math {
+
+namespace {
+
+// A node still to be searched: its position in the implicit layout, the range of slots it covers,
+// its level, and a lower bound on the squared distance from the query to any of its points
+struct PendingNode {
+    int node;
+    int begin;
+    int end;
+    int level;
+    double bound;
+};
+
+// The tree is balanced and holds fewer than 2^31 points, so a depth-first search never has more
+// than one pending node per level
+using SearchStack = std::array<PendingNode, 64>;
+
+void checkDimensions(int expected, ndarray::Size actual, char const *what) {
+    if (actual != static_cast<ndarray::Size>(expected)) {
+        std::ostringstream os;
+        os << what << " have " << actual << " dimensions; the tree's points have " << expected;
+        throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
+    }
+}
+
+void checkNeighborCount(int k, int size) {
+    if (k > size) {
+        std::ostringstream os;
+        os << "Requested " << k << " neighbors, but the tree only contains " << size << " points";
+        throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
+    }
+}
+
+}  // namespace
+
+template <typename T>
+FlatKdTree<T>::FlatKdTree(ndarray::Array<T const, 2, 1> const &points, int leafSize)
+        : _dimensions(points.template getSize<1>()), _depth(0) {
+    int const n = points.template getSize<0>();
+    if (n == 0 || _dimensions == 0) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "Cannot build a tree with no points");
+    }
+    if (leafSize < 1) {
+        std::ostringstream os;
+        os << "leafSize must be >= 1; got " << leafSize;
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, os.str());
+    }
+
+    // Halving a range of m points gives ranges of floor(m/2) and ceil(m/2) points, so the largest
+    // range at level d holds ceil(n/2^d) points
+    for (long maxLeaf = n; maxLeaf > leafSize; maxLeaf = (maxLeaf + 1) / 2) {
+        ++_depth;
+    }
+    int const nNodes = (1 << _depth) - 1;
+    _splitDims.resize(nNodes);
+    _splitValues.resize(nNodes);
+
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+
+    // Split nodes level by level; each level's nodes are consecutive in the implicit layout
+    std::vector<std::pair<int, int>> ranges = {{0, n}}, children;
+    for (int level = 0, node = 0; level < _depth; ++level) {
+        children.clear();
+        for (auto const &range : ranges) {
+            int const begin = range.first;
+            int const end = range.second;
+            int const mid = begin + (end - begin) / 2;
+
+            int dim = 0;
+            T maxSpread = -1;
+            for (int j = 0; j < _dimensions; ++j) {
+                auto const minmax = std::minmax_element(
+                        order.begin() + begin, order.begin() + end,
+                        [&points, j](int a, int b) { return points[a][j] < points[b][j]; });
+                T const spread = points[*minmax.second][j] - points[*minmax.first][j];
+                if (spread > maxSpread) {
+                    maxSpread = spread;
+                    dim = j;
+                }
+            }
+            std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+                             [&points, dim](int a, int b) { return points[a][dim] < points[b][dim]; });
+            _splitDims[node] = dim;
+            _splitValues[node] = points[order[mid]][dim];
+            ++node;
+
+            children.emplace_back(begin, mid);
+            children.emplace_back(mid, end);
+        }
+        std::swap(ranges, children);
+    }
+
+    _indices = std::move(order);
+    _points.resize(static_cast<std::size_t>(n) * _dimensions);
+    for (int slot = 0; slot < n; ++slot) {
+        std::copy_n(points[_indices[slot]].begin(), _dimensions, _points.begin() + slot * _dimensions);
+    }
+}
+
+template <typename T>
+double FlatKdTree<T>::_distanceSquared(T const *point, int slot) const {
+    T const *other = _points.data() + static_cast<std::size_t>(slot) * _dimensions;
+    double result = 0.0;
+    for (int j = 0; j < _dimensions; ++j) {
+        double const diff = static_cast<double>(point[j]) - other[j];
+        result += diff * diff;
+    }
+    return result;
+}
+
+template <typename T>
+void FlatKdTree<T>::_findNeighbors(T const *point, int k, std::vector<std::pair<double, int>> &heap,
+                                   int *indices, double *distances) const {
+    heap.clear();
+    if (k == 0) {
+        return;
+    }
+    // Neighbors are compared as (squared distance, index), so ties are broken by index
+    auto const worst = [&heap, k]() {
+        return static_cast<int>(heap.size()) < k ? std::numeric_limits<double>::infinity()
+                                                  : heap.front().first;
+    };
+
+    SearchStack stack;
+    int nPending = 0;
+    stack[nPending++] = {0, 0, size(), 0, 0.0};
+    while (nPending > 0) {
+        PendingNode current = stack[--nPending];
+        if (current.bound > worst()) {
+            continue;
+        }
+        while (current.level < _depth) {
+            int const mid = current.begin + (current.end - current.begin) / 2;
+            double const offset = static_cast<double>(point[_splitDims[current.node]]) -
+                                  _splitValues[current.node];
+            PendingNode lower = {2 * current.node + 1, current.begin, mid, current.level + 1, current.bound};
+            PendingNode upper = {2 * current.node + 2, mid, current.end, current.level + 1, current.bound};
+            if (offset < 0) {
+                upper.bound = std::max(current.bound, offset * offset);
+                stack[nPending++] = upper;
+                current = lower;
+            } else {
+                lower.bound = std::max(current.bound, offset * offset);
+                stack[nPending++] = lower;
+                current = upper;
+            }
+        }
+        for (int slot = current.begin; slot < current.end; ++slot) {
+            std::pair<double, int> const candidate(_distanceSquared(point, slot), _indices[slot]);
+            if (static_cast<int>(heap.size()) < k) {
+                heap.push_back(candidate);
+                std::push_heap(heap.begin(), heap.end());
+            } else if (candidate < heap.front()) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = candidate;
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+    }
+
+    std::sort_heap(heap.begin(), heap.end());
+    for (int i = 0; i < k; ++i) {
+        indices[i] = heap[i].second;
+        distances[i] = std::sqrt(heap[i].first);
+    }
+}
+
+template <typename T>
+std::vector<int> FlatKdTree<T>::_findWithinRadius(T const *point, double radius) const {
+    std::vector<int> result;
+    if (!(radius >= 0)) {
+        return result;
+    }
+    double const radius2 = radius * radius;
+
+    SearchStack stack;
+    int nPending = 0;
+    stack[nPending++] = {0, 0, size(), 0, 0.0};
+    while (nPending > 0) {
+        PendingNode current = stack[--nPending];
+        if (current.bound > radius2) {
+            continue;
+        }
+        while (current.level < _depth) {
+            int const mid = current.begin + (current.end - current.begin) / 2;
+            double const offset = static_cast<double>(point[_splitDims[current.node]]) -
+                                  _splitValues[current.node];
+            double const bound = std::max(current.bound, offset * offset);
+            PendingNode lower = {2 * current.node + 1, current.begin, mid, current.level + 1, current.bound};
+            PendingNode upper = {2 * current.node + 2, mid, current.end, current.level + 1, current.bound};
+            if (offset < 0) {
+                upper.bound = bound;
+                if (bound <= radius2) stack[nPending++] = upper;
+                current = lower;
+            } else {
+                lower.bound = bound;
+                if (bound <= radius2) stack[nPending++] = lower;
+                current = upper;
+            }
+        }
+        for (int slot = current.begin; slot < current.end; ++slot) {
+            if (_distanceSquared(point, slot) <= radius2) {
+                result.push_back(_indices[slot]);
+            }
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+template <typename T>
+void FlatKdTree<T>::findNeighbors(ndarray::Array<int, 1, 1> indices, ndarray::Array<double, 1, 1> distances,
+                                  ndarray::Array<T const, 1, 1> const &point) const {
+    checkDimensions(_dimensions, point.getNumElements(), "Query points");
+    if (indices.getNumElements() != distances.getNumElements()) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          "Index and distance arrays must have the same size");
+    }
+    int const k = indices.getNumElements();
+    checkNeighborCount(k, size());
+
+    std::vector<std::pair<double, int>> heap;
+    heap.reserve(k);
+    _findNeighbors(point.getData(), k, heap, indices.getData(), distances.getData());
+}
+
+template <typename T>
+void FlatKdTree<T>::findNeighbors(ndarray::Array<int, 2, 2> indices, ndarray::Array<double, 2, 2> distances,
+                                  ndarray::Array<T const, 2, 1> const &queries, int numThreads) const {
+    checkDimensions(_dimensions, queries.template getSize<1>(), "Query points");
+    if (indices.template getSize<0>() != distances.template getSize<0>() ||
+        indices.template getSize<1>() != distances.template getSize<1>()) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          "Index and distance arrays must have the same shape");
+    }
+    if (indices.template getSize<0>() != queries.template getSize<0>()) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          "Index and distance arrays must have one row per query");
+    }
+    int const k = indices.template getSize<1>();
+    checkNeighborCount(k, size());
+
+    int const nThreads = detail::resolveNumThreads(numThreads);
+    auto const chunks = detail::splitRange(0, queries.template getSize<0>(), nThreads);
+    int const nChunks = chunks.size();
+    detail::parallelFor(nChunks, nThreads, [&](int iChunk) {
+        std::vector<std::pair<double, int>> heap;
+        heap.reserve(k);
+        for (int i = chunks[iChunk].first; i < chunks[iChunk].second; ++i) {
+            _findNeighbors(queries[i].getData(), k, heap, indices[i].getData(), distances[i].getData());
+        }
+    });
+}
+
+template <typename T>
+std::vector<int> FlatKdTree<T>::findWithinRadius(ndarray::Array<T const, 1, 1> const &point,
+                                                 double radius) const {
+    checkDimensions(_dimensions, point.getNumElements(), "Query points");
+    return _findWithinRadius(point.getData(), radius);
+}
+
+template <typename T>
+std::vector<std::vector<int>> FlatKdTree<T>::findWithinRadius(ndarray::Array<T const, 2, 1> const &queries,
+                                                              double radius, int numThreads) const {
+    checkDimensions(_dimensions, queries.template getSize<1>(), "Query points");
+
+    int const nQueries = queries.template getSize<0>();
+    std::vector<std::vector<int>> result(nQueries);
+    int const nThreads = detail::resolveNumThreads(numThreads);
+    auto const chunks = detail::splitRange(0, nQueries, nThreads);
+    int const nChunks = chunks.size();
+    detail::parallelFor(nChunks, nThreads, [&](int iChunk) {
+        for (int i = chunks[iChunk].first; i < chunks[iChunk].second; ++i) {
+            result[i] = _findWithinRadius(queries[i].getData(), radius);
+        }
+    });
+    return result;
+}
+
+/// @cond
+template class FlatKdTree<float>;
+template class FlatKdTree<double>;
+/// @endcond
+
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
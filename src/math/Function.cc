@@ -30,6 +30,44 @@ namespace lsst {
 namespace afw {
 namespace math {
 
+template <typename ReturnT>
+ndarray::Array<ReturnT, 1, 1> Function1<ReturnT>::evaluate(ndarray::Array<double const, 1> const& x) const {
+    ndarray::Array<ReturnT, 1, 1> out = ndarray::allocate(x.getSize<0>());
+    for (int i = 0, n = x.getSize<0>(); i < n; ++i) {
+        out[i] = (*this)(x[i]);
+    }
+    return out;
+}
+
+template <typename ReturnT>
+ndarray::Array<ReturnT, 1, 1> Function2<ReturnT>::evaluate(ndarray::Array<double const, 1> const& x,
+                                                           ndarray::Array<double const, 1> const& y) const {
+    if (x.getSize<0>() != y.getSize<0>()) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError,
+                          (boost::format("x has %d elements but y has %d") % x.getSize<0>() % y.getSize<0>())
+                                  .str());
+    }
+    ndarray::Array<ReturnT, 1, 1> out = ndarray::allocate(x.getSize<0>());
+    for (int i = 0, n = x.getSize<0>(); i < n; ++i) {
+        out[i] = (*this)(x[i], y[i]);
+    }
+    return out;
+}
+
+template <typename ReturnT>
+ndarray::Array<ReturnT, 2, 2> Function2<ReturnT>::evaluateGrid(
+        ndarray::Array<double const, 1> const& x, ndarray::Array<double const, 1> const& y) const {
+    int const nx = x.getSize<0>();
+    int const ny = y.getSize<0>();
+    ndarray::Array<ReturnT, 2, 2> out = ndarray::allocate(ny, nx);
+    for (int i = 0; i < ny; ++i) {
+        for (int j = 0; j < nx; ++j) {
+            out[i][j] = (*this)(x[j], y[i]);
+        }
+    }
+    return out;
+}
+
 template <typename ReturnT>
 std::vector<double> PolynomialFunction2<ReturnT>::getDFuncDParameters(double x, double y) const {
     std::vector<double> coeffs(this->getNParameters());
@@ -74,6 +112,12 @@ std::vector<double> PolynomialFunction2<ReturnT>::getDFuncDParameters(double x,
     template std::shared_ptr<math::Function2<TYPE>>                                                       \
     table::io::PersistableFacade<math::Function2<TYPE>>::dynamicCast(                                     \
             std::shared_ptr<table::io::Persistable> const&);                                              \
+    template ndarray::Array<TYPE, 1, 1> math::Function1<TYPE>::evaluate(                                  \
+            ndarray::Array<double const, 1> const&) const;                                                \
+    template ndarray::Array<TYPE, 1, 1> math::Function2<TYPE>::evaluate(                                  \
+            ndarray::Array<double const, 1> const&, ndarray::Array<double const, 1> const&) const;        \
+    template ndarray::Array<TYPE, 2, 2> math::Function2<TYPE>::evaluateGrid(                              \
+            ndarray::Array<double const, 1> const&, ndarray::Array<double const, 1> const&) const;        \
     template std::vector<double> math::PolynomialFunction2<TYPE>::getDFuncDParameters(double x, double y) \
             const
 
@@ -1,6 +1,10 @@
 // -*- lsst-c++ -*-
 
 #include <memory>
+#include <vector>
+
+#include "Eigen/Core"
+#include "ndarray/eigen.h"
 
 #include "lsst/afw/math/FunctionLibrary.h"
 #include "lsst/afw/table/io/OutputArchive.h"
@@ -191,6 +195,60 @@ struct Suffix<double> {
     static std::string get() { return "D"; }
 };
 
+// Index of the coefficient of x^r y^s (or T_r(x) T_s(y)) in the parameters of a 2-d polynomial
+inline int paramIndex(int r, int s) { return (r + s) * (r + s + 1) / 2 + s; }
+
+/*
+ * The recurrences below run across all the points of an array at once, so their inner loops vectorize.
+ * Coefficient functions may return either a scalar or an array of per-point coefficients.
+ */
+
+// Evaluate sum_i coeff(i) x^i for i in [0, order] by Horner's method
+template <typename Coeff>
+Eigen::ArrayXd horner(Eigen::ArrayXd const &x, int order, Coeff const &coeff) {
+    Eigen::ArrayXd result = Eigen::ArrayXd::Zero(x.size()) + coeff(order);
+    for (int i = order - 1; i >= 0; --i) {
+        result = result * x + coeff(i);
+    }
+    return result;
+}
+
+// Evaluate sum_i coeff(i) T_i(x) for i in [0, order] by Clenshaw's recurrence, as
+// Chebyshev1Function1::operator() does
+template <typename Coeff>
+Eigen::ArrayXd clenshaw(Eigen::ArrayXd const &x, int order, Coeff const &coeff) {
+    if (order == 0) {
+        return Eigen::ArrayXd::Zero(x.size()) + coeff(0);
+    } else if (order == 1) {
+        return x * coeff(1) + coeff(0);
+    }
+    auto const top = coeff(order);
+    Eigen::ArrayXd cshPrev = Eigen::ArrayXd::Zero(x.size()) + top;
+    Eigen::ArrayXd csh = 2 * x * top + coeff(order - 1);
+    Eigen::ArrayXd cshNext(x.size());
+    for (int i = order - 2; i > 0; --i) {
+        cshNext = 2 * x * csh + coeff(i) - cshPrev;
+        cshPrev.swap(csh);
+        csh.swap(cshNext);
+    }
+    return x * csh + coeff(0) - cshPrev;
+}
+
+template <typename ReturnT>
+ndarray::Array<ReturnT, 1, 1> toArray(Eigen::ArrayXd const &values) {
+    ndarray::Array<ReturnT, 1, 1> out = ndarray::allocate(values.size());
+    ndarray::asEigenArray(out) = values.template cast<ReturnT>();
+    return out;
+}
+
+void checkSizes(ndarray::Array<double const, 1> const &x, ndarray::Array<double const, 1> const &y) {
+    if (x.getSize<0>() != y.getSize<0>()) {
+        std::ostringstream os;
+        os << "x has " << x.getSize<0>() << " elements but y has " << y.getSize<0>();
+        throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
+    }
+}
+
 }  // namespace
 
 template <typename ReturnT>
@@ -255,6 +313,99 @@ void Chebyshev1Function2<ReturnT>::write(table::io::OutputArchiveHandle& handle)
     handle.saveCatalog(catalog);
 }
 
+template <typename ReturnT>
+ndarray::Array<ReturnT, 1, 1> PolynomialFunction1<ReturnT>::evaluate(
+        ndarray::Array<double const, 1> const &x) const {
+    Eigen::ArrayXd const xs = ndarray::asEigenArray(x);
+    int const order = static_cast<int>(this->_params.size()) - 1;
+    return toArray<ReturnT>(horner(xs, order, [this](int i) { return this->_params[i]; }));
+}
+
+template <typename ReturnT>
+ndarray::Array<ReturnT, 1, 1> PolynomialFunction2<ReturnT>::evaluate(
+        ndarray::Array<double const, 1> const &x, ndarray::Array<double const, 1> const &y) const {
+    checkSizes(x, y);
+    Eigen::ArrayXd const xs = ndarray::asEigenArray(x);
+    Eigen::ArrayXd const ys = ndarray::asEigenArray(y);
+    int const order = this->_order;
+    // f(x, y) = sum_r x^r C_r(y), with C_r(y) = sum_s P(r, s) y^s
+    return toArray<ReturnT>(horner(xs, order, [&](int r) {
+        return horner(ys, order - r, [&](int s) { return this->_params[paramIndex(r, s)]; });
+    }));
+}
+
+template <typename ReturnT>
+ndarray::Array<ReturnT, 2, 2> PolynomialFunction2<ReturnT>::evaluateGrid(
+        ndarray::Array<double const, 1> const &x, ndarray::Array<double const, 1> const &y) const {
+    Eigen::ArrayXd const xs = ndarray::asEigenArray(x);
+    int const order = this->_order;
+    ndarray::Array<ReturnT, 2, 2> out = ndarray::allocate(y.getSize<0>(), x.getSize<0>());
+    std::vector<double> xCoeffs(order + 1);
+    for (int i = 0, ny = y.getSize<0>(); i < ny; ++i) {
+        for (int r = 0; r <= order; ++r) {
+            double coeff = this->_params[paramIndex(r, order - r)];
+            for (int s = order - r - 1; s >= 0; --s) {
+                coeff = coeff * y[i] + this->_params[paramIndex(r, s)];
+            }
+            xCoeffs[r] = coeff;
+        }
+        ndarray::Array<ReturnT, 1, 1> row = out[i];
+        ndarray::asEigenArray(row) =
+                horner(xs, order, [&](int r) { return xCoeffs[r]; }).template cast<ReturnT>();
+    }
+    return out;
+}
+
+template <typename ReturnT>
+ndarray::Array<ReturnT, 1, 1> Chebyshev1Function1<ReturnT>::evaluate(
+        ndarray::Array<double const, 1> const &x) const {
+    Eigen::ArrayXd const xPrime = (ndarray::asEigenArray(x) + _offset) * _scale;
+    return toArray<ReturnT>(clenshaw(xPrime, _order, [this](int i) { return this->_params[i]; }));
+}
+
+template <typename ReturnT>
+ndarray::Array<ReturnT, 1, 1> Chebyshev1Function2<ReturnT>::evaluate(
+        ndarray::Array<double const, 1> const &x, ndarray::Array<double const, 1> const &y) const {
+    checkSizes(x, y);
+    Eigen::ArrayXd const xPrime = (ndarray::asEigenArray(x) + _offsetX) * _scaleX;
+    Eigen::ArrayXd const yPrime = (ndarray::asEigenArray(y) + _offsetY) * _scaleY;
+    int const order = this->_order;
+    // f(x, y) = sum_r T_r(x') C_r(y'), with C_r(y') = sum_s P(r, s) T_s(y')
+    return toArray<ReturnT>(clenshaw(xPrime, order, [&](int r) {
+        return clenshaw(yPrime, order - r, [&](int s) { return this->_params[paramIndex(r, s)]; });
+    }));
+}
+
+template <typename ReturnT>
+ndarray::Array<ReturnT, 2, 2> Chebyshev1Function2<ReturnT>::evaluateGrid(
+        ndarray::Array<double const, 1> const &x, ndarray::Array<double const, 1> const &y) const {
+    Eigen::ArrayXd const xPrime = (ndarray::asEigenArray(x) + _offsetX) * _scaleX;
+    int const order = this->_order;
+    ndarray::Array<ReturnT, 2, 2> out = ndarray::allocate(y.getSize<0>(), x.getSize<0>());
+    std::vector<double> yCheby(order + 1);
+    std::vector<double> xCoeffs(order + 1);
+    for (int i = 0, ny = y.getSize<0>(); i < ny; ++i) {
+        double const yPrime = (y[i] + _offsetY) * _scaleY;
+        yCheby[0] = 1.0;
+        if (order > 0) {
+            yCheby[1] = yPrime;
+        }
+        for (int s = 2; s <= order; ++s) {
+            yCheby[s] = 2 * yPrime * yCheby[s - 1] - yCheby[s - 2];
+        }
+        for (int r = 0; r <= order; ++r) {
+            xCoeffs[r] = 0.0;
+            for (int s = 0; s <= order - r; ++s) {
+                xCoeffs[r] += this->_params[paramIndex(r, s)] * yCheby[s];
+            }
+        }
+        ndarray::Array<ReturnT, 1, 1> row = out[i];
+        ndarray::asEigenArray(row) =
+                clenshaw(xPrime, order, [&](int r) { return xCoeffs[r]; }).template cast<ReturnT>();
+    }
+    return out;
+}
+
 // Explicit instantiation
 #define INSTANTIATE(TYPE)                         \
     template class IntegerDeltaFunction1<TYPE>;   \
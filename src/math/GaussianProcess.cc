@@ -22,10 +22,14 @@
  * see  < http://www.lsstcorp.org/LegalNotices/ > .
  */
 
+#include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <limits>
+#include <vector>
 
 #include "lsst/afw/math/GaussianProcess.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 using namespace std;
 
@@ -154,31 +158,21 @@ void KdTree<T>::findNeighbors(ndarray::Array<int, 1, 1> neighdex, ndarray::Array
                           "Size of dd does not equal n_nn in KdTree.findNeighbors\n");
     }
 
-    int i, start;
+    NeighborSearch search{v.getData(), n_nn, 0, dd.getData(), neighdex.getData()};
 
-    _neighborCandidates = allocate(ndarray::makeVector(n_nn));
-    _neighborDistances = allocate(ndarray::makeVector(n_nn));
-    _neighborsFound = 0;
-    _neighborsWanted = n_nn;
+    for (int i = 0; i < n_nn; i++) search.distances[i] = -1.0;
 
-    for (i = 0; i < n_nn; i++) _neighborDistances[i] = -1.0;
+    int const start = _findNode(v);
 
-    start = _findNode(v);
+    search.distances[0] = _distance(search.point, _point(start));
+    search.candidates[0] = start;
+    search.found = 1;
 
-    _neighborDistances[0] = _distance(v, _data[start]);
-    _neighborCandidates[0] = start;
-    _neighborsFound = 1;
-
-    for (i = 1; i < 4; i++) {
-        if (_tree[start][i] >= 0) {
-            _lookForNeighbors(v, _tree[start][i], start);
+    for (int i = 1; i < 4; i++) {
+        if (_node(start, i) >= 0) {
+            _lookForNeighbors(search, _node(start, i), start);
         }
     }
-
-    for (i = 0; i < n_nn; i++) {
-        neighdex[i] = _neighborCandidates[i];
-        dd[i] = _neighborDistances[i];
-    }
 }
 
 template <typename T>
@@ -452,93 +446,95 @@ template <typename T>
 int KdTree<T>::_findNode(ndarray::Array<const T, 1, 1> const &v) const {
     int consider, next, dim;
 
-    dim = _tree[_masterParent][DIMENSION];
+    dim = _node(_masterParent, DIMENSION);
 
-    if (v[dim] < _data[_masterParent][dim])
-        consider = _tree[_masterParent][LT];
+    if (v[dim] < _point(_masterParent)[dim])
+        consider = _node(_masterParent, LT);
     else
-        consider = _tree[_masterParent][GEQ];
+        consider = _node(_masterParent, GEQ);
 
     next = consider;
 
     while (next >= 0) {
         consider = next;
 
-        dim = _tree[consider][DIMENSION];
-        if (v[dim] < _data[consider][dim])
-            next = _tree[consider][LT];
+        dim = _node(consider, DIMENSION);
+        if (v[dim] < _point(consider)[dim])
+            next = _node(consider, LT);
         else
-            next = _tree[consider][GEQ];
+            next = _node(consider, GEQ);
     }
 
     return consider;
 }
 
 template <typename T>
-void KdTree<T>::_lookForNeighbors(ndarray::Array<const T, 1, 1> const &v, int consider, int from) const {
+void KdTree<T>::_lookForNeighbors(NeighborSearch &search, int consider, int from) const {
     int i, j, going;
     double dd;
 
-    dd = _distance(v, _data[consider]);
+    T const *v = search.point;
+    T const *considered = _point(consider);
+    dd = _distance(v, considered);
 
-    if (_neighborsFound < _neighborsWanted || dd < _neighborDistances[_neighborsWanted - 1]) {
-        for (j = 0; j < _neighborsFound && _neighborDistances[j] < dd; j++)
+    if (search.found < search.wanted || dd < search.distances[search.wanted - 1]) {
+        for (j = 0; j < search.found && search.distances[j] < dd; j++)
             ;
 
-        for (i = _neighborsWanted - 1; i > j; i--) {
-            _neighborDistances[i] = _neighborDistances[i - 1];
-            _neighborCandidates[i] = _neighborCandidates[i - 1];
+        for (i = search.wanted - 1; i > j; i--) {
+            search.distances[i] = search.distances[i - 1];
+            search.candidates[i] = search.candidates[i - 1];
         }
 
-        _neighborDistances[j] = dd;
-        _neighborCandidates[j] = consider;
+        search.distances[j] = dd;
+        search.candidates[j] = consider;
 
-        if (_neighborsFound < _neighborsWanted) _neighborsFound++;
+        if (search.found < search.wanted) search.found++;
     }
 
-    if (_tree[consider][PARENT] == from) {
+    if (_node(consider, PARENT) == from) {
         // you came here from the parent
 
-        i = _tree[consider][DIMENSION];
-        dd = v[i] - _data[consider][i];
-        if ((dd <= _neighborDistances[_neighborsFound - 1] || _neighborsFound < _neighborsWanted) &&
-            _tree[consider][LT] >= 0) {
-            _lookForNeighbors(v, _tree[consider][LT], consider);
+        i = _node(consider, DIMENSION);
+        dd = v[i] - considered[i];
+        if ((dd <= search.distances[search.found - 1] || search.found < search.wanted) &&
+            _node(consider, LT) >= 0) {
+            _lookForNeighbors(search, _node(consider, LT), consider);
         }
 
-        dd = _data[consider][i] - v[i];
-        if ((dd <= _neighborDistances[_neighborsFound - 1] || _neighborsFound < _neighborsWanted) &&
-            _tree[consider][GEQ] >= 0) {
-            _lookForNeighbors(v, _tree[consider][GEQ], consider);
+        dd = considered[i] - v[i];
+        if ((dd <= search.distances[search.found - 1] || search.found < search.wanted) &&
+            _node(consider, GEQ) >= 0) {
+            _lookForNeighbors(search, _node(consider, GEQ), consider);
         }
     } else {
         // you came here from one of the branches
 
         // descend the other branch
-        if (_tree[consider][LT] == from) {
+        if (_node(consider, LT) == from) {
             going = GEQ;
         } else {
             going = LT;
         }
 
-        j = _tree[consider][going];
+        j = _node(consider, going);
 
         if (j >= 0) {
-            i = _tree[consider][DIMENSION];
+            i = _node(consider, DIMENSION);
 
             if (going == 1)
-                dd = v[i] - _data[consider][i];
+                dd = v[i] - considered[i];
             else
-                dd = _data[consider][i] - v[i];
+                dd = considered[i] - v[i];
 
-            if (dd <= _neighborDistances[_neighborsFound - 1] || _neighborsFound < _neighborsWanted) {
-                _lookForNeighbors(v, j, consider);
+            if (dd <= search.distances[search.found - 1] || search.found < search.wanted) {
+                _lookForNeighbors(search, j, consider);
             }
         }
 
         // ascend to the parent
-        if (_tree[consider][PARENT] >= 0) {
-            _lookForNeighbors(v, _tree[consider][PARENT], consider);
+        if (_node(consider, PARENT) >= 0) {
+            _lookForNeighbors(search, _node(consider, PARENT), consider);
         }
     }
 }
@@ -735,14 +731,10 @@ void KdTree<T>::_descend(int root) {
 }
 
 template <typename T>
-double KdTree<T>::_distance(ndarray::Array<const T, 1, 1> const &p1,
-                            ndarray::Array<const T, 1, 1> const &p2) const {
-    int i, dd;
-    double ans;
-    ans = 0.0;
-    dd = p1.template getSize<0>();
+double KdTree<T>::_distance(T const *p1, T const *p2) const {
+    double ans = 0.0;
 
-    for (i = 0; i < dd; i++) ans += (p1[i] - p2[i]) * (p1[i] - p2[i]);
+    for (int i = 0; i < _dimensions; i++) ans += (p1[i] - p2[i]) * (p1[i] - p2[i]);
 
     return ::sqrt(ans);
 }
@@ -1485,110 +1477,190 @@ void GaussianProcess<T>::selfInterpolate(ndarray::Array<T, 1, 1> mu, ndarray::Ar
 }
 
 template <typename T>
-void GaussianProcess<T>::batchInterpolate(ndarray::Array<T, 1, 1> mu, ndarray::Array<T, 1, 1> variance,
-                                          ndarray::Array<T, 2, 2> const &queries) const {
-    int i, j;
-
-    ndarray::Size nQueries = queries.template getSize<0>();
-
-    if (_nFunctions != 1) {
+void GaussianProcess<T>::batchSelfInterpolate(ndarray::Array<T, 1, 1> mu, ndarray::Array<T, 1, 1> variance,
+                                              ndarray::Array<int, 1, 1> const &indices,
+                                              int numberOfNeighbors) const {
+    if (_nFunctions > 1) {
         throw LSST_EXCEPT(lsst::pex::exceptions::RuntimeError,
-                          "Your mu and variance arrays do not have room for all of the functions "
-                          "as you are trying to interpolate\n");
+                          "You need to call the version of GaussianProcess.batchSelfInterpolate() "
+                          "that accepts two-dimensional mu and variance arrays. "
+                          "You are interpolating more than one function.");
     }
 
-    if (mu.getNumElements() != nQueries || variance.getNumElements() != nQueries) {
+    if (mu.getNumElements() != indices.getNumElements() ||
+        variance.getNumElements() != indices.getNumElements()) {
         throw LSST_EXCEPT(lsst::pex::exceptions::RuntimeError,
-                          "Your mu and variance arrays do not have room for all of the points "
-                          "at which you are trying to interpolate your function.\n");
+                          "Your mu and/or variance arrays are not the same size as your indices array\n");
     }
 
-    if (queries.template getSize<1>() != static_cast<ndarray::Size>(_dimensions)) {
+    _batchSelfInterpolate(mu.getData(), variance.getData(), indices, numberOfNeighbors);
+}
+
+template <typename T>
+void GaussianProcess<T>::batchSelfInterpolate(ndarray::Array<T, 2, 2> mu, ndarray::Array<T, 2, 2> variance,
+                                              ndarray::Array<int, 1, 1> const &indices,
+                                              int numberOfNeighbors) const {
+    ndarray::Size const nIndices = indices.getNumElements();
+    if (mu.template getSize<0>() != nIndices || variance.template getSize<0>() != nIndices ||
+        mu.template getSize<1>() != static_cast<ndarray::Size>(_nFunctions) ||
+        variance.template getSize<1>() != static_cast<ndarray::Size>(_nFunctions)) {
         throw LSST_EXCEPT(lsst::pex::exceptions::RuntimeError,
-                          "The points you passed to batchInterpolate are of the wrong "
-                          "dimensionality for your Gaussian Process\n");
+                          "Your mu and/or variance arrays are improperly sized for the number of indices "
+                          "and the number of functions you are interpolating\n");
     }
 
-    T fbar;
-    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> batchCovariance, batchbb, batchxx;
-    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> queryCovariance;
-    Eigen::LDLT<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> > ldlt;
+    _batchSelfInterpolate(mu.getData(), variance.getData(), indices, numberOfNeighbors);
+}
 
-    ndarray::Array<T, 1, 1> v1;
+template <typename T>
+void GaussianProcess<T>::_batchSelfInterpolate(T *mu, T *variance, ndarray::Array<int, 1, 1> const &indices,
+                                               int numberOfNeighbors) const {
+    using Matrix = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
 
-    _timer.start();
+    if (numberOfNeighbors <= 0) {
+        throw LSST_EXCEPT(lsst::pex::exceptions::RuntimeError,
+                          "Asked for zero or negative number of neighbors\n");
+    }
 
-    v1 = allocate(ndarray::makeVector(_dimensions));
-    batchbb.resize(_npts, 1);
-    batchxx.resize(_npts, 1);
-    batchCovariance.resize(_npts, _npts);
-    queryCovariance.resize(_npts, 1);
+    if (numberOfNeighbors + 1 > _kdTree.getNPoints()) {
+        throw LSST_EXCEPT(lsst::pex::exceptions::RuntimeError,
+                          "Asked for more neighbors than you have data points\n");
+    }
 
-    for (i = 0; i < _npts; i++) {
-        batchCovariance(i, i) = (*_covariogram)(_kdTree.getData(i), _kdTree.getData(i)) + _lambda;
-        for (j = i + 1; j < _npts; j++) {
-            batchCovariance(i, j) = (*_covariogram)(_kdTree.getData(i), _kdTree.getData(j));
-            batchCovariance(j, i) = batchCovariance(i, j);
+    int const nIndices = indices.template getSize<0>();
+    for (int k = 0; k < nIndices; k++) {
+        if (indices[k] < 0 || indices[k] >= _kdTree.getNPoints()) {
+            throw LSST_EXCEPT(lsst::pex::exceptions::RuntimeError,
+                              "Asked to self interpolate on a point that does not exist\n");
         }
     }
-    _timer.addToIteration();
 
-    ldlt.compute(batchCovariance);
+    _timer.start();
 
-    fbar = 0.0;
-    for (i = 0; i < _npts; i++) {
-        fbar += _function[i][0];
-    }
-    fbar = fbar / T(_npts);
+    // Copy the data points, and take pointers to them, the functions and the indices,
+    // so that the threads do not share any ndarray
+    ndarray::Array<T, 2, 2> points = ndarray::allocate(ndarray::makeVector(_npts, _dimensions));
+    for (int i = 0; i < _npts; i++) {
+        points[i].deep() = _kdTree.getData(i);
+    }
+    T const *pointData = points.getData();
+    T const *functionData = _function.getData();
+    int const functionStride = _function.template getStride<0>();
+    int const *indexData = indices.getData();
+
+    int const nThreads = detail::resolveNumThreads(_numThreads);
+    auto const chunks = detail::splitRange(0, nIndices, nThreads);
+    int const nChunks = chunks.size();
+    detail::parallelFor(nChunks, nThreads, [&](int iChunk) {
+        // Each thread has its own workspace; the arithmetic is that of selfInterpolate
+        ndarray::Array<T, 1, 1> testPoint = ndarray::allocate(ndarray::makeVector(_dimensions));
+        ndarray::Array<T, 2, 2> neighborPoints =
+                ndarray::allocate(ndarray::makeVector(numberOfNeighbors, _dimensions));
+        ndarray::Array<int, 1, 1> selfNeighbors =
+                ndarray::allocate(ndarray::makeVector(numberOfNeighbors + 1));
+        ndarray::Array<double, 1, 1> selfDistances =
+                ndarray::allocate(ndarray::makeVector(numberOfNeighbors + 1));
+        std::vector<T> covarianceTestPoint(numberOfNeighbors);
+        std::vector<int> neighbors(numberOfNeighbors);
+        Matrix covariance(numberOfNeighbors, numberOfNeighbors);
+        Matrix bb(numberOfNeighbors, 1);
+        Matrix xx(numberOfNeighbors, 1);
+        Eigen::LDLT<Matrix> ldlt;
+
+        for (int k = chunks[iChunk].first; k < chunks[iChunk].second; k++) {
+            int const dex = indexData[k];
+            std::copy_n(pointData + dex * _dimensions, _dimensions, testPoint.getData());
+
+            // we don't use _useMaxMin because the data has already been normalized
+            _kdTree.findNeighbors(selfNeighbors, selfDistances, testPoint, numberOfNeighbors + 1);
+            if (selfNeighbors[0] != dex) {
+                throw LSST_EXCEPT(lsst::pex::exceptions::RuntimeError,
+                                  "Nearest neighbor search in batchSelfInterpolate did not find self\n");
+            }
 
-    for (i = 0; i < _npts; i++) {
-        batchbb(i, 0) = _function[i][0] - fbar;
-    }
-    batchxx = ldlt.solve(batchbb);
-    _timer.addToEigen();
+            // discard the point itself, as selfInterpolate does
+            for (int i = 0; i < numberOfNeighbors; i++) {
+                neighbors[i] = selfNeighbors[i + 1];
+                std::copy_n(pointData + neighbors[i] * _dimensions, _dimensions,
+                            neighborPoints.getData() + i * _dimensions);
+            }
 
-    for (ndarray::Size ii = 0; ii < nQueries; ii++) {
-        for (i = 0; i < _dimensions; i++) v1[i] = queries[ii][i];
-        if (_useMaxMin == 1) {
-            for (i = 0; i < _dimensions; i++) v1[i] = (v1[i] - _min[i]) / (_max[i] - _min[i]);
-        }
-        mu(ii) = fbar;
-        for (i = 0; i < _npts; i++) {
-            mu(ii) += batchxx(i) * (*_covariogram)(v1, _kdTree.getData(i));
-        }
-    }
-    _timer.addToIteration();
+            for (int i = 0; i < numberOfNeighbors; i++) {
+                covarianceTestPoint[i] = (*_covariogram)(testPoint, neighborPoints[i]);
 
-    for (ndarray::Size ii = 0; ii < nQueries; ii++) {
-        for (i = 0; i < _dimensions; i++) v1[i] = queries[ii][i];
-        if (_useMaxMin == 1) {
-            for (i = 0; i < _dimensions; i++) v1[i] = (v1[i] - _min[i]) / (_max[i] - _min[i]);
-        }
+                covariance(i, i) = (*_covariogram)(neighborPoints[i], neighborPoints[i]) + _lambda;
 
-        for (i = 0; i < _npts; i++) {
-            batchbb(i, 0) = (*_covariogram)(v1, _kdTree.getData(i));
-            queryCovariance(i, 0) = batchbb(i, 0);
-        }
-        batchxx = ldlt.solve(batchbb);
+                for (int j = i + 1; j < numberOfNeighbors; j++) {
+                    covariance(i, j) = (*_covariogram)(neighborPoints[i], neighborPoints[j]);
+                    covariance(j, i) = covariance(i, j);
+                }
+            }
 
-        variance[ii] = (*_covariogram)(v1, v1) + _lambda;
+            ldlt.compute(covariance);
+
+            T *muRow = mu + k * _nFunctions;
+            for (int ii = 0; ii < _nFunctions; ii++) {
+                T fbar = 0.0;
+                for (int i = 0; i < numberOfNeighbors; i++) {
+                    fbar += functionData[neighbors[i] * functionStride + ii];
+                }
+                fbar = fbar / double(numberOfNeighbors);
+
+                for (int i = 0; i < numberOfNeighbors; i++) {
+                    bb(i, 0) = functionData[neighbors[i] * functionStride + ii] - fbar;
+                }
+                xx = ldlt.solve(bb);
+
+                muRow[ii] = fbar;
+                for (int i = 0; i < numberOfNeighbors; i++) {
+                    muRow[ii] += covarianceTestPoint[i] * xx(i, 0);
+                }
+            }
 
-        for (i = 0; i < _npts; i++) {
-            variance[ii] -= queryCovariance(i, 0) * batchxx(i);
+            T var = (*_covariogram)(testPoint, testPoint) + _lambda;
+            for (int i = 0; i < numberOfNeighbors; i++) bb(i) = covarianceTestPoint[i];
+            xx = ldlt.solve(bb);
+            for (int i = 0; i < numberOfNeighbors; i++) {
+                var -= covarianceTestPoint[i] * xx(i, 0);
+            }
+            std::fill_n(variance + k * _nFunctions, _nFunctions, var * _krigingParameter);
         }
+    });
+
+    // the threads interleave the search, covariance and solution, so the time is counted as iteration
+    _timer.addToIteration();
+    _timer.addToTotal(nIndices);
+}
+
+template <typename T>
+void GaussianProcess<T>::batchInterpolate(ndarray::Array<T, 1, 1> mu, ndarray::Array<T, 1, 1> variance,
+                                          ndarray::Array<T, 2, 2> const &queries) const {
+    ndarray::Size nQueries = queries.template getSize<0>();
+
+    if (_nFunctions != 1) {
+        throw LSST_EXCEPT(lsst::pex::exceptions::RuntimeError,
+                          "Your mu and variance arrays do not have room for all of the functions "
+                          "as you are trying to interpolate\n");
+    }
 
-        variance[ii] = variance[ii] * _krigingParameter;
+    if (mu.getNumElements() != nQueries || variance.getNumElements() != nQueries) {
+        throw LSST_EXCEPT(lsst::pex::exceptions::RuntimeError,
+                          "Your mu and variance arrays do not have room for all of the points "
+                          "at which you are trying to interpolate your function.\n");
     }
 
-    _timer.addToVariance();
-    _timer.addToTotal(nQueries);
+    if (queries.template getSize<1>() != static_cast<ndarray::Size>(_dimensions)) {
+        throw LSST_EXCEPT(lsst::pex::exceptions::RuntimeError,
+                          "The points you passed to batchInterpolate are of the wrong "
+                          "dimensionality for your Gaussian Process\n");
+    }
+
+    _batchInterpolate(mu.getData(), variance.getData(), queries);
 }
 
 template <typename T>
 void GaussianProcess<T>::batchInterpolate(ndarray::Array<T, 2, 2> mu, ndarray::Array<T, 2, 2> variance,
                                           ndarray::Array<T, 2, 2> const &queries) const {
-    int i, j, ifn;
-
     ndarray::Size nQueries = queries.template getSize<0>();
 
     if (mu.template getSize<0>() != nQueries || variance.template getSize<0>() != nQueries) {
@@ -1610,93 +1682,12 @@ void GaussianProcess<T>::batchInterpolate(ndarray::Array<T, 2, 2> mu, ndarray::A
                           "wrong dimensionality.\n");
     }
 
-    T fbar;
-    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> batchCovariance, batchbb, batchxx;
-    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> queryCovariance;
-    Eigen::LDLT<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> > ldlt;
-
-    ndarray::Array<T, 1, 1> v1;
-
-    _timer.start();
-
-    v1 = allocate(ndarray::makeVector(_dimensions));
-    batchbb.resize(_npts, 1);
-    batchxx.resize(_npts, 1);
-    batchCovariance.resize(_npts, _npts);
-    queryCovariance.resize(_npts, 1);
-
-    for (i = 0; i < _npts; i++) {
-        batchCovariance(i, i) = (*_covariogram)(_kdTree.getData(i), _kdTree.getData(i)) + _lambda;
-        for (j = i + 1; j < _npts; j++) {
-            batchCovariance(i, j) = (*_covariogram)(_kdTree.getData(i), _kdTree.getData(j));
-            batchCovariance(j, i) = batchCovariance(i, j);
-        }
-    }
-
-    _timer.addToIteration();
-
-    ldlt.compute(batchCovariance);
-
-    _timer.addToEigen();
-
-    for (ifn = 0; ifn < _nFunctions; ifn++) {
-        fbar = 0.0;
-        for (i = 0; i < _npts; i++) {
-            fbar += _function[i][ifn];
-        }
-        fbar = fbar / T(_npts);
-        _timer.addToIteration();
-
-        for (i = 0; i < _npts; i++) {
-            batchbb(i, 0) = _function[i][ifn] - fbar;
-        }
-        batchxx = ldlt.solve(batchbb);
-        _timer.addToEigen();
-
-        for (ndarray::Size ii = 0; ii < nQueries; ii++) {
-            for (i = 0; i < _dimensions; i++) v1[i] = queries[ii][i];
-            if (_useMaxMin == 1) {
-                for (i = 0; i < _dimensions; i++) v1[i] = (v1[i] - _min[i]) / (_max[i] - _min[i]);
-            }
-            mu[ii][ifn] = fbar;
-            for (i = 0; i < _npts; i++) {
-                mu[ii][ifn] += batchxx(i) * (*_covariogram)(v1, _kdTree.getData(i));
-            }
-        }
-
-    }  // ifn = 0 to _nFunctions
-
-    _timer.addToIteration();
-    for (ndarray::Size ii = 0; ii < nQueries; ii++) {
-        for (i = 0; i < _dimensions; i++) v1[i] = queries[ii][i];
-        if (_useMaxMin == 1) {
-            for (i = 0; i < _dimensions; i++) v1[i] = (v1[i] - _min[i]) / (_max[i] - _min[i]);
-        }
-
-        for (i = 0; i < _npts; i++) {
-            batchbb(i, 0) = (*_covariogram)(v1, _kdTree.getData(i));
-            queryCovariance(i, 0) = batchbb(i, 0);
-        }
-        batchxx = ldlt.solve(batchbb);
-
-        variance[ii][0] = (*_covariogram)(v1, v1) + _lambda;
-
-        for (i = 0; i < _npts; i++) {
-            variance[ii][0] -= queryCovariance(i, 0) * batchxx(i);
-        }
-
-        variance[ii][0] = variance[ii][0] * _krigingParameter;
-        for (i = 1; i < _nFunctions; i++) variance[ii][i] = variance[ii][0];
-    }
-    _timer.addToVariance();
-    _timer.addToTotal(nQueries);
+    _batchInterpolate(mu.getData(), variance.getData(), queries);
 }
 
 template <typename T>
 void GaussianProcess<T>::batchInterpolate(ndarray::Array<T, 1, 1> mu,
                                           ndarray::Array<T, 2, 2> const &queries) const {
-    int i, j;
-
     ndarray::Size nQueries = queries.template getSize<0>();
 
     if (_nFunctions != 1) {
@@ -1717,65 +1708,12 @@ void GaussianProcess<T>::batchInterpolate(ndarray::Array<T, 1, 1> mu,
                           "at which you are trying to interpolate your function.\n");
     }
 
-    T fbar;
-    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> batchCovariance, batchbb, batchxx;
-    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> queryCovariance;
-    Eigen::LDLT<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> > ldlt;
-
-    ndarray::Array<T, 1, 1> v1;
-
-    _timer.start();
-
-    v1 = allocate(ndarray::makeVector(_dimensions));
-
-    batchbb.resize(_npts, 1);
-    batchxx.resize(_npts, 1);
-    batchCovariance.resize(_npts, _npts);
-    queryCovariance.resize(_npts, 1);
-
-    for (i = 0; i < _npts; i++) {
-        batchCovariance(i, i) = (*_covariogram)(_kdTree.getData(i), _kdTree.getData(i)) + _lambda;
-        for (j = i + 1; j < _npts; j++) {
-            batchCovariance(i, j) = (*_covariogram)(_kdTree.getData(i), _kdTree.getData(j));
-            batchCovariance(j, i) = batchCovariance(i, j);
-        }
-    }
-    _timer.addToIteration();
-
-    ldlt.compute(batchCovariance);
-
-    fbar = 0.0;
-    for (i = 0; i < _npts; i++) {
-        fbar += _function[i][0];
-    }
-    fbar = fbar / T(_npts);
-
-    for (i = 0; i < _npts; i++) {
-        batchbb(i, 0) = _function[i][0] - fbar;
-    }
-    batchxx = ldlt.solve(batchbb);
-    _timer.addToEigen();
-
-    for (ndarray::Size ii = 0; ii < nQueries; ii++) {
-        for (i = 0; i < _dimensions; i++) v1[i] = queries[ii][i];
-        if (_useMaxMin == 1) {
-            for (i = 0; i < _dimensions; i++) v1[i] = (v1[i] - _min[i]) / (_max[i] - _min[i]);
-        }
-
-        mu(ii) = fbar;
-        for (i = 0; i < _npts; i++) {
-            mu(ii) += batchxx(i) * (*_covariogram)(v1, _kdTree.getData(i));
-        }
-    }
-    _timer.addToIteration();
-    _timer.addToTotal(nQueries);
+    _batchInterpolate(mu.getData(), nullptr, queries);
 }
 
 template <typename T>
 void GaussianProcess<T>::batchInterpolate(ndarray::Array<T, 2, 2> mu,
                                           ndarray::Array<T, 2, 2> const &queries) const {
-    int i, j, ifn;
-
     ndarray::Size nQueries = queries.template getSize<0>();
 
     if (mu.template getSize<0>() != nQueries) {
@@ -1796,65 +1734,200 @@ void GaussianProcess<T>::batchInterpolate(ndarray::Array<T, 2, 2> mu,
                           "have the correct dimensionality.\n");
     }
 
-    T fbar;
-    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> batchCovariance, batchbb, batchxx;
-    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> queryCovariance;
-    Eigen::LDLT<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> > ldlt;
+    _batchInterpolate(mu.getData(), nullptr, queries);
+}
 
-    ndarray::Array<T, 1, 1> v1;
+template <typename T>
+void GaussianProcess<T>::_batchInterpolate(T *mu, T *variance, ndarray::Array<T, 2, 2> const &queries) const {
+    if (_approximationRank > 0 && _approximationRank < _npts) {
+        _batchInterpolateApproximate(mu, variance, queries);
+        return;
+    }
 
-    _timer.start();
+    using Matrix = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+    using Vector = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+    using RowVector = Eigen::Matrix<T, 1, Eigen::Dynamic>;
 
-    v1 = allocate(ndarray::makeVector(_dimensions));
+    int const nQueries = queries.template getSize<0>();
 
-    batchbb.resize(_npts, 1);
-    batchxx.resize(_npts, 1);
-    batchCovariance.resize(_npts, _npts);
-    queryCovariance.resize(_npts, 1);
+    _timer.start();
 
-    for (i = 0; i < _npts; i++) {
-        batchCovariance(i, i) = (*_covariogram)(_kdTree.getData(i), _kdTree.getData(i)) + _lambda;
-        for (j = i + 1; j < _npts; j++) {
-            batchCovariance(i, j) = (*_covariogram)(_kdTree.getData(i), _kdTree.getData(j));
-            batchCovariance(j, i) = batchCovariance(i, j);
-        }
+    // Gather the data points into one array, so the covariogram can relate each point to all of them
+    ndarray::Array<T, 2, 2> points = ndarray::allocate(ndarray::makeVector(_npts, _dimensions));
+    for (int i = 0; i < _npts; i++) {
+        points[i].deep() = _kdTree.getData(i);
     }
 
+    Matrix batchCovariance(_npts, _npts);
+    ndarray::Array<T, 1, 1> covarianceRow = ndarray::allocate(ndarray::makeVector(_npts));
+    for (int i = 0; i < _npts; i++) {
+        _covariogram->evaluate(covarianceRow, points[i], points);
+        batchCovariance.row(i) = ndarray::asEigenMatrix(covarianceRow).transpose();
+        batchCovariance(i, i) += _lambda;
+    }
     _timer.addToIteration();
 
-    ldlt.compute(batchCovariance);
+    Eigen::LDLT<Matrix> ldlt(batchCovariance);
 
+    // Solve for the weights of all of the functions at once
+    RowVector fbar = RowVector::Zero(_nFunctions);
+    Matrix batchbb(_npts, _nFunctions);
+    for (int i = 0; i < _npts; i++) {
+        for (int ifn = 0; ifn < _nFunctions; ifn++) {
+            fbar[ifn] += _function[i][ifn];
+        }
+    }
+    fbar /= T(_npts);
+    for (int i = 0; i < _npts; i++) {
+        for (int ifn = 0; ifn < _nFunctions; ifn++) {
+            batchbb(i, ifn) = _function[i][ifn] - fbar[ifn];
+        }
+    }
+    Matrix const batchxx = ldlt.solve(batchbb);
     _timer.addToEigen();
 
-    for (ifn = 0; ifn < _nFunctions; ifn++) {
-        fbar = 0.0;
-        for (i = 0; i < _npts; i++) {
-            fbar += _function[i][ifn];
+    int const nThreads = detail::resolveNumThreads(_numThreads);
+    auto const chunks = detail::splitRange(0, nQueries, nThreads);
+    int const nChunks = chunks.size();
+    detail::parallelFor(nChunks, nThreads, [&](int iChunk) {
+        // Each thread has its own workspace
+        ndarray::Array<T, 1, 1> v1 = ndarray::allocate(ndarray::makeVector(_dimensions));
+        ndarray::Array<T, 1, 1> queryCovariance = ndarray::allocate(ndarray::makeVector(_npts));
+        auto const kk = ndarray::asEigenMatrix(queryCovariance);
+        Vector xx(_npts);
+
+        for (int ii = chunks[iChunk].first; ii < chunks[iChunk].second; ii++) {
+            for (int i = 0; i < _dimensions; i++) v1[i] = queries[ii][i];
+            if (_useMaxMin == 1) {
+                for (int i = 0; i < _dimensions; i++) v1[i] = (v1[i] - _min[i]) / (_max[i] - _min[i]);
+            }
+            _covariogram->evaluate(queryCovariance, v1, points);
+
+            Eigen::Map<RowVector>(mu + ii * _nFunctions, _nFunctions) = fbar + kk.transpose() * batchxx;
+
+            if (variance) {
+                xx = ldlt.solve(kk);
+                T const var = ((*_covariogram)(v1, v1) + _lambda - kk.dot(xx)) * _krigingParameter;
+                std::fill_n(variance + ii * _nFunctions, _nFunctions, var);
+            }
         }
-        fbar = fbar / T(_npts);
+    });
 
+    if (variance) {
+        _timer.addToVariance();
+    } else {
         _timer.addToIteration();
+    }
+    _timer.addToTotal(nQueries);
+}
 
-        for (i = 0; i < _npts; i++) {
-            batchbb(i, 0) = _function[i][ifn] - fbar;
+template <typename T>
+void GaussianProcess<T>::_batchInterpolateApproximate(T *mu, T *variance,
+                                                      ndarray::Array<T, 2, 2> const &queries) const {
+    using Matrix = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+    using Vector = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+    using RowVector = Eigen::Matrix<T, 1, Eigen::Dynamic>;
+
+    int const nQueries = queries.template getSize<0>();
+    int const rank = _approximationRank;
+
+    _timer.start();
+
+    // Choose the inducing points from the data by farthest-point sampling, so that they cover it evenly
+    ndarray::Array<T, 2, 2> inducing = ndarray::allocate(ndarray::makeVector(rank, _dimensions));
+    std::vector<double> minDistance(_npts, std::numeric_limits<double>::infinity());
+    for (int m = 0, next = 0; m < rank; m++) {
+        inducing[m].deep() = _kdTree.getData(next);
+        double maxDistance = -1.0;
+        for (int i = 0; i < _npts; i++) {
+            double dd = 0.0;
+            for (int j = 0; j < _dimensions; j++) {
+                dd += (_kdTree.getData(i, j) - inducing[m][j]) * (_kdTree.getData(i, j) - inducing[m][j]);
+            }
+            minDistance[i] = std::min(minDistance[i], dd);
+            if (minDistance[i] > maxDistance) {
+                maxDistance = minDistance[i];
+                next = i;
+            }
+        }
+    }
+
+    // Factor the covariance of the inducing points, K_mm = L L^T; the jitter keeps it positive-definite
+    Matrix inducingCovariance(rank, rank);
+    ndarray::Array<T, 1, 1> kk = ndarray::allocate(ndarray::makeVector(rank));
+    for (int m = 0; m < rank; m++) {
+        _covariogram->evaluate(kk, inducing[m], inducing);
+        inducingCovariance.row(m) = ndarray::asEigenMatrix(kk).transpose();
+    }
+    inducingCovariance.diagonal().array() += T(1.0e-8) * inducingCovariance.diagonal().mean();
+    Eigen::LLT<Matrix> const llt(inducingCovariance);
+
+    RowVector fbar = RowVector::Zero(_nFunctions);
+    for (int i = 0; i < _npts; i++) {
+        for (int ifn = 0; ifn < _nFunctions; ifn++) {
+            fbar[ifn] += _function[i][ifn];
         }
-        batchxx = ldlt.solve(batchbb);
-        _timer.addToEigen();
+    }
+    fbar /= T(_npts);
+
+    // Accumulate B = I + V Lambda^{-1} V^T and V Lambda^{-1} (f - fbar) one data point at a time, where
+    // V = L^{-1} K_mn and Lambda = diag(K_nn - V^T V) + lambda; this needs no O(_npts) workspace
+    Matrix bb = Matrix::Identity(rank, rank);
+    Matrix projected = Matrix::Zero(rank, _nFunctions);
+    Vector vv(rank);
+    RowVector residual(_nFunctions);
+    for (int i = 0; i < _npts; i++) {
+        ndarray::Array<T, 1, 1> const point = _kdTree.getData(i);
+        _covariogram->evaluate(kk, point, inducing);
+        vv = llt.matrixL().solve(ndarray::asEigenMatrix(kk));
+        T const diagonal = std::max((*_covariogram)(point, point) - vv.squaredNorm(), T(0)) + _lambda;
+        bb.template selfadjointView<Eigen::Lower>().rankUpdate(vv, T(1) / diagonal);
+        for (int ifn = 0; ifn < _nFunctions; ifn++) {
+            residual[ifn] = _function[i][ifn] - fbar[ifn];
+        }
+        projected.noalias() += (vv / diagonal) * residual;
+    }
+    _timer.addToIteration();
 
-        for (ndarray::Size ii = 0; ii < nQueries; ii++) {
-            for (i = 0; i < _dimensions; i++) v1[i] = queries[ii][i];
+    // mu = fbar + k_m^T L^{-T} B^{-1} V Lambda^{-1} (f - fbar)
+    Eigen::LLT<Matrix> const lltB(bb);
+    Matrix const weights = llt.matrixU().solve(lltB.solve(projected));
+    _timer.addToEigen();
+
+    int const nThreads = detail::resolveNumThreads(_numThreads);
+    auto const chunks = detail::splitRange(0, nQueries, nThreads);
+    int const nChunks = chunks.size();
+    detail::parallelFor(nChunks, nThreads, [&](int iChunk) {
+        // Each thread has its own workspace
+        ndarray::Array<T, 1, 1> v1 = ndarray::allocate(ndarray::makeVector(_dimensions));
+        ndarray::Array<T, 1, 1> queryCovariance = ndarray::allocate(ndarray::makeVector(rank));
+        auto const kq = ndarray::asEigenMatrix(queryCovariance);
+        Vector aa(rank);
+
+        for (int ii = chunks[iChunk].first; ii < chunks[iChunk].second; ii++) {
+            for (int i = 0; i < _dimensions; i++) v1[i] = queries[ii][i];
             if (_useMaxMin == 1) {
-                for (i = 0; i < _dimensions; i++) v1[i] = (v1[i] - _min[i]) / (_max[i] - _min[i]);
+                for (int i = 0; i < _dimensions; i++) v1[i] = (v1[i] - _min[i]) / (_max[i] - _min[i]);
             }
+            _covariogram->evaluate(queryCovariance, v1, inducing);
 
-            mu[ii][ifn] = fbar;
-            for (i = 0; i < _npts; i++) {
-                mu[ii][ifn] += batchxx(i) * (*_covariogram)(v1, _kdTree.getData(i));
+            Eigen::Map<RowVector>(mu + ii * _nFunctions, _nFunctions) = fbar + kq.transpose() * weights;
+
+            if (variance) {
+                // k_** - k_m^T K_mm^{-1} k_m + k_m^T (K_mm + K_mn Lambda^{-1} K_nm)^{-1} k_m
+                aa = llt.matrixL().solve(kq);
+                T const reduction = aa.squaredNorm() - lltB.matrixL().solve(aa).squaredNorm();
+                T const var = ((*_covariogram)(v1, v1) + _lambda - reduction) * _krigingParameter;
+                std::fill_n(variance + ii * _nFunctions, _nFunctions, var);
             }
         }
+    });
 
-    }  // ifn = 0 through _nFunctions
-
+    if (variance) {
+        _timer.addToVariance();
+    } else {
+        _timer.addToIteration();
+    }
     _timer.addToTotal(nQueries);
 }
 
@@ -1977,6 +2050,24 @@ void GaussianProcess<T>::setLambda(T lambda) {
     _lambda = lambda;
 }
 
+template <typename T>
+void GaussianProcess<T>::setApproximationRank(int rank) {
+    if (rank < 0) {
+        throw LSST_EXCEPT(lsst::pex::exceptions::InvalidParameterError,
+                          "The approximation rank must be >= 0 (0 means no approximation)");
+    }
+    _approximationRank = rank;
+}
+
+template <typename T>
+void GaussianProcess<T>::setNumThreads(int numThreads) {
+    if (numThreads < 0) {
+        throw LSST_EXCEPT(lsst::pex::exceptions::InvalidParameterError,
+                          "numThreads must be >= 0 (0 means one per hardware thread)");
+    }
+    _numThreads = numThreads;
+}
+
 template <typename T>
 GaussianProcessTimer &GaussianProcess<T>::getTimes() const {
     return _timer;
@@ -1993,6 +2084,14 @@ T Covariogram<T>::operator()(ndarray::Array<const T, 1, 1> const &p1,
     return T(1.0);
 }
 
+template <typename T>
+void Covariogram<T>::evaluate(ndarray::Array<T, 1, 1> result, ndarray::Array<const T, 1, 1> const &point,
+                              ndarray::Array<const T, 2, 2> const &points) const {
+    for (ndarray::Size i = 0; i < points.template getSize<0>(); i++) {
+        result[i] = (*this)(point, points[i]);
+    }
+}
+
 template <typename T>
 SquaredExpCovariogram<T>::~SquaredExpCovariogram() = default;
 
@@ -2018,6 +2117,16 @@ T SquaredExpCovariogram<T>::operator()(ndarray::Array<const T, 1, 1> const &p1,
     return T(exp(-0.5 * d));
 }
 
+template <typename T>
+void SquaredExpCovariogram<T>::evaluate(ndarray::Array<T, 1, 1> result,
+                                        ndarray::Array<const T, 1, 1> const &point,
+                                        ndarray::Array<const T, 2, 2> const &points) const {
+    auto const p = ndarray::asEigenMatrix(point);
+    Eigen::Array<T, Eigen::Dynamic, 1> const d =
+            (ndarray::asEigenMatrix(points).rowwise() - p.transpose()).rowwise().squaredNorm();
+    ndarray::asEigenArray(result) = (d * T(-0.5 / _ellSquared)).exp();
+}
+
 template <typename T>
 NeuralNetCovariogram<T>::~NeuralNetCovariogram() = default;
 
@@ -2049,6 +2158,21 @@ T NeuralNetCovariogram<T>::operator()(ndarray::Array<const T, 1, 1> const &p1,
     return T(2.0 * (::asin(arg)) / 3.141592654);
 }
 
+template <typename T>
+void NeuralNetCovariogram<T>::evaluate(ndarray::Array<T, 1, 1> result,
+                                       ndarray::Array<const T, 1, 1> const &point,
+                                       ndarray::Array<const T, 2, 2> const &points) const {
+    auto const p = ndarray::asEigenMatrix(point);
+    auto const x = ndarray::asEigenMatrix(points);
+
+    T const denom1 = 1.0 + 2.0 * _sigma0 + 2.0 * _sigma1 * p.squaredNorm();
+    Eigen::Array<T, Eigen::Dynamic, 1> const num = 2.0 * _sigma0 + 2.0 * _sigma1 * (x * p).array();
+    Eigen::Array<T, Eigen::Dynamic, 1> const denom2 =
+            1.0 + 2.0 * _sigma0 + 2.0 * _sigma1 * x.rowwise().squaredNorm().array();
+
+    ndarray::asEigenArray(result) = T(2.0 / 3.141592654) * (num / (denom1 * denom2).sqrt()).asin();
+}
+
 template <typename T>
 void NeuralNetCovariogram<T>::setSigma0(double sigma0) {
     _sigma0 = sigma0;
@@ -0,0 +1,168 @@
+// -*- lsst-c++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include <mutex>
+
+#include "lsst/afw/math/Instrumentation.h"
+
+namespace lsst {
+namespace afw {
+namespace math {
+
+namespace detail {
+std::atomic<bool> instrumentationEnabled(false);
+}  // namespace detail
+
+namespace {
+
+struct Registry {
+    std::mutex mutex;
+    // Counters are never removed, so references to them stay valid
+    std::map<std::string, std::unique_ptr<InstrumentationCounter>> counters;
+    std::map<std::string, std::unique_ptr<MemoryCounter>> memoryCounters;
+};
+
+Registry &getRegistry() {
+    // Leaked deliberately, so that counters may be updated from static destructors
+    static Registry *registry = new Registry;
+    return *registry;
+}
+
+thread_local MemoryCounter *memoryScopeCounter = nullptr;
+
+}  // namespace
+
+namespace detail {
+
+MemoryCounter *getMemoryScopeCounter() noexcept { return memoryScopeCounter; }
+
+MemoryCounter *setMemoryScopeCounter(MemoryCounter *counter) noexcept {
+    MemoryCounter *previous = memoryScopeCounter;
+    memoryScopeCounter = counter;
+    return previous;
+}
+
+}  // namespace detail
+
+void setInstrumentationEnabled(bool enabled) noexcept {
+    detail::instrumentationEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+InstrumentationRecord InstrumentationCounter::get() const noexcept {
+    InstrumentationRecord result;
+    result.count = _count.load(std::memory_order_relaxed);
+    result.time = 1e-9 * _nanoseconds.load(std::memory_order_relaxed);
+    return result;
+}
+
+void InstrumentationCounter::reset() noexcept {
+    _count.store(0, std::memory_order_relaxed);
+    _nanoseconds.store(0, std::memory_order_relaxed);
+}
+
+InstrumentationCounter &getInstrumentationCounter(std::string const &name) {
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto &counter = registry.counters[name];
+    if (!counter) {
+        counter = std::make_unique<InstrumentationCounter>(name);
+    }
+    return *counter;
+}
+
+std::map<std::string, InstrumentationRecord> getInstrumentationSnapshot() {
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::map<std::string, InstrumentationRecord> result;
+    for (auto const &entry : registry.counters) {
+        result.emplace(entry.first, entry.second->get());
+    }
+    return result;
+}
+
+void resetInstrumentation() {
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (auto &entry : registry.counters) {
+        entry.second->reset();
+    }
+    for (auto &entry : registry.memoryCounters) {
+        entry.second->resetPeak();
+    }
+}
+
+void MemoryCounter::allocate(std::size_t bytes) noexcept {
+    std::int64_t const size = static_cast<std::int64_t>(bytes);
+    std::int64_t const current = _current.fetch_add(size, std::memory_order_relaxed) + size;
+    _allocations.fetch_add(1, std::memory_order_relaxed);
+    std::int64_t peak = _peak.load(std::memory_order_relaxed);
+    while (current > peak && !_peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+    }
+}
+
+MemoryRecord MemoryCounter::get() const noexcept {
+    MemoryRecord result;
+    result.current = _current.load(std::memory_order_relaxed);
+    result.peak = _peak.load(std::memory_order_relaxed);
+    result.allocations = _allocations.load(std::memory_order_relaxed);
+    return result;
+}
+
+void MemoryCounter::resetPeak() noexcept {
+    _peak.store(_current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    _allocations.store(0, std::memory_order_relaxed);
+}
+
+MemoryCounter &getMemoryCounter(std::string const &name) {
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto &counter = registry.memoryCounters[name];
+    if (!counter) {
+        counter = std::make_unique<MemoryCounter>(name);
+    }
+    return *counter;
+}
+
+std::map<std::string, MemoryRecord> getMemorySnapshot() {
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::map<std::string, MemoryRecord> result;
+    for (auto const &entry : registry.memoryCounters) {
+        result.emplace(entry.first, entry.second->get());
+    }
+    return result;
+}
+
+void resetMemoryPeaks() {
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (auto &entry : registry.memoryCounters) {
+        entry.second->resetPeak();
+    }
+}
+
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
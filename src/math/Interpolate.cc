@@ -176,6 +176,9 @@ public:
     ~InterpolateGsl() override;
     double interpolate(double const x) const override;
 
+protected:
+    void doInterpolate(double const *x, std::size_t n, double *out) const override;
+
 private:
     InterpolateGsl(std::vector<double> const &x, std::vector<double> const &y,
                    Interpolate::Style const style);
@@ -183,6 +186,11 @@ private:
     ::gsl_interp_type const *_interpType;
     ::gsl_interp_accel *_acc;
     ::gsl_interp *_interp;
+    // Every style that GSL provides is a piecewise cubic, so within interval i (_x[i] <= x < _x[i + 1])
+    // the interpolant is _y[i] + dx*(_b[i] + dx*(_c[i] + dx*_d[i])) with dx = x - _x[i]
+    std::vector<double> _b;
+    std::vector<double> _c;
+    std::vector<double> _d;
 };
 
 InterpolateGsl::InterpolateGsl(std::vector<double> const &x,   ///< the x-values of points
@@ -214,6 +222,22 @@ InterpolateGsl::InterpolateGsl(std::vector<double> const &x,   ///< the x-values
                 pex::exceptions::RuntimeError,
                 str(boost::format("gsl_interp_init failed: %s [%d]") % ::gsl_strerror(status) % status));
     }
+    /*
+     * Extract the polynomial coefficients of each interval, for use by doInterpolate.  At an interval's
+     * lower end GSL's first and second derivatives are exactly the linear and (twice the) quadratic
+     * coefficients it uses; the cubic coefficient follows from the second derivative at the midpoint
+     */
+    std::size_t const nInterval = _x.size() - 1;
+    _b.resize(nInterval);
+    _c.resize(nInterval);
+    _d.resize(nInterval);
+    for (std::size_t i = 0; i < nInterval; ++i) {
+        double const h = _x[i + 1] - _x[i];
+        _b[i] = ::gsl_interp_eval_deriv(_interp, &_x[0], &_y[0], _x[i], _acc);
+        _c[i] = 0.5 * ::gsl_interp_eval_deriv2(_interp, &_x[0], &_y[0], _x[i], _acc);
+        double const midDeriv2 = ::gsl_interp_eval_deriv2(_interp, &_x[0], &_y[0], _x[i] + 0.5 * h, _acc);
+        _d[i] = (midDeriv2 - 2 * _c[i]) / (3 * h);
+    }
 }
 
 InterpolateGsl::~InterpolateGsl() {
@@ -258,22 +282,47 @@ double InterpolateGsl::interpolate(double const xInterp) const {
     return ::gsl_interp_eval(_interp, &_x[0], &_y[0], xInterp, _acc);
 }
 
-Interpolate::Style stringToInterpStyle(std::string const &style) {
-    static std::map<std::string, Interpolate::Style> gslInterpTypeStrings;
-    if (gslInterpTypeStrings.empty()) {
-        gslInterpTypeStrings["CONSTANT"] = Interpolate::CONSTANT;
-        gslInterpTypeStrings["LINEAR"] = Interpolate::LINEAR;
-        gslInterpTypeStrings["CUBIC_SPLINE"] = Interpolate::CUBIC_SPLINE;
-        gslInterpTypeStrings["NATURAL_SPLINE"] = Interpolate::NATURAL_SPLINE;
-        gslInterpTypeStrings["CUBIC_SPLINE_PERIODIC"] = Interpolate::CUBIC_SPLINE_PERIODIC;
-        gslInterpTypeStrings["AKIMA_SPLINE"] = Interpolate::AKIMA_SPLINE;
-        gslInterpTypeStrings["AKIMA_SPLINE_PERIODIC"] = Interpolate::AKIMA_SPLINE_PERIODIC;
+void InterpolateGsl::doInterpolate(double const *x, std::size_t n, double *out) const {
+    std::size_t const nInterval = _b.size();
+    double const xMin = _x.front();
+    double const xMax = _x.back();
+    std::size_t i = 0;  // the interval containing the previous point
+    for (std::size_t k = 0; k < n; ++k) {
+        double const xInterp = x[k];
+        if (!(xInterp >= xMin && xInterp <= xMax)) {
+            out[k] = interpolate(xInterp);  // NaN, or extrapolating
+            continue;
+        }
+        if (xInterp < _x[i] || xInterp >= _x[i + 1]) {
+            if (i + 2 <= nInterval && xInterp >= _x[i + 1] && xInterp < _x[i + 2]) {
+                ++i;  // the next interval; the common case for sorted points
+            } else {
+                std::size_t const upper = std::upper_bound(_x.begin(), _x.end(), xInterp) - _x.begin();
+                i = std::min(upper - 1, nInterval - 1);  // xInterp == xMax belongs to the last interval
+            }
+        }
+        double const dx = xInterp - _x[i];
+        out[k] = _y[i] + dx * (_b[i] + dx * (_c[i] + dx * _d[i]));
     }
+}
 
-    if (gslInterpTypeStrings.find(style) == gslInterpTypeStrings.end()) {
+Interpolate::Style stringToInterpStyle(std::string const &style) {
+    // initialised once, in a thread-safe way, and never modified
+    static std::map<std::string, Interpolate::Style> const gslInterpTypeStrings = {
+            {"CONSTANT", Interpolate::CONSTANT},
+            {"LINEAR", Interpolate::LINEAR},
+            {"CUBIC_SPLINE", Interpolate::CUBIC_SPLINE},
+            {"NATURAL_SPLINE", Interpolate::NATURAL_SPLINE},
+            {"CUBIC_SPLINE_PERIODIC", Interpolate::CUBIC_SPLINE_PERIODIC},
+            {"AKIMA_SPLINE", Interpolate::AKIMA_SPLINE},
+            {"AKIMA_SPLINE_PERIODIC", Interpolate::AKIMA_SPLINE_PERIODIC},
+    };
+
+    auto const found = gslInterpTypeStrings.find(style);
+    if (found == gslInterpTypeStrings.end()) {
         throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "Interp style not found: " + style);
     }
-    return gslInterpTypeStrings[style];
+    return found->second;
 }
 
 Interpolate::Style lookupMaxInterpStyle(int const n) {
@@ -282,51 +331,52 @@ Interpolate::Style lookupMaxInterpStyle(int const n) {
     } else if (n > 4) {
         return Interpolate::AKIMA_SPLINE;
     } else {
-        static std::vector<Interpolate::Style> styles;
-        if (styles.empty()) {
-            styles.resize(5);
-
-            styles[0] = Interpolate::UNKNOWN;  // impossible to reach as we check for n < 1
-            styles[1] = Interpolate::CONSTANT;
-            styles[2] = Interpolate::LINEAR;
-            styles[3] = Interpolate::CUBIC_SPLINE;
-            styles[4] = Interpolate::CUBIC_SPLINE;
-        }
+        static std::vector<Interpolate::Style> const styles = {
+                Interpolate::UNKNOWN,  // impossible to reach as we check for n < 1
+                Interpolate::CONSTANT,
+                Interpolate::LINEAR,
+                Interpolate::CUBIC_SPLINE,
+                Interpolate::CUBIC_SPLINE,
+        };
         return styles[n];
     }
 }
 
-std::vector<double> Interpolate::interpolate(std::vector<double> const &x) const {
-    size_t const num = x.size();
-    std::vector<double> out(num);
-    for (size_t i = 0; i < num; ++i) {
+void Interpolate::doInterpolate(double const *x, std::size_t n, double *out) const {
+    for (std::size_t i = 0; i < n; ++i) {
         out[i] = interpolate(x[i]);
     }
+}
+
+std::vector<double> Interpolate::interpolate(std::vector<double> const &x) const {
+    std::vector<double> out(x.size());
+    doInterpolate(x.data(), x.size(), out.data());
     return out;
 }
 
 ndarray::Array<double, 1> Interpolate::interpolate(ndarray::Array<double const, 1> const &x) const {
     int const num = x.getShape()[0];
-    ndarray::Array<double, 1> out = ndarray::allocate(ndarray::makeVector(num));
-    for (int i = 0; i < num; ++i) {
-        std::cout << "Interpolating " << x[i] << std::endl;
-        out[i] = interpolate(x[i]);
+    ndarray::Array<double, 1, 1> out = ndarray::allocate(ndarray::makeVector(num));
+    if (x.getStrides()[0] == 1) {
+        doInterpolate(x.getData(), num, out.getData());
+    } else {
+        std::vector<double> const xContiguous(x.begin(), x.end());
+        doInterpolate(xContiguous.data(), num, out.getData());
     }
     return out;
 }
 
 int lookupMinInterpPoints(Interpolate::Style const style) {
-    static std::vector<int> minPoints;
-    if (minPoints.empty()) {
-        minPoints.resize(Interpolate::NUM_STYLES);
-        minPoints[Interpolate::CONSTANT] = 1;
-        minPoints[Interpolate::LINEAR] = 2;
-        minPoints[Interpolate::NATURAL_SPLINE] = 3;
-        minPoints[Interpolate::CUBIC_SPLINE] = 3;
-        minPoints[Interpolate::CUBIC_SPLINE_PERIODIC] = 3;
-        minPoints[Interpolate::AKIMA_SPLINE] = 5;
-        minPoints[Interpolate::AKIMA_SPLINE_PERIODIC] = 5;
-    }
+    // indexed by style
+    static std::vector<int> const minPoints = {
+            1,  // CONSTANT
+            2,  // LINEAR
+            3,  // NATURAL_SPLINE
+            3,  // CUBIC_SPLINE
+            3,  // CUBIC_SPLINE_PERIODIC
+            5,  // AKIMA_SPLINE
+            5,  // AKIMA_SPLINE_PERIODIC
+    };
 
     if (style >= 0 && style < Interpolate::NUM_STYLES) {
         return minPoints[style];
@@ -21,7 +21,13 @@
  * the GNU General Public License along with this program.  If not,
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <map>
+#include <mutex>
 #include <sstream>
+#include <tuple>
 
 #include "boost/format.hpp"
 
@@ -39,6 +45,99 @@ template std::shared_ptr<math::Kernel> table::io::PersistableFacade<math::Kernel
 
 namespace math {
 
+/*
+ * A bounded, least-recently-used cache of kernel images, guarded by a mutex
+ */
+class Kernel::ImageCache {
+public:
+    ImageCache(int maxSize, double positionQuantum)
+            : _maxSize(maxSize), _positionQuantum(positionQuantum), _nHits(0), _nMisses(0) {}
+
+    int getMaxSize() const { return _maxSize; }
+    double getPositionQuantum() const { return _positionQuantum; }
+
+    int size() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return static_cast<int>(_entryList.size());
+    }
+    std::size_t getNHits() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _nHits;
+    }
+    std::size_t getNMisses() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _nMisses;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entryMap.clear();
+        _entryList.clear();
+        _nHits = 0;
+        _nMisses = 0;
+    }
+
+    double computeImage(Kernel const &kernel, image::Image<Pixel> &image, bool doNormalize, double x,
+                        double y) {
+        if (_positionQuantum > 0) {
+            x = std::round(x / _positionQuantum) * _positionQuantum;
+            y = std::round(y / _positionQuantum) * _positionQuantum;
+        }
+        Key key{x, y, doNormalize, image.getWidth(), image.getHeight(),
+                std::vector<double>(kernel.getNKernelParameters())};
+        kernel.computeKernelParametersFromSpatialModel(key.kernelParams, x, y);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto const mapIter = _entryMap.find(key);
+        if (mapIter != _entryMap.end()) {
+            ++_nHits;
+            _entryList.splice(_entryList.begin(), _entryList, mapIter->second);
+            image.assign(*mapIter->second->image);
+            return mapIter->second->kernelSum;
+        }
+        ++_nMisses;
+        kernel.setKernelParametersFromSpatialModel(x, y);
+        double const kernelSum = kernel.doComputeImage(image, doNormalize);
+        _entryList.push_front(Entry{key, std::make_shared<image::Image<Pixel>>(image, true), kernelSum});
+        _entryMap[key] = _entryList.begin();
+        if (static_cast<int>(_entryList.size()) > _maxSize) {
+            _entryMap.erase(_entryList.back().key);
+            _entryList.pop_back();
+        }
+        return kernelSum;
+    }
+
+private:
+    struct Key {
+        double x;
+        double y;
+        bool doNormalize;
+        int width;
+        int height;
+        std::vector<double> kernelParams;
+
+        bool operator<(Key const &other) const {
+            return std::tie(x, y, doNormalize, width, height, kernelParams) <
+                   std::tie(other.x, other.y, other.doNormalize, other.width, other.height,
+                            other.kernelParams);
+        }
+    };
+    struct Entry {
+        Key key;
+        std::shared_ptr<image::Image<Pixel>> image;
+        double kernelSum;
+    };
+    using EntryList = std::list<Entry>;  // most recently used first
+
+    int const _maxSize;
+    double const _positionQuantum;
+    mutable std::mutex _mutex;
+    EntryList _entryList;
+    std::map<Key, EntryList::iterator> _entryMap;
+    std::size_t _nHits;
+    std::size_t _nMisses;
+};
+
 generic_kernel_tag generic_kernel_tag_;  ///< Used as default value in argument lists
 deltafunction_kernel_tag deltafunction_kernel_tag_;
 ///< Used as default value in argument lists
@@ -82,7 +181,7 @@ double Kernel::computeImage(image::Image<Pixel> &image, bool doNormalize, double
     }
     image.setXY0(-_ctrX, -_ctrY);
     if (this->isSpatiallyVarying()) {
-        this->setKernelParametersFromSpatialModel(x, y);
+        return computeSpatiallyVaryingImage(image, doNormalize, x, y);
     }
     return doComputeImage(image, doNormalize);
 }
@@ -182,6 +281,37 @@ lsst::geom::Box2I Kernel::shrinkBBox(lsst::geom::Box2I const &bbox) const {
             lsst::geom::Extent2I(bbox.getWidth() + 1 - getWidth(), bbox.getHeight() + 1 - getHeight()));
 }
 
+void Kernel::setImageCache(int maxSize, double positionQuantum) {
+    if (maxSize < 0 || positionQuantum < 0) {
+        std::ostringstream os;
+        os << "maxSize = " << maxSize << " and/or positionQuantum = " << positionQuantum << " < 0";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+    if (maxSize == 0) {
+        _imageCache.reset();
+    } else {
+        _imageCache = std::make_shared<ImageCache>(maxSize, positionQuantum);
+    }
+}
+
+int Kernel::getImageCacheMaxSize() const { return _imageCache ? _imageCache->getMaxSize() : 0; }
+
+double Kernel::getImageCachePositionQuantum() const {
+    return _imageCache ? _imageCache->getPositionQuantum() : 0.0;
+}
+
+int Kernel::getImageCacheSize() const { return _imageCache ? _imageCache->size() : 0; }
+
+std::size_t Kernel::getImageCacheHits() const { return _imageCache ? _imageCache->getNHits() : 0; }
+
+std::size_t Kernel::getImageCacheMisses() const { return _imageCache ? _imageCache->getNMisses() : 0; }
+
+void Kernel::clearImageCache() {
+    if (_imageCache) {
+        _imageCache->clear();
+    }
+}
+
 std::string Kernel::toString(std::string const &prefix) const {
     std::ostringstream os;
     os << prefix << "Kernel:" << std::endl;
@@ -208,6 +338,47 @@ void Kernel::toFile(std::string fileName) const {
 
 //
 // Protected Member Functions
+
+ndarray::Array<double, 3, 3> Kernel::computeKernelParametersOnGrid(
+        ndarray::Array<double const, 1> const &x, ndarray::Array<double const, 1> const &y) const {
+    int const nParams = getNKernelParameters();
+    int const nx = x.getSize<0>();
+    int const ny = y.getSize<0>();
+    ndarray::Array<double, 3, 3> result = ndarray::allocate(nParams, ny, nx);
+    if (!isSpatiallyVarying()) {
+        std::vector<double> const kernelParams = getKernelParameters();
+        for (int ii = 0; ii < nParams; ++ii) {
+            std::fill_n(result[ii].getData(), nx * ny, kernelParams[ii]);
+        }
+        return result;
+    }
+    for (int ii = 0; ii < nParams; ++ii) {
+        ndarray::Array<double, 2, 2> const values = _spatialFunctionList[ii]->evaluateGrid(x, y);
+        std::copy_n(values.getData(), nx * ny, result[ii].getData());
+    }
+    return result;
+}
+
+double Kernel::computeImageFromKernelParameters(image::Image<Pixel> &image, bool doNormalize,
+                                                std::vector<double> const &kernelParams) const {
+    if (image.getDimensions() != this->getDimensions()) {
+        std::ostringstream os;
+        os << "image dimensions = ( " << image.getWidth() << ", " << image.getHeight() << ") != ("
+           << this->getWidth() << ", " << this->getHeight() << ") = kernel dimensions";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+    if (kernelParams.size() != this->getNKernelParameters()) {
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError,
+                          (boost::format("kernelParams has %d entries instead of %d") % kernelParams.size() %
+                           this->getNKernelParameters())
+                                  .str());
+    }
+    image.setXY0(-_ctrX, -_ctrY);
+    for (unsigned int ii = 0; ii < kernelParams.size(); ++ii) {
+        this->setKernelParameter(ii, kernelParams[ii]);
+    }
+    return doComputeImage(image, doNormalize);
+}
 //
 
 void Kernel::setKernelParameter(unsigned int, double) const {
@@ -221,6 +392,15 @@ void Kernel::setKernelParametersFromSpatialModel(double x, double y) const {
     }
 }
 
+double Kernel::computeSpatiallyVaryingImage(image::Image<Pixel> &image, bool doNormalize, double x,
+                                            double y) const {
+    if (_imageCache) {
+        return _imageCache->computeImage(*this, image, doNormalize, x, y);
+    }
+    this->setKernelParametersFromSpatialModel(x, y);
+    return doComputeImage(image, doNormalize);
+}
+
 std::string Kernel::getPythonModule() const { return "lsst.afw.math"; }
 }  // namespace math
 }  // namespace afw
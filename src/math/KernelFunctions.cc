@@ -38,7 +38,7 @@ namespace math {
 void printKernel(Kernel const &kernel, bool doNormalize, double xPos, double yPos, std::string pixelFmt) {
     using Pixel = Kernel::Pixel;
 
-    image::Image<Pixel> kImage(kernel.getDimensions());
+    image::Image<Pixel> kImage(kernel.getDimensions(), image::UNINITIALIZED);
     double kSum = kernel.computeImage(kImage, doNormalize, xPos, yPos);
 
     for (int y = kImage.getHeight() - 1; y >= 0; --y) {
@@ -0,0 +1,219 @@
+// -*- LSST-C++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "Eigen/Cholesky"
+#include "Eigen/Eigenvalues"
+#include "Eigen/SVD"
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/math/LeastSquaresBatch.h"
+#include "lsst/afw/math/detail/Parallel.h"
+
+namespace lsst {
+namespace afw {
+namespace math {
+
+namespace {
+
+// Largest problem dimension solved with fixed-size Eigen types
+int const MAX_FIXED_DIMENSION = 10;
+
+// Systems solved by one task; enough to amortize the scheduling of a task over many tiny systems
+int const SYSTEMS_PER_TASK = 256;
+
+// As LeastSquares::Impl::setRank: the number of leading elements of the descending sequence
+// `values` that are no smaller than threshold*values[0]
+template <typename D>
+int computeRank(Eigen::MatrixBase<D> const &values, double threshold) {
+    int const dimension = values.size();
+    double const cond = threshold * values[0];
+    if (cond <= 0.0) {
+        return 0;
+    }
+    int rank = dimension;
+    for (; (rank > 1) && (values[rank - 1] < cond); --rank)
+        ;
+    return rank;
+}
+
+/*
+ * Solve systems one after another, reusing the factorization workspace between them.
+ *
+ * N is the problem dimension if it is known at compile time, or Eigen::Dynamic.  The Fisher matrix
+ * of each system is read through a column-major map of row-major storage, which is the same matrix
+ * because it is symmetric, and only its lower triangle is used, as in LeastSquares.
+ */
+template <int N>
+class SystemSolver {
+public:
+    using Matrix = Eigen::Matrix<double, N, N>;
+    using Vector = Eigen::Matrix<double, N, 1>;
+
+    SystemSolver(int dimension, double threshold)
+            : _dimension(dimension), _threshold(threshold), _ldlt(dimension), _eig(dimension),
+              _tmp(dimension) {}
+
+    void solveCholesky(double const *fisherData, double const *rhsData, double *solutionData,
+                       double *diagnosticData, int &rank) {
+        Eigen::Map<Matrix const> fisher(fisherData, _dimension, _dimension);
+        Eigen::Map<Vector const> rhs(rhsData, _dimension);
+        Eigen::Map<Vector> diagnostic(diagnosticData, _dimension);
+        _ldlt.compute(fisher);
+        diagnostic = _ldlt.vectorD();
+        double const dMax = diagnostic.maxCoeff();
+        double const cond = _threshold * dMax;
+        rank = (dMax > 0.0) ? static_cast<int>((diagnostic.array() >= cond).count()) : 0;
+        Eigen::Map<Vector>(solutionData, _dimension) = _ldlt.solve(rhs);
+    }
+
+    void solveEigensystem(double const *fisherData, double const *rhsData, double *solutionData,
+                          double *diagnosticData, int &rank) {
+        Eigen::Map<Matrix const> fisher(fisherData, _dimension, _dimension);
+        Eigen::Map<Vector const> rhs(rhsData, _dimension);
+        Eigen::Map<Vector> solution(solutionData, _dimension);
+        Eigen::Map<Vector> diagnostic(diagnosticData, _dimension);
+        _eig.compute(fisher);
+        if (_eig.info() == Eigen::Success) {
+            diagnostic = _eig.eigenvalues().reverse();
+            rank = computeRank(diagnostic, _threshold);
+            if (rank == 0) {
+                solution.setZero();
+                return;
+            }
+            _tmp.head(rank) = _eig.eigenvectors().rightCols(rank).adjoint() * rhs;
+            _tmp.head(rank).array() /= _eig.eigenvalues().tail(rank).array();
+            solution = _eig.eigenvectors().rightCols(rank) * _tmp.head(rank);
+        } else {
+            // As in LeastSquares, fall back to the SVD of the (symmetric) Fisher matrix, whose
+            // singular vectors are its Eigenvectors.
+            Matrix full = fisher.template selfadjointView<Eigen::Lower>();
+            Eigen::JacobiSVD<Matrix> svd(full, Eigen::ComputeFullU);
+            diagnostic = svd.singularValues();
+            rank = computeRank(diagnostic, _threshold);
+            if (rank == 0) {
+                solution.setZero();
+                return;
+            }
+            _tmp.head(rank) = svd.matrixU().leftCols(rank).adjoint() * rhs;
+            _tmp.head(rank).array() /= svd.singularValues().head(rank).array();
+            solution = svd.matrixU().leftCols(rank) * _tmp.head(rank);
+        }
+    }
+
+private:
+    int _dimension;
+    double _threshold;
+    Eigen::LDLT<Matrix> _ldlt;
+    Eigen::SelfAdjointEigenSolver<Matrix> _eig;
+    Vector _tmp;
+};
+
+// Solve systems [begin, end) of the batch
+template <int N>
+void solveSystems(ndarray::Array<double const, 3, 3> const &fisher,
+                  ndarray::Array<double const, 2, 2> const &rhs, ndarray::Array<double, 2, 2> const &solution,
+                  ndarray::Array<double, 2, 2> const &diagnostic, ndarray::Array<int, 1, 1> const &rank,
+                  LeastSquares::Factorization factorization, double threshold, int begin, int end) {
+    int const dimension = rhs.getSize<1>();
+    SystemSolver<N> solver(dimension, threshold);
+    for (int i = begin; i < end; ++i) {
+        if (factorization == LeastSquares::NORMAL_CHOLESKY) {
+            solver.solveCholesky(fisher[i].getData(), rhs[i].getData(), solution[i].getData(),
+                                 diagnostic[i].getData(), rank[i]);
+        } else {
+            solver.solveEigensystem(fisher[i].getData(), rhs[i].getData(), solution[i].getData(),
+                                    diagnostic[i].getData(), rank[i]);
+        }
+    }
+}
+
+template <int N>
+struct FixedDispatch {
+    template <typename... Args>
+    static void apply(int dimension, Args &&...args) {
+        if (dimension == N) {
+            solveSystems<N>(std::forward<Args>(args)...);
+        } else {
+            FixedDispatch<N - 1>::apply(dimension, std::forward<Args>(args)...);
+        }
+    }
+};
+
+template <>
+struct FixedDispatch<0> {
+    template <typename... Args>
+    static void apply(int, Args &&...args) {
+        solveSystems<Eigen::Dynamic>(std::forward<Args>(args)...);
+    }
+};
+
+}  // namespace
+
+LeastSquaresBatch::LeastSquaresBatch(LeastSquares::Factorization factorization, int size, int dimension)
+        : _factorization(factorization),
+          _solution(ndarray::allocate(size, dimension)),
+          _diagnostic(ndarray::allocate(size, dimension)),
+          _rank(ndarray::allocate(size)) {}
+
+LeastSquaresBatch LeastSquaresBatch::fromNormalEquations(ndarray::Array<double const, 3, 3> const &fisher,
+                                                         ndarray::Array<double const, 2, 2> const &rhs,
+                                                         LeastSquares::Factorization factorization,
+                                                         double threshold, int numThreads) {
+    int const size = rhs.getSize<0>();
+    int const dimension = rhs.getSize<1>();
+    if (fisher.getSize<0>() != rhs.getSize<0>() || fisher.getSize<1>() != rhs.getSize<1>() ||
+        fisher.getSize<2>() != rhs.getSize<1>()) {
+        std::ostringstream os;
+        os << "Fisher matrices have shape (" << fisher.getSize<0>() << ", " << fisher.getSize<1>() << ", "
+           << fisher.getSize<2>() << "), but right-hand side vectors have shape (" << size << ", "
+           << dimension << ")";
+        throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
+    }
+    if (factorization == LeastSquares::DIRECT_SVD) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "Cannot initialize DIRECT_SVD solver with normal equations.");
+    }
+    detail::resolveNumThreads(numThreads);  // check numThreads even if the batch is too small to use it
+
+    LeastSquaresBatch result(factorization, size, dimension);
+    if (size == 0 || dimension == 0) {
+        return result;
+    }
+    std::vector<std::pair<int, int>> const tasks =
+            detail::splitRange(0, size, (size + SYSTEMS_PER_TASK - 1) / SYSTEMS_PER_TASK);
+    detail::parallelFor(static_cast<int>(tasks.size()), numThreads, [&](int i) {
+        FixedDispatch<MAX_FIXED_DIMENSION>::apply(dimension, fisher, rhs, result._solution,
+                                                  result._diagnostic, result._rank, factorization, threshold,
+                                                  tasks[i].first, tasks[i].second);
+    });
+    return result;
+}
+
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
@@ -109,6 +109,7 @@ std::shared_ptr<Kernel> LinearCombinationKernel::clone() const {
         retPtr.reset(new LinearCombinationKernel(this->_kernelList, this->_kernelParams));
     }
     retPtr->setCtr(this->getCtr());
+    retPtr->setImageCache(this->getImageCacheMaxSize(), this->getImageCachePositionQuantum());
     return retPtr;
 }
 
@@ -180,7 +181,7 @@ std::shared_ptr<Kernel> LinearCombinationKernel::refactor() const {
         KernelImagePtr kernelImagePtr(new KernelImage(this->getDimensions()));
         newKernelImagePtrList.push_back(kernelImagePtr);
     }
-    KernelImage kernelImage(this->getDimensions());
+    KernelImage kernelImage(this->getDimensions(), image::UNINITIALIZED);
     std::vector<Kernel::SpatialFunctionPtr>::const_iterator spFuncPtrIter =
             this->_spatialFunctionList.begin();
     KernelList::const_iterator kIter = _kernelList.begin();
@@ -285,7 +286,8 @@ void LinearCombinationKernel::_setKernelList(KernelList const &kernelList) {
             _isDeltaFunctionBasis = false;
         }
         _kernelList.push_back(basisKernelPtr);
-        std::shared_ptr<image::Image<Pixel>> kernelImagePtr(new image::Image<Pixel>(this->getDimensions()));
+        std::shared_ptr<image::Image<Pixel>> kernelImagePtr(
+                new image::Image<Pixel>(this->getDimensions(), image::UNINITIALIZED));
         _kernelSumList.push_back(basisKernelPtr->computeImage(*kernelImagePtr, false));
         _kernelImagePtrList.push_back(kernelImagePtr);
     }
@@ -0,0 +1,307 @@
+// -*- LSST-C++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/math/MultiRegionStatistics.h"
+#include "lsst/afw/math/detail/Parallel.h"
+
+namespace lsst {
+namespace afw {
+namespace math {
+
+namespace {
+
+// Number of chunks of regions handed to each thread; more than one keeps the threads busy when
+// region sizes vary, while keeping the number of scratch buffers small
+int const CHUNKS_PER_THREAD = 4;
+
+// Number of adjacent columns transposed together by makeColumnStatistics; a block's scratch rows
+// stay in cache while the image rows are read
+int const COLUMN_BLOCK = 32;
+
+/*
+ * Evaluate `measure(i)` for every region i in [0, n), concurrently, and collect the results
+ *
+ * `measure` is called as measure(begin, end, results) for contiguous chunks of regions, so it may
+ * set up state (e.g. a scratch buffer) once per chunk.  Chunks start at multiples of `alignment`.
+ */
+template <typename MeasureChunk>
+std::vector<Statistics> measureRegions(int n, StatisticsControl const &sctrl, MeasureChunk measure,
+                                       int alignment = 1) {
+    int const nThreads = detail::resolveNumThreads(sctrl.getNumThreads());
+    auto const chunks =
+            detail::splitRange(0, n, nThreads == 1 ? 1 : nThreads * CHUNKS_PER_THREAD, alignment);
+
+    std::vector<std::unique_ptr<Statistics>> results(n);
+    int const nChunks = chunks.size();
+    detail::parallelFor(nChunks, nThreads, [&chunks, &results, &measure](int iChunk) {
+        measure(chunks[iChunk].first, chunks[iChunk].second, results);
+    });
+
+    std::vector<Statistics> statistics;
+    statistics.reserve(n);
+    for (auto &result : results) {
+        statistics.push_back(std::move(*result));
+    }
+    return statistics;
+}
+
+template <typename Pixel>
+void checkContains(image::MaskedImage<Pixel> const &mimg, lsst::geom::Box2I const &bbox, std::size_t i) {
+    if (!mimg.getBBox().contains(bbox)) {
+        std::ostringstream os;
+        os << "Region " << i << " (bbox " << bbox << ") does not lie within image bbox " << mimg.getBBox();
+        throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
+    }
+}
+
+template <typename Pixel>
+void checkNotEmpty(image::MaskedImage<Pixel> const &mimg) {
+    if (mimg.getBBox().isEmpty()) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "Image contains no pixels");
+    }
+}
+
+// The pixels of one plane of a MaskedImage and the distance between its rows, captured so that
+// threads can read them without touching the reference counts of the image's array
+template <typename T>
+struct Plane {
+    template <typename ArrayT>
+    explicit Plane(ArrayT const &array) : data(array.getData()), stride(array.template getStride<0>()) {}
+
+    T *row(int y) const { return data + y * stride; }
+
+    T *data;
+    std::ptrdiff_t stride;
+};
+
+// The three planes of a MaskedImage
+template <typename Pixel, typename MaskPixel = image::MaskPixel,
+          typename VariancePixel = image::VariancePixel>
+struct Planes {
+    template <typename MaskedImageT>
+    explicit Planes(MaskedImageT const &mimg)
+            : image(mimg.getImage()->getArray()),
+              mask(mimg.getMask()->getArray()),
+              variance(mimg.getVariance()->getArray()) {}
+
+    Plane<Pixel> image;
+    Plane<MaskPixel> mask;
+    Plane<VariancePixel> variance;
+};
+
+}  // namespace
+
+MultiRegionStatistics::MultiRegionStatistics(std::vector<Statistics> statistics, int flags)
+        : _statistics(std::move(statistics)), _flags(flags) {}
+
+Statistics const &MultiRegionStatistics::get(std::size_t i) const {
+    if (i >= _statistics.size()) {
+        std::ostringstream os;
+        os << "Region index " << i << " out of range; there are " << _statistics.size() << " regions";
+        throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
+    }
+    return _statistics[i];
+}
+
+ndarray::Array<double, 1, 1> MultiRegionStatistics::getValues(Property const prop) const {
+    ndarray::Array<double, 1, 1> result = ndarray::allocate(_statistics.size());
+    std::transform(_statistics.begin(), _statistics.end(), result.begin(),
+                   [prop](Statistics const &stats) { return stats.getValue(prop); });
+    return result;
+}
+
+ndarray::Array<double, 1, 1> MultiRegionStatistics::getErrors(Property const prop) const {
+    ndarray::Array<double, 1, 1> result = ndarray::allocate(_statistics.size());
+    std::transform(_statistics.begin(), _statistics.end(), result.begin(),
+                   [prop](Statistics const &stats) { return stats.getError(prop); });
+    return result;
+}
+
+ndarray::Array<image::MaskPixel, 1, 1> MultiRegionStatistics::getOrMasks() const {
+    ndarray::Array<image::MaskPixel, 1, 1> result = ndarray::allocate(_statistics.size());
+    std::transform(_statistics.begin(), _statistics.end(), result.begin(),
+                   [](Statistics const &stats) { return stats.getOrMask(); });
+    return result;
+}
+
+template <typename Pixel>
+MultiRegionStatistics makeMultiRegionStatistics(image::MaskedImage<Pixel> const &mimg,
+                                                std::vector<lsst::geom::Box2I> const &boxes, int const flags,
+                                                StatisticsControl const &sctrl) {
+    for (std::size_t i = 0; i < boxes.size(); ++i) {
+        if (boxes[i].isEmpty()) {
+            std::ostringstream os;
+            os << "Region " << i << " contains no pixels";
+            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, os.str());
+        }
+        checkContains(mimg, boxes[i], i);
+    }
+    auto statistics = measureRegions(
+            boxes.size(), sctrl, [&mimg, &boxes, flags, &sctrl](int begin, int end, auto &results) {
+                for (int i = begin; i < end; ++i) {
+                    // a subimage is a view, so no pixels are copied
+                    image::MaskedImage<Pixel> const sub(mimg, boxes[i], image::PARENT, false);
+                    results[i] = std::make_unique<Statistics>(makeStatistics(sub, flags, sctrl));
+                }
+            });
+    return MultiRegionStatistics(std::move(statistics), flags);
+}
+
+template <typename Pixel>
+MultiRegionStatistics makeMultiRegionStatistics(
+        image::MaskedImage<Pixel> const &mimg,
+        std::vector<std::shared_ptr<geom::SpanSet const>> const &spanSets, int const flags,
+        StatisticsControl const &sctrl) {
+    for (std::size_t i = 0; i < spanSets.size(); ++i) {
+        if (!spanSets[i]) {
+            std::ostringstream os;
+            os << "Region " << i << " is null";
+            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, os.str());
+        }
+        if (spanSets[i]->getArea() == 0) {
+            std::ostringstream os;
+            os << "Region " << i << " contains no pixels";
+            throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, os.str());
+        }
+        checkContains(mimg, spanSets[i]->getBBox(), i);
+    }
+    auto statistics = measureRegions(
+            spanSets.size(), sctrl, [&mimg, &spanSets, flags, &sctrl](int begin, int end, auto &results) {
+                // One scratch buffer for the whole chunk, large enough for its biggest region;
+                // each region is measured through a view of its leading pixels
+                geom::SpanSet::size_type maxArea = 1;
+                for (int i = begin; i < end; ++i) {
+                    maxArea = std::max(maxArea, spanSets[i]->getArea());
+                }
+                image::MaskedImage<Pixel> scratch(lsst::geom::Extent2I(maxArea, 1));
+
+                int const x0 = mimg.getX0();
+                int const y0 = mimg.getY0();
+                for (int i = begin; i < end; ++i) {
+                    auto imgPtr = scratch.getImage()->row_begin(0);
+                    auto mskPtr = scratch.getMask()->row_begin(0);
+                    auto varPtr = scratch.getVariance()->row_begin(0);
+                    for (auto const &span : *spanSets[i]) {
+                        int const x = span.getMinX() - x0;
+                        int const y = span.getY() - y0;
+                        int const width = span.getWidth();
+                        imgPtr = std::copy_n(mimg.getImage()->x_at(x, y), width, imgPtr);
+                        mskPtr = std::copy_n(mimg.getMask()->x_at(x, y), width, mskPtr);
+                        varPtr = std::copy_n(mimg.getVariance()->x_at(x, y), width, varPtr);
+                    }
+                    lsst::geom::Box2I const regionBox(lsst::geom::Point2I(0, 0),
+                                                      lsst::geom::Extent2I(spanSets[i]->getArea(), 1));
+                    image::MaskedImage<Pixel> const region(scratch, regionBox, image::LOCAL, false);
+                    results[i] = std::make_unique<Statistics>(makeStatistics(region, flags, sctrl));
+                }
+            });
+    return MultiRegionStatistics(std::move(statistics), flags);
+}
+
+template <typename Pixel>
+MultiRegionStatistics makeRowStatistics(image::MaskedImage<Pixel> const &mimg, int const flags,
+                                        StatisticsControl const &sctrl) {
+    checkNotEmpty(mimg);
+    int const width = mimg.getWidth();
+    Planes<Pixel const, image::MaskPixel const, image::VariancePixel const> const input(mimg);
+    auto statistics = measureRegions(
+            mimg.getHeight(), sctrl, [&input, width, flags, &sctrl](int begin, int end, auto &results) {
+                // each row is copied into a scratch row owned by this chunk, and measured there
+                image::MaskedImage<Pixel> scratch(lsst::geom::Extent2I(width, 1));
+                Planes<Pixel> const output(scratch);
+                for (int y = begin; y < end; ++y) {
+                    std::copy_n(input.image.row(y), width, output.image.row(0));
+                    std::copy_n(input.mask.row(y), width, output.mask.row(0));
+                    std::copy_n(input.variance.row(y), width, output.variance.row(0));
+                    results[y] = std::make_unique<Statistics>(makeStatistics(scratch, flags, sctrl));
+                }
+            });
+    return MultiRegionStatistics(std::move(statistics), flags);
+}
+
+template <typename Pixel>
+MultiRegionStatistics makeColumnStatistics(image::MaskedImage<Pixel> const &mimg, int const flags,
+                                           StatisticsControl const &sctrl) {
+    checkNotEmpty(mimg);
+    int const height = mimg.getHeight();
+    Planes<Pixel const, image::MaskPixel const, image::VariancePixel const> const input(mimg);
+    auto statistics = measureRegions(
+            mimg.getWidth(), sctrl,
+            [&input, height, flags, &sctrl](int begin, int end, auto &results) {
+                // row k of the scratch image holds column x + k of the current block of columns
+                image::MaskedImage<Pixel> scratch(lsst::geom::Extent2I(height, COLUMN_BLOCK));
+                Planes<Pixel> const output(scratch);
+                for (int x = begin; x < end; x += COLUMN_BLOCK) {
+                    int const nColumns = std::min(COLUMN_BLOCK, end - x);
+                    for (int y = 0; y < height; ++y) {
+                        Pixel const *imgPtr = input.image.row(y) + x;
+                        image::MaskPixel const *mskPtr = input.mask.row(y) + x;
+                        image::VariancePixel const *varPtr = input.variance.row(y) + x;
+                        for (int k = 0; k < nColumns; ++k) {
+                            output.image.row(k)[y] = imgPtr[k];
+                            output.mask.row(k)[y] = mskPtr[k];
+                            output.variance.row(k)[y] = varPtr[k];
+                        }
+                    }
+                    for (int k = 0; k < nColumns; ++k) {
+                        lsst::geom::Box2I const columnBox(lsst::geom::Point2I(0, k),
+                                                          lsst::geom::Extent2I(height, 1));
+                        image::MaskedImage<Pixel> const column(scratch, columnBox, image::LOCAL, false);
+                        results[x + k] = std::make_unique<Statistics>(makeStatistics(column, flags, sctrl));
+                    }
+                }
+            },
+            COLUMN_BLOCK);
+    return MultiRegionStatistics(std::move(statistics), flags);
+}
+
+/// @cond
+#define INSTANTIATE_MULTIREGION_STATISTICS(TYPE)                                                         \
+    template MultiRegionStatistics makeMultiRegionStatistics(image::MaskedImage<TYPE> const &,           \
+                                                             std::vector<lsst::geom::Box2I> const &,     \
+                                                             int const, StatisticsControl const &);      \
+    template MultiRegionStatistics makeMultiRegionStatistics(                                            \
+            image::MaskedImage<TYPE> const &, std::vector<std::shared_ptr<geom::SpanSet const>> const &, \
+            int const, StatisticsControl const &);                                                       \
+    template MultiRegionStatistics makeRowStatistics(image::MaskedImage<TYPE> const &, int const,        \
+                                                     StatisticsControl const &);                         \
+    template MultiRegionStatistics makeColumnStatistics(image::MaskedImage<TYPE> const &, int const,     \
+                                                        StatisticsControl const &)
+
+INSTANTIATE_MULTIREGION_STATISTICS(double);
+INSTANTIATE_MULTIREGION_STATISTICS(float);
+INSTANTIATE_MULTIREGION_STATISTICS(int);
+INSTANTIATE_MULTIREGION_STATISTICS(std::uint16_t);
+INSTANTIATE_MULTIREGION_STATISTICS(std::uint64_t);
+/// @endcond
+
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
@@ -92,10 +92,23 @@ ndarray::Array<double, 1, 1> ProductBoundedField::evaluate(
             (boost::format("Inconsistent shapes: %s != %s") % x.getShape() % y.getShape()).str()
         );
     }
-    ndarray::Array<double, 1, 1> z = ndarray::allocate(x.getShape());
-    std::fill(z.begin(), z.end(), 1.0);
-    for (auto const & field : _factors) {
-        ndarray::asEigenArray(z) *= ndarray::asEigenArray(field->evaluate(x, y));
+    // The first factor's result is the accumulator, so there's no need to initialize one
+    auto iter = _factors.begin();
+    ndarray::Array<double, 1, 1> z = (**iter).evaluate(x, y);
+    for (++iter; iter != _factors.end(); ++iter) {
+        ndarray::asEigenArray(z) *= ndarray::asEigenArray((**iter).evaluate(x, y));
+    }
+    return z;
+}
+
+ndarray::Array<double, 2, 2> ProductBoundedField::evaluateGrid(
+    ndarray::Array<double const, 1> const& x,
+    ndarray::Array<double const, 1> const& y
+) const {
+    auto iter = _factors.begin();
+    ndarray::Array<double, 2, 2> z = (**iter).evaluateGrid(x, y);
+    for (++iter; iter != _factors.end(); ++iter) {
+        ndarray::asEigenArray(z) *= ndarray::asEigenArray((**iter).evaluateGrid(x, y));
     }
     return z;
 }
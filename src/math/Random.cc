@@ -26,6 +26,7 @@
  * Random number generator implementaion.
  */
 
+#include <cstdint>
 #include <limits>
 #include <string>
 #include <exception>
@@ -44,16 +45,93 @@ namespace lsst {
 namespace afw {
 namespace math {
 
+namespace {
+
+// -- The Philox4x32-10 generator --------
+//
+// Philox is a counter-based generator (Salmon et al. 2011, "Parallel random numbers: as easy as 1, 2,
+// 3"): each block of four 32-bit outputs is a bijective mix of a 128-bit counter under a 64-bit key.
+// We use the seed as the key, and the counter holds a substream index (high 64 bits) and the index of
+// the block within the substream (low 64 bits).  It is exposed to GSL as a gsl_rng_type, so that all of
+// GSL's distributions can use it.
+
+struct PhiloxState {
+    std::uint32_t key[2];
+    std::uint64_t stream;      // substream index
+    std::uint64_t block;       // index of the next block to generate in the substream
+    std::uint32_t buffer[4];   // the last block generated
+    unsigned int used;         // number of words of buffer already returned; 4 if it is exhausted
+};
+
+inline void philoxBlock(std::uint32_t const key[2], std::uint64_t stream, std::uint64_t block,
+                        std::uint32_t out[4]) {
+    std::uint32_t c0 = block, c1 = block >> 32, c2 = stream, c3 = stream >> 32;
+    std::uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < 10; ++round) {
+        std::uint64_t const p0 = std::uint64_t(0xD2511F53) * c0;
+        std::uint64_t const p1 = std::uint64_t(0xCD9E8D57) * c2;
+        c0 = (p1 >> 32) ^ c1 ^ k0;
+        c1 = p1;
+        c2 = (p0 >> 32) ^ c3 ^ k1;
+        c3 = p0;
+        k0 += 0x9E3779B9;
+        k1 += 0xBB67AE85;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+// A double in [0, 1) with 53 random bits, from two 32-bit words
+inline double wordsToDouble(std::uint32_t hi, std::uint32_t lo) {
+    return ((hi >> 5) * 67108864.0 + (lo >> 6)) * (1.0 / 9007199254740992.0);
+}
+
+// Where the substreams of a state start: the current one if nothing has been drawn from it yet
+inline std::uint64_t firstFreeStream(PhiloxState const &state) {
+    return state.block == 0 && state.used == 4 ? state.stream : state.stream + 1;
+}
+
+void philoxSet(void *vstate, unsigned long seed) {
+    auto state = static_cast<PhiloxState *>(vstate);
+    std::uint64_t const key = seed;
+    state->key[0] = key;
+    state->key[1] = key >> 32;
+    state->stream = 0;
+    state->block = 0;
+    state->used = 4;
+}
+
+unsigned long philoxGet(void *vstate) {
+    auto state = static_cast<PhiloxState *>(vstate);
+    if (state->used == 4) {
+        philoxBlock(state->key, state->stream, state->block++, state->buffer);
+        state->used = 0;
+    }
+    return state->buffer[state->used++];
+}
+
+double philoxGetDouble(void *vstate) {
+    std::uint32_t const hi = philoxGet(vstate);
+    return wordsToDouble(hi, philoxGet(vstate));
+}
+
+::gsl_rng_type const philoxType = {"philox4x32", 0xffffffffUL, 0, sizeof(PhiloxState),
+                                   &philoxSet,   &philoxGet,   &philoxGetDouble};
+
+}  // namespace
+
 // -- Static data --------
 
 ::gsl_rng_type const *const Random::_gslRngTypes[Random::NUM_ALGORITHMS] = {
         ::gsl_rng_mt19937, ::gsl_rng_ranlxs0, ::gsl_rng_ranlxs1,   ::gsl_rng_ranlxs2, ::gsl_rng_ranlxd1,
         ::gsl_rng_ranlxd2, ::gsl_rng_ranlux,  ::gsl_rng_ranlux389, ::gsl_rng_cmrg,    ::gsl_rng_mrg,
-        ::gsl_rng_taus,    ::gsl_rng_taus2,   ::gsl_rng_gfsr4};
+        ::gsl_rng_taus,    ::gsl_rng_taus2,   ::gsl_rng_gfsr4,   &philoxType};
 
 char const *const Random::_algorithmNames[Random::NUM_ALGORITHMS] = {
         "MT19937",   "RANLXS0", "RANLXS1", "RANLXS2", "RANLXD1", "RANLXD2", "RANLUX",
-        "RANLUX389", "CMRG",    "MRG",     "TAUS",    "TAUS2",   "GFSR4"};
+        "RANLUX389", "CMRG",    "MRG",     "TAUS",    "TAUS2",   "GFSR4",   "PHILOX4X32"};
 
 char const *const Random::_algorithmEnvVarName = "LSST_RNG_ALGORITHM";
 char const *const Random::_seedEnvVarName = "LSST_RNG_SEED";
@@ -141,10 +219,64 @@ std::vector<std::string> const &Random::getAlgorithmNames() {
 
 unsigned long Random::getSeed() const { return _seed; }
 
+// -- Substreams of counter-based generators --------
+
+bool Random::isCounterBased() const { return _algorithm == PHILOX4X32; }
+
+Random Random::getSubstream(std::uint64_t index) const {
+    if (!isCounterBased()) {
+        throw LSST_EXCEPT(ex::LogicError, "RNG algorithm " + getAlgorithmName() + " has no substreams");
+    }
+    Random result = deepCopy();
+    auto state = static_cast<PhiloxState *>(::gsl_rng_state(result._rng.get()));
+    state->stream = firstFreeStream(*state) + index;
+    state->block = 0;
+    state->used = 4;
+    return result;
+}
+
+void Random::skipSubstreams(std::uint64_t n) {
+    if (!isCounterBased()) {
+        throw LSST_EXCEPT(ex::LogicError, "RNG algorithm " + getAlgorithmName() + " has no substreams");
+    }
+    auto state = static_cast<PhiloxState *>(::gsl_rng_state(_rng.get()));
+    state->stream = firstFreeStream(*state) + n;
+    state->block = 0;
+    state->used = 4;
+}
+
 // -- Mutators: generating random numbers --------
 
 double Random::uniform() { return ::gsl_rng_uniform(_rng.get()); }
 
+void Random::uniform(double *begin, double *end) {
+    if (!isCounterBased()) {
+        for (double *ptr = begin; ptr != end; ++ptr) {
+            *ptr = ::gsl_rng_uniform(_rng.get());
+        }
+        return;
+    }
+    auto state = static_cast<PhiloxState *>(::gsl_rng_state(_rng.get()));
+    // Use up any buffered words first, so that whole blocks can be generated directly
+    while (begin != end && state->used != 4) {
+        *begin++ = philoxGetDouble(state);
+    }
+    // Each block gives two doubles; the blocks are independent, so the loop vectorizes
+    std::uint64_t const nBlocks = (end - begin) / 2;
+    std::uint64_t const block0 = state->block;
+    for (std::uint64_t i = 0; i < nBlocks; ++i) {
+        std::uint32_t words[4];
+        philoxBlock(state->key, state->stream, block0 + i, words);
+        begin[2 * i] = wordsToDouble(words[0], words[1]);
+        begin[2 * i + 1] = wordsToDouble(words[2], words[3]);
+    }
+    state->block += nBlocks;
+    begin += 2 * nBlocks;
+    if (begin != end) {
+        *begin = philoxGetDouble(state);
+    }
+}
+
 double Random::uniformPos() { return ::gsl_rng_uniform_pos(_rng.get()); }
 
 unsigned long Random::uniformInt(unsigned long n) {
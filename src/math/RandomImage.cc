@@ -25,9 +25,11 @@
 /*
  * Fill Images with Random numbers
  */
+#include <vector>
+
 #include "lsst/afw/image/Image.h"
-#include "lsst/afw/image/ImageAlgorithm.h"
 #include "lsst/afw/math/Random.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace lsst {
 namespace afw {
@@ -35,125 +37,116 @@ namespace math {
 
 namespace {
 
-template <typename T>
-struct do_random : public lsst::afw::image::pixelOp0<T> {
-    do_random(Random &rand) : _rand(rand) {}
-
-protected:
-    Random &_rand;
-};
-
-template <typename T>
-struct do_uniform : public do_random<T> {
-    do_uniform(Random &rand) : do_random<T>(rand) {}
-
-    T operator()() const override { return do_random<T>::_rand.uniform(); }
-};
-
-template <typename T>
-struct do_uniformPos : public do_random<T> {
-    do_uniformPos(Random &rand) : do_random<T>(rand) {}
-
-    T operator()() const override { return do_random<T>::_rand.uniformPos(); }
-};
-
-template <typename T>
-struct do_uniformInt : public do_random<T> {
-    do_uniformInt(Random &rand, unsigned long n) : do_random<T>(rand), _n(n) {}
-
-    T operator()() const override { return do_random<T>::_rand.uniformInt(_n); }
-
-private:
-    unsigned long _n;
-};
-
-template <typename T>
-struct do_flat : public do_random<T> {
-    do_flat(Random &rand, double const a, double const b) : do_random<T>(rand), _a(a), _b(b) {}
-
-    T operator()() const override { return do_random<T>::_rand.flat(_a, _b); }
-
-private:
-    double const _a;
-    double const _b;
-};
-
-template <typename T>
-struct do_gaussian : public do_random<T> {
-    do_gaussian(Random &rand) : do_random<T>(rand) {}
-
-    T operator()() const override { return do_random<T>::_rand.gaussian(); }
-};
-
-template <typename T>
-struct do_chisq : public do_random<T> {
-    do_chisq(Random &rand, double nu) : do_random<T>(rand), _nu(nu) {}
-
-    T operator()() const override { return do_random<T>::_rand.chisq(_nu); }
-
-private:
-    double const _nu;
-};
+/*
+ * Fill an image by calling fillRow(rand, row, width, scratch) on each row
+ *
+ * A counter-based generator gives each row its own substream, so the rows can be filled in parallel;
+ * any other generator fills the rows in order on this thread.  scratch is a buffer that fillRow may use.
+ */
+template <typename ImageT, typename RowFill>
+void fillRows(ImageT *image, Random &rand, int numThreads, RowFill const &fillRow) {
+    int const nThreads = detail::resolveNumThreads(numThreads);
+    int const width = image->getWidth();
+    if (!rand.isCounterBased()) {
+        std::vector<double> scratch;
+        for (int y = 0; y < image->getHeight(); ++y) {
+            fillRow(rand, image->row_begin(y), width, scratch);
+        }
+        return;
+    }
+    auto const bands = detail::splitRange(0, image->getHeight(), nThreads);
+    int const nBands = bands.size();
+    detail::parallelFor(nBands, nThreads, [&](int i) {
+        std::vector<double> scratch;
+        for (int y = bands[i].first; y < bands[i].second; ++y) {
+            Random rowRand = rand.getSubstream(y);
+            fillRow(rowRand, image->row_begin(y), width, scratch);
+        }
+    });
+    rand.skipSubstreams(image->getHeight());
+}
 
-template <typename T>
-struct do_poisson : public do_random<T> {
-    do_poisson(Random &rand, double mu) : do_random<T>(rand), _mu(mu) {}
+// Fill an image by calling draw(rand) for each pixel
+template <typename ImageT, typename Draw>
+void fillPixels(ImageT *image, Random &rand, int numThreads, Draw const &draw) {
+    using Pixel = typename ImageT::Pixel;
+    fillRows(image, rand, numThreads,
+             [&draw](Random &rowRand, typename ImageT::x_iterator row, int width, std::vector<double> &) {
+                 for (int x = 0; x < width; ++x) {
+                     row[x] = static_cast<Pixel>(draw(rowRand));
+                 }
+             });
+}
 
-    T operator()() const override { return do_random<T>::_rand.poisson(_mu); }
+// Fill an image with a + (b - a)*u for uniform u in [0, 1), drawing a row of u at once
+template <typename ImageT>
+void fillUniform(ImageT *image, Random &rand, double a, double b, int numThreads) {
+    using Pixel = typename ImageT::Pixel;
+    fillRows(image, rand, numThreads,
+             [a, b](Random &rowRand, typename ImageT::x_iterator row, int width,
+                    std::vector<double> &scratch) {
+                 scratch.resize(width);
+                 rowRand.uniform(scratch.data(), scratch.data() + width);
+                 for (int x = 0; x < width; ++x) {
+                     // as in gsl_ran_flat, so non-counter-based generators give the same images as before
+                     row[x] = static_cast<Pixel>(a * (1 - scratch[x]) + b * scratch[x]);
+                 }
+             });
+}
 
-private:
-    double const _mu;
-};
 }  // namespace
 
 template <typename ImageT>
-void randomUniformImage(ImageT *image, Random &rand) {
-    lsst::afw::image::for_each_pixel(*image, do_uniform<typename ImageT::Pixel>(rand));
+void randomUniformImage(ImageT *image, Random &rand, int numThreads) {
+    fillUniform(image, rand, 0.0, 1.0, numThreads);
 }
 
 template <typename ImageT>
-void randomUniformPosImage(ImageT *image, Random &rand) {
-    lsst::afw::image::for_each_pixel(*image, do_uniformPos<typename ImageT::Pixel>(rand));
+void randomUniformPosImage(ImageT *image, Random &rand, int numThreads) {
+    fillPixels(image, rand, numThreads, [](Random &r) { return r.uniformPos(); });
 }
 
 template <typename ImageT>
-void randomUniformIntImage(ImageT *image, Random &rand, unsigned long n) {
-    lsst::afw::image::for_each_pixel(*image, do_uniformInt<typename ImageT::Pixel>(rand, n));
+void randomUniformIntImage(ImageT *image, Random &rand, unsigned long n, int numThreads) {
+    fillPixels(image, rand, numThreads, [n](Random &r) { return r.uniformInt(n); });
 }
 
 template <typename ImageT>
-void randomFlatImage(ImageT *image, Random &rand, double const a, double const b) {
-    lsst::afw::image::for_each_pixel(*image, do_flat<typename ImageT::Pixel>(rand, a, b));
+void randomFlatImage(ImageT *image, Random &rand, double const a, double const b, int numThreads) {
+    fillUniform(image, rand, a, b, numThreads);
 }
 
 template <typename ImageT>
-void randomGaussianImage(ImageT *image, Random &rand) {
-    lsst::afw::image::for_each_pixel(*image, do_gaussian<typename ImageT::Pixel>(rand));
+void randomGaussianImage(ImageT *image, Random &rand, int numThreads) {
+    fillPixels(image, rand, numThreads, [](Random &r) { return r.gaussian(); });
 }
 
 template <typename ImageT>
-void randomChisqImage(ImageT *image, Random &rand, double const nu) {
-    lsst::afw::image::for_each_pixel(*image, do_chisq<typename ImageT::Pixel>(rand, nu));
+void randomChisqImage(ImageT *image, Random &rand, double const nu, int numThreads) {
+    fillPixels(image, rand, numThreads, [nu](Random &r) { return r.chisq(nu); });
 }
 
 template <typename ImageT>
-void randomPoissonImage(ImageT *image, Random &rand, double const mu) {
-    lsst::afw::image::for_each_pixel(*image, do_poisson<typename ImageT::Pixel>(rand, mu));
+void randomPoissonImage(ImageT *image, Random &rand, double const mu, int numThreads) {
+    fillPixels(image, rand, numThreads, [mu](Random &r) { return r.poisson(mu); });
 }
 
 //
 // Explicit instantiations
 //
 /// @cond
-#define INSTANTIATE(T)                                                                                     \
-    template void randomUniformImage(lsst::afw::image::Image<T> *image, Random &rand);                     \
-    template void randomUniformPosImage(lsst::afw::image::Image<T> *image, Random &rand);                  \
-    template void randomUniformIntImage(lsst::afw::image::Image<T> *image, Random &rand, unsigned long n); \
-    template void randomFlatImage(lsst::afw::image::Image<T> *image, Random &rand, double const a,         \
-                                  double const b);                                                         \
-    template void randomGaussianImage(lsst::afw::image::Image<T> *image, Random &rand);                    \
-    template void randomChisqImage(lsst::afw::image::Image<T> *image, Random &rand, double const nu);      \
-    template void randomPoissonImage(lsst::afw::image::Image<T> *image, Random &rand, double const mu);
+#define INSTANTIATE(T)                                                                                    \
+    template void randomUniformImage(lsst::afw::image::Image<T> *image, Random &rand, int);               \
+    template void randomUniformPosImage(lsst::afw::image::Image<T> *image, Random &rand, int);            \
+    template void randomUniformIntImage(lsst::afw::image::Image<T> *image, Random &rand, unsigned long n, \
+                                        int);                                                             \
+    template void randomFlatImage(lsst::afw::image::Image<T> *image, Random &rand, double const a,        \
+                                  double const b, int);                                                   \
+    template void randomGaussianImage(lsst::afw::image::Image<T> *image, Random &rand, int);              \
+    template void randomChisqImage(lsst::afw::image::Image<T> *image, Random &rand, double const nu,      \
+                                   int);                                                                  \
+    template void randomPoissonImage(lsst::afw::image::Image<T> *image, Random &rand, double const mu,    \
+                                     int);
 
 INSTANTIATE(double)
 INSTANTIATE(float)
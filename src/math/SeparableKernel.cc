@@ -21,10 +21,15 @@
  * the GNU General Public License along with this program.  If not,
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <typeinfo>
 #include <vector>
 #include <iostream>
 
 #include "lsst/pex/exceptions.h"
+#include "lsst/afw/math/Instrumentation.h"
 #include "lsst/afw/math/Kernel.h"
 #include "lsst/afw/math/KernelPersistenceHelper.h"
 #include "lsst/afw/table/io/Persistable.cc"
@@ -47,8 +52,8 @@ SeparableKernel::SeparableKernel()
           _localRowList(0),
           _kernelX(0),
           _kernelY(0),
-          _kernelRowCache(0),
-          _kernelColCache(0) {
+          _kernelRowCache(),
+          _kernelColCache() {
     _setKernelXY();
 }
 
@@ -63,8 +68,8 @@ SeparableKernel::SeparableKernel(int width, int height, KernelFunction const& ke
           _localRowList(height),
           _kernelX(width),
           _kernelY(height),
-          _kernelRowCache(0),
-          _kernelColCache(0) {
+          _kernelRowCache(),
+          _kernelColCache() {
     _setKernelXY();
 }
 
@@ -78,8 +83,8 @@ SeparableKernel::SeparableKernel(int width, int height, KernelFunction const& ke
           _localRowList(height),
           _kernelX(width),
           _kernelY(height),
-          _kernelRowCache(0),
-          _kernelColCache(0) {
+          _kernelRowCache(),
+          _kernelColCache() {
     if (kernelColFunction.getNParameters() + kernelRowFunction.getNParameters() !=
         spatialFunctionList.size()) {
         std::ostringstream os;
@@ -94,7 +99,7 @@ SeparableKernel::SeparableKernel(int width, int height, KernelFunction const& ke
 }
 
 std::shared_ptr<Kernel> SeparableKernel::clone() const {
-    std::shared_ptr<Kernel> retPtr;
+    std::shared_ptr<SeparableKernel> retPtr;
     if (this->isSpatiallyVarying()) {
         retPtr.reset(new SeparableKernel(this->getWidth(), this->getHeight(), *(this->_kernelColFunctionPtr),
                                          *(this->_kernelRowFunctionPtr), this->_spatialFunctionList));
@@ -103,7 +108,9 @@ std::shared_ptr<Kernel> SeparableKernel::clone() const {
                                          *(this->_kernelRowFunctionPtr)));
     }
     retPtr->setCtr(this->getCtr());
-    retPtr->computeCache(this->getCacheSize());
+    retPtr->_kernelColCache = _kernelColCache;
+    retPtr->_kernelRowCache = _kernelRowCache;
+    retPtr->setImageCache(this->getImageCacheMaxSize(), this->getImageCachePositionQuantum());
     return retPtr;
 }
 
@@ -198,18 +205,18 @@ void SeparableKernel::setKernelParameter(unsigned int ind, double value) const {
 double SeparableKernel::basicComputeVectors(std::vector<Pixel>& colList, std::vector<Pixel>& rowList,
                                             bool doNormalize) const {
     double colSum = 0.0;
-    if (_kernelColCache.empty()) {
+    if (!_kernelColCache) {
         for (unsigned int i = 0; i != colList.size(); ++i) {
             double colFuncValue = (*_kernelColFunctionPtr)(_kernelX[i]);
             colList[i] = colFuncValue;
             colSum += colFuncValue;
         }
     } else {
-        int const cacheSize = _kernelColCache.size();
+        int const cacheSize = _kernelColCache->size();
 
         int const indx = this->getKernelParameter(0) * cacheSize;
 
-        std::vector<double>& cachedValues = _kernelColCache.at(indx);
+        std::vector<double> const& cachedValues = _kernelColCache->at(indx);
         for (unsigned int i = 0; i != colList.size(); ++i) {
             double colFuncValue = cachedValues[i];
             colList[i] = colFuncValue;
@@ -218,18 +225,18 @@ double SeparableKernel::basicComputeVectors(std::vector<Pixel>& colList, std::ve
     }
 
     double rowSum = 0.0;
-    if (_kernelRowCache.empty()) {
+    if (!_kernelRowCache) {
         for (unsigned int i = 0; i != rowList.size(); ++i) {
             double rowFuncValue = (*_kernelRowFunctionPtr)(_kernelY[i]);
             rowList[i] = rowFuncValue;
             rowSum += rowFuncValue;
         }
     } else {
-        int const cacheSize = _kernelRowCache.size();
+        int const cacheSize = _kernelRowCache->size();
 
         int const indx = this->getKernelParameter(1) * cacheSize;
 
-        std::vector<double>& cachedValues = _kernelRowCache.at(indx);
+        std::vector<double> const& cachedValues = _kernelRowCache->at(indx);
         for (unsigned int i = 0; i != rowList.size(); ++i) {
             double rowFuncValue = cachedValues[i];
             rowList[i] = rowFuncValue;
@@ -266,57 +273,58 @@ double SeparableKernel::basicComputeVectors(std::vector<Pixel>& colList, std::ve
 }
 
 namespace {
-/**
- * @internal Compute a cache of pre-computed Kernels
- */
-void _computeCache(int const cacheSize, std::vector<double> const& x,
-                   SeparableKernel::KernelFunctionPtr& func, std::vector<std::vector<double> >* kernelCache) {
-    if (cacheSize <= 0) {
-        kernelCache->erase(kernelCache->begin(), kernelCache->end());
-        return;
-    }
 
-    if (kernelCache[0].size() != x.size()) {  // invalid
-        kernelCache->erase(kernelCache->begin(), kernelCache->end());
-    }
+using KernelCache = std::vector<std::vector<double>>;
 
-    int const old_cacheSize = kernelCache->size();
+// A kernel function's type, description and parameters (with the fractional position, parameter 0,
+// set to 0), positions and cache size
+using KernelCacheKey = std::tuple<std::string, std::string, std::vector<double>, std::vector<double>, int>;
 
-    if (cacheSize == old_cacheSize) {
-        return;  // nothing to do
+/**
+ * @internal Return the cache of a kernel function's values at positions x, for cacheSize fractional
+ * positions (parameter 0) evenly spaced in [0, 1); null if cacheSize is not positive
+ *
+ * Each cache is computed once, and shared by every kernel that asks for it.
+ */
+std::shared_ptr<KernelCache const> _getSharedCache(int const cacheSize, std::vector<double> const& x,
+                                                   SeparableKernel::KernelFunctionPtr const& func) {
+    if (cacheSize <= 0) {
+        return nullptr;
     }
-
-    if (cacheSize < old_cacheSize) {
-        kernelCache->erase(kernelCache->begin() + cacheSize, kernelCache->end());
-    } else {
-        kernelCache->resize(cacheSize);
-        for (int i = old_cacheSize; i != cacheSize; ++i) {
-            (*kernelCache)[i].resize(x.size());
+    func->setParameter(0, 0.0);
+    auto const& function = *func;
+    KernelCacheKey key(typeid(function).name(), func->toString(), func->getParameters(), x, cacheSize);
+
+    static std::mutex mutex;
+    static std::map<KernelCacheKey, std::shared_ptr<KernelCache const>> caches;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<KernelCache const>& cache = caches[key];
+    if (!cache) {
+        LSST_AFW_INSTRUMENT_COUNT("math.SeparableKernel.computeCache", 1);
+        auto newCache = std::make_shared<KernelCache>(cacheSize, std::vector<double>(x.size()));
+        for (int i = 0; i != cacheSize; ++i) {
+            func->setParameter(0, (i + 0.5) / static_cast<double>(cacheSize));
+            for (unsigned int j = 0; j != x.size(); ++j) {
+                (*newCache)[i][j] = (*func)(x[j]);
+            }
         }
-    }
-    //
-    // Actually fill the cache
-    //
-    for (int i = 0; i != cacheSize; ++i) {
-        func->setParameter(0, (i + 0.5) / static_cast<double>(cacheSize));
-        for (unsigned int j = 0; j != x.size(); ++j) {
-            (*kernelCache)[i][j] = (*func)(x[j]);
+        cache = std::move(newCache);
+        // The caches are never freed, so their charge is never released
+        if (LSST_AFW_INSTRUMENTATION && isInstrumentationEnabled()) {
+            static MemoryCounter& counter = getMemoryCounter("math.SeparableKernel.cache");
+            counter.allocate(cacheSize * x.size() * sizeof(double));
         }
     }
+    return cache;
 }
 }  // namespace
 
 void SeparableKernel::computeCache(int const cacheSize) {
-    SeparableKernel::KernelFunctionPtr func;
-
-    func = getKernelColFunction();
-    _computeCache(cacheSize, _kernelY, func, &_kernelColCache);
-
-    func = getKernelRowFunction();
-    _computeCache(cacheSize, _kernelX, func, &_kernelRowCache);
+    _kernelColCache = _getSharedCache(cacheSize, _kernelY, getKernelColFunction());
+    _kernelRowCache = _getSharedCache(cacheSize, _kernelX, getKernelRowFunction());
 }
 
-int SeparableKernel::getCacheSize() const { return _kernelColCache.size(); };
+int SeparableKernel::getCacheSize() const { return _kernelColCache ? _kernelColCache->size() : 0; };
 }  // namespace math
 }  // namespace afw
 }  // namespace lsst
@@ -32,6 +32,7 @@
 
 #include "lsst/log/Log.h"
 #include "lsst/afw/math/SpatialCell.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace image = lsst::afw::image;
 
@@ -298,6 +299,46 @@ std::shared_ptr<SpatialCellCandidate> SpatialCellCandidateIterator::operator*()
     return *_iterator;
 }
 
+namespace {
+/*
+ * Reset visitor, then call visitCell(cell, visitor) for each cell of cellList.
+ *
+ * If numThreads != 1 and the visitor can be cloned, each cell is instead visited by its own clone,
+ * concurrently, and the clones are merged back into visitor in cell order, so the result doesn't
+ * depend on how many threads actually run.
+ */
+template <typename VisitCell>
+void visitCells(SpatialCellSet::CellList const &cellList, CandidateVisitor *visitor, int numThreads,
+                VisitCell const &visitCell) {
+    visitor->reset();
+
+    std::vector<std::shared_ptr<CandidateVisitor>> clones;
+    if (numThreads != 1 && cellList.size() > 1) {
+        for (std::size_t i = 0; i < cellList.size(); ++i) {
+            std::shared_ptr<CandidateVisitor> clone = visitor->clone();
+            if (!clone) {
+                break;
+            }
+            clone->reset();
+            clones.push_back(std::move(clone));
+        }
+    }
+    if (clones.size() != cellList.size()) {
+        detail::resolveNumThreads(numThreads);  // check numThreads even if it's not used
+        for (auto const &cell : cellList) {
+            visitCell(*cell, visitor);
+        }
+        return;
+    }
+
+    detail::parallelFor(static_cast<int>(cellList.size()), numThreads,
+                        [&](int i) { visitCell(*cellList[i], clones[i].get()); });
+    for (auto const &clone : clones) {
+        visitor->merge(*clone);
+    }
+}
+}  // namespace
+
 SpatialCellSet::SpatialCellSet(lsst::geom::Box2I const &region, int xSize, int ySize)
         : _region(region), _cellList(CellList()) {
     if (ySize == 0) {
@@ -376,39 +417,31 @@ void SpatialCellSet::sortCandidates() {
 }
 
 void SpatialCellSet::visitCandidates(CandidateVisitor *visitor, int const nMaxPerCell,
-                                     bool const ignoreExceptions) {
-    visitor->reset();
-
-    for (auto const &cell : _cellList) {
-        cell->visitCandidates(visitor, nMaxPerCell, ignoreExceptions, false);
-    }
+                                     bool const ignoreExceptions, int numThreads) {
+    visitCells(_cellList, visitor, numThreads, [&](SpatialCell &cell, CandidateVisitor *cellVisitor) {
+        cell.visitCandidates(cellVisitor, nMaxPerCell, ignoreExceptions, false);
+    });
 }
 
 void SpatialCellSet::visitCandidates(CandidateVisitor *visitor, int const nMaxPerCell,
-                                     bool const ignoreExceptions) const {
-    visitor->reset();
-
-    for (auto const &cell : _cellList) {
-        SpatialCell const *ccell = cell.get();  // the SpatialCellSet's SpatialCells should be const too
-        ccell->visitCandidates(visitor, nMaxPerCell, ignoreExceptions, false);
-    }
+                                     bool const ignoreExceptions, int numThreads) const {
+    visitCells(_cellList, visitor, numThreads, [&](SpatialCell const &cell, CandidateVisitor *cellVisitor) {
+        cell.visitCandidates(cellVisitor, nMaxPerCell, ignoreExceptions, false);
+    });
 }
 
-void SpatialCellSet::visitAllCandidates(CandidateVisitor *visitor, bool const ignoreExceptions) {
-    visitor->reset();
-
-    for (auto const &cell : _cellList) {
-        cell->visitAllCandidates(visitor, ignoreExceptions, false);
-    }
+void SpatialCellSet::visitAllCandidates(CandidateVisitor *visitor, bool const ignoreExceptions,
+                                        int numThreads) {
+    visitCells(_cellList, visitor, numThreads, [&](SpatialCell &cell, CandidateVisitor *cellVisitor) {
+        cell.visitAllCandidates(cellVisitor, ignoreExceptions, false);
+    });
 }
 
-void SpatialCellSet::visitAllCandidates(CandidateVisitor *visitor, bool const ignoreExceptions) const {
-    visitor->reset();
-
-    for (auto const &cell : _cellList) {
-        SpatialCell const *ccell = cell.get();  // the SpatialCellSet's SpatialCells should be const too
-        ccell->visitAllCandidates(visitor, ignoreExceptions, false);
-    }
+void SpatialCellSet::visitAllCandidates(CandidateVisitor *visitor, bool const ignoreExceptions,
+                                        int numThreads) const {
+    visitCells(_cellList, visitor, numThreads, [&](SpatialCell const &cell, CandidateVisitor *cellVisitor) {
+        cell.visitAllCandidates(cellVisitor, ignoreExceptions, false);
+    });
 }
 
 std::shared_ptr<SpatialCellCandidate> SpatialCellSet::getCandidateById(int id, bool noThrow) {
@@ -26,61 +26,74 @@ void Spline::_allocateSpline(int const nknot) {
     }
 }
 
-void Spline::interpolate(std::vector<double> const &x, std::vector<double> &y) const {
+void Spline::_evaluate(double const *x, int const n, double *y, double *dydx) const {
     int const nknot = _knots.size();
-    int const n = x.size();
-
-    y.resize(n);   // may default-construct elements which is a little inefficient
-                   /*
-                    * For _knots[i] <= x <= _knots[i+1], the interpolant
-                    * has the form
-                    *    val = _coeff[0][i] +dx*(_coeff[1][i] + dx*(_coeff[2][i]/2 + dx*_coeff[3][i]/6))
-                    * with
-                    *    dx = x - knots[i]
-                    */
-    int ind = -1;  // no idea initially
+    if (n == 0) {
+        return;
+    }
+    /*
+     * For _knots[i] <= x <= _knots[i+1], the interpolant
+     * has the form
+     *    val = _coeff[0][i] +dx*(_coeff[1][i] + dx*(_coeff[2][i]/2 + dx*_coeff[3][i]/6))
+     * with
+     *    dx = x - knots[i]
+     * so the derivative is
+     *    val = _coeff[1][i] + dx*(_coeff[2][i] + dx*_coeff[3][i]/2))
+     *
+     * Points below the first knot use the first interval, and points above the last the last
+     */
+    double const *knots = &_knots[0];
+    int ind = 0;
+    double knot = knots[0];
+    double c0 = 0, c1 = 0, c2 = 0, c3 = 0;  // the Horner coefficients of the current interval
+    int coeffInd = -1;                      // the interval whose coefficients are in c0..c3
     for (int i = 0; i != n; ++i) {
-        ind = search_array(x[i], &_knots[0], nknot, ind);
-
-        if (ind < 0) {  // off bottom
-            ind = 0;
-        } else if (ind >= nknot) {  // off top
-            ind = nknot - 1;
+        double const xi = x[i];
+        if (xi >= knot) {
+            // Sorted input only ever moves forward, so walk up from the previous interval
+            while (ind + 1 < nknot && xi >= knots[ind + 1]) {
+                ++ind;
+            }
+        } else if (ind > 0) {
+            ind = search_array(xi, knots, nknot, ind);
+            if (ind < 0) {  // off bottom
+                ind = 0;
+            }
+        }
+        if (ind != coeffInd) {
+            coeffInd = ind;
+            knot = knots[ind];
+            c0 = _coeffs[0][ind];
+            c1 = _coeffs[1][ind];
+            c2 = _coeffs[2][ind] / 2;
+            c3 = _coeffs[3][ind] / 6;
         }
 
-        double const dx = x[i] - _knots[ind];
-        y[i] = _coeffs[0][ind] +
-               dx * (_coeffs[1][ind] + dx * (_coeffs[2][ind] / 2 + dx * _coeffs[3][ind] / 6));
+        double const dx = xi - knot;
+        if (y) {
+            y[i] = c0 + dx * (c1 + dx * (c2 + dx * c3));
+        }
+        if (dydx) {
+            dydx[i] = c1 + dx * (2 * c2 + dx * 3 * c3);
+        }
     }
 }
 
-void Spline::derivative(std::vector<double> const &x, std::vector<double> &dydx) const {
-    int const nknot = _knots.size();
-    int const n = x.size();
-
-    dydx.resize(n);  // may default-construct elements which is a little inefficient
-                     /*
-                      * For _knots[i] <= x <= _knots[i+1], the * interpolant has the form
-                      *    val = _coeff[0][i] +dx*(_coeff[1][i] + dx*(_coeff[2][i]/2 + dx*_coeff[3][i]/6))
-                      * with
-                      *    dx = x - knots[i]
-                      * so the derivative is
-                      *    val = _coeff[1][i] + dx*(_coeff[2][i] + dx*_coeff[3][i]/2))
-                      */
-
-    int ind = -1;  // no idea initially
-    for (int i = 0; i != n; ++i) {
-        ind = search_array(x[i], &_knots[0], nknot, ind);
+void Spline::interpolate(std::vector<double> const &x, std::vector<double> &y) const {
+    y.resize(x.size());  // may default-construct elements which is a little inefficient
+    _evaluate(x.data(), x.size(), y.data(), nullptr);
+}
 
-        if (ind < 0) {  // off bottom
-            ind = 0;
-        } else if (ind >= nknot) {  // off top
-            ind = nknot - 1;
-        }
+void Spline::derivative(std::vector<double> const &x, std::vector<double> &dydx) const {
+    dydx.resize(x.size());  // may default-construct elements which is a little inefficient
+    _evaluate(x.data(), x.size(), nullptr, dydx.data());
+}
 
-        double const dx = x[i] - _knots[ind];
-        dydx[i] = _coeffs[1][ind] + dx * (_coeffs[2][ind] + dx * _coeffs[3][ind] / 2);
-    }
+void Spline::interpolate(std::vector<double> const &x, std::vector<double> &y,
+                         std::vector<double> &dydx) const {
+    y.resize(x.size());
+    dydx.resize(x.size());
+    _evaluate(x.data(), x.size(), y.data(), dydx.data());
 }
 
 TautSpline::TautSpline(std::vector<double> const &x, std::vector<double> const &y, double const gamma0,
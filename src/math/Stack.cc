@@ -26,6 +26,11 @@
  * Provide functions to stack images
  *
  */
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <vector>
 #include <cassert>
 #include <memory>
@@ -33,6 +38,7 @@
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/math/Stack.h"
 #include "lsst/afw/math/MaskedVector.h"
+#include "lsst/afw/math/detail/Parallel.h"
 #include "lsst/log/Log.h"
 
 namespace pexExcept = lsst::pex::exceptions;
@@ -87,8 +93,8 @@ void checkObjectsAndWeights(ObjectVectorT const &objects, WeightVectorT const &w
     }
 }
 
-template <typename ImageT>
-void checkImageSizes(ImageT const &out, std::vector<std::shared_ptr<ImageT>> const &images) {
+template <typename ImageT, typename InputT>
+void checkImageSizes(ImageT const &out, std::vector<std::shared_ptr<InputT>> const &images) {
     lsst::geom::Extent2I const &dim = out.getDimensions();
     for (unsigned int i = 0; i < images.size(); ++i) {
         if (images[i]->getDimensions() != dim) {
@@ -101,6 +107,20 @@ void checkImageSizes(ImageT const &out, std::vector<std::shared_ptr<ImageT>> con
     }
 }
 
+/**
+ * @internal Width, in pixels, of the column tiles that each band of output rows is stacked in
+ *
+ * Stacking a narrow tile of one row at a time keeps the pieces of the input rows being gathered in cache.
+ */
+int const STACK_TILE_WIDTH = 256;
+
+/**
+ * @internal Split the rows of an output image into one band per thread
+ */
+std::vector<std::pair<int, int>> makeStackBands(int height, StatisticsControl const &sctrl) {
+    return detail::splitRange(0, height, detail::resolveNumThreads(sctrl.getNumThreads()));
+}
+
 /* ************************************************************************** *
  *
  * stack MaskedImages
@@ -115,94 +135,106 @@ void checkImageSizes(ImageT const &out, std::vector<std::shared_ptr<ImageT>> con
  *   to handle cases when we are, or are not, weighting
  *
  * Additionally, we may or may not want to weight based on the variance -- another template boolean
+ *
+ * The output is divided into bands of rows, which are stacked concurrently if sctrl.getNumThreads() != 1.
+ * Each band owns its gather buffers and is stacked in column tiles of STACK_TILE_WIDTH pixels; every output
+ * pixel sees exactly the same inputs, in the same order, as a serial stack, so the result does not depend
+ * on the number of threads.
+ *
+ * The inputs are MaskedImages, or anything else with their dimensions whose x_iterator yields MaskedImage
+ * pixels and their variances (see CompactStrip).
  */
-template <typename PixelT, bool isWeighted, bool useVariance>
+template <typename PixelT, bool isWeighted, bool useVariance, typename InputT>
 void computeMaskedImageStack(image::MaskedImage<PixelT> &imgStack,
-                             std::vector<std::shared_ptr<image::MaskedImage<PixelT>>> const &images,
-                             Property flags, StatisticsControl const &sctrl, image::MaskPixel const clipped,
+                             std::vector<std::shared_ptr<InputT>> const &images, Property flags,
+                             StatisticsControl const &sctrl, image::MaskPixel const clipped,
                              std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &maskMap,
                              WeightVector const &wvector = WeightVector()) {
-    // get a list of row_begin iterators
-    using x_iterator = typename image::MaskedImage<PixelT>::x_iterator;
-    std::vector<x_iterator> rows;
-    rows.reserve(images.size());
-
-    MaskedVector<PixelT> pixelSet(images.size());  // a pixel from x,y for each image
-    WeightVector weights;                          // weights; non-const version
-    //
-    StatisticsControl sctrlTmp(sctrl);
+    using x_iterator = typename InputT::x_iterator;
 
+    StatisticsControl sctrlTmp(sctrl);
     if (useVariance) {  // weight using the variance image
         assert(isWeighted);
         assert(wvector.empty());
 
-        weights.resize(images.size());
-
         sctrlTmp.setWeighted(true);
     } else if (isWeighted) {
-        weights.assign(wvector.begin(), wvector.end());
-
         sctrlTmp.setWeighted(true);
     }
-    assert(weights.empty() || weights.size() == images.size());
+    Property const eflags = static_cast<Property>(flags | NPOINT | ERRORS | NCLIPPED | NMASKED);
 
-    // loop over x,y ... the loop over the stack to fill pixelSet
-    // - get the stats on pixelSet and put the value in the output image at x,y
-    for (int y = 0; y != imgStack.getHeight(); ++y) {
-        for (unsigned int i = 0; i < images.size(); ++i) {
-            x_iterator ptr = images[i]->row_begin(y);
-            if (y == 0) {
-                rows.push_back(ptr);
-            } else {
-                rows[i] = ptr;
-            }
+    int const width = imgStack.getWidth();
+    auto const bands = makeStackBands(imgStack.getHeight(), sctrl);
+    int const nBands = bands.size();
+    detail::parallelFor(nBands, nBands, [&](int iBand) {
+        std::vector<x_iterator> rows;                  // the current pixel of each input image
+        rows.reserve(images.size());
+        MaskedVector<PixelT> pixelSet(images.size());  // a pixel from x,y for each image
+        WeightVector weights;                          // weights; non-const version
+        if (useVariance) {
+            weights.resize(images.size());
+        } else if (isWeighted) {
+            weights.assign(wvector.begin(), wvector.end());
         }
+        assert(weights.empty() || weights.size() == images.size());
 
-        for (x_iterator ptr = imgStack.row_begin(y), end = imgStack.row_end(y); ptr != end; ++ptr) {
-            typename MaskedVector<PixelT>::iterator psPtr = pixelSet.begin();
-            WeightVector::iterator wtPtr = weights.begin();
-            for (unsigned int i = 0; i < images.size(); ++rows[i], ++i, ++psPtr, ++wtPtr) {
-                *psPtr = *rows[i];
-                if (useVariance) {  // we're weighting using the variance
-                    *wtPtr = 1.0 / rows[i].variance();
+        for (int x0 = 0; x0 < width; x0 += STACK_TILE_WIDTH) {
+            int const tileWidth = std::min(STACK_TILE_WIDTH, width - x0);
+            for (int y = bands[iBand].first; y != bands[iBand].second; ++y) {
+                rows.clear();
+                for (auto const &im : images) {
+                    rows.push_back(im->x_at(x0, y));
                 }
-            }
 
-            Property const eflags = static_cast<Property>(flags | NPOINT | ERRORS | NCLIPPED | NMASKED);
-            Statistics stat = isWeighted ? makeStatistics(pixelSet, weights, eflags, sctrlTmp)
-                                         : makeStatistics(pixelSet, eflags, sctrlTmp);
-
-            PixelT variance = ::pow(stat.getError(flags), 2);
-            image::MaskPixel msk(stat.getOrMask());
-            int const npoint = stat.getValue(NPOINT);
-            if (npoint == 0) {
-                msk = sctrlTmp.getNoGoodPixelsMask();
-            } else if (npoint == 1) {
-                /*
-                 * you should be using sctrl.setCalcErrorFromInputVariance(true) if you want to avoid
-                 * getting a variance of NaN when you only have one input
-                 */
-            }
-            // Check to see if any pixels were rejected due to clipping
-            if (stat.getValue(NCLIPPED) > 0) {
-                msk |= clipped;
-            }
-            // Check to see if any pixels were rejected by masking, and apply
-            // any associated masks to the result.
-            if (stat.getValue(NMASKED) > 0) {
-                for (auto const &pair : maskMap) {
-                    for (auto pp = pixelSet.begin(); pp != pixelSet.end(); ++pp) {
-                        if ((*pp).mask() & pair.first) {
-                            msk |= pair.second;
-                            break;
+                // loop over the stack to fill pixelSet
+                // - get the stats on pixelSet and put the value in the output image at x,y
+                auto ptr = imgStack.x_at(x0, y);
+                for (int x = 0; x != tileWidth; ++x, ++ptr) {
+                    typename MaskedVector<PixelT>::iterator psPtr = pixelSet.begin();
+                    WeightVector::iterator wtPtr = weights.begin();
+                    for (unsigned int i = 0; i < images.size(); ++rows[i], ++i, ++psPtr, ++wtPtr) {
+                        *psPtr = *rows[i];
+                        if (useVariance) {  // we're weighting using the variance
+                            *wtPtr = 1.0 / rows[i].variance();
+                        }
+                    }
+
+                    Statistics stat = isWeighted ? makeStatistics(pixelSet, weights, eflags, sctrlTmp)
+                                                 : makeStatistics(pixelSet, eflags, sctrlTmp);
+
+                    PixelT variance = ::pow(stat.getError(flags), 2);
+                    image::MaskPixel msk(stat.getOrMask());
+                    int const npoint = stat.getValue(NPOINT);
+                    if (npoint == 0) {
+                        msk = sctrlTmp.getNoGoodPixelsMask();
+                    } else if (npoint == 1) {
+                        /*
+                         * you should be using sctrl.setCalcErrorFromInputVariance(true) if you want to avoid
+                         * getting a variance of NaN when you only have one input
+                         */
+                    }
+                    // Check to see if any pixels were rejected due to clipping
+                    if (stat.getValue(NCLIPPED) > 0) {
+                        msk |= clipped;
+                    }
+                    // Check to see if any pixels were rejected by masking, and apply
+                    // any associated masks to the result.
+                    if (stat.getValue(NMASKED) > 0) {
+                        for (auto const &pair : maskMap) {
+                            for (auto pp = pixelSet.begin(); pp != pixelSet.end(); ++pp) {
+                                if ((*pp).mask() & pair.first) {
+                                    msk |= pair.second;
+                                    break;
+                                }
+                            }
                         }
                     }
+
+                    *ptr = typename image::MaskedImage<PixelT>::Pixel(stat.getValue(flags), msk, variance);
                 }
             }
-
-            *ptr = typename image::MaskedImage<PixelT>::Pixel(stat.getValue(flags), msk, variance);
         }
-    }
+    });
 }
 template <typename PixelT, bool isWeighted, bool useVariance>
 void computeMaskedImageStack(image::MaskedImage<PixelT> &imgStack,
@@ -216,8 +248,303 @@ void computeMaskedImageStack(image::MaskedImage<PixelT> &imgStack,
 }
 //@}
 
+/**
+ * @internal Check the inputs and stack them with the instantiation of computeMaskedImageStack that
+ * the weighting requires
+ */
+template <typename PixelT, typename InputT>
+void stackMaskedImages(image::MaskedImage<PixelT> &out, std::vector<std::shared_ptr<InputT>> const &images,
+                       Property flags, StatisticsControl const &sctrl, WeightVector const &wvector,
+                       image::MaskPixel clipped,
+                       std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &maskMap) {
+    checkObjectsAndWeights(images, wvector);
+    checkOnlyOneFlag(flags);
+    checkImageSizes(out, images);
+
+    if (sctrl.getWeighted()) {
+        if (wvector.empty()) {
+            return computeMaskedImageStack<PixelT, true, true>(out, images, flags, sctrl, clipped,
+                                                               maskMap);  // use variance
+        } else {
+            return computeMaskedImageStack<PixelT, true, false>(out, images, flags, sctrl, clipped, maskMap,
+                                                                wvector);  // use wvector
+        }
+    } else {
+        return computeMaskedImageStack<PixelT, false, false>(out, images, flags, sctrl, clipped, maskMap);
+    }
+}
+
+/* ************************************************************************** *
+ *
+ * compact strips for streamingStatisticsStack
+ *
+ * ************************************************************************** */
+
+/**
+ * @internal Convert a float to IEEE binary16, rounding to nearest even
+ *
+ * Values too large for binary16 become infinities of the same sign.
+ */
+std::uint16_t floatToHalf(float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    std::uint16_t const sign = (bits >> 16) & 0x8000;
+    std::uint32_t const abs = bits & 0x7fffffff;
+    if (abs >= 0x7f800000) {  // infinity or NaN
+        return sign | 0x7c00 | (abs > 0x7f800000 ? 0x200 : 0);
+    }
+    if (abs >= 0x477ff000) {  // rounds to 65520 or more
+        return sign | 0x7c00;
+    }
+    if (abs >= 0x38800000) {  // a normal binary16 value
+        std::uint32_t half = (abs >> 13) - (112 << 10);  // rebias the exponent from 127 to 15
+        std::uint32_t const rest = abs & 0x1fff;
+        if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) {
+            ++half;  // may carry into the exponent, which is still correct
+        }
+        return sign | half;
+    }
+    if (abs <= 0x33000000) {  // no more than half the smallest subnormal binary16 value, 2^-24
+        return sign;
+    }
+    // a subnormal binary16 value: a multiple of 2^-24
+    int const shift = 126 - static_cast<int>(abs >> 23);
+    std::uint32_t const mantissa = (abs & 0x7fffff) | 0x800000;
+    std::uint32_t half = mantissa >> shift;
+    std::uint32_t const rest = mantissa & ((1u << shift) - 1);
+    std::uint32_t const halfway = 1u << (shift - 1);
+    if (rest > halfway || (rest == halfway && (half & 1))) {
+        ++half;
+    }
+    return sign | half;
+}
+
+/// @internal Convert an IEEE binary16 value to a float; the conversion is exact
+float halfToFloat(std::uint16_t half) {
+    std::uint32_t const sign = static_cast<std::uint32_t>(half & 0x8000) << 16;
+    std::uint32_t const exponent = (half >> 10) & 0x1f;
+    std::uint32_t const mantissa = half & 0x3ff;
+    if (exponent == 0) {  // zero or subnormal
+        float const value = mantissa * 5.9604644775390625e-8f;  // 2^-24
+        return sign ? -value : value;
+    }
+    std::uint32_t const bits =
+            sign | (exponent == 0x1f ? 0x7f800000 : (exponent + 112) << 23) | (mantissa << 13);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @internal Return the power of two by which to multiply values whose largest finite absolute value is
+ * maxAbs so that they are all less than 2^15, safely within the range of binary16
+ *
+ * An error of half a binary16 ulp of the largest scaled values is then 2^(3 - exponent) before scaling.
+ * Zero is returned if maxAbs is zero.
+ */
+int getHalfExponent(double maxAbs) {
+    if (maxAbs == 0.0) {
+        return 0;
+    }
+    int exponent;
+    std::frexp(maxAbs, &exponent);  // maxAbs < 2^exponent
+    return 15 - exponent;
+}
+
+/// @internal The code for NaN in a SCALED_INT16 image; the other codes are in [-32767, 32767]
+std::int16_t const SCALED_NAN = std::numeric_limits<std::int16_t>::min();
+
+/**
+ * @internal A strip of an input to streamingStatisticsStack, held as compactly as a StackSampleStorage
+ * allows (see StackSampleStorage for the encodings and their errors)
+ *
+ * Its x_iterator supports just what computeMaskedImageStack needs: the decoded value of the current pixel,
+ * its variance, and moving on to the next pixel of the row.  Decoding touches no reference counts, so a
+ * CompactStrip may be read from many threads at once.
+ */
+template <typename PixelT>
+class CompactStrip final {
+public:
+    using Pixel = typename image::MaskedImage<PixelT>::Pixel;
+
+    class x_iterator {
+    public:
+        x_iterator(CompactStrip const *strip, std::size_t index) : _strip(strip), _index(index) {}
+
+        Pixel operator*() const {
+            return Pixel(_strip->_getImage(_index), _strip->_getMask(_index), _strip->_getVariance(_index));
+        }
+
+        image::VariancePixel variance() const { return _strip->_getVariance(_index); }
+
+        x_iterator &operator++() {
+            ++_index;
+            return *this;
+        }
+
+    private:
+        CompactStrip const *_strip;
+        std::size_t _index;
+    };
+
+    CompactStrip(image::MaskedImage<PixelT> const &strip, StackSampleStorage const &storage)
+            : _dimensions(strip.getDimensions()),
+              _imagePrecision(StackSampleStorage::FULL),
+              _imageScale(1.0),
+              _imageOffset(0.0),
+              _varianceScale(1.0),
+              _smallMask(false) {
+        _setImage(*strip.getImage(), storage);
+        _setVariance(*strip.getVariance());
+        _setMask(*strip.getMask());
+    }
+
+    lsst::geom::Extent2I getDimensions() const noexcept { return _dimensions; }
+
+    x_iterator x_at(int x, int y) const {
+        return x_iterator(this, static_cast<std::size_t>(y) * _dimensions.getX() + x);
+    }
+
+private:
+    template <typename T, typename F>
+    static void _forEachPixel(image::ImageBase<T> const &image, F func) {
+        std::size_t i = 0;
+        for (int y = 0; y < image.getHeight(); ++y) {
+            for (auto ptr = image.row_begin(y), end = image.row_end(y); ptr != end; ++ptr, ++i) {
+                func(i, *ptr);
+            }
+        }
+    }
+
+    void _setImage(image::Image<PixelT> const &image, StackSampleStorage const &storage) {
+        std::size_t const n = image.getArea();
+        double min = std::numeric_limits<double>::infinity();
+        double max = -min;
+        bool hasInfinity = false;
+        _forEachPixel(image, [&](std::size_t, PixelT value) {
+            if (std::isfinite(value)) {
+                min = std::min<double>(min, value);
+                max = std::max<double>(max, value);
+            } else if (std::isinf(value)) {
+                hasInfinity = true;
+            }
+        });
+        bool const hasFinite = min <= max;
+        double const maxAbs = hasFinite ? std::max(std::fabs(min), std::fabs(max)) : 0.0;
+        // allow for rounding to float, or to PixelT when a value is decoded
+        double const roundingError = maxAbs * std::numeric_limits<float>::epsilon();
+
+        if (storage.getPrecision() == StackSampleStorage::HALF) {
+            int const exponent = getHalfExponent(maxAbs);
+            double const error = maxAbs == 0.0 ? 0.0 : std::ldexp(1.0, 3 - exponent) + roundingError;
+            if (error <= storage.getMaxImageError()) {
+                _imagePrecision = StackSampleStorage::HALF;
+                _imageScale = std::ldexp(1.0, -exponent);
+                _halfImage.resize(n);
+                _forEachPixel(image, [&](std::size_t i, PixelT value) {
+                    _halfImage[i] = floatToHalf(static_cast<float>(std::ldexp(value, exponent)));
+                });
+                return;
+            }
+        } else if (storage.getPrecision() == StackSampleStorage::SCALED_INT16 && !hasInfinity) {
+            double const scale = hasFinite ? (max - min) / 65534.0 : 0.0;
+            double const error = 0.5 * scale + roundingError;
+            if (error <= storage.getMaxImageError()) {
+                _imagePrecision = StackSampleStorage::SCALED_INT16;
+                _imageScale = scale;
+                _imageOffset = hasFinite ? 0.5 * (min + max) : 0.0;
+                _scaledImage.resize(n);
+                _forEachPixel(image, [&](std::size_t i, PixelT value) {
+                    if (std::isnan(value)) {
+                        _scaledImage[i] = SCALED_NAN;
+                    } else if (scale == 0.0) {
+                        _scaledImage[i] = 0;
+                    } else {
+                        double const code = std::round((value - _imageOffset) / scale);
+                        _scaledImage[i] =
+                                static_cast<std::int16_t>(std::max(-32767.0, std::min(32767.0, code)));
+                    }
+                });
+                return;
+            }
+        }
+        _image.resize(n);
+        _forEachPixel(image, [&](std::size_t i, PixelT value) { _image[i] = value; });
+    }
+
+    void _setVariance(image::Image<image::VariancePixel> const &variance) {
+        double maxAbs = 0.0;
+        _forEachPixel(variance, [&](std::size_t, image::VariancePixel value) {
+            if (std::isfinite(value)) {
+                maxAbs = std::max<double>(maxAbs, std::fabs(value));
+            }
+        });
+        int const exponent = getHalfExponent(maxAbs);
+        _varianceScale = std::ldexp(1.0, -exponent);
+        _halfVariance.resize(variance.getArea());
+        _forEachPixel(variance, [&](std::size_t i, image::VariancePixel value) {
+            _halfVariance[i] = floatToHalf(static_cast<float>(std::ldexp(value, exponent)));
+        });
+    }
+
+    void _setMask(image::Mask<image::MaskPixel> const &mask) {
+        image::MaskPixel orMask = 0;
+        _forEachPixel(mask, [&](std::size_t, image::MaskPixel value) { orMask |= value; });
+        _smallMask = (orMask & ~static_cast<image::MaskPixel>(0xffff)) == 0;
+        if (_smallMask) {
+            _smallMasks.resize(mask.getArea());
+            _forEachPixel(mask, [&](std::size_t i, image::MaskPixel value) {
+                _smallMasks[i] = static_cast<std::uint16_t>(value);
+            });
+        } else {
+            _masks.resize(mask.getArea());
+            _forEachPixel(mask, [&](std::size_t i, image::MaskPixel value) { _masks[i] = value; });
+        }
+    }
+
+    PixelT _getImage(std::size_t i) const {
+        switch (_imagePrecision) {
+            case StackSampleStorage::HALF:
+                return static_cast<PixelT>(halfToFloat(_halfImage[i]) * _imageScale);
+            case StackSampleStorage::SCALED_INT16:
+                return _scaledImage[i] == SCALED_NAN
+                               ? std::numeric_limits<PixelT>::quiet_NaN()
+                               : static_cast<PixelT>(_imageOffset + _imageScale * _scaledImage[i]);
+            default:
+                return _image[i];
+        }
+    }
+
+    image::VariancePixel _getVariance(std::size_t i) const {
+        return static_cast<image::VariancePixel>(halfToFloat(_halfVariance[i]) * _varianceScale);
+    }
+
+    image::MaskPixel _getMask(std::size_t i) const { return _smallMask ? _smallMasks[i] : _masks[i]; }
+
+    lsst::geom::Extent2I _dimensions;
+    StackSampleStorage::Precision _imagePrecision;
+    std::vector<PixelT> _image;              // if _imagePrecision is FULL
+    std::vector<std::uint16_t> _halfImage;   // image/_imageScale as binary16, if HALF
+    std::vector<std::int16_t> _scaledImage;  // (image - _imageOffset)/_imageScale or SCALED_NAN, if SCALED
+    double _imageScale;
+    double _imageOffset;
+    std::vector<std::uint16_t> _halfVariance;  // variance/_varianceScale as binary16
+    double _varianceScale;
+    bool _smallMask;  // are the masks held in _smallMasks rather than _masks?
+    std::vector<std::uint16_t> _smallMasks;
+    std::vector<image::MaskPixel> _masks;
+};
+
 }  // end anonymous namespace
 
+StackSampleStorage::StackSampleStorage(Precision precision, double maxImageError)
+        : _precision(precision), _maxImageError(maxImageError) {
+    if (!(maxImageError > 0.0)) {
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError,
+                          str(boost::format("maxImageError = %g is not positive") % maxImageError));
+    }
+}
+
 template <typename PixelT>
 std::shared_ptr<image::MaskedImage<PixelT>> statisticsStack(
         std::vector<std::shared_ptr<image::MaskedImage<PixelT>>> &images, Property flags,
@@ -278,21 +605,73 @@ void statisticsStack(image::MaskedImage<PixelT> &out,
                      std::vector<std::shared_ptr<image::MaskedImage<PixelT>>> &images, Property flags,
                      StatisticsControl const &sctrl, WeightVector const &wvector, image::MaskPixel clipped,
                      std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &maskMap) {
-    checkObjectsAndWeights(images, wvector);
+    stackMaskedImages(out, images, flags, sctrl, wvector, clipped, maskMap);
+}
+
+template <typename PixelT>
+void streamingStatisticsStack(std::vector<MaskedImageStripReader<PixelT>> const &readers,
+                              lsst::geom::Box2I const &bbox, Property flags,
+                              MaskedImageStripWriter<PixelT> const &writer, StatisticsControl const &sctrl,
+                              WeightVector const &wvector, image::MaskPixel clipped,
+                              std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &maskMap,
+                              int stripHeight, StackSampleStorage const &storage) {
+    checkObjectsAndWeights(readers, wvector);
     checkOnlyOneFlag(flags);
-    checkImageSizes(out, images);
+    if (stripHeight <= 0) {
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError,
+                          str(boost::format("stripHeight = %d <= 0") % stripHeight));
+    }
 
-    if (sctrl.getWeighted()) {
-        if (wvector.empty()) {
-            return computeMaskedImageStack<PixelT, true, true>(out, images, flags, sctrl, clipped,
-                                                               maskMap);  // use variance
+    // Unless the strips are held at full precision, each one is encoded as soon as it has been read,
+    // so that only one input strip at a time is ever held at full precision
+    bool const compact = storage.getPrecision() != StackSampleStorage::FULL;
+    std::vector<std::shared_ptr<image::MaskedImage<PixelT>>> strips(readers.size());
+    std::vector<std::shared_ptr<CompactStrip<PixelT>>> compactStrips(compact ? readers.size() : 0);
+    for (int y0 = bbox.getMinY(); y0 <= bbox.getMaxY(); y0 += stripHeight) {
+        lsst::geom::Box2I const stripBox(
+                lsst::geom::Point2I(bbox.getMinX(), y0),
+                lsst::geom::Extent2I(bbox.getWidth(), std::min(stripHeight, bbox.getMaxY() - y0 + 1)));
+        image::MaskedImage<PixelT> out(stripBox);
+        for (unsigned int i = 0; i < readers.size(); ++i) {
+            strips[i].reset();  // release the previous strip before reading the next one
+            if (compact) {
+                compactStrips[i].reset();
+            }
+            strips[i] = readers[i](stripBox);
+            if (!strips[i]) {
+                throw LSST_EXCEPT(pexExcept::InvalidParameterError,
+                                  str(boost::format("Reader %d returned no strip") % i));
+            }
+            if (compact) {
+                compactStrips[i] = std::make_shared<CompactStrip<PixelT>>(*strips[i], storage);
+                strips[i].reset();
+            }
+        }
+
+        if (compact) {
+            stackMaskedImages(out, compactStrips, flags, sctrl, wvector, clipped, maskMap);
         } else {
-            return computeMaskedImageStack<PixelT, true, false>(out, images, flags, sctrl, clipped, maskMap,
-                                                                wvector);  // use wvector
+            statisticsStack(out, strips, flags, sctrl, wvector, clipped, maskMap);
         }
-    } else {
-        return computeMaskedImageStack<PixelT, false, false>(out, images, flags, sctrl, clipped, maskMap);
+        writer(out);
+    }
+}
+
+template <typename PixelT>
+void streamingStatisticsStack(std::vector<MaskedImageStripReader<PixelT>> const &readers,
+                              lsst::geom::Box2I const &bbox, Property flags,
+                              MaskedImageStripWriter<PixelT> const &writer, StatisticsControl const &sctrl,
+                              WeightVector const &wvector, image::MaskPixel clipped, image::MaskPixel excuse,
+                              int stripHeight, StackSampleStorage const &storage) {
+    if (!sctrl.getWeighted() && !wvector.empty()) {
+        LOGL_WARN(_log,
+                  "Weights passed on to streamingStatisticsStack are ignored as sctrl.getWeighted() is False."
+                  "Set sctrl.setWeighted(True) for them to be used.");
     }
+    std::vector<std::pair<image::MaskPixel, image::MaskPixel>> maskMap;
+    maskMap.emplace_back(sctrl.getAndMask() & ~excuse, clipped);
+    streamingStatisticsStack(readers, bbox, flags, writer, sctrl, wvector, clipped, maskMap, stripHeight,
+                             storage);
 }
 
 namespace {
@@ -315,30 +694,42 @@ template <typename PixelT, bool isWeighted>
 void computeImageStack(image::Image<PixelT> &imgStack,
                        std::vector<std::shared_ptr<image::Image<PixelT>>> &images, Property flags,
                        StatisticsControl const &sctrl, WeightVector const &weights = WeightVector()) {
-    MaskedVector<PixelT> pixelSet(images.size());  // a pixel from x,y for each image
-    StatisticsControl sctrlTmp(sctrl);
-
-    // set the mask to be an infinite iterator
-    MaskImposter<image::MaskPixel> msk;
+    using x_iterator = typename image::Image<PixelT>::x_iterator;
 
+    StatisticsControl sctrlTmp(sctrl);
     if (!weights.empty()) {
         sctrlTmp.setWeighted(true);
     }
 
-    // get the desired statistic
-    for (int y = 0; y != imgStack.getHeight(); ++y) {
-        for (int x = 0; x != imgStack.getWidth(); ++x) {
-            for (unsigned int i = 0; i != images.size(); ++i) {
-                (*pixelSet.getImage())(i, 0) = (*images[i])(x, y);
-            }
+    // get the desired statistic, one band of rows per thread (see computeMaskedImageStack)
+    int const width = imgStack.getWidth();
+    auto const bands = makeStackBands(imgStack.getHeight(), sctrl);
+    int const nBands = bands.size();
+    detail::parallelFor(nBands, nBands, [&](int iBand) {
+        std::vector<x_iterator> rows;                  // the current pixel of each input image
+        rows.reserve(images.size());
+        MaskedVector<PixelT> pixelSet(images.size());  // a pixel from x,y for each image
+        auto &pixelSetImage = *pixelSet.getImage();
 
-            if (isWeighted) {
-                imgStack(x, y) = makeStatistics(pixelSet, weights, flags, sctrlTmp).getValue();
-            } else {
-                imgStack(x, y) = makeStatistics(pixelSet, weights, flags, sctrlTmp).getValue();
+        for (int x0 = 0; x0 < width; x0 += STACK_TILE_WIDTH) {
+            int const tileWidth = std::min(STACK_TILE_WIDTH, width - x0);
+            for (int y = bands[iBand].first; y != bands[iBand].second; ++y) {
+                rows.clear();
+                for (auto const &im : images) {
+                    rows.push_back(im->x_at(x0, y));
+                }
+
+                x_iterator ptr = imgStack.x_at(x0, y);
+                for (int x = 0; x != tileWidth; ++x, ++ptr) {
+                    for (unsigned int i = 0; i != images.size(); ++rows[i], ++i) {
+                        pixelSetImage(i, 0) = *rows[i];
+                    }
+
+                    *ptr = makeStatistics(pixelSet, weights, flags, sctrlTmp).getValue();
+                }
             }
         }
-    }
+    });
 }
 
 }  // end anonymous namespace
@@ -527,6 +918,178 @@ std::shared_ptr<image::MaskedImage<PixelT>> statisticsStack(image::MaskedImage<P
     return imgOut;
 }
 
+/* ************************************************************************ *
+ *
+ * accumulated stacks
+ *
+ * ************************************************************************ */
+
+template <typename PixelT>
+StackAccumulator<PixelT>::StackAccumulator(lsst::geom::Box2I const &bbox, Property flags,
+                                           StatisticsControl const &sctrl, image::MaskPixel clipped,
+                                           image::MaskPixel excuse)
+        : _bbox(bbox),
+          _flags(flags),
+          _sctrl(sctrl),
+          _clipped(clipped),
+          _clippedMask(sctrl.getAndMask() & ~excuse),
+          _propagatedBits(),
+          _numInputs(0) {
+    checkOnlyOneFlag(flags);
+    Property const stat = static_cast<Property>(flags & ~ERRORS);
+    if (stat != MEAN && stat != VARIANCE) {
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError,
+                          "StackAccumulator only supports MEAN and VARIANCE; use statisticsStack instead");
+    }
+    if (sctrl.getCalcErrorFromInputVariance() && sctrl.getCalcErrorMosaicMode()) {
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError,
+                          "Both calcErrorFromInputVariance and calcErrorMosaicMode are True");
+    }
+    // a rejected fraction can never exceed a threshold of 1
+    for (int bit = 0; bit < std::numeric_limits<image::MaskPixel>::digits; ++bit) {
+        if (sctrl.getMaskPropagationThreshold(bit) < 1.0) {
+            _propagatedBits.push_back(bit);
+        }
+    }
+
+    std::size_t const nPix = bbox.getArea();
+    _n.assign(nPix, 0);
+    _sumw.assign(nPix, 0.0);
+    _sumw2.assign(nPix, 0.0);
+    _mean.assign(nPix, 0.0);
+    _m2.assign(nPix, 0.0);
+    if (sctrl.getCalcErrorFromInputVariance() || sctrl.getCalcErrorMosaicMode()) {
+        _sumvw.assign(nPix, 0.0);
+    }
+    _orMask.assign(nPix, 0);
+    _allMask.assign(nPix, 0);
+    _rejectedWeights.assign(nPix * _propagatedBits.size(), 0.0);
+}
+
+template <typename PixelT>
+void StackAccumulator<PixelT>::add(image::MaskedImage<PixelT> const &maskedImage) {
+    _add<true>(maskedImage, 1.0);
+}
+
+template <typename PixelT>
+void StackAccumulator<PixelT>::add(image::MaskedImage<PixelT> const &maskedImage, double weight) {
+    _add<false>(maskedImage, weight);
+}
+
+template <typename PixelT>
+template <bool useVariance>
+void StackAccumulator<PixelT>::_add(image::MaskedImage<PixelT> const &maskedImage, double weight) {
+    if (maskedImage.getDimensions() != _bbox.getDimensions()) {
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError,
+                          (boost::format("Bad dimensions for image %d: %dx%d vs %dx%d") % _numInputs %
+                           maskedImage.getWidth() % maskedImage.getHeight() % _bbox.getWidth() %
+                           _bbox.getHeight())
+                                  .str());
+    }
+
+    bool const isWeighted = _sctrl.getWeighted();
+    bool const isNanSafe = _sctrl.getNanSafe();
+    bool const calcErrorFromInputVariance = _sctrl.getCalcErrorFromInputVariance();
+    bool const calcErrorMosaicMode = _sctrl.getCalcErrorMosaicMode();
+    image::MaskPixel const andMask = _sctrl.getAndMask();
+    std::size_t const nPix = _n.size();
+    int const nBits = _propagatedBits.size();
+
+    std::size_t i = 0;
+    for (int y = 0; y != maskedImage.getHeight(); ++y) {
+        for (auto ptr = maskedImage.row_begin(y), end = maskedImage.row_end(y); ptr != end; ++ptr, ++i) {
+            double const value = ptr.image();
+            image::MaskPixel const mask = ptr.mask();
+            double const var = ptr.variance();
+            double const w = isWeighted ? (useVariance ? 1.0 / var : weight) : 1.0;
+
+            _allMask[i] |= mask;
+            if ((isNanSafe && !std::isfinite(value)) || (mask & andMask)) {
+                for (int b = 0; b < nBits; ++b) {
+                    if (mask & (1 << _propagatedBits[b])) {
+                        _rejectedWeights[b * nPix + i] += w;
+                    }
+                }
+                continue;
+            }
+
+            // West's weighted version of Welford's algorithm
+            double const sumw = _sumw[i] + w;
+            double const delta = value - _mean[i];
+            if (sumw != 0.0) {
+                _mean[i] += delta * w / sumw;
+            }
+            _m2[i] += w * delta * (value - _mean[i]);
+            _sumw[i] = sumw;
+            _sumw2[i] += w * w;
+            if (calcErrorFromInputVariance) {
+                _sumvw[i] += var * w * w;
+            } else if (calcErrorMosaicMode) {
+                _sumvw[i] += var * w;
+            }
+            _orMask[i] |= mask;
+            ++_n[i];
+        }
+    }
+    ++_numInputs;
+}
+
+template <typename PixelT>
+std::shared_ptr<image::MaskedImage<PixelT>> StackAccumulator<PixelT>::finish() const {
+    double const NaN = std::numeric_limits<double>::quiet_NaN();
+    bool const isMean = (_flags & ~ERRORS) == MEAN;
+    bool const calcErrorFromInputVariance = _sctrl.getCalcErrorFromInputVariance();
+    bool const calcErrorMosaicMode = _sctrl.getCalcErrorMosaicMode();
+    std::size_t const nPix = _n.size();
+    int const nBits = _propagatedBits.size();
+
+    auto out = std::make_shared<image::MaskedImage<PixelT>>(_bbox);
+    std::size_t i = 0;
+    for (int y = 0; y != out->getHeight(); ++y) {
+        for (auto ptr = out->row_begin(y), end = out->row_end(y); ptr != end; ++ptr, ++i) {
+            int const n = _n[i];
+            double const sumw = _sumw[i];
+            double const sumw2 = _sumw2[i];
+
+            // N.b. as in Statistics, n == 0 or n == 1 give NaNs
+            double const mean = (n > 0 && sumw != 0.0) ? _mean[i] : NaN;
+            double const variance = _m2[i] / sumw * (sumw * sumw / (sumw * sumw - sumw2));
+            double value, error2;
+            if (isMean) {
+                value = mean;
+                if (calcErrorFromInputVariance) {
+                    error2 = _sumvw[i] / (sumw * sumw);
+                } else if (calcErrorMosaicMode) {
+                    error2 = _sumvw[i] / sumw;
+                } else {
+                    error2 = variance * sumw2 / (sumw * sumw);
+                }
+            } else {
+                value = variance;
+                error2 = 2 * (n - 1) * variance * variance / static_cast<double>(n * n);
+            }
+
+            image::MaskPixel msk = _orMask[i];
+            for (int b = 0; b < nBits; ++b) {
+                double const rejected = _rejectedWeights[b * nPix + i];
+                int const bit = _propagatedBits[b];
+                if (rejected / (sumw + rejected) > _sctrl.getMaskPropagationThreshold(bit)) {
+                    msk |= (1 << bit);
+                }
+            }
+            if (n == 0) {
+                msk = _sctrl.getNoGoodPixelsMask();
+            }
+            if (_allMask[i] & _clippedMask) {
+                msk |= _clipped;
+            }
+
+            *ptr = typename image::MaskedImage<PixelT>::Pixel(value, msk, error2);
+        }
+    }
+    return out;
+}
+
 /*
  * Explicit Instantiations
  *
@@ -555,6 +1118,17 @@ std::shared_ptr<image::MaskedImage<PixelT>> statisticsStack(image::MaskedImage<P
             image::MaskedImage<TYPE> & out, std::vector<std::shared_ptr<image::MaskedImage<TYPE>>> & images, \
             Property flags, StatisticsControl const &sctrl, WeightVector const &wvector, image::MaskPixel,   \
             std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &);                             \
+    template void streamingStatisticsStack<TYPE>(                                                            \
+            std::vector<MaskedImageStripReader<TYPE>> const &readers, lsst::geom::Box2I const &bbox,         \
+            Property flags, MaskedImageStripWriter<TYPE> const &writer, StatisticsControl const &sctrl,      \
+            WeightVector const &wvector, image::MaskPixel,                                                   \
+            std::vector<std::pair<image::MaskPixel, image::MaskPixel>> const &, int,                         \
+            StackSampleStorage const &);                                                                     \
+    template void streamingStatisticsStack<TYPE>(                                                            \
+            std::vector<MaskedImageStripReader<TYPE>> const &readers, lsst::geom::Box2I const &bbox,         \
+            Property flags, MaskedImageStripWriter<TYPE> const &writer, StatisticsControl const &sctrl,      \
+            WeightVector const &wvector, image::MaskPixel, image::MaskPixel, int,                            \
+            StackSampleStorage const &);                                                                     \
     template std::vector<TYPE> statisticsStack<TYPE>(                                       \
             std::vector<std::vector<TYPE>> & vectors, Property flags,                       \
             StatisticsControl const &sctrl, WeightVector const &wvector);                                    \
@@ -567,6 +1141,9 @@ std::shared_ptr<image::MaskedImage<PixelT>> statisticsStack(image::MaskedImage<P
 
 INSTANTIATE_STACKS(double)
 INSTANTIATE_STACKS(float)
+
+template class StackAccumulator<double>;
+template class StackAccumulator<float>;
 /// @endcond
 }  // namespace math
 }  // namespace afw
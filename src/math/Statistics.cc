@@ -25,8 +25,13 @@
 /*
  * Support statistical operations on images
  */
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
 #include <tuple>
 #include <type_traits>
 #include <string>
@@ -35,6 +40,7 @@
 
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/image/Image.h"
+#include "lsst/afw/math/Instrumentation.h"
 #include "lsst/afw/math/Statistics.h"
 #include "lsst/geom/Angle.h"
 
@@ -139,6 +145,53 @@ inline double varianceError(double const variance, int const n) {
 /// @internal return type for processPixels
 using StandardReturn = std::tuple<int, double, Statistics::Value, Statistics::Value, double, double, image::MaskPixel>;
 
+/**
+ * @internal Turn the sums accumulated by processPixels into a StandardReturn
+ *
+ * @param n       number of pixels accepted
+ * @param sumw    sum(weight)
+ * @param sumw2   sum(weight^2)
+ * @param sumx    sum(weight*(data - meanCrude))
+ * @param sumx2   sum(weight*(data - meanCrude)^2)
+ * @param sumvw   sum(variance*weight)
+ * @param sumvw2  sum(variance*weight^2)
+ */
+StandardReturn makeStandardReturn(int const n, double const sumw, double const sumw2, double sumx,
+                                  double const sumx2, double const sumvw, double const sumvw2,
+                                  double const meanCrude, double min, double max,
+                                  image::MaskPixel const allPixelOrMask,
+                                  bool const calcErrorFromInputVariance, bool const calcErrorMosaicMode) {
+    if (n == 0) {
+        min = NaN;
+        max = NaN;
+    }
+
+    // estimate of population mean and variance.
+    // N.b. if sumw == 0 or sumw*sumw == sumw2 (e.g. n == 1) we'll get NaNs
+    // N.b. the estimator of the variance assumes that the sample points all have the same variance;
+    // otherwise, what is it that we're estimating?
+    double mean = sumx / sumw;
+    double variance = sumx2 / sumw - ::pow(mean, 2);  // biased estimator
+    variance *= sumw * sumw / (sumw * sumw - sumw2);  // debias
+
+    double meanVar;  // (standard error of mean)^2
+    if (calcErrorFromInputVariance) {
+        meanVar = sumvw2 / (sumw * sumw);
+    } else if (calcErrorMosaicMode){
+        meanVar = sumvw / sumw;
+    } else {
+        meanVar = variance * sumw2 / (sumw * sumw);
+    }
+
+    double varVar = varianceError(variance, n);  // error in variance; incorrect if useWeights is true
+
+    sumx += sumw * meanCrude;
+    mean += meanCrude;
+
+    return StandardReturn(n, sumx, Statistics::Value(mean, meanVar), Statistics::Value(variance, varVar), min,
+                          max, allPixelOrMask);
+}
+
 /*
  * Functions which convert the booleans into calls to the proper templated types, one type per
  * recursion level
@@ -256,13 +309,6 @@ StandardReturn processPixels(ImageT const &img, MaskT const &msk, VarianceT cons
             }
         }
     }
-    if (n == 0) {
-        min = NaN;
-        max = NaN;
-    }
-
-    // estimate of population mean and variance.
-    double mean, variance;
     if (!useWeights) {
         sumw = sumw2 = n;
     }
@@ -275,29 +321,102 @@ StandardReturn processPixels(ImageT const &img, MaskT const &msk, VarianceT cons
         }
     }
 
-    // N.b. if sumw == 0 or sumw*sumw == sumw2 (e.g. n == 1) we'll get NaNs
-    // N.b. the estimator of the variance assumes that the sample points all have the same variance;
-    // otherwise, what is it that we're estimating?
-    mean = sumx / sumw;
-    variance = sumx2 / sumw - ::pow(mean, 2);         // biased estimator
-    variance *= sumw * sumw / (sumw * sumw - sumw2);  // debias
+    return makeStandardReturn(n, sumw, sumw2, sumx, sumx2, sumvw, sumvw2, meanCrude, min, max, allPixelOrMask,
+                              calcErrorFromInputVariance, calcErrorMosaicMode);
+}
 
-    double meanVar;  // (standard error of mean)^2
-    if (calcErrorFromInputVariance) {
-        meanVar = sumvw2 / (sumw * sumw);
-    } else if (calcErrorMosaicMode){
-        meanVar = sumvw / sumw;
-    } else {
-        meanVar = variance * sumw2 / (sumw * sumw);
-    }
+/**
+ * @internal Is ImageT a plain Image and MaskT a Mask, so processPixelsUnweighted can handle them?
+ */
+template <typename ImageT, typename MaskT>
+struct IsImageWithMask : std::false_type {};
 
-    double varVar = varianceError(variance, n);  // error in variance; incorrect if useWeights is true
+template <typename PixelT>
+struct IsImageWithMask<image::Image<PixelT>, image::Mask<image::MaskPixel>> : std::true_type {};
 
-    sumx += sumw * meanCrude;
-    mean += meanCrude;
+/**
+ * @internal A version of processPixels for unweighted statistics of an Image with a Mask
+ *
+ * Used when neither weights, nor input variances, nor mask propagation thresholds are needed. The
+ * pixel tests are evaluated without branches and each row is swept in blocks of `nLanes` pixels, with
+ * an independent set of accumulators for each position in a block, so that the compiler can vectorise
+ * the whole sweep. The results are those of processPixels, up to the order in which the sums are
+ * accumulated.
+ */
+template <typename IsFinite, typename HasValueLtMin, typename HasValueGtMax, typename InClipRange,
+          typename PixelT>
+StandardReturn processPixelsUnweighted(image::Image<PixelT> const &img,
+                                       image::Mask<image::MaskPixel> const &msk, int const nCrude,
+                                       int const stride, double const meanCrude, double const cliplimit,
+                                       int const andMask) {
+    constexpr int nLanes = 8;
+    bool const checkFinite = std::is_same<IsFinite, CheckFinite>::value;
+    bool const checkMin = std::is_same<HasValueLtMin, CheckValueLtMin>::value;
+    bool const checkMax = std::is_same<HasValueGtMax, CheckValueGtMax>::value;
+    bool const checkClip = std::is_same<InClipRange, CheckClipRange>::value;
+
+    std::array<int, nLanes> n{};
+    std::array<double, nLanes> sumx{};
+    std::array<double, nLanes> sumx2{};
+    std::array<double, nLanes> min;
+    std::array<double, nLanes> max;
+    std::array<image::MaskPixel, nLanes> orMask{};
+    min.fill((nCrude) ? meanCrude : MAX_DOUBLE);
+    max.fill((nCrude) ? meanCrude : -MAX_DOUBLE);
+
+    // accumulate one pixel into lane l
+    auto accumulate = [&](PixelT const value, image::MaskPixel const mask, int const l) {
+        bool good = !(mask & andMask);
+        if (checkFinite) {
+            float const fvalue = static_cast<float>(value);
+            good &= (fvalue - fvalue == 0.0f);  // false for NaN and +-Inf
+        }
+        double const delta = value - meanCrude;
+        if (checkClip) {
+            good &= (std::fabs(delta) <= cliplimit);
+        }
+        double const gdelta = good ? delta : 0.0;
+        n[l] += good;
+        sumx[l] += gdelta;
+        sumx2[l] += gdelta * gdelta;
+        orMask[l] |= good ? mask : 0;
+        if (checkMin) {
+            min[l] = (good && value < min[l]) ? static_cast<double>(value) : min[l];
+        }
+        if (checkMax) {
+            max[l] = (good && value > max[l]) ? static_cast<double>(value) : max[l];
+        }
+    };
 
-    return StandardReturn(n, sumx, Statistics::Value(mean, meanVar), Statistics::Value(variance, varVar), min,
-                          max, allPixelOrMask);
+    int const width = img.getWidth();
+    auto const imgArray = img.getArray();
+    auto const mskArray = msk.getArray();
+    for (int iY = 0; iY < img.getHeight(); iY += stride) {
+        PixelT const *ptr = imgArray[iY].getData();
+        image::MaskPixel const *mptr = mskArray[iY].getData();
+        int x = 0;
+        for (; x + nLanes <= width; x += nLanes) {
+            for (int l = 0; l < nLanes; ++l) {
+                accumulate(ptr[x + l], mptr[x + l], l);
+            }
+        }
+        for (int l = 0; x < width; ++x, ++l) {
+            accumulate(ptr[x], mptr[x], l);
+        }
+    }
+
+    for (int l = 1; l < nLanes; ++l) {
+        n[0] += n[l];
+        sumx[0] += sumx[l];
+        sumx2[0] += sumx2[l];
+        min[0] = std::min(min[0], min[l]);
+        max[0] = std::max(max[0], max[l]);
+        orMask[0] |= orMask[l];
+    }
+
+    double const sumw = n[0];
+    return makeStandardReturn(n[0], sumw, sumw, sumx[0], sumx2[0], 0.0, 0.0, meanCrude, min[0], max[0],
+                              orMask[0], false, false);
 }
 
 template <typename IsFinite, typename HasValueLtMin, typename HasValueGtMax, typename InClipRange,
@@ -313,6 +432,16 @@ StandardReturn processPixels(ImageT const &img, MaskT const &msk, VarianceT cons
                 img, msk, var, weights, flags, nCrude, 1, meanCrude, cliplimit, weightsAreMultiplicative,
                 andMask, calcErrorFromInputVariance, calcErrorMosaicMode, maskPropagationThresholds);
     } else {
+        if constexpr (IsImageWithMask<ImageT, MaskT>::value) {
+            // a rejected fraction can never exceed a threshold of 1
+            bool const propagateMasks =
+                    std::any_of(maskPropagationThresholds.begin(), maskPropagationThresholds.end(),
+                                [](double threshold) { return threshold < 1.0; });
+            if (!calcErrorFromInputVariance && !calcErrorMosaicMode && !propagateMasks) {
+                return processPixelsUnweighted<IsFinite, HasValueLtMin, HasValueGtMax, InClipRange>(
+                        img, msk, nCrude, 1, meanCrude, cliplimit, andMask);
+            }
+        }
         return processPixels<IsFinite, HasValueLtMin, HasValueGtMax, InClipRange, false>(
                 img, msk, var, weights, flags, nCrude, 1, meanCrude, cliplimit, weightsAreMultiplicative,
                 andMask, calcErrorFromInputVariance, calcErrorMosaicMode, maskPropagationThresholds);
@@ -463,6 +592,160 @@ StandardReturn getStandard(ImageT const &img, MaskT const &msk, VarianceT const
     }
 }
 
+/// @internal The largest number of bins (between the overflow bins) used by a ClipBuffer
+std::size_t const CLIP_BUFFER_MAX_BINS = 1 << 16;
+
+/**
+ * @internal The unweighted clipped statistics of a fixed set of values, without revisiting the image
+ *
+ * The values are copied once, bucketed by value into bins spanning [ref - halfRange, ref + halfRange]
+ * (plus one bin for all smaller and one for all larger values), and the count, sum(x - ref) and
+ * sum((x - ref)^2) accumulated over the bins.  The values accepted by a clip |x - center| <= cliplimit
+ * are contiguous in value, so each clip finds the first and last bins holding accepted values by
+ * binary search, takes the bins between them from the cumulative sums, and only tests the values of
+ * those two bins.  The binning only affects the speed, not the result.
+ */
+template <typename Pixel>
+class ClipBuffer {
+public:
+    /**
+     * @param forEachValue  call a functor with each good pixel value
+     * @param nValues       (approximate) number of values; sets the number of bins
+     * @param checkFinite   ignore non-finite values (otherwise NaNs are ignored and infinities
+     *                      make the buffer unusable, as a clip may accept them)
+     * @param ref           value near the center of the distribution, e.g. the median
+     * @param halfRange     half the width of the range to bin finely
+     */
+    template <typename ForEachValue>
+    ClipBuffer(ForEachValue const &forEachValue, std::size_t const nValues, bool const checkFinite,
+               double const ref, double const halfRange)
+            : _ref(ref), _hasInfinity(false) {
+        int const nFine = std::max(1, static_cast<int>(std::min(nValues / 32, CLIP_BUFFER_MAX_BINS)));
+        double const lo = (std::isfinite(halfRange) && halfRange > 0) ? ref - halfRange : ref;
+        double const scale = (lo < ref) ? nFine / (2 * halfRange) : 0.0;
+        double const hi = (lo < ref) ? ref + halfRange : ref;
+        auto const binOf = [lo, hi, scale, nFine](double const x) {
+            if (x < lo) {
+                return 0;
+            } else if (x >= hi) {
+                return nFine + 1;
+            }
+            return 1 + std::min(nFine - 1, static_cast<int>((x - lo) * scale));
+        };
+        // isAccepted() is false for NaN, and for Inf if we're checking for finite values
+        auto const isAccepted = [checkFinite](double const x) {
+            return checkFinite ? std::isfinite(x) : !std::isnan(x);
+        };
+
+        std::vector<std::size_t> binBegin(nFine + 3, 0);
+        forEachValue([&](Pixel const value) {
+            double const x = value;
+            if (isAccepted(x)) {
+                ++binBegin[binOf(x) + 1];
+                _hasInfinity |= std::isinf(x);
+            }
+        });
+        for (int i = 1; i < nFine + 3; ++i) {
+            binBegin[i] += binBegin[i - 1];
+        }
+        _values.resize(binBegin.back());
+        std::vector<std::size_t> next(binBegin.begin(), binBegin.end() - 1);
+        forEachValue([&](Pixel const value) {
+            double const x = value;
+            if (isAccepted(x)) {
+                _values[next[binOf(x)]++] = value;
+            }
+        });
+
+        // Keep only the non-empty bins, with their extreme values and cumulative sums
+        _begin.push_back(0);
+        _cumSum.push_back(0.0);
+        _cumSum2.push_back(0.0);
+        for (int i = 0; i < nFine + 2; ++i) {
+            if (binBegin[i] == binBegin[i + 1]) {
+                continue;
+            }
+            double min = _values[binBegin[i]];
+            double max = min;
+            double sum = 0.0;
+            double sum2 = 0.0;
+            for (std::size_t j = binBegin[i]; j < binBegin[i + 1]; ++j) {
+                double const x = _values[j];
+                double const delta = x - _ref;
+                min = std::min(min, x);
+                max = std::max(max, x);
+                sum += delta;
+                sum2 += delta * delta;
+            }
+            _begin.push_back(binBegin[i + 1]);
+            _min.push_back(min);
+            _max.push_back(max);
+            _cumSum.push_back(_cumSum.back() + sum);
+            _cumSum2.push_back(_cumSum2.back() + sum2);
+        }
+    }
+
+    /// Can clip() be used? False if there are infinite values
+    bool isUsable() const noexcept { return !_hasInfinity; }
+
+    /// Return the statistics of the values with |x - center| <= cliplimit, as getStandard() would
+    StandardReturn clip(double const center, double const cliplimit) const {
+        if (std::isnan(center) || std::isnan(cliplimit)) {
+            return StandardReturn(0, NaN, Statistics::Value(NaN, NaN), Statistics::Value(NaN, NaN), NaN, NaN,
+                                  ~0x0);
+        }
+        auto const isInside = [center, cliplimit](double const x) { return fabs(x - center) <= cliplimit; };
+        auto const isBelow = [center, &isInside](double const x) { return x < center && !isInside(x); };
+        auto const isAbove = [center, &isInside](double const x) { return x > center && !isInside(x); };
+
+        int n = 0;
+        double sum = 0.0;  // sum(x - ref)
+        double sum2 = 0.0;  // sum((x - ref)^2)
+        if (cliplimit >= 0) {
+            // bins [first, last] hold all the accepted values; those strictly between are all accepted
+            std::size_t const first = std::partition_point(_max.begin(), _max.end(), isBelow) - _max.begin();
+            std::size_t const end = std::partition_point(_min.begin(), _min.end(),
+                                                         [&isAbove](double x) { return !isAbove(x); }) -
+                                    _min.begin();
+            auto const addBin = [&](std::size_t const i) {
+                for (std::size_t j = _begin[i]; j < _begin[i + 1]; ++j) {
+                    double const x = _values[j];
+                    if (isInside(x)) {
+                        double const delta = x - _ref;
+                        ++n;
+                        sum += delta;
+                        sum2 += delta * delta;
+                    }
+                }
+            };
+            if (first < end) {
+                std::size_t const last = end - 1;
+                addBin(first);
+                if (last > first) {
+                    addBin(last);
+                    n += static_cast<int>(_begin[last] - _begin[first + 1]);
+                    sum += _cumSum[last] - _cumSum[first + 1];
+                    sum2 += _cumSum2[last] - _cumSum2[first + 1];
+                }
+            }
+        }
+
+        // convert to sums about the center, as used by processPixels
+        double const offset = center - _ref;
+        double const sumx = sum - n * offset;
+        double const sumx2 = sum2 - 2 * offset * sum + n * offset * offset;
+        return makeStandardReturn(n, n, n, sumx, sumx2, 0.0, 0.0, center, NaN, NaN, 0x0, false, false);
+    }
+
+private:
+    double _ref;
+    bool _hasInfinity;
+    std::vector<Pixel> _values;   // the values, in bin order
+    std::vector<std::size_t> _begin;  // _begin[i] is the index in _values of the first value of bin i
+    std::vector<double> _min, _max;  // the extreme values of each bin
+    std::vector<double> _cumSum, _cumSum2;  // sum(x - ref) and sum((x - ref)^2) of the bins before i
+};
+
 /**
  * @internal A wrapper using the nth_element() built-in to compute percentiles for an image
  *
@@ -696,11 +979,12 @@ namespace {
             // get the 50th percentile, then get the 25th and 75th on the smaller partitions
             std::nth_element(img.begin(), mid50, img.end());
             std::nth_element(img.begin(), mid25, mid50);
+            auto const naive50 = *mid50;    // partitioning the upper half may move the median
             std::nth_element(mid50,       mid75, img.end());
 
             double const q1     = computeQuantile(img.begin(), mid50,     *mid25,
                                                   0.25*n);
-            double const median = computeQuantile(mid25,       mid75,     *mid50,
+            double const median = computeQuantile(mid25,       mid75,     naive50,
                                                   0.50*n - (mid25 - img.begin()));
             double const q3     = computeQuantile(mid50,       img.end(), *mid75,
                                                   0.75*n - (mid50 - img.begin()));
@@ -737,6 +1021,281 @@ std::shared_ptr<std::vector<typename ImageT::Pixel> > makeVectorCopy(ImageT cons
 
     return imgcp;
 }
+
+/// @internal Images with at least this many pixels select their quantiles with a RadixSelector
+int const RADIX_SELECT_MIN_PIXELS = 1 << 16;
+
+/**
+ * @internal Map pixel values to unsigned keys that sort in the same order as the values
+ */
+template <typename Pixel, typename Enable = void>
+struct RadixKey {  // unsigned integers are their own keys
+    using Key = Pixel;
+    static Key toKey(Pixel value) noexcept { return value; }
+    static Pixel fromKey(Key key) noexcept { return key; }
+};
+
+template <typename Pixel>
+struct RadixKey<Pixel, typename std::enable_if<std::is_integral<Pixel>::value &&
+                                               std::is_signed<Pixel>::value>::type> {
+    using Key = typename std::make_unsigned<Pixel>::type;
+    static constexpr Key signBit = Key(1) << (8 * sizeof(Key) - 1);
+    static Key toKey(Pixel value) noexcept { return static_cast<Key>(value) ^ signBit; }
+    static Pixel fromKey(Key key) noexcept { return static_cast<Pixel>(key ^ signBit); }
+};
+
+template <typename Pixel>
+struct RadixKey<Pixel, typename std::enable_if<std::is_floating_point<Pixel>::value>::type> {
+    using Key = typename std::conditional<sizeof(Pixel) == 4, std::uint32_t, std::uint64_t>::type;
+    static_assert(sizeof(Key) == sizeof(Pixel), "Unsupported floating point type");
+    static constexpr Key signBit = Key(1) << (8 * sizeof(Key) - 1);
+    // flip all the bits of negative values, and just the sign bit of positive ones
+    static Key toKey(Pixel value) noexcept {
+        Key bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return (bits & signBit) ? ~bits : (bits | signBit);
+    }
+    static Pixel fromKey(Key key) noexcept {
+        Key const bits = (key & signBit) ? (key ^ signBit) : ~key;
+        Pixel value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
+
+/// @internal A value of given rank among a set of values, with the number of values below and equal to it
+template <typename Pixel>
+struct RankedValue {
+    Pixel value;
+    std::size_t nBelow;
+    std::size_t nEqual;
+};
+
+/**
+ * @internal Select values of given ranks from a set of values with a most-significant-digit radix select
+ *
+ * The values are never copied: `forEachValue(func)` must call `func(value)` for each of them, and is
+ * called once on construction (which counts the values) and once per remaining radix digit by select().
+ * Each pass histograms one 16-bit digit of the keys of those values that share the higher digits of
+ * one of the requested ranks, so the results are exact order statistics.
+ */
+template <typename Pixel>
+class RadixSelector {
+public:
+    using Key = typename RadixKey<Pixel>::Key;
+
+    template <typename ForEachValue>
+    explicit RadixSelector(ForEachValue const &forEachValue) : _histogram(NBINS, 0), _size(0) {
+        int const shift = (NDIGITS - 1) * DIGIT_BITS;
+        forEachValue([this, shift](Pixel value) {
+            ++_histogram[(RadixKey<Pixel>::toKey(value) >> shift) & (NBINS - 1)];
+        });
+        for (auto count : _histogram) {
+            _size += count;
+        }
+    }
+
+    /// Return the number of values
+    std::size_t size() const noexcept { return _size; }
+
+    /// Return the values with the given ranks (0 is the smallest); all ranks must be < size()
+    template <typename ForEachValue>
+    std::vector<RankedValue<Pixel>> select(std::vector<std::size_t> const &ranks,
+                                           ForEachValue const &forEachValue) const {
+        struct Target {
+            Key prefix;         // the digits of the value's key found so far
+            std::size_t below;  // number of values whose keys have a smaller prefix
+            std::size_t equal;  // number of values whose keys have the same prefix
+        };
+        std::vector<Target> targets(ranks.size(), Target{0, 0, _size});
+        std::vector<Key> prefixes(1, 0);
+        std::vector<std::size_t> histograms(_histogram);
+        for (int digit = NDIGITS - 1; digit >= 0; --digit) {
+            if (digit != NDIGITS - 1) {
+                // histogram this digit of the values that share the prefixes found so far
+                prefixes.clear();
+                for (auto const &target : targets) {
+                    if (std::find(prefixes.begin(), prefixes.end(), target.prefix) == prefixes.end()) {
+                        prefixes.push_back(target.prefix);
+                    }
+                }
+                int const shift = digit * DIGIT_BITS;
+                histograms.assign(prefixes.size() * NBINS, 0);
+                forEachValue([&prefixes, &histograms, shift](Pixel value) {
+                    Key const key = RadixKey<Pixel>::toKey(value);
+                    Key const prefix = key >> (shift + DIGIT_BITS);
+                    for (std::size_t i = 0; i != prefixes.size(); ++i) {
+                        if (prefix == prefixes[i]) {
+                            ++histograms[i * NBINS + ((key >> shift) & (NBINS - 1))];
+                            break;
+                        }
+                    }
+                });
+            }
+            for (std::size_t i = 0; i != targets.size(); ++i) {
+                Target &target = targets[i];
+                auto const prefix = std::find(prefixes.begin(), prefixes.end(), target.prefix);
+                std::size_t const offset = (prefix - prefixes.begin()) * NBINS;
+                std::size_t below = target.below;
+                for (std::size_t bin = 0; bin != NBINS; ++bin) {
+                    std::size_t const count = histograms[offset + bin];
+                    if (ranks[i] < below + count) {
+                        target.prefix = static_cast<Key>((target.prefix << DIGIT_BITS) | bin);
+                        target.below = below;
+                        target.equal = count;
+                        break;
+                    }
+                    below += count;
+                }
+            }
+        }
+
+        std::vector<RankedValue<Pixel>> result;
+        result.reserve(targets.size());
+        for (auto const &target : targets) {
+            result.push_back(RankedValue<Pixel>{RadixKey<Pixel>::fromKey(target.prefix), target.below,
+                                                target.equal});
+        }
+        return result;
+    }
+
+private:
+    static constexpr int DIGIT_BITS = 16;
+    static constexpr std::size_t NBINS = std::size_t(1) << DIGIT_BITS;
+    static constexpr int NDIGITS = (8 * sizeof(Key) + DIGIT_BITS - 1) / DIGIT_BITS;
+
+    std::vector<std::size_t> _histogram;  // histogram of the most significant digit of the keys
+    std::size_t _size;                    // number of values
+};
+
+/// @internal Interpolate a quantile of integral values as computeQuantile() does, from the counts of values
+/// below and equal to the "naive" value that lie in the rank range [begin, end)
+template <typename Pixel>
+double quantileInRange(RankedValue<Pixel> const &naive, std::size_t begin, std::size_t end,
+                       double const target) {
+    std::size_t const below = std::min(std::max(naive.nBelow, begin), end);
+    std::size_t const notAbove = std::min(std::max(naive.nBelow + naive.nEqual, begin), end);
+    std::size_t const left = below - begin;
+    std::size_t const middle = notAbove - below;
+    return naive.value - 0.5 + (target - left) / middle;
+}
+
+/**
+ * @internal Compute a percentile of the values seen by a RadixSelector, as percentile() would
+ *
+ * Specialisation for non-integral types
+ */
+template <typename Pixel, typename ForEachValue>
+typename enable_if<!is_integral<Pixel>::value, double>::type percentile(RadixSelector<Pixel> const &selector,
+                                                                       ForEachValue const &forEachValue,
+                                                                       double const fraction) {
+    assert(fraction >= 0.0 && fraction <= 1.0);
+
+    std::size_t const n = selector.size();
+    if (n > 1) {
+        double const idx = fraction * (n - 1);
+        std::size_t const q1 = static_cast<std::size_t>(idx);
+        std::size_t const q2 = q1 + 1;
+
+        auto const values = selector.select({q1, std::min(q2, n - 1)}, forEachValue);
+        double w1 = (static_cast<double>(q2) - idx);
+        double w2 = (idx - static_cast<double>(q1));
+        return w1 * static_cast<double>(values[0].value) + w2 * static_cast<double>(values[1].value);
+    } else if (n == 1) {
+        return selector.select({0}, forEachValue)[0].value;
+    } else {
+        return NaN;
+    }
+}
+
+/**
+ * @internal Compute a percentile of the values seen by a RadixSelector, as percentile() would
+ *
+ * Specialisation for integral types, handling ties as computeQuantile() does
+ */
+template <typename Pixel, typename ForEachValue>
+typename enable_if<is_integral<Pixel>::value, double>::type percentile(RadixSelector<Pixel> const &selector,
+                                                                      ForEachValue const &forEachValue,
+                                                                      double const fraction) {
+    assert(fraction >= 0.0 && fraction <= 1.0);
+
+    std::size_t const n = selector.size();
+    if (n == 0) {
+        return NaN;
+    } else if (n == 1) {
+        return selector.select({0}, forEachValue)[0].value;
+    } else {
+        std::size_t const rank = static_cast<int>(fraction * (n - 1));
+        auto const naive = selector.select({rank}, forEachValue)[0];
+        return quantileInRange(naive, 0, n, fraction * n);
+    }
+}
+
+/**
+ * @internal Compute the median and quartiles of the values seen by a RadixSelector,
+ * as medianAndQuartiles() would
+ *
+ * Specialisation for non-integral types
+ */
+template <typename Pixel, typename ForEachValue>
+typename enable_if<!is_integral<Pixel>::value, MedianQuartileReturn>::type medianAndQuartiles(
+        RadixSelector<Pixel> const &selector, ForEachValue const &forEachValue) {
+    std::size_t const n = selector.size();
+    if (n > 1) {
+        double const idx[] = {0.50 * (n - 1), 0.25 * (n - 1), 0.75 * (n - 1)};
+        std::vector<std::size_t> ranks;
+        for (double i : idx) {
+            ranks.push_back(static_cast<int>(i));
+            ranks.push_back(ranks.back() + 1);
+        }
+        auto const values = selector.select(ranks, forEachValue);
+
+        // interpolate linearly between the adjacent values
+        double result[3];
+        for (int i = 0; i != 3; ++i) {
+            double const wa = (static_cast<double>(ranks[2 * i + 1]) - idx[i]);
+            double const wb = (idx[i] - static_cast<double>(ranks[2 * i]));
+            result[i] = wa * static_cast<double>(values[2 * i].value) +
+                        wb * static_cast<double>(values[2 * i + 1].value);
+        }
+        return MedianQuartileReturn(result[0], result[1], result[2]);
+    } else if (n == 1) {
+        Pixel const value = selector.select({0}, forEachValue)[0].value;
+        return MedianQuartileReturn(value, value, value);
+    } else {
+        return MedianQuartileReturn(NaN, NaN, NaN);
+    }
+}
+
+/**
+ * @internal Compute the median and quartiles of the values seen by a RadixSelector,
+ * as medianAndQuartiles() would
+ *
+ * Specialisation for integral types. medianAndQuartiles() counts the ties of each quartile within
+ * a partition of the values bounded by the neighbouring quartiles; the same ranges are used here.
+ */
+template <typename Pixel, typename ForEachValue>
+typename enable_if<is_integral<Pixel>::value, MedianQuartileReturn>::type medianAndQuartiles(
+        RadixSelector<Pixel> const &selector, ForEachValue const &forEachValue) {
+    std::size_t const n = selector.size();
+    if (n == 0) {
+        return MedianQuartileReturn(NaN, NaN, NaN);
+    } else if (n == 1) {
+        Pixel const value = selector.select({0}, forEachValue)[0].value;
+        return MedianQuartileReturn(value, value, value);
+    } else {
+        std::size_t const mid25 = static_cast<int>(0.25 * (n - 1));
+        std::size_t const mid50 = static_cast<int>(0.50 * (n - 1));
+        std::size_t const mid75 = static_cast<int>(0.75 * (n - 1));
+        auto const values = selector.select({mid25, mid50, mid75}, forEachValue);
+
+        double const q1 = quantileInRange(values[0], 0, mid50, 0.25 * n);
+        double const median = quantileInRange(values[1], mid25, mid75, 0.50 * n - mid25);
+        double const q3 = quantileInRange(values[2], mid50, n, 0.75 * n - mid50);
+
+        return MedianQuartileReturn(median, q1, q3);
+    }
+}
 }  // namespace
 
 double StatisticsControl::getMaskPropagationThreshold(int bit) const {
@@ -864,6 +1423,7 @@ Statistics::Statistics(ImageT const &img, MaskT const &msk, VarianceT const &var
 template <typename ImageT, typename MaskT, typename VarianceT, typename WeightT>
 void Statistics::doStatistics(ImageT const &img, MaskT const &msk, VarianceT const &var,
                               WeightT const &weights, int const flags, StatisticsControl const &sctrl) {
+    LSST_AFW_INSTRUMENT_SCOPE("math.Statistics");
 
     if (_sctrl.getCalcErrorFromInputVariance() && _sctrl.getCalcErrorMosaicMode()) {
         throw LSST_EXCEPT(pexExceptions::InvalidParameterError,
@@ -906,26 +1466,79 @@ void Statistics::doStatistics(ImageT const &img, MaskT const &msk, VarianceT con
         _nMasked = num - _n;
     }
 
-    // copy the image for any routines that will use median or quantiles
+    // compute the median or quantiles for any routines that will use them
     if (flags & (MEDIAN | IQRANGE | MEANCLIP | STDEVCLIP | VARIANCECLIP)) {
-        // make a vector copy of the image to get the median and quartiles (will move values)
-        std::shared_ptr<std::vector<typename ImageT::Pixel> > imgcp;
-        if (_sctrl.getNanSafe()) {
-            imgcp = makeVectorCopy<ChkFin>(img, msk, var, _sctrl.getAndMask());
-        } else {
-            imgcp = makeVectorCopy<AlwaysT>(img, msk, var, _sctrl.getAndMask());
-        }
-
         // if we *only* want the median, just use percentile(), otherwise use medianAndQuartiles()
-        if ((flags & (MEDIAN)) && !(flags & (IQRANGE | MEANCLIP | STDEVCLIP | VARIANCECLIP))) {
-            _median = Value(percentile(*imgcp, 0.5), NaN);
+        bool const onlyMedian =
+                (flags & (MEDIAN)) && !(flags & (IQRANGE | MEANCLIP | STDEVCLIP | VARIANCECLIP));
+        MedianQuartileReturn mq(NaN, NaN, NaN);
+        // unweighted clipping with several iterations copies the good pixels into a ClipBuffer once,
+        // rather than passing over the image for every iteration
+        bool const doClip = flags & (MEANCLIP | STDEVCLIP | VARIANCECLIP);
+        bool const useClipBuffer = doClip && _sctrl.getNumIter() > 1 && !_sctrl.getWeighted() &&
+                                   !_sctrl.getCalcErrorFromInputVariance() &&
+                                   !_sctrl.getCalcErrorMosaicMode();
+        std::unique_ptr<ClipBuffer<typename ImageT::Pixel>> clipBuffer;
+        auto const makeClipBuffer = [&](auto const &forEachValue) {
+            double const median = std::get<0>(mq);
+            double const iqrange = std::get<2>(mq) - std::get<1>(mq);
+            clipBuffer = std::make_unique<ClipBuffer<typename ImageT::Pixel>>(
+                    forEachValue, _n, _sctrl.getNanSafe() || (flags & (MIN | MAX)), median,
+                    2 * _sctrl.getNumSigmaClip() * IQ_TO_STDEV * iqrange);
+        };
+        if (_sctrl.getNanSafe() && num >= RADIX_SELECT_MIN_PIXELS) {
+            // select the values straight from the image, without copying them
+            int const andMask = _sctrl.getAndMask();
+            auto const forEachValue = [&img, &msk, andMask](auto const &func) {
+                for (int iY = 0; iY < img.getHeight(); ++iY) {
+                    typename MaskT::x_iterator mptr = msk.row_begin(iY);
+                    for (typename ImageT::x_iterator ptr = img.row_begin(iY), end = img.row_end(iY);
+                         ptr != end; ++ptr, ++mptr) {
+                        if (ChkFin()(*ptr) && !(*mptr & andMask)) {
+                            func(*ptr);
+                        }
+                    }
+                }
+            };
+            RadixSelector<typename ImageT::Pixel> const selector(forEachValue);
+            if (onlyMedian) {
+                std::get<0>(mq) = percentile(selector, forEachValue, 0.5);
+            } else {
+                mq = medianAndQuartiles(selector, forEachValue);
+            }
+            if (useClipBuffer) {
+                makeClipBuffer(forEachValue);
+            }
         } else {
-            MedianQuartileReturn mq = medianAndQuartiles(*imgcp);
-            _median = Value(std::get<0>(mq), NaN);
+            // make a vector copy of the image to get the median and quartiles (will move values)
+            std::shared_ptr<std::vector<typename ImageT::Pixel> > imgcp;
+            if (_sctrl.getNanSafe()) {
+                imgcp = makeVectorCopy<ChkFin>(img, msk, var, _sctrl.getAndMask());
+            } else {
+                imgcp = makeVectorCopy<AlwaysT>(img, msk, var, _sctrl.getAndMask());
+            }
+            if (onlyMedian) {
+                std::get<0>(mq) = percentile(*imgcp, 0.5);
+            } else {
+                mq = medianAndQuartiles(*imgcp);
+            }
+            if (useClipBuffer) {
+                makeClipBuffer([&imgcp](auto const &func) {
+                    for (auto const value : *imgcp) {
+                        func(value);
+                    }
+                });
+            }
+        }
+        _median = Value(std::get<0>(mq), NaN);
+        if (!onlyMedian) {
             _iqrange = std::get<2>(mq) - std::get<1>(mq);
         }
 
-        if (flags & (MEANCLIP | STDEVCLIP | VARIANCECLIP)) {
+        if (clipBuffer && !clipBuffer->isUsable()) {
+            clipBuffer.reset();
+        }
+        if (doClip) {
             for (int i_i = 0; i_i < _sctrl.getNumIter(); ++i_i) {
                 double const center = ((i_i > 0) ? _meanclip : _median).first;
                 double const hwidth = (i_i > 0 && _n > 1)
@@ -933,11 +1546,13 @@ void Statistics::doStatistics(ImageT const &img, MaskT const &msk, VarianceT con
                                               : _sctrl.getNumSigmaClip() * IQ_TO_STDEV * _iqrange;
                 std::pair<double, double> const clipinfo(center, hwidth);
 
-                StandardReturn clipped = getStandard(
-                        img, msk, var, weights, flags, clipinfo, _weightsAreMultiplicative,
-                        _sctrl.getAndMask(), _sctrl.getCalcErrorFromInputVariance(),
-                        _sctrl.getCalcErrorMosaicMode(), _sctrl.getNanSafe(),
-                        _sctrl.getWeighted(), _sctrl._maskPropagationThresholds);
+                StandardReturn clipped =
+                        clipBuffer ? clipBuffer->clip(center, hwidth)
+                                   : getStandard(img, msk, var, weights, flags, clipinfo,
+                                                 _weightsAreMultiplicative, _sctrl.getAndMask(),
+                                                 _sctrl.getCalcErrorFromInputVariance(),
+                                                 _sctrl.getCalcErrorMosaicMode(), _sctrl.getNanSafe(),
+                                                 _sctrl.getWeighted(), _sctrl._maskPropagationThresholds);
 
                 int const nClip = std::get<0>(clipped);             // number after clipping
                 _nClipped = _n - nClip;                             // number clipped
@@ -21,6 +21,7 @@
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -65,10 +66,8 @@ ndarray::Array<double, 1, 1> TransformBoundedField::evaluate(ndarray::Array<doub
     // TODO if Mapping.applyForward gains support for x, y (DM-11226) then use that instead of copying data
     int const nPoints = x.getSize<0>();
     ndarray::Array<double, 2, 2> xy = ndarray::allocate(ndarray::makeVector(2, nPoints));
-    for (int col = 0; col < nPoints; ++col) {
-        xy[0][col] = x[col];
-        xy[1][col] = y[col];
-    }
+    xy[0] = x;
+    xy[1] = y;
 
     auto res2D = _transform.getMapping()->applyForward(xy);
 
@@ -78,6 +77,25 @@ ndarray::Array<double, 1, 1> TransformBoundedField::evaluate(ndarray::Array<doub
     return ndarray::external(res2D.getData(), resShape, resStrides, res2D);
 }
 
+ndarray::Array<double, 2, 2> TransformBoundedField::evaluateGrid(
+        ndarray::Array<double const, 1> const& x, ndarray::Array<double const, 1> const& y) const {
+    int const nx = x.getSize<0>();
+    int const ny = y.getSize<0>();
+    // Pack every grid point, row by row, so that the mapping is only called once
+    ndarray::Array<double, 2, 2> xy = ndarray::allocate(ndarray::makeVector(2, nx * ny));
+    for (int i = 0; i < ny; ++i) {
+        std::copy(x.begin(), x.end(), xy[0].begin() + i * nx);
+        std::fill(xy[1].begin() + i * nx, xy[1].begin() + (i + 1) * nx, y[i]);
+    }
+
+    auto res2D = _transform.getMapping()->applyForward(xy);
+
+    // res2D has shape 1 x (nx*ny), in row order; return it as an ny x nx view
+    auto resShape = ndarray::makeVector(ny, nx);
+    auto resStrides = ndarray::makeVector(nx, 1);
+    return ndarray::external(res2D.getData(), resShape, resStrides, res2D);
+}
+
 // ------------------ persistence ---------------------------------------------------------------------------
 
 namespace {
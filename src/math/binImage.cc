@@ -23,11 +23,15 @@
 /*
  * Bin an Image or MaskedImage by an integral factor (the same in x and y)
  */
-#include <memory>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <vector>
 
 #include "lsst/pex/exceptions.h"
 #include "lsst/afw/math/offsetImage.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace pexExcept = lsst::pex::exceptions;
 
@@ -35,14 +39,87 @@ namespace lsst {
 namespace afw {
 namespace math {
 
+namespace {
+
+/*
+ * Set every pixel of `out` to finish(s), where s combines the binX x binY block of `in` pixels that it
+ * covers using `combine`, row by row.
+ *
+ * The work is done in bands of output rows, one per thread, and each input row is reduced into a row of
+ * accumulators by a loop over contiguous memory that the compiler can vectorize.
+ */
+template <typename AccT, typename PixelT, typename CombineT, typename FinishT>
+void binPlane(image::ImageBase<PixelT> const& in, image::ImageBase<PixelT>& out, int binX, int binY,
+              CombineT combine, FinishT finish, int nThreads) {
+    auto const inArray = in.getArray();
+    auto const outArray = out.getArray();
+    int const width = out.getWidth();
+    auto const bands = detail::splitRange(0, out.getHeight(), nThreads);
+    int const nBands = bands.size();
+    detail::parallelFor(nBands, nThreads, [&](int iBand) {
+        std::vector<AccT> rowSum(width);
+        for (int oy = bands[iBand].first; oy < bands[iBand].second; ++oy) {
+            for (int i = 0; i < binY; ++i) {
+                PixelT const* src = inArray[oy * binY + i].getData();
+                for (int ox = 0; ox < width; ++ox) {
+                    AccT sum = src[ox * binX];
+                    for (int j = 1; j < binX; ++j) {
+                        sum = combine(sum, static_cast<AccT>(src[ox * binX + j]));
+                    }
+                    rowSum[ox] = (i == 0) ? sum : combine(rowSum[ox], sum);
+                }
+            }
+            PixelT* dst = outArray[oy].getData();
+            for (int ox = 0; ox < width; ++ox) {
+                dst[ox] = finish(rowSum[ox]);
+            }
+        }
+    });
+}
+
+// Sum of image pixels; integer pixels are summed in a wider type so that large bins cannot overflow
+template <typename PixelT>
+using SumT = std::conditional_t<std::is_integral<PixelT>::value, std::int64_t, PixelT>;
+
+// Mean of each bin of an image
+template <typename PixelT>
+void binMean(image::ImageBase<PixelT> const& in, image::ImageBase<PixelT>& out, int binX, int binY,
+             int nThreads) {
+    int const n = binX * binY;
+    binPlane<SumT<PixelT>>(in, out, binX, binY, std::plus<SumT<PixelT>>(),
+                           [n](SumT<PixelT> sum) { return static_cast<PixelT>(sum / n); }, nThreads);
+}
+
+template <typename PixelT>
+void binPlanes(image::Image<PixelT> const& in, image::Image<PixelT>& out, int binX, int binY,
+               int nThreads) {
+    binMean(in, out, binX, binY, nThreads);
+}
+
+// The mask of a bin is the OR of its pixels' masks, and the variance that of the mean
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+void binPlanes(image::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT> const& in,
+               image::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>& out, int binX, int binY,
+               int nThreads) {
+    binMean(*in.getImage(), *out.getImage(), binX, binY, nThreads);
+    binPlane<MaskPixelT>(*in.getMask(), *out.getMask(), binX, binY, std::bit_or<MaskPixelT>(),
+                         [](MaskPixelT sum) { return sum; }, nThreads);
+    VariancePixelT const n = binX * binY;
+    binPlane<VariancePixelT>(*in.getVariance(), *out.getVariance(), binX, binY, std::plus<VariancePixelT>(),
+                             [n](VariancePixelT sum) { return sum / (n * n); }, nThreads);
+}
+
+}  // namespace
+
 template <typename ImageT>
-std::shared_ptr<ImageT> binImage(ImageT const& in, int const binsize, lsst::afw::math::Property const flags) {
-    return binImage(in, binsize, binsize, flags);
+std::shared_ptr<ImageT> binImage(ImageT const& in, int const binsize, lsst::afw::math::Property const flags,
+                                 int numThreads) {
+    return binImage(in, binsize, binsize, flags, numThreads);
 }
 
 template <typename ImageT>
 std::shared_ptr<ImageT> binImage(ImageT const& in, int const binX, int const binY,
-                                 lsst::afw::math::Property const flags) {
+                                 lsst::afw::math::Property const flags, int numThreads) {
     if (flags != lsst::afw::math::MEAN) {
         throw LSST_EXCEPT(pexExcept::InvalidParameterError,
                           (boost::format("Only afwMath::MEAN is supported, saw 0x%x") % flags).str());
@@ -51,34 +128,15 @@ std::shared_ptr<ImageT> binImage(ImageT const& in, int const binX, int const bin
         throw LSST_EXCEPT(pexExcept::DomainError,
                           (boost::format("Binning must be >= 0, saw %dx%d") % binX % binY).str());
     }
+    int const nThreads = detail::resolveNumThreads(numThreads);
 
     int const outWidth = in.getWidth() / binX;
     int const outHeight = in.getHeight() / binY;
 
-    std::shared_ptr<ImageT> out =
-            std::shared_ptr<ImageT>(new ImageT(lsst::geom::Extent2I(outWidth, outHeight)));
+    std::shared_ptr<ImageT> out = std::shared_ptr<ImageT>(
+            new ImageT(lsst::geom::Extent2I(outWidth, outHeight), image::UNINITIALIZED));
     out->setXY0(in.getXY0());
-    *out = typename ImageT::SinglePixel(0);
-
-    for (int oy = 0, iy = 0; oy < out->getHeight(); ++oy) {
-        for (int i = 0; i != binY; ++i, ++iy) {
-            typename ImageT::x_iterator optr = out->row_begin(oy);
-            for (typename ImageT::x_iterator iptr = in.row_begin(iy), iend = iptr + binX * outWidth;
-                 iptr < iend;) {
-                typename ImageT::SinglePixel val = *iptr;
-                ++iptr;
-                for (int j = 1; j != binX; ++j, ++iptr) {
-                    val += *iptr;
-                }
-                *optr += val;
-                ++optr;
-            }
-        }
-        for (typename ImageT::x_iterator ptr = out->row_begin(oy), end = out->row_end(oy); ptr != end;
-             ++ptr) {
-            *ptr /= binX * binY;
-        }
-    }
+    binPlanes(in, *out, binX, binY, nThreads);
 
     return out;
 }
@@ -89,13 +147,13 @@ std::shared_ptr<ImageT> binImage(ImageT const& in, int const binX, int const bin
 /// @cond
 #define INSTANTIATE(TYPE)                                                                                  \
     template std::shared_ptr<image::Image<TYPE>> binImage(image::Image<TYPE> const&, int,                  \
-                                                          lsst::afw::math::Property const);                \
+                                                          lsst::afw::math::Property const, int);           \
     template std::shared_ptr<image::Image<TYPE>> binImage(image::Image<TYPE> const&, int, int,             \
-                                                          lsst::afw::math::Property const);                \
+                                                          lsst::afw::math::Property const, int);           \
     template std::shared_ptr<image::MaskedImage<TYPE>> binImage(image::MaskedImage<TYPE> const&, int,      \
-                                                                lsst::afw::math::Property const);          \
+                                                                lsst::afw::math::Property const, int);     \
     template std::shared_ptr<image::MaskedImage<TYPE>> binImage(image::MaskedImage<TYPE> const&, int, int, \
-                                                                lsst::afw::math::Property const);
+                                                                lsst::afw::math::Property const, int);
 
 INSTANTIATE(std::uint16_t)
 INSTANTIATE(int)
@@ -27,16 +27,21 @@
  */
 #include <algorithm>
 #include <cstdint>
+#include <map>
+#include <memory>
 #include <sstream>
+#include <utility>
 #include <vector>
 
 #include "lsst/pex/exceptions.h"
 #include "lsst/log/Log.h"
 #include "lsst/geom.h"
+#include "lsst/afw/geom/SpanSet.h"
 #include "lsst/afw/image/MaskedImage.h"
 #include "lsst/afw/math/ConvolveImage.h"
 #include "lsst/afw/math/Kernel.h"
 #include "lsst/afw/math/detail/Convolve.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace pexExcept = lsst::pex::exceptions;
 
@@ -75,60 +80,527 @@ void assertDimensionsOK(OutImageT const& convolvedImage, InImageT const& inImage
     }
 }
 /**
- * @internal Compute the dot product of a kernel row or column and the overlapping portion of an %image
+ * @internal Add the products of one kernel value and a row of %image pixels to a row of partial sums
  *
- * @returns computed dot product
- *
- * The pixel computed belongs at position imageIter + kernel center.
+ * Rather than computing one output pixel as the dot product of a whole kernel vector with the
+ * overlapping pixels, this applies one kernel value to a whole row of output pixels. Calling it for
+ * each kernel value in turn accumulates every output pixel in the same order as the dot product would,
+ * but the inner loop runs over contiguous pixels with no dependency between iterations,
+ * which lets the compiler vectorize it.
+ */
+template <typename OutPixelT, typename InPixelT, typename KernelPixelT>
+inline void accumulateKernelProducts(OutPixelT* outRow,      ///< @internal start of row of partial sums
+                                     InPixelT const* inRow,  ///< @internal start of row of %image pixels
+                                     KernelPixelT kVal,      ///< @internal kernel value
+                                     int width)              ///< @internal number of pixels in the row
+{
+    if (kVal == 0) {
+        return;
+    }
+    for (int x = 0; x < width; ++x) {
+        outRow[x] += static_cast<OutPixelT>(inRow[x] * kVal);
+    }
+}
+
+/**
+ * @internal Pointers to the image, mask and variance pixels of one row of a MaskedImage
+ */
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+struct MaskedRow {
+    ImagePixelT* image;
+    MaskPixelT* mask;
+    VariancePixelT* variance;
+};
+
+/**
+ * @internal Get the MaskedRow starting at pixel (x, y) of a MaskedImage
+ */
+template <typename MaskedImageT>
+inline auto getMaskedRow(MaskedImageT const& maskedImage, int x, int y) {
+    return MaskedRow<typename MaskedImageT::Image::Pixel, typename MaskedImageT::Mask::Pixel,
+                     typename MaskedImageT::Variance::Pixel>{
+            maskedImage.getImage()->getArray()[y].getData() + x,
+            maskedImage.getMask()->getArray()[y].getData() + x,
+            maskedImage.getVariance()->getArray()[y].getData() + x};
+}
+
+/**
+ * @internal Add the products of one kernel value and a row of MaskedImage pixels to a row of partial sums
  *
- * @todo get rid of KernelPixelT parameter if possible by not computing local variable kVal,
- * or by using iterator traits:
- *     typedef typename std::iterator_traits<KernelIterT>::value_type KernelPixel;
- * Unfortunately, in either case compilation fails with this sort of message:
-@verbatim
-include/lsst/afw/image/Pixel.h: In instantiation of
-‘lsst::afw::image::pixel::exprTraits<boost::gil::pixel<double,
-boost::gil::layout<boost::mpl::vector1<boost::gil::gray_color_t>, boost::mpl::range_c<int, 0, 1> > > >’:
-include/lsst/afw/image/Pixel.h:385:   instantiated from
-‘lsst::afw::image::pixel::BinaryExpr<lsst::afw::image::pixel::Pixel<int, short unsigned int, float>,
-boost::gil::pixel<double, boost::gil::layout<boost::mpl::vector1<boost::gil::gray_color_t>,
-boost::mpl::range_c<int, 0, 1> > >, std::multiplies<int>, lsst::afw::image::pixel::bitwise_or<short unsigned
-int>, lsst::afw::image::pixel::variance_multiplies<float> >’
-src/math/ConvolveImage.cc:59:   instantiated from ‘OutPixelT<unnamed>::kernelDotProduct(ImageIterT,
-KernelIterT, int) [with OutPixelT = lsst::afw::image::pixel::SinglePixel<int, short unsigned int, float>,
-ImageIterT = lsst::afw::image::MaskedImage<int, short unsigned int,
-float>::const_MaskedImageIterator<boost::gil::gray32s_pixel_t*, boost::gil::gray16_pixel_t*,
-boost::gil::gray32f_noscale_pixel_t*>, KernelIterT = const boost::gil::gray64f_noscalec_pixel_t*]’
-src/math/ConvolveImage.cc:265:   instantiated from ‘void lsst::afw::math::basicConvolve(OutImageT&, const
-InImageT&, const lsst::afw::math::Kernel&, bool) [with OutImageT = lsst::afw::image::MaskedImage<int, short
-unsigned int, float>, InImageT = lsst::afw::image::MaskedImage<int, short unsigned int, float>]’
-src/math/ConvolveImage.cc:451:   instantiated from ‘void lsst::afw::math::convolve(OutImageT&, const
-InImageT&, const KernelT&, bool, int) [with OutImageT = lsst::afw::image::MaskedImage<int, short unsigned int,
-float>, InImageT = lsst::afw::image::MaskedImage<int, short unsigned int, float>, KernelT =
-lsst::afw::math::AnalyticKernel]’
-src/math/ConvolveImage.cc:587:   instantiated from here
-include/lsst/afw/image/Pixel.h:210: error: no type named ‘ImagePixelT’ in ‘struct boost::gil::pixel<double,
-boost::gil::layout<boost::mpl::vector1<boost::gil::gray_color_t>, boost::mpl::range_c<int, 0, 1> > >’
-include/lsst/afw/image/Pixel.h:211: error: no type named ‘MaskPixelT’ in ‘struct boost::gil::pixel<double,
-boost::gil::layout<boost::mpl::vector1<boost::gil::gray_color_t>, boost::mpl::range_c<int, 0, 1> > >’
-include/lsst/afw/image/Pixel.h:212: error: no type named ‘VariancePixelT’ in ‘struct boost::gil::pixel<double,
-boost::gil::layout<boost::mpl::vector1<boost::gil::gray_color_t>, boost::mpl::range_c<int, 0, 1> > >’
-@endverbatim
+ * The MaskedImage analog of accumulateKernelProducts: the image, mask and variance of each input pixel
+ * are read once and all three sums are updated together. The arithmetic is that of MaskedImage pixels,
+ * `outPixel += inPixel * kVal`: the image product is computed in the input image pixel type,
+ * the variance is multiplied by kVal^2 in the input variance pixel type, and the mask bits are OR'd.
+ * The mask covers only input pixels for which kVal != 0, as the image and variance do.
+ * If doMask is false the mask sums are left unchanged, for callers that compute the mask separately.
  */
-template <typename OutPixelT, typename ImageIterT, typename KernelIterT, typename KernelPixelT>
-inline OutPixelT kernelDotProduct(
-        ImageIterT imageIter,    ///< @internal start of input %image that overlaps kernel vector
-        KernelIterT kernelIter,  ///< @internal start of kernel vector
-        int kWidth)              ///< @internal width of kernel
+template <bool doMask = true, typename OutImagePixelT, typename OutMaskPixelT, typename OutVariancePixelT,
+          typename InImagePixelT, typename InMaskPixelT, typename InVariancePixelT>
+inline void accumulateMaskedKernelProducts(
+        MaskedRow<OutImagePixelT, OutMaskPixelT, OutVariancePixelT> const& outRow,  ///< @internal sums
+        MaskedRow<InImagePixelT, InMaskPixelT, InVariancePixelT> const& inRow,      ///< @internal input
+        lsst::afw::math::Kernel::Pixel kVal,  ///< @internal kernel value
+        int width)                            ///< @internal number of pixels in the row
 {
-    OutPixelT outPixel(0);
-    for (int x = 0; x < kWidth; ++x, ++imageIter, ++kernelIter) {
-        KernelPixelT kVal = *kernelIter;
-        if (kVal != 0) {
-            outPixel += static_cast<OutPixelT>((*imageIter) * kVal);
+    if (kVal == 0) {
+        return;
+    }
+    InImagePixelT const imageScale = static_cast<InImagePixelT>(kVal);
+    InVariancePixelT const varianceScale = static_cast<InVariancePixelT>(kVal);
+    for (int x = 0; x < width; ++x) {
+        outRow.image[x] +=
+                static_cast<OutImagePixelT>(static_cast<InImagePixelT>(inRow.image[x] * imageScale));
+        if (doMask) {
+            outRow.mask[x] |= inRow.mask[x];
+        }
+        outRow.variance[x] +=
+                static_cast<OutVariancePixelT>(inRow.variance[x] * varianceScale * varianceScale);
+    }
+}
+
+/**
+ * @internal Set a MaskedRow to zero
+ */
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+inline void zeroMaskedRow(MaskedRow<ImagePixelT, MaskPixelT, VariancePixelT> const& row, int width) {
+    std::fill(row.image, row.image + width, ImagePixelT(0));
+    std::fill(row.mask, row.mask + width, MaskPixelT(0));
+    std::fill(row.variance, row.variance + width, VariancePixelT(0));
+}
+
+/**
+ * @internal The pixels of each mask plane that is set anywhere in a Mask
+ *
+ * @returns a list of (plane bit, SpanSet of the pixels with that bit set), in parent coordinates
+ */
+template <typename MaskPixelT>
+std::vector<std::pair<MaskPixelT, std::shared_ptr<lsst::afw::geom::SpanSet>>> getMaskPlaneSpans(
+        lsst::afw::image::Mask<MaskPixelT> const& mask) {
+    MaskPixelT usedBits = 0;
+    auto const array = mask.getArray();
+    for (int y = 0; y < mask.getHeight(); ++y) {
+        MaskPixelT const* row = array[y].getData();
+        for (int x = 0; x < mask.getWidth(); ++x) {
+            usedBits |= row[x];
+        }
+    }
+    std::vector<std::pair<MaskPixelT, std::shared_ptr<lsst::afw::geom::SpanSet>>> planeList;
+    for (std::size_t i = 0; i < 8 * sizeof(MaskPixelT); ++i) {
+        MaskPixelT const bit = static_cast<MaskPixelT>(std::uint64_t(1) << i);
+        if (usedBits & bit) {
+            planeList.emplace_back(bit, lsst::afw::geom::SpanSet::fromMask(mask, bit));
+        }
+    }
+    return planeList;
+}
+
+/**
+ * @internal The offsets from an input pixel to the output pixels whose mask it contributes to
+ *
+ * An output pixel's mask is the OR of the input pixels under the nonzero pixels of the kernel, so
+ * an input pixel contributes to the output pixels at its position + kernelCtr - (each nonzero kernel
+ * pixel). The offsets also include the offset from the input %image's xy0 to the output %image's.
+ */
+lsst::afw::geom::SpanSet makeMaskStencil(
+        lsst::afw::image::Image<lsst::afw::math::Kernel::Pixel> const& kernelImage,
+        lsst::geom::Point2I const& kernelCtr, lsst::geom::Extent2I const& offset) {
+    std::vector<lsst::afw::geom::Span> spanList;
+    auto const kernelArray = kernelImage.getArray();
+    for (int kernelY = 0; kernelY < kernelImage.getHeight(); ++kernelY) {
+        lsst::afw::math::Kernel::Pixel const* kernelRow = kernelArray[kernelY].getData();
+        int const y = kernelCtr.getY() - kernelY + offset.getY();
+        for (int kernelX = 0; kernelX < kernelImage.getWidth();) {
+            if (kernelRow[kernelX] == 0) {
+                ++kernelX;
+                continue;
+            }
+            int const runBegin = kernelX;
+            while (kernelX < kernelImage.getWidth() && kernelRow[kernelX] != 0) {
+                ++kernelX;
+            }
+            int const x = kernelCtr.getX() + offset.getX();
+            spanList.emplace_back(y, x - (kernelX - 1), x - runBegin);
+        }
+    }
+    return lsst::afw::geom::SpanSet(std::move(spanList));
+}
+
+/**
+ * @internal Convolve one row of an %image with a kernel vector along x
+ *
+ * Sets pixels [0, width) of row outY of outImage to the dot products of the kernel vector
+ * with the input pixels starting at (0, inY), (1, inY), ...
+ */
+template <typename OutImageT, typename InImageT>
+inline void convolveRowWithVector(OutImageT& outImage, int outY, InImageT const& inImage, int inY,
+                                  std::vector<lsst::afw::math::Kernel::Pixel> const& kernelVec, int width,
+                                  lsst::afw::image::detail::Image_tag) {
+    using OutPixel = typename OutImageT::Pixel;
+    OutPixel* outRow = outImage.getArray()[outY].getData();
+    typename InImageT::Pixel const* inRow = inImage.getArray()[inY].getData();
+    std::fill(outRow, outRow + width, OutPixel(0));
+    for (std::size_t k = 0; k < kernelVec.size(); ++k) {
+        accumulateKernelProducts(outRow, inRow + k, kernelVec[k], width);
+    }
+}
+
+template <typename OutImageT, typename InImageT>
+inline void convolveRowWithVector(OutImageT& outImage, int outY, InImageT const& inImage, int inY,
+                                  std::vector<lsst::afw::math::Kernel::Pixel> const& kernelVec, int width,
+                                  lsst::afw::image::detail::MaskedImage_tag) {
+    auto const outRow = getMaskedRow(outImage, 0, outY);
+    zeroMaskedRow(outRow, width);
+    for (std::size_t k = 0; k < kernelVec.size(); ++k) {
+        accumulateMaskedKernelProducts(outRow, getMaskedRow(inImage, static_cast<int>(k), inY), kernelVec[k],
+                                       width);
+    }
+}
+
+/**
+ * @internal Convolve the columns of an x-convolved buffer with a kernel vector along y
+ *
+ * Sets pixels [outX, outX + width) of row outY of outImage to the dot products of the kernel vector
+ * with columns [0, width) of the buffer; the kernel vector must have one element per buffer row.
+ */
+template <typename OutImageT>
+inline void convolveColumnsWithVector(OutImageT& outImage, int outX, int outY, OutImageT const& buffer,
+                                      std::vector<lsst::afw::math::Kernel::Pixel> const& kernelVec,
+                                      int width, lsst::afw::image::detail::Image_tag) {
+    using OutPixel = typename OutImageT::Pixel;
+    OutPixel* outRow = outImage.getArray()[outY].getData() + outX;
+    auto const bufArray = buffer.getArray();
+    std::fill(outRow, outRow + width, OutPixel(0));
+    for (std::size_t k = 0; k < kernelVec.size(); ++k) {
+        accumulateKernelProducts(outRow, bufArray[k].getData(), kernelVec[k], width);
+    }
+}
+
+template <typename OutImageT>
+inline void convolveColumnsWithVector(OutImageT& outImage, int outX, int outY, OutImageT const& buffer,
+                                      std::vector<lsst::afw::math::Kernel::Pixel> const& kernelVec,
+                                      int width, lsst::afw::image::detail::MaskedImage_tag) {
+    auto const outRow = getMaskedRow(outImage, outX, outY);
+    zeroMaskedRow(outRow, width);
+    for (std::size_t k = 0; k < kernelVec.size(); ++k) {
+        accumulateMaskedKernelProducts(outRow, getMaskedRow(buffer, 0, static_cast<int>(k)), kernelVec[k],
+                                       width);
+    }
+}
+
+/**
+ * @internal Convolve an %image with a spatially invariant kernel image
+ *
+ * Sets the good pixels of convolvedImage (see basicConvolve).
+ * Both versions work a row at a time: the products for each kernel row are summed into a row buffer,
+ * which is then added to the output row. The MaskedImage version computes all three planes in one pass,
+ * unless the masked pixels are sparse enough that it is cheaper to dilate the SpanSet of each mask plane
+ * by the kernel's nonzero pixels than to OR the mask under every kernel pixel; the result is the same.
+ */
+template <typename OutImageT, typename InImageT>
+void convolveWithKernelImage(OutImageT& convolvedImage, InImageT const& inImage,
+                             lsst::afw::image::Image<lsst::afw::math::Kernel::Pixel> const& kernelImage,
+                             lsst::geom::Point2I const& kernelCtr, lsst::afw::image::detail::Image_tag) {
+    using OutPixel = typename OutImageT::Pixel;
+    int const kWidth = kernelImage.getWidth();
+    int const kHeight = kernelImage.getHeight();
+    int const cnvWidth = inImage.getWidth() + 1 - kWidth;
+    int const cnvHeight = inImage.getHeight() + 1 - kHeight;
+
+    auto const inArray = inImage.getArray();
+    auto const kernelArray = kernelImage.getArray();
+    auto cnvArray = convolvedImage.getArray();
+    std::vector<OutPixel> rowSum(cnvWidth);
+    for (int inStartY = 0; inStartY < cnvHeight; ++inStartY) {
+        // as in the MaskedImage version, the first kernel row sets the output pixels
+        // and each subsequent kernel row's dot products are added to them
+        OutPixel* cnvRow = cnvArray[inStartY + kernelCtr.getY()].getData() + kernelCtr.getX();
+        for (int kernelY = 0; kernelY < kHeight; ++kernelY) {
+            OutPixel* sumRow = (kernelY == 0) ? cnvRow : rowSum.data();
+            typename InImageT::Pixel const* inRow = inArray[inStartY + kernelY].getData();
+            lsst::afw::math::Kernel::Pixel const* kernelRow = kernelArray[kernelY].getData();
+            std::fill(sumRow, sumRow + cnvWidth, OutPixel(0));
+            for (int kernelX = 0; kernelX < kWidth; ++kernelX) {
+                accumulateKernelProducts(sumRow, inRow + kernelX, kernelRow[kernelX], cnvWidth);
+            }
+            if (kernelY > 0) {
+                for (int x = 0; x < cnvWidth; ++x) {
+                    cnvRow[x] += rowSum[x];
+                }
+            }
+        }
+    }
+}
+
+template <typename OutImageT, typename InImageT>
+void convolveWithKernelImage(OutImageT& convolvedImage, InImageT const& inImage,
+                             lsst::afw::image::Image<lsst::afw::math::Kernel::Pixel> const& kernelImage,
+                             lsst::geom::Point2I const& kernelCtr,
+                             lsst::afw::image::detail::MaskedImage_tag) {
+    using OutImagePixel = typename OutImageT::Image::Pixel;
+    using OutMaskPixel = typename OutImageT::Mask::Pixel;
+    using OutVariancePixel = typename OutImageT::Variance::Pixel;
+    int const kWidth = kernelImage.getWidth();
+    int const kHeight = kernelImage.getHeight();
+    int const cnvWidth = inImage.getWidth() + 1 - kWidth;
+    int const cnvHeight = inImage.getHeight() + 1 - kHeight;
+
+    // the cost of a dilation is roughly proportional to the product of the numbers of spans,
+    // with each pair of spans costing about as much as OR-ing spanCost pixels
+    std::size_t const spanCost = 32;
+    auto const planeList = getMaskPlaneSpans(*inImage.getMask());
+    lsst::afw::geom::SpanSet const stencil =
+            makeMaskStencil(kernelImage, kernelCtr, convolvedImage.getXY0() - inImage.getXY0());
+    std::size_t nDilatedSpans = 0;
+    for (auto const& plane : planeList) {
+        nDilatedSpans += plane.second->size() * stencil.size();
+    }
+    bool const doDilateMask = nDilatedSpans * spanCost < static_cast<std::size_t>(cnvWidth) * cnvHeight *
+                                                                 static_cast<std::size_t>(stencil.getArea());
+
+    auto const kernelArray = kernelImage.getArray();
+    std::vector<OutImagePixel> imageRowSum(cnvWidth);
+    std::vector<OutMaskPixel> maskRowSum(cnvWidth);
+    std::vector<OutVariancePixel> varianceRowSum(cnvWidth);
+    MaskedRow<OutImagePixel, OutMaskPixel, OutVariancePixel> const rowSum{
+            imageRowSum.data(), maskRowSum.data(), varianceRowSum.data()};
+    for (int inStartY = 0; inStartY < cnvHeight; ++inStartY) {
+        auto const cnvRow = getMaskedRow(convolvedImage, kernelCtr.getX(), inStartY + kernelCtr.getY());
+        for (int kernelY = 0; kernelY < kHeight; ++kernelY) {
+            auto const& sumRow = (kernelY == 0) ? cnvRow : rowSum;
+            lsst::afw::math::Kernel::Pixel const* kernelRow = kernelArray[kernelY].getData();
+            zeroMaskedRow(sumRow, cnvWidth);
+            for (int kernelX = 0; kernelX < kWidth; ++kernelX) {
+                auto const inRow = getMaskedRow(inImage, kernelX, inStartY + kernelY);
+                if (doDilateMask) {
+                    accumulateMaskedKernelProducts<false>(sumRow, inRow, kernelRow[kernelX], cnvWidth);
+                } else {
+                    accumulateMaskedKernelProducts(sumRow, inRow, kernelRow[kernelX], cnvWidth);
+                }
+            }
+            if (kernelY > 0) {
+                for (int x = 0; x < cnvWidth; ++x) {
+                    cnvRow.image[x] += rowSum.image[x];
+                    cnvRow.mask[x] |= rowSum.mask[x];
+                    cnvRow.variance[x] += rowSum.variance[x];
+                }
+            }
+        }
+    }
+    if (doDilateMask) {
+        // the mask of the good pixels has been zeroed; set the bits of each plane that reach them
+        lsst::geom::Box2I const goodBBox(convolvedImage.getXY0() + lsst::geom::Extent2I(kernelCtr),
+                                         lsst::geom::Extent2I(cnvWidth, cnvHeight));
+        for (auto const& plane : planeList) {
+            auto const dilatedSpans = plane.second->dilated(stencil)->clippedTo(goodBBox);
+            dilatedSpans->setMask(*convolvedImage.getMask(), static_cast<OutMaskPixel>(plane.first));
+        }
+    }
+}
+
+/**
+ * @internal The shifted copies of the input %image that make up a convolution with a spatially varying
+ * LinearCombinationKernel whose basis kernels are all DeltaFunctionKernels
+ *
+ * Convolving with a delta-function basis kernel whose nonzero pixel is p shifts the input by p,
+ * so the convolved %image is sum_k c_k(x, y) * input shifted by p_k. Basis kernels that share a pixel
+ * are merged into a single shift whose weight is the sum of their coefficients. The weights of every
+ * shift are computed one output row at a time, from a single evaluation of the spatial model on the row.
+ */
+class DeltaFunctionShifts {
+public:
+    /**
+     * @internal Construct the shifts of a kernel
+     *
+     * @param kernel spatially varying LinearCombinationKernel with a delta-function basis
+     * @param colPosList column position of each output pixel in a row
+     * @param doNormalize if true, divide the weights of each output pixel by their sum (the kernel sum)
+     */
+    DeltaFunctionShifts(lsst::afw::math::LinearCombinationKernel const& kernel,
+                        ndarray::Array<double const, 1, 1> const& colPosList, bool doNormalize)
+            : _kernel(kernel),
+              _colPosList(colPosList),
+              _rowPosList(ndarray::allocate(1)),
+              _doNormalize(doNormalize),
+              _width(colPosList.getSize<0>()) {
+        std::map<std::pair<int, int>, std::size_t> shiftIndexMap;
+        auto const& basisList = kernel.getKernelList();
+        for (std::size_t k = 0; k < basisList.size(); ++k) {
+            lsst::geom::Point2I const pixel =
+                    std::dynamic_pointer_cast<lsst::afw::math::DeltaFunctionKernel>(basisList[k])->getPixel();
+            auto const inserted =
+                    shiftIndexMap.emplace(std::make_pair(pixel.getX(), pixel.getY()), _pixelList.size());
+            if (inserted.second) {
+                _pixelList.push_back(pixel);
+                _basisIndexList.emplace_back();
+            }
+            _basisIndexList[inserted.first->second].push_back(k);
+        }
+        _weights.resize(_pixelList.size() * _width);
+        _weightSum.resize(_width);
+    }
+
+    /// @internal Number of distinct shifts
+    std::size_t size() const { return _pixelList.size(); }
+
+    /// @internal Kernel pixel of the i-th shift
+    lsst::geom::Point2I const& getPixel(std::size_t i) const { return _pixelList[i]; }
+
+    /// @internal Weights of the i-th shift for the output pixels of the row last passed to computeRow
+    double const* getWeights(std::size_t i) const { return _weights.data() + i * _width; }
+
+    /**
+     * @internal Compute the weights of all shifts for one row of output pixels
+     *
+     * @param rowPos row position of the output pixels
+     */
+    void computeRow(double rowPos) {
+        _rowPosList[0] = rowPos;
+        ndarray::Array<double, 3, 3> const params =
+                _kernel.computeKernelParametersOnGrid(_colPosList, _rowPosList);
+        std::fill(_weightSum.begin(), _weightSum.end(), 0.0);
+        for (std::size_t i = 0; i < _pixelList.size(); ++i) {
+            double* weights = _weights.data() + i * _width;
+            std::fill(weights, weights + _width, 0.0);
+            for (std::size_t k : _basisIndexList[i]) {
+                double const* coeffs = params[k].getData();
+                for (int x = 0; x < _width; ++x) {
+                    weights[x] += coeffs[x];
+                }
+            }
+            for (int x = 0; x < _width; ++x) {
+                _weightSum[x] += weights[x];
+            }
+        }
+        if (_doNormalize) {
+            for (int x = 0; x < _width; ++x) {
+                _weightSum[x] = 1.0 / _weightSum[x];
+            }
+            for (std::size_t i = 0; i < _pixelList.size(); ++i) {
+                double* weights = _weights.data() + i * _width;
+                for (int x = 0; x < _width; ++x) {
+                    weights[x] *= _weightSum[x];
+                }
+            }
+        }
+    }
+
+private:
+    lsst::afw::math::LinearCombinationKernel const& _kernel;
+    ndarray::Array<double const, 1, 1> _colPosList;
+    ndarray::Array<double, 1, 1> _rowPosList;
+    bool _doNormalize;
+    int _width;
+    std::vector<lsst::geom::Point2I> _pixelList;
+    std::vector<std::vector<std::size_t>> _basisIndexList;  // basis kernels of each shift
+    std::vector<double> _weights;                           // [shift, x] for the current row
+    std::vector<double> _weightSum;
+};
+
+/**
+ * @internal Return true if a kernel is a LinearCombinationKernel whose basis kernels are all
+ * DeltaFunctionKernels
+ */
+bool isDeltaFunctionBasis(lsst::afw::math::Kernel const& kernel) {
+    auto const lcKernel = dynamic_cast<lsst::afw::math::LinearCombinationKernel const*>(&kernel);
+    return lcKernel != nullptr && lcKernel->isDeltaFunctionBasis();
+}
+
+/**
+ * @internal Compute the column position of each good output pixel of a convolution
+ */
+template <typename InImageT>
+ndarray::Array<double const, 1, 1> getGoodColumnPositions(InImageT const& inImage,
+                                                          lsst::afw::math::Kernel const& kernel) {
+    int const cnvWidth = inImage.getWidth() + 1 - kernel.getWidth();
+    ndarray::Array<double, 1, 1> colPosList = ndarray::allocate(cnvWidth);
+    for (int x = 0; x < cnvWidth; ++x) {
+        colPosList[x] = inImage.indexToPosition(x + kernel.getCtr().getX(), lsst::afw::image::X);
+    }
+    return colPosList;
+}
+
+/**
+ * @internal Convolve an %image with a spatially varying LinearCombinationKernel
+ * whose basis kernels are all DeltaFunctionKernels
+ *
+ * Sets the good pixels of convolvedImage (see basicConvolve). Rather than computing a kernel image
+ * at each pixel, or convolving the input by each basis kernel in turn, each output row is accumulated
+ * in one pass as the weighted sum of the shifted input rows, one contiguous multiply-add per shift.
+ * The result agrees with convolveWithBruteForce to within round-off; the MaskedImage version smears
+ * the mask by the shifts with nonzero weight, and weights the variance by the square of each weight.
+ */
+template <typename OutImageT, typename InImageT>
+void convolveWithDeltaFunctionBasis(OutImageT& convolvedImage, InImageT const& inImage,
+                                    lsst::afw::math::LinearCombinationKernel const& kernel, bool doNormalize,
+                                    lsst::afw::image::detail::Image_tag) {
+    using OutPixel = typename OutImageT::Pixel;
+    int const cnvWidth = inImage.getWidth() + 1 - kernel.getWidth();
+    int const cnvHeight = inImage.getHeight() + 1 - kernel.getHeight();
+    int const cnvStartX = kernel.getCtr().getX();
+    int const cnvStartY = kernel.getCtr().getY();
+
+    DeltaFunctionShifts shifts(kernel, getGoodColumnPositions(inImage, kernel), doNormalize);
+    auto const inArray = inImage.getArray();
+    auto cnvArray = convolvedImage.getArray();
+    std::vector<double> rowSum(cnvWidth);
+    for (int inStartY = 0; inStartY < cnvHeight; ++inStartY) {
+        shifts.computeRow(inImage.indexToPosition(inStartY + cnvStartY, lsst::afw::image::Y));
+        std::fill(rowSum.begin(), rowSum.end(), 0.0);
+        for (std::size_t i = 0; i < shifts.size(); ++i) {
+            lsst::geom::Point2I const& pixel = shifts.getPixel(i);
+            double const* weights = shifts.getWeights(i);
+            typename InImageT::Pixel const* inRow =
+                    inArray[inStartY + pixel.getY()].getData() + pixel.getX();
+            for (int x = 0; x < cnvWidth; ++x) {
+                rowSum[x] += weights[x] * inRow[x];
+            }
+        }
+        OutPixel* cnvRow = cnvArray[inStartY + cnvStartY].getData() + cnvStartX;
+        for (int x = 0; x < cnvWidth; ++x) {
+            cnvRow[x] = static_cast<OutPixel>(rowSum[x]);
+        }
+    }
+}
+
+template <typename OutImageT, typename InImageT>
+void convolveWithDeltaFunctionBasis(OutImageT& convolvedImage, InImageT const& inImage,
+                                    lsst::afw::math::LinearCombinationKernel const& kernel, bool doNormalize,
+                                    lsst::afw::image::detail::MaskedImage_tag) {
+    using OutImagePixel = typename OutImageT::Image::Pixel;
+    using OutMaskPixel = typename OutImageT::Mask::Pixel;
+    using OutVariancePixel = typename OutImageT::Variance::Pixel;
+    int const cnvWidth = inImage.getWidth() + 1 - kernel.getWidth();
+    int const cnvHeight = inImage.getHeight() + 1 - kernel.getHeight();
+    int const cnvStartX = kernel.getCtr().getX();
+    int const cnvStartY = kernel.getCtr().getY();
+
+    DeltaFunctionShifts shifts(kernel, getGoodColumnPositions(inImage, kernel), doNormalize);
+    std::vector<double> imageRowSum(cnvWidth);
+    std::vector<OutMaskPixel> maskRowSum(cnvWidth);
+    std::vector<double> varianceRowSum(cnvWidth);
+    for (int inStartY = 0; inStartY < cnvHeight; ++inStartY) {
+        shifts.computeRow(inImage.indexToPosition(inStartY + cnvStartY, lsst::afw::image::Y));
+        std::fill(imageRowSum.begin(), imageRowSum.end(), 0.0);
+        std::fill(maskRowSum.begin(), maskRowSum.end(), OutMaskPixel(0));
+        std::fill(varianceRowSum.begin(), varianceRowSum.end(), 0.0);
+        for (std::size_t i = 0; i < shifts.size(); ++i) {
+            lsst::geom::Point2I const& pixel = shifts.getPixel(i);
+            double const* weights = shifts.getWeights(i);
+            auto const inRow = getMaskedRow(inImage, pixel.getX(), inStartY + pixel.getY());
+            for (int x = 0; x < cnvWidth; ++x) {
+                double const weight = weights[x];
+                imageRowSum[x] += weight * inRow.image[x];
+                maskRowSum[x] |= (weight != 0) ? inRow.mask[x] : 0;
+                varianceRowSum[x] += weight * weight * inRow.variance[x];
+            }
+        }
+        auto const cnvRow = getMaskedRow(convolvedImage, cnvStartX, inStartY + cnvStartY);
+        for (int x = 0; x < cnvWidth; ++x) {
+            cnvRow.image[x] = static_cast<OutImagePixel>(imageRowSum[x]);
+            cnvRow.mask[x] = maskRowSum[x];
+            cnvRow.variance[x] = static_cast<OutVariancePixel>(varianceRowSum[x]);
         }
     }
-    return outPixel;
 }
 }  // anonymous namespace
 
@@ -214,6 +686,14 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage,
         LOGL_DEBUG("TRACE2.lsst.afw.math.convolve.basicConvolve",
                    "basicConvolve for LinearCombinationKernel: spatially invariant; using brute force");
         return convolveWithBruteForce(convolvedImage, inImage, kernel, convolutionControl.getDoNormalize());
+    } else if (kernel.isDeltaFunctionBasis()) {
+        // sum shifted copies of the input; this is exact, and refactoring would lose the sparsity
+        LOGL_DEBUG("TRACE2.lsst.afw.math.convolve.basicConvolve",
+                   "basicConvolve for LinearCombinationKernel: delta function basis; using shifted sums");
+        assertDimensionsOK(convolvedImage, inImage, kernel);
+        using ImageCategory = typename image::detail::image_traits<OutImageT>::image_category;
+        return convolveWithDeltaFunctionBasis(convolvedImage, inImage, kernel,
+                                              convolutionControl.getDoNormalize(), ImageCategory());
     } else {
         // refactor the kernel if this is reasonable and possible;
         // then use the standard algorithm for the spatially varying case
@@ -247,12 +727,8 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage, math::Sep
                    math::ConvolutionControl const& convolutionControl) {
     using KernelPixel = typename math::Kernel::Pixel;
     using KernelVector = typename std::vector<KernelPixel>;
-    using KernelIterator = KernelVector::const_iterator;
-    using InXIterator = typename InImageT::const_x_iterator;
     using InXYLocator = typename InImageT::const_xy_locator;
     using OutXIterator = typename OutImageT::x_iterator;
-    using OutYIterator = typename OutImageT::y_iterator;
-    using OutPixel = typename OutImageT::SinglePixel;
 
     assertDimensionsOK(convolvedImage, inImage, kernel);
 
@@ -299,8 +775,7 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage, math::Sep
                    "SeparableKernel basicConvolve: kernel is spatially invariant");
 
         kernel.computeVectors(kernelXVec, kernelYVec, convolutionControl.getDoNormalize());
-        KernelIterator const kernelXVecBegin = kernelXVec.begin();
-        KernelIterator const kernelYVecBegin = kernelYVec.begin();
+        typename image::detail::image_traits<OutImageT>::image_category const imageCategory{};
 
         // buffer for x-convolved data
         OutImageT buffer(lsst::geom::Extent2I(goodBBox.getWidth(), kernel.getHeight()));
@@ -309,13 +784,8 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage, math::Sep
         int yInd = 0;  // during initial fill bufY = inImageY
         int const yPrefillEnd = buffer.getHeight() - 1;
         for (; yInd < yPrefillEnd; ++yInd) {
-            OutXIterator bufXIter = buffer.x_at(0, yInd);
-            OutXIterator const bufXEnd = buffer.x_at(goodBBox.getWidth(), yInd);
-            InXIterator inXIter = inImage.x_at(0, yInd);
-            for (; bufXIter != bufXEnd; ++bufXIter, ++inXIter) {
-                *bufXIter = kernelDotProduct<OutPixel, InXIterator, KernelIterator, KernelPixel>(
-                        inXIter, kernelXVecBegin, kernel.getWidth());
-            }
+            convolveRowWithVector(buffer, yInd, inImage, yInd, kernelXVec, goodBBox.getWidth(),
+                                  imageCategory);
         }
 
         // compute output pixels using the sequence described above
@@ -324,19 +794,9 @@ void basicConvolve(OutImageT& convolvedImage, InImageT const& inImage, math::Sep
         int cnvY = goodBBox.getMinY();
         while (true) {
             // fill next buffer row and compute output row
-            InXIterator inXIter = inImage.x_at(0, inY);
-            OutXIterator bufXIter = buffer.x_at(0, bufY);
-            OutXIterator cnvXIter = convolvedImage.x_at(goodBBox.getMinX(), cnvY);
-            for (int bufX = 0; bufX < goodBBox.getWidth(); ++bufX, ++cnvXIter, ++bufXIter, ++inXIter) {
-                // note: bufXIter points to the row of the buffer that is being updated,
-                // whereas bufYIter points to row 0 of the buffer
-                *bufXIter = kernelDotProduct<OutPixel, InXIterator, KernelIterator, KernelPixel>(
-                        inXIter, kernelXVecBegin, kernel.getWidth());
-
-                OutYIterator bufYIter = buffer.y_at(bufX, 0);
-                *cnvXIter = kernelDotProduct<OutPixel, OutYIterator, KernelIterator, KernelPixel>(
-                        bufYIter, kernelYVecBegin, kernel.getHeight());
-            }
+            convolveRowWithVector(buffer, bufY, inImage, inY, kernelXVec, goodBBox.getWidth(), imageCategory);
+            convolveColumnsWithVector(convolvedImage, goodBBox.getMinX(), cnvY, buffer, kernelYVec,
+                                      goodBBox.getWidth(), imageCategory);
 
             // test for done now, instead of the start of the loop,
             // to avoid an unnecessary extra rotation of the kernel Y vector
@@ -359,12 +819,9 @@ void convolveWithBruteForce(OutImageT& convolvedImage, InImageT const& inImage,
     using KernelPixel = typename math::Kernel::Pixel;
     using KernelImage = image::Image<KernelPixel>;
 
-    using KernelXIterator = typename KernelImage::const_x_iterator;
     using KernelXYLocator = typename KernelImage::const_xy_locator;
-    using InXIterator = typename InImageT::const_x_iterator;
     using InXYLocator = typename InImageT::const_xy_locator;
     using OutXIterator = typename OutImageT::x_iterator;
-    using OutPixel = typename OutImageT::SinglePixel;
 
     assertDimensionsOK(convolvedImage, inImage, kernel);
 
@@ -406,26 +863,48 @@ void convolveWithBruteForce(OutImageT& convolvedImage, InImageT const& inImage,
                    "convolveWithBruteForce: kernel is spatially invariant");
 
         (void)kernel.computeImage(kernelImage, doNormalize);
+        convolveWithKernelImage(convolvedImage, inImage, kernelImage, kernel.getCtr(),
+                                typename image::detail::image_traits<OutImageT>::image_category());
+    }
+}
 
-        for (int inStartY = 0, cnvY = cnvStartY; inStartY < cnvHeight; ++inStartY, ++cnvY) {
-            KernelXIterator kernelXIter = kernelImage.x_at(0, 0);
-            InXIterator inXIter = inImage.x_at(0, inStartY);
-            OutXIterator cnvXIter = convolvedImage.x_at(cnvStartX, cnvY);
-            for (int x = 0; x < cnvWidth; ++x, ++cnvXIter, ++inXIter) {
-                *cnvXIter = kernelDotProduct<OutPixel, InXIterator, KernelXIterator, KernelPixel>(
-                        inXIter, kernelXIter, kWidth);
-            }
-            for (int kernelY = 1, inY = inStartY + 1; kernelY < kHeight; ++inY, ++kernelY) {
-                KernelXIterator kernelXIter = kernelImage.x_at(0, kernelY);
-                InXIterator inXIter = inImage.x_at(0, inY);
-                OutXIterator cnvXIter = convolvedImage.x_at(cnvStartX, cnvY);
-                for (int x = 0; x < cnvWidth; ++x, ++cnvXIter, ++inXIter) {
-                    *cnvXIter += kernelDotProduct<OutPixel, InXIterator, KernelXIterator, KernelPixel>(
-                            inXIter, kernelXIter, kWidth);
-                }
-            }
-        }
+template <typename OutImageT, typename InImageT>
+void convolveInRowBands(OutImageT& convolvedImage, InImageT const& inImage, math::Kernel const& kernel,
+                        math::ConvolutionControl const& convolutionControl) {
+    int const nThreads = resolveNumThreads(convolutionControl.getNumThreads());
+    bool const usesInterpolation = kernel.isSpatiallyVarying() &&
+                                   (convolutionControl.getMaxInterpolationDistance() > 1) &&
+                                   !IS_INSTANCE(kernel, math::SeparableKernel) &&
+                                   !isDeltaFunctionBasis(kernel);
+    if (nThreads == 1 || usesInterpolation) {
+        basicConvolve(convolvedImage, inImage, kernel, convolutionControl);
+        return;
     }
+    assertDimensionsOK(convolvedImage, inImage, kernel);
+
+    int const kHeight = kernel.getHeight();
+    int const kCtrY = kernel.getCtr().getY();
+    int const cnvHeight = inImage.getHeight() + 1 - kHeight;
+    std::vector<std::pair<int, int>> const bandList = splitRange(0, cnvHeight, nThreads, kHeight);
+    LOGL_DEBUG("TRACE2.lsst.afw.math.convolve.convolveInRowBands",
+               "convolveInRowBands: %d good rows in %d bands", cnvHeight, static_cast<int>(bandList.size()));
+
+    math::ConvolutionControl bandControl(convolutionControl);
+    bandControl.setNumThreads(1);
+    parallelFor(bandList.size(), nThreads, [&](int i) {
+        // a band of good rows [begin, end) needs input rows [begin, end + kHeight - 1);
+        // the output view has the same bounding box, so its good region is exactly the band
+        int const begin = bandList[i].first;
+        int const end = bandList[i].second;
+        lsst::geom::Box2I const bandBBox(lsst::geom::Point2I(0, begin),
+                                         lsst::geom::Extent2I(inImage.getWidth(), end - begin + kHeight - 1));
+        InImageT const inView(inImage, bandBBox, image::LOCAL);
+        OutImageT outView(convolvedImage, bandBBox, image::LOCAL);
+        std::shared_ptr<math::Kernel> bandKernel = kernel.clone();
+        LOGL_DEBUG("TRACE4.lsst.afw.math.convolve.convolveInRowBands",
+                   "convolveInRowBands: band %d: rows [%d, %d)", i, begin + kCtrY, end + kCtrY);
+        basicConvolve(outView, inView, *bandKernel, bandControl);
+    });
 }
 
 /*
@@ -446,7 +925,9 @@ void convolveWithBruteForce(OutImageT& convolvedImage, InImageT const& inImage,
     NL template void basicConvolve(IMGMACRO(OUTPIXTYPE)&, IMGMACRO(INPIXTYPE) const &,                     \
                                    math::SeparableKernel const&, math::ConvolutionControl const&);         \
     NL template void convolveWithBruteForce(IMGMACRO(OUTPIXTYPE)&, IMGMACRO(INPIXTYPE) const &,            \
-                                            math::Kernel const&, math::ConvolutionControl const&);
+                                            math::Kernel const&, math::ConvolutionControl const&);         \
+    NL template void convolveInRowBands(IMGMACRO(OUTPIXTYPE)&, IMGMACRO(INPIXTYPE) const &,                \
+                                        math::Kernel const&, math::ConvolutionControl const&);
 // Instantiate both Image and MaskedImage versions
 #define INSTANTIATE(OUTPIXTYPE, INPIXTYPE)             \
     INSTANTIATE_IM_OR_MI(IMAGE, OUTPIXTYPE, INPIXTYPE) \
@@ -0,0 +1,282 @@
+// -*- LSST-C++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Definition of convolveWithFft and shouldConvolveWithFft, declared in detail/Convolve.h
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <type_traits>
+
+#include "fftw3.h"
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/log/Log.h"
+#include "lsst/geom.h"
+#include "lsst/afw/math/Kernel.h"
+#include "lsst/afw/math/detail/Convolve.h"
+#include "lsst/afw/math/detail/Parallel.h"
+
+namespace pexExcept = lsst::pex::exceptions;
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+
+namespace {
+
+struct FftwFree {
+    void operator()(void* ptr) const { fftw_free(ptr); }
+};
+
+struct FftwDestroyPlan {
+    void operator()(fftw_plan plan) const { fftw_destroy_plan(plan); }
+};
+
+using RealBuffer = std::unique_ptr<double[], FftwFree>;
+using ComplexBuffer = std::unique_ptr<fftw_complex[], FftwFree>;
+using Plan = std::unique_ptr<std::remove_pointer<fftw_plan>::type, FftwDestroyPlan>;
+
+RealBuffer allocateReal(int size) {
+    auto ptr = static_cast<double*>(fftw_malloc(sizeof(double) * size));
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return RealBuffer(ptr);
+}
+
+ComplexBuffer allocateComplex(int size) {
+    auto ptr = static_cast<fftw_complex*>(fftw_malloc(sizeof(fftw_complex) * size));
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ComplexBuffer(ptr);
+}
+
+/*
+ * The FFTW planner is not thread-safe (execution of an existing plan is)
+ */
+std::mutex& getPlannerMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+/*
+ * Length of the transform along one axis: a power of 2 at least 4 times the kernel length
+ * (so at least 3/4 of each transform yields good pixels), but no longer than the image.
+ */
+int computeFftLength(int kernelLength, int imageLength) {
+    int fftLength = 64;
+    while (fftLength < 4 * kernelLength) {
+        fftLength *= 2;
+    }
+    return std::min(fftLength, imageLength);
+}
+
+template <typename PixelT>
+bool isFinite(PixelT value) {
+    return std::isfinite(static_cast<double>(value));
+}
+
+}  // anonymous namespace
+
+bool shouldConvolveWithFft(math::Kernel const& kernel, math::ConvolutionControl const& convolutionControl) {
+    int const minSize = convolutionControl.getMinFftKernelSize();
+    if (minSize <= 0 || kernel.isSpatiallyVarying()) {
+        return false;
+    }
+    if (IS_INSTANCE(kernel, math::DeltaFunctionKernel) || IS_INSTANCE(kernel, math::SeparableKernel)) {
+        return false;
+    }
+    return kernel.getWidth() >= minSize && kernel.getHeight() >= minSize;
+}
+
+template <typename OutImageT, typename InImageT>
+void convolveWithFft(OutImageT& convolvedImage, InImageT const& inImage, math::Kernel const& kernel,
+                     math::ConvolutionControl const& convolutionControl) {
+    using KernelImage = image::Image<math::Kernel::Pixel>;
+    using OutPixel = typename OutImageT::SinglePixel;
+    using InPixel = typename InImageT::SinglePixel;
+
+    if (convolvedImage.getDimensions() != inImage.getDimensions()) {
+        std::ostringstream os;
+        os << "convolvedImage dimensions = ( " << convolvedImage.getWidth() << ", "
+           << convolvedImage.getHeight() << ") != (" << inImage.getWidth() << ", " << inImage.getHeight()
+           << ") = inImage dimensions";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+    if ((kernel.getWidth() < 1) || (kernel.getHeight() < 1)) {
+        std::ostringstream os;
+        os << "kernel dimensions = ( " << kernel.getWidth() << ", " << kernel.getHeight()
+           << ") smaller than (1, 1) in width and/or height";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+    if (inImage.getWidth() < kernel.getWidth() || inImage.getHeight() < kernel.getHeight()) {
+        std::ostringstream os;
+        os << "inImage dimensions = ( " << inImage.getWidth() << ", " << inImage.getHeight()
+           << ") smaller than (" << kernel.getWidth() << ", " << kernel.getHeight()
+           << ") = kernel dimensions in width and/or height";
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
+    }
+    if (kernel.isSpatiallyVarying()) {
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError,
+                          "convolveWithFft does not support spatially varying kernels");
+    }
+
+    int const kWidth = kernel.getWidth();
+    int const kHeight = kernel.getHeight();
+    int const kCtrX = kernel.getCtr().getX();
+    int const kCtrY = kernel.getCtr().getY();
+    int const cnvWidth = inImage.getWidth() + 1 - kWidth;
+    int const cnvHeight = inImage.getHeight() + 1 - kHeight;
+
+    int const fftWidth = computeFftLength(kWidth, inImage.getWidth());
+    int const fftHeight = computeFftLength(kHeight, inImage.getHeight());
+    int const nReal = fftWidth * fftHeight;
+    int const nComplex = fftHeight * (fftWidth / 2 + 1);
+    // number of good output pixels computed by each transform
+    int const tileWidth = fftWidth + 1 - kWidth;
+    int const tileHeight = fftHeight + 1 - kHeight;
+    int const nTilesX = (cnvWidth + tileWidth - 1) / tileWidth;
+    int const nTilesY = (cnvHeight + tileHeight - 1) / tileHeight;
+    LOGL_DEBUG("TRACE2.lsst.afw.math.convolve.convolveWithFft",
+               "convolveWithFft: %d x %d transforms, %d x %d tiles", fftWidth, fftHeight, nTilesX, nTilesY);
+
+    KernelImage kernelImage(kernel.getDimensions());
+    (void)kernel.computeImage(kernelImage, convolutionControl.getDoNormalize());
+
+    // Compute conj(FFT(kernel)) / nReal, so that the inverse transform of its product
+    // with the transform of an input tile is the correlation
+    //     out(x, y) = sum_{i,j} in(x + i, y + j) kernel(i, j)
+    // which is what basicConvolve computes (FFTW transforms are unnormalized).
+    RealBuffer realBuffer = allocateReal(nReal);
+    ComplexBuffer kernelTransform = allocateComplex(nComplex);
+    Plan forwardPlan;
+    Plan inversePlan;
+    {
+        std::lock_guard<std::mutex> lock(getPlannerMutex());
+        forwardPlan.reset(fftw_plan_dft_r2c_2d(fftHeight, fftWidth, realBuffer.get(), kernelTransform.get(),
+                                               FFTW_ESTIMATE));
+        inversePlan.reset(fftw_plan_dft_c2r_2d(fftHeight, fftWidth, kernelTransform.get(), realBuffer.get(),
+                                               FFTW_ESTIMATE));
+    }
+    if (!forwardPlan || !inversePlan) {
+        throw LSST_EXCEPT(pexExcept::RuntimeError, "Could not create FFTW plans");
+    }
+    std::fill(realBuffer.get(), realBuffer.get() + nReal, 0.0);
+    auto const kernelArray = kernelImage.getArray();
+    for (int y = 0; y < kHeight; ++y) {
+        std::copy(kernelArray[y].begin(), kernelArray[y].end(), realBuffer.get() + y * fftWidth);
+    }
+    fftw_execute_dft_r2c(forwardPlan.get(), realBuffer.get(), kernelTransform.get());
+    double const scale = 1.0 / static_cast<double>(nReal);
+    for (int i = 0; i < nComplex; ++i) {
+        kernelTransform[i][0] *= scale;
+        kernelTransform[i][1] *= -scale;
+    }
+
+    // tiles whose input has non-finite pixels are convolved in real space with the same kernel image
+    math::FixedKernel fixedKernel(kernelImage);
+    fixedKernel.setCtr(kernel.getCtr());
+    math::ConvolutionControl const realSpaceControl(false);
+
+    auto const inArray = inImage.getArray();
+    auto cnvArray = convolvedImage.getArray();
+    parallelFor(nTilesX * nTilesY, resolveNumThreads(convolutionControl.getNumThreads()), [&](int tile) {
+        // the tile's good output pixels are [x0, x0 + nx) x [y0, y0 + ny), offset by the kernel center;
+        // they need input pixels [x0, x0 + nx + kWidth - 1) x [y0, y0 + ny + kHeight - 1)
+        int const x0 = (tile % nTilesX) * tileWidth;
+        int const y0 = (tile / nTilesX) * tileHeight;
+        int const nx = std::min(tileWidth, cnvWidth - x0);
+        int const ny = std::min(tileHeight, cnvHeight - y0);
+        int const inWidth = nx + kWidth - 1;
+        int const inHeight = ny + kHeight - 1;
+
+        bool hasNonFinite = false;
+        for (int y = y0; y < y0 + inHeight && !hasNonFinite; ++y) {
+            InPixel const* inRow = inArray[y].getData() + x0;
+            hasNonFinite = !std::all_of(inRow, inRow + inWidth, isFinite<InPixel>);
+        }
+        if (hasNonFinite) {
+            lsst::geom::Box2I const bbox(lsst::geom::Point2I(x0, y0),
+                                         lsst::geom::Extent2I(inWidth, inHeight));
+            InImageT const inView(inImage, bbox, image::LOCAL);
+            OutImageT outView(convolvedImage, bbox, image::LOCAL);
+            convolveWithBruteForce(outView, inView, fixedKernel, realSpaceControl);
+            return;
+        }
+
+        RealBuffer tileBuffer = allocateReal(nReal);
+        ComplexBuffer tileTransform = allocateComplex(nComplex);
+        std::fill(tileBuffer.get(), tileBuffer.get() + nReal, 0.0);
+        for (int y = 0; y < inHeight; ++y) {
+            InPixel const* inRow = inArray[y0 + y].getData() + x0;
+            std::copy(inRow, inRow + inWidth, tileBuffer.get() + y * fftWidth);
+        }
+        fftw_execute_dft_r2c(forwardPlan.get(), tileBuffer.get(), tileTransform.get());
+        for (int i = 0; i < nComplex; ++i) {
+            double const re = tileTransform[i][0] * kernelTransform[i][0] -
+                              tileTransform[i][1] * kernelTransform[i][1];
+            double const im = tileTransform[i][0] * kernelTransform[i][1] +
+                              tileTransform[i][1] * kernelTransform[i][0];
+            tileTransform[i][0] = re;
+            tileTransform[i][1] = im;
+        }
+        fftw_execute_dft_c2r(inversePlan.get(), tileTransform.get(), tileBuffer.get());
+        for (int y = 0; y < ny; ++y) {
+            OutPixel* cnvRow = cnvArray[y0 + y + kCtrY].getData() + x0 + kCtrX;
+            double const* tileRow = tileBuffer.get() + y * fftWidth;
+            for (int x = 0; x < nx; ++x) {
+                cnvRow[x] = static_cast<OutPixel>(tileRow[x]);
+            }
+        }
+    });
+}
+
+/*
+ * Explicit instantiation
+ */
+/// @cond
+#define IMAGE(PIXTYPE) image::Image<PIXTYPE>
+#define INSTANTIATE(OUTPIXTYPE, INPIXTYPE)                                                  \
+    template void convolveWithFft(IMAGE(OUTPIXTYPE)&, IMAGE(INPIXTYPE) const&, math::Kernel const&, \
+                                  math::ConvolutionControl const&);
+
+INSTANTIATE(double, double)
+INSTANTIATE(double, float)
+INSTANTIATE(double, int)
+INSTANTIATE(double, std::uint16_t)
+INSTANTIATE(float, float)
+INSTANTIATE(float, int)
+INSTANTIATE(float, std::uint16_t)
+/// @endcond
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
@@ -25,7 +25,9 @@
 /*
  * Definition of convolveWithInterpolation and helper functions declared in detail/ConvolveImage.h
  */
+#include <memory>
 #include <sstream>
+#include <vector>
 
 #include "lsst/pex/exceptions.h"
 #include "lsst/log/Log.h"
@@ -33,6 +35,7 @@
 #include "lsst/afw/image/MaskedImage.h"
 #include "lsst/afw/math/Kernel.h"
 #include "lsst/afw/math/detail/Convolve.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace pexExcept = lsst::pex::exceptions;
 
@@ -71,16 +74,43 @@ void convolveWithInterpolation(OutImageT &outImage, InImageT const &inImage, mat
     LOGL_DEBUG("TRACE3.lsst.afw.math.convolve.convolveWithInterpolation",
                "convolveWithInterpolation: divide into %d x %d subregions", nx, ny);
 
-    ConvolveWithInterpolationWorkingImages workingImages(kernel.getDimensions());
+    int const nThreads = resolveNumThreads(convolutionControl.getNumThreads());
+    if (nThreads == 1) {
+        ConvolveWithInterpolationWorkingImages workingImages(kernel.getDimensions());
+        RowOfKernelImagesForRegion regionRow(nx, ny);
+        while (goodRegion.computeNextRow(regionRow)) {
+            for (auto const &rgnIter : regionRow) {
+                LOGL_DEBUG("TRACE5.lsst.afw.math.convolve.convolveWithInterpolation",
+                           "convolveWithInterpolation: bbox minimum=(%d, %d), extent=(%d, %d)",
+                           rgnIter->getBBox().getMinX(), rgnIter->getBBox().getMinY(),
+                           rgnIter->getBBox().getWidth(), rgnIter->getBBox().getHeight());
+                convolveRegionWithInterpolation(outImage, inImage, *rgnIter, workingImages);
+            }
+        }
+        return;
+    }
+
+    // The corner kernel images of each row of subregions are computed serially by computeNextRow
+    // (computing a kernel image modifies the kernel); the subregions of the row are then convolved
+    // concurrently. Each group of subregions gets its own working images, and the subregions
+    // write disjoint parts of outImage, so the result is identical to the serial loop.
+    std::vector<std::pair<int, int>> const groupList = splitRange(0, nx, nThreads);
+    LOGL_DEBUG("TRACE3.lsst.afw.math.convolve.convolveWithInterpolation",
+               "convolveWithInterpolation: convolve each row of subregions in %d groups",
+               static_cast<int>(groupList.size()));
+    std::vector<std::unique_ptr<ConvolveWithInterpolationWorkingImages>> workingImagesList;
+    for (std::size_t group = 0; group < groupList.size(); ++group) {
+        workingImagesList.push_back(
+                std::make_unique<ConvolveWithInterpolationWorkingImages>(kernel.getDimensions()));
+    }
     RowOfKernelImagesForRegion regionRow(nx, ny);
     while (goodRegion.computeNextRow(regionRow)) {
-        for (auto const &rgnIter : regionRow) {
-            LOGL_DEBUG("TRACE5.lsst.afw.math.convolve.convolveWithInterpolation",
-                       "convolveWithInterpolation: bbox minimum=(%d, %d), extent=(%d, %d)",
-                       rgnIter->getBBox().getMinX(), rgnIter->getBBox().getMinY(),
-                       rgnIter->getBBox().getWidth(), rgnIter->getBBox().getHeight());
-            convolveRegionWithInterpolation(outImage, inImage, *rgnIter, workingImages);
-        }
+        parallelFor(groupList.size(), nThreads, [&](int group) {
+            for (int i = groupList[group].first; i < groupList[group].second; ++i) {
+                convolveRegionWithInterpolation(outImage, inImage, *regionRow.getRegion(i),
+                                                *workingImagesList[group]);
+            }
+        });
     }
 }
 
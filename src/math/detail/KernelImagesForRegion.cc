@@ -25,6 +25,7 @@
 /*
  * Definition of KernelImagesForRegion class declared in detail/ConvolveImage.h
  */
+#include <algorithm>
 #include <sstream>
 #include <vector>
 
@@ -79,7 +80,7 @@ KernelImagesForRegion::ImagePtr KernelImagesForRegion::getImage(Location locatio
         return _imagePtrList[location];
     }
 
-    ImagePtr imagePtr(new Image(_kernelPtr->getDimensions()));
+    ImagePtr imagePtr(new Image(_kernelPtr->getDimensions(), image::UNINITIALIZED));
     _imagePtrList[location] = imagePtr;
     _computeImage(location);
     return imagePtr;
@@ -134,6 +135,7 @@ bool KernelImagesForRegion::computeNextRow(RowOfKernelImagesForRegion &regionRow
         }
 
     } else {
+        _computeKernelParameterGrid(regionRow.getNX(), regionRow.getNY());
         ImagePtr blImagePtr = getImage(BOTTOM_LEFT);
         ImagePtr brImagePtr;
         ImagePtr tlImagePtr;
@@ -151,6 +153,7 @@ bool KernelImagesForRegion::computeNextRow(RowOfKernelImagesForRegion &regionRow
             std::shared_ptr<KernelImagesForRegion> regionPtr(new KernelImagesForRegion(
                     _kernelPtr, lsst::geom::Box2I(blCorner, lsst::geom::Extent2I(width, height)), _xy0,
                     _doNormalize, blImagePtr, brImagePtr, tlImagePtr, trImageNullPtr));
+            regionPtr->_kernelParameterGrid = _kernelParameterGrid;
             rgnIter = regionPtr;
 
             if (!tlImagePtr) {
@@ -174,10 +177,56 @@ void KernelImagesForRegion::_computeImage(Location location) const {
     }
 
     lsst::geom::Point2I pixelIndex = getPixelIndex(location);
+    if (_kernelParameterGrid) {
+        std::vector<int> const &xIndexList = _kernelParameterGrid->xIndexList;
+        std::vector<int> const &yIndexList = _kernelParameterGrid->yIndexList;
+        auto const xIter = std::lower_bound(xIndexList.begin(), xIndexList.end(), pixelIndex.getX());
+        auto const yIter = std::lower_bound(yIndexList.begin(), yIndexList.end(), pixelIndex.getY());
+        if (xIter != xIndexList.end() && *xIter == pixelIndex.getX() && yIter != yIndexList.end() &&
+            *yIter == pixelIndex.getY()) {
+            int const col = xIter - xIndexList.begin();
+            int const row = yIter - yIndexList.begin();
+            ndarray::Array<double const, 3, 3> const &gridParams = _kernelParameterGrid->kernelParams;
+            std::vector<double> kernelParams(gridParams.getSize<0>());
+            for (std::size_t ii = 0; ii < kernelParams.size(); ++ii) {
+                kernelParams[ii] = gridParams[ii][row][col];
+            }
+            _kernelPtr->computeImageFromKernelParameters(*imagePtr, _doNormalize, kernelParams);
+            return;
+        }
+    }
     _kernelPtr->computeImage(*imagePtr, _doNormalize, image::indexToPosition(pixelIndex.getX() + _xy0[0]),
                              image::indexToPosition(pixelIndex.getY() + _xy0[1]));
 }
 
+void KernelImagesForRegion::_computeKernelParameterGrid(int nx, int ny) const {
+    if (_kernelParameterGrid || !_kernelPtr->isSpatiallyVarying() || _kernelPtr->getImageCacheMaxSize() > 0 ||
+        nx > _bbox.getWidth() || ny > _bbox.getHeight()) {
+        return;
+    }
+    auto grid = std::make_shared<KernelParameterGrid>();
+    // the corners are those found by computeNextRow: the subregion boundaries plus one beyond the far edge
+    grid->xIndexList.push_back(_bbox.getMinX());
+    for (int width : _computeSubregionLengths(_bbox.getWidth(), nx)) {
+        grid->xIndexList.push_back(grid->xIndexList.back() + width);
+    }
+    grid->yIndexList.push_back(_bbox.getMinY());
+    for (int height : _computeSubregionLengths(_bbox.getHeight(), ny)) {
+        grid->yIndexList.push_back(grid->yIndexList.back() + height);
+    }
+
+    ndarray::Array<double, 1, 1> x = ndarray::allocate(grid->xIndexList.size());
+    for (std::size_t i = 0; i < grid->xIndexList.size(); ++i) {
+        x[i] = image::indexToPosition(grid->xIndexList[i] + _xy0[0]);
+    }
+    ndarray::Array<double, 1, 1> y = ndarray::allocate(grid->yIndexList.size());
+    for (std::size_t j = 0; j < grid->yIndexList.size(); ++j) {
+        y[j] = image::indexToPosition(grid->yIndexList[j] + _xy0[1]);
+    }
+    grid->kernelParams = _kernelPtr->computeKernelParametersOnGrid(x, y);
+    _kernelParameterGrid = grid;
+}
+
 std::vector<int> KernelImagesForRegion::_computeSubregionLengths(int length, int nDivisions) {
     if ((nDivisions > length) || (nDivisions < 1)) {
         std::ostringstream os;
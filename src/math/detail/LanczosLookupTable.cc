@@ -0,0 +1,87 @@
+// -*- LSST-C++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <map>
+#include <mutex>
+#include <sstream>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/math/FunctionLibrary.h"
+#include "lsst/afw/math/warpExposure.h"
+#include "lsst/afw/math/detail/LanczosLookupTable.h"
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+
+int const LanczosLookupTable::resolution;
+
+std::shared_ptr<LanczosLookupTable const> LanczosLookupTable::get(SeparableKernel const &kernel) {
+    auto const lanczosKernel = dynamic_cast<LanczosWarpingKernel const *>(&kernel);
+    if (!lanczosKernel || kernel.isSpatiallyVarying()) {
+        return nullptr;
+    }
+    // the table assumes the default kernel center, for which the kernel parameters are in [0, 1]
+    int const order = lanczosKernel->getOrder();
+    if (kernel.getCtr() != lsst::geom::Point2I(order - 1, order - 1)) {
+        return nullptr;
+    }
+    return get(order);
+}
+
+std::shared_ptr<LanczosLookupTable const> LanczosLookupTable::get(int order) {
+    if (order < 1) {
+        std::ostringstream os;
+        os << "order = " << order << " < 1";
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, os.str());
+    }
+    static std::mutex mutex;
+    static std::map<int, std::shared_ptr<LanczosLookupTable const>> tableMap;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &table = tableMap[order];
+    if (!table) {
+        table = std::make_shared<LanczosLookupTable>(order);
+    }
+    return table;
+}
+
+LanczosLookupTable::LanczosLookupTable(int order) : _order(order), _table() {
+    // sample the Lanczos function exactly as LanczosWarpingKernel does, at the kernel pixel positions
+    // i - ctr (with the default ctr = order - 1) minus each sampled fractional offset
+    int const size = getSize();
+    int const ctr = order - 1;
+    _table.resize((resolution + 1) * size);
+    for (int row = 0; row <= resolution; ++row) {
+        LanczosFunction1<double> const func(order, static_cast<double>(row) / resolution);
+        for (int i = 0; i < size; ++i) {
+            _table[row * size + i] = func(i - ctr);
+        }
+    }
+}
+
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
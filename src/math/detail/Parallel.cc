@@ -0,0 +1,233 @@
+// -*- LSST-C++ -*-
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <system_error>
+#include <thread>
+
+#include <unistd.h>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/math/ExecutionContext.h"
+#include "lsst/afw/math/detail/Parallel.h"
+
+namespace lsst {
+namespace afw {
+namespace math {
+namespace detail {
+
+namespace {
+
+/*
+ * The threads shared by all parallel calls.
+ *
+ * Threads are started on demand, up to the most that any call has needed, and then wait for work
+ * for the rest of the process.  A task only ever helps with a call whose own thread is also working
+ * on it, so a task that never runs (because all of the threads are busy) delays nothing.
+ */
+class ThreadPool {
+public:
+    ThreadPool() : _pid(getpid()), _nIdle(0), _nThreads(0) {}
+
+    // Queue a task, starting a new thread for it if none is idle and fewer than maxThreads exist
+    void submit(std::function<void()> task, int maxThreads) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.push_back(std::move(task));
+        if (static_cast<int>(_tasks.size()) > _nIdle && _nThreads < maxThreads) {
+            std::thread([this]() { run(); }).detach();
+            ++_nThreads;
+        } else {
+            _available.notify_one();
+        }
+    }
+
+    pid_t getPid() const { return _pid; }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true) {
+            ++_nIdle;
+            _available.wait(lock, [this]() { return !_tasks.empty(); });
+            --_nIdle;
+            std::function<void()> task = std::move(_tasks.front());
+            _tasks.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+    pid_t const _pid;
+    std::mutex _mutex;
+    std::condition_variable _available;
+    std::deque<std::function<void()>> _tasks;
+    int _nIdle;
+    int _nThreads;
+};
+
+/*
+ * Return the pool, creating it if necessary.
+ *
+ * Pools are never destroyed, so that their detached threads can't outlive them.  A child process
+ * created by fork() has none of its parent's threads (and possibly a locked mutex), so it gets a
+ * pool of its own.
+ */
+ThreadPool &getThreadPool() {
+    static std::mutex mutex;
+    static ThreadPool *pool = nullptr;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!pool || pool->getPid() != getpid()) {
+        pool = new ThreadPool;
+    }
+    return *pool;
+}
+
+// The shared state of one call to parallelFor
+class ParallelJob {
+public:
+    ParallelJob(int n, std::function<void(int)> const &func)
+            : _n(n), _func(func), _next(0), _failed(false), _nHelping(0), _closed(false) {}
+
+    // Work on the job from a pool thread, unless the calling thread has already finished it
+    void help() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_closed) {
+                return;
+            }
+            ++_nHelping;
+        }
+        work();
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (--_nHelping == 0) {
+            _done.notify_all();
+        }
+    }
+
+    // Work on the job from the calling thread, then wait for any helpers and rethrow their errors
+    void run() {
+        work();
+        std::unique_lock<std::mutex> lock(_mutex);
+        _closed = true;
+        _done.wait(lock, [this]() { return _nHelping == 0; });
+        if (_firstError) {
+            std::rethrow_exception(_firstError);
+        }
+    }
+
+private:
+    void work() {
+        ExecutionContext serial(1);  // parallel calls made by func run serially
+        for (int i = _next++; i < _n && !_failed; i = _next++) {
+            try {
+                _func(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_firstError) {
+                    _firstError = std::current_exception();
+                }
+                _failed = true;
+            }
+        }
+    }
+
+    int const _n;
+    std::function<void(int)> const &_func;  // only used by help() while run() waits
+    std::atomic<int> _next;
+    std::atomic<bool> _failed;
+    std::exception_ptr _firstError;
+    std::mutex _mutex;
+    std::condition_variable _done;
+    int _nHelping;
+    bool _closed;
+};
+
+}  // namespace
+
+int resolveNumThreads(int nThreads) {
+    if (nThreads < 0) {
+        std::ostringstream os;
+        os << "nThreads = " << nThreads << " < 0";
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, os.str());
+    }
+    int const maxNumThreads = getCurrentMaxNumThreads();
+    return nThreads == 0 ? maxNumThreads : std::min(nThreads, maxNumThreads);
+}
+std::vector<std::pair<int, int>> splitRange(int begin, int end, int nParts, int alignment) {
+    std::vector<std::pair<int, int>> result;
+    if (end <= begin) {
+        return result;
+    }
+    alignment = std::max(alignment, 1);
+    int const nBlocks = (end - begin + alignment - 1) / alignment;
+    nParts = std::max(1, std::min(nParts, nBlocks));
+    result.reserve(nParts);
+    int start = begin;
+    for (int i = 0; i < nParts; ++i) {
+        // distribute the remaining blocks as evenly as possible over the remaining parts
+        int const blocksDone = (start - begin) / alignment;
+        int const nPartBlocks = (nBlocks - blocksDone) / (nParts - i);
+        int const stop = std::min(end, start + nPartBlocks * alignment);
+        result.emplace_back(start, stop);
+        start = stop;
+    }
+    return result;
+}
+
+void parallelFor(int n, int nThreads, std::function<void(int)> const& func) {
+    if (n <= 0) {
+        return;
+    }
+    nThreads = std::min(resolveNumThreads(nThreads), n);
+    if (nThreads == 1) {
+        for (int i = 0; i < n; ++i) {
+            func(i);
+        }
+        return;
+    }
+
+    auto job = std::make_shared<ParallelJob>(n, func);
+    ThreadPool &pool = getThreadPool();
+    try {
+        for (int i = 1; i < nThreads; ++i) {
+            pool.submit([job]() { job->help(); }, getMaxNumThreads() - 1);
+        }
+    } catch (std::system_error const &) {
+        // Couldn't start another thread; the threads we have will do
+    }
+    job->run();
+}
+
+}  // namespace detail
+}  // namespace math
+}  // namespace afw
+}  // namespace lsst
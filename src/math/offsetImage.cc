@@ -26,10 +26,13 @@
  * Offset an Image (or Mask or MaskedImage) by a constant vector (dx, dy)
  */
 #include <iterator>
+#include <map>
+#include <utility>
 #include "lsst/geom.h"
 #include "lsst/afw/math/offsetImage.h"
 #include "lsst/afw/image/ImageUtils.h"
 #include "lsst/afw/math/warpExposure.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace afwImage = lsst::afw::image;
 
@@ -37,12 +40,34 @@ namespace lsst {
 namespace afw {
 namespace math {
 
+namespace {
+
+/*
+ * Return this thread's warping kernel for algorithmName, with its centre reset to the default.
+ *
+ * offsetImage is called many times in a row with small images (e.g. to recentre PSF models), for which
+ * parsing the name and building a new kernel each time costs as much as the convolution itself.
+ * Each thread has its own kernels, as offsetImage sets their centres and parameters.
+ */
+std::shared_ptr<SeparableKernel> getOffsetKernel(std::string const& algorithmName) {
+    thread_local std::map<std::string, std::pair<std::shared_ptr<SeparableKernel>, lsst::geom::Point2I>>
+            kernels;
+    auto iter = kernels.find(algorithmName);
+    if (iter == kernels.end()) {
+        std::shared_ptr<SeparableKernel> kernel = makeWarpingKernel(algorithmName);
+        iter = kernels.emplace(algorithmName, std::make_pair(kernel, kernel->getCtr())).first;
+    }
+    iter->second.first->setCtr(iter->second.second);
+    return iter->second.first;
+}
+
+}  // namespace
+
 template <typename ImageT>
 std::shared_ptr<ImageT> offsetImage(ImageT const& inImage, float dx, float dy,
-                                    std::string const& algorithmName, unsigned int buffer
-
-) {
-    std::shared_ptr<SeparableKernel> offsetKernel = makeWarpingKernel(algorithmName);
+                                    std::string const& algorithmName, unsigned int buffer, int numThreads) {
+    detail::resolveNumThreads(numThreads);  // validate before doing any work
+    std::shared_ptr<SeparableKernel> offsetKernel = getOffsetKernel(algorithmName);
 
     std::shared_ptr<ImageT> buffImage;
     if (buffer > 0) {
@@ -67,7 +92,8 @@ std::shared_ptr<ImageT> offsetImage(ImageT const& inImage, float dx, float dy,
     }
 
     //    std::shared_ptr<ImageT> convImage(new ImageT(buffImage, true)); // output image, a deep copy
-    std::shared_ptr<ImageT> convImage(new ImageT(buffImage->getDimensions()));  // Convolved image
+    // every pixel is set, as the edge is copied
+    std::shared_ptr<ImageT> convImage(new ImageT(buffImage->getDimensions(), afwImage::UNINITIALIZED));
 
     int dOrigX, dOrigY;
     double fracX, fracY;
@@ -105,6 +131,7 @@ std::shared_ptr<ImageT> offsetImage(ImageT const& inImage, float dx, float dy,
     ConvolutionControl convolutionControl;
     convolutionControl.setDoNormalize(true);
     convolutionControl.setDoCopyEdge(true);
+    convolutionControl.setNumThreads(numThreads);
     convolve(*convImage, *buffImage, *offsetKernel, convolutionControl);
 
     std::shared_ptr<ImageT> outImage;
@@ -128,9 +155,9 @@ std::shared_ptr<ImageT> offsetImage(ImageT const& inImage, float dx, float dy,
 /// @cond
 #define INSTANTIATE(TYPE)                                                                                   \
     template std::shared_ptr<afwImage::Image<TYPE>> offsetImage(afwImage::Image<TYPE> const&, float, float, \
-                                                                std::string const&, unsigned int);          \
+                                                                std::string const&, unsigned int, int);     \
     template std::shared_ptr<afwImage::MaskedImage<TYPE>> offsetImage(                                      \
-            afwImage::MaskedImage<TYPE> const&, float, float, std::string const&, unsigned int);
+            afwImage::MaskedImage<TYPE> const&, float, float, std::string const&, unsigned int, int);
 
 INSTANTIATE(double)
 INSTANTIATE(float)
@@ -23,11 +23,13 @@
 /*
  * Rotate an Image (or Mask or MaskedImage) by a fixed angle or number of quarter turns
  */
+#include <algorithm>
 #include <memory>
 #include <cstdint>
 
 #include "lsst/geom.h"
 #include "lsst/afw/math/offsetImage.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace afwImage = lsst::afw::image;
 
@@ -35,95 +37,151 @@ namespace lsst {
 namespace afw {
 namespace math {
 
+namespace {
+
+// Side of the square tiles in which transposes are copied, so that the rows being read and those being
+// written both stay in cache
+int const TILE_SIZE = 32;
+
+/*
+ * How an output plane is made from an input plane.
+ *
+ * Output pixel (x, y) is input pixel (flipX ? W-1-x : x, flipY ? H-1-y : y) or, if `transpose`,
+ * (flipY ? W-1-y : y, flipX ? H-1-x : x), where W and H are the input's width and height.
+ */
+struct Reorientation {
+    bool transpose;
+    bool flipX;
+    bool flipY;
+};
+
+/*
+ * Set rows [yBegin, yEnd) of `out` from `in`
+ *
+ * Rows are copied (or reversed) whole, so the loops run over contiguous memory and vectorize; transposes
+ * are done a tile at a time.
+ */
+template <typename PixelT>
+void reorientRows(ndarray::Array<PixelT const, 2, 1> const& in, ndarray::Array<PixelT, 2, 1> const& out,
+                  Reorientation const& how, int yBegin, int yEnd) {
+    int const inWidth = in.template getSize<1>();
+    int const inHeight = in.template getSize<0>();
+    int const outWidth = out.template getSize<1>();
+    if (!how.transpose) {
+        for (int y = yBegin; y < yEnd; ++y) {
+            PixelT const* src = in[how.flipY ? inHeight - 1 - y : y].getData();
+            PixelT* dst = out[y].getData();
+            if (how.flipX) {
+                std::reverse_copy(src, src + inWidth, dst);
+            } else {
+                std::copy(src, src + inWidth, dst);
+            }
+        }
+        return;
+    }
+    PixelT const* inData = in.getData();
+    std::ptrdiff_t const inStride = in.template getStride<0>();
+    for (int y0 = yBegin; y0 < yEnd; y0 += TILE_SIZE) {
+        int const y1 = std::min(y0 + TILE_SIZE, yEnd);
+        for (int x0 = 0; x0 < outWidth; x0 += TILE_SIZE) {
+            int const x1 = std::min(x0 + TILE_SIZE, outWidth);
+            for (int y = y0; y < y1; ++y) {
+                PixelT const* src = inData + (how.flipY ? inWidth - 1 - y : y);
+                PixelT* dst = out[y].getData();
+                for (int x = x0; x < x1; ++x) {
+                    dst[x] = src[(how.flipX ? inHeight - 1 - x : x) * inStride];
+                }
+            }
+        }
+    }
+}
+
+template <typename PixelT>
+void reorient(afwImage::ImageBase<PixelT> const& in, afwImage::ImageBase<PixelT>& out,
+              Reorientation const& how, int nThreads) {
+    auto const inArray = in.getArray();
+    auto const outArray = out.getArray();
+    // Bands of whole tiles, so threads never share a tile
+    auto const bands = detail::splitRange(0, out.getHeight(), nThreads, TILE_SIZE);
+    int const nBands = bands.size();
+    detail::parallelFor(nBands, nThreads, [&](int i) {
+        reorientRows(inArray, outArray, how, bands[i].first, bands[i].second);
+    });
+}
+
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+void reorient(afwImage::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT> const& in,
+              afwImage::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>& out, Reorientation const& how,
+              int nThreads) {
+    reorient(*in.getImage(), *out.getImage(), how, nThreads);
+    reorient(*in.getMask(), *out.getMask(), how, nThreads);
+    reorient(*in.getVariance(), *out.getVariance(), how, nThreads);
+}
+
+// Return an image with the bounding box and mask planes of `in`, but uninitialized pixels
+template <typename PixelT>
+std::shared_ptr<afwImage::Image<PixelT>> makeUninitializedLike(afwImage::Image<PixelT> const& in) {
+    return std::make_shared<afwImage::Image<PixelT>>(in.getBBox(), afwImage::UNINITIALIZED);
+}
+
+template <typename MaskPixelT>
+std::shared_ptr<afwImage::Mask<MaskPixelT>> makeUninitializedLike(afwImage::Mask<MaskPixelT> const& in) {
+    return std::make_shared<afwImage::Mask<MaskPixelT>>(in.getBBox(), afwImage::UNINITIALIZED,
+                                                         in.getMaskPlaneDict());
+}
+
+template <typename ImagePixelT, typename MaskPixelT, typename VariancePixelT>
+std::shared_ptr<afwImage::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>> makeUninitializedLike(
+        afwImage::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT> const& in) {
+    return std::make_shared<afwImage::MaskedImage<ImagePixelT, MaskPixelT, VariancePixelT>>(
+            in.getBBox(), afwImage::UNINITIALIZED, in.getMask()->getMaskPlaneDict());
+}
+
+}  // namespace
+
 template <typename ImageT>
-std::shared_ptr<ImageT> rotateImageBy90(ImageT const& inImage, int nQuarter) {
-    std::shared_ptr<ImageT> outImage;  // output image
+std::shared_ptr<ImageT> rotateImageBy90(ImageT const& inImage, int nQuarter, int numThreads) {
+    int const nThreads = detail::resolveNumThreads(numThreads);
 
     while (nQuarter < 0) {
         nQuarter += 4;
     }
 
+    if (nQuarter % 4 == 0) {
+        return std::make_shared<ImageT>(inImage, true);  // a deep copy of inImage
+    }
+    std::shared_ptr<ImageT> outImage;  // output image
+    Reorientation how;
     switch (nQuarter % 4) {
-        case 0:
-            outImage.reset(new ImageT(inImage, true));  // a deep copy of inImage
-            break;
         case 1:
-            outImage.reset(new ImageT(lsst::geom::Extent2I(inImage.getHeight(), inImage.getWidth())));
-
-            for (int y = 0; y != inImage.getHeight(); ++y) {
-                typename ImageT::y_iterator optr = outImage->col_begin(inImage.getHeight() - y - 1);
-                for (typename ImageT::x_iterator iptr = inImage.row_begin(y), end = inImage.row_end(y);
-                     iptr != end; ++iptr, ++optr) {
-                    *optr = *iptr;
-                }
-            }
-
+            outImage = std::make_shared<ImageT>(lsst::geom::Extent2I(inImage.getHeight(), inImage.getWidth()),
+                                                afwImage::UNINITIALIZED);
+            how = Reorientation{true, true, false};
             break;
         case 2:
-            outImage.reset(new ImageT(inImage.getDimensions()));
-
-            for (int y = 0; y != inImage.getHeight(); ++y) {
-                typename ImageT::x_iterator optr =
-                        outImage->x_at(inImage.getWidth() - 1, inImage.getHeight() - y - 1);
-                for (typename ImageT::x_iterator iptr = inImage.row_begin(y), end = inImage.row_end(y);
-                     iptr != end; ++iptr, optr -= 1) {
-                    *optr = *iptr;
-                }
-            }
+            outImage = std::make_shared<ImageT>(inImage.getDimensions(), afwImage::UNINITIALIZED);
+            how = Reorientation{false, true, true};
             break;
         case 3:
-            outImage.reset(new ImageT(lsst::geom::Extent2I(inImage.getHeight(), inImage.getWidth())));
-
-            for (int y = 0; y != inImage.getHeight(); ++y) {
-                typename ImageT::y_iterator optr = outImage->y_at(y, inImage.getWidth() - 1);
-                for (typename ImageT::x_iterator iptr = inImage.row_begin(y), end = inImage.row_end(y);
-                     iptr != end; ++iptr, optr -= 1) {
-                    *optr = *iptr;
-                }
-            }
-
+            outImage = std::make_shared<ImageT>(lsst::geom::Extent2I(inImage.getHeight(), inImage.getWidth()),
+                                                afwImage::UNINITIALIZED);
+            how = Reorientation{true, false, true};
             break;
     }
+    reorient(inImage, *outImage, how, nThreads);
 
     return outImage;
 }
 
 template <typename ImageT>
-std::shared_ptr<ImageT> flipImage(ImageT const& inImage, bool flipLR, bool flipTB) {
-    std::shared_ptr<ImageT> outImage(new ImageT(inImage, true));  // Output image
-
-    if (flipLR) {
-        if (flipTB) {
-            for (int y = 0; y != inImage.getHeight(); ++y) {
-                typename ImageT::x_iterator optr =
-                        outImage->x_at(inImage.getWidth() - 1, inImage.getHeight() - y - 1);
-                for (typename ImageT::x_iterator iptr = inImage.row_begin(y), end = inImage.row_end(y);
-                     iptr != end; ++iptr, optr -= 1) {
-                    *optr = *iptr;
-                }
-            }
-        } else {
-            for (int y = 0; y != inImage.getHeight(); ++y) {
-                typename ImageT::x_iterator optr = outImage->x_at(inImage.getWidth() - 1, y);
-                for (typename ImageT::x_iterator iptr = inImage.row_begin(y), end = inImage.row_end(y);
-                     iptr != end; ++iptr, optr -= 1) {
-                    *optr = *iptr;
-                }
-            }
-        }
-    } else {
-        if (flipTB) {
-            for (int y = 0; y != inImage.getHeight(); ++y) {
-                typename ImageT::x_iterator optr = outImage->row_begin(inImage.getHeight() - y - 1);
-                for (typename ImageT::x_iterator iptr = inImage.row_begin(y), end = inImage.row_end(y);
-                     iptr != end; ++iptr, ++optr) {
-                    *optr = *iptr;
-                }
-            }
-        } else {
-            ;  // nothing to do
-        }
+std::shared_ptr<ImageT> flipImage(ImageT const& inImage, bool flipLR, bool flipTB, int numThreads) {
+    int const nThreads = detail::resolveNumThreads(numThreads);
+
+    if (!flipLR && !flipTB) {
+        return std::make_shared<ImageT>(inImage, true);  // nothing to do but copy
     }
+    std::shared_ptr<ImageT> outImage = makeUninitializedLike(inImage);  // Output image
+    reorient(inImage, *outImage, Reorientation{false, flipLR, flipTB}, nThreads);
 
     return outImage;
 }
@@ -133,22 +191,23 @@ std::shared_ptr<ImageT> flipImage(ImageT const& inImage, bool flipLR, bool flipT
 //
 /// @cond
 #define INSTANTIATE(TYPE)                                                                                \
-    template std::shared_ptr<afwImage::Image<TYPE>> rotateImageBy90(afwImage::Image<TYPE> const&, int);  \
+    template std::shared_ptr<afwImage::Image<TYPE>> rotateImageBy90(afwImage::Image<TYPE> const&, int,   \
+                                                                    int);                                \
     template std::shared_ptr<afwImage::MaskedImage<TYPE>> rotateImageBy90(                               \
-            afwImage::MaskedImage<TYPE> const&, int);                                                    \
+            afwImage::MaskedImage<TYPE> const&, int, int);                                               \
     template std::shared_ptr<afwImage::Image<TYPE>> flipImage(afwImage::Image<TYPE> const&, bool flipLR, \
-                                                              bool flipTB);                              \
+                                                              bool flipTB, int);                         \
     template std::shared_ptr<afwImage::MaskedImage<TYPE>> flipImage(afwImage::MaskedImage<TYPE> const&,  \
-                                                                    bool flipLR, bool flipTB);
+                                                                    bool flipLR, bool flipTB, int);
 
 INSTANTIATE(std::uint16_t)
 INSTANTIATE(int)
 INSTANTIATE(float)
 INSTANTIATE(double)
 template std::shared_ptr<afwImage::Mask<afwImage::MaskPixel>> rotateImageBy90(
-        afwImage::Mask<afwImage::MaskPixel> const&, int);
+        afwImage::Mask<afwImage::MaskPixel> const&, int, int);
 template std::shared_ptr<afwImage::Mask<afwImage::MaskPixel>> flipImage(
-        afwImage::Mask<afwImage::MaskPixel> const&, bool flipLR, bool flipTB);
+        afwImage::Mask<afwImage::MaskPixel> const&, bool flipLR, bool flipTB, int);
 /// @endcond
 }  // namespace math
 }  // namespace afw
@@ -25,10 +25,15 @@
  * Support for warping an %image to a new Wcs.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <limits>
+#include <functional>
+#include <future>
 #include <memory>
+#include <numeric>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -42,8 +47,11 @@
 #include "lsst/geom.h"
 #include "lsst/afw/math/warpExposure.h"
 #include "lsst/afw/geom.h"
+#include "lsst/afw/math/ExecutionContext.h"
+#include "lsst/afw/math/Instrumentation.h"
 #include "lsst/afw/math/Kernel.h"
 #include "lsst/afw/image/PhotoCalib.h"
+#include "lsst/afw/math/detail/Parallel.h"
 #include "lsst/afw/math/detail/WarpAtOnePoint.h"
 #include "lsst/afw/table/io/InputArchive.h"
 #include "lsst/afw/table/io/OutputArchive.h"
@@ -435,6 +443,592 @@ inline double computeRelativeArea(
     return std::abs(dSrcA.getX() * dSrcB.getY() - dSrcA.getY() * dSrcB.getX());
 }
 
+/**
+ * @internal Warp a box of a destination image using linear interpolation of source positions
+ *
+ * destImage is the box, whose pixel (0, 0) is at destOffset in the local pixel coordinates expected by
+ * localDestToParentSrc.  Its position should be a multiple of interpLength, so that its interpolation
+ * bands are the same as when warping the whole image in one go.
+ *
+ * @returns the number of good (non-edge) pixels set
+ */
+template <typename DestImageT, typename WarpAtOnePointT>
+int warpRowsWithInterpolation(DestImageT &destImage, lsst::geom::Extent2D const &destOffset, int interpLength,
+                              geom::TransformPoint2ToPoint2 const &localDestToParentSrc,
+                              WarpAtOnePointT &warpAtOnePoint) {
+    int numGoodPixels = 0;
+    int const destWidth = destImage.getWidth();
+    int const maxCol = destWidth - 1;
+    int const beginRow = 0;
+    int const maxRow = destImage.getHeight() - 1;
+
+    // Estimate for number of horizontal interpolation band edges, to reserve memory in vectors
+    int const numColEdges = 2 + ((destWidth - 1) / interpLength);
+
+    // A list of edge column indices for interpolation bands;
+    // starts at -1, increments by interpLen (except the final interval), and ends at destWidth-1
+    std::vector<int> edgeColList;
+    edgeColList.reserve(numColEdges);
+
+    // A list of 1/column width for horizontal interpolation bands; the first value is garbage.
+    // The inverse is used for speed because the values are always multiplied.
+    std::vector<double> invWidthList;
+    invWidthList.reserve(numColEdges);
+
+    // Compute edgeColList and invWidthList
+    edgeColList.push_back(-1);
+    invWidthList.push_back(0.0);
+    for (int prevEndCol = -1; prevEndCol < maxCol; prevEndCol += interpLength) {
+        int endCol = prevEndCol + interpLength;
+        if (endCol > maxCol) {
+            endCol = maxCol;
+        }
+        edgeColList.push_back(endCol);
+        assert(endCol - prevEndCol > 0);
+        invWidthList.push_back(1.0 / static_cast<double>(endCol - prevEndCol));
+    }
+    assert(edgeColList.back() == maxCol);
+
+    // A list of delta source positions along the edge columns of the horizontal interpolation bands
+    std::vector<lsst::geom::Extent2D> yDeltaSrcPosList(edgeColList.size());
+
+    // A cache of pixel positions on the source corresponding to the previous or current row
+    // of the destination image.
+    // The first value is for column -1 because the previous source position is used to compute relative
+    // area To simplify the indexing, use an iterator that starts at begin+1, thus: srcPosView =
+    // srcPosList.begin() + 1 srcPosView[col-1] and lower indices are for this row srcPosView[col] and
+    // higher indices are for the previous row
+    std::vector<lsst::geom::Point2D> srcPosList(1 + destWidth);
+    std::vector<lsst::geom::Point2D>::iterator const srcPosView = srcPosList.begin() + 1;
+
+    std::vector<lsst::geom::Point2D> endColPosList;
+    endColPosList.reserve(numColEdges);
+
+    // Initialize srcPosList for row beginRow - 1
+    for (int endCol : edgeColList) {
+        endColPosList.emplace_back(lsst::geom::Point2D(endCol, beginRow - 1) + destOffset);
+    }
+    auto rightSrcPosList = localDestToParentSrc.applyForward(endColPosList);
+    srcPosView[-1] = rightSrcPosList[0];
+    for (int colBand = 1, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
+        int const prevEndCol = edgeColList[colBand - 1];
+        int const endCol = edgeColList[colBand];
+        lsst::geom::Point2D leftSrcPos = srcPosView[prevEndCol];
+
+        lsst::geom::Extent2D xDeltaSrcPos = (rightSrcPosList[colBand] - leftSrcPos) * invWidthList[colBand];
+
+        for (int col = prevEndCol + 1; col <= endCol; ++col) {
+            srcPosView[col] = srcPosView[col - 1] + xDeltaSrcPos;
+        }
+    }
+
+    int bandEndRow = beginRow - 1;
+    while (bandEndRow < maxRow) {
+        // Next horizontal interpolation band
+
+        int prevEndRow = bandEndRow;
+        bandEndRow = prevEndRow + interpLength;
+        if (bandEndRow > maxRow) {
+            bandEndRow = maxRow;
+        }
+        assert(bandEndRow - prevEndRow > 0);
+        double interpInvHeight = 1.0 / static_cast<double>(bandEndRow - prevEndRow);
+
+        // Set yDeltaSrcPosList for this horizontal interpolation band
+        std::vector<lsst::geom::Point2D> destRowPosList;
+        destRowPosList.reserve(edgeColList.size());
+        for (int endCol : edgeColList) {
+            destRowPosList.emplace_back(lsst::geom::Point2D(endCol, bandEndRow) + destOffset);
+        }
+        auto bottomSrcPosList = localDestToParentSrc.applyForward(destRowPosList);
+        for (int colBand = 0, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
+            int endCol = edgeColList[colBand];
+            yDeltaSrcPosList[colBand] = (bottomSrcPosList[colBand] - srcPosView[endCol]) * interpInvHeight;
+        }
+
+        for (int row = prevEndRow + 1; row <= bandEndRow; ++row) {
+            typename DestImageT::x_iterator destXIter = destImage.row_begin(row);
+            srcPosView[-1] += yDeltaSrcPosList[0];
+            for (int colBand = 1, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
+                // Next vertical interpolation band
+
+                int const prevEndCol = edgeColList[colBand - 1];
+                int const endCol = edgeColList[colBand];
+
+                // Compute xDeltaSrcPos; remember that srcPosView contains
+                // positions for this row in prevEndCol and smaller indices,
+                // and positions for the previous row for larger indices (including endCol)
+                lsst::geom::Point2D leftSrcPos = srcPosView[prevEndCol];
+                lsst::geom::Point2D rightSrcPos = srcPosView[endCol] + yDeltaSrcPosList[colBand];
+                lsst::geom::Extent2D xDeltaSrcPos = (rightSrcPos - leftSrcPos) * invWidthList[colBand];
+
+                for (int col = prevEndCol + 1; col <= endCol; ++col, ++destXIter) {
+                    lsst::geom::Point2D leftSrcPos = srcPosView[col - 1];
+                    lsst::geom::Point2D srcPos = leftSrcPos + xDeltaSrcPos;
+                    double relativeArea = computeRelativeArea(srcPos, leftSrcPos, srcPosView[col]);
+
+                    srcPosView[col] = srcPos;
+
+                    if (warpAtOnePoint(destXIter, srcPos, relativeArea,
+                                       typename image::detail::image_traits<DestImageT>::image_category())) {
+                        ++numGoodPixels;
+                    }
+                }  // for col
+            }      // for col band
+        }          // for row
+    }              // while next row band
+    return numGoodPixels;
+}
+
+/**
+ * @internal Warp a box of a destination image, transforming the position of every pixel
+ *
+ * destImage is the box, whose pixel (0, 0) is at destOffset in the local pixel coordinates expected by
+ * localDestToParentSrc.
+ *
+ * @returns the number of good (non-edge) pixels set
+ */
+template <typename DestImageT, typename WarpAtOnePointT>
+int warpRowsWithoutInterpolation(DestImageT &destImage, lsst::geom::Extent2D const &destOffset,
+                                 geom::TransformPoint2ToPoint2 const &localDestToParentSrc,
+                                 WarpAtOnePointT &warpAtOnePoint) {
+    int numGoodPixels = 0;
+    int const destWidth = destImage.getWidth();
+    int const destHeight = destImage.getHeight();
+
+    // prevSrcPosList = source positions from the previous row; these are used to compute pixel area;
+    // to begin, compute sources positions corresponding to destination row = -1
+    std::vector<lsst::geom::Point2D> destPosList;
+    destPosList.reserve(1 + destWidth);
+    for (int col = -1; col < destWidth; ++col) {
+        destPosList.emplace_back(lsst::geom::Point2D(col, -1) + destOffset);
+    }
+    auto prevSrcPosList = localDestToParentSrc.applyForward(destPosList);
+
+    for (int row = 0; row < destHeight; ++row) {
+        destPosList.clear();
+        for (int col = -1; col < destWidth; ++col) {
+            destPosList.emplace_back(lsst::geom::Point2D(col, row) + destOffset);
+        }
+        auto srcPosList = localDestToParentSrc.applyForward(destPosList);
+
+        typename DestImageT::x_iterator destXIter = destImage.row_begin(row);
+        for (int col = 0; col < destWidth; ++col, ++destXIter) {
+            // column index = column + 1 because the first entry in srcPosList is for column -1
+            auto srcPos = srcPosList[col + 1];
+            double relativeArea = computeRelativeArea(srcPos, prevSrcPosList[col], prevSrcPosList[col + 1]);
+
+            if (warpAtOnePoint(destXIter, srcPos, relativeArea,
+                               typename image::detail::image_traits<DestImageT>::image_category())) {
+                ++numGoodPixels;
+            }
+        }  // for col
+        // move points from srcPosList to prevSrcPosList (we don't care about what ends up in srcPosList
+        // because it will be reallocated anyway)
+        swap(srcPosList, prevSrcPosList);
+    }  // for row
+    return numGoodPixels;
+}
+
+/**
+ * @internal Source positions at destination pixel nodes, computed by adaptive interpolation
+ *
+ * Destination nodes are (col, row) for col in [-1, destWidth - 1], and are at (col, row) + destOffset
+ * in the local pixel coordinates expected by the transform; positions are computed for one
+ * horizontal strip of node rows at a time. The strip is covered by tiles at most maxTileSize nodes
+ * wide and exactly as tall as the strip. Each tile is recursively split into quarters (or halves,
+ * once it is too narrow or short to split along one axis) until bilinear interpolation between
+ * the source positions of its corners agrees with the transform to within maxInterpError source
+ * pixels at the midpoints of its edges and at its center. The positions of all other nodes
+ * of each final tile are then bilinearly interpolated. Transform evaluations are batched
+ * one subdivision level at a time, because each call to the transform has a large overhead.
+ */
+class AdaptiveSrcPosGrid {
+public:
+    AdaptiveSrcPosGrid(int destWidth, int maxTileSize, double maxInterpError,
+                       lsst::geom::Extent2D const &destOffset,
+                       geom::TransformPoint2ToPoint2 const &localDestToParentSrc)
+            : _numCols(destWidth + 1),
+              _maxTileSize(maxTileSize),
+              _maxInterpError(maxInterpError),
+              _destOffset(destOffset),
+              _localDestToParentSrc(localDestToParentSrc),
+              _posList(_numCols * (maxTileSize + 1)),
+              _stateList(_posList.size(), UNKNOWN),
+              _topRow(0),
+              _numRows(0),
+              _numEvaluations(0) {}
+
+    /**
+     * Compute source positions for node rows [topRow, bottomRow]
+     *
+     * If topRow is the bottom row of the previous call, the positions of that row are reused.
+     */
+    void compute(int topRow, int bottomRow) {
+        assert(bottomRow > topRow && bottomRow - topRow <= _maxTileSize);
+        if (_numRows > 0 && topRow == _topRow + _numRows - 1) {
+            std::size_t const lastRowStart = (_numRows - 1) * _numCols;
+            std::copy(_posList.begin() + lastRowStart, _posList.begin() + lastRowStart + _numCols,
+                      _posList.begin());
+            std::copy(_stateList.begin() + lastRowStart, _stateList.begin() + lastRowStart + _numCols,
+                      _stateList.begin());
+            std::fill(_stateList.begin() + _numCols, _stateList.end(), UNKNOWN);
+        } else {
+            std::fill(_stateList.begin(), _stateList.end(), UNKNOWN);
+        }
+        _topRow = topRow;
+        _numRows = 1 + bottomRow - topRow;
+
+        int const maxCol = _numCols - 2;
+        std::vector<Tile> tileList;
+        for (int x0 = -1; x0 < maxCol; x0 += _maxTileSize) {
+            tileList.push_back({x0, topRow, std::min(x0 + _maxTileSize, maxCol), bottomRow});
+        }
+        for (Tile const &tile : tileList) {
+            _queueNode(tile.x0, tile.y0);
+            _queueNode(tile.x1, tile.y0);
+            _queueNode(tile.x0, tile.y1);
+            _queueNode(tile.x1, tile.y1);
+        }
+        _evaluateQueue();
+
+        std::vector<Tile> leafList;
+        std::vector<Tile> nextTileList;
+        while (!tileList.empty()) {
+            for (Tile const &tile : tileList) {
+                _forEachTestNode(tile, [this](int col, int row) { _queueNode(col, row); });
+            }
+            _evaluateQueue();
+
+            nextTileList.clear();
+            for (Tile const &tile : tileList) {
+                if (_isAccurate(tile)) {
+                    leafList.push_back(tile);
+                } else {
+                    _split(tile, nextTileList);
+                }
+            }
+            swap(tileList, nextTileList);
+        }
+
+        for (Tile const &tile : leafList) {
+            for (int row = tile.y0; row <= tile.y1; ++row) {
+                for (int col = tile.x0; col <= tile.x1; ++col) {
+                    std::size_t const ind = _index(col, row);
+                    if (_stateList[ind] == UNKNOWN) {
+                        _posList[ind] = _interpolate(tile, col, row);
+                        _stateList[ind] = INTERPOLATED;
+                    }
+                }
+            }
+        }
+    }
+
+    /// Get the source position of a node in the current strip
+    lsst::geom::Point2D const &operator()(int col, int row) const { return _posList[_index(col, row)]; }
+
+    /// Get the total number of transform evaluations
+    std::size_t getNumEvaluations() const { return _numEvaluations; }
+
+private:
+    enum NodeState : unsigned char { UNKNOWN, QUEUED, EXACT, INTERPOLATED };
+
+    struct Tile {
+        int x0, y0, x1, y1;  // node indices of corners, inclusive
+    };
+
+    std::size_t _index(int col, int row) const {
+        return static_cast<std::size_t>(row - _topRow) * _numCols + (col + 1);
+    }
+
+    void _queueNode(int col, int row) {
+        std::size_t const ind = _index(col, row);
+        if (_stateList[ind] == UNKNOWN) {
+            _stateList[ind] = QUEUED;
+            _queueIndexList.push_back(ind);
+            _queueDestPosList.push_back(lsst::geom::Point2D(col, row) + _destOffset);
+        }
+    }
+
+    void _evaluateQueue() {
+        if (_queueIndexList.empty()) {
+            return;
+        }
+        auto const srcPosList = _localDestToParentSrc.applyForward(_queueDestPosList);
+        for (std::size_t i = 0; i < _queueIndexList.size(); ++i) {
+            _posList[_queueIndexList[i]] = srcPosList[i];
+            _stateList[_queueIndexList[i]] = EXACT;
+        }
+        _numEvaluations += _queueIndexList.size();
+        _queueIndexList.clear();
+        _queueDestPosList.clear();
+    }
+
+    /// Call func(col, row) for each node at which interpolation over a tile is tested
+    template <typename FuncT>
+    static void _forEachTestNode(Tile const &tile, FuncT func) {
+        bool const splitX = tile.x1 - tile.x0 >= 2;
+        bool const splitY = tile.y1 - tile.y0 >= 2;
+        int const midX = (tile.x0 + tile.x1) / 2;
+        int const midY = (tile.y0 + tile.y1) / 2;
+        if (splitX) {
+            func(midX, tile.y0);
+            func(midX, tile.y1);
+        }
+        if (splitY) {
+            func(tile.x0, midY);
+            func(tile.x1, midY);
+        }
+        if (splitX && splitY) {
+            func(midX, midY);
+        }
+    }
+
+    /// Is bilinear interpolation over this tile accurate enough (or impossible to improve upon)?
+    bool _isAccurate(Tile const &tile) const {
+        bool isAccurate = true;
+        _forEachTestNode(tile, [&](int col, int row) {
+            std::size_t const ind = _index(col, row);
+            // positions reused from the previous strip are not exact, but were already tested there
+            if (_stateList[ind] == EXACT) {
+                lsst::geom::Extent2D const err = _interpolate(tile, col, row) - _posList[ind];
+                if (err.computeSquaredNorm() > _maxInterpError * _maxInterpError) {
+                    isAccurate = false;
+                }
+            }
+        });
+        return isAccurate;
+    }
+
+    /// Append the sub-tiles of a tile to tileList
+    static void _split(Tile const &tile, std::vector<Tile> &tileList) {
+        int const midX = (tile.x0 + tile.x1) / 2;
+        int const midY = (tile.y0 + tile.y1) / 2;
+        std::vector<int> xList = {tile.x0, tile.x1};
+        std::vector<int> yList = {tile.y0, tile.y1};
+        if (tile.x1 - tile.x0 >= 2) {
+            xList.insert(xList.begin() + 1, midX);
+        }
+        if (tile.y1 - tile.y0 >= 2) {
+            yList.insert(yList.begin() + 1, midY);
+        }
+        for (std::size_t j = 1; j < yList.size(); ++j) {
+            for (std::size_t i = 1; i < xList.size(); ++i) {
+                tileList.push_back({xList[i - 1], yList[j - 1], xList[i], yList[j]});
+            }
+        }
+    }
+
+    lsst::geom::Point2D _interpolate(Tile const &tile, int col, int row) const {
+        double const fx = static_cast<double>(col - tile.x0) / static_cast<double>(tile.x1 - tile.x0);
+        double const fy = static_cast<double>(row - tile.y0) / static_cast<double>(tile.y1 - tile.y0);
+        lsst::geom::Point2D const &p00 = (*this)(tile.x0, tile.y0);
+        lsst::geom::Point2D const &p10 = (*this)(tile.x1, tile.y0);
+        lsst::geom::Point2D const &p01 = (*this)(tile.x0, tile.y1);
+        lsst::geom::Point2D const &p11 = (*this)(tile.x1, tile.y1);
+        double const w00 = (1.0 - fx) * (1.0 - fy);
+        double const w10 = fx * (1.0 - fy);
+        double const w01 = (1.0 - fx) * fy;
+        double const w11 = fx * fy;
+        return lsst::geom::Point2D(w00 * p00.getX() + w10 * p10.getX() + w01 * p01.getX() + w11 * p11.getX(),
+                                   w00 * p00.getY() + w10 * p10.getY() + w01 * p01.getY() + w11 * p11.getY());
+    }
+
+    int const _numCols;
+    int const _maxTileSize;
+    double const _maxInterpError;
+    lsst::geom::Extent2D const _destOffset;  // position of node (0, 0) for _localDestToParentSrc
+    geom::TransformPoint2ToPoint2 const &_localDestToParentSrc;
+    std::vector<lsst::geom::Point2D> _posList;
+    std::vector<NodeState> _stateList;
+    int _topRow;
+    int _numRows;
+    std::size_t _numEvaluations;
+    std::vector<std::size_t> _queueIndexList;
+    std::vector<lsst::geom::Point2D> _queueDestPosList;
+};
+
+/**
+ * @internal Warp a box of a destination image using adaptive interpolation of source positions
+ *
+ * destImage is the box, whose pixel (0, 0) is at destOffset in the local pixel coordinates expected by
+ * localDestToParentSrc.  Rows are processed in strips of maxTileSize rows; see AdaptiveSrcPosGrid.
+ *
+ * @returns the number of good (non-edge) pixels set
+ */
+template <typename DestImageT, typename WarpAtOnePointT>
+int warpRowsWithAdaptiveInterpolation(DestImageT &destImage, lsst::geom::Extent2D const &destOffset,
+                                      int maxTileSize, double maxInterpError,
+                                      geom::TransformPoint2ToPoint2 const &localDestToParentSrc,
+                                      WarpAtOnePointT &warpAtOnePoint, std::size_t &numTransformEvaluations) {
+    int numGoodPixels = 0;
+    int const destWidth = destImage.getWidth();
+    int const maxRow = destImage.getHeight() - 1;
+    AdaptiveSrcPosGrid srcPosGrid(destWidth, maxTileSize, maxInterpError, destOffset, localDestToParentSrc);
+    for (int topRow = -1; topRow < maxRow; topRow += maxTileSize) {
+        int const bottomRow = std::min(topRow + maxTileSize, maxRow);
+        srcPosGrid.compute(topRow, bottomRow);
+        for (int row = topRow + 1; row <= bottomRow; ++row) {
+            typename DestImageT::x_iterator destXIter = destImage.row_begin(row);
+            for (int col = 0; col < destWidth; ++col, ++destXIter) {
+                lsst::geom::Point2D const &srcPos = srcPosGrid(col, row);
+                double relativeArea =
+                        computeRelativeArea(srcPos, srcPosGrid(col - 1, row), srcPosGrid(col, row - 1));
+
+                if (warpAtOnePoint(destXIter, srcPos, relativeArea,
+                                   typename image::detail::image_traits<DestImageT>::image_category())) {
+                    ++numGoodPixels;
+                }
+            }  // for col
+        }      // for row
+    }          // for strip
+    numTransformEvaluations += srcPosGrid.getNumEvaluations();
+    return numGoodPixels;
+}
+
+/// @internal Number of source pixels by which the source box is grown before its outline is projected
+int const COVERAGE_SRC_MARGIN = 8;
+
+/// @internal Number of destination pixels by which the projected outline of the source is grown
+int const COVERAGE_DEST_MARGIN = 2;
+
+/// @internal Approximate height, in rows, of the strips of the destination image that coverage is found for
+int const COVERAGE_STRIP_HEIGHT = 64;
+
+/**
+ * @internal Return the boxes of a destination image that may receive data from a source image
+ *
+ * The outline of the source bounding box, grown by COVERAGE_SRC_MARGIN pixels (much more than any error
+ * of interpolating source positions) and sampled at every source pixel, is projected into the destination.
+ * For each strip of about COVERAGE_STRIP_HEIGHT rows of the destination, the columns that the projected
+ * outline crosses (grown by COVERAGE_DEST_MARGIN pixels) bound the part of the strip that can possibly map
+ * onto the source; since the outline is closed, any covered pixel of the strip lies between two crossings.
+ * The edges of each box are multiples of alignment (or edges of the destination image), so that the
+ * boxes have the same interpolation bands as the whole image.
+ *
+ * If the outline cannot be projected (no forward transform, or non-finite positions), every strip of the
+ * destination image is returned whole.
+ *
+ * @param[in] srcBBox    Bounding box of the source image, in parent coordinates.
+ * @param[in] destBBox   Bounding box of the destination image, in parent coordinates.
+ * @param[in] srcToDest  Transform from parent source to parent destination pixel coordinates.
+ * @param[in] alignment  Multiple of which the edges of the boxes must be.
+ * @returns boxes in the local coordinates of the destination image, in order of increasing y.
+ */
+std::vector<lsst::geom::Box2I> computeDestCoverage(lsst::geom::Box2I const &srcBBox,
+                                                   lsst::geom::Box2I const &destBBox,
+                                                   geom::TransformPoint2ToPoint2 const &srcToDest,
+                                                   int alignment) {
+    int const destWidth = destBBox.getWidth();
+    int const destHeight = destBBox.getHeight();
+    int const stripHeight = alignment * ((COVERAGE_STRIP_HEIGHT + alignment - 1) / alignment);
+
+    // the closed outline of the grown source box, in local destination coordinates
+    std::vector<lsst::geom::Point2D> outline;
+    bool isKnown = srcToDest.hasForward();
+    if (isKnown) {
+        lsst::geom::Box2D srcBox(srcBBox);
+        srcBox.grow(COVERAGE_SRC_MARGIN);
+        lsst::geom::Point2D const corners[] = {
+                srcBox.getMin(), lsst::geom::Point2D(srcBox.getMaxX(), srcBox.getMinY()), srcBox.getMax(),
+                lsst::geom::Point2D(srcBox.getMinX(), srcBox.getMaxY())};
+        std::vector<lsst::geom::Point2D> srcOutline;
+        for (int i = 0; i < 4; ++i) {
+            lsst::geom::Point2D const &begin = corners[i];
+            lsst::geom::Point2D const &end = corners[(i + 1) % 4];
+            int const numSteps = std::max(1, static_cast<int>(std::ceil((end - begin).computeNorm())));
+            for (int j = 0; j < numSteps; ++j) {
+                srcOutline.push_back(begin + (end - begin) * (static_cast<double>(j) / numSteps));
+            }
+        }
+        srcOutline.push_back(corners[0]);
+        outline = srcToDest.applyForward(srcOutline);
+        lsst::geom::Extent2D const destXY0(destBBox.getMin());
+        for (auto &point : outline) {
+            point -= destXY0;
+            isKnown = isKnown && std::isfinite(point.getX()) && std::isfinite(point.getY());
+        }
+    }
+
+    std::vector<lsst::geom::Box2I> boxList;
+    for (int beginRow = 0; beginRow < destHeight; beginRow += stripHeight) {
+        int const endRow = std::min(beginRow + stripHeight, destHeight);
+        int beginCol = 0;
+        int endCol = destWidth;
+        if (isKnown) {
+            // the range of x of the parts of the outline within the (grown) strip
+            double const yMin = beginRow - 0.5 - COVERAGE_DEST_MARGIN;
+            double const yMax = endRow - 0.5 + COVERAGE_DEST_MARGIN;
+            double xMin = std::numeric_limits<double>::infinity();
+            double xMax = -xMin;
+            for (std::size_t i = 1; i < outline.size(); ++i) {
+                lsst::geom::Point2D const &a = outline[i - 1];
+                lsst::geom::Point2D const &b = outline[i];
+                if (std::max(a.getY(), b.getY()) < yMin || std::min(a.getY(), b.getY()) > yMax) {
+                    continue;
+                }
+                double t0 = 0.0;
+                double t1 = 1.0;
+                if (a.getY() != b.getY()) {
+                    double const tMin = (yMin - a.getY()) / (b.getY() - a.getY());
+                    double const tMax = (yMax - a.getY()) / (b.getY() - a.getY());
+                    t0 = std::max(0.0, std::min(tMin, tMax));
+                    t1 = std::min(1.0, std::max(tMin, tMax));
+                }
+                double const x0 = a.getX() + t0 * (b.getX() - a.getX());
+                double const x1 = a.getX() + t1 * (b.getX() - a.getX());
+                xMin = std::min(xMin, std::min(x0, x1));
+                xMax = std::max(xMax, std::max(x0, x1));
+            }
+            double const minCol = std::max(0.0, std::floor(xMin) - COVERAGE_DEST_MARGIN);
+            double const maxCol = std::min(destWidth - 1.0, std::ceil(xMax) + COVERAGE_DEST_MARGIN);
+            if (!(minCol <= maxCol)) {
+                continue;  // nothing in this strip can map onto the source
+            }
+            beginCol = static_cast<int>(minCol) / alignment * alignment;
+            endCol = std::min(destWidth, (static_cast<int>(maxCol) + alignment) / alignment * alignment);
+        }
+        boxList.emplace_back(lsst::geom::Point2I(beginCol, beginRow),
+                             lsst::geom::Extent2I(endCol - beginCol, endRow - beginRow));
+    }
+    return boxList;
+}
+
+/**
+ * @internal Split a list of boxes into at most numGroups contiguous groups of about equal area
+ *
+ * @returns [begin, end) indices into boxList of each group
+ */
+std::vector<std::pair<int, int>> groupBoxesByArea(std::vector<lsst::geom::Box2I> const &boxList,
+                                                  int numGroups) {
+    std::size_t totalArea = 0;
+    for (auto const &box : boxList) {
+        totalArea += box.getArea();
+    }
+    std::vector<std::pair<int, int>> groupList;
+    std::size_t area = 0;
+    int begin = 0;
+    for (int i = 0, n = boxList.size(); i < n; ++i) {
+        area += boxList[i].getArea();
+        if (area * numGroups >= totalArea * (groupList.size() + 1) || i + 1 == n) {
+            groupList.emplace_back(begin, i + 1);
+            begin = i + 1;
+        }
+    }
+    return groupList;
+}
+
+/// @internal Set every pixel of an image to a value
+template <typename ImageT>
+void fillImage(ImageT &image, typename ImageT::SinglePixel const &value) {
+    for (int y = 0, height = image.getHeight(); y < height; ++y) {
+        for (typename ImageT::x_iterator ptr = image.row_begin(y), end = image.row_end(y); ptr != end;
+             ++ptr) {
+            *ptr = value;
+        }
+    }
+}
+
 }  // namespace
 
 template <typename DestImageT, typename SrcImageT>
@@ -445,10 +1039,20 @@ int warpImage(DestImageT &destImage, geom::SkyWcs const &destWcs, SrcImageT cons
     return warpImage(destImage, srcImage, *srcToDest, control, padValue);
 }
 
+namespace {
+
+/**
+ * @internal Warp an image, as warpImage
+ *
+ * @param[in,out] blockControlList  per-thread copies of control (and so of its warping kernels),
+ *                                  extended as needed; may be reused for later calls with the same control
+ */
 template <typename DestImageT, typename SrcImageT>
-int warpImage(DestImageT &destImage, SrcImageT const &srcImage,
-              geom::TransformPoint2ToPoint2 const &srcToDest, WarpingControl const &control,
-              typename DestImageT::SinglePixel padValue) {
+int warpImageWithBlockControls(DestImageT &destImage, SrcImageT const &srcImage,
+                               geom::TransformPoint2ToPoint2 const &srcToDest, WarpingControl const &control,
+                               typename DestImageT::SinglePixel padValue,
+                               std::vector<std::unique_ptr<WarpingControl>> &blockControlList) {
+    LSST_AFW_INSTRUMENT_SCOPE("math.warpImage");
     if (imagesOverlap(destImage, srcImage)) {
         throw LSST_EXCEPT(pexExcept::InvalidParameterError, "destImage overlaps srcImage; cannot warp");
     }
@@ -460,20 +1064,11 @@ int warpImage(DestImageT &destImage, SrcImageT const &srcImage,
     try {
         warpingKernelPtr->shrinkBBox(srcImage.getBBox(image::LOCAL));
     } catch (lsst::pex::exceptions::InvalidParameterError const &) {
-        for (int y = 0, height = destImage.getHeight(); y < height; ++y) {
-            for (typename DestImageT::x_iterator destPtr = destImage.row_begin(y), end = destImage.row_end(y);
-                 destPtr != end; ++destPtr) {
-                *destPtr = padValue;
-            }
-        }
+        fillImage(destImage, padValue);
         return 0;
     }
     int interpLength = control.getInterpLength();
-
-    std::shared_ptr<LanczosWarpingKernel const> const lanczosKernelPtr =
-            std::dynamic_pointer_cast<LanczosWarpingKernel>(warpingKernelPtr);
-
-    int numGoodPixels = 0;
+    int const numThreads = detail::resolveNumThreads(control.getNumThreads());
 
     // compute a transform from local destination pixels to parent source pixels
     auto const parentDestToParentSrc = srcToDest.inverted();
@@ -494,172 +1089,169 @@ int warpImage(DestImageT &destImage, SrcImageT const &srcImage,
     // Set each pixel of destExposure's MaskedImage
     LOGL_DEBUG("TRACE3.lsst.afw.math.warp", "Remapping masked image");
 
-    int const maxCol = destWidth - 1;
-    int const maxRow = destHeight - 1;
-
-    detail::WarpAtOnePoint<DestImageT, SrcImageT> warpAtOnePoint(srcImage, control, padValue);
-
-    if (interpLength > 0) {
-        // Use interpolation. Note that 1 produces the same result as no interpolation
-        // but uses this code branch, thus providing an easy way to compare the two branches.
-
-        // Estimate for number of horizontal interpolation band edges, to reserve memory in vectors
-        int const numColEdges = 2 + ((destWidth - 1) / interpLength);
-
-        // A list of edge column indices for interpolation bands;
-        // starts at -1, increments by interpLen (except the final interval), and ends at destWidth-1
-        std::vector<int> edgeColList;
-        edgeColList.reserve(numColEdges);
-
-        // A list of 1/column width for horizontal interpolation bands; the first value is garbage.
-        // The inverse is used for speed because the values are always multiplied.
-        std::vector<double> invWidthList;
-        invWidthList.reserve(numColEdges);
-
-        // Compute edgeColList and invWidthList
-        edgeColList.push_back(-1);
-        invWidthList.push_back(0.0);
-        for (int prevEndCol = -1; prevEndCol < maxCol; prevEndCol += interpLength) {
-            int endCol = prevEndCol + interpLength;
-            if (endCol > maxCol) {
-                endCol = maxCol;
-            }
-            edgeColList.push_back(endCol);
-            assert(endCol - prevEndCol > 0);
-            invWidthList.push_back(1.0 / static_cast<double>(endCol - prevEndCol));
-        }
-        assert(edgeColList.back() == maxCol);
-
-        // A list of delta source positions along the edge columns of the horizontal interpolation bands
-        std::vector<lsst::geom::Extent2D> yDeltaSrcPosList(edgeColList.size());
-
-        // A cache of pixel positions on the source corresponding to the previous or current row
-        // of the destination image.
-        // The first value is for column -1 because the previous source position is used to compute relative
-        // area To simplify the indexing, use an iterator that starts at begin+1, thus: srcPosView =
-        // srcPosList.begin() + 1 srcPosView[col-1] and lower indices are for this row srcPosView[col] and
-        // higher indices are for the previous row
-        std::vector<lsst::geom::Point2D> srcPosList(1 + destWidth);
-        std::vector<lsst::geom::Point2D>::iterator const srcPosView = srcPosList.begin() + 1;
-
-        std::vector<lsst::geom::Point2D> endColPosList;
-        endColPosList.reserve(numColEdges);
+    // Only the boxes of the destination image that the source can reach are warped; the rest is padding.
+    // The boxes start on interpolation band edges, so each uses the same bands as a warp of the whole image.
+    auto const boxList = computeDestCoverage(srcImage.getBBox(), destImage.getBBox(), srcToDest,
+                                             std::max(interpLength, 1));
+    fillImage(destImage, padValue);
+    std::size_t coveredArea = 0;
+    for (auto const &box : boxList) {
+        coveredArea += box.getArea();
+    }
+    LOGL_DEBUG("TRACE3.lsst.afw.math.warp", "warping %zu of %zu destination pixels", coveredArea,
+               static_cast<std::size_t>(destImage.getBBox().getArea()));
+    if (boxList.empty()) {
+        return 0;
+    }
+    // sub-images share the reference counts of destImage's pixels, so are made before any threads start
+    std::vector<DestImageT> subImageList;
+    subImageList.reserve(boxList.size());
+    for (auto const &box : boxList) {
+        subImageList.emplace_back(destImage, box, image::LOCAL);
+    }
 
-        // Initialize srcPosList for row -1
-        for (int endCol : edgeColList) {
-            endColPosList.emplace_back(lsst::geom::Point2D(endCol, -1));
+    // Warp one box of the destination image, adding the number of transform evaluations
+    // made by adaptive interpolation (only) to numTransformEvaluations.
+    // Note that an interpLength of 1 produces the same result as no interpolation
+    // but uses the interpolation code branch, thus providing an easy way to compare the two branches.
+    double const maxInterpError = control.getMaxInterpError();
+    bool const useAdaptiveInterp = interpLength > 0 && maxInterpError > 0;
+    auto warpBox = [&](int boxIndex, geom::TransformPoint2ToPoint2 const &transform,
+                       detail::WarpAtOnePoint<DestImageT, SrcImageT> &warpAtOnePoint,
+                       std::size_t &numTransformEvaluations) {
+        DestImageT &subImage = subImageList[boxIndex];
+        lsst::geom::Extent2D const offset(boxList[boxIndex].getMin());
+        if (useAdaptiveInterp) {
+            return warpRowsWithAdaptiveInterpolation(subImage, offset, interpLength, maxInterpError,
+                                                     transform, warpAtOnePoint, numTransformEvaluations);
+        } else if (interpLength > 0) {
+            return warpRowsWithInterpolation(subImage, offset, interpLength, transform, warpAtOnePoint);
+        } else {
+            return warpRowsWithoutInterpolation(subImage, offset, transform, warpAtOnePoint);
         }
-        auto rightSrcPosList = localDestToParentSrc->applyForward(endColPosList);
-        srcPosView[-1] = rightSrcPosList[0];
-        for (int colBand = 1, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
-            int const prevEndCol = edgeColList[colBand - 1];
-            int const endCol = edgeColList[colBand];
-            lsst::geom::Point2D leftSrcPos = srcPosView[prevEndCol];
-
-            lsst::geom::Extent2D xDeltaSrcPos =
-                    (rightSrcPosList[colBand] - leftSrcPos) * invWidthList[colBand];
-
-            for (int col = prevEndCol + 1; col <= endCol; ++col) {
-                srcPosView[col] = srcPosView[col - 1] + xDeltaSrcPos;
+    };
+
+    // Each thread warps a contiguous group of boxes.  The boxes do not depend on the number of threads,
+    // so neither does the result.
+    auto const groupList = groupBoxesByArea(boxList, numThreads);
+    std::vector<int> numGoodPixelsList(groupList.size(), 0);
+    std::vector<std::size_t> numTransformEvaluationsList(groupList.size(), 0);
+    auto warpGroup = [&](int groupIndex, geom::TransformPoint2ToPoint2 const &transform,
+                         detail::WarpAtOnePoint<DestImageT, SrcImageT> &warpAtOnePoint) {
+        for (int i = groupList[groupIndex].first; i < groupList[groupIndex].second; ++i) {
+            numGoodPixelsList[groupIndex] +=
+                    warpBox(i, transform, warpAtOnePoint, numTransformEvaluationsList[groupIndex]);
+        }
+    };
+    if (groupList.size() <= 1) {
+        detail::WarpAtOnePoint<DestImageT, SrcImageT> warpAtOnePoint(srcImage, control, padValue);
+        warpGroup(0, *localDestToParentSrc, warpAtOnePoint);
+    } else {
+        // Warping kernels are stateful (WarpAtOnePoint sets their parameters for each pixel),
+        // so each group gets its own copies, as well as its own copy of the AST mapping.
+        // The kernel copies (which look up the shared kernel caches on first use) are kept in
+        // blockControlList for later calls.
+        blockControlList.reserve(groupList.size());
+        while (blockControlList.size() < groupList.size()) {
+            std::unique_ptr<WarpingControl> blockControl(new WarpingControl(control));
+            blockControl->setWarpingKernel(*warpingKernelPtr);
+            if (control.hasMaskWarpingKernel()) {
+                blockControl->setMaskWarpingKernel(*control.getMaskWarpingKernel());
             }
+            blockControlList.push_back(std::move(blockControl));
         }
+        std::vector<std::unique_ptr<geom::TransformPoint2ToPoint2>> blockTransformList;
+        blockTransformList.reserve(groupList.size());
+        for (std::size_t i = 0; i < groupList.size(); ++i) {
+            blockTransformList.emplace_back(
+                    new geom::TransformPoint2ToPoint2(*localDestToParentSrc->getMapping(), false));
+        }
+        detail::parallelFor(groupList.size(), numThreads, [&](int groupIndex) {
+            detail::WarpAtOnePoint<DestImageT, SrcImageT> warpAtOnePoint(
+                    srcImage, *blockControlList[groupIndex], padValue);
+            warpGroup(groupIndex, *blockTransformList[groupIndex], warpAtOnePoint);
+        });
+    }
 
-        int endRow = -1;
-        while (endRow < maxRow) {
-            // Next horizontal interpolation band
-
-            int prevEndRow = endRow;
-            endRow = prevEndRow + interpLength;
-            if (endRow > maxRow) {
-                endRow = maxRow;
-            }
-            assert(endRow - prevEndRow > 0);
-            double interpInvHeight = 1.0 / static_cast<double>(endRow - prevEndRow);
-
-            // Set yDeltaSrcPosList for this horizontal interpolation band
-            std::vector<lsst::geom::Point2D> destRowPosList;
-            destRowPosList.reserve(edgeColList.size());
-            for (int endCol : edgeColList) {
-                destRowPosList.emplace_back(lsst::geom::Point2D(endCol, endRow));
-            }
-            auto bottomSrcPosList = localDestToParentSrc->applyForward(destRowPosList);
-            for (int colBand = 0, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
-                int endCol = edgeColList[colBand];
-                yDeltaSrcPosList[colBand] =
-                        (bottomSrcPosList[colBand] - srcPosView[endCol]) * interpInvHeight;
-            }
+    if (useAdaptiveInterp) {
+        // without interpolation the transform is evaluated at every warped pixel, plus one extra row
+        // and column per box (to compute the relative area of its first row and column)
+        std::size_t const numTransformEvaluations = std::accumulate(
+                numTransformEvaluationsList.begin(), numTransformEvaluationsList.end(), std::size_t(0));
+        std::size_t numUninterpolatedEvaluations = 0;
+        for (auto const &box : boxList) {
+            numUninterpolatedEvaluations +=
+                    static_cast<std::size_t>(box.getWidth() + 1) * (box.getHeight() + 1);
+        }
+        LOGL_DEBUG("lsst.afw.math.warp",
+                   "adaptive interpolation with maxInterpError=%g: %zu transform evaluations; "
+                   "%zu saved compared to no interpolation",
+                   maxInterpError, numTransformEvaluations,
+                   numUninterpolatedEvaluations - std::min(numUninterpolatedEvaluations,
+                                                           numTransformEvaluations));
+    }
+    return std::accumulate(numGoodPixelsList.begin(), numGoodPixelsList.end(), 0);
+}
 
-            for (int row = prevEndRow + 1; row <= endRow; ++row) {
-                typename DestImageT::x_iterator destXIter = destImage.row_begin(row);
-                srcPosView[-1] += yDeltaSrcPosList[0];
-                for (int colBand = 1, endBand = edgeColList.size(); colBand < endBand; ++colBand) {
-                    // Next vertical interpolation band
-
-                    int const prevEndCol = edgeColList[colBand - 1];
-                    int const endCol = edgeColList[colBand];
-
-                    // Compute xDeltaSrcPos; remember that srcPosView contains
-                    // positions for this row in prevEndCol and smaller indices,
-                    // and positions for the previous row for larger indices (including endCol)
-                    lsst::geom::Point2D leftSrcPos = srcPosView[prevEndCol];
-                    lsst::geom::Point2D rightSrcPos = srcPosView[endCol] + yDeltaSrcPosList[colBand];
-                    lsst::geom::Extent2D xDeltaSrcPos = (rightSrcPos - leftSrcPos) * invWidthList[colBand];
-
-                    for (int col = prevEndCol + 1; col <= endCol; ++col, ++destXIter) {
-                        lsst::geom::Point2D leftSrcPos = srcPosView[col - 1];
-                        lsst::geom::Point2D srcPos = leftSrcPos + xDeltaSrcPos;
-                        double relativeArea = computeRelativeArea(srcPos, leftSrcPos, srcPosView[col]);
-
-                        srcPosView[col] = srcPos;
-
-                        if (warpAtOnePoint(
-                                    destXIter, srcPos, relativeArea,
-                                    typename image::detail::image_traits<DestImageT>::image_category())) {
-                            ++numGoodPixels;
-                        }
-                    }  // for col
-                }      // for col band
-            }          // for row
-        }              // while next row band
+}  // namespace
 
-    } else {
-        // No interpolation
+template <typename DestImageT, typename SrcImageT>
+int warpImage(DestImageT &destImage, SrcImageT const &srcImage,
+              geom::TransformPoint2ToPoint2 const &srcToDest, WarpingControl const &control,
+              typename DestImageT::SinglePixel padValue) {
+    std::vector<std::unique_ptr<WarpingControl>> blockControlList;
+    return warpImageWithBlockControls(destImage, srcImage, srcToDest, control, padValue, blockControlList);
+}
 
-        // prevSrcPosList = source positions from the previous row; these are used to compute pixel area;
-        // to begin, compute sources positions corresponding to destination row = -1
-        std::vector<lsst::geom::Point2D> destPosList;
-        destPosList.reserve(1 + destWidth);
-        for (int col = -1; col < destWidth; ++col) {
-            destPosList.emplace_back(lsst::geom::Point2D(col, -1));
+template <typename DestExposureT, typename SrcExposureT>
+void warpExposures(std::vector<std::shared_ptr<SrcExposureT const>> const &srcExposures,
+                   lsst::geom::Box2I const &destBBox, std::shared_ptr<geom::SkyWcs const> const &destWcs,
+                   WarpingControl const &control,
+                   std::function<void(std::size_t, DestExposureT const &, int)> const &callback,
+                   typename DestExposureT::MaskedImageT::SinglePixel padValue) {
+    if (!destWcs) {
+        throw LSST_EXCEPT(pexExcept::InvalidParameterError, "destWcs is null");
+    }
+    for (std::size_t i = 0; i < srcExposures.size(); ++i) {
+        if (!srcExposures[i] || !srcExposures[i]->hasWcs()) {
+            std::ostringstream os;
+            os << "srcExposures[" << i << "] is null or has no Wcs";
+            throw LSST_EXCEPT(pexExcept::InvalidParameterError, os.str());
         }
-        auto prevSrcPosList = localDestToParentSrc->applyForward(destPosList);
-
-        for (int row = 0; row < destHeight; ++row) {
-            destPosList.clear();
-            for (int col = -1; col < destWidth; ++col) {
-                destPosList.emplace_back(lsst::geom::Point2D(col, row));
-            }
-            auto srcPosList = localDestToParentSrc->applyForward(destPosList);
-
-            typename DestImageT::x_iterator destXIter = destImage.row_begin(row);
-            for (int col = 0; col < destWidth; ++col, ++destXIter) {
-                // column index = column + 1 because the first entry in srcPosList is for column -1
-                auto srcPos = srcPosList[col + 1];
-                double relativeArea =
-                        computeRelativeArea(srcPos, prevSrcPosList[col], prevSrcPosList[col + 1]);
+    }
+    if (srcExposures.empty()) {
+        return;
+    }
 
-                if (warpAtOnePoint(destXIter, srcPos, relativeArea,
-                                   typename image::detail::image_traits<DestImageT>::image_category())) {
-                    ++numGoodPixels;
-                }
-            }  // for col
-            // move points from srcPosList to prevSrcPosList (we don't care about what ends up in srcPosList
-            // because it will be reallocated anyway)
-            swap(srcPosList, prevSrcPosList);
-        }  // for row
-    }      // if interp
+    auto makeSrcToDest = [&destWcs](SrcExposureT const &srcExposure) {
+        return geom::makeWcsPairTransform(*srcExposure.getWcs(), *destWcs);
+    };
+
+    typename DestExposureT::MaskedImageT destMaskedImage(destBBox);
+    std::vector<std::unique_ptr<WarpingControl>> blockControlList;
+    std::future<std::shared_ptr<geom::TransformPoint2ToPoint2>> nextSrcToDest =
+            std::async(std::launch::deferred, makeSrcToDest, std::cref(*srcExposures[0]));
+    for (std::size_t i = 0; i < srcExposures.size(); ++i) {
+        SrcExposureT const &srcExposure = *srcExposures[i];
+        auto const srcToDest = nextSrcToDest.get();
+        if (i + 1 < srcExposures.size()) {
+            // the next transform is prepared in the background unless this thread must stay serial
+            auto const policy = getCurrentMaxNumThreads() > 1 ? std::launch::async : std::launch::deferred;
+            nextSrcToDest = std::async(policy, makeSrcToDest, std::cref(*srcExposures[i + 1]));
+        }
 
-    return numGoodPixels;
+        // a new exposure for each source, so no metadata is carried over from the previous one
+        DestExposureT destExposure(destMaskedImage, destWcs);
+        if (srcExposure.getInfo()->hasId()) {
+            destExposure.getInfo()->setId(srcExposure.getInfo()->getId());
+        }
+        destExposure.setPhotoCalib(srcExposure.getPhotoCalib());
+        destExposure.setFilter(srcExposure.getFilter());
+        destExposure.getInfo()->setVisitInfo(srcExposure.getInfo()->getVisitInfo());
+        int const numGoodPixels = warpImageWithBlockControls(destMaskedImage, srcExposure.getMaskedImage(),
+                                                             *srcToDest, control, padValue, blockControlList);
+        callback(i, destExposure, numGoodPixels);
+    }
 }
 
 template <typename DestImageT, typename SrcImageT>
@@ -742,7 +1334,13 @@ int warpCenteredImage(DestImageT &destImage, SrcImageT const &srcImage,
                               MASKEDIMAGE(DESTIMAGEPIXELT)::SinglePixel padValue);                           \
     NL template int warpExposure(EXPOSURE(DESTIMAGEPIXELT) & destExposure,                                   \
                                  EXPOSURE(SRCIMAGEPIXELT) const &srcExposure, WarpingControl const &control, \
-                                 EXPOSURE(DESTIMAGEPIXELT)::MaskedImageT::SinglePixel padValue);
+                                 EXPOSURE(DESTIMAGEPIXELT)::MaskedImageT::SinglePixel padValue);         \
+    NL template void warpExposures(                                                                          \
+            std::vector<std::shared_ptr<EXPOSURE(SRCIMAGEPIXELT) const>> const &srcExposures,                \
+            lsst::geom::Box2I const &destBBox, std::shared_ptr<geom::SkyWcs const> const &destWcs,           \
+            WarpingControl const &control,                                                                   \
+            std::function<void(std::size_t, EXPOSURE(DESTIMAGEPIXELT) const &, int)> const &callback,        \
+            EXPOSURE(DESTIMAGEPIXELT)::MaskedImageT::SinglePixel padValue);
 
 INSTANTIATE(double, double)
 INSTANTIATE(double, float)
@@ -23,6 +23,7 @@
 
 #include <algorithm>
 #include <string>
+#include <utility>
 
 #include "lsst/cpputils/hashCombine.h"
 
@@ -64,6 +65,57 @@ void AliasMap::_apply(std::string& name) const {
                       (boost::format("Cycle detected in schema aliases involving name '%s'") % name).str());
 }
 
+namespace {
+
+// Largest number of names whose de-aliased form AliasMap remembers
+std::size_t const MAX_CACHE_SIZE = 4096;
+
+}  // namespace
+
+AliasMap& AliasMap::operator=(AliasMap const& other) {
+    if (&other != this) {
+        _internal = other._internal;
+        _table = other._table;
+        _clearCache();
+    }
+    return *this;
+}
+
+AliasMap& AliasMap::operator=(AliasMap&& other) {
+    if (&other != this) {
+        _internal = std::move(other._internal);
+        _table = std::move(other._table);
+        _clearCache();
+        other._clearCache();
+    }
+    return *this;
+}
+
+void AliasMap::_clearCache() {
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    _cache.clear();
+}
+
+std::string const* AliasMap::_applyCached(std::string const& name, std::string& buffer) const {
+    if (_internal.empty()) {
+        return &name;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_cacheMutex);
+        auto i = _cache.find(name);
+        if (i != _cache.end()) {
+            return &i->second;
+        }
+    }
+    buffer = name;
+    _apply(buffer);
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    if (_cache.size() >= MAX_CACHE_SIZE) {
+        return &buffer;
+    }
+    return &_cache.emplace(name, buffer).first->second;
+}
+
 std::string AliasMap::apply(std::string const& name) const {
     std::string result(name);
     _apply(result);
@@ -81,6 +133,7 @@ std::string AliasMap::get(std::string const& name) const {
 
 void AliasMap::set(std::string const& alias, std::string const& target) {
     _internal[alias] = target;
+    _clearCache();
     auto table = _table.lock();
     if (table) {
         table->handleAliasChange(alias);
@@ -89,6 +142,7 @@ void AliasMap::set(std::string const& alias, std::string const& target) {
 
 bool AliasMap::erase(std::string const& alias) {
     bool result = _internal.erase(alias);
+    _clearCache();
     auto table = _table.lock();
     if (table) {
         table->handleAliasChange(alias);
@@ -28,6 +28,13 @@ struct MatchName {
     std::string const &target;
 };
 
+// Return whether the bits of a row satisfy a selection; bitwise operators on the conditions keep the
+// loops over rows free of branches, so they can be vectorized.
+inline bool isSelected(BitsColumn::SizeT bits, BitsColumn::SizeT allOf, BitsColumn::SizeT anyOf,
+                       BitsColumn::SizeT noneOf) {
+    return ((bits & allOf) == allOf) & (((bits & anyOf) != 0) | (anyOf == 0)) & ((bits & noneOf) == 0);
+}
+
 }  // namespace
 
 BitsColumn::SizeT BitsColumn::getBit(Key<Flag> const &key) const {
@@ -48,6 +55,54 @@ BitsColumn::SizeT BitsColumn::getBit(std::string const &name) const {
     return r;
 }
 
+BitsColumn::SizeT BitsColumn::getMask(std::vector<std::string> const &names) const {
+    SizeT r = 0;
+    for (auto const &name : names) {
+        r |= getMask(name);
+    }
+    return r;
+}
+
+void BitsColumn::_checkMasks(SizeT allOf, SizeT anyOf, SizeT noneOf) const {
+    SizeT const nBits = _items.size();
+    SizeT const valid = (nBits >= sizeof(SizeT) * 8) ? ~SizeT(0) : (SizeT(1) << nBits) - 1;
+    if (((allOf | anyOf | noneOf) & ~valid) != 0) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          (boost::format("Selection masks (%#x, %#x, %#x) have bits beyond the %d in "
+                                         "BitsColumn") %
+                           allOf % anyOf % noneOf % nBits)
+                                  .str());
+    }
+}
+
+ndarray::Array<bool, 1, 1> BitsColumn::select(SizeT allOf, SizeT anyOf, SizeT noneOf) const {
+    _checkMasks(allOf, anyOf, noneOf);
+    std::size_t const n = _array.getSize<0>();
+    ndarray::Array<bool, 1, 1> result = ndarray::allocate(n);
+    SizeT const *bits = _array.getData();
+    bool *out = result.getData();
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = isSelected(bits[i], allOf, anyOf, noneOf);
+    }
+    return result;
+}
+
+ndarray::Array<BitsColumn::SizeT, 1, 1> BitsColumn::selectIndices(SizeT allOf, SizeT anyOf,
+                                                                  SizeT noneOf) const {
+    _checkMasks(allOf, anyOf, noneOf);
+    std::size_t const n = _array.getSize<0>();
+    ndarray::Array<SizeT, 1, 1> buffer = ndarray::allocate(n);
+    SizeT const *bits = _array.getData();
+    SizeT *out = buffer.getData();
+    // Write every index, but only advance past the selected ones.
+    std::size_t nSelected = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        out[nSelected] = i;
+        nSelected += isSelected(bits[i], allOf, anyOf, noneOf);
+    }
+    return ndarray::copy(buffer[ndarray::view(0, nSelected)]);
+}
+
 BitsColumn::BitsColumn(std::size_t size) : _array(ndarray::allocate(size)) { _array.deep() = SizeT(0); }
 
 // =============== BaseColumnView private Impl object =======================================================
@@ -127,10 +182,10 @@ ndarray::Array<double, 1> const BaseColumnView::get_radians_array(Key<Angle> con
 BitsColumn BaseColumnView::getBits(std::vector<Key<Flag> > const &keys) const {
     BitsColumn result(_impl->recordCount);
     ndarray::ArrayRef<BitsColumn::SizeT, 1, 1> array = result._array.deep();
-    if (keys.size() > sizeof(BitsColumn::SizeT)) {
+    if (keys.size() > sizeof(BitsColumn::SizeT) * 8) {
         throw LSST_EXCEPT(pex::exceptions::LengthError,
                           (boost::format("Too many keys passed to getBits(); %d > %d.") % keys.size() %
-                           sizeof(BitsColumn::SizeT))
+                           (sizeof(BitsColumn::SizeT) * 8))
                                   .str());
     }
     BitsColumn::SizeT const size = keys.size();  // just for unsigned/signed comparisons
@@ -158,10 +213,10 @@ BitsColumn BaseColumnView::getAllBits() const {
     BitsColumn result(_impl->recordCount);
     ExtractFlagItems func = {&result._items};
     getSchema().forEach(func);
-    if (result._items.size() > sizeof(BitsColumn::SizeT)) {
+    if (result._items.size() > sizeof(BitsColumn::SizeT) * 8) {
         throw LSST_EXCEPT(pex::exceptions::LengthError,
                           (boost::format("Too many Flag keys in schema; %d > %d.") % result._items.size() %
-                           sizeof(BitsColumn::SizeT))
+                           (sizeof(BitsColumn::SizeT) * 8))
                                   .str());
     }
     ndarray::ArrayRef<BitsColumn::SizeT, 1, 1> array = result._array.deep();
@@ -145,8 +145,10 @@ BaseRecord::BaseRecord(ConstructionToken const &, detail::RecordData && data) :
     _table(std::move(data.table)),
     _manager(std::move(data.manager))
 {
-    RecordInitializer f = {reinterpret_cast<char *>(_data)};
-    _table->getSchema().forEach(f);
+    if (!data.filled) {
+        RecordInitializer f = {reinterpret_cast<char *>(_data)};
+        _table->getSchema().forEach(f);
+    }
 }
 
 void BaseRecord::_stream(std::ostream& os) const {
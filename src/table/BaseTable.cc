@@ -1,5 +1,6 @@
 // -*- lsst-c++ -*-
 
+#include <cstdint>
 #include <memory>
 
 #include "boost/shared_ptr.hpp"  // only for ndarray
@@ -10,6 +11,7 @@
 #include "lsst/afw/table/SchemaMapper.h"
 #include "lsst/afw/table/io/FitsWriter.h"
 #include "lsst/afw/table/detail/Access.h"
+#include "lsst/afw/math/Instrumentation.h"
 
 namespace lsst {
 namespace afw {
@@ -39,9 +41,11 @@ public:
     // If the last chunk allocated isn't needed after all (usually because of an exception in a constructor)
     // we reuse it immediately.  If it wasn't the last chunk allocated, it can't be reclaimed until
     // the entire block goes out of scope.
+    // Chunks of an adopted block are never reclaimed, as they would no longer hold the values their
+    // new records are expected to start with.
     static void reclaim(std::size_t recordSize, void *data, ndarray::Manager::Ptr const &manager) {
         Ptr block = boost::static_pointer_cast<Block>(manager);
-        if (reinterpret_cast<char *>(data) + recordSize == block->_next) {
+        if (!block->_owner && reinterpret_cast<char *>(data) + recordSize == block->_next) {
             block->_next -= recordSize;
         }
     }
@@ -56,6 +60,23 @@ public:
         }
     }
 
+    // Install a block that doles out the chunks of existing memory, which already hold record values
+    // and are kept alive by owner.
+    static void adopt(void *data, std::size_t recordSize, std::size_t recordCount,
+                      ndarray::Manager::Ptr const &owner, ndarray::Manager::Ptr &manager) {
+        manager = Ptr(new Block(reinterpret_cast<char *>(data), recordSize * recordCount, owner));
+    }
+
+    // Return true if the chunks of the block already hold record values (see adopt).
+    static bool isFilled(ndarray::Manager::Ptr const &manager) {
+        return static_cast<bool>(boost::static_pointer_cast<Block>(manager)->_owner);
+    }
+
+    // Return true if memory is aligned as well as the memory of blocks we allocate.
+    static bool isAligned(void const *data) {
+        return reinterpret_cast<std::uintptr_t>(data) % alignof(AllocType) == 0;
+    }
+
     static std::size_t getBufferSize(std::size_t recordSize, ndarray::Manager::Ptr const &manager) {
         Ptr block = boost::static_pointer_cast<Block>(manager);
         return static_cast<std::size_t>(block->_end - block->_next) / recordSize;
@@ -92,23 +113,88 @@ private:
 
     explicit Block(std::size_t recordSize, std::size_t recordCount)
             : _mem(new AllocType[(recordSize * recordCount) / sizeof(AllocType)]),
+              _charge(getMemoryCounter(), recordSize * recordCount),
               _next(reinterpret_cast<char *>(_mem.get())),
               _end(_next + recordSize * recordCount) {
         assert((recordSize * recordCount) % sizeof(AllocType) == 0);
         std::fill(_next, _end, 0);  // initialize to zero; we'll later initialize floats to NaN.
     }
 
+    Block(char *data, std::size_t size, ndarray::Manager::Ptr const &owner)
+            : _mem(), _owner(owner), _next(data), _end(data + size) {}
+
+    static math::MemoryCounter &getMemoryCounter() {
+        static math::MemoryCounter &counter = math::getMemoryCounter("table.Block");
+        return counter;
+    }
+
     std::unique_ptr<AllocType[]> _mem;
+    math::MemoryCharge _charge;  // charge for _mem; adopted memory is charged by its owner
+    ndarray::Manager::Ptr _owner;  // keeps adopted memory alive; null if we allocated _mem
     char *_next;
     char *_end;
 };
 
+// A Schema functor that records whether any field is variable-length.
+struct VariableLengthFinder {
+    template <typename T>
+    void operator()(SchemaItem<T> const &item) const {}
+
+    template <typename T>
+    void operator()(SchemaItem<Array<T> > const &item) const {
+        *found = *found || item.key.isVariableLength();
+    }
+
+    void operator()(SchemaItem<std::string> const &item) const {
+        *found = *found || item.key.isVariableLength();
+    }
+
+    bool *found;
+};
+
+}  // namespace
+
+// =============== ThreadLocalBlock ==========================================================================
+
+namespace {
+
+// The innermost ThreadLocalBlock on this thread; each one links to the one it replaced.
+thread_local BaseTable::ThreadLocalBlock *currentThreadLocalBlock = nullptr;
+
 }  // namespace
 
+BaseTable::ThreadLocalBlock::ThreadLocalBlock(BaseTable &table, std::size_t nRecords)
+        : _table(&table), _previous(currentThreadLocalBlock) {
+    Block::preallocate(table._schema.getRecordSize(), nRecords, _manager);
+    currentThreadLocalBlock = this;
+}
+
+BaseTable::ThreadLocalBlock::~ThreadLocalBlock() noexcept { currentThreadLocalBlock = _previous; }
+
+BaseTable::ThreadLocalBlock *BaseTable::ThreadLocalBlock::find(BaseTable const *table) noexcept {
+    for (ThreadLocalBlock *block = currentThreadLocalBlock; block; block = block->_previous) {
+        if (block->_table == table) return block;
+    }
+    return nullptr;
+}
+
 // =============== BaseTable implementation (see header for docs) ===========================================
 
 void BaseTable::preallocate(std::size_t n) { Block::preallocate(_schema.getRecordSize(), n, _manager); }
 
+void BaseTable::adoptRecordData(void *data, std::size_t nRecords, ndarray::Manager::Ptr const &manager) {
+    if (!Block::isAligned(data)) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, "Record data is not suitably aligned");
+    }
+    bool variableLength = false;
+    _schema.forEach(VariableLengthFinder{&variableLength});
+    if (variableLength) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "Records with variable-length fields cannot adopt existing data");
+    }
+    Block::adopt(data, _schema.getRecordSize(), nRecords, manager, _manager);
+}
+
 std::size_t BaseTable::getBufferSize() const {
     if (_manager) {
         return Block::getBufferSize(_schema.getRecordSize(), _manager);
@@ -194,18 +280,25 @@ struct RecordDestroyer {
 }  // namespace
 
 detail::RecordData BaseTable::_makeNewRecordData() {
+    if (ThreadLocalBlock *local = ThreadLocalBlock::find(this)) {
+        auto data = Block::get(_schema.getRecordSize(), local->_manager);
+        return detail::RecordData{data, shared_from_this(), local->_manager,
+                                  Block::isFilled(local->_manager)};
+    }
     auto data = Block::get(_schema.getRecordSize(), _manager);
     return detail::RecordData{
             data, shared_from_this(),
-            _manager  // manager always points to the most recently-used block.
-    };
+            _manager,  // manager always points to the most recently-used block.
+            Block::isFilled(_manager)};
 }
 
 void BaseTable::_destroy(BaseRecord &record) {
     assert(record._table.get() == this);
     RecordDestroyer f = {reinterpret_cast<char *>(record._data)};
     _schema.forEach(f);
-    if (record._manager == _manager) Block::reclaim(_schema.getRecordSize(), record._data, _manager);
+    ThreadLocalBlock *local = ThreadLocalBlock::find(this);
+    ndarray::Manager::Ptr &manager = local ? local->_manager : _manager;
+    if (record._manager == manager) Block::reclaim(_schema.getRecordSize(), record._data, manager);
 }
 
 /*
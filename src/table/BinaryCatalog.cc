@@ -0,0 +1,271 @@
+// -*- lsst-c++ -*-
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "boost/format.hpp"
+
+#include "ndarray.h"
+#include "lsst/geom/Angle.h"
+#include "lsst/afw/table/Schema.h"
+#include "lsst/afw/table/io/Persistable.h"
+#include "lsst/afw/table/detail/BinaryCatalog.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+namespace detail {
+
+namespace {
+
+// Field types whose FieldBase carries a size.
+template <typename T>
+struct IsSized : std::false_type {};
+
+template <>
+struct IsSized<std::string> : std::true_type {};
+
+template <typename U>
+struct IsSized<Array<U>> : std::true_type {};
+
+// Unsigned integer with the same size as T, used to serialize T's bytes in a fixed order.
+template <typename T>
+using BitsOf = std::conditional_t<
+        sizeof(T) == 1, std::uint8_t,
+        std::conditional_t<sizeof(T) == 2, std::uint16_t,
+                           std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>>;
+
+class Writer {
+public:
+    explicit Writer(std::vector<std::uint8_t> &buffer) : _buffer(buffer) {}
+
+    // Numbers are written little-endian, whatever the byte order of the host.
+    template <typename T>
+    std::enable_if_t<std::is_arithmetic_v<T>> put(T value) const {
+        static_assert(sizeof(T) <= 8, "Unsupported scalar size");
+        BitsOf<T> bits;
+        std::memcpy(&bits, &value, sizeof(T));
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            _buffer.push_back(static_cast<std::uint8_t>(bits >> (8 * i)));
+        }
+    }
+
+    void put(bool value) const { put(static_cast<std::uint8_t>(value)); }
+
+    void put(lsst::geom::Angle const &value) const { put(value.asRadians()); }
+
+    void put(std::string const &value) const {
+        put(static_cast<std::uint64_t>(value.size()));
+        _buffer.insert(_buffer.end(), value.begin(), value.end());
+    }
+
+    template <typename T, int N, int C>
+    void put(ndarray::Array<T, N, C> const &value) const {
+        put(static_cast<std::uint64_t>(value.getNumElements()));
+        for (auto const &element : value) {
+            put(element);
+        }
+    }
+
+private:
+    std::vector<std::uint8_t> &_buffer;
+};
+
+class Reader {
+public:
+    Reader(std::uint8_t const *&data, std::uint8_t const *end) : _data(data), _end(end) {}
+
+    template <typename T>
+    std::enable_if_t<std::is_arithmetic_v<T>, T> get() const {
+        require(sizeof(T));
+        BitsOf<T> bits = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            bits |= static_cast<BitsOf<T>>(static_cast<BitsOf<T>>(_data[i]) << (8 * i));
+        }
+        _data += sizeof(T);
+        T value;
+        std::memcpy(&value, &bits, sizeof(T));
+        return value;
+    }
+
+    std::string getString() const {
+        std::uint64_t const size = get<std::uint64_t>();
+        require(size);
+        std::string value(reinterpret_cast<char const *>(_data), size);
+        _data += size;
+        return value;
+    }
+
+    std::uint64_t getCount(std::size_t elementSize) const {
+        std::uint64_t const count = get<std::uint64_t>();
+        // Check before allocating, so a corrupt count can't ask for an absurd amount of memory.
+        if (elementSize > 0 && count > static_cast<std::uint64_t>(_end - _data) / elementSize) {
+            fail();
+        }
+        return count;
+    }
+
+private:
+    void require(std::uint64_t nBytes) const {
+        if (nBytes > static_cast<std::uint64_t>(_end - _data)) {
+            fail();
+        }
+    }
+
+    [[noreturn]] void fail() const {
+        throw LSST_EXCEPT(io::MalformedArchiveError, "Binary archive data ends unexpectedly");
+    }
+
+    std::uint8_t const *&_data;
+    std::uint8_t const *_end;
+};
+
+struct FieldWriter {
+    template <typename T>
+    void operator()(SchemaItem<T> const &item) const {
+        writer.put(FieldBase<T>::getTypeString());
+        writer.put(item.field.getName());
+        writer.put(item.field.getDoc());
+        writer.put(item.field.getUnits());
+        if constexpr (IsSized<T>::value) {
+            writer.put(static_cast<std::uint64_t>(item.field.getSize()));
+        } else {
+            writer.put(std::uint64_t(0));
+        }
+    }
+
+    Writer const &writer;
+};
+
+struct ValueWriter {
+    template <typename T>
+    void operator()(SchemaItem<T> const &item) const {
+        writer.put(record->get(item.key));
+    }
+
+    Writer const &writer;
+    BaseRecord const *record;
+};
+
+struct ValueReader {
+    template <typename T>
+    void operator()(SchemaItem<T> const &item) const {
+        read(item.key);
+    }
+
+    template <typename T>
+    void read(Key<T> const &key) const {
+        record->set(key, reader.get<T>());
+    }
+
+    void read(Key<lsst::geom::Angle> const &key) const {
+        record->set(key, reader.get<double>() * lsst::geom::radians);
+    }
+
+    void read(Key<Flag> const &key) const { record->set(key, reader.get<std::uint8_t>() != 0); }
+
+    void read(Key<std::string> const &key) const { record->set(key, reader.getString()); }
+
+    template <typename U>
+    void read(Key<Array<U>> const &key) const {
+        ndarray::Array<U, 1, 1> value = ndarray::allocate(reader.getCount(sizeof(U)));
+        for (auto &element : value) {
+            element = reader.get<U>();
+        }
+        record->set(key, value);
+    }
+
+    Reader const &reader;
+    BaseRecord *record;
+};
+
+template <typename T>
+bool addFieldIfType(Schema &schema, std::string const &type, std::string const &name, std::string const &doc,
+                    std::string const &units, std::uint64_t size) {
+    if (type != FieldBase<T>::getTypeString()) {
+        return false;
+    }
+    if constexpr (IsSized<T>::value) {
+        schema.addField<T>(name, doc, units, FieldBase<T>(size));
+    } else {
+        schema.addField<T>(name, doc, units);
+    }
+    return true;
+}
+
+template <typename... E>
+void addField(TypeList<E...>, Schema &schema, std::string const &type, std::string const &name,
+              std::string const &doc, std::string const &units, std::uint64_t size) {
+    if (!(addFieldIfType<E>(schema, type, name, doc, units, size) || ...)) {
+        throw LSST_EXCEPT(io::MalformedArchiveError,
+                          (boost::format("Unknown field type '%s' for field '%s' in binary archive") % type %
+                           name)
+                                  .str());
+    }
+}
+
+// Identifies (and versions) the format; bump the digit on any incompatible change.
+constexpr char ARCHIVE_MAGIC[] = "AFWARCB1";
+constexpr std::size_t ARCHIVE_MAGIC_SIZE = sizeof(ARCHIVE_MAGIC) - 1;
+
+}  // namespace
+
+void writeBinaryArchiveHeader(std::size_t nCatalogs, std::vector<std::uint8_t> &buffer) {
+    buffer.insert(buffer.end(), ARCHIVE_MAGIC, ARCHIVE_MAGIC + ARCHIVE_MAGIC_SIZE);
+    Writer(buffer).put(static_cast<std::uint64_t>(nCatalogs));
+}
+
+std::size_t readBinaryArchiveHeader(std::uint8_t const *&data, std::uint8_t const *end) {
+    if (static_cast<std::size_t>(end - data) < ARCHIVE_MAGIC_SIZE ||
+        std::memcmp(data, ARCHIVE_MAGIC, ARCHIVE_MAGIC_SIZE) != 0) {
+        throw LSST_EXCEPT(io::MalformedArchiveError, "Buffer does not hold a binary archive");
+    }
+    data += ARCHIVE_MAGIC_SIZE;
+    // Each catalog takes at least a field count and a record count.
+    return Reader(data, end).getCount(2 * sizeof(std::uint64_t));
+}
+
+void writeBinaryCatalog(BaseCatalog const &catalog, std::vector<std::uint8_t> &buffer) {
+    Writer writer(buffer);
+    Schema const schema = catalog.getSchema();
+    writer.put(static_cast<std::uint64_t>(schema.getFieldCount()));
+    schema.forEach(FieldWriter{writer});
+    writer.put(static_cast<std::uint64_t>(catalog.size()));
+    for (auto const &record : catalog) {
+        schema.forEach(ValueWriter{writer, &record});
+    }
+}
+
+BaseCatalog readBinaryCatalog(std::uint8_t const *&data, std::uint8_t const *end) {
+    Reader reader(data, end);
+    Schema schema;
+    // Each field takes at least 4 length prefixes and a size.
+    std::uint64_t const nFields = reader.getCount(5 * sizeof(std::uint64_t));
+    for (std::uint64_t i = 0; i < nFields; ++i) {
+        std::string const type = reader.getString();
+        std::string const name = reader.getString();
+        std::string const doc = reader.getString();
+        std::string const units = reader.getString();
+        std::uint64_t const size = reader.get<std::uint64_t>();
+        addField(FieldTypes(), schema, type, name, doc, units, size);
+    }
+    BaseCatalog catalog(schema);
+    // Each record of a schema with fields takes at least one byte.
+    std::uint64_t const nRecords = reader.getCount(nFields > 0 ? 1 : 0);
+    if (nFields > 0) {
+        catalog.reserve(nRecords);
+    }
+    for (std::uint64_t i = 0; i < nRecords; ++i) {
+        std::shared_ptr<BaseRecord> record = catalog.addNew();
+        schema.forEach(ValueReader{reader, record.get()});
+    }
+    return catalog;
+}
+
+}  // namespace detail
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
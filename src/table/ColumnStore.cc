@@ -0,0 +1,138 @@
+// -*- lsst-c++ -*-
+
+#include <cstring>
+#include <sstream>
+#include <type_traits>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/table/ColumnStore.h"
+#include "lsst/afw/math/detail/Parallel.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+
+namespace {
+
+template <typename T>
+struct IsFixedElement : std::is_arithmetic<T> {};
+
+template <>
+struct IsFixedElement<lsst::geom::Angle> : std::true_type {};
+
+template <typename T>
+struct IsArray : std::false_type {};
+
+template <typename U>
+struct IsArray<Array<U>> : std::true_type {};
+
+// Run func(begin, end) over ranges of [0, n) on nThreads threads.
+template <typename F>
+void forEachRange(std::size_t n, int nThreads, F const &func) {
+    auto const chunks = math::detail::splitRange(0, static_cast<int>(n), nThreads);
+    math::detail::parallelFor(static_cast<int>(chunks.size()), nThreads,
+                              [&](int i) { func(chunks[i].first, chunks[i].second); });
+}
+
+// Return the number of bytes per row stored for a field, or 0 if it is not stored.
+template <typename T>
+std::size_t getRowBytes(SchemaItem<T> const &item) {
+    if constexpr (IsFixedElement<T>::value) {
+        return sizeof(T);
+    } else if constexpr (IsArray<T>::value) {
+        return item.key.isVariableLength() ? 0 : item.key.getSize() * sizeof(typename Field<T>::Element);
+    } else if constexpr (std::is_same_v<T, Flag>) {
+        return sizeof(bool);
+    } else {
+        return 0;
+    }
+}
+
+template <typename T>
+std::pair<std::size_t, int> getColumnId(Key<T> const &key) {
+    return std::make_pair(key.getOffset(), -1);
+}
+
+std::pair<std::size_t, int> getColumnId(Key<Flag> const &key) {
+    return std::make_pair(key.getOffset(), static_cast<int>(key.getBit()));
+}
+
+// Schema::forEach functor that copies const records into columns, or columns into non-const records.
+template <typename RecordPtr, typename ColumnMap>
+struct CopyColumns {
+    template <typename T>
+    void operator()(SchemaItem<T> const &item) const {
+        std::size_t const rowBytes = getRowBytes(item);
+        if (rowBytes == 0) {
+            return;
+        }
+        auto const id = getColumnId(item.key);
+        auto &column = columns[id];
+        if (!column.bytes.getData()) {
+            column.rowBytes = rowBytes;
+            column.bytes = ndarray::allocate(records.size() * rowBytes);
+        }
+        std::uint8_t *const data = column.bytes.getData();
+        forEachRange(records.size(), nThreads, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                if constexpr (std::is_same_v<T, Flag>) {
+                    bool *const value = reinterpret_cast<bool *>(data) + i;
+                    if constexpr (std::is_const_v<std::remove_pointer_t<RecordPtr>>) {
+                        *value = records[i]->get(item.key);
+                    } else {
+                        records[i]->set(item.key, *value);
+                    }
+                } else {
+                    auto *const element = records[i]->getElement(item.key);
+                    if constexpr (std::is_const_v<std::remove_pointer_t<RecordPtr>>) {
+                        std::memcpy(data + i * rowBytes, element, rowBytes);
+                    } else {
+                        std::memcpy(element, data + i * rowBytes, rowBytes);
+                    }
+                }
+            }
+        });
+    }
+
+    std::vector<RecordPtr> const &records;
+    ColumnMap &columns;
+    int nThreads;
+};
+
+}  // namespace
+
+ColumnStore::ColumnStore(Schema const &schema, std::vector<BaseRecord const *> const &records,
+                         int numThreads)
+        : _schema(schema), _size(records.size()) {
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    schema.forEach(CopyColumns<BaseRecord const *, ColumnMap>{records, _columns, nThreads});
+}
+
+void ColumnStore::_assignTo(Schema const &schema, std::vector<BaseRecord *> const &records,
+                            int numThreads) const {
+    if (schema != _schema) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          "Catalog schema does not match the ColumnStore's");
+    }
+    if (records.size() != _size) {
+        std::ostringstream os;
+        os << "Catalog has " << records.size() << " records; the ColumnStore has " << _size << " rows";
+        throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
+    }
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    // The columns are not modified, since every one already exists.
+    auto &columns = const_cast<ColumnMap &>(_columns);
+    schema.forEach(CopyColumns<BaseRecord *, ColumnMap>{records, columns, nThreads});
+}
+
+ColumnStore::Column const &ColumnStore::_find(std::size_t offset, int bit) const {
+    auto const iter = _columns.find(std::make_pair(offset, bit));
+    if (iter == _columns.end()) {
+        throw LSST_EXCEPT(pex::exceptions::NotFoundError, "Field is not stored in the ColumnStore");
+    }
+    return iter->second;
+}
+
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
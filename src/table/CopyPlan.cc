@@ -0,0 +1,174 @@
+// -*- lsst-c++ -*-
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/table/CopyPlan.h"
+#include "lsst/afw/table/BaseTable.h"
+#include "lsst/afw/math/detail/Parallel.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+
+namespace {
+
+template <typename U>
+void checkVariableLength(Key<U> const &inputKey, Key<U> const &outputKey, char const *what) {
+    if (inputKey.isVariableLength() != outputKey.isVariableLength()) {
+        std::ostringstream os;
+        os << "At least one input " << what << " field is variable-length"
+           << " and the corresponding output is not, or vice-versa";
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError, os.str());
+    }
+}
+
+// SchemaMapper::forEach functor that sorts the mapper's key pairs into byte runs, flags, and
+// variable-length fields.
+template <typename Run, typename FlagMasks, typename Variable>
+struct CompilePlan {
+    template <typename U>
+    void operator()(Key<U> const &inputKey, Key<U> const &outputKey) const {
+        addRun(inputKey.getOffset(), outputKey.getOffset(),
+               inputKey.getElementCount() * sizeof(typename Field<U>::Element));
+    }
+
+    template <typename U>
+    void operator()(Key<Array<U>> const &inputKey, Key<Array<U>> const &outputKey) const {
+        checkVariableLength(inputKey, outputKey, "array");
+        if (inputKey.isVariableLength()) {
+            variable.push_back([inputKey, outputKey](BaseRecord const &input, BaseRecord &output) {
+                output.set(outputKey, ndarray::Array<U, 1, 1>(ndarray::copy(input.get(inputKey))));
+            });
+            return;
+        }
+        addRun(inputKey.getOffset(), outputKey.getOffset(), inputKey.getElementCount() * sizeof(U));
+    }
+
+    void operator()(Key<std::string> const &inputKey, Key<std::string> const &outputKey) const {
+        checkVariableLength(inputKey, outputKey, "string");
+        if (inputKey.isVariableLength()) {
+            variable.push_back([inputKey, outputKey](BaseRecord const &input, BaseRecord &output) {
+                output.set(outputKey, input.get(inputKey));
+            });
+            return;
+        }
+        addRun(inputKey.getOffset(), outputKey.getOffset(), inputKey.getElementCount());
+    }
+
+    void operator()(Key<Flag> const &inputKey, Key<Flag> const &outputKey) const {
+        int const shift = static_cast<int>(outputKey.getBit()) - static_cast<int>(inputKey.getBit());
+        flags[std::make_tuple(inputKey.getOffset(), outputKey.getOffset(), shift)] |=
+                std::uint64_t(1) << inputKey.getBit();
+    }
+
+    void addRun(std::size_t inputOffset, std::size_t outputOffset, std::size_t size) const {
+        if (size > 0) {
+            runs.push_back(Run{inputOffset, outputOffset, size});
+        }
+    }
+
+    std::vector<Run> &runs;
+    FlagMasks &flags;
+    Variable &variable;
+};
+
+}  // namespace
+
+CopyPlan::CopyPlan(SchemaMapper const &mapper) : _mapper(mapper) {
+    std::map<std::tuple<std::size_t, std::size_t, int>, std::uint64_t> flagMasks;
+    mapper.forEach(CompilePlan<Run, decltype(flagMasks), decltype(_variable)>{_runs, flagMasks, _variable});
+    // Coalesce runs that are adjacent in both the input and the output.
+    std::sort(_runs.begin(), _runs.end(),
+              [](Run const &a, Run const &b) { return a.inputOffset < b.inputOffset; });
+    std::vector<Run> runs;
+    for (auto const &run : _runs) {
+        if (!runs.empty() && runs.back().inputOffset + runs.back().size == run.inputOffset &&
+            runs.back().outputOffset + runs.back().size == run.outputOffset) {
+            runs.back().size += run.size;
+        } else {
+            runs.push_back(run);
+        }
+    }
+    _runs.swap(runs);
+    for (auto const &item : flagMasks) {
+        _flags.push_back(FlagRemap{std::get<0>(item.first), std::get<1>(item.first), std::get<2>(item.first),
+                                   item.second});
+    }
+}
+
+void CopyPlan::apply(BaseRecord const &input, BaseRecord &output) const {
+    _checkSchemas(input, output);
+    _copy(input, output);
+}
+
+void CopyPlan::apply(std::vector<BaseRecord const *> const &inputs, std::vector<BaseRecord *> const &outputs,
+                     int numThreads) const {
+    if (inputs.size() != outputs.size()) {
+        std::ostringstream os;
+        os << "Number of input records (" << inputs.size() << ") does not match number of output records ("
+           << outputs.size() << ")";
+        throw LSST_EXCEPT(pex::exceptions::LengthError, os.str());
+    }
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    // Records almost always come from one table each, so only check schemas when the tables change.
+    BaseTable const *lastInputTable = nullptr;
+    BaseTable const *lastOutputTable = nullptr;
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        BaseTable const *inputTable = inputs[i]->getTable().get();
+        BaseTable const *outputTable = outputs[i]->getTable().get();
+        if (inputTable != lastInputTable || outputTable != lastOutputTable) {
+            _checkSchemas(*inputs[i], *outputs[i]);
+            lastInputTable = inputTable;
+            lastOutputTable = outputTable;
+        }
+    }
+    auto const chunks = math::detail::splitRange(0, static_cast<int>(inputs.size()), nThreads);
+    math::detail::parallelFor(static_cast<int>(chunks.size()), nThreads, [&](int k) {
+        for (int i = chunks[k].first; i < chunks[k].second; ++i) {
+            _copy(*inputs[i], *outputs[i]);
+        }
+    });
+}
+
+void CopyPlan::_checkSchemas(BaseRecord const &input, BaseRecord const &output) const {
+    if (!input.getSchema().contains(_mapper.getInputSchema())) {
+        throw LSST_EXCEPT(pex::exceptions::LogicError, "Unequal schemas between input record and mapper.");
+    }
+    if (!output.getSchema().contains(_mapper.getOutputSchema())) {
+        throw LSST_EXCEPT(pex::exceptions::LogicError, "Unequal schemas between output record and mapper.");
+    }
+}
+
+void CopyPlan::_copy(BaseRecord const &input, BaseRecord &output) const {
+    char const *const in = static_cast<char const *>(input._data);
+    char *const out = static_cast<char *>(output._data);
+    for (auto const &run : _runs) {
+        std::memcpy(out + run.outputOffset, in + run.inputOffset, run.size);
+    }
+    for (auto const &flag : _flags) {
+        std::uint64_t inWord;
+        std::uint64_t outWord;
+        std::memcpy(&inWord, in + flag.inputOffset, sizeof(inWord));
+        std::memcpy(&outWord, out + flag.outputOffset, sizeof(outWord));
+        std::uint64_t const bits = flag.inputMask & inWord;
+        std::uint64_t const outMask =
+                flag.shift >= 0 ? flag.inputMask << flag.shift : flag.inputMask >> -flag.shift;
+        std::uint64_t const outBits = flag.shift >= 0 ? bits << flag.shift : bits >> -flag.shift;
+        outWord = (outWord & ~outMask) | outBits;
+        std::memcpy(out + flag.outputOffset, &outWord, sizeof(outWord));
+    }
+    for (auto const &copyField : _variable) {
+        copyField(input, output);
+    }
+    output._assign(input);  // let derived classes assign their own stuff
+}
+
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
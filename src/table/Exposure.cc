@@ -201,6 +201,7 @@ public:
         if (!_archive) {
             _doWriteArchive = true;
             _archive.reset(new io::OutputArchive());
+            _archive->setDeduplicate(true);
         }
     }
 
@@ -323,6 +324,12 @@ public:
                     "photoCalib", mapper);
         }
 
+        if ((ioFlags & EXPOSURE_IO_PARALLEL_ARCHIVE) && mapper.hasArchive()) {
+            // Load the objects now, so the column readers find them in the archive's map
+            mapper.getArchive()->getAll(0);
+        }
+
+        mapper.require(ExposureTable::makeMinimalSchema());
         auto schema = mapper.finalize();
         std::shared_ptr<ExposureTable> table = ExposureTable::make(schema);
         table->setMetadata(metadata);
@@ -0,0 +1,198 @@
+// -*- lsst-c++ -*-
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/geom/Angle.h"
+#include "lsst/geom/Box.h"
+#include "lsst/afw/geom/SkyWcs.h"
+#include "lsst/afw/table/ExposureSkyIndex.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+
+namespace {
+
+// Number of points sampled along each edge of a bounding box to bound it on the sky.
+constexpr int EDGE_SAMPLES = 8;
+
+// Factor by which a bounding circle's radius is increased, to cover the edges between samples.
+constexpr double PADDING = 1.05;
+
+// Maximum number of records in a leaf of the tree.
+constexpr std::size_t LEAF_SIZE = 8;
+
+Eigen::Vector3d toVector(lsst::geom::SpherePoint const &coord) {
+    auto const v = coord.getVector();
+    return Eigen::Vector3d(v.x(), v.y(), v.z());
+}
+
+double angleBetween(Eigen::Vector3d const &a, Eigen::Vector3d const &b) {
+    return std::acos(std::max(-1.0, std::min(1.0, a.dot(b))));
+}
+
+// Return the center and radius of a circle containing the bounding box of a record on the sky; a
+// radius of pi covers the whole sky, for boxes the WCS cannot map.
+std::pair<Eigen::Vector3d, double> boundRecord(ExposureRecord const &record) {
+    std::pair<Eigen::Vector3d, double> const wholeSky(Eigen::Vector3d::UnitX(), lsst::geom::PI);
+    lsst::geom::Box2D const box(record.getBBox());
+    std::vector<lsst::geom::Point2D> points;
+    points.reserve(4 * EDGE_SAMPLES + 1);
+    for (int i = 0; i < EDGE_SAMPLES; ++i) {
+        double const dx = box.getWidth() * i / EDGE_SAMPLES;
+        double const dy = box.getHeight() * i / EDGE_SAMPLES;
+        points.emplace_back(box.getMinX() + dx, box.getMinY());
+        points.emplace_back(box.getMaxX(), box.getMinY() + dy);
+        points.emplace_back(box.getMaxX() - dx, box.getMaxY());
+        points.emplace_back(box.getMinX(), box.getMaxY() - dy);
+    }
+    points.push_back(box.getCenter());
+    std::vector<Eigen::Vector3d> vectors;
+    try {
+        for (auto const &coord : record.getWcs()->pixelToSky(points)) {
+            vectors.push_back(toVector(coord));
+        }
+    } catch (pex::exceptions::Exception &) {
+        return wholeSky;
+    }
+    Eigen::Vector3d center = Eigen::Vector3d::Zero();
+    for (auto const &v : vectors) {
+        center += v;
+    }
+    if (!center.allFinite() || center.norm() < 1E-8) {
+        return wholeSky;
+    }
+    center.normalize();
+    double radius = 0.0;
+    for (auto const &v : vectors) {
+        radius = std::max(radius, angleBetween(center, v));
+    }
+    return std::make_pair(center, std::min(radius * PADDING + 1E-8, lsst::geom::PI));
+}
+
+}  // namespace
+
+ExposureSkyIndex::ExposureSkyIndex(ExposureCatalog const &catalog) : _catalog(catalog) {
+    _caps.reserve(_catalog.size());
+    for (std::size_t i = 0; i < _catalog.size(); ++i) {
+        ExposureRecord const &record = _catalog[i];
+        if (!record.getWcs()) {
+            throw LSST_EXCEPT(pex::exceptions::LogicError,
+                              "ExposureRecord does not have a Wcs; cannot build an ExposureSkyIndex");
+        }
+        if (record.getBBox().isEmpty()) {
+            // Empty records contain no points; give them a circle that contains none either.
+            _caps.push_back(Cap{Eigen::Vector3d::UnitX(), 0.0, 2.0});
+            continue;
+        }
+        auto const bound = boundRecord(record);
+        _caps.push_back(Cap{bound.first, bound.second,
+                            bound.second >= lsst::geom::PI ? -2.0 : std::cos(bound.second)});
+        _order.push_back(i);
+    }
+    if (!_order.empty()) {
+        _nodes.reserve(2 * (_order.size() / LEAF_SIZE + 1));
+        _build(0, _order.size());
+    }
+}
+
+int ExposureSkyIndex::_build(std::size_t begin, std::size_t end) {
+    // Bound the circles of the node's records.
+    Eigen::Vector3d center = Eigen::Vector3d::Zero();
+    for (std::size_t k = begin; k < end; ++k) {
+        center += _caps[_order[k]].center;
+    }
+    double radius = lsst::geom::PI;
+    if (center.norm() > 1E-8) {
+        center.normalize();
+        radius = 0.0;
+        for (std::size_t k = begin; k < end; ++k) {
+            Cap const &cap = _caps[_order[k]];
+            radius = std::max(radius, angleBetween(center, cap.center) + cap.radius);
+        }
+        radius = std::min(radius, lsst::geom::PI);
+    } else {
+        center = Eigen::Vector3d::UnitX();
+    }
+    int const index = static_cast<int>(_nodes.size());
+    Cap const cap{center, radius, radius >= lsst::geom::PI ? -2.0 : std::cos(radius)};
+    _nodes.push_back(Node{cap, begin, end, -1, -1});
+    if (end - begin <= LEAF_SIZE) {
+        return index;
+    }
+    // Split the records at the median of their centers along the axis on which they are most spread.
+    Eigen::Vector3d lower = _caps[_order[begin]].center;
+    Eigen::Vector3d upper = lower;
+    for (std::size_t k = begin; k < end; ++k) {
+        lower = lower.cwiseMin(_caps[_order[k]].center);
+        upper = upper.cwiseMax(_caps[_order[k]].center);
+    }
+    int axis;
+    (upper - lower).maxCoeff(&axis);
+    std::size_t const middle = begin + (end - begin) / 2;
+    std::nth_element(_order.begin() + begin, _order.begin() + middle, _order.begin() + end,
+                     [this, axis](std::size_t a, std::size_t b) {
+                         return _caps[a].center[axis] < _caps[b].center[axis];
+                     });
+    int const left = _build(begin, middle);
+    int const right = _build(middle, end);
+    _nodes[index].left = left;
+    _nodes[index].right = right;
+    return index;
+}
+
+std::vector<std::size_t> ExposureSkyIndex::findContaining(lsst::geom::SpherePoint const &coord,
+                                                          bool includeValidPolygon) const {
+    std::vector<std::size_t> result;
+    if (_nodes.empty()) {
+        return result;
+    }
+    Eigen::Vector3d const v = toVector(coord);
+    std::vector<int> stack(1, 0);
+    while (!stack.empty()) {
+        Node const &node = _nodes[stack.back()];
+        stack.pop_back();
+        if (!node.cap.contains(v)) {
+            continue;
+        }
+        if (node.left >= 0) {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+            continue;
+        }
+        for (std::size_t k = node.begin; k < node.end; ++k) {
+            std::size_t const i = _order[k];
+            if (_caps[i].contains(v) && _catalog[i].contains(coord, includeValidPolygon)) {
+                result.push_back(i);
+            }
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+ExposureCatalog ExposureSkyIndex::subsetContaining(lsst::geom::SpherePoint const &coord,
+                                                   bool includeValidPolygon) const {
+    ExposureCatalog result(_catalog.getTable());
+    for (std::size_t i : findContaining(coord, includeValidPolygon)) {
+        result.push_back(_catalog.get(i));
+    }
+    return result;
+}
+
+std::vector<ExposureCatalog> ExposureSkyIndex::subsetContaining(
+        std::vector<lsst::geom::SpherePoint> const &coords, bool includeValidPolygon) const {
+    std::vector<ExposureCatalog> result;
+    result.reserve(coords.size());
+    for (auto const &coord : coords) {
+        result.push_back(subsetContaining(coord, includeValidPolygon));
+    }
+    return result;
+}
+
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
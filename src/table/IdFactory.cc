@@ -1,3 +1,4 @@
+#include <atomic>
 #include <memory>
 #include "boost/format.hpp"
 
@@ -20,21 +21,24 @@ public:
 
     SimpleIdFactory()  {}
 
+    SimpleIdFactory(SimpleIdFactory const &other) : IdFactory(other), _current(other._current.load()) {}
+
 private:
-    RecordId _current{0};
+    std::atomic<RecordId> _current{0};
 };
 
 class SourceIdFactory : public IdFactory {
 public:
     RecordId operator()() override {
-        if (++_lower & _upperMask) {
+        RecordId const lower = ++_lower;
+        if (lower & _upperMask) {
             --_lower;
             throw LSST_EXCEPT(pex::exceptions::LengthError,
                               (boost::format("Next ID '%s' is too large for the number of reserved bits") %
-                               (_lower + 1))
+                               lower)
                                       .str());
         }
-        return _upper | _lower;
+        return _upper | lower;
     }
 
     void notify(RecordId id) override {
@@ -59,10 +63,16 @@ public:
         }
     }
 
+    SourceIdFactory(SourceIdFactory const &other)
+            : IdFactory(other),
+              _upper(other._upper),
+              _upperMask(other._upperMask),
+              _lower(other._lower.load()) {}
+
 private:
     RecordId const _upper;
     RecordId const _upperMask;
-    RecordId _lower;
+    std::atomic<RecordId> _lower;
 };
 
 }  // namespace
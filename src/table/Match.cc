@@ -24,12 +24,21 @@
 
 #include <algorithm>
 #include <cmath>
+#include <iterator>
 #include <memory>
+#include <utility>
+
+#include "boost/format.hpp"
 
 #include "lsst/pex/exceptions.h"
 #include "lsst/log/Log.h"
 #include "lsst/geom/Angle.h"
+#include "lsst/afw/math/detail/Parallel.h"
+#include "lsst/afw/table/HashIndex.h"
 #include "lsst/afw/table/Match.h"
+#include "lsst/afw/table/MatchIndex.h"
+#include "lsst/afw/table/detail/PointGrid.h"
+#include "lsst/afw/table/detail/PointTree.h"
 
 namespace lsst {
 namespace afw {
@@ -53,11 +62,24 @@ bool operator<(RecordPos<Record1> const &s1, RecordPos<Record2> const &s2) {
     return (s1.dec < s2.dec);
 }
 
-struct CmpRecordPtr {
-    bool operator()(std::shared_ptr<SourceRecord> const s1, std::shared_ptr<SourceRecord> const s2) {
-        return s1->getY() < s2->getY();
+/**
+ * @internal Extract the records of a SourceCatalog whose centroids are finite, and those centroids,
+ * in catalog order.
+ */
+void makeXyPositions(SourceCatalog const &cat, std::vector<std::shared_ptr<SourceRecord>> &records,
+                     std::vector<detail::PointGrid::Point> &points) {
+    records.reserve(cat.size());
+    points.reserve(cat.size());
+    for (SourceCatalog::const_iterator i(cat.begin()), e(cat.end()); i != e; ++i) {
+        double const x = i->getX();
+        double const y = i->getY();
+        if (std::isnan(x) || std::isnan(y)) {
+            continue;
+        }
+        records.push_back(i);
+        points.push_back({x, y});
     }
-};
+}
 
 /**
  * @internal Extract source positions from `set`, convert them to cartesian coordinates
@@ -141,6 +163,49 @@ lsst::geom::Angle fromUnitSphereDistanceSquared(double d2) noexcept {
     return 2.0 * std::asin(0.5 * std::sqrt(d2)) * lsst::geom::radians;
 }
 
+/**
+ * @internal Build a 3-d tree over the unit vectors of an array of RecordPos.
+ *
+ * Unlike a sweep over a declination band, the cost of a query does not grow near the poles or with
+ * the density of positions outside the match radius.
+ */
+template <typename Pos>
+detail::PointTree<3> makePositionTree(Pos const *positions, std::size_t n) {
+    std::vector<detail::PointTree<3>::Point> points;
+    points.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        points.push_back({positions[i].x, positions[i].y, positions[i].z});
+    }
+    return detail::PointTree<3>(std::move(points));
+}
+
+/**
+ * @internal Call func(begin, end, matches) for pieces of [0, n) on up to nThreads threads, and
+ * return the concatenation of the matches each call appends, in order.
+ */
+template <typename MatchT, typename F>
+std::vector<MatchT> matchInParallel(std::size_t n, int nThreads, F const &func) {
+    // Use several pieces per thread, since the work per position is uneven.
+    auto const pieces = math::detail::splitRange(0, static_cast<int>(n), nThreads == 1 ? 1 : 8 * nThreads);
+    std::vector<std::vector<MatchT>> results(pieces.size());
+    math::detail::parallelFor(static_cast<int>(pieces.size()), nThreads,
+                              [&](int i) { func(pieces[i].first, pieces[i].second, results[i]); });
+    std::vector<MatchT> matches;
+    if (results.size() == 1) {
+        matches.swap(results.front());
+        return matches;
+    }
+    std::size_t total = 0;
+    for (auto const &result : results) {
+        total += result.size();
+    }
+    matches.reserve(total);
+    for (auto &result : results) {
+        std::move(result.begin(), result.end(), std::back_inserter(matches));
+    }
+    return matches;
+}
+
 }  // namespace
 
 template <typename Cat1, typename Cat2>
@@ -184,45 +249,40 @@ std::vector<Match<typename Cat1::Record, typename Cat2::Record> > matchRaDec(Cat
     len1 = makeRecordPositions(cat1, pos1.get());
     len2 = makeRecordPositions(cat2, pos2.get());
     std::shared_ptr<typename Cat2::Record> nullRecord = std::shared_ptr<typename Cat2::Record>();
-
-    for (size_t i = 0, start = 0; i < len1; ++i) {
-        double minDec = pos1[i].dec - radius.asRadians();
-        while (start < len2 && pos2[start].dec < minDec) {
-            ++start;
-        }
-        if (start == len2) {
-            break;
-        }
-        double maxDec = pos1[i].dec + radius.asRadians();
-        size_t closestIndex = -1;    // Index of closest match (if any)
-        double d2Include = d2Limit;  // Squared distance for inclusion of match
-        bool found = false;          // Found anything?
-        size_t nMatches = 0;         // Number of matches
-        for (size_t j = start; j < len2 && pos2[j].dec <= maxDec; ++j) {
-            double dx = pos1[i].x - pos2[j].x;
-            double dy = pos1[i].y - pos2[j].y;
-            double dz = pos1[i].z - pos2[j].z;
-            double d2 = dx * dx + dy * dy + dz * dz;
-            if (d2 < d2Include) {
-                if (mc.findOnlyClosest) {
-                    d2Include = d2;
-                    closestIndex = j;
-                    found = true;
-                } else {
-                    matches.push_back(MatchT(pos1[i].src, pos2[j].src, fromUnitSphereDistanceSquared(d2)));
+    auto const tree = makePositionTree(pos2.get(), len2);
+
+    auto matchPositions = [&](std::size_t begin, std::size_t end, std::vector<MatchT> &result) {
+        std::vector<std::pair<std::size_t, double>> found;
+        for (size_t i = begin; i < end; ++i) {
+            tree.findWithin({pos1[i].x, pos1[i].y, pos1[i].z}, d2Limit, found);
+            size_t closestIndex = -1;    // Index of closest match (if any)
+            double d2Include = d2Limit;  // Squared distance for inclusion of match
+            bool isFound = false;        // Found anything?
+            size_t nMatches = 0;         // Number of matches
+            for (auto const &candidate : found) {
+                size_t const j = candidate.first;
+                double const d2 = candidate.second;
+                if (d2 < d2Include) {
+                    if (mc.findOnlyClosest) {
+                        d2Include = d2;
+                        closestIndex = j;
+                        isFound = true;
+                    } else {
+                        result.push_back(MatchT(pos1[i].src, pos2[j].src, fromUnitSphereDistanceSquared(d2)));
+                    }
+                    ++nMatches;
                 }
-                ++nMatches;
+            }
+            if (mc.includeMismatches && nMatches == 0) {
+                result.push_back(MatchT(pos1[i].src, nullRecord, NAN));
+            }
+            if (mc.findOnlyClosest && isFound) {
+                result.push_back(MatchT(pos1[i].src, pos2[closestIndex].src,
+                                        fromUnitSphereDistanceSquared(d2Include)));
             }
         }
-        if (mc.includeMismatches && nMatches == 0) {
-            matches.push_back(MatchT(pos1[i].src, nullRecord, NAN));
-        }
-        if (mc.findOnlyClosest && found) {
-            matches.push_back(
-                    MatchT(pos1[i].src, pos2[closestIndex].src, fromUnitSphereDistanceSquared(d2Include)));
-        }
-    }
-    return matches;
+    };
+    return matchInParallel<MatchT>(len1, math::detail::resolveNumThreads(mc.numThreads), matchPositions);
 }
 
 #define LSST_MATCH_RADEC(RTYPE, C1, C2)                                         \
@@ -266,24 +326,26 @@ std::vector<Match<typename Cat::Record, typename Cat::Record> > matchRaDec(Cat c
     using Pos = RecordPos<typename Cat::Record>;
     std::unique_ptr<Pos[]> pos(new Pos[len]);
     len = makeRecordPositions(cat, pos.get());
-
-    for (size_t i = 0; i < len; ++i) {
-        double maxDec = pos[i].dec + radius.asRadians();
-        for (size_t j = i + 1; j < len && pos[j].dec <= maxDec; ++j) {
-            double dx = pos[i].x - pos[j].x;
-            double dy = pos[i].y - pos[j].y;
-            double dz = pos[i].z - pos[j].z;
-            double d2 = dx * dx + dy * dy + dz * dz;
-            if (d2 < d2Limit) {
-                lsst::geom::Angle d = fromUnitSphereDistanceSquared(d2);
-                matches.push_back(MatchT(pos[i].src, pos[j].src, d));
+    auto const tree = makePositionTree(pos.get(), len);
+
+    auto matchPositions = [&](std::size_t begin, std::size_t end, std::vector<MatchT> &result) {
+        std::vector<std::pair<std::size_t, double>> found;
+        for (size_t i = begin; i < end; ++i) {
+            tree.findWithin({pos[i].x, pos[i].y, pos[i].z}, d2Limit, found);
+            for (auto const &candidate : found) {
+                size_t const j = candidate.first;
+                if (j <= i) {
+                    continue;
+                }
+                lsst::geom::Angle d = fromUnitSphereDistanceSquared(candidate.second);
+                result.push_back(MatchT(pos[i].src, pos[j].src, d));
                 if (mc.symmetricMatch) {
-                    matches.push_back(MatchT(pos[j].src, pos[i].src, d));
+                    result.push_back(MatchT(pos[j].src, pos[i].src, d));
                 }
             }
         }
-    }
-    return matches;
+    };
+    return matchInParallel<MatchT>(len, math::detail::resolveNumThreads(mc.numThreads), matchPositions);
 }
 
 #define LSST_MATCH_RADEC(RTYPE, C)                                 \
@@ -307,77 +369,42 @@ SourceMatchVector matchXy(SourceCatalog const &cat1, SourceCatalog const &cat2,
     if (&cat1 == &cat2) {
         return matchXy(cat1, radius);
     }
-    // setup match parameters
-    double const r2 = radius * radius;
-
-    // copy and sort array of pointers on y
-    size_t len1 = cat1.size();
-    size_t len2 = cat2.size();
-    std::unique_ptr<std::shared_ptr<SourceRecord>[]> pos1(new std::shared_ptr<SourceRecord>[len1]);
-    std::unique_ptr<std::shared_ptr<SourceRecord>[]> pos2(new std::shared_ptr<SourceRecord>[len2]);
+    // setup match parameters; a negative radius matches nothing, as no distance is smaller
+    double const r2 = radius > 0.0 ? radius * radius : 0.0;
+
+    std::vector<std::shared_ptr<SourceRecord>> records1, records2;
+    std::vector<detail::PointGrid::Point> points1, points2;
+    makeXyPositions(cat1, records1, points1);
+    makeXyPositions(cat2, records2, points2);
+    detail::PointGrid const grid(points2, radius);
     std::shared_ptr<SourceRecord> nullRecord = std::shared_ptr<SourceRecord>();
-    size_t n = 0;
-    for (SourceCatalog::const_iterator i(cat1.begin()), e(cat1.end()); i != e; ++i) {
-        if (std::isnan(i->getX()) || std::isnan(i->getY())) {
-            continue;
-        }
-        pos1[n] = i;
-        ++n;
-    }
-    len1 = n;
-    n = 0;
-    for (SourceCatalog::const_iterator i(cat2.begin()), e(cat2.end()); i != e; ++i) {
-        if (std::isnan(i->getX()) || std::isnan(i->getY())) {
-            continue;
-        }
-        pos2[n] = i;
-        ++n;
-    }
-    len2 = n;
-
-    std::sort(pos1.get(), pos1.get() + len1, CmpRecordPtr());
-    std::sort(pos2.get(), pos2.get() + len2, CmpRecordPtr());
 
-    SourceMatchVector matches;
-    for (size_t i = 0, start = 0; i < len1; ++i) {
-        double y = pos1[i]->getY();
-        double minY = y - radius;
-        while (start < len2 && pos2[start]->getY() < minY) {
-            ++start;
-        }
-        if (start == len2) {
-            break;
-        }
-        double x = pos1[i]->getX();
-        double maxY = y + radius;
-        double y2;
-        size_t closestIndex = -1;  // Index of closest match (if any)
-        double r2Include = r2;     // Squared radius for inclusion of match
-        bool found = false;        // Found anything?
-        size_t nMatches = 0;       // Number of matches
-        for (size_t j = start; j < len2 && (y2 = pos2[j]->getY()) <= maxY; ++j) {
-            double dx = x - pos2[j]->getX();
-            double dy = y - y2;
-            double d2 = dx * dx + dy * dy;
-            if (d2 < r2Include) {
-                if (mc.findOnlyClosest) {
-                    r2Include = d2;
-                    closestIndex = j;
-                    found = true;
-                } else {
-                    matches.push_back(SourceMatch(pos1[i], pos2[j], std::sqrt(d2)));
+    auto matchPositions = [&](std::size_t begin, std::size_t end, SourceMatchVector &result) {
+        std::vector<std::pair<std::size_t, double>> found;
+        for (std::size_t i = begin; i < end; ++i) {
+            grid.findWithin(points1[i], r2, found);
+            if (mc.includeMismatches && found.empty()) {
+                result.push_back(SourceMatch(records1[i], nullRecord, NAN));
+            }
+            if (found.empty()) {
+                continue;
+            }
+            if (mc.findOnlyClosest) {
+                auto const closest = std::min_element(
+                        found.begin(), found.end(),
+                        [](auto const &a, auto const &b) { return a.second < b.second; });
+                result.push_back(
+                        SourceMatch(records1[i], records2[closest->first], std::sqrt(closest->second)));
+            } else {
+                for (auto const &candidate : found) {
+                    result.push_back(
+                            SourceMatch(records1[i], records2[candidate.first], std::sqrt(candidate.second)));
                 }
-                ++nMatches;
             }
         }
-        if (mc.includeMismatches && nMatches == 0) {
-            matches.push_back(SourceMatch(pos1[i], nullRecord, NAN));
-        }
-        if (mc.findOnlyClosest && found) {
-            matches.push_back(SourceMatch(pos1[i], pos2[closestIndex], std::sqrt(r2Include)));
-        }
-    }
-    return matches;
+    };
+    return matchInParallel<SourceMatch>(records1.size(), math::detail::resolveNumThreads(mc.numThreads),
+                                        matchPositions);
 }
 
 SourceMatchVector matchXy(SourceCatalog const &cat, double radius, bool symmetric) {
@@ -388,61 +415,65 @@ SourceMatchVector matchXy(SourceCatalog const &cat, double radius, bool symmetri
 }
 
 SourceMatchVector matchXy(SourceCatalog const &cat, double radius, MatchControl const &mc) {
-    // setup match parameters
-    double const r2 = radius * radius;
-
-    // copy and sort array of pointers on y
-    size_t len = cat.size();
-    std::unique_ptr<std::shared_ptr<SourceRecord>[]> pos(new std::shared_ptr<SourceRecord>[len]);
-    size_t n = 0;
-    for (SourceCatalog::const_iterator i(cat.begin()), e(cat.end()); i != e; ++i) {
-        if (std::isnan(i->getX()) || std::isnan(i->getY())) {
-            continue;
-        }
-        pos[n] = i;
-        ++n;
-    }
-    len = n;
-
-    std::sort(pos.get(), pos.get() + len, CmpRecordPtr());
-
-    SourceMatchVector matches;
-    for (size_t i = 0; i < len; ++i) {
-        double x = pos[i]->getX();
-        double y = pos[i]->getY();
-        double maxY = y + radius;
-        double y2;
-        for (size_t j = i + 1; j < len && (y2 = pos[j]->getY()) <= maxY; ++j) {
-            double dx = x - pos[j]->getX();
-            double dy = y - y2;
-            double d2 = dx * dx + dy * dy;
-            if (d2 < r2) {
-                double d = std::sqrt(d2);
-                matches.push_back(SourceMatch(pos[i], pos[j], d));
+    // setup match parameters; a negative radius matches nothing, as no distance is smaller
+    double const r2 = radius > 0.0 ? radius * radius : 0.0;
+
+    std::vector<std::shared_ptr<SourceRecord>> records;
+    std::vector<detail::PointGrid::Point> points;
+    makeXyPositions(cat, records, points);
+    detail::PointGrid const grid(points, radius);
+
+    auto matchPositions = [&](std::size_t begin, std::size_t end, SourceMatchVector &result) {
+        std::vector<std::pair<std::size_t, double>> found;
+        for (std::size_t i = begin; i < end; ++i) {
+            grid.findWithin(points[i], r2, found);
+            for (auto const &candidate : found) {
+                std::size_t const j = candidate.first;
+                if (j <= i) {
+                    continue;
+                }
+                double const d = std::sqrt(candidate.second);
+                result.push_back(SourceMatch(records[i], records[j], d));
                 if (mc.symmetricMatch) {
-                    matches.push_back(SourceMatch(pos[j], pos[i], d));
+                    result.push_back(SourceMatch(records[j], records[i], d));
                 }
             }
         }
-    }
-    return matches;
+    };
+    return matchInParallel<SourceMatch>(records.size(), math::detail::resolveNumThreads(mc.numThreads),
+                                        matchPositions);
 }
 
+namespace {
+
+/// @internal The schema of the catalogs made by packMatches, and its keys
+struct PackedMatchSchema {
+    PackedMatchSchema()
+            : schema(),
+              first(schema.addField<RecordId>("first", "ID for first source record in match.")),
+              second(schema.addField<RecordId>("second", "ID for second source record in match.")),
+              distance(schema.addField<double>("distance", "Distance between matches sources.")) {}
+
+    Schema schema;
+    Key<RecordId> first;
+    Key<RecordId> second;
+    Key<double> distance;
+};
+
+}  // namespace
+
 template <typename Record1, typename Record2>
 BaseCatalog packMatches(std::vector<Match<Record1, Record2> > const &matches) {
-    Schema schema;
-    Key<RecordId> outKey1 = schema.addField<RecordId>("first", "ID for first source record in match.");
-    Key<RecordId> outKey2 = schema.addField<RecordId>("second", "ID for second source record in match.");
-    Key<double> keyD = schema.addField<double>("distance", "Distance between matches sources.");
-    BaseCatalog result(schema);
+    PackedMatchSchema const packed;
+    BaseCatalog result(packed.schema);
     result.getTable()->preallocate(matches.size());
     result.reserve(matches.size());
     using Iter = typename std::vector<Match<Record1, Record2>>::const_iterator;
     for (Iter i = matches.begin(); i != matches.end(); ++i) {
         std::shared_ptr<BaseRecord> record = result.addNew();
-        record->set(outKey1, i->first->getId());
-        record->set(outKey2, i->second->getId());
-        record->set(keyD, i->distance);
+        record->set(packed.first, i->first->getId());
+        record->set(packed.second, i->second->getId());
+        record->set(packed.distance, i->distance);
     }
     return result;
 }
@@ -451,45 +482,83 @@ template BaseCatalog packMatches(SimpleMatchVector const &);
 template BaseCatalog packMatches(ReferenceMatchVector const &);
 template BaseCatalog packMatches(SourceMatchVector const &);
 
+template <typename Cat1, typename Cat2>
+BaseCatalog packMatches(MatchIndices const &matches, Cat1 const &cat1, Cat2 const &cat2) {
+    std::size_t const size = matches.first.size();
+    if (matches.second.size() != size || matches.distance.size() != size) {
+        throw LSST_EXCEPT(pex::exceptions::LengthError, "Match columns have different lengths");
+    }
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        if (matches.first[i] < 0 || matches.first[i] >= static_cast<std::int64_t>(cat1.size()) ||
+            matches.second[i] >= static_cast<std::int64_t>(cat2.size())) {
+            throw LSST_EXCEPT(pex::exceptions::LengthError,
+                              (boost::format("Match %d refers to a record outside its catalog") % i).str());
+        }
+        n += (matches.second[i] >= 0);
+    }
+    PackedMatchSchema const packed;
+    BaseCatalog result(packed.schema);
+    result.getTable()->preallocate(n);
+    result.reserve(n);
+    for (std::size_t i = 0; i < size; ++i) {
+        if (matches.second[i] < 0) {
+            continue;
+        }
+        BaseRecord &record = *result.addNew();
+        record.set(packed.first, cat1[matches.first[i]].getId());
+        record.set(packed.second, cat2[matches.second[i]].getId());
+        record.set(packed.distance, matches.distance[i]);
+    }
+    return result;
+}
+
+template BaseCatalog packMatches(MatchIndices const &, SimpleCatalog const &, SimpleCatalog const &);
+template BaseCatalog packMatches(MatchIndices const &, SimpleCatalog const &, SourceCatalog const &);
+template BaseCatalog packMatches(MatchIndices const &, SourceCatalog const &, SourceCatalog const &);
+
 template <typename Cat1, typename Cat2>
 std::vector<Match<typename Cat1::Record, typename Cat2::Record> > unpackMatches(BaseCatalog const &matches,
                                                                                 Cat1 const &first,
-                                                                                Cat2 const &second) {
+                                                                                Cat2 const &second,
+                                                                                int numThreads) {
     LOG_LOGGER tableLog = LOG_GET("lsst.afw.table");
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
     Key<RecordId> inKey1 = matches.getSchema()["first"];
     Key<RecordId> inKey2 = matches.getSchema()["second"];
     Key<double> keyD = matches.getSchema()["distance"];
-    if (!first.isSorted() || !second.isSorted())
-        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
-                          "Catalogs passed to unpackMatches must be sorted.");
+    HashIndex<typename Cat1::Record, RecordId> const index1(first, first.getTable()->getIdKey());
+    HashIndex<typename Cat2::Record, RecordId> const index2(second, second.getTable()->getIdKey());
     using MatchT = Match<typename Cat1::Record, typename Cat2::Record>;
-    std::vector<MatchT> result;
-    result.resize(matches.size());
-    typename std::vector<MatchT>::iterator j = result.begin();
-    for (BaseCatalog::const_iterator i = matches.begin(); i != matches.end(); ++i, ++j) {
-        typename Cat1::const_iterator k1 = first.find(i->get(inKey1));
-        typename Cat2::const_iterator k2 = second.find(i->get(inKey2));
-        if (k1 != first.end()) {
-            j->first = k1;
-        } else {
-            LOGLS_WARN(tableLog,
-                       "Persisted match record with ID " << i->get(inKey1) << " not found in catalog 1.");
+    std::vector<MatchT> result(matches.size());
+    auto const pieces = math::detail::splitRange(0, static_cast<int>(matches.size()), nThreads);
+    math::detail::parallelFor(static_cast<int>(pieces.size()), nThreads, [&](int i) {
+        for (int k = pieces[i].first; k < pieces[i].second; ++k) {
+            BaseRecord const &match = matches[k];
+            result[k].first = index1.find(match.get(inKey1));
+            result[k].second = index2.find(match.get(inKey2));
+            result[k].distance = match.get(keyD);
+        }
+    });
+    for (std::size_t k = 0; k < result.size(); ++k) {
+        if (!result[k].first) {
+            LOGLS_WARN(tableLog, "Persisted match record with ID " << matches[k].get(inKey1)
+                                                                     << " not found in catalog 1.");
         }
-        if (k2 != second.end()) {
-            j->second = k2;
-        } else {
-            LOGLS_WARN(tableLog,
-                       "Persisted match record with ID " << i->get(inKey2) << " not found in catalog 2.");
+        if (!result[k].second) {
+            LOGLS_WARN(tableLog, "Persisted match record with ID " << matches[k].get(inKey2)
+                                                                     << " not found in catalog 2.");
         }
-        j->distance = i->get(keyD);
     }
     return result;
 }
 
-template SimpleMatchVector unpackMatches(BaseCatalog const &, SimpleCatalog const &, SimpleCatalog const &);
+template SimpleMatchVector unpackMatches(BaseCatalog const &, SimpleCatalog const &, SimpleCatalog const &,
+                                         int);
 template ReferenceMatchVector unpackMatches(BaseCatalog const &, SimpleCatalog const &,
-                                            SourceCatalog const &);
-template SourceMatchVector unpackMatches(BaseCatalog const &, SourceCatalog const &, SourceCatalog const &);
+                                            SourceCatalog const &, int);
+template SourceMatchVector unpackMatches(BaseCatalog const &, SourceCatalog const &, SourceCatalog const &,
+                                         int);
 }  // namespace table
 }  // namespace afw
 }  // namespace lsst
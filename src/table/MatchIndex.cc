@@ -0,0 +1,336 @@
+// -*- lsst-c++ -*-
+
+#include <cmath>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/math/detail/Parallel.h"
+#include "lsst/afw/table/MatchIndex.h"
+#include "lsst/afw/table/detail/PointTree.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+
+namespace {
+
+// A point to match, and the position in its catalog of the record it came from.
+template <int N>
+using IndexedPoint = std::pair<std::size_t, typename detail::PointTree<N>::Point>;
+
+// Return the unit vectors of the coordinates of a catalog's records, skipping NaNs.
+template <typename Cat>
+std::vector<IndexedPoint<3>> getSkyPoints(Cat const &catalog) {
+    Key<lsst::geom::Angle> raKey = Cat::Table::getCoordKey().getRa();
+    Key<lsst::geom::Angle> decKey = Cat::Table::getCoordKey().getDec();
+    std::vector<IndexedPoint<3>> points;
+    points.reserve(catalog.size());
+    for (std::size_t i = 0; i < catalog.size(); ++i) {
+        lsst::geom::Angle ra = catalog[i].get(raKey);
+        lsst::geom::Angle dec = catalog[i].get(decKey);
+        if (std::isnan(ra.asRadians()) || std::isnan(dec.asRadians())) {
+            continue;
+        }
+        double cosDec = std::cos(dec);
+        points.emplace_back(i, detail::PointTree<3>::Point{std::cos(ra) * cosDec, std::sin(ra) * cosDec,
+                                                            std::sin(dec)});
+    }
+    return points;
+}
+
+// Return the centroids of a catalog's records, skipping NaNs.
+template <typename Cat>
+std::vector<IndexedPoint<2>> getXyPoints(Cat const &catalog) {
+    std::vector<IndexedPoint<2>> points;
+    points.reserve(catalog.size());
+    for (std::size_t i = 0; i < catalog.size(); ++i) {
+        double const x = catalog[i].getX();
+        double const y = catalog[i].getY();
+        if (std::isnan(x) || std::isnan(y)) {
+            continue;
+        }
+        points.emplace_back(i, detail::PointTree<2>::Point{x, y});
+    }
+    return points;
+}
+
+// A match between the record at position query in the query catalog and the point with index
+// indexed in the tree (-1 for mismatches), with their squared distance (NaN for mismatches).
+struct Found {
+    std::size_t query;
+    std::ptrdiff_t indexed;
+    double d2;
+};
+
+template <int N>
+std::vector<Found> findMatches(detail::PointTree<N> const &tree, std::vector<IndexedPoint<N>> const &queries,
+                               double d2Limit, MatchControl const &mc) {
+    int const nThreads = math::detail::resolveNumThreads(mc.numThreads);
+    // Use several pieces per thread, since the work per point is uneven.
+    auto const pieces =
+            math::detail::splitRange(0, static_cast<int>(queries.size()), nThreads == 1 ? 1 : 8 * nThreads);
+    std::vector<std::vector<Found>> results(pieces.size());
+    math::detail::parallelFor(static_cast<int>(pieces.size()), nThreads, [&](int p) {
+        std::vector<std::pair<std::size_t, double>> candidates;
+        for (int q = pieces[p].first; q < pieces[p].second; ++q) {
+            std::size_t const query = queries[q].first;
+            tree.findWithin(queries[q].second, d2Limit, candidates);
+            if (candidates.empty()) {
+                if (mc.includeMismatches) {
+                    results[p].push_back(Found{query, -1, NAN});
+                }
+            } else if (mc.findOnlyClosest) {
+                auto closest = candidates.front();
+                for (auto const &candidate : candidates) {
+                    if (candidate.second < closest.second) {
+                        closest = candidate;
+                    }
+                }
+                results[p].push_back(
+                        Found{query, static_cast<std::ptrdiff_t>(closest.first), closest.second});
+            } else {
+                for (auto const &candidate : candidates) {
+                    results[p].push_back(
+                            Found{query, static_cast<std::ptrdiff_t>(candidate.first), candidate.second});
+                }
+            }
+        }
+    });
+    std::vector<Found> found;
+    for (auto &result : results) {
+        std::move(result.begin(), result.end(), std::back_inserter(found));
+    }
+    return found;
+}
+
+// Return the angle in radians between two unit vectors separated by a squared distance.
+double skyDistance(double d2) { return 2.0 * std::asin(0.5 * std::sqrt(d2)); }
+
+double xyDistance(double d2) { return std::sqrt(d2); }
+
+void checkSkyRadius(lsst::geom::Angle radius) {
+    if (radius < 0.0 || radius > (45.0 * lsst::geom::degrees)) {
+        throw LSST_EXCEPT(pex::exceptions::RangeError, "match radius out of range (0 to 45 degrees)");
+    }
+}
+
+// Return a copy of a MatchControl that finds all pairs, for self-matches.
+MatchControl allPairs(MatchControl const &mc) {
+    MatchControl result(mc);
+    result.findOnlyClosest = false;
+    result.includeMismatches = false;
+    return result;
+}
+
+// Return the matches between distinct records of a self-match, in one or both orders.
+MatchIndices selectSelfMatches(MatchIndices const &all, bool symmetric) {
+    auto keep = [&all, symmetric](std::size_t i) {
+        return symmetric ? all.first[i] != all.second[i] : all.first[i] < all.second[i];
+    };
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < all.first.size(); ++i) {
+        n += keep(i);
+    }
+    MatchIndices result{ndarray::allocate(n), ndarray::allocate(n), ndarray::allocate(n)};
+    for (std::size_t i = 0, j = 0; i < all.first.size(); ++i) {
+        if (keep(i)) {
+            result.first[j] = all.first[i];
+            result.second[j] = all.second[i];
+            result.distance[j] = all.distance[i];
+            ++j;
+        }
+    }
+    return result;
+}
+
+}  // namespace
+
+template <typename RecordT>
+struct MatchIndex<RecordT>::Impl {
+    std::vector<std::shared_ptr<RecordT>> records;  // indexed records, by tree index
+    std::vector<std::int64_t> positions;            // their positions in the catalog, by tree index
+    std::optional<detail::PointTree<3>> sky;
+    std::optional<detail::PointTree<2>> xy;
+
+    template <int N>
+    std::vector<typename detail::PointTree<N>::Point> add(CatalogT<RecordT> const &catalog,
+                                                          std::vector<IndexedPoint<N>> const &points) {
+        std::vector<typename detail::PointTree<N>::Point> treePoints;
+        treePoints.reserve(points.size());
+        for (auto const &point : points) {
+            records.push_back(catalog.get(point.first));
+            positions.push_back(static_cast<std::int64_t>(point.first));
+            treePoints.push_back(point.second);
+        }
+        return treePoints;
+    }
+
+    template <typename Record1, typename Cat, typename Distance>
+    std::vector<Match<Record1, RecordT>> toMatches(Cat const &catalog, std::vector<Found> const &found,
+                                                   Distance distance) const {
+        std::vector<Match<Record1, RecordT>> matches;
+        matches.reserve(found.size());
+        for (auto const &f : found) {
+            matches.emplace_back(catalog.get(f.query),
+                                 f.indexed < 0 ? std::shared_ptr<RecordT>() : records[f.indexed],
+                                 f.indexed < 0 ? NAN : distance(f.d2));
+        }
+        return matches;
+    }
+
+    template <typename Distance>
+    MatchIndices toIndices(std::vector<Found> const &found, Distance distance) const {
+        MatchIndices result{ndarray::allocate(found.size()), ndarray::allocate(found.size()),
+                            ndarray::allocate(found.size())};
+        for (std::size_t i = 0; i < found.size(); ++i) {
+            result.first[i] = static_cast<std::int64_t>(found[i].query);
+            result.second[i] = found[i].indexed < 0 ? -1 : positions[found[i].indexed];
+            result.distance[i] = found[i].indexed < 0 ? NAN : distance(found[i].d2);
+        }
+        return result;
+    }
+
+    void checkSky() const {
+        if (!sky) {
+            throw LSST_EXCEPT(pex::exceptions::LogicError, "MatchIndex is not on sky coordinates");
+        }
+    }
+
+    void checkXy() const {
+        if (!xy) {
+            throw LSST_EXCEPT(pex::exceptions::LogicError, "MatchIndex is not on centroids");
+        }
+    }
+};
+
+template <typename RecordT>
+MatchIndex<RecordT>::MatchIndex(std::shared_ptr<Impl const> impl) : _impl(std::move(impl)) {}
+
+template <typename RecordT>
+MatchIndex<RecordT> MatchIndex<RecordT>::makeSky(CatalogT<RecordT> const &catalog) {
+    auto impl = std::make_shared<Impl>();
+    impl->sky.emplace(impl->add(catalog, getSkyPoints(catalog)));
+    return MatchIndex(impl);
+}
+
+template <typename RecordT>
+MatchIndex<RecordT> MatchIndex<RecordT>::makeXy(CatalogT<RecordT> const &catalog) {
+    if constexpr (std::is_same_v<RecordT, SourceRecord>) {
+        auto impl = std::make_shared<Impl>();
+        impl->xy.emplace(impl->add(catalog, getXyPoints(catalog)));
+        return MatchIndex(impl);
+    } else {
+        throw LSST_EXCEPT(pex::exceptions::LogicError, "Only SourceCatalogs can be indexed by centroid");
+    }
+}
+
+template <typename RecordT>
+bool MatchIndex<RecordT>::isSky() const noexcept {
+    return static_cast<bool>(_impl->sky);
+}
+
+template <typename RecordT>
+std::size_t MatchIndex<RecordT>::size() const noexcept {
+    return _impl->records.size();
+}
+
+template <typename RecordT>
+template <typename Cat>
+std::vector<Match<typename Cat::Record, RecordT>> MatchIndex<RecordT>::matchRaDec(
+        Cat const &catalog, lsst::geom::Angle radius, MatchControl const &mc) const {
+    _impl->checkSky();
+    checkSkyRadius(radius);
+    double const d2Limit = 2.0 * (1.0 - std::cos(radius.asRadians()));
+    auto const found = findMatches(*_impl->sky, getSkyPoints(catalog), d2Limit, mc);
+    return _impl->template toMatches<typename Cat::Record>(catalog, found, skyDistance);
+}
+
+template <typename RecordT>
+template <typename Cat>
+MatchIndices MatchIndex<RecordT>::matchRaDecIndices(Cat const &catalog, lsst::geom::Angle radius,
+                                                    MatchControl const &mc) const {
+    _impl->checkSky();
+    checkSkyRadius(radius);
+    double const d2Limit = 2.0 * (1.0 - std::cos(radius.asRadians()));
+    return _impl->toIndices(findMatches(*_impl->sky, getSkyPoints(catalog), d2Limit, mc), skyDistance);
+}
+
+template <typename RecordT>
+std::vector<Match<SourceRecord, RecordT>> MatchIndex<RecordT>::matchXy(SourceCatalog const &catalog,
+                                                                       double radius,
+                                                                       MatchControl const &mc) const {
+    _impl->checkXy();
+    auto const found = findMatches(*_impl->xy, getXyPoints(catalog), radius * radius, mc);
+    return _impl->template toMatches<SourceRecord>(catalog, found, xyDistance);
+}
+
+template <typename RecordT>
+MatchIndices MatchIndex<RecordT>::matchXyIndices(SourceCatalog const &catalog, double radius,
+                                                 MatchControl const &mc) const {
+    _impl->checkXy();
+    return _impl->toIndices(findMatches(*_impl->xy, getXyPoints(catalog), radius * radius, mc), xyDistance);
+}
+
+#define LSST_MATCH_INDEX(RECORD, CAT)                                                                   \
+    template std::vector<Match<CAT::Record, RECORD>> MatchIndex<RECORD>::matchRaDec(                   \
+            CAT const &, lsst::geom::Angle, MatchControl const &) const;                              \
+    template MatchIndices MatchIndex<RECORD>::matchRaDecIndices(CAT const &, lsst::geom::Angle,       \
+                                                                 MatchControl const &) const
+
+template class MatchIndex<SimpleRecord>;
+template class MatchIndex<SourceRecord>;
+
+LSST_MATCH_INDEX(SimpleRecord, SimpleCatalog);
+LSST_MATCH_INDEX(SimpleRecord, SourceCatalog);
+LSST_MATCH_INDEX(SourceRecord, SimpleCatalog);
+LSST_MATCH_INDEX(SourceRecord, SourceCatalog);
+
+#undef LSST_MATCH_INDEX
+
+template <typename Cat1, typename Cat2>
+MatchIndices matchRaDecIndices(Cat1 const &cat1, Cat2 const &cat2, lsst::geom::Angle radius,
+                               MatchControl const &mc) {
+    if constexpr (std::is_same_v<Cat1, Cat2>) {
+        if (&cat1 == &cat2) {
+            return matchRaDecIndices(cat1, radius, mc);
+        }
+    }
+    checkSkyRadius(radius);
+    return MatchIndex<typename Cat2::Record>::makeSky(cat2).matchRaDecIndices(cat1, radius, mc);
+}
+
+template <typename Cat>
+MatchIndices matchRaDecIndices(Cat const &cat, lsst::geom::Angle radius, MatchControl const &mc) {
+    checkSkyRadius(radius);
+    auto const index = MatchIndex<typename Cat::Record>::makeSky(cat);
+    return selectSelfMatches(index.matchRaDecIndices(cat, radius, allPairs(mc)), mc.symmetricMatch);
+}
+
+MatchIndices matchXyIndices(SourceCatalog const &cat1, SourceCatalog const &cat2, double radius,
+                            MatchControl const &mc) {
+    if (&cat1 == &cat2) {
+        return matchXyIndices(cat1, radius, mc);
+    }
+    return MatchIndex<SourceRecord>::makeXy(cat2).matchXyIndices(cat1, radius, mc);
+}
+
+MatchIndices matchXyIndices(SourceCatalog const &cat, double radius, MatchControl const &mc) {
+    auto const index = MatchIndex<SourceRecord>::makeXy(cat);
+    return selectSelfMatches(index.matchXyIndices(cat, radius, allPairs(mc)), mc.symmetricMatch);
+}
+
+template MatchIndices matchRaDecIndices(SimpleCatalog const &, SimpleCatalog const &, lsst::geom::Angle,
+                                        MatchControl const &);
+template MatchIndices matchRaDecIndices(SimpleCatalog const &, SourceCatalog const &, lsst::geom::Angle,
+                                        MatchControl const &);
+template MatchIndices matchRaDecIndices(SourceCatalog const &, SourceCatalog const &, lsst::geom::Angle,
+                                        MatchControl const &);
+template MatchIndices matchRaDecIndices(SimpleCatalog const &, lsst::geom::Angle, MatchControl const &);
+template MatchIndices matchRaDecIndices(SourceCatalog const &, lsst::geom::Angle, MatchControl const &);
+
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
@@ -90,8 +90,8 @@ namespace detail {
 
 template <typename T>
 SchemaItem<T> SchemaImpl::find(std::string const &name) const {
-    NameMap::const_iterator i = _names.lower_bound(name);
-    if (i != _names.end() && i->first == name) {
+    NameIndex::const_iterator i = _nameIndex.find(name);
+    if (i != _nameIndex.end()) {
         // got an exact match; we're done if it has the right type, and dead if it doesn't.
         try {
             return std::get<SchemaItem<T>>(_items[i->second]);
@@ -214,6 +214,8 @@ void SchemaImpl::replaceField(Key<T> const &key, Field<T> const &field) {
         }
         j = _names.find(item->field.getName());
         _names.insert(j, std::pair<std::string, std::size_t>(field.getName(), j->second));
+        _nameIndex.erase(j->first);
+        _nameIndex.emplace(field.getName(), j->second);
         _names.erase(j);
     }
     item->field = field;
@@ -359,6 +361,7 @@ Key<Flag> SchemaImpl::addField(Field<Flag> const &field, bool doReplace) {
         ++_lastFlagBit;
         _flags.insert(std::pair<std::pair<size_t, size_t>, size_t>(
                 std::make_pair(item.key.getOffset(), item.key.getBit()), _items.size()));
+        _nameIndex.emplace(field.getName(), _items.size());
         _items.push_back(item);
         return item.key;
     }
@@ -404,6 +407,7 @@ Key<T> SchemaImpl::addFieldImpl(std::size_t elementSize, std::size_t elementCoun
         SchemaItem<T> item(detail::Access::makeKey(field, _recordSize), field);
         _recordSize += elementCount * elementSize;
         _offsets.insert(std::pair<std::size_t, std::size_t>(item.key.getOffset(), _items.size()));
+        _nameIndex.emplace(field.getName(), _items.size());
         _items.push_back(item);
         return item.key;
     }
@@ -465,9 +469,8 @@ std::set<std::string> Schema::getNames(bool topOnly) const { return _impl->getNa
 
 template <typename T>
 SchemaItem<T> Schema::find(std::string const &name) const {
-    std::string tmp(name);
-    _aliases->_apply(tmp);
-    return _impl->find<T>(tmp);
+    std::string buffer;
+    return _impl->find<T>(*_aliases->_applyCached(name, buffer));
 }
 
 template <typename T>
@@ -582,7 +585,13 @@ SubSchema::SubSchema(std::shared_ptr<Impl> impl, std::shared_ptr<AliasMap> alias
 
 template <typename T>
 SchemaItem<T> SubSchema::find(std::string const &name) const {
-    return _impl->find<T>(_aliases->apply(join(_name, name)));
+    // Reuse one buffer per thread for the full name, so repeated lookups don't allocate.
+    thread_local std::string fullName;
+    fullName.assign(_name);
+    fullName.push_back(getDelimiter());
+    fullName += name;
+    std::string buffer;
+    return _impl->find<T>(*_aliases->_applyCached(fullName, buffer));
 }
 
 SubSchema SubSchema::operator[](std::string const &name) const {
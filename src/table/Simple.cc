@@ -25,6 +25,7 @@ public:
 
 protected:
     void _writeTable(std::shared_ptr<BaseTable const> const& table, std::size_t nRows) override;
+    bool _writesRecordsUnchanged() const override { return true; }
 };
 
 void SimpleFitsWriter::_writeTable(std::shared_ptr<BaseTable const> const& t, std::size_t nRows) {
@@ -55,6 +56,7 @@ public:
     std::shared_ptr<BaseTable> makeTable(io::FitsSchemaInputMapper& mapper,
                                          std::shared_ptr<daf::base::PropertyList> metadata, int ioFlags,
                                          bool stripMetadata) const override {
+        mapper.require(SimpleTable::makeMinimalSchema());
         std::shared_ptr<SimpleTable> table = SimpleTable::make(mapper.finalize());
         table->setMetadata(metadata);
         return table;
@@ -0,0 +1,90 @@
+// -*- lsst-c++ -*-
+
+#include <cmath>
+#include <numeric>
+
+#include "lsst/sphgeom/LonLat.h"
+#include "lsst/sphgeom/UnitVector3d.h"
+#include "lsst/afw/math/detail/Parallel.h"
+#include "lsst/afw/table/Simple.h"
+#include "lsst/afw/table/Source.h"
+#include "lsst/afw/table/SortKey.h"
+#include "lsst/afw/table/SkyPixels.h"
+
+namespace lsst {
+namespace afw {
+namespace table {
+
+template <typename RecordT>
+ndarray::Array<std::uint64_t, 1, 1> computeSkyPixels(CatalogT<RecordT> const &catalog,
+                                                     sphgeom::Pixelization const &pixelization,
+                                                     int numThreads) {
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    Key<lsst::geom::Angle> const raKey = SimpleTable::getCoordKey().getRa();
+    Key<lsst::geom::Angle> const decKey = SimpleTable::getCoordKey().getDec();
+    ndarray::Array<std::uint64_t, 1, 1> result = ndarray::allocate(catalog.size());
+    std::uint64_t *pixels = result.getData();
+    auto const pieces = math::detail::splitRange(0, static_cast<int>(catalog.size()), nThreads);
+    math::detail::parallelFor(static_cast<int>(pieces.size()), nThreads, [&](int i) {
+        for (int k = pieces[i].first; k < pieces[i].second; ++k) {
+            double const ra = catalog[k].get(raKey).asRadians();
+            double const dec = catalog[k].get(decKey).asRadians();
+            if (std::isfinite(ra) && std::isfinite(dec)) {
+                sphgeom::UnitVector3d const v(sphgeom::LonLat::fromRadians(ra, dec));
+                pixels[k] = pixelization.index(v);
+            } else {
+                pixels[k] = NO_SKY_PIXEL;
+            }
+        }
+    });
+    return result;
+}
+
+std::vector<SkyPixelRange> findSkyPixelRanges(ndarray::Array<std::uint64_t const, 1, 1> const &pixels) {
+    std::vector<SkyPixelRange> result;
+    std::size_t const n = pixels.getSize<0>();
+    for (std::size_t begin = 0, end = 0; begin < n; begin = end) {
+        for (end = begin + 1; end < n && pixels[end] == pixels[begin]; ++end) {
+        }
+        result.push_back(SkyPixelRange{pixels[begin], begin, end});
+    }
+    return result;
+}
+
+template <typename RecordT>
+std::vector<SkyPixelRange> sortBySkyPixel(CatalogT<RecordT> &catalog,
+                                          sphgeom::Pixelization const &pixelization, int numThreads) {
+    int const nThreads = math::detail::resolveNumThreads(numThreads);
+    ndarray::Array<std::uint64_t const, 1, 1> const pixels =
+            computeSkyPixels(catalog, pixelization, nThreads);
+    std::vector<std::size_t> order(catalog.size());
+    std::iota(order.begin(), order.end(), 0);
+    detail::stableSortOrder<std::uint64_t>(order, [&pixels](std::size_t i) { return pixels[i]; }, nThreads);
+    auto &internal = catalog.getInternal();
+    typename CatalogT<RecordT>::Internal permuted;
+    permuted.reserve(order.size());
+    ndarray::Array<std::uint64_t, 1, 1> sorted = ndarray::allocate(order.size());
+    for (std::size_t k = 0; k < order.size(); ++k) {
+        permuted.push_back(internal[order[k]]);
+        sorted[k] = pixels[order[k]];
+    }
+    internal.swap(permuted);
+    return findSkyPixelRanges(sorted);
+}
+
+//
+// Explicit instantiations
+//
+#define INSTANTIATE(RECORD)                                                                          \
+    template ndarray::Array<std::uint64_t, 1, 1> computeSkyPixels(CatalogT<RECORD> const &,         \
+                                                                  sphgeom::Pixelization const &,   \
+                                                                  int);                            \
+    template std::vector<SkyPixelRange> sortBySkyPixel(CatalogT<RECORD> &, sphgeom::Pixelization const &, \
+                                                       int);
+
+INSTANTIATE(SimpleRecord)
+INSTANTIATE(SourceRecord)
+
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
@@ -57,6 +57,9 @@ protected:
 
     void _writeRecord(BaseRecord const &record) override;
 
+    // Without Footprints, records are written as they are
+    bool _writesRecordsUnchanged() const override { return _flags & SOURCE_IO_NO_FOOTPRINTS; }
+
     void _finish() override {
         if (!(_flags & SOURCE_IO_NO_FOOTPRINTS)) {
             _archive.writeFits(*_fits);
@@ -346,6 +349,7 @@ public:
         // Look for new-style persistence of Footprints.  We'll only read them if we have an archive,
         // but we'll strip fields out regardless.
         SourceFootprintReader::setup(mapper, ioFlags);
+        mapper.require(SourceTable::makeMinimalSchema());
         std::shared_ptr<SourceTable> table = SourceTable::make(mapper.finalize());
         table->setMetadata(metadata);
         return table;
@@ -21,15 +21,65 @@
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "lsst/afw/geom/ellipses/Quadrupole.h"
 #include "lsst/geom/Box.h"
 #include "lsst/afw/table/aggregates.h"
 #include "lsst/afw/table/BaseRecord.h"
+#include "lsst/afw/table/BaseColumnView.h"
 
 namespace lsst {
 namespace afw {
 namespace table {
 
+namespace {
+
+// A scalar column of a contiguous catalog, looked up once so the batch accessors below can address
+// the record data directly.
+template <typename T>
+struct Column {
+    Column() = default;
+
+    Column(BaseColumnView const &columns, Key<T> const &key) {
+        ndarray::ArrayRef<T, 1> array = columns[key];
+        data = array.getData();
+        stride = array.template getStride<0>();
+        size = array.template getSize<0>();
+    }
+
+    T &operator[](std::size_t i) const { return data[i * stride]; }
+
+    T *data = nullptr;
+    std::ptrdiff_t stride = 0;
+    std::size_t size = 0;
+};
+
+// Look up the columns of a list of keys; invalid keys give null columns
+template <typename T>
+std::vector<Column<T>> getColumnList(BaseColumnView const &columns, std::vector<Key<T>> const &keys) {
+    std::vector<Column<T>> result(keys.size());
+    for (std::size_t k = 0; k < keys.size(); ++k) {
+        if (keys[k].isValid()) result[k] = Column<T>(columns, keys[k]);
+    }
+    return result;
+}
+
+// Check that a batch of values has one row of nValues values for each of nRecords records
+template <typename T, int N, int C>
+void checkColumnsShape(ndarray::Array<T, N, C> const &values, std::size_t nRecords, std::size_t nValues) {
+    LSST_THROW_IF_NE(values.template getSize<0>(), nRecords, pex::exceptions::LengthError,
+                     "Number of rows (%d) does not match the number of records (%d)");
+    for (int d = 1; d < N; ++d) {
+        LSST_THROW_IF_NE(values.getShape()[d], nValues, pex::exceptions::LengthError,
+                         "Size of values dimension (%d) does not match the number of fields (%d)");
+    }
+}
+
+}  // namespace
+
 //============ PointKey =====================================================================================
 
 template <typename T>
@@ -121,6 +171,27 @@ void CoordKey::set(BaseRecord &record, lsst::geom::SpherePoint const &value) con
     record.set(_dec, value.getLatitude());
 }
 
+ndarray::Array<double, 2, 2> CoordKey::getColumns(BaseColumnView const &columns) const {
+    Column<lsst::geom::Angle> ra(columns, _ra), dec(columns, _dec);
+    ndarray::Array<double, 2, 2> result = ndarray::allocate(ra.size, 2);
+    double *out = result.getData();
+    for (std::size_t i = 0; i < ra.size; ++i, out += 2) {
+        out[0] = ra[i].asRadians();
+        out[1] = dec[i].asRadians();
+    }
+    return result;
+}
+
+void CoordKey::setColumns(BaseColumnView const &columns,
+                          ndarray::Array<double const, 2> const &values) const {
+    Column<lsst::geom::Angle> ra(columns, _ra), dec(columns, _dec);
+    checkColumnsShape(values, ra.size, 2);
+    for (std::size_t i = 0; i < ra.size; ++i) {
+        ra[i] = values[i][0] * lsst::geom::radians;
+        dec[i] = values[i][1] * lsst::geom::radians;
+    }
+}
+
 CoordKey::ErrorKey CoordKey::getErrorKey(Schema const & schema) {
     return ErrorKey(schema["coord"], {"ra", "dec"});
 }
@@ -151,6 +222,29 @@ void QuadrupoleKey::set(BaseRecord &record, geom::ellipses::Quadrupole const &va
     record.set(_ixy, value.getIxy());
 }
 
+ndarray::Array<double, 2, 2> QuadrupoleKey::getColumns(BaseColumnView const &columns) const {
+    Column<double> ixx(columns, _ixx), iyy(columns, _iyy), ixy(columns, _ixy);
+    ndarray::Array<double, 2, 2> result = ndarray::allocate(ixx.size, 3);
+    double *out = result.getData();
+    for (std::size_t i = 0; i < ixx.size; ++i, out += 3) {
+        out[0] = ixx[i];
+        out[1] = iyy[i];
+        out[2] = ixy[i];
+    }
+    return result;
+}
+
+void QuadrupoleKey::setColumns(BaseColumnView const &columns,
+                               ndarray::Array<double const, 2> const &values) const {
+    Column<double> ixx(columns, _ixx), iyy(columns, _iyy), ixy(columns, _ixy);
+    checkColumnsShape(values, ixx.size, 3);
+    for (std::size_t i = 0; i < ixx.size; ++i) {
+        ixx[i] = values[i][0];
+        iyy[i] = values[i][1];
+        ixy[i] = values[i][2];
+    }
+}
+
 //============ EllipseKey ================================================================================
 
 EllipseKey EllipseKey::addFields(Schema &schema, std::string const &name, std::string const &doc,
@@ -169,6 +263,31 @@ void EllipseKey::set(BaseRecord &record, geom::ellipses::Ellipse const &value) c
     _pKey.set(record, value.getCenter());
 }
 
+ndarray::Array<double, 2, 2> EllipseKey::getColumns(BaseColumnView const &columns) const {
+    ndarray::Array<double, 2, 2> core = _qKey.getColumns(columns);
+    Column<double> x(columns, _pKey.getX()), y(columns, _pKey.getY());
+    ndarray::Array<double, 2, 2> result = ndarray::allocate(x.size, 5);
+    double const *in = core.getData();
+    double *out = result.getData();
+    for (std::size_t i = 0; i < x.size; ++i, in += 3, out += 5) {
+        std::copy(in, in + 3, out);
+        out[3] = x[i];
+        out[4] = y[i];
+    }
+    return result;
+}
+
+void EllipseKey::setColumns(BaseColumnView const &columns,
+                            ndarray::Array<double const, 2> const &values) const {
+    Column<double> x(columns, _pKey.getX()), y(columns, _pKey.getY());
+    checkColumnsShape(values, x.size, 5);
+    _qKey.setColumns(columns, values[ndarray::view()(0, 3)]);
+    for (std::size_t i = 0; i < x.size; ++i) {
+        x[i] = values[i][3];
+        y[i] = values[i][4];
+    }
+}
+
 //============ CovarianceMatrixKey ==========================================================================
 
 template <typename T, int N>
@@ -401,6 +520,56 @@ void CovarianceMatrixKey<T, N>::setElement(BaseRecord &record, int i, int j, T v
     }
 }
 
+template <typename T, int N>
+ndarray::Array<T, 3, 3> CovarianceMatrixKey<T, N>::getColumns(BaseColumnView const &columns) const {
+    int const n = _err.size();
+    std::vector<Column<T>> err = getColumnList(columns, _err);
+    std::vector<Column<T>> cov = getColumnList(columns, _cov);
+    std::size_t const nRecords = n > 0 ? err.front().size : 0;
+    ndarray::Array<T, 3, 3> result = ndarray::allocate(nRecords, n, n);
+    T *out = result.getData();
+    std::fill_n(out, result.getNumElements(), T(0));
+    for (std::size_t r = 0; r < nRecords; ++r, out += n * n) {
+        int k = 0;
+        for (int i = 0; i < n; ++i) {
+            T const e = err[i][r];
+            out[i * n + i] = e * e;
+            if (!cov.empty()) {
+                for (int j = 0; j < i; ++j, ++k) {
+                    if (cov[k].data) {
+                        out[i * n + j] = out[j * n + i] = cov[k][r];
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+template <typename T, int N>
+void CovarianceMatrixKey<T, N>::setColumns(BaseColumnView const &columns,
+                                           ndarray::Array<T const, 3> const &values) const {
+    int const n = _err.size();
+    std::vector<Column<T>> err = getColumnList(columns, _err);
+    std::vector<Column<T>> cov = getColumnList(columns, _cov);
+    std::size_t const nRecords = n > 0 ? err.front().size : 0;
+    checkColumnsShape(values, nRecords, n);
+    for (std::size_t r = 0; r < nRecords; ++r) {
+        auto const matrix = values[r];
+        int k = 0;
+        for (int i = 0; i < n; ++i) {
+            err[i][r] = std::sqrt(matrix[i][i]);
+            if (!cov.empty()) {
+                for (int j = 0; j < i; ++j, ++k) {
+                    if (cov[k].data) {
+                        cov[k][r] = matrix[i][j];
+                    }
+                }
+            }
+        }
+    }
+}
+
 template class CovarianceMatrixKey<float, 2>;
 template class CovarianceMatrixKey<float, 3>;
 template class CovarianceMatrixKey<float, 4>;
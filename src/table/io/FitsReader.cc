@@ -1,5 +1,7 @@
 // -*- lsst-c++ -*-
 
+#include <type_traits>
+
 #include "lsst/afw/table/io/FitsReader.h"
 
 namespace lsst {
@@ -19,8 +21,95 @@ Registry& getRegistry() {
 static FitsReader const baseFitsReader("BASE");
 static FitsReader const ampInfoFitsReader("AMPINFO");
 
+enum class Comparison { EQUAL, NOT_EQUAL, LESS, LESS_EQUAL, GREATER, GREATER_EQUAL };
+
+Comparison parseComparison(std::string const& comparison) {
+    if (comparison == "==") return Comparison::EQUAL;
+    if (comparison == "!=") return Comparison::NOT_EQUAL;
+    if (comparison == "<") return Comparison::LESS;
+    if (comparison == "<=") return Comparison::LESS_EQUAL;
+    if (comparison == ">") return Comparison::GREATER;
+    if (comparison == ">=") return Comparison::GREATER_EQUAL;
+    throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                      (boost::format("Unrecognized comparison '%s'") % comparison).str());
+}
+
+void checkRowRange(std::size_t begin, std::size_t end) {
+    if (end < begin) {
+        throw LSST_EXCEPT(pex::exceptions::InvalidParameterError,
+                          (boost::format("Row range [%d, %d) is reversed") % begin % end).str());
+    }
+}
+
+template <typename T>
+bool compare(T lhs, Comparison comparison, double rhs) {
+    switch (comparison) {
+        case Comparison::EQUAL:
+            return lhs == rhs;
+        case Comparison::NOT_EQUAL:
+            return lhs != rhs;
+        case Comparison::LESS:
+            return lhs < rhs;
+        case Comparison::LESS_EQUAL:
+            return lhs <= rhs;
+        case Comparison::GREATER:
+            return lhs > rhs;
+        case Comparison::GREATER_EQUAL:
+            return lhs >= rhs;
+    }
+    return false;
+}
+
+// Functor for Schema::findAndApply that makes the test for a FitsRowFilter's comparison.
+struct MakeTest {
+    template <typename T>
+    void operator()(SchemaItem<T> const& item) const {
+        if constexpr (std::is_arithmetic_v<T>) {
+            test = [key = item.key, comparison = comparison, value = value](BaseRecord const& record) {
+                return compare(record.get(key), comparison, value);
+            };
+        } else if constexpr (std::is_same_v<T, lsst::geom::Angle>) {
+            test = [key = item.key, comparison = comparison, value = value](BaseRecord const& record) {
+                return compare(record.get(key).asRadians(), comparison, value);
+            };
+        } else if constexpr (std::is_same_v<T, Flag>) {
+            test = [key = item.key, comparison = comparison, value = value](BaseRecord const& record) {
+                return compare(record.get(key) ? 1 : 0, comparison, value);
+            };
+        } else {
+            throw LSST_EXCEPT(
+                    pex::exceptions::TypeError,
+                    (boost::format("Cannot filter rows on field '%s' of type %s") % item.field.getName() %
+                     item.field.getTypeString())
+                            .str());
+        }
+    }
+
+    Comparison comparison;
+    double value;
+    mutable std::function<bool(BaseRecord const&)> test;
+};
+
 }  // namespace
 
+FitsRowFilter::FitsRowFilter(std::size_t begin, std::size_t end)
+        : _begin(begin), _end(end), _value(0.0) {
+    checkRowRange(begin, end);
+}
+
+FitsRowFilter::FitsRowFilter(std::string const& field, std::string const& comparison, double value,
+                             std::size_t begin, std::size_t end)
+        : _begin(begin), _end(end), _field(field), _comparison(comparison), _value(value) {
+    checkRowRange(begin, end);
+    parseComparison(comparison);
+}
+
+std::function<bool(BaseRecord const&)> FitsRowFilter::makeTest(Schema const& schema) const {
+    MakeTest functor{parseComparison(_comparison), _value, {}};
+    schema.findAndApply(_field, functor);
+    return functor.test;
+}
+
 std::shared_ptr<BaseTable> FitsReader::makeTable(FitsSchemaInputMapper& mapper,
                                                  std::shared_ptr<daf::base::PropertyList> metadata,
                                                  int ioFlags, bool stripMetadata) const {
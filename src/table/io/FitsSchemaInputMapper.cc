@@ -3,10 +3,13 @@
 #include <array>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <string>
+#include <type_traits>
 #include <algorithm>
 #include <cctype>
 #include <regex>
+#include <set>
 
 #include "boost/multi_index_container.hpp"
 #include "boost/multi_index/sequenced_index.hpp"
@@ -18,6 +21,8 @@
 #include "lsst/geom.h"
 #include "lsst/afw/table/io/FitsSchemaInputMapper.h"
 #include "lsst/afw/table/aggregates.h"
+#include "lsst/afw/math/Instrumentation.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace lsst {
 namespace afw {
@@ -81,10 +86,14 @@ public:
     std::unique_ptr<bool[]> flagWorkspace;
     std::shared_ptr<io::InputArchive> archive;
     InputContainer inputs;
+    std::set<std::string> selected;  // ttypes of the regular fields to read; empty to read them all
     std::size_t nRowsToPrep = 1;
 };
 
 std::size_t FitsSchemaInputMapper::PREPPED_ROWS_FACTOR = 1 << 15;  // determined empirically; see DM-19461.
+std::size_t FitsSchemaInputMapper::READ_CHUNK_BYTES = 1 << 24;
+int FitsSchemaInputMapper::READ_THREADS = 1;
+bool FitsSchemaInputMapper::MAP_ROWS = false;
 
 FitsSchemaInputMapper::FitsSchemaInputMapper(daf::base::PropertyList &metadata, bool stripMetadata)
         : _impl(std::make_shared<Impl>()) {
@@ -312,6 +321,8 @@ bool FitsSchemaInputMapper::readArchive(afw::fits::Fits &fits) {
 
 bool FitsSchemaInputMapper::hasArchive() const { return static_cast<bool>(_impl->archive); }
 
+std::shared_ptr<InputArchive> FitsSchemaInputMapper::getArchive() const { return _impl->archive; }
+
 FitsSchemaItem const *FitsSchemaInputMapper::find(std::string const &ttype) const {
     auto iter = _impl->byName().find(ttype);
     if (iter == _impl->byName().end()) {
@@ -356,6 +367,65 @@ void FitsSchemaInputMapper::customize(std::unique_ptr<FitsColumnReader> reader)
 
 namespace {
 
+// Unsigned integers of each size, for reassembling big-endian values from raw FITS bytes.
+template <std::size_t N>
+struct UnsignedBits;
+template <>
+struct UnsignedBits<1> {
+    using Type = std::uint8_t;
+};
+template <>
+struct UnsignedBits<2> {
+    using Type = std::uint16_t;
+};
+template <>
+struct UnsignedBits<4> {
+    using Type = std::uint32_t;
+};
+template <>
+struct UnsignedBits<8> {
+    using Type = std::uint64_t;
+};
+
+// Return true if nElements values of type T per row can be decoded directly from a column stored
+// with the given layout.  FITS stores unsigned integers wider than a byte (and signed bytes) offset
+// by TZERO = +/- 2^(N-1); flipSign is set if the most significant bit must be flipped to undo that.
+// Columns stored any other way are left to CFITSIO.
+template <typename T>
+bool canDecode(fits::TableColumnLayout const &column, std::size_t nElements, bool &flipSign) {
+    flipSign = false;
+    if (!std::is_arithmetic<T>::value || column.size != nElements * sizeof(T) || column.scale != 1.0) {
+        return false;
+    }
+    if (std::is_floating_point<T>::value) {
+        return column.zero == 0.0;
+    }
+    bool const signedStorage = sizeof(T) > 1;  // FITS integers are signed, except for bytes
+    if (column.zero == 0.0) {
+        return std::is_signed<T>::value == signedStorage;
+    }
+    double const offset = std::ldexp(1.0, 8 * sizeof(T) - 1);
+    flipSign = true;
+    return std::is_signed<T>::value ? (!signedStorage && column.zero == -offset)
+                                    : (signedStorage && column.zero == offset);
+}
+
+// Decode one big-endian value, as checked by canDecode.
+template <typename T>
+T decodeValue(unsigned char const *bytes, bool flipSign) {
+    using Bits = typename UnsignedBits<sizeof(T)>::Type;
+    Bits bits = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        bits = static_cast<Bits>((bits << 8) | bytes[i]);
+    }
+    if (flipSign) {
+        bits ^= static_cast<Bits>(Bits(1) << (8 * sizeof(T) - 1));
+    }
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
 template <typename T>
 class StandardReader : public FitsColumnReader {
 public:
@@ -393,6 +463,34 @@ public:
         }
     }
 
+    Decoder makeDecoder(fits::TableLayout const &layout) const override {
+        using Element = typename FieldBase<T>::Element;
+        std::size_t const nElements = _key.getElementCount();
+        bool flipSign = false;
+        if (!canDecode<Element>(layout.columns[_column], nElements, flipSign)) {
+            return Decoder();
+        }
+        std::size_t const offset = layout.columns[_column].offset;
+        Key<T> const key = _key;
+        return [key, offset, nElements, flipSign](BaseRecord *const *records, std::size_t nRows,
+                                                  unsigned char const *rows, std::size_t rowWidth) {
+            for (std::size_t i = 0; i < nRows; ++i) {
+                unsigned char const *bytes = rows + i * rowWidth + offset;
+                Element *values = records[i]->getElement(key);
+                for (std::size_t j = 0; j < nElements; ++j) {
+                    values[j] = decodeValue<Element>(bytes + j * sizeof(Element), flipSign);
+                }
+            }
+        };
+    }
+
+    bool decodesInPlace(fits::TableLayout const &layout) const override {
+        bool flipSign = false;
+        return canDecode<typename FieldBase<T>::Element>(layout.columns[_column], _key.getElementCount(),
+                                                         flipSign) &&
+               layout.columns[_column].offset == _key.getOffset();
+    }
+
 private:
     int _column;
     Key<T> _key;
@@ -442,6 +540,28 @@ public:
         }
     }
 
+    Decoder makeDecoder(fits::TableLayout const &layout) const override {
+        bool flipSign = false;
+        if (!canDecode<double>(layout.columns[_column], 1, flipSign)) {
+            return Decoder();
+        }
+        std::size_t const offset = layout.columns[_column].offset;
+        Key<lsst::geom::Angle> const key = _key;
+        return [key, offset](BaseRecord *const *records, std::size_t nRows, unsigned char const *rows,
+                             std::size_t rowWidth) {
+            for (std::size_t i = 0; i < nRows; ++i) {
+                double const value = decodeValue<double>(rows + i * rowWidth + offset, false);
+                records[i]->set(key, value * lsst::geom::radians);
+            }
+        };
+    }
+
+    bool decodesInPlace(fits::TableLayout const &layout) const override {
+        bool flipSign = false;
+        return canDecode<double>(layout.columns[_column], 1, flipSign) &&
+               layout.columns[_column].offset == _key.getOffset();
+    }
+
 private:
     int _column;
     Key<lsst::geom::Angle> _key;
@@ -768,6 +888,28 @@ std::string replace(std::string full, std::string const & from, std::string cons
 
 }  // namespace
 
+void FitsSchemaInputMapper::select(std::vector<std::string> const &names) {
+    for (auto const &name : names) {
+        std::string const ttype = _impl->schema.getAliasMap()->apply(name);
+        if (_impl->byName().find(ttype) == _impl->byName().end()) {
+            throw LSST_EXCEPT(pex::exceptions::NotFoundError,
+                              (boost::format("No column named '%s' to select") % name).str());
+        }
+        _impl->selected.insert(ttype);
+    }
+}
+
+void FitsSchemaInputMapper::require(Schema const &schema) {
+    if (_impl->selected.empty()) {
+        return;
+    }
+    for (auto const &name : schema.getNames()) {
+        if (_impl->byName().find(name) != _impl->byName().end()) {
+            _impl->selected.insert(name);
+        }
+    }
+}
+
 Schema FitsSchemaInputMapper::finalize() {
     if (_impl->version == 0) {
         AliasMap &aliases = *_impl->schema.getAliasMap();
@@ -835,6 +977,9 @@ Schema FitsSchemaInputMapper::finalize() {
         }
     }
     for (auto iter = _impl->asList().begin(); iter != _impl->asList().end(); ++iter) {
+        if (!_impl->selected.empty() && _impl->selected.count(iter->ttype) == 0) {
+            continue;
+        }
         if (iter->bit < 0) {  // not a Flag column
             std::unique_ptr<FitsColumnReader> reader = makeColumnReader(_impl->schema, *iter);
             if (reader) {
@@ -855,6 +1000,10 @@ Schema FitsSchemaInputMapper::finalize() {
         }
     }
     _impl->asList().clear();
+    if (std::none_of(_impl->flagKeys.begin(), _impl->flagKeys.end(),
+                     [](Key<Flag> const &key) { return key.isValid(); })) {
+        _impl->flagKeys.clear();  // no flags were selected
+    }
     if (_impl->schema.getRecordSize() <= 0) {
         throw LSST_EXCEPT(
             pex::exceptions::LengthError,
@@ -870,7 +1019,9 @@ void FitsSchemaInputMapper::readRecord(BaseRecord &record, afw::fits::Fits &fits
     if (!_impl->flagKeys.empty()) {
         fits.readTableArray<bool>(row, _impl->flagColumn, _impl->flagKeys.size(), _impl->flagWorkspace.get());
         for (std::size_t bit = 0; bit < _impl->flagKeys.size(); ++bit) {
-            record.set(_impl->flagKeys[bit], _impl->flagWorkspace[bit]);
+            if (_impl->flagKeys[bit].isValid()) {
+                record.set(_impl->flagKeys[bit], _impl->flagWorkspace[bit]);
+            }
         }
     }
     if (_impl->nRowsToPrep != 1 && row % _impl->nRowsToPrep == 0) {
@@ -885,6 +1036,149 @@ void FitsSchemaInputMapper::readRecord(BaseRecord &record, afw::fits::Fits &fits
         reader->readCell(record, row, fits, _impl->archive);
     }
 }
+
+namespace {
+
+// readRecords() decodes blocks of rows of about this many bytes a column at a time, so that the
+// rows being decoded and the records being filled stay in cache while every column is visited.
+std::size_t const DECODE_BLOCK_BYTES = 1 << 16;
+
+}  // namespace
+
+void FitsSchemaInputMapper::readRecords(std::vector<BaseRecord *> const &records, afw::fits::Fits &fits,
+                                        std::size_t firstRow) {
+    LSST_AFW_INSTRUMENT_SCOPE("fits.readTable");
+    int const nThreads = math::detail::resolveNumThreads(READ_THREADS);
+    if (records.empty()) {
+        return;
+    }
+    afw::fits::TableLayout const layout = fits.getTableLayout();
+    std::vector<FitsColumnReader::Decoder> decoders;
+    if (!_impl->flagKeys.empty()) {
+        std::size_t const offset = layout.columns[_impl->flagColumn].offset;
+        // Bits are packed most significant first.
+        decoders.push_back([flagKeys = _impl->flagKeys, offset](BaseRecord *const *records,
+                                                                std::size_t nRows, unsigned char const *rows,
+                                                                std::size_t rowWidth) {
+            for (std::size_t i = 0; i < nRows; ++i) {
+                unsigned char const *bytes = rows + i * rowWidth + offset;
+                for (std::size_t bit = 0; bit < flagKeys.size(); ++bit) {
+                    if (flagKeys[bit].isValid()) {
+                        bool const value = (bytes[bit >> 3] >> (7 - (bit & 7))) & 1;
+                        records[i]->set(flagKeys[bit], value);
+                    }
+                }
+            }
+        });
+    }
+    std::vector<FitsColumnReader *> cellReaders;
+    for (auto const &reader : _impl->readers) {
+        auto decoder = reader->makeDecoder(layout);
+        if (decoder) {
+            decoders.push_back(std::move(decoder));
+        } else {
+            cellReaders.push_back(reader.get());
+        }
+    }
+
+    std::size_t const rowWidth = std::max(layout.rowWidth, std::size_t(1));
+    std::size_t const chunkRows = std::max(READ_CHUNK_BYTES / rowWidth, std::size_t(1));
+    std::size_t const blockRows = std::max(DECODE_BLOCK_BYTES / rowWidth, std::size_t(1));
+    std::vector<unsigned char> buffer;
+    if (!decoders.empty()) {
+        buffer.resize(std::min(chunkRows, records.size()) * rowWidth);
+    }
+    for (std::size_t begin = 0; begin < records.size(); begin += chunkRows) {
+        std::size_t const nRows = std::min(chunkRows, records.size() - begin);
+        std::size_t const chunkFirstRow = firstRow + begin;
+        if (!decoders.empty()) {
+            fits.readTableBytes(chunkFirstRow, nRows, buffer.data());
+            int const nBlocks = (nRows + blockRows - 1) / blockRows;
+            math::detail::parallelFor(nBlocks, nThreads, [&](int iBlock) {
+                std::size_t const blockBegin = iBlock * blockRows;
+                std::size_t const blockSize = std::min(blockRows, nRows - blockBegin);
+                for (auto const &decoder : decoders) {
+                    decoder(records.data() + begin + blockBegin, blockSize,
+                            buffer.data() + blockBegin * rowWidth, rowWidth);
+                }
+            });
+        }
+        if (cellReaders.empty()) {
+            continue;
+        }
+        for (std::size_t i = 0; i < nRows; ++i) {
+            std::size_t const row = chunkFirstRow + i;
+            if (_impl->nRowsToPrep != 1 && i % _impl->nRowsToPrep == 0) {
+                std::size_t const size = std::min(_impl->nRowsToPrep, nRows - i);
+                for (auto reader : cellReaders) {
+                    reader->prepRead(row, size, fits);
+                }
+            }
+            for (auto reader : cellReaders) {
+                reader->readCell(*records[begin + i], row, fits, _impl->archive);
+            }
+        }
+    }
+}
+
+std::vector<std::shared_ptr<BaseRecord>> FitsSchemaInputMapper::mapRecords(BaseTable &table,
+                                                                           afw::fits::Fits &fits,
+                                                                           std::size_t firstRow,
+                                                                           std::size_t nRows) {
+    LSST_AFW_INSTRUMENT_SCOPE("fits.mapTable");
+    int const nThreads = math::detail::resolveNumThreads(READ_THREADS);
+    std::vector<std::shared_ptr<BaseRecord>> result;
+    Schema const &schema = table.getSchema();
+    afw::fits::TableLayout const layout = fits.getTableLayout();
+    if (!_impl->flagKeys.empty() || nRows == 0 || layout.rowWidth != schema.getRecordSize()) {
+        return result;
+    }
+    // Every field must be filled by exactly one in-place decoder.
+    std::size_t nFields = 0;
+    schema.forEach([&nFields](auto const &item) { ++nFields; });
+    if (nFields != _impl->readers.size()) {
+        return result;
+    }
+    std::vector<FitsColumnReader::Decoder> decoders;
+    for (auto const &reader : _impl->readers) {
+        if (!reader->decodesInPlace(layout)) {
+            return result;
+        }
+        decoders.push_back(reader->makeDecoder(layout));
+    }
+
+    ndarray::Array<unsigned char, 1, 1> rows;
+    try {
+        rows = fits.mapTableBytes(firstRow, nRows);
+    } catch (afw::fits::FitsError &err) {
+        LOGLS_DEBUG("lsst.afw.FitsSchemaInputMapper", "Reading table rows instead of mapping them: "
+                                                              << err.what());
+        fits.status = 0;
+        return result;
+    }
+    table.adoptRecordData(rows.getData(), nRows, rows.getManager());
+    result.reserve(nRows);
+    std::vector<BaseRecord *> records;
+    records.reserve(nRows);
+    for (std::size_t i = 0; i < nRows; ++i) {
+        result.push_back(table.makeRecord());
+        records.push_back(result.back().get());
+    }
+
+    std::size_t const rowWidth = layout.rowWidth;
+    std::size_t const blockRows = std::max(DECODE_BLOCK_BYTES / rowWidth, std::size_t(1));
+    int const nBlocks = (nRows + blockRows - 1) / blockRows;
+    math::detail::parallelFor(nBlocks, nThreads, [&](int iBlock) {
+        std::size_t const blockBegin = iBlock * blockRows;
+        std::size_t const blockSize = std::min(blockRows, nRows - blockBegin);
+        for (auto const &decoder : decoders) {
+            decoder(records.data() + blockBegin, blockSize, rows.getData() + blockBegin * rowWidth,
+                    rowWidth);
+        }
+    });
+    return result;
+}
+
 }  // namespace io
 }  // namespace table
 }  // namespace afw
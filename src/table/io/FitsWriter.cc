@@ -1,10 +1,20 @@
 // -*- lsst-c++ -*-
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <memory>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
 
 #include "lsst/afw/table/io/FitsWriter.h"
 #include "lsst/afw/table/BaseTable.h"
 #include "lsst/afw/table/BaseRecord.h"
+#include "lsst/afw/math/Instrumentation.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace lsst {
 namespace afw {
@@ -190,6 +200,220 @@ void FitsWriter::_writeRecord(BaseRecord const& record) {
     ++_row;
     _processor->apply(&record);
 }
+
+bool FitsWriter::_writesRecordsUnchanged() const { return typeid(*this) == typeid(FitsWriter); }
+
+std::size_t FitsWriter::WRITE_CHUNK_BYTES = 1 << 24;
+int FitsWriter::WRITE_THREADS = 1;
+
+//----- Code for writing whole catalogs ---------------------------------------------------------------------
+
+namespace {
+
+// Catalogs are encoded in blocks of rows of about this many bytes a column at a time, so that the
+// records being read and the rows being filled stay in cache while every column is visited.
+std::size_t const ENCODE_BLOCK_BYTES = 1 << 16;
+
+// Unsigned integers of each size, for writing values big-endian.
+template <std::size_t N>
+struct UnsignedBits;
+template <>
+struct UnsignedBits<1> {
+    using Type = std::uint8_t;
+};
+template <>
+struct UnsignedBits<2> {
+    using Type = std::uint16_t;
+};
+template <>
+struct UnsignedBits<4> {
+    using Type = std::uint32_t;
+};
+template <>
+struct UnsignedBits<8> {
+    using Type = std::uint64_t;
+};
+
+// Return true if nElements values of type T per row can be encoded directly into a column stored
+// with the given layout.  CFITSIO stores unsigned integers wider than a byte (and signed bytes)
+// offset by TZERO = +/- 2^(N-1); flipSign is set if the most significant bit must be flipped to
+// apply that offset.
+template <typename T>
+bool canEncode(afw::fits::TableColumnLayout const& column, std::size_t nElements, bool& flipSign) {
+    flipSign = false;
+    if (column.size != nElements * sizeof(T) || column.scale != 1.0) {
+        return false;
+    }
+    if (std::is_floating_point<T>::value) {
+        return column.zero == 0.0;
+    }
+    bool const signedStorage = sizeof(T) > 1;  // FITS integers are signed, except for bytes
+    if (column.zero == 0.0) {
+        return std::is_signed<T>::value == signedStorage;
+    }
+    double const offset = std::ldexp(1.0, 8 * sizeof(T) - 1);
+    flipSign = true;
+    return std::is_signed<T>::value ? (!signedStorage && column.zero == -offset)
+                                    : (signedStorage && column.zero == offset);
+}
+
+// Encode one value big-endian, as checked by canEncode.
+template <typename T>
+void encodeValue(T value, bool flipSign, unsigned char* bytes) {
+    using Bits = typename UnsignedBits<sizeof(T)>::Type;
+    Bits bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    if (flipSign) {
+        bits ^= static_cast<Bits>(Bits(1) << (8 * sizeof(T) - 1));
+    }
+    for (std::size_t i = sizeof(T); i > 0; --i) {
+        bytes[i - 1] = static_cast<unsigned char>(bits & 0xFF);
+        bits = static_cast<Bits>(bits >> 8);
+    }
+}
+
+// The values of fields as they are stored in FITS.
+template <typename T>
+T toStored(T value) {
+    return value;
+}
+double toStored(lsst::geom::Angle value) { return value.asRadians(); }
+
+// Fills its fields of records[i] into the bytes starting at rows + i*rowWidth, for i in [0, nRows).
+using Encoder = std::function<void(BaseRecord const* const* records, std::size_t nRows, unsigned char* rows,
+                                   std::size_t rowWidth)>;
+
+// Writes its field of a record to a row of the table through CFITSIO.
+using CellWriter = std::function<void(BaseRecord const& record, std::size_t row)>;
+
+// A Schema::forEach functor that makes an Encoder for each field that can be encoded directly into
+// the rows' bytes, and a CellWriter (writing as ProcessRecords does) for each of the others.
+struct MakeColumnWriters {
+    template <typename T>
+    void operator()(SchemaItem<T> const& item) const {
+        addFixed(item.key);
+        ++col;
+    }
+
+    template <typename T>
+    void operator()(SchemaItem<Array<T> > const& item) const {
+        if (item.key.isVariableLength()) {
+            Key<Array<T> > const key = item.key;
+            cellWriters.push_back([fits = fits, col = col, key](BaseRecord const& record, std::size_t row) {
+                ndarray::Array<T const, 1, 1> array = record.get(key);
+                fits->writeTableArray(row, col, array.template getSize<0>(), array.getData());
+            });
+        } else {
+            addFixed(item.key);
+        }
+        ++col;
+    }
+
+    void operator()(SchemaItem<std::string> const& item) const {
+        Key<std::string> const key = item.key;
+        cellWriters.push_back([fits = fits, col = col, key](BaseRecord const& record, std::size_t row) {
+            fits->writeTableScalar(row, col, record.get(key));
+        });
+        ++col;
+    }
+
+    void operator()(SchemaItem<Flag> const& item) const { flagKeys.push_back(item.key); }
+
+    template <typename T>
+    void addFixed(Key<T> const& key) const {
+        using Element = typename Field<T>::Element;
+        using Stored = decltype(toStored(std::declval<Element>()));
+        std::size_t const nElements = key.getElementCount();
+        bool flipSign = false;
+        if (!canEncode<Stored>(layout->columns[col], nElements, flipSign)) {
+            cellWriters.push_back([fits = fits, col = col, key](BaseRecord const& record, std::size_t row) {
+                fits->writeTableArray(row, col, key.getElementCount(), record.getElement(key));
+            });
+            return;
+        }
+        std::size_t const offset = layout->columns[col].offset;
+        encoders.push_back([key, offset, nElements, flipSign](BaseRecord const* const* records,
+                                                              std::size_t nRows, unsigned char* rows,
+                                                              std::size_t rowWidth) {
+            for (std::size_t i = 0; i < nRows; ++i) {
+                Element const* values = records[i]->getElement(key);
+                unsigned char* bytes = rows + i * rowWidth + offset;
+                for (std::size_t j = 0; j < nElements; ++j) {
+                    encodeValue(toStored(values[j]), flipSign, bytes + j * sizeof(Stored));
+                }
+            }
+        });
+    }
+
+    Fits* fits;
+    afw::fits::TableLayout const* layout;
+    mutable int col;
+    mutable std::vector<Key<Flag> > flagKeys;
+    mutable std::vector<Encoder> encoders;
+    mutable std::vector<CellWriter> cellWriters;
+};
+
+// Make an Encoder that packs Flag fields into a bit column, eight bits (most significant first) at a
+// time.
+Encoder makeFlagEncoder(std::vector<Key<Flag> > const& flagKeys, std::size_t offset) {
+    return [flagKeys, offset](BaseRecord const* const* records, std::size_t nRows, unsigned char* rows,
+                              std::size_t rowWidth) {
+        std::size_t const nFlags = flagKeys.size();
+        for (std::size_t i = 0; i < nRows; ++i) {
+            unsigned char* bytes = rows + i * rowWidth + offset;
+            for (std::size_t begin = 0; begin < nFlags; begin += 8) {
+                std::size_t const end = std::min(begin + 8, nFlags);
+                unsigned int byte = 0;
+                for (std::size_t bit = begin; bit < end; ++bit) {
+                    auto const word = *records[i]->getElement(flagKeys[bit]);
+                    byte |= ((word >> flagKeys[bit].getBit()) & 1) << (7 - (bit - begin));
+                }
+                bytes[begin / 8] = static_cast<unsigned char>(byte);
+            }
+        }
+    };
+}
+
+}  // namespace
+
+void FitsWriter::_writeRecords(std::vector<BaseRecord const*> const& records) {
+    LSST_AFW_INSTRUMENT_SCOPE("fits.writeTable");
+    int const nThreads = math::detail::resolveNumThreads(WRITE_THREADS);
+    if (records.empty()) {
+        return;
+    }
+    afw::fits::TableLayout const layout = _fits->getTableLayout();
+    MakeColumnWriters writers = {_fits, &layout, _processor->nFlags ? 1 : 0, {}, {}, {}};
+    _processor->schema.forEach(writers);
+    if (!writers.flagKeys.empty()) {
+        writers.encoders.push_back(makeFlagEncoder(writers.flagKeys, layout.columns[0].offset));
+    }
+
+    std::size_t const firstRow = _row + 1;
+    std::size_t const rowWidth = std::max(layout.rowWidth, std::size_t(1));
+    std::size_t const chunkRows = std::max(WRITE_CHUNK_BYTES / rowWidth, std::size_t(1));
+    std::size_t const blockRows = std::max(ENCODE_BLOCK_BYTES / rowWidth, std::size_t(1));
+    std::vector<unsigned char> buffer(std::min(chunkRows, records.size()) * rowWidth);
+    for (std::size_t begin = 0; begin < records.size(); begin += chunkRows) {
+        std::size_t const nRows = std::min(chunkRows, records.size() - begin);
+        int const nBlocks = (nRows + blockRows - 1) / blockRows;
+        math::detail::parallelFor(nBlocks, nThreads, [&](int iBlock) {
+            std::size_t const blockBegin = iBlock * blockRows;
+            std::size_t const blockSize = std::min(blockRows, nRows - blockBegin);
+            for (auto const& encoder : writers.encoders) {
+                encoder(records.data() + begin + blockBegin, blockSize, buffer.data() + blockBegin * rowWidth,
+                        rowWidth);
+            }
+        });
+        _fits->writeTableBytes(firstRow + begin, nRows, buffer.data());
+        for (std::size_t i = 0; i < nRows; ++i) {
+            for (auto const& cellWriter : writers.cellWriters) {
+                cellWriter(*records[begin + i], firstRow + begin + i);
+            }
+        }
+    }
+    _row += records.size();
+}
 }  // namespace io
 }  // namespace table
 }  // namespace afw
@@ -1,5 +1,16 @@
 // -*- lsst-c++ -*-
 
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 #include "boost/format.hpp"
 
 #include "lsst/pex/exceptions.h"
@@ -7,7 +18,10 @@
 #include "lsst/afw/table/io/Persistable.h"
 #include "lsst/afw/table/io/ArchiveIndexSchema.h"
 #include "lsst/afw/table/io/CatalogVector.h"
+#include "lsst/afw/table/detail/BinaryCatalog.h"
 #include "lsst/afw/fits.h"
+#include "lsst/afw/math/Instrumentation.h"
+#include "lsst/afw/math/detail/Parallel.h"
 
 namespace lsst {
 namespace afw {
@@ -31,6 +45,61 @@ struct IndexSortCompare {
     }
 };
 
+// Read the archive index at the current HDU, and return it with the number of catalogs (including the
+// index) in the archive.
+std::pair<BaseCatalog, int> readIndex(fits::Fits& fitsfile) {
+    LSST_AFW_MEMORY_SCOPE("table.io.archive");
+    BaseCatalog index = BaseCatalog::readFits(fitsfile);
+    std::shared_ptr<daf::base::PropertyList> metadata = index.getTable()->popMetadata();
+    assert(metadata);  // BaseCatalog::readFits should always read metadata, even if there's nothing there
+    if (metadata->get<std::string>("EXTTYPE") != "ARCHIVE_INDEX") {
+        throw LSST_FITS_EXCEPT(fits::FitsError, fitsfile,
+                               boost::format("Wrong value for archive index EXTTYPE: '%s'") %
+                                       metadata->get<std::string>("EXTTYPE"));
+    }
+    return std::make_pair(index, metadata->get<int>("AR_NCAT"));
+}
+
+// Read the archive data catalog at the current HDU, which should be catalog n (1-indexed).
+BaseCatalog readDataCatalog(fits::Fits& fitsfile, int n) {
+    LSST_AFW_MEMORY_SCOPE("table.io.archive");
+    BaseCatalog catalog = BaseCatalog::readFits(fitsfile);
+    std::shared_ptr<daf::base::PropertyList> metadata = catalog.getTable()->popMetadata();
+    if (metadata->get<std::string>("EXTTYPE") != "ARCHIVE_DATA") {
+        throw LSST_FITS_EXCEPT(fits::FitsError, fitsfile,
+                               boost::format("Wrong value for archive data EXTTYPE: '%s'") %
+                                       metadata->get<std::string>("EXTTYPE"));
+    }
+    if (metadata->get<int>("AR_CATN") != n) {
+        throw LSST_FITS_EXCEPT(
+                fits::FitsError, fitsfile,
+                boost::format("Incorrect order for archive catalogs: AR_CATN=%d found at position %d") %
+                        metadata->get<int>("AR_CATN") % n);
+    }
+    return catalog;
+}
+
+// Reads the data catalogs of an archive on disk when they are first needed, opening the file again
+// so the archive does not depend on the lifetime of the Fits object it was read from.
+class FileCatalogReader {
+public:
+    FileCatalogReader(std::string const& fileName, int indexHdu) : _fileName(fileName), _indexHdu(indexHdu) {}
+
+    BaseCatalog operator()(std::size_t catN) {
+        if (!_fitsfile) {
+            _fitsfile = std::make_shared<fits::Fits>(_fileName, "r",
+                                                     fits::Fits::AUTO_CLOSE | fits::Fits::AUTO_CHECK);
+        }
+        _fitsfile->setHdu(_indexHdu + 1 + static_cast<int>(catN));
+        return readDataCatalog(*_fitsfile, static_cast<int>(catN) + 1);
+    }
+
+private:
+    std::string _fileName;
+    int _indexHdu;
+    std::shared_ptr<fits::Fits> _fitsfile;
+};
+
 }  // namespace
 
 // ----- InputArchive::Impl ---------------------------------------------------------------------------------
@@ -38,110 +107,131 @@ struct IndexSortCompare {
 class InputArchive::Impl {
 public:
     std::shared_ptr<Persistable> get(int id, InputArchive const& self) {
-        std::shared_ptr<Persistable> empty;
-        if (id == 0) return empty;
-        std::pair<Map::iterator, bool> r = _map.insert(std::make_pair(id, empty));
-        if (r.second) {
-            // insertion successful means we haven't reassembled this object yet; do that now.
-            CatalogVector factoryArgs;
-            // iterate over records in index with this ID; we know they're sorted by ID and then
-            // by catPersistable, so we can just append to factoryArgs.
-            std::string name;
-            std::string module;
-            for (BaseCatalog::iterator indexIter = _index.find(id, indexKeys.id);
-                 indexIter != _index.end() && indexIter->get(indexKeys.id) == id; ++indexIter) {
-                if (name.empty()) {
-                    name = indexIter->get(indexKeys.name);
-                } else if (name != indexIter->get(indexKeys.name)) {
-                    throw LSST_EXCEPT(
-                            MalformedArchiveError,
-                            (boost::format("Inconsistent name in index for ID %d; got '%s', expected '%s'") %
-                             indexIter->get(indexKeys.id) % indexIter->get(indexKeys.name) % name)
-                                    .str());
-                }
-                if (module.empty()) {
-                    module = indexIter->get(indexKeys.module);
-                } else if (module != indexIter->get(indexKeys.module)) {
-                    throw LSST_EXCEPT(
-                            MalformedArchiveError,
-                            (boost::format(
-                                     "Inconsistent module in index for ID %d; got '%s', expected '%s'") %
-                             indexIter->get(indexKeys.id) % indexIter->get(indexKeys.module) % module)
-                                    .str());
-                }
-                int catArchive = indexIter->get(indexKeys.catArchive);
-                if (catArchive == ArchiveIndexSchema::NO_CATALOGS_SAVED) {
-                    break;  // object was written with saveEmpty, and hence no catalogs.
-                }
-                std::size_t catN = catArchive - 1;
-                if (catN >= _catalogs.size()) {
-                    throw LSST_EXCEPT(
-                            MalformedArchiveError,
-                            (boost::format(
-                                     "Invalid catalog number in index for ID %d; got '%d', max is '%d'") %
-                             indexIter->get(indexKeys.id) % catN % _catalogs.size())
-                                    .str());
-                }
-                BaseCatalog& fullCatalog = _catalogs[catN];
-                std::size_t i1 = indexIter->get(indexKeys.row0);
-                std::size_t i2 = i1 + indexIter->get(indexKeys.nRows);
-                if (i2 > fullCatalog.size()) {
-                    throw LSST_EXCEPT(MalformedArchiveError,
-                                      (boost::format("Index and data catalogs do not agree for ID %d; "
-                                                     "catalog %d has %d rows, not %d") %
-                                       indexIter->get(indexKeys.id) % indexIter->get(indexKeys.catArchive) %
-                                       fullCatalog.size() % i2)
-                                              .str());
-                }
-                factoryArgs.push_back(BaseCatalog(fullCatalog.getTable(), fullCatalog.begin() + i1,
-                                                  fullCatalog.begin() + i2));
+        if (id == 0) return std::shared_ptr<Persistable>();
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true) {
+            auto const iter = _map.find(id);
+            if (iter == _map.end()) {
+                break;  // we haven't reassembled this object yet; do that below.
             }
-            try {
-                PersistableFactory const& factory = PersistableFactory::lookup(name, module);
-                r.first->second = factory.read(self, factoryArgs);
-            } catch (pex::exceptions::Exception& err) {
-                LSST_EXCEPT_ADD(err,
-                                (boost::format("loading object with id=%d, name='%s'") % id % name).str());
-                throw;
+            if (iter->second) {
+                return iter->second;
+            }
+            auto const loading = _loading.find(id);
+            if (loading == _loading.end() || loading->second == std::this_thread::get_id()) {
+                // If we'd already tried and failed to load this object before - but we'd caught the
+                // exception previously (because the calling code didn't consider that to be a fatal
+                // error) - we'll just throw an exception again.  While we can't know exactly what was
+                // thrown before, it's most likely it was a NotFoundError because a needed extension
+                // package was not setup. And conveniently it's appropriate to throw that here too, since
+                // now the problem is that the object should have been loaded into the cache and it wasn't
+                // found there.
+                throw LSST_EXCEPT(pex::exceptions::NotFoundError,
+                                  (boost::format("Not trying to reload object with id=%d; a previous attempt "
+                                                 "to load it already failed.") %
+                                   id)
+                                          .str());
             }
-            // If we're loading the object for the first time, and we've failed, we should have already
-            // thrown an exception, and we assert that here.
-            assert(r.first->second);
-        } else if (!r.first->second) {
-            // If we'd already tried and failed to load this object before - but we'd caught the exception
-            // previously (because the calling code didn't consider that to be a fatal error) - we'll
-            // just throw an exception again.  While we can't know exactly what was thrown before,
-            // it's most likely it was a NotFoundError because a needed extension package was not setup.
-            // And conveniently it's appropriate to throw that here too, since now the problem is that
-            // the object should have been loaded into the cache and it wasn't found there.
-            throw LSST_EXCEPT(pex::exceptions::NotFoundError,
-                              (boost::format("Not trying to reload object with id=%d; a previous attempt to "
-                                             "load it already failed.") %
-                               id)
-                                      .str());
-        }
-        return r.first->second;
-    }
-
-    Map const& getAll(InputArchive const& self) {
-        int id = 0;
+            // another thread is loading the object; wait for it to finish
+            _loaded.wait(lock);
+        }
+        _map.emplace(id, std::shared_ptr<Persistable>());
+        _loading.emplace(id, std::this_thread::get_id());
+        CatalogVector factoryArgs;
+        std::string name;
+        std::string module;
+        try {
+            _collectCatalogs(id, factoryArgs, name, module);
+        } catch (...) {
+            _finishLoading(id);
+            throw;
+        }
+        // Reassemble the object without holding the lock, so the factory can load the objects it
+        // refers to and other threads can load other objects.
+        lock.unlock();
+        std::shared_ptr<Persistable> result;
+        std::exception_ptr error;
+        try {
+            PersistableFactory const& factory = PersistableFactory::lookup(name, module);
+            result = factory.read(self, factoryArgs);
+        } catch (pex::exceptions::Exception& err) {
+            LSST_EXCEPT_ADD(err, (boost::format("loading object with id=%d, name='%s'") % id % name).str());
+            error = std::current_exception();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        lock.lock();
+        if (error) {
+            _finishLoading(id);
+            std::rethrow_exception(error);
+        }
+        // If we're loading the object for the first time, and we've failed, we should have already
+        // thrown an exception, and we assert that here.
+        assert(result);
+        _map[id] = result;
+        _finishLoading(id);
+        return result;
+    }
+
+    Map const& getAll(InputArchive const& self, int numThreads) {
+        int const nThreads = math::detail::resolveNumThreads(numThreads);
+        std::vector<int> ids;
         for (BaseCatalog::iterator indexIter = _index.begin(); indexIter != _index.end(); ++indexIter) {
-            if (indexIter->get(indexKeys.id) != id) {
-                id = indexIter->get(indexKeys.id);
+            if (ids.empty() || indexIter->get(indexKeys.id) != ids.back()) {
+                ids.push_back(indexIter->get(indexKeys.id));
+            }
+        }
+        if (nThreads == 1) {
+            for (int id : ids) {
                 get(id, self);
             }
+            return _map;
+        }
+        // Read every data catalog and import every factory's module here, so the worker threads
+        // neither read from the file nor call Python; objects whose factories are not thread-safe are
+        // loaded here too, along with everything they refer to.
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (std::size_t catN = 0; catN < _nCatalogs; ++catN) {
+                _getCatalog(catN);
+            }
         }
+        std::vector<int> concurrentIds;
+        concurrentIds.reserve(ids.size());
+        for (int id : ids) {
+            bool threadSafe = false;
+            try {
+                BaseRecord const& first = _index[_rows.at(id).first];
+                PersistableFactory const& factory =
+                        PersistableFactory::lookup(first.get(indexKeys.name), first.get(indexKeys.module));
+                threadSafe = factory.isThreadSafe();
+            } catch (pex::exceptions::Exception&) {
+                // get reports the problem, with the object's ID and name
+            }
+            if (threadSafe) {
+                concurrentIds.push_back(id);
+            } else {
+                get(id, self);
+            }
+        }
+        math::detail::parallelFor(concurrentIds.size(), nThreads,
+                                  [&](int i) { get(concurrentIds[i], self); });
         return _map;
     }
 
-    Impl() : _index(ArchiveIndexSchema::get().schema) {}
+    /// Read data catalog catN (0-indexed) of an archive whose catalogs are not all in memory.
+    using CatalogReader = std::function<BaseCatalog(std::size_t)>;
 
-    Impl(BaseCatalog const& index, CatalogVector const& catalogs) : _index(index), _catalogs(catalogs) {
-        if (index.getSchema() != indexKeys.schema) {
-            throw LSST_EXCEPT(pex::exceptions::RuntimeError, "Incorrect schema for index catalog");
-        }
-        _map.insert(std::make_pair(0, std::shared_ptr<Persistable>()));
-        _index.sort(IndexSortCompare());
+    Impl() : _index(ArchiveIndexSchema::get().schema), _nCatalogs(0) {}
+
+    Impl(BaseCatalog const& index, CatalogVector const& catalogs)
+            : _index(index), _catalogs(catalogs), _nCatalogs(catalogs.size()) {
+        _initialize();
+    }
+
+    Impl(BaseCatalog const& index, std::size_t nCatalogs, CatalogReader readCatalog)
+            : _index(index), _nCatalogs(nCatalogs), _readCatalog(std::move(readCatalog)) {
+        _initialize();
     }
 
     // No copying
@@ -152,9 +242,110 @@ public:
     Impl(Impl&&) = delete;
     Impl& operator=(Impl&&) = delete;
 
+    std::mutex _mutex;  // guards _map, _loading and _readCatalogs
+    std::condition_variable _loaded;  // notified when a thread stops loading an object
     Map _map;
+    // IDs of the objects being loaded, with the threads loading them
+    std::unordered_map<int, std::thread::id> _loading;
     BaseCatalog _index;
-    CatalogVector _catalogs;
+    CatalogVector _catalogs;  // all data catalogs, unless they are read by _readCatalog
+    std::size_t _nCatalogs;
+    CatalogReader _readCatalog;
+    std::map<std::size_t, BaseCatalog> _readCatalogs;  // data catalogs read by _readCatalog so far
+    // Rows [first, second) of the sorted index for each ID
+    std::unordered_map<int, std::pair<std::size_t, std::size_t>> _rows;
+
+private:
+    void _initialize() {
+        if (_index.getSchema() != indexKeys.schema) {
+            throw LSST_EXCEPT(pex::exceptions::RuntimeError, "Incorrect schema for index catalog");
+        }
+        _map.insert(std::make_pair(0, std::shared_ptr<Persistable>()));
+        _index.sort(IndexSortCompare());
+        for (std::size_t i = 0; i < _index.size();) {
+            int const id = _index[i].get(indexKeys.id);
+            std::size_t j = i + 1;
+            while (j < _index.size() && _index[j].get(indexKeys.id) == id) {
+                ++j;
+            }
+            _rows.emplace(id, std::make_pair(i, j));
+            i = j;
+        }
+    }
+
+    // Gather the catalogs of an object, and its name and module, from the index
+    void _collectCatalogs(int id, CatalogVector& factoryArgs, std::string& name, std::string& module) {
+        // iterate over records in index with this ID; we know they're sorted by ID and then
+        // by catPersistable, so we can just append to factoryArgs.
+        std::pair<std::size_t, std::size_t> rows(0, 0);
+        auto const rowsIter = _rows.find(id);
+        if (rowsIter != _rows.end()) {
+            rows = rowsIter->second;
+        }
+        for (BaseCatalog::iterator indexIter = _index.begin() + rows.first;
+             indexIter != _index.begin() + rows.second; ++indexIter) {
+            if (name.empty()) {
+                name = indexIter->get(indexKeys.name);
+            } else if (name != indexIter->get(indexKeys.name)) {
+                throw LSST_EXCEPT(
+                        MalformedArchiveError,
+                        (boost::format("Inconsistent name in index for ID %d; got '%s', expected '%s'") %
+                         indexIter->get(indexKeys.id) % indexIter->get(indexKeys.name) % name)
+                                .str());
+            }
+            if (module.empty()) {
+                module = indexIter->get(indexKeys.module);
+            } else if (module != indexIter->get(indexKeys.module)) {
+                throw LSST_EXCEPT(
+                        MalformedArchiveError,
+                        (boost::format("Inconsistent module in index for ID %d; got '%s', expected '%s'") %
+                         indexIter->get(indexKeys.id) % indexIter->get(indexKeys.module) % module)
+                                .str());
+            }
+            int catArchive = indexIter->get(indexKeys.catArchive);
+            if (catArchive == ArchiveIndexSchema::NO_CATALOGS_SAVED) {
+                break;  // object was written with saveEmpty, and hence no catalogs.
+            }
+            std::size_t catN = catArchive - 1;
+            if (catN >= _nCatalogs) {
+                throw LSST_EXCEPT(
+                        MalformedArchiveError,
+                        (boost::format("Invalid catalog number in index for ID %d; got '%d', max is '%d'") %
+                         indexIter->get(indexKeys.id) % catN % _nCatalogs)
+                                .str());
+            }
+            BaseCatalog& fullCatalog = _getCatalog(catN);
+            std::size_t i1 = indexIter->get(indexKeys.row0);
+            std::size_t i2 = i1 + indexIter->get(indexKeys.nRows);
+            if (i2 > fullCatalog.size()) {
+                throw LSST_EXCEPT(MalformedArchiveError,
+                                  (boost::format("Index and data catalogs do not agree for ID %d; "
+                                                 "catalog %d has %d rows, not %d") %
+                                   indexIter->get(indexKeys.id) % indexIter->get(indexKeys.catArchive) %
+                                   fullCatalog.size() % i2)
+                                          .str());
+            }
+            factoryArgs.push_back(
+                    BaseCatalog(fullCatalog.getTable(), fullCatalog.begin() + i1, fullCatalog.begin() + i2));
+        }
+    }
+
+    // Mark an object as no longer being loaded, waking any threads waiting for it; _mutex must be held
+    void _finishLoading(int id) {
+        _loading.erase(id);
+        _loaded.notify_all();
+    }
+
+    BaseCatalog& _getCatalog(std::size_t catN) {
+        if (!_readCatalog) {
+            return _catalogs[catN];
+        }
+        auto iter = _readCatalogs.find(catN);
+        if (iter == _readCatalogs.end()) {
+            iter = _readCatalogs.emplace(catN, _readCatalog(catN)).first;
+        }
+        return iter->second;
+    }
 };
 
 // ----- InputArchive ---------------------------------------------------------------------------------------
@@ -176,37 +367,52 @@ InputArchive& InputArchive::operator=(InputArchive&& other) { return *this = oth
 
 InputArchive::~InputArchive() = default;
 
-std::shared_ptr<Persistable> InputArchive::get(int id) const { return _impl->get(id, *this); }
+std::shared_ptr<Persistable> InputArchive::get(int id) const {
+    LSST_AFW_INSTRUMENT_SCOPE("table.io.InputArchive.get");
+    return _impl->get(id, *this);
+}
+
+InputArchive::Map const& InputArchive::getAll() const { return _impl->getAll(*this, 1); }
 
-InputArchive::Map const& InputArchive::getAll() const { return _impl->getAll(*this); }
+InputArchive::Map const& InputArchive::getAll(int numThreads) const {
+    return _impl->getAll(*this, numThreads);
+}
 
 InputArchive InputArchive::readFits(fits::Fits& fitsfile) {
-    BaseCatalog index = BaseCatalog::readFits(fitsfile);
-    std::shared_ptr<daf::base::PropertyList> metadata = index.getTable()->popMetadata();
-    assert(metadata);  // BaseCatalog::readFits should always read metadata, even if there's nothing there
-    if (metadata->get<std::string>("EXTTYPE") != "ARCHIVE_INDEX") {
-        throw LSST_FITS_EXCEPT(fits::FitsError, fitsfile,
-                               boost::format("Wrong value for archive index EXTTYPE: '%s'") %
-                                       metadata->get<std::string>("EXTTYPE"));
-    }
-    int nCatalogs = metadata->get<int>("AR_NCAT");
+    auto [index, nCatalogs] = readIndex(fitsfile);
     CatalogVector catalogs;
     catalogs.reserve(nCatalogs);
     for (int n = 1; n < nCatalogs; ++n) {
         fitsfile.setHdu(1, true);  // increment HDU by one
-        catalogs.push_back(BaseCatalog::readFits(fitsfile));
-        metadata = catalogs.back().getTable()->popMetadata();
-        if (metadata->get<std::string>("EXTTYPE") != "ARCHIVE_DATA") {
-            throw LSST_FITS_EXCEPT(fits::FitsError, fitsfile,
-                                   boost::format("Wrong value for archive data EXTTYPE: '%s'") %
-                                           metadata->get<std::string>("EXTTYPE"));
-        }
-        if (metadata->get<int>("AR_CATN") != n) {
-            throw LSST_FITS_EXCEPT(
-                    fits::FitsError, fitsfile,
-                    boost::format("Incorrect order for archive catalogs: AR_CATN=%d found at position %d") %
-                            metadata->get<int>("AR_CATN") % n);
-        }
+        catalogs.push_back(readDataCatalog(fitsfile, n));
+    }
+    std::shared_ptr<Impl> impl(new Impl(index, catalogs));
+    return InputArchive(impl);
+}
+
+InputArchive InputArchive::readFitsLazy(fits::Fits& fitsfile) {
+    std::string const fileName = fitsfile.getFileName();
+    if (!std::filesystem::is_regular_file(fileName)) {
+        return readFits(fitsfile);
+    }
+    int const indexHdu = fitsfile.getHdu();
+    auto [index, nCatalogs] = readIndex(fitsfile);
+    std::shared_ptr<Impl> impl(
+            new Impl(index, std::max(nCatalogs - 1, 0), FileCatalogReader(fileName, indexHdu)));
+    return InputArchive(impl);
+}
+
+InputArchive InputArchive::readBinary(std::uint8_t const* data, std::size_t size) {
+    std::uint8_t const* const end = data + size;
+    std::size_t const nCatalogs = detail::readBinaryArchiveHeader(data, end);
+    if (nCatalogs == 0) {
+        throw LSST_EXCEPT(MalformedArchiveError, "Binary archive has no index catalog");
+    }
+    BaseCatalog index = detail::readBinaryCatalog(data, end);
+    CatalogVector catalogs;
+    catalogs.reserve(nCatalogs - 1);
+    for (std::size_t n = 1; n < nCatalogs; ++n) {
+        catalogs.push_back(detail::readBinaryCatalog(data, end));
     }
     std::shared_ptr<Impl> impl(new Impl(index, catalogs));
     return InputArchive(impl);
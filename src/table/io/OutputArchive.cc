@@ -1,6 +1,9 @@
 // -*- lsst-c++ -*-
 
+#include <cstring>
 #include <typeinfo>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 #include <map>
 #include <memory>
@@ -12,7 +15,9 @@
 #include "lsst/afw/table/io/ArchiveIndexSchema.h"
 #include "lsst/afw/table/io/Persistable.h"
 #include "lsst/afw/table/io/CatalogVector.h"
+#include "lsst/afw/table/detail/BinaryCatalog.h"
 #include "lsst/afw/fits.h"
+#include "lsst/afw/math/Instrumentation.h"
 
 namespace lsst {
 namespace afw {
@@ -30,6 +35,40 @@ using Map = std::map<std::weak_ptr<Persistable const>, int,
 
 using MapItem = Map::value_type;
 
+// Functor that appends the values of a record's fields to a string, so that records (and objects)
+// with equal contents produce equal strings.
+struct ContentWriter {
+    template <typename T>
+    void operator()(SchemaItem<T> const &item) const {
+        append(record->get(item.key));
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_arithmetic_v<T>> append(T value) const {
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        content.append(bytes, sizeof(T));
+    }
+
+    void append(lsst::geom::Angle const &value) const { append(value.asRadians()); }
+
+    void append(std::string const &value) const {
+        append(value.size());
+        content.append(value);
+    }
+
+    template <typename T, int N, int C>
+    void append(ndarray::Array<T, N, C> const &value) const {
+        append(value.getNumElements());
+        for (auto const &element : value) {
+            append(element);
+        }
+    }
+
+    BaseRecord const *record;
+    std::string &content;
+};
+
 }  // namespace
 
 // ----- OutputArchive::Impl --------------------------------------------------------------------------------
@@ -109,21 +148,86 @@ public:
     int put(Persistable const *obj, std::shared_ptr<Impl> const &self, bool permissive) {
         if (!obj) return 0;
         if (permissive && !obj->isPersistable()) return 0;
+        LSST_AFW_MEMORY_SCOPE("table.io.archive");
         int const currentId = _nextId;
         ++_nextId;
+        std::size_t const indexSize = _index.size();
+        std::size_t const nCatalogs = _catalogs.size();
         OutputArchiveHandle handle(currentId, obj->getPersistenceName(), obj->getPythonModule(), self);
         obj->write(handle);
+        if (_deduplicate) {
+            return deduplicate(currentId, obj->getPersistenceName(), obj->getPythonModule(), indexSize,
+                               nCatalogs);
+        }
         return currentId;
     }
 
+    /*
+     * Return the ID of an object saved earlier with the same contents as the object just saved with
+     * ID id, and remove the latter from the archive; if there is no such object, record the contents
+     * of the new one and return id.
+     *
+     * indexSize and nCatalogs are the sizes of the index and the catalog list before the new object
+     * was saved.
+     */
+    int deduplicate(int id, std::string const &name, std::string const &module, std::size_t indexSize,
+                    std::size_t nCatalogs) {
+        std::string content = name + '\0' + module + '\0';
+        ContentWriter writer{nullptr, content};
+        bool onlyOwnRows = (_catalogs.size() == nCatalogs);
+        for (std::size_t i = indexSize; i < _index.size(); ++i) {
+            BaseRecord const &indexRecord = _index[i];
+            if (indexRecord.get(indexKeys.id) != id) {
+                // Entries for new nested objects; their IDs are new, so ours can't be a duplicate.
+                onlyOwnRows = false;
+                continue;
+            }
+            int const catArchive = indexRecord.get(indexKeys.catArchive);
+            writer.append(indexRecord.get(indexKeys.catPersistable));
+            writer.append(catArchive);
+            writer.append(indexRecord.get(indexKeys.nRows));
+            if (catArchive == ArchiveIndexSchema::NO_CATALOGS_SAVED) {
+                continue;
+            }
+            BaseCatalog const &catalog = _catalogs[catArchive - 1];
+            std::size_t const row0 = indexRecord.get(indexKeys.row0);
+            for (std::size_t j = row0; j < row0 + indexRecord.get(indexKeys.nRows); ++j) {
+                ContentWriter rowWriter{&catalog[j], content};
+                catalog.getSchema().forEach(rowWriter);
+            }
+        }
+        auto const previous = _contents.find(content);
+        if (previous == _contents.end()) {
+            _contents.emplace(std::move(content), id);
+            return id;
+        }
+        if (!onlyOwnRows) {
+            return id;
+        }
+        // Nothing else has been saved since this object started, so its rows are at the ends of
+        // their catalogs and its entries at the end of the index.
+        for (std::size_t i = _index.size(); i > indexSize; --i) {
+            BaseRecord const &indexRecord = _index[i - 1];
+            int const catArchive = indexRecord.get(indexKeys.catArchive);
+            if (catArchive != ArchiveIndexSchema::NO_CATALOGS_SAVED) {
+                BaseCatalog &catalog = _catalogs[catArchive - 1];
+                catalog.erase(catalog.begin() + indexRecord.get(indexKeys.row0), catalog.end());
+            }
+        }
+        _index.erase(_index.begin() + indexSize, _index.end());
+        _nextId = id;
+        return previous->second;
+    }
+
     int put(std::shared_ptr<Persistable const> obj, std::shared_ptr<Impl> const &self, bool permissive) {
         if (!obj) return 0;
         if (permissive && !obj->isPersistable()) return 0;
         MapItem item(obj, _nextId);
         std::pair<Map::iterator, bool> r = _map.insert(item);
         if (r.second) {
-            // We've never seen this object before.  Save it.
-            return put(obj.get(), self, permissive);
+            // We've never seen this object before.  Save it (or find an object with the same contents).
+            r.first->second = put(obj.get(), self, permissive);
+            return r.first->second;
         } else {
             // We had already saved this object, and insert returned an iterator
             // to the ID we used before; return that.
@@ -150,6 +254,8 @@ public:
     }
 
     int _nextId{1};
+    bool _deduplicate{false};
+    std::unordered_map<std::string, int> _contents;  // contents of saved objects, when deduplicating
     Map _map;
     BaseCatalog _index;
     CatalogVector _catalogs;
@@ -198,10 +304,30 @@ BaseCatalog const &OutputArchive::getCatalog(int n) const {
     return _impl->_catalogs[n - 1];
 }
 
+void OutputArchive::setDeduplicate(bool deduplicate) {
+    if (!_impl.unique()) {  // copy on write
+        std::shared_ptr<Impl> tmp(new Impl(*_impl));
+        _impl.swap(tmp);
+    }
+    _impl->_deduplicate = deduplicate;
+}
+
+bool OutputArchive::getDeduplicate() const noexcept { return _impl->_deduplicate; }
+
 std::size_t OutputArchive::countCatalogs() const { return _impl->_catalogs.size() + 1; }
 
 void OutputArchive::writeFits(fits::Fits &fitsfile) const { _impl->writeFits(fitsfile); }
 
+std::vector<std::uint8_t> OutputArchive::writeBinary() const {
+    std::vector<std::uint8_t> buffer;
+    detail::writeBinaryArchiveHeader(_impl->_catalogs.size() + 1, buffer);
+    detail::writeBinaryCatalog(_impl->_index, buffer);
+    for (BaseCatalog const &catalog : _impl->_catalogs) {
+        detail::writeBinaryCatalog(catalog, buffer);
+    }
+    return buffer;
+}
+
 // ----- OutputArchiveHandle ------------------------------------------------------------------------------
 
 BaseCatalog OutputArchiveHandle::makeCatalog(Schema const &schema) { return _impl->makeCatalog(schema); }
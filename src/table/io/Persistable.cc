@@ -31,6 +31,12 @@ void Persistable::writeFits(fits::MemFileManager &manager, std::string const &mo
     writeFits(fitsfile);
 }
 
+std::vector<std::uint8_t> Persistable::writeBinary() const {
+    OutputArchive archive;
+    archive.put(this);
+    return archive.writeBinary();
+}
+
 std::string Persistable::getPersistenceName() const { return std::string(); }
 
 std::string Persistable::getPythonModule() const { return std::string(); }
@@ -58,6 +64,11 @@ std::shared_ptr<Persistable> Persistable::_readFits(fits::Fits &fitsfile) {
     return archive.get(1);  // the first object saved always has id=1
 }
 
+std::shared_ptr<Persistable> Persistable::_readBinary(std::uint8_t const *data, std::size_t size) {
+    InputArchive archive = InputArchive::readBinary(data, size);
+    return archive.get(1);
+}
+
 // ----- PersistableFactory ---------------------------------------------------------------------------------
 
 namespace {
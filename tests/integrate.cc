@@ -185,3 +185,56 @@ BOOST_AUTO_TEST_CASE(Integrate) {
     BOOST_CHECK_CLOSE(integ1, result1, tolerance);
     BOOST_CHECK_CLOSE(integ2, result2, tolerance);
 }
+
+/*
+ * Test that batched integrands give the same results as the equivalent pointwise integrands
+ */
+BOOST_AUTO_TEST_CASE(BatchIntegrand) {
+    Parab1D<double> parab1d(100.0, 1.0);
+    int nCalls = 0;
+    auto batch1d = math::makeBatchIntegrand([&parab1d, &nCalls](std::vector<double> const &x,
+                                                                std::vector<double> &f) {
+        ++nCalls;
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            f[i] = parab1d(x[i]);
+        }
+    });
+    BOOST_CHECK_EQUAL(math::integrate(batch1d, 0.0, 9.0), math::integrate(parab1d, 0.0, 9.0));
+    BOOST_CHECK_GT(nCalls, 0);
+    BOOST_CHECK_LT(nCalls, 10);
+
+    // infinite ranges use a change of variables, which must also be batched
+    auto gauss = math::makeBatchIntegrand([](std::vector<double> const &x, std::vector<double> &f) {
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            f[i] = std::exp(-0.5 * x[i] * x[i]);
+        }
+    });
+    math::IntRegion<double> reg(0.0, math::MOCK_INF);
+    BOOST_CHECK_CLOSE(math::int1d(gauss, reg, 1.e-10, 1.e-8), std::sqrt(M_PI / 2.0), 1e-6);
+
+    Parab2D<double> parab2d(100.0, 1.0, 1.0);
+    auto batch2d = math::makeBatchIntegrand([&parab2d](std::vector<double> const &x, double y,
+                                                       std::vector<double> &f) {
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            f[i] = parab2d(x[i], y);
+        }
+    });
+    BOOST_CHECK_EQUAL(math::integrate2d(batch2d, 0.0, 9.0, 0.0, 9.0),
+                      math::integrate2d(parab2d, 0.0, 9.0, 0.0, 9.0));
+}
+
+/*
+ * Test that integrate2d gives the same results whether or not the outer integral is done in parallel
+ */
+BOOST_AUTO_TEST_CASE(ParallelIntegrate2D) {
+    Parab2D<double> parab2d(100.0, 1.0, 1.0);
+    auto wavy = [](double x, double y) { return std::sin(x) * std::cos(3.0 * y) + 2.0; };
+    for (int numThreads : {0, 4}) {
+        BOOST_CHECK_EQUAL(math::integrate2d(parab2d, 0.0, 9.0, 0.0, 9.0, 1e-6, numThreads),
+                          math::integrate2d(parab2d, 0.0, 9.0, 0.0, 9.0));
+        BOOST_CHECK_EQUAL(math::integrate2d(wavy, 0.0, 10.0, -2.0, 5.0, 1e-8, numThreads),
+                          math::integrate2d(wavy, 0.0, 10.0, -2.0, 5.0, 1e-8));
+    }
+    BOOST_CHECK_THROW(math::integrate2d(parab2d, 0.0, 9.0, 0.0, 9.0, 1e-6, -1),
+                      lsst::pex::exceptions::InvalidParameterError);
+}
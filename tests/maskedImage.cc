@@ -481,3 +481,28 @@ BOOST_AUTO_TEST_CASE(
         BOOST_CHECK_EQUAL(pix.image(), 1452);
     }
 }
+
+BOOST_AUTO_TEST_CASE(
+        uninitialized) { /* parasoft-suppress  LsstDm-3-2a LsstDm-3-4a LsstDm-4-6 LsstDm-5-25 "Boost non-Std" */
+    ImageT const reference = make_image();
+    lsst::geom::Box2I const bbox(lsst::geom::Point2I(3, -2), reference.getDimensions());
+
+    ImageT img(bbox, image::UNINITIALIZED);
+    BOOST_CHECK_EQUAL(img.getBBox(), bbox);
+    BOOST_CHECK(img.getMask()->getMaskPlaneDict() == reference.getMask()->getMaskPlaneDict());
+    img.assign(reference);
+    BOOST_CHECK_EQUAL((*img.getImage())(1, 1), 101);
+    BOOST_CHECK_EQUAL((*img.getMask())(1, 1), img.getWidth() + 1);
+    BOOST_CHECK_EQUAL((*img.getVariance())(1, 1), 202);
+
+    image::Image<PixelT> plane(reference.getDimensions(), image::UNINITIALIZED);
+    BOOST_CHECK_EQUAL(plane.getBBox(), reference.getBBox());
+
+    // The default constructor still zeroes every plane
+    ImageT zeroed(reference.getDimensions());
+    for (ImageT::iterator ptr = zeroed.begin(), end = zeroed.end(); ptr != end; ++ptr) {
+        BOOST_CHECK_EQUAL(ptr.image(), 0);
+        BOOST_CHECK_EQUAL(ptr.mask(), 0);
+        BOOST_CHECK_EQUAL(ptr.variance(), 0);
+    }
+}
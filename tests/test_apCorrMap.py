@@ -39,6 +39,7 @@ import lsst.pex.exceptions
 import lsst.geom
 import lsst.afw.math
 import lsst.afw.image
+import lsst.afw.table
 
 
 class ApCorrMapTestCase(lsst.utils.tests.TestCase):
@@ -151,6 +152,72 @@ class ApCorrMapTestCase(lsst.utils.tests.TestCase):
         new *= scale
         self.compare(self.map, new)
 
+    def makeCatalog(self, names):
+        schema = lsst.afw.table.SourceTable.makeMinimalSchema()
+        centroidKey = lsst.afw.table.Point2DKey.addFields(schema, "centroid", "centroid", "pixel")
+        schema.getAliasMap().set("slot_Centroid", "centroid")
+        for name in names:
+            schema.addField(name + "_instFlux", type=float, doc="flux")
+            schema.addField(name + "_instFluxErr", type=float, doc="flux error")
+            schema.addField(name + "_apCorr", type=float, doc="aperture correction")
+            schema.addField(name + "_apCorrErr", type=float, doc="aperture correction error")
+            schema.addField(name + "_flag_apCorr", type="Flag", doc="aperture correction failed")
+        catalog = lsst.afw.table.SourceCatalog(schema)
+        for i in range(20):
+            record = catalog.addNew()
+            record.set(centroidKey, lsst.geom.Point2D(*np.random.uniform(-5, 5, size=2)))
+            for name in names:
+                record.set(name + "_instFlux", np.random.uniform(10.0, 100.0))
+                record.set(name + "_instFluxErr", np.random.uniform(1.0, 2.0))
+        return catalog
+
+    def testApplyToCatalog(self):
+        """Test that applyToCatalog matches applying the corrections one record at a time.
+        """
+        names = ["a", "b"]
+        apCorrMap = lsst.afw.image.ApCorrMap()
+        for name in names:
+            apCorrMap.set(name + "_instFlux", lsst.afw.math.ChebyshevBoundedField(
+                self.bbox, np.random.uniform(0.5, 1.0, size=(1, 1)) + 0.01*np.random.randn(3, 3)))
+        # corrections may share their uncertainty
+        apCorrMap.set("a_instFluxErr", self.map["a"])
+        apCorrMap.set("b_instFluxErr", self.map["a"])
+        for numThreads in (1, 0):
+            for contiguous in (True, False):
+                catalog = self.makeCatalog(names)
+                if not contiguous:
+                    catalog = catalog[::2]
+                expected = catalog.copy(deep=True)
+                apCorrMap.applyToCatalog(catalog, names, numThreads=numThreads)
+                for record, original in zip(catalog, expected):
+                    point = original.getCentroid()
+                    for name in names:
+                        apCorr = apCorrMap[name + "_instFlux"].evaluate(point)
+                        self.assertFloatsAlmostEqual(record.get(name + "_instFlux"),
+                                                     original.get(name + "_instFlux")*apCorr, rtol=1E-14)
+                        self.assertFloatsAlmostEqual(record.get(name + "_instFluxErr"),
+                                                     original.get(name + "_instFluxErr")*apCorr,
+                                                     rtol=1E-14)
+                        self.assertFloatsAlmostEqual(record.get(name + "_apCorr"), apCorr, rtol=1E-14)
+                        self.assertFloatsAlmostEqual(record.get(name + "_apCorrErr"),
+                                                     self.map["a"].evaluate(point), rtol=1E-14)
+                        self.assertFalse(record.get(name + "_flag_apCorr"))
+
+    def testApplyToCatalogErrors(self):
+        """Test that unusable corrections are flagged and missing ones detected.
+        """
+        catalog = self.makeCatalog(["a"])
+        expected = catalog.copy(deep=True)
+        apCorrMap = lsst.afw.image.ApCorrMap()
+        apCorrMap.set("a_instFlux", lsst.afw.math.ChebyshevBoundedField(self.bbox, np.array([[-1.0]])))
+        apCorrMap.applyToCatalog(catalog, ["a"])
+        self.assertTrue(np.all(catalog["a_flag_apCorr"]))
+        self.assertFloatsEqual(catalog["a_instFlux"], expected["a_instFlux"])
+        with self.assertRaises(lsst.pex.exceptions.NotFoundError):
+            apCorrMap.applyToCatalog(catalog, ["b"])
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            apCorrMap.applyToCatalog(catalog, ["a"], numThreads=-1)
+
 
 class TestMemory(lsst.utils.tests.MemoryTestCase):
     pass
@@ -153,6 +153,40 @@ class ApproximateTestCase(lsst.utils.tests.TestCase):
                           lambda: approx.getImage(orderMax + 1, orderMax + 1))
 
 
+    def testQuadraticMultithreaded(self):
+        """Check that a threaded evaluation reproduces a fitted quadratic surface"""
+        nx, ny = 30, 50
+        xVec = [float(i) for i in range(nx)]
+        yVec = [float(j) for j in range(ny)]
+        ramp = afwImage.MaskedImageF(nx, ny)
+
+        def surface(x, y):
+            return 100 + 0.5*x - 0.25*y + 0.01*x*x + 0.02*x*y - 0.005*y*y
+
+        for j in range(ny):
+            for i in range(nx):
+                ramp[i, j, afwImage.LOCAL] = (surface(xVec[i], yVec[j]), 0x0, 1.0)
+        bbox = lsst.geom.BoxI(lsst.geom.PointI(0, 0), lsst.geom.ExtentI(nx, ny))
+
+        actrl = afwMath.ApproximateControl(afwMath.ApproximateControl.CHEBYSHEV, 2)
+        self.assertEqual(actrl.getNumThreads(), 1)
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            actrl.setNumThreads(-1)
+        serial = afwMath.makeApproximate(xVec, yVec, ramp, bbox, actrl).getImage()
+
+        actrl.setNumThreads(4)
+        approx = afwMath.makeApproximate(xVec, yVec, ramp, bbox, actrl)
+        threaded = approx.getImage()
+        self.assertFloatsAlmostEqual(threaded.getArray(), serial.getArray(), rtol=1e-6)
+
+        y, x = np.mgrid[0:ny, 0:nx]
+        self.assertFloatsAlmostEqual(threaded.getArray(), surface(x, y), rtol=1e-5)
+
+        # a truncated expansion is the same as an image or a masked image
+        self.assertImagesEqual(approx.getMaskedImage(1, 1).getImage(), approx.getImage(1, 1))
+        self.assertFloatsNotEqual(approx.getImage(1, 1).getArray(), threaded.getArray())
+
+
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
 
@@ -812,6 +812,186 @@ class BackgroundTestCase(lsst.utils.tests.TestCase):
                 self.assertEqual(np.min(backImage.getArray()), 0.0)
                 self.assertEqual(np.max(backImage.getArray()), 0.0)
 
+    def testMultithreaded(self):
+        """Test that threading the grid statistics and interpolation doesn't change the background"""
+        rng = np.random.RandomState(13579)
+        mimg = afwImage.MaskedImageF(lsst.geom.Box2I(lsst.geom.Point2I(12, 34), lsst.geom.Extent2I(301, 257)))
+        mimg.image.array[:] = rng.normal(100.0, 3.0, size=mimg.image.array.shape)
+        mimg.variance.array[:] = 9.0
+        box = lsst.geom.Box2I(lsst.geom.Point2I(50, 60), lsst.geom.Extent2I(123, 97))
+
+        bgCtrl = afwMath.BackgroundControl(afwMath.Interpolate.AKIMA_SPLINE, 7, 5)
+        self.assertEqual(bgCtrl.getNumThreads(), 1)
+        serial = afwMath.makeBackground(mimg, bgCtrl)
+        for numThreads in (0, 3, 8):
+            bgCtrl.setNumThreads(numThreads)
+            self.assertEqual(bgCtrl.getNumThreads(), numThreads)
+            threaded = afwMath.makeBackground(mimg, bgCtrl)
+            self.assertMaskedImagesEqual(threaded.getStatsImage(), serial.getStatsImage())
+            self.assertImagesEqual(threaded.getImageF(), serial.getImageF())
+            self.assertImagesEqual(threaded.getImageF(box, "AKIMA_SPLINE"),
+                                   serial.getImageF(box, "AKIMA_SPLINE"))
+
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            bgCtrl.setNumThreads(-1)
+
+    def testBackgroundImageView(self):
+        """Test that a BackgroundImageView reproduces getImage without building the whole image"""
+        rng = np.random.RandomState(97531)
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(-7, 21), lsst.geom.Extent2I(283, 301))
+        mimg = afwImage.MaskedImageF(bbox)
+        y, x = np.mgrid[0:bbox.getHeight(), 0:bbox.getWidth()]
+        mimg.image.array[:] = 100.0 + 0.01*x + 0.02*y + rng.normal(0.0, 1.0, size=x.shape)
+        mimg.variance.array[:] = 1.0
+        box = lsst.geom.Box2I(lsst.geom.Point2I(40, 60), lsst.geom.Extent2I(77, 201))
+
+        for approxStyle in (afwMath.ApproximateControl.UNKNOWN, afwMath.ApproximateControl.CHEBYSHEV):
+            bgCtrl = afwMath.BackgroundControl(afwMath.Interpolate.AKIMA_SPLINE, 6, 6)
+            bgCtrl.setApproximateControl(afwMath.ApproximateControl(approxStyle, 3))
+            bkgd = afwMath.makeBackground(mimg, bgCtrl)
+            bgImage = bkgd.getImageF()
+            if approxStyle != afwMath.ApproximateControl.UNKNOWN:
+                bgImage.setXY0(bbox.getMin())  # getImage returns approximations in LOCAL coordinates
+
+            view = afwMath.BackgroundImageView(bkgd)
+            self.assertEqual(view.getBBox(), bbox)
+            self.assertImagesEqual(view.evaluate(bbox), bgImage)
+            self.assertImagesEqual(view.evaluate(box), bgImage[box])
+
+            for numThreads in (1, 3):
+                bgCtrl.setNumThreads(numThreads)
+                view = afwMath.BackgroundImageView(afwMath.makeBackground(mimg, bgCtrl),
+                                                   afwMath.Interpolate.AKIMA_SPLINE)
+                subtracted = mimg.clone()
+                view.subtractFrom(subtracted)
+                np.testing.assert_array_equal(subtracted.image.array, mimg.image.array - bgImage.array)
+                np.testing.assert_array_equal(subtracted.variance.array, mimg.variance.array)
+
+                subImage = afwImage.ImageD(box)
+                subImage.array[:] = mimg.image[box].array
+                view.subtractFrom(subImage)
+                np.testing.assert_array_equal(subImage.array,
+                                              mimg.image[box].array.astype(np.float64)
+                                              - bgImage[box].array.astype(np.float64))
+
+            outside = lsst.geom.Box2I(lsst.geom.Point2I(-10, 0), lsst.geom.Extent2I(5, 5))
+            with self.assertRaises(lsst.pex.exceptions.LengthError):
+                view.evaluate(outside)
+            with self.assertRaises(lsst.pex.exceptions.LengthError):
+                view.subtractFrom(afwImage.ImageF(outside))
+
+        # undersampled styles are checked up front
+        bgCtrl = afwMath.BackgroundControl(afwMath.Interpolate.AKIMA_SPLINE, 2, 2)
+        bkgd = afwMath.makeBackground(mimg, bgCtrl)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            afwMath.BackgroundImageView(bkgd)
+        view = afwMath.BackgroundImageView(bkgd, afwMath.Interpolate.AKIMA_SPLINE,
+                                           afwMath.REDUCE_INTERP_ORDER)
+        self.assertImagesEqual(view.evaluate(bbox),
+                               bkgd.getImageF(afwMath.Interpolate.AKIMA_SPLINE, afwMath.REDUCE_INTERP_ORDER))
+
+
+    def testUpdate(self):
+        """Test that updating a background after a mask change matches re-estimating it"""
+        rng = np.random.RandomState(11235)
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(-4, 13), lsst.geom.Extent2I(250, 230))
+        mimg = afwImage.MaskedImageF(bbox)
+        y, x = np.mgrid[0:bbox.getHeight(), 0:bbox.getWidth()]
+        mimg.image.array[:] = 100.0 + 0.01*x + 0.02*y + rng.normal(0.0, 1.0, size=x.shape)
+        mimg.variance.array[:] = 1.0
+        detected = mimg.mask.getPlaneBitMask("DETECTED")
+
+        bgCtrl = afwMath.BackgroundControl(afwMath.Interpolate.AKIMA_SPLINE, 7, 6)
+        bgCtrl.getStatisticsControl().setAndMask(detected)
+        bgCtrl.setNumThreads(3)
+        bkgd = afwMath.makeBackground(mimg, bgCtrl)
+        bkgd.getImageF()
+
+        # add a bright, detected source
+        source = lsst.geom.Box2I(lsst.geom.Point2I(60, 80), lsst.geom.Extent2I(30, 20))
+        mimg.image[source].array += 50.0
+        mimg.mask[source].array |= detected
+        bkgd.update(mimg, source)
+        expected = afwMath.makeBackground(mimg, bgCtrl)
+        self.assertMaskedImagesEqual(bkgd.getStatsImage(), expected.getStatsImage())
+        self.assertImagesEqual(bkgd.getImageF(), expected.getImageF())
+
+        # the same with a bitmap of the cells to measure
+        mimg.mask[source].array &= ~detected
+        dirtyCells = np.zeros((6, 7), dtype=bool)
+        dirtyCells[1:3, 1:3] = True  # the cells overlapping the source
+        bkgd.update(mimg, dirtyCells)
+        expected = afwMath.makeBackground(mimg, bgCtrl)
+        self.assertMaskedImagesEqual(bkgd.getStatsImage(), expected.getStatsImage())
+        self.assertImagesEqual(bkgd.getImageF(), expected.getImageF())
+
+        # writing to the statsImage still changes the background
+        statsImage = bkgd.getStatsImage()
+        statsImage.image.array[3, 4] += 10.0
+        styles = (afwMath.Interpolate.AKIMA_SPLINE, afwMath.THROW_EXCEPTION)
+        self.assertImagesEqual(bkgd.getImageF(*styles),
+                               afwMath.BackgroundMI(bbox, statsImage).getImageF(*styles))
+
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            bkgd.update(mimg[source], source)
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            bkgd.update(mimg, np.zeros((7, 6), dtype=bool))
+
+    def testBackgroundListView(self):
+        """Test that a BackgroundListView sums its backgrounds as BackgroundList.getImage did"""
+        rng = np.random.RandomState(86420)
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(5, -9), lsst.geom.Extent2I(211, 290))
+        mimg = afwImage.MaskedImageF(bbox)
+        y, x = np.mgrid[0:bbox.getHeight(), 0:bbox.getWidth()]
+        mimg.image.array[:] = 100.0 + 0.01*x + 0.02*y + rng.normal(0.0, 1.0, size=x.shape)
+        mimg.variance.array[:] = 1.0
+        box = lsst.geom.Box2I(lsst.geom.Point2I(40, 60), lsst.geom.Extent2I(77, 201))
+
+        backgroundList = afwMath.BackgroundList()
+        expected = afwImage.ImageF(bbox)
+        for nx, approxStyle in ((4, afwMath.ApproximateControl.UNKNOWN),
+                                (6, afwMath.ApproximateControl.CHEBYSHEV),
+                                (9, afwMath.ApproximateControl.UNKNOWN)):
+            bgCtrl = afwMath.BackgroundControl(afwMath.Interpolate.AKIMA_SPLINE, nx, nx)
+            bgCtrl.setApproximateControl(afwMath.ApproximateControl(approxStyle, 3))
+            bgCtrl.setNumThreads(3)
+            bkgd = afwMath.makeBackground(mimg, bgCtrl)
+            backgroundList.append((bkgd, afwMath.Interpolate.AKIMA_SPLINE, afwMath.REDUCE_INTERP_ORDER,
+                                   approxStyle, 3, 3, True))
+            expected += afwMath.BackgroundImageView(bkgd, afwMath.Interpolate.AKIMA_SPLINE,
+                                                    afwMath.REDUCE_INTERP_ORDER).evaluate(bbox)
+            # the images are added in the same order, in the same precision
+            self.assertImagesEqual(backgroundList.getImage(), expected)
+
+        view = backgroundList.getImageView()
+        self.assertEqual(len(view), 3)
+        self.assertEqual(view.getBBox(), bbox)
+        self.assertImagesEqual(view.evaluate(bbox), expected)
+        self.assertImagesEqual(view.evaluate(box), expected[box])
+
+        subtracted = mimg.clone()
+        backgroundList.subtractFrom(subtracted)
+        np.testing.assert_array_equal(subtracted.image.array, mimg.image.array - expected.array)
+        np.testing.assert_array_equal(subtracted.variance.array, mimg.variance.array)
+        subImage = afwImage.ImageD(box)
+        subImage.array[:] = mimg.image[box].array
+        view.subtractFrom(subImage)
+        np.testing.assert_array_equal(subImage.array, mimg.image[box].array.astype(np.float64)
+                                      - expected[box].array.astype(np.float64))
+
+        outside = lsst.geom.Box2I(lsst.geom.Point2I(-10, 0), lsst.geom.Extent2I(5, 5))
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            view.evaluate(outside)
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            view.subtractFrom(afwImage.ImageF(outside))
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            afwMath.BackgroundListView([])
+        other = afwMath.makeBackground(mimg[box], afwMath.BackgroundControl(4, 4))
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            afwMath.BackgroundListView([afwMath.BackgroundImageView(backgroundList[0][0]),
+                                        afwMath.BackgroundImageView(other)])
+        self.assertIsNone(afwMath.BackgroundList().getImage())
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
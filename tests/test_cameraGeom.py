@@ -29,19 +29,24 @@ import lsst.utils.tests
 import lsst.pex.exceptions as pexExcept
 import lsst.geom
 import lsst.afw.image as afwImage
+import lsst.afw.math as afwMath
 import lsst.afw.display as afwDisplay
 from lsst.afw.cameraGeom import (
     AmplifierIsolator,
     assembleAmplifierImage,
     assembleAmplifierRawImage,
+    assembleDetectorImage,
     Camera,
     CameraSys,
     CameraSysPrefix,
+    correctAmplifiers,
     Detector,
     DetectorCollection,
     FIELD_ANGLE,
     FOCAL_PLANE,
     makeUpdatedDetector,
+    measureOverscanLevels,
+    measureOverscanRows,
     Orientation,
     PIXELS,
 )
@@ -269,6 +274,31 @@ class CameraGeomTestCase(lsst.utils.tests.TestCase):
             for dets in detList:
                 self.assertEqual(len(dets), 1)
 
+    def testFindDetectorsMatchesBruteForce(self):
+        """Test that findDetectors and findDetectorsList agree with checking
+        every detector's bounding box, including near detector edges and off
+        the focal plane
+        """
+        rng = np.random.RandomState(5)
+        for cw in self.cameraList:
+            camera = cw.camera
+            fpBBox = camera.getFpBBox()
+            fpBBox.grow(0.1*max(fpBBox.getWidth(), fpBBox.getHeight()))
+            pointList = [lsst.geom.Point2D(x, y) for x, y in
+                         zip(rng.uniform(fpBBox.getMinX(), fpBBox.getMaxX(), 500),
+                             rng.uniform(fpBBox.getMinY(), fpBBox.getMaxY(), 500))]
+            for det in camera:
+                pointList += det.getCorners(FOCAL_PLANE)
+            detListList = camera.findDetectorsList(pointList, FOCAL_PLANE)
+            self.assertEqual(len(detListList), len(pointList))
+            for point, detList in zip(pointList, detListList):
+                expected = [det.getName() for det in camera
+                            if lsst.geom.Box2D(det.getBBox()).contains(
+                                det.transform(point, FOCAL_PLANE, PIXELS))]
+                self.assertEqual(sorted(d.getName() for d in detList), sorted(expected))
+                self.assertEqual([d.getName() for d in camera.findDetectors(point, FOCAL_PLANE)],
+                                 [d.getName() for d in detList])
+
     def testFpBbox(self):
         for cw in self.cameraList:
             camera = cw.camera
@@ -324,6 +354,17 @@ class CameraGeomTestCase(lsst.utils.tests.TestCase):
                     for amp, im in zip(det, imList):
                         assemble(outImage, im, amp)
                     self.assertImagesEqual(outImage, detectorImageMap[trim])
+                    # The C++ assembly of all amplifiers at once must agree.
+                    for numThreads in (1, 0):
+                        assembled = assembleDetectorImage(det, imList, isTrimmed=trim, numThreads=numThreads)
+                        self.assertEqual(assembled.getBBox(), outBbox)
+                        self.assertImagesEqual(assembled, detectorImageMap[trim])
+                    if all(im is imList[0] for im in imList):
+                        self.assertImagesEqual(assembleDetectorImage(det, imList[0], isTrimmed=trim),
+                                               detectorImageMap[trim])
+                    maskedImList = [afwImage.MaskedImageU(im) for im in imList]
+                    assembledMasked = assembleDetectorImage(det, maskedImList, isTrimmed=trim, numThreads=0)
+                    self.assertImagesEqual(assembledMasked.image, detectorImageMap[trim])
                     # Test going from detector images back to single-amplifier
                     # images.
                     detector_exposure = afwImage.ExposureU(afwImage.MaskedImageU(detectorImageMap[trim]))
@@ -342,6 +383,63 @@ class CameraGeomTestCase(lsst.utils.tests.TestCase):
                                              amp_exposure.getBBox())
                             self.assertImagesEqual(im[amp.getRawDataBBox()], amp_exposure.image)
 
+    def testAmplifierCorrections(self):
+        camera = self.scCamWrapper.camera
+        raw = self.assemblyList[camera.getName()][0].convertF()
+        builder = camera['R:0,0 S:1,0'].rebuild()
+        for i in range(len(builder)):
+            builder[i].setGain(1.5 + 0.25*i)
+            if i % 2 == 0:
+                builder[i].setLinearityType("Polynomial")
+                builder[i].setLinearityCoeffs(np.array([1e-6, -2e-11]))
+            else:
+                builder[i].setLinearityType("None")
+        det = builder.finish()
+        for numThreads in (1, 0):
+            levels = measureOverscanLevels(det, raw, numThreads=numThreads)
+            means = measureOverscanLevels(det, raw, afwMath.MEAN, numThreads=numThreads)
+            rows = measureOverscanRows(det, raw, numThreads=numThreads)
+            self.assertEqual(len(levels), len(det))
+            self.assertEqual(len(rows), len(det))
+            corrected = raw.clone()
+            correctAmplifiers(corrected, det, rows, numThreads=numThreads)
+            for amp, level, mean, ampRows in zip(det, levels, means, rows):
+                overscan = raw[amp.getRawHorizontalOverscanBBox()].array
+                self.assertAlmostEqual(level, np.median(overscan))
+                self.assertAlmostEqual(mean, np.mean(overscan.astype(np.float64)))
+                dataBBox = amp.getRawDataBBox()
+                y0 = dataBBox.getMinY() - amp.getRawHorizontalOverscanBBox().getMinY()
+                self.assertFloatsAlmostEqual(
+                    ampRows, np.median(overscan[y0:y0 + dataBBox.getHeight()], axis=1))
+                u = raw[dataBBox].array.astype(np.float64) - ampRows[:, np.newaxis]
+                if amp.getLinearityType() == "Polynomial":
+                    c = amp.getLinearityCoeffs()
+                    u += c[0]*u**2 + c[1]*u**3
+                self.assertFloatsAlmostEqual(corrected[dataBBox].array, u*amp.getGain(), rtol=1e-6)
+                self.assertImagesEqual(corrected[amp.getRawHorizontalOverscanBBox()],
+                                       raw[amp.getRawHorizontalOverscanBBox()])
+
+        # A single offset per amplifier, without linearity or gain
+        corrected = raw.clone()
+        correctAmplifiers(corrected, det, [np.array([level]) for level in levels],
+                          doLinearity=False, doGain=False)
+        for amp, level in zip(det, levels):
+            self.assertFloatsAlmostEqual(corrected[amp.getRawDataBBox()].array,
+                                         raw[amp.getRawDataBBox()].array - level, rtol=1e-6)
+
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            measureOverscanLevels(det, raw, afwMath.STDEV)
+        with self.assertRaises(pexExcept.LengthError):
+            correctAmplifiers(raw.clone(), det, rows[:-1])
+        with self.assertRaises(pexExcept.LengthError):
+            correctAmplifiers(raw.clone(), det, [np.zeros(2)]*len(det))
+        builder = det.rebuild()
+        builder[0].setLinearityType("LookupTable")
+        lookupDet = builder.finish()
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            correctAmplifiers(raw.clone(), lookupDet, [])
+        correctAmplifiers(raw.clone(), lookupDet, [], doLinearity=False)
+
     @unittest.skipIf(not display, "display variable not set; skipping cameraGeomUtils test")
     def testCameraGeomUtils(self):
         for cw in self.cameraList:
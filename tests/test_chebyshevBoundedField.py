@@ -115,6 +115,31 @@ class ChebyshevBoundedFieldTestCase(lsst.utils.tests.TestCase):
         self.assertFloatsAlmostEqual(image1.array, image3.array, rtol=1.5E-2, atol=1.5E-2)
         self.assertFloatsAlmostEqual(image1.array, image4.array, rtol=2E-2, atol=2E-2)
 
+    def testEvaluateGrid(self):
+        """Test that evaluateGrid and the image methods built on it agree with evaluate"""
+        for field in self.fields:
+            grid = field.evaluateGrid(self.x1d, self.y1d)
+            self.assertEqual(grid.shape, (self.y1d.size, self.x1d.size))
+            self.assertFloatsAlmostEqual(grid, field.evaluate(self.xFlat, self.yFlat).reshape(grid.shape),
+                                         rtol=1E-12, atol=1E-12)
+
+        # tall enough that the image is evaluated in several bands of rows
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(-3, 7), lsst.geom.Extent2I(31, 150))
+        field = lsst.afw.math.ChebyshevBoundedField(bbox, self.cases[-2][1])
+        # ProductBoundedField uses the default, row-by-row, evaluateGrid
+        reference = lsst.afw.math.ProductBoundedField([field])
+        x, y = np.meshgrid(np.arange(bbox.getBeginX(), bbox.getEndX(), dtype=float),
+                           np.arange(bbox.getBeginY(), bbox.getEndY(), dtype=float))
+        expect = field.evaluate(x.ravel(), y.ravel()).reshape(x.shape)
+        for xStep, yStep in [(1, 1), (3, 1), (1, 4), (5, 7)]:
+            image = lsst.afw.image.ImageD(bbox)
+            field.fillImage(image, xStep=xStep, yStep=yStep)
+            referenceImage = lsst.afw.image.ImageD(bbox)
+            reference.fillImage(referenceImage, xStep=xStep, yStep=yStep)
+            self.assertFloatsAlmostEqual(image.array, referenceImage.array, rtol=1E-12, atol=1E-12)
+            if xStep == 1 and yStep == 1:
+                self.assertFloatsAlmostEqual(image.array, expect, rtol=1E-12, atol=1E-12)
+
     def testEvaluate(self):
         """Test the single-point evaluate method against explicitly-defined 1-d Chebyshevs
         (at the top of this file).
@@ -349,6 +374,27 @@ class ChebyshevBoundedFieldTestCase(lsst.utils.tests.TestCase):
                 self.assertFloatsAlmostEqual(
                     outField.getCoefficients(), coefficients, rtol=1E-6, atol=1E-7)
 
+    def testImageFitMultithreaded(self):
+        """Test that fitting an image on several threads solves the same least-squares problem as
+        fitting its pixels as arrays.
+        """
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(-4, 3), lsst.geom.Extent2I(37, 23))
+        image = lsst.afw.image.ImageD(bbox)
+        image.array[:, :] = np.random.randn(*image.array.shape)
+        x, y = np.meshgrid(np.arange(bbox.getBeginX(), bbox.getEndX(), dtype=float),
+                           np.arange(bbox.getBeginY(), bbox.getEndY(), dtype=float))
+        for ctrl, _ in self.cases[::7]:
+            expected = lsst.afw.math.ChebyshevBoundedField.fit(bbox, x.ravel(), y.ravel(),
+                                                               image.array.ravel(), ctrl)
+            ctrl.numThreads = 1
+            serial = lsst.afw.math.ChebyshevBoundedField.fit(image, ctrl)
+            ctrl.numThreads = 4
+            threaded = lsst.afw.math.ChebyshevBoundedField.fit(image, ctrl)
+            self.assertFloatsAlmostEqual(serial.getCoefficients(), expected.getCoefficients(),
+                                         rtol=1E-10, atol=1E-12)
+            self.assertFloatsAlmostEqual(threaded.getCoefficients(), serial.getCoefficients(),
+                                         rtol=1E-10, atol=1E-12)
+
     def testArrayFit(self):
         """Test that we can fit 1-d arrays produced by a ChebyshevBoundedField and
         get the same coefficients back.
@@ -0,0 +1,114 @@
+# This file is part of afw.
+#
+# Developed for the LSST Data Management System.
+# This product includes software developed by the LSST Project
+# (https://www.lsst.org).
+# See the COPYRIGHT file at the top-level directory of this distribution
+# for details of code ownership.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+"""
+Tests for lsst.afw.table.ColumnStore
+
+Run with:
+   python test_columnStore.py
+or
+   pytest test_columnStore.py
+"""
+import unittest
+
+import numpy as np
+
+import lsst.utils.tests
+import lsst.pex.exceptions
+import lsst.geom
+import lsst.afw.table
+
+
+class ColumnStoreTestCase(lsst.utils.tests.TestCase):
+
+    def setUp(self):
+        schema = lsst.afw.table.SourceTable.makeMinimalSchema()
+        schema.addField("i", type="I", doc="int32")
+        schema.addField("d", type="D", doc="double")
+        schema.addField("a", type="ArrayF", doc="float array", size=3)
+        schema.addField("s", type="String", doc="string", size=4)
+        schema.addField("vf", type="ArrayF", doc="variable-length array", size=0)
+        for n in range(70):
+            schema.addField(f"flag{n}", type="Flag", doc="flag")
+        rng = np.random.RandomState(3)
+        self.catalog = lsst.afw.table.SourceCatalog(schema)
+        self.catalog.resize(101)
+        self.catalog["id"] = np.arange(1, 102)
+        self.catalog["i"] = rng.randint(-1000, 1000, size=101)
+        self.catalog["d"] = rng.randn(101)
+        self.catalog["a"] = rng.randn(101, 3)
+        self.catalog["coord_ra"] = rng.rand(101)
+        for n in range(70):
+            self.catalog[f"flag{n}"] = rng.rand(101) < 0.5
+
+    def tearDown(self):
+        del self.catalog
+
+    def testColumns(self):
+        """Test that the stored columns are contiguous and match the catalog,
+        for both contiguous and non-contiguous catalogs.
+        """
+        for catalog, nThreads in [(self.catalog, 1), (self.catalog, 4), (self.catalog[::3], 0)]:
+            store = lsst.afw.table.ColumnStore(catalog, nThreads)
+            expected = catalog.copy(deep=True)
+            self.assertEqual(len(store), len(catalog))
+            self.assertEqual(store.schema, catalog.schema)
+            for name in ["id", "i", "d", "a", "coord_ra", "flag0", "flag63", "flag69"]:
+                column = store[name]
+                self.assertTrue(column.flags.c_contiguous)
+                np.testing.assert_array_equal(column, expected[name])
+            with self.assertRaises(lsst.pex.exceptions.NotFoundError):
+                store["s"]
+            with self.assertRaises(lsst.pex.exceptions.NotFoundError):
+                store["vf"]
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            lsst.afw.table.ColumnStore(self.catalog, -1)
+
+    def testAssign(self):
+        """Test that changes to the columns can be copied back to a catalog.
+        """
+        store = lsst.afw.table.ColumnStore(self.catalog)
+        store["d"][:] *= 2.0
+        store["flag5"][:] = np.logical_not(store["flag5"])
+        expected = self.catalog.copy(deep=True)
+        store.assignTo(self.catalog, 3)
+        np.testing.assert_array_equal(self.catalog["d"], 2.0*expected["d"])
+        np.testing.assert_array_equal(self.catalog["flag5"], np.logical_not(expected["flag5"]))
+        np.testing.assert_array_equal(self.catalog["flag6"], expected["flag6"])
+        np.testing.assert_array_equal(self.catalog["a"], expected["a"])
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            store.assignTo(self.catalog[:10])
+        other = lsst.afw.table.BaseCatalog(lsst.afw.table.Schema())
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            store.assignTo(other)
+
+
+class MemoryTester(lsst.utils.tests.MemoryTestCase):
+    pass
+
+
+def setup_module(module):
+    lsst.utils.tests.init()
+
+
+if __name__ == "__main__":
+    lsst.utils.tests.init()
+    unittest.main()
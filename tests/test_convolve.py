@@ -35,6 +35,7 @@ import numpy
 import lsst.utils
 import lsst.utils.tests
 import lsst.geom
+import lsst.pex.exceptions
 import lsst.afw.image as afwImage
 import lsst.afw.math as afwMath
 import lsst.afw.math.detail as mathDetail
@@ -384,6 +385,16 @@ class ConvolveTestCase(lsst.utils.tests.TestCase):
             self.assertEqual(
                 convControl.getMaxInterpolationDistance(), maxInterpDist)
 
+        self.assertEqual(convControl.getNumThreads(), 1)
+        for numThreads in (0, 1, 4):
+            convControl.setNumThreads(numThreads)
+            self.assertEqual(convControl.getNumThreads(), numThreads)
+
+        self.assertEqual(convControl.getMinFftKernelSize(), 0)
+        for minFftKernelSize in (0, 1, 15):
+            convControl.setMinFftKernelSize(minFftKernelSize)
+            self.assertEqual(convControl.getMinFftKernelSize(), minFftKernelSize)
+
     @unittest.skipIf(dataDir is None, "afwdata not setup")
     def testUnityConvolution(self):
         """Verify that convolution with a centered delta function reproduces the original.
@@ -697,6 +708,287 @@ class ConvolveTestCase(lsst.utils.tests.TestCase):
                 maxInterpDist=maxInterpDist,
                 rtol=rtol)
 
+    def testImageMatchesMaskedImage(self):
+        """Test that the row-oriented Image code matches the image plane of MaskedImage convolution
+
+        MaskedImage pixel arithmetic multiplies in the image pixel type, so the results
+        are only required to be identical for double precision images.
+        """
+        rng = numpy.random.RandomState(54321)
+        for pixelType, outType, rtol in (("F", "F", 1e-6), ("F", "D", 1e-6), ("D", "D", 0.0)):
+            inMaskedImage = afwImage.MaskedImage[pixelType](lsst.geom.Extent2I(45, 38))
+            inMaskedImage.image.array[:, :] = rng.uniform(0.0, 1000.0, inMaskedImage.image.array.shape)
+            kernelImage = afwImage.ImageD(5, 4)
+            kernelImage.array[:, :] = rng.uniform(0.0, 1.0, kernelImage.array.shape)
+            kernelImage.array[1, 2] = 0.0  # exercise zero-skipping
+            gaussFunc1 = afwMath.GaussianFunction1D(1.3)
+            for kernel in (afwMath.FixedKernel(kernelImage),
+                           afwMath.SeparableKernel(7, 6, gaussFunc1, gaussFunc1)):
+                with self.subTest(pixelType=pixelType, outType=outType, kernel=type(kernel).__name__):
+                    cnvImage = afwImage.Image[outType](inMaskedImage.getDimensions())
+                    afwMath.convolve(cnvImage, inMaskedImage.image, kernel, afwMath.ConvolutionControl())
+                    cnvMaskedImage = afwImage.MaskedImage[outType](inMaskedImage.getDimensions())
+                    afwMath.convolve(cnvMaskedImage, inMaskedImage, kernel, afwMath.ConvolutionControl())
+                    self.assertImagesAlmostEqual(cnvImage, cnvMaskedImage.image, rtol=rtol, atol=0.0)
+
+    def testMaskedImagePlanes(self):
+        """Test the image, mask and variance planes of MaskedImage convolution against refConvolve
+
+        The planes are computed together in one pass; the mask must be the OR of the input mask
+        pixels under nonzero kernel pixels, and the variance must be weighted by the squared kernel.
+        """
+        rng = numpy.random.RandomState(24680)
+        inMaskedImage = afwImage.MaskedImageD(lsst.geom.Extent2I(41, 37))
+        inMaskedImage.image.array[:, :] = rng.normal(100.0, 10.0, inMaskedImage.image.array.shape)
+        inMaskedImage.variance.array[:, :] = rng.uniform(50.0, 150.0, inMaskedImage.variance.array.shape)
+        inMaskedImage.mask.array[:, :] = numpy.where(rng.uniform(size=inMaskedImage.mask.array.shape) < 0.05,
+                                                     1 << rng.randint(0, 4, inMaskedImage.mask.array.shape), 0)
+        kernelImage = afwImage.ImageD(5, 6)
+        kernelImage.array[:, :] = rng.uniform(0.1, 1.0, kernelImage.array.shape)
+        kernelImage.array[2, 3] = 0.0  # masks under zero kernel pixels must not be smeared
+        gaussFunc1 = afwMath.GaussianFunction1D(1.3)
+        imMaskVar = (inMaskedImage.image.array, inMaskedImage.mask.array, inMaskedImage.variance.array)
+        for kernel in (afwMath.FixedKernel(kernelImage),
+                       afwMath.SeparableKernel(7, 6, gaussFunc1, gaussFunc1)):
+            with self.subTest(kernel=type(kernel).__name__):
+                refMaskedImage = afwImage.makeMaskedImageFromArrays(
+                    *refConvolve(imMaskVar, inMaskedImage.getXY0(), kernel, True, False))
+                cnvMaskedImage = afwImage.MaskedImageD(inMaskedImage.getDimensions())
+                afwMath.convolve(cnvMaskedImage, inMaskedImage, kernel, afwMath.ConvolutionControl())
+                self.assertMaskedImagesAlmostEqual(cnvMaskedImage, refMaskedImage, rtol=1e-10)
+
+    def testMaskDilation(self):
+        """Test that the mask of a convolved MaskedImage is the same for sparse and dense masks
+
+        Sparse masks are convolved by dilating the pixels of each mask plane by the kernel,
+        dense masks by OR-ing the mask under each kernel pixel; both must match refConvolve.
+        """
+        rng = numpy.random.RandomState(13579)
+        dims = lsst.geom.Extent2I(61, 45)
+        sparseMask = numpy.zeros((dims.getY(), dims.getX()), dtype=numpy.int32)
+        sparseMask[10:20, 5:9] = 1
+        sparseMask[15:40, 30:32] |= 2
+        sparseMask[0, :] = 4
+        sparseMask[rng.randint(0, dims.getY(), 20), rng.randint(0, dims.getX(), 20)] |= 1 << 30
+        denseMask = rng.randint(0, 16, (dims.getY(), dims.getX())).astype(numpy.int32)
+        kernelImage = afwImage.ImageD(9, 7)
+        kernelImage.array[:, :] = rng.uniform(0.1, 1.0, kernelImage.array.shape)
+        kernelImage.array[2:5, 3:6] = 0.0  # a hole, which must not smear the mask
+        kernelImage.array[:, 8] = 0.0
+        kernel = afwMath.FixedKernel(kernelImage)
+        for maskDescr, maskArray in (("sparse", sparseMask), ("dense", denseMask)):
+            inMaskedImage = afwImage.MaskedImageD(dims)
+            inMaskedImage.image.array[:, :] = rng.normal(100.0, 10.0, inMaskedImage.image.array.shape)
+            inMaskedImage.variance.array[:, :] = rng.uniform(50.0, 150.0,
+                                                             inMaskedImage.variance.array.shape)
+            inMaskedImage.mask.array[:, :] = maskArray
+            inMaskedImage.setXY0(-7, 12)
+            imMaskVar = (inMaskedImage.image.array, inMaskedImage.mask.array, inMaskedImage.variance.array)
+            refMaskedImage = afwImage.makeMaskedImageFromArrays(
+                *refConvolve(imMaskVar, inMaskedImage.getXY0(), kernel, True, False))
+            for numThreads in (1, 3):
+                with self.subTest(mask=maskDescr, numThreads=numThreads):
+                    convControl = afwMath.ConvolutionControl()
+                    convControl.setNumThreads(numThreads)
+                    cnvMaskedImage = afwImage.MaskedImageD(dims)
+                    afwMath.convolve(cnvMaskedImage, inMaskedImage, kernel, convControl)
+                    self.assertMaskedImagesAlmostEqual(cnvMaskedImage, refMaskedImage, rtol=1e-10)
+
+    def testBasisConvolutionCache(self):
+        """Test that BasisConvolutionCache matches convolve and reuses basis convolutions
+        """
+        rng = numpy.random.RandomState(13579)
+        sFunc = afwMath.PolynomialFunction2D(1)
+        basisKernelList = makeGaussianKernelList(7, 6, ((1.5, 1.5, 0.0), (2.5, 1.5, 0.0), (2.5, 2.5, 0.0)))
+        spatialParamsList = (
+            ((1.0, -0.001, -0.001), (0.0, 0.001, 0.0), (0.0, 0.0, 0.001)),
+            ((0.5, 0.002, 0.0), (0.5, 0.0, -0.001), (0.1, 0.0, 0.0)),
+        )
+        for imageClass, cacheClass, rtol in ((afwImage.ImageD, afwMath.BasisConvolutionCacheD, 1e-10),
+                                             (afwImage.ImageF, afwMath.BasisConvolutionCacheF, 1e-5)):
+            inImage = imageClass(lsst.geom.Extent2I(45, 52))
+            inImage.array[:, :] = rng.normal(100.0, 10.0, inImage.array.shape)
+            inImage.setXY0(20, 30)
+            cache = cacheClass()
+            for spatialParams in spatialParamsList:
+                # a new kernel on each iteration, as a fit might construct
+                kernel = afwMath.LinearCombinationKernel(basisKernelList, sFunc)
+                kernel.setSpatialParameters(spatialParams)
+                for doNormalize in (False, True):
+                    with self.subTest(imageClass=imageClass, spatialParams=spatialParams,
+                                      doNormalize=doNormalize):
+                        convControl = afwMath.ConvolutionControl(doNormalize, False, 0)
+                        refImage = imageClass(inImage.getDimensions())
+                        afwMath.convolve(refImage, inImage, kernel, convControl)
+                        cnvImage = imageClass(inImage.getDimensions())
+                        cache.convolve(cnvImage, inImage, kernel, convControl)
+                        self.assertTrue(cache.isCached(inImage, kernel))
+                        self.assertEqual(cnvImage.getXY0(), inImage.getXY0())
+                        self.assertImagesAlmostEqual(cnvImage, refImage, rtol=rtol, atol=0.0)
+
+            self.assertFalse(cache.isCached(imageClass(inImage, deep=True), kernel))
+            otherBasisKernelList = makeGaussianKernelList(7, 6,
+                                                          ((1.5, 1.5, 0.0), (2.0, 1.5, 0.0), (2.5, 2.5, 0.0)))
+            self.assertFalse(cache.isCached(inImage, afwMath.LinearCombinationKernel(otherBasisKernelList,
+                                                                                     sFunc)))
+            cache.clear()
+            self.assertFalse(cache.isCached(inImage, kernel))
+
+            with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+                cache.convolve(imageClass(10, 10), inImage, kernel)
+
+    def testDeltaFunctionBasisConvolve(self):
+        """Test that convolving with a spatially varying delta function basis matches brute force
+
+        The reference is the same kernel with each delta function basis kernel replaced by
+        an equivalent FixedKernel, and so is convolved by computing a kernel image at each pixel.
+        """
+        rng = numpy.random.RandomState(54321)
+        inMaskedImage = afwImage.MaskedImageF(lsst.geom.Extent2I(53, 47))
+        inMaskedImage.image.array[:, :] = rng.normal(100.0, 10.0, inMaskedImage.image.array.shape)
+        inMaskedImage.variance.array[:, :] = rng.uniform(50.0, 150.0, inMaskedImage.variance.array.shape)
+        inMaskedImage.mask.array[:, :] = rng.randint(0, 4, inMaskedImage.mask.array.shape)
+        inMaskedImage.setXY0(20, -10)
+
+        kWidth = 5
+        kHeight = 4
+        # include a repeated basis kernel, whose coefficients must be summed
+        deltaKernelList = makeDeltaFunctionKernelList(kWidth, kHeight)
+        deltaKernelList.append(afwMath.DeltaFunctionKernel(kWidth, kHeight, lsst.geom.Point2I(2, 1)))
+        fixedKernelList = []
+        for basisKernel in deltaKernelList:
+            basisImage = afwImage.ImageD(basisKernel.getDimensions())
+            basisKernel.computeImage(basisImage, False)
+            fixedKernelList.append(afwMath.FixedKernel(basisImage))
+        sFunc = afwMath.PolynomialFunction2D(1)
+        sParams = [(1.0 + rng.uniform(), rng.uniform(-1e-3, 1e-3), rng.uniform(-1e-3, 1e-3))
+                   for i in range(len(deltaKernelList))]
+        deltaKernel = afwMath.LinearCombinationKernel(deltaKernelList, sFunc)
+        deltaKernel.setSpatialParameters(sParams)
+        self.assertTrue(deltaKernel.isDeltaFunctionBasis())
+        fixedKernel = afwMath.LinearCombinationKernel(fixedKernelList, sFunc)
+        fixedKernel.setSpatialParameters(sParams)
+        self.assertFalse(fixedKernel.isDeltaFunctionBasis())
+
+        for doNormalize in (False, True):
+            refControl = afwMath.ConvolutionControl(doNormalize)
+            refControl.setMaxInterpolationDistance(0)
+            refMaskedImage = afwImage.MaskedImageF(inMaskedImage.getDimensions())
+            afwMath.convolve(refMaskedImage, inMaskedImage, fixedKernel, refControl)
+            refImage = afwImage.ImageF(inMaskedImage.getDimensions())
+            afwMath.convolve(refImage, inMaskedImage.image, fixedKernel, refControl)
+            # the delta function basis is exact, so interpolation is not used even if allowed
+            for maxInterpDist, numThreads in ((0, 1), (10, 1), (10, 3)):
+                with self.subTest(doNormalize=doNormalize, maxInterpDist=maxInterpDist,
+                                  numThreads=numThreads):
+                    convControl = afwMath.ConvolutionControl(doNormalize)
+                    convControl.setMaxInterpolationDistance(maxInterpDist)
+                    convControl.setNumThreads(numThreads)
+                    cnvMaskedImage = afwImage.MaskedImageF(inMaskedImage.getDimensions())
+                    afwMath.convolve(cnvMaskedImage, inMaskedImage, deltaKernel, convControl)
+                    self.assertMaskedImagesAlmostEqual(cnvMaskedImage, refMaskedImage, rtol=1e-6)
+                    cnvImage = afwImage.ImageF(inMaskedImage.getDimensions())
+                    afwMath.convolve(cnvImage, inMaskedImage.image, deltaKernel, convControl)
+                    self.assertImagesAlmostEqual(cnvImage, refImage, rtol=1e-6)
+
+    def testMultithreadedConvolve(self):
+        """Test that convolving on several threads is bit-identical to one thread
+
+        Covers both row-band convolution and (for spatially varying kernels with
+        maxInterpDist > 1) concurrent convolution of interpolation subregions.
+        """
+        rng = numpy.random.RandomState(12345)
+        inMaskedImage = afwImage.MaskedImageF(lsst.geom.Extent2I(67, 83))
+        inMaskedImage.image.array[:, :] = rng.normal(100.0, 10.0, inMaskedImage.image.array.shape)
+        inMaskedImage.variance.array[:, :] = rng.uniform(50.0, 150.0, inMaskedImage.variance.array.shape)
+        inMaskedImage.mask.array[:, :] = rng.randint(0, 4, inMaskedImage.mask.array.shape)
+        inMaskedImage.setXY0(300, 200)
+
+        sFunc = afwMath.PolynomialFunction2D(1)
+        gaussFunc1 = afwMath.GaussianFunction1D(1.0)
+        gaussFunc2 = afwMath.GaussianFunction2D(1.5, 1.0, 0.3)
+        varyingKernel = afwMath.AnalyticKernel(7, 6, afwMath.GaussianFunction2D(1.0, 1.0, 0.0), sFunc)
+        varyingKernel.setSpatialParameters(((1.0, 0.01, 0.0), (1.0, 0.0, 0.01), (0.0, 0.0, 0.0)))
+        basisKernelList = makeGaussianKernelList(5, 5, ((1.5, 1.5, 0.0), (2.5, 1.5, 0.0), (2.5, 2.5, 0.0)))
+        lcKernel = afwMath.LinearCombinationKernel(basisKernelList, sFunc)
+        lcKernel.setSpatialParameters(((1.0, -0.001, -0.001), (0.0, 0.001, 0.0), (0.0, 0.0, 0.001)))
+        deltaKernel = afwMath.LinearCombinationKernel(makeDeltaFunctionKernelList(4, 3), sFunc)
+        deltaKernel.setSpatialParameters([(1.0, 0.001 * i, -0.001 * i) for i in range(12)])
+        kernelList = [
+            ("AnalyticKernel", afwMath.AnalyticKernel(6, 7, gaussFunc2)),
+            ("SeparableKernel", afwMath.SeparableKernel(7, 6, gaussFunc1, gaussFunc1)),
+            ("DeltaFunctionKernel", afwMath.DeltaFunctionKernel(3, 4, lsst.geom.Point2I(1, 2))),
+            ("spatially varying AnalyticKernel", varyingKernel),
+            ("spatially varying LinearCombinationKernel", lcKernel),
+            ("spatially varying delta function LinearCombinationKernel", deltaKernel),
+        ]
+        for kernelDescr, kernel in kernelList:
+            for maxInterpDist in (0, 10):
+                refControl = afwMath.ConvolutionControl()
+                refControl.setMaxInterpolationDistance(maxInterpDist)
+                refMaskedImage = afwImage.MaskedImageF(inMaskedImage.getDimensions())
+                afwMath.convolve(refMaskedImage, inMaskedImage, kernel, refControl)
+                for numThreads in (0, 2, 3, 100):
+                    with self.subTest(kernel=kernelDescr, maxInterpDist=maxInterpDist,
+                                      numThreads=numThreads):
+                        convControl = afwMath.ConvolutionControl()
+                        convControl.setMaxInterpolationDistance(maxInterpDist)
+                        convControl.setNumThreads(numThreads)
+                        cnvMaskedImage = afwImage.MaskedImageF(inMaskedImage.getDimensions())
+                        afwMath.convolve(cnvMaskedImage, inMaskedImage, kernel, convControl)
+                        self.assertMaskedImagesEqual(cnvMaskedImage, refMaskedImage)
+                        self.assertEqual(cnvMaskedImage.getXY0(), inMaskedImage.getXY0())
+
+        convControl = afwMath.ConvolutionControl()
+        convControl.setNumThreads(-1)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            afwMath.convolve(afwImage.MaskedImageF(inMaskedImage.getDimensions()), inMaskedImage,
+                             kernelList[0][1], convControl)
+
+    def testFftConvolve(self):
+        """Test that convolving in Fourier space matches convolving in real space
+
+        Includes a non-finite pixel, whose tile must be convolved in real space so that
+        it only affects the output pixels within a kernel's reach.
+        """
+        rng = numpy.random.RandomState(54321)
+        kernelArr = rng.uniform(0.0, 1.0, (35, 33))
+        kernelArr[3, 5] = 0.0
+        kernelImage = afwImage.ImageD(kernelArr)
+        kernel = afwMath.FixedKernel(kernelImage)
+        kernel.setCtr(lsst.geom.Point2I(12, 20))
+
+        for imageClass, rtol in ((afwImage.ImageF, 1e-5), (afwImage.ImageD, 1e-10)):
+            inImage = imageClass(lsst.geom.Extent2I(301, 257))
+            inImage.array[:, :] = rng.normal(100.0, 10.0, inImage.array.shape)
+            inImage.array[150, 40] = numpy.nan
+            inImage.setXY0(10, -5)
+            for doNormalize in (False, True):
+                refControl = afwMath.ConvolutionControl(doNormalize)
+                refImage = imageClass(inImage.getDimensions())
+                afwMath.convolve(refImage, inImage, kernel, refControl)
+                for numThreads in (1, 3):
+                    with self.subTest(imageClass=imageClass, doNormalize=doNormalize, numThreads=numThreads):
+                        fftControl = afwMath.ConvolutionControl(doNormalize)
+                        fftControl.setMinFftKernelSize(30)
+                        fftControl.setNumThreads(numThreads)
+                        self.assertTrue(mathDetail.shouldConvolveWithFft(kernel, fftControl))
+                        cnvImage = imageClass(inImage.getDimensions())
+                        afwMath.convolve(cnvImage, inImage, kernel, fftControl)
+                        self.assertEqual(cnvImage.getXY0(), inImage.getXY0())
+                        self.assertImagesAlmostEqual(cnvImage, refImage, rtol=rtol, atol=0.0)
+
+        # kernels smaller than the threshold are convolved in real space
+        convControl = afwMath.ConvolutionControl()
+        convControl.setMinFftKernelSize(34)
+        self.assertFalse(mathDetail.shouldConvolveWithFft(kernel, convControl))
+        convControl.setMinFftKernelSize(0)
+        self.assertFalse(mathDetail.shouldConvolveWithFft(kernel, convControl))
+
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            mathDetail.convolveWithFft(afwImage.ImageF(10, 10), afwImage.ImageF(10, 11), kernel,
+                                       afwMath.ConvolutionControl())
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
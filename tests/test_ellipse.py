@@ -111,6 +111,44 @@ class EllipseTestCase(lsst.utils.tests.TestCase):
                 self.assertFloatsAlmostEqual(
                     t1.getParameterVector(), core.getParameterVector())
 
+    def testBatchConversion(self):
+        """Test that the column conversions agree with converting cores
+        one at a time
+        """
+        ellipses = lsst.afw.geom.ellipses
+        quadrupoles = [ellipses.Quadrupole(core) for core in self.cores]
+        ixx, iyy, ixy = (np.array([getattr(q, name)() for q in quadrupoles])
+                         for name in ("getIxx", "getIyy", "getIxy"))
+        a, b, theta = ellipses.convertQuadrupolesToAxes(ixx, iyy, ixy)
+        for q, row in zip(quadrupoles, zip(a, b, theta)):
+            self.assertFloatsEqual(np.array(row), ellipses.Axes(q).getParameterVector())
+        ixx2, iyy2, ixy2 = ellipses.convertAxesToQuadrupoles(a, b, theta)
+        for q, row in zip(quadrupoles, zip(ixx2, iyy2, ixy2)):
+            self.assertFloatsEqual(np.array(row), ellipses.Quadrupole(ellipses.Axes(q)).getParameterVector())
+
+        transform = lsst.geom.LinearTransform(np.random.randn(2, 2))
+        transformed = ellipses.transformQuadrupoles(transform, ixx, iyy, ixy)
+        for q, row in zip(quadrupoles, zip(*transformed)):
+            self.assertFloatsAlmostEqual(np.array(row), q.transform(transform).getParameterVector(),
+                                         rtol=1E-14, atol=1E-14)
+
+        for fromCls in self.classes:
+            inputCores = [fromCls(core) for core in self.cores]
+            # a strided input, as for a catalog column
+            inputs = np.zeros((len(inputCores), 4))
+            inputs[:, :3] = [c.getParameterVector() for c in inputCores]
+            for toCls in self.classes:
+                with self.subTest(fromCls=fromCls.__name__, toCls=toCls.__name__):
+                    result = ellipses.convertCores(inputCores[0].getName(), toCls(inputCores[0]).getName(),
+                                                   inputs[:, :3])
+                    for c, row in zip(inputCores, result):
+                        self.assertFloatsAlmostEqual(row, toCls(c).getParameterVector(),
+                                                     rtol=1E-14, atol=1E-14)
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            ellipses.convertQuadrupolesToAxes(ixx, iyy, ixy[:-1])
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            ellipses.convertCores("Quadrupole", "Axes", np.zeros((3, 2)))
+
     def testPixelRegion(self):
         for core in self.cores:
             with self.subTest(core=str(core)):
@@ -146,6 +184,21 @@ class EllipseTestCase(lsst.utils.tests.TestCase):
                     self.assertTrue(bbox.contains(span.getMin()))
                     self.assertTrue(bbox.contains(span.getMax()))
 
+    def testPixelRegionCache(self):
+        """Test that PixelRegionCache makes the same regions as PixelRegion"""
+        cache = lsst.afw.geom.ellipses.PixelRegionCache(maxSize=3)
+        for center in [lsst.geom.Point2D(*np.random.randn(2)*100) for _ in range(4)]:
+            for core in self.cores:
+                with self.subTest(core=str(core), center=center):
+                    e = lsst.afw.geom.ellipses.Ellipse(core, center)
+                    expected = lsst.afw.geom.ellipses.PixelRegion(e)
+                    region = cache.makePixelRegion(e)
+                    self.assertEqual(region.getBBox(), expected.getBBox())
+                    self.assertEqual(list(region), list(expected))
+                    self.assertEqual(lsst.afw.geom.SpanSet.fromShape(e, cache),
+                                     lsst.afw.geom.SpanSet.fromShape(e))
+        self.assertEqual(len(cache), 3)
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
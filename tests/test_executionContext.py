@@ -0,0 +1,120 @@
+# This file is part of afw.
+#
+# Developed for the LSST Data Management System.
+# This product includes software developed by the LSST Project
+# (https://www.lsst.org).
+# See the COPYRIGHT file at the top-level directory of this distribution
+# for details of code ownership.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+"""Tests for the control of afw's parallel algorithms.
+"""
+
+import threading
+import unittest
+
+import numpy as np
+
+import lsst.utils.tests
+import lsst.geom
+import lsst.pex.exceptions
+import lsst.afw.image as afwImage
+import lsst.afw.math as afwMath
+
+
+class ExecutionContextTestCase(lsst.utils.tests.TestCase):
+
+    def setUp(self):
+        self.maxNumThreads = afwMath.getMaxNumThreads()
+
+    def tearDown(self):
+        afwMath.setMaxNumThreads(self.maxNumThreads)
+
+    def testMaxNumThreads(self):
+        afwMath.setMaxNumThreads(3)
+        self.assertEqual(afwMath.getMaxNumThreads(), 3)
+        self.assertEqual(afwMath.getCurrentMaxNumThreads(), 3)
+        afwMath.setMaxNumThreads(0)
+        self.assertGreaterEqual(afwMath.getMaxNumThreads(), 1)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            afwMath.setMaxNumThreads(-1)
+
+    def testContext(self):
+        afwMath.setMaxNumThreads(4)
+        with afwMath.ExecutionContext(2) as context:
+            self.assertEqual(context.getMaxNumThreads(), 2)
+            self.assertEqual(afwMath.getCurrentMaxNumThreads(), 2)
+            with afwMath.ExecutionContext(1):
+                self.assertEqual(afwMath.getCurrentMaxNumThreads(), 1)
+                # inner contexts can't raise the limit
+                with afwMath.ExecutionContext(3):
+                    self.assertEqual(afwMath.getCurrentMaxNumThreads(), 1)
+            self.assertEqual(afwMath.getCurrentMaxNumThreads(), 2)
+        self.assertEqual(afwMath.getCurrentMaxNumThreads(), 4)
+        # nor above the process-wide limit
+        with afwMath.ExecutionContext(8):
+            self.assertEqual(afwMath.getCurrentMaxNumThreads(), 4)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            afwMath.ExecutionContext(-1)
+
+    def testContextIsPerThread(self):
+        afwMath.setMaxNumThreads(4)
+        seen = []
+        with afwMath.ExecutionContext(1):
+            thread = threading.Thread(target=lambda: seen.append(afwMath.getCurrentMaxNumThreads()))
+            thread.start()
+            thread.join()
+        self.assertEqual(seen, [4])
+
+    def testSerialResults(self):
+        """Test that parallel algorithms give the same results when made serial.
+        """
+        afwMath.setMaxNumThreads(4)
+        rng = np.random.RandomState(5)
+        image = afwImage.ImageF(lsst.geom.Extent2I(60, 80))
+        image.array[:, :] = rng.randn(80, 60)
+        kernel = afwMath.AnalyticKernel(7, 7, afwMath.GaussianFunction2D(1.5, 1.5))
+        control = afwMath.ConvolutionControl()
+        control.setNumThreads(0)
+
+        parallel = afwImage.ImageF(image.getDimensions())
+        afwMath.convolve(parallel, image, kernel, control)
+        serial = afwImage.ImageF(image.getDimensions())
+        with afwMath.ExecutionContext(1):
+            afwMath.convolve(serial, image, kernel, control)
+        self.assertImagesEqual(serial, parallel)
+
+        images = [afwImage.ImageF(image, deep=True) for _ in range(3)]
+        for i, im in enumerate(images):
+            im.array += i
+        sctrl = afwMath.StatisticsControl()
+        sctrl.setNumThreads(0)
+        parallelStack = afwMath.statisticsStack(images, afwMath.MEAN, sctrl)
+        afwMath.setMaxNumThreads(1)
+        serialStack = afwMath.statisticsStack(images, afwMath.MEAN, sctrl)
+        self.assertImagesEqual(serialStack, parallelStack)
+
+
+class TestMemory(lsst.utils.tests.MemoryTestCase):
+    pass
+
+
+def setup_module(module):
+    lsst.utils.tests.init()
+
+
+if __name__ == "__main__":
+    lsst.utils.tests.init()
+    unittest.main()
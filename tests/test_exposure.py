@@ -495,6 +495,42 @@ class ExposureTestCase(lsst.utils.tests.TestCase):
             # check psf property getter
             self.assertEqual(readExposure.psf, self.psf)
 
+    def testReadLazyComponents(self):
+        """Test that components read lazily match those read eagerly.
+        """
+        exposure = afwImage.ExposureF(inFilePathSmall)
+        exposure.setPsf(self.psf)
+        exposure.setPhotoCalib(afwImage.PhotoCalib(1e-10, 1e-12))
+        for key, value in self.extras.items():
+            exposure.info.setComponent(key, value)
+
+        with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+            exposure.writeFits(tmpFile)
+            eager = afwImage.ExposureFitsReader(tmpFile).readExposureInfo()
+            lazy = afwImage.ExposureFitsReader(tmpFile).readExposureInfo(lazyComponents=True)
+            unread = lazy.getUnreadLazyComponents()
+            self.assertIn(afwImage.ExposureInfo.KEY_PSF, unread)
+            self.assertIn(afwImage.ExposureInfo.KEY_WCS, unread)
+
+            # Copies share the pending reads
+            copy = afwImage.ExposureInfo(lazy)
+            self.assertTrue(lazy.hasPsf())
+            self.assertEqual(lazy.getPsf(), self.psf)
+            self.assertNotIn(afwImage.ExposureInfo.KEY_PSF, lazy.getUnreadLazyComponents())
+            self.assertEqual(copy.getPsf(), self.psf)
+            self.assertEqual(lazy.getPhotoCalib(), eager.getPhotoCalib())
+            for key, value in self.extras.items():
+                self.assertEqual(lazy.getComponent(key), value)
+            self.checkWcs(exposure, afwImage.ExposureF(exposure.maskedImage, copy))
+
+            # Replacing a component cancels its read
+            copy.setWcs(None)
+            self.assertFalse(copy.hasWcs())
+            self.assertNotIn(afwImage.ExposureInfo.KEY_WCS, copy.getUnreadLazyComponents())
+
+            readExposure = afwImage.ExposureFitsReader(tmpFile).read(lazyComponents=True)
+            self.assertEqual(readExposure.getPsf(), self.psf)
+
     def checkWcs(self, parentExposure, subExposure):
         """Compare WCS at corner points of a sub-exposure and its parent exposure
            By using the function indexToPosition, we should be able to convert the indices
@@ -1053,6 +1089,28 @@ class ExposureInfoTestCase(lsst.utils.tests.TestCase):
         self.assertEqual(copy.getWcs(), newWcs)
         self.assertNotEqual(self.exposureInfo.getWcs(), copy.getWcs())
 
+    def testCopyOnWrite(self):
+        """Test that copies that share components stay independent when
+        either is modified.
+        """
+        self.exposureInfo.setPsf(self.psf)
+        self.exposureInfo.setValidPolygon(self.polygon)
+        exposure = afwImage.ExposureF(afwImage.MaskedImageF(10, 10), self.exposureInfo)
+        sub = exposure.subset(lsst.geom.Box2I(lsst.geom.Point2I(2, 2), lsst.geom.Extent2I(4, 4)))
+        copy = afwImage.ExposureInfo(self.exposureInfo)
+
+        sub.info.removeComponent(afwImage.ExposureInfo.KEY_VALID_POLYGON)
+        self.assertFalse(sub.info.hasValidPolygon())
+        self.assertTrue(exposure.info.hasValidPolygon())
+        self.assertTrue(copy.hasValidPolygon())
+
+        copy.setPhotoCalib(self.photoCalib)
+        self.assertTrue(copy.hasPhotoCalib())
+        self.assertFalse(self.exposureInfo.hasPhotoCalib())
+        self.assertFalse(sub.info.hasPhotoCalib())
+        self.assertEqual(sub.getPsf(), self.psf)
+        self.assertEqual(copy.getPsf(), self.psf)
+
     def testMissingProperties(self):
         # Test that invalid properties return None instead of raising
         exposureInfo = afwImage.ExposureInfo()
@@ -31,7 +31,7 @@ import lsst.geom
 import lsst.afw.table
 from lsst.afw.coord import Observatory, Weather
 from lsst.geom import arcseconds, degrees, radians, Point2D, Extent2D, Box2D, SpherePoint
-from lsst.afw.geom import Polygon, makeSkyWcs
+from lsst.afw.geom import Polygon, makeCdMatrix, makeSkyWcs
 import lsst.afw.image
 import lsst.afw.detection
 from lsst.afw.cameraGeom.testUtils import DetectorWrapper
@@ -240,6 +240,34 @@ class ExposureTableTestCase(lsst.utils.tests.TestCase):
             for key in self.plist:
                 self.assertEqual(self.plist[key], cat1.getMetadata()[key])
 
+    def testParallelArchivePersistence(self):
+        """Test reading a catalog while loading its archive with several
+        threads.
+        """
+        for i in range(20):
+            record = self.cat.addNew()
+            record.setId(10 + i)
+            record.setBBox(self.bbox0)
+            record.setWcs(self.createWcs())
+            record.setPhotoCalib(lsst.afw.image.PhotoCalib(1.0 + i, 0.1))
+            record.setPsf(self.psf)
+        with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+            self.cat.writeFits(tmpFile)
+            cat1 = lsst.afw.table.ExposureCatalog.readFits(tmpFile)
+            cat2 = lsst.afw.table.ExposureCatalog.readFits(
+                tmpFile, flags=lsst.afw.table.EXPOSURE_IO_PARALLEL_ARCHIVE)
+        self.assertEqual(len(cat2), len(self.cat))
+        for record1, record2 in zip(cat1, cat2):
+            self.assertEqual(record1.getId(), record2.getId())
+            self.assertEqual(record1.getWcs(), record2.getWcs())
+            self.assertEqual(record1.getPhotoCalib(), record2.getPhotoCalib())
+            self.assertEqual(record1.getVisitInfo(), record2.getVisitInfo())
+            if record1.getPsf() is None:
+                self.assertIsNone(record2.getPsf())
+            else:
+                self.comparePsfs(record1.getPsf(), record2.getPsf())
+        self.assertDetectorsEqual(cat2[1].getDetector(), self.detector)
+
     def testGeometry(self):
         bigBox = lsst.geom.Box2D(lsst.geom.Box2I(self.bbox0))
         bigBox.include(lsst.geom.Box2D(self.bbox1))
@@ -275,6 +303,45 @@ class ExposureTableTestCase(lsst.utils.tests.TestCase):
         subset3 = self.cat.subsetContaining(crazyPoint)
         self.assertEqual(len(subset3), 0)
 
+    def testSkyIndex(self):
+        """Test that ExposureSkyIndex finds the same records as
+        subsetContaining, for a grid of detectors.
+        """
+        cat = lsst.afw.table.ExposureCatalog(self.cat.schema)
+        for i in range(10):
+            for j in range(10):
+                record = cat.addNew()
+                record.setId(10*i + j + 1)
+                record.setWcs(self.wcs)
+                record.setBBox(lsst.geom.Box2I(lsst.geom.Point2I(50*i - 250, 40*j - 200),
+                                               lsst.geom.Extent2I(50, 40)))
+        record = cat.addNew()
+        record.setWcs(self.wcs)
+        record.setBBox(lsst.geom.Box2I(lsst.geom.Point2I(-30, -30), lsst.geom.Extent2I(60, 60)))
+        record.setValidPolygon(self.makePolygon())
+
+        index = lsst.afw.table.ExposureSkyIndex(cat)
+        self.assertEqual(len(index), len(cat))
+        pixels = np.random.rand(200, 2)*np.array([600.0, 500.0]) + np.array([-275.0, -225.0])
+        coords = [self.wcs.pixelToSky(lsst.geom.Point2D(x, y)) for x, y in pixels]
+        coords.append(lsst.geom.SpherePoint(self.wcs.getSkyOrigin().getLongitude() + np.pi*radians,
+                                            self.wcs.getSkyOrigin().getLatitude()))
+        subsets = index.subsetContaining(coords, includeValidPolygon=True)
+        self.assertEqual(len(subsets), len(coords))
+        for coord, subset in zip(coords, subsets):
+            for includeValidPolygon in (False, True):
+                expected = [r.getId() for r in cat.subsetContaining(coord, includeValidPolygon)]
+                found = index.subsetContaining(coord, includeValidPolygon)
+                self.assertEqual([r.getId() for r in found], expected)
+                positions = index.findContaining(coord, includeValidPolygon)
+                self.assertEqual([cat[k].getId() for k in positions], expected)
+            self.assertEqual([r.getId() for r in subset],
+                             [r.getId() for r in cat.subsetContaining(coord, True)])
+
+        cat.addNew().setBBox(lsst.geom.Box2I(lsst.geom.Point2I(0, 0), lsst.geom.Extent2I(5, 5)))
+        with self.assertRaises(lsst.pex.exceptions.LogicError):
+            lsst.afw.table.ExposureSkyIndex(cat)
+
     def testCoaddInputs(self):
         coaddInputs = lsst.afw.image.CoaddInputs(
             lsst.afw.table.ExposureTable.makeMinimalSchema(),
@@ -295,6 +362,53 @@ class ExposureTableTestCase(lsst.utils.tests.TestCase):
             self.assertEqual(coaddInputsOut.ccds[0].getId(), 3)
             self.assertEqual(coaddInputsOut.ccds[1].getId(), 4)
 
+    def testCoaddInputsIndex(self):
+        """Test that CoaddInputsIndex finds the same inputs as
+        subsetContaining, and survives persistence.
+        """
+        coaddInputs = lsst.afw.image.CoaddInputs(
+            lsst.afw.table.ExposureTable.makeMinimalSchema(),
+            lsst.afw.table.ExposureTable.makeMinimalSchema()
+        )
+        for i in range(6):
+            for j in range(5):
+                record = coaddInputs.ccds.addNew()
+                record.setId(10*i + j + 1)
+                record.setWcs(self.wcs)
+                record.setBBox(lsst.geom.Box2I(lsst.geom.Point2I(60*i - 180, 50*j - 125),
+                                               lsst.geom.Extent2I(65, 55)))
+        record = coaddInputs.ccds.addNew()
+        record.setId(100)
+        record.setWcs(self.wcs)
+        record.setBBox(lsst.geom.Box2I(lsst.geom.Point2I(-40, -40), lsst.geom.Extent2I(80, 80)))
+        record.setValidPolygon(Polygon([Point2D(-30, -30), Point2D(30, -20), Point2D(0, 35)]))
+        coaddWcs = makeSkyWcs(crpix=Point2D(500.0, 400.0), crval=self.wcs.getSkyOrigin(),
+                              cdMatrix=makeCdMatrix(scale=0.25*arcseconds, orientation=30*degrees))
+        positions = [coaddWcs.skyToPixel(self.wcs.pixelToSky(Point2D(x, y)))
+                     for x, y in np.random.rand(200, 2)*np.array([400.0, 300.0]) - 200.0]
+        for includeValidPolygon in (False, True):
+            index = lsst.afw.image.CoaddInputsIndex(coaddInputs, coaddWcs, includeValidPolygon)
+            self.assertEqual(len(index), len(coaddInputs.ccds))
+            with lsst.utils.tests.getTempFilePath(".fits") as filename:
+                index.writeFits(filename)
+                index2 = lsst.afw.image.CoaddInputsIndex.readFits(filename)
+            self.assertEqual(index2.getPolygon(0), index.getPolygon(0))
+            subsets = index.subsetContaining(positions)
+            found = index2.findContaining(positions)
+            for position, subset, positions2 in zip(positions, subsets, found):
+                expected = [r.getId() for r in
+                            coaddInputs.ccds.subsetContaining(position, coaddWcs, includeValidPolygon)]
+                self.assertEqual([r.getId() for r in index.subsetContaining(position)], expected)
+                self.assertEqual([r.getId() for r in subset], expected)
+                self.assertEqual([index2.catalog[k].getId() for k in positions2], expected)
+            self.assertEqual(len(index.findContaining(Point2D(1E6, 1E6))), 0)
+        with self.assertRaises(lsst.pex.exceptions.OutOfRangeError):
+            index.getPolygon(len(index))
+
+        coaddInputs.ccds.addNew().setBBox(lsst.geom.Box2I(lsst.geom.Point2I(0, 0), lsst.geom.Extent2I(5, 5)))
+        with self.assertRaises(lsst.pex.exceptions.LogicError):
+            lsst.afw.image.CoaddInputsIndex(coaddInputs, coaddWcs)
+
     def testReadV1Catalog(self):
         testDir = os.path.dirname(__file__)
         v1CatalogPath = os.path.join(
@@ -20,12 +20,17 @@
 # see <http://www.lsstcorp.org/LegalNotices/>.
 #
 
+import math
 import os
 import unittest
 
+import numpy as np
+
 from lsst.daf.base import PropertyList
 
+import lsst.pex.exceptions
 import lsst.afw.fits
+import lsst.afw.image
 import lsst.utils.tests
 
 testPath = os.path.abspath(os.path.dirname(__file__))
@@ -188,6 +193,121 @@ class FitsTestCase(lsst.utils.tests.TestCase):
             self.assertEqual(new[key], longString)
 
 
+    def testLazyHeader(self):
+        """Check that a LazyHeader parses values as readMetadata does"""
+        for name in ("ticket42210.fits", "ticket18864.fits", "ticket20143.fits", "parent.fits"):
+            testFile = os.path.join(testPath, "data", name)
+            for strip in (False, True):
+                expected = lsst.afw.fits.readMetadata(testFile, strip=strip)
+                header = lsst.afw.fits.LazyHeader(testFile)
+                self.assertEqual(header.toPropertyList(strip).toOrderedDict(), expected.toOrderedDict())
+                names = [key for key in header.getNames() if key in expected][::3]
+                subset = header.extract(names, strip)
+                self.assertEqual(subset.getOrderedNames(), [key for key in expected.getOrderedNames()
+                                                            if key in names])
+                for key in names:
+                    self.assertEqual(subset.getArray(key), expected.getArray(key))
+
+        testFile = os.path.join(testPath, "data", "ticket18864.fits")
+        header = lsst.afw.fits.LazyHeader(testFile)
+        self.assertIn("ADC-STR", header)
+        self.assertAlmostEqual(header["ADC-STR"], 22.01)
+        self.assertAlmostEqual(header.get("DOM-WND"), 4.8)
+        self.assertIsNone(header.get("NOTTHERE"))
+        self.assertNotIn("NOTTHERE", header)
+        with self.assertRaises(lsst.pex.exceptions.NotFoundError):
+            header.getValueString("NOTTHERE")
+
+        # Long strings are continued over several cards
+        metadata = PropertyList()
+        longString = "A string value that is far too long to fit on a single FITS header card " * 3
+        metadata.set("LONGSTR", longString, "a comment")
+        metadata.set("SHORT", 3)
+        manager = lsst.afw.fits.MemFileManager()
+        with lsst.afw.fits.Fits(manager, "w") as fits:
+            fits.createEmpty()
+            fits.writeMetadata(metadata)
+        with lsst.afw.fits.Fits(manager, "r") as fits:
+            header = lsst.afw.fits.LazyHeader(fits)
+        self.assertEqual(header["LONGSTR"], longString.rstrip())
+        self.assertEqual(header.getComment("LONGSTR"), "a comment")
+        self.assertEqual(header.getValueString("SHORT"), "3")
+        self.assertEqual(header["SHORT"], 3)
+        self.assertNotIn("CONTINUE", header.getNames())
+
+    def testManyKeys(self):
+        """Check that large headers of every type are written in order,
+        including into a header that is followed by data."""
+        metadata = PropertyList()
+        for i in range(1000):
+            metadata.set(f"INT{i}", i, f"integer {i}")
+            metadata.set(f"FLT{i}", i + 0.25)
+            metadata.set(f"BOOL{i}", i % 2 == 0)
+            metadata.set(f"STR{i}", f"value {i}", "a string")
+        metadata.set("ANUNDEF", None, "undefined")
+        metadata.set("ANAN", float("nan"))
+        metadata.set("LONG KEYWORD NAME", 5)
+        metadata.set("LONGSTR", "a long string value " * 10)
+        metadata.add("COMMENT", "a comment card")
+        names = [name for name in metadata.getOrderedNames() if name != "COMMENT"]
+        read = self.writeAndRead(metadata)
+        self.assertEqual(read.getArray("COMMENT")[-1], "a comment card")
+        self.assertEqual([name for name in read.getOrderedNames() if name in names], names)
+        for name in names:
+            if name == "ANAN":
+                self.assertTrue(math.isnan(read.getScalar(name)))
+            elif name == "LONGSTR":
+                self.assertEqual(read.getScalar(name), metadata.getScalar(name).rstrip())
+            else:
+                self.assertEqual(read.getScalar(name), metadata.getScalar(name), msg=name)
+        self.assertEqual(read.getComment("INT5"), "integer 5")
+
+        image = lsst.afw.image.ImageF(20, 10)
+        image.array[:, :] = np.arange(200).reshape(10, 20)
+        with lsst.utils.tests.getTempFilePath(".fits") as fileName:
+            image.writeFits(fileName)
+            with lsst.afw.fits.Fits(fileName, "a") as fits:
+                fits.setHdu(0)
+                fits.writeMetadata(metadata)
+            self.assertImagesEqual(lsst.afw.image.ImageF(fileName), image)
+            header = lsst.afw.fits.readMetadata(fileName)
+            self.assertEqual(header.getScalar("INT999"), 999)
+            self.assertEqual(header.getScalar("STR999"), "value 999")
+
+    def testMemFileReuse(self):
+        """Check that a MemFileManager can be written to repeatedly, and
+        viewed and read without copying"""
+        def write(manager, nKeys):
+            metadata = PropertyList()
+            for i in range(nKeys):
+                metadata.set(f"KEY{i}", i)
+            with lsst.afw.fits.Fits(manager, "w") as fits:
+                fits.createEmpty()
+                fits.writeMetadata(metadata)
+
+        manager = lsst.afw.fits.MemFileManager()
+        for nKeys in (500, 10, 200):
+            write(manager, nKeys)
+            fresh = lsst.afw.fits.MemFileManager()
+            write(fresh, nKeys)
+            self.assertEqual(manager.getLength(), fresh.getLength())
+            self.assertEqual(manager.getData(), fresh.getData())
+            self.assertGreaterEqual(manager.getCapacity(), manager.getLength())
+            self.assertEqual(bytes(memoryview(manager)), manager.getData())
+        # memory is kept from the largest file
+        self.assertGreater(manager.getCapacity(), manager.getLength())
+
+        data = manager.getData()
+        view = lsst.afw.fits.MemFileManager(data)
+        self.assertTrue(view.isReadOnly())
+        self.assertEqual(view.getLength(), len(data))
+        self.assertTrue(memoryview(view).readonly)
+        with lsst.afw.fits.Fits(view, "r") as fits:
+            self.assertEqual(fits.readMetadata()["KEY199"], 199)
+        with self.assertRaises(lsst.afw.fits.FitsError):
+            lsst.afw.fits.Fits(view, "w")
+
+
 class TestMemory(lsst.utils.tests.MemoryTestCase):
     pass
 
@@ -0,0 +1,163 @@
+# This file is part of afw.
+#
+# Developed for the LSST Data Management System.
+# This product includes software developed by the LSST Project
+# (https://www.lsst.org).
+# See the COPYRIGHT file at the top-level directory of this distribution
+# for details of code ownership.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+"""
+Tests for reading FITS files through byte-range requests
+
+Run with:
+   python test_fitsByteRange.py
+or
+   pytest test_fitsByteRange.py
+"""
+
+import os
+import unittest
+
+import numpy as np
+
+import lsst.utils.tests
+import lsst.pex.exceptions
+import lsst.geom
+import lsst.afw.fits
+import lsst.afw.image as afwImage
+from lsst.afw.fits import ImageCompressionOptions
+
+
+class LocalRangeSource(lsst.afw.fits.ByteRangeSource):
+    """A stand-in for an object-store client, recording each request."""
+
+    def __init__(self, fileName):
+        lsst.afw.fits.ByteRangeSource.__init__(self)
+        self.fileName = fileName
+        self.requests = []
+
+    def getName(self):
+        return self.fileName
+
+    def getSize(self):
+        return os.path.getsize(self.fileName)
+
+    def read(self, offset, size):
+        self.requests.append((offset, size))
+        with open(self.fileName, "rb") as f:
+            f.seek(offset)
+            return f.read(size)
+
+
+class FitsByteRangeTestCase(lsst.utils.tests.TestCase):
+
+    def setUp(self):
+        np.random.seed(1)
+        self.bbox = lsst.geom.Box2I(lsst.geom.Point2I(100, 200), lsst.geom.Extent2I(300, 400))
+        self.exposure = afwImage.ExposureF(self.bbox)
+        self.exposure.image.array[:, :] = np.random.normal(size=self.exposure.image.array.shape)
+        self.exposure.variance.array[:, :] = np.random.uniform(1.0, 2.0,
+                                                                 size=self.exposure.image.array.shape)
+        self.exposure.mask.array[:, :] = np.random.randint(0, 4, size=self.exposure.image.array.shape)
+        self.cutout = lsst.geom.Box2I(lsst.geom.Point2I(150, 400), lsst.geom.Extent2I(40, 10))
+
+    def tearDown(self):
+        del self.exposure
+
+    def testCache(self):
+        with lsst.utils.tests.getTempFilePath(".bin") as fileName:
+            data = np.random.randint(0, 256, size=10000).astype(np.uint8).tobytes()
+            with open(fileName, "wb") as f:
+                f.write(data)
+            source = LocalRangeSource(fileName)
+            cache = lsst.afw.fits.ByteRangeCache(source, blockSize=1000, capacity=3, readAhead=1)
+            self.assertEqual(cache.getSize(), len(data))
+            self.assertEqual(cache.read(1500, 1000), data[1500:2500])
+            # the two blocks read are fetched at once, with one more read ahead
+            self.assertEqual(source.requests, [(1000, 3000)])
+            self.assertEqual(cache.read(3100, 10), data[3100:3110])
+            self.assertEqual(cache.getRequestCount(), 1)
+            self.assertEqual(cache.read(9990, 10), data[9990:])
+            self.assertEqual(source.requests[-1], (9000, 1000))
+            # the least recently used block has been dropped, but not the one after it
+            self.assertEqual(cache.read(1000, 10), data[1000:1010])
+            self.assertEqual(source.requests[-1], (1000, 1000))
+            self.assertEqual(cache.getRequestCount(), 3)
+            self.assertEqual(cache.getBytesFetched(), 3000 + 1000 + 1000)
+            with self.assertRaises(lsst.pex.exceptions.LengthError):
+                cache.read(9995, 10)
+
+            fileSource = lsst.afw.fits.FileByteRangeSource(fileName)
+            self.assertEqual(fileSource.getSize(), len(data))
+            self.assertEqual(fileSource.read(17, 100), data[17:117])
+
+    def testExposure(self):
+        with lsst.utils.tests.getTempFilePath(".fits") as fileName:
+            self.exposure.writeFits(fileName)
+            cache = lsst.afw.fits.ByteRangeCache(LocalRangeSource(fileName), blockSize=8192)
+            reader = afwImage.ExposureFitsReader(cache)
+            self.assertEqual(reader.readBBox(), self.bbox)
+            self.assertMaskedImagesEqual(reader.readMaskedImage(), self.exposure.maskedImage)
+            cutout = afwImage.ExposureFitsReader(cache).readImage(self.cutout)
+            self.assertImagesEqual(cutout, self.exposure.image[self.cutout])
+
+            with lsst.afw.fits.Fits(cache) as fits:
+                self.assertEqual(fits.countHdus(), 4)
+
+    def testCompressedCutout(self):
+        """Only the compressed tiles overlapping a cutout are fetched."""
+        options = lsst.afw.fits.ImageWriteOptions(ImageCompressionOptions(ImageCompressionOptions.GZIP))
+        with lsst.utils.tests.getTempFilePath(".fits") as fileName:
+            self.exposure.writeFits(fileName, options, options, options)
+            source = LocalRangeSource(fileName)
+            cache = lsst.afw.fits.ByteRangeCache(source, blockSize=4096, readAhead=0)
+            reader = afwImage.ExposureFitsReader(cache)
+            cutout = reader.readImage(self.cutout)
+            self.assertImagesEqual(cutout, self.exposure.image[self.cutout])
+            self.assertLess(cache.getBytesFetched(), os.path.getsize(fileName)/4)
+            self.assertEqual(cache.getRequestCount(), len(source.requests))
+
+            fileCache = lsst.afw.fits.ByteRangeCache(lsst.afw.fits.FileByteRangeSource(fileName))
+            variance = afwImage.MaskedImageFitsReader(fileCache).readVariance(self.cutout)
+            self.assertImagesEqual(variance, self.exposure.variance[self.cutout])
+
+    def testErrors(self):
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            lsst.afw.fits.ByteRangeCache(None)
+        with lsst.utils.tests.getTempFilePath(".fits") as fileName:
+            self.exposure.image.writeFits(fileName)
+            source = LocalRangeSource(fileName)
+            with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+                lsst.afw.fits.ByteRangeCache(source, blockSize=0)
+            # a failing source is reported as a FITS error
+            source.read = lambda offset, size: b""
+            with self.assertRaises(lsst.afw.fits.FitsError):
+                afwImage.ImageFitsReader(lsst.afw.fits.ByteRangeCache(source)).read()
+        with self.assertRaises(lsst.pex.exceptions.IoError):
+            lsst.afw.fits.FileByteRangeSource("no/such/file.fits")
+
+
+class TestMemory(lsst.utils.tests.MemoryTestCase):
+    pass
+
+
+def setup_module(module):
+    lsst.utils.tests.init()
+
+
+if __name__ == "__main__":
+    lsst.utils.tests.init()
+    unittest.main()
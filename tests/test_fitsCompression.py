@@ -29,8 +29,10 @@ import fitsio
 
 import lsst.utils
 import lsst.daf.base
+import lsst.pex.exceptions
 import lsst.geom
 import lsst.afw.geom
+import lsst.afw.detection
 import lsst.afw.image
 import lsst.afw.fits
 import lsst.utils.tests
@@ -696,6 +698,252 @@ class ImageCompressionTestCase(lsst.utils.tests.TestCase):
         maskOptions = lsst.afw.fits.ImageWriteOptions(compression)
         self.checkMaskedImage(imageOptions, maskOptions, imageOptions, atol=self.noise/quantize)
 
+    def testMaskedImageThreads(self):
+        """Test that compressing the planes of a MaskedImage concurrently
+        writes the same file as compressing them one after another
+        """
+        image = lsst.afw.image.makeMaskedImage(self.makeImage(lsst.afw.image.ImageF),
+                                               self.makeMask(), self.makeImage(lsst.afw.image.ImageF))
+        exp = lsst.afw.image.makeExposure(image)
+        # An archive of ancillary objects is written alongside the planes
+        exp.setPsf(lsst.afw.detection.GaussianPsf(5, 5, 1.5))
+        exp.info.setVisitInfo(lsst.afw.image.VisitInfo(exposureTime=15.0))
+        compression = lsst.afw.fits.ImageCompressionOptions(ImageCompressionOptions.GZIP_SHUFFLE)
+        imageOptions = lsst.afw.fits.ImageWriteOptions(compression)
+        maskOptions = lsst.afw.fits.ImageWriteOptions(
+            lsst.afw.fits.ImageCompressionOptions(ImageCompressionOptions.RICE))
+        old = lsst.afw.fits.getImageCompressionThreads()
+        try:
+            for obj in (image, exp):
+                contents = []
+                for numThreads in (1, 3):
+                    lsst.afw.fits.setImageCompressionThreads(numThreads)
+                    with lsst.utils.tests.getTempFilePath(self.extension) as filename:
+                        obj.writeFits(filename, imageOptions, maskOptions, imageOptions)
+                        with open(filename, "rb") as fd:
+                            contents.append(fd.read())
+                        unpersisted = type(obj)(filename)
+                    if hasattr(obj, "getMaskedImage"):
+                        point = lsst.geom.Point2D(0, 0)
+                        self.assertImagesEqual(unpersisted.getPsf().computeKernelImage(point),
+                                               obj.getPsf().computeKernelImage(point))
+                        unpersisted = unpersisted.getMaskedImage()
+                    self.assertMaskedImagesEqual(unpersisted, image)
+                self.assertEqual(contents[0], contents[1])
+        finally:
+            lsst.afw.fits.setImageCompressionThreads(old)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            lsst.afw.fits.setImageCompressionThreads(-1)
+
+    def testSubimageThreads(self):
+        """Test that decompressing rows of tiles concurrently reads the same
+        pixels as decompressing them one after another
+        """
+        tilesList = ((0, 1), (3, 2), (0, 3))
+        bboxList = (self.bbox,
+                    lsst.geom.Box2I(lsst.geom.Point2I(124, 457), lsst.geom.Extent2I(5, 6)),
+                    lsst.geom.Box2I(lsst.geom.Point2I(125, 459), lsst.geom.Extent2I(3, 1)))
+        old = lsst.afw.fits.getImageCompressionThreads()
+        try:
+            for cls, tiles in itertools.product((lsst.afw.image.ImageF, lsst.afw.image.ImageI), tilesList):
+                compression = ImageCompressionOptions(ImageCompressionOptions.GZIP_SHUFFLE,
+                                                      np.array(tiles, dtype=np.int64))
+                original = self.makeImage(cls)
+                with lsst.utils.tests.getTempFilePath(self.extension) as filename:
+                    original.writeFits(filename, lsst.afw.fits.ImageWriteOptions(compression))
+                    for bbox in bboxList:
+                        expected = original.subset(bbox)
+                        for numThreads in (1, 3, 0):
+                            lsst.afw.fits.setImageCompressionThreads(numThreads)
+                            reader = lsst.afw.image.ImageFitsReader(filename)
+                            self.assertImagesEqual(reader.read(bbox=bbox), expected)
+        finally:
+            lsst.afw.fits.setImageCompressionThreads(old)
+
+    def testScalingThreads(self):
+        """Test that scaling and fuzzing an image concurrently writes the same
+        file as doing so with a single thread
+        """
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(12, 34), lsst.geom.Extent2I(700, 400))
+        rng = np.random.RandomState(12345)
+        image = lsst.afw.image.ImageF(bbox)
+        image.array[:] = rng.normal(self.background, self.noise, image.array.shape)
+        image.array[::37, ::41] = np.nan
+        mask = lsst.afw.image.Mask(bbox)
+        mask.addMaskPlane("BAD")
+        mask.array[::13, ::7] = mask.getPlaneBitMask("BAD")
+        tilesList = ((0, 1), (128, 7), (0, 400))
+        old = lsst.afw.fits.getImageCompressionThreads()
+        try:
+            for algorithm, tiles in itertools.product((ImageScalingOptions.STDEV_POSITIVE,
+                                                       ImageScalingOptions.STDEV_BOTH), tilesList):
+                compression = ImageCompressionOptions(ImageCompressionOptions.RICE,
+                                                      np.array(tiles, dtype=np.int64))
+                scaling = ImageScalingOptions(algorithm, 16, ["BAD"], seed=5, quantizeLevel=10.0)
+                options = lsst.afw.fits.ImageWriteOptions(compression, scaling)
+                contents = []
+                scales = []
+                for numThreads in (1, 3):
+                    lsst.afw.fits.setImageCompressionThreads(numThreads)
+                    scale = scaling.determine(image, mask)
+                    scales.append((scale.bscale, scale.bzero))
+                    with lsst.utils.tests.getTempFilePath(self.extension) as filename:
+                        with lsst.afw.fits.Fits(filename, "w") as fits:
+                            image.writeFits(fits, options, lsst.daf.base.PropertyList(), mask)
+                        with open(filename, "rb") as fd:
+                            contents.append(fd.read())
+                self.assertEqual(scales[0], scales[1])
+                self.assertEqual(contents[0], contents[1])
+        finally:
+            lsst.afw.fits.setImageCompressionThreads(old)
+
+    def testImageStreamWriter(self):
+        """Test that writing an image a strip at a time writes the same file
+        as writing it all at once
+        """
+        compressions = (ImageCompressionOptions(ImageCompressionOptions.NONE),
+                        ImageCompressionOptions(ImageCompressionOptions.RICE),
+                        ImageCompressionOptions(ImageCompressionOptions.GZIP_SHUFFLE,
+                                                np.array((0, 3), dtype=np.int64)))
+        stripHeights = ((8,), (1, 2, 5), (3, 3, 2), (7, 1))
+        writers = {lsst.afw.image.ImageF: lsst.afw.fits.ImageStreamWriterF,
+                   lsst.afw.image.ImageI: lsst.afw.fits.ImageStreamWriterI}
+        header = lsst.daf.base.PropertyList()
+        header.set("FOO", "bar")
+        for (cls, Writer), compression in itertools.product(writers.items(), compressions):
+            image = self.makeImage(cls)
+            optionsList = [lsst.afw.fits.ImageWriteOptions(compression)]
+            if cls is lsst.afw.image.ImageF:
+                optionsList.append(lsst.afw.fits.ImageWriteOptions(compression,
+                                                                   ImageScalingOptions(16, 0.5, 10000.0)))
+            for options, heights in itertools.product(optionsList, stripHeights):
+                with self.subTest(cls=cls, compression=compression.algorithm, heights=heights):
+                    with lsst.utils.tests.getTempFilePath(self.extension) as filename:
+                        image.writeFits(filename, options, "w", header)
+                        with open(filename, "rb") as fd:
+                            expected = fd.read()
+                        fits = lsst.afw.fits.Fits(filename, "w")
+                        with Writer(fits, self.bbox, options, header) as writer:
+                            start = 0
+                            for height in heights:
+                                writer.writeRows(image.array[start:start + height])
+                                start += height
+                                self.assertEqual(writer.getRowsWritten(), start)
+                        self.assertTrue(writer.isClosed())
+                        fits.closeFile()
+                        with open(filename, "rb") as fd:
+                            self.assertEqual(fd.read(), expected)
+
+        with lsst.utils.tests.getTempFilePath(self.extension) as filename:
+            fits = lsst.afw.fits.Fits(filename, "w")
+            with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+                lsst.afw.fits.ImageStreamWriterF(fits, self.bbox, lsst.afw.fits.ImageWriteOptions(
+                    ImageScalingOptions(ImageScalingOptions.STDEV_BOTH, 16)))
+            writer = lsst.afw.fits.ImageStreamWriterF(fits, self.bbox)
+            image = self.makeImage(lsst.afw.image.ImageF)
+            with self.assertRaises(lsst.pex.exceptions.LengthError):
+                writer.writeRows(image.array[:, 1:])
+            writer.writeRows(image.array[:5])
+            with self.assertRaises(lsst.pex.exceptions.LengthError):
+                writer.writeRows(image.array)
+            with self.assertRaises(lsst.pex.exceptions.LogicError):
+                writer.close()
+            writer.writeRows(image.array[5:])
+            writer.close()
+            fits.closeFile()
+            self.assertImagesEqual(lsst.afw.image.ImageF(filename), image)
+
+    def checkChecksums(self, filename):
+        """Check the checksums of every HDU of a file that has them
+
+        Returns the number of HDUs checked.
+        """
+        checked = 0
+        with astropy.io.fits.open(filename, disable_image_compression=True) as hduList:
+            for hdu in hduList:
+                if "CHECKSUM" not in hdu.header:
+                    continue
+                self.assertIn("DATASUM", hdu.header)
+                self.assertEqual(hdu.verify_datasum(), 1)
+                self.assertEqual(hdu.verify_checksum(), 1)
+                checked += 1
+        return checked
+
+    def testChecksum(self):
+        """Test that the checksums written are those of the file, whether
+        DATASUM is computed from the pixels in memory or by cfitsio (for
+        compressed images)
+        """
+        compressions = (ImageCompressionOptions(ImageCompressionOptions.NONE),
+                        ImageCompressionOptions(ImageCompressionOptions.GZIP_SHUFFLE))
+        classes = (lsst.afw.image.ImageU, lsst.afw.image.ImageI, lsst.afw.image.ImageF,
+                   lsst.afw.image.ImageD)
+        for cls, compression in itertools.product(classes, compressions):
+            image = self.makeImage(cls)
+            optionsList = [lsst.afw.fits.ImageWriteOptions(compression)]
+            if cls is lsst.afw.image.ImageF:
+                optionsList.append(lsst.afw.fits.ImageWriteOptions(compression,
+                                                                   ImageScalingOptions(16, 0.5, 10000.0)))
+            for options in optionsList:
+                options.checksum = True
+                with self.subTest(cls=cls, compression=compression.algorithm, options=options):
+                    with lsst.utils.tests.getTempFilePath(self.extension) as filename:
+                        image.writeFits(filename, options)
+                        self.assertEqual(self.checkChecksums(filename), 1)
+        image = self.makeImage(lsst.afw.image.ImageL)
+        options = lsst.afw.fits.ImageWriteOptions(ImageCompressionOptions(ImageCompressionOptions.NONE))
+        with lsst.utils.tests.getTempFilePath(self.extension) as filename:
+            image.writeFits(filename, options)
+            self.assertEqual(self.checkChecksums(filename), 0)
+            options.checksum = True
+            image.writeFits(filename, options)
+            self.assertEqual(self.checkChecksums(filename), 1)
+            self.assertImagesEqual(lsst.afw.image.ImageL(filename), image)
+
+        config = lsst.daf.base.PropertySet()
+        self.assertFalse(lsst.afw.fits.ImageWriteOptions.validate(config).getScalar("checksum"))
+        config.set("checksum", True)
+        self.assertTrue(lsst.afw.fits.ImageWriteOptions(
+            lsst.afw.fits.ImageWriteOptions.validate(config)).checksum)
+
+    def testChecksumThreads(self):
+        """Test that summing the pixels concurrently, or a strip at a time,
+        writes the same checksums as summing them all at once
+        """
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(12, 34), lsst.geom.Extent2I(701, 400))
+        rng = np.random.RandomState(12345)
+        images = []
+        for cls in (lsst.afw.image.ImageU, lsst.afw.image.ImageF):
+            image = cls(bbox)
+            image.array[:] = rng.normal(self.background, self.noise, image.array.shape)
+            images.append(image)
+        writers = {lsst.afw.image.ImageU: lsst.afw.fits.ImageStreamWriterU,
+                   lsst.afw.image.ImageF: lsst.afw.fits.ImageStreamWriterF}
+        options = lsst.afw.fits.ImageWriteOptions(ImageCompressionOptions(ImageCompressionOptions.NONE))
+        options.checksum = True
+        header = lsst.daf.base.PropertyList()
+        old = lsst.afw.fits.getImageCompressionThreads()
+        try:
+            for image in images:
+                contents = []
+                for numThreads in (1, 3):
+                    lsst.afw.fits.setImageCompressionThreads(numThreads)
+                    with lsst.utils.tests.getTempFilePath(self.extension) as filename:
+                        image.writeFits(filename, options, "w", header)
+                        self.assertEqual(self.checkChecksums(filename), 1)
+                        with open(filename, "rb") as fd:
+                            contents.append(fd.read())
+                        fits = lsst.afw.fits.Fits(filename, "w")
+                        with writers[type(image)](fits, bbox, options, header) as writer:
+                            for start in range(0, bbox.getHeight(), 57):
+                                writer.writeRows(image.array[start:start + 57])
+                        fits.closeFile()
+                        with open(filename, "rb") as fd:
+                            contents.append(fd.read())
+                self.assertEqual(len(set(contents)), 1)
+        finally:
+            lsst.afw.fits.setImageCompressionThreads(old)
+
     def testQuantization(self):
         """Test that our quantization produces the same values as cfitsio
 
@@ -0,0 +1,127 @@
+# This file is part of afw.
+#
+# Developed for the LSST Data Management System.
+# This product includes software developed by the LSST Project
+# (https://www.lsst.org).
+# See the COPYRIGHT file at the top-level directory of this distribution
+# for details of code ownership.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+import unittest
+
+import numpy as np
+
+import lsst.utils.tests
+import lsst.pex.exceptions as pexExcept
+import lsst.afw.math as afwMath
+
+
+class FlatKdTreeTestCase(lsst.utils.tests.TestCase):
+
+    def setUp(self):
+        self.rng = np.random.RandomState(17)
+        # quantize the points so that there are many ties in distance
+        self.points = np.floor(self.rng.rand(301, 3)*20.0)/20.0
+        self.queries = self.rng.rand(97, 3)
+
+    def bruteForce(self, query):
+        """Return all points' indices and distances from query, nearest
+        first, breaking ties by index.
+        """
+        distances = np.sqrt(np.sum((self.points - query)**2, axis=1))
+        order = np.lexsort((np.arange(len(self.points)), distances))
+        return order, distances[order]
+
+    def testConstructorExceptions(self):
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            afwMath.FlatKdTreeD(np.zeros((0, 2)))
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            afwMath.FlatKdTreeD(self.points, leafSize=0)
+
+    def testFindNeighbors(self):
+        k = 7
+        for leafSize in (1, 4, 8, 500):
+            tree = afwMath.FlatKdTreeD(self.points, leafSize=leafSize)
+            self.assertEqual(len(tree), len(self.points))
+            self.assertEqual(tree.getDimensions(), 3)
+
+            indices = np.zeros(k, dtype=np.int32)
+            distances = np.zeros(k, dtype=float)
+            for query in self.queries:
+                tree.findNeighbors(indices, distances, query)
+                expectedIndices, expectedDistances = self.bruteForce(query)
+                np.testing.assert_array_equal(indices, expectedIndices[:k])
+                self.assertFloatsAlmostEqual(distances, expectedDistances[:k], rtol=1E-14)
+
+    def testFindNeighborsBatch(self):
+        k = 5
+        tree = afwMath.FlatKdTreeD(self.points)
+        serialIndices = np.zeros((len(self.queries), k), dtype=np.int32)
+        serialDistances = np.zeros((len(self.queries), k), dtype=float)
+        tree.findNeighbors(serialIndices, serialDistances, self.queries)
+        for i, query in enumerate(self.queries):
+            expectedIndices, expectedDistances = self.bruteForce(query)
+            np.testing.assert_array_equal(serialIndices[i], expectedIndices[:k])
+            self.assertFloatsAlmostEqual(serialDistances[i], expectedDistances[:k], rtol=1E-14)
+
+        for numThreads in (3, 0):
+            indices = np.zeros_like(serialIndices)
+            distances = np.zeros_like(serialDistances)
+            tree.findNeighbors(indices, distances, self.queries, numThreads=numThreads)
+            np.testing.assert_array_equal(indices, serialIndices)
+            np.testing.assert_array_equal(distances, serialDistances)
+
+        with self.assertRaises(pexExcept.LengthError):
+            tree.findNeighbors(np.zeros((len(self.queries), len(self.points) + 1), dtype=np.int32),
+                               np.zeros((len(self.queries), len(self.points) + 1), dtype=float),
+                               self.queries)
+        with self.assertRaises(pexExcept.LengthError):
+            tree.findNeighbors(serialIndices, serialDistances, self.queries[:, :2].copy())
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            tree.findNeighbors(serialIndices, serialDistances, self.queries, numThreads=-1)
+
+    def testFindWithinRadius(self):
+        radius = 0.2
+        tree = afwMath.FlatKdTreeD(self.points, leafSize=4)
+        expected = []
+        for query in self.queries:
+            distances = np.sqrt(np.sum((self.points - query)**2, axis=1))
+            expected.append(list(np.flatnonzero(distances <= radius)))
+            self.assertEqual(tree.findWithinRadius(query, radius), expected[-1])
+        self.assertEqual(tree.findWithinRadius(self.queries[0], -1.0), [])
+
+        for numThreads in (1, 4):
+            self.assertEqual(tree.findWithinRadius(self.queries, radius, numThreads=numThreads), expected)
+
+    def testFloat(self):
+        tree = afwMath.FlatKdTreeF(self.points.astype(np.float32))
+        indices = np.zeros(3, dtype=np.int32)
+        distances = np.zeros(3, dtype=float)
+        tree.findNeighbors(indices, distances, self.queries[0].astype(np.float32))
+        self.assertEqual(len(set(indices)), 3)
+        self.assertTrue(np.all(np.diff(distances) >= 0.0))
+
+
+class TestMemory(lsst.utils.tests.MemoryTestCase):
+    pass
+
+
+def setup_module(module):
+    lsst.utils.tests.init()
+
+
+if __name__ == "__main__":
+    lsst.utils.tests.init()
+    unittest.main()
@@ -0,0 +1,157 @@
+# This file is part of afw.
+#
+# Developed for the LSST Data Management System.
+# This product includes software developed by the LSST Project
+# (https://www.lsst.org).
+# See the COPYRIGHT file at the top-level directory of this distribution
+# for details of code ownership.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+"""
+Tests for Float16Image
+
+Run with:
+   python test_float16Image.py
+or
+   pytest test_float16Image.py
+"""
+
+import unittest
+
+import numpy as np
+
+import lsst.utils.tests
+import lsst.pex.exceptions
+import lsst.geom
+import lsst.afw.fits
+import lsst.afw.image as afwImage
+import lsst.afw.math as afwMath
+
+
+class Float16ImageTestCase(lsst.utils.tests.TestCase):
+    """A test case for Float16Image"""
+
+    def setUp(self):
+        np.random.seed(1)
+        self.bbox = lsst.geom.Box2I(lsst.geom.Point2I(-3, 7), lsst.geom.Extent2I(40, 30))
+        self.image = afwImage.ImageF(self.bbox)
+        self.image.array[:, :] = np.random.lognormal(sigma=3.0, size=self.image.array.shape)
+        self.image.array[::2, :] *= -1
+        self.image.array[0, :6] = [np.nan, np.inf, -np.inf, 1e6, 1e-7, -0.0]
+
+    def tearDown(self):
+        del self.image
+
+    def assertRoundedEqual(self, half, image):
+        """Check that a Float16Image holds the half-precision rounding of an ImageF."""
+        self.assertEqual(half.getBBox(), image.getBBox())
+        expected = image.array.astype(np.float16)
+        values = half.getArray().view(np.float16)
+        np.testing.assert_array_equal(values, expected)
+        converted = half.convertF()
+        self.assertEqual(converted.getBBox(), image.getBBox())
+        np.testing.assert_array_equal(converted.array, expected.astype(np.float32))
+
+    def testConversions(self):
+        """Every half value converts to float and back exactly, as numpy does."""
+        bits = np.arange(2**16, dtype=np.uint16).reshape(256, 256)
+        half = afwImage.Float16Image(lsst.geom.Box2I(lsst.geom.Point2I(0, 0), lsst.geom.Extent2I(256, 256)))
+        half.getArray()[:, :] = bits
+        converted = half.convertF()
+        np.testing.assert_array_equal(converted.array, bits.view(np.float16).astype(np.float32))
+        roundTrip = afwImage.Float16Image(converted).getArray()
+        finite = np.isfinite(converted.array)
+        np.testing.assert_array_equal(roundTrip[finite], bits[finite])
+        self.assertTrue(np.all(np.isnan(roundTrip[~finite & ((bits & 0x3ff) != 0)].view(np.float16))))
+
+    def testRounding(self):
+        half = afwImage.Float16Image(self.image)
+        self.assertRoundedEqual(half, self.image)
+        self.assertEqual(half.getArray().dtype, np.uint16)
+        self.assertEqual(half.getArray().nbytes, self.image.array.nbytes // 2)
+        # ties round to even, and values beyond 65504 overflow
+        image = afwImage.ImageF(lsst.geom.Extent2I(5, 1))
+        image.array[0, :] = [2049.0, 2051.0, 65519.0, 65520.0, 2.0**-25]
+        np.testing.assert_array_equal(afwImage.Float16Image(image).convertF().array[0],
+                                      [2048.0, 2052.0, 65504.0, np.inf, 0.0])
+
+    def testPixels(self):
+        half = afwImage.Float16Image(self.image)
+        point = lsst.geom.Point2I(5, 20)
+        self.assertEqual(half.get(point), np.float16(self.image[point]))
+        half.set(point, 1.0/3.0)
+        self.assertEqual(half.get(point), np.float16(1.0/3.0))
+        self.assertEqual(half.get(lsst.geom.Point2I(8, 13), afwImage.LOCAL), half.get(point))
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            half.get(lsst.geom.Point2I(-4, 7))
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            half.set(lsst.geom.Point2I(40, 0), 1.0, afwImage.LOCAL)
+
+    def testViews(self):
+        half = afwImage.Float16Image(self.image)
+        region = lsst.geom.Box2I(lsst.geom.Point2I(2, 10), lsst.geom.Extent2I(12, 8))
+        view = afwImage.Float16Image(half, region)
+        self.assertRoundedEqual(view, self.image.subset(region))
+        clone = half.clone()
+        view.assign(afwImage.ImageF(region, 4.0))
+        self.assertEqual(half.get(region.getMin()), 4.0)
+        self.assertRoundedEqual(clone, self.image)
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            view.assign(self.image)
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            afwImage.Float16Image(view, self.bbox)
+
+    def testStatistics(self):
+        """Statistics are computed in float, from the converted image."""
+        image = afwImage.ImageF(self.bbox)
+        image.array[:, :] = np.random.normal(100.0, 10.0, size=image.array.shape)
+        half = afwImage.Float16Image(image)
+        stats = afwMath.makeStatistics(half.convertF(), afwMath.MEAN | afwMath.STDEV)
+        rounded = image.array.astype(np.float16).astype(np.float32)
+        self.assertFloatsAlmostEqual(stats.getValue(afwMath.MEAN), np.mean(rounded), rtol=1e-6)
+        self.assertFloatsAlmostEqual(stats.getValue(afwMath.STDEV), np.std(rounded, ddof=1), rtol=1e-5)
+
+    def testFits(self):
+        half = afwImage.Float16Image(self.image)
+        with lsst.utils.tests.getTempFilePath(".fits") as fileName:
+            half.writeFits(fileName)
+            self.assertEqual(afwImage.ImageF.readFits(fileName).getArray().dtype, np.float32)
+            self.assertRoundedEqual(afwImage.Float16Image.readFits(fileName), self.image)
+        # scaled to 16-bit integers
+        image = afwImage.ImageF(self.bbox)
+        image.array[:, :] = np.random.uniform(0.0, 100.0, size=image.array.shape)
+        half = afwImage.Float16Image(image)
+        scaling = lsst.afw.fits.ImageScalingOptions(lsst.afw.fits.ImageScalingOptions.RANGE, 16, [],
+                                                    fuzz=False)
+        options = lsst.afw.fits.ImageWriteOptions(scaling)
+        with lsst.utils.tests.getTempFilePath(".fits") as fileName:
+            half.writeFits(fileName, options)
+            metadata = lsst.afw.fits.readMetadata(fileName)
+            self.assertEqual(metadata.getScalar("BITPIX"), 16)
+            readBack = afwImage.Float16Image.readFits(fileName)
+            self.assertFloatsAlmostEqual(readBack.convertF().array, half.convertF().array, atol=0.1)
+
+
+class TestMemory(lsst.utils.tests.MemoryTestCase):
+    pass
+
+
+def setup_module(module):
+    lsst.utils.tests.init()
+
+
+if __name__ == "__main__":
+    lsst.utils.tests.init()
+    unittest.main()
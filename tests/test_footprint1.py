@@ -734,6 +734,53 @@ class FootprintTestCase(lsst.utils.tests.TestCase):
             self.assertEqual(peak.getIx(), truth[0]*scaleFactor)
             self.assertEqual(peak.getIy(), truth[1]*scaleFactor)
 
+    def testTransformFootprints(self):
+        """Test that transforming many Footprints at once matches
+        transforming them one at a time.
+        """
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(0, 0), lsst.geom.Extent2I(300, 300))
+        crval = lsst.geom.SpherePoint(30, 10, lsst.geom.degrees)
+        source = afwGeom.makeSkyWcs(crpix=lsst.geom.Point2D(150, 150), crval=crval,
+                                    cdMatrix=afwGeom.makeCdMatrix(scale=0.2*lsst.geom.arcseconds))
+        target = afwGeom.makeSkyWcs(crpix=lsst.geom.Point2D(140, 160), crval=crval,
+                                    cdMatrix=afwGeom.makeCdMatrix(scale=0.25*lsst.geom.arcseconds,
+                                                                  orientation=30*lsst.geom.degrees))
+        rng = np.random.RandomState(3)
+        footprints = []
+        for i in range(20):
+            spans = afwGeom.SpanSet.fromShape(int(rng.randint(1, 8)), afwGeom.Stencil.CIRCLE,
+                                              lsst.geom.Point2I(rng.randint(0, 300), rng.randint(0, 300)))
+            footprint = afwDetect.Footprint(spans, bbox)
+            for peak in range(i % 3):
+                center = spans.computeCentroid()
+                footprint.addPeak(center.getX() + peak, center.getY(), 10.0 + peak)
+            footprints.append(footprint)
+        footprints.append(afwDetect.Footprint(afwGeom.SpanSet(), bbox))
+
+        for doClip in (True, False):
+            expected = [fp.transform(source, target, bbox, doClip) for fp in footprints]
+            for numThreads in (1, 3):
+                with self.subTest(doClip=doClip, numThreads=numThreads):
+                    result = afwDetect.transformFootprints(footprints, source, target, bbox, doClip=doClip,
+                                                           numThreads=numThreads)
+                    self.assertEqual(len(result), len(expected))
+                    for fp, fpExpected in zip(result, expected):
+                        self.assertEqual(fp.getSpans(), fpExpected.getSpans())
+                        self.assertEqual(fp.getRegion(), bbox)
+                        self.assertEqual(len(fp.getPeaks()), len(fpExpected.getPeaks()))
+                        for peak, peakExpected in zip(fp.getPeaks(), fpExpected.getPeaks()):
+                            self.assertEqual(peak.getF(), peakExpected.getF())
+                            self.assertEqual(peak.getPeakValue(), peakExpected.getPeakValue())
+
+        fs = afwDetect.FootprintSet(bbox)
+        fs.setFootprints(footprints)
+        transformed = fs.transform(source, target, bbox, numThreads=2)
+        self.assertEqual(transformed.getRegion(), bbox)
+        self.assertEqual([fp.getSpans() for fp in transformed.getFootprints()],
+                         [fp.transform(source, target, bbox).getSpans() for fp in footprints])
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            afwDetect.transformFootprints(footprints, source, target, bbox, numThreads=-1)
+
     def testCopyWithinFootprintImage(self):
         W, H = 10, 10
         dims = lsst.geom.Extent2I(W, H)
@@ -1192,6 +1239,32 @@ class FootprintSetTestCase(unittest.TestCase):
 
         self.assertEqual(len(foot.getPeaks()), 5)
 
+    def testParallel(self):
+        """Test that searching bands of rows in parallel finds the same
+        Footprints, in the same order, as a serial search"""
+        rng = np.random.RandomState(5)
+        mi = afwImage.MaskedImageF(lsst.geom.Extent2I(97, 131))
+        mi.image.array[:, :] = rng.normal(size=mi.image.array.shape).astype(np.float32)
+        mi.variance.array[:, :] = rng.uniform(0.5, 2.0, size=mi.variance.array.shape)
+        for threshold in (afwDetect.Threshold(0.5),
+                          afwDetect.Threshold(0.5, afwDetect.Threshold.VALUE, False),
+                          afwDetect.Threshold(1.0, afwDetect.Threshold.PIXEL_STDEV, True, 1.5)):
+            serial = afwDetect.FootprintSet(mi, threshold).getFootprints()
+            self.assertGreater(len(serial), 10)
+            for numThreads in (2, 3, 0):
+                parallel = afwDetect.FootprintSet(mi, threshold, numThreads=numThreads).getFootprints()
+                self.assertEqual(len(parallel), len(serial))
+                for fp1, fp2 in zip(serial, parallel):
+                    self.assertEqual(fp1.getSpans(), fp2.getSpans())
+                    self.assertEqual([(p.getIx(), p.getIy(), p.getPeakValue()) for p in fp1.getPeaks()],
+                                     [(p.getIx(), p.getIy(), p.getPeakValue()) for p in fp2.getPeaks()])
+                # Peak IDs come from a shared table, so are only reproducible relative to the first
+                ids1 = np.array([p.getId() for fp in serial for p in fp.getPeaks()])
+                ids2 = np.array([p.getId() for fp in parallel for p in fp.getPeaks()])
+                np.testing.assert_array_equal(ids1 - ids1.min(), ids2 - ids2.min())
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            afwDetect.FootprintSet(mi, afwDetect.Threshold(0.5), numThreads=-1)
+
 
 class MaskFootprintSetTestCase(unittest.TestCase):
     """A test case for generating FootprintSet from Masks"""
@@ -32,6 +32,7 @@ import unittest
 
 import lsst.utils.tests
 import lsst.geom
+import lsst.pex.exceptions
 import lsst.afw.table as afwTable
 import lsst.afw.image as afwImage
 import lsst.afw.geom as afwGeom
@@ -228,6 +229,141 @@ class FootprintSetTestCase(unittest.TestCase):
             self.assertLessEqual(len(grown.getFootprints()),
                                  len(fs.getFootprints()))
 
+    def testInsertIntoImageThreaded(self):
+        """Check that threaded painting of a FootprintSet matches painting each Footprint in turn"""
+        ds = afwDetect.FootprintSet(self.im, afwDetect.Threshold(10))
+        grown = afwDetect.FootprintSet(ds, 3, True)  # overlapping Footprints are summed
+        for fs in (ds, grown):
+            expectedIds = afwImage.ImageL(fs.getRegion())
+            expectedMask = afwImage.Mask(fs.getRegion())
+            bitmask = expectedMask.getPlaneBitMask("DETECTED")
+            for i, foot in enumerate(fs.getFootprints()):
+                for sp in foot.getSpans():
+                    expectedIds.array[sp.getY() - expectedIds.getY0(),
+                                      sp.getX0() - expectedIds.getX0():sp.getX1() + 1 - expectedIds.getX0()] \
+                        += i + 1
+                foot.spans.setMask(expectedMask, bitmask)
+            self.assertImagesEqual(fs.insertIntoImage(), expectedIds)
+            # A reused image, larger than the region, is cleared first.
+            bbox = fs.getRegion()
+            bbox.grow(2)
+            idImage = afwImage.ImageL(bbox)
+            for numThreads in (1, 0, 3):
+                self.assertImagesEqual(fs.insertIntoImage(numThreads=numThreads), expectedIds)
+                idImage.set(12345)
+                fs.insertIntoImage(idImage, numThreads=numThreads)
+                self.assertImagesEqual(idImage[fs.getRegion()], expectedIds)
+                self.assertEqual(idImage.array[0, 0], 0)
+                mask = afwImage.Mask(fs.getRegion())
+                fs.setMask(mask, "DETECTED", numThreads=numThreads)
+                self.assertMasksEqual(mask, expectedMask)
+
+        tooSmall = afwImage.ImageL(lsst.geom.Box2I(ds.getRegion().getMin(), lsst.geom.Extent2I(2, 2)))
+        with self.assertRaises(lsst.pex.exceptions.OutOfRangeError):
+            ds.insertIntoImage(tooSmall, numThreads=2)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            ds.insertIntoImage(numThreads=-1)
+
+    def testBothPolarities(self):
+        """Test that one pass for both polarities matches two single-polarity FootprintSets"""
+        rng = np.random.Generator(np.random.MT19937(11))
+        mi = afwImage.MaskedImageF(100, 80)
+        mi.setXY0(5, 9)
+        mi.image.array[:, :] = rng.normal(0.0, 1.0, size=mi.image.array.shape)
+        mi.variance.array[:, :] = rng.uniform(0.5, 2.0, size=mi.variance.array.shape)
+        for sign in (1, -1):
+            for x, y in zip(rng.integers(1, 99, size=30), rng.integers(1, 79, size=30)):
+                mi.image.array[y - 1:y + 2, x - 1:x + 2] += sign*rng.uniform(5.0, 30.0)
+
+        for thresholdType, value in ((afwDetect.Threshold.VALUE, 4.0),
+                                     (afwDetect.Threshold.PIXEL_STDEV, 4.0),
+                                     (afwDetect.Threshold.STDEV, 3.5)):
+            threshold = afwDetect.Threshold(value, thresholdType, True, 1.5)
+            negThreshold = afwDetect.Threshold(value, thresholdType, False, 1.5)
+            for numThreads in (1, 0):
+                expectedMi = mi.clone()
+                expectedPos = afwDetect.FootprintSet(expectedMi, threshold, "DETECTED", 2)
+                expectedNeg = afwDetect.FootprintSet(expectedMi, negThreshold, "DETECTED_NEGATIVE", 2)
+                self.assertGreater(len(expectedPos.getFootprints()), 0)
+                self.assertGreater(len(expectedNeg.getFootprints()), 0)
+                copy = mi.clone()
+                pos, neg = afwDetect.FootprintSet.makeBothPolarities(
+                    copy, threshold, "DETECTED", "DETECTED_NEGATIVE", 2, numThreads=numThreads)
+                for found, expected in ((pos, expectedPos), (neg, expectedNeg)):
+                    self.assertEqual(found.getRegion(), expected.getRegion())
+                    self.assertEqual(len(found.getFootprints()), len(expected.getFootprints()))
+                    for foot1, foot2 in zip(found.getFootprints(), expected.getFootprints()):
+                        self.assertEqual(foot1.spans, foot2.spans)
+                        self.assertEqual([(p.getIx(), p.getIy()) for p in foot1.peaks],
+                                         [(p.getIx(), p.getIy()) for p in foot2.peaks])
+                self.assertMasksEqual(copy.mask, expectedMi.mask)
+
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            afwDetect.FootprintSet.makeBothPolarities(mi, afwDetect.Threshold(1, afwDetect.Threshold.BITMASK))
+
+    def testMakePeakCatalog(self):
+        """Test that the Peaks of a FootprintSet can be viewed as one contiguous catalog"""
+        rng = np.random.Generator(np.random.MT19937(3))
+        im = afwImage.ImageF(90, 70)
+        im.array[:, :] = rng.normal(0.0, 1.0, size=im.array.shape)
+        for x, y in zip(rng.integers(0, 90, size=40), rng.integers(0, 70, size=40)):
+            im.array[y, x] += rng.uniform(10.0, 50.0)
+        for numThreads in (1, 0):
+            fs = afwDetect.FootprintSet(im, afwDetect.Threshold(5), numThreads=numThreads)
+            footprints = fs.getFootprints()
+            self.assertGreater(len(footprints), 10)
+            for foot in footprints:
+                values = [p.getPeakValue() for p in foot.peaks]
+                self.assertEqual(values, sorted(values, reverse=True))
+            peaks = fs.makePeakCatalog()
+            self.assertEqual(len(peaks), sum(len(foot.peaks) for foot in footprints))
+            self.assertTrue(peaks.isContiguous())
+            np.testing.assert_array_equal(peaks["peakValue"],
+                                          [p.getPeakValue() for foot in footprints for p in foot.peaks])
+            np.testing.assert_array_equal(peaks["i_x"],
+                                          [p.getIx() for foot in footprints for p in foot.peaks])
+            # Merged Footprints keep their Peaks, even if they are no longer contiguous.
+            grown = afwDetect.FootprintSet(fs, 5, True)
+            self.assertEqual(sorted(p.getId() for p in grown.makePeakCatalog()),
+                             sorted(p.getId() for p in peaks))
+
+        self.assertEqual(len(afwDetect.FootprintSet(im.getBBox()).makePeakCatalog()), 0)
+
+    def testGrowDistanceTransform(self):
+        """Test that both growth algorithms give the same Footprints and Peaks"""
+        rng = np.random.Generator(np.random.MT19937(5))
+        im = afwImage.ImageF(120, 90)
+        im.setXY0(17, -3)
+        im.array[:, :] = rng.normal(0.0, 1.0, size=im.array.shape)
+        for x, y in zip(rng.integers(0, 120, size=60), rng.integers(0, 90, size=60)):
+            im.array[max(y - 1, 0):y + 2, max(x - 1, 0):x + 2] += rng.uniform(10.0, 50.0)
+        fs = afwDetect.FootprintSet(im, afwDetect.Threshold(5))
+        self.assertGreater(len(fs.getFootprints()), 20)
+        Algorithm = afwDetect.FootprintSet.GrowthAlgorithm
+        for rGrow in (0, 1, 4, 9):
+            for isotropic in (True, False):
+                expected = afwDetect.FootprintSet(fs, rGrow, isotropic)
+                for numThreads in (1, 0):
+                    grown = afwDetect.FootprintSet(fs, rGrow, isotropic, Algorithm.DISTANCE_TRANSFORM,
+                                                   numThreads=numThreads)
+                    self.assertEqual(grown.getRegion(), expected.getRegion())
+                    self.assertEqual(len(grown.getFootprints()), len(expected.getFootprints()))
+                    for foot1, foot2 in zip(grown.getFootprints(), expected.getFootprints()):
+                        self.assertEqual(foot1.spans, foot2.spans)
+                        self.assertEqual([(p.getIx(), p.getIy(), p.getPeakValue()) for p in foot1.peaks],
+                                         [(p.getIx(), p.getIy(), p.getPeakValue()) for p in foot2.peaks])
+                dilated = afwDetect.FootprintSet(fs, rGrow, isotropic, Algorithm.DILATE)
+                self.assertEqual([f.spans for f in dilated.getFootprints()],
+                                 [f.spans for f in expected.getFootprints()])
+
+        empty = afwDetect.FootprintSet(afwDetect.FootprintSet(im.getBBox()), 3, True,
+                                       Algorithm.DISTANCE_TRANSFORM)
+        self.assertEqual(len(empty.getFootprints()), 0)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            afwDetect.FootprintSet(fs, -1, True, Algorithm.DISTANCE_TRANSFORM)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            afwDetect.FootprintSet(fs, 2, True, Algorithm.DISTANCE_TRANSFORM, numThreads=-1)
+
     def testFootprintControl(self):
         """Test the FootprintControl constructor"""
         fctrl = afwDetect.FootprintControl()
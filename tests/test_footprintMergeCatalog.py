@@ -26,6 +26,7 @@ import numpy as np
 import lsst.utils.tests
 import lsst.pex.exceptions
 import lsst.geom
+import lsst.afw.geom as afwGeom
 import lsst.afw.image as afwImage
 import lsst.afw.detection as afwDetect
 import lsst.afw.table as afwTable
@@ -350,6 +351,52 @@ class FootprintMergeCatalogTestCase(lsst.utils.tests.TestCase):
             for peak in record.getFootprint().getPeaks():
                 self.assertTrue(isPeakInCatalog(peak, merge))
 
+    def testCrowded(self):
+        """Test merging many footprints spread over a large area
+
+        Rows of small squares, some of which are joined by long bars in a
+        second catalog, stretching across negative and positive coordinates.
+        """
+        nx, ny, size = 30, 10, 5
+        schema = afwTable.SourceTable.makeMinimalSchema()
+        idFactory = afwTable.IdFactory.makeSimple()
+        table = afwTable.SourceTable.make(schema, idFactory)
+
+        def addFootprint(catalog, box):
+            footprint = afwDetect.Footprint(afwGeom.SpanSet(box))
+            center = box.getCenter()
+            footprint.addPeak(int(center.getX()), int(center.getY()), 1.0)
+            catalog.addNew().setFootprint(footprint)
+
+        squares = afwTable.SourceCatalog(table)
+        for j in range(ny):
+            for i in range(nx):
+                addFootprint(squares, lsst.geom.Box2I(lsst.geom.Point2I(-300 + 20*i, -200 + 40*j),
+                                                      lsst.geom.Extent2I(size, size)))
+        bars = afwTable.SourceCatalog(table)
+        for j in range(0, ny, 2):
+            addFootprint(bars, lsst.geom.Box2I(lsst.geom.Point2I(-400, -200 + 40*j),
+                                               lsst.geom.Point2I(300, -198 + 40*j)))
+
+        merge, nob, npeak = mergeCatalogs([squares, bars], ["1", "2"], -1, idFactory)
+
+        self.assertEqual(nob, (ny//2)*nx + ny//2)
+        self.assertUniqueIds(merge)
+        records = iter(merge)
+        for j in range(ny):
+            if j % 2 == 0:
+                # The bar absorbs the whole row, in place of its first square
+                record = next(records)
+                self.assertTrue(record.get("merge_footprint_2"))
+                self.assertEqual(record.getFootprint().getArea(), nx*size*size + 701*3 - nx*size*3)
+                self.assertEqual(len(record.getFootprint().getPeaks()), nx)
+            else:
+                for i in range(nx):
+                    record = next(records)
+                    self.assertFalse(record.get("merge_footprint_2"))
+                    self.assertEqual(record.getFootprint().getBBox().getMin(),
+                                     lsst.geom.Point2I(-300 + 20*i, -200 + 40*j))
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
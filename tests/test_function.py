@@ -698,6 +698,38 @@ class FunctionTestCase(lsst.utils.tests.TestCase):
                 f(x, y),
                 sum([params[i]*dFdC[i] for i in range(len(params))]))
 
+    def testArrayEvaluation(self):
+        """Test that evaluate and evaluateGrid match evaluating one point at a time"""
+        rng = np.random.RandomState(11)
+        x = rng.uniform(-10.0, 30.0, size=23)
+        y = rng.uniform(-5.0, 25.0, size=23)
+        xyRange = lsst.geom.Box2D(lsst.geom.Point2D(-10.0, -5.0), lsst.geom.Point2D(30.0, 25.0))
+        for order in range(5):
+            nParams = afwMath.PolynomialFunction2D.nParametersFromOrder(order)
+            params = list(rng.randn(nParams))
+            functions2 = [afwMath.PolynomialFunction2D(params), afwMath.Chebyshev1Function2D(params, xyRange),
+                          afwMath.PolynomialFunction2F(params)]
+            # GaussianFunction2 has no array specialization, so this tests the default implementation
+            functions2.append(afwMath.GaussianFunction2D(3.0, 2.0, 0.4))
+            for f in functions2:
+                expected = np.array([f(xi, yi) for xi, yi in zip(x, y)])
+                self.assertFloatsAlmostEqual(f.evaluate(x, y), expected, rtol=1e-10, atol=1e-12)
+                expectedGrid = np.array([[f(xi, yi) for xi in x[:5]] for yi in y[:4]])
+                grid = f.evaluateGrid(x[:5], y[:4])
+                self.assertEqual(grid.shape, (4, 5))
+                self.assertFloatsAlmostEqual(grid, expectedGrid, rtol=1e-10, atol=1e-12)
+            with self.assertRaises(pexExceptions.LengthError):
+                functions2[0].evaluate(x, y[:-1])
+
+            params1 = list(rng.randn(order + 1))
+            for f in (afwMath.PolynomialFunction1D(params1),
+                      afwMath.Chebyshev1Function1D(params1, -10.0, 30.0),
+                      afwMath.GaussianFunction1D(2.0)):
+                expected = np.array([f(xi) for xi in x])
+                self.assertFloatsAlmostEqual(f.evaluate(x), expected, rtol=1e-10, atol=1e-12)
+                # non-contiguous input
+                self.assertFloatsAlmostEqual(f.evaluate(x[::2]), expected[::2], rtol=1e-10, atol=1e-12)
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
@@ -452,6 +452,61 @@ class FunctorKeysTestCase(lsst.utils.tests.TestCase):
                     self.doTestCovarianceMatrixKeyAddFields(
                         fieldType, varianceOnly, dynamicSize)
 
+    def testColumns(self):
+        """Test getColumns and setColumns against per-record get and set.
+        """
+        schema = lsst.afw.table.Schema()
+        coordKey = lsst.afw.table.CoordKey.addFields(schema, "coord", "position")
+        ellipseKey = lsst.afw.table.EllipseKey.addFields(schema, "a", "shape", "pixel")
+        sigmaKeys = [schema.addField(f"b_{p}Err", type="F", doc="") for p in "xyz"]
+        covKeys = [schema.addField("b_x_y_Cov", type="F", doc=""), lsst.afw.table.Key["F"](),
+                   schema.addField("b_y_z_Cov", type="F", doc="")]
+        covKey = lsst.afw.table.CovarianceMatrix3fKey(sigmaKeys, covKeys)
+        catalog = lsst.afw.table.BaseCatalog(schema)
+        for i in range(5):
+            record = catalog.addNew()
+            record.set(coordKey, lsst.geom.SpherePoint(0.1*i, 0.05*i, lsst.geom.radians))
+            ellipse = lsst.afw.geom.Ellipse(lsst.afw.geom.Quadrupole(3.0 + i, 2.0, 0.5*i),
+                                            lsst.geom.Point2D(i, -i))
+            record.set(ellipseKey, ellipse)
+            record.set(covKey, makePositiveSymmetricMatrix(3))
+        columns = catalog.getColumnView()
+
+        coords = coordKey.getColumns(columns)
+        ellipses = ellipseKey.getColumns(columns)
+        quadrupoles = ellipseKey.getCore().getColumns(columns)
+        matrices = covKey.getColumns(columns)
+        self.assertEqual(coords.shape, (5, 2))
+        self.assertEqual(ellipses.shape, (5, 5))
+        self.assertEqual(matrices.shape, (5, 3, 3))
+        for i, record in enumerate(catalog):
+            coord = record.get(coordKey)
+            self.assertFloatsAlmostEqual(coords[i], [coord.getRa().asRadians(), coord.getDec().asRadians()])
+            ellipse = record.get(ellipseKey)
+            expected = [ellipse.getCore().getIxx(), ellipse.getCore().getIyy(), ellipse.getCore().getIxy(),
+                        ellipse.getCenter().getX(), ellipse.getCenter().getY()]
+            self.assertFloatsAlmostEqual(ellipses[i], expected)
+            self.assertFloatsAlmostEqual(quadrupoles[i], expected[:3])
+            self.assertFloatsAlmostEqual(matrices[i], record.get(covKey))
+            self.assertEqual(matrices[i, 0, 2], 0.0)
+
+        # round-trip through setColumns into a second catalog
+        copy = lsst.afw.table.BaseCatalog(schema)
+        for _ in catalog:
+            copy.addNew()
+        copyColumns = copy.getColumnView()
+        coordKey.setColumns(copyColumns, coords)
+        ellipseKey.setColumns(copyColumns, ellipses)
+        covKey.setColumns(copyColumns, matrices)
+        for record, copyRecord in zip(catalog, copy):
+            self.assertEqual(copyRecord.get(coordKey), record.get(coordKey))
+            self.assertFloatsAlmostEqual(copyRecord.get(covKey), record.get(covKey), rtol=1E-6)
+        self.assertFloatsAlmostEqual(ellipseKey.getColumns(copyColumns), ellipses)
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            coordKey.setColumns(copyColumns, coords[:3])
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            ellipseKey.setColumns(copyColumns, ellipses[:, :3])
+
     def doTestArrayKey(self, fieldType, numpyType):
         FunctorKeyType = getattr(lsst.afw.table, f"Array{fieldType}Key")
         self.assertFalse(FunctorKeyType().isValid())
@@ -1452,6 +1452,118 @@ class GaussianProcessTestCase(lsst.utils.tests.TestCase):
         print("worst mu error ", worstMuErr)
         print("worst sig2 error ", worstVarErr)
 
+    def testCovariogramEvaluate(self):
+        """
+        Test that Covariogram.evaluate agrees with evaluating the covariogram
+        one pair of points at a time
+        """
+        rng = np.random.RandomState(41)
+        points = rng.rand(30, 3)
+        point = rng.rand(3)
+
+        squaredExp = afwMath.SquaredExpCovariogramD()
+        squaredExp.setEllSquared(0.3)
+        neuralNet = afwMath.NeuralNetCovariogramD()
+        neuralNet.setSigma0(0.7)
+        neuralNet.setSigma1(1.3)
+
+        result = np.zeros(len(points), dtype=float)
+        squaredExp.evaluate(result, point, points)
+        expected = [squaredExp(point, p) for p in points]
+        self.assertFloatsAlmostEqual(result, np.array(expected), rtol=1.0e-14)
+
+        # Rasmussen and Williams (2006) equation 4.29, as in NeuralNetCovariogram
+        neuralNet.evaluate(result, point, points)
+        num = 2.0*0.7 + 2.0*1.3*np.dot(points, point)
+        denom1 = 1.0 + 2.0*0.7 + 2.0*1.3*np.dot(point, point)
+        denom2 = 1.0 + 2.0*0.7 + 2.0*1.3*np.sum(points**2, axis=1)
+        expected = 2.0*np.arcsin(num/np.sqrt(denom1*denom2))/3.141592654
+        self.assertFloatsAlmostEqual(result, expected, rtol=1.0e-12)
+
+    def testBatchMultithreaded(self):
+        """
+        Test that GaussianProcess.batchInterpolate gives the same results
+        on several threads as on one
+        """
+        rng = np.random.RandomState(52)
+        data = rng.rand(80, 2)
+        fn = np.column_stack([np.sin(3.0*data[:, 0])*data[:, 1], np.cos(2.0*data[:, 1])])
+        queries = rng.rand(237, 2)
+
+        covar = afwMath.SquaredExpCovariogramD()
+        covar.setEllSquared(0.2)
+        gg = afwMath.GaussianProcessD(data, fn, covar)
+        gg.setLambda(0.001)
+        self.assertEqual(gg.getNumThreads(), 1)
+        with self.assertRaises(pex.InvalidParameterError):
+            gg.setNumThreads(-1)
+
+        mu1 = np.zeros((len(queries), 2), dtype=float)
+        var1 = np.zeros((len(queries), 2), dtype=float)
+        gg.batchInterpolate(mu1, var1, queries)
+
+        # the first function alone must agree with the vector of functions
+        gg1 = afwMath.GaussianProcessD(data, fn[:, 0].copy(), covar)
+        gg1.setLambda(0.001)
+        muScalar = np.zeros(len(queries), dtype=float)
+        varScalar = np.zeros(len(queries), dtype=float)
+        gg1.batchInterpolate(muScalar, varScalar, queries)
+        self.assertFloatsAlmostEqual(muScalar, mu1[:, 0], rtol=1.0e-10, atol=1.0e-12)
+        self.assertFloatsAlmostEqual(varScalar, var1[:, 0], rtol=1.0e-10, atol=1.0e-12)
+
+        for numThreads in (4, 0):
+            gg.setNumThreads(numThreads)
+            mu = np.zeros((len(queries), 2), dtype=float)
+            var = np.zeros((len(queries), 2), dtype=float)
+            gg.batchInterpolate(mu, var, queries)
+            self.assertFloatsAlmostEqual(mu, mu1, rtol=1.0e-12, atol=1.0e-14)
+            self.assertFloatsAlmostEqual(var, var1, rtol=1.0e-12, atol=1.0e-14)
+
+            mu[:, :] = 0.0
+            gg.batchInterpolate(mu, queries)
+            self.assertFloatsAlmostEqual(mu, mu1, rtol=1.0e-12, atol=1.0e-14)
+
+    def testBatchApproximation(self):
+        """
+        Test that the low-rank approximation used by
+        GaussianProcess.batchInterpolate converges to the exact interpolation
+        """
+        rng = np.random.RandomState(63)
+        data = rng.rand(400, 2)
+        fn = np.sin(3.0*data[:, 0])*data[:, 1]
+        queries = rng.rand(200, 2)
+
+        covar = afwMath.SquaredExpCovariogramD()
+        covar.setEllSquared(0.1)
+        gg = afwMath.GaussianProcessD(data, fn, covar)
+        gg.setLambda(0.001)
+        self.assertEqual(gg.getApproximationRank(), 0)
+        with self.assertRaises(pex.InvalidParameterError):
+            gg.setApproximationRank(-1)
+
+        muExact = np.zeros(len(queries), dtype=float)
+        varExact = np.zeros(len(queries), dtype=float)
+        gg.batchInterpolate(muExact, varExact, queries)
+
+        mu = np.zeros(len(queries), dtype=float)
+        var = np.zeros(len(queries), dtype=float)
+
+        # a rank of at least the number of data points means no approximation
+        gg.setApproximationRank(len(data))
+        gg.batchInterpolate(mu, var, queries)
+        self.assertFloatsEqual(mu, muExact)
+        self.assertFloatsEqual(var, varExact)
+
+        gg.setApproximationRank(100)
+        gg.setNumThreads(3)
+        gg.batchInterpolate(mu, var, queries)
+        self.assertFloatsAlmostEqual(mu, muExact, atol=1.0e-3)
+        self.assertFloatsAlmostEqual(var, varExact, atol=1.0e-3)
+
+        muNoVariance = np.zeros(len(queries), dtype=float)
+        gg.batchInterpolate(muNoVariance, queries)
+        self.assertFloatsAlmostEqual(muNoVariance, mu, rtol=1.0e-12, atol=1.0e-14)
+
     def testSelf(self):
         """
         This test will test GaussianProcess.selfInterpolation
@@ -1523,6 +1635,70 @@ class GaussianProcessTestCase(lsst.utils.tests.TestCase):
         self.assertLess(worstMuErr, tol)
         self.assertLess(worstSigErr, tol)
 
+    def testBatchSelf(self):
+        """
+        Test that GaussianProcess.batchSelfInterpolate agrees with selfInterpolate
+        on every point, on one thread and on several
+        """
+        rng = np.random.RandomState(61)
+        data = rng.rand(150, 3)
+        fn = np.column_stack([np.sin(3.0*data[:, 0])*data[:, 1], np.cos(2.0*data[:, 2])])
+        kk = 12
+
+        covar = afwMath.SquaredExpCovariogramD()
+        covar.setEllSquared(0.3)
+        gg = afwMath.GaussianProcessD(data, fn, covar)
+        gg.setLambda(0.001)
+        gg.setKrigingParameter(2.0)
+        gg1 = afwMath.GaussianProcessD(data, fn[:, 0].copy(), covar)
+        gg1.setLambda(0.001)
+        gg1.setKrigingParameter(2.0)
+
+        muShould = np.zeros((len(data), 2), dtype=float)
+        varShould = np.zeros((len(data), 2), dtype=float)
+        varScalarShould = np.zeros(len(data), dtype=float)
+        muScalarShould = np.zeros(len(data), dtype=float)
+        variance = np.zeros(1, dtype=float)
+        for i in range(len(data)):
+            gg.selfInterpolate(muShould[i], varShould[i], i, kk)
+            muScalarShould[i] = gg1.selfInterpolate(variance, i, kk)
+            varScalarShould[i] = variance[0]
+
+        indexLists = (np.arange(len(data), dtype=np.int32), np.array([7, 140, 7, 0], dtype=np.int32))
+        for numThreads in (1, 3, 0):
+            gg.setNumThreads(numThreads)
+            gg1.setNumThreads(numThreads)
+            for indices in indexLists:
+                with self.subTest(numThreads=numThreads, nIndices=len(indices)):
+                    mu = np.zeros((len(indices), 2), dtype=float)
+                    var = np.zeros((len(indices), 2), dtype=float)
+                    gg.batchSelfInterpolate(mu, var, indices, kk)
+                    self.assertFloatsAlmostEqual(mu, muShould[indices], rtol=1.0e-12, atol=1.0e-14)
+                    self.assertFloatsAlmostEqual(var, varShould[indices], rtol=1.0e-12, atol=1.0e-14)
+
+                    muScalar = np.zeros(len(indices), dtype=float)
+                    varScalar = np.zeros(len(indices), dtype=float)
+                    gg1.batchSelfInterpolate(muScalar, varScalar, indices, kk)
+                    self.assertFloatsAlmostEqual(muScalar, muScalarShould[indices],
+                                                 rtol=1.0e-12, atol=1.0e-14)
+                    self.assertFloatsAlmostEqual(varScalar, varScalarShould[indices],
+                                                 rtol=1.0e-12, atol=1.0e-14)
+
+        indices = np.arange(10, dtype=np.int32)
+        with self.assertRaises(pex.Exception):
+            # more than one function
+            gg.batchSelfInterpolate(np.zeros(10), np.zeros(10), indices, kk)
+        with self.assertRaises(pex.Exception):
+            gg1.batchSelfInterpolate(np.zeros(9), np.zeros(10), indices, kk)
+        with self.assertRaises(pex.Exception):
+            gg.batchSelfInterpolate(np.zeros((10, 3)), np.zeros((10, 3)), indices, kk)
+        with self.assertRaises(pex.Exception):
+            gg1.batchSelfInterpolate(np.zeros(2), np.zeros(2), np.array([0, 150], dtype=np.int32), kk)
+        with self.assertRaises(pex.Exception):
+            gg1.batchSelfInterpolate(np.zeros(10), np.zeros(10), indices, len(data))
+        with self.assertRaises(pex.Exception):
+            gg1.batchSelfInterpolate(np.zeros(10), np.zeros(10), indices, 0)
+
     def testVector(self):
         """
         This will test interpolate using a vector of functions
@@ -19,6 +19,7 @@
 # You should have received a copy of the GNU General Public License
 # along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+import pickle
 import unittest
 
 import numpy as np
@@ -69,6 +70,19 @@ class GaussianPsfTestCase(lsst.utils.tests.TestCase):
         self.assertFloatsAlmostEqual(image.getArray(), check.getArray())
         self.assertFloatsAlmostEqual(image.getArray().sum(), 1.0, atol=1E-14)
 
+    def testKernelArray(self):
+        image = self.psf.computeKernelImage(self.psf.getAveragePosition())
+        array = np.full((self.kernelSize, self.kernelSize), np.nan)
+        self.psf.computeKernelArray(array)
+        self.assertFloatsEqual(array, image.getArray())
+        psf = lsst.afw.detection.GaussianPsf(7, 5, 1.5)
+        array = np.zeros((5, 7))
+        psf.computeKernelArray(array)
+        check = makeGaussianImage(psf.computeBBox(psf.getAveragePosition()), psf.getSigma())
+        self.assertFloatsAlmostEqual(array, check.getArray())
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            psf.computeKernelArray(np.zeros((7, 5)))
+
     def testOffsetImage(self):
         image = self.psf.computeImage(lsst.geom.Point2D(0.25, 0.25))
         check = makeGaussianImage(
@@ -101,6 +115,21 @@ class GaussianPsfTestCase(lsst.utils.tests.TestCase):
             self.assertEqual(self.psf.getSigma(), psf.getSigma())
             self.assertEqual(self.psf.getDimensions(), psf.getDimensions())
 
+    def testBinaryPersistence(self):
+        data = self.psf.writeBinary()
+        self.assertIsInstance(data, bytes)
+        psf = lsst.afw.detection.GaussianPsf.readBinary(data)
+        self.assertEqual(self.psf.getSigma(), psf.getSigma())
+        self.assertEqual(self.psf.getDimensions(), psf.getDimensions())
+        with self.assertRaises(lsst.pex.exceptions.Exception):
+            lsst.afw.detection.GaussianPsf.readBinary(data[:len(data)//2])
+
+    def testPickle(self):
+        psf = pickle.loads(pickle.dumps(self.psf))
+        self.assertIsInstance(psf, lsst.afw.detection.GaussianPsf)
+        self.assertEqual(self.psf.getSigma(), psf.getSigma())
+        self.assertEqual(self.psf.getDimensions(), psf.getDimensions())
+
     def testBBox(self):
 
         self.assertEqual(self.psf.computeKernelImage(self.psf.getAveragePosition()).getBBox(),
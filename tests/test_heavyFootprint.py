@@ -35,6 +35,7 @@ import numpy as np
 
 import lsst.utils.tests
 import lsst.geom
+import lsst.pex.exceptions
 import lsst.afw.image as afwImage
 import lsst.afw.detection as afwDetect
 import lsst.afw.geom as afwGeom
@@ -151,6 +152,49 @@ class HeavyFootprintTestCase(lsst.utils.tests.TestCase):
         self.assertFloatsEqual(
             self.mi.getImage().getArray(), omi.getImage().getArray())
 
+    def testBatch(self):
+        """Test making and inserting many overlapping HeavyFootprints at once,
+        against doing it one at a time.
+        """
+        rng = np.random.RandomState(4)
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(10, -5), lsst.geom.Extent2I(60, 50))
+        mi = afwImage.MaskedImageF(bbox)
+        mi.image.array[:] = rng.rand(*mi.image.array.shape)
+        mi.mask.array[:] = rng.randint(0, 16, size=mi.mask.array.shape)
+        mi.variance.array[:] = rng.rand(*mi.variance.array.shape)
+        footprints = []
+        for _ in range(30):
+            center = lsst.geom.Point2I(rng.randint(15, 65), rng.randint(0, 40))
+            spans = afwGeom.SpanSet.fromShape(int(rng.randint(1, 6)), afwGeom.Stencil.CIRCLE, center)
+            footprints.append(afwDetect.Footprint(spans.clippedTo(bbox)))
+        expectedHeavies = [afwDetect.makeHeavyFootprint(fp, mi) for fp in footprints]
+        expected = afwImage.MaskedImageF(bbox)
+        for heavy in expectedHeavies:
+            heavy.insert(expected)
+        for numThreads in (1, 3):
+            with self.subTest(numThreads=numThreads):
+                heavies = afwDetect.makeHeavyFootprints(footprints, mi, numThreads=numThreads)
+                self.assertEqual(len(heavies), len(footprints))
+                for heavy, expectedHeavy in zip(heavies, expectedHeavies):
+                    self.assertEqual(heavy.getSpans(), expectedHeavy.getSpans())
+                    self.assertFloatsEqual(heavy.getImageArray(), expectedHeavy.getImageArray())
+                    self.assertFloatsEqual(heavy.getMaskArray(), expectedHeavy.getMaskArray())
+                    self.assertFloatsEqual(heavy.getVarianceArray(), expectedHeavy.getVarianceArray())
+                output = afwImage.MaskedImageF(bbox)
+                afwDetect.insertHeavyFootprints(heavies, output, numThreads=numThreads)
+                self.assertMaskedImagesEqual(output, expected)
+
+        fs = afwDetect.FootprintSet(bbox)
+        fs.setFootprints(footprints)
+        fs.makeHeavy(mi, numThreads=2)
+        for heavy, expectedHeavy in zip(fs.getFootprints(), expectedHeavies):
+            self.assertTrue(heavy.isHeavy())
+            self.assertFloatsEqual(heavy.getImageArray(), expectedHeavy.getImageArray())
+
+        smaller = afwImage.MaskedImageF(lsst.geom.Box2I(bbox.getMin(), lsst.geom.Extent2I(30, 30)))
+        with self.assertRaises(lsst.pex.exceptions.OutOfRangeError):
+            afwDetect.insertHeavyFootprints(expectedHeavies, smaller)
+
     def testXY0(self):
         """Test that inserting a HeavyFootprint obeys XY0"""
         fs = afwDetect.FootprintSet(self.mi, afwDetect.Threshold(1))
@@ -261,6 +305,47 @@ class HeavyFootprintTestCase(lsst.utils.tests.TestCase):
         self.assertFloatsAlmostEqual(heavy1.getVarianceArray(),
                                      heavy2.getVarianceArray(), rtol=0.0, atol=0.0)
 
+    def testCompactFitsPersistence(self):
+        """Test that the compressed pixels of every pixel type round-trip exactly.
+        """
+        rng = np.random.Generator(np.random.MT19937(5))
+        spans = afwGeom.SpanSet([afwGeom.Span(-20, -5, 30), afwGeom.Span(-19, 100, 101),
+                                 afwGeom.Span(40, -300, -250)])
+        foot = afwDetect.Footprint(spans)
+        foot.addPeak(-3, -20, 4.0)
+        n = foot.getArea()
+        for heavyType, dtype in [(afwDetect.HeavyFootprintU, np.uint16),
+                                 (afwDetect.HeavyFootprintI, np.int32),
+                                 (afwDetect.HeavyFootprintF, np.float32),
+                                 (afwDetect.HeavyFootprintD, np.float64)]:
+            with self.subTest(dtype=dtype):
+                heavy1 = heavyType(foot)
+                if np.issubdtype(dtype, np.integer):
+                    info = np.iinfo(dtype)
+                    image = rng.integers(info.min, info.max, size=n, endpoint=True, dtype=dtype)
+                    image[:10] = 7
+                else:
+                    image = rng.normal(100.0, 10.0, size=n).astype(dtype)
+                    image[:3] = [np.nan, np.inf, -0.0]
+                heavy1.getImageArray()[:] = image
+                mask = np.zeros(n, dtype=afwImage.MaskPixel)
+                mask[5:9] = 3
+                mask[-1] = -1
+                heavy1.getMaskArray()[:] = mask
+                variance = np.full(n, 25.0, dtype=np.float32)
+                variance[::7] = rng.uniform(1.0, 50.0, size=variance[::7].size)
+                heavy1.getVarianceArray()[:] = variance
+                with lsst.utils.tests.getTempFilePath(".fits") as filename:
+                    heavy1.writeFits(filename)
+                    heavy2 = heavyType.readFits(filename)
+                self.assertEqual(list(heavy1.getSpans()), list(heavy2.getSpans()))
+                self.assertEqual(len(heavy2.getPeaks()), 1)
+                np.testing.assert_array_equal(heavy2.getImageArray(), image)
+                np.testing.assert_array_equal(np.signbit(heavy2.getImageArray()),
+                                              np.signbit(image))
+                np.testing.assert_array_equal(heavy2.getMaskArray(), mask)
+                np.testing.assert_array_equal(heavy2.getVarianceArray(), variance)
+
     def testLegacyHeavyFootprintMaskLoading(self):
         filename = os.path.join(os.path.split(__file__)[0],
                                 "data", "legacyHeavyFootprint.fits")
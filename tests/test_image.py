@@ -188,6 +188,34 @@ class ImageTestCase(lsst.utils.tests.TestCase):
 
         self.assertRaises(lsst.pex.exceptions.LengthError, tst)
 
+    def testPooledPixelAllocator(self):
+        """Test that images made in a ScopedPixelAllocator reuse pooled
+        buffers without changing their contents.
+        """
+        pool = afwImage.PooledPixelAllocator(maxCachedBytes=1 << 26)
+        self.assertIsNone(afwImage.getPixelAllocator())
+        with afwImage.ScopedPixelAllocator(pool):
+            self.assertIs(afwImage.getPixelAllocator(), pool)
+            image = afwImage.ImageF(512, 512, 3.0)
+            del image
+            image = afwImage.ImageF(500, 510, 2.0)
+            np.testing.assert_array_equal(image.array, 2.0)
+            small = afwImage.ImageF(10, 10, 1.0)
+            np.testing.assert_array_equal(small.array, 1.0)
+            with afwImage.ScopedPixelAllocator(None):
+                self.assertIsNone(afwImage.getPixelAllocator())
+            self.assertIs(afwImage.getPixelAllocator(), pool)
+        self.assertIsNone(afwImage.getPixelAllocator())
+        statistics = pool.getStatistics()
+        self.assertEqual(statistics.hits, 1)
+        self.assertEqual(statistics.misses, 1)
+        self.assertEqual(statistics.cachedBytes, 0)
+        # Buffers outlive both the scope and the allocator
+        del pool
+        image.array[:, :] = 4.0
+        del image
+        self.assertEqual(afwImage.ImageF(3, 3, 5.0).array[1, 1], 5.0)
+
     def testAddImages(self):
         self.image2 += self.image1
         self.image1 += self.val1
@@ -0,0 +1,129 @@
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ImageExpressionCpp
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-variable"
+#include "boost/test/unit_test.hpp"
+#pragma clang diagnostic pop
+#include "boost/test/tools/floating_point_comparison.hpp"
+
+#include "lsst/pex/exceptions.h"
+#include "lsst/afw/image/ImageExpression.h"
+
+namespace lsst {
+namespace afw {
+namespace image {
+
+namespace {
+
+using MaskedImageT = MaskedImage<float>;
+
+MaskedImageT makeMaskedImage(int width, int height, float offset) {
+    MaskedImageT result(lsst::geom::Extent2I(width, height));
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            (*result.getImage())(x, y) = offset + 0.5 * x - 0.25 * y;
+            (*result.getMask())(x, y) = (x + y) % 3 == 0 ? static_cast<int>(offset) % 8 : 0;
+            (*result.getVariance())(x, y) = 1.0 + 0.1 * offset + 0.01 * x * y;
+        }
+    }
+    return result;
+}
+
+void checkClose(MaskedImageT const& actual, MaskedImageT const& expected) {
+    for (int y = 0; y < expected.getHeight(); ++y) {
+        for (int x = 0; x < expected.getWidth(); ++x) {
+            BOOST_CHECK_CLOSE((*actual.getImage())(x, y), (*expected.getImage())(x, y), 1e-3);
+            BOOST_CHECK_EQUAL((*actual.getMask())(x, y), (*expected.getMask())(x, y));
+            BOOST_CHECK_CLOSE((*actual.getVariance())(x, y), (*expected.getVariance())(x, y), 1e-3);
+        }
+    }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(FusedMatchesInPlaceOperators) {
+    int const width = 31, height = 17;
+    MaskedImageT const b = makeMaskedImage(width, height, 3.0);
+    MaskedImageT const c = makeMaskedImage(width, height, 5.0);
+    MaskedImageT const d = makeMaskedImage(width, height, 12.0);
+    double const s = 1.5;
+
+    MaskedImageT expected(b, true);
+    expected -= c;
+    expected *= s;
+    expected += d;
+
+    MaskedImageT quotient(b, true);
+    quotient /= d;
+    MaskedImageT product(c, true);
+    product *= d;
+
+    for (int numThreads : {1, 3, 0}) {
+        MaskedImageT actual(b.getDimensions());
+        expr::evaluate(actual, (expr::lazy(b) - expr::lazy(c)) * s + expr::lazy(d), numThreads);
+        checkClose(actual, expected);
+
+        expr::evaluate(actual, expr::lazy(b) / expr::lazy(d), numThreads);
+        checkClose(actual, quotient);
+
+        expr::evaluate(actual, expr::lazy(c) * expr::lazy(d), numThreads);
+        checkClose(actual, product);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(InPlaceAndImageOperands) {
+    int const width = 20, height = 9;
+    MaskedImageT a = makeMaskedImage(width, height, 2.0);
+    MaskedImageT expected(a, true);
+    Image<float> const flat(*makeMaskedImage(width, height, 7.0).getImage(), true);
+
+    expected *= flat;
+    expected *= -2.0;
+    expected += 1.0;
+    expr::evaluate(a, -(expr::lazy(a) * expr::lazy(flat)) * 2.0 + 1.0);
+    checkClose(a, expected);
+
+    Image<float> image(flat.getDimensions());
+    expr::evaluate(image, 2.0 * expr::lazy(flat) - expr::lazy(*a.getImage()) / 4.0, 2);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            double const value = 2.0 * flat(x, y) - (*a.getImage())(x, y) / 4.0;
+            BOOST_CHECK_CLOSE(static_cast<double>(image(x, y)), value, 1e-3);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(DimensionMismatch) {
+    MaskedImageT const b = makeMaskedImage(10, 10, 1.0);
+    MaskedImageT dest(lsst::geom::Extent2I(10, 11));
+    BOOST_CHECK_THROW(expr::evaluate(dest, expr::lazy(b) + 1.0), pex::exceptions::LengthError);
+    BOOST_CHECK_THROW(expr::evaluate(dest, expr::lazy(dest) + 1.0, -1),
+                      pex::exceptions::InvalidParameterError);
+}
+
+}  // namespace image
+}  // namespace afw
+}  // namespace lsst
@@ -182,6 +182,45 @@ class ImagePcaTestCase(lsst.utils.tests.TestCase):
             inner /= norm1*norm2
             self.assertAlmostEqual(inner, 0, 6)
 
+    def testPcaThreadedAndIncremental(self):
+        """Test that threaded and incremental analysis match a serial one"""
+        width, height = 31, 17
+        rng = np.random.RandomState(12345)
+        images = []
+        for i in range(6):
+            im = afwImage.ImageF(lsst.geom.Extent2I(width, height))
+            im.array[:] = rng.normal(size=im.array.shape)
+            images.append(im)
+        fluxes = [1.0 + i for i in range(len(images))]
+
+        serial = afwImage.ImagePcaF()
+        for im, flux in zip(images, fluxes):
+            serial.addImage(im, flux)
+        serial.analyze()
+
+        threaded = afwImage.ImagePcaF()
+        threaded.setNumThreads(3)
+        self.assertEqual(threaded.getNumThreads(), 3)
+        incremental = afwImage.ImagePcaF()
+        incremental.setIncremental(True)
+        incremental.setNumThreads(0)
+        self.assertTrue(incremental.isIncremental())
+        for pca in (threaded, incremental):
+            for im, flux in zip(images[:4], fluxes[:4]):
+                pca.addImage(im, flux)
+            pca.analyze()
+            for im, flux in zip(images[4:], fluxes[4:]):
+                pca.addImage(im, flux)
+            pca.analyze()
+
+            self.assertFloatsAlmostEqual(np.array(pca.getEigenValues()), np.array(serial.getEigenValues()),
+                                         rtol=1e-10)
+            for eImage, expected in zip(pca.getEigenImages(), serial.getEigenImages()):
+                self.assertImagesAlmostEqual(eImage, expected, rtol=1e-5)
+
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            serial.setNumThreads(-1)
+
     def testPcaNaN(self):
         """Test calculating PCA when the images can contain NaNs"""
 
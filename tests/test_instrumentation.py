@@ -0,0 +1,179 @@
+# This file is part of afw.
+#
+# Developed for the LSST Data Management System.
+# This product includes software developed by the LSST Project
+# (https://www.lsst.org).
+# See the COPYRIGHT file at the top-level directory of this distribution
+# for details of code ownership.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+"""Tests for the hot-path instrumentation counters.
+"""
+
+import unittest
+
+import lsst.utils.tests
+import lsst.geom
+import lsst.afw.detection as afwDetection
+import lsst.afw.geom
+import lsst.afw.image as afwImage
+import lsst.afw.math as afwMath
+import lsst.afw.table as afwTable
+
+
+class InstrumentationTestCase(lsst.utils.tests.TestCase):
+
+    def setUp(self):
+        self.wasEnabled = afwMath.isInstrumentationEnabled()
+        afwMath.resetInstrumentation()
+        afwMath.setInstrumentationEnabled(True)
+        self.image = afwImage.ImageF(lsst.geom.Box2I(lsst.geom.Point2I(0, 0), lsst.geom.Extent2I(40, 30)))
+        self.image.array[:, :] = 1.0
+
+    def tearDown(self):
+        afwMath.setInstrumentationEnabled(self.wasEnabled)
+        afwMath.resetInstrumentation()
+
+    def getCount(self, name):
+        return afwMath.getInstrumentationSnapshot().get(name, {"count": 0})["count"]
+
+    def testSnapshot(self):
+        afwMath.makeStatistics(self.image, afwMath.MEAN)
+        snapshot = afwMath.getInstrumentationSnapshot()
+        self.assertEqual(snapshot["math.Statistics"]["count"], 1)
+        self.assertGreaterEqual(snapshot["math.Statistics"]["time"], 0.0)
+        afwMath.resetInstrumentation()
+        self.assertEqual(afwMath.getInstrumentationSnapshot()["math.Statistics"],
+                         {"count": 0, "time": 0.0})
+
+    def testDisabled(self):
+        afwMath.setInstrumentationEnabled(False)
+        self.assertFalse(afwMath.isInstrumentationEnabled())
+        afwMath.makeStatistics(self.image, afwMath.MEAN)
+        self.assertEqual(self.getCount("math.Statistics"), 0)
+
+    def testConvolveAndWarp(self):
+        kernel = afwMath.FixedKernel(afwImage.ImageD(lsst.geom.Extent2I(3, 3), 1.0/9))
+        convolved = self.image.Factory(self.image.getBBox())
+        afwMath.convolve(convolved, self.image, kernel, afwMath.ConvolutionControl())
+        self.assertEqual(self.getCount("math.convolve"), 1)
+
+        warped = self.image.Factory(self.image.getBBox())
+        transform = lsst.afw.geom.makeTransform(
+            lsst.geom.AffineTransform(lsst.geom.Extent2D(0.5, 0.25)))
+        afwMath.warpImage(warped, self.image, transform, afwMath.WarpingControl("bilinear"))
+        self.assertEqual(self.getCount("math.warpImage"), 1)
+
+    def testFits(self):
+        exposure = afwImage.ExposureF(self.image.getBBox())
+        exposure.setPsf(afwDetection.GaussianPsf(5, 5, 1.5))
+        catalog = afwTable.SourceCatalog(afwTable.SourceTable.makeMinimalSchema())
+        catalog.addNew()
+        with lsst.utils.tests.getTempFilePath(".fits") as filename:
+            exposure.writeFits(filename)
+            self.assertGreater(self.getCount("fits.writeImage"), 0)
+            afwImage.ExposureF(filename)
+            self.assertGreater(self.getCount("fits.readImage"), 0)
+            self.assertGreater(self.getCount("table.io.InputArchive.get"), 0)
+        with lsst.utils.tests.getTempFilePath(".fits") as filename:
+            catalog.writeFits(filename)
+            self.assertGreater(self.getCount("fits.writeTable"), 0)
+            afwTable.SourceCatalog.readFits(filename)
+            self.assertGreater(self.getCount("fits.readTable"), 0)
+
+    def testPsfCache(self):
+        psf = afwDetection.GaussianPsf(9, 9, 1.5)
+        position = lsst.geom.Point2D(10.0, 20.0)
+        psf.computeImage(position)
+        psf.computeImage(position)
+        self.assertEqual(self.getCount("detection.Psf.cacheMiss"), 1)
+        self.assertEqual(self.getCount("detection.Psf.cacheHit"), 1)
+
+
+    def getMemory(self, name):
+        return afwMath.getMemorySnapshot().get(name, {"current": 0, "peak": 0, "allocations": 0})
+
+    def testImageMemory(self):
+        before = self.getMemory("image.pixels")
+        image = afwImage.ImageF(lsst.geom.Extent2I(100, 50))
+        after = self.getMemory("image.pixels")
+        self.assertEqual(after["current"], before["current"] + 100*50*4)
+        self.assertGreaterEqual(after["peak"], after["current"])
+        self.assertEqual(after["allocations"], before["allocations"] + 1)
+        # Views and shallow copies share the pixels, and are not charged again
+        afwImage.ImageF(image, lsst.geom.Box2I(lsst.geom.Point2I(10, 10), lsst.geom.Extent2I(5, 5)))
+        self.assertEqual(self.getMemory("image.pixels")["current"], after["current"])
+        del image
+        self.assertEqual(self.getMemory("image.pixels")["current"], before["current"])
+
+        afwMath.resetMemoryPeaks()
+        record = self.getMemory("image.pixels")
+        self.assertEqual(record["peak"], record["current"])
+        self.assertEqual(record["allocations"], 0)
+
+    def testMemoryDisabled(self):
+        before = self.getMemory("image.pixels")["current"]
+        afwMath.setInstrumentationEnabled(False)
+        image = afwImage.ImageD(lsst.geom.Extent2I(30, 30))
+        afwMath.setInstrumentationEnabled(True)
+        self.assertEqual(self.getMemory("image.pixels")["current"], before)
+        # Memory allocated while disabled must not be released from the counter either
+        del image
+        self.assertEqual(self.getMemory("image.pixels")["current"], before)
+
+    def testTableAndSpanSetMemory(self):
+        before = self.getMemory("table.Block")["current"]
+        catalog = afwTable.SourceCatalog(afwTable.SourceTable.makeMinimalSchema())
+        catalog.addNew()
+        self.assertGreater(self.getMemory("table.Block")["current"], before)
+        del catalog
+        self.assertEqual(self.getMemory("table.Block")["current"], before)
+
+        before = self.getMemory("geom.SpanSet")["current"]
+        spans = lsst.afw.geom.SpanSet(lsst.geom.Box2I(lsst.geom.Point2I(0, 0), lsst.geom.Extent2I(10, 20)))
+        self.assertGreater(self.getMemory("geom.SpanSet")["current"], before)
+        del spans
+        self.assertEqual(self.getMemory("geom.SpanSet")["current"], before)
+
+    def testPsfCacheMemory(self):
+        before = self.getMemory("detection.Psf.cache")["current"]
+        psf = afwDetection.GaussianPsf(9, 9, 1.5)
+        image = psf.computeImage(lsst.geom.Point2D(10.0, 20.0))
+        self.assertGreaterEqual(self.getMemory("detection.Psf.cache")["current"], before + 9*9*8)
+        del psf, image
+        self.assertEqual(self.getMemory("detection.Psf.cache")["current"], before)
+
+    def testArchiveMemory(self):
+        exposure = afwImage.ExposureF(self.image.getBBox())
+        exposure.setPsf(afwDetection.GaussianPsf(5, 5, 1.5))
+        with lsst.utils.tests.getTempFilePath(".fits") as filename:
+            exposure.writeFits(filename)
+            self.assertGreater(self.getMemory("table.io.archive")["peak"], 0)
+            afwMath.resetMemoryPeaks()
+            afwImage.ExposureF(filename)
+            self.assertGreater(self.getMemory("table.io.archive")["allocations"], 0)
+
+
+class TestMemory(lsst.utils.tests.MemoryTestCase):
+    pass
+
+
+def setup_module(module):
+    lsst.utils.tests.init()
+
+
+if __name__ == "__main__":
+    lsst.utils.tests.init()
+    unittest.main()
@@ -126,6 +126,26 @@ class InterpolateTestCase(lsst.utils.tests.TestCase):
         for x in np.arange(xvec_c[i], xvec_c[i + 1], 10):
             self.assertEqual(interp.interpolate(x), yvec_c[i])
 
+    def testArrayInterpolate(self):
+        """Test that interpolating many points at once agrees with one at a time"""
+        rng = np.random.RandomState(12345)
+        xvec = np.cumsum(rng.uniform(0.5, 2.0, size=12))
+        yvec = np.sin(xvec) + 0.1*xvec**2
+        xSorted = np.linspace(xvec[0] - 2.0, xvec[-1] + 2.0, 101)
+        xUnsorted = rng.permutation(np.concatenate([xSorted, xvec]))
+        for style in (afwMath.Interpolate.LINEAR, afwMath.Interpolate.NATURAL_SPLINE,
+                      afwMath.Interpolate.CUBIC_SPLINE, afwMath.Interpolate.AKIMA_SPLINE,
+                      afwMath.Interpolate.CONSTANT):
+            interp = afwMath.makeInterpolate(xvec, yvec, style)
+            for xInterp in (xSorted, xUnsorted, xvec, xSorted[::-3]):
+                expected = np.array([interp.interpolate(x) for x in xInterp])
+                self.assertFloatsAlmostEqual(np.array(interp.interpolate(xInterp)), expected,
+                                             rtol=1e-10, atol=1e-12, msg=str(style))
+
+            result = interp.interpolate(np.array([np.nan, xvec[3]]))
+            self.assertTrue(np.isnan(result[0]))
+            self.assertAlmostEqual(result[1], yvec[3])
+
     def testInvalidInputs(self):
         """Test that invalid inputs cause an abort"""
 
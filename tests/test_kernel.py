@@ -590,6 +590,119 @@ class KernelTestCase(lsst.utils.tests.TestCase):
 
         assert_allclose(kim.getArray(), kim2.getArray())
 
+    def testImageCache(self):
+        """Test the image cache of a spatially varying AnalyticKernel"""
+        spFunc = afwMath.PolynomialFunction2D(1)
+        sParams = (
+            (1.0, 0.01, 0.0),
+            (1.0, 0.0, 0.01),
+            (0.0, 0.001, 0.001),
+        )
+        gaussFunc = afwMath.GaussianFunction2D(1.0, 1.0, 0.0)
+        kernel = afwMath.AnalyticKernel(5, 8, gaussFunc, spFunc)
+        kernel.setSpatialParameters(sParams)
+        refKernel = kernel.clone()
+
+        self.assertEqual(kernel.getImageCacheMaxSize(), 0)
+        kernel.setImageCache(2, 0.5)
+        self.assertEqual(kernel.getImageCacheMaxSize(), 2)
+        self.assertEqual(kernel.getImageCachePositionQuantum(), 0.5)
+
+        kim = afwImage.ImageD(kernel.getDimensions())
+        refKim = afwImage.ImageD(kernel.getDimensions())
+        # (position, snapped position, expected hit)
+        for xy, snappedXy, isHit in (((10.1, 20.2), (10.0, 20.0), False),
+                                     ((10.2, 19.9), (10.0, 20.0), True),
+                                     ((30.0, 40.0), (30.0, 40.0), False),
+                                     ((50.0, 60.0), (50.0, 60.0), False),  # evicts (10, 20)
+                                     ((30.1, 40.1), (30.0, 40.0), True),
+                                     ((10.0, 20.0), (10.0, 20.0), False)):
+            nHits = kernel.getImageCacheHits()
+            kSum = kernel.computeImage(kim, False, *xy)
+            refKSum = refKernel.computeImage(refKim, False, *snappedXy)
+            self.assertEqual(kernel.getImageCacheHits(), nHits + (1 if isHit else 0))
+            self.assertEqual(kSum, refKSum)
+            self.assertImagesEqual(kim, refKim)
+            self.assertEqual(kim.getXY0(), refKim.getXY0())
+        self.assertEqual(kernel.getImageCacheHits(), 2)
+        self.assertEqual(kernel.getImageCacheMisses(), 4)
+        self.assertEqual(kernel.getImageCacheSize(), 2)
+
+        # doNormalize and the kernel parameters are part of the key
+        kernel.computeImage(kim, True, 10.0, 20.0)
+        self.assertEqual(kernel.getImageCacheMisses(), 5)
+        kernel.setSpatialParameters(((1.0, 0.02, 0.0), (1.0, 0.0, 0.02), (0.0, 0.0, 0.0)))
+        kernel.computeImage(kim, True, 10.0, 20.0)
+        self.assertEqual(kernel.getImageCacheMisses(), 6)
+
+        kernelClone = kernel.clone()
+        self.assertEqual(kernelClone.getImageCacheMaxSize(), 2)
+        self.assertEqual(kernelClone.getImageCacheSize(), 0)
+
+        kernel.clearImageCache()
+        self.assertEqual(kernel.getImageCacheSize(), 0)
+        self.assertEqual(kernel.getImageCacheHits(), 0)
+        self.assertEqual(kernel.getImageCacheMisses(), 0)
+
+        kernel.setImageCache(0)
+        self.assertEqual(kernel.getImageCacheMaxSize(), 0)
+        kernel.computeImage(kim, False, 10.1, 20.2)
+        refKernel.setSpatialParameters(kernel.getSpatialParameters())
+        refKernel.computeImage(refKim, False, 10.1, 20.2)
+        self.assertImagesEqual(kim, refKim)
+        self.assertEqual(kernel.getImageCacheMisses(), 0)
+
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            kernel.setImageCache(-1)
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            kernel.setImageCache(10, -1.0)
+
+    def testKernelParametersOnGrid(self):
+        """Test computing the parameters of a spatially varying kernel over a grid"""
+        spFunc = afwMath.PolynomialFunction2D(1)
+        sParams = (
+            (1.0, 0.01, 0.0),
+            (1.0, 0.0, 0.01),
+            (0.0, 0.001, 0.001),
+        )
+        gaussFunc = afwMath.GaussianFunction2D(1.0, 1.0, 0.0)
+        kernel = afwMath.AnalyticKernel(5, 7, gaussFunc, spFunc)
+        kernel.setSpatialParameters(sParams)
+
+        xs = np.array([0.0, 12.5, 40.0, 99.0])
+        ys = np.array([-3.0, 20.0, 61.0])
+        params = kernel.computeKernelParametersOnGrid(xs, ys)
+        self.assertEqual(params.shape, (3, len(ys), len(xs)))
+        kim = afwImage.ImageD(kernel.getDimensions())
+        refKim = afwImage.ImageD(kernel.getDimensions())
+        for j, y in enumerate(ys):
+            for i, x in enumerate(xs):
+                kernel.computeImage(refKim, True, x, y)
+                assert_allclose(params[:, j, i], kernel.getKernelParameters(), rtol=1e-14)
+                kernel.computeImageFromKernelParameters(kim, True, list(params[:, j, i]))
+                self.assertImagesAlmostEqual(kim, refKim, rtol=1e-14)
+                self.assertEqual(kim.getXY0(), refKim.getXY0())
+
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            kernel.computeImageFromKernelParameters(kim, True, [1.0, 1.0])
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            kernel.computeImageFromKernelParameters(afwImage.ImageD(3, 3), True, [1.0, 1.0, 0.0])
+
+        # the interpolated convolution uses the grid unless the image cache is enabled
+        inImage = afwImage.ImageF(lsst.geom.Extent2I(110, 90))
+        inImage.array[:, :] = np.random.RandomState(3).rand(90, 110)
+        control = afwMath.ConvolutionControl(True, False, 20)
+        gridImage = afwImage.ImageF(inImage.getDimensions())
+        afwMath.convolve(gridImage, inImage, kernel, control)
+        kernel.setImageCache(1000, 0.0)
+        pointImage = afwImage.ImageF(inImage.getDimensions())
+        afwMath.convolve(pointImage, inImage, kernel, control)
+        self.assertImagesAlmostEqual(gridImage, pointImage, rtol=1e-6)
+
+        fixedKernel = afwMath.FixedKernel(refKim)
+        params = fixedKernel.computeKernelParametersOnGrid(xs, ys)
+        self.assertEqual(params.shape, (0, len(ys), len(xs)))
+
     def testSVLinearCombinationKernelFixed(self):
         """Test a spatially varying LinearCombinationKernel whose bases are FixedKernels"""
         kWidth = 3
@@ -37,7 +37,7 @@ import numpy as np
 
 import lsst.utils.tests
 import lsst.pex.exceptions
-from lsst.afw.math import LeastSquares
+from lsst.afw.math import LeastSquares, LeastSquaresBatch
 from lsst.log import Log
 
 Log.getLogger("lsst.afw.math.LeastSquares").setLevel(Log.DEBUG)
@@ -177,6 +177,38 @@ class LeastSquaresTestCase(lsst.utils.tests.TestCase):
         self._assertClose(s_svd.getSolution(), s_design_eigen.getSolution())
         self._assertClose(s_svd.getSolution(), s_normal_eigen.getSolution())
 
+    def testBatch(self):
+        """Test that batched solves match LeastSquares on each system."""
+        nData = 30
+        for dimension in (1, 3, 6, 12):  # fixed-size and dynamic-size code paths
+            designs = np.random.randn(50, nData, dimension)
+            designs[5, :, 0] = designs[5, :, -1]  # a rank-deficient system, if dimension > 1
+            data = np.random.randn(50, nData)
+            fisher = np.ascontiguousarray(np.einsum("kji,kjl->kil", designs, designs))
+            rhs = np.ascontiguousarray(np.einsum("kji,kj->ki", designs, data))
+            for factorization in (LeastSquares.NORMAL_EIGENSYSTEM, LeastSquares.NORMAL_CHOLESKY):
+                threshold = 1E-10
+                batch = LeastSquaresBatch.fromNormalEquations(fisher, rhs, factorization, threshold,
+                                                              numThreads=0)
+                self.assertEqual(batch.getSize(), 50)
+                self.assertEqual(batch.getDimension(), dimension)
+                self.assertEqual(batch.getFactorization(), factorization)
+                for k in range(50):
+                    expectedRank = dimension - 1 if k == 5 and dimension > 1 else dimension
+                    self.assertEqual(batch.getRank()[k], expectedRank)
+                    single = LeastSquares.fromNormalEquations(fisher[k], rhs[k], factorization)
+                    self._assertClose(batch.getDiagnostic()[k], single.getDiagnostic(factorization))
+                    if expectedRank == dimension:
+                        self._assertClose(batch.getSolution()[k], single.getSolution())
+                    elif factorization == LeastSquares.NORMAL_EIGENSYSTEM:
+                        self._assertClose(batch.getSolution()[k], np.linalg.lstsq(designs[k], data[k])[0])
+
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            LeastSquaresBatch.fromNormalEquations(np.zeros((3, 2, 2)), np.zeros((3, 3)))
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            LeastSquaresBatch.fromNormalEquations(np.zeros((3, 2, 2)), np.zeros((3, 2)),
+                                                  LeastSquares.DIRECT_SVD)
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
@@ -348,6 +348,57 @@ class MaskTestCase(utilsTests.TestCase):
 
         self.assertIn("MaskX=", repr(mask))
 
+    def testMaskSummary(self):
+        """Test that a MaskSummary agrees with direct queries of the pixels"""
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(-7, 12), lsst.geom.Extent2I(150, 97))
+        mask = afwImage.Mask(bbox)
+        bad = mask.getPlaneBitMask("BAD")
+        sat = mask.getPlaneBitMask("SAT")
+        rng = np.random.RandomState(11)
+        array = mask.array
+        array[rng.randint(0, 97, 30), rng.randint(0, 150, 30)] |= bad
+        array[40:45, 100:120] |= sat
+
+        for numThreads in (1, 3, 0):
+            summary = afwImage.MaskSummary(mask, tileSize=32, numThreads=numThreads)
+            self.assertEqual(summary.getBBox(), bbox)
+            self.assertEqual(summary.getUnion(), bad | sat)
+            for name in ("BAD", "SAT", "EDGE"):
+                bitmask = mask.getPlaneBitMask(name)
+                ys, xs = np.nonzero(array & bitmask)
+                self.assertEqual(summary.getPlaneCount(name), len(xs))
+                self.assertEqual(summary.getPlaneCount(mask.getMaskPlane(name)), len(xs))
+                if len(xs) == 0:
+                    self.assertTrue(summary.getPlaneBBox(name).isEmpty())
+                else:
+                    expected = lsst.geom.Box2I(lsst.geom.Point2I(int(xs.min()), int(ys.min())),
+                                               lsst.geom.Point2I(int(xs.max()), int(ys.max())))
+                    expected.shift(lsst.geom.Extent2I(bbox.getMin()))
+                    self.assertEqual(summary.getPlaneBBox(name), expected)
+            self.assertEqual(summary.getTileDimensions(), lsst.geom.Extent2I(5, 4))
+            tiles = summary.getTileBBoxes(sat)
+            self.assertEqual(tiles, [summary.getTileBBox(3, 1)])
+            self.assertEqual(tiles[0], lsst.geom.Box2I(lsst.geom.Point2I(89, 44), lsst.geom.Extent2I(32, 32)))
+            self.assertEqual(summary.getTileBBox(4, 3),
+                             lsst.geom.Box2I(lsst.geom.Point2I(121, 108), lsst.geom.Point2I(142, 108)))
+            for tileBBox in (summary.getTileBBox(ix, iy) for ix in range(5) for iy in range(4)):
+                self.assertEqual(summary.mayIntersect(tileBBox, bad | sat),
+                                 bool(np.any(mask[tileBBox].array & (bad | sat))))
+            self.assertFalse(summary.mayIntersect(bbox, mask.getPlaneBitMask("EDGE")))
+            self.assertTrue(summary.mayIntersect(bbox, sat))
+
+        untiled = afwImage.MaskSummary(mask)
+        self.assertEqual(untiled.getTileSize(), 0)
+        self.assertEqual(untiled.getPlaneCount("SAT"), 100)
+        with self.assertRaises(pexExcept.LogicError):
+            untiled.getTileBBoxes(sat)
+        with self.assertRaises(pexExcept.NotFoundError):
+            untiled.getPlaneCount("NOT_A_PLANE")
+        with self.assertRaises(pexExcept.OutOfRangeError):
+            untiled.getPlaneBBox(32)
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            afwImage.MaskSummary(mask, tileSize=-1)
+
 
 class OldMaskTestCase(unittest.TestCase):
     """A test case for Mask (based on Mask_1.cc); these are taken over from the DC2 fw tests
@@ -622,6 +673,28 @@ class OldMaskTestCase(unittest.TestCase):
 
         self.testMask |= testMask3
 
+    def testConformMaskPlanesThreaded(self):
+        """Test conformMaskPlanes() permuting, adding and dropping planes on several threads"""
+        fileDict = {"CR": 1, "BP": 0, "FILE_A": 5, "FILE_B": 9}
+        undefinedBit = 12  # set in the pixels but in no plane, so dropped
+        rng = np.random.RandomState(42)
+        bits = rng.randint(0, 2, size=(len(fileDict) + 1, 61, 37))
+        array = np.zeros((61, 37), dtype=np.int32)
+        for plane, bit in enumerate(list(fileDict.values()) + [undefinedBit]):
+            array |= bits[plane] << bit
+
+        for numThreads in (1, 3, 0):
+            mask = self.Mask(array.copy(), deep=True)
+            mask.conformMaskPlanes(fileDict, numThreads=numThreads)
+            expected = np.zeros_like(array)
+            for plane, name in enumerate(fileDict):
+                expected |= bits[plane]*mask.getPlaneBitMask(name)
+            self.assertEqual(mask.getMaskPlaneDict(), self.Mask().getMaskPlaneDict())
+            np.testing.assert_array_equal(mask.array, expected)
+
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            self.Mask(array, deep=True).conformMaskPlanes(fileDict, numThreads=-1)
+
 
 def printMaskPlane(mask, plane,
                    xrange=list(range(250, 300, 10)), yrange=list(range(300, 400, 20))):
@@ -84,6 +84,29 @@ class MatchFitsTestCase(unittest.TestCase):
         unpacked = afwTable.unpackMatches(matches, cat1, cat2)
         self.testMatches(unpacked)
 
+    def testUnpackUnsorted(self):
+        """Test that unpacking matches does not need sorted catalogs, and
+        gives the same matches on several threads.
+        """
+        packed = afwTable.packMatches(self.matches)
+        cat1 = self.cat1.copy()
+        cat2 = self.cat2.copy()
+        cat1.sort()
+        cat2.sort()
+        expected = afwTable.unpackMatches(packed, cat1, cat2)
+        # Reverse the order of the catalogs
+        cat1 = afwTable.SimpleCatalog(cat1.table)
+        cat2 = afwTable.SimpleCatalog(cat2.table)
+        for m in reversed(expected):
+            cat1.append(m.first)
+            cat2.append(m.second)
+        self.assertFalse(cat1.isSorted())
+        for numThreads in (1, 0):
+            unpacked = afwTable.unpackMatches(packed, cat1, cat2, numThreads=numThreads)
+            self.testMatches(unpacked)
+            self.assertEqual([(m.first.getId(), m.second.getId(), m.distance) for m in unpacked],
+                             [(m.first.getId(), m.second.getId(), m.distance) for m in expected])
+
     def testTicket2080(self):
         packed = afwTable.packMatches(self.matches)
         cat1 = self.cat1.copy()
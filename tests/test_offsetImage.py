@@ -34,6 +34,7 @@ import numpy as np
 
 import lsst.utils.tests
 import lsst.geom
+import lsst.pex.exceptions
 import lsst.afw.image as afwImage
 import lsst.afw.math as afwMath
 import lsst.afw.display as afwDisplay
@@ -96,6 +97,30 @@ class OffsetImageTestCase(unittest.TestCase):
                         disp.pan(50, 50)
                         disp.dot("+", 50 + dx + delta - outImage.getX0(), 50 + dy + delta - outImage.getY0())
 
+    def testRepeatedAndThreaded(self):
+        """Test that reusing the warping kernels between calls, and threading, do not change the results.
+        """
+        rng = np.random.RandomState(2468)
+        image = afwImage.MaskedImageF(150, 120)
+        image.image.array[:, :] = rng.randn(*image.image.array.shape)
+        image.variance.array[:, :] = rng.uniform(1, 2, size=image.variance.array.shape)
+        image.mask.array[60, 70] = 1
+        offsets = [(0.3, -0.2), (-0.4, -0.45), (1.7, -2.6), (0.3, -0.2)]
+        for algorithm in ("lanczos3", "bilinear", "lanczos5"):
+            # Some of these offsets move the kernel centre, which must be restored for the next call
+            first = afwMath.offsetImage(image, *offsets[0], algorithm)
+            results = [afwMath.offsetImage(image, dx, dy, algorithm, numThreads=numThreads)
+                       for (dx, dy), numThreads in zip(offsets, (1, 2, 0, 3))]
+            self.assertEqual(results[-1].getXY0(), first.getXY0())
+            for plane in ("image", "mask", "variance"):
+                np.testing.assert_array_equal(getattr(results[-1], plane).array,
+                                              getattr(first, plane).array)
+            self.assertEqual(results[2].getXY0(), lsst.geom.Point2I(2, -3))
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            afwMath.offsetImage(image, 0.5, 0.5, numThreads=-1)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            afwMath.offsetImage(image, 0.5, 0.5, "noSuchKernel")
+
     def calcGaussian(self, im, x, y, amp, sigma1):
         """Insert a Gaussian into the image centered at (x, y).
         """
@@ -236,6 +261,34 @@ class TransformImageTestCase(unittest.TestCase):
         # for a while, swig couldn't handle the resulting std::shared_ptr<Mask>
         afwMath.flipImage(mask, True, False)
 
+    def testMatchesNumpy(self):
+        """Test that large multi-plane images are rotated and flipped correctly with any number of threads.
+        """
+        rng = np.random.RandomState(12345)
+        image = afwImage.MaskedImageF(lsst.geom.BoxI(lsst.geom.PointI(5, -3), lsst.geom.ExtentI(333, 170)))
+        image.image.array[:, :] = rng.randn(*image.image.array.shape)
+        image.mask.array[:, :] = rng.randint(0, 256, size=image.mask.array.shape)
+        image.variance.array[:, :] = rng.uniform(1, 2, size=image.variance.array.shape)
+        for numThreads in (1, 3, 0):
+            for nQuarter in range(-1, 5):
+                outImage = afwMath.rotateImageBy90(image, nQuarter, numThreads=numThreads)
+                for plane in ("image", "mask", "variance"):
+                    np.testing.assert_array_equal(getattr(outImage, plane).array,
+                                                  np.rot90(getattr(image, plane).array, -nQuarter))
+            for flipLR in (False, True):
+                for flipTB in (False, True):
+                    outImage = afwMath.flipImage(image, flipLR, flipTB, numThreads=numThreads)
+                    self.assertEqual(outImage.getBBox(), image.getBBox())
+                    for plane in ("image", "mask", "variance"):
+                        expected = getattr(image, plane).array
+                        if flipLR:
+                            expected = expected[:, ::-1]
+                        if flipTB:
+                            expected = expected[::-1, :]
+                        np.testing.assert_array_equal(getattr(outImage, plane).array, expected)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            afwMath.flipImage(image, True, False, numThreads=-1)
+
 
 class BinImageTestCase(unittest.TestCase):
     """A test case for binning images.
@@ -291,6 +344,39 @@ class BinImageTestCase(unittest.TestCase):
             afwDisplay.Display(frame=2).mtv(inImage, title="unbinned")
             afwDisplay.Display(frame=3).mtv(outImage, title=f"binned {binX}x{binY}")
 
+    def testBinMatchesNumpy(self):
+        """Test that binning a MaskedImage gives the mean of each bin, the OR of its masks,
+        and the variance of the mean, with any number of threads.
+        """
+        rng = np.random.RandomState(54321)
+        inImage = afwImage.MaskedImageF(203, 131)
+        inImage.image.array[:, :] = rng.uniform(0, 100, size=inImage.image.array.shape)
+        inImage.mask.array[:, :] = 1 << rng.randint(0, 8, size=inImage.mask.array.shape)
+        inImage.variance.array[:, :] = rng.uniform(1, 2, size=inImage.variance.array.shape)
+        binX, binY = 3, 4
+        height, width = inImage.getHeight()//binY, inImage.getWidth()//binX
+
+        def reshape(array):
+            return array[:height*binY, :width*binX].reshape(height, binY, width, binX)
+
+        for numThreads in (1, 4, 0):
+            outImage = afwMath.binImage(inImage, binX, binY, numThreads=numThreads)
+            np.testing.assert_allclose(outImage.image.array,
+                                       reshape(inImage.image.array).mean(axis=(1, 3)), rtol=1e-5)
+            np.testing.assert_array_equal(outImage.mask.array,
+                                          np.bitwise_or.reduce(reshape(inImage.mask.array), axis=(1, 3)))
+            np.testing.assert_allclose(outImage.variance.array,
+                                       reshape(inImage.variance.array).sum(axis=(1, 3))/(binX*binY)**2,
+                                       rtol=1e-5)
+
+    def testBinUnsigned(self):
+        """Test that sums of unsigned pixels do not overflow.
+        """
+        inImage = afwImage.ImageU(8, 8)
+        inImage.set(60000)
+        outImage = afwMath.binImage(inImage, 4, numThreads=2)
+        np.testing.assert_array_equal(outImage.array, 60000)
+
 
 class TestMemory(lsst.utils.tests.MemoryTestCase):
     pass
@@ -20,6 +20,7 @@
 # see <http://www.lsstcorp.org/LegalNotices/>.
 #
 
+import itertools
 import os.path
 import unittest
 
@@ -358,6 +359,16 @@ class PhotoCalibTestCase(lsst.utils.tests.TestCase):
         self.assertFloatsAlmostEqual(result[self.noErrInstFluxKeyName+'_mag'], expectMag[:, 0])
         self.assertFloatsAlmostEqual(result[self.noErrInstFluxKeyName+'_instFlux'], origInstFlux)
 
+        # a catalog whose records are not contiguous in memory gives the same results
+        nonContiguous = catalog.copy(deep=True)
+        nonContiguous.extend(catalog.copy(deep=True), deep=False)
+        self.assertFalse(nonContiguous.isContiguous())
+        result = photoCalib.instFluxToNanojansky(nonContiguous, self.instFluxKeyName)
+        self.assertFloatsAlmostEqual(np.concatenate([expectNanojansky, expectNanojansky]), result)
+        photoCalib.instFluxToMagnitude(nonContiguous, self.instFluxKeyName, self.instFluxKeyName)
+        self.assertFloatsAlmostEqual(nonContiguous[self.instFluxKeyName + '_mag'],
+                                     np.concatenate([expectMag[:, 0], expectMag[:, 0]]))
+
     def testNonVarying(self):
         """Test constructing with a constant calibration factor."""
         photoCalib = lsst.afw.image.PhotoCalib(self.calibration)
@@ -655,6 +666,43 @@ class PhotoCalibTestCase(lsst.utils.tests.TestCase):
         uncalibrated = photoCalib.uncalibrateImage(result, includeScaleUncertainty=False)
         self.assertMaskedImagesAlmostEqual(subImage, uncalibrated)
 
+    def testCalibrateImageInPlace(self):
+        """Test that calibrating in place agrees with calibrateImage, for
+        images spanning several bands of rows and extending beyond the
+        calibration's bounding box.
+        """
+        rng = np.random.RandomState(12)
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(-40, 30), lsst.geom.Extent2I(150, 140))
+        maskedImage = lsst.afw.image.MaskedImageF(bbox)
+        maskedImage.image.array[:, :] = rng.uniform(100, 1000, size=maskedImage.image.array.shape)
+        maskedImage.variance.array[:, :] = rng.uniform(10, 40, size=maskedImage.variance.array.shape)
+        maskedImage.mask.array[:, :] = rng.randint(0, 4, size=maskedImage.mask.array.shape)
+        coefficients = np.array([[self.calibration, 0.01*self.calibration],
+                                 [0.02*self.calibration, 0.0]])
+        calibBox = lsst.geom.Box2I(lsst.geom.Point2I(-50, 20), lsst.geom.Extent2I(120, 200))
+        photoCalibs = [lsst.afw.image.PhotoCalib(self.calibration, self.calibrationErr),
+                       lsst.afw.image.PhotoCalib(lsst.afw.math.ChebyshevBoundedField(calibBox, coefficients),
+                                                 self.calibrationErr)]
+        for photoCalib, includeScaleUncertainty, numThreads in itertools.product(photoCalibs, (True, False),
+                                                                                (1, 3)):
+            with self.subTest(photoCalib=photoCalib, includeScaleUncertainty=includeScaleUncertainty,
+                              numThreads=numThreads):
+                expect = photoCalib.calibrateImage(maskedImage, includeScaleUncertainty)
+                result = maskedImage.clone()
+                photoCalib.calibrateImageInPlace(result, includeScaleUncertainty, numThreads=numThreads)
+                self.assertMaskedImagesAlmostEqual(result, expect, rtol=1E-6)
+                photoCalib.uncalibrateImageInPlace(result, includeScaleUncertainty, numThreads=numThreads)
+                self.assertMaskedImagesAlmostEqual(result, maskedImage, rtol=1E-5)
+
+                # Interpolating the calibration (which is smooth) changes little.
+                result = maskedImage.clone()
+                photoCalib.calibrateImageInPlace(result, includeScaleUncertainty, tolerance=1E-8,
+                                                 numThreads=numThreads)
+                self.assertMaskedImagesAlmostEqual(result, expect, rtol=1E-6)
+
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            photoCalibs[1].calibrateImageInPlace(maskedImage, tolerance=-1.0)
+
     def testNonPositiveMeans(self):
         # no negative calibrations
         with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
@@ -26,6 +26,8 @@ import numpy as np
 import lsst.utils.tests
 import lsst.geom
 import lsst.afw.geom
+import lsst.afw.image
+import lsst.pex.exceptions
 from lsst.afw.math import PixelAreaBoundedField
 
 
@@ -112,6 +114,51 @@ class PixelAreaBoundedFieldTestCase(lsst.utils.tests.TestCase):
         other = PixelAreaBoundedField(self.bbox, newWcs)
         self.assertNotEqual(self.boundedField, other)
 
+    def testFillImageInterpolated(self):
+        """Test that interpolating the field from a grid agrees with
+        evaluating it at every pixel to within the requested tolerance.
+        """
+        # A wide field, so the pixel area varies appreciably.
+        cdMatrix = lsst.afw.geom.makeCdMatrix(0.05*lsst.geom.degrees, 20*lsst.geom.degrees)
+        skyWcs = lsst.afw.geom.makeSkyWcs(crpix=lsst.geom.Point2D(120, 40),
+                                          crval=lsst.geom.SpherePoint(0, 45, lsst.geom.degrees),
+                                          cdMatrix=cdMatrix)
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(-5, 7), lsst.geom.Extent2I(400, 300))
+        boundedField = PixelAreaBoundedField(bbox, skyWcs, unit=lsst.geom.arcseconds)
+        exact = lsst.afw.image.ImageD(bbox)
+        boundedField.fillImage(exact)
+        maxValue = np.abs(exact.array).max()
+        for tolerance in (1E-4, 1E-7):
+            with self.subTest(tolerance=tolerance):
+                image = lsst.afw.image.ImageD(bbox)
+                boundedField.fillImageInterpolated(image, tolerance)
+                self.assertLess(np.abs(image.array - exact.array).max(), tolerance*maxValue)
+                image.set(2.0)
+                boundedField.multiplyImageInterpolated(image, tolerance)
+                self.assertFloatsAlmostEqual(image.array, 2.0*exact.array, atol=2*tolerance*maxValue)
+                boundedField.divideImageInterpolated(image, tolerance)
+                self.assertFloatsAlmostEqual(image.array, 2.0, rtol=4*tolerance, atol=0)
+
+        # A tolerance of zero evaluates the field at every pixel.
+        image = lsst.afw.image.ImageD(bbox)
+        boundedField.fillImageInterpolated(image, 0.0)
+        self.assertImagesEqual(image, exact)
+
+        # Only the overlap is filled if requested.
+        subBox = lsst.geom.Box2I(lsst.geom.Point2I(300, 200), lsst.geom.Extent2I(200, 200))
+        image = lsst.afw.image.ImageD(subBox)
+        image.set(-1.0)
+        boundedField.fillImageInterpolated(image, 1E-7, overlapOnly=True)
+        overlap = lsst.geom.Box2I(subBox)
+        overlap.clip(bbox)
+        self.assertFloatsAlmostEqual(image[overlap].array, exact[overlap].array, atol=1E-7*maxValue)
+        self.assertEqual(image[subBox.getMaxX(), subBox.getMaxY()], -1.0)
+
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            boundedField.fillImageInterpolated(image, -1.0)
+        with self.assertRaises(lsst.pex.exceptions.RuntimeError):
+            boundedField.fillImageInterpolated(image, 1E-7)
+
     def testPersistence(self):
         """Test that we can round-trip a PixelAreaBoundedField through
         persistence.
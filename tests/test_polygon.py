@@ -26,6 +26,7 @@ import numpy as np
 
 import lsst.utils.tests
 import lsst.geom
+import lsst.pex.exceptions
 import lsst.afw.geom as afwGeom
 import lsst.afw.image  # noqa: F401 required by Polygon.createImage
 
@@ -168,6 +169,23 @@ class PolygonTest(lsst.utils.tests.TestCase):
         box = lsst.geom.Box2D(lsst.geom.Point2D(-100, -100), lsst.geom.Point2D(100, 100))
         self.assertFalse(all(poly.contains(box.getCorners())))
 
+    def testContainsArray(self):
+        """Test Polygon.contains for arrays of x and y"""
+        poly = self.polygon(7, radius=10, x0=1.5, y0=-2.0)
+        rng = np.random.RandomState(1)
+        x = rng.uniform(-12, 14, 1000)
+        y = rng.uniform(-14, 12, 1000)
+        # include the vertices, which are on the boundary and so not contained
+        vertices = poly.getVertices()
+        x = np.concatenate([x, [p.getX() for p in vertices]])
+        y = np.concatenate([y, [p.getY() for p in vertices]])
+        expected = [poly.contains(lsst.geom.Point2D(xx, yy)) for xx, yy in zip(x, y)]
+        self.assertEqual(list(poly.contains(x, y)), expected)
+        self.assertEqual(poly.contains([lsst.geom.Point2D(xx, yy) for xx, yy in zip(x, y)]), expected)
+        self.assertFalse(any(expected[-len(vertices):]))
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            poly.contains(x, y[:-1])
+
     def testOverlaps(self):
         """Test Polygon.overlaps"""
         radius = 1.0
@@ -272,6 +290,52 @@ class PolygonTest(lsst.utils.tests.TestCase):
                                     (+3.0, +3.0), (+3.0, -1.0), (+1.0, -3.0))])
         self.assertEqual(poly.convexHull(), expected)
 
+    def testIntersectPairs(self):
+        """Test intersectPairs against intersecting every pair directly"""
+        rng = np.random.RandomState(2)
+        polygons = [self.polygon(int(num), radius, x0, y0) for num, radius, x0, y0 in
+                    zip(rng.randint(3, 12, 40), rng.uniform(1, 5, 40),
+                        rng.uniform(0, 50, 40), rng.uniform(0, 50, 40))]
+        expected = []
+        for i in range(len(polygons)):
+            for j in range(i + 1, len(polygons)):
+                overlap = polygons[i].intersection(polygons[j])
+                if overlap:
+                    expected.append((i, j, sum(p.calculateArea() for p in overlap)))
+        self.assertGreater(len(expected), 0)
+        for numThreads in (1, 3):
+            result = afwGeom.intersectPairs(polygons, numThreads=numThreads)
+            self.assertEqual([(r.first, r.second) for r in result], [(i, j) for i, j, _ in expected])
+            for r, (_, _, area) in zip(result, expected):
+                self.assertFloatsAlmostEqual(sum(p.calculateArea() for p in r.intersection), area)
+        self.assertEqual(afwGeom.intersectPairs([]), [])
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            afwGeom.intersectPairs(polygons, numThreads=-1)
+
+    def testPolygonUnion(self):
+        """Test PolygonUnion against a union built one polygon at a time"""
+        squares = [self.square(1.0, x0, y0) for x0, y0 in
+                   ((0, 0), (1, 0.5), (1.5, 1.5), (10, 10), (11, 10), (-5, 3), (0.5, -0.5))]
+        accumulator = afwGeom.PolygonUnion()
+        self.assertEqual(accumulator.getPolygons(), [])
+        self.assertEqual(accumulator.calculateArea(), 0.0)
+        expected = [squares[0]]
+        for square in squares:
+            accumulator.add(square)
+        for square in squares[1:]:
+            merged = []
+            for poly in expected:
+                if poly.overlaps(square):
+                    square = square.unionSingle(poly)
+                else:
+                    merged.append(poly)
+            expected = merged + [square]
+        self.assertEqual(accumulator.getNumAdded(), len(squares))
+        self.assertEqual(len(accumulator.getPolygons()), len(expected))
+        self.assertFloatsAlmostEqual(accumulator.calculateArea(), sum(p.calculateArea() for p in expected))
+        self.assertFloatsAlmostEqual(sum(p.calculateArea() for p in accumulator.getPolygons()),
+                                     accumulator.calculateArea())
+
     def testImage(self):
         """Test Polygon.createImage"""
         if display:
@@ -298,6 +362,20 @@ class PolygonTest(lsst.utils.tests.TestCase):
                 self.assertFloatsAlmostEqual(
                     image.getArray().sum(), poly.calculateArea(), rtol=0.025)
 
+    def testImagePixelOverlap(self):
+        """Test that each pixel of Polygon.createImage is its area of overlap
+        with the polygon, including for a polygon that runs off the image
+        """
+        for poly in (self.polygon(7, 5.3, 4.2, 3.7), self.polygon(30, 25, 0, 0)):
+            box = lsst.geom.Box2I(lsst.geom.Point2I(-2, -3), lsst.geom.Extent2I(13, 11))
+            image = poly.createImage(box)
+            for y in range(box.getMinY(), box.getMaxY() + 1):
+                for x in range(box.getMinX(), box.getMaxX() + 1):
+                    pixel = lsst.geom.Box2D(lsst.geom.Point2D(x - 0.5, y - 0.5),
+                                            lsst.geom.Point2D(x + 0.5, y + 0.5))
+                    area = sum(p.calculateArea() for p in poly.intersection(pixel))
+                    self.assertFloatsAlmostEqual(image[x, y, lsst.afw.image.PARENT], area, atol=1e-5)
+
     def testTransform(self):
         """Test constructor for Polygon involving transforms"""
         box = lsst.geom.Box2D(lsst.geom.Point2D(0.0, 0.0),
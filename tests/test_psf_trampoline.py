@@ -26,9 +26,10 @@ import pickle
 import numpy as np
 
 import lsst.utils.tests
+import lsst.pex.exceptions
 from lsst.afw.typehandling import StorableHelperFactory
 from lsst.afw.detection import Psf, GaussianPsf
-from lsst.afw.image import Image, ExposureF
+from lsst.afw.image import Color, Image, ExposureF
 from lsst.geom import Box2I, Extent2I, Point2I, Point2D
 from lsst.afw.geom.ellipses import Quadrupole
 import testPsfTrampolineLib as cppLib
@@ -271,6 +272,90 @@ class FixedPsfTestSuite(lsst.utils.tests.TestCase):
         img2 = self.fixedPsf.computeKernelImage(pos2)
         self.assertFloatsEqual(img1.array, img2.array)
 
+    def testCacheStatistics(self):
+        pos1 = Point2D(1.0, 1.0)
+        pos2 = Point2D(-1.0, -1.0)
+        for position in (pos1, pos2, pos1, pos1):
+            self.floatPsf.computeKernelImage(position)
+        stats = self.floatPsf.getCacheStatistics()
+        self.assertEqual(stats.kernelImageMisses, 2)
+        self.assertEqual(stats.kernelImageHits, 2)
+        self.assertEqual(stats.imageMisses, 0)
+        self.assertEqual(stats.imageHits, 0)
+        # The default computeImage goes through the kernel image cache
+        self.floatPsf.computeImage(pos2)
+        stats = self.floatPsf.getCacheStatistics()
+        self.assertEqual(stats.imageMisses, 1)
+        self.assertEqual(stats.kernelImageHits, 3)
+        self.floatPsf.resetCacheStatistics()
+        stats = self.floatPsf.getCacheStatistics()
+        self.assertEqual((stats.imageHits, stats.imageMisses, stats.kernelImageHits, stats.kernelImageMisses),
+                         (0, 0, 0, 0))
+        # Shards share the capacity, which is reported undivided
+        self.floatPsf.setCacheCapacity(10)
+        self.assertEqual(self.floatPsf.getCacheCapacity(), 10)
+
+    def testCacheGrid(self):
+        self.assertEqual(self.floatPsf.getCacheGridSize(), 0.0)
+        self.floatPsf.setCacheGridSize(4.0)
+        self.assertEqual(self.floatPsf.getCacheGridSize(), 4.0)
+        # Both positions snap to (4, 0), so the second is a cache hit
+        pos1 = Point2D(3.1, 1.2)
+        pos2 = Point2D(4.9, -0.7)
+        img1 = self.floatPsf.computeKernelImage(pos1)
+        img2 = self.floatPsf.computeKernelImage(pos2)
+        self.assertImagesEqual(img1, img2)
+        stats = self.floatPsf.getCacheStatistics()
+        self.assertEqual((stats.kernelImageHits, stats.kernelImageMisses), (1, 1))
+        # (-1, 0.5) snaps to (0, 0), where TestPsf has its narrow profile
+        self.assertImagesEqual(self.floatPsf.computeKernelImage(Point2D(-1.0, 0.5)),
+                               self.floatPsf.computeKernelImage(Point2D(1.0, 1.0)))
+        # computeImage is still centered on the exact position
+        image = self.floatPsf.computeImage(pos1)
+        self.assertImagesAlmostEqual(image, Psf.recenterKernelImage(img1, pos1))
+        self.assertEqual(self.floatPsf.computeKernelImages([pos1])[0].getBBox(), img1.getBBox())
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            self.floatPsf.setCacheGridSize(-1.0)
+        self.floatPsf.setCacheGridSize(0.0)
+        self.assertFloatsNotEqual(self.floatPsf.computeKernelImage(Point2D(-1.0, 0.5)).array,
+                                  self.floatPsf.computeKernelImage(Point2D(1.0, 1.0)).array)
+
+    def testBatch(self):
+        positions = [Point2D(x, 0.5*x) for x in np.linspace(-5.0, 5.0, 11)]
+        for numThreads in (1, 3):
+            with self.subTest(numThreads=numThreads):
+                images = self.floatPsf.computeKernelImages(positions, numThreads=numThreads)
+                self.assertEqual(len(images), len(positions))
+                for position, image in zip(positions, images):
+                    self.assertImagesEqual(image, self.floatPsf.computeKernelImage(position))
+                # As for computeKernelImage, a fixed Psf returns the same image everywhere
+                images = self.fixedPsf.computeKernelImages(positions, numThreads=numThreads)
+                for image in images:
+                    self.assertImagesEqual(image, self.fixedPsf.computeKernelImage(positions[0]))
+        self.assertEqual(self.floatPsf.computeKernelImages([]), [])
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            self.floatPsf.computeKernelImages(positions, [Color()])
+
+    def testBatchOverride(self):
+        class BatchPsf(TestPsf):
+            __test__ = False
+
+            def __init__(self):
+                TestPsf.__init__(self, isFixed=False)
+                self.batchSizes = []
+
+            def _doComputeKernelImages(self, positions, colors):
+                self.batchSizes.append(len(positions))
+                return [self._doComputeKernelImage(p, c) for p, c in zip(positions, colors)]
+
+        psf = BatchPsf()
+        positions = [Point2D(x, 0.0) for x in range(-3, 4)]
+        images = psf.computeKernelImages(positions, numThreads=2)
+        self.assertEqual(sum(psf.batchSizes), len(positions))
+        self.assertLessEqual(len(psf.batchSizes), 2)
+        for position, image in zip(positions, images):
+            self.assertImagesEqual(image, self.floatPsf.computeKernelImage(position))
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
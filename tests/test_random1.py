@@ -141,6 +141,57 @@ class RandomImageTestCase(unittest.TestCase):
         self.assertAlmostEqual(stats.getValue(afwMath.VARIANCE), mu, 1)
 
 
+class CounterBasedRandomTestCase(unittest.TestCase):
+    """A test case for the counter-based lsst.afw.math.Random algorithm"""
+
+    def setUp(self):
+        self.rand = afwMath.Random(afwMath.Random.PHILOX4X32, getSeed())
+
+    def testSubstreams(self):
+        self.assertTrue(self.rand.isCounterBased())
+        self.assertFalse(afwMath.Random().isCounterBased())
+        with self.assertRaises(lsst.pex.exceptions.LogicError):
+            afwMath.Random().getSubstream(0)
+
+        self.rand.uniform()
+        values = [[self.rand.getSubstream(i).uniform() for i in range(5)] for _ in range(2)]
+        self.assertEqual(values[0], values[1])
+        self.assertEqual(len(set(values[0])), 5)
+        # Skipping substreams moves past all of them
+        expected = self.rand.getSubstream(5).uniform()
+        self.rand.skipSubstreams(5)
+        self.assertEqual(self.rand.uniform(), expected)
+        self.assertNotEqual(self.rand.getSubstream(0).uniform(), expected)
+
+    def testImageFillsIndependentOfThreads(self):
+        fills = [
+            lambda image, rand, numThreads: afwMath.randomUniformImage(image, rand, numThreads),
+            lambda image, rand, numThreads: afwMath.randomFlatImage(image, rand, -2.0, 3.0, numThreads),
+            lambda image, rand, numThreads: afwMath.randomGaussianImage(image, rand, numThreads),
+            lambda image, rand, numThreads: afwMath.randomPoissonImage(image, rand, 5.0, numThreads),
+            lambda image, rand, numThreads: afwMath.randomUniformIntImage(image, rand, 10, numThreads),
+        ]
+        for fill in fills:
+            results = []
+            for numThreads in (1, 3, 0):
+                rand = self.rand.deepCopy()
+                image = afwImage.ImageD(lsst.geom.Extent2I(101, 67))
+                fill(image, rand, numThreads)
+                results.append((image.array.copy(), rand.uniform()))
+            for array, nextValue in results[1:]:
+                self.assertTrue((array == results[0][0]).all())
+                self.assertEqual(nextValue, results[0][1])
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            afwMath.randomUniformImage(image, self.rand, -1)
+
+    def testImageStatistics(self):
+        image = afwImage.ImageF(lsst.geom.Extent2I(1000, 1000))
+        afwMath.randomGaussianImage(image, self.rand, 4)
+        stats = afwMath.makeStatistics(image, afwMath.MEAN | afwMath.VARIANCE)
+        self.assertAlmostEqual(stats.getValue(afwMath.MEAN), 0.0, 2)
+        self.assertAlmostEqual(stats.getValue(afwMath.VARIANCE), 1.0, 2)
+
+
 class TestMemory(lsst.utils.tests.MemoryTestCase):
     pass
 
@@ -19,6 +19,7 @@
 # You should have received a copy of the GNU General Public License
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+import contextlib
 import unittest
 
 import os
@@ -26,15 +27,18 @@ import numpy as np
 import astropy.io.fits
 
 import lsst.utils.tests
+import lsst.pex.exceptions
 from lsst.daf.base import PropertyList
 from lsst.geom import Box2I, Point2I, Extent2I, Point2D, Box2D, SpherePoint, degrees
 from lsst.afw.geom import makeSkyWcs, Polygon
 from lsst.afw.table import ExposureTable
 from lsst.afw.image import (Image, Mask, MaskedImage, Exposure, LOCAL, PARENT, MaskPixel, VariancePixel,
                             ImageFitsReader, MaskFitsReader, MaskedImageFitsReader, ExposureFitsReader,
+                            ExposureCutoutReader,
                             FilterLabel, PhotoCalib, ApCorrMap, VisitInfo, TransmissionCurve,
                             CoaddInputs, ExposureInfo, ExposureF)
 from lsst.afw.detection import GaussianPsf
+from lsst.afw.fits import FitsError
 from lsst.afw.cameraGeom.testUtils import DetectorWrapper
 
 TESTDIR = os.path.abspath(os.path.dirname(__file__))
@@ -84,6 +88,37 @@ class FitsReaderTestCase(lsst.utils.tests.TestCase):
                                 self.assertEqual(subIn.getBBox(), image2.getBBox())
                                 self.assertTrue(np.all(image2.array == array2))
 
+    def testImageFitsReaderMap(self):
+        for dtypeIn in (np.int32, np.float32, np.float64):
+            with self.subTest(dtypeIn=dtypeIn):
+                imageIn = Image(self.bbox, dtype=dtypeIn)
+                imageIn.array[:, :] = np.random.randint(low=1, high=5, size=imageIn.array.shape)
+                with lsst.utils.tests.getTempFilePath(".fits") as fileName:
+                    imageIn.writeFits(fileName)
+                    reader = ImageFitsReader(fileName)
+                    for args in self.args:
+                        with self.subTest(args=args):
+                            array = reader.mapArray(*args)
+                            image = reader.map(*args)
+                            subIn = imageIn.subset(*args) if args else imageIn
+                            self.assertEqual(dtypeIn, array.dtype)
+                            self.assertTrue(np.all(subIn.array == array))
+                            self.assertImagesEqual(subIn, image)
+                    # The mapping is private, so changing the pixels does not change the file
+                    image = reader.map()
+                    image.array[:, :] = 0
+                    self.assertImagesEqual(reader.read(), imageIn)
+                    del reader
+                    self.assertImagesEqual(image, Image(self.bbox, initialValue=0, dtype=dtypeIn))
+                    # Images cannot be mapped as another pixel type, or if they are scaled
+                    with self.assertRaises(FitsError):
+                        ImageFitsReader(fileName).map(dtype=np.float64 if dtypeIn != np.float64 else np.int32)
+        imageIn = Image(self.bbox, dtype=np.uint16)
+        with lsst.utils.tests.getTempFilePath(".fits") as fileName:
+            imageIn.writeFits(fileName)
+            with self.assertRaises(FitsError):
+                ImageFitsReader(fileName).map()
+
     def testMaskFitsReader(self):
         maskIn = Mask(self.bbox, dtype=MaskPixel)
         maskIn.array[:, :] = np.random.randint(low=1, high=5, size=maskIn.array.shape)
@@ -187,7 +222,7 @@ class FitsReaderTestCase(lsst.utils.tests.TestCase):
         self.checkMultiPlaneReader(reader, maskedImageIn, fileName, dtypesOut,
                                    compare=self.assertMaskedImagesEqual)
 
-    def checkExposureFitsReader(self, exposureIn, fileName, dtypesOut):
+    def checkExposureFitsReader(self, exposureIn, fileName, dtypesOut, prefetch=False):
         """Test ExposureFitsReader.
 
         Parameters
@@ -198,8 +233,13 @@ class FitsReaderTestCase(lsst.utils.tests.TestCase):
             Name of the file the reader is reading.
         dtypesOut : sequence of `numpy.dype`
             Compatible image pixel types to try to read in.
+        prefetch : `bool`
+            Whether to start reading the archive in the background as soon
+            as the reader is created.
         """
         reader = ExposureFitsReader(fileName)
+        if prefetch:
+            reader.prefetch()
         self.assertIn('EXPINFO_V', reader.readMetadata().toDict(), "metadata is automatically versioned")
         reader.readMetadata().remove('EXPINFO_V')
         # ensure EXTNAMEs can be read and make sense
@@ -320,6 +360,12 @@ class FitsReaderTestCase(lsst.utils.tests.TestCase):
                     exposureIn.writeFits(fileName)
                     self.checkMaskedImageFitsReader(exposureIn.maskedImage, fileName, self.dtypes[n:])
                     self.checkExposureFitsReader(exposureIn, fileName, self.dtypes[n:])
+                    self.checkExposureFitsReader(exposureIn, fileName, self.dtypes[n:], prefetch=True)
+                    reader = ExposureFitsReader(fileName)
+                    reader.prefetch()
+                    exposureOut = reader.read()
+                    self.assertMaskedImagesEqual(exposureOut.maskedImage, exposureIn.maskedImage)
+                    self.assertEqual(exposureOut.getPhotoCalib(), exposureIn.getPhotoCalib())
 
     def test31035(self):
         """Test that illegal values in the header can be round-tripped."""
@@ -344,6 +390,58 @@ class FitsReaderTestCase(lsst.utils.tests.TestCase):
             _ = ExposureF.readFits(fileName)
 
 
+    def testExposureCutoutReader(self):
+        """Test that batches of cutouts match reading each one on its own."""
+        psf = GaussianPsf(11, 11, 2.0)
+        with contextlib.ExitStack() as stack:
+            fileNames = []
+            for i in range(3):
+                exposure = ExposureF(self.bbox)
+                exposure.image.array[:, :] = np.random.randint(low=1, high=5, size=exposure.image.array.shape)
+                exposure.variance.array[:, :] = i + 1
+                exposure.setPsf(psf)
+                exposure.metadata["INDEX"] = i
+                fileName = stack.enter_context(lsst.utils.tests.getTempFilePath(f"_{i}.fits"))
+                exposure.writeFits(fileName)
+                fileNames.append(fileName)
+            bboxes = [Box2I(), Box2I(Point2I(3, 4), Extent2I(2, 1)), Box2I(Point2I(2, 2), Extent2I(3, 5))]
+            requestFiles = [fileNames[i % 3] for i in range(7)][::-1]
+            requestBoxes = [bboxes[i % 2 + (i // 3) % 2] for i in range(7)]
+            for numThreads, maxOpenFiles in ((1, 1), (3, 2), (0, 16)):
+                with self.subTest(numThreads=numThreads, maxOpenFiles=maxOpenFiles):
+                    reader = ExposureCutoutReader(maxOpenFiles=maxOpenFiles, numThreads=numThreads)
+                    self.assertEqual(reader.getNumThreads(), numThreads)
+                    self.assertEqual(reader.getMaxOpenFiles(), maxOpenFiles)
+                    for batch in range(2):
+                        cutouts = reader.read(requestFiles, requestBoxes)
+                        maskedImages = reader.readMaskedImages(requestFiles, requestBoxes, dtype=np.float64)
+                        self.assertEqual(len(cutouts), len(requestFiles))
+                        for fileName, bbox, cutout, maskedImage in zip(requestFiles, requestBoxes, cutouts,
+                                                                       maskedImages):
+                            expected = ExposureFitsReader(fileName).read(bbox)
+                            self.assertMaskedImagesEqual(cutout.maskedImage, expected.maskedImage)
+                            self.assertEqual(cutout.metadata.toDict(), expected.metadata.toDict())
+                            self.assertIsNotNone(cutout.getPsf())
+                            self.assertEqual(maskedImage.image.array.dtype, np.float64)
+                            self.assertImagesEqual(maskedImage.mask, expected.mask)
+                            self.assertImagesEqual(maskedImage.variance, expected.variance)
+                        self.assertEqual(reader.getNumOpenFiles(), min(maxOpenFiles, len(fileNames)))
+                    # Each cutout has its own metadata
+                    cutouts[0].metadata["INDEX"] = 10
+                    self.assertEqual(reader.read(requestFiles[:1], requestBoxes[:1])[0].metadata["INDEX"],
+                                     0)
+                    reader.clear()
+                    self.assertEqual(reader.getNumOpenFiles(), 0)
+            reader = ExposureCutoutReader()
+            self.assertEqual(reader.read([], []), [])
+            with self.assertRaises(lsst.pex.exceptions.LengthError):
+                reader.read(fileNames, bboxes[:1])
+            with self.assertRaises(FitsError):
+                reader.read([os.path.join(TESTDIR, "no_such_file.fits")], [Box2I()])
+            with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+                ExposureCutoutReader(maxOpenFiles=0)
+
+
 class TestMemory(lsst.utils.tests.MemoryTestCase):
     pass
 
@@ -28,6 +28,8 @@ import unittest
 from lsst.geom import Angle, degrees
 from lsst.afw.coord import Observatory, Weather
 from lsst.afw.coord import refraction, differentialRefraction
+from lsst.afw.coord import computeRefraction, computeDifferentialRefraction, makeDefaultWeather
+import lsst.pex.exceptions
 import lsst.utils.tests
 
 
@@ -101,6 +103,30 @@ class RefractionTestSuite(lsst.utils.tests.TestCase):
             refract = refraction(wl, elevation, self.observatory)
             self.assertFloatsAlmostEqual(refract.asArcseconds(), refVal, rtol=1e-3)
 
+    def testArrays(self):
+        """Test that refraction of arrays of elevations matches that of each
+        elevation.
+        """
+        elevations = np.random.random(10)*np.pi/2.
+        wl, wlRef = 480., 620.  # in nm
+        for weather in [self.weather, None]:
+            arrayWeather = makeDefaultWeather(self.observatory.getElevation()) if weather is None else weather
+            refract = computeRefraction(wl, elevations, self.observatory, arrayWeather)
+            diffRefract = computeDifferentialRefraction(wl, wlRef, elevations, self.observatory,
+                                                        arrayWeather)
+            for i, elevation in enumerate(elevations):
+                self.assertFloatsAlmostEqual(
+                    refract[i],
+                    refraction(wl, Angle(elevation), self.observatory, weather=weather).asRadians(),
+                    rtol=1e-10)
+                self.assertFloatsAlmostEqual(
+                    diffRefract[i],
+                    differentialRefraction(wl, wlRef, Angle(elevation), self.observatory,
+                                           weather=weather).asRadians(),
+                    rtol=1e-8)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            computeRefraction(230., elevations, self.observatory, self.weather)
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
@@ -26,6 +26,7 @@ import unittest
 import numpy as np
 
 import lsst.utils.tests
+import lsst.pex.exceptions
 import lsst.geom
 import lsst.afw.detection as afwDetect
 import lsst.afw.image as afwImage
@@ -134,6 +135,27 @@ class RgbTestCase(unittest.TestCase):
         if display:
             rgb.displayRGB(rgbImage)
 
+    def testStarsAsinhFused(self):
+        """Test that the single-pass asinh mapping matches the numpy one"""
+        asinhMap = rgb.AsinhMapping(self.min, self.range, self.Q)
+        arrays = [im.getArray() for im in (self.images[R], self.images[G], self.images[B])]
+        arrays[0][10, 10] = np.nan
+        with np.errstate(invalid="ignore"):
+            expected = np.dstack(asinhMap._convertImagesToUint8(*arrays)).astype(np.uint8)
+        expected[10, 10] = 0  # numpy's conversion of NaN to uint8 is undefined
+        for numThreads in (1, 3):
+            rgbImage = asinhMap.makeRgbImage(self.images[R], self.images[G], self.images[B],
+                                             numThreads=numThreads)
+            self.assertEqual(rgbImage.dtype, np.uint8)
+            self.assertEqual(rgbImage.shape, expected.shape)
+            # numpy works in single precision, so values may be truncated differently
+            self.assertLessEqual(np.max(np.abs(rgbImage.astype(int) - expected)), 1)
+            np.testing.assert_array_equal(rgbImage[10, 10], [0, 0, 0])
+
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            rgb.makeAsinhRgbArray(arrays[0], arrays[1], arrays[2][1:, :], minimum=[0, 0, 0],
+                                  soften=1.0, slope=1.0)
+
     def testStarsAsinhZscale(self):
         """Test creating an RGB image using an asinh stretch estimated using zscale"""
 
@@ -313,6 +313,53 @@ class SchemaMapperTestCase(unittest.TestCase):
         mapper3.addMapping(ka, "c", True)
         self.assertEqual(mapper3.getMapping(ka), kc)
 
+    def testExtendWithMapper(self):
+        """Test that extending a catalog through a mapper copies the same
+        values as assigning each record through it.
+        """
+        inSchema = lsst.afw.table.Schema()
+        inSchema.addField("a", type=np.int32, doc="")
+        inSchema.addField("b", type=np.float64, doc="")
+        inSchema.addField("skipped", type=np.float64, doc="")
+        inSchema.addField("c", type="ArrayF", size=3, doc="")
+        inSchema.addField("s", type=str, size=5, doc="")
+        inSchema.addField("v", type="ArrayD", size=0, doc="")
+        for i in range(5):
+            inSchema.addField(f"flag{i}", type="Flag", doc="")
+        mapper = lsst.afw.table.SchemaMapper(inSchema)
+        mapper.addOutputField(lsst.afw.table.Field["Flag"]("outFlag", ""))
+        for name in ("flag3", "a", "b", "c", "s", "v", "flag0", "flag4"):
+            mapper.addMapping(inSchema.find(name).key)
+        outSchema = mapper.getOutputSchema()
+
+        rng = np.random.RandomState(7)
+        inCat = lsst.afw.table.BaseCatalog(inSchema)
+        for i in range(50):
+            record = inCat.addNew()
+            record["a"] = i
+            record["b"] = rng.randn()
+            record["skipped"] = rng.randn()
+            record["c"] = rng.randn(3).astype(np.float32)
+            record["s"] = f"s{i}"
+            record["v"] = rng.randn(i % 4)
+            for j in range(5):
+                record[f"flag{j}"] = bool(rng.randint(2))
+
+        for numThreads in (1, 3):
+            outCat = lsst.afw.table.BaseCatalog(outSchema)
+            outCat.extend(inCat, mapper=mapper, numThreads=numThreads)
+            self.assertEqual(len(outCat), len(inCat))
+            for inRecord, outRecord in zip(inCat, outCat):
+                expected = lsst.afw.table.BaseCatalog(outSchema).addNew()
+                expected.assign(inRecord, mapper)
+                for name in outSchema.getNames():
+                    if name == "v" or name == "c":
+                        np.testing.assert_array_equal(outRecord[name], expected[name])
+                    else:
+                        self.assertEqual(outRecord[name], expected[name])
+                self.assertFalse(outRecord["outFlag"])
+                self.assertEqual(outRecord["flag3"], inRecord["flag3"])
+
     def testJoin2(self):
         s1 = lsst.afw.table.Schema()
         self.assertEqual(s1.join("a", "b"), "a_b")
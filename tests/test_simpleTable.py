@@ -409,6 +409,51 @@ class SimpleTableTestCase(lsst.utils.tests.TestCase):
         cat8.extend(list(cat7), True)
         cat8.extend(list(cat7), deep=True)
 
+    def testConcatenate(self):
+        schema = lsst.afw.table.SourceTable.makeMinimalSchema()
+        kInt = schema.addField("f1", type=np.int32, doc="an int")
+        kFlag = schema.addField("f2", type="Flag", doc="a flag")
+        kArray = schema.addField("f3", type="ArrayD", size=0, doc="a variable-length array")
+        catalogs = []
+        for n in (5, 0, 17, 3):
+            catalog = lsst.afw.table.SourceCatalog(schema)
+            for i in range(n):
+                record = catalog.addNew()
+                record.set(kInt, 100*len(catalogs) + i)
+                record.set(kFlag, i % 3 == 0)
+                record.set(kArray, np.arange(i, dtype=float))
+            catalogs.append(catalog)
+        parts = [record for catalog in catalogs for record in catalog]
+        for numThreads in (1, 3):
+            with self.subTest(numThreads=numThreads):
+                merged = lsst.afw.table.SourceCatalog.concatenate(catalogs, numThreads=numThreads)
+                self.assertIsInstance(merged, lsst.afw.table.SourceCatalog)
+                self.assertEqual(len(merged), len(parts))
+                self.assertTrue(merged.isContiguous())
+                for record, part in zip(merged, parts):
+                    self.assertEqual(record.getId(), part.getId())
+                    self.assertEqual(record.get(kInt), part.get(kInt))
+                    self.assertEqual(record.get(kFlag), part.get(kFlag))
+                    np.testing.assert_array_equal(record.get(kArray), part.get(kArray))
+                np.testing.assert_array_equal(merged[kInt], [part.get(kInt) for part in parts])
+        # The records are copies, not shared with the inputs
+        merged[0].set(kInt, -1)
+        self.assertEqual(catalogs[0][0].get(kInt), 0)
+
+        mapper = lsst.afw.table.SchemaMapper(schema)
+        mapper.addMinimalSchema(lsst.afw.table.SourceTable.makeMinimalSchema())
+        kOut = mapper.addMapping(kInt)
+        table = lsst.afw.table.SourceTable.make(mapper.getOutputSchema())
+        mapped = lsst.afw.table.SourceCatalog.concatenate(table, mapper, catalogs, numThreads=2)
+        self.assertTrue(mapped.isContiguous())
+        self.assertEqual(list(mapped[kOut]), [part.get(kInt) for part in parts])
+
+        other = lsst.afw.table.SourceCatalog(lsst.afw.table.SourceTable.makeMinimalSchema())
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            lsst.afw.table.SourceCatalog.concatenate([catalogs[0], other])
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            lsst.afw.table.SourceCatalog.concatenate([])
+
     def testTicket2308(self):
         inputSchema = lsst.afw.table.SourceTable.makeMinimalSchema()
         mapper1 = lsst.afw.table.SchemaMapper(inputSchema)
@@ -851,6 +896,75 @@ class SimpleTableTestCase(lsst.utils.tests.TestCase):
         table = lsst.afw.table.SimpleTable.make(schema)
         self.assertEqual(table.metadata, lsst.daf.base.PropertyList())
 
+    def testParallelSort(self):
+        """Test single- and multi-key sorts, with and without threads.
+        """
+        schema = lsst.afw.table.Schema()
+        aKey = schema.addField("a", type=np.int32, doc="coarse key")
+        bKey = schema.addField("b", type=np.float64, doc="fine key")
+        indexKey = schema.addField("index", type=np.int64, doc="original position")
+        rng = np.random.RandomState(5)
+        a = rng.randint(0, 5, size=1000).astype(np.int32)
+        b = rng.randint(0, 20, size=1000).astype(np.float64)
+        catalog = lsst.afw.table.BaseCatalog(schema)
+        catalog.resize(len(a))
+        catalog[aKey] = a
+        catalog[bKey] = b
+        catalog[indexKey] = np.arange(len(a))
+
+        for numThreads in (1, 4, 0):
+            # Ties keep their original order.
+            sorted1 = catalog.copy(deep=True)
+            sorted1.sort(aKey, numThreads=numThreads)
+            np.testing.assert_array_equal(sorted1[indexKey], np.argsort(a, kind="stable"))
+
+            sorted2 = catalog.copy(deep=True)
+            sorted2.sort([aKey, bKey], numThreads=numThreads)
+            np.testing.assert_array_equal(sorted2[indexKey], np.lexsort((b, a)))
+
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            catalog.sort(aKey, numThreads=-1)
+
+    def testHashIndex(self):
+        """Test finding records in an unsorted catalog with a HashIndex.
+        """
+        schema = lsst.afw.table.SimpleTable.makeMinimalSchema()
+        nameKey = schema.addField("name", type=str, size=8, doc="name")
+        catalog = lsst.afw.table.SimpleCatalog(schema)
+        ids = np.random.RandomState(3).permutation(100) + 1
+        for i in ids:
+            record = catalog.addNew()
+            record.setId(int(i))
+            record.set(nameKey, f"s{i}")
+        self.assertFalse(catalog.isSorted())
+
+        index = catalog.makeHashIndex(catalog.getIdKey())
+        self.assertIsInstance(index, lsst.afw.table.SimpleHashIndexL)
+        self.assertEqual(len(index), len(catalog))
+        self.assertTrue(index.isValid())
+        self.assertEqual(index.find(17).getId(), 17)
+        self.assertIsNone(index.find(1000))
+        self.assertIn(42, index)
+        self.assertFalse(index.contains(0))
+        records = index.findAll([5, 0, 99])
+        self.assertEqual(records[0].getId(), 5)
+        self.assertIsNone(records[1])
+        self.assertEqual(records[2].getId(), 99)
+        indices = index.getIndices(list(ids[:10]) + [0])
+        np.testing.assert_array_equal(indices, list(range(10)) + [-1])
+
+        nameIndex = catalog.makeHashIndex(nameKey)
+        self.assertEqual(nameIndex.find("s23").getId(), 23)
+        self.assertIsNone(nameIndex.find("t23"))
+
+        index.invalidate()
+        self.assertFalse(index.isValid())
+        with self.assertRaises(lsst.pex.exceptions.LogicError):
+            index.find(17)
+        catalog.addNew().setId(1000)
+        index.rebuild(catalog)
+        self.assertEqual(index.find(1000).getId(), 1000)
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
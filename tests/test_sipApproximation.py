@@ -24,6 +24,7 @@ import unittest
 import numpy as np
 from numpy.testing import assert_allclose
 import lsst.utils.tests
+import lsst.pex.exceptions
 from lsst.daf.base import PropertyList
 from lsst.geom import Point2D, Point2I, Extent2I, Box2D, Box2I, SpherePoint, radians
 from lsst.afw.geom import (SipApproximation, makeSkyWcs, getPixelToIntermediateWorldCoords, SkyWcs,
@@ -523,6 +524,48 @@ class SipApproximationTestCases(lsst.utils.tests.TestCase):
         run(self.calexp03, order=3)
         run(self.wcs22, order=8)
 
+    def testThreaded(self):
+        """Check that threading the grid evaluation and fit does not change
+        the solution.
+        """
+        kwds = extractCtorArgs(self.calexp03)
+        for numThreads in (2, 0):
+            serial = SipApproximation(gridShape=Extent2I(20, 20), order=3, **kwds)
+            threaded = SipApproximation(gridShape=Extent2I(20, 20), order=3, numThreads=numThreads, **kwds)
+            for getter in ("getA", "getB", "getAP", "getBP"):
+                assert_allclose(getattr(threaded, getter)(), getattr(serial, getter)(), rtol=0, atol=0)
+            threaded.refineGrid()
+            serial.refineGrid()
+            self.assertEqual(threaded.computeMaxDeviation(), serial.computeMaxDeviation())
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            SipApproximation(gridShape=Extent2I(20, 20), order=3, numThreads=-1, **kwds)
+
+    def testRefit(self):
+        """Check that refitting at a lower order on the same grid matches a
+        fresh fit at that order, and that fitToTolerance picks the lowest
+        order that meets the tolerance.
+        """
+        kwds = extractCtorArgs(self.calexp03)
+        gridShape = Extent2I(20, 20)
+        approx = SipApproximation(gridShape=gridShape, order=5, **kwds)
+        approx.fit(3)
+        fresh = SipApproximation(gridShape=gridShape, order=3, **kwds)
+        self.assertEqual(approx.getOrder(), 3)
+        for getter in ("getA", "getB", "getAP", "getBP"):
+            assert_allclose(getattr(approx, getter)(), getattr(fresh, getter)(), rtol=1E-10, atol=1E-14)
+
+        tolerance = 0.01
+        order = approx.fitToTolerance(5, tolerance)
+        self.assertEqual(order, approx.getOrder())
+        diffs = approx.computeMaxDeviation()
+        self.assertLessEqual(diffs[0], tolerance)
+        self.assertLessEqual(diffs[1], tolerance)
+        self.assertGreater(order, 0)
+        lower = SipApproximation(gridShape=gridShape, order=order - 1, **kwds)
+        self.assertGreater(max(lower.computeMaxDeviation()), tolerance)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            approx.fitToTolerance(-1, tolerance)
+
     def testCalculateSipWcsHeader(self):
         """Test the calculateSipWcsHeader function
 
@@ -19,7 +19,7 @@ from lsst.afw.geom import wcsAlmostEqualOverBBox, \
     SkyWcs, makeSkyWcs, makeCdMatrix, makeWcsPairTransform, \
     makeFlippedWcs, makeModifiedWcs, makeTanSipWcs, \
     getIntermediateWorldCoordsToSky, getPixelToIntermediateWorldCoords, \
-    stripWcsMetadata
+    stripWcsMetadata, setSkyWcsMetadataCacheCapacity, getSkyWcsMetadataCacheCapacity
 from lsst.afw.geom import getCdMatrixFromMetadata, getSipMatrixFromMetadata, makeSimpleWcsMetadata
 from lsst.afw.geom.testUtils import makeSipIwcToPixel, makeSipPixelToIwc
 from lsst.afw.fits import makeLimitedFitsHeader
@@ -78,6 +78,13 @@ class SkyWcsBaseTestCase(lsst.utils.tests.TestCase):
         pixelPoints2 = skyWcs.skyToPixel(skyPoints)
         assert_allclose(pixelPoints, pixelPoints2, atol=1e-7)
 
+        # check that afw::table::io persistence, which writes the compact
+        # encoding of the string, reproduces the SkyWcs exactly
+        with lsst.utils.tests.getTempFilePath(".fits") as outFile:
+            skyWcs.writeFits(outFile)
+            skyWcsFromFits = SkyWcs.readFits(outFile)
+        self.assertEqual(skyWcs, skyWcsFromFits)
+
         # check that WCS is properly saved as part of an exposure FITS file
         exposure = ExposureF(100, 100, skyWcs)
         with lsst.utils.tests.getTempFilePath(".fits") as outFile:
@@ -688,6 +695,32 @@ class MetadataWcsTestCase(SkyWcsBaseTestCase):
             predictedPixelArea = 1 / linSkyToPix1.getLinear().computeDeterminant()
             self.assertAlmostEqual(pixelArea, predictedPixelArea)
 
+    def testLinearizeMethodsBatch(self):
+        """Test that the methods taking lists of points agree with those
+        taking single points.
+        """
+        skyWcs = makeSkyWcs(self.metadata)
+        pixels = [skyWcs.getPixelOrigin() + lsst.geom.Extent2D(dx, dy)
+                  for dx, dy in ((0, 0), (210.5, -33.0), (-1000, 1230), (55, 4000))]
+        coords = skyWcs.pixelToSky(pixels)
+        for skyUnit in (lsst.geom.degrees, lsst.geom.arcseconds):
+            for batch, method, points in (
+                (skyWcs.linearizePixelToSky(coords, skyUnit), skyWcs.linearizePixelToSky, coords),
+                (skyWcs.linearizePixelToSky(pixels, skyUnit), skyWcs.linearizePixelToSky, pixels),
+                (skyWcs.linearizeSkyToPixel(coords, skyUnit), skyWcs.linearizeSkyToPixel, coords),
+                (skyWcs.linearizeSkyToPixel(pixels, skyUnit), skyWcs.linearizeSkyToPixel, pixels),
+            ):
+                self.assertEqual(len(batch), len(points))
+                for transform, point in zip(batch, points):
+                    expect = method(point, skyUnit)
+                    self.assertFloatsAlmostEqual(transform.getParameterVector(),
+                                                 expect.getParameterVector(), rtol=1E-9, atol=1E-9)
+        scales = skyWcs.getPixelScale(pixels)
+        self.assertEqual(len(scales), len(pixels))
+        for scale, pixel in zip(scales, pixels):
+            self.assertAnglesAlmostEqual(scale, skyWcs.getPixelScale(pixel),
+                                         maxDiff=1E-9*lsst.geom.arcseconds)
+
     def testBasics(self):
         skyWcs = makeSkyWcs(self.metadata, strip=False)
         self.assertEqual(len(self.metadata.names(False)), 14)
@@ -695,6 +728,46 @@ class MetadataWcsTestCase(SkyWcsBaseTestCase):
         makeSkyWcs(self.metadata, strip=True)
         self.assertEqual(len(self.metadata.names(False)), 0)
 
+    def testMetadataCache(self):
+        """Test that makeSkyWcs shares SkyWcs read from equivalent metadata,
+        and strips the metadata just as it would without the cache.
+        """
+        metadata1 = self.metadata.deepCopy()
+        metadata1.set("EXPTIME", 30.0)  # not a WCS card
+        metadata2 = self.metadata.deepCopy()
+        metadata2.set("EXPTIME", 15.0)
+        skyWcs1 = makeSkyWcs(metadata1)
+        skyWcs2 = makeSkyWcs(metadata2)
+        self.assertIs(skyWcs1, skyWcs2)
+        self.assertEqual(metadata1.names(False), self.metadata.names(False) + ["EXPTIME"])
+
+        uncached = makeSkyWcs(self.metadata.deepCopy(), useCache=False)
+        self.assertIsNot(uncached, skyWcs1)
+        self.assertEqual(uncached, skyWcs1)
+
+        # A different WCS card gives a different WCS.
+        metadata3 = self.metadata.deepCopy()
+        metadata3.set("CRPIX1", 1000.0)
+        skyWcs3 = makeSkyWcs(metadata3)
+        self.assertIsNot(skyWcs3, skyWcs1)
+        self.assertNotEqual(skyWcs3, skyWcs1)
+
+        # Stripping removes the same cards whether or not the cache is used.
+        expect = self.metadata.deepCopy()
+        makeSkyWcs(expect, strip=True, useCache=False)
+        for _ in range(2):
+            stripped = metadata1.deepCopy()
+            self.assertIs(makeSkyWcs(stripped, strip=True), skyWcs1)
+            self.assertEqual(stripped.names(False), expect.names(False) + ["EXPTIME"])
+
+        capacity = getSkyWcsMetadataCacheCapacity()
+        try:
+            setSkyWcsMetadataCacheCapacity(0)
+            self.assertEqual(getSkyWcsMetadataCacheCapacity(), 0)
+            self.assertIsNot(makeSkyWcs(metadata1.deepCopy()), makeSkyWcs(metadata1.deepCopy()))
+        finally:
+            setSkyWcsMetadataCacheCapacity(capacity)
+
     def testBasicsStrip(self):
         stripWcsMetadata(self.metadata)
         self.assertEqual(len(self.metadata.names(False)), 0)
@@ -1047,6 +1120,42 @@ class TestTanSipTestCase(SkyWcsBaseTestCase):
         self.checkMakeFlippedWcs(skyWcs1)
         self.checkMakeFlippedWcs(skyWcs2)
 
+    def testDirectEvaluation(self):
+        """Test that pixelToSky and skyToPixel match the AST mapping once
+        enough points have been transformed to use direct TAN-SIP evaluation
+        """
+        tanMetadata = PropertyList()
+        for name in ("RADESYS", "CRPIX1", "CRPIX2", "CRVAL1", "CRVAL2",
+                     "CUNIT1", "CUNIT2", "CD1_1", "CD1_2", "CD2_1", "CD2_2"):
+            tanMetadata.set(name, self.metadata.getScalar(name))
+        tanMetadata.set("CTYPE1", "RA---TAN")
+        tanMetadata.set("CTYPE2", "DEC--TAN")
+        for metadata in (self.metadata, tanMetadata):
+            skyWcs = makeSkyWcs(metadata, strip=False)
+            transform = skyWcs.getTransform()
+            pixPosList = [lsst.geom.Point2D(x, y) for x in np.linspace(-1000, 2000, 11)
+                          for y in np.linspace(-1000, 2000, 11)]
+            # the first call goes through AST, the second may not
+            for _ in range(2):
+                skyPosList = skyWcs.pixelToSky(pixPosList)
+                self.assertSpherePointListsAlmostEqual(skyPosList, transform.applyForward(pixPosList),
+                                                       maxSep=1e-6*lsst.geom.arcseconds)
+                self.assertPairListsAlmostEqual(skyWcs.skyToPixel(skyPosList),
+                                                transform.applyInverse(skyPosList), maxDiff=1e-6)
+                for pixPos, skyPos in zip(pixPosList[:5], skyPosList):
+                    self.assertSpherePointsAlmostEqual(skyWcs.pixelToSky(pixPos), skyPos,
+                                                       maxSep=1e-6*lsst.geom.arcseconds)
+                    self.assertPairsAlmostEqual(skyWcs.skyToPixel(skyPos), transform.applyInverse(skyPos),
+                                                maxDiff=1e-6)
+
+            # a WCS with a shifted pixel origin gets its own evaluator
+            shift = lsst.geom.Extent2D(10.5, -3.25)
+            shiftedWcs = skyWcs.copyAtShiftedPixelOrigin(shift)
+            shiftedPosList = [pixPos + shift for pixPos in pixPosList]
+            for _ in range(2):
+                self.assertSpherePointListsAlmostEqual(shiftedWcs.pixelToSky(shiftedPosList), skyPosList,
+                                                       maxSep=1e-6*lsst.geom.arcseconds)
+
     def testReadWriteFits(self):
         wcsFromMetadata = makeSkyWcs(self.metadata)
         with lsst.utils.tests.getTempFilePath(".fits") as filePath:
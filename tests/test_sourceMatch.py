@@ -34,6 +34,7 @@ import unittest
 import numpy as np
 
 import lsst.geom
+import lsst.sphgeom
 import lsst.afw.table as afwTable
 import lsst.daf.base as dafBase
 import lsst.utils.tests
@@ -255,6 +256,167 @@ class SourceMatchTestCase(lsst.utils.tests.TestCase):
                 print(s0.getId(), s1.getId(), s0.getRa(), s0.getDec(), end=' ')
                 print(s1.getRa(), s1.getDec(), s0.getPsfInstFlux(), s1.getPsfInstFlux())
 
+    def testMatchNearPole(self):
+        """Test that matches near a pole agree with a brute-force match, and
+        do not depend on the number of threads.
+        """
+        rng = np.random.RandomState(11)
+        coordKey = afwTable.SourceTable.getCoordKey()
+        for cat, n, offset in ((self.ss1, 300, 0), (self.ss2, 400, 1000)):
+            ra = rng.uniform(0.0, 2*np.pi, size=n)
+            dec = np.pi/2 - rng.uniform(0.0, 0.002, size=n)
+            for i in range(n):
+                record = cat.addNew()
+                record.setId(offset + i)
+                record.set(coordKey, lsst.geom.SpherePoint(ra[i], dec[i], lsst.geom.radians))
+        radius = 10.0*lsst.geom.arcseconds
+
+        def key(m):
+            return (m.first.getId(), m.second.getId() if m.second is not None else None)
+
+        expected = set()
+        for r1 in self.ss1:
+            for r2 in self.ss2:
+                if r1.getCoord().separation(r2.getCoord()) < radius:
+                    expected.add((r1.getId(), r2.getId()))
+        self.assertGreater(len(expected), 0)
+
+        for closest in (False, True):
+            mc = afwTable.MatchControl()
+            mc.findOnlyClosest = closest
+            mc.includeMismatches = True
+            serial = afwTable.matchRaDec(self.ss1, self.ss2, radius, mc)
+            mc.numThreads = 4
+            parallel = afwTable.matchRaDec(self.ss1, self.ss2, radius, mc)
+            self.assertEqual([key(m) for m in serial], [key(m) for m in parallel])
+            self.assertEqual([m.distance for m in serial], [m.distance for m in parallel])
+            found = {key(m) for m in serial if m.second is not None}
+            if closest:
+                self.assertLessEqual(found, expected)
+                self.assertEqual({k[0] for k in found}, {k[0] for k in expected})
+            else:
+                self.assertEqual(found, expected)
+            unmatched = {m.first.getId() for m in serial if m.second is None}
+            self.assertEqual(unmatched, {r.getId() for r in self.ss1} - {k[0] for k in expected})
+
+        mc = afwTable.MatchControl()
+        selfSerial = afwTable.matchRaDec(self.ss2, radius, mc)
+        mc.numThreads = 0
+        selfParallel = afwTable.matchRaDec(self.ss2, radius, mc)
+        self.assertEqual([key(m) for m in selfSerial], [key(m) for m in selfParallel])
+
+    def testMatchIndex(self):
+        """Test that matching against a MatchIndex agrees with matchRaDec and
+        matchXy.
+        """
+        rng = np.random.RandomState(5)
+        schema = afwTable.SourceTable.makeMinimalSchema()
+        centroidKey = afwTable.Point2DKey.addFields(schema, "cen", "center", "pixels")
+        table = afwTable.SourceTable.make(schema)
+        table.defineCentroid("cen")
+        coordKey = afwTable.SourceTable.getCoordKey()
+        catalogs = []
+        for n, offset in ((200, 0), (300, 1000)):
+            catalog = afwTable.SourceCatalog(table)
+            for i in range(n):
+                record = catalog.addNew()
+                record.setId(offset + i)
+                record.set(coordKey, lsst.geom.SpherePoint(rng.uniform(10.0, 10.1), rng.uniform(-5.0, -4.9),
+                                                           lsst.geom.degrees))
+                record.set(centroidKey, lsst.geom.Point2D(*rng.uniform(0.0, 100.0, size=2)))
+            catalogs.append(catalog)
+        cat1, cat2 = catalogs
+        cat1[7].set(coordKey, lsst.geom.SpherePoint(float("nan"), float("nan"), lsst.geom.degrees))
+
+        def key(m):
+            return (m.first.getId(), m.second.getId() if m.second is not None else None)
+
+        radius = 20.0*lsst.geom.arcseconds
+        skyIndex = afwTable.SourceMatchIndex.makeSky(cat2)
+        self.assertTrue(skyIndex.isSky())
+        self.assertEqual(len(skyIndex), len(cat2))
+        with self.assertRaises(lsst.pex.exceptions.LogicError):
+            skyIndex.matchXy(cat1, 2.0)
+        for closest in (False, True):
+            mc = afwTable.MatchControl()
+            mc.findOnlyClosest = closest
+            expected = afwTable.matchRaDec(cat1, cat2, radius, mc)
+            self.assertGreater(len(expected), 0)
+            matches = skyIndex.matchRaDec(cat1, radius, mc)
+            self.assertEqual({key(m) for m in matches}, {key(m) for m in expected})
+            for m in matches:
+                self.assertFloatsAlmostEqual(m.distance, m.first.getCoord().separation(
+                    m.second.getCoord()).asRadians(), rtol=1E-8)
+            mc.numThreads = 3
+            indices = skyIndex.matchRaDecIndices(cat1, radius, mc)
+            self.assertEqual([(cat1[int(i)].getId(), cat2[int(j)].getId())
+                              for i, j in zip(indices.first, indices.second)],
+                             [key(m) for m in matches])
+            np.testing.assert_array_equal(indices.distance, [m.distance for m in matches])
+
+        simple = afwTable.SimpleCatalog(afwTable.SimpleTable.makeMinimalSchema())
+        for record in cat2:
+            simple.addNew().set(coordKey, record.getCoord())
+        simpleIndex = afwTable.SimpleMatchIndex.makeSky(simple)
+        with self.assertRaises(lsst.pex.exceptions.LogicError):
+            afwTable.SimpleMatchIndex.makeXy(simple)
+        simpleIndices = simpleIndex.matchRaDecIndices(cat1, radius)
+        indices = skyIndex.matchRaDecIndices(cat1, radius)
+        np.testing.assert_array_equal(simpleIndices.first, indices.first)
+        np.testing.assert_array_equal(simpleIndices.second, indices.second)
+        self.assertEqual(len(afwTable.SourceMatchIndex.makeSky(cat1)), len(cat1) - 1)
+
+        mc = afwTable.MatchControl()
+        mc.includeMismatches = True
+        xyIndex = afwTable.SourceMatchIndex.makeXy(cat2)
+        self.assertFalse(xyIndex.isSky())
+        expected = afwTable.matchXy(cat1, cat2, 2.0, mc)
+        matches = xyIndex.matchXy(cat1, 2.0, mc)
+        self.assertEqual({key(m) for m in matches}, {key(m) for m in expected})
+        indices = xyIndex.matchXyIndices(cat1, 2.0, mc)
+        self.assertEqual(np.sum(indices.second < 0), sum(m.second is None for m in matches))
+        self.assertTrue(np.all(np.isnan(indices.distance[indices.second < 0])))
+
+    def testMatchIndices(self):
+        """Test that match columns agree with matchRaDec, and pack like
+        matches.
+        """
+        rng = np.random.RandomState(3)
+        coordKey = afwTable.SourceTable.getCoordKey()
+        for cat, n, offset in ((self.ss1, 150, 0), (self.ss2, 250, 1000)):
+            for i in range(n):
+                record = cat.addNew()
+                record.setId(offset + i)
+                record.set(coordKey, lsst.geom.SpherePoint(rng.uniform(20.0, 20.05), rng.uniform(30.0, 30.05),
+                                                           lsst.geom.degrees))
+        radius = 15.0*lsst.geom.arcseconds
+
+        def rows(catalog, ordered=True):
+            return {(r["first"], r["second"], r["distance"]) if ordered else
+                    (min(r["first"], r["second"]), max(r["first"], r["second"]), r["distance"])
+                    for r in catalog}
+
+        mc = afwTable.MatchControl()
+        mc.findOnlyClosest = False
+        matches = afwTable.matchRaDec(self.ss1, self.ss2, radius, mc)
+        self.assertGreater(len(matches), 0)
+        indices = afwTable.matchRaDecIndices(self.ss1, self.ss2, radius, mc)
+        self.assertEqual(len(indices.first), len(matches))
+        self.assertEqual(rows(afwTable.packMatches(indices, self.ss1, self.ss2)),
+                         rows(afwTable.packMatches(matches)))
+        with self.assertRaises(TypeError):
+            afwTable.packMatches(indices)
+
+        for symmetric in (False, True):
+            mc = afwTable.MatchControl()
+            mc.symmetricMatch = symmetric
+            matches = afwTable.matchRaDec(self.ss2, radius, mc)
+            mc.numThreads = 2
+            indices = afwTable.matchRaDecIndices(self.ss2, radius, mc)
+            # Unsymmetric self-matches may put either record of a pair first.
+            self.assertEqual(rows(afwTable.packMatches(indices, self.ss2, self.ss2), symmetric),
+                             rows(afwTable.packMatches(matches), symmetric))
+
     def testMismatches(self):
         """ Chech that matchRaDec works as expected when using
             the includeMismatches option
@@ -379,6 +541,53 @@ class SourceMatchTestCase(lsst.utils.tests.TestCase):
         self.assertLess(diff.std(), tol)  # I get 4e-12
         self.assertFloatsAlmostEqual(dist1, dist2, atol=tol)
 
+    def testSkyPixels(self):
+        """Test computing, sorting by and partitioning by the sky pixels of
+        records.
+        """
+        rng = np.random.RandomState(3)
+        coordKey = afwTable.SourceTable.getCoordKey()
+        for i in range(500):
+            record = self.ss1.addNew()
+            record.setId(i)
+            record.set(coordKey, lsst.geom.SpherePoint(rng.uniform(0.0, 360.0), rng.uniform(-90.0, 90.0),
+                                                       lsst.geom.degrees))
+        self.ss1[11].set(coordKey, lsst.geom.SpherePoint(float("nan"), 0.0, lsst.geom.degrees))
+        for pixelization in (lsst.sphgeom.HtmPixelization(3), lsst.sphgeom.HealpixPixelization(2)):
+            expected = []
+            for record in self.ss1:
+                coord = record.getCoord()
+                if np.isfinite(coord.getRa().asRadians()):
+                    lonLat = lsst.sphgeom.LonLat.fromRadians(coord.getRa().asRadians(),
+                                                               coord.getDec().asRadians())
+                    expected.append(pixelization.index(lsst.sphgeom.UnitVector3d(lonLat)))
+                else:
+                    expected.append(afwTable.NO_SKY_PIXEL)
+            for numThreads in (1, 0):
+                pixels = afwTable.computeSkyPixels(self.ss1, pixelization, numThreads=numThreads)
+                np.testing.assert_array_equal(pixels, expected)
+
+            catalog = self.ss1.copy()
+            ranges = afwTable.sortBySkyPixel(catalog, pixelization, numThreads=0)
+            pixels = afwTable.computeSkyPixels(catalog, pixelization)
+            self.assertTrue(np.all(pixels[1:] >= pixels[:-1]))
+            ids = np.array([record.getId() for record in catalog])
+            self.assertEqual(sorted(ids), list(range(len(self.ss1))))
+            self.assertEqual(ranges[-1].pixel, afwTable.NO_SKY_PIXEL)
+            self.assertEqual(catalog[ranges[-1].begin].getId(), 11)
+            self.assertEqual(ranges[0].begin, 0)
+            self.assertEqual(ranges[-1].end, len(catalog))
+            for r, following in zip(ranges[:-1], ranges[1:]):
+                self.assertEqual(r.end, following.begin)
+                self.assertLess(r.pixel, following.pixel)
+            for r in ranges:
+                np.testing.assert_array_equal(pixels[r.begin:r.end], r.pixel)
+                # Records in each pixel keep their order
+                self.assertTrue(np.all(ids[r.begin + 1:r.end] > ids[r.begin:r.end - 1]))
+            rangesFromPixels = afwTable.findSkyPixelRanges(pixels)
+            self.assertEqual([(r.pixel, r.begin, r.end) for r in rangesFromPixels],
+                             [(r.pixel, r.begin, r.end) for r in ranges])
+
 
 class TestMemory(lsst.utils.tests.MemoryTestCase):
     pass
@@ -326,6 +326,32 @@ class SourceTableTestCase(lsst.utils.tests.TestCase):
         np.testing.assert_array_equal((someBits.array & 0x1 != 0), self.catalog["a_flag"])
         np.testing.assert_array_equal((someBits.array & 0x2 != 0), self.catalog["c_flag"])
 
+    def testBitsColumnSelect(self):
+        catalog = lsst.afw.table.SourceCatalog(self.table)
+        catalog.reserve(64)
+        for i in range(64):
+            catalog.addNew()
+        names = ["a_flag", "b_flag", "c_flag", "d_flag"]
+        for bit, name in enumerate(names):
+            catalog[name] = (np.arange(64) & (1 << bit)) != 0
+        bits = catalog.getBits()
+        self.assertEqual(bits.getMask(["a_flag", "c_flag"]), 0x5)
+        a, b, c, d = (catalog[name] for name in names)
+        for kwds, expected in [(dict(), np.ones(64, dtype=bool)),
+                               (dict(allOf=0x3), a & b),
+                               (dict(anyOf=0x6), b | c),
+                               (dict(noneOf=0x9), ~a & ~d),
+                               (dict(allOf=0x1, anyOf=0x6, noneOf=0x8), a & (b | c) & ~d)]:
+            mask = bits.select(**kwds)
+            np.testing.assert_array_equal(mask, expected)
+            np.testing.assert_array_equal(bits.selectIndices(**kwds), np.flatnonzero(expected))
+            subset = catalog.subset(mask)
+            self.assertEqual([r.getId() for r in subset], list(catalog["id"][expected]))
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            bits.select(allOf=0x10)
+        with self.assertRaises(lsst.pex.exceptions.NotFoundError):
+            bits.getMask(["a_flag", "z_flag"])
+
     def testCast(self):
         baseCat = self.catalog.cast(lsst.afw.table.BaseCatalog)
         baseCat.cast(lsst.afw.table.SourceCatalog)
@@ -32,6 +32,7 @@
 
 #include "lsst/geom.h"
 #include "lsst/afw/geom/SpanSet.h"
+#include "lsst/afw/geom/PackedSpanSet.h"
 #include "lsst/afw/image.h"
 #include "lsst/afw/fits.h"
 #include "lsst/afw/table/io/OutputArchive.h"
@@ -660,6 +661,39 @@ BOOST_AUTO_TEST_CASE(SpanSet_testEquality) {
     BOOST_CHECK((*firstSS != *secondSSShift) == false);
 }
 
+BOOST_AUTO_TEST_CASE(SpanSet_testPacked) {
+    // Spans far apart need more than 16 bits per value, and unnormalized SpanSets need not be sorted
+    std::vector<afwGeom::Span> spans = {afwGeom::Span(3, -2, 4),      afwGeom::Span(4, 100000, 100003),
+                                        afwGeom::Span(-70000, 5, 5),  afwGeom::Span(-70000, 1, 2),
+                                        afwGeom::Span(2000000, 8, 7), afwGeom::Span(9, 0, 0)};
+    auto circle = afwGeom::SpanSet::fromShape(3, afwGeom::Stencil::CIRCLE);
+    std::vector<std::shared_ptr<afwGeom::SpanSet>> spanSets = {
+            std::make_shared<afwGeom::SpanSet>(), circle, circle->shiftedBy(-1000, 1000000),
+            std::make_shared<afwGeom::SpanSet>(spans, false)};
+    for (auto const& spanSet : spanSets) {
+        afwGeom::PackedSpanSet packed(*spanSet);
+        BOOST_CHECK_EQUAL(packed.size(), spanSet->size());
+        BOOST_CHECK_EQUAL(packed.getArea(), spanSet->getArea());
+        BOOST_CHECK_EQUAL(packed.getBBox(), spanSet->getBBox());
+        BOOST_CHECK(std::equal(packed.begin(), packed.end(), spanSet->begin(), spanSet->end()));
+        auto unpacked = packed.toSpanSet();
+        BOOST_CHECK(std::equal(unpacked->begin(), unpacked->end(), spanSet->begin(), spanSet->end()));
+
+        afwGeom::PackedSpanSet copied(packed);
+        afwGeom::PackedSpanSet moved(std::move(copied));
+        BOOST_CHECK(moved == packed);
+        BOOST_CHECK(copied.empty());
+        copied = moved;
+        BOOST_CHECK(copied == packed);
+    }
+    // A 3x3 circle fits inside the object itself; a 7x7 one needs one value per row, column and width
+    auto small = afwGeom::SpanSet::fromShape(1, afwGeom::Stencil::CIRCLE)->shiftedBy(10000, 10000);
+    BOOST_CHECK_EQUAL(afwGeom::PackedSpanSet(*small).getMemorySize(), sizeof(afwGeom::PackedSpanSet));
+    BOOST_CHECK_EQUAL(afwGeom::PackedSpanSet(*circle).getMemorySize(),
+                      sizeof(afwGeom::PackedSpanSet) + 21 * sizeof(std::uint16_t));
+    BOOST_CHECK(afwGeom::PackedSpanSet(*circle) != afwGeom::PackedSpanSet(*circle->shiftedBy(1, 0)));
+}
+
 BOOST_AUTO_TEST_CASE(SpanSet_testFunctor) {
     // Test the remaining types of functors. Above code has tested ndarray functors
     // need to test, constants, iterators, Images
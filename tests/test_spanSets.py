@@ -29,6 +29,7 @@ import lsst.geom
 import lsst.afw.geom as afwGeom
 import lsst.afw.geom.ellipses as afwGeomEllipses
 import lsst.afw.image as afwImage
+import lsst.pex.exceptions
 
 
 class SpanSetTestCase(lsst.utils.tests.TestCase):
@@ -97,6 +98,37 @@ class SpanSetTestCase(lsst.utils.tests.TestCase):
         for a, b in zip(spanSetTwo, spanSetSplit[1]):
             self.assertEqual(a, b)
 
+    def testSplitPixels(self):
+        """Compare split against a flood fill of the pixels, including at
+        negative coordinates, serially and in parallel.
+        """
+        rng = np.random.RandomState(11)
+        for trial in range(10):
+            pixels = {(y, x) for y, x in rng.randint(-20, 20, size=(600, 2))}
+            spanSet = afwGeom.SpanSet([afwGeom.Span(y, x, x) for y, x in pixels])
+            components = []
+            remaining = set(pixels)
+            while remaining:
+                stack = [min(remaining)]
+                remaining.remove(stack[0])
+                component = set(stack)
+                while stack:
+                    y, x = stack.pop()
+                    for neighbor in ((y - 1, x), (y + 1, x), (y, x - 1), (y, x + 1)):
+                        if neighbor in remaining:
+                            remaining.remove(neighbor)
+                            component.add(neighbor)
+                            stack.append(neighbor)
+                components.append(component)
+            components.sort(key=min)
+            for numThreads in (1, 4):
+                with self.subTest(trial=trial, numThreads=numThreads):
+                    pieces = spanSet.split(numThreads=numThreads)
+                    self.assertEqual([{(span.getY(), x) for span in piece
+                                       for x in range(span.getMinX(), span.getMaxX() + 1)}
+                                      for piece in pieces], components)
+                    self.assertEqual(spanSet.isContiguous(), len(components) == 1)
+
     def testTransform(self):
         transform = lsst.geom.LinearTransform(np.array([[2.0, 0.0], [0.0, 2.0]]))
         spanSetPreScale = afwGeom.SpanSet.fromShape(2, afwGeom.Stencil.CIRCLE)
@@ -149,6 +181,40 @@ class SpanSetTestCase(lsst.utils.tests.TestCase):
         self.assertEqual(bBox.getMinX(), -1)
         self.assertEqual(bBox.getMinY(), -1)
 
+    def testDilateErodePixels(self):
+        """Compare dilation and erosion against pixel-by-pixel definitions,
+        for irregular sets and kernels, serially and in parallel.
+        """
+        def toPixels(spanSet):
+            return {(span.getY(), x) for span in spanSet for x in range(span.getMinX(), span.getMaxX() + 1)}
+
+        def toSpanSet(pixels):
+            spans = [afwGeom.Span(y, x, x) for y, x in pixels]
+            return afwGeom.SpanSet(spans)
+
+        rng = np.random.RandomState(5)
+        for trial in range(20):
+            pixels = {(y, x) for y, x in rng.randint(-15, 15, size=(150, 2))}
+            # Kernels need not be convex, or even have a span on every row
+            kernel = {(y, x) for y, x in rng.randint(-2, 3, size=(6, 2))}
+            spanSet = toSpanSet(pixels)
+            kernelSet = toSpanSet(kernel)
+            dilated = {(y + ky, x + kx) for y, x in pixels for ky, kx in kernel}
+            eroded = {(y - ky, x - kx) for y, x in pixels for ky, kx in kernel
+                      if all((y - ky + jy, x - kx + jx) in pixels for jy, jx in kernel)}
+            for numThreads in (1, 4):
+                with self.subTest(trial=trial, numThreads=numThreads):
+                    result = spanSet.dilated(kernelSet, numThreads=numThreads)
+                    self.assertEqual(toPixels(result), dilated)
+                    self.assertEqual(result, toSpanSet(dilated))
+                    result = spanSet.eroded(kernelSet, numThreads=numThreads)
+                    self.assertEqual(toPixels(result), eroded)
+                    self.assertEqual(result, toSpanSet(eroded))
+        circle = afwGeom.SpanSet.fromShape(4, afwGeom.Stencil.CIRCLE)
+        self.assertEqual(circle.dilated(2, numThreads=3), circle.dilated(2))
+        self.assertEqual(circle.eroded(2, afwGeom.Stencil.BOX, numThreads=3),
+                         circle.eroded(2, afwGeom.Stencil.BOX))
+
     def testFlatten(self):
         # Give an initial value to an input array
         inputArray = np.ones((6, 6)) * 9
@@ -195,6 +261,45 @@ class SpanSetTestCase(lsst.utils.tests.TestCase):
         truthArray = np.arange(5*5*3).reshape(5, 5, 3)
         self.assertFloatsAlmostEqual(unflattened3DArray, truthArray)
 
+    def testFlattenLayouts(self):
+        """Test flatten and unflatten on contiguous and strided arrays, serially
+        and in parallel.
+        """
+        rng = np.random.RandomState(3)
+        spanSet = afwGeom.SpanSet.fromShape(4, afwGeom.Stencil.CIRCLE).shiftedBy(7, 8)
+        yIndices = np.concatenate([np.full(span.getWidth(), span.getY()) for span in spanSet])
+        xIndices = np.concatenate([np.arange(span.getMinX(), span.getMaxX() + 1) for span in spanSet])
+        contiguous = rng.rand(20, 22, 3)
+        for image in (contiguous, contiguous[:, :, 0], contiguous[:, ::2, 1], contiguous[:, ::2, :]):
+            truth = image[yIndices - 1, xIndices - 2]
+            for numThreads in (1, 3):
+                with self.subTest(shape=image.shape, strides=image.strides, numThreads=numThreads):
+                    flat = spanSet.flatten(image, lsst.geom.Point2I(2, 1), numThreads=numThreads)
+                    np.testing.assert_array_equal(flat, truth)
+                    output = np.zeros(image.shape)
+                    spanSet.unflatten(output, flat, lsst.geom.Point2I(2, 1), numThreads=numThreads)
+                    expected = np.zeros(image.shape)
+                    expected[yIndices - 1, xIndices - 2] = truth
+                    np.testing.assert_array_equal(output, expected)
+                    # Strided flat arrays must work as well
+                    stridedFlat = np.zeros((2*len(truth),) + truth.shape[1:])[::2]
+                    spanSet.flatten(stridedFlat, image, lsst.geom.Point2I(2, 1), numThreads=numThreads)
+                    np.testing.assert_array_equal(stridedFlat, truth)
+        with self.assertRaises(lsst.pex.exceptions.OutOfRangeError):
+            spanSet.flatten(contiguous, lsst.geom.Point2I(4, 4), numThreads=2)
+
+    def testPackedSpanSet(self):
+        spanSet = afwGeom.SpanSet.fromShape(20, afwGeom.Stencil.CIRCLE).shiftedBy(100000, -7)
+        packed = afwGeom.PackedSpanSet(spanSet)
+        self.assertEqual(len(packed), len(spanSet))
+        self.assertEqual(packed.getArea(), spanSet.getArea())
+        self.assertEqual(packed.getBBox(), spanSet.getBBox())
+        self.assertEqual(list(packed), list(spanSet))
+        self.assertEqual(packed.toSpanSet(), spanSet)
+        self.assertEqual(packed, afwGeom.PackedSpanSet(spanSet))
+        self.assertNotEqual(packed, afwGeom.PackedSpanSet())
+        self.assertLess(packed.getMemorySize(), 12*len(spanSet))
+
     def populateMask(self):
         msk = afwImage.Mask(10, 10, 1)
         spanSetMask = afwGeom.SpanSet.fromShape(3, afwGeom.Stencil.CIRCLE).shiftedBy(5, 5)
@@ -367,6 +472,49 @@ class SpanSetTestCase(lsst.utils.tests.TestCase):
         for yVal, span in enumerate(spanSetUnion):
             self.assertEqual(span.getY(), yVal)
 
+    def testSetOperationPixels(self):
+        """Compare set operations against pixel-by-pixel definitions,
+        including for SpanSets built without normalization.
+        """
+        def toPixels(spanSet):
+            return {(span.getY(), x) for span in spanSet for x in range(span.getMinX(), span.getMaxX() + 1)}
+
+        def toSpanSet(pixels, normalize=True):
+            # Sorted, since SpanSet assumes that even when not normalizing,
+            # but one span per pixel
+            spans = [afwGeom.Span(y, x, x) for y, x in sorted(pixels)]
+            return afwGeom.SpanSet(spans, normalize)
+
+        rng = np.random.RandomState(11)
+        for trial in range(20):
+            first = {(y, x) for y, x in rng.randint(0, 12, size=(80, 2))}
+            second = {(y, x) for y, x in rng.randint(0, 12, size=(80, 2))}
+            for normalize in (True, False):
+                with self.subTest(trial=trial, normalize=normalize):
+                    a = toSpanSet(first, normalize)
+                    b = toSpanSet(second, normalize)
+                    self.assertEqual(a.intersect(b), toSpanSet(first & second))
+                    self.assertEqual(a.intersectNot(b), toSpanSet(first - second))
+                    self.assertEqual(a.union(b), toSpanSet(first | second))
+                    self.assertEqual(toPixels(a.intersect(b)), first & second)
+
+    def testIntersectEach(self):
+        spanSet = afwGeom.SpanSet.fromShape(10, afwGeom.Stencil.CIRCLE)
+        boxes = [lsst.geom.Box2I(lsst.geom.Point2I(x, y), lsst.geom.Extent2I(8, 6))
+                 for x in range(-12, 12, 8) for y in range(-12, 12, 6)]
+        boxes.append(lsst.geom.Box2I(lsst.geom.Point2I(50, 50), lsst.geom.Extent2I(3, 3)))
+        others = [afwGeom.SpanSet(box) for box in boxes]
+        for numThreads in (1, 3):
+            clipped = spanSet.intersectEach(boxes, numThreads=numThreads)
+            intersected = spanSet.intersectEach(others, numThreads=numThreads)
+            self.assertEqual(len(clipped), len(boxes))
+            self.assertEqual(len(intersected), len(boxes))
+            for box, other, c, i in zip(boxes, others, clipped, intersected):
+                self.assertEqual(c, spanSet.clippedTo(box))
+                self.assertEqual(i, spanSet.intersect(other))
+        self.assertEqual(sum(c.getArea() for c in clipped), spanSet.getArea())
+        self.assertEqual(clipped[-1].getArea(), 0)
+
     def testMaskToSpanSet(self):
         mask, _ = self.makeMaskAndSpanSetForOperationTest()
         spanSetFromMask = afwGeom.SpanSet.fromMask(mask)
@@ -399,6 +547,48 @@ class SpanSetTestCase(lsst.utils.tests.TestCase):
         self.assertEqual(spans.getBBox(), box)
         self.assertFalse(point in spans)
 
+    def testFromMaskBlocks(self):
+        """Test fromMask and intersecting with a Mask on rows with long runs
+        that start and end inside and across blocks of pixels.
+        """
+        rng = np.random.RandomState(11)
+        box = lsst.geom.Box2I(lsst.geom.Point2I(-7, 20), lsst.geom.Extent2I(203, 37))
+        mask = afwImage.Mask(box)
+        array = mask.getArray()
+        for row in array:
+            for _ in range(rng.randint(0, 5)):
+                x0 = rng.randint(0, box.getWidth())
+                row[x0:x0 + rng.randint(1, 90)] |= rng.choice([1, 2, 3])
+        array[5, :] = 2
+        array[6, ::2] = 1
+
+        def expectedSpans(selected):
+            spans = []
+            for j, row in enumerate(selected):
+                x = 0
+                while x < len(row):
+                    if row[x]:
+                        start = x
+                        while x < len(row) and row[x]:
+                            x += 1
+                        spans.append(afwGeom.Span(j + box.getMinY(), start + box.getMinX(),
+                                                  x - 1 + box.getMinX()))
+                    else:
+                        x += 1
+            return afwGeom.SpanSet(spans)
+
+        for numThreads in (1, 4):
+            with self.subTest(numThreads=numThreads):
+                self.assertEqual(afwGeom.SpanSet.fromMask(mask, 2, numThreads=numThreads),
+                                 expectedSpans(array & 2 != 0))
+                self.assertEqual(afwGeom.SpanSet.fromMask(mask, 3, numThreads=numThreads),
+                                 expectedSpans(array & 3 != 0))
+        self.assertEqual(afwGeom.SpanSet.fromMask(mask), expectedSpans(array != 0))
+        region = afwGeom.SpanSet.fromShape(60, afwGeom.Stencil.BOX, lsst.geom.Point2I(60, 40))
+        inside = expectedSpans(np.ones(array.shape, dtype=bool)).intersect(region)
+        self.assertEqual(region.intersect(mask, 1), inside.intersect(expectedSpans(array & 1 != 0)))
+        self.assertEqual(region.intersectNot(mask, 1), inside.intersect(expectedSpans(array & 1 == 0)))
+
     def testEquality(self):
         firstSpanSet, secondSpanSet = self.makeOverlapSpanSets()
         secondSpanSetShift = secondSpanSet.shiftedBy(0, 2)
@@ -208,6 +208,25 @@ class SpatialCellSetTestCase(unittest.TestCase):
         self.cellSet.visitCandidates(visitor, 1)
         self.assertEqual(visitor.getN(), 3)
 
+    def testParallelVisitor(self):
+        """Test that parallel visits merge the per-cell results"""
+        self.makeTestCandidateCellSet()
+
+        visitor = afwMath.TestCandidateVisitor()
+        for numThreads in (0, 1, 2):
+            self.cellSet.visitCandidates(visitor, numThreads=numThreads)
+            self.assertEqual(visitor.getN(), self.NTestCandidates)
+            self.cellSet.visitCandidates(visitor, 1, numThreads=numThreads)
+            self.assertEqual(visitor.getN(), 3)
+            self.cellSet.visitAllCandidates(visitor, numThreads=numThreads)
+            self.assertEqual(visitor.getN(), self.NTestCandidates)
+
+        # visitors that can't be cloned are visited serially
+        self.assertIsNone(afwMath.CandidateVisitor().clone())
+        self.cellSet.visitCandidates(afwMath.CandidateVisitor(), numThreads=2)
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            self.cellSet.visitCandidates(visitor, numThreads=-1)
+
     def testGetCandidateById(self):
         """Check that we can lookup candidates by ID"""
         self.makeTestCandidateCellSet()
@@ -94,6 +94,26 @@ class SplineTestCase(unittest.TestCase):
         for x, y in zip(self.x2, y2):
             self.assertAlmostEqual(y, self.smooth(x, True), delta=1.5e-3)
 
+    def testInterpolateWithDerivative(self):
+        """Test evaluating a spline and its derivative together, at sorted and unsorted points"""
+        sp = afwMath.TautSpline(self.x, self.ySin)
+
+        y, dydx = sp.interpolateWithDerivative(self.x2)
+        self.assertEqual(len(y), len(self.x2))
+        self.assertEqual(len(dydx), len(self.x2))
+        for x, value, slope in zip(self.x2, y, dydx):
+            self.assertAlmostEqual(value, self.smooth(x), delta=1e-3)
+            self.assertAlmostEqual(slope, self.smooth(x, True), delta=1.5e-3)
+
+        # points out of order, and beyond the ends of the knots, must give the same results
+        # as the same points one at a time
+        xUnsorted = [3.7, -0.5, 0.05, 2.2, 4.5, 1.1, 1.1, 0.0, 3.9]
+        yUnsorted, dydxUnsorted = sp.interpolateWithDerivative(xUnsorted)
+        for x, value, slope in zip(xUnsorted, yUnsorted, dydxUnsorted):
+            ySingle, dydxSingle = sp.interpolateWithDerivative([x])
+            self.assertAlmostEqual(value, ySingle[0], places=12)
+            self.assertAlmostEqual(slope, dydxSingle[0], places=12)
+
     def testNaturalSpline2(self):
         """Test fitting a natural spline to a non-differentiable function (we basically fail)"""
         gamma = 0
@@ -27,6 +27,8 @@ Run with:
 or
    pytest test_stacker.py
 """
+import os
+import tempfile
 import unittest
 from functools import reduce
 
@@ -426,6 +428,178 @@ class StackTestCase(lsst.utils.tests.TestCase):
         self.assertEqual(stack.mask[1, 1, afwImage.LOCAL], clipped)
         self.assertEqual(stack.mask[1, 2, afwImage.LOCAL], rejected)
 
+    def testMultithreaded(self):
+        """Test that stacking with several threads reproduces the serial stack exactly"""
+        # wider than one column tile and with a ragged last band
+        dims = lsst.geom.Extent2I(300, 37)
+        maskVal = 0x4
+        mimgList = []
+        imgList = []
+        for i in range(self.nImg):
+            mimg = afwImage.MaskedImageF(dims)
+            mimg.image.array[:] = np.random.normal(10.0, 1.0, size=mimg.image.array.shape)
+            mimg.image.array[i::self.nImg, :] += 20.0  # outliers to clip
+            mimg.variance.array[:] = np.random.uniform(0.5, 2.0, size=mimg.variance.array.shape)
+            mimg.mask.array[:, i::7] = maskVal
+            mimgList.append(mimg)
+            imgList.append(mimg.image)
+
+        for stat in (afwMath.MEANCLIP, afwMath.MEDIAN):
+            for weighted in (False, True):
+                sctrl = afwMath.StatisticsControl()
+                sctrl.setAndMask(maskVal)
+                sctrl.setWeighted(weighted)
+                self.assertEqual(sctrl.getNumThreads(), 1)
+                serial = afwMath.statisticsStack(mimgList, stat, sctrl)
+                serialImage = afwMath.statisticsStack(imgList, stat, sctrl)
+                for numThreads in (0, 3, 8):
+                    sctrl.setNumThreads(numThreads)
+                    self.assertEqual(sctrl.getNumThreads(), numThreads)
+                    parallel = afwMath.statisticsStack(mimgList, stat, sctrl)
+                    self.assertMaskedImagesEqual(parallel, serial)
+                    parallelImage = afwMath.statisticsStack(imgList, stat, sctrl)
+                    self.assertImagesEqual(parallelImage, serialImage)
+
+        with self.assertRaises(pexEx.InvalidParameterError):
+            afwMath.StatisticsControl().setNumThreads(-1)
+
+    def testStreaming(self):
+        """Test that stacking strips read from disk reproduces the in-memory stack"""
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(10, 20), lsst.geom.Extent2I(self.nX, self.nY))
+        maskVal = 0x2
+        mimgList = []
+        for i in range(self.nImg):
+            mimg = afwImage.MaskedImageF(bbox)
+            mimg.image.array[:] = np.random.normal(10.0, 1.0, size=mimg.image.array.shape)
+            mimg.variance.array[:] = np.random.uniform(0.5, 2.0, size=mimg.variance.array.shape)
+            mimg.mask.array[i::5, :] = maskVal
+            mimgList.append(mimg)
+        sctrl = afwMath.StatisticsControl()
+        sctrl.setAndMask(maskVal)
+        clipped = 1 << afwImage.Mask().addMaskPlane("CLIPPED")
+
+        with tempfile.TemporaryDirectory() as tempDir:
+            def makeReader(fileName):
+                reader = afwImage.MaskedImageFitsReader(fileName)
+                return lambda box: reader.read(bbox=box)
+
+            readers = []
+            for i, mimg in enumerate(mimgList):
+                fileName = os.path.join(tempDir, f"input{i}.fits")
+                mimg.writeFits(fileName)
+                readers.append(makeReader(fileName))
+
+            for stat in (afwMath.MEAN, afwMath.MEANCLIP, afwMath.MEDIAN):
+                expected = afwMath.statisticsStack(mimgList, stat, sctrl, clipped=clipped)
+                result = afwImage.MaskedImageF(bbox)
+                stripBoxes = []
+
+                def writer(strip):
+                    stripBoxes.append(strip.getBBox())
+                    result.assign(strip, strip.getBBox())
+
+                afwMath.streamingStatisticsStackF(readers, bbox, stat, writer, sctrl, clipped=clipped,
+                                                  stripHeight=7)
+                self.assertEqual(len(stripBoxes), (self.nY + 6)//7)
+                self.assertTrue(all(box.getHeight() <= 7 for box in stripBoxes))
+                self.assertMaskedImagesEqual(result, expected)
+
+            with self.assertRaises(pexEx.InvalidParameterError):
+                afwMath.streamingStatisticsStackF(readers, bbox, afwMath.MEAN, writer, stripHeight=0)
+            # a reader that ignores the requested box
+            badReaders = readers[:-1] + [lambda box: mimgList[-1]]
+            with self.assertRaises(pexEx.InvalidParameterError):
+                afwMath.streamingStatisticsStackF(badReaders, bbox, afwMath.MEAN, writer, stripHeight=7)
+
+    def testStreamingCompactStorage(self):
+        """Test that holding the strips compactly reproduces the full-precision stack to within the
+        promised errors"""
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(3, 4), lsst.geom.Extent2I(self.nX, self.nY))
+        maskVal = 0x2
+        mimgList = []
+        for i in range(self.nImg):
+            mimg = afwImage.MaskedImageF(bbox)
+            mimg.image.array[:] = np.random.normal(1000.0, 10.0, size=mimg.image.array.shape)
+            mimg.variance.array[:] = np.random.uniform(50.0, 200.0, size=mimg.variance.array.shape)
+            mimg.mask.array[i::5, :] = maskVal
+            mimg.image.array[i, i] = np.nan
+            mimgList.append(mimg)
+        readers = [lambda box, mimg=mimg: afwImage.MaskedImageF(mimg, box, deep=True) for mimg in mimgList]
+        sctrl = afwMath.StatisticsControl()
+        sctrl.setAndMask(maskVal)
+        sctrl.setWeighted(True)
+
+        Storage = afwMath.StackSampleStorage
+        self.assertEqual(Storage().getPrecision(), Storage.FULL)
+        # HALF image errors are at most 2^-12 of 2048 (the power of two above the largest value), and
+        # SCALED_INT16 errors at most 1/131068 of the range of each strip; in both cases the relative
+        # errors of the weights (2^-11 at most) move a weighted mean by much less than 0.1
+        for precision, atol in ((Storage.HALF, 0.6), (Storage.SCALED_INT16, 0.1)):
+            # an image held at full precision because its errors would exceed maxImageError
+            for maxImageError in (np.inf, 1e-6):
+                storage = Storage(precision, maxImageError)
+                self.assertEqual(storage.getPrecision(), precision)
+                self.assertEqual(storage.getMaxImageError(), maxImageError)
+                for stat in (afwMath.MEAN, afwMath.MEDIAN):
+                    expected = afwMath.statisticsStack(mimgList, stat, sctrl)
+                    result = afwImage.MaskedImageF(bbox)
+                    afwMath.streamingStatisticsStackF(readers, bbox, stat,
+                                                      lambda strip: result.assign(strip, strip.getBBox()),
+                                                      sctrl, stripHeight=5, storage=storage)
+                    np.testing.assert_array_equal(result.mask.array, expected.mask.array)
+                    np.testing.assert_array_equal(np.isnan(result.image.array),
+                                                  np.isnan(expected.image.array))
+                    self.assertFloatsAlmostEqual(result.image.array, expected.image.array, atol=atol,
+                                                 ignoreNaNs=True)
+                    self.assertFloatsAlmostEqual(result.variance.array, expected.variance.array,
+                                                 rtol=2.0**-10, ignoreNaNs=True)
+
+        with self.assertRaises(pexEx.InvalidParameterError):
+            Storage(Storage.HALF, 0.0)
+
+    def testStackAccumulator(self):
+        """Test that accumulating inputs one at a time reproduces statisticsStack"""
+        bbox = lsst.geom.Box2I(lsst.geom.Point2I(5, 6), lsst.geom.Extent2I(self.nX, self.nY))
+        maskVal = afwImage.Mask.getPlaneBitMask("SAT")
+        propagatedBit = afwImage.Mask.getMaskPlane("SAT")
+        clipped = 1 << afwImage.Mask().addMaskPlane("CLIPPED")
+        mimgList = []
+        for i in range(self.nImg):
+            mimg = afwImage.MaskedImageF(bbox)
+            mimg.image.array[:] = np.random.normal(1000.0, 1.0, size=mimg.image.array.shape)
+            mimg.variance.array[:] = np.random.uniform(0.5, 2.0, size=mimg.variance.array.shape)
+            mimg.mask.array[i::3, :] = maskVal
+            mimg.image.array[0, i] = np.nan
+            mimgList.append(mimg)
+        wvector = [float(i + 1) for i in range(self.nImg)]
+
+        for stat in (afwMath.MEAN, afwMath.VARIANCE):
+            for weighted, useVector in ((False, False), (True, False), (True, True)):
+                sctrl = afwMath.StatisticsControl()
+                sctrl.setAndMask(maskVal)
+                sctrl.setWeighted(weighted)
+                sctrl.setMaskPropagationThreshold(propagatedBit, 0.35)
+                expected = afwMath.statisticsStack(mimgList, stat, sctrl, wvector if useVector else [],
+                                                   clipped=clipped)
+                accumulator = afwMath.StackAccumulatorF(bbox, stat, sctrl, clipped=clipped)
+                for mimg, weight in zip(mimgList, wvector):
+                    if useVector:
+                        accumulator.add(mimg, weight)
+                    else:
+                        accumulator.add(mimg)
+                self.assertEqual(accumulator.getNumInputs(), self.nImg)
+                result = accumulator.finish()
+                self.assertEqual(result.getBBox(), bbox)
+                self.assertMasksEqual(result.mask, expected.mask)
+                self.assertImagesAlmostEqual(result.image, expected.image, rtol=1e-6)
+                self.assertImagesAlmostEqual(result.variance, expected.variance, rtol=1e-5)
+
+        with self.assertRaises(pexEx.InvalidParameterError):
+            afwMath.StackAccumulatorF(bbox, afwMath.MEANCLIP)
+        accumulator = afwMath.StackAccumulatorF(bbox, afwMath.MEAN)
+        with self.assertRaises(pexEx.InvalidParameterError):
+            accumulator.add(afwImage.MaskedImageF(self.nX + 1, self.nY))
+
 #################################################################
 # Test suite boiler plate
 #################################################################
@@ -37,6 +37,7 @@ import numpy as np
 import lsst.utils.tests
 import lsst.pex.exceptions
 import lsst.geom
+import lsst.afw.geom as afwGeom
 import lsst.afw.image as afwImage
 import lsst.afw.math as afwMath
 import lsst.afw.display as afwDisplay
@@ -593,6 +594,203 @@ class StatisticsTestCase(lsst.utils.tests.TestCase):
             self.assertEqual(afwMath.makeStatistics(image, mask, afwMath.NMASKED, ctrl).getValue(), 1)
 
 
+    def testUnweightedMaskedSweep(self):
+        """Test the unweighted Image-with-Mask statistics against numpy"""
+        rng = np.random.RandomState(12345)
+        maskVal = 0x4
+        for dtype in (np.float32, np.float64, np.int32):
+            # a width that is not a multiple of the sweep's block size
+            image = afwImage.makeImageFromArray(rng.normal(100.0, 5.0, size=(37, 101)).astype(dtype))
+            mask = afwImage.Mask(image.getBBox())
+            mask.array[:] = rng.choice([0, 0x1, maskVal], size=mask.array.shape, p=[0.8, 0.1, 0.1])
+            if dtype != np.int32:
+                image.array[3, 5] = np.nan
+                image.array[7, 9] = np.inf
+            ctrl = afwMath.StatisticsControl()
+            ctrl.setAndMask(maskVal)
+            flags = (afwMath.NPOINT | afwMath.MEAN | afwMath.STDEV | afwMath.MIN | afwMath.MAX
+                     | afwMath.SUM | afwMath.ORMASK | afwMath.ERRORS)
+            stats = afwMath.makeStatistics(image, mask, flags, ctrl)
+
+            good = np.isfinite(image.array) & ((mask.array & maskVal) == 0)
+            values = image.array[good].astype(np.float64)
+            self.assertEqual(stats.getValue(afwMath.NPOINT), values.size)
+            self.assertFloatsAlmostEqual(stats.getValue(afwMath.MEAN), values.mean(), rtol=1e-12)
+            self.assertFloatsAlmostEqual(stats.getError(afwMath.MEAN),
+                                         values.std(ddof=1)/np.sqrt(values.size), rtol=1e-10)
+            self.assertFloatsAlmostEqual(stats.getValue(afwMath.STDEV), values.std(ddof=1), rtol=1e-10)
+            self.assertEqual(stats.getValue(afwMath.MIN), values.min())
+            self.assertEqual(stats.getValue(afwMath.MAX), values.max())
+            self.assertFloatsAlmostEqual(stats.getValue(afwMath.SUM), values.sum(), rtol=1e-12)
+            self.assertEqual(stats.getValue(afwMath.ORMASK), np.bitwise_or.reduce(mask.array[good]))
+
+
+    def testClippingIterations(self):
+        """Test iterated clipping against numpy, for small and large images"""
+        rng = np.random.RandomState(24680)
+        maskVal = 0x2
+        numSigmaClip = 2.5
+        for shape in ((37, 101), (300, 301)):
+            maskArray = np.where(rng.uniform(size=shape) < 0.1, maskVal, 0).astype(np.int32)
+            mask = afwImage.makeMaskFromArray(maskArray)
+            for dtype in (np.float32, np.float64, np.int32):
+                array = rng.normal(100.0, 5.0, size=shape)
+                array[rng.uniform(size=shape) < 0.05] += 1000.0  # outliers to clip
+                image = afwImage.makeImageFromArray(array.astype(dtype))
+                if dtype != np.int32:
+                    image.array[3, 5] = np.nan
+                good = np.isfinite(image.array) & (maskArray == 0)
+                values = image.array[good].astype(np.float64)
+                for numIter in (1, 2, 3, 5):
+                    ctrl = afwMath.StatisticsControl()
+                    ctrl.setAndMask(maskVal)
+                    ctrl.setNumSigmaClip(numSigmaClip)
+                    ctrl.setNumIter(numIter)
+                    stats = afwMath.makeStatistics(image, mask, afwMath.MEDIAN | afwMath.IQRANGE
+                                                   | afwMath.MEANCLIP | afwMath.VARIANCECLIP
+                                                   | afwMath.NCLIPPED, ctrl)
+                    center = stats.getValue(afwMath.MEDIAN)
+                    hwidth = numSigmaClip*0.741301109252802*stats.getValue(afwMath.IQRANGE)
+                    for i in range(numIter):
+                        clipped = values[np.abs(values - center) <= hwidth]
+                        center = clipped.mean()
+                        hwidth = numSigmaClip*clipped.std(ddof=1)
+                    self.assertFloatsAlmostEqual(stats.getValue(afwMath.MEANCLIP), clipped.mean(), rtol=1e-12)
+                    self.assertFloatsAlmostEqual(stats.getValue(afwMath.VARIANCECLIP), clipped.var(ddof=1),
+                                                 rtol=1e-9)
+                    self.assertEqual(stats.getValue(afwMath.NCLIPPED), values.size - clipped.size)
+
+    def testLargeImageQuantiles(self):
+        """Test the median and quartiles of images large enough to be selected without copying them"""
+        rng = np.random.RandomState(54321)
+        maskVal = 0x2
+        shape = (300, 301)
+        ctrl = afwMath.StatisticsControl()
+        ctrl.setAndMask(maskVal)
+        maskArray = np.where(rng.uniform(size=shape) < 0.1, maskVal, 0).astype(np.int32)
+        mask = afwImage.makeMaskFromArray(maskArray)
+
+        for dtype in (np.float32, np.float64):
+            image = afwImage.makeImageFromArray(rng.normal(10.0, 2.0, size=shape).astype(dtype))
+            image.array[5, 7] = np.nan
+            good = np.isfinite(image.array) & (maskArray == 0)
+            values = image.array[good].astype(np.float64)
+            q1, median, q3 = np.percentile(values, [25, 50, 75])
+
+            stats = afwMath.makeStatistics(image, mask, afwMath.MEDIAN, ctrl)
+            self.assertFloatsAlmostEqual(stats.getValue(afwMath.MEDIAN), median, rtol=1e-14)
+            stats = afwMath.makeStatistics(image, mask, afwMath.MEDIAN | afwMath.IQRANGE, ctrl)
+            self.assertFloatsAlmostEqual(stats.getValue(afwMath.MEDIAN), median, rtol=1e-14)
+            self.assertFloatsAlmostEqual(stats.getValue(afwMath.IQRANGE), q3 - q1, rtol=1e-12)
+
+        # integer images have many ties, which are resolved by interpolating within the tied values
+        image = afwImage.makeImageFromArray(rng.poisson(5.0, size=shape).astype(np.int32))
+        values = image.array[maskArray == 0]
+        naive = np.sort(values)[int(0.5*(values.size - 1))]
+        nBelow = np.sum(values < naive)
+        nEqual = np.sum(values == naive)
+        median = naive - 0.5 + (0.5*values.size - nBelow)/nEqual
+        for flags in (afwMath.MEDIAN, afwMath.MEDIAN | afwMath.IQRANGE):
+            stats = afwMath.makeStatistics(image, mask, flags, ctrl)
+            self.assertFloatsAlmostEqual(stats.getValue(afwMath.MEDIAN), median, rtol=1e-14)
+
+    def testMultiRegionStatistics(self):
+        """Test that statistics over many regions match per-region statistics"""
+        rng = np.random.RandomState(24680)
+        maskVal = 0x1
+        mimg = afwImage.MaskedImageF(lsst.geom.BoxI(lsst.geom.PointI(10, 20), lsst.geom.ExtentI(120, 90)))
+        mimg.image.array[:] = rng.normal(10.0, 2.0, size=mimg.image.array.shape)
+        mimg.mask.array[:] = np.where(rng.uniform(size=mimg.mask.array.shape) < 0.1, maskVal, 0)
+        mimg.variance.array[:] = 4.0
+        ctrl = afwMath.StatisticsControl()
+        ctrl.setAndMask(maskVal)
+        flags = afwMath.NPOINT | afwMath.MEAN | afwMath.MEDIAN | afwMath.MEANCLIP | afwMath.ERRORS
+
+        boxes = [lsst.geom.BoxI(lsst.geom.PointI(x, y), lsst.geom.ExtentI(w, h))
+                 for x, y, w, h in rng.randint(0, 30, size=(50, 4)) + (10, 20, 1, 1)]
+        for numThreads in (1, 0, 3):
+            ctrl.setNumThreads(numThreads)
+            results = afwMath.makeMultiRegionStatistics(mimg, boxes, flags, ctrl)
+            self.assertEqual(len(results), len(boxes))
+            self.assertEqual(results.getFlags(), flags)
+            for prop in (afwMath.NPOINT, afwMath.MEAN, afwMath.MEDIAN, afwMath.MEANCLIP):
+                expected = [afwMath.makeStatistics(mimg[box], flags, ctrl) for box in boxes]
+                np.testing.assert_array_equal(results.getValues(prop), [s.getValue(prop) for s in expected])
+                np.testing.assert_array_equal(results.getErrors(prop), [s.getError(prop) for s in expected])
+            self.assertEqual(results[3].getValue(afwMath.MEAN), expected[3].getValue(afwMath.MEAN))
+
+        spanSets = [afwGeom.SpanSet.fromShape(r, offset=(x, y))
+                    for r, x, y in rng.randint(1, 10, size=(20, 3)) + (0, 30, 40)]
+        flags = afwMath.NPOINT | afwMath.MEAN | afwMath.MAX | afwMath.ORMASK
+        for numThreads in (1, 3):
+            ctrl.setNumThreads(numThreads)
+            results = afwMath.makeMultiRegionStatistics(mimg, spanSets, flags, ctrl)
+            self.assertEqual(len(results), len(spanSets))
+            for i, spanSet in enumerate(spanSets):
+                y, x = spanSet.indices()
+                values = mimg.image.array[y - mimg.getY0(), x - mimg.getX0()]
+                masks = mimg.mask.array[y - mimg.getY0(), x - mimg.getX0()]
+                good = (masks & maskVal) == 0
+                self.assertEqual(results.getValues(afwMath.NPOINT)[i], good.sum())
+                self.assertFloatsAlmostEqual(results.getValues(afwMath.MEAN)[i], values[good].mean(),
+                                             rtol=1e-6)
+                self.assertEqual(results.getValues(afwMath.MAX)[i], values[good].max())
+                self.assertEqual(results.getOrMasks()[i], np.bitwise_or.reduce(masks[good]))
+
+        # every region must lie within the image and contain pixels
+        outside = lsst.geom.BoxI(lsst.geom.PointI(0, 0), lsst.geom.ExtentI(5, 5))
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            afwMath.makeMultiRegionStatistics(mimg, boxes + [outside], afwMath.MEAN, ctrl)
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            afwMath.makeMultiRegionStatistics(mimg, [afwGeom.SpanSet(outside)], afwMath.MEAN, ctrl)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            afwMath.makeMultiRegionStatistics(mimg, [afwGeom.SpanSet()], afwMath.MEAN, ctrl)
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            results[len(spanSets)]
+
+    def testRowColumnStatistics(self):
+        """Test that row and column statistics match those of one-row and one-column subimages"""
+        rng = np.random.RandomState(13579)
+        maskVal = 0x1
+        bbox = lsst.geom.BoxI(lsst.geom.PointI(-3, 7), lsst.geom.ExtentI(77, 45))
+        mimg = afwImage.MaskedImageF(bbox)
+        mimg.image.array[:] = rng.normal(10.0, 2.0, size=mimg.image.array.shape)
+        mimg.image.array[4, 5] = np.nan
+        mimg.mask.array[:] = np.where(rng.uniform(size=mimg.mask.array.shape) < 0.1, maskVal, 0)
+        mimg.variance.array[:] = rng.uniform(3.0, 5.0, size=mimg.variance.array.shape)
+        ctrl = afwMath.StatisticsControl()
+        ctrl.setAndMask(maskVal)
+        flags = (afwMath.NPOINT | afwMath.MEAN | afwMath.MEDIAN | afwMath.MEANCLIP | afwMath.STDEVCLIP
+                 | afwMath.ORMASK | afwMath.ERRORS)
+        rows = [lsst.geom.BoxI(lsst.geom.PointI(bbox.getMinX(), y), lsst.geom.ExtentI(bbox.getWidth(), 1))
+                for y in range(bbox.getMinY(), bbox.getEndY())]
+        columns = [lsst.geom.BoxI(lsst.geom.PointI(x, bbox.getMinY()), lsst.geom.ExtentI(1, bbox.getHeight()))
+                   for x in range(bbox.getMinX(), bbox.getEndX())]
+
+        for weighted in (False, True):
+            ctrl.setWeighted(weighted)
+            for numThreads in (1, 3):
+                ctrl.setNumThreads(numThreads)
+                for results, boxes in ((afwMath.makeRowStatistics(mimg, flags, ctrl), rows),
+                                       (afwMath.makeColumnStatistics(mimg, flags, ctrl), columns)):
+                    self.assertEqual(len(results), len(boxes))
+                    self.assertEqual(results.getFlags(), flags)
+                    expected = [afwMath.makeStatistics(mimg[box], flags, ctrl) for box in boxes]
+                    for prop in (afwMath.NPOINT, afwMath.MEAN, afwMath.MEDIAN, afwMath.MEANCLIP,
+                                 afwMath.STDEVCLIP):
+                        np.testing.assert_array_equal(results.getValues(prop),
+                                                      [s.getValue(prop) for s in expected])
+                        np.testing.assert_array_equal(results.getErrors(prop),
+                                                      [s.getError(prop) for s in expected])
+                    np.testing.assert_array_equal(results.getOrMasks(), [s.getOrMask() for s in expected])
+
+        empty = afwImage.MaskedImageF(lsst.geom.ExtentI(0, 0))
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            afwMath.makeRowStatistics(empty, afwMath.MEAN, ctrl)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            afwMath.makeColumnStatistics(empty, afwMath.MEAN, ctrl)
+
+
 class TestMemory(lsst.utils.tests.MemoryTestCase):
     pass
 
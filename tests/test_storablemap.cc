@@ -424,6 +424,35 @@ BOOST_AUTO_TEST_CASE(TestConstIteration) {
     BOOST_TEST(expected == result);
 }
 
+BOOST_AUTO_TEST_CASE(TestCopyIsIndependent) {
+    StorableMap original(*makePrefilledMap());
+    StorableMap copy(original);
+    BOOST_TEST(copy == original);
+
+    BOOST_TEST(copy.erase(KEY_SIMPLE));
+    BOOST_TEST(!copy.contains(KEY_SIMPLE.getId()));
+    BOOST_TEST(original.contains(KEY_SIMPLE));
+    BOOST_TEST(original.size() == 4);
+
+    StorableMap iterated(original);
+    for (auto& keyValue : iterated) {
+        keyValue.second = nullptr;
+    }
+    BOOST_TEST(iterated.at(KEY_COMPLEX) == nullptr);
+    BOOST_TEST(original.at(KEY_COMPLEX) == VALUE_COMPLEX);
+
+    StorableMap cleared(original);
+    cleared.clear();
+    BOOST_TEST(cleared.empty());
+    BOOST_TEST(original.size() == 4);
+    BOOST_TEST(cleared.insert(KEY_SIMPLE, VALUE_SIMPLE));
+    BOOST_TEST(StorableMap().empty());
+
+    StorableMap moved(std::move(copy));
+    BOOST_TEST(moved.size() == 3);
+    BOOST_TEST(copy.empty());
+}
+
 }  // namespace detail
 }  // namespace image
 }  // namespace afw
@@ -113,6 +113,29 @@ class TableAliasTestCase(lsst.utils.tests.TestCase):
         self.assertEqual(self.schema.find("s12").key, self.ab12)
         self.assertEqual(self.schema.find("t").key, self.ab11)
 
+    def testFindAfterChange(self):
+        """Test that finding a name again after changing the aliases uses the new aliases.
+        """
+        for _ in range(2):
+            self.assertEqual(self.schema.find("q11").key, self.a11)
+        aliases = self.schema.getAliasMap()
+        aliases.set("q", "ab")
+        self.assertEqual(self.schema.find("q11").key, self.ab11)
+        aliases.erase("q")
+        with self.assertRaises(lsst.pex.exceptions.NotFoundError):
+            self.schema.find("q11")
+        self.schema.setAliasMap(None)
+        with self.assertRaises(lsst.pex.exceptions.NotFoundError):
+            self.schema.find("t")
+        self.assertEqual(self.schema.find("a11").key, self.a11)
+
+    def testSubSchemaFind(self):
+        abx = self.schema.addField("ab_x", type=np.int32, doc="")
+        self.schema.getAliasMap().set("y", "ab")
+        for _ in range(2):
+            self.assertEqual(self.schema["y"].find("x").key, abx)
+            self.assertEqual(self.schema["ab"].find("x").key, abx)
+
     def testRecursiveAliases(self):
         """Test that multi-level alias replacement works.
         """
@@ -9,7 +9,9 @@
 
 #include <iostream>
 #include <algorithm>
+#include <cstdint>
 #include <filesystem>
+#include <string>
 
 #include "Eigen/Core"
 
@@ -22,6 +24,7 @@
 #include "lsst/afw/table/io/OutputArchive.h"
 #include "lsst/afw/table/io/InputArchive.h"
 #include "lsst/afw/table/io/CatalogVector.h"
+#include "lsst/afw/table/detail/BinaryCatalog.h"
 #include "ndarray/eigen.h"
 
 #include "lsst/afw/math/FunctionLibrary.h"
@@ -344,6 +347,41 @@ std::vector<ndarray::Vector<std::shared_ptr<Comparable>, M>> roundtripAndCompare
         outputs.back()[i] = outObj;
     }
 
+    // Round-trip and compare again, via a FITS file on disk read lazily, having closed the file the
+    // index was read from
+    outputs.push_back(ndarray::Vector<std::shared_ptr<Comparable>, M>());
+    std::filesystem::path const path =
+            std::filesystem::temp_directory_path() /
+            ("tableArchivesLazy" + std::to_string(M) + "-" + std::to_string(N) + ".fits");
+    {
+        fits::Fits outFits3(path.string(), "w", fits::Fits::AUTO_CLOSE | fits::Fits::AUTO_CHECK);
+        outArchive.writeFits(outFits3);
+    }
+    {
+        fits::Fits inFits3(path.string(), "r", fits::Fits::AUTO_CLOSE | fits::Fits::AUTO_CHECK);
+        inFits3.setHdu(fits::DEFAULT_HDU);
+        InputArchive inArchive3 = InputArchive::readFitsLazy(inFits3);
+        inFits3.closeFile();
+        for (int i = 0; i < M; ++i) {
+            std::shared_ptr<Comparable> outObj =
+                    std::dynamic_pointer_cast<Comparable>(inArchive3.get(inputIds[i]));
+            BOOST_CHECK_EQUAL(*outObj, *inputs[i]);
+            outputs.back()[i] = outObj;
+        }
+    }
+    std::filesystem::remove(path);
+
+    // Round-trip and compare again, via the binary format
+    outputs.push_back(ndarray::Vector<std::shared_ptr<Comparable>, M>());
+    std::vector<std::uint8_t> const buffer = outArchive.writeBinary();
+    InputArchive inArchive4 = InputArchive::readBinary(buffer.data(), buffer.size());
+    for (int i = 0; i < M; ++i) {
+        std::shared_ptr<Comparable> outObj =
+                std::dynamic_pointer_cast<Comparable>(inArchive4.get(inputIds[i]));
+        BOOST_CHECK_EQUAL(*outObj, *inputs[i]);
+        outputs.back()[i] = outObj;
+    }
+
     return outputs;
 }
 
@@ -463,6 +501,108 @@ BOOST_AUTO_TEST_CASE(Nested) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(Deduplicate) {
+    using namespace lsst::afw::table::io;
+
+    auto makeA = []() {
+        ndarray::Array<float, 1, 1> av = ndarray::allocate(2);
+        av[0] = 1.5;
+        av[1] = 2.5;
+        return std::make_shared<ExampleA>(3, 0.5, av);
+    };
+    std::shared_ptr<Comparable> a1 = makeA();
+    std::shared_ptr<Comparable> a2 = makeA();
+    std::shared_ptr<Comparable> c1(new ExampleC(1, a1, a2));
+    std::shared_ptr<Comparable> c2(new ExampleC(1, a2, a1));
+    std::shared_ptr<Comparable> c3(new ExampleC(2, a1, a1));
+
+    OutputArchive plain;
+    BOOST_CHECK(!plain.getDeduplicate());
+    BOOST_CHECK(plain.put(a1) != plain.put(a2));
+
+    OutputArchive archive;
+    archive.setDeduplicate(true);
+    int const idA = archive.put(a1);
+    BOOST_CHECK_EQUAL(archive.put(a2), idA);
+    int const idC = archive.put(c1);
+    BOOST_CHECK_EQUAL(idC, idA + 1);
+    BOOST_CHECK_EQUAL(archive.put(c2), idC);
+    int const idC3 = archive.put(c3);
+    BOOST_CHECK_EQUAL(idC3, idC + 1);
+    BOOST_CHECK_EQUAL(archive.getIndexCatalog().size(), 3u);
+    BOOST_REQUIRE_EQUAL(archive.countCatalogs(), 3u);
+    BOOST_CHECK_EQUAL(archive.getCatalog(1).size(), 1u);
+    BOOST_CHECK_EQUAL(archive.getCatalog(2).size(), 2u);
+
+    CatalogVector catalogs;
+    for (std::size_t n = 1; n < archive.countCatalogs(); ++n) {
+        catalogs.push_back(archive.getCatalog(n));
+    }
+    InputArchive inArchive(archive.getIndexCatalog(), catalogs);
+    std::shared_ptr<ExampleC> c4 = std::dynamic_pointer_cast<ExampleC>(inArchive.get(idC3));
+    BOOST_REQUIRE(c4);
+    BOOST_CHECK_EQUAL(*c4, *c3);
+    BOOST_CHECK_EQUAL(c4->var2, c4->var3);
+}
+
+BOOST_AUTO_TEST_CASE(BinaryCatalog) {
+    Schema schema;
+    auto idKey = schema.addField<RecordId>("id", "an ID", "");
+    auto iKey = schema.addField<std::int32_t>("i", "an int", "count");
+    auto angleKey = schema.addField<lsst::geom::Angle>("angle", "an angle", "rad");
+    auto flagKey = schema.addField<Flag>("flag", "a flag");
+    auto fixedStringKey = schema.addField<std::string>("s1", "a fixed-length string", "", 8);
+    auto stringKey = schema.addField<std::string>("s2", "a variable-length string", "", 0);
+    auto fixedArrayKey = schema.addField<Array<float>>("a1", "a fixed-length array", "", 3);
+    auto arrayKey = schema.addField<Array<double>>("a2", "a variable-length array", "", 0);
+    BaseCatalog catalog(schema);
+    for (int n = 0; n < 3; ++n) {
+        auto record = catalog.addNew();
+        record->set(idKey, 10 + n);
+        record->set(iKey, -n);
+        record->set(angleKey, 0.25 * n * lsst::geom::radians);
+        record->set(flagKey, n % 2 == 1);
+        record->set(fixedStringKey, std::string(n + 1, 'x'));
+        record->set(stringKey, std::string(10 * n, 'y'));
+        ndarray::Array<float, 1, 1> fixed = ndarray::allocate(3);
+        fixed.deep() = 1.5f * n;
+        record->set(fixedArrayKey, fixed);
+        ndarray::Array<double, 1, 1> variable = ndarray::allocate(n);
+        variable.deep() = -2.0 * n;
+        record->set(arrayKey, variable);
+    }
+
+    std::vector<std::uint8_t> buffer;
+    detail::writeBinaryCatalog(catalog, buffer);
+    std::uint8_t const *data = buffer.data();
+    BaseCatalog copy = detail::readBinaryCatalog(data, buffer.data() + buffer.size());
+    BOOST_CHECK(data == buffer.data() + buffer.size());
+    BOOST_REQUIRE(copy.getSchema() == schema);
+    BOOST_CHECK_EQUAL(copy.getSchema().find<std::string>("s2").field.getDoc(), "a variable-length string");
+    BOOST_REQUIRE_EQUAL(copy.size(), catalog.size());
+    for (std::size_t n = 0; n < catalog.size(); ++n) {
+        BOOST_CHECK_EQUAL(copy[n].get(idKey), catalog[n].get(idKey));
+        BOOST_CHECK_EQUAL(copy[n].get(iKey), catalog[n].get(iKey));
+        BOOST_CHECK_EQUAL(copy[n].get(angleKey), catalog[n].get(angleKey));
+        BOOST_CHECK_EQUAL(copy[n].get(flagKey), catalog[n].get(flagKey));
+        BOOST_CHECK_EQUAL(copy[n].get(fixedStringKey), catalog[n].get(fixedStringKey));
+        BOOST_CHECK_EQUAL(copy[n].get(stringKey), catalog[n].get(stringKey));
+        auto fixed1 = copy[n].get(fixedArrayKey);
+        auto fixed2 = catalog[n].get(fixedArrayKey);
+        BOOST_CHECK_EQUAL_COLLECTIONS(fixed1.begin(), fixed1.end(), fixed2.begin(), fixed2.end());
+        auto variable1 = copy[n].get(arrayKey);
+        auto variable2 = catalog[n].get(arrayKey);
+        BOOST_CHECK_EQUAL_COLLECTIONS(variable1.begin(), variable1.end(), variable2.begin(), variable2.end());
+    }
+
+    // Truncated buffers are errors, not crashes
+    for (std::size_t size : {std::size_t(0), std::size_t(20), buffer.size() - 1}) {
+        data = buffer.data();
+        BOOST_CHECK_THROW(detail::readBinaryCatalog(data, buffer.data() + size), MalformedArchiveError);
+    }
+    BOOST_CHECK_THROW(InputArchive::readBinary(buffer.data(), buffer.size()), MalformedArchiveError);
+}
+
 namespace {
 
 std::vector<double> makeRandomVector(int size) {
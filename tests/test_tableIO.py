@@ -25,8 +25,15 @@ import unittest
 import numpy as np
 import astropy.io.fits
 
+try:
+    import pyarrow
+except ImportError:
+    pyarrow = None
+
 import lsst.utils.tests
+import lsst.pex.exceptions
 import lsst.geom
+import lsst.afw.fits
 import lsst.afw.table
 import lsst.afw.image
 
@@ -102,6 +109,353 @@ class TableIoTestCase(lsst.utils.tests.TestCase):
             self.assertFloatsEqual(larger[bb], larger2[bb])
             self.assertFloatsEqual(larger[cc], larger2[cc])
 
+    def _makeMixedCatalog(self, nRows=37):
+        """Make a catalog with fields of most types, including flags that
+        span more than one byte.
+        """
+        schema = lsst.afw.table.Schema()
+        schema.addField("u", type="U", doc="uint16")
+        schema.addField("i", type="I", doc="int32")
+        schema.addField("l", type="L", doc="int64")
+        schema.addField("f", type="F", doc="float")
+        schema.addField("d", type="D", doc="double")
+        schema.addField("b", type="ArrayB", doc="uint8 array", size=3)
+        schema.addField("au", type="ArrayU", doc="uint16 array", size=2)
+        schema.addField("ad", type="ArrayD", doc="double array", size=4)
+        vfKey = schema.addField("vf", type="ArrayF", doc="variable-length array", size=0)
+        angleKey = schema.addField("angle", type="Angle", doc="angle")
+        stringKey = schema.addField("s", type="String", doc="string", size=8)
+        flagKeys = [schema.addField(f"flag{n}", type="Flag", doc="flag") for n in range(11)]
+        rng = np.random.RandomState(5)
+        catalog = lsst.afw.table.BaseCatalog(schema)
+        catalog.resize(nRows)
+        catalog["u"] = rng.randint(0, 1 << 16, size=nRows)
+        catalog["i"] = rng.randint(-(1 << 31), 1 << 31, size=nRows)
+        catalog["l"] = rng.randint(-(1 << 62), 1 << 62, size=nRows, dtype=np.int64)
+        catalog["f"] = rng.randn(nRows)
+        catalog["d"] = rng.randn(nRows)
+        catalog["b"] = rng.randint(0, 256, size=(nRows, 3))
+        catalog["au"] = rng.randint(0, 1 << 16, size=(nRows, 2))
+        catalog["ad"] = rng.randn(nRows, 4)
+        for record in catalog:
+            record.set(angleKey, rng.randn()*lsst.geom.radians)
+            record.set(vfKey, rng.randn(rng.randint(0, 4)).astype(np.float32))
+            record.set(stringKey, "r%d" % rng.randint(1000))
+            for flagKey in flagKeys:
+                record.set(flagKey, bool(rng.randint(2)))
+        return catalog
+
+    def _assertMixedCatalogsEqual(self, catalog, catalog2):
+        self.assertEqual(len(catalog2), len(catalog))
+        for name in ["u", "i", "l", "b", "au"]:
+            np.testing.assert_array_equal(catalog2[name], catalog[name])
+        for name in ["f", "d", "ad", "angle"]:
+            self.assertFloatsEqual(catalog2[name], catalog[name])
+        for name in [f"flag{n}" for n in range(11)]:
+            np.testing.assert_array_equal(catalog2[name], catalog[name])
+        vfKey = catalog.schema["vf"].asKey()
+        stringKey = catalog.schema["s"].asKey()
+        for record, record2 in zip(catalog, catalog2):
+            self.assertFloatsEqual(record2.get(vfKey), record.get(vfKey))
+            self.assertEqual(record2.get(stringKey), record.get(stringKey))
+
+    def testChunkedRead(self):
+        """Test that decoding rows a chunk at a time, on several threads,
+        reads the same values as CFITSIO.
+        """
+        catalog = self._makeMixedCatalog()
+        recordSize = catalog.schema.getRecordSize()
+        oldChunkBytes = lsst.afw.table.io.getReadChunkBytes()
+        oldThreads = lsst.afw.table.io.getReadThreads()
+        try:
+            with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+                catalog.writeFits(tmpFile)
+                # Chunks of one row, a few rows and every row
+                for chunkBytes, nThreads in [(1, 1), (2*recordSize, 3), (oldChunkBytes, 0)]:
+                    lsst.afw.table.io.setReadChunkBytes(chunkBytes)
+                    lsst.afw.table.io.setReadThreads(nThreads)
+                    self._assertMixedCatalogsEqual(catalog, lsst.afw.table.BaseCatalog.readFits(tmpFile))
+                lsst.afw.table.io.setReadThreads(-1)
+                with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+                    lsst.afw.table.BaseCatalog.readFits(tmpFile)
+        finally:
+            lsst.afw.table.io.setReadChunkBytes(oldChunkBytes)
+            lsst.afw.table.io.setReadThreads(oldThreads)
+
+    def testMappedRead(self):
+        """Test that reading by mapping rows into memory gives the same
+        values as reading them, and falls back to reading them when the
+        rows are not laid out as records.
+        """
+        schema = lsst.afw.table.Schema()
+        schema.addField("l", type="L", doc="int64")
+        schema.addField("d", type="D", doc="double")
+        angleKey = schema.addField("angle", type="Angle", doc="angle")
+        schema.addField("f", type="F", doc="float")
+        schema.addField("i", type="I", doc="int32")
+        schema.addField("au", type="ArrayU", doc="uint16 array", size=4)
+        schema.addField("u", type="U", doc="uint16")
+        schema.addField("b", type="ArrayB", doc="uint8 array", size=6)
+        self.assertEqual(schema.getRecordSize(), 48)
+        nRows = 29
+        rng = np.random.RandomState(7)
+        catalog = lsst.afw.table.BaseCatalog(schema)
+        catalog.resize(nRows)
+        catalog["l"] = rng.randint(-(1 << 62), 1 << 62, size=nRows, dtype=np.int64)
+        catalog["d"] = rng.randn(nRows)
+        catalog["f"] = rng.randn(nRows)
+        catalog["i"] = rng.randint(-(1 << 31), 1 << 31, size=nRows)
+        catalog["au"] = rng.randint(0, 1 << 16, size=(nRows, 4))
+        catalog["u"] = rng.randint(0, 1 << 16, size=nRows)
+        catalog["b"] = rng.randint(0, 256, size=(nRows, 6))
+        for record in catalog:
+            record.set(angleKey, rng.randn()*lsst.geom.radians)
+        oldMapRows = lsst.afw.table.io.getMapRows()
+        try:
+            lsst.afw.table.io.setMapRows(True)
+            with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+                catalog.writeFits(tmpFile)
+                catalog2 = lsst.afw.table.BaseCatalog.readFits(tmpFile)
+                self.assertTrue(catalog2.isContiguous())
+                for name in ["l", "i", "au", "u", "b"]:
+                    np.testing.assert_array_equal(catalog2[name], catalog[name])
+                for name in ["d", "angle", "f"]:
+                    self.assertFloatsEqual(catalog2[name], catalog[name])
+                # Changing the records does not change the file
+                catalog2["d"] = 0.0
+                self.assertFloatsEqual(lsst.afw.table.BaseCatalog.readFits(tmpFile)["d"], catalog["d"])
+                # Rows that are not laid out as records are read instead
+                mixed = self._makeMixedCatalog()
+                mixed.writeFits(tmpFile)
+                self._assertMixedCatalogsEqual(mixed, lsst.afw.table.BaseCatalog.readFits(tmpFile))
+            # As are rows of files in memory
+            manager = lsst.afw.fits.MemFileManager()
+            catalog.writeFits(manager)
+            catalog3 = lsst.afw.table.BaseCatalog.readFits(manager)
+            np.testing.assert_array_equal(catalog3["l"], catalog["l"])
+        finally:
+            lsst.afw.table.io.setMapRows(oldMapRows)
+
+    def testChunkedWrite(self):
+        """Test that encoding rows a chunk at a time, on several threads,
+        writes the same values as CFITSIO.
+        """
+        catalog = self._makeMixedCatalog()
+        recordSize = catalog.schema.getRecordSize()
+        oldChunkBytes = lsst.afw.table.io.getWriteChunkBytes()
+        oldThreads = lsst.afw.table.io.getWriteThreads()
+        try:
+            for chunkBytes, nThreads in [(1, 1), (2*recordSize, 3), (oldChunkBytes, 0)]:
+                lsst.afw.table.io.setWriteChunkBytes(chunkBytes)
+                lsst.afw.table.io.setWriteThreads(nThreads)
+                with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+                    catalog.writeFits(tmpFile)
+                    self._assertMixedCatalogsEqual(catalog, lsst.afw.table.BaseCatalog.readFits(tmpFile))
+                    # Check the encoding independently of afw's reader
+                    with astropy.io.fits.open(tmpFile) as inFits:
+                        data = inFits[1].data
+                        for name in ["u", "i", "l", "b", "au"]:
+                            np.testing.assert_array_equal(data[name], catalog[name])
+                        self.assertFloatsEqual(data["d"], catalog["d"])
+                        self.assertFloatsEqual(data["angle"], catalog["angle"])
+                        flags = np.array([catalog[f"flag{n}"] for n in range(11)]).transpose()
+                        np.testing.assert_array_equal(data["flags"], flags)
+            lsst.afw.table.io.setWriteThreads(-1)
+            with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+                with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+                    catalog.writeFits(tmpFile)
+        finally:
+            lsst.afw.table.io.setWriteChunkBytes(oldChunkBytes)
+            lsst.afw.table.io.setWriteThreads(oldThreads)
+
+    def testCompressedTable(self):
+        """Test writing catalogs as tile-compressed tables, and reading them
+        back on one or several threads.
+        """
+        mixed = self._makeMixedCatalog(nRows=53)
+        # Without variable-length arrays, tiles can be decompressed concurrently.
+        schema = lsst.afw.table.Schema()
+        for name, type in [("u", "U"), ("i", "I"), ("l", "L"), ("f", "F"), ("d", "D")]:
+            schema.addField(name, type=type, doc=name)
+        schema.addField("s", type="String", doc="string", size=8)
+        fixed = lsst.afw.table.BaseCatalog(schema)
+        fixed.resize(len(mixed))
+        for name in ["u", "i", "l", "f", "d"]:
+            fixed[name] = mixed[name]
+        for record, mixedRecord in zip(fixed, mixed):
+            record["s"] = mixedRecord["s"]
+        Options = lsst.afw.fits.TableCompressionOptions
+        Algorithm = lsst.afw.fits.ImageCompressionOptions
+        oldThreads = lsst.afw.table.io.getReadThreads()
+        try:
+            for algorithm in [Algorithm.GZIP, Algorithm.GZIP_SHUFFLE, Algorithm.RICE]:
+                for catalog in [mixed, fixed]:
+                    with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+                        with lsst.afw.fits.Fits(tmpFile, "w") as fits:
+                            fits.setTableCompression(Options(algorithm, 10))
+                            self.assertEqual(fits.getTableCompression().rows, 10)
+                            catalog.writeFits(fits)
+                        with lsst.afw.fits.Fits(tmpFile, "r") as fits:
+                            fits.setHdu(1)
+                            self.assertTrue(fits.isCompressedTable())
+                        with astropy.io.fits.open(tmpFile) as inFits:
+                            self.assertTrue(inFits[1].header["ZTABLE"])
+                            self.assertEqual(inFits[1].header["ZTILELEN"], 10)
+                            self.assertEqual(inFits[1].header["ZNAXIS2"], len(catalog))
+                            self.assertEqual(inFits[1].header["NAXIS2"], 6)
+                        for nThreads in [1, 3]:
+                            lsst.afw.table.io.setReadThreads(nThreads)
+                            catalog2 = lsst.afw.table.BaseCatalog.readFits(tmpFile)
+                            self.assertEqual(len(catalog2), len(catalog))
+                            for name in ["u", "i", "l"]:
+                                np.testing.assert_array_equal(catalog2[name], catalog[name])
+                            for name in ["f", "d"]:
+                                self.assertFloatsEqual(catalog2[name], catalog[name])
+                            self.assertEqual([r["s"] for r in catalog2], [r["s"] for r in catalog])
+                    if catalog is mixed:
+                        with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+                            with lsst.afw.fits.Fits(tmpFile, "w") as fits:
+                                fits.setTableCompression(Options(algorithm))
+                                catalog.writeFits(fits)
+                            self._assertMixedCatalogsEqual(catalog,
+                                                           lsst.afw.table.BaseCatalog.readFits(tmpFile))
+            # Catalogs that are not compressed are read as before.
+            with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+                with lsst.afw.fits.Fits(tmpFile, "w") as fits:
+                    self.assertEqual(fits.getTableCompression().algorithm, Algorithm.NONE)
+                    fixed.writeFits(fits)
+                with lsst.afw.fits.Fits(tmpFile, "r") as fits:
+                    fits.setHdu(1)
+                    self.assertFalse(fits.isCompressedTable())
+            manager = lsst.afw.fits.MemFileManager()
+            with lsst.afw.fits.Fits(manager, "w") as fits:
+                with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+                    fits.setTableCompression(Options(Algorithm.PLIO))
+                    fixed.writeFits(fits)
+        finally:
+            lsst.afw.table.io.setReadThreads(oldThreads)
+
+    def testColumnSelection(self):
+        """Test reading only some of the columns of a catalog.
+        """
+        catalog = self._makeMixedCatalog()
+        catalog.schema.getAliasMap().set("dd", "d")
+        with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+            catalog.writeFits(tmpFile)
+            columns = ["i", "dd", "s", "flag3", "flag9"]
+            catalog2 = lsst.afw.table.BaseCatalog.readFits(tmpFile, columns=columns)
+            self.assertEqual(catalog2.schema.getNames(), {"i", "d", "s", "flag3", "flag9"})
+            self.assertEqual(len(catalog2), len(catalog))
+            np.testing.assert_array_equal(catalog2["i"], catalog["i"])
+            self.assertFloatsEqual(catalog2["d"], catalog["d"])
+            for name in ["flag3", "flag9"]:
+                np.testing.assert_array_equal(catalog2[name], catalog[name])
+            for record, record2 in zip(catalog, catalog2):
+                self.assertEqual(record2["s"], record["s"])
+            # An empty selection reads everything.
+            self._assertMixedCatalogsEqual(catalog,
+                                           lsst.afw.table.BaseCatalog.readFits(tmpFile, columns=[]))
+            with self.assertRaises(lsst.pex.exceptions.NotFoundError):
+                lsst.afw.table.BaseCatalog.readFits(tmpFile, columns=["i", "nonexistent"])
+
+    def testSourceColumnSelection(self):
+        """Test that reading some of the columns of a SourceCatalog keeps
+        its minimal schema.
+        """
+        schema = lsst.afw.table.SourceTable.makeMinimalSchema()
+        aKey = schema.addField("a", type=np.float64, doc="a")
+        schema.addField("b", type=np.float64, doc="b")
+        catalog = lsst.afw.table.SourceCatalog(schema)
+        for n in range(5):
+            record = catalog.addNew()
+            record.set(aKey, 0.5*n)
+            record.setCoord(lsst.geom.SpherePoint(n, 2*n, lsst.geom.degrees))
+        with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+            catalog.writeFits(tmpFile)
+            catalog2 = lsst.afw.table.SourceCatalog.readFits(tmpFile, columns=["a"])
+            minimalNames = lsst.afw.table.SourceTable.makeMinimalSchema().getNames()
+            self.assertEqual(catalog2.schema.getNames(), minimalNames | {"a"})
+            np.testing.assert_array_equal(catalog2["id"], catalog["id"])
+            self.assertFloatsEqual(catalog2["a"], catalog["a"])
+            self.assertFloatsEqual(catalog2["coord_ra"], catalog["coord_ra"])
+
+    def testRowFilter(self):
+        """Test reading a range of rows, and the rows that pass a comparison.
+        """
+        catalog = self._makeMixedCatalog()
+        FitsRowFilter = lsst.afw.table.io.FitsRowFilter
+        oldChunkBytes = lsst.afw.table.io.getReadChunkBytes()
+        try:
+            with lsst.utils.tests.getTempFilePath(".fits") as tmpFile:
+                catalog.writeFits(tmpFile)
+                self._assertMixedCatalogsEqual(
+                    catalog[5:20], lsst.afw.table.BaseCatalog.readFits(tmpFile, rows=FitsRowFilter(5, 20)))
+                # Row ranges are clipped to the table.
+                self._assertMixedCatalogsEqual(
+                    catalog[30:], lsst.afw.table.BaseCatalog.readFits(tmpFile, rows=FitsRowFilter(30, 100)))
+                self.assertEqual(len(lsst.afw.table.BaseCatalog.readFits(tmpFile,
+                                                                          rows=FitsRowFilter(50))), 0)
+                # Comparisons are evaluated a chunk of rows at a time.
+                lsst.afw.table.io.setReadChunkBytes(3*catalog.schema.getRecordSize())
+                for comparison, selected in [("<", catalog["d"] < 0.25),
+                                             (">=", catalog["d"] >= 0.25)]:
+                    catalog2 = lsst.afw.table.BaseCatalog.readFits(
+                        tmpFile, rows=FitsRowFilter("d", comparison, 0.25))
+                    self._assertMixedCatalogsEqual(catalog[selected].copy(deep=True), catalog2)
+                # Flags compare as 0 or 1, and a row range restricts the rows compared.
+                selected = np.zeros(len(catalog), dtype=bool)
+                selected[10:30] = catalog["flag4"][10:30]
+                catalog2 = lsst.afw.table.BaseCatalog.readFits(
+                    tmpFile, columns=["i"], rows=FitsRowFilter("flag4", "==", 1, 10, 30))
+                self.assertEqual(catalog2.schema.getNames(), {"i", "flag4"})
+                np.testing.assert_array_equal(catalog2["i"], catalog["i"][selected])
+                with self.assertRaises(lsst.pex.exceptions.NotFoundError):
+                    lsst.afw.table.BaseCatalog.readFits(tmpFile, rows=FitsRowFilter("x", "==", 0))
+                with self.assertRaises(lsst.pex.exceptions.TypeError):
+                    lsst.afw.table.BaseCatalog.readFits(tmpFile, rows=FitsRowFilter("s", "==", 0))
+        finally:
+            lsst.afw.table.io.setReadChunkBytes(oldChunkBytes)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            FitsRowFilter("d", "=~", 0)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            FitsRowFilter(5, 4)
+
+    @unittest.skipIf(pyarrow is None, "pyarrow is not available")
+    def testArrow(self):
+        """Test converting catalogs to and from Arrow, and Parquet I/O.
+        """
+        catalog = self._makeMixedCatalog()
+        catalog.schema.getAliasMap().set("dd", "d")
+        batch = catalog.asArrow()
+        self.assertEqual(batch.num_rows, len(catalog))
+        self.assertEqual(batch.schema.field("flag3").type, pyarrow.bool_())
+        np.testing.assert_array_equal(batch.column("flag3").to_numpy(zero_copy_only=False),
+                                      catalog["flag3"])
+        np.testing.assert_array_equal(batch.column("i").to_numpy(), catalog["i"])
+        catalog2 = lsst.afw.table.BaseCatalog.fromArrow(batch)
+        self.assertEqual(catalog2.schema, catalog.schema)
+        self._assertMixedCatalogsEqual(catalog, catalog2)
+        # Non-contiguous catalogs are copied first.
+        subset = catalog[::2]
+        self._assertMixedCatalogsEqual(subset.copy(deep=True),
+                                       lsst.afw.table.BaseCatalog.fromArrow(subset.asArrow()))
+        # Tables from elsewhere have their field types inferred.
+        table = pyarrow.table({"a": np.arange(3, dtype=np.int32), "b": [True, False, True],
+                               "c": ["x", "yy", "zzz"]})
+        catalog3 = lsst.afw.table.BaseCatalog.fromArrow(table)
+        self.assertEqual(catalog3.schema["a"].asKey().getTypeString(), "I")
+        np.testing.assert_array_equal(catalog3["a"], [0, 1, 2])
+        np.testing.assert_array_equal(catalog3["b"], [True, False, True])
+        self.assertEqual([record["c"] for record in catalog3], ["x", "yy", "zzz"])
+        with self.assertRaises(TypeError):
+            lsst.afw.table.BaseCatalog.fromArrow(pyarrow.table({"a": pyarrow.array([1], pyarrow.int8())}))
+        with lsst.utils.tests.getTempFilePath(".parq") as tmpFile:
+            catalog.writeParquet(tmpFile)
+            self._assertMixedCatalogsEqual(catalog, lsst.afw.table.BaseCatalog.readParquet(tmpFile))
+            catalog4 = lsst.afw.table.BaseCatalog.readParquet(tmpFile, columns=["i", "d"])
+            self.assertEqual(catalog4.schema.getNames(), {"i", "d"})
+            np.testing.assert_array_equal(catalog4["i"], catalog["i"])
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
@@ -0,0 +1,109 @@
+/*
+ * This file is part of afw.
+ *
+ * Developed for the LSST Data Management System.
+ * This product includes software developed by the LSST Project
+ * (https://www.lsst.org).
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ThreadLocalBlockCpp
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-variable"
+#include "boost/test/unit_test.hpp"
+#pragma clang diagnostic pop
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "lsst/afw/table/IdFactory.h"
+#include "lsst/afw/table/Source.h"
+
+/*
+ * Tests for creating records of one table from several threads.
+ */
+namespace lsst {
+namespace afw {
+namespace table {
+
+namespace {
+
+int const N_THREADS = 4;
+int const N_RECORDS = 1000;  // per thread
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(ConcurrentIds) {
+    for (auto const &factory : {IdFactory::makeSimple(), IdFactory::makeSource(3, 32)}) {
+        std::vector<std::vector<RecordId>> ids(N_THREADS);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < N_THREADS; ++i) {
+            threads.emplace_back([&factory, &ids, i]() {
+                for (int j = 0; j < N_RECORDS; ++j) ids[i].push_back((*factory)());
+            });
+        }
+        for (auto &thread : threads) thread.join();
+        std::vector<RecordId> all;
+        for (auto const &part : ids) all.insert(all.end(), part.begin(), part.end());
+        std::sort(all.begin(), all.end());
+        BOOST_CHECK(std::adjacent_find(all.begin(), all.end()) == all.end());
+        BOOST_CHECK_EQUAL(all.size(), std::size_t(N_THREADS * N_RECORDS));
+        BOOST_CHECK_EQUAL((*factory)(), all.back() + 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentRecords) {
+    Schema schema = SourceTable::makeMinimalSchema();
+    Key<double> valueKey = schema.addField<double>("value", "thread-dependent value");
+    auto table = SourceTable::make(schema, IdFactory::makeSimple());
+    std::vector<SourceCatalog> parts(N_THREADS, SourceCatalog(table));
+    std::vector<std::thread> threads;
+    for (int i = 0; i < N_THREADS; ++i) {
+        threads.emplace_back([&table, &parts, valueKey, i]() {
+            BaseTable::ThreadLocalBlock block(*table, N_RECORDS);
+            for (int j = 0; j < N_RECORDS; ++j) {
+                std::shared_ptr<SourceRecord> record = table->makeRecord();
+                record->set(valueKey, i);
+                parts[i].push_back(record);
+            }
+        });
+    }
+    for (auto &thread : threads) thread.join();
+    for (auto const &part : parts) {
+        BOOST_CHECK(part.isContiguous());
+    }
+
+    SourceCatalog merged(table);
+    merged.reserve(N_THREADS * N_RECORDS);
+    for (auto const &part : parts) merged.insert(merged.end(), part.begin(), part.end(), true);
+    merged.sort();
+    BOOST_CHECK(merged.isContiguous());
+    BOOST_REQUIRE_EQUAL(merged.size(), std::size_t(N_THREADS * N_RECORDS));
+    for (std::size_t i = 0; i < merged.size(); ++i) {
+        BOOST_CHECK_EQUAL(merged[i].getId(), RecordId(i + 1));
+    }
+    // records made after the threads finish come from the table's own block again
+    BOOST_CHECK_GT(table->makeRecord()->getId(), RecordId(N_THREADS * N_RECORDS));
+}
+
+}  // namespace table
+}  // namespace afw
+}  // namespace lsst
@@ -0,0 +1,90 @@
+# This file is part of afw.
+#
+# Developed for the LSST Data Management System.
+# This product includes software developed by the LSST Project
+# (https://www.lsst.org).
+# See the COPYRIGHT file at the top-level directory of this distribution
+# for details of code ownership.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+"""Tests for afw calls made concurrently from several Python threads.
+"""
+
+from concurrent.futures import ThreadPoolExecutor
+import unittest
+
+import numpy as np
+
+import lsst.utils.tests
+import lsst.geom
+import lsst.afw.detection as afwDetection
+import lsst.afw.image as afwImage
+import lsst.afw.math as afwMath
+
+
+class ThreadedCallsTestCase(lsst.utils.tests.TestCase):
+
+    def setUp(self):
+        rng = np.random.RandomState(3)
+        self.images = []
+        for i in range(6):
+            image = afwImage.MaskedImageF(lsst.geom.Extent2I(64, 48))
+            image.image.array[:, :] = rng.randn(48, 64) + i
+            image.variance.array[:, :] = 1.0
+            self.images.append(image)
+        self.kernel = afwMath.AnalyticKernel(5, 5, afwMath.GaussianFunction2D(1.2, 1.2))
+
+    def process(self, image):
+        convolved = afwImage.MaskedImageF(image.getDimensions())
+        afwMath.convolve(convolved, image, self.kernel, afwMath.ConvolutionControl())
+        mean = afwMath.makeStatistics(convolved, afwMath.MEAN).getValue()
+        footprints = afwDetection.FootprintSet(convolved, afwDetection.Threshold(2.0))
+        return convolved, mean, len(footprints.getFootprints())
+
+    def testMatchesSerial(self):
+        """Test that calls releasing the GIL give the same results from a thread pool.
+        """
+        serial = [self.process(image) for image in self.images]
+        with ThreadPoolExecutor(max_workers=3) as pool:
+            threaded = list(pool.map(self.process, self.images))
+        for (serialImage, serialMean, serialCount), (image, mean, count) in zip(serial, threaded):
+            self.assertMaskedImagesEqual(image, serialImage)
+            self.assertEqual(mean, serialMean)
+            self.assertEqual(count, serialCount)
+
+    def testReaders(self):
+        with lsst.utils.tests.getTempFilePath(".fits") as filename:
+            self.images[0].writeFits(filename)
+
+            def read(_):
+                return afwImage.MaskedImageFitsReader(filename).read()
+
+            with ThreadPoolExecutor(max_workers=3) as pool:
+                for image in pool.map(read, range(4)):
+                    self.assertMaskedImagesEqual(image, self.images[0])
+
+
+class TestMemory(lsst.utils.tests.MemoryTestCase):
+    pass
+
+
+def setup_module(module):
+    lsst.utils.tests.init()
+
+
+if __name__ == "__main__":
+    lsst.utils.tests.init()
+    unittest.main()
@@ -22,6 +22,8 @@
 
 import unittest
 
+import numpy as np
+
 import lsst.geom
 import lsst.afw.table as afwTable
 import lsst.utils.tests
@@ -152,6 +154,58 @@ class MatchXyTest(unittest.TestCase):
             # produces s1,s2 and s2,s1.
             self.assertEqual(len(matches), 2 if symmetric else 1)
 
+    def testMatchXyBruteForce(self):
+        """Test that matching with any number of threads finds the same
+        matches as comparing every pair of sources.
+        """
+        rng = np.random.RandomState(5)
+        centroidKey = afwTable.Point2DKey(self.schema["cen"])
+        cat1 = afwTable.SourceCatalog(self.table)
+        cat2 = afwTable.SourceCatalog(self.table)
+        for i, (x, y) in enumerate(rng.uniform(0.0, 50.0, size=(300, 2))):
+            record = cat1.addNew()
+            record.setId(i + 1)
+            record.set(centroidKey, lsst.geom.Point2D(x, y))
+        for i, (x, y) in enumerate(rng.uniform(0.0, 50.0, size=(200, 2))):
+            record = cat2.addNew()
+            record.setId(i + 1001)
+            record.set(centroidKey, lsst.geom.Point2D(x, y))
+        radius = 1.5
+
+        def distance(r1, r2):
+            return np.hypot(r1.getX() - r2.getX(), r1.getY() - r2.getY())
+
+        expected = sorted((r1.getId(), r2.getId()) for r1 in cat1 for r2 in cat2
+                          if distance(r1, r2) < radius)
+        expectedSelf = sorted((r1.getId(), r2.getId()) for r1 in cat1 for r2 in cat1
+                              if r1.getId() < r2.getId() and distance(r1, r2) < radius)
+        for numThreads in (1, 4):
+            mc = afwTable.MatchControl()
+            mc.findOnlyClosest = False
+            mc.numThreads = numThreads
+            matches = afwTable.matchXy(cat1, cat2, radius, mc)
+            self.assertEqual(sorted((m.first.getId(), m.second.getId()) for m in matches), expected)
+            for m in matches:
+                self.assertAlmostEqual(m.distance, distance(m.first, m.second))
+            self.assertEqual([m.first.getId() for m in matches],
+                             sorted(m.first.getId() for m in matches))
+
+            mc.findOnlyClosest = True
+            mc.includeMismatches = True
+            matches = afwTable.matchXy(cat1, cat2, radius, mc)
+            self.assertEqual([m.first.getId() for m in matches], [r.getId() for r in cat1])
+            for m, r1 in zip(matches, cat1):
+                candidates = [r2 for r2 in cat2 if distance(r1, r2) < radius]
+                if candidates:
+                    self.assertAlmostEqual(m.distance, min(distance(r1, r2) for r2 in candidates))
+                else:
+                    self.assertIsNone(m.second)
+
+            mc = afwTable.MatchControl()
+            mc.numThreads = numThreads
+            matches = afwTable.matchXy(cat1, radius, mc)
+            self.assertEqual(sorted((m.first.getId(), m.second.getId()) for m in matches), expectedSelf)
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
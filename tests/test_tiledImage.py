@@ -0,0 +1,219 @@
+# This file is part of afw.
+#
+# Developed for the LSST Data Management System.
+# This product includes software developed by the LSST Project
+# (https://www.lsst.org).
+# See the COPYRIGHT file at the top-level directory of this distribution
+# for details of code ownership.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+"""
+Tests for TiledImage
+
+Run with:
+   python test_tiledImage.py
+or
+   pytest test_tiledImage.py
+"""
+
+import os
+import tempfile
+import threading
+import unittest
+
+import numpy as np
+
+import lsst.utils.tests
+import lsst.pex.exceptions
+import lsst.geom
+import lsst.afw.image as afwImage
+import lsst.afw.math as afwMath
+
+
+class TiledImageTestCase(lsst.utils.tests.TestCase):
+    """A test case for TiledImage"""
+
+    def setUp(self):
+        np.random.seed(1)
+        self.bbox = lsst.geom.Box2I(lsst.geom.Point2I(10, 20), lsst.geom.Extent2I(70, 50))
+        self.whole = afwImage.ImageF(self.bbox)
+        self.whole.array[:, :] = np.random.normal(size=self.whole.array.shape)
+        # a 3 x 2 grid of tiles, leaving a gap at the top right, plus one overlapping the others
+        self.tileBoxes = []
+        for y0 in (20, 45):
+            for x0 in (10, 35, 60):
+                box = lsst.geom.Box2I(lsst.geom.Point2I(x0, y0), lsst.geom.Extent2I(25, 25))
+                box.clip(self.bbox)
+                self.tileBoxes.append(box)
+        self.tileBoxes[-1].clip(lsst.geom.Box2I(lsst.geom.Point2I(60, 45), lsst.geom.Extent2I(10, 10)))
+        self.tileBoxes.append(lsst.geom.Box2I(lsst.geom.Point2I(30, 30), lsst.geom.Extent2I(10, 10)))
+        self.padValue = -5.0
+        self.tiles = []
+        for i, box in enumerate(self.tileBoxes):
+            tile = afwImage.ImageF(box)
+            tile.array[:, :] = self.whole.subset(box).array + 100*i
+            self.tiles.append(tile)
+        # expected pixels: later tiles take precedence, uncovered pixels are padded
+        self.expected = afwImage.ImageF(self.bbox)
+        self.expected.set(self.padValue)
+        for box, tile in zip(self.tileBoxes, self.tiles):
+            self.expected.subset(box).assign(tile)
+
+    def tearDown(self):
+        del self.whole
+        del self.tiles
+        del self.expected
+
+    def makeTiledImage(self, cacheCapacity=4):
+        return afwImage.TiledImageF(self.bbox, self.tileBoxes, lambda i: self.tiles[i],
+                                    cacheCapacity, self.padValue)
+
+    def testRead(self):
+        tiled = self.makeTiledImage()
+        self.assertEqual(tiled.getBBox(), self.bbox)
+        self.assertEqual(tiled.getTileCount(), len(self.tileBoxes))
+        self.assertEqual(tiled.getTileBBox(2), self.tileBoxes[2])
+        self.assertEqual(tiled.getPadValue(), self.padValue)
+        self.assertEqual(tiled.getTileLoadCount(), 0)
+        image = tiled.read()
+        self.assertEqual(image.getBBox(), self.bbox)
+        self.assertImagesEqual(image, self.expected)
+
+        region = lsst.geom.Box2I(lsst.geom.Point2I(28, 40), lsst.geom.Extent2I(40, 12))
+        self.assertImagesEqual(tiled.read(region), self.expected.subset(region))
+        local = lsst.geom.Box2I(region)
+        local.shift(-lsst.geom.Extent2I(self.bbox.getMin()))
+        self.assertImagesEqual(tiled.read(local, afwImage.LOCAL), self.expected.subset(region))
+
+        for point in (lsst.geom.Point2I(10, 20), lsst.geom.Point2I(35, 35), lsst.geom.Point2I(75, 65),
+                      lsst.geom.Point2I(62, 47)):
+            self.assertEqual(tiled.get(point), self.expected[point])
+        self.assertEqual(tiled.get(lsst.geom.Point2I(0, 0), afwImage.LOCAL), self.expected[10, 20])
+
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            tiled.get(lsst.geom.Point2I(9, 20))
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            tiled.read(lsst.geom.Box2I(lsst.geom.Point2I(0, 0), lsst.geom.Extent2I(20, 30)))
+
+    def testView(self):
+        tiled = self.makeTiledImage()
+        region = lsst.geom.Box2I(lsst.geom.Point2I(20, 25), lsst.geom.Extent2I(30, 30))
+        view = afwImage.TiledImageF(tiled, region)
+        self.assertEqual(view.getBBox(), region)
+        self.assertEqual(view.getXY0(), region.getMin())
+        self.assertEqual(tiled.getTileLoadCount(), 0)
+        self.assertImagesEqual(view.read(), self.expected.subset(region))
+        # views share their parent's cache
+        self.assertEqual(view.getTileLoadCount(), tiled.getTileLoadCount())
+
+        inner = lsst.geom.Box2I(lsst.geom.Point2I(5, 5), lsst.geom.Extent2I(10, 10))
+        viewOfView = afwImage.TiledImageF(view, inner, afwImage.LOCAL)
+        self.assertEqual(viewOfView.getXY0(), lsst.geom.Point2I(25, 30))
+        self.assertImagesEqual(viewOfView.read(), self.expected[25:35, 30:40])
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            afwImage.TiledImageF(view, self.bbox)
+
+    def testCache(self):
+        loads = []
+
+        def loader(i):
+            loads.append(i)
+            return self.tiles[i]
+
+        tiled = afwImage.TiledImageF(self.bbox, self.tileBoxes, loader, 1, self.padValue)
+        self.assertEqual(tiled.getCacheCapacity(), 1)
+        point = lsst.geom.Point2I(12, 22)
+        for _ in range(3):
+            tiled.get(point)
+        self.assertEqual(loads, [0])
+        tiled.get(lsst.geom.Point2I(37, 22))
+        tiled.get(point)
+        self.assertEqual(loads, [0, 1, 0])
+        self.assertEqual(tiled.getTileLoadCount(), 3)
+
+        tiled.setCacheCapacity(len(self.tileBoxes))
+        tiled.read()
+        tiled.read()
+        self.assertEqual(tiled.getTileLoadCount(), 3 + len(self.tileBoxes))
+
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            tiled.setCacheCapacity(0)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            afwImage.TiledImageF(self.bbox, self.tileBoxes, loader, 0)
+
+    def testBadTile(self):
+        tiled = afwImage.TiledImageF(self.bbox, self.tileBoxes, lambda i: self.tiles[0])
+        with self.assertRaises(lsst.pex.exceptions.RuntimeError):
+            tiled.get(lsst.geom.Point2I(37, 22))
+
+    def testForEachBlock(self):
+        """Convolving block by block with a halo must match convolving the whole image."""
+        tiled = self.makeTiledImage()
+        kernel = afwMath.AnalyticKernel(5, 5, afwMath.GaussianFunction2D(1.5, 1.5))
+        halo = 2
+        reference = afwImage.ImageF(self.bbox)
+        afwMath.convolve(reference, self.expected, kernel, afwMath.ConvolutionControl())
+        interior = lsst.geom.Box2I(self.bbox)
+        interior.grow(-halo)
+
+        for numThreads in (1, 3):
+            result = afwImage.ImageF(self.bbox)
+            cores = []
+            lock = threading.Lock()
+
+            def func(block, core):
+                convolved = afwImage.ImageF(block.getBBox())
+                afwMath.convolve(convolved, block, kernel, afwMath.ConvolutionControl())
+                with lock:
+                    cores.append(core)
+                    result.subset(core).assign(convolved.subset(core))
+
+            tiled.forEachBlock(lsst.geom.Extent2I(16, 12), halo, func, numThreads)
+            self.assertEqual(len(cores), 5*5)
+            self.assertEqual(sum(core.getArea() for core in cores), self.bbox.getArea())
+            self.assertImagesAlmostEqual(result.subset(interior), reference.subset(interior))
+
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            tiled.forEachBlock(lsst.geom.Extent2I(0, 12), halo, func)
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            tiled.forEachBlock(lsst.geom.Extent2I(16, 12), -1, func)
+
+    def testReadFits(self):
+        with tempfile.TemporaryDirectory() as tempDir:
+            fileNames = []
+            for i, tile in enumerate(self.tiles):
+                fileName = os.path.join(tempDir, f"tile{i}.fits")
+                tile.writeFits(fileName)
+                fileNames.append(fileName)
+            tiled = afwImage.TiledImageF.readFits(fileNames, cacheCapacity=2, padValue=self.padValue)
+            self.assertEqual(tiled.getBBox(), self.bbox)
+            self.assertEqual(tiled.getTileLoadCount(), 0)
+            self.assertImagesEqual(tiled.read(), self.expected)
+            self.assertEqual(tiled.getTileLoadCount(), len(self.tiles))
+            stats = afwMath.makeStatistics(tiled.read(), afwMath.MEAN)
+            self.assertAlmostEqual(stats.getValue(afwMath.MEAN), np.mean(self.expected.array), places=5)
+
+
+class TestMemory(lsst.utils.tests.MemoryTestCase):
+    pass
+
+
+def setup_module(module):
+    lsst.utils.tests.init()
+
+
+if __name__ == "__main__":
+    lsst.utils.tests.init()
+    unittest.main()
@@ -26,6 +26,7 @@ import astshim as ast
 from astshim.test import makeForwardPolyMap
 
 import lsst.utils.tests
+import lsst.pex.exceptions
 import lsst.afw.geom as afwGeom
 from lsst.afw.geom.testUtils import TransformTestBaseClass
 
@@ -90,6 +91,27 @@ class TransformTestCase(TransformTestBaseClass):
         assert_allclose(merged1.applyForward(inPoint),
                         merged2.applyForward(inPoint))
 
+    def testApplyThreaded(self):
+        """Test that splitting a large array of points across threads gives
+        the same result as transforming it in one call
+        """
+        nPoints = 50001
+        transform = afwGeom.TransformGenericToGeneric(makeForwardPolyMap(2, 3))
+        inArray = self.makeRawArrayData(nPoints, 2)
+        outArray = transform.applyForward(inArray)
+        for numThreads in (1, 2, 3, 0):
+            assert_allclose(transform.applyForward(inArray, numThreads=numThreads), outArray,
+                            rtol=0, atol=0)
+
+        twoWay = afwGeom.TransformPoint2ToPoint2(ast.ZoomMap(2, 1.5).then(ast.ShiftMap([3.0, -2.5])))
+        pointList = twoWay.fromEndpoint.arrayFromData(inArray)
+        forward = twoWay.applyForward(pointList)
+        self.assertEqual(twoWay.applyForward(pointList, numThreads=4), forward)
+        self.assertEqual(twoWay.applyInverse(forward, numThreads=4), twoWay.applyInverse(forward))
+
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            transform.applyForward(inArray, numThreads=-1)
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
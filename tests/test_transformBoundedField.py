@@ -39,7 +39,7 @@ import lsst.pex.exceptions
 import lsst.geom
 import lsst.afw.geom
 import lsst.afw.image
-from lsst.afw.math import TransformBoundedField
+from lsst.afw.math import ProductBoundedField, TransformBoundedField
 
 
 CHEBYSHEV_T = [
@@ -101,6 +101,26 @@ class TransformBoundedFieldTestCase(lsst.utils.tests.TestCase):
         predResArr = self.transform.applyForward(self.pointList)[0]
         assert_allclose(resArr, predResArr)
 
+    def testEvaluateGrid(self):
+        """Test evaluateGrid and the image methods that use it
+        """
+        x = np.arange(self.bbox.getBeginX(), self.bbox.getEndX(), dtype=float)
+        y = np.arange(self.bbox.getBeginY(), self.bbox.getEndY(), dtype=float)
+        xx, yy = np.meshgrid(x, y)
+        predRes = self.boundedField.evaluate(xx.ravel(), yy.ravel()).reshape(xx.shape)
+
+        grid = self.boundedField.evaluateGrid(x, y)
+        self.assertEqual(grid.shape, (y.size, x.size))
+        assert_allclose(grid, predRes)
+
+        image = lsst.afw.image.ImageD(self.bbox)
+        self.boundedField.fillImage(image)
+        assert_allclose(image.array, predRes)
+
+        # a product of fields multiplies the factors' grids
+        product = ProductBoundedField([self.boundedField, self.boundedField])
+        assert_allclose(product.evaluateGrid(x, y), predRes**2)
+
     def testMultiplyOperator(self):
         """Test operator*
         """
@@ -311,6 +311,53 @@ class TransformFactoryTestSuite(TransformTestBaseClass):
         self.checkRadial(transform, coeffs)
         self.checkRoundTrip(transform, rtol=0.01)
 
+    def testApproximate(self):
+        """Test approximateTransform on a composite Transform
+        """
+        bbox = lsst.geom.Box2D(lsst.geom.Point2D(-1000, 200), lsst.geom.Point2D(1500, 4200))
+        shift = afwGeom.makeTransform(lsst.geom.AffineTransform(lsst.geom.Extent2D(-300.0, 150.0)))
+        radial = afwGeom.makeRadialTransform([0.0, 1.0, 0.0, 5.0e-11])
+        original = shift.then(radial)
+        maxError = 1.0e-4
+        approx = afwGeom.approximateTransform(original, bbox, maxError)
+        self.assertLessEqual(approx.maxForwardError, maxError)
+        self.assertLessEqual(approx.maxInverseError, maxError)
+        self.assertGreaterEqual(approx.order, 3)
+
+        rng = np.random.RandomState(5)
+        inPoints = [lsst.geom.Point2D(x, y) for x, y in
+                    zip(rng.uniform(bbox.getMinX(), bbox.getMaxX(), 200),
+                        rng.uniform(bbox.getMinY(), bbox.getMaxY(), 200))]
+        outPoints = original.applyForward(inPoints)
+        # the radial distortion barely changes the scale, so output errors are close to input errors
+        self.assertPairListsAlmostEqual(approx.transform.applyForward(inPoints), outPoints, maxDiff=1e-3)
+        self.assertPairListsAlmostEqual(approx.transform.applyInverse(outPoints), inPoints, maxDiff=1e-3)
+
+        # the approximation persists like any other Transform
+        restored = afwGeom.TransformPoint2ToPoint2.readString(approx.transform.writeString())
+        self.assertPairListsAlmostEqual(restored.applyForward(inPoints),
+                                        approx.transform.applyForward(inPoints), maxDiff=1e-8)
+
+        # an affine transform is reproduced exactly at first order
+        affine = afwGeom.makeTransform(lsst.geom.AffineTransform(np.array([[3.0, -2.0], [2.0, -1.0]]),
+                                                                 np.array([5.0, -7.0])))
+        approx = afwGeom.approximateTransform(affine, bbox, 1e-8)
+        self.assertEqual(approx.order, 1)
+        self.assertLess(approx.maxForwardError, 1e-8)
+        self.assertLess(approx.maxInverseError, 1e-8)
+
+        # with too low an order, the best attempt is returned with its errors
+        approx = afwGeom.approximateTransform(original, bbox, 1e-12, maxOrder=2)
+        self.assertLessEqual(approx.order, 2)
+        self.assertGreater(max(approx.maxForwardError, approx.maxInverseError), 1e-12)
+
+        for kwargs in (dict(maxError=0.0), dict(maxError=maxError, maxOrder=0),
+                       dict(maxError=maxError, gridShape=lsst.geom.Extent2I(2, 2))):
+            with self.assertRaises(pexExcept.InvalidParameterError):
+                afwGeom.approximateTransform(original, bbox, **kwargs)
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            afwGeom.approximateTransform(original, lsst.geom.Box2D(), maxError)
+
     def testBadRadial(self):
         """Test radial with invalid coefficients
         """
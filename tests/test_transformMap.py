@@ -174,6 +174,21 @@ class CameraTransformMapTestCase(lsst.utils.tests.TestCase):
                         fromPoint, fromSys, toSys)
                     self.assertPairsAlmostEqual(predToPoint, toPoint)
 
+    def testRepeatedLookup(self):
+        """Test that asking for the same pair of systems again gives the
+        same result, and that each Transform is independent of the others
+        """
+        point = lsst.geom.Point2D(3.5, -12.0)
+        for fromSys in self.transformMap:
+            for toSys in self.transformMap:
+                first = self.transformMap.getTransform(fromSys, toSys)
+                second = self.transformMap.getTransform(fromSys, toSys)
+                self.assertIsNot(first, second)
+                self.assertPairsAlmostEqual(first.applyForward(point), second.applyForward(point))
+                toPoint = self.transformMap.transform(point, fromSys, toSys)
+                self.assertPairsAlmostEqual(toPoint, first.applyForward(point))
+                self.assertPairsAlmostEqual(self.transformMap.transform(point, fromSys, toSys), toPoint)
+
 
 class MemoryTester(lsst.utils.tests.MemoryTestCase):
     pass
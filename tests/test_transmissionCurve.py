@@ -102,6 +102,10 @@ class TransmissionCurveTestCase(lsst.utils.tests.TestCase):
             throughput2 = np.zeros(wavelengths.size, dtype=float)
             tc.sampleAt(point, wavelengths, out=throughput2)
             self.assertFloatsEqual(throughput2, throughput)
+        throughputs = tc.sampleAt(self.points, wavelengths)
+        self.assertEqual(throughputs.shape, (len(self.points), wavelengths.size))
+        for point, throughput in zip(self.points, throughputs):
+            self.assertFloatsAlmostEqual(throughput, tc.sampleAt(point, wavelengths), rtol=1E-13)
 
     def assertTransmissionCurvesEqual(self, a, b, rtol=0.0, atol=0.0):
         """Test whether two TransimssionCurves are equivalent."""
@@ -322,6 +326,33 @@ class TransmissionCurveTestCase(lsst.utils.tests.TestCase):
         # Test persistence for radial TransmissionCurves
         self.checkPersistence(tc)
 
+    def testSampleMany(self):
+        """Test that sampling many positions at once matches sampling them one at a time."""
+        tc, wavelengths, radii, curve2d = self.makeRadial()
+        constant = lsst.afw.image.TransmissionCurve.makeSpatiallyConstant(
+            makeTestCurve(self.random, wavelengths[0], wavelengths[-1])(wavelengths), wavelengths, 0.5, 0.25
+        )
+        transform = lsst.afw.geom.makeTransform(
+            lsst.geom.AffineTransform(lsst.geom.LinearTransform.makeScaling(1.5),
+                                      lsst.geom.Extent2D(0.1, -0.2))
+        )
+        # include points beyond the largest radius and at the origin, and wavelengths out of bounds
+        points = self.points + [lsst.geom.Point2D(0.0, 0.0), lsst.geom.Point2D(3.0, -4.0),
+                                lsst.geom.Point2D(0.0, radii[17])]
+        wl2 = np.linspace(self.minWavelength - 50, self.maxWavelength + 50, 151)
+        for curve in (tc, constant, tc*constant, tc.transformedBy(transform),
+                      lsst.afw.image.TransmissionCurve.makeIdentity()):
+            out = np.zeros((len(points), wl2.size), dtype=float)
+            curve.sampleAt(points, wl2, out=out)
+            for point, throughput in zip(points, out):
+                self.assertFloatsAlmostEqual(throughput, curve.sampleAt(point, wl2), rtol=1E-13, atol=1E-15)
+            self.assertFloatsEqual(curve.sampleAt(points, wl2), out)
+            self.assertEqual(curve.sampleAt([], wl2).shape, (0, wl2.size))
+            with self.assertRaises(lsst.pex.exceptions.LengthError):
+                curve.sampleAt(points, wl2, out=np.zeros((len(points) - 1, wl2.size), dtype=float))
+            with self.assertRaises(lsst.pex.exceptions.LengthError):
+                curve.sampleAt(points, wl2, out=np.zeros((len(points), wl2.size + 1), dtype=float))
+
     def testTransform(self):
         """Test that we can transform a spatially-varying TransmissionCurve."""
         tc, wavelengths, radii, curve2d = self.makeRadial()
@@ -28,7 +28,8 @@ import numpy as np
 import lsst.utils.tests
 import lsst.pex.exceptions
 from lsst.daf.base import DateTime, PropertySet, PropertyList
-from lsst.geom import Angle, degrees, SpherePoint
+from lsst.geom import Angle, degrees, radians, SpherePoint
+import lsst.afw.coord
 from lsst.afw.coord import Observatory, Weather
 import lsst.afw.image as afwImage
 
@@ -801,6 +802,65 @@ class VisitInfoTestCase(lsst.utils.tests.TestCase):
         self.assertAnglesAlmostEqual(visitInfo.getBoresightParAngle(), Angle(0.))
 
 
+    def testArrayQuantities(self):
+        """Test the quantities computed for arrays of sky positions."""
+        weather = Weather(10., 74000., 20.)
+        visitInfo = afwImage.VisitInfo(era=self.data1.era,
+                                       boresightRaDec=self.data1.boresightRaDec,
+                                       observatory=self.data1.observatory,
+                                       weather=weather,
+                                       )
+        rng = np.random.RandomState(3)
+        localEra = visitInfo.getLocalEra().asRadians()
+        latitude = self.data1.observatory.getLatitude().asRadians()
+        ra = np.concatenate([[self.data1.boresightRaDec[0].asRadians(), localEra, localEra],
+                             rng.uniform(0., 2.*np.pi, 20)])
+        dec = np.concatenate([[self.data1.boresightRaDec[1].asRadians(), latitude, latitude + 0.1],
+                              rng.uniform(-0.5*np.pi, 0.5*np.pi, 20)])
+        parAngle = visitInfo.getParAngle(ra, dec)
+        self.assertAnglesAlmostEqual(parAngle[0]*radians, visitInfo.getBoresightParAngle())
+        self.assertAnglesAlmostEqual(parAngle[2]*radians, Angle(np.pi))
+        for i in range(len(ra)):
+            boresightInfo = afwImage.VisitInfo(era=self.data1.era,
+                                               boresightRaDec=SpherePoint(ra[i]*radians, dec[i]*radians),
+                                               observatory=self.data1.observatory)
+            self.assertAnglesAlmostEqual(parAngle[i]*radians, boresightInfo.getBoresightParAngle())
+
+        altitude = visitInfo.getAltitude(ra, dec)
+        self.assertFloatsAlmostEqual(altitude[1], 0.5*np.pi, atol=1e-7)
+        hourAngle = localEra - ra
+        expected = np.arcsin(np.clip(np.sin(dec)*np.sin(latitude)
+                                     + np.cos(dec)*np.cos(latitude)*np.cos(hourAngle), -1., 1.))
+        self.assertFloatsAlmostEqual(altitude, expected, atol=1e-12)
+
+        airmass = visitInfo.getAirmass(ra, dec)
+        self.assertFloatsAlmostEqual(airmass[1], 1.0, rtol=1e-6)
+        above = altitude > 0.5
+        self.assertFloatsAlmostEqual(airmass[above], 1.0/np.sin(altitude[above]), rtol=1e-2)
+        self.assertTrue(np.all(np.isnan(airmass[altitude < 0.])))
+
+        self.assertFloatsAlmostEqual(visitInfo.getRefraction(500., ra, dec)[1], 0.0, atol=1e-10)
+        for i in np.flatnonzero(above):
+            refraction = lsst.afw.coord.refraction(500., altitude[i]*radians, self.data1.observatory,
+                                                   weather=weather)
+            self.assertFloatsAlmostEqual(visitInfo.getRefraction(500., ra, dec)[i],
+                                         refraction.asRadians(), rtol=1e-10)
+        differential = visitInfo.getDifferentialRefraction(400., 600., ra, dec)
+        self.assertFloatsAlmostEqual(differential,
+                                     visitInfo.getRefraction(400., ra, dec)
+                                     - visitInfo.getRefraction(600., ra, dec), atol=1e-14)
+        # Unknown weather is replaced by typical weather for the observatory.
+        noWeather = afwImage.VisitInfo(era=self.data1.era, observatory=self.data1.observatory)
+        defaultWeather = lsst.afw.coord.makeDefaultWeather(self.data1.observatory.getElevation())
+        self.assertFloatsAlmostEqual(
+            noWeather.getRefraction(500., ra, dec),
+            lsst.afw.coord.computeRefraction(500., altitude, self.data1.observatory, defaultWeather))
+        with self.assertRaises(lsst.pex.exceptions.LengthError):
+            visitInfo.getAltitude(ra, dec[1:])
+        with self.assertRaises(lsst.pex.exceptions.InvalidParameterError):
+            visitInfo.getRefraction(100., ra, dec)
+
+
 def setup_module(module):
     lsst.utils.tests.init()
 
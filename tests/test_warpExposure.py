@@ -246,6 +246,254 @@ class WarpExposureTestCase(lsst.utils.tests.TestCase):
                          wc2.getMaskWarpingKernel().getKernelParameters())
         self.assertEqual(wc.getGrowFullMask(), wc2.getGrowFullMask())
 
+        wc = afwMath.WarpingControl("lanczos3")
+        self.assertEqual(wc.getNumThreads(), 1)
+        wc.setNumThreads(4)
+        self.assertEqual(wc.getNumThreads(), 4)
+        wc = afwMath.WarpingControl("lanczos3", numThreads=0)
+        self.assertEqual(wc.getNumThreads(), 0)
+
+
+    def testSharedKernelCache(self):
+        """Test that warping kernels with the same settings share their
+        caches, which are computed only once.
+        """
+        name = "math.SeparableKernel.computeCache"
+        wasEnabled = afwMath.isInstrumentationEnabled()
+        afwMath.setInstrumentationEnabled(True)
+        try:
+            def getCount():
+                return afwMath.getInstrumentationSnapshot().get(name, {"count": 0})["count"]
+            cacheSize = 4321  # a size no other test uses
+            count = getCount()
+            kernel = afwMath.WarpingControl("lanczos3", "", cacheSize).getWarpingKernel()
+            self.assertEqual(kernel.getCacheSize(), cacheSize)
+            self.assertEqual(getCount(), count + 2)  # one each for the row and column functions
+            kernel2 = afwMath.WarpingControl("lanczos3", "bilinear", cacheSize).getWarpingKernel()
+            self.assertEqual(kernel2.getCacheSize(), cacheSize)
+            self.assertEqual(getCount(), count + 2)
+            afwMath.WarpingControl("lanczos4", "", cacheSize).getWarpingKernel()
+            self.assertEqual(getCount(), count + 4)
+            # Warping on several threads uses the same caches as well
+            image = afwImage.ImageF(lsst.geom.Box2I(lsst.geom.Point2I(0, 0), lsst.geom.Extent2I(64, 64)))
+            image.array[:, :] = np.random.RandomState(1).randn(64, 64)
+            transform = afwGeom.makeTransform(lsst.geom.AffineTransform(lsst.geom.Extent2D(0.3, 0.2)))
+            warped = [image.Factory(image.getBBox()) for _ in range(2)]
+            for numThreads, dest in zip([1, 4], warped):
+                control = afwMath.WarpingControl("lanczos3", "", cacheSize, numThreads=numThreads)
+                afwMath.warpImage(dest, image, transform, control)
+            self.assertEqual(getCount(), count + 4)
+            self.assertImagesEqual(warped[0], warped[1])
+        finally:
+            afwMath.setInstrumentationEnabled(wasEnabled)
+    def testMultithreadedWarpImage(self):
+        """Test that warping with several threads matches warping with one
+        """
+        srcImage = afwImage.MaskedImageF(lsst.geom.Box2I(lsst.geom.Point2I(-5, 12),
+                                                         lsst.geom.Extent2I(120, 100)))
+        srcImage.image.array[:] = np.random.normal(100, 10, size=srcImage.image.array.shape)
+        srcImage.variance.array[:] = np.random.uniform(1, 2, size=srcImage.variance.array.shape)
+        srcImage.mask.array[:] = np.random.randint(0, 4, size=srcImage.mask.array.shape)
+        affine = lsst.geom.AffineTransform(lsst.geom.LinearTransform.makeScaling(1.1)
+                                           * lsst.geom.LinearTransform.makeRotation(0.3*lsst.geom.radians),
+                                           lsst.geom.Extent2D(20.5, -37.2))
+        srcToDest = afwGeom.makeTransform(affine)
+        destBBox = lsst.geom.Box2I(lsst.geom.Point2I(3, -4), lsst.geom.Extent2I(111, 97))
+
+        for interpLength in (0, 1, 7):
+            for numThreads in (2, 3, 0):
+                with self.subTest(interpLength=interpLength, numThreads=numThreads):
+                    serialImage = afwImage.MaskedImageF(destBBox)
+                    serialControl = afwMath.WarpingControl("lanczos3", "bilinear", 0, interpLength)
+                    serialNumGood = afwMath.warpImage(serialImage, srcImage, srcToDest, serialControl)
+                    self.assertGreater(serialNumGood, 1000)
+
+                    parallelImage = afwImage.MaskedImageF(destBBox)
+                    parallelControl = afwMath.WarpingControl("lanczos3", "bilinear", 0, interpLength,
+                                                             numThreads=numThreads)
+                    parallelNumGood = afwMath.warpImage(parallelImage, srcImage, srcToDest,
+                                                        parallelControl)
+                    if interpLength == 0:
+                        self.assertEqual(parallelNumGood, serialNumGood)
+                        self.assertMaskedImagesEqual(parallelImage, serialImage)
+                    else:
+                        # source positions are recomputed at the start of each block of rows
+                        self.assertAlmostEqual(parallelNumGood, serialNumGood, delta=10)
+                        self.assertMaskedImagesAlmostEqual(parallelImage, serialImage, rtol=1e-5)
+
+    def testSparseCoverage(self):
+        """Test that warping a source that covers little of the destination matches warping onto a
+        destination that just contains it
+        """
+        srcImage = afwImage.MaskedImageF(lsst.geom.Box2I(lsst.geom.Point2I(2, -3),
+                                                         lsst.geom.Extent2I(40, 30)))
+        srcImage.image.array[:] = np.random.normal(100, 10, size=srcImage.image.array.shape)
+        srcImage.variance.array[:] = 1
+        affine = lsst.geom.AffineTransform(lsst.geom.LinearTransform.makeScaling(0.9)
+                                           * lsst.geom.LinearTransform.makeRotation(0.7*lsst.geom.radians),
+                                           lsst.geom.Extent2D(250.3, 170.6))
+        srcToDest = afwGeom.makeTransform(affine)
+        bigBBox = lsst.geom.Box2I(lsst.geom.Point2I(0, 0), lsst.geom.Extent2I(400, 300))
+        smallBBox = lsst.geom.Box2I(lsst.geom.Point2I(220, 155), lsst.geom.Extent2I(80, 75))
+        noDataBitMask = afwImage.Mask.getPlaneBitMask("NO_DATA")
+
+        for interpLength in (0, 5):
+            with self.subTest(interpLength=interpLength):
+                control = afwMath.WarpingControl("lanczos3", "bilinear", 0, interpLength)
+                bigImage = afwImage.MaskedImageF(bigBBox)
+                bigNumGood = afwMath.warpImage(bigImage, srcImage, srcToDest, control)
+                smallImage = afwImage.MaskedImageF(smallBBox)
+                smallNumGood = afwMath.warpImage(smallImage, srcImage, srcToDest, control)
+                self.assertGreater(smallNumGood, 500)
+                # interpolation bands depend on the origin of the destination
+                self.assertAlmostEqual(bigNumGood, smallNumGood, delta=0 if interpLength == 0 else 10)
+                # everything outside the small box is padding
+                bigImage.assign(smallImage, smallBBox)
+                self.assertEqual(np.isfinite(bigImage.image.array).sum(), smallNumGood)
+                self.assertEqual((bigImage.mask.array == noDataBitMask).sum(),
+                                 bigBBox.getArea() - smallNumGood)
+                if interpLength == 0:
+                    bigImage = afwImage.MaskedImageF(bigBBox)
+                    afwMath.warpImage(bigImage, srcImage, srcToDest, control)
+                    self.assertMaskedImagesEqual(bigImage[smallBBox], smallImage)
+
+        # a destination that the source does not reach at all
+        farImage = afwImage.MaskedImageF(lsst.geom.Box2I(lsst.geom.Point2I(-500, -500),
+                                                         lsst.geom.Extent2I(100, 100)))
+        self.assertEqual(afwMath.warpImage(farImage, srcImage, srcToDest,
+                                           afwMath.WarpingControl("lanczos3")), 0)
+        self.assertTrue(np.all(np.isnan(farImage.image.array)))
+        self.assertTrue(np.all(farImage.mask.array == noDataBitMask))
+
+    def testWarpExposures(self):
+        """Test that warpExposures matches warpExposure for each source exposure
+        """
+        destWcs = afwGeom.makeSkyWcs(
+            crpix=lsst.geom.Point2D(50, 40),
+            crval=lsst.geom.SpherePoint(10, 20, lsst.geom.degrees),
+            cdMatrix=afwGeom.makeCdMatrix(scale=0.2*lsst.geom.arcseconds),
+        )
+        destBBox = lsst.geom.Box2I(lsst.geom.Point2I(5, -2), lsst.geom.Extent2I(90, 75))
+        srcExposures = []
+        for i in range(4):
+            srcWcs = afwGeom.makeSkyWcs(
+                crpix=lsst.geom.Point2D(45 + 3*i, 38 - 2*i),
+                crval=lsst.geom.SpherePoint(10, 20, lsst.geom.degrees),
+                cdMatrix=afwGeom.makeCdMatrix(scale=0.21*lsst.geom.arcseconds,
+                                              orientation=(5 + 10*i)*lsst.geom.degrees),
+            )
+            srcExposure = afwImage.ExposureF(lsst.geom.Box2I(lsst.geom.Point2I(0, 0),
+                                                             lsst.geom.Extent2I(100, 80)), srcWcs)
+            srcExposure.image.array[:] = np.random.normal(100, 10, size=srcExposure.image.array.shape)
+            srcExposure.variance.array[:] = 1
+            srcExposure.getInfo().setVisitInfo(makeVisitInfo())
+            srcExposures.append(srcExposure)
+
+        for numThreads in (1, 2):
+            control = afwMath.WarpingControl("lanczos3", "bilinear", 1000, 5, numThreads=numThreads)
+            results = []
+
+            def callback(index, destExposure, numGoodPixels):
+                # the pixels of destExposure are reused, so keep a deep copy
+                results.append((index, destExposure.clone(), numGoodPixels))
+
+            afwMath.warpExposures(srcExposures, destBBox, destWcs, control, callback)
+            self.assertEqual([index for index, _, _ in results], list(range(len(srcExposures))))
+            for srcExposure, (index, batchExposure, batchNumGood) in zip(srcExposures, results):
+                with self.subTest(numThreads=numThreads, index=index):
+                    destExposure = afwImage.ExposureF(destBBox, destWcs)
+                    numGood = afwMath.warpExposure(destExposure, srcExposure, control)
+                    self.assertGreater(numGood, 1000)
+                    self.assertEqual(batchNumGood, numGood)
+                    self.assertEqual(batchExposure.getBBox(), destBBox)
+                    self.assertEqual(batchExposure.getWcs(), destWcs)
+                    self.assertEqual(batchExposure.getInfo().getVisitInfo(),
+                                     srcExposure.getInfo().getVisitInfo())
+                    self.assertMaskedImagesEqual(batchExposure.maskedImage, destExposure.maskedImage)
+
+        with self.assertRaises(pexExcept.InvalidParameterError):
+            afwMath.warpExposures([srcExposures[0], afwImage.ExposureF(10, 10)], destBBox, destWcs,
+                                  control, callback)
+
+    def testAdaptiveInterpolation(self):
+        """Test that adaptive interpolation matches warping without interpolation
+        """
+        wc = afwMath.WarpingControl("lanczos3", "", 0, 10)
+        self.assertEqual(wc.getMaxInterpError(), 0)
+        wc.setMaxInterpError(0.05)
+        self.assertEqual(wc.getMaxInterpError(), 0.05)
+
+        srcImage = afwImage.MaskedImageF(lsst.geom.Box2I(lsst.geom.Point2I(-30, -20),
+                                                         lsst.geom.Extent2I(200, 180)))
+        yArr, xArr = np.mgrid[0:180, 0:200]
+        srcImage.image.array[:] = 100 + 10*np.sin(xArr/7.0)*np.cos(yArr/5.0)
+        srcImage.variance.array[:] = 1
+        # a radial distortion, which varies much faster near the edges of the image than near the center
+        srcToDest = afwGeom.makeRadialTransform([0.0, 1.0, 0.0, 2e-6])
+        destBBox = lsst.geom.Box2I(lsst.geom.Point2I(-10, -5), lsst.geom.Extent2I(150, 130))
+
+        exactControl = afwMath.WarpingControl("lanczos3")
+        exactImage = afwImage.MaskedImageF(destBBox)
+        numGood = afwMath.warpImage(exactImage, srcImage, srcToDest, exactControl)
+        self.assertGreater(numGood, 10000)
+
+        for maxInterpError, atol in ((1e-5, 1e-3), (0.01, 0.1)):
+            for interpLength, numThreads in ((1, 1), (16, 1), (64, 1), (16, 3)):
+                with self.subTest(maxInterpError=maxInterpError, interpLength=interpLength,
+                                  numThreads=numThreads):
+                    adaptiveControl = afwMath.WarpingControl("lanczos3", "", 0, interpLength,
+                                                             numThreads=numThreads)
+                    adaptiveControl.setMaxInterpError(maxInterpError)
+                    adaptiveImage = afwImage.MaskedImageF(destBBox)
+                    numAdaptiveGood = afwMath.warpImage(adaptiveImage, srcImage, srcToDest, adaptiveControl)
+                    self.assertAlmostEqual(numAdaptiveGood, numGood, delta=numGood*0.01)
+                    goodArr = np.isfinite(adaptiveImage.image.array) & np.isfinite(exactImage.image.array)
+                    self.assertGreater(goodArr.sum(), numGood*0.99)
+                    self.assertFloatsAlmostEqual(adaptiveImage.image.array[goodArr],
+                                                 exactImage.image.array[goodArr], atol=atol)
+
+    def testLanczosLookupTable(self):
+        """Test that warping with the Lanczos lookup table matches warping without it
+        """
+        wc = afwMath.WarpingControl("lanczos3")
+        self.assertFalse(wc.getUseLanczosLookupTable())
+        wc.setUseLanczosLookupTable(True)
+        self.assertTrue(wc.getUseLanczosLookupTable())
+
+        srcImage = afwImage.MaskedImageF(lsst.geom.Box2I(lsst.geom.Point2I(4, -3),
+                                                         lsst.geom.Extent2I(90, 80)))
+        srcImage.image.array[:] = np.random.normal(100, 10, size=srcImage.image.array.shape)
+        srcImage.variance.array[:] = np.random.uniform(1, 2, size=srcImage.variance.array.shape)
+        srcImage.mask.array[:] = np.random.randint(0, 4, size=srcImage.mask.array.shape)
+        affine = lsst.geom.AffineTransform(lsst.geom.LinearTransform.makeScaling(0.93)
+                                           * lsst.geom.LinearTransform.makeRotation(0.2*lsst.geom.radians),
+                                           lsst.geom.Extent2D(-3.3, 8.1))
+        srcToDest = afwGeom.makeTransform(affine)
+        destBBox = lsst.geom.Box2I(lsst.geom.Point2I(0, 0), lsst.geom.Extent2I(85, 77))
+
+        for kernelName, maskKernelName in (("lanczos3", ""), ("lanczos4", "lanczos2"),
+                                           ("lanczos5", "bilinear")):
+            for interpLength in (0, 10):
+                with self.subTest(kernelName=kernelName, maskKernelName=maskKernelName,
+                                  interpLength=interpLength):
+                    exactControl = afwMath.WarpingControl(kernelName, maskKernelName, 0, interpLength)
+                    tableControl = afwMath.WarpingControl(kernelName, maskKernelName, 0, interpLength)
+                    tableControl.setUseLanczosLookupTable(True)
+
+                    exactImage = afwImage.MaskedImageF(destBBox)
+                    numGood = afwMath.warpImage(exactImage, srcImage, srcToDest, exactControl)
+                    self.assertGreater(numGood, 1000)
+                    tableImage = afwImage.MaskedImageF(destBBox)
+                    self.assertEqual(afwMath.warpImage(tableImage, srcImage, srcToDest, tableControl),
+                                     numGood)
+                    self.assertMaskedImagesAlmostEqual(tableImage, exactImage, rtol=1e-5)
+
+                    exactImage = afwImage.ImageF(destBBox)
+                    afwMath.warpImage(exactImage, srcImage.image, srcToDest, exactControl)
+                    tableImage = afwImage.ImageF(destBBox)
+                    afwMath.warpImage(tableImage, srcImage.image, srcToDest, tableControl)
+                    self.assertImagesAlmostEqual(tableImage, exactImage, rtol=1e-5)
+
     def testWarpingControlError(self):
         """Test error handling of WarpingControl
         """